@@ -74,6 +74,7 @@ let notSyncServerSources: [String] = [
     "realm/group_writer.cpp",
     "realm/history.cpp",
     "realm/impl",
+    "realm/index_fulltext.cpp",
     "realm/index_string.cpp",
     "realm/list.cpp",
     "realm/mixed.cpp",
@@ -111,6 +112,7 @@ let notSyncServerSources: [String] = [
     "realm/sync/noinst/pending_bootstrap_store.cpp",
     "realm/sync/noinst/protocol_codec.cpp",
     "realm/sync/noinst/sync_metadata_schema.cpp",
+    "realm/sync/noinst/upload_flow_control.cpp",
     "realm/sync/object_id.cpp",
     "realm/sync/protocol.cpp",
     "realm/sync/subscriptions.cpp",
@@ -126,6 +126,12 @@ typedef enum realm_schema_validation_mode {
     RLM_SCHEMA_VALIDATION_REJECT_EMBEDDED_ORPHANS = 2
 } realm_schema_validation_mode_e;
 
+typedef enum realm_memory_pressure {
+    // Values matching `realm::DB::MemoryPressure`.
+    RLM_MEMORY_PRESSURE_MODERATE,
+    RLM_MEMORY_PRESSURE_CRITICAL,
+} realm_memory_pressure_e;
+
 /**
  * Represents a view over a UTF-8 string buffer. The buffer is unowned by this struct.
  *
@@ -171,6 +177,15 @@ typedef struct realm_uuid {
     uint8_t bytes[16];
 } realm_uuid_t;
 
+/**
+ * A value read from a Realm.
+ *
+ * Strings and binary values, including dictionary keys and the elements of
+ * collections, are not copied: they point directly into the Realm file (or
+ * its decrypted pages). They remain valid until the read transaction they
+ * were read in is advanced or ended, or the value is modified in a write
+ * transaction. For a frozen Realm this is as long as the Realm is open.
+ */
 typedef struct realm_value {
     union {
         int64_t integer;
@@ -364,12 +379,16 @@ typedef enum realm_property_flags {
 
 /* Notification types */
 typedef struct realm_notification_token realm_notification_token_t;
+typedef struct realm_async_evaluation realm_async_evaluation_t;
 typedef struct realm_callback_token realm_callback_token_t;
 typedef struct realm_refresh_callback_token realm_refresh_callback_token_t;
 typedef struct realm_object_changes realm_object_changes_t;
 typedef struct realm_collection_changes realm_collection_changes_t;
 typedef void (*realm_on_object_change_func_t)(realm_userdata_t userdata, const realm_object_changes_t*);
 typedef void (*realm_on_collection_change_func_t)(realm_userdata_t userdata, const realm_collection_changes_t*);
+typedef struct realm_notification_batch realm_notification_batch_t;
+typedef void (*realm_on_notification_batch_func_t)(realm_userdata_t userdata, size_t num_changes,
+                                                   const uint64_t* ids, const realm_collection_changes_t* const* changes);
 typedef void (*realm_on_realm_change_func_t)(realm_userdata_t userdata);
 typedef void (*realm_on_realm_refresh_func_t)(realm_userdata_t userdata);
 typedef void (*realm_async_begin_write_func_t)(realm_userdata_t userdata);
@@ -418,6 +437,52 @@ RLM_API const char* realm_get_library_version(void);
 RLM_API void realm_get_library_version_numbers(int* out_major, int* out_minor, int* out_patch,
                                                const char** out_extra);
 
+/* Latency metrics */
+// equivalent to realm::metrics::LatencyMetric in metrics/latency.hpp and must be kept in sync.
+typedef enum realm_latency_metric {
+    RLM_LATENCY_METRIC_BEGIN_READ = 0,
+    RLM_LATENCY_METRIC_COMMIT = 1,
+    RLM_LATENCY_METRIC_FSYNC = 2,
+    RLM_LATENCY_METRIC_QUERY = 3,
+    RLM_LATENCY_METRIC_NOTIFIER_RUN = 4,
+    RLM_LATENCY_METRIC_SYNC_INTEGRATE = 5,
+    RLM_LATENCY_METRIC_SYNC_UPLOAD = 6,
+} realm_latency_metric_e;
+
+typedef struct realm_latency_snapshot {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    // Percentiles, rounded up to the precision of the histogram (12.5%)
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} realm_latency_snapshot_t;
+
+/**
+ * Get the latencies recorded for an operation by all Realms in the process,
+ * since the start of the process or the last call to
+ * `realm_reset_latency_metrics()`.
+ *
+ * This function does not allocate any memory.
+ *
+ * @param metric The operation to get the latencies of.
+ * @param out_snapshot Populated with the recorded latencies.
+ * @return False if `metric` is not a valid metric.
+ */
+RLM_API bool realm_get_latency_snapshot(realm_latency_metric_e metric, realm_latency_snapshot_t* out_snapshot);
+
+/**
+ * Forget the latencies recorded so far.
+ */
+RLM_API void realm_reset_latency_metrics(void);
+
+/**
+ * Enable or disable the recording of latencies, which is enabled by default.
+ */
+RLM_API void realm_set_latency_metrics_enabled(bool enabled);
+
 /**
  * Get the last error that happened on this thread.
  *
@@ -835,9 +900,10 @@ RLM_API void realm_config_set_automatic_backlink_handling(realm_config_t*, bool)
  * @param notify Function which will be called whenever the scheduler has work
  *               to do. Each call to this should trigger a call to
  *               `realm_scheduler_perform_work()` from within the scheduler's
- *               event loop. This function must be thread-safe, or NULL, in
- *               which case the scheduler is considered unable to deliver
- *               notifications.
+ *               event loop. Work scheduled before that call is performed
+ *               by it, so `notify()` is not called again until it has run.
+ *               This function must be thread-safe, or NULL, in which case the
+ *               scheduler is considered unable to deliver notifications.
  * @param is_on_thread Function to return true if called from the same thread as
  *                     the scheduler. This function must be thread-safe.
  * @param can_deliver_notifications Function to return true if the scheduler can
@@ -1134,6 +1200,19 @@ RLM_API realm_t* realm_freeze(const realm_t*);
  */
 RLM_API bool realm_compact(realm_t*, bool* did_compact);
 
+/**
+ * Release memory which is recreated on demand, such as decrypted pages of an
+ * encrypted file and cached query data, as a response to memory pressure
+ * reported by the OS.
+ *
+ * @param level How much to release. At moderate pressure, data which was used
+ *              recently is kept.
+ * @param out_bytes_released If non-null, set to an estimate of the number of
+ *                           bytes released.
+ * @return True if no exceptions occurred.
+ */
+RLM_API bool realm_release_memory(realm_t*, realm_memory_pressure_e level, size_t* out_bytes_released);
+
 /**
  * Create a new schema from classes and their properties.
  *
@@ -1389,6 +1468,31 @@ RLM_API bool realm_find_primary_key_property(const realm_t*, realm_class_key_t c
  */
 RLM_API bool realm_get_num_objects(const realm_t*, realm_class_key_t, size_t* out_count);
 
+/**
+ * Designate an integer property of a class as the one in which every object
+ * records the modification version of the class as of the transaction that
+ * last created or modified it. Objects modified since a version obtained from
+ * `realm_get_modification_version()` can then be found by comparing with
+ * this property, so that cached data derived from them can be invalidated.
+ *
+ * This function must be called from within a write transaction.
+ *
+ * @param property_key The property to use, or RLM_INVALID_PROPERTY_KEY to
+ *                     remove the designation.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_set_modification_version_property(realm_t*, realm_class_key_t, realm_property_key_t property_key);
+
+/**
+ * Get the modification version of a class as of the start of the current
+ * transaction.
+ *
+ * @param out_version A pointer to a `uint64_t` that will contain the version,
+ *                    if successful.
+ * @return True if the table key was valid for this realm.
+ */
+RLM_API bool realm_get_modification_version(const realm_t*, realm_class_key_t, uint64_t* out_version);
+
 /**
  * Get the number of versions found in the Realm file.
  *
@@ -1418,6 +1522,21 @@ RLM_API realm_object_t* realm_get_object(const realm_t*, realm_class_key_t class
 RLM_API realm_object_t* realm_object_find_with_primary_key(const realm_t*, realm_class_key_t, realm_value_t pk,
                                                            bool* out_found);
 
+/**
+ * Find the keys of the objects with the given primary key values. This is
+ * faster than finding the objects one by one.
+ *
+ * @param pks The primary key values to look for.
+ * @param num_pks The number of values in @a pks.
+ * @param out_keys An array of size at least @a num_pks, which will contain the
+ *                 key of the object for each value, in the same order.
+ * @param out_found An array of size at least @a num_pks, which will tell if an
+ *                  object was found for each value. May be NULL.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_object_find_keys_with_primary_keys(const realm_t*, realm_class_key_t, const realm_value_t* pks,
+                                                      size_t num_pks, realm_object_key_t* out_keys, bool* out_found);
+
 /**
  * Find all objects in class.
  *
@@ -1452,6 +1571,25 @@ RLM_API realm_object_t* realm_object_create_with_primary_key(realm_t*, realm_cla
 RLM_API realm_object_t* realm_object_get_or_create_with_primary_key(realm_t*, realm_class_key_t, realm_value_t pk,
                                                                     bool* did_create);
 
+/**
+ * Create or update a batch of objects in a class.
+ *
+ * The values are laid out column-major: the value of `properties[p]` for
+ * object `i` is `values[p * num_objects + i]`. For classes with a primary key
+ * the primary key property must be one of `properties`; objects which already
+ * exist (or appear more than once in the batch) are updated in place.
+ *
+ * This is faster than creating the objects one at a time, as search indexes
+ * are updated in a single pass once all objects have been created.
+ *
+ * @param out_keys Pointer to an array of at least `num_objects` elements which
+ *                 receives the object key of each row. May be NULL.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_object_create_batch(realm_t*, realm_class_key_t, size_t num_objects, size_t num_properties,
+                                       const realm_property_key_t* properties, const realm_value_t* values,
+                                       realm_object_key_t* out_keys);
+
 /**
  * Delete a realm object.
  *
@@ -1508,6 +1646,17 @@ RLM_API realm_object_key_t realm_object_get_key(const realm_object_t* object);
  */
 RLM_API realm_class_key_t realm_object_get_table(const realm_object_t* object);
 
+/**
+ * Get the modification version of the class as of the transaction that last
+ * created or modified this object.
+ *
+ * @param out_version A pointer to a `uint64_t` that will contain the version,
+ *                    if successful.
+ * @return True if no exception occurred. It is an error to call this for an
+ *         object whose class has no modification version property.
+ */
+RLM_API bool realm_object_get_modification_version(const realm_object_t* object, uint64_t* out_version);
+
 /**
  * Get a `realm_link_t` representing a link to @a object.
  *
@@ -1562,6 +1711,32 @@ RLM_API bool realm_get_value(const realm_object_t*, realm_property_key_t, realm_
 RLM_API bool realm_get_values(const realm_object_t*, size_t num_values, const realm_property_key_t* properties,
                               realm_value_t* out_values);
 
+/**
+ * Get the values of several properties for several objects of the same class.
+ *
+ * This is a batched alternative to calling `realm_get_values()` for each
+ * object, for example when populating a scrolling list. Values are read
+ * directly from the storage leaves, which are shared between neighbouring
+ * objects, and no object accessors are created.
+ *
+ * The values are written property by property: the value of
+ * `properties[p]` for `objects[o]` is written to
+ * `out_values[p * num_objects + o]`.
+ *
+ * @param num_objects The number of elements in @a objects.
+ * @param objects The keys of the objects to read. May not be NULL.
+ * @param num_properties The number of elements in @a properties.
+ * @param properties The keys for the properties to fetch. May not be NULL.
+ *                   Collection properties are not supported.
+ * @param out_values Where to write the property values. Must have room for
+ *                   `num_objects * num_properties` elements. If an error
+ *                   occurs, this array is left uninitialized. May not be NULL.
+ * @return True if no exception occurs.
+ */
+RLM_API bool realm_get_values_for_objects(const realm_t*, realm_class_key_t class_key, size_t num_objects,
+                                          const realm_object_key_t* objects, size_t num_properties,
+                                          const realm_property_key_t* properties, realm_value_t* out_values);
+
 /**
  * Set the value for a property.
  *
@@ -1696,6 +1871,18 @@ RLM_API bool realm_list_get_property(const realm_list_t*, realm_property_info_t*
  */
 RLM_API bool realm_list_get(const realm_list_t*, size_t index, realm_value_t* out_value);
 
+/**
+ * Get the values in the range [begin, end).
+ *
+ * This is considerably faster than calling `realm_list_get()` for each index
+ * when reading large lists of primitive values.
+ *
+ * @param out_values The resulting values, if no error occurred. Must point to
+ *                   room for `end - begin` values.
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_list_get_range(const realm_list_t*, size_t begin, size_t end, realm_value_t* out_values);
+
 /**
  * Set the value at @a index.
  *
@@ -1782,6 +1969,20 @@ RLM_API realm_notification_token_t* realm_list_add_notification_callback(realm_l
  */
 RLM_API realm_list_t* realm_list_from_thread_safe_reference(const realm_t*, realm_thread_safe_reference_t*);
 
+/**
+ * Limit how often the callback registered with @a token is called.
+ *
+ * The callback is called at most once per @a interval_ms milliseconds, with the
+ * changes from all versions produced in between merged into a single
+ * changeset. The initial notification is not delayed. An interval of zero
+ * (the default) calls the callback for every version with changes.
+ *
+ * This must be called on the thread the callback was registered on.
+ *
+ * @return True if no exception occurred.
+ */
+RLM_API bool realm_notification_token_set_delivery_interval(realm_notification_token_t* token, uint64_t interval_ms);
+
 /**
  * True if an object notification indicates that the object was deleted.
  *
@@ -2245,6 +2446,33 @@ RLM_API realm_dictionary_t* realm_dictionary_from_thread_safe_reference(const re
 RLM_API realm_query_t* realm_query_parse(const realm_t*, realm_class_key_t target_table, const char* query_string,
                                          size_t num_args, const realm_query_arg_t* args);
 
+/**
+ * Parse a query string like realm_query_parse(), and prepare the query to be
+ * run again with other arguments by realm_query_rebind(), without parsing and
+ * building it again.
+ *
+ * Only the conditions comparing a property with a single argument can be
+ * rebound. Arguments which are null or lists are not bound.
+ *
+ * @return A non-null pointer if the query was successfully parsed and no
+ *         exception occurred.
+ */
+RLM_API realm_query_t* realm_query_prepare(const realm_t*, realm_class_key_t target_table, const char* query_string,
+                                           size_t num_args, const realm_query_arg_t* args);
+
+/**
+ * Replace the value of an argument of a query created by realm_query_prepare().
+ * The query is changed in place; results created from it before are not
+ * affected.
+ *
+ * @param arg_index The index of the argument, e.g. 0 for `$0`.
+ * @param value The new value, which must be of the type the property is
+ *              compared with.
+ * @return True if no exception occurred. Fails if no condition is bound to the
+ *         argument, or if a condition can't compare with the value.
+ */
+RLM_API bool realm_query_rebind(realm_query_t*, size_t arg_index, realm_value_t value);
+
 
 /**
  * Get textual representation of query
@@ -2253,6 +2481,17 @@ RLM_API realm_query_t* realm_query_parse(const realm_t*, realm_class_key_t targe
  */
 RLM_API const char* realm_query_get_description(realm_query_t*);
 
+/**
+ * Get a textual representation of how the query is evaluated, with one line per
+ * condition giving its access path and estimated cost.
+ *
+ * @param analyze If true, the query is also evaluated and the number of rows
+ *                processed by each condition, and the time spent, are included.
+ * @return a non-null pointer if no exception occurred. The returned string must
+ *         be freed with realm_free().
+ */
+RLM_API char* realm_query_explain(const realm_query_t*, bool analyze);
+
 
 /**
  * Parse a query string and append it to an existing query via logical &&.
@@ -2336,6 +2575,31 @@ RLM_API bool realm_query_find_first(realm_query_t*, realm_value_t* out_value, bo
  */
 RLM_API realm_results_t* realm_query_find_all(realm_query_t*);
 
+/**
+ * Callback for realm_query_find_all_async().
+ *
+ * @param results The evaluated results, frozen at the version the query was run against. This object is released
+ *                after the callback returns. Preserve it with realm_clone() if you wish to keep it around for longer.
+ *                NULL if the evaluation failed.
+ * @param error NULL if the evaluation succeeded.
+ */
+typedef void (*realm_query_find_all_async_func_t)(realm_userdata_t userdata, const realm_results_t* results,
+                                                  const realm_async_error_t* error);
+
+/**
+ * Run the query on a background thread, against a frozen copy of the current
+ * version of the realm, and deliver the results to the callback on the realm's
+ * scheduler. This keeps the calling thread free without registering a
+ * notification callback.
+ *
+ * @return A handle for the evaluation. Releasing it with realm_release() cancels
+ *         the evaluation if the callback has not been called yet. NULL if an
+ *         exception occurred.
+ */
+RLM_API realm_async_evaluation_t* realm_query_find_all_async(realm_query_t*, realm_query_find_all_async_func_t,
+                                                             realm_userdata_t userdata,
+                                                             realm_free_userdata_func_t userdata_free);
+
 /**
  * Delete all objects matched by a query.
  */
@@ -2351,6 +2615,15 @@ RLM_API bool realm_query_delete_all(const realm_query_t*);
  */
 RLM_API bool realm_results_count(realm_results_t*, size_t* out_count);
 
+/**
+ * Get a textual representation of how the query of the results is evaluated.
+ * See realm_query_explain().
+ *
+ * @return a non-null pointer if no exception occurred. The returned string must
+ *         be freed with realm_free().
+ */
+RLM_API char* realm_results_explain(realm_results_t*, bool analyze);
+
 /**
  * Create a new results object by further filtering existing result.
  *
@@ -2421,6 +2694,24 @@ RLM_API bool realm_results_get(realm_results_t*, size_t index, realm_value_t* ou
  */
 RLM_API realm_object_t* realm_results_get_object(realm_results_t*, size_t index);
 
+/**
+ * Get the values of several properties for the matching objects in the range
+ * [begin, end).
+ *
+ * This is a batched alternative to calling `realm_results_get_object()` and
+ * `realm_get_values()` for each row. The values are laid out as for
+ * `realm_get_values_for_objects()`: the value of `properties[p]` for the
+ * object at index `begin + o` is written to `out_values[p * (end - begin) + o]`.
+ *
+ * @param properties The keys for the properties to fetch. May not be NULL.
+ *                   Collection properties are not supported.
+ * @param out_values Where to write the property values. Must have room for
+ *                   `(end - begin) * num_properties` elements. May not be NULL.
+ * @return True if no exception occurred (including out-of-bounds).
+ */
+RLM_API bool realm_results_get_values(realm_results_t*, size_t begin, size_t end, size_t num_properties,
+                                      const realm_property_key_t* properties, realm_value_t* out_values);
+
 /**
  * Delete all objects in the result.
  *
@@ -2493,6 +2784,48 @@ RLM_API realm_notification_token_t* realm_results_add_notification_callback(real
                                                                             realm_key_path_array_t*,
                                                                             realm_on_collection_change_func_t);
 
+/**
+ * Create a batch which collects the changes of several collection
+ * notification callbacks and delivers them through a single callback.
+ *
+ * The changes delivered to the callbacks added with
+ * `realm_results_add_batched_notification_callback()` and the list, set and
+ * dictionary variants are collected, and passed together to @a on_batch once
+ * the notifications of a version have all been delivered. This happens on the
+ * scheduler of @a realm, or immediately if that cannot invoke functions. The
+ * changes are only valid during the call to @a on_batch.
+ *
+ * @param on_batch Called with the number of changes, and for each of them the
+ *                 id the callback was added with and the changes.
+ * @return A non-null pointer if no exception occurred. The batch is kept
+ *         alive by its callbacks until their tokens are released.
+ */
+RLM_API realm_notification_batch_t* realm_notification_batch_new(const realm_t* realm, realm_userdata_t userdata,
+                                                                 realm_free_userdata_func_t userdata_free,
+                                                                 realm_on_notification_batch_func_t on_batch);
+
+/**
+ * Subscribe to notifications for a collection, delivered through @a batch.
+ *
+ * @param id Passed along with the changes of this collection to the batch
+ *           callback.
+ * @return A non-null pointer if no exception occurred.
+ */
+RLM_API realm_notification_token_t* realm_results_add_batched_notification_callback(realm_results_t*,
+                                                                                    realm_notification_batch_t* batch,
+                                                                                    uint64_t id,
+                                                                                    realm_key_path_array_t*);
+RLM_API realm_notification_token_t* realm_list_add_batched_notification_callback(realm_list_t*,
+                                                                                 realm_notification_batch_t* batch,
+                                                                                 uint64_t id,
+                                                                                 realm_key_path_array_t*);
+RLM_API realm_notification_token_t* realm_set_add_batched_notification_callback(realm_set_t*,
+                                                                                realm_notification_batch_t* batch,
+                                                                                uint64_t id, realm_key_path_array_t*);
+RLM_API realm_notification_token_t*
+realm_dictionary_add_batched_notification_callback(realm_dictionary_t*, realm_notification_batch_t* batch, uint64_t id,
+                                                   realm_key_path_array_t*);
+
 /**
  * Get an results object from a thread-safe reference, potentially originating
  * in a different `realm_t` instance
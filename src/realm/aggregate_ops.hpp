@@ -178,6 +178,23 @@ public:
         return false;
     }
 
+    // Add the sum of `count` values computed elsewhere, e.g. by a vectorized reduction over a leaf
+    void accumulate_sum(ResultType sum, size_t count)
+    {
+        if constexpr (std::is_integral_v<ResultType> && std::is_signed_v<ResultType>) {
+            m_result = std::make_unsigned_t<ResultType>(m_result) + sum;
+        }
+        else {
+            m_result += sum;
+        }
+        m_count += count;
+    }
+    // Merge the partial result of a disjoint set of values
+    void combine(const Sum& other)
+    {
+        accumulate_sum(other.m_result, other.m_count);
+    }
+
     bool is_null() const
     {
         return false;
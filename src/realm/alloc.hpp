@@ -22,6 +22,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
+#include <memory>
+#include <mutex>
 
 #include <realm/util/features.h>
 #include <realm/util/terminate.hpp>
@@ -43,6 +45,8 @@
 namespace realm {
 
 class Allocator;
+class DecompressedBlobCache;
+class LeafSummaryCache;
 
 using ref_type = size_t;
 
@@ -125,6 +129,23 @@ public:
     {
         m_is_read_only = ro;
     }
+
+    /// Array encodings which only files of format version 23 may hold. Data
+    /// modified through this allocator is stored in one of them only when it
+    /// is enabled here, which DB does as requested by DBOptions.
+    enum Encoding : unsigned {
+        encoding_DictStrings = 1,
+        encoding_CompressedValues = 2,
+        encoding_CompactDecimals = 4,
+    };
+    bool is_encoding_enabled(Encoding encoding) const noexcept
+    {
+        return (m_enabled_encodings & encoding) != 0;
+    }
+    void set_enabled_encodings(unsigned encodings) noexcept
+    {
+        m_enabled_encodings = encodings;
+    }
     /// Returns a simple allocator that can be used with free-standing
     /// Realm objects (such as a free-standing table). A
     /// free-standing object is one that is not part of a Group, and
@@ -139,6 +160,12 @@ public:
 
     virtual void verify() const = 0;
 
+    /// Hint that the specified range of memory, starting at 'ref', will be
+    /// read soon. The memory itself is not accessed. Allocators backed by a
+    /// file may use this to start reading the range in; the default does
+    /// nothing.
+    virtual void prefetch(ref_type, size_t) const noexcept {}
+
 #ifdef REALM_DEBUG
     /// Terminate the program precisely when the specified 'ref' is
     /// freed (or reallocated). You can use this to detect whether the
@@ -322,11 +349,24 @@ protected:
 
 private:
     bool m_is_read_only = false; // prevent any alloc or free operations
+    unsigned m_enabled_encodings = 0;
+
+    // Values decompressed from compressed blobs read through this allocator,
+    // see ArrayBigBlobs. Created on first use.
+    std::mutex m_blob_cache_mutex;
+    std::shared_ptr<DecompressedBlobCache> m_blob_cache;
+
+    // Summaries of the column leaves read through this allocator, see
+    // LeafSummaryCache. Created on first use, and kept across versions.
+    std::mutex m_leaf_summary_cache_mutex;
+    std::shared_ptr<LeafSummaryCache> m_leaf_summary_cache;
 
     friend class Table;
     friend class ClusterTree;
     friend class Group;
     friend class WrappedAllocator;
+    friend class ArrayBigBlobs;
+    friend class LeafSummaryCache;
     friend class Obj;
     template <class, class>
     friend class CollectionBaseImpl;
@@ -342,16 +382,28 @@ public:
         m_baseline.store(m_alloc->m_baseline, std::memory_order_relaxed);
         m_debug_watch = 0;
         m_ref_translation_ptr.store(m_alloc->m_ref_translation_ptr);
+        m_enabled_encodings = m_alloc->m_enabled_encodings;
     }
 
     ~WrappedAllocator() {}
 
+    void prefetch(ref_type ref, size_t size) const noexcept override
+    {
+        m_alloc->prefetch(ref, size);
+    }
+
     void switch_underlying_allocator(Allocator& underlying_allocator)
     {
         m_alloc = &underlying_allocator;
         m_baseline.store(m_alloc->m_baseline, std::memory_order_relaxed);
         m_debug_watch = 0;
+        m_enabled_encodings = m_alloc->m_enabled_encodings;
         refresh_ref_translation();
+        // Values decompressed while reading the previous version are no longer referenced
+        std::lock_guard lock(m_blob_cache_mutex);
+        m_blob_cache.reset();
+        // The leaf summaries are kept, as the leaves of a table which is not modified stay
+        // the same. The table drops them when it is, see Table::drop_leaf_summaries().
     }
 
     void update_from_underlying_allocator(bool writable)
@@ -133,6 +133,8 @@ void SlabAlloc::detach() noexcept
         case attach_None:
             break;
         case attach_UsersBuffer:
+            m_regions.clear();
+            m_xover_buffers.clear();
             break;
         case attach_OwnedBuffer:
             delete[] m_data;
@@ -252,9 +254,30 @@ SlabAlloc::FreeBlock* SlabAlloc::get_next_block_if_mergeable(SlabAlloc::FreeBloc
     return block_after(bb);
 }
 
+int SlabAlloc::find_small_bin(int size) const noexcept
+{
+    size_t bin_ndx = size_t(size) / 8;
+    if (bin_ndx >= num_small_bins)
+        return 0;
+    size_t word_ndx = bin_ndx / bits_per_word;
+    size_t bits = m_small_bins_used[word_ndx] & (~size_t(0) << (bin_ndx % bits_per_word));
+    while (!bits) {
+        if (++word_ndx == m_small_bins_used.size())
+            return 0;
+        bits = m_small_bins_used[word_ndx];
+    }
+    return int(word_ndx * bits_per_word + size_t(ctz(bits))) * 8;
+}
+
 SlabAlloc::FreeList SlabAlloc::find(int size)
 {
     FreeList retval;
+    if (size <= small_block_limit) {
+        retval.it = m_block_map.end();
+        if (m_small_bins[size / 8])
+            retval.size = size;
+        return retval;
+    }
     retval.it = m_block_map.lower_bound(size);
     if (retval.it != m_block_map.end()) {
         retval.size = retval.it->first;
@@ -268,15 +291,39 @@ SlabAlloc::FreeList SlabAlloc::find(int size)
 SlabAlloc::FreeList SlabAlloc::find_larger(FreeList hint, int size)
 {
     int needed_size = size + sizeof(BetweenBlocks) + sizeof(FreeBlock);
+    if (size <= small_block_limit) {
+        // The hint did not come from m_block_map
+        if (int bin_size = find_small_bin(needed_size)) {
+            hint.size = bin_size;
+            return hint;
+        }
+        hint.it = m_block_map.lower_bound(needed_size);
+    }
     while (hint.it != m_block_map.end() && hint.it->first < needed_size)
         ++hint.it;
     if (hint.it == m_block_map.end())
         hint.size = 0; // indicate "not found"
+    else
+        hint.size = hint.it->first;
     return hint;
 }
 
 SlabAlloc::FreeBlock* SlabAlloc::pop_freelist_entry(FreeList list)
 {
+    if (list.is_small()) {
+        size_t bin_ndx = size_t(list.size) / 8;
+        FreeBlock* retval = m_small_bins[bin_ndx];
+        FreeBlock* header = retval->next;
+        if (header == retval) {
+            m_small_bins[bin_ndx] = nullptr;
+            m_small_bins_used[bin_ndx / bits_per_word] &= ~(size_t(1) << (bin_ndx % bits_per_word));
+        }
+        else {
+            m_small_bins[bin_ndx] = header;
+        }
+        retval->unlink();
+        return retval;
+    }
     FreeBlock* retval = list.it->second;
     FreeBlock* header = retval->next;
     if (header == retval)
@@ -299,6 +346,20 @@ void SlabAlloc::FreeBlock::unlink()
 void SlabAlloc::remove_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
+    if (size <= small_block_limit) {
+        size_t bin_ndx = size_t(size) / 8;
+        FreeBlock*& header = m_small_bins[bin_ndx];
+        REALM_ASSERT_EX(header, get_file_path_for_assertions());
+        if (header == entry) {
+            header = entry->next;
+            if (header == entry) {
+                header = nullptr;
+                m_small_bins_used[bin_ndx / bits_per_word] &= ~(size_t(1) << (bin_ndx % bits_per_word));
+            }
+        }
+        entry->unlink();
+        return;
+    }
     auto it = m_block_map.find(size);
     REALM_ASSERT_EX(it != m_block_map.end(), get_file_path_for_assertions());
     auto header = it->second;
@@ -316,6 +377,22 @@ void SlabAlloc::push_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
     FreeBlock* header;
+    if (size <= small_block_limit) {
+        size_t bin_ndx = size_t(size) / 8;
+        header = m_small_bins[bin_ndx];
+        if (header) {
+            entry->next = header;
+            entry->prev = header->prev;
+            entry->prev->next = entry;
+            entry->next->prev = entry;
+        }
+        else {
+            entry->next = entry->prev = entry;
+            m_small_bins_used[bin_ndx / bits_per_word] |= size_t(1) << (bin_ndx % bits_per_word);
+        }
+        m_small_bins[bin_ndx] = entry;
+        return;
+    }
     auto it = m_block_map.find(size);
     if (it != m_block_map.end()) {
         header = it->second;
@@ -397,6 +474,8 @@ SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_st
 void SlabAlloc::clear_freelists()
 {
     m_block_map.clear();
+    m_small_bins.fill(nullptr);
+    m_small_bins_used.fill(0);
 }
 
 void SlabAlloc::rebuild_freelists_from_slab()
@@ -483,6 +562,8 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
     // Create new slab and add to list of slabs
     m_slabs.emplace_back(ref_end, new_size); // Throws
     const Slab& slab = m_slabs.back();
+    if (m_cfg.huge_page_slabs)
+        util::madvise(slab.addr, slab.size, util::MappingAdvice::HugePages);
     extend_fast_mapping_with_slab(slab.addr);
 
     // build a single block from that entry
@@ -896,6 +977,8 @@ ref_type SlabAlloc::attach_file(const std::string& file_path, Config& cfg)
     fcg.release(); // Do not close
 #if REALM_ENABLE_ENCRYPTION
     m_realm_file_info = util::get_file_info_for_file(m_file);
+    if (m_realm_file_info && cfg.decrypted_page_budget)
+        util::set_decrypted_page_budget(*m_realm_file_info, cfg.decrypted_page_budget);
 #endif
     return top_ref;
 }
@@ -920,6 +1003,17 @@ void SlabAlloc::note_reader_end(const void* reader_id) noexcept
 #endif
 }
 
+size_t SlabAlloc::release_decrypted_pages(bool include_recent)
+{
+#if REALM_ENABLE_ENCRYPTION
+    if (m_realm_file_info)
+        return util::reclaim_decrypted_pages(*m_realm_file_info, include_recent);
+#else
+    static_cast<void>(include_recent);
+#endif
+    return 0;
+}
+
 ref_type SlabAlloc::attach_buffer(const char* data, size_t size)
 {
     // ExceptionSafety: If this function throws, it must leave the allocator in
@@ -943,6 +1037,67 @@ ref_type SlabAlloc::attach_buffer(const char* data, size_t size)
 }
 
 
+ref_type SlabAlloc::attach_buffers(const std::vector<BinaryData>& regions)
+{
+    // ExceptionSafety: If this function throws, it must leave the allocator in
+    // the detached state.
+
+    REALM_ASSERT_EX(!is_attached(), get_file_path_for_assertions());
+    REALM_ASSERT(!regions.empty());
+
+    std::string path; // No path
+    size_t size = 0;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        if (REALM_UNLIKELY(i + 1 < regions.size() && regions[i].size() != section_size())) {
+            std::string msg = "Memory region " + util::to_string(i) + " has bad size (" +
+                              util::to_string(regions[i].size()) + ")";
+            throw InvalidDatabase(msg, path);
+        }
+        size += regions[i].size();
+    }
+    if (REALM_UNLIKELY(regions[0].size() < sizeof(Header))) {
+        std::string msg = "Realm file has bad size (" + util::to_string(size) + ")";
+        throw InvalidDatabase(msg, path);
+    }
+
+    // Verify the data structures. The footer may be split between the last
+    // two regions.
+    StreamingFooter footer = {0, 0};
+    if (size >= sizeof(Header) + sizeof footer)
+        copy_from_regions(regions, size - sizeof footer, reinterpret_cast<char*>(&footer), sizeof footer);
+    auto header = reinterpret_cast<const Header*>(regions[0].data());
+    ref_type top_ref = validate_header(header, &footer, size, path); // Throws
+
+    std::unique_ptr<RefTranslation[]> translations(new RefTranslation[regions.size()]);
+    for (size_t i = 0; i < regions.size(); ++i)
+        translations[i].mapping_addr = const_cast<char*>(regions[i].data());
+    m_regions = regions;                    // Throws
+    m_xover_buffers.resize(regions.size()); // Throws
+
+    m_data = regions[0].data();
+    m_baseline = align_size_to_section_boundary(size);
+    m_attach_mode = attach_UsersBuffer;
+
+    m_translation_table_size = regions.size();
+    m_ref_translation_ptr = translations.release();
+    return top_ref;
+}
+
+void SlabAlloc::copy_from_regions(const std::vector<BinaryData>& regions, size_t offset, char* dest,
+                                  size_t size) noexcept
+{
+    while (size > 0) {
+        size_t index = offset >> section_shift;
+        size_t offset_in_region = offset - get_section_base(index);
+        size_t n = std::min(size, regions[index].size() - offset_in_region);
+        realm::safe_copy_n(regions[index].data() + offset_in_region, n, dest);
+        offset += n;
+        dest += n;
+        size -= n;
+    }
+}
+
+
 void SlabAlloc::attach_empty()
 {
     // ExceptionSafety: If this function throws, it must leave the allocator in
@@ -1200,6 +1355,14 @@ void SlabAlloc::update_reader_view(size_t file_size)
     std::move(new_mappings.begin(), new_mappings.end(), std::back_inserter(m_mappings));
     m_baseline.store(file_size, std::memory_order_relaxed);
 
+    // The last old mapping may have been extended in place
+    if (m_cfg.mapping_advice != util::MappingAdvice::Normal && !m_file.get_encryption_key()) {
+        for (size_t k = old_num_mappings ? old_num_mappings - 1 : 0; k < m_mappings.size(); ++k) {
+            auto& mapping = m_mappings[k].primary_mapping;
+            util::madvise(mapping.get_addr(), mapping.get_size(), m_cfg.mapping_advice);
+        }
+    }
+
     const size_t ref_start = align_size_to_section_boundary(file_size);
     const size_t ref_displacement = ref_start - old_slab_base;
     if (ref_displacement > 0) {
@@ -1229,6 +1392,25 @@ void SlabAlloc::update_reader_view(size_t file_size)
     rebuild_translations(replace_last_mapping, old_num_mappings);
 }
 
+void SlabAlloc::prefetch(ref_type ref) const noexcept
+{
+    if (ref == 0 || ref >= m_baseline.load(std::memory_order_relaxed) || m_file.get_encryption_key())
+        return;
+    const char* header = translate(ref);
+    size_t size = NodeHeader::get_byte_size_from_header(header);
+    util::madvise(const_cast<char*>(header), size, util::MappingAdvice::WillNeed);
+}
+
+void SlabAlloc::prefetch(ref_type ref, size_t size) const noexcept
+{
+    size_t baseline = m_baseline.load(std::memory_order_relaxed);
+    if (ref == 0 || ref >= baseline || m_file.get_encryption_key())
+        return;
+    size_t end = std::min(ref + size, baseline);
+    end = std::min(end, get_section_base(get_section_index(ref) + 1));
+    util::madvise(translate(ref), end - ref, util::MappingAdvice::WillNeed);
+}
+
 size_t SlabAlloc::get_allocated_size() const noexcept
 {
     size_t sz = 0;
@@ -1308,6 +1490,17 @@ void SlabAlloc::get_or_add_xover_mapping(RefTranslation& txl, size_t index, size
         REALM_ASSERT(offset == txl.lowest_possible_xover_offset.load(std::memory_order_relaxed));
         return;
     }
+    if (m_attach_mode == attach_UsersBuffer) {
+        // The regions given to attach_buffers() are not contiguous, so the
+        // array has to be copied
+        REALM_ASSERT(index + 1 < m_regions.size());
+        std::unique_ptr<char[]> buffer(new char[size]);
+        copy_from_regions(m_regions, get_section_base(index) + offset, buffer.get(), size);
+        txl.xover_mapping_base = offset;
+        txl.xover_mapping_addr.store(buffer.get(), std::memory_order_release);
+        m_xover_buffers[index] = std::move(buffer);
+        return;
+    }
     MapEntry* map_entry = &m_mappings[index];
     REALM_ASSERT(map_entry->primary_mapping.get_addr() == txl.mapping_addr);
     if (!map_entry->xover_mapping.is_attached()) {
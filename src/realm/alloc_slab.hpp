@@ -20,6 +20,7 @@
 #define REALM_ALLOC_SLAB_HPP
 
 #include <cstdint> // unint8_t etc
+#include <array>
 #include <vector>
 #include <map>
 #include <string>
@@ -28,8 +29,10 @@
 
 #include <realm/util/features.h>
 #include <realm/util/file.hpp>
+#include <realm/util/file_mapper.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/alloc.hpp>
+#include <realm/binary_data.hpp>
 #include <realm/disable_sync_to_disk.hpp>
 
 namespace realm {
@@ -105,6 +108,17 @@ public:
     /// Always initialize the file as if it was a newly
     /// created file and ignore any pre-existing contents. Requires that
     /// Config::session_initiator be true as well.
+    ///
+    /// \var Config::mapping_advice
+    /// Hint given to the kernel for every mapping of the file. Not used for
+    /// encrypted files.
+    ///
+    /// \var Config::huge_page_slabs
+    /// Request transparent huge pages for the slabs.
+    ///
+    /// \var Config::decrypted_page_budget
+    /// If non-zero, the approximate number of bytes the decrypted pages of an
+    /// encrypted file may use.
     struct Config {
         bool is_shared = false;
         bool read_only = false;
@@ -114,6 +128,9 @@ public:
         bool clear_file = false;
         bool disable_sync = false;
         const char* encryption_key = nullptr;
+        util::MappingAdvice mapping_advice = util::MappingAdvice::Normal;
+        bool huge_page_slabs = false;
+        size_t decrypted_page_budget = 0;
     };
 
     struct Retry {
@@ -166,6 +183,23 @@ public:
     /// \throw InvalidDatabase
     ref_type attach_buffer(const char* data, size_t size);
 
+    /// Attach this allocator to a database held in a number of separate memory
+    /// regions, without copying it. Region `i` must hold the bytes of the
+    /// database starting at offset `i * section_size()`, and every region but
+    /// the last must be exactly section_size() bytes long. The regions are
+    /// used as they are, except that an array which extends from one region
+    /// into the next is copied into memory owned by the allocator when it is
+    /// first accessed. There can be at most one such array per region.
+    ///
+    /// The regions must remain valid and unchanged until the allocator is
+    /// detached. Attaching in this way is subject to the same restrictions
+    /// as attach_buffer().
+    ///
+    /// \return The `ref` of the root node, or zero if there is none.
+    ///
+    /// \throw InvalidDatabase
+    ref_type attach_buffers(const std::vector<BinaryData>& regions);
+
     /// Reads file format from file header. Must be called from within a write
     /// transaction.
     int get_committed_file_format_version() const noexcept;
@@ -297,6 +331,16 @@ public:
     void purge_old_mappings(uint64_t oldest_live_version, uint64_t youngest_live_version);
     void init_mapping_management(uint64_t currently_live_version);
 
+    /// Ask the kernel to start reading in the array at the specified ref from
+    /// the file, which will soon be needed. Only the header of the array is
+    /// read immediately. Does nothing for encrypted files or refs outside the
+    /// attached file.
+    void prefetch(ref_type ref) const noexcept;
+    /// Ask the kernel to start reading in the specified range of the file.
+    /// The range is cut at the end of the attached file and of the section
+    /// holding 'ref'.
+    void prefetch(ref_type ref, size_t size) const noexcept override;
+
     /// Get an ID for the current mapping version. This ID changes whenever any part
     /// of an existing mapping is changed. Such a change requires all refs to be
     /// retranslated to new pointers. This will happen whenever the reader view
@@ -328,6 +372,11 @@ public:
     void note_reader_start(const void* reader_id);
     void note_reader_end(const void* reader_id) noexcept;
 
+    /// Release the decrypted pages of an encrypted file which no reader can be
+    /// using (see util::reclaim_decrypted_pages()). Returns the number of
+    /// bytes released.
+    size_t release_decrypted_pages(bool include_recent);
+
     void verify() const override;
 #ifdef REALM_DEBUG
     void enable_debug(bool enable)
@@ -430,6 +479,17 @@ private:
     using FreeListMap = std::map<int, FreeBlock*>; // log(N) addressing for larger blocks
     FreeListMap m_block_map;
 
+    // Free blocks no larger than small_block_limit are kept in one freelist per
+    // size (all sizes are multiples of 8) instead of in m_block_map, so that
+    // the many small arrays of a write transaction can be allocated and freed
+    // in constant time. A bit is set in m_small_bins_used for each nonempty
+    // freelist.
+    static constexpr int small_block_limit = 1024;
+    static constexpr size_t num_small_bins = small_block_limit / 8 + 1;
+    static constexpr size_t bits_per_word = sizeof(size_t) * 8;
+    std::array<FreeBlock*, num_small_bins> m_small_bins = {};
+    std::array<size_t, (num_small_bins + bits_per_word - 1) / bits_per_word> m_small_bins_used = {};
+
     // abstract notion of a freelist - used to hide whether a freelist
     // is residing in the small blocks or the large blocks structures.
     struct FreeList {
@@ -443,6 +503,10 @@ private:
         {
             return size == sz;
         }
+        bool is_small()
+        {
+            return size <= small_block_limit;
+        }
     };
 
     // simple helper functions for accessing/navigating blocks and betweenblocks (TM)
@@ -495,6 +559,9 @@ private:
     void remove_freelist_entry(FreeBlock* element);
     void rebuild_freelists_from_slab();
     void clear_freelists();
+    // Returns the size of the smallest nonempty small bin holding blocks of
+    // at least the given size, or 0 if there is none.
+    int find_small_bin(int size) const noexcept;
 
     // grow the slab area.
     // returns a free block large enough to handle the request.
@@ -589,8 +656,15 @@ private:
     // added at the end.
     void extend_fast_mapping_with_slab(char* address);
     void get_or_add_xover_mapping(RefTranslation& txl, size_t index, size_t offset, size_t size) override;
+    // Copy bytes of the database held in the regions given to attach_buffers()
+    void copy_from_regions(const std::vector<BinaryData>& regions, size_t offset, char* dest,
+                           size_t size) noexcept;
 
     const char* m_data = nullptr;
+    // The memory regions attached by attach_buffers(), and copies of the
+    // arrays which cross from one of them into the next, indexed by region.
+    std::vector<BinaryData> m_regions;
+    std::vector<std::unique_ptr<char[]>> m_xover_buffers;
     size_t m_initial_section_size = 0;
     int m_section_shifts = 0;
     AttachMode m_attach_mode = attach_None;
@@ -84,8 +84,8 @@
 //
 // 'size' (aka length) is the number of elements in the array.
 //
-// 'checksum' (not yet implemented) is the checksum of the array
-// including the header.
+// 'checksum' is either "AAAA", or the CRC-32C of the array including the
+// header, but not the checksum itself (see NodeHeader::calc_checksum()).
 //
 //
 // Inner node of B+-tree:
@@ -277,13 +277,62 @@ void Array::destroy_children(size_t offset) noexcept
 }
 
 
+// Produce the frame-of-reference encoded form of this array, provided that it
+// holds plain integers and that the encoded form is smaller. Only arrays of at
+// least 16 bits are considered, as narrower ones have little to gain.
+std::unique_ptr<char[]> Array::encode(size_t& byte_size) const
+{
+    if (m_has_refs || m_is_encoded || m_width < 16 || m_size == 0)
+        return nullptr;
+    const char* header = get_header_from_data(m_data);
+    if (get_wtype_from_header(header) != wtype_Bits)
+        return nullptr;
+
+    int64_t min = get(0);
+    int64_t max = min;
+    for (size_t i = 1; i < m_size; ++i) {
+        int64_t v = get(i);
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+    uint64_t spread = uint64_t(max) - uint64_t(min);
+    if (spread > uint64_t(ubound_for_width(32)))
+        return nullptr;
+    size_t offsets_width = bit_width(int64_t(spread));
+    if (offsets_width >= m_width)
+        return nullptr;
+
+    size_t offsets_byte_size = calc_byte_size(wtype_Bits, m_size, uint_least8_t(offsets_width));
+    size_t encoded_byte_size = header_size + 8 + offsets_byte_size;
+    if (encoded_byte_size >= get_byte_size())
+        return nullptr;
+
+    std::unique_ptr<char[]> buffer(new char[encoded_byte_size]()); // Throws
+    char* encoded_header = buffer.get();
+    init_header(encoded_header, false, false, m_context_flag, wtype_Encoded, m_width, m_size, encoded_byte_size);
+    std::memcpy(get_data_from_header(encoded_header), &min, sizeof min);
+    char* offsets_header = get_data_from_header(encoded_header) + 8;
+    init_header(offsets_header, false, false, false, wtype_Bits, int(offsets_width), m_size, offsets_byte_size);
+    char* offsets = get_data_from_header(offsets_header);
+    for (size_t i = 0; i < m_size; ++i)
+        set_direct(offsets, offsets_width, i, int64_t(uint64_t(get(i)) - uint64_t(min)));
+    byte_size = encoded_byte_size;
+    return buffer;
+}
+
 ref_type Array::do_write_shallow(_impl::ArrayWriterBase& out) const
 {
     // Write flat array
     const char* header = get_header_from_data(m_data);
     size_t byte_size = get_byte_size();
-    uint32_t dummy_checksum = 0x41414141UL;                                // "AAAA" in ASCII
-    ref_type new_ref = out.write_array(header, byte_size, dummy_checksum); // Throws
+    std::unique_ptr<char[]> encoded;
+    if (out.encode_integer_leaves) {
+        encoded = encode(byte_size); // Throws
+        if (encoded)
+            header = encoded.get();
+    }
+    uint32_t checksum = out.checksum_arrays ? calc_checksum(header, byte_size) : unchecked_signature;
+    ref_type new_ref = out.write_array(header, byte_size, checksum); // Throws
     REALM_ASSERT_3(new_ref % 8, ==, 0);                                    // 8-byte alignment
     return new_ref;
 }
@@ -429,6 +478,10 @@ void Array::insert(size_t ndx, int_fast64_t value)
 {
     REALM_ASSERT_DEBUG(ndx <= m_size);
 
+    // The old getter must not outlive the encoded representation
+    if (REALM_UNLIKELY(m_is_encoded))
+        copy_on_write(); // Throws
+
     const auto old_width = m_width;
     const auto old_size = m_size;
     const Getter old_getter = m_getter; // Save old getter before potential width expansion
@@ -538,6 +591,10 @@ void Array::do_ensure_minimum_width(int_fast64_t value)
 
     REALM_ASSERT_3(width, >, m_width);
 
+    // The old getter must not outlive the encoded representation
+    if (REALM_UNLIKELY(m_is_encoded))
+        copy_on_write(); // Throws
+
     Getter old_getter = m_getter; // Save old getter before width expansion
     alloc(m_size, width);         // Throws
 
@@ -651,6 +708,13 @@ size_t find_zero(uint64_t v)
 
 int64_t Array::sum(size_t start, size_t end) const
 {
+    if (REALM_UNLIKELY(m_is_encoded)) {
+        if (end == size_t(-1))
+            end = m_size;
+        Array offsets(m_alloc);
+        init_offsets_accessor(offsets);
+        return int64_t(uint64_t(offsets.sum(start, end)) + uint64_t(m_encoded_base) * (end - start));
+    }
     REALM_TEMPEX(return sum, m_width, (start, end));
 }
 
@@ -822,6 +886,15 @@ int64_t Array::sum(size_t start, size_t end) const
 
 size_t Array::count(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_is_encoded)) {
+        Array offsets(m_alloc);
+        init_offsets_accessor(offsets);
+        int64_t offset = rebase_to_offsets(value, offsets);
+        if (offset < 0 || offset > offsets.m_ubound)
+            return 0;
+        return offsets.count(offset);
+    }
+
     const uint64_t* next = reinterpret_cast<uint64_t*>(m_data);
     size_t value_count = 0;
     const size_t end = m_size;
@@ -1026,6 +1099,17 @@ size_t Array::calc_aligned_byte_size(size_t size, int width)
 MemRef Array::clone(MemRef mem, Allocator& alloc, Allocator& target_alloc)
 {
     const char* header = mem.get_addr();
+    if (get_wtype_from_header(header) == wtype_Encoded) {
+        // Encoded arrays only live in read-only memory, so the clone is
+        // decoded.
+        size_t num_elems = get_size_from_header(header);
+        size_t size = calc_byte_size(wtype_Bits, num_elems, get_width_from_header(header));
+        MemRef clone_mem = target_alloc.alloc(size); // Throws
+        decode(header, num_elems, clone_mem.get_addr());
+        set_capacity_in_header(size, clone_mem.get_addr());
+        return clone_mem;
+    }
+
     if (!get_hasrefs_from_header(header)) {
         // This array has no subarrays, so we can make a byte-for-byte
         // copy, which is more efficient.
@@ -1137,6 +1221,13 @@ bool Array::find_vtable(int64_t value, size_t start, size_t end, size_t baseinde
     return ArrayWithFind(*this).find_optimized<cond, bitwidth>(value, start, end, baseindex, state, nullptr);
 }
 
+template <class cond>
+bool Array::find_vtable_encoded(int64_t value, size_t start, size_t end, size_t baseindex,
+                                QueryStateBase* state) const
+{
+    return ArrayWithFind(*this).find_encoded<cond>(value, start, end, baseindex, state, nullptr);
+}
+
 
 template <size_t width>
 struct Array::VTableForWidth {
@@ -1158,18 +1249,62 @@ struct Array::VTableForWidth {
 template <size_t width>
 const typename Array::VTableForWidth<width>::PopulatedVTable Array::VTableForWidth<width>::vtable;
 
+// Here 'width' is the width of the offsets. There is no setter, since encoded
+// arrays are decoded by copy_on_write() before they are modified.
+template <size_t width>
+struct Array::VTableForEncoded {
+    struct PopulatedVTable : Array::VTable {
+        PopulatedVTable()
+        {
+            getter = &Array::get_encoded<width>;
+            setter = nullptr;
+            chunk_getter = &Array::get_chunk_encoded<width>;
+            finder[cond_Equal] = &Array::find_vtable_encoded<Equal>;
+            finder[cond_NotEqual] = &Array::find_vtable_encoded<NotEqual>;
+            finder[cond_Greater] = &Array::find_vtable_encoded<Greater>;
+            finder[cond_Less] = &Array::find_vtable_encoded<Less>;
+        }
+    };
+    static const PopulatedVTable vtable;
+};
+
+template <size_t width>
+const typename Array::VTableForEncoded<width>::PopulatedVTable Array::VTableForEncoded<width>::vtable;
+
 void Array::update_width_cache_from_header() noexcept
 {
-    auto width = get_width_from_header(get_header());
+    const char* header = get_header();
+    auto width = get_width_from_header(header);
     m_lbound = lbound_for_width(width);
     m_ubound = ubound_for_width(width);
 
     m_width = width;
 
-    REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::vtable);
+    // For an encoded array the bounds above still describe the width it
+    // decodes to, while the vtable works on the offsets.
+    m_is_encoded = get_wtype_from_header(header) == wtype_Encoded;
+    if (REALM_UNLIKELY(m_is_encoded)) {
+        m_encoded_base = get_encoded_base(header);
+        auto offsets_width = get_width_from_header(get_encoded_offsets_header(header));
+        REALM_TEMPEX(m_vtable = &VTableForEncoded, offsets_width, ::vtable);
+    }
+    else {
+        REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::vtable);
+    }
     m_getter = m_vtable->getter;
 }
 
+template <size_t w>
+void Array::get_chunk_encoded(size_t ndx, int64_t res[8]) const noexcept
+{
+    REALM_ASSERT_3(ndx, <, m_size);
+    size_t i = 0;
+    for (; i + ndx < m_size && i < 8; i++)
+        res[i] = get_encoded<w>(ndx + i);
+    for (; i < 8; i++)
+        res[i] = 0;
+}
+
 // This method reads 8 concecutive values into res[8], starting from index 'ndx'. It's allowed for the 8 values to
 // exceed array length; in this case, remainder of res[8] will be left untouched.
 template <size_t w>
@@ -1335,11 +1470,21 @@ void Array::verify() const
 
 size_t Array::lower_bound_int(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_is_encoded)) {
+        Array offsets(m_alloc);
+        init_offsets_accessor(offsets);
+        return offsets.lower_bound_int(rebase_to_offsets(value, offsets));
+    }
     REALM_TEMPEX(return lower_bound, m_width, (m_data, m_size, value));
 }
 
 size_t Array::upper_bound_int(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_is_encoded)) {
+        Array offsets(m_alloc);
+        init_offsets_accessor(offsets);
+        return offsets.upper_bound_int(rebase_to_offsets(value, offsets));
+    }
     REALM_TEMPEX(return upper_bound, m_width, (m_data, m_size, value));
 }
 
@@ -1352,6 +1497,11 @@ size_t Array::find_first(int64_t value, size_t start, size_t end) const
 
 int_fast64_t Array::get(const char* header, size_t ndx) noexcept
 {
+    if (REALM_UNLIKELY(get_wtype_from_header(header) == wtype_Encoded)) {
+        const char* offsets_header = get_encoded_offsets_header(header);
+        return get_encoded_base(header) +
+               get_direct(get_data_from_header(offsets_header), get_width_from_header(offsets_header), ndx);
+    }
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
     return get_direct(data, width, ndx);
@@ -1360,6 +1510,8 @@ int_fast64_t Array::get(const char* header, size_t ndx) noexcept
 
 std::pair<int64_t, int64_t> Array::get_two(const char* header, size_t ndx) noexcept
 {
+    if (REALM_UNLIKELY(get_wtype_from_header(header) == wtype_Encoded))
+        return std::make_pair(get(header, ndx), get(header, ndx + 1));
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
     std::pair<int64_t, int64_t> p = ::get_two(data, width, ndx);
@@ -1399,3 +1551,15 @@ bool QueryStateFindAll<IntegerColumn>::match(size_t index, Mixed) noexcept
 
     return (m_limit > m_match_count);
 }
+
+template <>
+bool QueryStateFindAll<std::vector<ObjKey>>::match(size_t index, Mixed) noexcept
+{
+    ++m_match_count;
+
+    REALM_ASSERT(m_key_values);
+    int64_t key_value = m_key_values->get(index) + m_key_offset;
+    m_keys.push_back(ObjKey(key_value));
+
+    return (m_limit > m_match_count);
+}
@@ -160,6 +160,14 @@ public:
         return m_width;
     }
 
+    /// True if this array is stored frame-of-reference encoded (see
+    /// NodeHeader::get_encoded_base()). An encoded array behaves like a plain
+    /// one of the same width, and decodes when it is first modified.
+    bool is_encoded() const noexcept
+    {
+        return m_is_encoded;
+    }
+
     void insert(size_t ndx, int_fast64_t value);
     void add(int_fast64_t value);
 
@@ -476,6 +484,21 @@ private:
     int64_t sum(size_t start, size_t end) const;
 
 protected:
+    // Decode the array if it is encoded, and refresh the cached width
+    // information accordingly.
+    void copy_on_write()
+    {
+        Node::copy_on_write(); // Throws
+        if (REALM_UNLIKELY(m_is_encoded))
+            update_width_cache_from_header();
+    }
+    void copy_on_write(size_t min_size)
+    {
+        Node::copy_on_write(min_size); // Throws
+        if (REALM_UNLIKELY(m_is_encoded))
+            update_width_cache_from_header();
+    }
+
     /// It is an error to specify a non-zero value unless the width
     /// type is wtype_Bits. It is also an error to specify a non-zero
     /// size if the width type is wtype_Ignore.
@@ -504,14 +527,36 @@ protected:
     };
     template <size_t w>
     struct VTableForWidth;
+    template <size_t w>
+    struct VTableForEncoded;
 
     // This is the one installed into the m_vtable->finder slots.
     template <class cond, size_t bitwidth>
     bool find_vtable(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
 
+    template <class cond>
+    bool find_vtable_encoded(int64_t value, size_t start, size_t end, size_t baseindex,
+                             QueryStateBase* state) const;
+
     template <size_t w>
     int64_t get_universal(const char* const data, const size_t ndx) const;
 
+    // Getters for encoded arrays. 'w' is the width of the offsets.
+    template <size_t w>
+    int64_t get_encoded(size_t ndx) const noexcept;
+    template <size_t w>
+    void get_chunk_encoded(size_t ndx, int64_t res[8]) const noexcept;
+
+    /// Attach \a offsets to the plain array of offsets embedded in this
+    /// encoded array.
+    void init_offsets_accessor(Array& offsets) const noexcept;
+
+    /// Map \a value onto the offsets of this encoded array. Values below the
+    /// base map to -1, and values beyond what the offsets can hold map to one
+    /// past their upper bound, so that comparing against the offsets gives the
+    /// same result as comparing against the decoded elements.
+    int64_t rebase_to_offsets(int64_t value, const Array& offsets) const noexcept;
+
 protected:
     /// Takes a 64-bit value and returns the minimum number of bits needed
     /// to fit the value. For alignment this is rounded up to nearest
@@ -531,8 +576,11 @@ protected:
     bool m_is_inner_bptree_node; // This array is an inner node of B+-tree.
     bool m_has_refs;             // Elements whose first bit is zero are refs to subarrays.
     bool m_context_flag;         // Meaning depends on context.
+    bool m_is_encoded = false;   // Elements are stored as offsets from m_encoded_base.
+    int64_t m_encoded_base = 0;
 
 private:
+    std::unique_ptr<char[]> encode(size_t& byte_size) const;
     ref_type do_write_shallow(_impl::ArrayWriterBase&) const;
     ref_type do_write_deep(_impl::ArrayWriterBase&, bool only_if_modified) const;
 
@@ -708,6 +756,28 @@ int64_t Array::get(size_t ndx) const noexcept
     return get_universal<w>(m_data, ndx);
 }
 
+template <size_t w>
+int64_t Array::get_encoded(size_t ndx) const noexcept
+{
+    return m_encoded_base + get_universal<w>(m_data + encoded_prefix_size, ndx);
+}
+
+inline void Array::init_offsets_accessor(Array& offsets) const noexcept
+{
+    REALM_ASSERT_DEBUG(m_is_encoded);
+    char* offsets_header = m_data + 8;
+    offsets.init_from_mem(MemRef(offsets_header, m_ref + header_size + 8, m_alloc));
+}
+
+inline int64_t Array::rebase_to_offsets(int64_t value, const Array& offsets) const noexcept
+{
+    if (value < m_encoded_base)
+        return -1;
+    // The offsets are at most 32 bits wide, as they are always narrower than the array itself
+    uint64_t offset = uint64_t(value) - uint64_t(m_encoded_base);
+    return offset > uint64_t(offsets.m_ubound) ? offsets.m_ubound + 1 : int64_t(offset);
+}
+
 inline int64_t Array::get(size_t ndx) const noexcept
 {
     REALM_ASSERT_DEBUG(is_attached());
@@ -928,6 +998,8 @@ inline void Array::adjust(size_t begin, size_t end, int_fast64_t diff)
 inline size_t Array::get_byte_size() const noexcept
 {
     const char* header = get_header_from_data(m_data);
+    if (m_is_encoded)
+        return get_byte_size_from_header(header);
     WidthType wtype = Node::get_wtype_from_header(header);
     size_t num_bytes = NodeHeader::calc_byte_size(wtype, m_size, m_width);
 
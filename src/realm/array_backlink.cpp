@@ -96,6 +96,31 @@ void ArrayBacklink::add(size_t ndx, ObjKey key)
     backlink_list.add(key.value); // Throws
 }
 
+void ArrayBacklink::add(size_t ndx, const std::vector<ObjKey>& keys)
+{
+    if (keys.size() < 2) {
+        if (!keys.empty())
+            add(ndx, keys[0]); // Throws
+        return;
+    }
+
+    uint64_t value = Array::get(ndx);
+    Array backlink_list(m_alloc);
+    if (value == 0 || (value & 1) != 0) {
+        backlink_list.create(Array::type_Normal);
+        set_as_ref(ndx, backlink_list.get_ref());
+        if (value != 0)
+            backlink_list.add(value >> 1);
+    }
+    else {
+        backlink_list.init_from_ref(to_ref(value));
+    }
+    // The list may be reallocated while growing
+    backlink_list.set_parent(this, ndx);
+    for (auto key : keys)
+        backlink_list.add(key.value); // Throws
+}
+
 // Return true if the last link was removed
 bool ArrayBacklink::remove(size_t ndx, ObjKey key)
 {
@@ -71,6 +71,8 @@ public:
     // nullify forward links corresponding to any backward links at index 'ndx'
     void nullify_fwd_links(size_t ndx, CascadeState& state);
     void add(size_t ndx, ObjKey key);
+    // Adds all of 'keys' with a single conversion to a list, if any is needed
+    void add(size_t ndx, const std::vector<ObjKey>& keys);
     bool remove(size_t ndx, ObjKey key);
     void erase(size_t ndx);
     size_t get_backlink_count(size_t ndx) const;
@@ -18,6 +18,7 @@
 
 #include <realm/array_binary.hpp>
 #include <realm/mixed.hpp>
+#include <realm/spec.hpp>
 
 using namespace realm;
 
@@ -47,6 +48,7 @@ void ArrayBinary::init_from_mem(MemRef mem) noexcept
     else {
         auto arr = new (&m_storage.m_big_blobs) ArrayBigBlobs(m_alloc, true);
         arr->init_from_mem(mem);
+        arr->set_compress(m_compress);
     }
 
     m_arr->set_parent(parent, ndx_in_parent);
@@ -59,6 +61,11 @@ void ArrayBinary::init_from_parent()
     init_from_ref(ref);
 }
 
+void ArrayBinary::set_spec(Spec* spec, size_t col_ndx) const
+{
+    m_compress = spec->get_column_attr(col_ndx).test(col_attr_Compressed);
+}
+
 size_t ArrayBinary::size() const
 {
     if (!m_is_big) {
@@ -173,7 +180,7 @@ void ArrayBinary::clear()
     }
 }
 
-size_t ArrayBinary::find_first(BinaryData value, size_t begin, size_t end) const noexcept
+size_t ArrayBinary::find_first(BinaryData value, size_t begin, size_t end) const
 {
     if (!m_is_big) {
         return static_cast<ArraySmallBlobs*>(m_arr)->find_first(value, false, begin, end);
@@ -209,6 +216,7 @@ bool ArrayBinary::upgrade_leaf(size_t value_size)
     arr->init_from_mem(big_blobs.get_mem());
     arr->set_parent(parent, ndx_in_parent);
     arr->update_parent(); // Throws
+    arr->set_compress(m_compress);
 
     m_is_big = true;
     return true;
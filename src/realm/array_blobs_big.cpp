@@ -17,19 +17,215 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
 
 #include <realm/array_blobs_big.hpp>
 #include <realm/column_integer.hpp>
+#include <realm/util/compression.hpp>
 
 
 using namespace realm;
 
-BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const noexcept
+namespace realm {
+
+// Holds the most recently read values decompressed through one allocator, up
+// to ArrayBigBlobs::decompressed_cache_size bytes. Entries are looked up by
+// ref and the storage version of the allocator. A read-only ref cannot change
+// before the allocator moves on to another version, which discards the whole
+// cache. A writable ref may be freed and reused for another value, but every
+// allocation bumps the storage version (see WrappedAllocator), so the old
+// entry is then no longer found.
+class DecompressedBlobCache {
+public:
+    struct Key {
+        ref_type ref;
+        uint_fast64_t version;
+        bool operator==(const Key& other) const noexcept
+        {
+            return ref == other.ref && version == other.version;
+        }
+    };
+
+    const char* get(Key key, const char* compressed, size_t compressed_size, size_t value_size)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            auto i = m_index.find(key);
+            if (i != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, i->second);
+                return i->second->value.get();
+            }
+        }
+
+        // Decompress without holding the lock
+        auto value = std::make_unique<char[]>(value_size + 1); // Throws
+        std::error_code ec =
+            util::compression::decompress({compressed, compressed_size}, {value.get(), value_size}); // Throws
+        if (ec)
+            throw std::runtime_error(util::format("Could not decompress value: %1", ec.message()));
+        value[value_size] = '\0';
+
+        std::lock_guard lock(m_mutex);
+        auto i = m_index.find(key);
+        if (i != m_index.end()) {
+            // Decompressed by another thread in the meantime
+            m_entries.splice(m_entries.begin(), m_entries, i->second);
+            return i->second->value.get();
+        }
+        m_entries.push_front(Entry{key, std::move(value), value_size + 1}); // Throws
+        m_index.emplace(key, m_entries.begin());                             // Throws
+        m_size += value_size + 1;
+        evict();
+        return m_entries.front().value.get();
+    }
+
+    void pin() noexcept
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_num_pins;
+    }
+
+    void unpin() noexcept
+    {
+        std::lock_guard lock(m_mutex);
+        --m_num_pins;
+        evict();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        std::unique_ptr<char[]> value;
+        size_t size;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept
+        {
+            return std::hash<uint64_t>()(uint64_t(key.ref) ^ (uint64_t(key.version) << 32));
+        }
+    };
+
+    std::mutex m_mutex;
+    // Most recently read first
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+    size_t m_size = 0;
+    size_t m_num_pins = 0;
+
+    // The most recently read value is kept even if it exceeds the limit on
+    // its own, as the caller is about to use it.
+    void evict() noexcept
+    {
+        if (m_num_pins > 0)
+            return;
+        while (m_size > ArrayBigBlobs::decompressed_cache_size && m_entries.size() > 1) {
+            Entry& entry = m_entries.back();
+            m_size -= entry.size;
+            m_index.erase(entry.key);
+            m_entries.pop_back();
+        }
+    }
+};
+
+} // namespace realm
+
+std::shared_ptr<DecompressedBlobCache> ArrayBigBlobs::get_cache(Allocator& alloc)
+{
+    std::lock_guard lock(alloc.m_blob_cache_mutex);
+    if (!alloc.m_blob_cache)
+        alloc.m_blob_cache = std::make_shared<DecompressedBlobCache>(); // Throws
+    return alloc.m_blob_cache;
+}
+
+ArrayBigBlobs::DecompressedPin::DecompressedPin(Allocator& alloc)
+    : m_cache(get_cache(alloc)) // Throws
+{
+    m_cache->pin();
+}
+
+ArrayBigBlobs::DecompressedPin::DecompressedPin(const DecompressedPin& other)
+    : m_cache(other.m_cache)
+{
+    m_cache->pin();
+}
+
+ArrayBigBlobs::DecompressedPin::~DecompressedPin()
+{
+    m_cache->unpin();
+}
+
+BinaryData ArrayBigBlobs::get_compressed(ref_type blob_ref, const char* blob_header, Allocator& alloc)
+{
+    const char* data = ArrayBlob::get(blob_header, 0);
+    size_t blob_size = get_size_from_header(blob_header);
+    uint64_t tag;
+    std::memcpy(&tag, data, sizeof tag);
+    size_t value_size = size_t(tag >> 1);
+    bool zero_term = (tag & 1) != 0;
+
+    DecompressedBlobCache::Key key{blob_ref, alloc.is_read_only(blob_ref) ? 0 : alloc.get_storage_version()};
+    const char* value = get_cache(alloc)->get(key, data + sizeof tag, blob_size - sizeof tag, value_size); // Throws
+    return BinaryData(value, value_size + (zero_term ? 1 : 0));
+}
+
+size_t ArrayBigBlobs::get_uncompressed_size(const char* blob_header) noexcept
+{
+    uint64_t tag;
+    std::memcpy(&tag, ArrayBlob::get(blob_header, 0), sizeof tag);
+    return size_t(tag >> 1) + size_t(tag & 1);
+}
+
+ref_type ArrayBigBlobs::create_blob(BinaryData value, bool add_zero_term)
+{
+    if (m_compress && value.size() >= compress_min_size && value.size() <= ArrayBlob::max_binary_size) {
+        if (ref_type ref = create_compressed_blob(value, add_zero_term)) // Throws
+            return ref;
+    }
+    ArrayBlob new_blob(m_alloc);
+    new_blob.create();                                                // Throws
+    return new_blob.add(value.data(), value.size(), add_zero_term); // Throws
+}
+
+// Returns zero if compression does not make the value smaller
+ref_type ArrayBigBlobs::create_compressed_blob(BinaryData value, bool add_zero_term)
+{
+    size_t bound = util::compression::compress_bound(value.size());
+    if (bound == 0)
+        return 0;
+    std::unique_ptr<char[]> buffer = std::make_unique<char[]>(bound); // Throws
+    size_t compressed_size;
+    std::error_code ec =
+        util::compression::compress({value.data(), value.size()}, {buffer.get(), bound}, compressed_size); // Throws
+    uint64_t tag = (uint64_t(value.size()) << 1) | (add_zero_term ? 1 : 0);
+    size_t blob_size = sizeof tag + compressed_size;
+    if (ec || blob_size >= value.size())
+        return 0;
+
+    size_t byte_size = (header_size + blob_size + 7) & ~size_t(7);
+    MemRef mem = m_alloc.alloc(byte_size); // Throws
+    char* header = mem.get_addr();
+    init_header(header, false, false, false, wtype_Multiply, 1, blob_size, byte_size);
+    char* data = get_data_from_header(header);
+    std::memcpy(data, &tag, sizeof tag);
+    std::memcpy(data + sizeof tag, buffer.get(), compressed_size);
+    return mem.get_ref();
+}
+
+BinaryData ArrayBigBlobs::get_at(size_t ndx, size_t& pos) const
 {
     ref_type ref = get_as_ref(ndx);
     if (ref == 0)
         return {}; // realm::null();
 
+    const char* blob_header = m_alloc.translate(ref);
+    if (is_compressed_blob(blob_header)) {
+        // A compressed value is always returned in one piece
+        pos = 0;
+        return get_compressed(ref, blob_header, m_alloc);
+    }
+
     ArrayBlob blob(m_alloc);
     blob.init_from_ref(ref);
 
@@ -45,10 +241,8 @@ void ArrayBigBlobs::add(BinaryData value, bool add_zero_term)
         Array::add(0); // Throws
     }
     else {
-        ArrayBlob new_blob(m_alloc);
-        new_blob.create();                                                      // Throws
-        ref_type ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
-        Array::add(from_ref(ref));                                              // Throws
+        ref_type ref = create_blob(value, add_zero_term); // Throws
+        Array::add(from_ref(ref));                        // Throws
     }
 }
 
@@ -64,15 +258,20 @@ void ArrayBigBlobs::set(size_t ndx, BinaryData value, bool add_zero_term)
         return;
     }
     else if (ref == 0 && value.data() != nullptr) {
-        ArrayBlob new_blob(m_alloc);
-        new_blob.create();                                             // Throws
-        ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
+        ref = create_blob(value, add_zero_term); // Throws
         Array::set_as_ref(ndx, ref);
         return;
     }
     else if (ref != 0 && value.data() != nullptr) {
         char* header = m_alloc.translate(ref);
-        if (Array::get_context_flag_from_header(header)) {
+        if (is_compressed_blob(header) || (m_compress && value.size() >= compress_min_size)) {
+            // Compressed blobs are never modified in place. The new blob is
+            // created before the old one is freed, as `value` may point into it.
+            ref_type new_ref = create_blob(value, add_zero_term); // Throws
+            Array::set_as_ref(ndx, new_ref);
+            Array::destroy_deep(ref, m_alloc);
+        }
+        else if (Array::get_context_flag_from_header(header)) {
             Array arr(m_alloc);
             arr.init_from_mem(MemRef(header, ref, m_alloc));
             arr.set_parent(this, ndx);
@@ -111,16 +310,13 @@ void ArrayBigBlobs::insert(size_t ndx, BinaryData value, bool add_zero_term)
         Array::insert(ndx, 0); // Throws
     }
     else {
-        ArrayBlob new_blob(m_alloc);
-        new_blob.create();                                                      // Throws
-        ref_type ref = new_blob.add(value.data(), value.size(), add_zero_term); // Throws
-
-        Array::insert(ndx, int64_t(ref)); // Throws
+        ref_type ref = create_blob(value, add_zero_term); // Throws
+        Array::insert(ndx, int64_t(ref));                 // Throws
     }
 }
 
 
-size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size_t end) const
 {
     size_t num_matches = 0;
 
@@ -137,7 +333,7 @@ size_t ArrayBigBlobs::count(BinaryData value, bool is_string, size_t begin, size
 }
 
 
-size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const noexcept
+size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin, size_t end) const
 {
     if (end == npos)
         end = m_size;
@@ -160,6 +356,15 @@ size_t ArrayBigBlobs::find_first(BinaryData value, bool is_string, size_t begin,
             ref_type ref = get_as_ref(i);
             if (ref) {
                 const char* blob_header = get_alloc().translate(ref);
+                if (is_compressed_blob(blob_header)) {
+                    // Only decompress values of the right size
+                    if (get_uncompressed_size(blob_header) == full_size) {
+                        BinaryData blob_value = get_compressed(ref, blob_header, m_alloc);
+                        if (std::equal(blob_value.data(), blob_value.data() + value_size, value.data()))
+                            return i;
+                    }
+                    continue;
+                }
                 size_t sz = get_size_from_header(blob_header);
                 if (sz == full_size) {
                     const char* blob_value = ArrayBlob::get(blob_header, 0);
@@ -19,24 +19,59 @@
 #ifndef REALM_ARRAY_BIG_BLOBS_HPP
 #define REALM_ARRAY_BIG_BLOBS_HPP
 
+#include <memory>
+
 #include <realm/array_blob.hpp>
 
 namespace realm {
 
 
+/// A blob of this array is either a plain ArrayBlob holding the value, an array
+/// of ArrayBlobs (marked by the context flag) holding a value too large for a
+/// single node, or a compressed blob. A compressed blob is an ArrayBlob with
+/// width type `wtype_Multiply` and width 1, whose payload is a 64-bit tag
+/// (uncompressed size shifted left by one, or'ed with 1 if a terminating zero
+/// follows the value) followed by the zlib compressed value.
+///
+/// Values are compressed only when set_compress(true) has been called, the
+/// value is at least `compress_min_size` bytes, and compression makes it
+/// smaller. Compressed values are decompressed into a cache owned by the
+/// allocator, which keeps the most recently read values up to a total of
+/// `decompressed_cache_size` bytes. The data returned by get() for a
+/// compressed value therefore stays valid until that many bytes of other
+/// compressed values have been read through the same allocator, or the
+/// allocator moves on to another version. Code which holds on to many values
+/// at once must keep a DecompressedPin. Reading a compressed value which
+/// cannot be decompressed throws.
 class ArrayBigBlobs : public Array {
 public:
     typedef BinaryData value_type;
 
+    static constexpr size_t compress_min_size = 256;
+    static constexpr size_t decompressed_cache_size = 64 * 1024 * 1024;
+
+    /// While a pin exists, no values decompressed through the allocator are
+    /// dropped from its cache, however large it grows.
+    class DecompressedPin {
+    public:
+        explicit DecompressedPin(Allocator&);
+        DecompressedPin(const DecompressedPin&);
+        DecompressedPin& operator=(const DecompressedPin&) = delete;
+        ~DecompressedPin();
+
+    private:
+        std::shared_ptr<DecompressedBlobCache> m_cache;
+    };
+
     explicit ArrayBigBlobs(Allocator&, bool nullable) noexcept;
 
     // Disable copying, this is not allowed.
     ArrayBigBlobs& operator=(const ArrayBigBlobs&) = delete;
     ArrayBigBlobs(const ArrayBigBlobs&) = delete;
 
-    BinaryData get(size_t ndx) const noexcept;
+    BinaryData get(size_t ndx) const;
     bool is_null(size_t ndx) const;
-    BinaryData get_at(size_t ndx, size_t& pos) const noexcept;
+    BinaryData get_at(size_t ndx, size_t& pos) const;
     void set(size_t ndx, BinaryData value, bool add_zero_term = false);
     void add(BinaryData value, bool add_zero_term = false);
     void insert(size_t ndx, BinaryData value, bool add_zero_term = false);
@@ -45,8 +80,8 @@ public:
     void clear();
     void destroy();
 
-    size_t count(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const noexcept;
-    size_t find_first(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const noexcept;
+    size_t count(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const;
+    size_t find_first(BinaryData value, bool is_string = false, size_t begin = 0, size_t end = npos) const;
     void find_all(IntegerColumn& result, BinaryData value, bool is_string = false, size_t add_offset = 0,
                   size_t begin = 0, size_t end = npos);
 
@@ -54,17 +89,17 @@ public:
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
     /// slower.
-    static BinaryData get(const char* header, size_t ndx, Allocator&) noexcept;
+    static BinaryData get(const char* header, size_t ndx, Allocator&);
 
     //@{
     /// Those that return a string, discard the terminating zero from
     /// the stored value. Those that accept a string argument, add a
     /// terminating zero before storing the value.
-    StringData get_string(size_t ndx) const noexcept;
+    StringData get_string(size_t ndx) const;
     void add_string(StringData value);
     void set_string(size_t ndx, StringData value);
     void insert_string(size_t ndx, StringData value);
-    static StringData get_string(const char* header, size_t ndx, Allocator&, bool nullable) noexcept;
+    static StringData get_string(const char* header, size_t ndx, Allocator&, bool nullable);
     //@}
 
     /// Create a new empty big blobs array and attach this accessor to
@@ -75,10 +110,29 @@ public:
     /// underlying node. It is not owned by the accessor.
     void create();
 
+    /// Controls whether values are compressed when they are stored by this
+    /// accessor. Values can be read regardless of this setting.
+    void set_compress(bool compress) noexcept
+    {
+        m_compress = compress;
+    }
+
     void verify() const;
 
 private:
     bool m_nullable;
+    bool m_compress = false;
+
+    ref_type create_blob(BinaryData value, bool add_zero_term);
+    ref_type create_compressed_blob(BinaryData value, bool add_zero_term);
+
+    static bool is_compressed_blob(const char* blob_header) noexcept
+    {
+        return get_wtype_from_header(blob_header) == wtype_Multiply;
+    }
+    static BinaryData get_compressed(ref_type blob_ref, const char* blob_header, Allocator&);
+    static std::shared_ptr<DecompressedBlobCache> get_cache(Allocator&);
+    static size_t get_uncompressed_size(const char* blob_header) noexcept;
 };
 
 
@@ -90,13 +144,15 @@ inline ArrayBigBlobs::ArrayBigBlobs(Allocator& allocator, bool nullable) noexcep
 {
 }
 
-inline BinaryData ArrayBigBlobs::get(size_t ndx) const noexcept
+inline BinaryData ArrayBigBlobs::get(size_t ndx) const
 {
     ref_type ref = get_as_ref(ndx);
     if (ref == 0)
         return {}; // realm::null();
 
     const char* blob_header = get_alloc().translate(ref);
+    if (is_compressed_blob(blob_header))
+        return get_compressed(ref, blob_header, get_alloc());
     if (!get_context_flag_from_header(blob_header)) {
         const char* value = ArrayBlob::get(blob_header, 0);
         size_t sz = get_size_from_header(blob_header);
@@ -111,13 +167,15 @@ inline bool ArrayBigBlobs::is_null(size_t ndx) const
     return ref == 0;
 }
 
-inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator& alloc) noexcept
+inline BinaryData ArrayBigBlobs::get(const char* header, size_t ndx, Allocator& alloc)
 {
     ref_type blob_ref = to_ref(Array::get(header, ndx));
     if (blob_ref == 0)
         return {};
 
     const char* blob_header = alloc.translate(blob_ref);
+    if (is_compressed_blob(blob_header))
+        return get_compressed(blob_ref, blob_header, alloc);
     if (!get_context_flag_from_header(blob_header)) {
         const char* blob_data = Array::get_data_from_header(blob_header);
         size_t sz = Array::get_size_from_header(blob_header);
@@ -150,7 +208,7 @@ inline void ArrayBigBlobs::destroy()
     Array::destroy_deep();
 }
 
-inline StringData ArrayBigBlobs::get_string(size_t ndx) const noexcept
+inline StringData ArrayBigBlobs::get_string(size_t ndx) const
 {
     BinaryData bin = get(ndx);
     if (bin.is_null())
@@ -184,7 +242,7 @@ inline void ArrayBigBlobs::insert_string(size_t ndx, StringData value)
 }
 
 inline StringData ArrayBigBlobs::get_string(const char* header, size_t ndx, Allocator& alloc,
-                                            bool nullable = true) noexcept
+                                            bool nullable = true)
 {
     static_cast<void>(nullable);
     BinaryData bin = get(header, ndx, alloc);
@@ -19,12 +19,42 @@
 #include <realm/array_decimal128.hpp>
 #include <realm/mixed.hpp>
 
+#include <vector>
+
 namespace realm {
 
+size_t ArrayDecimal128::width_for(Decimal128 value, uint64_t& compact) const
+{
+    // An empty leaf may start over in the compact form, if the file allows it
+    bool may_be_compact =
+        is_compact() || (m_size == 0 && m_alloc.is_encoding_enabled(Allocator::encoding_CompactDecimals));
+    if (may_be_compact && to_compact(value, compact))
+        return sizeof(uint64_t);
+    return sizeof(Decimal128);
+}
+
+void ArrayDecimal128::expand()
+{
+    REALM_ASSERT(is_compact());
+    std::vector<Decimal128> values;
+    values.reserve(m_size);
+    for (size_t i = 0; i < m_size; ++i)
+        values.push_back(get(i));
+    alloc(m_size, sizeof(Decimal128)); // Throws
+    std::copy(values.begin(), values.end(), reinterpret_cast<Decimal128*>(m_data));
+}
+
 void ArrayDecimal128::set(size_t ndx, Decimal128 value)
 {
     REALM_ASSERT(ndx < m_size);
     copy_on_write();
+    uint64_t compact;
+    if (width_for(value, compact) == sizeof(uint64_t)) {
+        reinterpret_cast<uint64_t*>(m_data)[ndx] = compact;
+        return;
+    }
+    if (is_compact())
+        expand(); // Throws
     auto values = reinterpret_cast<Decimal128*>(m_data);
     values[ndx] = value;
 }
@@ -32,17 +62,25 @@ void ArrayDecimal128::set(size_t ndx, Decimal128 value)
 void ArrayDecimal128::insert(size_t ndx, Decimal128 value)
 {
     REALM_ASSERT(ndx <= m_size);
-    // Allocate room for the new value
-    alloc(m_size + 1, sizeof(Decimal128)); // Throws
+    uint64_t compact;
+    size_t width = width_for(value, compact);
+    if (is_compact() && width != sizeof(uint64_t))
+        expand(); // Throws
 
-    auto src = reinterpret_cast<Decimal128*>(m_data) + ndx;
-    auto dst = src + 1;
+    // Allocate room for the new value
+    alloc(m_size + 1, width); // Throws
 
     // Make gap for new value
-    memmove(dst, src, sizeof(Decimal128) * (m_size - 1 - ndx));
+    char* src = m_data + ndx * width;
+    memmove(src + width, src, width * (m_size - 1 - ndx));
 
     // Set new value
-    *src = value;
+    if (width == sizeof(uint64_t)) {
+        *reinterpret_cast<uint64_t*>(src) = compact;
+    }
+    else {
+        *reinterpret_cast<Decimal128*>(src) = value;
+    }
 }
 
 void ArrayDecimal128::erase(size_t ndx)
@@ -51,10 +89,9 @@ void ArrayDecimal128::erase(size_t ndx)
 
     copy_on_write();
 
-    Decimal128* dst = reinterpret_cast<Decimal128*>(m_data) + ndx;
-    Decimal128* src = dst + 1;
-
-    memmove(dst, src, sizeof(Decimal128) * (m_size - ndx));
+    size_t width = get_width();
+    char* dst = m_data + ndx * width;
+    memmove(dst, dst + width, width * (m_size - 1 - ndx));
 
     // Update size (also in header)
     m_size -= 1;
@@ -65,11 +102,16 @@ void ArrayDecimal128::move(ArrayDecimal128& dst_arr, size_t ndx)
 {
     size_t elements_to_move = m_size - ndx;
     if (elements_to_move) {
-        const auto old_dst_size = dst_arr.m_size;
-        dst_arr.alloc(old_dst_size + elements_to_move, sizeof(Decimal128));
-        Decimal128* dst = reinterpret_cast<Decimal128*>(dst_arr.m_data) + old_dst_size;
-        Decimal128* src = reinterpret_cast<Decimal128*>(m_data) + ndx;
-        memmove(dst, src, elements_to_move * sizeof(Decimal128));
+        size_t width = get_width();
+        if (dst_arr.m_size == 0 || dst_arr.get_width() == width) {
+            const auto old_dst_size = dst_arr.m_size;
+            dst_arr.alloc(old_dst_size + elements_to_move, width);
+            memmove(dst_arr.m_data + old_dst_size * width, m_data + ndx * width, elements_to_move * width);
+        }
+        else {
+            for (size_t i = ndx; i < m_size; ++i)
+                dst_arr.add(get(i)); // Throws
+        }
     }
     truncate(ndx);
 }
@@ -81,14 +123,61 @@ size_t ArrayDecimal128::find_first(Decimal128 value, size_t start, size_t end) c
         end = sz;
     REALM_ASSERT(start <= sz && end <= sz && start <= end);
 
-    auto values = reinterpret_cast<Decimal128*>(this->m_data);
     for (size_t i = start; i < end; i++) {
-        if (values[i] == value)
+        if (get(i) == value)
             return i;
     }
     return realm::npos;
 }
 
+Decimal128 ArrayDecimal128::sum(size_t& count) const
+{
+    Decimal128 result(0);
+    count = 0;
+    if (!is_compact()) {
+        for (size_t i = 0; i < m_size; ++i) {
+            Decimal128 value = get(i);
+            if (!value.is_null() && !value.is_nan()) {
+                result += value;
+                ++count;
+            }
+        }
+        return result;
+    }
+
+    // Runs of values with the same exponent are summed as integers. A
+    // coefficient has at most 49 bits, so an int64_t holds the sum of more
+    // values than a leaf has.
+    static_assert(REALM_MAX_BPNODE_SIZE <= (1 << 13));
+    auto values = reinterpret_cast<const uint64_t*>(m_data);
+    constexpr uint64_t sign_mask = uint64_t(1) << 63;
+    constexpr uint64_t exponent_mask = ~(sign_mask | compact_coefficient_mask);
+    uint64_t exponent = 0;
+    int64_t run_sum = 0;
+    auto flush = [&] {
+        if (run_sum != 0) {
+            uint64_t sign = run_sum < 0 ? sign_mask : 0;
+            uint64_t coefficient = run_sum < 0 ? 0 - uint64_t(run_sum) : uint64_t(run_sum);
+            result += Decimal128(Decimal128::Bid128{{coefficient, sign | exponent}});
+        }
+        run_sum = 0;
+    };
+    for (size_t i = 0; i < m_size; ++i) {
+        uint64_t value = values[i];
+        if (value == compact_null)
+            continue;
+        ++count;
+        if ((value & exponent_mask) != exponent) {
+            flush();
+            exponent = value & exponent_mask;
+        }
+        int64_t coefficient = int64_t(value & compact_coefficient_mask);
+        run_sum += (value & sign_mask) ? -coefficient : coefficient;
+    }
+    flush();
+    return result;
+}
+
 Mixed ArrayDecimal128::get_any(size_t ndx) const
 {
     return Mixed(get(ndx));
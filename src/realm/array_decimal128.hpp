@@ -24,6 +24,16 @@
 
 namespace realm {
 
+/// A leaf stores its values either as 16 byte Decimal128s, or, as long as all
+/// of them allow it, in a compact form of 8 bytes each. A value can be stored
+/// compactly unless it is NaN or infinite or its coefficient needs more than 49
+/// bits, which covers amounts of money with up to 14 digits, at any scale. The
+/// compact form keeps the sign, exponent and coefficient bits as they are, so
+/// the value read is identical to the value stored. The width of the leaf
+/// tells the two forms apart. If the allocator has
+/// Allocator::encoding_CompactDecimals enabled, new leaves start out compact,
+/// and are expanded the first time a value which cannot be stored compactly is
+/// written.
 class ArrayDecimal128 : public ArrayPayload, private Array {
 public:
     using value_type = Decimal128;
@@ -67,6 +77,8 @@ public:
     Decimal128 get(size_t ndx) const
     {
         REALM_ASSERT(ndx < m_size);
+        if (is_compact())
+            return from_compact(reinterpret_cast<const uint64_t*>(this->m_data)[ndx]);
         auto values = reinterpret_cast<Decimal128*>(this->m_data);
         return values[ndx];
     }
@@ -94,11 +106,51 @@ public:
 
     size_t find_first(Decimal128 value, size_t begin = 0, size_t end = npos) const noexcept;
 
+    /// The sum of the values which are neither null nor NaN. The number of such
+    /// values is returned in `count`.
+    Decimal128 sum(size_t& count) const;
+
+    bool is_compact() const noexcept
+    {
+        return get_width() == sizeof(uint64_t);
+    }
+
 protected:
-    size_t calc_byte_len(size_t num_items, size_t) const override
+    size_t calc_byte_len(size_t num_items, size_t width) const override
     {
-        return num_items * sizeof(Decimal128) + header_size;
+        return num_items * width + header_size;
     }
+
+private:
+    static constexpr uint64_t compact_coefficient_mask = (uint64_t(1) << 49) - 1;
+    // Null is a NaN, which is never stored compactly otherwise
+    static constexpr uint64_t compact_null = 0x7c000000000000aa;
+
+    static bool to_compact(Decimal128 value, uint64_t& compact) noexcept
+    {
+        auto& raw = *value.raw();
+        if (value.is_null()) {
+            compact = compact_null;
+            return true;
+        }
+        // Both of the two bits after the sign set means NaN, infinity or a
+        // coefficient in the large format
+        if ((raw.w[1] & 0x6000000000000000) == 0x6000000000000000)
+            return false;
+        if ((raw.w[1] & compact_coefficient_mask) != 0 || raw.w[0] > compact_coefficient_mask)
+            return false;
+        compact = (raw.w[1] & ~compact_coefficient_mask) | raw.w[0];
+        return true;
+    }
+    static Decimal128 from_compact(uint64_t compact) noexcept
+    {
+        if (compact == compact_null)
+            return Decimal128(realm::null());
+        return Decimal128(Decimal128::Bid128{{compact & compact_coefficient_mask, compact & ~compact_coefficient_mask}});
+    }
+
+    size_t width_for(Decimal128 value, uint64_t& compact) const;
+    void expand();
 };
 
 } // namespace realm
@@ -217,6 +217,34 @@ size_t ArrayMixed::find_first(Mixed value, size_t begin, size_t end) const noexc
     DataType type = value.get_type();
     if (end == realm::npos)
         end = size();
+
+    // Small integers and booleans are stored inline, so they can be searched
+    // for directly in the composite array.
+    if (type == type_Int) {
+        int64_t int_val = value.get_int();
+        if (std::numeric_limits<int32_t>::min() <= int_val && int_val <= std::numeric_limits<int32_t>::max()) {
+            int64_t val = (static_cast<uint64_t>(int_val) << s_data_shift) + int(type_Int) + 1;
+            return m_composite.find_first(val, begin, end);
+        }
+    }
+    else if (type == type_Bool) {
+        int64_t val = (int64_t(value.get_bool()) << s_data_shift) + int(type_Bool) + 1;
+        return m_composite.find_first(val, begin, end);
+    }
+    else if (type == type_String) {
+        // Compare the payload directly instead of going through Mixed
+        StringData str = value.get_string();
+        for (size_t i = begin; i < end; i++) {
+            int64_t val = m_composite.get(i);
+            if ((val & s_data_type_mask) == int(type_String) + 1) {
+                ensure_string_array();
+                if (m_strings.get(size_t(val >> s_data_shift)) == str)
+                    return i;
+            }
+        }
+        return realm::npos;
+    }
+
     for (size_t i = begin; i < end; i++) {
         if (this->get_type(i) == type && get(i) == value) {
             return i;
@@ -225,6 +253,16 @@ size_t ArrayMixed::find_first(Mixed value, size_t begin, size_t end) const noexc
     return realm::npos;
 }
 
+uint32_t ArrayMixed::get_type_mask() const
+{
+    uint32_t mask = 0;
+    size_t sz = size();
+    for (size_t i = 0; i < sz; i++) {
+        mask |= uint32_t(1) << (m_composite.get(i) & s_data_type_mask);
+    }
+    return mask;
+}
+
 void ArrayMixed::verify() const
 {
     // TODO: Implement
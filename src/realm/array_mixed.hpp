@@ -95,6 +95,17 @@ public:
 
     size_t find_first(Mixed value, size_t begin = 0, size_t end = realm::npos) const noexcept;
 
+    // Bit set in the mask returned by get_type_mask() for null values and for
+    // values of the given type
+    static constexpr uint32_t null_type_bit = 1;
+    static constexpr uint32_t type_bit(DataType type)
+    {
+        return uint32_t(1) << (int(type) + 1);
+    }
+    // Summary of the types held by the array, used by queries to skip arrays
+    // that cannot contain a match.
+    uint32_t get_type_mask() const;
+
     void verify() const;
 
 private:
@@ -20,10 +20,13 @@
 #include <realm/spec.hpp>
 #include <realm/mixed.hpp>
 
+#include <unordered_set>
+
 using namespace realm;
 
 ArrayString::ArrayString(Allocator& a)
     : m_alloc(a)
+    , m_dict_codes(a)
 {
     m_arr = new (&m_storage.m_string_short) ArrayStringShort(a, true);
 }
@@ -33,6 +36,13 @@ void ArrayString::create()
     static_cast<ArrayStringShort*>(m_arr)->create();
 }
 
+void ArrayString::set_spec(Spec* spec, size_t col_ndx) const
+{
+    m_spec = spec;
+    m_col_ndx = col_ndx;
+    m_compress = spec && spec->get_column_attr(col_ndx).test(col_attr_Compressed);
+}
+
 void ArrayString::init_from_mem(MemRef mem) noexcept
 {
     char* header = mem.get_addr();
@@ -62,6 +72,18 @@ void ArrayString::init_from_mem(MemRef mem) noexcept
             m_type = Type::enum_strings;
         }
     }
+    else if (is_dict_leaf(header)) {
+        auto arr = new (&m_storage.m_enum) Array(m_alloc);
+        arr->init_from_mem(mem);
+        m_dict_codes.set_parent(arr, 1);
+        m_dict_codes.init_from_parent();
+        if (!m_dict_values)
+            m_dict_values = std::make_unique<ArrayString>(m_alloc);
+        m_dict_values->set_nullability(m_nullable);
+        m_dict_values->set_parent(arr, 2);
+        m_dict_values->init_from_parent();
+        m_type = Type::dict_strings;
+    }
     else {
         bool is_big = Array::get_context_flag_from_header(header);
         if (!is_big) {
@@ -72,6 +94,7 @@ void ArrayString::init_from_mem(MemRef mem) noexcept
         else {
             auto arr = new (&m_storage.m_big_blobs) ArrayBigBlobs(m_alloc, m_nullable);
             arr->init_from_mem(mem);
+            arr->set_compress(m_compress);
             m_type = Type::big_strings;
         }
     }
@@ -95,6 +118,7 @@ void ArrayString::destroy() noexcept
 void ArrayString::detach() noexcept
 {
     m_arr->detach();
+    m_dict_codes.detach();
     // Make sure the object is in a state like right after construction
     // Next call must be to create()
     m_arr = new (&m_storage.m_string_short) ArrayStringShort(m_alloc, true);
@@ -112,11 +136,19 @@ size_t ArrayString::size() const
             return static_cast<ArrayBigBlobs*>(m_arr)->size();
         case Type::enum_strings:
             return static_cast<Array*>(m_arr)->size();
+        case Type::dict_strings:
+            return m_dict_codes.size();
     }
     return {};
 }
 
 void ArrayString::add(StringData value)
+{
+    do_add(value);       // Throws
+    maybe_dict_encode(); // Throws
+}
+
+void ArrayString::do_add(StringData value)
 {
     switch (upgrade_leaf(value.size())) {
         case Type::small_strings:
@@ -135,6 +167,16 @@ void ArrayString::add(StringData value)
             set(ndx, value);
             break;
         }
+        case Type::dict_strings: {
+            size_t code = get_dict_code_for_insert(value); // Throws
+            if (code == npos) {
+                dict_decode(); // Throws
+                do_add(value); // Throws
+                break;
+            }
+            m_dict_codes.add(int64_t(code)); // Throws
+            break;
+        }
     }
 }
 
@@ -160,10 +202,26 @@ void ArrayString::set(size_t ndx, StringData value)
             static_cast<Array*>(m_arr)->set(ndx, res);
             break;
         }
+        case Type::dict_strings: {
+            size_t code = get_dict_code_for_insert(value); // Throws
+            if (code == npos) {
+                dict_decode();   // Throws
+                set(ndx, value); // Throws
+                break;
+            }
+            m_dict_codes.set(ndx, int64_t(code)); // Throws
+            break;
+        }
     }
 }
 
 void ArrayString::insert(size_t ndx, StringData value)
+{
+    do_insert(ndx, value); // Throws
+    maybe_dict_encode();   // Throws
+}
+
+void ArrayString::do_insert(size_t ndx, StringData value)
 {
     switch (upgrade_leaf(value.size())) {
         case Type::small_strings:
@@ -178,6 +236,17 @@ void ArrayString::insert(size_t ndx, StringData value)
         case Type::enum_strings: {
             static_cast<Array*>(m_arr)->insert(ndx, 0);
             set(ndx, value);
+            break;
+        }
+        case Type::dict_strings: {
+            size_t code = get_dict_code_for_insert(value); // Throws
+            if (code == npos) {
+                dict_decode();         // Throws
+                do_insert(ndx, value); // Throws
+                break;
+            }
+            m_dict_codes.insert(ndx, int64_t(code)); // Throws
+            break;
         }
     }
 }
@@ -195,6 +264,8 @@ StringData ArrayString::get(size_t ndx) const
             size_t index = size_t(static_cast<Array*>(m_arr)->get(ndx));
             return m_string_enum_values->get(index);
         }
+        case Type::dict_strings:
+            return m_dict_values->get(get_dict_code(ndx));
     }
     return {};
 }
@@ -212,6 +283,8 @@ StringData ArrayString::get_legacy(size_t ndx) const
             size_t index = size_t(static_cast<Array*>(m_arr)->get(ndx));
             return m_string_enum_values->get(index);
         }
+        case Type::dict_strings:
+            return m_dict_values->get(get_dict_code(ndx));
     }
     return {};
 }
@@ -234,6 +307,8 @@ bool ArrayString::is_null(size_t ndx) const
             size_t index = size_t(static_cast<Array*>(m_arr)->get(ndx));
             return m_string_enum_values->is_null(index);
         }
+        case Type::dict_strings:
+            return m_dict_values->is_null(get_dict_code(ndx));
     }
     return {};
 }
@@ -253,6 +328,11 @@ void ArrayString::erase(size_t ndx)
         case Type::enum_strings:
             static_cast<Array*>(m_arr)->erase(ndx);
             break;
+        case Type::dict_strings:
+            // Values no longer in use stay in the dictionary until the leaf
+            // is decoded
+            m_dict_codes.erase(ndx);
+            break;
     }
 }
 
@@ -277,6 +357,9 @@ void ArrayString::move(ArrayString& dst, size_t ndx)
             // this operation will never be called for enumerated columns
             REALM_UNREACHABLE();
             break;
+        case Type::dict_strings:
+            m_dict_codes.truncate(ndx);
+            break;
     }
 }
 
@@ -295,10 +378,14 @@ void ArrayString::clear()
         case Type::enum_strings:
             static_cast<Array*>(m_arr)->clear();
             break;
+        case Type::dict_strings:
+            m_dict_codes.clear();
+            m_dict_values->clear();
+            break;
     }
 }
 
-size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const noexcept
+size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const
 {
     switch (m_type) {
         case Type::small_strings:
@@ -321,6 +408,13 @@ size_t ArrayString::find_first(StringData value, size_t begin, size_t end) const
             }
             break;
         }
+        case Type::dict_strings: {
+            size_t code = find_dict_code(value);
+            if (code != realm::not_found) {
+                return find_first_dict_code(code, begin, end);
+            }
+            break;
+        }
     }
     return not_found;
 }
@@ -339,6 +433,12 @@ inline StringData get_string(const ArrayStringShort* arr, size_t ndx)
     return arr->get(ndx);
 }
 
+template <>
+inline StringData get_string(const ArrayString* arr, size_t ndx)
+{
+    return arr->get(ndx);
+}
+
 template <class T, class U>
 size_t lower_bound_string(const T* arr, U value)
 {
@@ -371,6 +471,8 @@ size_t ArrayString::lower_bound(StringData value)
             return lower_bound_string(static_cast<ArrayBigBlobs*>(m_arr), value);
         case Type::enum_strings:
             break;
+        case Type::dict_strings:
+            return lower_bound_string(this, value);
     }
     return realm::npos;
 }
@@ -383,6 +485,10 @@ ArrayString::Type ArrayString::upgrade_leaf(size_t value_size)
     if (m_type == Type::enum_strings)
         return Type::enum_strings;
 
+    // The dictionary takes values of any size
+    if (m_type == Type::dict_strings)
+        return Type::dict_strings;
+
     if (m_type == Type::medium_strings) {
         if (value_size <= medium_string_max_size)
             return Type::medium_strings;
@@ -404,6 +510,7 @@ ArrayString::Type ArrayString::upgrade_leaf(size_t value_size)
         arr->init_from_mem(big_blobs.get_mem());
         arr->set_parent(parent, ndx_in_parent);
         arr->update_parent();
+        arr->set_compress(m_compress);
 
         m_type = Type::big_strings;
         return Type::big_strings;
@@ -452,6 +559,7 @@ ArrayString::Type ArrayString::upgrade_leaf(size_t value_size)
         arr->init_from_mem(big_blobs.get_mem());
         arr->set_parent(parent, ndx_in_parent);
         arr->update_parent();
+        arr->set_compress(m_compress);
 
         m_type = Type::big_strings;
     }
@@ -475,6 +583,100 @@ void ArrayString::verify() const
         case Type::enum_strings:
             static_cast<Array*>(m_arr)->verify();
             break;
+        case Type::dict_strings: {
+            m_dict_codes.verify();
+            m_dict_values->verify();
+            size_t num_values = m_dict_values->size();
+            for (size_t i = 0; i < m_dict_codes.size(); ++i)
+                REALM_ASSERT(get_dict_code(i) < num_values);
+            break;
+        }
     }
 #endif
 }
+
+// Returns npos if the value is not in the dictionary, and there is no room
+// for it
+size_t ArrayString::get_dict_code_for_insert(StringData value)
+{
+    size_t num_values = m_dict_values->size();
+    size_t code = m_dict_values->find_first(value, 0, num_values);
+    if (code != realm::not_found)
+        return code;
+    if (num_values == dict_max_values)
+        return npos;
+    m_dict_values->do_add(value); // Throws
+    return num_values;
+}
+
+void ArrayString::maybe_dict_encode()
+{
+    if (m_type == Type::enum_strings || m_type == Type::dict_strings)
+        return;
+    if (!m_alloc.is_encoding_enabled(Allocator::encoding_DictStrings))
+        return;
+    size_t sz = size();
+    if (sz < dict_min_leaf_size || (sz & (sz - 1)) != 0)
+        return;
+
+    size_t max_values = std::min(dict_max_values, sz / 4);
+    std::unordered_set<StringData> values;
+    for (size_t i = 0; i < sz; ++i) {
+        values.insert(get(i)); // Throws
+        if (values.size() > max_values)
+            return;
+    }
+    dict_encode(); // Throws
+}
+
+void ArrayString::dict_encode()
+{
+    ArrayString values(m_alloc);
+    values.set_nullability(m_nullable);
+    values.create(); // Throws
+    Array codes(m_alloc);
+    codes.create(Array::type_Normal); // Throws
+
+    size_t sz = size();
+    for (size_t i = 0; i < sz; ++i) {
+        StringData value = get(i);
+        size_t code = values.find_first(value, 0, values.size());
+        if (code == realm::not_found) {
+            code = values.size();
+            values.do_add(value); // Throws
+        }
+        codes.add(int64_t(code)); // Throws
+    }
+
+    Array top(m_alloc);
+    top.create(Array::type_HasRefs); // Throws
+    top.add(RefOrTagged::make_tagged(0)); // Throws
+    top.add(from_ref(codes.get_ref()));   // Throws
+    top.add(from_ref(values.get_ref()));  // Throws
+
+    auto parent = m_arr->get_parent();
+    auto ndx_in_parent = m_arr->get_ndx_in_parent();
+    destroy();
+
+    m_arr->set_parent(parent, ndx_in_parent);
+    init_from_mem(top.get_mem());
+    update_parent(); // Throws
+}
+
+void ArrayString::dict_decode()
+{
+    ArrayString plain(m_alloc);
+    plain.set_nullability(m_nullable);
+    plain.create(); // Throws
+    size_t sz = size();
+    for (size_t i = 0; i < sz; ++i)
+        plain.do_add(get(i)); // Throws
+
+    auto parent = m_arr->get_parent();
+    auto ndx_in_parent = m_arr->get_ndx_in_parent();
+    destroy();
+
+    m_arr->set_parent(parent, ndx_in_parent);
+    init_from_mem(plain.m_arr->get_mem());
+    update_parent(); // Throws
+}
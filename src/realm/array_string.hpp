@@ -70,11 +70,7 @@ public:
     {
         return true;
     }
-    void set_spec(Spec* spec, size_t col_ndx) const override
-    {
-        m_spec = spec;
-        m_col_ndx = col_ndx;
-    }
+    void set_spec(Spec* spec, size_t col_ndx) const override;
 
     void update_parent()
     {
@@ -107,28 +103,64 @@ public:
     void move(ArrayString& dst, size_t ndx);
     void clear();
 
-    size_t find_first(StringData value, size_t begin, size_t end) const noexcept;
+    size_t find_first(StringData value, size_t begin, size_t end) const;
 
     size_t lower_bound(StringData value);
 
+    /// If the allocator has Allocator::encoding_DictStrings enabled, leaves
+    /// with few distinct values are dictionary encoded automatically: the leaf
+    /// holds a small array of the distinct values and, per element, an integer
+    /// code indexing it. The functions below give searches direct access to
+    /// the codes.
+    bool is_dict_encoded() const noexcept
+    {
+        return m_type == Type::dict_strings;
+    }
+    /// The number of entries in the dictionary of an encoded leaf. Codes are
+    /// always less than this.
+    size_t get_dict_size() const noexcept
+    {
+        return m_dict_values->size();
+    }
+    /// The code of \a value in the dictionary of an encoded leaf, or npos if
+    /// no element of the leaf has that value.
+    size_t find_dict_code(StringData value) const
+    {
+        return m_dict_values->find_first(value, 0, m_dict_values->size());
+    }
+    size_t get_dict_code(size_t ndx) const noexcept
+    {
+        return size_t(m_dict_codes.get(ndx));
+    }
+    size_t find_first_dict_code(size_t code, size_t begin, size_t end) const noexcept
+    {
+        return m_dict_codes.find_first(int64_t(code), begin, end);
+    }
+
     /// Get the specified element without the cost of constructing an
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
     /// slower.
-    static StringData get(const char* header, size_t ndx, Allocator& alloc) noexcept;
+    static StringData get(const char* header, size_t ndx, Allocator& alloc);
 
     void verify() const;
 
 private:
     static constexpr size_t small_string_max_size = 15;  // ArrayStringShort
     static constexpr size_t medium_string_max_size = 63; // ArrayStringLong
+    // Leaves are considered for dictionary encoding each time their size
+    // reaches a power of two from dict_min_leaf_size on, and are encoded if at
+    // most a quarter of their elements are distinct, and no more than
+    // dict_max_values.
+    static constexpr size_t dict_min_leaf_size = 64;
+    static constexpr size_t dict_max_values = 64;
     union Storage {
         std::aligned_storage<sizeof(ArrayStringShort), alignof(ArrayStringShort)>::type m_string_short;
         std::aligned_storage<sizeof(ArraySmallBlobs), alignof(ArraySmallBlobs)>::type m_string_long;
         std::aligned_storage<sizeof(ArrayBigBlobs), alignof(ArrayBigBlobs)>::type m_big_blobs;
         std::aligned_storage<sizeof(Array), alignof(Array)>::type m_enum;
     };
-    enum class Type { small_strings, medium_strings, big_strings, enum_strings };
+    enum class Type { small_strings, medium_strings, big_strings, enum_strings, dict_strings };
 
     Type m_type = Type::small_strings;
 
@@ -137,19 +169,42 @@ private:
     Array* m_arr;
     mutable Spec* m_spec = nullptr;
     mutable size_t m_col_ndx = realm::npos;
+    mutable bool m_compress = false;
     bool m_nullable = true;
 
     std::unique_ptr<ArrayString> m_string_enum_values;
 
+    // For dict_strings, m_arr is the top array of the leaf, holding a tag and
+    // refs to these two.
+    Array m_dict_codes;
+    std::unique_ptr<ArrayString> m_dict_values;
+
     Type upgrade_leaf(size_t value_size);
+
+    void do_add(StringData value);
+    void do_insert(size_t ndx, StringData value);
+    size_t get_dict_code_for_insert(StringData value);
+    void maybe_dict_encode();
+    void dict_encode();
+    void dict_decode();
+    static bool is_dict_leaf(const char* header) noexcept
+    {
+        return Array::get_hasrefs_from_header(header) && !Array::get_context_flag_from_header(header) &&
+               (Array::get(header, 0) & 1) != 0;
+    }
 };
 
-inline StringData ArrayString::get(const char* header, size_t ndx, Allocator& alloc) noexcept
+inline StringData ArrayString::get(const char* header, size_t ndx, Allocator& alloc)
 {
     bool long_strings = Array::get_hasrefs_from_header(header);
     if (!long_strings) {
         return ArrayStringShort::get(header, ndx, true);
     }
+    else if (is_dict_leaf(header)) {
+        const char* codes_header = alloc.translate(to_ref(Array::get(header, 1)));
+        const char* values_header = alloc.translate(to_ref(Array::get(header, 2)));
+        return get(values_header, size_t(Array::get(codes_header, ndx)), alloc);
+    }
     else {
         bool is_big = Array::get_context_flag_from_header(header);
         if (!is_big) {
@@ -295,6 +295,30 @@ bool ArrayStringShort::compare_string(const ArrayStringShort& c) const noexcept
     return true;
 }
 
+size_t ArrayStringShortLookup::find(const ArrayStringShort& names, StringData value) const
+{
+    size_t size = names.size();
+    if (size < s_min_size)
+        return names.find_first(value);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid.load(std::memory_order_relaxed)) {
+        m_ndx.clear();
+        m_names.clear();
+        // No reallocation may move the strings the keys point into
+        m_names.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            StringData name = names.get(i);
+            m_names.emplace_back(name.data(), name.size());
+            // The first of equal names is found, as by find_first()
+            m_ndx.emplace(StringData(m_names.back()), i);
+        }
+        m_valid.store(true, std::memory_order_relaxed);
+    }
+    auto it = m_ndx.find(value);
+    return it == m_ndx.end() ? npos : it->second;
+}
+
 #ifdef REALM_DEBUG // LCOV_EXCL_START ignore debug functions
 
 void ArrayStringShort::string_stats() const
@@ -22,6 +22,12 @@
 #include <realm/array.hpp>
 #include <realm/string_data.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace realm {
 
 /*
@@ -99,6 +105,32 @@ private:
     bool m_nullable;
 };
 
+/// Finds strings in an ArrayStringShort of names, such as the table names of
+/// a group or the column names of a table, through a hash table built by the
+/// first lookup. The owner of the array must call reset() whenever it changes
+/// the array or attaches it to other memory. Short arrays are searched
+/// directly. Lookups may run concurrently, as they do on frozen transactions.
+class ArrayStringShortLookup {
+public:
+    ArrayStringShortLookup() = default;
+    ArrayStringShortLookup(const ArrayStringShortLookup&) noexcept {}
+
+    /// Same result as `names.find_first(value)`
+    size_t find(const ArrayStringShort& names, StringData value) const;
+    void reset() noexcept
+    {
+        m_valid.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t s_min_size = 16;
+
+    mutable std::mutex m_mutex;
+    mutable std::atomic<bool> m_valid{false};
+    mutable std::vector<std::string> m_names;
+    mutable std::unordered_map<StringData, size_t> m_ndx;
+};
+
 
 // Implementation:
 
@@ -19,6 +19,8 @@
 #include <realm/array_unsigned.hpp>
 #include <realm/array_direct.hpp>
 #include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace realm {
 
@@ -73,6 +75,99 @@ inline uint64_t ArrayUnsigned::_get(size_t ndx, uint8_t width) const
     return get_direct(m_data, width, ndx);
 }
 
+// The encoding treats the elements as signed integers of the original width,
+// so that is what the base plus the offset gives.
+uint64_t ArrayUnsigned::get_encoded(size_t ndx) const noexcept
+{
+    const char* header = get_header();
+    const char* offsets_header = get_encoded_offsets_header(header);
+    int64_t offset = get_direct(get_data_from_header(offsets_header), get_width_from_header(offsets_header), ndx);
+    return uint64_t(get_encoded_base(header) + offset) & m_ubound;
+}
+
+namespace {
+
+// Like std::lower_bound() if 'comp' is std::less and like std::upper_bound()
+// if it is std::less_equal, but without branching on the elements, as in
+// realm::lower_bound(). The keys of a cluster are searched for every object
+// looked up by key, and when the keys are sparse, such as those derived from
+// hashed primary keys, the outcome of every comparison is a coin toss.
+template <class T, class Compare>
+inline size_t bound(const char* data, size_t size, uint64_t value, Compare comp) noexcept
+{
+    if (size == 0)
+        return 0;
+    const T* arr = reinterpret_cast<const T*>(data);
+    const T* low = arr;
+    while (size > 1) {
+        size_t half = size / 2;
+        low = comp(low[half], value) ? low + half : low;
+        size -= half;
+    }
+    return size_t(low - arr) + (comp(*low, value) ? 1 : 0);
+}
+
+template <class Compare>
+inline size_t bound(const char* data, uint8_t width, size_t size, uint64_t value, Compare comp) noexcept
+{
+    switch (width) {
+        case 8:
+            return bound<uint8_t>(data, size, value, comp);
+        case 16:
+            return bound<uint16_t>(data, size, value, comp);
+        case 32:
+            return bound<uint32_t>(data, size, value, comp);
+        case 64:
+            return bound<uint64_t>(data, size, value, comp);
+    }
+    // Only the offsets of encoded arrays are narrower than 8 bits
+    int64_t v = int64_t(std::min(value, uint64_t(std::numeric_limits<int64_t>::max())));
+    if constexpr (std::is_same_v<Compare, std::less<uint64_t>>) {
+        REALM_TEMPEX(return realm::lower_bound, width, (data, size, v));
+    }
+    else {
+        REALM_TEMPEX(return realm::upper_bound, width, (data, size, v));
+    }
+}
+
+} // anonymous namespace
+
+// As long as adding the offsets to the base does not wrap around the width of
+// the array, the offsets are ordered like the elements, and the search runs
+// on the packed offsets with the rebased value. Otherwise it falls back to a
+// binary search by means of get_encoded().
+template <class Compare>
+size_t ArrayUnsigned::encoded_bound(uint64_t value, Compare comp) const noexcept
+{
+    const char* header = get_header();
+    const char* offsets_header = get_encoded_offsets_header(header);
+    const char* offsets = get_data_from_header(offsets_header);
+    uint8_t offsets_width = uint8_t(get_width_from_header(offsets_header));
+    uint64_t base = uint64_t(get_encoded_base(header)) & m_ubound;
+    uint64_t last_offset = uint64_t(get_direct(offsets, offsets_width, m_size - 1));
+    if (last_offset <= m_ubound - base) {
+        if (value < base)
+            return 0;
+        if (value - base > last_offset)
+            return m_size;
+        return bound(offsets, offsets_width, m_size, value - base, comp);
+    }
+
+    size_t first = 0;
+    size_t count = m_size;
+    while (count > 0) {
+        size_t step = count / 2;
+        if (comp(get_encoded(first + step), value)) {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else {
+            count = step;
+        }
+    }
+    return first;
+}
+
 void ArrayUnsigned::create(size_t initial_size, uint64_t ubound_value)
 {
     MemRef mem = create_node(initial_size, get_alloc(), false, Node::type_Normal, wtype_Bits,
@@ -91,78 +186,16 @@ void ArrayUnsigned::update_from_parent() noexcept
 
 size_t ArrayUnsigned::lower_bound(uint64_t value) const noexcept
 {
-    if (m_width == 8) {
-        uint8_t* arr = reinterpret_cast<uint8_t*>(m_data);
-        uint8_t* pos = std::lower_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width == 16) {
-        uint16_t* arr = reinterpret_cast<uint16_t*>(m_data);
-        uint16_t* pos = std::lower_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width == 32) {
-        uint32_t* arr = reinterpret_cast<uint32_t*>(m_data);
-        uint32_t* pos = std::lower_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width < 8) {
-        switch (m_width) {
-            case 0:
-                return realm::lower_bound<0>(m_data, m_size, value);
-            case 1:
-                return realm::lower_bound<1>(m_data, m_size, value);
-            case 2:
-                return realm::lower_bound<2>(m_data, m_size, value);
-            case 4:
-                return realm::lower_bound<4>(m_data, m_size, value);
-            default:
-                REALM_UNREACHABLE();
-                break;
-        }
-        return npos;
-    }
-    uint64_t* arr = reinterpret_cast<uint64_t*>(m_data);
-    uint64_t* pos = std::lower_bound(arr, arr + m_size, value);
-    return pos - arr;
+    if (REALM_UNLIKELY(m_is_encoded))
+        return encoded_bound(value, std::less<uint64_t>());
+    return bound(m_data, m_width, m_size, value, std::less<uint64_t>());
 }
 
 size_t ArrayUnsigned::upper_bound(uint64_t value) const noexcept
 {
-    if (m_width == 8) {
-        uint8_t* arr = reinterpret_cast<uint8_t*>(m_data);
-        uint8_t* pos = std::upper_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width == 16) {
-        uint16_t* arr = reinterpret_cast<uint16_t*>(m_data);
-        uint16_t* pos = std::upper_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width == 32) {
-        uint32_t* arr = reinterpret_cast<uint32_t*>(m_data);
-        uint32_t* pos = std::upper_bound(arr, arr + m_size, value);
-        return pos - arr;
-    }
-    else if (m_width < 8) {
-        switch (m_width) {
-            case 0:
-                return realm::upper_bound<0>(m_data, m_size, value);
-            case 1:
-                return realm::upper_bound<1>(m_data, m_size, value);
-            case 2:
-                return realm::upper_bound<2>(m_data, m_size, value);
-            case 4:
-                return realm::upper_bound<4>(m_data, m_size, value);
-            default:
-                REALM_UNREACHABLE();
-                break;
-        }
-        return npos;
-    }
-    uint64_t* arr = reinterpret_cast<uint64_t*>(m_data);
-    uint64_t* pos = std::upper_bound(arr, arr + m_size, value);
-    return pos - arr;
+    if (REALM_UNLIKELY(m_is_encoded))
+        return encoded_bound(value, std::less_equal<uint64_t>());
+    return bound(m_data, m_width, m_size, value, std::less_equal<uint64_t>());
 }
 
 void ArrayUnsigned::insert(size_t ndx, uint64_t value)
@@ -232,6 +265,8 @@ void ArrayUnsigned::erase(size_t ndx)
 
 uint64_t ArrayUnsigned::get(size_t index) const
 {
+    if (REALM_UNLIKELY(m_is_encoded))
+        return get_encoded(index);
     return _get(index, m_width);
 }
 
@@ -83,11 +83,20 @@ public:
 private:
     uint_least8_t m_width = 0; // Size of an element (meaning depend on type of array).
     uint64_t m_ubound;         // max number that can be stored with current m_width
+    bool m_is_encoded = false; // See NodeHeader::get_encoded_base()
 
     void init_from_mem(MemRef mem) noexcept
     {
         Node::init_from_mem(mem);
         set_width(get_width_from_header(get_header()));
+        m_is_encoded = get_wtype_from_header(get_header()) == wtype_Encoded;
+    }
+
+    // Encoded arrays are decoded before being modified
+    void copy_on_write()
+    {
+        Node::copy_on_write(); // Throws
+        m_is_encoded = false;
     }
 
     void adjust(size_t ndx, int64_t diff)
@@ -101,6 +110,7 @@ private:
     {
         Node::alloc(init_size, new_width);
         set_width(uint8_t(new_width));
+        m_is_encoded = false;
     }
 
     void set_width(uint8_t width);
@@ -108,6 +118,9 @@ private:
 
     void _set(size_t ndx, uint8_t width, uint64_t value);
     uint64_t _get(size_t ndx, uint8_t width) const;
+    uint64_t get_encoded(size_t ndx) const noexcept;
+    template <class Compare>
+    size_t encoded_bound(uint64_t value, Compare) const noexcept;
 };
 
 class ClusterKeyArray : public ArrayUnsigned {
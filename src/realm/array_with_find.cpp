@@ -29,6 +29,10 @@ void ArrayWithFind::find_all(IntegerColumn* result, int64_t value, size_t col_of
         end = m_array.m_size;
 
     QueryStateFindAll state(*result);
+    if (m_array.m_is_encoded) {
+        find_encoded<Equal>(value, begin, end, col_offset, &state, nullptr);
+        return;
+    }
     REALM_TEMPEX2(find_optimized, Equal, m_array.m_width, (value, begin, end, col_offset, &state, nullptr));
 
     return;
@@ -55,6 +55,12 @@ Searching: The main finding function is:
 #include <emmintrin.h>             // SSE2
 #include <realm/realm_nmmintrin.h> // SSE42
 #endif
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h> // AVX2 and AVX-512, only used from functions compiled with REALM_TARGET_AVX2/AVX512
+#endif
+#ifdef REALM_COMPILER_NEON
+#include <arm_neon.h>
+#endif
 
 namespace realm {
 
@@ -64,6 +70,32 @@ inline T no0(T v)
     return v == 0 ? 1 : v;
 }
 
+// Passes the matches found among the offsets of an encoded array on to the
+// state of the search, with the base of the array added back to the values.
+class QueryStateRebased : public QueryStateBase {
+public:
+    QueryStateRebased(QueryStateBase& state, int64_t base) noexcept
+        : QueryStateBase(state.limit())
+        , m_state(state)
+        , m_base(base)
+    {
+        m_match_count = state.match_count();
+    }
+
+    bool match(size_t index, Mixed value) noexcept override
+    {
+        if (!value.is_null())
+            value = Mixed(int64_t(uint64_t(value.get_int()) + uint64_t(m_base)));
+        bool cont = m_state.match(index, value);
+        m_match_count = m_state.match_count();
+        return cont;
+    }
+
+private:
+    QueryStateBase& m_state;
+    int64_t m_base;
+};
+
 class ArrayWithFind {
 public:
     ArrayWithFind(const Array& array) noexcept
@@ -78,6 +110,11 @@ public:
     bool find(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state,
               Callback callback) const;
 
+    // Find for encoded arrays. The search runs directly on the packed offsets.
+    template <class cond, class Callback>
+    bool find_encoded(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state,
+                      Callback callback) const;
+
     void find_all(IntegerColumn* result, int64_t value, size_t col_offset = 0, size_t begin = 0,
                   size_t end = size_t(-1)) const;
 
@@ -120,6 +157,34 @@ public:
 
 #endif
 
+// AVX2 find for the four functions Equal/NotEqual/Less/Greater. Unlike SSE it handles all of them for 64 bit too.
+#ifdef REALM_COMPILER_AVX
+    template <class cond, size_t width, class Callback>
+    REALM_TARGET_AVX2 bool find_avx2(int64_t value, const __m256i* data, size_t items, QueryStateBase* state,
+                                     size_t baseindex, Callback callback) const;
+
+    // AVX-512 compares yield a mask with one bit per element, so no movemask step is needed
+    template <class cond, size_t width, class Callback>
+    REALM_TARGET_AVX512 bool find_avx512(int64_t value, const __m512i* data, size_t items, QueryStateBase* state,
+                                         size_t baseindex, Callback callback) const;
+#endif
+
+// NEON find for the four functions Equal/NotEqual/Less/Greater
+#ifdef REALM_COMPILER_NEON
+    template <class cond, size_t width, class Callback>
+    bool find_neon(int64_t value, const char* data, size_t items, QueryStateBase* state, size_t baseindex,
+                   Callback callback) const;
+
+    template <class cond, size_t width>
+    static uint8x16_t neon_compare(const char* data, int64_t value);
+#endif
+
+    // Calls find_action() for each element flagged in 'mask' where each element of 'width' bits at 'data' is
+    // represented by 'stride' consecutive mask bits. 'start' is the index of the element the mask begins at.
+    template <size_t width, size_t stride, class Callback>
+    bool find_mask(uint64_t mask, const char* data, size_t start, size_t baseindex, QueryStateBase* state,
+                   Callback callback) const;
+
     template <size_t width>
     inline bool test_zero(uint64_t value) const; // Tests value for 0-elements
 
@@ -368,6 +433,66 @@ bool ArrayWithFind::find_optimized(int64_t value, size_t start, size_t end, size
     // finder cannot handle this bitwidth
     REALM_ASSERT_3(m_array.m_width, !=, 0);
 
+    [[maybe_unused]] constexpr bool vector_cond = std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual> ||
+                                                  std::is_same_v<cond, Greater> || std::is_same_v<cond, Less>;
+
+#if defined(REALM_COMPILER_AVX)
+    // AVX-512 and AVX2 cover every condition and byte sized width, so prefer them over SSE when the range spans a
+    // whole chunk
+    if constexpr (vector_cond && bitwidth >= 8) {
+        if ((end - start2) * bitwidth / 8 >= sizeof(__m512i) && sseavx<3>()) {
+            // find_avx512() must start at a 64-byte boundary, so search area before that using compare()
+            __m512i* const a =
+                reinterpret_cast<__m512i*>(round_up(m_array.m_data + start2 * bitwidth / 8, sizeof(__m512i)));
+            __m512i* const b =
+                reinterpret_cast<__m512i*>(round_down(m_array.m_data + end * bitwidth / 8, sizeof(__m512i)));
+            const size_t a_ndx = (reinterpret_cast<char*>(a) - m_array.m_data) * 8 / bitwidth;
+            const size_t b_ndx = (reinterpret_cast<char*>(b) - m_array.m_data) * 8 / bitwidth;
+
+            if (!compare<cond, bitwidth, Callback>(value, start2, a_ndx, baseindex, state, callback))
+                return false;
+            if (b > a) {
+                if (!find_avx512<cond, bitwidth, Callback>(value, a, b - a, state, baseindex + a_ndx, callback))
+                    return false;
+            }
+            return compare<cond, bitwidth, Callback>(value, std::max(a_ndx, b_ndx), end, baseindex, state,
+                                                     callback);
+        }
+        if ((end - start2) * bitwidth / 8 >= sizeof(__m256i) && sseavx<2>()) {
+            // find_avx2() must start at a 32-byte boundary, so search area before that using compare()
+            __m256i* const a =
+                reinterpret_cast<__m256i*>(round_up(m_array.m_data + start2 * bitwidth / 8, sizeof(__m256i)));
+            __m256i* const b =
+                reinterpret_cast<__m256i*>(round_down(m_array.m_data + end * bitwidth / 8, sizeof(__m256i)));
+            const size_t a_ndx = (reinterpret_cast<char*>(a) - m_array.m_data) * 8 / bitwidth;
+            const size_t b_ndx = (reinterpret_cast<char*>(b) - m_array.m_data) * 8 / bitwidth;
+
+            if (!compare<cond, bitwidth, Callback>(value, start2, a_ndx, baseindex, state, callback))
+                return false;
+            if (b > a) {
+                if (!find_avx2<cond, bitwidth, Callback>(value, a, b - a, state, baseindex + a_ndx, callback))
+                    return false;
+            }
+            return compare<cond, bitwidth, Callback>(value, std::max(a_ndx, b_ndx), end, baseindex, state,
+                                                     callback);
+        }
+    }
+#endif
+
+#if defined(REALM_COMPILER_NEON)
+    // NEON loads have no alignment requirement, so only the remainder needs the scalar fallback
+    if constexpr (vector_cond && bitwidth >= 8) {
+        const size_t items = (end - start2) * bitwidth / 128;
+        if (items > 0) {
+            if (!find_neon<cond, bitwidth, Callback>(value, m_array.m_data + start2 * bitwidth / 8, items, state,
+                                                     baseindex + start2, callback))
+                return false;
+            start2 += items * 128 / bitwidth;
+        }
+        return compare<cond, bitwidth, Callback>(value, start2, end, baseindex, state, callback);
+    }
+#endif
+
 #if defined(REALM_COMPILER_SSE)
     // Only use SSE if payload is at least one SSE chunk (128 bits) in size. Also note taht SSE doesn't support
     // Less-than comparison for 64-bit values.
@@ -718,10 +843,31 @@ template <class cond, class Callback>
 bool ArrayWithFind::find(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state,
                          Callback callback) const
 {
+    if (REALM_UNLIKELY(m_array.m_is_encoded))
+        return find_encoded<cond>(value, start, end, baseindex, state, callback);
     REALM_TEMPEX3(return find_optimized, cond, m_array.m_width, Callback,
                          (value, start, end, baseindex, state, callback));
 }
 
+// The offsets of an encoded array form a plain array, so once the value is
+// rebased the ordinary (vectorized) finders can search them without decoding
+// anything.
+template <class cond, class Callback>
+bool ArrayWithFind::find_encoded(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state,
+                                 Callback callback) const
+{
+    Array offsets(m_array.get_alloc());
+    m_array.init_offsets_accessor(offsets);
+    int64_t offset = m_array.rebase_to_offsets(value, offsets);
+    if constexpr (std::is_same_v<Callback, std::nullptr_t>) {
+        QueryStateRebased rebased_state(*state, m_array.m_encoded_base);
+        return ArrayWithFind(offsets).find<cond>(offset, start, end, baseindex, &rebased_state, nullptr);
+    }
+    else {
+        return ArrayWithFind(offsets).find<cond>(offset, start, end, baseindex, state, callback);
+    }
+}
+
 #ifdef REALM_COMPILER_SSE
 // 'items' is the number of 16-byte SSE chunks. Returns index of packed element relative to first integer of first
 // chunk
@@ -826,6 +972,188 @@ REALM_FORCEINLINE bool ArrayWithFind::find_sse_intern(__m128i* action_data, __m1
 }
 #endif // REALM_COMPILER_SSE
 
+#ifdef REALM_COMPILER_AVX
+// 'items' is the number of 32-byte AVX2 chunks, which must be aligned. 'baseindex' is the index of the first element
+// in the first chunk.
+template <class cond, size_t width, class Callback>
+REALM_TARGET_AVX2 bool ArrayWithFind::find_avx2(int64_t value, const __m256i* data, size_t items,
+                                                 QueryStateBase* state, size_t baseindex, Callback callback) const
+{
+    static_assert(width == 8 || width == 16 || width == 32 || width == 64);
+
+    __m256i search;
+    if constexpr (width == 8)
+        search = _mm256_set1_epi8(static_cast<char>(value));
+    else if constexpr (width == 16)
+        search = _mm256_set1_epi16(static_cast<short int>(value));
+    else if constexpr (width == 32)
+        search = _mm256_set1_epi32(static_cast<int>(value));
+    else
+        search = _mm256_set1_epi64x(value);
+
+    for (size_t i = 0; i < items; ++i) {
+        const __m256i chunk = _mm256_load_si256(data + i);
+        __m256i compare_result;
+
+        // AVX2 has no less-than, so Less is implemented as greater-than with swapped operands
+        if constexpr (std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual>) {
+            if constexpr (width == 8)
+                compare_result = _mm256_cmpeq_epi8(chunk, search);
+            else if constexpr (width == 16)
+                compare_result = _mm256_cmpeq_epi16(chunk, search);
+            else if constexpr (width == 32)
+                compare_result = _mm256_cmpeq_epi32(chunk, search);
+            else
+                compare_result = _mm256_cmpeq_epi64(chunk, search);
+        }
+        else {
+            static_assert(std::is_same_v<cond, Greater> || std::is_same_v<cond, Less>);
+            const __m256i lhs = std::is_same_v<cond, Greater> ? chunk : search;
+            const __m256i rhs = std::is_same_v<cond, Greater> ? search : chunk;
+            if constexpr (width == 8)
+                compare_result = _mm256_cmpgt_epi8(lhs, rhs);
+            else if constexpr (width == 16)
+                compare_result = _mm256_cmpgt_epi16(lhs, rhs);
+            else if constexpr (width == 32)
+                compare_result = _mm256_cmpgt_epi32(lhs, rhs);
+            else
+                compare_result = _mm256_cmpgt_epi64(lhs, rhs);
+        }
+
+        // One bit per byte
+        uint64_t resmask = uint32_t(_mm256_movemask_epi8(compare_result));
+        if constexpr (std::is_same_v<cond, NotEqual>)
+            resmask ^= 0xffffffffULL;
+
+        if (resmask != 0 && !find_mask<width, width / 8, Callback>(resmask, reinterpret_cast<const char*>(data),
+                                                                      i * sizeof(__m256i) * 8 / width, baseindex,
+                                                                      state, callback))
+            return false;
+    }
+
+    return true;
+}
+
+// 'items' is the number of 64-byte AVX-512 chunks, which must be aligned. 'baseindex' is the index of the first
+// element in the first chunk.
+template <class cond, size_t width, class Callback>
+REALM_TARGET_AVX512 bool ArrayWithFind::find_avx512(int64_t value, const __m512i* data, size_t items,
+                                                     QueryStateBase* state, size_t baseindex,
+                                                     Callback callback) const
+{
+    static_assert(width == 8 || width == 16 || width == 32 || width == 64);
+
+    constexpr int predicate = std::is_same_v<cond, Equal>      ? _MM_CMPINT_EQ
+                              : std::is_same_v<cond, NotEqual> ? _MM_CMPINT_NE
+                              : std::is_same_v<cond, Less>     ? _MM_CMPINT_LT
+                                                               : _MM_CMPINT_NLE;
+    static_assert(std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual> || std::is_same_v<cond, Less> ||
+                  std::is_same_v<cond, Greater>);
+
+    __m512i search;
+    if constexpr (width == 8)
+        search = _mm512_set1_epi8(static_cast<char>(value));
+    else if constexpr (width == 16)
+        search = _mm512_set1_epi16(static_cast<short int>(value));
+    else if constexpr (width == 32)
+        search = _mm512_set1_epi32(static_cast<int>(value));
+    else
+        search = _mm512_set1_epi64(value);
+
+    for (size_t i = 0; i < items; ++i) {
+        const __m512i chunk = _mm512_load_si512(data + i);
+
+        // One bit per element
+        uint64_t resmask;
+        if constexpr (width == 8)
+            resmask = _mm512_cmp_epi8_mask(chunk, search, predicate);
+        else if constexpr (width == 16)
+            resmask = _mm512_cmp_epi16_mask(chunk, search, predicate);
+        else if constexpr (width == 32)
+            resmask = _mm512_cmp_epi32_mask(chunk, search, predicate);
+        else
+            resmask = _mm512_cmp_epi64_mask(chunk, search, predicate);
+
+        if (resmask != 0 && !find_mask<width, 1, Callback>(resmask, reinterpret_cast<const char*>(data),
+                                                            i * sizeof(__m512i) * 8 / width, baseindex, state,
+                                                            callback))
+            return false;
+    }
+
+    return true;
+}
+#endif // REALM_COMPILER_AVX
+
+#ifdef REALM_COMPILER_NEON
+template <class cond, size_t width>
+inline uint8x16_t ArrayWithFind::neon_compare(const char* data, int64_t value)
+{
+    static_assert(width == 8 || width == 16 || width == 32 || width == 64);
+    constexpr bool eq = std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual>;
+    constexpr bool gt = std::is_same_v<cond, Greater>;
+
+    if constexpr (width == 8) {
+        const int8x16_t chunk = vld1q_s8(reinterpret_cast<const int8_t*>(data));
+        const int8x16_t search = vdupq_n_s8(static_cast<int8_t>(value));
+        return eq ? vceqq_s8(chunk, search) : (gt ? vcgtq_s8(chunk, search) : vcltq_s8(chunk, search));
+    }
+    else if constexpr (width == 16) {
+        const int16x8_t chunk = vld1q_s16(reinterpret_cast<const int16_t*>(data));
+        const int16x8_t search = vdupq_n_s16(static_cast<int16_t>(value));
+        return vreinterpretq_u8_u16(eq ? vceqq_s16(chunk, search)
+                                       : (gt ? vcgtq_s16(chunk, search) : vcltq_s16(chunk, search)));
+    }
+    else if constexpr (width == 32) {
+        const int32x4_t chunk = vld1q_s32(reinterpret_cast<const int32_t*>(data));
+        const int32x4_t search = vdupq_n_s32(static_cast<int32_t>(value));
+        return vreinterpretq_u8_u32(eq ? vceqq_s32(chunk, search)
+                                       : (gt ? vcgtq_s32(chunk, search) : vcltq_s32(chunk, search)));
+    }
+    else {
+        const int64x2_t chunk = vld1q_s64(reinterpret_cast<const int64_t*>(data));
+        const int64x2_t search = vdupq_n_s64(value);
+        return vreinterpretq_u8_u64(eq ? vceqq_s64(chunk, search)
+                                       : (gt ? vcgtq_s64(chunk, search) : vcltq_s64(chunk, search)));
+    }
+}
+
+// 'items' is the number of 16-byte NEON chunks. 'baseindex' is the index of the first element in the first chunk.
+template <class cond, size_t width, class Callback>
+bool ArrayWithFind::find_neon(int64_t value, const char* data, size_t items, QueryStateBase* state,
+                              size_t baseindex, Callback callback) const
+{
+    for (size_t i = 0; i < items; ++i) {
+        const uint8x16_t compare_result = neon_compare<cond, width>(data + i * 16, value);
+
+        // NEON has no movemask, but narrowing each 16 bit lane by 4 bits yields one nibble per byte
+        uint64_t resmask =
+            vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(compare_result), 4)), 0);
+        if constexpr (std::is_same_v<cond, NotEqual>)
+            resmask = ~resmask;
+
+        if (resmask != 0 &&
+            !find_mask<width, width / 2, Callback>(resmask, data, i * 128 / width, baseindex, state, callback))
+            return false;
+    }
+
+    return true;
+}
+#endif // REALM_COMPILER_NEON
+
+template <size_t width, size_t stride, class Callback>
+inline bool ArrayWithFind::find_mask(uint64_t mask, const char* data, size_t start, size_t baseindex,
+                                     QueryStateBase* state, Callback callback) const
+{
+    while (mask != 0) {
+        size_t s = start + size_t(ctz(size_t(mask))) / stride;
+        if (!find_action(s + baseindex, m_array.get_universal<width>(data, s), state, callback))
+            return false;
+        // Clear the bits of this and all preceding elements, (s - start + 1) * stride never exceeds 64
+        mask &= ~(uint64_t(-1) >> (64 - (s - start + 1) * stride));
+    }
+    return true;
+}
+
 template <class cond, class Callback>
 bool ArrayWithFind::compare_leafs(const Array* foreign, size_t start, size_t end, size_t baseindex,
                                   QueryStateBase* state, Callback callback) const
@@ -869,6 +1197,16 @@ bool ArrayWithFind::compare_leafs(const Array* foreign, size_t start, size_t end
         return true;
     }
 
+    if (REALM_UNLIKELY(m_array.m_is_encoded || foreign->m_is_encoded)) {
+        for (; start < end; ++start) {
+            v = m_array.get(start);
+            if (c(v, foreign->get(start)))
+                if (!find_action(start + baseindex, v, state, callback))
+                    return false;
+        }
+        return true;
+    }
+
     bool r;
     REALM_TEMPEX3(r = compare_leafs, cond, m_array.m_width, Callback,
                   (foreign, start, end, baseindex, state, callback))
@@ -179,10 +179,10 @@ BPlusTreeNode::~BPlusTreeNode()
 ref_type BPlusTreeLeaf::bptree_insert(size_t ndx, State& state, InsertFunc func)
 {
     size_t leaf_size = get_node_size();
-    REALM_ASSERT_DEBUG(leaf_size <= REALM_MAX_BPNODE_SIZE);
+    REALM_ASSERT_DEBUG(leaf_size <= m_tree->get_max_node_size());
     if (ndx > leaf_size)
         ndx = leaf_size;
-    if (REALM_LIKELY(leaf_size < REALM_MAX_BPNODE_SIZE)) {
+    if (REALM_LIKELY(leaf_size < m_tree->get_max_node_size())) {
         func(this, ndx);
         m_tree->adjust_leaf_bounds(1);
         return 0; // Leaf was not split
@@ -386,7 +386,7 @@ size_t BPlusTreeInner::bptree_erase(size_t n, EraseFunc func)
         erase_and_destroy_bp_node(child_ndx);
         return num_children - 1;
     }
-    else if (erase_node_size < REALM_MAX_BPNODE_SIZE / 2 && child_ndx < (num_children - 1)) {
+    else if (erase_node_size < m_tree->get_max_node_size() / 2 && child_ndx < (num_children - 1)) {
         // Candidate for merge. First calculate if the combined size of current and
         // next sibling is small enough.
         size_t sibling_ndx = child_ndx + 1;
@@ -406,7 +406,7 @@ size_t BPlusTreeInner::bptree_erase(size_t n, EraseFunc func)
 
         size_t combined_size = sibling_node->get_node_size() + erase_node_size;
 
-        if (combined_size < REALM_MAX_BPNODE_SIZE * 3 / 4) {
+        if (combined_size < m_tree->get_max_node_size() * 3 / 4) {
             // Combined size is small enough for the nodes to be merged
             // Move all content from the next sibling into current node
             int64_t offs_adj = 0;
@@ -548,7 +548,7 @@ ref_type BPlusTreeInner::insert_bp_node(size_t child_ndx, ref_type new_sibling_r
     size_t new_ref_ndx = child_ndx + 1;
 
     size_t sz = get_node_size();
-    if (sz < REALM_MAX_BPNODE_SIZE) {
+    if (sz < m_tree->get_max_node_size()) {
         // Room in current node for the new child
         adjust(size() - 1, +2); // Throws
         if (m_offsets.is_attached()) {
@@ -203,6 +203,18 @@ public:
             m_root->bp_set_parent(parent, ndx_in_parent);
     }
 
+    /// Maximum number of elements in a leaf and of children of an inner
+    /// node. Nodes are self-describing, so a tree remains readable with any
+    /// limit; the limit only decides when nodes are split and merged.
+    size_t get_max_node_size() const noexcept
+    {
+        return m_max_node_size;
+    }
+    void set_max_node_size(size_t sz) noexcept
+    {
+        m_max_node_size = sz;
+    }
+
     void create();
     void destroy();
     void verify() const
@@ -224,6 +236,7 @@ protected:
     ArrayParent* m_parent = nullptr;
     size_t m_ndx_in_parent = 0;
     size_t m_size = 0;
+    size_t m_max_node_size = REALM_MAX_BPNODE_SIZE;
     size_t m_cached_leaf_begin;
     size_t m_cached_leaf_end;
 
@@ -381,6 +394,26 @@ public:
         return value;
     }
 
+    // Copy the values in [begin, end) to `out`, descending the tree once per
+    // leaf rather than once per element
+    void get_range(size_t begin, size_t end, T* out) const
+    {
+        REALM_ASSERT_DEBUG(begin <= end && end <= m_size);
+        while (begin < end) {
+            size_t copied = 0;
+            auto func = [&](BPlusTreeNode* node, size_t ndx) {
+                LeafNode* leaf = static_cast<LeafNode*>(node);
+                copied = std::min(leaf->size() - ndx, end - begin);
+                for (size_t i = 0; i < copied; i++) {
+                    out[i] = leaf->get(ndx + i);
+                }
+            };
+            m_root->bptree_access(begin, func);
+            begin += copied;
+            out += copied;
+        }
+    }
+
     std::vector<T> get_all() const
     {
         std::vector<T> all_values;
@@ -452,6 +485,58 @@ public:
         }
     }
 
+    // Move the element at `from` so that it ends up at `to`. If both are in
+    // the same leaf, the leaf is updated in place with a single descent, as
+    // the size of the leaf (and thus the offsets of the inner nodes) doesn't
+    // change.
+    void move(size_t from, size_t to)
+    {
+        REALM_ASSERT_DEBUG(from < m_size && to < m_size);
+        if (from == to)
+            return;
+
+        std::string buffer;
+        // Leaf values of these types point into the leaf, so must be copied
+        // out before the leaf is modified
+        auto detach = [&buffer](T& value) {
+            if constexpr (std::is_same_v<T, StringData> || std::is_same_v<T, BinaryData>) {
+                if (!value.is_null()) {
+                    buffer.assign(value.data(), value.size());
+                    value = T(buffer.data(), buffer.size());
+                }
+            }
+            else if constexpr (std::is_same_v<T, Mixed>) {
+                if (value.is_type(type_String, type_Binary)) {
+                    value.use_buffer(buffer);
+                }
+            }
+            else {
+                static_cast<void>(value);
+            }
+        };
+
+        bool done = false;
+        auto func = [&](BPlusTreeNode* node, size_t ndx) {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            size_t leaf_begin = from - ndx;
+            if (to < leaf_begin || to >= leaf_begin + leaf->size())
+                return;
+            T value = leaf->get(ndx);
+            detach(value);
+            leaf->LeafArray::erase(ndx);
+            leaf->LeafArray::insert(to - leaf_begin, value);
+            done = true;
+        };
+        m_root->bptree_access(from, func);
+
+        if (!done) {
+            T value = get(from);
+            detach(value);
+            erase(from);
+            insert(to, value);
+        }
+    }
+
     void erase(size_t n)
     {
         auto func = [](BPlusTreeNode* node, size_t ndx) {
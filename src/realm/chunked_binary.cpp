@@ -103,3 +103,73 @@ BinaryData ChunkedBinaryData::get_first_chunk() const
 {
     return m_begin.get_only();
 }
+
+BinaryListWriter::BinaryListWriter(Lst<BinaryData> list, size_t chunk_size)
+    : m_list(std::move(list))
+    , m_chunk_size(chunk_size)
+{
+    if (m_chunk_size == 0 || m_chunk_size > ArrayBlob::max_binary_size)
+        throw LogicError(LogicError::binary_too_big);
+}
+
+void BinaryListWriter::write(const char* data, size_t size)
+{
+    while (size > 0) {
+        if (m_buffer.size() == 0 && size >= m_chunk_size) {
+            m_list.add(BinaryData(data, m_chunk_size)); // Throws
+            data += m_chunk_size;
+            size -= m_chunk_size;
+            continue;
+        }
+        size_t n = std::min(size, m_chunk_size - m_buffer.size());
+        m_buffer.append(data, n); // Throws
+        data += n;
+        size -= n;
+        if (m_buffer.size() == m_chunk_size)
+            flush(); // Throws
+    }
+}
+
+void BinaryListWriter::flush()
+{
+    if (m_buffer.size() == 0)
+        return;
+    m_list.add(BinaryData(m_buffer.data(), m_buffer.size())); // Throws
+    m_buffer.clear();
+}
+
+size_t BinaryListInputStream::size() const
+{
+    size_t result = 0;
+    for (size_t i = 0, n = m_list.size(); i < n; ++i)
+        result += m_list.get(i).size();
+    return result;
+}
+
+size_t BinaryListInputStream::read_at(size_t offset, char* buffer, size_t size) const
+{
+    size_t copied = 0;
+    for (size_t i = 0, n = m_list.size(); i < n && copied < size; ++i) {
+        BinaryData chunk = m_list.get(i);
+        if (offset >= chunk.size()) {
+            offset -= chunk.size();
+            continue;
+        }
+        size_t m = std::min(chunk.size() - offset, size - copied);
+        std::copy(chunk.data() + offset, chunk.data() + offset + m, buffer + copied);
+        copied += m;
+        offset = 0;
+    }
+    return copied;
+}
+
+util::Span<const char> BinaryListInputStream::next_block()
+{
+    // Empty chunks would otherwise end the stream early
+    while (m_ndx < m_list.size()) {
+        BinaryData chunk = m_list.get(m_ndx++);
+        if (chunk.size() > 0)
+            return {chunk.data(), chunk.size()};
+    }
+    return {};
+}
@@ -21,6 +21,7 @@
 
 #include <realm/binary_data.hpp>
 #include <realm/column_binary.hpp>
+#include <realm/list.hpp>
 #include <realm/table.hpp>
 
 #include <realm/util/buffer.hpp>
@@ -93,6 +94,56 @@ private:
     BinaryIterator m_it;
 };
 
+/// Binary values of any size can be stored in a list of binaries, as a number
+/// of chunks each stored as one element of the list. Every chunk is an ordinary
+/// binary value, so neither writing nor reading such a value needs the whole
+/// of it in memory.
+///
+/// BinaryListWriter appends the data written to it to the list in chunks of
+/// `chunk_size` bytes, so at most one chunk is buffered. Data written in pieces
+/// of at least that size is not buffered at all.
+class BinaryListWriter {
+public:
+    static constexpr size_t default_chunk_size = 1024 * 1024;
+
+    explicit BinaryListWriter(Lst<BinaryData> list, size_t chunk_size = default_chunk_size);
+
+    void write(const char* data, size_t size);
+
+    /// Appends the buffered data, if any, as the last chunk. Must be called
+    /// before the write transaction is committed.
+    void flush();
+
+private:
+    Lst<BinaryData> m_list;
+    const size_t m_chunk_size;
+    util::AppendBuffer<char> m_buffer;
+};
+
+/// Reads a value stored as a list of chunks, one chunk at a time, or any range
+/// of it on demand. The chunks are read directly from the file.
+class BinaryListInputStream : public util::NoCopyInputStream {
+public:
+    explicit BinaryListInputStream(Lst<BinaryData> list)
+        : m_list(std::move(list))
+    {
+    }
+
+    /// The size of the whole value. This is O(n) in the number of chunks.
+    size_t size() const;
+
+    /// Copies at most `size` bytes starting at `offset` into `buffer`, and
+    /// returns the number of bytes copied, which is only less than `size` at
+    /// the end of the value.
+    size_t read_at(size_t offset, char* buffer, size_t size) const;
+
+    util::Span<const char> next_block() override;
+
+private:
+    Lst<BinaryData> m_list;
+    size_t m_ndx = 0;
+};
+
 } // namespace realm
 
 #endif // REALM_NOINST_CHUNKED_BINARY_HPP
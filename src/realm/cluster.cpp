@@ -261,6 +261,12 @@ inline void Cluster::set_spec(ArrayString& arr, ColKey::Idx col_ndx) const
     m_tree_top.set_spec(arr, col_ndx);
 }
 
+template <>
+inline void Cluster::set_spec(ArrayBinary& arr, ColKey::Idx col_ndx) const
+{
+    m_tree_top.set_spec(arr, col_ndx);
+}
+
 template <class T>
 inline void Cluster::do_insert_row(size_t ndx, ColKey col, Mixed init_val, bool nullable)
 {
@@ -445,10 +451,12 @@ inline void Cluster::do_move(size_t ndx, ColKey col_key, Cluster* to)
     auto col_ndx = col_key.get_index().val + s_first_col_index;
     T src(m_alloc);
     src.set_parent(this, col_ndx);
+    set_spec<T>(src, col_key.get_index());
     src.init_from_parent();
 
     T dst(m_alloc);
     dst.set_parent(to, col_ndx);
+    set_spec<T>(dst, col_key.get_index());
     dst.init_from_parent();
 
     src.move(dst, ndx);
@@ -693,13 +701,13 @@ ref_type Cluster::insert(ObjKey k, const FieldValues& init_values, ClusterNode::
         }
         // Key value is bigger than all other values, should be put last
         ndx = sz;
-        if (uint64_t(k.value) > sz && sz < cluster_node_size) {
+        if (uint64_t(k.value) > sz && sz < cluster_node_size()) {
             ensure_general_form();
         }
     }
 
-    REALM_ASSERT_DEBUG(sz <= cluster_node_size);
-    if (REALM_LIKELY(sz < cluster_node_size)) {
+    REALM_ASSERT_DEBUG(sz <= cluster_node_size());
+    if (REALM_LIKELY(sz < cluster_node_size())) {
         insert_row(ndx, k, init_values); // Throws
         state.mem = get_mem();
         state.index = ndx;
@@ -69,6 +69,17 @@ private:
 
 class ClusterNode : public Array {
 public:
+#if REALM_MAX_BPNODE_SIZE > 256
+    static constexpr int node_shift_factor = 8;
+#else
+    static constexpr int node_shift_factor = 2;
+#endif
+
+    // Maximum number of objects in a leaf, and of children of an inner node,
+    // unless a different size has been chosen for the tree. Inner nodes in
+    // compact form (without a key array) are only used with this size.
+    static constexpr size_t default_cluster_node_size = 1 << node_shift_factor;
+
     // This structure is used to bring information back to the upper nodes when
     // inserting new objects or finding existing ones.
     struct State {
@@ -193,13 +204,7 @@ public:
     }
 
 protected:
-#if REALM_MAX_BPNODE_SIZE > 256
-    static constexpr int node_shift_factor = 8;
-#else
-    static constexpr int node_shift_factor = 2;
-#endif
-
-    static constexpr size_t cluster_node_size = 1 << node_shift_factor;
+    size_t cluster_node_size() const noexcept;
 
     const ClusterTree& m_tree_top;
     ClusterKeyArray m_keys;
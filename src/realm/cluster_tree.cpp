@@ -24,6 +24,7 @@
 #include "realm/array_bool.hpp"
 #include "realm/array_string.hpp"
 #include "realm/array_fixed_bytes.hpp"
+#include "realm/util/file_mapper.hpp"
 
 #include <iostream>
 
@@ -46,6 +47,8 @@ namespace realm {
  * (optional) key array in position 0 and the subtree depth in position 1. After
  * that follows refs to the subordinate nodes.
  */
+class TraversalPrefetcher;
+
 class ClusterNodeInner : public ClusterNode {
 public:
     ClusterNodeInner(Allocator& allocator, const ClusterTree& tree_top);
@@ -67,7 +70,7 @@ public:
         return m_sub_tree_depth;
     }
 
-    bool traverse(ClusterTree::TraverseFunction func, int64_t) const;
+    bool traverse(ClusterTree::TraverseFunction func, int64_t, TraversalPrefetcher*) const;
     void update(ClusterTree::UpdateFunction func, int64_t);
 
     size_t node_size() const override
@@ -204,6 +207,13 @@ void ClusterNodeInner::create(int sub_tree_depth)
     Array::set(s_sub_tree_size, 1); // sub_tree_size = 0 (as tagged value)
     m_sub_tree_depth = sub_tree_depth;
     m_shift_factor = m_sub_tree_depth * node_shift_factor;
+
+    if (cluster_node_size() != default_cluster_node_size) {
+        // The key offsets of a compact node are derived from the default node
+        // size, so with any other size the key array is always present.
+        m_keys.create(0, 0);
+        m_keys.update_parent();
+    }
 }
 
 void ClusterNodeInner::init(MemRef mem)
@@ -300,7 +310,7 @@ ref_type ClusterNodeInner::insert(ObjKey key, const FieldValues& init_values, Cl
 
         int64_t split_key_value = state.split_key + child_info.offset;
         uint64_t sz = node_size();
-        if (sz < cluster_node_size) {
+        if (sz < cluster_node_size()) {
             if (m_keys.is_attached()) {
                 m_keys.insert(new_ref_ndx, split_key_value);
             }
@@ -467,7 +477,7 @@ size_t ClusterNodeInner::erase(ObjKey key, CascadeState& state)
                 adjust_keys_first_child(first_offset);
             }
         }
-        else if (erase_node_size < cluster_node_size / 2 && child_info.ndx < (node_size() - 1)) {
+        else if (erase_node_size < cluster_node_size() / 2 && child_info.ndx < (node_size() - 1)) {
             // Candidate for merge. First calculate if the combined size of current and
             // next sibling is small enough.
             size_t sibling_ndx = child_info.ndx + 1;
@@ -479,7 +489,7 @@ size_t ClusterNodeInner::erase(ObjKey key, CascadeState& state)
 
             size_t combined_size = sibling_node->node_size() + erase_node_size;
 
-            if (combined_size < cluster_node_size * 3 / 4) {
+            if (combined_size < cluster_node_size() * 3 / 4) {
                 // Calculate value that must be subtracted from the moved keys
                 // (will be negative as the sibling has bigger keys)
                 int64_t key_adj = m_keys.is_attached() ? (m_keys.get(child_info.ndx) - m_keys.get(sibling_ndx))
@@ -679,11 +689,79 @@ size_t ClusterNodeInner::update_sub_tree_size()
     return sub_tree_size;
 }
 
-bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset) const
+/// Used by traversals made while a `util::SequentialScanHint` is active to
+/// request the memory of the nodes a few children ahead of the one being
+/// visited, so that a cold scan doesn't stall on a page fault for every array.
+/// The array of a child is requested first and the column arrays of a leaf
+/// once its own array is likely to have arrived.
+class TraversalPrefetcher {
+public:
+    static constexpr size_t node_distance = 4;
+    static constexpr size_t column_distance = 2;
+
+    TraversalPrefetcher(Allocator& alloc) noexcept
+        : m_alloc(alloc)
+    {
+    }
+
+    void prefetch_node(ref_type ref) noexcept
+    {
+        if (!ref)
+            return;
+#if defined(__GNUC__)
+        __builtin_prefetch(m_alloc.translate(ref));
+#endif
+        // Arrays written by the same commit tend to be adjacent in the file,
+        // so skip refs within a range which has recently been requested.
+        for (auto begin : m_recent_ranges) {
+            if (begin <= ref && ref < begin + range_size)
+                return;
+        }
+        m_alloc.prefetch(ref, range_size);
+        m_recent_ranges[m_next_range] = ref;
+        m_next_range = (m_next_range + 1) % num_recent_ranges;
+    }
+
+    void prefetch_columns(MemRef leaf_mem) noexcept
+    {
+        if (Array::get_is_inner_bptree_node_from_header(leaf_mem.get_addr()))
+            return;
+        Array leaf(m_alloc);
+        leaf.init_from_mem(leaf_mem);
+        for (size_t i = 0; i < leaf.size(); ++i) {
+            auto rot = leaf.get_as_ref_or_tagged(i);
+            if (rot.is_ref())
+                prefetch_node(rot.get_as_ref());
+        }
+    }
+
+private:
+    static constexpr size_t range_size = 8 * 1024;
+    static constexpr size_t num_recent_ranges = 8;
+
+    Allocator& m_alloc;
+    ref_type m_recent_ranges[num_recent_ranges] = {};
+    size_t m_next_range = 0;
+};
+
+bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset,
+                                TraversalPrefetcher* prefetcher) const
 {
     auto sz = node_size();
 
+    if (prefetcher) {
+        for (size_t i = 0; i < std::min(sz, TraversalPrefetcher::node_distance); i++)
+            prefetcher->prefetch_node(_get_child_ref(i));
+    }
     for (unsigned i = 0; i < sz; i++) {
+        if (prefetcher) {
+            if (i + TraversalPrefetcher::node_distance < sz)
+                prefetcher->prefetch_node(_get_child_ref(i + TraversalPrefetcher::node_distance));
+            if (i + TraversalPrefetcher::column_distance < sz) {
+                ref_type ahead = _get_child_ref(i + TraversalPrefetcher::column_distance);
+                prefetcher->prefetch_columns(MemRef(m_alloc.translate(ahead), ahead, m_alloc));
+            }
+        }
         ref_type ref = _get_child_ref(i);
         char* header = m_alloc.translate(ref);
         bool child_is_leaf = !Array::get_is_inner_bptree_node_from_header(header);
@@ -699,7 +777,7 @@ bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_
         else {
             ClusterNodeInner node(m_alloc, m_tree_top);
             node.init(mem);
-            if (node.traverse(func, offs)) {
+            if (node.traverse(func, offs, prefetcher)) {
                 return true;
             }
         }
@@ -845,6 +923,7 @@ void ClusterTree::clear()
 
     bump_content_version();
     bump_storage_version();
+    invalidate_leaf_cache();
 
     m_size = 0;
 }
@@ -861,6 +940,7 @@ void ClusterTree::replace_root(std::unique_ptr<ClusterNode> new_root)
 
 bool ClusterTree::init_from_parent()
 {
+    invalidate_leaf_cache();
     m_root = get_root_from_parent();
     if (m_root) {
         m_size = m_root->get_tree_size();
@@ -872,6 +952,7 @@ bool ClusterTree::init_from_parent()
 
 void ClusterTree::update_from_parent() noexcept
 {
+    invalidate_leaf_cache();
     m_root->update_from_parent();
     m_size = m_root->get_tree_size();
 }
@@ -911,24 +992,85 @@ bool ClusterTree::is_valid(ObjKey k) const noexcept
         return false;
 
     ClusterNode::State state;
+    if (use_leaf_cache())
+        return k && try_get_cached(k, state);
     return m_root->try_get(k, state);
 }
 
 ClusterNode::State ClusterTree::get(ObjKey k) const
 {
     ClusterNode::State state;
-    m_root->get(k, state);
+    if (use_leaf_cache() && k && try_get_cached(k, state))
+        return state;
+    m_root->get(k, state); // Throws
     return state;
 }
 
 ClusterNode::State ClusterTree::try_get(ObjKey k) const noexcept
 {
     ClusterNode::State state;
-    if (!(k && m_root->try_get(k, state)))
+    bool found = k && (use_leaf_cache() ? try_get_cached(k, state) : m_root->try_get(k, state));
+    if (!found)
         state.index = realm::npos;
     return state;
 }
 
+void ClusterTree::set_leaf_cache_enabled(bool enable)
+{
+    if (enable) {
+        for (auto& entry : m_leaf_cache) {
+            if (!entry.leaf)
+                entry.leaf = std::make_unique<Cluster>(0, m_alloc, *this); // Throws
+        }
+    }
+    invalidate_leaf_cache();
+    m_leaf_cache_enabled = enable;
+}
+
+void ClusterTree::invalidate_leaf_cache() const noexcept
+{
+    for (auto& entry : m_leaf_cache) {
+        entry.first_key = 1;
+        entry.last_key = 0;
+    }
+}
+
+bool ClusterTree::try_get_cached(ObjKey k, ClusterNode::State& state) const noexcept
+{
+    // Any change to the layout of the tree bumps the storage version, after
+    // which the cached leaf accessors may refer to stale memory.
+    auto storage_version = m_alloc.get_storage_version();
+    if (storage_version != m_leaf_cache_storage_version) {
+        invalidate_leaf_cache();
+        m_leaf_cache_storage_version = storage_version;
+    }
+
+    // Keys are unique and ordered across leaves, so a key within the range of
+    // a leaf can only be found in that leaf.
+    uint64_t key = uint64_t(k.value);
+    for (auto& entry : m_leaf_cache) {
+        if (entry.first_key <= key && key <= entry.last_key) {
+            return entry.leaf->try_get(ObjKey(k.value - entry.leaf->get_offset()), state);
+        }
+    }
+
+    CachedLeaf& entry = m_leaf_cache[m_leaf_cache_next];
+    m_leaf_cache_next = (m_leaf_cache_next + 1) % s_leaf_cache_size;
+    entry.first_key = 1;
+    entry.last_key = 0;
+
+    // Find the leaf holding the first key not less than k
+    ClusterNode::IteratorState leaf_state(*entry.leaf);
+    if (!get_leaf(k, leaf_state))
+        return false;
+
+    Cluster& leaf = *entry.leaf;
+    uint64_t offset = leaf.get_offset();
+    entry.first_key = offset + leaf.get_key_value(0);
+    entry.last_key = offset + leaf.get_key_value(leaf.node_size() - 1);
+    return leaf.try_get(ObjKey(k.value - offset), state);
+}
+
 ClusterNode::State ClusterTree::get(size_t ndx, ObjKey& k) const
 {
     if (ndx >= m_size) {
@@ -997,7 +1139,11 @@ bool ClusterTree::traverse(TraverseFunction func) const
         return func(static_cast<Cluster*>(m_root.get()));
     }
     else {
-        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0);
+        if (util::SequentialScanHint::is_active()) {
+            TraversalPrefetcher prefetcher(m_alloc);
+            return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0, &prefetcher);
+        }
+        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0, nullptr);
     }
 }
 
@@ -69,6 +69,27 @@ public:
 
     static size_t size_from_ref(ref_type, Allocator& alloc);
 
+    /// Maximum number of objects in a leaf and of children of an inner node.
+    size_t get_max_node_size() const noexcept
+    {
+        return m_max_node_size;
+    }
+    /// Must be set before any object is inserted. The size is not persisted
+    /// by the tree itself, so the owner must set it again every time the
+    /// accessor is initialized.
+    void set_max_node_size(size_t sz) noexcept
+    {
+        m_max_node_size = sz;
+    }
+
+    /// Keep accessors for the leaves most recently used by lookups by key, so
+    /// that repeated lookups in the same leaves (e.g. `Table::get_object()`,
+    /// `Obj` refresh and link traversal) don't descend from the root. The
+    /// cache is validated against the storage version and makes `get()` and
+    /// `try_get()` mutate the accessor, so it must not be enabled for trees
+    /// that may be read concurrently (frozen tables).
+    void set_leaf_cache_enabled(bool enable);
+
     void destroy()
     {
         m_root->destroy_deep();
@@ -175,6 +196,26 @@ protected:
 
     std::unique_ptr<ClusterNode> m_root;
     size_t m_size = 0;
+    size_t m_max_node_size = ClusterNode::default_cluster_node_size;
+
+    struct CachedLeaf {
+        std::unique_ptr<Cluster> leaf;
+        // Range of absolute keys covered by the leaf. Empty if first > last.
+        uint64_t first_key = 1;
+        uint64_t last_key = 0;
+    };
+    static constexpr size_t s_leaf_cache_size = 4;
+    bool m_leaf_cache_enabled = false;
+    mutable uint64_t m_leaf_cache_storage_version = 0;
+    mutable size_t m_leaf_cache_next = 0;
+    mutable CachedLeaf m_leaf_cache[s_leaf_cache_size];
+
+    bool use_leaf_cache() const noexcept
+    {
+        return m_leaf_cache_enabled && !m_root->is_leaf();
+    }
+    bool try_get_cached(ObjKey k, ClusterNode::State& state) const noexcept;
+    void invalidate_leaf_cache() const noexcept;
 
     void clear();
     void replace_root(std::unique_ptr<ClusterNode> leaf);
@@ -231,6 +272,11 @@ protected:
     ObjKey load_leaf(ObjKey key) const;
     size_t get_position();
 };
+
+inline size_t ClusterNode::cluster_node_size() const noexcept
+{
+    return m_tree_top.get_max_node_size();
+}
 } // namespace realm
 
 #endif /* REALM_CLUSTER_TREE_HPP */
@@ -146,8 +146,10 @@ enum ColumnAttr {
     /// `col_attr_Indexed`.
     col_attr_Unique = 2,
 
-    /// Reserved for future use.
-    col_attr_Reserved = 4,
+    /// Specifies that large string and binary values written to this column
+    /// are stored compressed. Like `col_attr_Indexed`, this is only recorded in
+    /// the spec and is not part of the column key.
+    col_attr_Compressed = 4,
 
     /// Specifies that the links of this column are strong, not weak. Applies
     /// only to link columns (`type_Link` and `type_LinkList`).
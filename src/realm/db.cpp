@@ -19,6 +19,7 @@
 #include <realm/transaction.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cerrno>
 #include <fcntl.h>
@@ -28,12 +29,14 @@
 #include <type_traits>
 #include <random>
 #include <deque>
+#include <map>
 #include <thread>
 #include <condition_variable>
 
 #include <realm/disable_sync_to_disk.hpp>
 #include <realm/group_writer.hpp>
 #include <realm/impl/simulated_failure.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/replication.hpp>
 #include <realm/util/errno.hpp>
 #include <realm/util/features.h>
@@ -42,6 +45,7 @@
 #include <realm/util/scope_exit.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/to_string.hpp>
+#include <realm/util/tracing.hpp>
 
 #ifndef _WIN32
 #include <sys/wait.h>
@@ -78,7 +82,8 @@ namespace {
 // 11      New impl of InterprocessCondVar on windows.
 // 12      Change `number_of_versions` to an atomic rather than guarding it
 //         with a lock.
-const uint_fast16_t g_shared_info_version = 12;
+// 13      New impl of InterprocessCondVar on Linux, based on a futex.
+const uint_fast16_t g_shared_info_version = 13;
 
 // The following functions are carefully designed for minimal overhead
 // in case of contention among read transactions. In case of contention,
@@ -360,13 +365,33 @@ public:
         // dump();
         while (m_old_pos.load(std::memory_order_relaxed) != m_put_pos.load(std::memory_order_relaxed)) {
             const ReadCount& r = get(m_old_pos.load(std::memory_order_relaxed));
-            if (!atomic_one_if_zero(r.count))
+            // Entries released by release_unread() are odd already
+            if (!(r.count.load(std::memory_order_acquire) & 1) && !atomic_one_if_zero(r.count))
                 break;
             auto next_ndx = get(m_old_pos.load(std::memory_order_relaxed)).next;
             m_old_pos.store(next_ndx, std::memory_order_relaxed);
         }
     }
 
+    // Make the live entries between the oldest and the last one which are not
+    // read available for cleanup, and call 'func(entry)' for those which are
+    // read. Unlike cleanup(), this never makes the count odd temporarily, as
+    // that would make a concurrent attempt to read such an entry fail. Must
+    // only be called by the thread doing cleanup().
+    template <class F>
+    void release_unread(F func) noexcept
+    {
+        uint_fast32_t put_pos = m_put_pos.load(std::memory_order_relaxed);
+        for (uint_fast32_t i = m_old_pos.load(std::memory_order_relaxed); i != put_pos; i = get(i).next) {
+            const ReadCount& r = get(i);
+            uint32_t count = 0;
+            if (r.count.compare_exchange_strong(count, 1, std::memory_order_acquire))
+                continue;
+            if (!(count & 1))
+                func(r);
+        }
+    }
+
 private:
     // number of entries. Access synchronized through put_pos.
     uint32_t m_entries;
@@ -406,8 +431,553 @@ TransactionRef make_transaction_ref(Args&&... args)
     return TransactionRef(new Transaction(std::forward<Args>(args)...), TransactionDeleter);
 }
 
+util::MappingAdvice mapping_advice_for(DBOptions::AccessPattern pattern)
+{
+    switch (pattern) {
+        case DBOptions::AccessPattern::Normal:
+            break;
+        case DBOptions::AccessPattern::Random:
+            return util::MappingAdvice::Random;
+        case DBOptions::AccessPattern::Sequential:
+            return util::MappingAdvice::Sequential;
+    }
+    return util::MappingAdvice::Normal;
+}
+
+// The access profile lists the ranges of the file which were held in memory
+// when the last session on the file ended. It starts with a magic number,
+// followed by the page size and the number of ranges. Then follows, for each
+// range, the number of pages since the end of the previous range and the number
+// of pages in the range. All numbers are stored as variable length integers.
+constexpr char access_profile_magic[4] = {'R', 'A', 'P', '1'};
+
+// Ranges less than this many pages apart are recorded as one
+constexpr size_t access_profile_max_gap = 16;
+
+// The amount of the file each call to File::prefetch() covers
+constexpr size_t access_profile_prefetch_chunk = 4 * 1024 * 1024;
+
+std::string get_access_profile_path(const std::string& coordination_dir)
+{
+    return coordination_dir + "/access_profile";
+}
+
+void encode_varint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out += char(value | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+bool decode_varint(const char*& p, const char* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; p != end && shift < 64; shift += 7) {
+        auto byte = uint8_t(*p++);
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+void write_access_profile(const std::string& path, const std::vector<std::pair<size_t, size_t>>& ranges)
+{
+    const size_t page_size = util::page_size();
+    std::vector<std::pair<size_t, size_t>> merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && range.first - (merged.back().first + merged.back().second) <=
+                                   access_profile_max_gap * page_size) {
+            merged.back().second = range.first + range.second - merged.back().first;
+            continue;
+        }
+        merged.push_back(range);
+    }
+    std::string buffer(access_profile_magic, sizeof access_profile_magic);
+    encode_varint(buffer, page_size);
+    encode_varint(buffer, merged.size());
+    size_t end = 0;
+    for (const auto& range : merged) {
+        encode_varint(buffer, (range.first - end) / page_size);
+        encode_varint(buffer, range.second / page_size);
+        end = range.first + range.second;
+    }
+    // Replace the old profile atomically, so that a concurrent open never reads
+    // a partial one
+    std::string tmp_path = path + ".tmp";
+    {
+        File file(tmp_path, File::mode_Write);
+        file.write(buffer.data(), buffer.size());
+    }
+    File::move(tmp_path, path);
+}
+
+// Find the ranges of the file which are held in the page cache
+std::vector<std::pair<size_t, size_t>> get_resident_file_ranges(const std::string& path)
+{
+    // Map a bounded part of the file at a time to not exhaust the address space
+    constexpr size_t max_map_size = 256 * 1024 * 1024;
+    const size_t page_size = util::page_size();
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::vector<bool> pages;
+    File file(path); // Throws
+    size_t file_size = size_t(file.get_size());
+    for (size_t base = 0; base < file_size; base += max_map_size) {
+        File::Map<char> map(file, base, File::access_ReadOnly, std::min(max_map_size, file_size - base)); // Throws
+        if (!util::get_resident_pages(map.get_addr(), map.get_size(), pages))
+            return {};
+        for (size_t i = 0; i < pages.size(); ++i) {
+            if (!pages[i])
+                continue;
+            size_t offset = base + i * page_size;
+            if (!ranges.empty() && ranges.back().first + ranges.back().second == offset)
+                ranges.back().second += page_size;
+            else
+                ranges.emplace_back(offset, page_size);
+        }
+    }
+    return ranges;
+}
+
+// Returns no ranges if there is no profile, or it is malformed
+std::vector<std::pair<size_t, size_t>> read_access_profile(const std::string& path)
+{
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (!File::exists(path))
+        return ranges;
+    File file(path); // Throws
+    std::string buffer(size_t(file.get_size()), '\0');
+    if (file.read(buffer.data(), buffer.size()) != buffer.size() || buffer.size() < sizeof access_profile_magic ||
+        buffer.compare(0, sizeof access_profile_magic, access_profile_magic, sizeof access_profile_magic) != 0)
+        return ranges;
+    const char* p = buffer.data() + sizeof access_profile_magic;
+    const char* end = buffer.data() + buffer.size();
+    uint64_t page_size, num_ranges;
+    if (!decode_varint(p, end, page_size) || !decode_varint(p, end, num_ranges) || page_size == 0)
+        return ranges;
+    uint64_t range_end = 0;
+    for (uint64_t i = 0; i < num_ranges; ++i) {
+        uint64_t gap, size;
+        if (!decode_varint(p, end, gap) || !decode_varint(p, end, size))
+            return {};
+        uint64_t offset = range_end + gap * page_size;
+        range_end = offset + size * page_size;
+        if (range_end < offset || range_end > std::numeric_limits<size_t>::max())
+            return {};
+        ranges.emplace_back(size_t(offset), size_t(size * page_size));
+    }
+    return ranges;
+}
+
+// Start reading in the arrays directly below the top array, and the top array
+// of each table, which are needed by the first transactions on the file.
+void prefetch_top_arrays(SlabAlloc& alloc, const Array& top)
+{
+    for (size_t i = 0; i < top.size(); ++i) {
+        RefOrTagged rot = top.get_as_ref_or_tagged(i);
+        if (rot.is_ref())
+            alloc.prefetch(rot.get_as_ref());
+    }
+    // The second entry of the top array holds the refs of the tables
+    if (top.size() > 1 && top.get_as_ref(1)) {
+        Array tables{alloc};
+        tables.init_from_ref(top.get_as_ref(1));
+        for (size_t i = 0; i < tables.size(); ++i) {
+            RefOrTagged rot = tables.get_as_ref_or_tagged(i);
+            if (rot.is_ref())
+                alloc.prefetch(rot.get_as_ref());
+        }
+    }
+}
+
+// The array encodings requested by the options, which need the file format
+// version allowing compact encodings
+unsigned get_enabled_encodings(const DBOptions& options) noexcept
+{
+    unsigned encodings = 0;
+    if (options.enable_string_dictionary_encoding)
+        encodings |= Allocator::encoding_DictStrings;
+    if (options.enable_value_compression)
+        encodings |= Allocator::encoding_CompressedValues;
+    if (options.enable_compact_decimal_leaves)
+        encodings |= Allocator::encoding_CompactDecimals;
+    return encodings;
+}
+
+} // anonymous namespace
+
+
+// Process local bookkeeping of the read locks held through a DB object, with one
+// counter per ringbuffer entry. The counters are only accessed with atomic operations,
+// so threads can begin and end read transactions concurrently without serializing on
+// DB::m_mutex. The counters are stored in chunks of doubling size, which allows the
+// ringbuffer to grow without ever moving a counter that another thread may be using.
+class DB::ReadLockCounts {
+public:
+    // A counter holds the number of locks held on the entry in the low 32 bits and the
+    // number of threads currently releasing a lock on the entry in the bits above that.
+    // The top bit is set once release_all() has released the locks on the entry.
+    static constexpr uint64_t held_mask = 0xFFFFFFFFULL;
+    static constexpr uint64_t busy_one = 1ULL << 32;
+    static constexpr uint64_t busy_mask = 0x7FFFFFFFULL << 32;
+    static constexpr uint64_t released = 1ULL << 63;
+
+    using Counter = std::atomic<uint64_t>;
+
+    ~ReadLockCounts()
+    {
+        for (auto& chunk : m_chunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    // Make counters available for entries below 'num_entries'. Caller must lock DB::m_mutex.
+    void reserve(uint_fast32_t num_entries)
+    {
+        for (size_t k = 0; chunk_begin(k) < num_entries; ++k) {
+            REALM_ASSERT_RELEASE(k < max_chunks);
+            if (!m_chunks[k].load(std::memory_order_relaxed))
+                m_chunks[k].store(new Counter[chunk_size(k)](), std::memory_order_release); // Throws
+        }
+    }
+
+    // The entry must be below a size previously passed to reserve().
+    Counter& get(uint_fast32_t idx) noexcept
+    {
+        size_t k = 0;
+        while (idx >= chunk_begin(k + 1))
+            ++k;
+        return m_chunks[k].load(std::memory_order_acquire)[idx - chunk_begin(k)];
+    }
+
+    // Mark all counters as released, and call 'func(idx, num_held)' for every entry with
+    // locks held. Waits for any concurrent release of a lock to complete. Caller must
+    // lock DB::m_mutex.
+    template <class F>
+    void release_all(F func) noexcept
+    {
+        for (size_t k = 0; k < max_chunks; ++k) {
+            Counter* chunk = m_chunks[k].load(std::memory_order_relaxed);
+            if (!chunk)
+                break;
+            for (size_t i = 0; i < chunk_size(k); ++i) {
+                uint64_t val = chunk[i].fetch_or(released, std::memory_order_acq_rel);
+                while (val & busy_mask) {
+                    std::this_thread::yield();
+                    val = chunk[i].load(std::memory_order_acquire);
+                }
+                if (uint32_t num_held = uint32_t(val & held_mask))
+                    func(uint_fast32_t(chunk_begin(k) + i), num_held);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t first_chunk_size = 32;
+    static constexpr size_t max_chunks = 26;
+
+    static constexpr size_t chunk_size(size_t k) noexcept
+    {
+        return first_chunk_size << k;
+    }
+    static constexpr size_t chunk_begin(size_t k) noexcept
+    {
+        return first_chunk_size * ((size_t(1) << k) - 1);
+    }
+
+    std::atomic<Counter*> m_chunks[max_chunks] = {};
+};
+
+
+// Announces that a read lock is being taken, or a transaction created on one,
+// which is done without holding m_mutex. close() sets m_closing and then waits
+// for all of these to be gone before it releases the read locks and unmaps the
+// ringbuffer. Announcing before checking m_closing makes that race-free.
+class DB::ReadLockGrab {
+public:
+    explicit ReadLockGrab(DB& db)
+        : m_db(db)
+    {
+        ++m_db.m_read_lock_grabs;
+        if (REALM_UNLIKELY(m_db.m_closing)) {
+            --m_db.m_read_lock_grabs;
+            throw LogicError(LogicError::wrong_transact_state);
+        }
+    }
+    ~ReadLockGrab() noexcept
+    {
+        --m_db.m_read_lock_grabs;
+    }
+    ReadLockGrab(const ReadLockGrab&) = delete;
+    ReadLockGrab& operator=(const ReadLockGrab&) = delete;
+
+private:
+    DB& m_db;
+};
+
+
+namespace {
+
+// The slot in the management directory through which a DB publishing to
+// replicas hands them the latest version. It is a seqlock: the sequence is odd
+// while the slot is being updated, and readers retry if it changed while they
+// read the slot.
+//
+// Each open replica owns one of the entries in `oldest_read`, by holding an
+// exclusive lock on the lock file of that entry, and announces in it the oldest
+// version its transactions read, or zero. Publishers keep the versions from the
+// oldest one announced by an open replica.
+struct ReplicaSlot {
+    static constexpr uint64_t magic_value = 0x325F41434C504552; // "REPLCA_2"
+    static constexpr size_t max_replicas = 64;
+    std::atomic<uint64_t> magic;
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> top_ref;
+    std::atomic<uint64_t> file_size;
+    std::atomic<uint64_t> oldest_read[max_replicas];
+};
+
+std::string get_replica_slot_path(const std::string& coordination_dir)
+{
+    return coordination_dir + "/replica";
+}
+
+std::string get_replica_lock_path(const std::string& coordination_dir, size_t ndx)
+{
+    return coordination_dir + "/replica." + util::to_string(ndx);
+}
+
 } // anonymous namespace
 
+class DB::ReplicaPublisher {
+public:
+    explicit ReplicaPublisher(const std::string& coordination_dir)
+        : m_coordination_dir(coordination_dir)
+    {
+        m_file.open(get_replica_slot_path(coordination_dir), File::access_ReadWrite, File::create_Auto,
+                    0); // Throws
+        if (m_file.get_size() < File::SizeType(sizeof(ReplicaSlot)))
+            m_file.resize(sizeof(ReplicaSlot)); // Throws
+        m_map.map(m_file, File::access_ReadWrite, sizeof(ReplicaSlot)); // Throws
+    }
+
+    // Publish the latest version, and let go of the superseded versions which
+    // no open replica reads. Caller must hold the write lock.
+    void publish(DB& db)
+    {
+        ReadLockInfo read_lock;
+        db.grab_read_lock(read_lock, VersionID()); // Throws
+        try {
+            m_retained.push_back(read_lock); // Throws
+        }
+        catch (...) {
+            db.release_read_lock(read_lock);
+            throw;
+        }
+
+        ReplicaSlot& slot = *m_map.get_addr();
+        // A publisher which crashed while updating may have left it odd
+        uint64_t sequence = (slot.sequence.load(std::memory_order_relaxed) + 1) & ~uint64_t(1);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.version.store(read_lock.m_version, std::memory_order_relaxed);
+        slot.top_ref.store(read_lock.m_top_ref, std::memory_order_relaxed);
+        slot.file_size.store(read_lock.m_file_size, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        slot.magic.store(ReplicaSlot::magic_value, std::memory_order_release);
+
+        // Pairs with the fence in ReplicaReader::grab(). Either the replica
+        // announcement is seen here, or the replica sees the new version and
+        // does not use the one it announced.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        version_type oldest_read = std::numeric_limits<version_type>::max();
+        for (size_t i = 0; i < ReplicaSlot::max_replicas; ++i) {
+            version_type version = slot.oldest_read[i].load(std::memory_order_relaxed);
+            if (version && version < oldest_read && is_replica_open(i))
+                oldest_read = version;
+        }
+        while (m_retained.size() > 1 && m_retained.front().m_version < oldest_read) {
+            db.release_read_lock(m_retained.front());
+            m_retained.pop_front();
+        }
+    }
+
+    size_t get_num_retained() const noexcept
+    {
+        return m_retained.size();
+    }
+
+    // Stop replicas from opening the file. Those already open must be checked
+    // for afterwards with has_open_replicas().
+    void unpublish() noexcept
+    {
+        m_map.get_addr()->magic.store(0, std::memory_order_seq_cst);
+    }
+
+    bool has_open_replicas() noexcept
+    {
+        for (size_t i = 0; i < ReplicaSlot::max_replicas; ++i) {
+            if (is_replica_open(i))
+                return true;
+        }
+        return false;
+    }
+
+    void release_all(DB& db) noexcept
+    {
+        for (auto& read_lock : m_retained)
+            db.release_read_lock(read_lock);
+        m_retained.clear();
+    }
+
+private:
+    const std::string m_coordination_dir;
+    File m_file;
+    File::Map<ReplicaSlot> m_map;
+    // The published versions which replicas may still read, oldest first
+    std::deque<ReadLockInfo> m_retained;
+    std::array<File, ReplicaSlot::max_replicas> m_replica_lock_files;
+
+    bool is_replica_open(size_t ndx) noexcept
+    {
+        // An entry left behind by a replica which crashed is not locked
+        try {
+            File& file = m_replica_lock_files[ndx];
+            if (!file.is_attached())
+                file.open(get_replica_lock_path(m_coordination_dir, ndx), File::access_ReadWrite,
+                          File::create_Auto, 0); // Throws
+            if (!file.try_lock_shared()) // Throws
+                return true;
+            file.unlock();
+            return false;
+        }
+        catch (...) {
+            return true;
+        }
+    }
+};
+
+class DB::ReplicaReader {
+public:
+    explicit ReplicaReader(const std::string& coordination_dir)
+    {
+        std::string path = get_replica_slot_path(coordination_dir);
+        if (!File::exists(path))
+            throw InvalidDatabase("No version has been published to replicas", path);
+        m_file.open(path, File::access_ReadWrite, File::create_Never, 0); // Throws
+        if (m_file.get_size() < File::SizeType(sizeof(ReplicaSlot)))
+            throw InvalidDatabase("No version has been published to replicas", path);
+        m_map.map(m_file, File::access_ReadWrite, sizeof(ReplicaSlot)); // Throws
+
+        for (size_t i = 0; i < ReplicaSlot::max_replicas && !m_lock_file.is_attached(); ++i) {
+            File file;
+            file.open(get_replica_lock_path(coordination_dir, i), File::access_ReadWrite, File::create_Auto,
+                      0); // Throws
+            if (file.try_lock_exclusive()) { // Throws
+                m_lock_file = std::move(file);
+                m_ndx = i;
+            }
+        }
+        if (!m_lock_file.is_attached())
+            throw std::runtime_error(util::format("More than %1 replicas are open", ReplicaSlot::max_replicas));
+        announce(0);
+
+        // Checked once the entry is held, see DB::compact()
+        if (m_map.get_addr()->magic.load(std::memory_order_seq_cst) != ReplicaSlot::magic_value)
+            throw InvalidDatabase("No version has been published to replicas", path);
+    }
+
+    ~ReplicaReader()
+    {
+        if (m_lock_file.is_attached())
+            announce(0);
+    }
+
+    ReadLockInfo get_latest() const noexcept
+    {
+        const ReplicaSlot& slot = *m_map.get_addr();
+        ReadLockInfo read_lock;
+        for (;;) {
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            read_lock.m_version = slot.version.load(std::memory_order_relaxed);
+            read_lock.m_top_ref = to_size_t(slot.top_ref.load(std::memory_order_relaxed));
+            read_lock.m_file_size = to_size_t(slot.file_size.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+                return read_lock;
+        }
+    }
+
+    // Versions other than the latest can only be read if a transaction of
+    // this DB is reading them already.
+    ReadLockInfo grab(VersionID version_id)
+    {
+        std::lock_guard lock(m_mutex);
+        if (version_id.version != std::numeric_limits<version_type>::max()) {
+            auto it = m_read_versions.find(version_id.version);
+            if (it != m_read_versions.end()) {
+                ++it->second.second;
+                return it->second.first;
+            }
+        }
+        ReadLockInfo read_lock = get_latest();
+        if (m_read_versions.empty()) {
+            // Publishers keep every version from the oldest one announced, but
+            // may have let go of this one before the announcement was seen. It
+            // is safe to read if it is still the latest afterwards.
+            for (;;) {
+                announce(read_lock.m_version);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                ReadLockInfo latest = get_latest();
+                if (latest.m_version == read_lock.m_version)
+                    break;
+                read_lock = latest;
+            }
+        }
+        if (version_id.version != std::numeric_limits<version_type>::max() &&
+            version_id.version != read_lock.m_version) {
+            if (m_read_versions.empty())
+                announce(0);
+            throw BadVersion();
+        }
+        ++m_read_versions.emplace(read_lock.m_version, std::make_pair(read_lock, size_t(0))).first->second.second;
+        return read_lock;
+    }
+
+    void release(const ReadLockInfo& read_lock) noexcept
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_read_versions.find(read_lock.m_version);
+        if (it == m_read_versions.end() || --it->second.second != 0)
+            return;
+        bool was_oldest = it == m_read_versions.begin();
+        m_read_versions.erase(it);
+        if (was_oldest)
+            announce(m_read_versions.empty() ? 0 : m_read_versions.begin()->first);
+    }
+
+private:
+    File m_file;
+    File::Map<ReplicaSlot> m_map;
+    // Locked for as long as the replica owns entry `m_ndx` of the slot
+    File m_lock_file;
+    size_t m_ndx = 0;
+    std::mutex m_mutex;
+    // The versions read by the transactions of the DB, and by how many
+    std::map<version_type, std::pair<ReadLockInfo, size_t>> m_read_versions;
+
+    void announce(version_type oldest_read) noexcept
+    {
+        m_map.get_addr()->oldest_read[m_ndx].store(oldest_read, std::memory_order_seq_cst);
+    }
+};
+
 
 /// The structure of the contents of the per session `.lock` file. Note that
 /// this file is transient in that it is recreated/reinitialized at the
@@ -669,6 +1239,28 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
         dg.release();
         return;
     }
+    if (options.is_replica) {
+        if (options.encryption_key)
+            throw LogicError(LogicError::illegal_combination);
+        m_coordination_dir = get_core_file(path, CoreFileType::Management);
+        m_replica_reader = std::make_unique<ReplicaReader>(m_coordination_dir); // Throws
+        SlabAlloc::Config cfg;
+        cfg.read_only = true;
+        cfg.no_create = true;
+        try {
+            auto top_ref = alloc.attach_file(path, cfg); // Throws
+            SlabAlloc::DetachGuard dg(alloc);
+            m_file_format_version = Group::read_only_version_check(alloc, top_ref, path); // Throws
+            // Only there for is_attached(), as the versions read are those published
+            m_fake_read_lock_if_immutable = ReadLockInfo::make_fake(top_ref, m_alloc.get_baseline());
+            dg.release();
+        }
+        catch (...) {
+            m_replica_reader.reset();
+            throw;
+        }
+        return;
+    }
     m_lockfile_path = get_core_file(path, CoreFileType::Lock);
     m_coordination_dir = get_core_file(path, CoreFileType::Management);
     m_lockfile_prefix = m_coordination_dir + "/access_control";
@@ -875,15 +1467,19 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
             std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
             // we need a thread-local copy of the number of ringbuffer entries in order
             // to later detect concurrent expansion of the ringbuffer.
-            m_local_max_entry = info->readers.get_num_entries();
+            uint_fast32_t num_entries = info->readers.get_num_entries();
+            m_read_lock_counts = std::make_unique<ReadLockCounts>();
+            m_read_lock_counts->reserve(num_entries); // Throws
 
             // We need to map the info file once more for the readers part
             // since that part can be resized and as such remapped which
             // could move our mutexes (which we don't want to risk moving while
             // they are locked)
-            size_t reader_info_size = sizeof(SharedInfo) + info->readers.compute_required_space(m_local_max_entry);
+            size_t reader_info_size = sizeof(SharedInfo) + info->readers.compute_required_space(num_entries);
             m_reader_map.map(m_file, File::access_ReadWrite, reader_info_size, File::map_NoSync);
             File::UnmapGuard fug_2(m_reader_map);
+            m_reader_info.store(m_reader_map.get_addr(), std::memory_order_release);
+            m_local_max_entry.store(num_entries, std::memory_order_release);
 
             // proceed to initialize versioning and other metadata information related to
             // the database. Also create the database if we're beginning a new session
@@ -905,6 +1501,9 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
             cfg.clear_file = (options.durability == Durability::MemOnly && begin_new_session);
 
             cfg.encryption_key = m_key;
+            cfg.mapping_advice = mapping_advice_for(options.access_pattern);
+            cfg.huge_page_slabs = options.use_huge_pages;
+            cfg.decrypted_page_budget = options.decrypted_page_budget;
             ref_type top_ref;
             try {
                 top_ref = alloc.attach_file(path, cfg); // Throws
@@ -920,6 +1519,11 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
             current_file_format_version = alloc.get_committed_file_format_version();
             target_file_format_version =
                 Group::get_target_file_format_version_for_session(current_file_format_version, openers_hist_type);
+            // Files holding arrays in compact encodings must not be opened by
+            // versions that cannot read them
+            if (options.enable_integer_leaf_encoding || get_enabled_encodings(options))
+                target_file_format_version =
+                    std::max(target_file_format_version, int(Group::g_compact_file_format_version));
             BackupHandler backup(path, options.accepted_versions, options.to_be_deleted);
             if (backup.must_restore_from_backup(current_file_format_version)) {
                 // we need to unmap before any file ops that'll change the realm
@@ -954,6 +1558,8 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
                     Array top{alloc};
                     top.init_from_ref(top_ref);
                     Group::validate_top_array(top, alloc);
+                    if (options.prefetch_on_open)
+                        prefetch_top_arrays(alloc, top);
                 }
                 catch (InvalidDatabase& e) {
                     if (e.get_path().empty()) {
@@ -1155,6 +1761,15 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
         break;
     }
 
+    if (options.enable_access_profile && options.durability != Durability::MemOnly && !m_key) {
+        m_record_access_profile = true;
+        m_prefetcher =
+            std::make_unique<AccessProfilePrefetcher>(m_db_path, get_access_profile_path(m_coordination_dir));
+    }
+
+    if (target_file_format_version >= Group::g_compact_file_format_version)
+        m_alloc.set_enabled_encodings(get_enabled_encodings(options));
+
     // Upgrade file format and/or history schema
     try {
         if (stored_hist_schema_version == -1) {
@@ -1175,7 +1790,8 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
         else {
             m_file_format_version = current_file_format_version;
             upgrade_file_format(options.allow_file_format_upgrade, target_file_format_version,
-                                stored_hist_schema_version, openers_hist_schema_version); // Throws
+                                stored_hist_schema_version, openers_hist_schema_version,
+                                options.file_format_upgrade_chunk_size); // Throws
         }
         start_read()->check_consistency();
     }
@@ -1189,6 +1805,21 @@ void DB::open(const std::string& path, bool no_create_file, const DBOptions opti
     }
 #endif // REALM_METRICS
 
+    if (options.publish_to_replicas && options.durability != Durability::MemOnly && !m_key) {
+        try {
+            m_replica_publisher = std::make_unique<ReplicaPublisher>(m_coordination_dir); // Throws
+            do_begin_write();
+            auto end_write = make_scope_exit([&]() noexcept {
+                do_end_write();
+            });
+            m_replica_publisher->publish(*this); // Throws
+        }
+        catch (...) {
+            close();
+            throw;
+        }
+    }
+
     m_alloc.set_read_only(true);
 }
 
@@ -1200,6 +1831,15 @@ void DB::open(BinaryData buffer, bool take_ownership)
         m_alloc.own_buffer();
 }
 
+void DB::open(const std::vector<BinaryData>& regions)
+{
+    auto top_ref = m_alloc.attach_buffers(regions);
+    size_t size = 0;
+    for (auto& region : regions)
+        size += region.size();
+    m_fake_read_lock_if_immutable = ReadLockInfo::make_fake(top_ref, size);
+}
+
 void DB::open(Replication& repl, const std::string& file, const DBOptions options)
 {
     // Exception safety: Since open() is called from constructors, if it throws,
@@ -1281,6 +1921,23 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
     SharedInfo* info = m_file_map.get_addr();
     Durability dura = Durability(info->durability);
     const char* write_key = bool(output_encryption_key) ? *output_encryption_key : m_key;
+    // Replicas are kept from opening the file while it is compacted, and see
+    // the latest version again once it is done, whether it succeeds or not
+    bool unpublished = false;
+    auto republish = util::make_scope_exit([&]() noexcept {
+        if (!unpublished)
+            return;
+        try {
+            do_begin_write(); // Throws
+            auto end_write = make_scope_exit([&]() noexcept {
+                do_end_write();
+            });
+            m_replica_publisher->publish(*this); // Throws
+        }
+        catch (...) {
+            // Replicas can open the file again after the next commit
+        }
+    });
     {
         std::unique_lock<InterprocessMutex> lock(m_controlmutex); // Throws
 
@@ -1290,13 +1947,31 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
 
         // Holding the controlmutex prevents any other DB from attaching to the file.
 
-        // local lock blocking any transaction from starting (and stopping)
+        // local lock blocking any transaction from starting (and stopping). Read locks are
+        // normally taken without m_mutex, so make grab_read_lock() wait for it while compacting.
         std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
+        m_compacting = true;
+        auto compacting_guard = util::make_scope_exit([&]() noexcept {
+            m_compacting = false;
+        });
 
-        // We should be the only transaction active - otherwise back out
-        if (m_transaction_count != 0)
+        // We should be the only transaction active - otherwise back out. The
+        // versions retained for replicas are not transactions of the user.
+        size_t num_retained = m_replica_publisher ? m_replica_publisher->get_num_retained() : 0;
+        if (size_t(m_transaction_count) != num_retained)
             return false;
 
+        if (m_replica_publisher) {
+            // Open replicas have the file mapped, and could not follow it
+            // being replaced. Replicas check for the published version after
+            // taking their entry, so none can open the file after this.
+            m_replica_publisher->unpublish();
+            unpublished = true;
+            if (m_replica_publisher->has_open_replicas())
+                return false;
+            m_replica_publisher->release_all(*this);
+        }
+
         // group::write() will throw if the file already exists.
         // To prevent this, we have to remove the file (should it exist)
         // before calling group::write().
@@ -1394,6 +2069,27 @@ void DB::write_copy(StringData path, const char* output_encryption_key)
         }
     } writer;
 
+    // Where the filesystem supports it, the file is cloned instead of being
+    // written out again. That is not possible when the encryption changes or
+    // the sync file ident in the history must be cleared.
+    bool is_sync_client = m_replication && m_replication->get_history_type() == Replication::hist_SyncClient;
+    bool can_clone = !m_key && !output_encryption_key && !is_sync_client &&
+                     Durability(info->durability) != Durability::MemOnly;
+    if (can_clone && File::clone(m_db_path, path)) {
+        // Nothing the transaction reads can be overwritten while it is active,
+        // so the clone holds its version intact. The header may however select
+        // a later version, and the file may have grown since.
+        File file(path, File::mode_Update);
+        file.resize(tr->m_read_lock.m_file_size);
+        SlabAlloc::Header header = SlabAlloc::empty_file_header;
+        header.m_top_ref[0] = tr->m_read_lock.m_top_ref;
+        header.m_file_format[0] = uint8_t(m_file_format_version);
+        file.seek(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof header);
+        file.sync();
+        return;
+    }
+
     File file;
     file.open(path, File::access_ReadWrite, File::create_Must, 0);
     file.resize(0);
@@ -1401,6 +2097,174 @@ void DB::write_copy(StringData path, const char* output_encryption_key)
     tr->write(file, output_encryption_key, info->latest_version_number, writer);
 }
 
+namespace {
+
+// Format of a backup stream written by DB::write_backup(). All integers are
+// stored in host byte order, like in the Realm file itself.
+const char g_backup_magic[8] = {'T', '-', 'D', 'B', 'B', 'A', 'K', '1'};
+
+struct BackupHeader {
+    char m_magic[8];
+    uint64_t m_base_top_ref; // Top ref of the version the backup is based on, or zero
+    uint64_t m_top_ref;
+    uint64_t m_file_size;
+    uint64_t m_file_format;
+};
+
+// Writes the arrays which are reachable from a top ref, but not from the top
+// ref of a base version, to a backup stream. An array which is reachable from
+// the base cannot be overwritten while a read transaction holds the base, so
+// an array found in both versions is the same in both, as are all arrays below
+// it.
+class BackupWriter {
+public:
+    BackupWriter(Allocator& alloc, std::ostream& out)
+        : m_alloc(alloc)
+        , m_out(out)
+    {
+    }
+
+    void write_subtree(ref_type ref, ref_type base_ref)
+    {
+        if (ref == base_ref)
+            return;
+        const char* header = m_alloc.translate(ref);
+        uint64_t chunk[2] = {ref, NodeHeader::get_byte_size_from_header(header)};
+        m_out.write(reinterpret_cast<const char*>(chunk), sizeof chunk);
+        m_out.write(header, std::streamsize(chunk[1]));
+        if (!NodeHeader::get_hasrefs_from_header(header))
+            return;
+
+        // Children are first looked up among all the children of the base
+        // node, which finds them even if they have moved to another index.
+        // Children which are new are compared to the base child at the same
+        // index, which is usually the one they replaced.
+        Array base(m_alloc);
+        std::vector<ref_type> base_children;
+        if (base_ref && NodeHeader::get_hasrefs_from_header(m_alloc.translate(base_ref))) {
+            base.init_from_ref(base_ref);
+            for (size_t i = 0; i < base.size(); ++i) {
+                int_fast64_t value = base.get(i);
+                if (value != 0 && (value & 1) == 0)
+                    base_children.push_back(to_ref(value));
+            }
+            std::sort(base_children.begin(), base_children.end());
+        }
+        Array node(m_alloc);
+        node.init_from_ref(ref);
+        for (size_t i = 0; i < node.size(); ++i) {
+            int_fast64_t value = node.get(i);
+            if (value == 0 || (value & 1) != 0)
+                continue;
+            ref_type child = to_ref(value);
+            if (std::binary_search(base_children.begin(), base_children.end(), child))
+                continue;
+            ref_type base_child = 0;
+            if (base.is_attached() && i < base.size()) {
+                int_fast64_t base_value = base.get(i);
+                if ((base_value & 1) == 0)
+                    base_child = to_ref(base_value);
+            }
+            write_subtree(child, base_child); // Throws
+        }
+    }
+
+private:
+    Allocator& m_alloc;
+    std::ostream& m_out;
+};
+
+void read_backup_data(std::istream& in, char* data, size_t size)
+{
+    in.read(data, std::streamsize(size));
+    if (size_t(in.gcount()) != size)
+        throw std::runtime_error("Truncated Realm backup");
+}
+
+} // anonymous namespace
+
+void DB::write_backup(std::ostream& out, TransactionRef& base)
+{
+    if (base && (base->get_db().get() != this || base->get_transact_stage() != DB::transact_Reading))
+        throw LogicError(LogicError::wrong_transact_state);
+
+    auto tr = start_read();
+    BackupHeader header;
+    std::copy(std::begin(g_backup_magic), std::end(g_backup_magic), header.m_magic);
+    header.m_base_top_ref = base ? base->m_read_lock.m_top_ref : 0;
+    header.m_top_ref = tr->m_read_lock.m_top_ref;
+    header.m_file_size = tr->m_read_lock.m_file_size;
+    header.m_file_format = uint64_t(m_file_format_version);
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+
+    BackupWriter writer(m_alloc, out);
+    writer.write_subtree(header.m_top_ref, header.m_base_top_ref); // Throws
+    uint64_t end[2] = {0, 0};
+    out.write(reinterpret_cast<const char*>(end), sizeof end);
+    out.flush();
+    if (!out)
+        throw std::runtime_error("Failed to write Realm backup");
+
+    base = std::move(tr);
+}
+
+void DB::apply_backup(const std::string& path, std::istream& in)
+{
+    BackupHeader header;
+    read_backup_data(in, reinterpret_cast<char*>(&header), sizeof header);
+    if (!std::equal(std::begin(g_backup_magic), std::end(g_backup_magic), header.m_magic))
+        throw std::runtime_error("Not a Realm backup");
+
+    // The arrays of the new version only ever overwrite space which is free
+    // in the base version, so the file holds the base version intact until
+    // the new header has been written. The file is therefore only cut down to
+    // its new size after that.
+    bool is_incremental = header.m_base_top_ref != 0;
+    File file;
+    file.open(path, File::access_ReadWrite, is_incremental ? File::create_Never : File::create_Must, 0); // Throws
+    SlabAlloc::Header file_header = SlabAlloc::empty_file_header;
+    int slot = 0;
+    if (is_incremental) {
+        if (file.read(reinterpret_cast<char*>(&file_header), sizeof file_header) != sizeof file_header)
+            throw InvalidDatabase("Realm file is too small to hold a header", path);
+        int current_slot = (file_header.m_flags & SlabAlloc::flags_SelectBit) != 0 ? 1 : 0;
+        if (file_header.m_top_ref[current_slot] != header.m_base_top_ref)
+            throw std::runtime_error("Realm backup is not based on the version held by the file");
+        slot = 1 - current_slot;
+    }
+    if (file.get_size() < File::SizeType(header.m_file_size))
+        file.resize(File::SizeType(header.m_file_size)); // Throws
+
+    std::vector<char> buffer;
+    for (;;) {
+        uint64_t chunk[2];
+        read_backup_data(in, reinterpret_cast<char*>(chunk), sizeof chunk);
+        if (chunk[0] == 0)
+            break;
+        if (chunk[0] < sizeof file_header || chunk[0] + chunk[1] > header.m_file_size)
+            throw std::runtime_error("Corrupt Realm backup");
+        buffer.resize(size_t(chunk[1]));
+        read_backup_data(in, buffer.data(), buffer.size());
+        file.seek(File::SizeType(chunk[0]));
+        file.write(buffer.data(), buffer.size()); // Throws
+    }
+    file.sync(); // Throws
+
+    // Select the new version the same way a commit does
+    file_header.m_top_ref[slot] = header.m_top_ref;
+    file_header.m_file_format[slot] = uint8_t(header.m_file_format);
+    file.seek(0);
+    file.write(reinterpret_cast<const char*>(&file_header), offsetof(SlabAlloc::Header, m_flags)); // Throws
+    file.sync(); // Throws
+    file_header.m_flags = uint8_t((file_header.m_flags & ~SlabAlloc::flags_SelectBit) | slot);
+    file.seek(offsetof(SlabAlloc::Header, m_flags));
+    file.write(reinterpret_cast<const char*>(&file_header.m_flags), 1); // Throws
+    file.sync(); // Throws
+
+    if (file.get_size() > File::SizeType(header.m_file_size))
+        file.resize(File::SizeType(header.m_file_size)); // Throws
+}
+
 uint_fast64_t DB::get_number_of_versions()
 {
     if (m_fake_read_lock_if_immutable)
@@ -1409,11 +2273,128 @@ uint_fast64_t DB::get_number_of_versions()
     return info->number_of_versions;
 }
 
+void DB::register_reader(ReaderPin& pin, const ReadLockInfo& read_lock, bool is_frozen)
+{
+    static std::atomic<uint64_t> s_next_reader_id{1};
+    pin.id = s_next_reader_id.fetch_add(1, std::memory_order_relaxed);
+    pin.thread = std::this_thread::get_id();
+    pin.is_frozen = is_frozen;
+    note_reader_version(pin, read_lock);
+    std::lock_guard lock(m_reader_pins_mutex);
+    m_reader_pins.push_back(&pin); // Throws
+}
+
+void DB::unregister_reader(ReaderPin& pin) noexcept
+{
+    std::lock_guard lock(m_reader_pins_mutex);
+    auto it = std::find(m_reader_pins.begin(), m_reader_pins.end(), &pin);
+    if (it != m_reader_pins.end()) {
+        *it = m_reader_pins.back();
+        m_reader_pins.pop_back();
+    }
+}
+
+void DB::note_reader_version(ReaderPin& pin, const ReadLockInfo& read_lock) noexcept
+{
+    pin.version.store(read_lock.m_version, std::memory_order_relaxed);
+    pin.since.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+size_t DB::get_pinned_bytes(version_type version) const noexcept
+{
+    // GroupWriter cannot reuse space freed in versions at or after the oldest
+    // one being read
+    size_t bytes = 0;
+    for (auto& [freed_in, size] : m_locked_space_by_version) {
+        if (freed_in >= version)
+            bytes += size;
+    }
+    return bytes;
+}
+
+std::vector<DB::PinnedReader> DB::get_pinned_readers()
+{
+    version_type latest_version = get_version_of_latest_snapshot();
+    auto now = std::chrono::steady_clock::now();
+    std::vector<PinnedReader> readers;
+    {
+        std::lock_guard lock(m_reader_pins_mutex);
+        readers.reserve(m_reader_pins.size()); // Throws
+        for (ReaderPin* pin : m_reader_pins) {
+            PinnedReader reader;
+            reader.reader_id = pin->id;
+            reader.thread = pin->thread;
+            reader.version = pin->version.load(std::memory_order_relaxed);
+            reader.is_frozen = pin->is_frozen;
+            reader.is_latest = reader.version >= latest_version;
+            auto since = std::chrono::steady_clock::duration(pin->since.load(std::memory_order_relaxed));
+            reader.held_for = now - std::chrono::steady_clock::time_point(since);
+            reader.is_invalidated = pin->invalidated.load(std::memory_order_relaxed);
+            readers.push_back(reader);
+        }
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto& reader : readers)
+            reader.pinned_bytes = get_pinned_bytes(reader.version);
+    }
+    std::sort(readers.begin(), readers.end(), [](const PinnedReader& a, const PinnedReader& b) {
+        return a.version < b.version || (a.version == b.version && a.reader_id < b.reader_id);
+    });
+    return readers;
+}
+
+void DB::check_stale_readers(version_type latest_version, const ReaderPin* committer)
+{
+    const auto& policy = m_stale_reader_policy;
+    auto now = std::chrono::steady_clock::now();
+    std::vector<PinnedReader> stale;
+    {
+        std::lock_guard lock(m_mutex);
+        std::lock_guard pins_lock(m_reader_pins_mutex);
+        for (ReaderPin* pin : m_reader_pins) {
+            if (pin == committer)
+                continue;
+            version_type version = pin->version.load(std::memory_order_relaxed);
+            if (version >= latest_version || version == pin->reported_version)
+                continue;
+            auto since = std::chrono::steady_clock::duration(pin->since.load(std::memory_order_relaxed));
+            auto held_for = now - std::chrono::steady_clock::time_point(since);
+            size_t pinned_bytes = get_pinned_bytes(version);
+            bool too_old = policy.max_age.count() > 0 && held_for > policy.max_age;
+            bool too_big = policy.max_pinned_bytes > 0 && pinned_bytes > policy.max_pinned_bytes;
+            if (!too_old && !too_big)
+                continue;
+            pin->reported_version = version;
+            if (policy.action == DBOptions::StaleReaderPolicy::Action::Invalidate)
+                pin->invalidated.store(true, std::memory_order_relaxed);
+            PinnedReader reader;
+            reader.reader_id = pin->id;
+            reader.thread = pin->thread;
+            reader.version = version;
+            reader.is_frozen = pin->is_frozen;
+            reader.held_for = held_for;
+            reader.pinned_bytes = pinned_bytes;
+            reader.is_invalidated = pin->invalidated.load(std::memory_order_relaxed);
+            stale.push_back(reader); // Throws
+        }
+    }
+    if (policy.on_stale_reader) {
+        for (auto& reader : stale)
+            policy.on_stale_reader(reader);
+    }
+}
+
 size_t DB::get_allocated_size() const
 {
     return m_alloc.get_allocated_size();
 }
 
+size_t DB::release_memory(MemoryPressure level)
+{
+    return m_alloc.release_decrypted_pages(level == MemoryPressure::critical);
+}
+
 DB::~DB() noexcept
 {
     close();
@@ -1424,12 +2405,12 @@ void DB::release_all_read_locks() noexcept
     REALM_ASSERT(!m_fake_read_lock_if_immutable);
     std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
     SharedInfo* r_info = m_reader_map.get_addr();
-    for (auto& read_lock : m_local_locks_held) {
-        --m_transaction_count;
-        const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
-        atomic_double_dec(r.count);
-    }
-    m_local_locks_held.clear();
+    m_read_lock_counts->release_all([&](uint_fast32_t reader_idx, uint32_t num_held) {
+        m_transaction_count -= int(num_held);
+        const Ringbuffer::ReadCount& r = r_info->readers.get(reader_idx);
+        for (uint32_t i = 0; i < num_held; ++i)
+            atomic_double_dec(r.count);
+    });
     REALM_ASSERT(m_transaction_count == 0);
 }
 
@@ -1440,42 +2421,80 @@ void DB::close(bool allow_open_read_transactions)
 {
     // make helper thread terminate
     m_commit_helper.reset();
+    // and sync the commits whose sync has been deferred
+    join_deferred_sync_thread();
 
-    if (m_fake_read_lock_if_immutable) {
-        if (!is_attached())
-            return;
+    // Refuse to close while transactions are open before stopping new read locks
+    // from being taken, so that a failing close() does not make concurrent
+    // start_read() fail.
+    {
+        std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
+        check_no_open_transactions(allow_open_read_transactions); // Throws
+        m_closing = true;
+    }
+    // Wait for the read locks in progress, as they do not hold m_mutex. This must
+    // not hold m_mutex either, as taking a read lock may need it to grow the
+    // reader mapping.
+    while (m_read_lock_grabs != 0)
+        std::this_thread::yield();
+
+    try {
         {
+            // Transactions may have been started on read locks taken before m_closing was set
             std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
-            if (!allow_open_read_transactions && m_transaction_count)
-                throw LogicError(LogicError::wrong_transact_state);
+            check_no_open_transactions(allow_open_read_transactions); // Throws
+        }
+        if (m_fake_read_lock_if_immutable) {
+            if (!is_attached())
+                return;
+            if (m_alloc.is_attached())
+                m_alloc.detach();
+            m_fake_read_lock_if_immutable.reset();
+            m_replica_reader.reset();
+        }
+        else {
+            close_internal(std::unique_lock<InterprocessMutex>(m_controlmutex, std::defer_lock)); // Throws
         }
-        if (m_alloc.is_attached())
-            m_alloc.detach();
-        m_fake_read_lock_if_immutable.reset();
     }
-    else {
-        close_internal(std::unique_lock<InterprocessMutex>(m_controlmutex, std::defer_lock),
-                       allow_open_read_transactions);
+    catch (...) {
+        // Still open, as transactions are in progress
+        m_closing = false;
+        throw;
     }
 }
 
-void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_open_read_transactions)
+void DB::check_no_open_transactions(bool allow_open_read_transactions)
+{
+    if (m_write_transaction_open)
+        throw LogicError(LogicError::wrong_transact_state);
+    // The versions retained for replicas are not transactions of the user
+    size_t num_retained = m_replica_publisher ? m_replica_publisher->get_num_retained() : 0;
+    if (!allow_open_read_transactions && size_t(m_transaction_count) > num_retained)
+        throw LogicError(LogicError::wrong_transact_state);
+}
+
+void DB::close_internal(std::unique_lock<InterprocessMutex> lock)
 {
     if (!is_attached())
         return;
 
-    {
-        std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
-        if (m_write_transaction_open)
-            throw LogicError(LogicError::wrong_transact_state);
-        if (!allow_open_read_transactions && m_transaction_count)
-            throw LogicError(LogicError::wrong_transact_state);
-    }
     SharedInfo* info = m_file_map.get_addr();
     {
         if (!lock.owns_lock())
             lock.lock();
 
+        m_prefetcher.reset();
+        if (m_record_access_profile && info->num_participants == 1) {
+            // Record what the last session participant leaves in memory
+            try {
+                write_access_profile(get_access_profile_path(m_coordination_dir),
+                                     get_resident_file_ranges(m_db_path)); // Throws
+            }
+            catch (...) {
+                // The profile is only a hint
+            }
+        }
+
         if (m_alloc.is_attached())
             m_alloc.detach();
 
@@ -1484,6 +2503,7 @@ void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_ope
             info->sync_agent_present = 0; // Set to false
         }
         release_all_read_locks();
+        m_replica_publisher.reset();
         --info->num_participants;
         bool end_of_session = info->num_participants == 0;
         // std::cerr << "closing" << std::endl;
@@ -1511,13 +2531,58 @@ void DB::close_internal(std::unique_lock<InterprocessMutex> lock, bool allow_ope
         // may
         // interleave which is not permitted on Windows. It is permitted on *nix.
         m_file_map.unmap();
+        m_reader_info.store(nullptr, std::memory_order_relaxed);
         m_reader_map.unmap();
+        m_retired_reader_maps.clear();
         m_file.unlock();
         // info->~SharedInfo(); // DO NOT Call destructor
         m_file.close();
     }
 }
 
+// Replays the access profile recorded at the end of the previous session on a
+// background thread, reading in the ranges of the file listed in it.
+class DB::AccessProfilePrefetcher {
+public:
+    AccessProfilePrefetcher(const std::string& db_path, const std::string& profile_path)
+        : m_thread([this, db_path, profile_path] {
+            run(db_path, profile_path);
+        })
+    {
+    }
+    ~AccessProfilePrefetcher()
+    {
+        m_stop = true;
+        m_thread.join();
+    }
+
+private:
+    std::atomic<bool> m_stop = false;
+    std::thread m_thread;
+
+    void run(const std::string& db_path, const std::string& profile_path) noexcept
+    {
+        try {
+            auto ranges = read_access_profile(profile_path); // Throws
+            if (ranges.empty())
+                return;
+            File file(db_path); // Throws
+            size_t file_size = size_t(file.get_size());
+            for (const auto& range : ranges) {
+                size_t end = std::min(range.first + range.second, file_size);
+                for (size_t offset = range.first; offset < end; offset += access_profile_prefetch_chunk) {
+                    if (m_stop)
+                        return;
+                    file.prefetch(offset, std::min(access_profile_prefetch_chunk, end - offset));
+                }
+            }
+        }
+        catch (...) {
+            // The profile is only a hint
+        }
+    }
+};
+
 class DB::AsyncCommitHelper {
 public:
     AsyncCommitHelper(DB* db)
@@ -1644,6 +2709,17 @@ public:
         m_cv_worker.notify_one();
     }
 
+    void flush_to_disk(util::UniqueFunction<void()> fn)
+    {
+        REALM_ASSERT(fn);
+        std::unique_lock lg(m_mutex);
+        REALM_ASSERT(m_has_write_mutex);
+        REALM_ASSERT(!m_pending_sync);
+        start_thread();
+        m_pending_flushes.push_back(std::move(fn));
+        m_cv_worker.notify_one();
+    }
+
 private:
     DB* m_db;
     std::thread m_thread;
@@ -1651,6 +2727,7 @@ private:
     std::condition_variable m_cv_worker;
     std::condition_variable m_cv_callers;
     std::deque<util::UniqueFunction<void()>> m_pending_writes;
+    std::deque<util::UniqueFunction<void()>> m_pending_flushes;
     util::UniqueFunction<void()> m_pending_sync;
     size_t m_write_lock_claim_ticket = 0;
     size_t m_write_lock_claim_fulfilled = 0;
@@ -1687,6 +2764,16 @@ void DB::AsyncCommitHelper::main()
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
 #endif
         if (m_has_write_mutex) {
+            // Flushes keep the write mutex, and must complete before a final sync
+            if (!m_pending_flushes.empty()) {
+                auto cb = std::move(m_pending_flushes.front());
+                m_pending_flushes.pop_front();
+                lg.unlock();
+                cb();
+                cb = nullptr; // Release things captured by the callback before reacquiring the lock
+                lg.lock();
+                continue;
+            }
             if (auto cb = std::move(m_pending_sync)) {
                 // Only one of sync_to_disk(), end_write(), or blocking_end_write()
                 // should be called, so we should never have both a pending sync
@@ -1771,8 +2858,16 @@ void DB::async_sync_to_disk(util::UniqueFunction<void()> fn)
     m_commit_helper->sync_to_disk(std::move(fn));
 }
 
+void DB::async_flush_to_disk(util::UniqueFunction<void()> fn)
+{
+    REALM_ASSERT(m_commit_helper);
+    m_commit_helper->flush_to_disk(std::move(fn));
+}
+
 bool DB::has_changed(TransactionRef& tr)
 {
+    if (m_replica_reader)
+        return tr->m_read_lock.m_version != m_replica_reader->get_latest().m_version;
     if (m_fake_read_lock_if_immutable)
         return false; // immutable doesn't change
     bool changed = tr->m_read_lock.m_version != get_version_of_latest_snapshot();
@@ -1781,6 +2876,8 @@ bool DB::has_changed(TransactionRef& tr)
 
 bool DB::wait_for_change(TransactionRef& tr)
 {
+    if (m_replica_reader)
+        throw LogicError(LogicError::wrong_transact_state);
     REALM_ASSERT(!m_fake_read_lock_if_immutable);
     SharedInfo* info = m_file_map.get_addr();
     std::lock_guard<InterprocessMutex> lock(m_controlmutex);
@@ -1809,7 +2906,8 @@ void DB::enable_wait_for_change()
 }
 
 void DB::upgrade_file_format(bool allow_file_format_upgrade, int target_file_format_version,
-                             int current_hist_schema_version, int target_hist_schema_version)
+                             int current_hist_schema_version, int target_hist_schema_version,
+                             size_t chunk_size)
 {
     // In a multithreaded scenario multiple threads may initially see a need to
     // upgrade (maybe_upgrade == true) even though one onw thread is supposed to
@@ -1875,7 +2973,7 @@ void DB::upgrade_file_format(bool allow_file_format_upgrade, int target_file_for
         if (need_file_format_upgrade) {
             if (!allow_file_format_upgrade)
                 throw FileFormatUpgradeRequired("Database upgrade required but prohibited", this->m_db_path);
-            wt->upgrade_file_format(target_file_format_version); // Throws
+            wt->upgrade_file_format(target_file_format_version, chunk_size); // Throws
             // Note: The file format version stored in the Realm file will be
             // updated to the new file format version as part of the following
             // commit operation. This happens in GroupWriter::commit().
@@ -1894,46 +2992,69 @@ void DB::upgrade_file_format(bool allow_file_format_upgrade, int target_file_for
 
 void DB::release_read_lock(ReadLockInfo& read_lock) noexcept
 {
+    if (m_replica_reader) {
+        --m_transaction_count;
+        m_replica_reader->release(read_lock);
+        return;
+    }
     // ignore if opened with immutable file (then we have no lockfile)
     if (m_fake_read_lock_if_immutable)
         return;
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    bool found_match = false;
-    // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
-    for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
-            m_local_locks_held[j] = m_local_locks_held.back();
-            m_local_locks_held.pop_back();
-            found_match = true;
-            break;
-        }
-    }
-    if (!found_match) {
-        REALM_ASSERT(!is_attached());
+    // Announce the release, so that a concurrent close() waits for it before unmapping
+    // the ringbuffer.
+    ReadLockCounts::Counter& held = m_read_lock_counts->get(read_lock.m_reader_idx);
+    uint64_t val = held.fetch_add(ReadLockCounts::busy_one, std::memory_order_acquire);
+    if (val & ReadLockCounts::released) {
         // it's OK, someone called close() and all locks where released
+        held.fetch_sub(ReadLockCounts::busy_one, std::memory_order_release);
         return;
     }
+    REALM_ASSERT(val & ReadLockCounts::held_mask);
     --m_transaction_count;
-    SharedInfo* r_info = m_reader_map.get_addr();
+    SharedInfo* r_info = m_reader_info.load(std::memory_order_acquire);
     const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
     atomic_double_dec(r.count); // <-- most of the exec time spent here
+    held.fetch_sub(ReadLockCounts::busy_one + 1, std::memory_order_release);
 }
 
 
 void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    ReadLockGrab grab(*this); // Throws
     REALM_ASSERT_RELEASE(is_attached());
+    // Read locks are taken without holding m_mutex. Counting the lock before checking
+    // m_compacting ensures that compact() either sees the lock or that we see compact().
+    ++m_transaction_count;
+    if (REALM_UNLIKELY(m_compacting)) {
+        --m_transaction_count;
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        ++m_transaction_count;
+    }
+    try {
+        do_grab_read_lock(read_lock, version_id); // Throws
+    }
+    catch (...) {
+        --m_transaction_count;
+        throw;
+    }
+}
+
+
+void DB::do_grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
+{
+    if (m_replica_reader) {
+        read_lock = m_replica_reader->grab(version_id); // Throws
+        return;
+    }
     if (version_id.version == std::numeric_limits<version_type>::max()) {
         for (;;) {
-            SharedInfo* r_info = m_reader_map.get_addr();
+            SharedInfo* r_info = m_reader_info.load(std::memory_order_acquire);
             read_lock.m_reader_idx = r_info->readers.last();
             if (grow_reader_mapping(read_lock.m_reader_idx)) { // Throws
                 // remapping takes time, so retry with a fresh entry
                 continue;
             }
-            r_info = m_reader_map.get_addr();
+            r_info = m_reader_info.load(std::memory_order_acquire);
             const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
             // if the entry is stale and has been cleared by the cleanup process,
             // we need to start all over again. This is extremely unlikely, but possible.
@@ -1942,8 +3063,7 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
             read_lock.m_version = r.version;
             read_lock.m_top_ref = to_size_t(r.current_top);
             read_lock.m_file_size = to_size_t(r.filesize);
-            m_local_locks_held.emplace_back(read_lock);
-            ++m_transaction_count;
+            m_read_lock_counts->get(read_lock.m_reader_idx).fetch_add(1, std::memory_order_relaxed);
             // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
             REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
             return;
@@ -1956,7 +3076,7 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
             // remapping takes time, so retry with a fresh entry
             continue;
         }
-        SharedInfo* r_info = m_reader_map.get_addr();
+        SharedInfo* r_info = m_reader_info.load(std::memory_order_acquire);
         const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
 
         // if the entry is stale and has been cleared by the cleanup process,
@@ -1979,8 +3099,7 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
         read_lock.m_version = r.version;
         read_lock.m_top_ref = to_size_t(r.current_top);
         read_lock.m_file_size = to_size_t(r.filesize);
-        m_local_locks_held.emplace_back(read_lock);
-        ++m_transaction_count;
+        m_read_lock_counts->get(read_lock.m_reader_idx).fetch_add(1, std::memory_order_relaxed);
         // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
         REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
         return;
@@ -1989,17 +3108,13 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
 
 void DB::leak_read_lock(ReadLockInfo& read_lock) noexcept
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
-    for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
-            m_local_locks_held[j] = m_local_locks_held.back();
-            m_local_locks_held.pop_back();
-            --m_transaction_count;
+    ReadLockCounts::Counter& held = m_read_lock_counts->get(read_lock.m_reader_idx);
+    uint64_t val = held.load(std::memory_order_relaxed);
+    do {
+        if ((val & ReadLockCounts::released) || !(val & ReadLockCounts::held_mask))
             return;
-        }
-    }
+    } while (!held.compare_exchange_weak(val, val - 1, std::memory_order_relaxed));
+    --m_transaction_count;
 }
 
 bool DB::do_try_begin_write()
@@ -2053,7 +3168,7 @@ void DB::do_begin_write()
 
     while (should_yield) {
 
-        m_pick_next_writer.wait(m_writemutex, &time_limit);
+        m_pick_next_writer.wait_for_ticket(m_writemutex, &time_limit, my_ticket);
         timeval tv;
         gettimeofday(&tv, nullptr);
         if (time_limit.tv_sec < tv.tv_sec ||
@@ -2072,6 +3187,11 @@ void DB::do_begin_write()
     //
     // In doing so, we may bypass other waiters, hence the condition for yielding
     // should take this situation into account by comparing with '>' instead of '!='
+    if (should_yield) {
+        // The bypassed waiters are not woken by the ticket notifications
+        // anymore, as their tickets have already been served.
+        m_pick_next_writer.notify_all();
+    }
     info->next_served = my_ticket;
     finish_begin_write();
 }
@@ -2095,19 +3215,24 @@ void DB::finish_begin_write()
 void DB::do_end_write() noexcept
 {
     SharedInfo* info = m_file_map.get_addr();
-    info->next_served.fetch_add(1, std::memory_order_relaxed);
+    uint32_t next_ticket = info->next_served.fetch_add(1, std::memory_order_relaxed) + 1;
 
     std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
     REALM_ASSERT(m_write_transaction_open);
     m_alloc.set_read_only(true);
     m_write_transaction_open = false;
-    m_pick_next_writer.notify_all();
+    // Only wake the writer whose turn it is
+    m_pick_next_writer.notify_ticket(next_ticket);
     m_writemutex.unlock();
 }
 
 
 Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to_disk)
 {
+#if REALM_METRICS
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::commit);
+#endif
+    util::tracing::Span span("DB::do_commit");
     version_type current_version;
     {
         std::lock_guard<std::recursive_mutex> lock(m_mutex);
@@ -2132,37 +3257,220 @@ Replication::version_type DB::do_commit(Transaction& transaction, bool commit_to
         repl->finalize_commit();
     }
     else {
-        low_level_commit(new_version, transaction); // Throws
+        low_level_commit(new_version, transaction, commit_to_disk); // Throws
+    }
+    span.set_attribute("version", int64_t(new_version));
+    if (m_stale_reader_policy.is_enabled()) {
+        try {
+            check_stale_readers(new_version, &transaction.m_reader_pin); // Throws
+        }
+        catch (...) {
+            // The commit has succeeded, so a failure to report the stale
+            // readers must not make it look like it failed
+        }
+    }
+    if (m_replica_publisher) {
+        try {
+            m_replica_publisher->publish(*this); // Throws
+        }
+        catch (...) {
+            // The commit has succeeded, so replicas just keep reading the
+            // previous version until the next commit is published
+        }
     }
     return new_version;
 }
 
 
-// Caller must lock m_mutex.
+void DB::hold_durable_version(Transaction& transaction)
+{
+    std::lock_guard<std::mutex> lock(m_group_commit_mutex);
+    if (m_durable_read_lock)
+        return;
+    // With no commits pending, the version the transaction started from is the one
+    // on disk, unless it has async commits of its own which are not yet persisted.
+    const ReadLockInfo& durable = transaction.m_oldest_version_not_persisted
+                                      ? *transaction.m_oldest_version_not_persisted
+                                      : transaction.m_read_lock;
+    ReadLockInfo read_lock;
+    grab_read_lock(read_lock, VersionID(durable.m_version, durable.m_reader_idx)); // Throws
+    m_durable_read_lock = read_lock;
+}
+
+
+void DB::wait_for_group_commit(version_type version)
+{
+    if (m_defer_group_commit_sync) {
+        schedule_deferred_sync(); // Throws
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_group_commit_mutex);
+    uint64_t num_failed = m_num_failed_group_commits;
+    for (;;) {
+        if (m_durable_version >= version)
+            return;
+        if (m_num_failed_group_commits != num_failed)
+            std::rethrow_exception(m_group_commit_error);
+        if (!m_group_commit_leader)
+            break;
+        m_group_commit_cv.wait(lock);
+    }
+
+    // No sync in progress, so this thread syncs the batch. Give other writers a chance
+    // to join it first.
+    m_group_commit_leader = true;
+    lock.unlock();
+    std::this_thread::sleep_for(m_group_commit_window);
+    std::exception_ptr error;
+    version_type synced_version = 0;
+    try {
+        synced_version = sync_pending_commits(); // Throws
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    m_group_commit_leader = false;
+    if (error) {
+        ++m_num_failed_group_commits;
+        m_group_commit_error = error;
+    }
+    else if (synced_version > m_durable_version) {
+        m_durable_version = synced_version;
+    }
+    m_group_commit_cv.notify_all();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+
+void DB::schedule_deferred_sync()
+{
+    std::lock_guard<std::mutex> lock(m_group_commit_mutex);
+    // A running sync thread checks for pending commits again before it exits
+    if (m_group_commit_leader || !m_durable_read_lock)
+        return;
+    // The previous thread is done, apart from releasing its reference to the DB
+    if (m_deferred_sync_thread.joinable())
+        m_deferred_sync_thread.join();
+    m_group_commit_leader = true;
+    // The thread keeps the DB open until the commits are synced
+    m_deferred_sync_thread = std::thread([db = shared_from_this()]() mutable {
+        db->run_deferred_syncs();
+        // If this is the last reference, the DB is closed on this thread
+        db.reset();
+    });
+}
+
+
+void DB::run_deferred_syncs() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_group_commit_mutex);
+    std::exception_ptr error;
+    while (m_durable_read_lock) {
+        lock.unlock();
+        std::this_thread::sleep_for(m_group_commit_window);
+        version_type synced_version = 0;
+        try {
+            synced_version = sync_pending_commits(); // Throws
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        // The commits stay pending, and the next commit retries
+        if (error)
+            break;
+        if (synced_version > m_durable_version)
+            m_durable_version = synced_version;
+    }
+    m_group_commit_leader = false;
+    lock.unlock();
+    if (error && m_on_deferred_sync_error)
+        m_on_deferred_sync_error(error);
+}
+
+
+void DB::join_deferred_sync_thread() noexcept
+{
+    if (!m_deferred_sync_thread.joinable())
+        return;
+    // The thread may hold the last reference to the DB, in which case it is the one
+    // closing it
+    if (m_deferred_sync_thread.get_id() == std::this_thread::get_id())
+        m_deferred_sync_thread.detach();
+    else
+        m_deferred_sync_thread.join();
+}
+
+
+DB::version_type DB::sync_pending_commits()
+{
+    // Holding the write lock ensures that the latest version is complete, and that no
+    // commit changes the file while its top ref is made durable.
+    TransactionRef tr = start_write(); // Throws
+    version_type version = tr->get_version();
+    bool has_pending_commits;
+    {
+        std::lock_guard<std::mutex> lock(m_group_commit_mutex);
+        has_pending_commits = bool(m_durable_read_lock);
+    }
+    if (has_pending_commits) {
+        GroupWriter out(*tr);
+        out.commit(tr->m_read_lock.m_top_ref); // Throws
+        std::lock_guard<std::mutex> lock(m_group_commit_mutex);
+        release_read_lock(*m_durable_read_lock);
+        m_durable_read_lock.reset();
+    }
+    tr->rollback();
+    return version;
+}
+
+
 bool DB::grow_reader_mapping(uint_fast32_t index)
 {
     using _impl::SimulatedFailure;
     SimulatedFailure::trigger(SimulatedFailure::shared_group__grow_reader_mapping); // Throws
 
-    if (index >= m_local_max_entry) {
+    if (index >= m_local_max_entry.load(std::memory_order_acquire)) {
         // handle mapping expansion if required
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
         SharedInfo* r_info = m_reader_map.get_addr();
-        m_local_max_entry = r_info->readers.get_num_entries();
-        REALM_ASSERT(index < m_local_max_entry);
-        size_t info_size = sizeof(SharedInfo) + r_info->readers.compute_required_space(m_local_max_entry);
-        // std::cout << "Growing reader mapping to " << infosize << std::endl;
-        m_reader_map.remap(m_file, util::File::access_ReadWrite, info_size); // Throws
+        uint_fast32_t num_entries = r_info->readers.get_num_entries();
+        REALM_ASSERT(index < num_entries);
+        // another thread may have expanded the mapping while we waited for the lock
+        if (num_entries > m_local_max_entry.load(std::memory_order_relaxed)) {
+            size_t info_size = sizeof(SharedInfo) + r_info->readers.compute_required_space(num_entries);
+            // std::cout << "Growing reader mapping to " << infosize << std::endl;
+            remap_reader_info(num_entries, info_size); // Throws
+        }
         return true;
     }
     return false;
 }
 
+// Caller must lock m_mutex.
+void DB::remap_reader_info(uint_fast32_t num_entries, size_t info_size)
+{
+    m_read_lock_counts->reserve(num_entries); // Throws
+    // Other threads may still be accessing the ringbuffer through the current mapping,
+    // so it cannot be remapped in place.
+    util::File::Map<SharedInfo> new_map(m_file, util::File::access_ReadWrite, info_size); // Throws
+    m_retired_reader_maps.reserve(m_retired_reader_maps.size() + 1);                       // Throws
+    m_retired_reader_maps.push_back(std::move(m_reader_map));
+    m_reader_map = std::move(new_map);
+    // The new address must be visible before the new number of entries
+    m_reader_info.store(m_reader_map.get_addr(), std::memory_order_release);
+    m_local_max_entry.store(num_entries, std::memory_order_release);
+}
+
 
 VersionID DB::get_version_id_of_latest_snapshot()
 {
+    if (m_replica_reader)
+        return {m_replica_reader->get_latest().m_version, 0};
     if (m_fake_read_lock_if_immutable)
         return {m_fake_read_lock_if_immutable->m_version, 0};
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // As get_version_of_latest_snapshot() may be called outside of the write
     // mutex, another thread may be performing changes to the ringbuffer
     // concurrently. It may even cleanup and recycle the current entry from
@@ -2176,9 +3484,10 @@ VersionID DB::get_version_id_of_latest_snapshot()
             // make sure that the index we are about to dereference falls within
             // the portion of the ringbuffer that we have mapped - if not, extend
             // the mapping to fit.
-            r_info = m_reader_map.get_addr();
+            r_info = m_reader_info.load(std::memory_order_acquire);
             index = r_info->readers.last();
         } while (grow_reader_mapping(index)); // throws
+        r_info = m_reader_info.load(std::memory_order_acquire);
 
         // now (double) increment the read count so that no-one cleans up the entry
         // while we read it.
@@ -2200,6 +3509,46 @@ DB::version_type DB::get_version_of_latest_snapshot()
 }
 
 
+void DB::adapt_map_windows(const GroupWriter& out)
+{
+    if (!m_adapt_map_windows)
+        return;
+    constexpr size_t max_windows = 256;
+    constexpr unsigned quiet_commits_before_shrink = 16;
+    if (out.get_num_map_window_evictions() > 0) {
+        // Windows were closed before the commit was done with them, so the
+        // writes are spread over more of the file than the cache covers.
+        m_num_map_windows = std::min(2 * m_num_map_windows, max_windows);
+        m_num_quiet_commits = 0;
+    }
+    else if (out.get_num_map_window_misses() <= m_num_map_windows / 4) {
+        // Give back the mappings once commits have stayed local for a while
+        if (++m_num_quiet_commits >= quiet_commits_before_shrink) {
+            m_num_map_windows = std::max(m_num_map_windows / 2, GroupWriter::default_max_map_windows);
+            m_num_quiet_commits = 0;
+        }
+    }
+    else {
+        m_num_quiet_commits = 0;
+    }
+}
+
+void DB::start_evacuation_if_needed()
+{
+    constexpr size_t min_file_size = 1024 * 1024;
+    EvacuationState& state = *m_evacuation;
+    if (state.limit)
+        return;
+    if (state.commits_until_retry) {
+        --state.commits_until_retry;
+        return;
+    }
+    // Compact when more than half of the file is free, leaving some room for
+    // fragmentation below the new end of the file.
+    if (m_free_space + m_used_space >= min_file_size && m_free_space > m_used_space)
+        state.limit = util::round_up_to_page_size(m_used_space + m_used_space / 2);
+}
+
 void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk)
 {
     SharedInfo* info = m_file_map.get_addr();
@@ -2207,6 +3556,7 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
     // Version of oldest snapshot currently (or recently) bound in a transaction
     // of the current session.
     uint_fast64_t oldest_version;
+    std::vector<std::pair<uint64_t, ref_type>> live_versions;
     {
         std::lock_guard<std::recursive_mutex> lock(m_mutex);
         SharedInfo* r_info = m_reader_map.get_addr();
@@ -2220,6 +3570,16 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         r_info->readers.cleanup();
         const Ringbuffer::ReadCount& rc = r_info->readers.get_oldest();
         oldest_version = rc.version;
+        if (m_reclaim_space_between_readers) {
+            // The space freed after the oldest version can be reused if no
+            // version which is still read can reach it. The versions in between
+            // which are not read are made unavailable, so that they cannot be
+            // read again.
+            live_versions.reserve(r_info->readers.get_num_entries()); // Throws
+            r_info->readers.release_unread([&](const Ringbuffer::ReadCount& r) {
+                live_versions.emplace_back(r.version, ref_type(r.current_top));
+            });
+        }
 
         // Allow for trimming of the history. Some types of histories do not
         // need store changesets prior to the oldest bound snapshot.
@@ -2239,19 +3599,31 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
     // info->readers.dump();
     GroupWriter out(transaction, Durability(info->durability)); // Throws
     out.set_versions(new_version, oldest_version);
+    out.set_live_versions(std::move(live_versions));
+    out.set_map_window_cache(m_num_map_windows, m_map_window_size);
+    out.encode_integer_leaves =
+        m_encode_integer_leaves && m_file_format_version >= Group::g_compact_file_format_version;
+    out.checksum_arrays = m_checksum_arrays;
+    if (m_evacuation) {
+        start_evacuation_if_needed();
+        out.set_evacuation_state(m_evacuation.get());
+    }
     ref_type new_top_ref;
     // Recursively write all changed arrays to end of file
     {
+        util::tracing::Span span("GroupWriter::write_group");
         // protect against race with any other DB trying to attach to the file
         std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
         new_top_ref = out.write_group();                         // Throws
+        span.set_attribute("bytes_written", int64_t(out.get_bytes_written()));
     }
     {
         // protect access to shared variables and m_reader_mapping from here
         std::lock_guard<std::recursive_mutex> lock_guard(m_mutex);
         m_free_space = out.get_free_space_size();
         m_locked_space = out.get_locked_space_size();
-        m_used_space = out.get_file_size() - m_free_space;
+        m_locked_space_by_version = out.get_locked_space_by_version();
+        m_used_space = out.get_logical_file_size() - m_free_space;
         // std::cout << "Writing version " << new_version << ", Topptr " << new_top_ref
         //     << " Read lock at version " << oldest_version << std::endl;
         switch (Durability(info->durability)) {
@@ -2271,6 +3643,11 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
                 // mode the file on disk may very likely be in an invalid state.
                 break;
         }
+        adapt_map_windows(out);
+#if REALM_METRICS
+        Metrics::report_map_window_usage(transaction, out.get_num_map_window_hits(),
+                                         out.get_num_map_window_misses());
+#endif // REALM_METRICS
         size_t new_file_size = out.get_file_size();
         // We must reset the allocators free space tracking before communicating the new
         // version through the ring buffer. If not, a reader may start updating the allocators
@@ -2289,10 +3666,9 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
                 entries = entries + 32;
                 size_t new_info_size = sizeof(SharedInfo) + r_info->readers.compute_required_space(entries);
                 // std::cout << "resizing: " << entries << " = " << new_info_size << std::endl;
-                m_file.prealloc(new_info_size);                                          // Throws
-                m_reader_map.remap(m_file, util::File::access_ReadWrite, new_info_size); // Throws
+                m_file.prealloc(new_info_size);             // Throws
+                remap_reader_info(entries, new_info_size); // Throws
                 r_info = m_reader_map.get_addr();
-                m_local_max_entry = entries;
                 r_info->readers.expand_to(entries);
             }
             Ringbuffer::ReadCount& r = r_info->readers.get_next();
@@ -2376,10 +3752,15 @@ void DB::delete_files(const std::string& base_path, bool* did_delete, bool delet
 
 TransactionRef DB::start_read(VersionID version_id)
 {
+    // Keeps close() from detaching the DB before the transaction is created
+    ReadLockGrab grab(*this); // Throws
     if (!is_attached())
         throw LogicError(LogicError::wrong_transact_state);
+#if REALM_METRICS
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::begin_read);
+#endif
     TransactionRef tr;
-    if (m_fake_read_lock_if_immutable) {
+    if (m_fake_read_lock_if_immutable && !m_replica_reader) {
         tr = make_transaction_ref(shared_from_this(), &m_alloc, *m_fake_read_lock_if_immutable, DB::transact_Reading);
     }
     else {
@@ -2396,10 +3777,12 @@ TransactionRef DB::start_read(VersionID version_id)
 
 TransactionRef DB::start_frozen(VersionID version_id)
 {
+    // Keeps close() from detaching the DB before the transaction is created
+    ReadLockGrab grab(*this); // Throws
     if (!is_attached())
         throw LogicError(LogicError::wrong_transact_state);
     TransactionRef tr;
-    if (m_fake_read_lock_if_immutable) {
+    if (m_fake_read_lock_if_immutable && !m_replica_reader) {
         tr = make_transaction_ref(shared_from_this(), &m_alloc, *m_fake_read_lock_if_immutable, DB::transact_Frozen);
     }
     else {
@@ -2491,7 +3874,27 @@ void DB::async_request_write_mutex(TransactionRef& tr, util::UniqueFunction<void
 inline DB::DB(const DBOptions& options)
     : m_key(options.encryption_key)
     , m_upgrade_callback(std::move(options.upgrade_callback))
+    , m_before_commit(options.before_commit)
+    , m_group_commit_window(options.durability == Durability::Full ? options.group_commit_window
+                                                                   : std::chrono::microseconds(0))
+    , m_defer_group_commit_sync(options.defer_group_commit_sync)
+    , m_on_deferred_sync_error(options.on_deferred_sync_error)
+    , m_adapt_map_windows(options.max_map_windows == 0)
+    , m_num_map_windows(options.max_map_windows ? options.max_map_windows : GroupWriter::default_max_map_windows)
+    , m_map_window_size(0)
+    , m_encode_integer_leaves(options.enable_integer_leaf_encoding)
+    , m_checksum_arrays(options.enable_array_checksums)
+    , m_reclaim_space_between_readers(options.reclaim_space_between_readers)
+    , m_stale_reader_policy(options.stale_reader_policy)
 {
+    if (options.enable_incremental_compaction && options.durability != Durability::MemOnly) {
+        m_evacuation = std::make_unique<EvacuationState>();
+    }
+    if (options.map_window_size) {
+        m_map_window_size = 1024 * 1024;
+        while (m_map_window_size < options.map_window_size)
+            m_map_window_size <<= 1;
+    }
     if (options.enable_async_writes) {
         m_commit_helper = std::make_unique<AsyncCommitHelper>(this);
     }
@@ -2539,6 +3942,15 @@ DBRef DB::create(BinaryData buffer, bool take_ownership)
     return retval;
 }
 
+DBRef DB::create(const std::vector<BinaryData>& regions)
+{
+    DBOptions options;
+    options.is_immutable = true;
+    DBRef retval = std::make_shared<DBInit>(options);
+    retval->open(regions);
+    return retval;
+}
+
 void DB::claim_sync_agent()
 {
     REALM_ASSERT(is_attached());
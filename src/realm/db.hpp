@@ -33,14 +33,21 @@
 #include <realm/util/interprocess_mutex.hpp>
 #include <realm/version_id.hpp>
 
+#include <atomic>
 #include <functional>
 #include <cstdint>
+#include <exception>
 #include <limits>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace realm {
 
 class Transaction;
+class GroupWriter;
+struct EvacuationState;
 using TransactionRef = std::shared_ptr<Transaction>;
 
 /// Thrown by DB::create() if the lock file is already open in another
@@ -119,6 +126,10 @@ public:
     static DBRef create(std::unique_ptr<Replication> repl, const std::string& file,
                         const DBOptions options = DBOptions());
     static DBRef create(BinaryData, bool take_ownership = true);
+    // Create a read-only DB over a Realm file held in a number of memory regions, such as shared
+    // memory segments, without copying it and without a lock file. See SlabAlloc::attach_buffers()
+    // for how the file must be split into regions. The regions must outlive the DB.
+    static DBRef create(const std::vector<BinaryData>& regions);
 
     ~DB() noexcept;
 
@@ -272,9 +283,32 @@ public:
     /// a read transaction will not immediately release any versions.
     uint_fast64_t get_number_of_versions();
 
+    using PinnedReader = DBOptions::PinnedReader;
+
+    /// Report the transactions of this DB which are currently reading a
+    /// version, oldest version first. Transactions of other DB instances,
+    /// including those in other processes, are not included, but do keep
+    /// versions alive too (see get_number_of_versions()).
+    std::vector<PinnedReader> get_pinned_readers();
+
     /// Get the size of the currently allocated slab area
     size_t get_allocated_size() const;
 
+    enum class MemoryPressure {
+        moderate, ///< Release what is unlikely to be needed again soon
+        critical, ///< Release everything which can be recreated on demand
+    };
+
+    /// Release memory held on behalf of the file, as a response to memory
+    /// pressure reported by the OS: for an encrypted file, the decrypted pages
+    /// which no live transaction can be using. At `moderate` pressure only
+    /// pages which have not been used since the last sweep of the page
+    /// reclaimer are released. Returns the number of bytes released.
+    ///
+    /// The caches of the tables of a transaction are released with
+    /// Group::release_memory().
+    size_t release_memory(MemoryPressure level = MemoryPressure::critical);
+
     /// Compact the database file.
     /// - The method will throw if called inside a transaction.
     /// - The method will throw if called in unattached state.
@@ -300,8 +334,33 @@ public:
     /// WARNING: Compact() is not thread-safe with respect to a concurrent close()
     bool compact(bool bump_version_number = false, util::Optional<const char*> output_encryption_key = util::none);
 
+    /// Write a copy of the latest version of the database to a new file at
+    /// the given path, optionally changing the encryption key. Where the
+    /// filesystem supports it (see util::File::clone()), an unencrypted file
+    /// which is not a synchronized realm is cloned, and only the header of the
+    /// clone is rewritten. The copy is then not compacted. Otherwise the
+    /// database is serialized to the new file.
     void write_copy(StringData path, const char* output_encryption_key);
 
+    /// Write a backup of the latest version of the database to \a out, and
+    /// set \a base to a read transaction on that version. If \a base is
+    /// already a read transaction on this database, which normally is the one
+    /// set by the previous call, only the arrays written since the version it
+    /// holds are included. Such an incremental backup can only be applied to a
+    /// file holding that version, as restored by apply_backup().
+    ///
+    /// The transaction in \a base keeps the space of the arrays in its version
+    /// from being reused until the next backup is made, so the file may grow
+    /// more than it would otherwise. The backup is never encrypted.
+    void write_backup(std::ostream& out, TransactionRef& base);
+
+    /// Apply a backup written by write_backup() to the file at \a path, which
+    /// must not be open. A full backup creates the file, which must not exist.
+    /// An incremental backup throws unless the file holds the version it was
+    /// based on. The file holds the previous version until the backup has been
+    /// applied completely.
+    static void apply_backup(const std::string& path, std::istream& in);
+
 #ifdef REALM_DEBUG
     void test_ringbuf();
 #endif
@@ -412,7 +471,12 @@ protected:
     explicit DB(const DBOptions& options); // Is this ever used?
 
 private:
+    class AccessProfilePrefetcher;
     class AsyncCommitHelper;
+    class ReadLockCounts;
+    class ReadLockGrab;
+    class ReplicaPublisher;
+    class ReplicaReader;
     struct SharedInfo;
     struct ReadCount;
     struct ReadLockInfo {
@@ -437,20 +501,39 @@ private:
     };
     class ReadLockGuard;
 
+    // The version read by a transaction, for get_pinned_readers(). Updated by
+    // the transaction, and read by other threads.
+    struct ReaderPin {
+        uint64_t id = 0;
+        std::thread::id thread;
+        bool is_frozen = false;
+        std::atomic<version_type> version{0};
+        std::atomic<std::chrono::steady_clock::rep> since{0};
+        std::atomic<bool> invalidated{false};
+        version_type reported_version = 0; // protected by m_reader_pins_mutex
+    };
+
     // Member variables
     std::recursive_mutex m_mutex;
-    int m_transaction_count = 0;
+    std::atomic<int> m_transaction_count{0};
+    std::atomic<bool> m_compacting{false}; // makes grab_read_lock() fall back to m_mutex during compact()
+    std::atomic<int> m_read_lock_grabs{0}; // number of ReadLockGrab objects, waited for by close()
+    std::atomic<bool> m_closing{false};    // set by close(), makes ReadLockGrab throw
     SlabAlloc m_alloc;
     std::unique_ptr<Replication> m_history;
     Replication* m_replication = nullptr;
     size_t m_free_space = 0;
     size_t m_locked_space = 0;
     size_t m_used_space = 0;
-    uint_fast32_t m_local_max_entry = 0;          // highest version observed by this DB
-    std::vector<ReadLockInfo> m_local_locks_held; // tracks all read locks held by this DB
+    std::atomic<uint_fast32_t> m_local_max_entry{0};  // highest version observed by this DB
+    std::unique_ptr<ReadLockCounts> m_read_lock_counts; // tracks all read locks held by this DB
     util::File m_file;
     util::File::Map<SharedInfo> m_file_map;   // Never remapped, provides access to everything but the ringbuffer
-    util::File::Map<SharedInfo> m_reader_map; // provides access to ringbuffer, remapped as needed when it grows
+    util::File::Map<SharedInfo> m_reader_map; // provides access to ringbuffer, replaced as needed when it grows
+    // Mappings of the ringbuffer replaced by a larger one. They are kept until close(), so
+    // that m_reader_info can be used without holding m_mutex.
+    std::vector<util::File::Map<SharedInfo>> m_retired_reader_maps;
+    std::atomic<SharedInfo*> m_reader_info{nullptr}; // address of m_reader_map
     bool m_wait_for_change_enabled = true;    // Initially wait_for_change is enabled
     bool m_write_transaction_open = false;
     std::string m_lockfile_path;
@@ -461,13 +544,51 @@ private:
     int m_file_format_version = 0;
     util::InterprocessMutex m_writemutex;
     std::unique_ptr<ReadLockInfo> m_fake_read_lock_if_immutable;
+    std::unique_ptr<ReplicaPublisher> m_replica_publisher; // if DBOptions::publish_to_replicas
+    std::unique_ptr<ReplicaReader> m_replica_reader;       // if DBOptions::is_replica
     util::InterprocessMutex m_controlmutex;
     util::InterprocessCondVar m_new_commit_available;
     util::InterprocessCondVar m_pick_next_writer;
     std::function<void(int, int)> m_upgrade_callback;
+    std::function<void(Transaction&)> m_before_commit; // See DBOptions::before_commit
     std::shared_ptr<metrics::Metrics> m_metrics;
     std::unique_ptr<AsyncCommitHelper> m_commit_helper;
+    // See DBOptions::enable_access_profile
+    std::unique_ptr<AccessProfilePrefetcher> m_prefetcher;
+    bool m_record_access_profile = false;
     bool m_is_sync_agent = false;
+    // Group commit, see DBOptions::group_commit_window
+    std::chrono::microseconds m_group_commit_window;
+    const bool m_defer_group_commit_sync;
+    std::function<void(std::exception_ptr)> m_on_deferred_sync_error; // See DBOptions::on_deferred_sync_error
+    // Write window cache, see DBOptions::max_map_windows. Adapted between
+    // commits when not fixed by the options.
+    const bool m_adapt_map_windows;
+    size_t m_num_map_windows;
+    size_t m_map_window_size;
+    unsigned m_num_quiet_commits = 0;
+    // See DBOptions::enable_integer_leaf_encoding
+    const bool m_encode_integer_leaves;
+    // See DBOptions::enable_array_checksums
+    const bool m_checksum_arrays;
+    // See DBOptions::reclaim_space_between_readers
+    const bool m_reclaim_space_between_readers;
+    // Incremental compaction, see DBOptions::enable_incremental_compaction
+    std::unique_ptr<EvacuationState> m_evacuation;
+    std::mutex m_group_commit_mutex;
+    std::condition_variable m_group_commit_cv;
+    util::Optional<ReadLockInfo> m_durable_read_lock; // held while there are commits not yet synced
+    version_type m_durable_version = 0;
+    bool m_group_commit_leader = false;
+    uint64_t m_num_failed_group_commits = 0;
+    std::exception_ptr m_group_commit_error;
+    std::thread m_deferred_sync_thread;
+    // See get_pinned_readers()
+    std::mutex m_reader_pins_mutex;
+    std::vector<ReaderPin*> m_reader_pins;
+    // Locked space of the last commit by the version it was freed in, protected by m_mutex
+    std::vector<std::pair<version_type, size_t>> m_locked_space_by_version;
+    DBOptions::StaleReaderPolicy m_stale_reader_policy;
 
     /// Attach this DB instance to the specified database file.
     ///
@@ -503,6 +624,7 @@ private:
     /// how to migrate from.
     void open(const std::string& file, bool no_create = false, const DBOptions options = DBOptions());
     void open(BinaryData, bool take_ownership = true);
+    void open(const std::vector<BinaryData>& regions);
     void open(Replication&, const std::string& file, const DBOptions options = DBOptions());
 
     void do_open(const std::string& file, bool no_create, const DBOptions options);
@@ -545,26 +667,69 @@ private:
     // release_read_lock for locks already released must be avoided.
     void release_all_read_locks() noexcept;
 
+    // Track the version read by a transaction, see get_pinned_readers()
+    void register_reader(ReaderPin&, const ReadLockInfo&, bool is_frozen);
+    void unregister_reader(ReaderPin&) noexcept;
+    static void note_reader_version(ReaderPin&, const ReadLockInfo&) noexcept;
+    size_t get_pinned_bytes(version_type) const noexcept; // caller must lock m_mutex
+    // Apply DBOptions::stale_reader_policy after a commit. The committing
+    // transaction still holds its old version and is not considered.
+    void check_stale_readers(version_type latest_version, const ReaderPin* committer);
+
     /// return true if write transaction can commence, false otherwise.
     bool do_try_begin_write();
     void do_begin_write();
     void do_begin_possibly_async_write();
     version_type do_commit(Transaction&, bool commit_to_disk = true);
+
+    bool is_group_commit_enabled() const noexcept
+    {
+        return m_group_commit_window.count() > 0;
+    }
+    // Keep the version last synced to disk from being overwritten by commits that are
+    // not yet synced. Must be called by the writer before committing with group commit.
+    void hold_durable_version(Transaction&);
+    // Wait until 'version' has been synced to disk, syncing the pending commits of all
+    // writers if no other thread is already doing so. Must be called without holding the
+    // write lock.
+    // With DBOptions::defer_group_commit_sync, this only makes sure that a sync of the
+    // pending commits is scheduled.
+    void wait_for_group_commit(version_type version);
+    void schedule_deferred_sync();
+    void run_deferred_syncs() noexcept;
+    void join_deferred_sync_thread() noexcept;
+    version_type sync_pending_commits();
     void do_end_write() noexcept;
     void end_write_on_correct_thread() noexcept;
 
     // make sure the given index is within the currently mapped area.
     // if not, expand the mapped area. Returns true if the area is expanded.
+    // Only takes m_mutex if the mapping has to be expanded.
     bool grow_reader_mapping(uint_fast32_t index);
 
+    // Replace the ringbuffer mapping by one covering 'num_entries' entries.
+    // Caller must lock m_mutex.
+    void remap_reader_info(uint_fast32_t num_entries, size_t info_size);
+
+    void do_grab_read_lock(ReadLockInfo&, VersionID);
+
     // Must be called only by someone that has a lock on the write mutex.
     void low_level_commit(uint_fast64_t new_version, Transaction& transaction, bool commit_to_disk = true);
 
+    // Grow or shrink the number of write windows used by the next commit
+    // based on how the last one used them. Caller must lock m_mutex.
+    void adapt_map_windows(const GroupWriter&);
+
+    // Decide whether the next commit should start compacting the file.
+    // Must be called only by someone that has a lock on the write mutex.
+    void start_evacuation_if_needed();
+
     void do_async_commits();
 
     /// Upgrade file format and/or history schema
     void upgrade_file_format(bool allow_file_format_upgrade, int target_file_format_version,
-                             int current_hist_schema_version, int target_hist_schema_version);
+                             int current_hist_schema_version, int target_hist_schema_version,
+                             size_t chunk_size);
 
     int get_file_format_version() const noexcept;
 
@@ -576,11 +741,15 @@ private:
         m_alloc.reset_free_space_tracking();
     }
 
-    void close_internal(std::unique_lock<util::InterprocessMutex>, bool allow_open_read_transactions);
+    // Throws if a write transaction, or any transaction when not allowed, is open. Requires m_mutex.
+    void check_no_open_transactions(bool allow_open_read_transactions);
+    void close_internal(std::unique_lock<util::InterprocessMutex>);
 
     void async_begin_write(util::UniqueFunction<void()> fn);
     void async_end_write();
     void async_sync_to_disk(util::UniqueFunction<void()> fn);
+    // Like async_sync_to_disk(), but the write mutex is kept after running 'fn'
+    void async_flush_to_disk(util::UniqueFunction<void()> fn);
 
     friend class Transaction;
 };
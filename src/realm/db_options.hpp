@@ -19,12 +19,18 @@
 #ifndef REALM_GROUP_SHARED_OPTIONS_HPP
 #define REALM_GROUP_SHARED_OPTIONS_HPP
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <string>
+#include <thread>
 #include <realm/backup_restore.hpp>
 
 namespace realm {
 
+class Transaction;
+
 struct DBOptions {
 
     /// The persistence level of the DB.
@@ -35,9 +41,71 @@ struct DBOptions {
         Unsafe // If you use this, you loose ACID property
     };
 
+    /// How the data in the file is mostly accessed. Used to advise the kernel
+    /// on read-ahead for the memory mappings of the file.
+    enum class AccessPattern {
+        Normal,
+        Random,    // Lookups of individual objects spread over a large file
+        Sequential // Scans through most of the file
+    };
+
     using version_list_t = BackupHandler::version_list_t;
     using version_time_list_t = BackupHandler::version_time_list_t;
 
+    /// A transaction of a DB and the version it reads, as reported by
+    /// DB::get_pinned_readers(). A version cannot be removed, and the space
+    /// freed after it cannot be reused, for as long as it is read.
+    struct PinnedReader {
+        /// Unique within the process
+        uint64_t reader_id = 0;
+        /// The thread which began the transaction
+        std::thread::id thread;
+        uint64_t version = 0;
+        bool is_frozen = false;
+        /// False if a newer version has been committed
+        bool is_latest = false;
+        /// How long the transaction has been reading this version
+        std::chrono::steady_clock::duration held_for{};
+        /// The free space in the file which cannot be reused for as long as
+        /// this version is read, as of the last commit made through the DB
+        size_t pinned_bytes = 0;
+        /// Set by StaleReaderPolicy::Action::Invalidate
+        bool is_invalidated = false;
+    };
+
+    /// What to do about transactions which keep reading an old version for
+    /// too long, or while too much space is freed after it. Checked by each
+    /// commit made through the DB.
+    struct StaleReaderPolicy {
+        enum class Action {
+            /// Only call `on_stale_reader`
+            Warn,
+            /// Also invalidate the transaction. The read lock of a transaction
+            /// cannot safely be taken away while it may be in use, so it is
+            /// ended by its owner: the next call of advance_read(),
+            /// promote_to_write(), freeze() or duplicate() on it ends it and
+            /// throws LogicError::wrong_transact_state. Long running readers
+            /// can check Transaction::is_invalidated().
+            Invalidate
+        };
+
+        /// Zero for no limit
+        std::chrono::milliseconds max_age{0};
+        /// Zero for no limit
+        size_t max_pinned_bytes = 0;
+        Action action = Action::Warn;
+        /// Called once for every reader of an old version which exceeds a
+        /// limit, on the thread that made the commit, once the commit is
+        /// done. If it throws, the exception is ignored, and the remaining
+        /// stale readers of that commit are not reported.
+        std::function<void(const PinnedReader&)> on_stale_reader;
+
+        bool is_enabled() const noexcept
+        {
+            return max_age.count() > 0 || max_pinned_bytes > 0;
+        }
+    };
+
     explicit DBOptions(Durability level = Durability::Full, const char* key = nullptr, bool allow_upgrade = true,
                        std::function<void(int, int)> file_upgrade_callback = nullptr,
                        std::string temp_directory = sys_tmp_dir, bool track_metrics = false,
@@ -98,6 +166,13 @@ struct DBOptions {
     /// upgrade (rollback the transaction) but the DB will not be opened.
     std::function<void(int, int)> upgrade_callback;
 
+    /// Called by every write transaction of the DB just before it commits,
+    /// while it can still be modified. Lets layers above the storage engine
+    /// keep data derived from the file up to date, as
+    /// MaterializedViews::enable() does. If it throws, the commit fails and
+    /// the transaction is left as it was.
+    std::function<void(Transaction&)> before_commit;
+
     /// A path to a directory where Realm can write temporary files or pipes to.
     /// This string should include a trailing slash '/'.
     std::string temp_dir;
@@ -118,6 +193,13 @@ struct DBOptions {
     /// Disable automatic backup at file format upgrade by setting to false
     bool backup_at_file_format_change;
 
+    /// The number of objects migrated in each commit during a file format
+    /// upgrade. Progress is recorded in the file with each commit, so an
+    /// upgrade that is interrupted continues where it stopped the next time
+    /// the file is opened, rather than starting over. If zero, each table is
+    /// migrated in a single commit.
+    size_t file_format_upgrade_chunk_size = 10000;
+
     /// List of versions we can upgrade from
     BackupHandler::version_list_t accepted_versions;
 
@@ -129,6 +211,154 @@ struct DBOptions {
     /// a performance impact.
     bool enable_async_writes = false;
 
+    /// If non-zero, durable commits made through this DB by concurrent writers are
+    /// batched, so that a single sync to disk covers all of them. A commit writes its
+    /// changes without syncing, releases the write lock, and then waits up to this long
+    /// for other writers to join the batch before the batch is made durable. commit()
+    /// still only returns once the changes it made are durable. Only used with
+    /// Durability::Full.
+    std::chrono::microseconds group_commit_window = std::chrono::microseconds(0);
+
+    /// If true, commits made with group commit return once their changes are
+    /// written and visible to other transactions, without waiting for them to
+    /// be synced to disk. The pending commits are synced together on a
+    /// separate thread once group_commit_window has passed, and by close(). A
+    /// crash can lose the commits made since the last sync, but the file is
+    /// left as of that sync. This suits many tiny commits of data which can be
+    /// recreated. If a deferred sync fails, the commits stay pending, and the
+    /// next commit schedules another attempt.
+    bool defer_group_commit_sync = false;
+
+    /// Called on the sync thread with the error when a deferred sync fails
+    /// (see defer_group_commit_sync). The commits that failed to be synced
+    /// were already reported as successful, so this is the only place the
+    /// failure is reported. Must not throw.
+    std::function<void(std::exception_ptr)> on_deferred_sync_error;
+
+    /// If true, once more than half of the file is free, commits made through
+    /// this DB gradually move live data from the end of the file into free space
+    /// earlier in it, and the file is shrunk when its end is no longer used by
+    /// any version being read. Unlike DB::compact(), this does not require
+    /// exclusive access to the file. As the work is done by ordinary write
+    /// transactions, committing an empty one makes progress when nothing else
+    /// is written. Not used with Durability::MemOnly.
+    bool enable_incremental_compaction = false;
+
+    /// The maximum number of memory mapped windows a commit keeps open while
+    /// writing to the file. If zero, the number is adapted to the write locality
+    /// observed in earlier commits, starting from 16.
+    size_t max_map_windows = 0;
+
+    /// The size of each window used for writing. If zero, a size suitable for
+    /// the platform is used (normally 1MB). Otherwise it is rounded up to a power
+    /// of two of at least 1MB.
+    size_t map_window_size = 0;
+
+    /// The access pattern the mappings of the file are advised for. Not used
+    /// for encrypted files, which are read through a separate decrypted copy.
+    AccessPattern access_pattern = AccessPattern::Normal;
+
+    /// If true, transparent huge pages are requested for the memory holding
+    /// the arrays modified by write transactions. This cuts down on TLB misses
+    /// when a transaction modifies a lot of data. Only has an effect where
+    /// supported by the kernel.
+    bool use_huge_pages = false;
+
+    /// If true, the kernel is asked to start reading in the top-level arrays
+    /// of the file and of each table when the file is opened.
+    bool prefetch_on_open = false;
+
+    /// If true, the ranges of the file which are held in memory when the last
+    /// DB on the file is closed are recorded in the management directory next
+    /// to the lock file. When the file is opened again, a background thread
+    /// asks the system to read those ranges back in, so that the first queries
+    /// do not have to wait for the pages they need one by one. Not used with
+    /// Durability::MemOnly or encrypted files.
+    bool enable_access_profile = false;
+
+    /// If true, integer arrays are written to the file frame-of-reference
+    /// encoded whenever that makes them smaller: every element is stored as
+    /// an offset from the smallest one, using only as many bits as the largest
+    /// offset needs. A leaf of timestamps or increasing ids then takes a
+    /// fraction of the space, and searches run on the packed offsets. Leaves
+    /// are decoded again when modified. The file is upgraded to file format
+    /// version 23, so that versions of Realm that do not know the encoding
+    /// refuse to open it, and stays at that version. All DBs opening the
+    /// file at the same time must agree on whether this is enabled, unless the
+    /// file has been upgraded already.
+    bool enable_integer_leaf_encoding = false;
+
+    /// If true, string leaves with few distinct values are dictionary encoded:
+    /// the leaf holds each distinct value once, and a small integer code per
+    /// element. Leaves switch to and from the encoding as they are modified.
+    /// Like enable_integer_leaf_encoding, this upgrades the file to file format
+    /// version 23.
+    bool enable_string_dictionary_encoding = false;
+
+    /// If true, Table::set_compressed() may be used to have large string and
+    /// binary values stored compressed. Like enable_integer_leaf_encoding,
+    /// this upgrades the file to file format version 23. Columns which have
+    /// compression enabled keep compressing values when the file is opened
+    /// without this option.
+    bool enable_value_compression = false;
+
+    /// If true, Decimal128 leaves store their values in 8 bytes each as long
+    /// as every value is null or has a coefficient of at most 49 bits, see
+    /// ArrayDecimal128. Like enable_integer_leaf_encoding, this upgrades the
+    /// file to file format version 23.
+    bool enable_compact_decimal_leaves = false;
+
+    /// If true, every array written to the file carries the CRC-32C of its
+    /// contents in its header, where it otherwise has a fixed signature, so
+    /// that Group::check_integrity() can detect arrays damaged on disk.
+    /// Computing the checksums adds to the cost of a commit in proportion to
+    /// the amount of data written. The file format is unchanged, and files
+    /// with checksums can be opened by any version of Realm.
+    bool enable_array_checksums = false;
+
+    /// If true, space freed after the oldest version being read is reused as
+    /// soon as none of the versions still being read can reach it, so that a
+    /// long lived reader does not keep everything written after it in the
+    /// file. To make this possible, each commit releases the versions between
+    /// the oldest and the latest which are not being read at the time, so
+    /// starting a transaction on a VersionID that is not bound by another
+    /// transaction may fail with DB::BadVersion. Only use this when every DB
+    /// on the file starts transactions on the latest version or on versions
+    /// it keeps bound. By default, only the space freed before the oldest
+    /// version being read is reused.
+    bool reclaim_space_between_readers = false;
+
+    /// If non-zero, the memory holding decrypted pages of an encrypted file is
+    /// kept to about this many bytes. When it is exceeded, the pages which
+    /// have been used least recently are released, starting with those only
+    /// read by sequential scans. This applies in addition to the limit set by
+    /// the page reclaim governor. Not used for unencrypted files.
+    size_t decrypted_page_budget = 0;
+
+    /// If true, each commit made through the DB is published to read-only
+    /// replicas (see is_replica) through a small shared memory slot in the
+    /// management directory. All DBs writing to the file must publish, and one
+    /// of them must stay open for as long as replicas read it. A published
+    /// version is kept for as long as an open replica reads it or an older
+    /// one. DB::compact() fails while a replica is open, and replicas cannot
+    /// be opened while it runs. Not used with encrypted files or
+    /// Durability::MemOnly.
+    bool publish_to_replicas = false;
+
+    /// If true, the file is opened as a read-only replica of a DB which
+    /// publishes to replicas. A replica reads the latest version published,
+    /// without taking part in the lock file protocol, so opening it and
+    /// starting transactions need no interprocess locking. It announces the
+    /// versions it reads in the shared memory slot, so the management
+    /// directory must be writable. At most 64 replicas can be open at once.
+    /// Replicas cannot write, and cannot wait_for_change(), but see new
+    /// versions through has_changed() and advance_read().
+    bool is_replica = false;
+
+    /// Limits on the transactions of the DB which read versions that are no
+    /// longer the latest. Disabled by default. See StaleReaderPolicy.
+    StaleReaderPolicy stale_reader_policy;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating DBOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
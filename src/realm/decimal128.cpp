@@ -43,6 +43,50 @@ BID_UINT128 to_BID_UINT128(const Decimal128& val)
     return ret;
 }
 
+// Most decimals stored in a Realm, amounts of money in particular, are finite
+// values whose coefficient fits in the low word. When two of those also have
+// the same exponent, they can be added and compared as plain integers, which
+// is a lot cheaper than going through the BID library.
+constexpr uint64_t sign_bit = uint64_t(1) << 63;
+constexpr uint64_t exponent_bits = ((uint64_t(1) << 14) - 1) << 49;
+constexpr uint64_t coefficient_high_bits = (uint64_t(1) << 49) - 1;
+constexpr uint64_t special_bits = uint64_t(3) << 61;
+
+inline bool same_exponent_and_small(const Decimal128::Bid128& lhs, const Decimal128::Bid128& rhs) noexcept
+{
+    // Both of the two bits after the sign set means NaN, infinity or a
+    // coefficient in the large format
+    return (lhs.w[1] & special_bits) != special_bits && (lhs.w[1] & coefficient_high_bits) == 0 &&
+           ((lhs.w[1] ^ rhs.w[1]) & (exponent_bits | special_bits | coefficient_high_bits)) == 0;
+}
+
+// The result has the common exponent, and is an exact +0 if the operands
+// cancel out, as bid128_add() does when rounding to nearest
+bool add_small(Decimal128::Bid128& lhs, uint64_t rhs_high, uint64_t rhs_low) noexcept
+{
+    uint64_t exponent = lhs.w[1] & exponent_bits;
+    uint64_t lhs_sign = lhs.w[1] & sign_bit;
+    if (lhs_sign == (rhs_high & sign_bit)) {
+        uint64_t sum = lhs.w[0] + rhs_low;
+        if (sum < rhs_low)
+            return false; // Carry, let the BID library take care of it
+        lhs.w[0] = sum;
+        return true;
+    }
+    if (lhs.w[0] > rhs_low) {
+        lhs.w[0] -= rhs_low;
+    }
+    else if (lhs.w[0] < rhs_low) {
+        lhs.w[0] = rhs_low - lhs.w[0];
+        lhs.w[1] = (rhs_high & sign_bit) | exponent;
+    }
+    else {
+        lhs.w[0] = 0;
+        lhs.w[1] = exponent;
+    }
+    return true;
+}
+
 } // namespace
 
 Decimal128::Decimal128()
@@ -1502,6 +1546,11 @@ bool Decimal128::to_int(int64_t& i) const
 
 bool Decimal128::operator==(const Decimal128& rhs) const
 {
+    if (same_exponent_and_small(m_value, rhs.m_value)) {
+        // +0 and -0 are equal
+        return m_value.w[0] == rhs.m_value.w[0] &&
+               (m_value.w[1] == rhs.m_value.w[1] || m_value.w[0] == 0);
+    }
     if (is_null() && rhs.is_null()) {
         return true;
     }
@@ -1520,6 +1569,19 @@ bool Decimal128::operator!=(const Decimal128& rhs) const
 
 int Decimal128::compare(const Decimal128& rhs) const
 {
+    if (same_exponent_and_small(m_value, rhs.m_value)) {
+        uint64_t lhs_coefficient = m_value.w[0];
+        uint64_t rhs_coefficient = rhs.m_value.w[0];
+        if (lhs_coefficient == 0 && rhs_coefficient == 0)
+            return 0;
+        bool lhs_negative = m_value.w[1] & sign_bit;
+        bool rhs_negative = rhs.m_value.w[1] & sign_bit;
+        if (lhs_negative != rhs_negative)
+            return lhs_negative ? -1 : 1;
+        if (lhs_coefficient == rhs_coefficient)
+            return 0;
+        return (lhs_coefficient < rhs_coefficient) != lhs_negative ? -1 : 1;
+    }
     unsigned flags = 0;
     int ret;
     BID_UINT128 l = to_BID_UINT128(*this);
@@ -1643,6 +1705,8 @@ Decimal128 Decimal128::operator/(Decimal128 div) const
 
 Decimal128& Decimal128::operator+=(Decimal128 rhs)
 {
+    if (same_exponent_and_small(m_value, rhs.m_value) && add_small(m_value, rhs.m_value.w[1], rhs.m_value.w[0]))
+        return *this;
     unsigned flags = 0;
     BID_UINT128 x = to_BID_UINT128(*this);
     BID_UINT128 y = to_BID_UINT128(rhs);
@@ -1655,6 +1719,9 @@ Decimal128& Decimal128::operator+=(Decimal128 rhs)
 
 Decimal128& Decimal128::operator-=(Decimal128 rhs)
 {
+    if (same_exponent_and_small(m_value, rhs.m_value) &&
+        add_small(m_value, rhs.m_value.w[1] ^ sign_bit, rhs.m_value.w[0]))
+        return *this;
     unsigned flags = 0;
     BID_UINT128 x = to_BID_UINT128(*this);
     BID_UINT128 y = to_BID_UINT128(rhs);
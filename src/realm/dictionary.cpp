@@ -65,6 +65,7 @@ DictionaryClusterTree::~DictionaryClusterTree() {}
 
 bool DictionaryClusterTree::init_from_parent()
 {
+    m_small_keys.reset();
     if (ClusterTree::init_from_parent()) {
         m_has_collision_column = (nb_columns() == 3);
         return true;
@@ -127,9 +128,56 @@ ObjKey DictionaryClusterTree::find_sibling(ClusterNode::State& state, Mixed key)
     return {};
 }
 
+bool DictionaryClusterTree::try_get_small(ObjKey k, ClusterNode::State& state) const noexcept
+{
+    if (!m_small_lookup_enabled || !m_root->is_leaf() || m_size > s_small_dictionary_size)
+        return false;
+
+    auto storage_version = m_alloc.get_storage_version();
+    ref_type ref = m_root->get_ref();
+    if (!(m_small_keys && m_small_keys->storage_version == storage_version && m_small_keys->ref == ref)) {
+        // Taking the snapshot costs about as much as a lookup, so only do it
+        // when the tree is looked up repeatedly.
+        if (m_last_lookup_version != storage_version || m_last_lookup_ref != ref) {
+            m_last_lookup_version = storage_version;
+            m_last_lookup_ref = ref;
+            return false;
+        }
+        if (!m_small_keys) {
+            m_small_keys.reset(new (std::nothrow) SmallKeys);
+            if (!m_small_keys)
+                return false;
+        }
+        auto leaf = static_cast<const Cluster*>(m_root.get());
+        size_t sz = leaf->node_size();
+        for (size_t i = 0; i < sz; i++) {
+            m_small_keys->keys[i] = uint64_t(leaf->get_key_value(i));
+        }
+        m_small_keys->size = sz;
+        m_small_keys->ref = ref;
+        m_small_keys->storage_version = storage_version;
+    }
+
+    // The keys are ordered, so the position of 'k' is the number of keys less
+    // than it. Counting them without an early exit lets the compiler
+    // vectorize the loop.
+    const uint64_t* keys = m_small_keys->keys;
+    size_t sz = m_small_keys->size;
+    uint64_t key = uint64_t(k.value);
+    size_t pos = 0;
+    for (size_t i = 0; i < sz; i++) {
+        pos += (keys[i] < key);
+    }
+    state.mem = m_root->get_mem();
+    state.index = (pos < sz && keys[pos] == key) ? pos : realm::npos;
+    return true;
+}
+
 ClusterNode::State DictionaryClusterTree::try_get_with_key(ObjKey k, Mixed key) const noexcept
 {
-    auto state = ClusterTree::try_get(k);
+    ClusterNode::State state;
+    if (!try_get_small(k, state))
+        state = ClusterTree::try_get(k);
     if (state) {
         // Some entry found - Check if key matches.
         if (get_key(state).compare_signed(key) != 0) {
@@ -146,11 +194,22 @@ ClusterNode::State DictionaryClusterTree::try_get_with_key(ObjKey k, Mixed key)
 
 size_t DictionaryClusterTree::get_ndx_with_key(ObjKey k, Mixed key) const noexcept
 {
-    size_t pos = ClusterTree::get_ndx(k);
-    if (pos == realm::npos) {
-        return pos;
+    ClusterNode::State state;
+    size_t pos;
+    if (try_get_small(k, state)) {
+        // The tree is a single leaf, so the index in the leaf is the position
+        pos = state.index;
+        if (pos == realm::npos) {
+            return pos;
+        }
+    }
+    else {
+        pos = ClusterTree::get_ndx(k);
+        if (pos == realm::npos) {
+            return pos;
+        }
+        state = get(pos, k);
     }
-    auto state = get(pos, k);
     if (get_key(state).compare_signed(key) == 0) {
         return pos;
     }
@@ -969,6 +1028,7 @@ bool Dictionary::init_from_parent(bool allow_create) const
     if (!m_clusters) {
         m_clusters.reset(new DictionaryClusterTree(const_cast<Dictionary*>(this), m_key_type, m_obj.get_alloc(),
                                                    m_obj.get_row_ndx()));
+        m_clusters->set_small_lookup_enabled(!m_obj.get_table()->is_frozen());
     }
 
     if (m_clusters->init_from_parent()) {
@@ -46,6 +46,7 @@ public:
 
         bump_content_version();
         bump_storage_version();
+        m_small_keys.reset();
 
         m_size = 0;
     }
@@ -55,6 +56,13 @@ public:
     ClusterNode::State try_get_with_key(ObjKey k, Mixed) const noexcept;
     size_t get_ndx_with_key(ObjKey k, Mixed) const noexcept;
 
+    // Must not be enabled for trees that may be read from several threads
+    void set_small_lookup_enabled(bool enable)
+    {
+        m_small_lookup_enabled = enable;
+        m_small_keys.reset();
+    }
+
     ColKey get_keys_column_key() const
     {
         return m_keys_col;
@@ -116,13 +124,36 @@ public:
     Mixed avg(size_t* return_cnt = nullptr, DataType type = type_Mixed) const;
 
 private:
+    // Dictionaries holding no more than this number of entries are looked up
+    // through a snapshot of their key hashes instead of the cluster tree.
+    static constexpr size_t s_small_dictionary_size = 64;
+
+    // Contiguous copy of the keys of a dictionary that fits in a single leaf.
+    // The snapshot only holds the hashes, so it stays valid as long as no
+    // entry is inserted or erased and the leaf is not reallocated, all of
+    // which bump the storage version of the allocator.
+    struct SmallKeys {
+        uint64_t storage_version;
+        ref_type ref;
+        size_t size;
+        uint64_t keys[s_small_dictionary_size];
+    };
+
     template <typename AggregateType>
     void do_accumulate(size_t* return_ndx, AggregateType& agg) const;
 
+    bool try_get_small(ObjKey k, ClusterNode::State& state) const noexcept;
+
     ArrayParent* m_owner;
     size_t m_ndx_in_cluster;
     ColKey m_keys_col;
     bool m_has_collision_column = false;
+    bool m_small_lookup_enabled = false;
+    mutable std::unique_ptr<SmallKeys> m_small_keys;
+    // Storage version and root seen by the previous lookup. The snapshot is
+    // only built once the same tree is looked up twice.
+    mutable uint64_t m_last_lookup_version = 0;
+    mutable ref_type m_last_lookup_ref = 0;
 };
 
 } // namespace realm
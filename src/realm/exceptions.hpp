@@ -125,6 +125,16 @@ public:
     }
 };
 
+/// Thrown when the evaluation of a query is abandoned because its cancellation
+/// token was cancelled or its deadline passed.
+class QueryCancelled : public std::runtime_error {
+public:
+    QueryCancelled()
+        : std::runtime_error("Query evaluation was cancelled")
+    {
+    }
+};
+
 /// Thrown when a key is already existing when trying to create a new object
 class KeyAlreadyUsed : public std::runtime_error {
 public:
@@ -22,6 +22,7 @@
 #include <limits>
 #include <sstream>
 #include <cstdint>
+#include <thread>
 #include <vector>
 
 #include <realm/util/assert.hpp>
@@ -65,14 +66,14 @@ const char* DataTypeToText(DataType t)
 void print_col_names(Table& table)
 {
     std::cout << "\n";
-    for (size_t t = 0; t < table.get_column_count(); t++) {
-        std::string s = std::string(table.get_column_name(t).data());
+    for (auto col : table.get_column_keys()) {
+        std::string s = std::string(table.get_column_name(col).data());
         s = set_width(s, print_width);
         std::cout << s.c_str() << " ";
     }
     std::cout << "\n";
-    for (size_t t = 0; t < table.get_column_count(); t++) {
-        std::string s = "Type: " + std::string(DataTypeToText(table.get_column_type(t)));
+    for (auto col : table.get_column_keys()) {
+        std::string s = "Type: " + std::string(DataTypeToText(table.get_column_type(col)));
         s = set_width(s, print_width);
         std::cout << s.c_str() << " ";
     }
@@ -80,25 +81,26 @@ void print_col_names(Table& table)
     std::cout << "\n" << std::string(table.get_column_count() * (print_width + 1), '-').c_str() << "\n";
 }
 
-// Prints row 'r' of a Realm table
-void print_row(Table& table, size_t r)
+// Prints an object of a Realm table
+void print_row(const Obj& obj)
 {
-    for (size_t c = 0; c < table.get_column_count(); c++) {
+    for (auto col : obj.get_table()->get_column_keys()) {
         char buf[print_width];
-
-        if (table.get_column_type(c) == type_Bool)
-            sprintf(buf, "%s", table.get_bool(c, r) ? "true" : "false");
-        if (table.get_column_type(c) == type_Double)
-            sprintf(buf, "%f", table.get_double(c, r));
-        if (table.get_column_type(c) == type_Float)
-            sprintf(buf, "%f", table.get_float(c, r));
-        if (table.get_column_type(c) == type_Int)
-            sprintf(buf, "%lld", static_cast<long long>(table.get_int(c, r)));
-        if (table.get_column_type(c) == type_String) {
+        DataType type = obj.get_table()->get_column_type(col);
+
+        if (type == type_Bool)
+            sprintf(buf, "%s", obj.get<bool>(col) ? "true" : "false");
+        if (type == type_Double)
+            snprintf(buf, sizeof(buf), "%f", obj.get<double>(col));
+        if (type == type_Float)
+            snprintf(buf, sizeof(buf), "%f", obj.get<float>(col));
+        if (type == type_Int)
+            snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(obj.get<Int>(col)));
+        if (type == type_String) {
 #if defined(_MSC_VER) && _MSC_VER
-            _snprintf(buf, sizeof(buf), "%s", table.get_string(c, r).data());
+            _snprintf(buf, sizeof(buf), "%s", obj.get<String>(col).data());
 #else
-            snprintf(buf, sizeof(buf), "%s", table.get_string(c, r).data());
+            snprintf(buf, sizeof(buf), "%s", obj.get<String>(col).data());
 #endif
         }
         std::string s = std::string(buf);
@@ -129,6 +131,8 @@ bool is_null(const char* v)
 Importer::Importer()
     : Quiet(false)
     , Separator(',')
+    , Empty_as_string(false)
+    , Threads(1)
 {
 }
 
@@ -640,8 +644,9 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
     }
 
     // Create scheme in Realm table
+    std::vector<ColKey> col_keys;
     for (size_t t = 0; t < scheme.size(); t++)
-        table.add_column(scheme[t], StringData(header[t]).data());
+        col_keys.push_back(table.add_column(scheme[t], StringData(header[t]).data()));
 
     if (!Quiet)
         print_col_names(table);
@@ -654,80 +659,84 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
         payload.clear();
     }
 
+    // Values in the column-major layout expected by Table::create_objects()
+    std::vector<Mixed> values;
+
     do {
-        for (size_t row = 0; row < payload.size(); row++) {
-
-            if (imported_rows == import_rows)
-                return imported_rows;
-
-            if (!Quiet && imported_rows % 123 == 0)
-                std::cout << imported_rows << " rows\r";
-
-            // Add empty row to Realm
-            REALM_ASSERT(false); // unimplemented
-            // table.add_empty_row();
-
-            // Add all fields to new row
-            for (size_t col = 0; col < scheme.size(); col++) {
-                bool success = true;
-
-                if (scheme[col] == type_String)
-                    table.set_string(col, imported_rows, StringData(payload[row][col]));
-                else if (scheme[col] == type_Int)
-                    table.set_int(col, imported_rows, parse_integer<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Double)
-                    table.set_double(col, imported_rows, parse_double<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Float)
-                    table.set_float(col, imported_rows, parse_float<true>(payload[row][col].c_str(), &success));
-                else if (scheme[col] == type_Bool)
-                    table.set_bool(col, imported_rows, parse_bool<true>(payload[row][col].c_str(), &success));
-                else
-                    REALM_ASSERT(false);
-
-                if (!success) {
-                    // Remove all columns so that user can call csv_import() on it again
-                    table.clear();
-
-                    for (size_t t = 0; t < table.get_column_count(); t++)
-                        table.remove_column(0);
-
-                    std::stringstream sstm;
-
-                    if (type_detection_rows > 0) {
-                        if (scheme[col] != type_String && is_null(payload[row][col].c_str()) && Empty_as_string)
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained the NULL value '" << payload[row][col].c_str()
-                                 << "'. Please increase the 'type_detection_rows' argument or set "
-                                 << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
-                                    "false";
-                        else
-                            sstm << "Column " << col << " was auto detected to be of type "
-                                 << DataTypeToText(scheme[col]) << " using the first " << type_detection_rows
-                                 << " rows of CSV file, but in row " << imported_rows
-                                 << " of cvs file the field contained '" << payload[row][col].c_str()
-                                 << "' which is of another type. Please increase the 'type_detection_rows' argument";
-                    }
-                    else
-                        sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col])
-                             << ", but in row " << imported_rows << " of cvs file,"
-                             << "the field contained '" << payload[row][col].c_str() << "' which is of another type";
-
-                    throw std::runtime_error(sstm.str());
-                }
+        size_t rows = std::min(payload.size(), import_rows - imported_rows);
+        if (rows == 0)
+            break;
+
+        // Convert the fields of the batch, one column at a time. The columns
+        // are divided between `Threads` threads.
+        values.resize(rows * scheme.size());
+        std::vector<size_t> failed_rows(scheme.size(), realm::npos);
+        auto convert_columns = [&](size_t first_col, size_t step) {
+            for (size_t col = first_col; col < scheme.size(); col += step)
+                failed_rows[col] = convert_column(payload, rows, col, scheme[col], &values[col * rows]);
+        };
+        size_t num_threads = std::max(std::min(Threads, scheme.size()), size_t(1));
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < num_threads; ++i)
+            threads.emplace_back(convert_columns, i, num_threads);
+        convert_columns(0, num_threads);
+        for (auto& thread : threads)
+            thread.join();
+
+        // Report the first field, in file order, that could not be converted
+        size_t row = realm::npos;
+        size_t col = realm::npos;
+        for (size_t c = 0; c < scheme.size(); ++c) {
+            if (failed_rows[c] < row) {
+                row = failed_rows[c];
+                col = c;
             }
+        }
+        if (row != realm::npos) {
+            size_t file_row = imported_rows + row;
 
+            // Remove all columns so that user can call csv_import() on it again
+            table.clear();
 
-            if (!Quiet) {
-                if (imported_rows < 10)
-                    print_row(table, imported_rows);
-                else if (imported_rows == 11)
-                    std::cout << "\nOnly showing first few rows...\n";
+            for (auto col_key : col_keys)
+                table.remove_column(col_key);
+
+            std::stringstream sstm;
+
+            if (type_detection_rows > 0) {
+                if (scheme[col] != type_String && is_null(payload[row][col].c_str()) && Empty_as_string)
+                    sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                         << " using the first " << type_detection_rows << " rows of CSV file, but in row "
+                         << file_row << " of cvs file the field contained the NULL value '"
+                         << payload[row][col].c_str() << "'. Please increase the 'type_detection_rows' argument or set "
+                         << "Empty_as_string = false/void the -e flag to convert such fields to 0, 0.0 or "
+                            "false";
+                else
+                    sstm << "Column " << col << " was auto detected to be of type " << DataTypeToText(scheme[col])
+                         << " using the first " << type_detection_rows << " rows of CSV file, but in row "
+                         << file_row << " of cvs file the field contained '" << payload[row][col].c_str()
+                         << "' which is of another type. Please increase the 'type_detection_rows' argument";
             }
+            else
+                sstm << "Column " << col << " was specified to be of type " << DataTypeToText(scheme[col])
+                     << ", but in row " << file_row << " of cvs file,"
+                     << "the field contained '" << payload[row][col].c_str() << "' which is of another type";
+
+            throw std::runtime_error(sstm.str());
+        }
+
+        // Insert the whole batch through the bulk path
+        auto keys = table.create_objects(col_keys, values);
 
-            imported_rows++;
+        if (!Quiet) {
+            for (size_t r = 0; r < rows && imported_rows + r < 10; ++r)
+                print_row(table.get_object(keys[r]));
+            if (imported_rows < 11 && imported_rows + rows >= 11)
+                std::cout << "\nOnly showing first few rows...\n";
+            std::cout << imported_rows + rows << " rows\r";
         }
+
+        imported_rows += rows;
         payload.clear();
         tokenize(payload, record_chunks);
     } while (payload.size() > 0);
@@ -735,6 +744,34 @@ size_t Importer::import_csv(FILE* file, Table& table, std::vector<DataType>* imp
     return imported_rows;
 }
 
+// Converts field `col` of the first `rows` rows of `payload` to `type`, and
+// stores the values in `out`. Returns the first row whose field could not be
+// converted, or npos.
+size_t Importer::convert_column(const std::vector<std::vector<std::string>>& payload, size_t rows, size_t col,
+                                DataType type, Mixed* out)
+{
+    bool success = true;
+    for (size_t row = 0; row < rows; row++) {
+        const std::string& field = payload[row][col];
+        if (type == type_String)
+            out[row] = StringData(field);
+        else if (type == type_Int)
+            out[row] = parse_integer<true>(field.c_str(), &success);
+        else if (type == type_Double)
+            out[row] = parse_double<true>(field.c_str(), &success);
+        else if (type == type_Float)
+            out[row] = parse_float<true>(field.c_str(), &success);
+        else if (type == type_Bool)
+            out[row] = parse_bool<true>(field.c_str(), &success);
+        else
+            REALM_ASSERT(false);
+
+        if (!success)
+            return row;
+    }
+    return realm::npos;
+}
+
 size_t Importer::import_csv_auto(FILE* file, Table& table, size_t type_detection_rows, size_t import_rows)
 {
     return import_csv(file, table, nullptr, nullptr, type_detection_rows, 0, import_rows);
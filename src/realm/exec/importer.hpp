@@ -63,8 +63,9 @@ import_csv(csv file handle, realm table)
     Calls tokenize(csv file handle):
         reads payload chunk and returns std::vector<std::vector<std::string>> with the right dimensions filled with
         rows and columns of the chunk payload
-    Calls parse_float(), parse_bool(), etc, which tests for type and returns converted values
-    Calls table.add_empty_row(), table.set_float(), table.set_bool()
+    Calls convert_column() for each column, on multiple threads, which calls parse_float(), parse_bool(), etc, to
+        test for type and convert the values of the chunk into a column-major vector
+    Calls table.create_objects() with the converted values of the chunk
 */
 
 #include <cstddef>
@@ -76,8 +77,9 @@ import_csv(csv file handle, realm table)
 // Ubuntu)
 static const size_t chunk_size = 32 * 1024;
 
-// Number of rows to csv-parse + insert into realm in each iteration.
-static const size_t record_chunks = 100;
+// Number of rows to csv-parse + insert into realm in each iteration. Each batch is converted by `Importer::Threads`
+// threads and inserted with a single call to Table::create_objects().
+static const size_t record_chunks = 10000;
 
 // Width of each column when printing them on screen (non-Quiet mode)
 const size_t print_width = 25;
@@ -100,6 +102,7 @@ public:
     bool Quiet;           // Quiet mode, only print to screen upon errors
     char Separator;       // csv delimitor/separator
     bool Empty_as_string; // Import columns that have occurences of empty strings as String type column
+    size_t Threads;       // Number of threads that convert csv fields to column values
 
 private:
     size_t import_csv(FILE* file, Table& table, std::vector<DataType>* import_scheme,
@@ -115,6 +118,8 @@ private:
     bool parse_bool(const char* col, bool* success = nullptr);
     std::vector<DataType> types(std::vector<std::string> v);
     size_t tokenize(std::vector<std::vector<std::string>>& payload, size_t records);
+    size_t convert_column(const std::vector<std::vector<std::string>>& payload, size_t rows, size_t col,
+                          DataType type, Mixed* out);
     std::vector<DataType> detect_scheme(std::vector<std::vector<std::string>> payload, size_t begin, size_t end);
     std::vector<DataType> lowest_common(std::vector<DataType> types1, std::vector<DataType> types2);
 
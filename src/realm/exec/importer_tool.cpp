@@ -20,6 +20,7 @@
 
 #define NOMINMAX
 
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <realm.hpp>
@@ -39,13 +40,14 @@ char separator_flag = ',';
 bool force_flag = false;
 bool quiet_flag = false;
 bool empty_as_string_flag = false;
+size_t threads_flag = 1;
 
 const char* legend =
     "Simple auto-import (works in most cases):\n"
     "  csv <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Advanced auto-detection of scheme:\n"
-    "  csv [-a=N] [-n=N] [-e] [-f] [-q] [-l tablename] <.csv file | -stdin> <.realm file>\n"
+    "  csv [-a=N] [-n=N] [-j=N] [-e] [-f] [-q] [-l tablename] <.csv file | -stdin> <.realm file>\n"
     "\n"
     "Manual specification of scheme:\n"
     "  csv -t={s|i|b|f|d}{s|i|b|f|d}... name1 name2 ... [-s=N] [-n=N] <.csv file | -stdin> <.realm file>\n"
@@ -54,6 +56,7 @@ const char* legend =
     " -e: Realm does not support null values. Set the -e flag to import a column as a String type column if\n"
     "     it has occurences of empty fields. Otherwise empty fields may be converted to 0, 0.0 or false\n"
     " -n: Only import first N rows of payload\n"
+    " -j: Use N threads to convert fields to column values (default =1)\n"
     " -t: List of column types where s=string, i=integer, b=bool, f=float, d=double\n"
     " -s: Skip first N rows (can be used to skip headers)\n"
     " -q: Quiet, only print upon errors\n"
@@ -119,6 +122,10 @@ int main(int argc, char* argv[])
             import_rows_flag = atoi(&argv[a][3]);
             abort2(import_rows_flag == 0, "Invalid value for -n flag");
         }
+        else if (strncmp(argv[a], "-j", 2) == 0) {
+            threads_flag = atoi(&argv[a][3]);
+            abort2(threads_flag == 0, "Invalid value for -j flag");
+        }
         else if (strncmp(argv[a], "-s", 2) == 0) {
             skip_rows_flag = atoi(&argv[a][3]);
             abort2(skip_rows_flag == 0, "Invalid value for -s flag");
@@ -188,6 +195,9 @@ int main(int argc, char* argv[])
     importer.Quiet = quiet_flag;
     importer.Separator = ',';
     importer.Empty_as_string = empty_as_string_flag;
+    importer.Threads = threads_flag;
+
+    auto start = std::chrono::steady_clock::now();
 
     try {
         if (scheme.size() > 0) {
@@ -210,10 +220,22 @@ int main(int argc, char* argv[])
         exit(-1);
     }
 
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long input_size = ftell(in_file);
+
     group.write(path);
 
-    if (!quiet_flag)
-        std::cout << "Imported " << imported_rows << " rows into table named '" << tablename << "'\n";
+    if (!quiet_flag) {
+        std::cout << "Imported " << imported_rows << " rows into table named '" << tablename << "' in " << seconds
+                  << " seconds";
+        if (seconds > 0) {
+            std::cout << " (" << imported_rows / seconds << " rows/s";
+            if (input_size > 0)
+                std::cout << ", " << input_size / seconds / (1024 * 1024) << " MB/s";
+            std::cout << ")";
+        }
+        std::cout << "\n";
+    }
 
     return 0;
 }
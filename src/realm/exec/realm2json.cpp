@@ -1,5 +1,9 @@
 #include <realm.hpp>
+#include <atomic>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <thread>
 
 const char* legend =
     "Simple tool to output the JSON representation of a Realm:\n"
@@ -13,6 +17,10 @@ const char* legend =
     "      0 - JSON Object\n"
     "      1 - MongoDB Extended JSON (XJSON)\n"
     "      2 - An extension of XJSON that adds wrappers for embdded objects, links, dictionaries, etc\n"
+    " --output-dir: Write each table to its own file '<table name>.json' in the given directory\n"
+    " --threads: How many tables to export concurrently with --output-dir. Defaults to 1.\n"
+    " --ndjson: Output one object per line instead of a JSON array (newline-delimited JSON). Requires\n"
+    "      --output-dir or --filter, and the files are then named '<table name>.ndjson'.\n"
     "\n";
 
 template <typename FormatStr>
@@ -37,11 +45,86 @@ void abort_if(bool cond, FormatStr fmt, Args... args)
     std::exit(1);
 }
 
+// Output is written in large chunks rather than whenever the stream's default
+// buffer fills up.
+constexpr std::streamsize output_buffer_size = 1024 * 1024;
+
+void objects_to_ndjson(std::ostream& out, const realm::Table& table, size_t link_depth,
+                       const std::map<std::string, std::string>& renames, realm::JSONOutputMode output_mode)
+{
+    for (auto& obj : table) {
+        obj.to_json(out, link_depth, renames, output_mode);
+        out << "\n";
+    }
+}
+
+void objects_to_ndjson(std::ostream& out, const realm::TableView& results, size_t link_depth,
+                       const std::map<std::string, std::string>& renames, realm::JSONOutputMode output_mode)
+{
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results.get_key(i)) {
+            results.get_object(i).to_json(out, link_depth, renames, output_mode);
+            out << "\n";
+        }
+    }
+}
+
+// Writes every table that is not embedded to its own file in `dir`. The
+// tables are divided between `num_threads` threads, each of which reads
+// through a group of its own, as obtained from `open_group`.
+void tables_to_dir(const std::function<std::shared_ptr<const realm::Group>()>& open_group, const std::string& dir,
+                   size_t num_threads, size_t link_depth, const std::map<std::string, std::string>& renames,
+                   realm::JSONOutputMode output_mode, bool ndjson)
+{
+    std::vector<std::string> table_names;
+    {
+        auto group = open_group();
+        for (auto key : group->get_table_keys()) {
+            if (!group->get_table(key)->is_embedded())
+                table_names.push_back(group->get_table_name(key));
+        }
+    }
+
+    std::atomic<size_t> next_table{0};
+    auto worker = [&] {
+        auto group = open_group();
+        std::vector<char> buffer(output_buffer_size);
+        for (size_t i = next_table++; i < table_names.size(); i = next_table++) {
+            const std::string& name = table_names[i];
+            std::string file_name = realm::util::File::resolve(name + (ndjson ? ".ndjson" : ".json"), dir);
+            std::ofstream out;
+            out.rdbuf()->pubsetbuf(buffer.data(), output_buffer_size);
+            out.open(file_name, std::ios::out | std::ios::trunc);
+            abort_if(!out, "Failed to open '%s' for writing\n", file_name.c_str());
+            auto table = group->get_table(name);
+            if (ndjson) {
+                objects_to_ndjson(out, *table, link_depth, renames, output_mode);
+            }
+            else {
+                table->to_json(out, link_depth, renames, output_mode);
+                out << "\n";
+            }
+            out.close();
+            abort_if(!out, "Failed to write '%s'\n", file_name.c_str());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+
 int main(int argc, char const* argv[])
 {
     std::map<std::string, std::string> renames;
     size_t link_depth = 0;
     bool output_schema = false;
+    bool ndjson = false;
+    size_t num_threads = 1;
+    std::string output_dir;
     realm::JSONOutputMode output_mode = realm::output_mode_json;
 
     abort_if(argc <= 1, legend);
@@ -82,10 +165,26 @@ int main(int argc, char const* argv[])
             table_filter = filter_val.substr(0, sep);
             query_filter = filter_val.substr(sep + 1);
         }
+        else if (arg == "--output-dir") {
+            output_dir = argv[++idx];
+        }
+        else if (arg == "--threads") {
+            auto num_threads_val = strtol(argv[++idx], nullptr, 0);
+            abort_if(num_threads_val < 1, "Received invalid value for threads option: %d", num_threads_val);
+            num_threads = size_t(num_threads_val);
+        }
+        else if (arg == "--ndjson") {
+            ndjson = true;
+        }
         else {
             abort_if(true, "Received unknown option '%s' - please see description below\n\n%s", argv[idx], legend);
         }
     }
+    abort_if(ndjson && output_dir.empty() && table_filter.empty(), "--ndjson requires --output-dir or --filter\n");
+
+    static char cout_buffer[output_buffer_size];
+    std::ios::sync_with_stdio(false);
+    std::cout.rdbuf()->pubsetbuf(cout_buffer, output_buffer_size);
 
     std::string path = argv[argc - 1];
 
@@ -101,9 +200,20 @@ int main(int argc, char const* argv[])
             abort_if(!target, "table not found: '%s'", table_filter.c_str());
             realm::Query q = target->query(query_filter);
             realm::TableView results = q.find_all();
-            std::cout << realm::util::format("filter '%1' found %2 results", query_filter, results.size())
-                      << std::endl;
-            results.to_json(std::cout, link_depth, renames, output_mode);
+            if (ndjson) {
+                objects_to_ndjson(std::cout, results, link_depth, renames, output_mode);
+            }
+            else {
+                std::cout << realm::util::format("filter '%1' found %2 results", query_filter, results.size())
+                          << std::endl;
+                results.to_json(std::cout, link_depth, renames, output_mode);
+            }
+        }
+        else if (!output_dir.empty()) {
+            auto open_group = [&] {
+                return std::make_shared<const realm::Group>(path);
+            };
+            tables_to_dir(open_group, output_dir, num_threads, link_depth, renames, output_mode, ndjson);
         }
         else {
             g.to_json(std::cout, link_depth, &renames, output_mode);
@@ -120,9 +230,18 @@ int main(int argc, char const* argv[])
 
         std::cerr << "File upgraded to latest version: " << path << std::endl;
 
-        auto tr = db->start_read();
-        tr->to_json(std::cout, link_depth, &renames, output_mode);
+        if (!output_dir.empty()) {
+            auto open_group = [&] {
+                return std::shared_ptr<const realm::Group>(db->start_frozen());
+            };
+            tables_to_dir(open_group, output_dir, num_threads, link_depth, renames, output_mode, ndjson);
+        }
+        else {
+            auto tr = db->start_read();
+            tr->to_json(std::cout, link_depth, &renames, output_mode);
+        }
     }
+    std::cout.flush();
 
     return 0;
 }
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <iostream>
-#include <fstream>
+#include <cstdlib>
 #include <cstring>
 #include <realm/util/file.hpp>
 #include <realm/util/aes_cryptor.hpp>
 #include <realm/util/encrypted_file_mapping.hpp>
+#include <realm/util/thread_pool.hpp>
 #include "hex_util.hpp"
 
 using namespace realm;
@@ -16,6 +18,7 @@ int main(int argc, const char* argv[])
         const uint8_t* key_ptr = nullptr;
         char key[64];
         std::string outfilename = "out.realm";
+        size_t num_threads = 0;
         for (int curr_arg = 1; curr_arg < argc; curr_arg++) {
             if (strcmp(argv[curr_arg], "--key") == 0) {
                 hex_to_bin(argv[curr_arg + 1], key);
@@ -26,28 +29,47 @@ int main(int argc, const char* argv[])
                 outfilename = argv[curr_arg + 1];
                 curr_arg++;
             }
+            else if (strcmp(argv[curr_arg], "--threads") == 0) {
+                num_threads = size_t(atoi(argv[curr_arg + 1]));
+                curr_arg++;
+            }
             else {
                 const std::string path = argv[curr_arg];
                 std::cout << "Decrypting " << path << " into " << outfilename << std::endl;
-                std::ofstream out(outfilename);
-                util::File file;
-                file.open(path);
-                file.set_encryption_key(key);
-                size_t size = file.get_size();
-                size_t pos = 0;
-                util::AESCryptor cryptor(key_ptr);
-                cryptor.set_file_size(size);
-                while (pos < size) {
-                    char buf[block_size];
-                    cryptor.try_read_block(file.get_descriptor(), pos, buf);
-                    out.write(buf, block_size);
-                    pos += block_size;
+                size_t size;
+                {
+                    util::File file(path);
+                    file.set_encryption_key(key);
+                    size = size_t(file.get_size());
+                    util::File out(outfilename, util::File::mode_Write);
+                    out.resize(size);
                 }
+
+                // Each thread decrypts a range of blocks with its own cryptor
+                // and descriptors, as these keep a position
+                auto& pool = util::ThreadPool::get_default();
+                size_t num_blocks = (size + block_size - 1) / block_size;
+                size_t num_tasks = num_threads ? num_threads : pool.get_thread_count();
+                num_tasks = std::max<size_t>(1, std::min(num_tasks, num_blocks));
+                pool.run_parallel(num_tasks, [&](size_t task) {
+                    util::File in(path);
+                    util::File out(outfilename, util::File::mode_Update);
+                    util::AESCryptor cryptor(key_ptr);
+                    cryptor.set_file_size(size);
+                    size_t end = num_blocks * (task + 1) / num_tasks;
+                    for (size_t block = num_blocks * task / num_tasks; block < end; ++block) {
+                        char buf[block_size];
+                        cryptor.try_read_block(in.get_descriptor(), off_t(block * block_size), buf);
+                        out.seek(block * block_size);
+                        out.write(buf, block_size);
+                    }
+                });
             }
         }
     }
     else {
-        std::cout << "Usage: realm-decrypt --key crypt_key [--out <outfilename>] <realmfile>" << std::endl;
+        std::cout << "Usage: realm-decrypt --key crypt_key [--out <outfilename>] [--threads <count>] <realmfile>"
+                  << std::endl;
     }
 
     return 0;
@@ -1,6 +1,8 @@
 #include <iostream>
+#include <cstdlib>
 #include <cstring>
 #include <realm.hpp>
+#include <realm/util/aes_cryptor.hpp>
 #include "hex_util.hpp"
 
 using namespace realm;
@@ -12,6 +14,9 @@ int main(int argc, const char* argv[])
     if (argc > 1) {
         char* key_ptr = nullptr;
         char key[64];
+        char* old_key_ptr = nullptr;
+        char old_key[64];
+        size_t num_threads = 0;
         std::string outfilename = "out.realm";
         for (int curr_arg = 1; curr_arg < argc; curr_arg++) {
             if (strcmp(argv[curr_arg], "--key") == 0) {
@@ -19,10 +24,33 @@ int main(int argc, const char* argv[])
                 key_ptr = key;
                 curr_arg++;
             }
+            else if (strcmp(argv[curr_arg], "--old-key") == 0) {
+                hex_to_bin(argv[curr_arg + 1], old_key);
+                old_key_ptr = old_key;
+                curr_arg++;
+            }
+            else if (strcmp(argv[curr_arg], "--threads") == 0) {
+                num_threads = size_t(atoi(argv[curr_arg + 1]));
+                curr_arg++;
+            }
             else if (strcmp(argv[curr_arg], "--out") == 0) {
                 outfilename = argv[curr_arg + 1];
                 curr_arg++;
             }
+#if REALM_ENABLE_ENCRYPTION
+            else if (old_key_ptr && key_ptr) {
+                // Re-encrypt the file in place, without going through a Group
+                const std::string path = argv[curr_arg];
+                std::cout << "Changing the encryption key of " << path << std::endl;
+                bool locked = DB::call_with_lock(path, [&](const std::string& realm_path) {
+                    util::rotate_encryption_key(realm_path, old_key_ptr, key_ptr, num_threads);
+                });
+                if (!locked) {
+                    std::cerr << path << " is in use" << std::endl;
+                    return 1;
+                }
+            }
+#endif
             else {
                 const std::string path = argv[curr_arg];
                 std::cout << "Encrypting " << path << " into " << outfilename << std::endl;
@@ -33,7 +61,9 @@ int main(int argc, const char* argv[])
         }
     }
     else {
-        std::cout << "Usage: realm-encrypt --key crypt_key [--out <outfilename>] <realmfile>" << std::endl;
+        std::cout << "Usage: realm-encrypt --key crypt_key [--out <outfilename>] <realmfile>\n"
+                  << "       realm-encrypt --key crypt_key --old-key old_crypt_key [--threads <count>] <realmfile>"
+                  << std::endl;
     }
 
     return 0;
@@ -0,0 +1,514 @@
+#include <realm.hpp>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+const char* legend =
+    "Generates typed C++ accessors for the classes of a Realm:\n"
+    "  realm-schemagen [--namespace NAME] [--output FILE] [--no-object-schema] <.realm file>\n"
+    "\n"
+    "Every class gets an accessor class with a getter and a setter per property. The column keys\n"
+    "are resolved and checked against the schema once per table by the generated bind() function,\n"
+    "after which the getters read the values without looking up or checking the columns again.\n"
+    "\n"
+    "Options:\n"
+    " --namespace: The namespace of the generated code. Defaults to 'schema'.\n"
+    " --output: Write the generated header to the given file instead of to stdout\n"
+    " --no-object-schema: Do not generate the object_schema() and schema() functions, which\n"
+    "      return the schema as an ObjectSchema for use with the object store\n"
+    "\n";
+
+template <typename FormatStr>
+void abort_if(bool cond, FormatStr fmt)
+{
+    if (!cond) {
+        return;
+    }
+
+    fputs(fmt, stderr);
+    std::exit(1);
+}
+
+template <typename FormatStr, typename... Args>
+void abort_if(bool cond, FormatStr fmt, Args... args)
+{
+    if (!cond) {
+        return;
+    }
+
+    fprintf(stderr, fmt, args...);
+    std::exit(1);
+}
+
+namespace {
+
+constexpr const char* class_prefix = "class_";
+
+struct Column {
+    std::string name;       // As in the table
+    std::string identifier; // Of the getter and of the key in Keys
+    realm::ColKey key;
+    std::string target;          // Class name of the link target, if a link
+    bool target_embedded = false;
+    bool is_primary = false;
+    bool is_indexed = false;
+};
+
+struct Class {
+    std::string name; // Without the class prefix
+    std::string identifier;
+    realm::Table::Type type;
+    std::vector<Column> columns;
+};
+
+// Names which would clash with the members of the generated classes
+const std::set<std::string> reserved_names = {
+    "alignas",  "alignof",  "and",      "asm",        "auto",      "bind",          "bool",     "break",
+    "case",     "catch",    "char",     "class",      "class_name", "const",        "constexpr", "continue",
+    "default",  "delete",   "do",       "double",     "else",      "enum",          "explicit", "export",
+    "extern",   "false",    "float",    "for",        "friend",    "goto",          "if",       "inline",
+    "int",      "long",     "mutable",  "namespace",  "new",       "noexcept",      "not",      "nullptr",
+    "obj",      "operator", "or",       "private",    "protected", "object_schema", "public",   "register",
+    "return",   "short",    "signed",   "sizeof",     "static",    "struct",        "switch",   "table_name",
+    "template", "this",     "throw",    "true",       "try",       "typedef",       "typename", "union",
+    "unsigned", "using",    "virtual",  "void",       "volatile",  "while",         "xor",      "Keys",
+};
+
+std::string to_identifier(std::string_view name)
+{
+    std::string id;
+    for (char c : name)
+        id += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    if (id.empty() || std::isdigit(static_cast<unsigned char>(id[0])))
+        id.insert(0, "_");
+    if (reserved_names.count(id))
+        id += '_';
+    return id;
+}
+
+std::string to_class_name(realm::StringData table_name)
+{
+    return std::string(table_name.substr(strlen(class_prefix)));
+}
+
+// Escapes a name for use in a string literal
+std::string quoted(const std::string& str)
+{
+    std::string out = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out + '"';
+}
+
+struct TypeNames {
+    const char* column_type;
+    const char* property_type;
+};
+
+// The names to use in the generated code for the types of a column
+TypeNames type_names(realm::ColumnType type)
+{
+    switch (type) {
+        case realm::col_type_Int:
+            return {"realm::col_type_Int", "Int"};
+        case realm::col_type_Bool:
+            return {"realm::col_type_Bool", "Bool"};
+        case realm::col_type_String:
+            return {"realm::col_type_String", "String"};
+        case realm::col_type_Binary:
+            return {"realm::col_type_Binary", "Data"};
+        case realm::col_type_Mixed:
+            return {"realm::col_type_Mixed", "Mixed"};
+        case realm::col_type_Timestamp:
+            return {"realm::col_type_Timestamp", "Date"};
+        case realm::col_type_Float:
+            return {"realm::col_type_Float", "Float"};
+        case realm::col_type_Double:
+            return {"realm::col_type_Double", "Double"};
+        case realm::col_type_Decimal:
+            return {"realm::col_type_Decimal", "Decimal"};
+        case realm::col_type_Link:
+            return {"realm::col_type_Link", "Object"};
+        case realm::col_type_LinkList:
+            return {"realm::col_type_LinkList", "Object"};
+        case realm::col_type_ObjectId:
+            return {"realm::col_type_ObjectId", "ObjectId"};
+        case realm::col_type_TypedLink:
+            return {"realm::col_type_TypedLink", "Object"};
+        case realm::col_type_UUID:
+            return {"realm::col_type_UUID", "UUID"};
+        default:
+            return {nullptr, nullptr};
+    }
+}
+
+// The type of the values, or of the elements of a collection
+std::string value_type(realm::ColKey col)
+{
+    bool nullable = col.is_nullable();
+    auto optional = [&](const char* type) {
+        return nullable ? std::string("realm::util::Optional<") + type + ">" : std::string(type);
+    };
+    switch (col.get_type()) {
+        case realm::col_type_Int:
+            return optional("int64_t");
+        case realm::col_type_Bool:
+            return optional("bool");
+        case realm::col_type_Float:
+            return optional("float");
+        case realm::col_type_Double:
+            return optional("double");
+        case realm::col_type_ObjectId:
+            return optional("realm::ObjectId");
+        case realm::col_type_UUID:
+            return optional("realm::UUID");
+        case realm::col_type_String:
+            return "realm::StringData";
+        case realm::col_type_Binary:
+            return "realm::BinaryData";
+        case realm::col_type_Timestamp:
+            return "realm::Timestamp";
+        case realm::col_type_Decimal:
+            return "realm::Decimal128";
+        case realm::col_type_Mixed:
+            return "realm::Mixed";
+        case realm::col_type_Link:
+        case realm::col_type_LinkList:
+            return "realm::ObjKey";
+        case realm::col_type_TypedLink:
+            return "realm::ObjLink";
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+// Same as ObjectSchema::from_core_type()
+std::string property_type(realm::ColKey col)
+{
+    std::string str = std::string("realm::PropertyType::") + type_names(col.get_type()).property_type;
+    if (col.is_nullable())
+        str += " | realm::PropertyType::Nullable";
+    if (col.is_list())
+        str += " | realm::PropertyType::Array";
+    else if (col.is_set())
+        str += " | realm::PropertyType::Set";
+    else if (col.is_dictionary())
+        str += " | realm::PropertyType::Dictionary";
+    return str;
+}
+
+std::vector<Class> read_classes(const realm::Group& group)
+{
+    std::vector<Class> classes;
+    for (auto table_key : group.get_table_keys()) {
+        auto table = group.get_table(table_key);
+        if (!table->get_name().begins_with(class_prefix))
+            continue;
+
+        Class cls;
+        cls.name = to_class_name(table->get_name());
+        cls.identifier = to_identifier(cls.name);
+        cls.type = table->get_table_type();
+        realm::ColKey pk_col = table->get_primary_key_column();
+        for (auto col : table->get_column_keys()) {
+            if (col.get_type() == realm::col_type_BackLink)
+                continue;
+            abort_if(!type_names(col.get_type()).column_type, "Unsupported type of column '%s.%s'\n", cls.name.c_str(),
+                     table->get_column_name(col).data());
+            Column column;
+            column.name = table->get_column_name(col);
+            column.identifier = to_identifier(column.name);
+            column.key = col;
+            column.is_primary = col == pk_col;
+            column.is_indexed = table->has_search_index(col) || column.is_primary;
+            if (col.get_type() == realm::col_type_Link || col.get_type() == realm::col_type_LinkList) {
+                auto target = table->get_link_target(col);
+                column.target = to_class_name(target->get_name());
+                column.target_embedded = target->is_embedded();
+            }
+            cls.columns.push_back(std::move(column));
+        }
+        classes.push_back(std::move(cls));
+    }
+    return classes;
+}
+
+void generate_accessors(std::ostream& out, const Column& column)
+{
+    auto col = column.key;
+    std::string type = value_type(col);
+    std::string key = "m_keys->" + column.identifier;
+
+    if (col.is_collection()) {
+        std::string collection_type, getter;
+        bool is_link = col.get_type() == realm::col_type_Link || col.get_type() == realm::col_type_LinkList;
+        if (col.is_dictionary()) {
+            collection_type = "realm::Dictionary";
+            getter = "get_dictionary(";
+        }
+        else if (col.is_list()) {
+            collection_type = is_link ? "realm::LnkLst" : "realm::Lst<" + type + ">";
+            getter = is_link ? "get_linklist(" : "get_list<" + type + ">(";
+        }
+        else {
+            collection_type = is_link ? "realm::LnkSet" : "realm::Set<" + type + ">";
+            getter = is_link ? "get_linkset(" : "get_set<" + type + ">(";
+        }
+        out << "    " << collection_type << " " << column.identifier << "() const\n"
+            << "    {\n"
+            << "        return m_obj." << getter << key << ");\n"
+            << "    }\n";
+        return;
+    }
+
+    out << "    " << type << " " << column.identifier << "() const\n"
+        << "    {\n"
+        << "        return m_obj.get_unchecked<" << type << ">(" << key << ");\n"
+        << "    }\n";
+
+    if (column.target_embedded) {
+        // Embedded objects can only be created in place
+        out << "    realm::Obj create_" << column.identifier << "()\n"
+            << "    {\n"
+            << "        return m_obj.create_and_set_linked_object(" << key << ");\n"
+            << "    }\n";
+    }
+    else if (col.is_nullable() && type.find("realm::util::Optional<") == 0) {
+        out << "    void set_" << column.identifier << "(" << type << " value)\n"
+            << "    {\n"
+            << "        if (value)\n"
+            << "            m_obj.set(" << key << ", *value);\n"
+            << "        else\n"
+            << "            m_obj.set_null(" << key << ");\n"
+            << "    }\n";
+    }
+    else {
+        out << "    void set_" << column.identifier << "(" << type << " value)\n"
+            << "    {\n"
+            << "        m_obj.set(" << key << ", value);\n"
+            << "    }\n";
+    }
+}
+
+void generate_object_schema(std::ostream& out, const Class& cls)
+{
+    const char* object_type = "TopLevel";
+    if (cls.type == realm::Table::Type::Embedded)
+        object_type = "Embedded";
+    else if (cls.type == realm::Table::Type::TopLevelAsymmetric)
+        object_type = "TopLevelAsymmetric";
+
+    out << "    static realm::ObjectSchema object_schema()\n"
+        << "    {\n"
+        << "        return realm::ObjectSchema(class_name, realm::ObjectSchema::ObjectType::" << object_type
+        << ", {\n";
+    for (auto& column : cls.columns) {
+        out << "            realm::Property(" << quoted(column.name) << ", " << property_type(column.key) << ", ";
+        if (!column.target.empty()) {
+            out << quoted(column.target);
+        }
+        else {
+            out << "realm::Property::IsPrimary{" << (column.is_primary ? "true" : "false")
+                << "}, realm::Property::IsIndexed{" << (column.is_indexed ? "true" : "false") << "}";
+        }
+        out << "),\n";
+    }
+    out << "        });\n"
+        << "    }\n";
+}
+
+void generate_class(std::ostream& out, const Class& cls, bool object_schema)
+{
+    out << "/// Accessors for the objects of class '" << cls.name << "'\n"
+        << "class " << cls.identifier << " {\n"
+        << "public:\n"
+        << "    static constexpr const char* class_name = " << quoted(cls.name) << ";\n"
+        << "    static constexpr const char* table_name = " << quoted(class_prefix + cls.name) << ";\n"
+        << "\n"
+        << "    struct Keys {\n";
+    for (auto& column : cls.columns)
+        out << "        realm::ColKey " << column.identifier << ";\n";
+    out << "    };\n"
+        << "\n"
+        << "    /// Resolves the column keys of `table`, and checks that its columns are the\n"
+        << "    /// ones the accessors were generated for. Throws std::runtime_error if not.\n"
+        << "    /// The keys must be bound again after the schema of the table has changed.\n"
+        << "    static Keys bind(const realm::Table& table)\n"
+        << "    {\n"
+        << "        if (table.get_name() != table_name)\n"
+        << "            throw std::runtime_error(realm::util::format(\"Table '%1' is not '%2'\", table.get_name(), "
+           "table_name));\n"
+        << "        Keys keys;\n";
+    for (auto& column : cls.columns) {
+        auto col = column.key;
+        out << "        keys." << column.identifier << " = _impl::bind_column(table, " << quoted(column.name) << ", "
+            << type_names(col.get_type()).column_type << ", " << (col.is_nullable() ? "true" : "false") << ", "
+            << (col.is_list() ? "true" : "false") << ", " << (col.is_set() ? "true" : "false") << ", "
+            << (col.is_dictionary() ? "true" : "false");
+        if (!column.target.empty())
+            out << ", " << quoted(class_prefix + column.target);
+        out << ");\n";
+    }
+    out << "        return keys;\n"
+        << "    }\n"
+        << "\n"
+        << "    /// `keys` must be bound to the table of `obj`, and must outlive the accessor.\n"
+        << "    " << cls.identifier << "(realm::Obj obj, const Keys& keys)\n"
+        << "        : m_obj(std::move(obj))\n"
+        << "        , m_keys(&keys)\n"
+        << "    {\n"
+        << "    }\n"
+        << "\n"
+        << "    const realm::Obj& obj() const noexcept\n"
+        << "    {\n"
+        << "        return m_obj;\n"
+        << "    }\n"
+        << "\n";
+    for (auto& column : cls.columns)
+        generate_accessors(out, column);
+    if (object_schema) {
+        out << "\n";
+        generate_object_schema(out, cls);
+    }
+    out << "\n"
+        << "private:\n"
+        << "    realm::Obj m_obj;\n"
+        << "    const Keys* m_keys;\n"
+        << "};\n"
+        << "\n";
+}
+
+void generate(std::ostream& out, const std::vector<Class>& classes, const std::string& ns, bool object_schema,
+              const std::string& source)
+{
+    std::string guard = "REALM_SCHEMAGEN_";
+    for (char c : ns)
+        guard += std::isalnum(static_cast<unsigned char>(c)) ? char(std::toupper(c)) : '_';
+    guard += "_HPP";
+
+    out << "// Generated by realm-schemagen from '" << source << "'. Do not edit.\n"
+        << "\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n"
+        << "\n"
+        << "#include <realm/dictionary.hpp>\n"
+        << "#include <realm/list.hpp>\n"
+        << "#include <realm/obj.hpp>\n"
+        << "#include <realm/set.hpp>\n"
+        << "#include <realm/table.hpp>\n"
+        << "#include <realm/util/format.hpp>\n";
+    if (object_schema) {
+        out << "#include <realm/object-store/object_schema.hpp>\n"
+            << "#include <realm/object-store/property.hpp>\n"
+            << "#include <realm/object-store/schema.hpp>\n";
+    }
+    out << "\n"
+        << "#include <stdexcept>\n"
+        << "\n"
+        << "namespace " << ns << " {\n"
+        << "\n"
+        << "namespace _impl {\n"
+        << "inline realm::ColKey bind_column(const realm::Table& table, const char* name, realm::ColumnType type,\n"
+        << "                                 bool nullable, bool list, bool set, bool dictionary,\n"
+        << "                                 const char* target_table = nullptr)\n"
+        << "{\n"
+        << "    realm::ColKey col = table.get_column_key(name);\n"
+        << "    bool matches = col && col.get_type() == type && col.is_nullable() == nullable &&\n"
+        << "                   col.is_list() == list && col.is_set() == set && col.is_dictionary() == dictionary;\n"
+        << "    if (matches && target_table)\n"
+        << "        matches = table.get_link_target(col)->get_name() == target_table;\n"
+        << "    if (!matches)\n"
+        << "        throw std::runtime_error(\n"
+        << "            realm::util::format(\"Property '%1.%2' does not match the generated schema\", "
+           "table.get_name(), name));\n"
+        << "    return col;\n"
+        << "}\n"
+        << "} // namespace _impl\n"
+        << "\n";
+
+    for (auto& cls : classes)
+        generate_class(out, cls, object_schema);
+
+    if (object_schema) {
+        out << "inline realm::Schema schema()\n"
+            << "{\n"
+            << "    return realm::Schema{\n";
+        for (auto& cls : classes)
+            out << "        " << cls.identifier << "::object_schema(),\n";
+        out << "    };\n"
+            << "}\n"
+            << "\n";
+    }
+
+    out << "} // namespace " << ns << "\n"
+        << "\n"
+        << "#endif // " << guard << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char const* argv[])
+{
+    std::string ns = "schema";
+    std::string output;
+    bool object_schema = true;
+
+    abort_if(argc <= 1, legend);
+    // Parse from 1'st argument until before source args
+    for (int idx = 1; idx < argc - 1; ++idx) {
+        realm::StringData arg(argv[idx]);
+        if (arg == "--namespace" && idx + 1 < argc - 1) {
+            ns = argv[++idx];
+        }
+        else if (arg == "--output" && idx + 1 < argc - 1) {
+            output = argv[++idx];
+        }
+        else if (arg == "--no-object-schema") {
+            object_schema = false;
+        }
+        else {
+            abort_if(true, "Received unknown option '%s' - please see description below\n\n%s", argv[idx], legend);
+        }
+    }
+
+    std::string path = argv[argc - 1];
+    std::vector<Class> classes;
+    try {
+        // First we try to open in read_only mode. In this way we can also open
+        // realms with a client history
+        realm::Group g(path);
+        classes = read_classes(g);
+    }
+    catch (const realm::FileFormatUpgradeRequired&) {
+        // In realm history
+        // Last chance - this one must succeed
+        auto hist = realm::make_in_realm_history();
+        realm::DBOptions options;
+        options.allow_file_format_upgrade = true;
+
+        auto db = realm::DB::create(*hist, path, options);
+
+        std::cerr << "File upgraded to latest version: " << path << std::endl;
+
+        auto tr = db->start_read();
+        classes = read_classes(*tr);
+    }
+
+    if (output.empty()) {
+        generate(std::cout, classes, ns, object_schema, path);
+        std::cout.flush();
+    }
+    else {
+        std::ofstream out(output, std::ios::out | std::ios::trunc);
+        abort_if(!out, "Failed to open '%s' for writing\n", output.c_str());
+        generate(out, classes, ns, object_schema, path);
+        out.close();
+        abort_if(!out, "Failed to write '%s'\n", output.c_str());
+    }
+
+    return 0;
+}
@@ -10,7 +10,8 @@
  * found in the table. The user data found in the tables will not be interpreted.
  *
  * Generally all references will be checked in the sense that they should point to something that has
- * a valid header, meaning that the header must have a valid signature. Also, references that point
+ * a valid header, meaning that the header must have a valid signature, or match the checksum it holds
+ * instead if the file was written with array checksums. Also, references that point
  * to areas included in the free list will be considered invalid. References that are not valid
  * will not be followed. It is checked that an area is only referenced once.
  *
@@ -140,6 +141,13 @@ public:
     unsigned length() const
     {
         unsigned width_type = (unsigned(m_header[4]) & 0x18) >> 3;
+        if (width_type == 3) {
+            // Frame-of-reference encoded: 8 byte base followed by a plain array of offsets
+            const unsigned char* offsets = reinterpret_cast<const unsigned char*>(m_header) + 16;
+            unsigned offsets_width = (1 << (unsigned(offsets[4]) & 0x07)) >> 1;
+            unsigned offsets_size = (unsigned(offsets[5]) << 16) + (unsigned(offsets[6]) << 8) + offsets[7];
+            return 16 + calc_byte_size(0, offsets_size, offsets_width);
+        }
         return calc_byte_size(width_type, m_size, width());
     }
     uint64_t ref() const
@@ -520,9 +528,14 @@ void Node::init(realm::Allocator& alloc, uint64_t ref)
     m_ref = ref;
     m_header = alloc.translate(ref);
 
-    if (memcmp(m_header, &signature, 4)) {
+    bool valid = memcmp(m_header, &signature, 4) == 0;
+    if (!valid) {
+        size_t byte_size = realm::NodeHeader::get_byte_size_from_header(m_header);
+        valid = ref + byte_size <= current_logical_file_size &&
+                realm::NodeHeader::calc_checksum(m_header, byte_size) ==
+                    realm::NodeHeader::get_checksum_from_header(m_header);
     }
-    else {
+    if (valid) {
         unsigned char* u = reinterpret_cast<unsigned char*>(m_header);
         m_size = (u[5] << 16) + (u[6] << 8) + u[7];
         m_valid = true;
@@ -0,0 +1,86 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_GEOSPATIAL_HPP
+#define REALM_GEOSPATIAL_HPP
+
+#include <cmath>
+
+namespace realm {
+
+/// A point given by latitude and longitude in degrees
+struct GeoPoint {
+    double latitude = 0;
+    double longitude = 0;
+};
+
+/// The region between two corners. If the longitude of `lo` is greater than
+/// that of `hi` the box crosses the antimeridian.
+struct GeoBox {
+    GeoPoint lo;
+    GeoPoint hi;
+};
+
+/// The points within `radius_km` of `center`, measured along the surface of
+/// the earth
+struct GeoCircle {
+    GeoPoint center;
+    double radius_km = 0;
+
+    /// The smallest box holding the circle
+    GeoBox bounding_box() const noexcept;
+};
+
+constexpr double earth_radius_km = 6371.0088;
+
+/// Great circle distance in kilometers, computed with the haversine formula
+inline double geo_distance_km(const GeoPoint& a, const GeoPoint& b) noexcept
+{
+    constexpr double to_radians = 3.14159265358979323846 / 180;
+    double sin_dlat = std::sin((b.latitude - a.latitude) * to_radians / 2);
+    double sin_dlon = std::sin((b.longitude - a.longitude) * to_radians / 2);
+    double h = sin_dlat * sin_dlat +
+               std::cos(a.latitude * to_radians) * std::cos(b.latitude * to_radians) * sin_dlon * sin_dlon;
+    return 2 * earth_radius_km * std::asin(std::sqrt(std::fmin(h, 1.0)));
+}
+
+inline GeoBox GeoCircle::bounding_box() const noexcept
+{
+    constexpr double to_degrees = 180 / 3.14159265358979323846;
+    double angle = radius_km / earth_radius_km;
+    double dlat = angle * to_degrees;
+    GeoBox box{{center.latitude - dlat, -180}, {center.latitude + dlat, 180}};
+    if (box.lo.latitude <= -90 || box.hi.latitude >= 90 || angle >= 3.14159265358979323846 / 2) {
+        // Covers a pole, so all longitudes are within reach
+        box.lo.latitude = std::fmax(box.lo.latitude, -90);
+        box.hi.latitude = std::fmin(box.hi.latitude, 90);
+        return box;
+    }
+    double dlon = std::asin(std::sin(angle) / std::cos(center.latitude * (1 / to_degrees))) * to_degrees;
+    box.lo.longitude = center.longitude - dlon;
+    box.hi.longitude = center.longitude + dlon;
+    if (box.lo.longitude < -180)
+        box.lo.longitude += 360;
+    if (box.hi.longitude > 180)
+        box.hi.longitude -= 360;
+    return box;
+}
+
+} // namespace realm
+
+#endif // REALM_GEOSPATIAL_HPP
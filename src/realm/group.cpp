@@ -29,6 +29,7 @@
 #include <realm/util/memory_stream.hpp>
 #include <realm/util/miscellaneous.hpp>
 #include <realm/util/thread.hpp>
+#include <realm/util/thread_pool.hpp>
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/utilities.hpp>
 #include <realm/exceptions.hpp>
@@ -331,6 +332,10 @@ int Group::get_target_file_format_version_for_session(int current_file_format_ve
     // Please see Group::get_file_format_version() for information about the
     // individual file format versions.
 
+    // Files are never downgraded from the format allowing compact encodings
+    if (current_file_format_version == g_compact_file_format_version)
+        return current_file_format_version;
+
     if (requested_history_type == Replication::hist_None) {
         if (current_file_format_version == 22) {
             // We are able to open these file formats in RO mode
@@ -408,6 +413,7 @@ int Group::read_only_version_check(SlabAlloc& alloc, ref_type top_ref, const std
         case 20:
         case 21:
         case g_current_file_format_version:
+        case g_compact_file_format_version:
             file_format_ok = true;
             break;
     }
@@ -537,6 +543,7 @@ void Group::attach(ref_type top_ref, bool writable, bool create_group_when_missi
 
     m_tables.detach();
     m_table_names.detach();
+    m_table_name_lookup.reset();
     m_is_writable = writable;
 
     if (top_ref != 0) {
@@ -574,6 +581,7 @@ void Group::detach() noexcept
     m_table_accessors.clear();
 
     m_table_names.detach();
+    m_table_name_lookup.reset();
     m_tables.detach();
     m_top.detach();
 
@@ -631,6 +639,18 @@ void Group::detach_table_accessors() noexcept
 }
 
 
+size_t Group::release_memory() const
+{
+    size_t freed = 0;
+    std::lock_guard<std::mutex> lock(m_accessor_mutex);
+    for (auto& table_accessor : m_table_accessors) {
+        if (Table* t = table_accessor)
+            freed += t->release_caches();
+    }
+    return freed;
+}
+
+
 void Group::create_empty_group()
 {
     m_top.create(Array::type_HasRefs); // Throws
@@ -671,9 +691,7 @@ Table* Group::do_get_table(size_t table_ndx)
 
 Table* Group::do_get_table(StringData name)
 {
-    if (!m_table_names.is_attached())
-        return 0;
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         return 0;
 
@@ -733,6 +751,7 @@ Table* Group::do_add_table(StringData name, Table::Type table_type, bool do_repl
     rot = RefOrTagged::make_ref(ref);
     REALM_ASSERT(m_table_accessors.size() == m_tables.size());
 
+    m_table_name_lookup.reset();
     if (table_ndx == m_tables.size()) {
         m_tables.add(rot);
         m_table_names.add(name);
@@ -809,7 +828,7 @@ void Group::remove_table(StringData name)
 {
     if (REALM_UNLIKELY(!is_attached()))
         throw LogicError(LogicError::detached_accessor);
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         throw NoSuchTable();
     auto key = ndx2key(table_ndx);
@@ -875,6 +894,7 @@ void Group::remove_table(size_t table_ndx, TableKey key)
     // Remove table
     m_tables.set(table_ndx, rot);     // Throws
     m_table_names.set(table_ndx, {}); // Throws
+    m_table_name_lookup.reset();
     m_table_accessors[table_ndx] = nullptr;
     --m_num_tables;
 
@@ -889,7 +909,7 @@ void Group::rename_table(StringData name, StringData new_name, bool require_uniq
 {
     if (REALM_UNLIKELY(!is_attached()))
         throw LogicError(LogicError::detached_accessor);
-    size_t table_ndx = m_table_names.find_first(name);
+    size_t table_ndx = find_table_index(name);
     if (table_ndx == not_found)
         throw NoSuchTable();
     rename_table(ndx2key(table_ndx), new_name, require_unique_name); // Throws
@@ -907,6 +927,7 @@ void Group::rename_table(TableKey key, StringData new_name, bool require_unique_
         throw TableNameInUse();
     size_t table_ndx = key2ndx_checked(key);
     m_table_names.set(table_ndx, new_name);
+    m_table_name_lookup.reset();
     if (Replication* repl = *get_repl())
         repl->rename_class(key, new_name); // Throws
 }
@@ -978,9 +999,9 @@ auto Group::DefaultTableWriter::write_history(_impl::OutputStream& out) -> Histo
     return info;
 }
 
-void Group::write(std::ostream& out, bool pad) const
+void Group::write(std::ostream& out, bool pad, bool write_history) const
 {
-    DefaultTableWriter table_writer;
+    DefaultTableWriter table_writer(write_history);
     write(out, pad, 0, table_writer);
 }
 
@@ -1009,6 +1030,9 @@ void Group::write(File& file, const char* encryption_key, uint_fast64_t version_
 
     std::ostream out(&streambuf);
     out.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    // Every array is read once, so the decrypted pages of an encrypted file
+    // should be the first to be released again
+    util::SequentialScanHint scan_hint;
     write(out, encryption_key != 0, version_number, writer);
     int sync_status = streambuf.pubsync();
     REALM_ASSERT(sync_status == 0);
@@ -1176,6 +1200,7 @@ void Group::update_refs(ref_type top_ref) noexcept
 
     // Now we can update it's child arrays
     m_table_names.update_from_parent();
+    m_table_name_lookup.reset();
     m_tables.update_from_parent();
 
     // Update all attached table accessors.
@@ -1246,7 +1271,7 @@ void Group::to_json(std::ostream& out, size_t link_depth, std::map<std::string,
         renames = *opt_renames;
     }
 
-    out << "{" << std::endl;
+    out << "{\n";
 
     auto keys = get_table_keys();
     bool first = true;
@@ -1264,7 +1289,7 @@ void Group::to_json(std::ostream& out, size_t link_depth, std::map<std::string,
             out << "\"" << name << "\"";
             out << ":";
             table->to_json(out, link_depth, renames, output_mode);
-            out << std::endl;
+            out << "\n";
             first = false;
         }
     }
@@ -1336,6 +1361,194 @@ size_t Group::get_used_space() const noexcept
     return used_space;
 }
 
+StorageStats Group::get_storage_stats(size_t sample_interval) const
+{
+    StorageStats stats;
+    if (!m_top.is_attached())
+        return stats;
+    SlabAlloc& alloc = *const_cast<SlabAlloc*>(&m_alloc);
+
+    stats.file_size = size_t(m_top.get_as_ref_or_tagged(s_file_size_ndx).get_as_int());
+    stats.group_bytes = m_top.get_byte_size() + m_tables.get_byte_size();
+    for (size_t i = 0; i < m_top.size(); ++i) {
+        auto rot = m_top.get_as_ref_or_tagged(i);
+        // The tables themselves are accounted for below
+        if (!rot.is_ref() || !rot.get_as_ref() || i == s_table_refs_ndx)
+            continue;
+        size_t bytes = size_of_tree_from_ref(rot.get_as_ref(), alloc);
+        switch (i) {
+            case s_free_pos_ndx:
+            case s_free_size_ndx:
+            case s_free_version_ndx:
+                stats.free_list.bookkeeping_bytes += bytes;
+                break;
+            case s_hist_ref_ndx:
+                stats.history_bytes += bytes;
+                break;
+            default:
+                stats.group_bytes += bytes;
+                break;
+        }
+    }
+
+    if (m_top.size() > s_free_size_ndx) {
+        if (ref_type ref = m_top.get_as_ref(s_free_size_ndx)) {
+            Array lengths(alloc);
+            lengths.init_from_ref(ref);
+            stats.free_list.num_chunks = lengths.size();
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                size_t length = size_t(lengths.get(i));
+                stats.free_list.free_bytes += length;
+                stats.free_list.largest_chunk = std::max(stats.free_list.largest_chunk, length);
+            }
+        }
+    }
+
+    for (auto key : get_table_keys()) {
+        stats.tables.push_back(get_table(key)->get_storage_stats(sample_interval));
+        stats.is_estimate |= stats.tables.back().is_estimate;
+    }
+    return stats;
+}
+
+namespace {
+
+// Checks the arrays reachable from a ref, see Group::check_integrity()
+class IntegrityChecker {
+public:
+    IntegrityChecker(const SlabAlloc& alloc, ref_type ref_begin, const std::string& path, uint64_t sample_threshold,
+                     uint64_t seed) noexcept
+        : m_alloc(alloc)
+        , m_ref_begin(ref_begin)
+        , m_baseline(alloc.get_baseline())
+        , m_path(path)
+        , m_sample_threshold(sample_threshold)
+        , m_seed(seed)
+    {
+    }
+
+    size_t get_num_checksums() const noexcept
+    {
+        return m_num_checksums;
+    }
+
+    // Check the array at `ref`, and if it has refs, those it refers to
+    void check(ref_type ref, size_t depth)
+    {
+        // The trees of a file are far from this deep, but a damaged file may
+        // have refs forming a cycle
+        if (depth > max_depth)
+            fail(ref, "is nested too deeply");
+        const char* header = check_shallow(ref);
+        if (!NodeHeader::get_hasrefs_from_header(header))
+            return;
+        Array arr(const_cast<SlabAlloc&>(m_alloc));
+        arr.init_from_mem(MemRef(const_cast<char*>(header), ref, arr.get_alloc()));
+        for (size_t i = 0; i < arr.size(); ++i) {
+            int64_t value = arr.get(i);
+            if (value != 0 && (value & 1) == 0)
+                check(to_ref(value), depth + 1);
+        }
+    }
+
+    // Check the array at `ref`, but not those it refers to
+    const char* check_shallow(ref_type ref)
+    {
+        bool read_only = m_alloc.is_read_only(ref);
+        if (read_only && (ref % 8 != 0 || ref < m_ref_begin || ref + NodeHeader::header_size > m_baseline))
+            fail(ref, "lies outside of the file");
+        const char* header = m_alloc.translate(ref);
+        if (NodeHeader::get_hasrefs_from_header(header) &&
+            NodeHeader::get_wtype_from_header(header) != NodeHeader::wtype_Bits)
+            fail(ref, "has an invalid header");
+        if (!read_only)
+            return header;
+
+        size_t byte_size = NodeHeader::get_byte_size_from_header(header);
+        if (ref + byte_size > m_baseline)
+            fail(ref, "extends past the end of the file");
+        uint32_t checksum = NodeHeader::get_checksum_from_header(header);
+        if (checksum != NodeHeader::unchecked_signature && is_sampled(ref)) {
+            if (NodeHeader::calc_checksum(header, byte_size) != checksum)
+                fail(ref, "does not match its checksum");
+            ++m_num_checksums;
+        }
+        return header;
+    }
+
+private:
+    static constexpr size_t max_depth = 256;
+
+    const SlabAlloc& m_alloc;
+    const ref_type m_ref_begin;
+    const ref_type m_baseline;
+    const std::string& m_path;
+    const uint64_t m_sample_threshold;
+    const uint64_t m_seed;
+    size_t m_num_checksums = 0;
+
+    bool is_sampled(ref_type ref) const noexcept
+    {
+        if (m_sample_threshold == uint64_t(-1))
+            return true;
+        // The finalizer of splitmix64
+        uint64_t x = uint64_t(ref) ^ m_seed;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return (x ^ (x >> 31)) <= m_sample_threshold;
+    }
+
+    [[noreturn]] void fail(ref_type ref, const char* problem) const
+    {
+        throw InvalidDatabase(util::format("The array at ref %1 %2", ref, problem), m_path);
+    }
+};
+
+} // anonymous namespace
+
+size_t Group::check_integrity(double checksum_sample) const
+{
+    if (!m_top.is_attached())
+        return 0;
+
+    uint64_t sample_threshold = uint64_t(-1);
+    if (checksum_sample < 1)
+        sample_threshold = checksum_sample > 0 ? uint64_t(checksum_sample * 18446744073709551616.0) : 0;
+    uint64_t seed = uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string path = m_alloc.get_file_path_for_assertions();
+
+    // The first task checks the top array and all it refers to but the
+    // tables, and every other task one table
+    size_t num_tables = m_tables.size();
+    std::vector<size_t> num_checksums(num_tables + 1);
+    util::ThreadPool::get_default().run_parallel(num_tables + 1, [&](size_t ndx) {
+        IntegrityChecker checker(m_alloc, sizeof(SlabAlloc::Header), path, sample_threshold, seed);
+        if (ndx == 0) {
+            checker.check_shallow(m_top.get_ref());
+            for (size_t i = 0; i < m_top.size(); ++i) {
+                auto rot = m_top.get_as_ref_or_tagged(i);
+                if (!rot.is_ref() || !rot.get_as_ref())
+                    continue;
+                if (i == s_table_refs_ndx)
+                    checker.check_shallow(rot.get_as_ref());
+                else
+                    checker.check(rot.get_as_ref(), 1);
+            }
+        }
+        else {
+            auto rot = m_tables.get_as_ref_or_tagged(ndx - 1);
+            if (rot.is_ref() && rot.get_as_ref())
+                checker.check(rot.get_as_ref(), 2);
+        }
+        num_checksums[ndx] = checker.get_num_checksums();
+    });
+
+    size_t total = 0;
+    for (auto n : num_checksums)
+        total += n;
+    return total;
+}
+
 
 class Group::TransactAdvancer {
 public:
@@ -1382,6 +1595,11 @@ public:
         return true; // No-op
     }
 
+    bool modify_object_range(ColKey, ObjKey, size_t) noexcept
+    {
+        return true; // No-op
+    }
+
     bool list_set(size_t)
     {
         return true;
@@ -1415,6 +1633,11 @@ public:
         return true; // No-op
     }
 
+    bool set_compressed(ColKey, bool) noexcept
+    {
+        return true; // No-op
+    }
+
     bool set_link_type(ColKey) noexcept
     {
         return true; // No-op
@@ -1508,6 +1731,15 @@ void Group::refresh_dirty_accessors()
         m_table_accessors.resize(m_tables.size());
     }
 
+    // Any change to a table copies its top array, and the ref of the old one
+    // cannot have been reused while the version we come from is still locked.
+    // So a table whose top array has not moved is unchanged, and unless the
+    // file has been remapped since the accessors were last translated, its
+    // accessors can be kept as they are.
+    auto mapping_version = m_alloc.get_mapping_version();
+    bool same_mapping = (mapping_version == m_last_seen_mapping_version);
+    m_last_seen_mapping_version = mapping_version;
+
     // Update all attached table accessors.
     for (size_t i = 0; i < m_table_accessors.size(); ++i) {
         auto& table_accessor = m_table_accessors[i];
@@ -1518,6 +1750,8 @@ void Group::refresh_dirty_accessors()
             bool same_table = false;
             if (rot.is_ref()) {
                 auto ref = rot.get_as_ref();
+                if (same_mapping && ref == table_accessor->m_top.get_ref())
+                    continue;
                 TableKey new_key = Table::get_key_direct(m_alloc, ref);
                 if (new_key == table_accessor->get_key())
                     same_table = true;
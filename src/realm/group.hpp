@@ -333,7 +333,10 @@ public:
     ///
     /// \param pad If true, the file is padded to ensure the footer is aligned
     /// to the end of a page
-    void write(std::ostream& out, bool pad = false) const;
+    ///
+    /// \param write_history Indicates if you want the Sync History to be
+    /// written to the stream (only relevant for synchronized files).
+    void write(std::ostream& out, bool pad = false, bool write_history = true) const;
 
     /// Write this database to a new file. It is an error to specify a
     /// file that already exists. This is to protect against
@@ -509,6 +512,37 @@ public:
     /// identical, the numbers will of course be equal.
     size_t get_used_space() const noexcept;
 
+    /// Break the size of this snapshot down into tables, columns, search
+    /// indexes, history and free space, in a single traversal of the
+    /// snapshot. The result is like compute_aggregated_byte_size(), but the
+    /// free list is reported as the space it describes.
+    ///
+    /// Measuring every cluster of a large file takes time proportional to its
+    /// size. With a `sample_interval` above 1 only every `sample_interval`th
+    /// cluster of each table is measured, and the sizes of the columns are
+    /// extrapolated from those.
+    StorageStats get_storage_stats(size_t sample_interval = 1) const;
+
+    /// Check the structure of this snapshot, in release builds as well: every
+    /// array reachable from the top array must lie within the file, and must
+    /// match its checksum if it was written with one (see
+    /// DBOptions::enable_array_checksums). Throws InvalidDatabase describing
+    /// the first damaged array found. Returns the number of checksums
+    /// verified.
+    ///
+    /// The tables are checked in parallel on util::ThreadPool::get_default().
+    /// With a `checksum_sample` below 1, only about that fraction of the
+    /// arrays, chosen at random by every call, have their checksum verified,
+    /// which leaves the contents of the others unread. The structure is
+    /// always checked in full.
+    size_t check_integrity(double checksum_sample = 1) const;
+
+    /// Drop the caches kept by the accessors of the tables of this group,
+    /// which are rebuilt when next needed. Returns an estimate of the number
+    /// of bytes freed. See DB::release_memory() for the memory held on behalf
+    /// of the file itself.
+    size_t release_memory() const;
+
     /// check that an already attached realm file is valid for read only access.
     /// if not detach the file and throw a FileFormatUpgradeRequired.
     /// return the file format version.
@@ -598,6 +632,7 @@ private:
     Array m_top;
     Array m_tables;
     ArrayStringShort m_table_names;
+    ArrayStringShortLookup m_table_name_lookup;
     uint64_t m_last_seen_mapping_version = 0;
 
     typedef std::vector<Table*> TableAccessors;
@@ -784,6 +819,10 @@ private:
     ///  22 Object keys are no longer generated from primary key values. Search index
     ///     reintroduced.
     ///
+    ///  23 Same as 22, but arrays may be stored in encodings which have to be
+    ///     enabled through DBOptions, such as frame-of-reference encoded integer
+    ///     leaves. Files are only upgraded to it when one of them is enabled.
+    ///
     /// IMPORTANT: When introducing a new file format version, be sure to review
     /// the file validity checks in Group::open() and DB::do_open, the file
     /// format selection logic in
@@ -792,6 +831,8 @@ private:
     /// file formats and the version deletion list residing in "backup_restore.cpp"
 
     static constexpr int g_current_file_format_version = 22;
+    // The file format needed by the encodings enabled through DBOptions
+    static constexpr int g_compact_file_format_version = 23;
 
     int get_file_format_version() const noexcept;
     void set_file_format_version(int) noexcept;
@@ -825,7 +866,7 @@ private:
     std::map<TableRef, ColKey> get_primary_key_columns_from_pk_table(TableRef pk_table);
     void check_table_name_uniqueness(StringData name)
     {
-        if (m_table_names.find_first(name) != not_found)
+        if (find_table_index(name) != not_found)
             throw TableNameInUse();
     }
 
@@ -938,7 +979,7 @@ inline bool Group::has_table(StringData name) const noexcept
 inline size_t Group::find_table_index(StringData name) const noexcept
 {
     if (m_table_names.is_attached())
-        return m_table_names.find_first(name);
+        return m_table_name_lookup.find(m_table_names, name);
     return not_found;
 }
 
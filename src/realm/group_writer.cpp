@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <map>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -29,9 +30,11 @@
 #include <realm/disable_sync_to_disk.hpp>
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/impl/simulated_failure.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/metrics/metric_timer.hpp>
 #include <realm/util/miscellaneous.hpp>
 #include <realm/util/safe_int_ops.hpp>
+#include <realm/util/tracing.hpp>
 
 using namespace realm;
 using namespace realm::util;
@@ -163,6 +166,58 @@ void GroupWriter::MapWindow::encryption_write_barrier(void* start_addr, size_t s
 }
 
 
+struct GroupWriter::LiveFreeList {
+    Array positions;
+    Array lengths;
+    Array versions;
+    bool is_valid = false;
+
+    LiveFreeList(SlabAlloc& alloc, ref_type top_ref)
+        : positions(alloc)
+        , lengths(alloc)
+        , versions(alloc)
+    {
+        // The arrays of a live version are all in the part of the file
+        // which is mapped, but check anyway, as reading beyond it is fatal
+        size_t baseline = alloc.get_baseline();
+        if (top_ref == 0 || top_ref >= baseline)
+            return;
+        Array top(alloc);
+        top.init_from_ref(top_ref);
+        if (top.size() <= Group::s_free_version_ndx)
+            return;
+        ref_type positions_ref = top.get_as_ref(Group::s_free_pos_ndx);
+        ref_type lengths_ref = top.get_as_ref(Group::s_free_size_ndx);
+        ref_type versions_ref = top.get_as_ref(Group::s_free_version_ndx);
+        if (!positions_ref || !lengths_ref || !versions_ref || positions_ref >= baseline ||
+            lengths_ref >= baseline || versions_ref >= baseline)
+            return;
+        positions.init_from_ref(positions_ref);
+        lengths.init_from_ref(lengths_ref);
+        versions.init_from_ref(versions_ref);
+        is_valid = positions.size() == lengths.size() && positions.size() == versions.size();
+    }
+
+    // Find the entry covering a chunk. The free lists are written in order of
+    // position, which is relied on for the search, but not for correctness.
+    bool find(size_t ref, size_t size, uint64_t& version) const noexcept
+    {
+        if (!is_valid)
+            return false;
+        size_t ndx = positions.upper_bound_int(int64_t(ref));
+        if (ndx == 0)
+            return false;
+        --ndx;
+        size_t pos = size_t(positions.get(ndx));
+        size_t len = size_t(lengths.get(ndx));
+        if (pos > ref || pos + len < ref + size)
+            return false;
+        version = uint64_t(versions.get(ndx));
+        return true;
+    }
+};
+
+
 GroupWriter::GroupWriter(Group& group, Durability dura)
     : m_group(group)
     , m_alloc(group.m_alloc)
@@ -170,8 +225,10 @@ GroupWriter::GroupWriter(Group& group, Durability dura)
     , m_free_lengths(m_alloc)
     , m_free_versions(m_alloc)
     , m_durability(dura)
+    , m_use_write_batch(dura != Durability::MemOnly && !m_alloc.get_file().get_encryption_key() &&
+                        util::File::is_io_uring_supported())
 {
-    m_map_windows.reserve(num_map_windows);
+    m_map_windows.reserve(m_max_map_windows);
 #if REALM_PLATFORM_APPLE && REALM_MOBILE
     m_window_alignment = 1 * 1024 * 1024; // 1M
 #else
@@ -266,8 +323,14 @@ size_t GroupWriter::get_file_size() const noexcept
     return sz;
 }
 
+size_t GroupWriter::get_logical_file_size() const noexcept
+{
+    return to_size_t(m_group.m_top.get(2) / 2);
+}
+
 void GroupWriter::flush_all_mappings()
 {
+    write_pending_arrays(false); // Throws
     if (m_durability == Durability::Unsafe)
         return;
     for (const auto& window : m_map_windows) {
@@ -275,22 +338,45 @@ void GroupWriter::flush_all_mappings()
     }
 }
 
+void GroupWriter::set_map_window_cache(size_t max_windows, size_t window_size)
+{
+    REALM_ASSERT(m_map_windows.empty());
+    REALM_ASSERT(max_windows > 0);
+    REALM_ASSERT((window_size & (window_size - 1)) == 0);
+    m_max_map_windows = max_windows;
+    m_map_windows.reserve(max_windows);
+    if (window_size)
+        m_window_alignment = window_size;
+}
+
 // Get a window matching a request, either creating a new window or reusing an
 // existing one (possibly extended to accomodate the new request). Maintain a
 // cache of open windows which are sync'ed and closed following a least recently
 // used policy. Entries in the cache are kept in MRU order.
 GroupWriter::MapWindow* GroupWriter::get_window(ref_type start_ref, size_t size)
 {
+    bool extended = false;
     auto match = std::find_if(m_map_windows.begin(), m_map_windows.end(), [&](const auto& window) {
-        return window->matches(start_ref, size) || window->extends_to_match(m_alloc.get_file(), start_ref, size);
+        if (window->matches(start_ref, size))
+            return true;
+        extended = window->extends_to_match(m_alloc.get_file(), start_ref, size);
+        return extended;
     });
     if (match != m_map_windows.end()) {
+        if (extended) {
+            ++m_num_map_window_misses;
+        }
+        else {
+            ++m_num_map_window_hits;
+        }
         // move matching window to top (to keep LRU order)
         std::rotate(m_map_windows.begin(), match, match + 1);
         return m_map_windows[0].get();
     }
+    ++m_num_map_window_misses;
     // no window found, make room for a new one at the top
-    if (m_map_windows.size() == num_map_windows) {
+    if (m_map_windows.size() >= m_max_map_windows) {
+        ++m_num_map_window_evictions;
         m_map_windows.back()->flush();
         m_map_windows.pop_back();
     }
@@ -316,6 +402,9 @@ ref_type GroupWriter::write_group()
     read_in_freelist();
     // Now, 'm_size_map' holds all free elements candidate for recycling
 
+    if (m_evacuation && m_evacuation->limit)
+        evacuate(); // Throws
+
     Array& top = m_group.m_top;
 #if REALM_ALLOC_DEBUG
     std::cout << "    In-file freelist after merge:  " << m_size_map.size() << std::endl;
@@ -380,6 +469,7 @@ ref_type GroupWriter::write_group()
 #endif
     max_free_list_size += free_read_only_size;
     max_free_list_size += m_not_free_in_file.size();
+    max_free_list_size += m_withheld_free_space.size();
     // The final allocation of free space (i.e., the call to
     // reserve_free_space() below) may add extra entries to the free-lists.
     // We reserve room for the worst case scenario, which is as follows:
@@ -411,8 +501,8 @@ ref_type GroupWriter::write_group()
     // using the maximum size possible, we still do not end up with a zero size
     // free-space chunk as we deduct the actually used size from it.
     auto reserve = reserve_free_space(max_free_space_needed + 8); // Throws
-    size_t reserve_pos = reserve->second;
-    size_t reserve_size = reserve->first;
+    size_t reserve_pos = m_size_map.get(reserve).ref;
+    size_t reserve_size = m_size_map.get(reserve).size;
 
     // At this point we have allocated all the space we need, so we can add to
     // the free-lists any free space created during the current transaction (or
@@ -493,16 +583,21 @@ ref_type GroupWriter::write_group()
 
     // The free-list now have their final form, so we can write them to the file
     // char* start_addr = m_file_map.get_addr() + reserve_ref;
-    MapWindow* window = get_window(reserve_ref, end_ref - reserve_ref);
-    char* start_addr = window->translate(reserve_ref);
-    window->encryption_read_barrier(start_addr, used);
+    MapWindow* window = nullptr;
+    char* start_addr = nullptr;
+    if (!m_use_write_batch) {
+        window = get_window(reserve_ref, end_ref - reserve_ref);
+        start_addr = window->translate(reserve_ref);
+        window->encryption_read_barrier(start_addr, used);
+    }
     write_array_at(window, free_positions_ref, m_free_positions.get_header(), free_positions_size); // Throws
     write_array_at(window, free_sizes_ref, m_free_lengths.get_header(), free_sizes_size);           // Throws
     write_array_at(window, free_versions_ref, m_free_versions.get_header(), free_versions_size);    // Throws
 
     // Write top
     write_array_at(window, top_ref, top.get_header(), top_byte_size); // Throws
-    window->encryption_write_barrier(start_addr, used);
+    if (window)
+        window->encryption_write_barrier(start_addr, used);
     // Return top_ref so that it can be saved in lock file used for coordination
     return top_ref;
 }
@@ -523,6 +618,8 @@ void GroupWriter::read_in_freelist()
             size_t size = size_t(m_free_lengths.get(idx));
 
             uint64_t version = m_free_versions.get(idx);
+            if (version >= limit_version && !m_live_versions.empty())
+                version = backdate(ref, size, version);
             // Entries that are freed in still alive versions are not candidates for merge or allocation
             if (version >= limit_version) {
                 m_not_free_in_file.emplace_back(ref, size, version);
@@ -547,36 +644,215 @@ void GroupWriter::read_in_freelist()
     }
 
     free_in_file.merge_adjacent_entries_in_freelist();
-    // Previous step produces - potentially - some entries with size of zero. These
+    if (m_evacuation && m_evacuation->limit)
+        withhold_free_space_beyond_limit(free_in_file); // Throws
+    // Previous steps produce - potentially - some entries with size of zero. These
     // entries will be skipped in the next step.
     free_in_file.move_free_in_file_to_size_map(m_size_map);
 }
 
+uint64_t GroupWriter::backdate(size_t ref, size_t size, uint64_t version)
+{
+    // A chunk freed in `version` is reachable from versions before it only.
+    // If it is also in the free list of the newest live version before it,
+    // it is unreachable from that one too, and from the versions after the
+    // one it was freed in there. Repeat with that version until a live
+    // version reaches the chunk, or no live version is left before it. The
+    // versions between the live ones have been made unavailable by DB.
+    if (m_live_free_lists.size() != m_live_versions.size())
+        m_live_free_lists.resize(m_live_versions.size());
+    for (;;) {
+        auto it = std::lower_bound(m_live_versions.begin(), m_live_versions.end(), version,
+                                   [](const std::pair<uint64_t, ref_type>& live, uint64_t v) {
+                                       return live.first < v;
+                                   });
+        if (it == m_live_versions.begin())
+            return version;
+        --it;
+        size_t ndx = size_t(it - m_live_versions.begin());
+        auto& free_list = m_live_free_lists[ndx];
+        if (!free_list)
+            free_list = std::make_unique<LiveFreeList>(m_alloc, it->second); // Throws
+        uint64_t freed_in;
+        // The free list of a version only holds entries freed in or before
+        // it, so this always moves back
+        if (!free_list->find(ref, size, freed_in) || freed_in >= version)
+            return version;
+        version = freed_in;
+    }
+}
+
+void GroupWriter::evacuate()
+{
+    EvacuationState& state = *m_evacuation;
+    if (state.walk_done) {
+        // Wait for the end of the file to be released, but walk the tree again
+        // if it takes long, as others may have written beyond the limit
+        if (++state.commits_since_walk < evacuation_rewalk_delay)
+            return;
+        state.walk_done = false;
+        state.commits_since_walk = 0;
+    }
+
+    // Only move as much as leaves room below the limit for what is written anyway
+    m_evacuation_bytes_left = std::min(max_evacuated_bytes_per_commit, m_size_map.get_total_size() / 2);
+    if (m_evacuation_bytes_left < min_evacuated_bytes_per_commit)
+        return;
+    m_evacuation_visits_left = max_evacuation_visits_per_commit;
+    Array& top = m_group.m_top;
+    size_t start = state.progress.empty() ? 0 : state.progress[0];
+    for (size_t i = start; i < 3; ++i) {
+        bool resume = i == start && !state.progress.empty();
+        bool done = true;
+        switch (i) {
+            case 0:
+                done = evacuate_subtree(m_group.m_table_names, 1, resume); // Throws
+                break;
+            case 1:
+                done = evacuate_subtree(m_group.m_tables, 1, resume); // Throws
+                break;
+            case 2:
+                if (top.size() > Group::s_hist_ref_ndx) {
+                    if (ref_type history_ref = top.get_as_ref(Group::s_hist_ref_ndx)) {
+                        Array history(m_alloc);
+                        history.init_from_ref(history_ref);
+                        history.set_parent(&top, Group::s_hist_ref_ndx);
+                        done = evacuate_subtree(history, 1, resume); // Throws
+                    }
+                }
+                break;
+        }
+        if (!done) {
+            state.progress[0] = i;
+            return;
+        }
+    }
+    state.progress.clear();
+    state.walk_done = true;
+}
+
+bool GroupWriter::evacuate_subtree(Array& node, size_t depth, bool resume)
+{
+    // Copying the array into memory makes it get written to free space below
+    // the limit, as such space is all that is available for allocation. This
+    // is done here rather than by copy_on_write(), which only knows about
+    // arrays of bit packed integers.
+    ref_type ref = node.get_ref();
+    if (ref >= m_evacuation->limit && m_alloc.is_read_only(ref)) {
+        const char* header = node.get_header();
+        size_t byte_size = Array::get_byte_size_from_header(header);
+        size_t capacity = (byte_size + 7) & ~size_t(7);
+        MemRef mem = m_alloc.alloc(capacity); // Throws
+        realm::safe_copy_n(header, byte_size, mem.get_addr());
+        Array::set_capacity_in_header(capacity, mem.get_addr());
+        node.init_from_mem(mem);
+        node.update_parent(); // Throws
+        m_alloc.free_(ref, header);
+        m_evacuation_bytes_left -= std::min(byte_size, m_evacuation_bytes_left);
+    }
+    if (!node.has_refs())
+        return true;
+
+    auto& progress = m_evacuation->progress;
+    size_t n = node.size();
+    size_t start = resume && depth < progress.size() ? progress[depth] : 0;
+    for (size_t i = start; i < n; ++i) {
+        int_fast64_t value = node.get(i);
+        if (value == 0 || (value & 1) != 0)
+            continue;
+        if (m_evacuation_bytes_left == 0 || m_evacuation_visits_left == 0) {
+            progress.resize(depth + 1);
+            progress[depth] = i;
+            return false;
+        }
+        --m_evacuation_visits_left;
+        Array child(m_alloc);
+        child.init_from_ref(to_ref(value));
+        child.set_parent(&node, i);
+        if (!evacuate_subtree(child, depth + 1, resume && i == start)) { // Throws
+            progress[depth] = i;
+            return false;
+        }
+    }
+    return true;
+}
+
+void GroupWriter::withhold_free_space_beyond_limit(FreeList& free_in_file)
+{
+    EvacuationState& state = *m_evacuation;
+    for (auto& elem : free_in_file) {
+        if (elem.size == 0 || elem.ref + elem.size <= state.limit)
+            continue;
+        size_t start = std::max(elem.ref, size_t(state.limit));
+        m_withheld_free_space.emplace_back(start, elem.ref + elem.size - start, 0);
+        elem.size = start - elem.ref;
+    }
+
+    // Cut off the end of the file once it is all free
+    size_t logical_file_size = to_size_t(m_group.m_top.get(2) / 2);
+    if (!m_withheld_free_space.empty()) {
+        auto& last = m_withheld_free_space.back();
+        size_t new_file_size = util::round_up_to_page_size(last.ref);
+        if (last.ref + last.size == logical_file_size && new_file_size < logical_file_size) {
+            last.size = new_file_size - last.ref;
+            if (last.size == 0)
+                m_withheld_free_space.pop_back();
+            m_group.m_top.set(2, 1 + 2 * uint64_t(new_file_size)); // Throws
+            m_unshrunk_file_size = logical_file_size;
+            m_shrunk_file_size = new_file_size;
+            logical_file_size = new_file_size;
+        }
+    }
+    if (state.walk_done && logical_file_size <= util::round_up_to_page_size(state.limit)) {
+        // Nothing is left beyond the limit
+        state = EvacuationState();
+    }
+}
+
+void GroupWriter::stop_evacuation()
+{
+    for (const auto& elem : m_withheld_free_space)
+        m_size_map.insert(elem.size, elem.ref); // Throws
+    m_withheld_free_space.clear();
+    *m_evacuation = EvacuationState();
+    m_evacuation->commits_until_retry = evacuation_retry_delay;
+}
+
 size_t GroupWriter::recreate_freelist(size_t reserve_pos)
 {
     std::vector<FreeSpaceEntry> free_in_file;
     auto& new_free_space = m_group.m_alloc.get_free_read_only(); // Throws
-    auto nb_elements = m_size_map.size() + m_not_free_in_file.size() + new_free_space.size();
+    auto nb_elements =
+        m_size_map.size() + m_withheld_free_space.size() + m_not_free_in_file.size() + new_free_space.size();
     free_in_file.reserve(nb_elements);
 
     size_t reserve_ndx = realm::npos;
 
-    for (const auto& entry : m_size_map) {
-        free_in_file.emplace_back(entry.second, entry.first, 0);
+    m_size_map.for_each([&](const FreeSpaceMap::Chunk& chunk) {
+        free_in_file.emplace_back(chunk.ref, chunk.size, 0);
+    });
+    for (const auto& withheld : m_withheld_free_space) {
+        free_in_file.emplace_back(withheld.ref, withheld.size, 0);
     }
 
     {
         size_t locked_space_size = 0;
+        std::map<uint64_t, size_t> locked_space_by_version;
         for (const auto& locked : m_not_free_in_file) {
             free_in_file.emplace_back(locked.ref, locked.size, locked.released_at_version);
             locked_space_size += locked.size;
+            locked_space_by_version[locked.released_at_version] += locked.size;
         }
 
+        size_t newly_freed = 0;
         for (const auto& free_space : new_free_space) {
             free_in_file.emplace_back(free_space.first, free_space.second, m_current_version);
-            locked_space_size += free_space.second;
+            newly_freed += free_space.second;
         }
-        m_locked_space_size = locked_space_size;
+        if (newly_freed)
+            locked_space_by_version[m_current_version] += newly_freed;
+        m_locked_space_size = locked_space_size + newly_freed;
+        m_locked_space_by_version.assign(locked_space_by_version.begin(), locked_space_by_version.end());
     }
 
     REALM_ASSERT(free_in_file.size() == nb_elements);
@@ -651,18 +927,70 @@ void GroupWriter::FreeList::merge_adjacent_entries_in_freelist()
     }
 }
 
-void GroupWriter::FreeList::move_free_in_file_to_size_map(std::multimap<size_t, size_t>& size_map)
+void GroupWriter::FreeList::move_free_in_file_to_size_map(FreeSpaceMap& size_map)
 {
     for (auto& elem : *this) {
         // Skip elements merged in 'merge_adjacent_entries_in_freelist'
         if (elem.size) {
             REALM_ASSERT_RELEASE_EX(!(elem.size & 7), elem.size);
             REALM_ASSERT_RELEASE_EX(!(elem.ref & 7), elem.ref);
-            size_map.emplace(elem.size, elem.ref);
+            size_map.insert(elem.size, elem.ref);
         }
     }
 }
 
+size_t GroupWriter::FreeSpaceMap::size_class_of(size_t size) noexcept
+{
+    REALM_ASSERT_DEBUG(size > 0 && !(size & 7));
+    if (size <= max_exact_size)
+        return size / 8 - 1;
+    // 8 classes for each power of two, selected by the 3 bits following the
+    // most significant one
+    constexpr int log2_max_exact_size = 12;
+    static_assert(size_t(1) << log2_max_exact_size == max_exact_size, "");
+    int msb = log2(size);
+    return num_exact_classes + size_t(msb - log2_max_exact_size) * 8 + ((size >> (msb - 3)) & 7);
+}
+
+GroupWriter::FreeListElement GroupWriter::FreeSpaceMap::insert(size_t size, size_t ref)
+{
+    size_t size_class = size_class_of(size);
+    auto& chunks = m_classes[size_class];
+    chunks.push_back({size, ref}); // Throws
+    m_nonempty[size_class / bits_per_word] |= size_t(1) << (size_class % bits_per_word);
+    ++m_size;
+    m_total_size += size;
+    return {size_class, chunks.size() - 1};
+}
+
+void GroupWriter::FreeSpaceMap::erase(FreeListElement e)
+{
+    auto& chunks = m_classes[e.size_class];
+    REALM_ASSERT_DEBUG(e.ndx < chunks.size());
+    m_total_size -= chunks[e.ndx].size;
+    // The order within a size class does not matter, so fill the hole with the last chunk
+    chunks[e.ndx] = chunks.back();
+    chunks.pop_back();
+    if (chunks.empty())
+        m_nonempty[e.size_class / bits_per_word] &= ~(size_t(1) << (e.size_class % bits_per_word));
+    --m_size;
+}
+
+size_t GroupWriter::FreeSpaceMap::find_nonempty_class(size_t size_class) const noexcept
+{
+    constexpr size_t num_words = sizeof(m_nonempty) / sizeof(m_nonempty[0]);
+    if (size_class >= num_classes)
+        return realm::npos;
+    size_t word_ndx = size_class / bits_per_word;
+    size_t bits = m_nonempty[word_ndx] & (~size_t(0) << (size_class % bits_per_word));
+    while (!bits) {
+        if (++word_ndx == num_words)
+            return realm::npos;
+        bits = m_nonempty[word_ndx];
+    }
+    return word_ndx * bits_per_word + size_t(ctz(bits));
+}
+
 size_t GroupWriter::get_free_space(size_t size)
 {
     REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
@@ -670,8 +998,8 @@ size_t GroupWriter::get_free_space(size_t size)
     auto p = reserve_free_space(size);
 
     // Claim space from identified chunk
-    size_t chunk_pos = p->second;
-    size_t chunk_size = p->first;
+    size_t chunk_pos = m_size_map.get(p).ref;
+    size_t chunk_size = m_size_map.get(p).size;
     REALM_ASSERT_3(chunk_size, >=, size);
     REALM_ASSERT_RELEASE_EX(!(chunk_pos & 7), chunk_pos);
     REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
@@ -683,7 +1011,7 @@ size_t GroupWriter::get_free_space(size_t size)
         // of the chunk. The call to reserve_free_space may split chunks
         // in order to make sure that it returns a chunk from which allocation
         // can be done from the beginning
-        m_size_map.emplace(rest, chunk_pos + size);
+        m_size_map.insert(rest, chunk_pos + size);
     }
     return chunk_pos;
 }
@@ -691,26 +1019,26 @@ size_t GroupWriter::get_free_space(size_t size)
 
 inline GroupWriter::FreeListElement GroupWriter::split_freelist_chunk(FreeListElement it, size_t alloc_pos)
 {
-    size_t start_pos = it->second;
-    size_t chunk_size = it->first;
+    size_t start_pos = m_size_map.get(it).ref;
+    size_t chunk_size = m_size_map.get(it).size;
     m_size_map.erase(it);
     REALM_ASSERT_RELEASE_EX(alloc_pos > start_pos, alloc_pos, start_pos);
 
     REALM_ASSERT_RELEASE_EX(!(alloc_pos & 7), alloc_pos);
     size_t size_first = alloc_pos - start_pos;
     size_t size_second = chunk_size - size_first;
-    m_size_map.emplace(size_first, start_pos);
-    return m_size_map.emplace(size_second, alloc_pos);
+    m_size_map.insert(size_first, start_pos);
+    return m_size_map.insert(size_second, alloc_pos);
 }
 
 GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element(FreeListElement it, size_t size)
 {
     SlabAlloc& alloc = m_group.m_alloc;
-    size_t chunk_size = it->first;
+    size_t chunk_size = m_size_map.get(it).size;
 
     // search through the chunk, finding a place within it,
     // where an allocation will not cross a mmap boundary
-    size_t start_pos = it->second;
+    size_t start_pos = m_size_map.get(it).ref;
     size_t alloc_pos = alloc.find_section_in_range(start_pos, chunk_size, size);
     if (alloc_pos == 0) {
         return m_size_map.end();
@@ -725,23 +1053,55 @@ GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element
     return it;
 }
 
-GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(size_t size)
+GroupWriter::FreeListElement GroupWriter::search_free_space_in_size_class(size_t size_class, size_t size)
 {
-    auto it = m_size_map.lower_bound(size);
-    while (it != m_size_map.end()) {
-        // Accept either a perfect match or a block that is twice the size. Tests have shown
-        // that this is a good strategy.
-        if (it->first == size || it->first >= 2 * size) {
-            auto ret = search_free_space_in_free_list_element(it, size);
-            if (ret != m_size_map.end()) {
-                return ret;
+    const auto& chunks = m_size_map.get_class(size_class);
+    // Candidates are tried in order of (size, index), so that we can move on to
+    // the next one if an allocation cannot be placed in the best fitting chunk.
+    size_t rejected_size = 0;
+    size_t rejected_ndx = realm::npos;
+    for (;;) {
+        size_t best = realm::npos;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            size_t chunk_size = chunks[i].size;
+            // Accept either a perfect match or a block that is twice the size. Tests have shown
+            // that this is a good strategy.
+            if (chunk_size != size && chunk_size < 2 * size)
+                continue;
+            if (rejected_ndx != realm::npos &&
+                (chunk_size < rejected_size || (chunk_size == rejected_size && i <= rejected_ndx)))
+                continue;
+            if (best == realm::npos || chunk_size < chunks[best].size) {
+                best = i;
+                if (chunk_size == size)
+                    break;
             }
-            ++it;
-        }
-        else {
-            // If block was too small, search for the first that is at least twice as big.
-            it = m_size_map.lower_bound(2 * size);
         }
+        if (best == realm::npos)
+            return m_size_map.end();
+        auto ret = search_free_space_in_free_list_element({size_class, best}, size);
+        if (ret != m_size_map.end())
+            return ret;
+        rejected_size = chunks[best].size;
+        rejected_ndx = best;
+    }
+}
+
+GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(size_t size)
+{
+    // A perfect match can only be found in the size class of the request itself
+    size_t size_class = FreeSpaceMap::size_class_of(size);
+    auto ret = search_free_space_in_size_class(size_class, size);
+    if (ret != m_size_map.end())
+        return ret;
+    // Otherwise take the smallest block that is at least twice as big. Only the
+    // first class searched may hold blocks which are too small.
+    size_class = m_size_map.find_nonempty_class(FreeSpaceMap::size_class_of(2 * size));
+    while (size_class != realm::npos) {
+        ret = search_free_space_in_size_class(size_class, size);
+        if (ret != m_size_map.end())
+            return ret;
+        size_class = m_size_map.find_nonempty_class(size_class + 1);
     }
     // No match
     return m_size_map.end();
@@ -751,6 +1111,30 @@ GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(
 GroupWriter::FreeListElement GroupWriter::reserve_free_space(size_t size)
 {
     auto chunk = search_free_space_in_part_of_freelist(size);
+    if (chunk == m_size_map.end() && m_evacuation && m_evacuation->limit) {
+        // Rather use the lowest free space beyond the limit, or what was to be
+        // cut off the end of the file, than make the file grow. Give up on
+        // compacting the file if none of it will do.
+        for (auto it = m_withheld_free_space.begin(); it != m_withheld_free_space.end(); ++it) {
+            if (it->size < size)
+                continue;
+            auto elem = m_size_map.insert(it->size, it->ref); // Throws
+            m_withheld_free_space.erase(it);
+            chunk = search_free_space_in_free_list_element(elem, size);
+            break;
+        }
+        if (chunk == m_size_map.end() && m_shrunk_file_size &&
+            m_unshrunk_file_size - m_shrunk_file_size >= size) {
+            auto elem = m_size_map.insert(m_unshrunk_file_size - m_shrunk_file_size, m_shrunk_file_size); // Throws
+            m_group.m_top.set(2, 1 + 2 * uint64_t(m_unshrunk_file_size));                                // Throws
+            m_shrunk_file_size = 0;
+            chunk = search_free_space_in_free_list_element(elem, size);
+        }
+        if (chunk == m_size_map.end()) {
+            stop_evacuation();
+            chunk = search_free_space_in_part_of_freelist(size);
+        }
+    }
     while (chunk == m_size_map.end()) {
         // No free space, so we have to extend the file.
         auto new_chunk = extend_free_space(size);
@@ -817,6 +1201,7 @@ GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_siz
     // of the user to ensure non-concurrent file mutation.
     m_alloc.resize_file(new_file_size); // Throws
     REALM_ASSERT(new_file_size <= get_file_size());
+    m_shrunk_file_size = 0;
 #if REALM_ALLOC_DEBUG
     std::cout << "        ** File extension to " << new_file_size << "     after request for " << requested_size
               << std::endl;
@@ -827,7 +1212,7 @@ GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_siz
     size_t chunk_size = new_file_size - logical_file_size;
     REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
     REALM_ASSERT_RELEASE(chunk_size != 0);
-    auto it = m_size_map.emplace(chunk_size, logical_file_size);
+    auto it = m_size_map.insert(chunk_size, logical_file_size);
 
     // Update the logical file size
     m_group.m_top.set(2, 1 + 2 * uint64_t(new_file_size)); // Throws
@@ -845,6 +1230,12 @@ ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checks
 {
     // Get position of free space to write in (expanding file if needed)
     size_t pos = get_free_space(size);
+    m_bytes_written += size;
+
+    if (m_use_write_batch) {
+        stage_array_at(to_ref(pos), data, size, checksum); // Throws
+        return to_ref(pos);
+    }
 
     // Write the block
     MapWindow* window = get_window(pos, size);
@@ -866,19 +1257,67 @@ void GroupWriter::write_array_at(MapWindow* window, ref_type ref, const char* da
 
     REALM_ASSERT_3(pos + size, <=, to_size_t(m_group.m_top.get(2) / 2));
     // REALM_ASSERT_3(pos + size, <=, m_file_map.get_size());
+    uint32_t checksum = checksum_arrays ? NodeHeader::calc_checksum(data, size) : NodeHeader::unchecked_signature;
+    if (!window) {
+        stage_array_at(ref, data, size, checksum); // Throws
+        return;
+    }
     char* dest_addr = window->translate(pos);
     REALM_ASSERT_RELEASE(is_aligned(dest_addr));
 
-    uint32_t dummy_checksum = 0x41414141UL; // "AAAA" in ASCII
-    memcpy(dest_addr, &dummy_checksum, 4);
+    memcpy(dest_addr, &checksum, 4);
     memcpy(dest_addr + 4, data + 4, size - 4);
 }
 
 
+void GroupWriter::stage_array_at(ref_type ref, const char* data, size_t size, uint32_t checksum)
+{
+    REALM_ASSERT_RELEASE((ref & 7) == 0);
+    if (m_pending_data.size() + size > max_pending_data_size)
+        write_pending_arrays(false); // Throws
+
+    size_t offset = m_pending_data.size();
+    m_pending_data.resize(offset + size); // Throws
+    char* dest_addr = m_pending_data.data() + offset;
+    memcpy(dest_addr, &checksum, 4);
+    memcpy(dest_addr + 4, data + 4, size - 4);
+
+    // Arrays are mostly allocated one after the other, so most writes can be merged
+    if (!m_pending_writes.empty()) {
+        PendingWrite& last = m_pending_writes.back();
+        if (last.ref + last.size == ref && last.offset + last.size == offset) {
+            last.size += size;
+            return;
+        }
+    }
+    m_pending_writes.push_back({ref, offset, size}); // Throws
+}
+
+
+void GroupWriter::write_pending_arrays(bool barrier)
+{
+    if (m_pending_writes.empty() && !barrier)
+        return;
+    std::vector<File::WriteRequest> requests;
+    requests.reserve(m_pending_writes.size()); // Throws
+    for (const PendingWrite& write : m_pending_writes)
+        requests.push_back({File::SizeType(write.ref), m_pending_data.data() + write.offset, write.size});
+    m_alloc.get_file().write_batch(requests, barrier); // Throws
+    m_pending_writes.clear();
+    m_pending_data.clear();
+}
+
+
+void GroupWriter::prepare_commit()
+{
+    get_window(0, sizeof(SlabAlloc::Header)); // Throws
+}
+
 void GroupWriter::commit(ref_type new_top_ref)
 {
     using _impl::SimulatedFailure;
     SimulatedFailure::trigger(SimulatedFailure::group_writer__commit); // Throws
+    util::tracing::Span span("GroupWriter::commit");
 
     MapWindow* window = get_window(0, sizeof(SlabAlloc::Header));
     SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(window->translate(0));
@@ -906,18 +1345,27 @@ void GroupWriter::commit(ref_type new_top_ref)
     // When running the test suite, device synchronization is disabled
     bool disable_sync = get_disable_sync_to_disk() || m_durability == Durability::Unsafe;
     file_header.m_top_ref[slot_selector] = new_top_ref;
+    span.set_attribute("sync_to_disk", !disable_sync);
 
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> fsync_timer = Metrics::report_fsync_time(m_group);
+    metrics::LatencyTimer fsync_latency_timer(metrics::LatencyMetric::fsync);
 #endif // REALM_METRICS
 
     // Make sure that that all data relating to the new snapshot is written to
     // stable storage before flipping the slot selector
     window->encryption_write_barrier(&file_header.m_top_ref[slot_selector],
                                      sizeof(file_header.m_top_ref[slot_selector]));
-    flush_all_mappings();
-    if (!disable_sync)
-        m_alloc.get_file().barrier();
+    if (m_use_write_batch) {
+        // The staged arrays are written together with the sync to disk, which
+        // also covers the header modified through the mapping
+        write_pending_arrays(!disable_sync); // Throws
+    }
+    else {
+        flush_all_mappings();
+        if (!disable_sync)
+            m_alloc.get_file().barrier();
+    }
     // Flip the slot selector bit.
     using type_2 = std::remove_reference<decltype(file_header.m_flags)>::type;
     file_header.m_flags = type_2(new_flags);
@@ -926,6 +1374,23 @@ void GroupWriter::commit(ref_type new_top_ref)
     window->encryption_write_barrier(&file_header.m_flags, sizeof(file_header.m_flags));
     if (!disable_sync)
         window->sync();
+
+    // Now that the header no longer refers to a version using the end of the
+    // file, it can be truncated. Encrypted files are left at their size, as
+    // the decrypted pages mapped by others could otherwise go stale.
+    //
+    // The commit is durable at this point, so it must not fail. Truncation is
+    // only an attempt: a file larger than its logical size is valid, and
+    // will be reused or cut off later. Some platforms refuse to truncate a
+    // file while it is mapped.
+    if (m_shrunk_file_size && !m_alloc.get_file().get_encryption_key()) {
+        m_map_windows.clear();
+        try {
+            m_alloc.get_file().resize(m_shrunk_file_size);
+        }
+        catch (const std::exception&) {
+        }
+    }
 }
 
 
@@ -20,8 +20,9 @@
 #define REALM_GROUP_WRITER_HPP
 
 #include <cstdint> // unint8_t etc
+#include <memory>
 #include <utility>
-#include <map>
+#include <vector>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc.hpp>
@@ -36,6 +37,24 @@ namespace realm {
 class Group;
 class SlabAlloc;
 
+/// State of an incremental compaction of the file, kept by the DB between
+/// commits. See DBOptions::enable_incremental_compaction.
+struct EvacuationState {
+    /// Arrays at or beyond this position are moved below it, and free space
+    /// beyond it is not allocated from. Zero when no compaction is going on.
+    ref_type limit = 0;
+    /// Where the last commit stopped walking the tree of arrays, as the index
+    /// of the child followed at each level.
+    std::vector<size_t> progress;
+    /// Set when the whole tree has been walked, so that all that remains is
+    /// for the end of the file to be released by the readers using it.
+    bool walk_done = false;
+    unsigned commits_since_walk = 0;
+    /// Commits to let pass before compaction is considered again after it
+    /// had to be given up.
+    unsigned commits_until_retry = 0;
+};
+
 
 /// This class is not supposed to be reused for multiple write sessions. In
 /// particular, do not reuse it in case any of the functions throw.
@@ -56,6 +75,22 @@ public:
 
     void set_versions(uint64_t current, uint64_t read_lock) noexcept;
 
+    /// The versions other than the latest which may still be read, as pairs
+    /// of version and top ref, oldest first. Space freed after the oldest of
+    /// them is reused if none of them can reach it. Without them, no space
+    /// freed at or after `read_lock` is reused.
+    void set_live_versions(std::vector<std::pair<uint64_t, ref_type>> versions)
+    {
+        m_live_versions = std::move(versions);
+    }
+
+    /// Take part in an incremental compaction of the file. The state is
+    /// updated as the compaction progresses.
+    void set_evacuation_state(EvacuationState* state) noexcept
+    {
+        m_evacuation = state;
+    }
+
     /// Write all changed array nodes into free space.
     ///
     /// Returns the new top ref. When in full durability mode, call
@@ -67,8 +102,17 @@ public:
     /// returned by write_group().
     void commit(ref_type new_top_ref);
 
+    /// Map the file header ahead of commit(). Afterwards commit() only uses
+    /// the file, not the state of the allocator, so it can run on another
+    /// thread while further writes are made through the allocator.
+    void prepare_commit();
+
     size_t get_file_size() const noexcept;
 
+    /// The size of the file as recorded in the new top array. This may be less
+    /// than get_file_size() when the end of the file is not in use.
+    size_t get_logical_file_size() const noexcept;
+
     ref_type write_array(const char*, size_t, uint32_t) override;
 
 #ifdef REALM_DEBUG
@@ -85,9 +129,43 @@ public:
         return m_locked_space_size;
     }
 
-    // Flush all cached memory mappings
+    /// The locked space by the version it was freed in, in order of version
+    const std::vector<std::pair<uint64_t, size_t>>& get_locked_space_by_version() const
+    {
+        return m_locked_space_by_version;
+    }
+
+    // Flush all cached memory mappings, and write arrays not yet written
     void flush_all_mappings();
 
+    static constexpr size_t default_max_map_windows = 16;
+
+    /// Set the number of memory mapped windows kept open for writing, and,
+    /// if \a window_size is not zero, the size (and alignment) of each of
+    /// them, which must be a power of two. Must be called before writing.
+    void set_map_window_cache(size_t max_windows, size_t window_size = 0);
+
+    /// Number of lookups of a window served by one already mapped, and
+    /// number of lookups for which a window had to be mapped or remapped.
+    size_t get_num_map_window_hits() const noexcept
+    {
+        return m_num_map_window_hits;
+    }
+    size_t get_num_map_window_misses() const noexcept
+    {
+        return m_num_map_window_misses;
+    }
+    /// Number of windows closed to make room for another one
+    size_t get_num_map_window_evictions() const noexcept
+    {
+        return m_num_map_window_evictions;
+    }
+    /// Total size of the arrays written by write_group()
+    size_t get_bytes_written() const noexcept
+    {
+        return m_bytes_written;
+    }
+
 private:
     class MapWindow;
     Group& m_group;
@@ -100,8 +178,84 @@ private:
     size_t m_window_alignment;
     size_t m_free_space_size = 0;
     size_t m_locked_space_size = 0;
+    std::vector<std::pair<uint64_t, size_t>> m_locked_space_by_version;
     Durability m_durability;
 
+    // Position of an entry in a FreeSpaceMap
+    struct FreeListElement {
+        size_t size_class;
+        size_t ndx;
+        bool operator==(const FreeListElement& other) const noexcept
+        {
+            return size_class == other.size_class && ndx == other.ndx;
+        }
+        bool operator!=(const FreeListElement& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    // The chunks of free space available for allocation in this commit,
+    // segregated by size. Chunks up to 'max_exact_size' have a size class of
+    // their own, larger chunks are put in one of 8 classes per power of two.
+    // Inserting and erasing chunks is done in constant time, and a lookup only
+    // has to look at the chunks of one or two size classes, so the cost of a
+    // commit does not grow with the log of the number of free chunks as it
+    // would with an ordered map.
+    class FreeSpaceMap {
+    public:
+        struct Chunk {
+            size_t size;
+            size_t ref;
+        };
+        static constexpr size_t max_exact_size = 4096;
+
+        FreeListElement insert(size_t size, size_t ref);
+        void erase(FreeListElement);
+        const Chunk& get(FreeListElement e) const noexcept
+        {
+            return m_classes[e.size_class][e.ndx];
+        }
+        const std::vector<Chunk>& get_class(size_t size_class) const noexcept
+        {
+            return m_classes[size_class];
+        }
+        size_t size() const noexcept
+        {
+            return m_size;
+        }
+        // Sum of the sizes of all chunks
+        size_t get_total_size() const noexcept
+        {
+            return m_total_size;
+        }
+        FreeListElement end() const noexcept
+        {
+            return {realm::npos, realm::npos};
+        }
+        static size_t size_class_of(size_t size) noexcept;
+        // Return the first size class at or above 'size_class' with any chunks
+        // in it, or npos if there are none.
+        size_t find_nonempty_class(size_t size_class) const noexcept;
+        template <class F>
+        void for_each(F&& func) const
+        {
+            for (const auto& chunks : m_classes) {
+                for (const auto& chunk : chunks)
+                    func(chunk);
+            }
+        }
+
+    private:
+        static constexpr size_t num_exact_classes = max_exact_size / 8;
+        static constexpr size_t num_classes = num_exact_classes + (64 - 12) * 8;
+        static constexpr size_t bits_per_word = sizeof(size_t) * 8;
+        std::vector<std::vector<Chunk>> m_classes = std::vector<std::vector<Chunk>>(num_classes);
+        size_t m_nonempty[(num_classes + bits_per_word - 1) / bits_per_word] = {};
+        size_t m_size = 0;
+        size_t m_total_size = 0;
+    };
+
     struct FreeSpaceEntry {
         FreeSpaceEntry(size_t r, size_t s, uint64_t v)
             : ref(r)
@@ -118,30 +272,81 @@ private:
         FreeList() = default;
         // Merge adjacent chunks
         void merge_adjacent_entries_in_freelist();
-        // Copy free space entries to structure where entries are sorted by size
-        void move_free_in_file_to_size_map(std::multimap<size_t, size_t>& size_map);
+        // Copy free space entries to structure where entries are segregated by size
+        void move_free_in_file_to_size_map(FreeSpaceMap& size_map);
     };
-    //  m_free_in_file;
+
     std::vector<FreeSpaceEntry> m_not_free_in_file;
-    std::multimap<size_t, size_t> m_size_map;
-    using FreeListElement = std::multimap<size_t, size_t>::iterator;
+    FreeSpaceMap m_size_map;
+
+    // The free lists of the live versions, read as needed by backdate()
+    struct LiveFreeList;
+    std::vector<std::pair<uint64_t, ref_type>> m_live_versions;
+    std::vector<std::unique_ptr<LiveFreeList>> m_live_free_lists;
 
     void read_in_freelist();
+    // Return the earliest version from which a chunk freed in `version` is
+    // known to be unreachable by every live version
+    uint64_t backdate(size_t ref, size_t size, uint64_t version);
     size_t recreate_freelist(size_t reserve_pos);
-    // Currently cached memory mappings. We keep as many as 16 1MB windows
-    // open for writing. The allocator will favor sequential allocation
+
+    // Incremental compaction. Each commit walks part of the tree of arrays and
+    // moves those found beyond the limit into free space below it. Free space
+    // beyond the limit is kept out of m_size_map, and cut off the file once it
+    // reaches the end of it.
+    static constexpr size_t max_evacuated_bytes_per_commit = 1024 * 1024;
+    static constexpr size_t min_evacuated_bytes_per_commit = 4096;
+    static constexpr size_t max_evacuation_visits_per_commit = 64 * 1024;
+    static constexpr unsigned evacuation_rewalk_delay = 64;
+    static constexpr unsigned evacuation_retry_delay = 64;
+    EvacuationState* m_evacuation = nullptr;
+    std::vector<FreeSpaceEntry> m_withheld_free_space;
+    size_t m_evacuation_bytes_left = 0;
+    size_t m_evacuation_visits_left = 0;
+    size_t m_shrunk_file_size = 0;
+    size_t m_unshrunk_file_size = 0;
+
+    void evacuate();
+    // Return false if the budget ran out before all of the subtree was visited
+    bool evacuate_subtree(Array& node, size_t depth, bool resume);
+    void withhold_free_space_beyond_limit(FreeList&);
+    // Make the withheld free space available again, giving up the compaction
+    void stop_evacuation();
+    // Currently cached memory mappings. By default we keep as many as 16 1MB
+    // windows open for writing. The allocator will favor sequential allocation
     // from a modest number of windows, depending upon fragmentation, so
-    // 16 windows should be more than enough. If more than 16 windows are
-    // needed, the least recently used is sync'ed and closed to make room
-    // for a new one. The windows are kept in MRU (most recently used) order.
-    const static int num_map_windows = 16;
+    // 16 windows are usually enough. If more windows are needed, the least
+    // recently used is sync'ed and closed to make room for a new one. The
+    // windows are kept in MRU (most recently used) order.
+    size_t m_max_map_windows = default_max_map_windows;
     std::vector<std::unique_ptr<MapWindow>> m_map_windows;
+    size_t m_num_map_window_hits = 0;
+    size_t m_num_map_window_misses = 0;
+    size_t m_num_map_window_evictions = 0;
+    size_t m_bytes_written = 0;
 
     // Get a suitable memory mapping for later access:
     // potentially adding it to the cache, potentially closing
     // the least recently used and sync'ing it to disk
     MapWindow* get_window(ref_type start_ref, size_t size);
 
+    // When io_uring is supported, arrays are copied here and written to the file in
+    // batches instead of through the memory mappings. This is not done for encrypted
+    // files, which must be written through the mappings, nor in MemOnly mode.
+    struct PendingWrite {
+        ref_type ref;
+        size_t offset; // in m_pending_data
+        size_t size;
+    };
+    const static size_t max_pending_data_size = 8 * 1024 * 1024;
+    bool m_use_write_batch;
+    std::vector<char> m_pending_data;
+    std::vector<PendingWrite> m_pending_writes;
+
+    void stage_array_at(ref_type, const char* data, size_t size, uint32_t checksum);
+    // Write the staged arrays, followed by a sync to disk if 'barrier' is true
+    void write_pending_arrays(bool barrier);
+
     /// Allocate a chunk of free space of the specified size. The
     /// specified size must be 8-byte aligned. Extend the file if
     /// required. The returned chunk is removed from the amount of
@@ -166,6 +371,11 @@ private:
 
     FreeListElement search_free_space_in_free_list_element(FreeListElement element, size_t size);
 
+    /// Search the chunks of one size class for the smallest one which can
+    /// hold the specified size and is either an exact match or at least
+    /// twice as big.
+    FreeListElement search_free_space_in_size_class(size_t size_class, size_t size);
+
     /// Search only a range of the free list for a block as big as the
     /// specified size. Return a pair with index and size of the found chunk.
     FreeListElement search_free_space_in_part_of_freelist(size_t size);
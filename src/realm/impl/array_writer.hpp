@@ -36,6 +36,14 @@ public:
     /// Returns the ref (position in the target stream) of the written copy of
     /// the specified array data.
     virtual ref_type write_array(const char* data, size_t size, uint32_t checksum) = 0;
+
+    /// Write integer leaves frame-of-reference encoded when that makes them
+    /// smaller (see NodeHeader::get_encoded_base()).
+    bool encode_integer_leaves = false;
+
+    /// Write the CRC-32C of every array into the checksum field of its header
+    /// (see NodeHeader::calc_checksum()) instead of the unchecked signature.
+    bool checksum_arrays = false;
 };
 
 } // namespace impl_
@@ -22,6 +22,8 @@
 #include <realm/list.hpp>
 #include <realm/set.hpp>
 
+#include <algorithm>
+
 namespace realm::_impl {
 
 void CopyReplication::add_class(TableKey, StringData name, Table::Type table_type)
@@ -201,10 +203,15 @@ void CopyReplication::sync(const Table* t, ObjKey obj_key)
         auto obj = t->get_object(obj_key);
         if (auto pk_col = t->get_primary_key_column()) {
             // Updating a primary object
-            auto pk = obj.get_any(pk_col);
             m_current.table = t;
             m_current.obj_key = obj_key;
-            m_current.obj_in_destination = get_table_in_destination_realm()->get_object_with_primary_key(pk);
+            if (ObjKey dest_key = find_in_key_map(t, obj_key)) {
+                m_current.obj_in_destination = get_table_in_destination_realm()->get_object(dest_key);
+            }
+            else {
+                auto pk = obj.get_any(pk_col);
+                m_current.obj_in_destination = get_table_in_destination_realm()->get_object_with_primary_key(pk);
+            }
         }
         else {
             // Updating an embedded object
@@ -239,6 +246,26 @@ void CopyReplication::sync(const Table* t, ObjKey obj_key)
     }
 }
 
+void CopyReplication::add_key_map(const Table* t, KeyMap key_map)
+{
+    REALM_ASSERT_DEBUG(std::is_sorted(key_map.begin(), key_map.end()));
+    m_key_maps[t] = std::move(key_map);
+}
+
+ObjKey CopyReplication::find_in_key_map(const Table* t, ObjKey key) const
+{
+    auto it = m_key_maps.find(t);
+    if (it == m_key_maps.end())
+        return {};
+    const KeyMap& key_map = it->second;
+    auto pos = std::lower_bound(key_map.begin(), key_map.end(), key, [](const auto& entry, ObjKey key) {
+        return entry.first < key;
+    });
+    if (pos == key_map.end() || pos->first != key)
+        return {};
+    return pos->second;
+}
+
 Mixed CopyReplication::handle_link(ColKey col_key, Mixed val, util::FunctionRef<void(TableRef)> create_embedded_func)
 {
     auto dest_col_key = get_colkey_in_destination_realm(col_key);
@@ -255,6 +282,8 @@ Mixed CopyReplication::handle_link(ColKey col_key, Mixed val, util::FunctionRef<
         dest_target_table = dest_table->get_opposite_table(dest_col_key);
     }
     if (auto pk_col = target_table->get_primary_key_column()) {
+        if (ObjKey obj_key = find_in_key_map(target_table.unchecked_ptr(), val.get<ObjKey>()))
+            return Mixed(ObjLink(dest_target_table->get_key(), obj_key));
         auto target_obj = target_table->get_object(val.get<ObjKey>());
         auto pk = target_obj.get_any(pk_col);
         auto obj_key = dest_target_table->get_objkey_from_primary_key(pk);
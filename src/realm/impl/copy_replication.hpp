@@ -43,6 +43,14 @@ public:
     void set_insert(const CollectionBase& coll, size_t, Mixed value) override;
     void dictionary_insert(const CollectionBase& coll, size_t, Mixed key, Mixed value) override;
 
+    /// Pairs of the key of an object in the source realm and the key of the
+    /// corresponding object in the destination realm, ordered by the former.
+    using KeyMap = std::vector<std::pair<ObjKey, ObjKey>>;
+
+    /// Record where the objects of source table \a t were copied to, so that
+    /// links to them, and updates of them, need no lookup by primary key.
+    void add_key_map(const Table* t, KeyMap key_map);
+
 private:
     Table* get_table_in_destination_realm()
     {
@@ -70,6 +78,10 @@ private:
     // Returns link to target object - null if embedded object
     Mixed handle_link(ColKey col_key, Mixed val, util::FunctionRef<void(TableRef)> create_embedded_func);
 
+    // Returns the key of the copy of the object in the destination realm, or
+    // a null key if there is no key map for the table
+    ObjKey find_in_key_map(const Table* t, ObjKey key) const;
+
     TransactionRef m_tr;
     struct State {
         // Table and object in source realm
@@ -81,6 +93,7 @@ private:
     State m_current;
     std::vector<State> m_states;
     std::map<const Table*, Table*> m_table_map;
+    std::map<const Table*, KeyMap> m_key_maps;
 };
 
 } // namespace realm::_impl
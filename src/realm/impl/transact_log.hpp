@@ -29,6 +29,7 @@
 
 #include <stdexcept>
 #include <tuple>
+#include <type_traits>
 
 namespace realm {
 
@@ -75,6 +76,14 @@ enum Instruction {
     // the number of backlink columns to change. This can happen
     // when a TypedLink is created for the first time to a Table.
     instr_TypedLinkChange = 43,
+
+    // Set on a number of consecutive objects (by key) in the same column,
+    // i.e. a run of instr_Set.
+    instr_SetRange = 44,
+
+    // Enable or disable compression of the values of a column, see
+    // Table::set_compressed().
+    instr_SetCompressed = 45,
 };
 
 class TransactLogStream {
@@ -198,6 +207,10 @@ public:
     {
         return true;
     }
+    bool set_compressed(ColKey, bool)
+    {
+        return true;
+    }
     bool set_link_type(ColKey)
     {
         return true;
@@ -266,11 +279,20 @@ public:
         return true;
     }
     bool modify_object(ColKey col_key, ObjKey key);
+    /// Optional for other instruction handlers. If a handler lacks it, the
+    /// parser calls modify_object() for each of the objects instead.
+    bool modify_object_range(ColKey col_key, ObjKey first_key, size_t count);
+    /// Like modify_object(), but if the previous instruction was a
+    /// modification of the preceding object in the same column, that
+    /// instruction is extended into an instr_SetRange. Not for logs whose
+    /// instruction boundaries are tracked, as in TransactReverser.
+    bool modify_object_coalesced(ColKey col_key, ObjKey key);
 
     // Must have descriptor selected:
     bool insert_column(ColKey col_key);
     bool erase_column(ColKey col_key);
     bool rename_column(ColKey col_key);
+    bool set_compressed(ColKey col_key, bool compressed);
     bool set_link_type(ColKey col_key);
 
     // Must have collection selected:
@@ -322,6 +344,15 @@ private:
     char* m_transact_log_free_begin = nullptr;
     char* m_transact_log_free_end = nullptr;
 
+    // The run of modifications which modify_object_coalesced() may extend.
+    // It is extended only if nothing has been written after it, i.e. if the
+    // write position is still `m_run_end`.
+    char* m_run_end = nullptr;
+    size_t m_run_size = 0; // bytes of the instruction
+    ColKey m_run_col;
+    int64_t m_run_first_key = 0;
+    size_t m_run_count = 0;
+
     char* reserve(size_t size);
     /// \param ptr Must be in the range [m_transact_log_free_begin, m_transact_log_free_end]
     void advance(char* ptr) noexcept;
@@ -367,6 +398,16 @@ private:
 };
 
 
+/// True if the instruction handler has modify_object_range()
+template <class H, class = void>
+struct HasModifyObjectRange : std::false_type {};
+
+template <class H>
+struct HasModifyObjectRange<H, std::void_t<decltype(std::declval<H&>().modify_object_range(ColKey(), ObjKey(),
+                                                                                           size_t()))>>
+    : std::true_type {};
+
+
 class TransactLogParser {
 public:
     class BadTransactLog; // Exception
@@ -382,6 +423,8 @@ public:
     void parse(util::NoCopyInputStream&, InstructionHandler&);
 
 private:
+    static constexpr size_t input_buffer_size = 1024;
+    // Only used when parsing from an InputStream, so allocated on first use
     util::Buffer<char> m_input_buffer;
 
     // The input stream is assumed to consist of chunks of memory organised such that
@@ -475,12 +518,15 @@ inline void TransactLogEncoder::set_buffer(char* free_begin, char* free_end)
     REALM_ASSERT(free_begin <= free_end);
     m_transact_log_free_begin = free_begin;
     m_transact_log_free_end = free_end;
+    m_run_end = nullptr;
 }
 
 inline char* TransactLogEncoder::reserve(size_t n)
 {
     if (size_t(m_transact_log_free_end - m_transact_log_free_begin) < n) {
         m_stream.transact_log_reserve(n, &m_transact_log_free_begin, &m_transact_log_free_end);
+        // The buffer may have moved
+        m_run_end = nullptr;
     }
     return m_transact_log_free_begin;
 }
@@ -670,12 +716,53 @@ inline bool TransactLogEncoder::rename_column(ColKey col_key)
     return true;
 }
 
+inline bool TransactLogEncoder::set_compressed(ColKey col_key, bool compressed)
+{
+    append_simple_instr(instr_SetCompressed, col_key, int(compressed)); // Throws
+    return true;
+}
+
 inline bool TransactLogEncoder::modify_object(ColKey col_key, ObjKey key)
 {
     append_simple_instr(instr_Set, col_key, key); // Throws
     return true;
 }
 
+inline bool TransactLogEncoder::modify_object_range(ColKey col_key, ObjKey first_key, size_t count)
+{
+    REALM_ASSERT(count > 0);
+    if (count == 1)
+        return modify_object(col_key, first_key); // Throws
+    append_simple_instr(instr_SetRange, col_key, first_key, count); // Throws
+    return true;
+}
+
+inline bool TransactLogEncoder::modify_object_coalesced(ColKey col_key, ObjKey key)
+{
+    constexpr size_t max_range_size = 1 + 3 * max_enc_bytes_per_int;
+    bool extends_run = m_run_end && m_run_end == m_transact_log_free_begin && col_key == m_run_col &&
+                       key.value == m_run_first_key + int64_t(m_run_count) &&
+                       size_t(m_transact_log_free_end - m_run_end) + m_run_size >= max_range_size;
+    char* begin;
+    if (extends_run) {
+        // Rewrite the run in place
+        begin = m_run_end - m_run_size;
+        m_transact_log_free_begin = begin;
+        ++m_run_count;
+        encode_list(begin, instr_SetRange, col_key, ObjKey(m_run_first_key), m_run_count);
+    }
+    else {
+        begin = reserve(max_range_size); // Throws
+        m_run_col = col_key;
+        m_run_first_key = key.value;
+        m_run_count = 1;
+        encode_list(begin, instr_Set, col_key, key);
+    }
+    m_run_end = m_transact_log_free_begin;
+    m_run_size = size_t(m_run_end - begin);
+    return true;
+}
+
 
 
 /************************************ List ***********************************/
@@ -745,10 +832,7 @@ inline bool TransactLogEncoder::typed_link_change(ColKey col, TableKey dest)
 }
 
 
-inline TransactLogParser::TransactLogParser()
-    : m_input_buffer(1024) // Throws
-{
-}
+inline TransactLogParser::TransactLogParser() {}
 
 
 inline TransactLogParser::~TransactLogParser() noexcept {}
@@ -767,6 +851,8 @@ void TransactLogParser::parse(util::NoCopyInputStream& in, InstructionHandler& h
 template <class InstructionHandler>
 void TransactLogParser::parse(util::InputStream& in, InstructionHandler& handler)
 {
+    if (m_input_buffer.size() == 0)
+        m_input_buffer.set_size(input_buffer_size); // Throws
     util::NoCopyInputStreamAdaptor in_2(in, m_input_buffer);
     parse(in_2, handler); // Throws
 }
@@ -791,6 +877,25 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_SetRange: {
+            ColKey col_key = ColKey(read_int<int64_t>()); // Throws
+            int64_t first_key = read_int<int64_t>();      // Throws
+            size_t count = read_int<size_t>();            // Throws
+            int64_t end_key = first_key;
+            if (count == 0 || util::int_add_with_overflow_detect(end_key, count))
+                parser_error();
+            if constexpr (HasModifyObjectRange<InstructionHandler>::value) {
+                if (!handler.modify_object_range(col_key, ObjKey(first_key), count)) // Throws
+                    parser_error();
+            }
+            else {
+                for (size_t i = 0; i < count; ++i) {
+                    if (!handler.modify_object(col_key, ObjKey(first_key + int64_t(i)))) // Throws
+                        parser_error();
+                }
+            }
+            return;
+        }
         case instr_SetDefault:
             // Should not appear in the transaction log
             parser_error();
@@ -915,6 +1020,15 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
                 parser_error();
             return;
         }
+        case instr_SetCompressed: {
+            ColKey col_key = ColKey(read_int<int64_t>()); // Throws
+            int compressed = read_int<int>();             // Throws
+            if (compressed != 0 && compressed != 1)
+                parser_error();
+            if (!handler.set_compressed(col_key, compressed != 0)) // Throws
+                parser_error();
+            return;
+        }
         case instr_InsertGroupLevelTable: {
             TableKey table_key = TableKey(read_int<uint32_t>()); // Throws
             if (!handler.insert_group_level_table(table_key))    // Throws
@@ -1159,6 +1273,13 @@ public:
         return true;
     }
 
+    bool set_compressed(ColKey col_key, bool compressed)
+    {
+        m_encoder.set_compressed(col_key, !compressed);
+        append_instruction();
+        return true;
+    }
+
     bool select_collection(ColKey col_key, ObjKey key)
     {
         sync_list();
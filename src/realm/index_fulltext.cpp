@@ -0,0 +1,86 @@
+/*************************************************************************
+ *
+ * Copyright 2022 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/index_fulltext.hpp>
+#include <realm/array_string.hpp>
+#include <realm/cluster.hpp>
+#include <realm/table.hpp>
+#include <realm/unicode.hpp>
+
+#include <algorithm>
+
+using namespace realm;
+
+FulltextIndex::FulltextIndex(const Table& table, ColKey col_key)
+{
+    REALM_ASSERT(col_key.get_type() == col_type_String && !col_key.is_collection());
+    ArrayString leaf(table.get_alloc());
+    // The clusters are traversed in key order, so every posting list comes out sorted
+    table.traverse_clusters([&](const Cluster* cluster) {
+        cluster->init_leaf(col_key, &leaf);
+        const size_t sz = cluster->node_size();
+        for (size_t i = 0; i < sz; ++i) {
+            StringData value = leaf.get(i);
+            if (value.size() == 0)
+                continue;
+            ObjKey key = cluster->get_real_key(i);
+            for (auto& word : tokenize_words(value)) {
+                m_postings[word].push_back(key);
+            }
+        }
+        return false; // Continue
+    });
+}
+
+size_t FulltextIndex::memory_usage() const noexcept
+{
+    // Every entry is a hash node holding the word and its posting list
+    size_t usage = m_postings.bucket_count() * sizeof(void*);
+    for (auto& [word, keys] : m_postings)
+        usage += sizeof(decltype(m_postings)::value_type) + 2 * sizeof(void*) + word.capacity() + 1 +
+                 keys.capacity() * sizeof(ObjKey);
+    return usage;
+}
+
+std::vector<ObjKey> FulltextIndex::find_all(StringData text) const
+{
+    std::vector<const std::vector<ObjKey>*> lists;
+    for (auto& word : tokenize_words(text)) {
+        auto it = m_postings.find(word);
+        if (it == m_postings.end())
+            return {};
+        lists.push_back(&it->second);
+    }
+    if (lists.empty())
+        return {};
+
+    // Start from the rarest word, so the candidates only shrink from there
+    std::sort(lists.begin(), lists.end(), [](auto a, auto b) {
+        return a->size() < b->size();
+    });
+    std::vector<ObjKey> result = *lists.front();
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        auto& list = *lists[i];
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [&](ObjKey key) {
+                                        return !std::binary_search(list.begin(), list.end(), key);
+                                    }),
+                     result.end());
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+/*************************************************************************
+ *
+ * Copyright 2022 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_FULLTEXT_HPP
+#define REALM_INDEX_FULLTEXT_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <realm/keys.hpp>
+#include <realm/string_data.hpp>
+
+namespace realm {
+
+class Table;
+
+/*
+The FulltextIndex maps each word (see tokenize_words()) occurring in a string column to the keys of the objects
+containing it. It is not stored in the file, but built from the column when first needed, and is only valid
+for the version of the table it was built from. Table::get_fulltext_index() takes care of that.
+*/
+class FulltextIndex {
+public:
+    FulltextIndex(const Table& table, ColKey col_key);
+
+    /// Returns the keys, in ascending order, of the objects containing every word of \a text. If \a text
+    /// contains no words, nothing matches.
+    std::vector<ObjKey> find_all(StringData text) const;
+
+    size_t num_words() const noexcept
+    {
+        return m_postings.size();
+    }
+
+    /// An estimate of the heap memory held by the index, in bytes.
+    size_t memory_usage() const noexcept;
+
+private:
+    std::unordered_map<std::string, std::vector<ObjKey>> m_postings;
+};
+
+} // namespace realm
+
+#endif // REALM_INDEX_FULLTEXT_HPP
@@ -42,6 +42,25 @@ void get_child(Array& parent, size_t child_ref_ndx, Array& child) noexcept
     child.set_parent(&parent, child_ref_ndx);
 }
 
+// Keys are always 32 bits wide, unless the array holding them was encoded when
+// it was written to the file.
+size_t lower_bound_key(const char* offsets_header, ref_type offsets_ref, size_t offsets_size, int64_t key,
+                       Allocator& alloc) noexcept
+{
+    if (REALM_LIKELY(NodeHeader::get_wtype_from_header(offsets_header) != NodeHeader::wtype_Encoded))
+        return ::lower_bound<32>(NodeHeader::get_data_from_header(offsets_header), offsets_size, key);
+    Array offsets(alloc);
+    offsets.init_from_mem(MemRef(const_cast<char*>(offsets_header), offsets_ref, alloc));
+    return offsets.lower_bound_int(key);
+}
+
+StringIndex::key_type get_key(const char* offsets_header, size_t pos) noexcept
+{
+    if (REALM_LIKELY(NodeHeader::get_wtype_from_header(offsets_header) != NodeHeader::wtype_Encoded))
+        return StringIndex::key_type(get_direct<32>(NodeHeader::get_data_from_header(offsets_header), pos));
+    return StringIndex::key_type(Array::get(offsets_header, pos));
+}
+
 } // anonymous namespace
 
 DataType ClusterColumn::get_data_type() const
@@ -187,9 +206,8 @@ int64_t IndexArray::index_string(Mixed value, InternalFindResult& result_ref, co
 
         // Find the position matching the key
         const char* offsets_header = m_alloc.translate(offsets_ref);
-        const char* offsets_data = get_data_from_header(offsets_header);
         size_t offsets_size = get_size_from_header(offsets_header);
-        size_t pos = ::lower_bound<32>(offsets_data, offsets_size, key); // keys are always 32 bits wide
+        size_t pos = lower_bound_key(offsets_header, offsets_ref, offsets_size, key, m_alloc);
 
         // If key is outside range, we know there can be no match
         if (pos == offsets_size)
@@ -208,7 +226,7 @@ int64_t IndexArray::index_string(Mixed value, InternalFindResult& result_ref, co
             continue;
         }
 
-        key_type stored_key = key_type(get_direct<32>(offsets_data, pos));
+        key_type stored_key = get_key(offsets_header, pos);
 
         if (stored_key != key)
             return local_not_found;
@@ -442,9 +460,8 @@ void IndexArray::index_string_all_ins(StringData value, std::vector<ObjKey>& res
 
         // Find the position matching the key
         const char* const offsets_header = m_alloc.translate(offsets_ref);
-        const char* const offsets_data = get_data_from_header(offsets_header);
         const size_t offsets_size = get_size_from_header(offsets_header);
-        const size_t pos = ::lower_bound<32>(offsets_data, offsets_size, key); // keys are always 32 bits wide
+        const size_t pos = lower_bound_key(offsets_header, offsets_ref, offsets_size, key, m_alloc);
 
         // If key is outside range, we know there can be no match
         if (pos == offsets_size)
@@ -461,7 +478,7 @@ void IndexArray::index_string_all_ins(StringData value, std::vector<ObjKey>& res
             continue;
         }
 
-        const key_type stored_key = key_type(get_direct<32>(offsets_data, pos));
+        const key_type stored_key = get_key(offsets_header, pos);
 
         if (stored_key != key)
             continue;
@@ -518,9 +535,8 @@ void IndexArray::index_string_all(Mixed value, std::vector<ObjKey>& result, cons
 
         // Find the position matching the key
         const char* offsets_header = m_alloc.translate(offsets_ref);
-        const char* offsets_data = get_data_from_header(offsets_header);
         size_t offsets_size = get_size_from_header(offsets_header);
-        size_t pos = ::lower_bound<32>(offsets_data, offsets_size, key); // keys are always 32 bits wide
+        size_t pos = lower_bound_key(offsets_header, offsets_ref, offsets_size, key, m_alloc);
 
         // If key is outside range, we know there can be no match
         if (pos == offsets_size)
@@ -539,7 +555,7 @@ void IndexArray::index_string_all(Mixed value, std::vector<ObjKey>& result, cons
             continue;
         }
 
-        key_type stored_key = key_type(get_direct<32>(offsets_data, pos));
+        key_type stored_key = get_key(offsets_header, pos);
 
         if (stored_key != key)
             return;
@@ -1044,6 +1060,16 @@ bool StringIndex::leaf_insert(ObjKey obj_key, key_type key, size_t offset, Strin
         IntegerColumn sub(alloc, ref); // Throws
         sub.set_parent(m_array.get(), ins_pos_refs);
 
+        // Bulk loads insert the values in sorted order and the new objects
+        // have the highest keys, so a duplicate usually belongs at the end of
+        // the list. Checking that first saves the binary searches below, which
+        // have to look up the value of every object they compare with.
+        int64_t last_in_list = sub.back();
+        if (obj_key.value > last_in_list && get(ObjKey(last_in_list)) == value) {
+            sub.add(obj_key.value);
+            return true;
+        }
+
         SortedListComparator slc(m_target_column);
         IntegerColumn::const_iterator it_end = sub.cend();
         IntegerColumn::const_iterator lower = std::lower_bound(sub.cbegin(), it_end, value, slc);
@@ -98,6 +98,9 @@ public:
     }
 
     T get(size_t ndx) const;
+    // Copy the values in [begin, end) to `out`, which is much faster than
+    // calling get() for each of them for large ranges
+    void get_range(size_t begin, size_t end, T* out) const;
     size_t find_first(const T& value) const;
     T set(size_t ndx, T value);
     void insert(size_t ndx, T value);
@@ -248,6 +251,7 @@ protected:
     {
         if (!m_tree) {
             m_tree.reset(new BPlusTree<T>(m_obj.get_alloc()));
+            m_tree->set_max_node_size(m_obj.get_table()->get_collection_node_size());
             const ArrayParent* parent = this;
             m_tree->set_parent(const_cast<ArrayParent*>(parent), 0);
         }
@@ -682,6 +686,26 @@ inline T Lst<T>::get(size_t ndx) const
     return value;
 }
 
+template <class T>
+void Lst<T>::get_range(size_t begin, size_t end, T* out) const
+{
+    const auto current_size = size();
+    if (begin > end || end > current_size) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (begin == end)
+        return;
+
+    m_tree->get_range(begin, end, out);
+    if constexpr (std::is_same_v<T, Mixed>) {
+        // return a null for mixed unresolved link
+        for (size_t i = 0; i < end - begin; ++i) {
+            if (out[i].is_type(type_TypedLink) && out[i].is_unresolved_link())
+                out[i] = Mixed{};
+        }
+    }
+}
+
 template <class T>
 inline size_t Lst<T>::find_first(const T& value) const
 {
@@ -836,19 +860,7 @@ void Lst<T>::move(size_t from, size_t to)
         if (Replication* repl = this->m_obj.get_replication()) {
             repl->list_move(*this, from, to);
         }
-        if (to > from) {
-            to++;
-        }
-        else {
-            from++;
-        }
-        // We use swap here as it handles the special case for StringData where
-        // 'to' and 'from' points into the same array. In this case you cannot
-        // set an entry with the result of a get from another entry in the same
-        // leaf.
-        m_tree->insert(to, BPlusTree<T>::default_value(m_nullable));
-        m_tree->swap(from, to);
-        m_tree->erase(from);
+        m_tree->move(from, to);
 
         bump_content_version();
     }
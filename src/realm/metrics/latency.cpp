@@ -0,0 +1,186 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/metrics/latency.hpp>
+#include <realm/utilities.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace realm;
+using namespace realm::metrics;
+
+namespace {
+
+// The shard used by the thread, assigned round robin
+std::atomic<size_t> g_next_shard{0};
+thread_local size_t t_shard = g_next_shard.fetch_add(1, std::memory_order_relaxed);
+
+// The metrics for which a LatencyTimer is running on the thread
+thread_local uint32_t t_active_timers = 0;
+
+int log2_64(uint64_t value)
+{
+    if (value >> 32)
+        return 32 + realm::log2(size_t(value >> 32));
+    return realm::log2(size_t(value));
+}
+
+} // anonymous namespace
+
+const char* realm::metrics::get_latency_metric_name(LatencyMetric metric) noexcept
+{
+    switch (metric) {
+        case LatencyMetric::begin_read:
+            return "begin_read";
+        case LatencyMetric::commit:
+            return "commit";
+        case LatencyMetric::fsync:
+            return "fsync";
+        case LatencyMetric::query:
+            return "query";
+        case LatencyMetric::notifier_run:
+            return "notifier_run";
+        case LatencyMetric::sync_integrate:
+            return "sync_integrate";
+        case LatencyMetric::sync_upload:
+            return "sync_upload";
+    }
+    return "unknown";
+}
+
+size_t LatencyHistogram::get_bucket(uint64_t nanoseconds) noexcept
+{
+    constexpr uint64_t sub_buckets = uint64_t(1) << sub_bucket_bits;
+    if (nanoseconds < sub_buckets)
+        return size_t(nanoseconds);
+    int exponent = log2_64(nanoseconds);
+    if (exponent > max_exponent)
+        return num_buckets - 1;
+    size_t sub_bucket = size_t(nanoseconds >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+    return (size_t(exponent - sub_bucket_bits + 1) << sub_bucket_bits) + sub_bucket;
+}
+
+uint64_t LatencyHistogram::get_bucket_limit(size_t bucket) noexcept
+{
+    constexpr size_t sub_buckets = size_t(1) << sub_bucket_bits;
+    if (bucket < sub_buckets)
+        return bucket;
+    int shift = int(bucket >> sub_bucket_bits) - 1;
+    uint64_t lower = uint64_t(sub_buckets + (bucket & (sub_buckets - 1))) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::get_percentile(double percentile) const noexcept
+{
+    if (count == 0)
+        return 0;
+    auto rank = uint64_t(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * double(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min(get_bucket_limit(i), max_nanoseconds);
+    }
+    return max_nanoseconds;
+}
+
+struct alignas(64) LatencyRegistry::Shard {
+    struct Counters {
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> max{0};
+        std::array<std::atomic<uint64_t>, LatencyHistogram::num_buckets> buckets = {};
+    };
+    std::array<Counters, num_latency_metrics> metrics;
+};
+
+std::atomic<bool> LatencyRegistry::s_enabled{true};
+
+LatencyRegistry::LatencyRegistry()
+    : m_shards(new Shard[num_shards])
+{
+}
+
+LatencyRegistry::~LatencyRegistry() = default;
+
+LatencyRegistry& LatencyRegistry::get() noexcept
+{
+    // Never destroyed, as threads may still record while the process exits
+    static LatencyRegistry* registry = new LatencyRegistry;
+    return *registry;
+}
+
+void LatencyRegistry::record(LatencyMetric metric, uint64_t nanoseconds) noexcept
+{
+    auto& counters = m_shards[t_shard % num_shards].metrics[size_t(metric)];
+    counters.buckets[LatencyHistogram::get_bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    counters.total.fetch_add(nanoseconds, std::memory_order_relaxed);
+    uint64_t max = counters.max.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !counters.max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+        ;
+}
+
+LatencyHistogram LatencyRegistry::get_snapshot(LatencyMetric metric) const noexcept
+{
+    LatencyHistogram histogram;
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto& counters = m_shards[i].metrics[size_t(metric)];
+        histogram.total_nanoseconds += counters.total.load(std::memory_order_relaxed);
+        histogram.max_nanoseconds = std::max(histogram.max_nanoseconds, counters.max.load(std::memory_order_relaxed));
+        for (size_t j = 0; j < LatencyHistogram::num_buckets; ++j)
+            histogram.buckets[j] += counters.buckets[j].load(std::memory_order_relaxed);
+    }
+    // Counted from the buckets, so that the percentiles are consistent with
+    // the count even if values were recorded meanwhile
+    for (auto n : histogram.buckets)
+        histogram.count += n;
+    return histogram;
+}
+
+void LatencyRegistry::reset() noexcept
+{
+    for (size_t i = 0; i < num_shards; ++i) {
+        for (auto& counters : m_shards[i].metrics) {
+            counters.total.store(0, std::memory_order_relaxed);
+            counters.max.store(0, std::memory_order_relaxed);
+            for (auto& bucket : counters.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+LatencyTimer::LatencyTimer(LatencyMetric metric) noexcept
+    : m_metric(metric)
+{
+    uint32_t mask = uint32_t(1) << unsigned(metric);
+    if (!LatencyRegistry::is_enabled() || (t_active_timers & mask))
+        return;
+    t_active_timers |= mask;
+    m_active = true;
+    m_start = clock::now();
+}
+
+LatencyTimer::~LatencyTimer()
+{
+    if (!m_active)
+        return;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start).count();
+    t_active_timers &= ~(uint32_t(1) << unsigned(m_metric));
+    LatencyRegistry::get().record(m_metric, uint64_t(std::max<int64_t>(elapsed, 0)));
+}
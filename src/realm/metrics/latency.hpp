@@ -0,0 +1,129 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_METRICS_LATENCY_HPP
+#define REALM_METRICS_LATENCY_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace realm::metrics {
+
+/// The operations whose latencies are recorded by the LatencyRegistry.
+enum class LatencyMetric : uint8_t {
+    begin_read,     // DB::start_read()
+    commit,         // Committing a write transaction, including the fsync
+    fsync,          // Making a commit durable
+    query,          // Evaluating a query, including aggregates and counts
+    notifier_run,   // Running the notifiers of a Realm in the background
+    sync_integrate, // Integrating changesets downloaded from the server
+    sync_upload,    // Preparing an upload message
+};
+constexpr size_t num_latency_metrics = 7;
+
+const char* get_latency_metric_name(LatencyMetric metric) noexcept;
+
+/// A log-linear histogram of latencies in nanoseconds, in the style of HDR
+/// histograms. Values below 8ns are counted exactly. Above that, every power
+/// of two is split into 8 buckets, so a value is known to within 12.5%.
+/// Values of 2^37ns (about 2 minutes) and above go into the last bucket.
+struct LatencyHistogram {
+    static constexpr int sub_bucket_bits = 3;
+    static constexpr int max_exponent = 36;
+    static constexpr size_t num_buckets = size_t(max_exponent - sub_bucket_bits + 2) << sub_bucket_bits;
+
+    uint64_t count = 0;
+    uint64_t total_nanoseconds = 0;
+    uint64_t max_nanoseconds = 0;
+    std::array<uint64_t, num_buckets> buckets = {};
+
+    static size_t get_bucket(uint64_t nanoseconds) noexcept;
+    /// The largest value which goes into the bucket.
+    static uint64_t get_bucket_limit(size_t bucket) noexcept;
+
+    /// The value at or below which `percentile` percent of the recorded values
+    /// are, rounded up to the limit of its bucket. Returns 0 if nothing has
+    /// been recorded.
+    uint64_t get_percentile(double percentile) const noexcept;
+};
+
+/// Records the latencies of the operations listed in LatencyMetric for the
+/// whole process. Recording is cheap enough to be left on: each thread records
+/// into one of a fixed number of shards with relaxed atomic increments, so
+/// threads rarely contend on the same cache lines, and nothing is allocated or
+/// locked. The shards are only combined when a snapshot is taken.
+class LatencyRegistry {
+public:
+    static LatencyRegistry& get() noexcept;
+
+    /// Recording is enabled by default.
+    static void set_enabled(bool enabled) noexcept
+    {
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    static bool is_enabled() noexcept
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(LatencyMetric metric, uint64_t nanoseconds) noexcept;
+
+    /// The values recorded since the start of the process, or since the last
+    /// call to reset(). Values which are recorded while the snapshot is taken
+    /// may or may not be included.
+    LatencyHistogram get_snapshot(LatencyMetric metric) const noexcept;
+
+    void reset() noexcept;
+
+private:
+    static constexpr size_t num_shards = 8;
+    struct Shard;
+
+    static std::atomic<bool> s_enabled;
+    std::unique_ptr<Shard[]> m_shards;
+
+    LatencyRegistry();
+    ~LatencyRegistry();
+};
+
+/// Records the time from its construction to its destruction in the registry.
+/// Nested timers for the same metric on the same thread are ignored, so that
+/// e.g. a query which is evaluated by way of another query function is only
+/// counted once.
+class LatencyTimer {
+public:
+    explicit LatencyTimer(LatencyMetric metric) noexcept;
+    ~LatencyTimer();
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    LatencyMetric m_metric;
+    bool m_active = false;
+    clock::time_point m_start;
+};
+
+} // namespace realm::metrics
+
+#endif // REALM_METRICS_LATENCY_HPP
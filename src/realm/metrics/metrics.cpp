@@ -116,6 +116,17 @@ std::unique_ptr<MetricTimer> Metrics::report_write_time(const Group& g)
     return nullptr;
 }
 
+void Metrics::report_map_window_usage(const Group& g, size_t hits, size_t misses)
+{
+    std::shared_ptr<Metrics> instance = g.get_metrics();
+    if (instance) {
+        REALM_ASSERT_DEBUG(instance->m_transaction_info);
+        if (instance->m_pending_write) {
+            instance->m_pending_write->m_num_map_window_hits = hits;
+            instance->m_pending_write->m_num_map_window_misses = misses;
+        }
+    }
+}
 
 std::unique_ptr<Metrics::QueryInfoList> Metrics::take_queries()
 {
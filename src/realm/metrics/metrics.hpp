@@ -50,6 +50,7 @@ public:
                                size_t num_decrypted_pages);
     static std::unique_ptr<MetricTimer> report_fsync_time(const Group& g);
     static std::unique_ptr<MetricTimer> report_write_time(const Group& g);
+    static void report_map_window_usage(const Group& g, size_t hits, size_t misses);
 
     using QueryInfoList = util::FixedSizeBuffer<QueryInfo>;
     using TransactionInfoList = util::FixedSizeBuffer<TransactionInfo>;
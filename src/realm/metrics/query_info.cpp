@@ -39,6 +39,7 @@ QueryInfo::QueryInfo(const Query* query, QueryType type)
     } catch (const SerialisationError& e) {
         m_description = e.what();
     }
+    m_plan = query->get_plan_description();
     m_table_name = query->m_table->get_name();
 #else
     static_cast<void>(query);
@@ -54,6 +55,11 @@ std::string QueryInfo::get_description() const
     return m_description;
 }
 
+std::string QueryInfo::get_plan() const
+{
+    return m_plan;
+}
+
 std::string QueryInfo::get_table_name() const
 {
     return m_table_name;
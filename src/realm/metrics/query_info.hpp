@@ -50,6 +50,9 @@ public:
     ~QueryInfo() noexcept;
 
     std::string get_description() const;
+    // The conditions in the order the query engine will first try them, with the access path chosen for each
+    // and the selectivity measured when sampling the table.
+    std::string get_plan() const;
     std::string get_table_name() const;
     QueryType get_type() const;
     nanosecond_storage_t get_query_time_nanoseconds() const;
@@ -59,6 +62,7 @@ public:
 
 private:
     std::string m_description;
+    std::string m_plan;
     std::string m_table_name;
     QueryType m_type;
     std::shared_ptr<MetricTimerResult> m_query_time;
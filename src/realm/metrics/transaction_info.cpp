@@ -28,6 +28,8 @@ TransactionInfo::TransactionInfo(TransactionInfo::TransactionType type)
     , m_type(type)
     , m_num_versions(0)
     , m_num_decrypted_pages(0)
+    , m_num_map_window_hits(0)
+    , m_num_map_window_misses(0)
 {
 #if REALM_METRICS
     if (m_type == write_transaction) {
@@ -92,6 +94,16 @@ size_t TransactionInfo::get_num_decrypted_pages() const
     return m_num_decrypted_pages;
 }
 
+size_t TransactionInfo::get_num_map_window_hits() const
+{
+    return m_num_map_window_hits;
+}
+
+size_t TransactionInfo::get_num_map_window_misses() const
+{
+    return m_num_map_window_misses;
+}
+
 void TransactionInfo::update_stats(size_t disk_size, size_t free_space, size_t total_objects,
                                    size_t available_versions, size_t num_decrypted_pages)
 {
@@ -47,6 +47,9 @@ public:
     size_t get_total_objects() const;
     size_t get_num_available_versions() const;
     size_t get_num_decrypted_pages() const;
+    // lookups of a write window served by an open one, and lookups which had to map one
+    size_t get_num_map_window_hits() const;
+    size_t get_num_map_window_misses() const;
 
 private:
     MetricTimerResult m_transaction_time;
@@ -60,6 +63,8 @@ private:
     TransactionType m_type;
     size_t m_num_versions;
     size_t m_num_decrypted_pages;
+    size_t m_num_map_window_hits;
+    size_t m_num_map_window_misses;
 
     friend class Metrics;
     void update_stats(size_t disk_size, size_t free_space, size_t total_objects, size_t available_versions,
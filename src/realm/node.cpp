@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/node.hpp>
+#include <realm/array_direct.hpp>
 #include <realm/utilities.hpp>
 #include <realm/mixed.hpp>
 
@@ -123,12 +124,34 @@ void Node::alloc(size_t init_size, size_t new_width)
     m_size = init_size;
 }
 
+void Node::decode(const char* header, size_t num_elems, char* dest_header) noexcept
+{
+    REALM_ASSERT_DEBUG(get_wtype_from_header(header) == wtype_Encoded);
+    int width = get_width_from_header(header);
+    init_header(dest_header, get_is_inner_bptree_node_from_header(header), get_hasrefs_from_header(header),
+                get_context_flag_from_header(header), wtype_Bits, width, get_size_from_header(header), 0);
+
+    int64_t base = get_encoded_base(header);
+    const char* offsets_header = get_encoded_offsets_header(header);
+    const char* offsets = get_data_from_header(offsets_header);
+    size_t offsets_width = get_width_from_header(offsets_header);
+    char* data = get_data_from_header(dest_header);
+    for (size_t i = 0; i < num_elems; ++i)
+        set_direct(data, width, i, base + get_direct(offsets, offsets_width, i));
+}
+
 void Node::do_copy_on_write(size_t minimum_size)
 {
     const char* header = get_header_from_data(m_data);
 
+    // Arrays are only encoded when written to the file, so this is where they
+    // turn back into plain ones.
+    bool is_encoded = get_wtype_from_header(header) == wtype_Encoded;
+
     // Calculate size in bytes
-    size_t array_size = calc_byte_len(m_size, get_width_from_header(header));
+    size_t width = get_width_from_header(header);
+    size_t array_size = is_encoded ? calc_byte_size(wtype_Bits, m_size, uint_least8_t(width))
+                                   : calc_byte_len(m_size, width);
     size_t new_size = std::max(array_size, minimum_size);
     new_size = (new_size + 0x7) & ~size_t(0x7); // 64bit blocks
     // Plus a bit of matchcount room for expansion
@@ -139,7 +162,12 @@ void Node::do_copy_on_write(size_t minimum_size)
     const char* old_begin = header;
     const char* old_end = header + array_size;
     char* new_begin = mref.get_addr();
-    realm::safe_copy_n(old_begin, old_end - old_begin, new_begin);
+    if (REALM_UNLIKELY(is_encoded)) {
+        decode(header, m_size, new_begin);
+    }
+    else {
+        realm::safe_copy_n(old_begin, old_end - old_begin, new_begin);
+    }
 
     ref_type old_ref = m_ref;
 
@@ -336,6 +336,12 @@ protected:
     static void init_header(char* header, bool is_inner_bptree_node, bool has_refs, bool context_flag,
                             WidthType width_type, int width, size_t size, size_t capacity) noexcept;
 
+    /// Write a plain (wtype_Bits) copy of the first \a num_elems elements of
+    /// the specified encoded array to \a dest_header. The destination must have
+    /// room for `calc_byte_size(wtype_Bits, num_elems, width)` bytes. Its
+    /// capacity is left for the caller to set.
+    static void decode(const char* header, size_t num_elems, char* dest_header) noexcept;
+
 private:
     ArrayParent* m_parent = nullptr;
     size_t m_ndx_in_parent = 0; // Ignored if m_parent is null.
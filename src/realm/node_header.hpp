@@ -20,6 +20,9 @@
 #define REALM_NODE_HEADER_HPP
 
 #include <realm/util/assert.hpp>
+#include <realm/util/crc32c.hpp>
+
+#include <cstring>
 
 namespace realm {
 
@@ -52,10 +55,14 @@ public:
         wtype_Bits = 0,     // width indicates how many bits every element occupies
         wtype_Multiply = 1, // width indicates how many bytes every element occupies
         wtype_Ignore = 2,   // each element is 1 byte
+        wtype_Encoded = 3,  // frame-of-reference encoded integers, see get_encoded_base()
     };
 
     static const int header_size = 8; // Number of bytes used by header
 
+    /// Number of bytes in the payload of an encoded array that precede the packed offsets.
+    static const int encoded_prefix_size = 8 + header_size;
+
     // The encryption layer relies on headers always fitting within a single page.
     static_assert(header_size == 8, "Header must always fit in entirely on a page");
 
@@ -159,6 +166,7 @@ public:
         // 0: bits      (width/8) * size
         // 1: multiply  width * size
         // 2: ignore    1 * size
+        // 3: encoded   see get_byte_size_from_header()
         typedef unsigned char uchar;
         uchar* h = reinterpret_cast<uchar*>(header);
         h[4] = uchar((int(h[4]) & ~0x18) | int(value) << 3);
@@ -200,11 +208,53 @@ public:
         h[2] = uchar(value >> 3 & 0x000000FF);
     }
 
+    /// An encoded integer array (wtype_Encoded) stores every element as an
+    /// offset from a common base. The payload consists of the 64-bit base
+    /// followed by a complete plain (wtype_Bits) array holding the offsets,
+    /// header included. The width of the encoded array itself remains the one
+    /// it had before it was encoded, which is what it decodes back to.
+    ///
+    /// Arrays are only encoded while being written to the file, so they are
+    /// always in read-only memory.
+    static int64_t get_encoded_base(const char* header) noexcept
+    {
+        int64_t base;
+        std::memcpy(&base, get_data_from_header(header), sizeof base);
+        return base;
+    }
+
+    static const char* get_encoded_offsets_header(const char* header) noexcept
+    {
+        return get_data_from_header(header) + 8;
+    }
+
+    /// In the file, the first 4 bytes of the header hold either this
+    /// signature, or the checksum of the array when it was written with
+    /// checksums (DBOptions::enable_array_checksums).
+    static constexpr uint32_t unchecked_signature = 0x41414141; // "AAAA" in ASCII
+
+    static uint32_t get_checksum_from_header(const char* header) noexcept
+    {
+        uint32_t checksum;
+        std::memcpy(&checksum, header, sizeof checksum);
+        return checksum;
+    }
+
+    /// The CRC-32C of the `byte_size` bytes of the array at `header`, but
+    /// for the first 4, which is where the checksum goes. An array whose
+    /// checksum happens to be the unchecked signature is not checked.
+    static uint32_t calc_checksum(const char* header, size_t byte_size) noexcept
+    {
+        return util::crc32c(header + 4, byte_size - 4);
+    }
+
     static size_t get_byte_size_from_header(const char* header) noexcept
     {
         size_t size = get_size_from_header(header);
         uint_least8_t width = get_width_from_header(header);
         WidthType wtype = get_wtype_from_header(header);
+        if (wtype == wtype_Encoded)
+            return header_size + 8 + get_byte_size_from_header(get_encoded_offsets_header(header));
         size_t num_bytes = calc_byte_size(wtype, size, width);
 
         return num_bytes;
@@ -229,6 +279,9 @@ public:
             case wtype_Ignore:
                 num_bytes = size;
                 break;
+            case wtype_Encoded:
+                // Depends on the width of the offsets, see get_byte_size_from_header()
+                REALM_UNREACHABLE();
         }
 
         // Ensure 8-byte alignment
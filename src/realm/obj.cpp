@@ -283,6 +283,12 @@ T Obj::get(ColKey col_key) const
     return _get<T>(col_key.get_index());
 }
 
+template <class T>
+T Obj::get_unchecked(ColKey col_key) const
+{
+    return _get<T>(col_key.get_index());
+}
+
 template <class T>
 T Obj::_get(ColKey::Idx col_ndx) const
 {
@@ -340,6 +346,8 @@ int64_t Obj::_get<int64_t>(ColKey::Idx col_ndx) const
 
     ref_type ref = to_ref(Array::get(m_mem.get_addr(), col_ndx.val + 1));
     char* header = alloc.translate(ref);
+    if (REALM_UNLIKELY(Array::get_wtype_from_header(header) == Array::wtype_Encoded))
+        return Array::get(header, m_row_ndx);
     int width = Array::get_width_from_header(header);
     char* data = Array::get_data_from_header(header);
     REALM_TEMPEX(return get_direct, width, (data, m_row_ndx));
@@ -491,6 +499,14 @@ Mixed Obj::get_primary_key() const
     return col ? get_any(col) : Mixed{get_key()};
 }
 
+uint64_t Obj::get_modification_version() const
+{
+    auto col = m_table->get_modification_version_column();
+    if (!col)
+        throw LogicError(LogicError::illegal_combination);
+    return uint64_t(get<int64_t>(col));
+}
+
 /* FIXME: Make this one fast too!
 template <>
 ObjKey Obj::_get(size_t col_ndx) const
@@ -799,18 +815,24 @@ inline void out_floats(std::ostream& out, T value)
     out.precision(old);
 }
 
-void out_string(std::ostream& out, std::string str)
+void out_string(std::ostream& out, StringData str)
 {
-    size_t p = str.find_first_of(to_be_escaped);
-    while (p != std::string::npos) {
-        char c = str[p];
-        auto found = strchr(to_be_escaped, c);
-        REALM_ASSERT(found);
-        out << str.substr(0, p) << '\\' << encoding[found - to_be_escaped];
-        str = str.substr(p + 1);
-        p = str.find_first_of(to_be_escaped);
+    // Write the runs of characters that need no escaping in one go
+    const char* begin = str.data();
+    const char* end = begin + str.size();
+    const char* run = begin;
+    for (const char* p = begin; p != end; ++p) {
+        unsigned char c = *p;
+        if (c >= ' ' && c != '"' && c != '\\')
+            continue;
+        const char* found = c ? strchr(to_be_escaped, c) : nullptr;
+        if (!found)
+            continue;
+        out.write(run, p - run);
+        out << '\\' << encoding[found - to_be_escaped];
+        run = p + 1;
     }
-    out << str;
+    out.write(run, end - run);
 }
 
 void out_binary(std::ostream& out, BinaryData bin)
@@ -1002,7 +1024,9 @@ void Obj::to_json(std::ostream& out, size_t link_depth, const std::map<std::stri
     size_t new_depth = link_depth == not_found ? not_found : link_depth - 1;
     StringData name = "_key";
     bool prefixComma = false;
-    if (renames.count(name))
+    // Looking up a StringData in `renames` creates a std::string
+    bool has_renames = !renames.empty();
+    if (has_renames && renames.count(name))
         name = renames.at(name);
     out << "{";
     if (output_mode == output_mode_json) {
@@ -1016,7 +1040,7 @@ void Obj::to_json(std::ostream& out, size_t link_depth, const std::map<std::stri
         auto type = ck.get_type();
         if (type == col_type_LinkList)
             type = col_type_Link;
-        if (renames.count(name))
+        if (has_renames && renames.count(name))
             name = renames.at(name);
 
         if (prefixComma)
@@ -1262,6 +1286,7 @@ Obj& Obj::set<Mixed>(ColKey col_key, Mixed value, bool is_default)
     values.set(m_row_ndx, value);
 
     sync(fields);
+    update_modification_version(col_key);
 
     if (Replication* repl = get_replication())
         repl->set(m_table.unchecked_ptr(), col_key, m_key, value,
@@ -1367,6 +1392,7 @@ Obj& Obj::set<int64_t>(ColKey col_key, int64_t value, bool is_default)
     }
 
     sync(fields);
+    update_modification_version(col_key);
 
     if (Replication* repl = get_replication()) {
         repl->set(m_table.unchecked_ptr(), col_key, m_key, value,
@@ -1445,6 +1471,7 @@ Obj& Obj::add_int(ColKey col_key, int64_t value)
     }
 
     sync(fields);
+    update_modification_version(col_key);
 
     if (Replication* repl = get_replication()) {
         repl->add_int(m_table.unchecked_ptr(), col_key, m_key, value); // Throws
@@ -1458,7 +1485,6 @@ Obj& Obj::set<ObjKey>(ColKey col_key, ObjKey target_key, bool is_default)
 {
     update_if_needed();
     get_table()->check_column(col_key);
-    ColKey::Idx col_ndx = col_key.get_index();
     ColumnType type = col_key.get_type();
     if (type != ColumnTypeTraits<ObjKey>::column_id)
         throw LogicError(LogicError::illegal_type);
@@ -1481,18 +1507,8 @@ Obj& Obj::set<ObjKey>(ColKey col_key, ObjKey target_key, bool is_default)
         bool recurse = replace_backlink(col_key, {target_table_key, old_key}, {target_table_key, target_key}, state);
         _update_if_needed();
 
-        Allocator& alloc = get_alloc();
-        alloc.bump_content_version();
-        Array fallback(alloc);
-        Array& fields = get_tree_top()->get_fields_accessor(fallback, m_mem);
-        REALM_ASSERT(col_ndx.val + 1 < fields.size());
-        ArrayKey values(alloc);
-        values.set_parent(&fields, col_ndx.val + 1);
-        values.init_from_parent();
-
-        values.set(m_row_ndx, target_key);
-
-        sync(fields);
+        set_link_value(col_key, target_key);
+        update_modification_version(col_key);
 
         if (Replication* repl = get_replication()) {
             repl->set(m_table.unchecked_ptr(), col_key, m_key, target_key,
@@ -1538,6 +1554,7 @@ Obj& Obj::set<ObjLink>(ColKey col_key, ObjLink target_link, bool is_default)
         values.set(m_row_ndx, target_link);
 
         sync(fields);
+        update_modification_version(col_key);
 
         if (Replication* repl = get_replication()) {
             repl->set(m_table.unchecked_ptr(), col_key, m_key, target_link,
@@ -1602,6 +1619,7 @@ Obj Obj::create_and_set_linked_object(ColKey col_key, bool is_default)
         values.set(m_row_ndx, target_key);
 
         sync(fields);
+        update_modification_version(col_key);
 
         if (Replication* repl = get_replication()) {
             repl->set(m_table.unchecked_ptr(), col_key, m_key, target_key,
@@ -1646,6 +1664,13 @@ inline void Obj::set_spec<ArrayString>(ArrayString& values, ColKey col_key)
     Spec* spec = const_cast<Spec*>(&get_spec());
     values.set_spec(spec, spec_ndx);
 }
+template <>
+inline void Obj::set_spec<ArrayBinary>(ArrayBinary& values, ColKey col_key)
+{
+    size_t spec_ndx = m_table->colkey2spec_ndx(col_key);
+    Spec* spec = const_cast<Spec*>(&get_spec());
+    values.set_spec(spec, spec_ndx);
+}
 
 template <class T>
 Obj& Obj::set(ColKey col_key, T value, bool is_default)
@@ -1681,6 +1706,7 @@ Obj& Obj::set(ColKey col_key, T value, bool is_default)
     values.set(m_row_ndx, value);
 
     sync(fields);
+    update_modification_version(col_key);
 
     if (Replication* repl = get_replication())
         repl->set(m_table.unchecked_ptr(), col_key, m_key, value,
@@ -1718,6 +1744,32 @@ void Obj::set_int(ColKey col_key, int64_t value)
     sync(fields);
 }
 
+int_fast64_t Obj::bump_content_version()
+{
+    // Collections report their modifications through here
+    update_modification_version();
+    Allocator& alloc = get_alloc();
+    return alloc.bump_content_version();
+}
+
+void Obj::update_modification_version(ColKey modified_col)
+{
+    ColKey col_key = m_table->get_modification_version_column();
+    if (!col_key || col_key == modified_col || m_key.is_unresolved())
+        return;
+
+    // Objects modified in this transaction carry the version the table gets
+    // when it is committed
+    int64_t version = int64_t(m_table->get_modification_version() + 1);
+    if (get<int64_t>(col_key) == version)
+        return;
+
+    if (StringIndex* index = m_table->get_search_index(col_key)) {
+        index->set<int64_t>(m_key, version);
+    }
+    set_int(col_key, version);
+}
+
 void Obj::add_backlink(ColKey backlink_col_key, ObjKey origin_key)
 {
     ColKey::Idx backlink_col_ndx = backlink_col_key.get_index();
@@ -1735,6 +1787,40 @@ void Obj::add_backlink(ColKey backlink_col_key, ObjKey origin_key)
     sync(fields);
 }
 
+void Obj::add_backlinks(ColKey backlink_col_key, const std::vector<ObjKey>& origin_keys)
+{
+    ColKey::Idx backlink_col_ndx = backlink_col_key.get_index();
+    Allocator& alloc = get_alloc();
+    alloc.bump_content_version();
+    Array fallback(alloc);
+    Array& fields = get_tree_top()->get_fields_accessor(fallback, m_mem);
+
+    ArrayBacklink backlinks(alloc);
+    backlinks.set_parent(&fields, backlink_col_ndx.val + 1);
+    backlinks.init_from_parent();
+
+    backlinks.add(m_row_ndx, origin_keys);
+
+    sync(fields);
+}
+
+void Obj::set_link_value(ColKey col_key, ObjKey target_key)
+{
+    ColKey::Idx col_ndx = col_key.get_index();
+    Allocator& alloc = get_alloc();
+    alloc.bump_content_version();
+    Array fallback(alloc);
+    Array& fields = get_tree_top()->get_fields_accessor(fallback, m_mem);
+    REALM_ASSERT(col_ndx.val + 1 < fields.size());
+    ArrayKey values(alloc);
+    values.set_parent(&fields, col_ndx.val + 1);
+    values.init_from_parent();
+
+    values.set(m_row_ndx, target_key);
+
+    sync(fields);
+}
+
 bool Obj::remove_one_backlink(ColKey backlink_col_key, ObjKey origin_key)
 {
     ColKey::Idx backlink_col_ndx = backlink_col_key.get_index();
@@ -2172,6 +2258,26 @@ template Mixed Obj::get<Mixed>(realm::ColKey) const;
 template UUID Obj::get<UUID>(realm::ColKey) const;
 template util::Optional<UUID> Obj::get<util::Optional<UUID>>(ColKey col_key) const;
 
+template int64_t Obj::get_unchecked<int64_t>(ColKey col_key) const;
+template util::Optional<int64_t> Obj::get_unchecked<util::Optional<int64_t>>(ColKey col_key) const;
+template bool Obj::get_unchecked<bool>(ColKey col_key) const;
+template util::Optional<Bool> Obj::get_unchecked<util::Optional<Bool>>(ColKey col_key) const;
+template float Obj::get_unchecked<float>(ColKey col_key) const;
+template util::Optional<float> Obj::get_unchecked<util::Optional<float>>(ColKey col_key) const;
+template double Obj::get_unchecked<double>(ColKey col_key) const;
+template util::Optional<double> Obj::get_unchecked<util::Optional<double>>(ColKey col_key) const;
+template StringData Obj::get_unchecked<StringData>(ColKey col_key) const;
+template BinaryData Obj::get_unchecked<BinaryData>(ColKey col_key) const;
+template Timestamp Obj::get_unchecked<Timestamp>(ColKey col_key) const;
+template ObjectId Obj::get_unchecked<ObjectId>(ColKey col_key) const;
+template util::Optional<ObjectId> Obj::get_unchecked<util::Optional<ObjectId>>(ColKey col_key) const;
+template ObjKey Obj::get_unchecked<ObjKey>(ColKey col_key) const;
+template Decimal128 Obj::get_unchecked<Decimal128>(ColKey col_key) const;
+template ObjLink Obj::get_unchecked<ObjLink>(ColKey col_key) const;
+template Mixed Obj::get_unchecked<Mixed>(ColKey col_key) const;
+template UUID Obj::get_unchecked<UUID>(ColKey col_key) const;
+template util::Optional<UUID> Obj::get_unchecked<util::Optional<UUID>>(ColKey col_key) const;
+
 template <class T>
 inline void Obj::do_set_null(ColKey col_key)
 {
@@ -2269,6 +2375,7 @@ Obj& Obj::set_null(ColKey col_key, bool is_default)
             case col_type_TypedLink:
                 REALM_UNREACHABLE();
         }
+        update_modification_version(col_key);
     }
 
     if (Replication* repl = get_replication())
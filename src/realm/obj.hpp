@@ -142,6 +142,13 @@ public:
 
     template <typename U>
     U get(ColKey col_key) const;
+    /// Same as get(), but without checking that the column belongs to the
+    /// table and has the type of `U`. For accessors which have already verified
+    /// their column keys against the table, like the ones generated by
+    /// realm-schemagen. `U` must also match the nullability of the column,
+    /// e.g. `util::Optional<int64_t>` for a nullable integer column.
+    template <typename U>
+    U get_unchecked(ColKey col_key) const;
 
     Mixed get_any(ColKey col_key) const;
     Mixed get_any(StringData col_name) const
@@ -150,6 +157,10 @@ public:
     }
     Mixed get_any(std::vector<std::string>::iterator path_start, std::vector<std::string>::iterator path_end) const;
     Mixed get_primary_key() const;
+    /// The table modification version as of the transaction which last
+    /// created or modified this object, see
+    /// Table::set_modification_version_column().
+    uint64_t get_modification_version() const;
 
     template <typename U>
     U get(StringData col_name) const
@@ -347,6 +358,7 @@ private:
     template <class>
     friend class Set;
     friend class Table;
+    friend class TableClusterTree;
     friend class Transaction;
 
     mutable TableRef m_table;
@@ -400,6 +412,7 @@ private:
     void sync(Node& arr);
     int_fast64_t bump_content_version();
     void bump_both_versions();
+    void update_modification_version(ColKey modified_col = {});
     template <class T>
     void do_set_null(ColKey col_key);
 
@@ -416,7 +429,10 @@ private:
     }
 
     void set_int(ColKey col_key, int64_t value);
+    // Stores the link without touching the backlinks or replication
+    void set_link_value(ColKey col_key, ObjKey target_key);
     void add_backlink(ColKey backlink_col, ObjKey origin_key);
+    void add_backlinks(ColKey backlink_col, const std::vector<ObjKey>& origin_keys);
     bool remove_one_backlink(ColKey backlink_col, ObjKey origin_key);
     void nullify_link(ColKey origin_col, ObjLink target_key) &&;
     // Used when inserting a new link. You will not remove existing links in this process
@@ -603,12 +619,6 @@ inline bool Obj::update_if_needed() const
     return false;
 }
 
-inline int_fast64_t Obj::bump_content_version()
-{
-    Allocator& alloc = get_alloc();
-    return alloc.bump_content_version();
-}
-
 inline void Obj::bump_both_versions()
 {
     Allocator& alloc = get_alloc();
@@ -312,6 +312,7 @@ public:
     bool insert_column(ColKey) { unexpected_instruction(); }
     bool erase_column(ColKey) { unexpected_instruction(); }
     bool rename_column(ColKey) { unexpected_instruction(); }
+    bool set_compressed(ColKey, bool) { unexpected_instruction(); }
     bool set_link_type(ColKey) { unexpected_instruction(); }
     bool typed_link_change(ColKey, TableKey) { unexpected_instruction(); }
     // clang-format on
@@ -481,24 +482,26 @@ struct MetadataSchema {
     ColKey col_data;
 };
 
-class AuditEventWriter {
+// An audit event converted to the values stored in the audit Realm
+struct SerializedEvent {
+    Timestamp timestamp;
+    std::string activity;
+    util::Optional<std::string> event_type;
+    util::Optional<std::string> data;
+};
+
+class AuditEventSerializer {
 public:
-    AuditEventWriter(DB& db, MetadataSchema const& metadata, StringData activity_name, Table& audit_table,
-                     AuditObjectSerializer& serializer)
+    AuditEventSerializer(DB& db, StringData activity_name, AuditObjectSerializer& serializer,
+                         std::vector<SerializedEvent>& out)
         : m_source_db(db)
-        , m_schema(metadata)
         , m_serializer(serializer)
-        , m_table(audit_table)
-        , m_repl(*m_table.get_parent_group()->get_replication())
-        , m_repl_buffer([=]() -> const util::AppendBuffer<char>& {
-            REALM_ASSERT(typeid(m_repl) == typeid(sync::ClientReplication));
-            return static_cast<sync::SyncReplication&>(m_repl).get_instruction_encoder().buffer();
-        }())
         , m_activity(activity_name)
+        , m_out(out)
     {
     }
 
-    bool operator()(audit_event::Query const& query)
+    void operator()(audit_event::Query const& query)
     {
         auto& g = read(query.version);
         nlohmann::json data;
@@ -507,11 +510,10 @@ public:
         auto& value = data["value"];
         for (auto& obj : query.objects)
             m_serializer.to_json(value[value.size()], table->get_object(obj));
-        auto str = data.dump();
-        return write_event(query.timestamp, m_activity, "read", str);
+        m_out.push_back({query.timestamp, m_activity, std::string("read"), data.dump()});
     }
 
-    bool operator()(audit_event::Write const& write)
+    void operator()(audit_event::Write const& write)
     {
         auto& g = read(write.prev_version);
         TransactLogHandler changes(g, m_serializer);
@@ -519,11 +521,10 @@ public:
         changes.after_advance();
 
         if (changes.has_any_changes())
-            return write_event(write.timestamp, m_activity, "write", changes.data());
-        return 0;
+            m_out.push_back({write.timestamp, m_activity, std::string("write"), changes.data()});
     }
 
-    bool operator()(audit_event::Object const& obj)
+    void operator()(audit_event::Object const& obj)
     {
         auto& g = read(obj.version);
         auto table = g.get_table(obj.table);
@@ -531,29 +532,22 @@ public:
         nlohmann::json data;
         data["type"] = ObjectStore::object_type_for_table_name(table->get_name());
         m_serializer.to_json(data["value"][0], table->get_object(obj.obj));
-        auto str = data.dump();
-        return write_event(obj.timestamp, m_activity, "read", str);
+        m_out.push_back({obj.timestamp, m_activity, std::string("read"), data.dump()});
     }
 
-    bool operator()(audit_event::Custom const& event)
+    void operator()(audit_event::Custom const& event)
     {
-        return write_event(event.timestamp, event.activity, event.event_type, event.data);
+        m_out.push_back({event.timestamp, event.activity, event.event_type, event.data});
     }
 
 private:
     DB& m_source_db;
-    MetadataSchema const& m_schema;
     AuditObjectSerializer& m_serializer;
-    Table& m_table;
-    Replication& m_repl;
-    const util::AppendBuffer<char>& m_repl_buffer;
-    const StringData m_activity;
+    const std::string m_activity;
+    std::vector<SerializedEvent>& m_out;
 
     TransactionRef m_source_transaction;
 
-    std::vector<uint8_t> m_compress_buffer;
-    std::vector<uint8_t> m_compress_scratch;
-
     Transaction& read(VersionID v)
     {
         if (!m_source_transaction || m_source_transaction->get_version_of_current_transaction() != v) {
@@ -562,9 +556,29 @@ private:
         }
         return *m_source_transaction;
     }
+};
 
-    bool write_event(Timestamp timestamp, StringData activity, StringData event_type, StringData data)
+class AuditEventWriter {
+public:
+    AuditEventWriter(MetadataSchema const& metadata, Table& audit_table)
+        : m_schema(metadata)
+        , m_table(audit_table)
+        , m_repl(*m_table.get_parent_group()->get_replication())
+        , m_repl_buffer([=]() -> const util::AppendBuffer<char>& {
+            REALM_ASSERT(typeid(m_repl) == typeid(sync::ClientReplication));
+            return static_cast<sync::SyncReplication&>(m_repl).get_instruction_encoder().buffer();
+        }())
     {
+    }
+
+    // Returns true if the event did not fit in the current transaction, in
+    // which case the caller has to commit it and call this again
+    bool write_event(SerializedEvent const& event)
+    {
+        StringData activity = event.activity;
+        StringData event_type = event.event_type ? StringData(*event.event_type) : StringData();
+        StringData data = event.data ? StringData(*event.data) : StringData();
+
         // The server has a maximum body size for UPLOAD messages of 16777217
         // bytes. To avoid exceeding this, we need to calculate the size of the
         // changeset we're going to produce and split it up into multiple
@@ -604,7 +618,7 @@ private:
         auto obj = m_table.create_object_with_primary_key(pk).get_key();
         m_repl.create_object_with_primary_key(&m_table, obj, pk);
 
-        m_repl.set(&m_table, m_schema.col_timestamp, obj, timestamp);
+        m_repl.set(&m_table, m_schema.col_timestamp, obj, event.timestamp);
         m_repl.set(&m_table, m_schema.col_activity, obj, activity);
         if (event_type)
             m_repl.set(&m_table, m_schema.col_event_type, obj, event_type);
@@ -614,6 +628,12 @@ private:
             m_repl.set(&m_table, m_schema.metadata_cols[i], obj, m_schema.metadata[i].second);
         return false;
     }
+
+private:
+    MetadataSchema const& m_schema;
+    Table& m_table;
+    Replication& m_repl;
+    const util::AppendBuffer<char>& m_repl_buffer;
 };
 
 // A pool of audit Realms for a sync user. Each audit scope asks the pool for
@@ -940,6 +960,7 @@ private:
         std::shared_ptr<MetadataSchema> metadata;
         std::string activity_name;
         std::vector<Event> events;
+        std::vector<SerializedEvent> serialized_events;
         std::vector<std::shared_ptr<Transaction>> source_transactions;
         util::UniqueFunction<void(std::exception_ptr)> completion;
     };
@@ -954,9 +975,15 @@ private:
     std::shared_ptr<Scope> m_current_scope GUARDED_BY(m_mutex);
     dispatch_queue_t m_queue;
 
+    // Scopes which have been ended but not yet picked up by the worker queue
+    util::CheckedMutex m_pending_mutex;
+    std::vector<std::shared_ptr<Scope>> m_pending_scopes GUARDED_BY(m_pending_mutex);
+
     void pin_version(VersionID) REQUIRES(m_mutex);
-    void trigger_write(std::shared_ptr<Scope>) REQUIRES(m_mutex);
-    void process_scope(AuditContext::Scope& scope) const;
+    void trigger_write(std::shared_ptr<Scope>) REQUIRES(m_mutex, !m_pending_mutex);
+    void serialize_scope(AuditContext::Scope& scope) const;
+    void write_scope(Transaction& tr, Table& table, AuditContext::Scope& scope) const;
+    void process_scopes(std::vector<std::shared_ptr<Scope>>& scopes) const;
 
     friend class AuditEventWriter;
 };
@@ -1034,6 +1061,7 @@ void AuditContext::record_query(VersionID version, TableView const& tv)
 
     pin_version(version);
     std::vector<ObjKey> objects;
+    objects.reserve(tv.size());
     for (size_t i = 0, count = tv.size(); i < count; ++i)
         objects.push_back(tv.get_key(i));
 
@@ -1116,104 +1144,153 @@ void AuditContext::end_scope(util::UniqueFunction<void(std::exception_ptr)>&& co
     m_current_scope = nullptr;
 }
 
-void AuditContext::process_scope(AuditContext::Scope& scope) const
+void AuditContext::serialize_scope(AuditContext::Scope& scope) const
 {
-    m_logger->info("Audit: Processing scope for '%1'", m_source_db->get_path());
-    try {
-        // Merge single object reads following a query into that query and discard
-        // duplicate reads on objects.
-        {
-            ReadCombiner combiner{*m_logger};
-            auto& events = scope.events;
-            events.erase(std::remove_if(events.begin(), events.end(),
-                                        [&](auto& event) {
-                                            return mpark::visit(combiner, event);
-                                        }),
-                         events.end());
-        }
+    // Merge single object reads following a query into that query and discard
+    // duplicate reads on objects.
+    {
+        ReadCombiner combiner{*m_logger};
+        auto& events = scope.events;
+        events.erase(std::remove_if(events.begin(), events.end(),
+                                    [&](auto& event) {
+                                        return mpark::visit(combiner, event);
+                                    }),
+                     events.end());
+    }
 
-        // Filter out queries which were made empty by the above pass and filter
-        // out reads on newly-created objects
-        {
-            EmptyQueryFilter filter{*m_source_db, *m_logger};
-            auto& events = scope.events;
-            events.erase(std::remove_if(events.begin(), events.end(),
-                                        [&](auto& event) {
-                                            return mpark::visit(filter, event);
-                                        }),
-                         events.end());
+    // Filter out queries which were made empty by the above pass and filter
+    // out reads on newly-created objects
+    {
+        EmptyQueryFilter filter{*m_source_db, *m_logger};
+        auto& events = scope.events;
+        events.erase(std::remove_if(events.begin(), events.end(),
+                                    [&](auto& event) {
+                                        return mpark::visit(filter, event);
+                                    }),
+                     events.end());
+    }
+
+    // Gather information about link accesses so that we can include
+    // information about the linked object in the audit event for the parent
+    {
+        m_serializer->reset_link_accesses();
+        TrackLinkAccesses track{*m_serializer};
+        auto& events = scope.events;
+        for (size_t i = 0; i < events.size(); ++i) {
+            m_serializer->set_event_index(i);
+            mpark::visit(track, events[i]);
         }
+        m_serializer->sort_link_accesses();
+    }
 
-        // Gather information about link accesses so that we can include
-        // information about the linked object in the audit event for the parent
-        {
-            m_serializer->reset_link_accesses();
-            TrackLinkAccesses track{*m_serializer};
-            auto& events = scope.events;
-            for (size_t i = 0; i < events.size(); ++i) {
-                m_serializer->set_event_index(i);
-                mpark::visit(track, events[i]);
+    AuditEventSerializer serializer{*m_source_db, scope.activity_name, *m_serializer, scope.serialized_events};
+    for (size_t i = 0; i < scope.events.size(); ++i) {
+        m_serializer->set_event_index(i);
+        mpark::visit(serializer, scope.events[i]);
+    }
+}
+
+void AuditContext::write_scope(Transaction& tr, Table& table, AuditContext::Scope& scope) const
+{
+    // Read out schema information, creating the metadata columns if needed
+    if (!scope.metadata->col_timestamp) {
+        scope.metadata->col_timestamp = table.get_column_key("timestamp");
+        scope.metadata->col_activity = table.get_column_key("activity");
+        scope.metadata->col_event_type = table.get_column_key("event");
+        scope.metadata->col_data = table.get_column_key("data");
+        for (auto& [key, _] : scope.metadata->metadata) {
+            if (auto col = table.get_column_key(key)) {
+                scope.metadata->metadata_cols.push_back(col);
+            }
+            else {
+                constexpr bool nullable = true;
+                scope.metadata->metadata_cols.push_back(table.add_column(type_String, key, nullable));
+                m_logger->trace("Audit: Adding column for metadata field '%1'", key);
             }
-            m_serializer->sort_link_accesses();
         }
+    }
 
-        m_realm_pool->write([&](Transaction& tr) {
-            auto table = tr.get_table("class_AuditEvent");
+    AuditEventWriter writer{*scope.metadata, table};
 
-            // Read out schema information, creating the metadata columns if needed
-            if (!scope.metadata->col_timestamp) {
-                scope.metadata->col_timestamp = table->get_column_key("timestamp");
-                scope.metadata->col_activity = table->get_column_key("activity");
-                scope.metadata->col_event_type = table->get_column_key("event");
-                scope.metadata->col_data = table->get_column_key("data");
-                for (auto& [key, _] : scope.metadata->metadata) {
-                    if (auto col = table->get_column_key(key)) {
-                        scope.metadata->metadata_cols.push_back(col);
-                    }
-                    else {
-                        constexpr bool nullable = true;
-                        scope.metadata->metadata_cols.push_back(table->add_column(type_String, key, nullable));
-                        m_logger->trace("Audit: Adding column for metadata field '%1'", key);
-                    }
-                }
-            }
+    auto& events = scope.serialized_events;
+    m_logger->trace("Audit: Total event count: %1", events.size());
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (writer.write_event(events[i])) {
+            // This event didn't fit in the current transaction
+            // so commit and try it again after that.
+            m_logger->detail("Audit: Incrementally comitting transaction after %1 events", i);
+            tr.commit_and_continue_writing();
+            --i;
+        }
+    }
+}
+
+void AuditContext::process_scopes(std::vector<std::shared_ptr<Scope>>& scopes) const
+{
+    m_logger->info("Audit: Processing %1 scopes for '%2'", scopes.size(), m_source_db->get_path());
+    auto report_error = [&](Scope& scope) {
+        try {
+            throw;
+        }
+        catch (std::exception const& e) {
+            m_logger->error("Audit: Error when writing scope: %1", e.what());
+        }
+        catch (...) {
+            m_logger->error("Audit: Unknown error when writing scope");
+        }
+        if (scope.completion)
+            scope.completion(std::current_exception());
+    };
 
-            AuditEventWriter writer{*m_source_db, *scope.metadata, scope.activity_name, *table, *m_serializer};
+    // Reading the source Realm and serializing the events is where a scope can
+    // fail on its own, so it is done for each scope separately, outside of the
+    // write transaction. A scope which fails is dropped from the batch.
+    std::vector<std::shared_ptr<Scope>> serialized;
+    serialized.reserve(scopes.size());
+    for (auto& scope : scopes) {
+        try {
+            serialize_scope(*scope);
+            serialized.push_back(scope);
+        }
+        catch (...) {
+            report_error(*scope);
+        }
+        m_serializer->scope_complete();
+    }
+    if (serialized.empty())
+        return;
 
-            m_logger->trace("Audit: Total event count: %1", scope.events.size());
+    // All of the scopes which were queued up while we were processing the
+    // previous batch are written in a single write transaction, as the
+    // per-transaction overhead dominates for the common case of small scopes.
+    // Large batches are still split up by the writer when they get near the
+    // maximum upload size.
+    try {
+        m_realm_pool->write([&](Transaction& tr) {
+            auto table = tr.get_table("class_AuditEvent");
 
             // We write directly to the replication log and don't want
             // the automatic replication to happen
             Table::DisableReplication dr(*table);
 
-            for (size_t i = 0; i < scope.events.size(); ++i) {
-                m_serializer->set_event_index(i);
-                if (mpark::visit(writer, scope.events[i])) {
-                    // This event didn't fit in the current transaction
-                    // so commit and try it again after that.
-                    m_logger->detail("Audit: Incrementally comitting transaction after %1 events", i);
-                    tr.commit_and_continue_writing();
-                    --i;
-                }
-            }
+            for (auto& scope : serialized)
+                write_scope(tr, *table, *scope);
             table->clear();
         });
-
-        if (scope.completion)
-            scope.completion(nullptr);
-        m_logger->detail("Audit: Scope completed");
-    }
-    catch (std::exception const& e) {
-        m_logger->error("Audit: Error when writing scope: %1", e.what());
-        if (scope.completion)
-            scope.completion(std::current_exception());
     }
     catch (...) {
-        m_logger->error("Audit: Unknown error when writing scope");
-        if (scope.completion)
-            scope.completion(std::current_exception());
+        // Writing to the audit Realm failed, which affects all of the scopes
+        for (auto& scope : serialized)
+            report_error(*scope);
+        return;
+    }
+
+    for (auto& scope : serialized) {
+        if (scope->completion)
+            scope->completion(nullptr);
     }
-    m_serializer->scope_complete();
+    m_logger->detail("Audit: Scopes completed");
 }
 
 void AuditContext::close()
@@ -1224,8 +1301,20 @@ void AuditContext::close()
 
 void AuditContext::trigger_write(std::shared_ptr<Scope> scope)
 {
-    dispatch_async(m_queue, [self = shared_from_this(), scope = std::move(scope)]() {
-        self->process_scope(*scope);
+    {
+        util::CheckedLockGuard lock(m_pending_mutex);
+        m_pending_scopes.push_back(std::move(scope));
+        // A block which hasn't started yet will pick up this scope too
+        if (m_pending_scopes.size() > 1)
+            return;
+    }
+    dispatch_async(m_queue, [self = shared_from_this()]() {
+        std::vector<std::shared_ptr<Scope>> scopes;
+        {
+            util::CheckedLockGuard lock(self->m_pending_mutex);
+            scopes.swap(self->m_pending_scopes);
+        }
+        self->process_scopes(scopes);
     });
 }
 
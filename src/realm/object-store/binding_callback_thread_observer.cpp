@@ -18,6 +18,44 @@
 
 #include <realm/object-store/binding_callback_thread_observer.hpp>
 
+#include <realm/util/thread_pool.hpp>
+
 namespace realm {
 BindingCallbackThreadObserver* g_binding_callback_thread_observer = nullptr;
-}
+
+namespace {
+// Forwards the events of the threads of core's thread pools to the binding's
+// observer. The binding may set its observer after some threads were started,
+// so a thread only reports its destruction if it reported its creation.
+class ThreadPoolObserver final : public util::ThreadPool::Observer {
+public:
+    void did_create_thread() override
+    {
+        if (auto observer = g_binding_callback_thread_observer) {
+            observer->did_create_thread();
+            t_did_create = true;
+        }
+    }
+
+    void will_destroy_thread() override
+    {
+        if (auto observer = g_binding_callback_thread_observer; observer && t_did_create)
+            observer->will_destroy_thread();
+    }
+
+    void handle_error(const std::exception& e) override
+    {
+        if (auto observer = g_binding_callback_thread_observer)
+            observer->handle_error(e);
+    }
+
+private:
+    static thread_local bool t_did_create;
+};
+
+thread_local bool ThreadPoolObserver::t_did_create = false;
+
+ThreadPoolObserver s_thread_pool_observer;
+const bool s_thread_pool_observer_installed = (util::ThreadPool::set_observer(&s_thread_pool_observer), true);
+} // anonymous namespace
+} // namespace realm
@@ -24,6 +24,7 @@
 namespace realm {
 // Interface for bindings interested in registering callbacks before/after the ObjectStore thread runs.
 // This is for example helpful to attach/detach the pthread to the JavaVM in order to be able to perform JNI calls.
+// The threads of core's shared thread pool (see realm::util::ThreadPool) are reported as well.
 class BindingCallbackThreadObserver {
 public:
     // This method is called just before the thread is started
@@ -51,6 +51,20 @@ RLM_API bool realm_list_get(const realm_list_t* list, size_t index, realm_value_
     });
 }
 
+RLM_API bool realm_list_get_range(const realm_list_t* list, size_t begin, size_t end, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        list->verify_attached();
+        // The list reports invalid ranges
+        std::vector<Mixed> values(end > begin ? end - begin : 0);
+        list->get_any_range(begin, end, values.data());
+        for (size_t i = 0; i < values.size(); ++i) {
+            out_values[i] = to_capi(values[i]);
+        }
+        return true;
+    });
+}
+
 RLM_API bool realm_list_insert(realm_list_t* list, size_t index, realm_value_t value)
 {
     return wrap_err([&]() {
@@ -2,6 +2,27 @@
 #include <realm/object-store/c_api/util.hpp>
 
 namespace realm::c_api {
+// Collects the changes of several collection notification callbacks, which
+// are then delivered together through a single callback
+class NotificationBatch : public std::enable_shared_from_this<NotificationBatch> {
+public:
+    NotificationBatch(const SharedRealm& realm, UserdataPtr userdata, realm_on_notification_batch_func_t on_batch);
+    void add(uint64_t id, const CollectionChangeSet& changes);
+
+private:
+    std::weak_ptr<Realm> m_realm;
+    UserdataPtr m_userdata;
+    realm_on_notification_batch_func_t m_on_batch;
+    VersionID m_version;
+    bool m_delivery_scheduled = false;
+    // Reused between deliveries
+    std::vector<uint64_t> m_ids;
+    std::vector<realm_collection_changes_t> m_changes;
+    std::vector<const realm_collection_changes_t*> m_change_ptrs;
+
+    void deliver();
+};
+
 namespace {
 struct ObjectNotificationsCallback {
     UserdataPtr m_userdata;
@@ -43,6 +64,16 @@ struct CollectionNotificationsCallback {
     }
 };
 
+struct BatchedNotificationsCallback {
+    std::shared_ptr<NotificationBatch> m_batch;
+    uint64_t m_id;
+
+    void operator()(const CollectionChangeSet& changes)
+    {
+        m_batch->add(m_id, changes);
+    }
+};
+
 KeyPathArray build_key_path_array(realm_key_path_array_t* key_path_array)
 {
     KeyPathArray ret;
@@ -60,8 +91,128 @@ KeyPathArray build_key_path_array(realm_key_path_array_t* key_path_array)
     return ret;
 }
 
+template <class Collection>
+realm_notification_token_t* add_batched_notification_callback(Collection& collection, realm_notification_batch_t* batch,
+                                                              uint64_t id, realm_key_path_array_t* key_path_array)
+{
+    BatchedNotificationsCallback cb{batch->m_batch, id};
+    auto token = collection.add_notification_callback(std::move(cb), build_key_path_array(key_path_array));
+    return new realm_notification_token_t{std::move(token)};
+}
+
 } // namespace
 
+NotificationBatch::NotificationBatch(const SharedRealm& realm, UserdataPtr userdata,
+                                     realm_on_notification_batch_func_t on_batch)
+    : m_realm(realm)
+    , m_userdata(std::move(userdata))
+    , m_on_batch(on_batch)
+{
+}
+
+void NotificationBatch::add(uint64_t id, const CollectionChangeSet& changes)
+{
+    auto realm = m_realm.lock();
+    if (!realm)
+        return;
+
+    // The indices of the changes refer to the version they were delivered
+    // for, so changes for different versions are never delivered together
+    auto version = realm->read_transaction_version();
+    if (!m_ids.empty() && version != m_version)
+        deliver();
+    m_version = version;
+    m_ids.push_back(id);
+    m_changes.emplace_back(changes);
+
+    auto scheduler = realm->scheduler();
+    if (!scheduler || !scheduler->can_invoke()) {
+        deliver();
+        return;
+    }
+    // Runs once the notifications currently being delivered are done
+    if (!m_delivery_scheduled) {
+        m_delivery_scheduled = true;
+        scheduler->invoke([self = shared_from_this()] {
+            self->m_delivery_scheduled = false;
+            self->deliver();
+        });
+    }
+}
+
+void NotificationBatch::deliver()
+{
+    if (m_ids.empty())
+        return;
+
+    // The callback may refresh the Realm and so add further changes
+    std::vector<uint64_t> ids;
+    std::vector<realm_collection_changes_t> changes;
+    ids.swap(m_ids);
+    changes.swap(m_changes);
+    m_change_ptrs.clear();
+    for (auto& c : changes)
+        m_change_ptrs.push_back(&c);
+    std::vector<const realm_collection_changes_t*> change_ptrs;
+    change_ptrs.swap(m_change_ptrs);
+
+    m_on_batch(m_userdata.get(), ids.size(), ids.data(), change_ptrs.data());
+
+    // Keep the buffers for the next delivery
+    if (m_ids.empty()) {
+        ids.clear();
+        changes.clear();
+        m_ids.swap(ids);
+        m_changes.swap(changes);
+        m_change_ptrs.swap(change_ptrs);
+    }
+}
+
+RLM_API realm_notification_batch_t* realm_notification_batch_new(const realm_t* realm, realm_userdata_t userdata,
+                                                                 realm_free_userdata_func_t free,
+                                                                 realm_on_notification_batch_func_t on_batch)
+{
+    return wrap_err([&]() {
+        auto batch = std::make_shared<NotificationBatch>(*realm, UserdataPtr{userdata, free}, on_batch);
+        return new realm_notification_batch_t{std::move(batch)};
+    });
+}
+
+RLM_API realm_notification_token_t* realm_results_add_batched_notification_callback(
+    realm_results_t* results, realm_notification_batch_t* batch, uint64_t id, realm_key_path_array_t* key_path_array)
+{
+    return wrap_err([&]() {
+        return add_batched_notification_callback(*results, batch, id, key_path_array);
+    });
+}
+
+RLM_API realm_notification_token_t* realm_list_add_batched_notification_callback(
+    realm_list_t* list, realm_notification_batch_t* batch, uint64_t id, realm_key_path_array_t* key_path_array)
+{
+    return wrap_err([&]() {
+        return add_batched_notification_callback(*list, batch, id, key_path_array);
+    });
+}
+
+RLM_API realm_notification_token_t* realm_set_add_batched_notification_callback(realm_set_t* set,
+                                                                                realm_notification_batch_t* batch,
+                                                                                uint64_t id,
+                                                                                realm_key_path_array_t* key_path_array)
+{
+    return wrap_err([&]() {
+        return add_batched_notification_callback(*set, batch, id, key_path_array);
+    });
+}
+
+RLM_API realm_notification_token_t*
+realm_dictionary_add_batched_notification_callback(realm_dictionary_t* dict, realm_notification_batch_t* batch,
+                                                   uint64_t id, realm_key_path_array_t* key_path_array)
+{
+    return wrap_err([&]() {
+        return add_batched_notification_callback(*dict, batch, id, key_path_array);
+    });
+}
+
 RLM_API realm_notification_token_t* realm_object_add_notification_callback(realm_object_t* obj,
                                                                            realm_userdata_t userdata,
                                                                            realm_free_userdata_func_t free,
@@ -77,6 +228,14 @@ RLM_API realm_notification_token_t* realm_object_add_notification_callback(realm
     });
 }
 
+RLM_API bool realm_notification_token_set_delivery_interval(realm_notification_token_t* token, uint64_t interval_ms)
+{
+    return wrap_err([&]() {
+        token->set_delivery_interval(std::chrono::milliseconds(interval_ms));
+        return true;
+    });
+}
+
 RLM_API bool realm_object_changes_is_deleted(const realm_object_changes_t* changes)
 {
     return !changes->deletions.empty();
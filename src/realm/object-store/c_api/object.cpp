@@ -16,6 +16,30 @@ RLM_API bool realm_get_num_objects(const realm_t* realm, realm_class_key_t key,
     });
 }
 
+RLM_API bool realm_set_modification_version_property(realm_t* realm, realm_class_key_t key,
+                                                     realm_property_key_t property_key)
+{
+    return wrap_err([&]() {
+        auto& rlm = **realm;
+        rlm.verify_in_write();
+        auto table = rlm.read_group().get_table(TableKey(key));
+        auto col_key = property_key == RLM_INVALID_PROPERTY_KEY ? ColKey() : ColKey(property_key);
+        table->set_modification_version_column(col_key);
+        return true;
+    });
+}
+
+RLM_API bool realm_get_modification_version(const realm_t* realm, realm_class_key_t key, uint64_t* out_version)
+{
+    return wrap_err([&]() {
+        auto& rlm = **realm;
+        auto table = rlm.read_group().get_table(TableKey(key));
+        if (out_version)
+            *out_version = table->get_modification_version();
+        return true;
+    });
+}
+
 RLM_API realm_object_t* realm_get_object(const realm_t* realm, realm_class_key_t tbl_key, realm_object_key_t obj_key)
 {
     return wrap_err([&]() {
@@ -65,6 +89,44 @@ RLM_API realm_object_t* realm_object_find_with_primary_key(const realm_t* realm,
     });
 }
 
+RLM_API bool realm_object_find_keys_with_primary_keys(const realm_t* realm, realm_class_key_t class_key,
+                                                      const realm_value_t* pks, size_t num_pks,
+                                                      realm_object_key_t* out_keys, bool* out_found)
+{
+    return wrap_err([&]() {
+        auto& shared_realm = *realm;
+        auto table = shared_realm->read_group().get_table(TableKey(class_key));
+        auto pk_col = table->get_primary_key_column();
+
+        // Values which cannot be a primary key of the class are not looked up
+        std::vector<Mixed> pk_vals;
+        std::vector<size_t> positions;
+        pk_vals.reserve(num_pks);
+        positions.reserve(num_pks);
+        for (size_t i = 0; i < num_pks; ++i) {
+            out_keys[i] = ObjKey().value;
+            if (out_found)
+                out_found[i] = false;
+            auto pk_val = from_capi(pks[i]);
+            if (pk_val.is_null() && !pk_col.is_nullable())
+                continue;
+            if (!pk_val.is_null() && ColumnType(pk_val.get_type()) != pk_col.get_type() &&
+                pk_col.get_type() != col_type_Mixed)
+                continue;
+            pk_vals.push_back(pk_val);
+            positions.push_back(i);
+        }
+
+        auto keys = table->find_primary_keys(pk_vals);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            out_keys[positions[i]] = keys[i].value;
+            if (out_found)
+                out_found[positions[i]] = bool(keys[i]);
+        }
+        return true;
+    });
+}
+
 RLM_API realm_results_t* realm_object_find_all(const realm_t* realm, realm_class_key_t key)
 {
     return wrap_err([&]() {
@@ -139,6 +201,56 @@ RLM_API realm_object_t* realm_object_get_or_create_with_primary_key(realm_t* rea
     });
 }
 
+RLM_API bool realm_object_create_batch(realm_t* realm, realm_class_key_t table_key, size_t num_objects,
+                                       size_t num_properties, const realm_property_key_t* properties,
+                                       const realm_value_t* values, realm_object_key_t* out_keys)
+{
+    return wrap_err([&]() {
+        auto& shared_realm = *realm;
+        auto table = shared_realm->read_group().get_table(TableKey(table_key));
+
+        std::vector<ColKey> cols;
+        cols.reserve(num_properties);
+        for (size_t i = 0; i < num_properties; ++i) {
+            auto col_key = ColKey(properties[i]);
+            table->check_column(col_key);
+            if (col_key.is_collection()) {
+                auto& schema = schema_for_table(shared_realm, table->get_key());
+                throw PropertyTypeMismatch{schema.name, table->get_column_name(col_key)};
+            }
+            cols.push_back(col_key);
+        }
+
+        if (table->get_primary_key_column() &&
+            std::find(cols.begin(), cols.end(), table->get_primary_key_column()) == cols.end()) {
+            auto& object_schema = schema_for_table(shared_realm, table->get_key());
+            throw MissingPrimaryKeyException{object_schema.name};
+        }
+
+        std::vector<Mixed> vals;
+        vals.reserve(num_objects * num_properties);
+        for (size_t i = 0; i < num_objects * num_properties; ++i) {
+            auto col_key = cols[i / num_objects];
+            auto val = from_capi(values[i]);
+            check_value_assignable(shared_realm, *table, col_key, val);
+            // Link columns store plain object keys
+            if (val.is_type(type_TypedLink))
+                val = val.get<ObjLink>().get_obj_key();
+            vals.push_back(val);
+        }
+
+        if (num_objects == 0)
+            return true;
+
+        auto keys = table->create_objects(cols, vals);
+        if (out_keys) {
+            for (size_t i = 0; i < keys.size(); ++i)
+                out_keys[i] = keys[i].value;
+        }
+        return true;
+    });
+}
+
 RLM_API bool realm_object_delete(realm_object_t* obj)
 {
     return wrap_err([&]() {
@@ -228,6 +340,17 @@ RLM_API realm_class_key_t realm_object_get_table(const realm_object_t* obj)
     return obj->obj().get_table()->get_key().value;
 }
 
+RLM_API bool realm_object_get_modification_version(const realm_object_t* obj, uint64_t* out_version)
+{
+    return wrap_err([&]() {
+        obj->verify_attached();
+        auto version = obj->obj().get_modification_version();
+        if (out_version)
+            *out_version = version;
+        return true;
+    });
+}
+
 RLM_API realm_link_t realm_object_as_link(const realm_object_t* object)
 {
     auto obj = object->obj();
@@ -284,6 +407,41 @@ RLM_API bool realm_get_values(const realm_object_t* obj, size_t num_values, cons
     });
 }
 
+RLM_API bool realm_get_values_for_objects(const realm_t* realm, realm_class_key_t class_key, size_t num_objects,
+                                          const realm_object_key_t* objects, size_t num_properties,
+                                          const realm_property_key_t* properties, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        auto& shared_realm = *realm;
+        auto table = shared_realm->read_group().get_table(TableKey(class_key));
+
+        std::vector<ColKey> cols;
+        cols.reserve(num_properties);
+        for (size_t i = 0; i < num_properties; ++i) {
+            auto col_key = ColKey(properties[i]);
+            table->check_column(col_key);
+            if (col_key.is_collection()) {
+                auto& schema = schema_for_table(shared_realm, table->get_key());
+                throw PropertyTypeMismatch{schema.name, table->get_column_name(col_key)};
+            }
+            cols.push_back(col_key);
+        }
+
+        std::vector<ObjKey> keys;
+        keys.reserve(num_objects);
+        for (size_t i = 0; i < num_objects; ++i)
+            keys.push_back(ObjKey(objects[i]));
+
+        auto values = table->get_values(keys, cols);
+        for (size_t i = 0; i < values.size(); ++i) {
+            auto converted = objkey_to_typed_link(values[i], cols[i / num_objects], *table);
+            out_values[i] = to_capi(converted);
+        }
+
+        return true;
+    });
+}
+
 RLM_API bool realm_set_value(realm_object_t* obj, realm_property_key_t col, realm_value_t new_value, bool is_default)
 {
     return realm_set_values(obj, 1, &col, &new_value, is_default);
@@ -4,6 +4,7 @@
 #include <realm/object-store/c_api/util.hpp>
 
 #include <realm/object-store/keypath_helpers.hpp>
+#include <realm/parser/query_cache.hpp>
 #include <realm/parser/query_parser.hpp>
 #include <realm/parser/keypath_mapping.hpp>
 
@@ -202,7 +203,7 @@ static Query parse_and_apply_query(const std::shared_ptr<Realm>& realm, ConstTab
     query_parser::KeyPathMapping mapping;
     realm::populate_keypath_mapping(mapping, *realm);
     QueryArgumentsAdapter arguments{num_args, args};
-    Query query = table->query(query_string, arguments, mapping);
+    Query query = realm->query_cache().query(table, query_string, arguments, mapping);
     return query;
 }
 
@@ -217,6 +218,29 @@ RLM_API realm_query_t* realm_query_parse(const realm_t* realm, realm_class_key_t
     });
 }
 
+RLM_API realm_query_t* realm_query_prepare(const realm_t* realm, realm_class_key_t target_table_key,
+                                           const char* query_string, size_t num_args, const realm_query_arg_t* args)
+{
+    return wrap_err([&]() {
+        auto table = (*realm)->read_group().get_table(TableKey(target_table_key));
+        query_parser::KeyPathMapping mapping;
+        realm::populate_keypath_mapping(mapping, **realm);
+        QueryArgumentsAdapter arguments{num_args, args};
+        // Bypasses the query cache, as a prepared query is meant to be parsed only once
+        Query query = table->prepare_query(query_string, arguments, mapping);
+        auto ordering = query.get_ordering();
+        return new realm_query_t{std::move(query), std::move(ordering), *realm};
+    });
+}
+
+RLM_API bool realm_query_rebind(realm_query_t* query, size_t arg_index, realm_value_t value)
+{
+    return wrap_err([&]() {
+        query->query.rebind(arg_index, from_capi(value));
+        return true;
+    });
+}
+
 RLM_API const char* realm_query_get_description(realm_query_t* query)
 {
     return wrap_err([&]() {
@@ -224,6 +248,14 @@ RLM_API const char* realm_query_get_description(realm_query_t* query)
     });
 }
 
+RLM_API char* realm_query_explain(const realm_query_t* query, bool analyze)
+{
+    return wrap_err([&]() {
+        auto explanation = analyze ? query->query.explain_analyze() : query->query.explain();
+        return duplicate_string(explanation.to_string());
+    });
+}
+
 RLM_API realm_query_t* realm_query_append_query(const realm_query_t* existing_query, const char* query_string,
                                                 size_t num_args, const realm_query_arg_t* args)
 {
@@ -302,6 +334,30 @@ RLM_API realm_results_t* realm_query_find_all(realm_query_t* query)
     });
 }
 
+RLM_API realm_async_evaluation_t* realm_query_find_all_async(realm_query_t* query,
+                                                             realm_query_find_all_async_func_t callback,
+                                                             realm_userdata_t userdata,
+                                                             realm_free_userdata_func_t userdata_free)
+{
+    return wrap_err([&]() {
+        auto shared_realm = query->weak_realm.lock();
+        REALM_ASSERT_RELEASE(shared_realm);
+        auto cb = [callback, userdata = UserdataPtr{userdata, userdata_free}](Results results,
+                                                                             std::exception_ptr error) {
+            if (error) {
+                realm_async_error_t c_error(std::move(error));
+                callback(userdata.get(), nullptr, &c_error);
+            }
+            else {
+                realm_results_t c_results(std::move(results));
+                callback(userdata.get(), &c_results, nullptr);
+            }
+        };
+        Results results{shared_realm, query->query, query->get_ordering()};
+        return new realm_async_evaluation{results.evaluate_async(std::move(cb))};
+    });
+}
+
 RLM_API bool realm_results_count(realm_results_t* results, size_t* out_count)
 {
     return wrap_err([&]() {
@@ -313,6 +369,14 @@ RLM_API bool realm_results_count(realm_results_t* results, size_t* out_count)
     });
 }
 
+RLM_API char* realm_results_explain(realm_results_t* results, bool analyze)
+{
+    return wrap_err([&]() {
+        auto explanation = analyze ? results->explain_analyze() : results->explain();
+        return duplicate_string(explanation.to_string());
+    });
+}
+
 RLM_API realm_results_t* realm_results_filter(realm_results_t* results, realm_query_t* query)
 {
     return wrap_err([&]() {
@@ -367,6 +431,39 @@ RLM_API bool realm_results_get(realm_results_t* results, size_t index, realm_val
     });
 }
 
+RLM_API bool realm_results_get_values(realm_results_t* results, size_t begin, size_t end, size_t num_properties,
+                                      const realm_property_key_t* properties, realm_value_t* out_values)
+{
+    return wrap_err([&]() {
+        auto table = results->get_table();
+        std::vector<ColKey> cols;
+        cols.reserve(num_properties);
+        for (size_t i = 0; i < num_properties; ++i) {
+            auto col_key = ColKey(properties[i]);
+            table->check_column(col_key);
+            if (col_key.is_collection()) {
+                auto& schema = schema_for_table(results->get_realm(), table->get_key());
+                throw PropertyTypeMismatch{schema.name, table->get_column_name(col_key)};
+            }
+            cols.push_back(col_key);
+        }
+
+        // Resolve all rows first, so that the results are only evaluated once
+        std::vector<ObjKey> keys;
+        keys.reserve(end > begin ? end - begin : 0);
+        for (size_t i = begin; i < end; ++i)
+            keys.push_back(results->get<Obj>(i).get_key());
+
+        auto values = table->get_values(keys, cols);
+        size_t num_objects = keys.size();
+        for (size_t i = 0; i < values.size(); ++i) {
+            auto converted = objkey_to_typed_link(values[i], cols[i / num_objects], *table);
+            out_values[i] = to_capi(converted);
+        }
+        return true;
+    });
+}
+
 RLM_API realm_object_t* realm_results_get_object(realm_results_t* results, size_t index)
 {
     return wrap_err([&]() {
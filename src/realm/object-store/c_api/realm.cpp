@@ -1,4 +1,5 @@
 #include <realm/object-store/c_api/types.hpp>
+#include <realm/metrics/latency.hpp>
 #include "realm.hpp"
 
 realm_callback_token_realm::~realm_callback_token_realm()
@@ -18,6 +19,8 @@ realm_refresh_callback_token::~realm_refresh_callback_token()
 
 namespace realm::c_api {
 
+static_assert(realm_memory_pressure_e(DB::MemoryPressure::moderate) == RLM_MEMORY_PRESSURE_MODERATE);
+static_assert(realm_memory_pressure_e(DB::MemoryPressure::critical) == RLM_MEMORY_PRESSURE_CRITICAL);
 
 RLM_API bool realm_get_version_id(const realm_t* realm, bool* out_found, realm_version_id_t* out_version)
 {
@@ -66,6 +69,39 @@ RLM_API void realm_get_library_version_numbers(int* out_major, int* out_minor, i
     *out_extra = REALM_VERSION_EXTRA;
 }
 
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::begin_read) == RLM_LATENCY_METRIC_BEGIN_READ);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::commit) == RLM_LATENCY_METRIC_COMMIT);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::fsync) == RLM_LATENCY_METRIC_FSYNC);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::query) == RLM_LATENCY_METRIC_QUERY);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::notifier_run) == RLM_LATENCY_METRIC_NOTIFIER_RUN);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::sync_integrate) == RLM_LATENCY_METRIC_SYNC_INTEGRATE);
+static_assert(realm_latency_metric_e(metrics::LatencyMetric::sync_upload) == RLM_LATENCY_METRIC_SYNC_UPLOAD);
+
+RLM_API bool realm_get_latency_snapshot(realm_latency_metric_e metric, realm_latency_snapshot_t* out_snapshot)
+{
+    if (size_t(metric) >= metrics::num_latency_metrics)
+        return false;
+    auto histogram = metrics::LatencyRegistry::get().get_snapshot(metrics::LatencyMetric(metric));
+    out_snapshot->count = histogram.count;
+    out_snapshot->total_ns = histogram.total_nanoseconds;
+    out_snapshot->max_ns = histogram.max_nanoseconds;
+    out_snapshot->p50_ns = histogram.get_percentile(50);
+    out_snapshot->p90_ns = histogram.get_percentile(90);
+    out_snapshot->p99_ns = histogram.get_percentile(99);
+    out_snapshot->p999_ns = histogram.get_percentile(99.9);
+    return true;
+}
+
+RLM_API void realm_reset_latency_metrics()
+{
+    metrics::LatencyRegistry::get().reset();
+}
+
+RLM_API void realm_set_latency_metrics_enabled(bool enabled)
+{
+    metrics::LatencyRegistry::set_enabled(enabled);
+}
+
 RLM_API realm_t* realm_open(const realm_config_t* config)
 {
     return wrap_err([&]() {
@@ -268,6 +304,16 @@ RLM_API bool realm_compact(realm_t* realm, bool* did_compact)
     });
 }
 
+RLM_API bool realm_release_memory(realm_t* realm, realm_memory_pressure_e level, size_t* out_bytes_released)
+{
+    return wrap_err([&]() {
+        size_t bytes = (*realm)->release_memory(DB::MemoryPressure(level));
+        if (out_bytes_released)
+            *out_bytes_released = bytes;
+        return true;
+    });
+}
+
 RLM_API realm_t* realm_from_thread_safe_reference(realm_thread_safe_reference_t* tsr, realm_scheduler_t* scheduler)
 {
     return wrap_err([&]() {
@@ -47,8 +47,8 @@ struct CAPIScheduler : Scheduler {
     void invoke(util::UniqueFunction<void()>&& fn) final
     {
         if (m_notify) {
-            m_queue.push(std::move(fn));
-            m_notify(m_userdata);
+            if (m_queue.push(std::move(fn)))
+                m_notify(m_userdata);
         }
     }
 
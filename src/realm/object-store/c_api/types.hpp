@@ -458,6 +458,19 @@ struct realm_collection_changes : realm::c_api::WrapC, realm::CollectionChangeSe
     }
 };
 
+namespace realm::c_api {
+class NotificationBatch;
+}
+
+struct realm_notification_batch : realm::c_api::WrapC {
+    explicit realm_notification_batch(std::shared_ptr<realm::c_api::NotificationBatch> batch)
+        : m_batch(std::move(batch))
+    {
+    }
+
+    std::shared_ptr<realm::c_api::NotificationBatch> m_batch;
+};
+
 struct realm_notification_token : realm::c_api::WrapC, realm::NotificationToken {
     explicit realm_notification_token(realm::NotificationToken token)
         : realm::NotificationToken(std::move(token))
@@ -466,6 +479,18 @@ struct realm_notification_token : realm::c_api::WrapC, realm::NotificationToken
 };
 
 
+struct realm_async_evaluation : realm::c_api::WrapC, realm::Results::AsyncEvaluation {
+    explicit realm_async_evaluation(realm::Results::AsyncEvaluation evaluation)
+        : realm::Results::AsyncEvaluation(std::move(evaluation))
+    {
+    }
+
+    ~realm_async_evaluation()
+    {
+        cancel();
+    }
+};
+
 struct realm_callback_token : realm::c_api::WrapC {
 protected:
     realm_callback_token(realm_t* realm, uint64_t token)
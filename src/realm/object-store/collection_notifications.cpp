@@ -64,3 +64,8 @@ void NotificationToken::suppress_next()
 {
     m_notifier.load()->suppress_next_notification(m_token);
 }
+
+void NotificationToken::set_delivery_interval(std::chrono::milliseconds interval)
+{
+    m_notifier.load()->set_delivery_interval(m_token, interval);
+}
@@ -22,6 +22,7 @@
 #include <realm/object-store/index_set.hpp>
 #include <realm/object-store/util/atomic_shared_ptr.hpp>
 
+#include <chrono>
 #include <exception>
 #include <memory>
 #include <type_traits>
@@ -51,6 +52,12 @@ struct NotificationToken {
 
     void suppress_next();
 
+    // Call the callback associated with this token at most once per `interval`,
+    // merging the changes from all versions produced in between into a single
+    // changeset. The initial notification is not delayed. Zero (the default)
+    // calls the callback for every version with changes.
+    void set_delivery_interval(std::chrono::milliseconds interval);
+
 private:
     util::AtomicSharedPtr<_impl::CollectionNotifier> m_notifier;
     uint64_t m_token;
@@ -551,6 +551,87 @@ void calculate_moves_sorted(std::vector<RowInfo>& rows, CollectionChangeSet& cha
     }
 }
 
+// Calculates the insertions and deletions needed to move the rows of a sorted
+// collection when no key appears more than once. As every row then has exactly
+// one previous index, the largest set of rows which can stay in place is the
+// longest increasing subsequence of the previous indices taken in the new
+// order, and every other row is reported as moved. This is O(N log N) rather
+// than the potentially quadratic matching done for collections with duplicates.
+//
+// When there are several subsequences of the same length the one with the
+// fewest modified rows is kept, so that modified rows are the ones reported as
+// moving, and after that the one ending later in the new collection is kept,
+// which gives the same result as LongestCommonSubsequenceCalculator for
+// simple reorderings.
+void calculate_moves_unique(std::vector<RowInfo>& rows, CollectionChangeSet& changeset)
+{
+    // Rows which were deleted leave gaps in the previous indices, so replace
+    // them with their rank among the remaining rows
+    std::vector<size_t> rank(rows.size());
+    {
+        std::vector<std::pair<size_t, size_t>> by_prev;
+        by_prev.reserve(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i)
+            by_prev.push_back({rows[i].prev_tv_index, i});
+        std::sort(by_prev.begin(), by_prev.end());
+        for (size_t i = 0; i < by_prev.size(); ++i)
+            rank[by_prev[i].second] = i;
+    }
+
+    // Skip over the prefix which is unchanged
+    size_t first_difference = 0;
+    while (first_difference < rows.size() && rank[first_difference] == first_difference)
+        ++first_difference;
+    if (first_difference == rows.size())
+        return;
+    size_t count = rows.size() - first_difference;
+
+    struct Entry {
+        size_t length;
+        size_t unmodified;
+        size_t row;
+        bool operator<(Entry const& other) const noexcept
+        {
+            return std::tie(length, unmodified, row) < std::tie(other.length, other.unmodified, other.row);
+        }
+    };
+    // Fenwick tree over the previous ranks holding the best subsequence ending
+    // at each rank seen so far, so that the best subsequence which a row can
+    // extend is found in O(log N)
+    std::vector<Entry> tree(count + 1, Entry{0, 0, IndexSet::npos});
+    std::vector<size_t> predecessor(count);
+    Entry best{0, 0, IndexSet::npos};
+    for (size_t i = 0; i < count; ++i) {
+        auto& row = rows[first_difference + i];
+        size_t value = rank[first_difference + i] - first_difference;
+        REALM_ASSERT_DEBUG(value < count);
+
+        Entry prefix{0, 0, IndexSet::npos};
+        for (size_t k = value; k > 0; k -= k & (0 - k)) {
+            if (prefix.row == IndexSet::npos || prefix < tree[k])
+                prefix = tree[k];
+        }
+        predecessor[i] = prefix.row;
+        Entry entry{prefix.length + 1, prefix.unmodified + !changeset.modifications.contains(row.tv_index), i};
+        for (size_t k = value + 1; k <= count; k += k & (0 - k)) {
+            if (tree[k].row == IndexSet::npos || tree[k] < entry)
+                tree[k] = entry;
+        }
+        if (best.row == IndexSet::npos || best < entry)
+            best = entry;
+    }
+
+    std::vector<bool> stays(count);
+    for (size_t i = best.row; i != IndexSet::npos; i = predecessor[i])
+        stays[i] = true;
+    for (size_t i = 0; i < count; ++i) {
+        if (!stays[i]) {
+            changeset.deletions.add(rows[first_difference + i].prev_tv_index);
+            changeset.insertions.add(rows[first_difference + i].tv_index);
+        }
+    }
+}
+
 template <typename T>
 void verify_changeset(std::vector<T> const& prev_rows, std::vector<T> const& next_rows,
                       CollectionChangeBuilder const& changeset)
@@ -624,8 +705,19 @@ void calculate(CollectionChangeBuilder& ret, std::vector<RowInfo> old_rows, std:
         }
     }
 
-    if (!in_table_order)
+    if (in_table_order)
+        return;
+
+    // Any key which appears more than once in the rows which are in both
+    // collections must also appear more than once in the old rows, which are
+    // still sorted by key
+    bool has_duplicates = std::adjacent_find(begin(old_rows), end(old_rows), [](auto& lft, auto& rgt) {
+                              return lft.key == rgt.key;
+                          }) != end(old_rows);
+    if (has_duplicates)
         calculate_moves_sorted(new_rows, ret);
+    else
+        calculate_moves_unique(new_rows, ret);
 }
 
 template <typename T>
@@ -50,7 +50,7 @@ util::UniqueFunction<bool(ObjKey)> CollectionNotifier::get_modification_checker(
     // happened" would mostly just be a source of potential bugs.
     if (info.schema_changed) {
         util::CheckedLockGuard lock(m_callback_mutex);
-        update_related_tables(*root_table);
+        update_related_tables(*root_table, info.deep_change_cache.get());
     }
 
     if (!any_related_table_was_modified(info)) {
@@ -163,7 +163,7 @@ uint64_t CollectionNotifier::add_callback(CollectionChangeCallback callback, Key
     }
 
     auto token = m_next_token++;
-    m_callbacks.push_back({std::move(callback), {}, {}, std::move(key_path_array), token, false, false});
+    m_callbacks.push_back({std::move(callback), {}, {}, std::move(key_path_array), token, false, false, {}, {}});
 
     if (m_callback_index == npos) { // Don't need to wake up if we're already sending notifications
         Realm::Internal::get_coordinator(*m_realm).wake_up_notifier_worker();
@@ -221,11 +221,27 @@ void CollectionNotifier::suppress_next_notification(uint64_t token)
         // should have already been called and there are no versions after
         // this one yet
         REALM_ASSERT(it->changes_to_deliver.empty());
-        REALM_ASSERT(it->accumulated_changes.empty());
+        // unless the callback is throttled and is still waiting for changes
+        // from earlier versions. Those can't be delivered without the changes
+        // from this write, so the write is reported as well.
+        if (!it->accumulated_changes.empty()) {
+            REALM_ASSERT(it->delivery_interval.count());
+            return;
+        }
         it->skip_next = true;
     }
 }
 
+void CollectionNotifier::set_delivery_interval(uint64_t token, std::chrono::milliseconds interval)
+{
+    m_realm->verify_thread();
+
+    util::CheckedLockGuard lock(m_callback_mutex);
+    auto it = find_callback(token);
+    if (it != end(m_callbacks))
+        it->delivery_interval = interval;
+}
+
 std::vector<NotificationCallback>::iterator CollectionNotifier::find_callback(uint64_t token)
 {
     REALM_ASSERT(m_callbacks.size() > 0);
@@ -261,17 +277,43 @@ void CollectionNotifier::add_required_change_info(TransactionChangeInfo& info)
         return;
     }
 
+    if (all_callbacks_filtered()) {
+        // Only the columns on the key paths can produce a notification, so the
+        // other columns don't need to be tracked at all. Insertions into tables
+        // on the key paths still need to be tracked for backlinks. A backlink
+        // changes when the link column it is the opposite of is modified.
+        std::unordered_map<TableKey, std::vector<ColKey>> columns;
+        columns[m_related_tables[0].table_key];
+        for (auto& key_path : m_key_path_array) {
+            for (auto& [table_key, col_key] : key_path) {
+                columns[table_key].push_back(col_key);
+                if (col_key.get_type() == col_type_BackLink) {
+                    auto table = m_sg->get_table(table_key);
+                    columns[table->get_opposite_table_key(col_key)].push_back(
+                        table->get_opposite_column(col_key));
+                }
+            }
+        }
+        for (auto& [table_key, cols] : columns)
+            info.track_columns(table_key, cols);
+        return;
+    }
+
     // Create an entry in the `TransactionChangeInfo` for every table in `m_related_tables`.
     info.tables.reserve(m_related_tables.size());
     for (auto& tbl : m_related_tables)
-        info.tables[tbl.table_key];
+        info.track_table(tbl.table_key);
 }
 
-void CollectionNotifier::update_related_tables(Table const& table)
+void CollectionNotifier::update_related_tables(Table const& table, DeepChangeCache* cache)
 {
     m_related_tables.clear();
     recalculate_key_path_array();
-    DeepChangeChecker::find_related_tables(m_related_tables, table, m_key_path_array);
+    if (cache)
+        DeepChangeChecker::find_related_tables(m_related_tables, table, m_key_path_array,
+                                               cache->link_graph(*table.get_parent_group()));
+    else
+        DeepChangeChecker::find_related_tables(m_related_tables, table, m_key_path_array);
     // We deactivate the `m_did_modify_callbacks` toggle to make sure the recalculation is only done when
     // necessary.
     m_did_modify_callbacks = false;
@@ -338,16 +380,39 @@ bool CollectionNotifier::package_for_delivery()
 {
     if (!prepare_to_deliver())
         return false;
-    util::CheckedLockGuard lock(m_callback_mutex);
-    for (auto& callback : m_callbacks) {
-        // changes_to_deliver will normally be empty here. If it's non-empty
-        // then that means package_for_delivery() was called multiple times
-        // without the notification actually being delivered, which can happen
-        // if the Realm was refreshed from within a notification callback.
-        callback.changes_to_deliver.merge(std::move(callback.accumulated_changes));
-        callback.accumulated_changes = {};
+    auto now = std::chrono::steady_clock::now();
+    util::Optional<std::chrono::steady_clock::time_point> next_delivery;
+    {
+        util::CheckedLockGuard lock(m_callback_mutex);
+        for (auto& callback : m_callbacks) {
+            if (callback.delivery_interval.count() && !callback.accumulated_changes.empty()) {
+                // Hold on to the changes until the interval has passed, unless
+                // the initial notification still has to be sent
+                if (callback.initial_delivered && now < callback.next_delivery) {
+                    if (!next_delivery || callback.next_delivery < *next_delivery)
+                        next_delivery = callback.next_delivery;
+                    continue;
+                }
+                callback.next_delivery = now + callback.delivery_interval;
+            }
+
+            // changes_to_deliver will normally be empty here. If it's non-empty
+            // then that means package_for_delivery() was called multiple times
+            // without the notification actually being delivered, which can happen
+            // if the Realm was refreshed from within a notification callback.
+            callback.changes_to_deliver.merge(std::move(callback.accumulated_changes));
+            callback.accumulated_changes = {};
+        }
+        m_callback_count = m_callbacks.size();
+    }
+
+    // Make sure the held back changes are delivered even if no further
+    // versions are produced
+    if (next_delivery) {
+        std::lock_guard<std::mutex> realm_lock(m_realm_mutex);
+        if (m_realm)
+            Realm::Internal::get_coordinator(*m_realm).notify_realms_at(*next_delivery);
     }
-    m_callback_count = m_callbacks.size();
     return true;
 }
 
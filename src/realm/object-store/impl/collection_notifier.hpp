@@ -29,6 +29,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <mutex>
@@ -65,6 +66,14 @@ struct NotificationCallback {
     // Set within a write transaction on the target thread if this callback
     // should not be called with changes for that write. requires m_callback_mutex.
     bool skip_next = false;
+    // The minimum time between two deliveries of changes to this callback.
+    // Changes from versions produced in between are left in
+    // `accumulated_changes` and delivered together once the interval has
+    // passed. Zero delivers changes for every version. requires m_callback_mutex.
+    std::chrono::steady_clock::duration delivery_interval = {};
+    // The earliest time at which changes may next be delivered to this
+    // callback if `delivery_interval` is set. requires m_callback_mutex.
+    std::chrono::steady_clock::time_point next_delivery = {};
 };
 
 // A base class for a notifier that keeps a collection up to date and/or
@@ -109,6 +118,16 @@ public:
 
     void suppress_next_notification(uint64_t token) REQUIRES(!m_callback_mutex);
 
+    /**
+     * Deliver changes to the callback identified by `token` at most once per `interval`. The changes made by all
+     * versions produced in between are merged into a single changeset. The first notification is never delayed.
+     * This can only be called from the target collection's thread.
+     *
+     * @param token The token that was returned from `add_callback`.
+     * @param interval The minimum time between two notifications. Zero delivers a notification for every version.
+     */
+    void set_delivery_interval(uint64_t token, std::chrono::milliseconds interval) REQUIRES(!m_callback_mutex);
+
     // ------------------------------------------------------------------------
     // API for RealmCoordinator to manage running things and calling callbacks
 
@@ -154,6 +173,13 @@ public:
     // precondition: RealmCoordinator::m_notifier_mutex is locked
     void attach_to(std::shared_ptr<Transaction> sg);
 
+    // The Transaction this notifier is currently attached to
+    // precondition: RealmCoordinator::m_notifier_mutex is locked *or* is called on worker thread
+    Transaction* attached_transaction() const noexcept
+    {
+        return m_sg.get();
+    }
+
     // Set `info` as the new ChangeInfo that will be populated by the next
     // transaction advance, and register all required information in it
     // precondition: RealmCoordinator::m_notifier_mutex is locked
@@ -202,7 +228,8 @@ protected:
     // filter is attached to all of them.
     bool all_callbacks_filtered() const noexcept;
 
-    void update_related_tables(Table const& table) REQUIRES(m_callback_mutex);
+    // Recalculates `m_related_tables`, using the table graph cached in `cache` if non-null.
+    void update_related_tables(Table const& table, DeepChangeCache* cache = nullptr) REQUIRES(m_callback_mutex);
 
     // A summary of all `KeyPath`s attached to the `m_callbacks`.
     KeyPathArray m_key_path_array;
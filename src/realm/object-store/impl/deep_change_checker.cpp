@@ -34,21 +34,28 @@ void sort_and_unique(T& container)
 }
 } // namespace
 
-void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_tables, Table const& table,
-                                            const KeyPathArray& key_path_array)
+void TransactionChangeInfo::track_table(TableKey table_key)
 {
-    struct LinkInfo {
-        std::vector<ColKey> forward_links;
-        std::vector<TableKey> forward_tables;
+    tables[table_key];
+    tracked_columns.erase(table_key);
+}
 
-        std::vector<TableKey> backlink_tables;
-        bool processed_table = false;
-    };
+void TransactionChangeInfo::track_columns(TableKey table_key, std::vector<ColKey> const& columns)
+{
+    if (!tables.emplace(table_key, ObjectChangeSet{}).second && tracks_all_columns(table_key))
+        return;
+    auto& tracked = tracked_columns[table_key];
+    tracked.insert(tracked.end(), columns.begin(), columns.end());
+    sort_and_unique(tracked);
+}
 
-    auto has_key_paths = std::any_of(begin(key_path_array), end(key_path_array), [&](auto key_path) {
-        return key_path.size() > 0;
-    });
+bool TransactionChangeInfo::tracks_all_columns(TableKey table_key) const
+{
+    return tracked_columns.find(table_key) == tracked_columns.end();
+}
 
+DeepChangeChecker::LinkGraph DeepChangeChecker::build_link_graph(Group const& group)
+{
     // Build up the complete forward mapping from the back links.
     // Following forward link columns does not account for TypedLink
     // values as part of Dictionary<String, Mixed> for example. But
@@ -56,32 +63,19 @@ void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_t
     // so we rely on the fact that if there are any TypedLinks from a
     // Mixed value, there will be a corresponding backlink column
     // created at the destination table.
-    std::unordered_map<TableKey, LinkInfo> complete_mapping;
-    Group* group = table.get_parent_group();
-    REALM_ASSERT(group);
-    auto all_table_keys = group->get_table_keys();
-    for (auto key : all_table_keys) {
-        auto cur_table = group->get_table(key);
+    LinkGraph link_graph;
+    for (auto key : group.get_table_keys()) {
+        auto cur_table = group.get_table(key);
         REALM_ASSERT(cur_table);
 
-        LinkInfo* backlinks = nullptr;
-        if (has_key_paths) {
-            backlinks = &complete_mapping[cur_table->get_key()];
-        }
+        auto& backlinks = link_graph[key].backlinks;
         cur_table->for_each_backlink_column([&](ColKey backlink_col_key) {
             auto origin_table_key = cur_table->get_opposite_table_key(backlink_col_key);
             auto origin_link_col = cur_table->get_opposite_column(backlink_col_key);
-            auto& links = complete_mapping[origin_table_key];
+            auto& links = link_graph[origin_table_key];
             links.forward_links.push_back(origin_link_col);
-            links.forward_tables.push_back(cur_table->get_key());
-
-            if (any_of(key_path_array.begin(), key_path_array.end(), [&](const KeyPath& key_path) {
-                    return any_of(key_path.begin(), key_path.end(), [&](std::pair<TableKey, ColKey> pair) {
-                        return pair.first == cur_table->get_key() && pair.second == backlink_col_key;
-                    });
-                })) {
-                backlinks->backlink_tables.push_back(cur_table->get_link_target(backlink_col_key)->get_key());
-            }
+            links.forward_tables.push_back(key);
+            backlinks.push_back({backlink_col_key, origin_table_key});
             return false;
         });
     }
@@ -89,22 +83,51 @@ void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_t
     // Remove duplicates:
     // duplicates in link_columns can occur when a Mixed(TypedLink) contain links to different tables
     // duplicates in connected_tables can occur when there are different link paths to the same table
-    for (auto& [_, info] : complete_mapping) {
+    for (auto& [_, info] : link_graph) {
         sort_and_unique(info.forward_links);
         sort_and_unique(info.forward_tables);
     }
+    return link_graph;
+}
+
+void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_tables, Table const& table,
+                                            const KeyPathArray& key_path_array)
+{
+    Group* group = table.get_parent_group();
+    REALM_ASSERT(group);
+    find_related_tables(related_tables, table, key_path_array, build_link_graph(*group));
+}
+
+void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_tables, Table const& table,
+                                            const KeyPathArray& key_path_array, LinkGraph const& link_graph)
+{
+    auto has_key_paths = std::any_of(begin(key_path_array), end(key_path_array), [&](auto& key_path) {
+        return key_path.size() > 0;
+    });
+    auto is_in_key_paths = [&](TableKey table_key, ColKey col_key) {
+        return any_of(key_path_array.begin(), key_path_array.end(), [&](const KeyPath& key_path) {
+            return any_of(key_path.begin(), key_path.end(), [&](std::pair<TableKey, ColKey> pair) {
+                return pair.first == table_key && pair.second == col_key;
+            });
+        });
+    };
 
+    std::unordered_set<TableKey> processed_tables;
     std::vector<TableKey> tables_to_check = {table.get_key()};
     while (tables_to_check.size()) {
         auto table_key_to_check = tables_to_check.back();
         tables_to_check.pop_back();
-        auto& link_info = complete_mapping[table_key_to_check];
-        if (link_info.processed_table) {
+        if (!processed_tables.insert(table_key_to_check).second) {
             continue;
         }
-        link_info.processed_table = true;
 
-        related_tables.push_back({table_key_to_check, std::move(link_info.forward_links)});
+        auto it = link_graph.find(table_key_to_check);
+        if (it == link_graph.end()) {
+            related_tables.push_back({table_key_to_check, {}});
+            continue;
+        }
+        auto& link_info = it->second;
+        related_tables.push_back({table_key_to_check, link_info.forward_links});
 
         // Add all tables reachable via a forward link to the vector of tables that need to be checked
         for (auto linked_table_key : link_info.forward_tables) {
@@ -113,8 +136,9 @@ void DeepChangeChecker::find_related_tables(std::vector<RelatedTable>& related_t
 
         // Backlinks can only come into consideration when added via key paths.
         if (has_key_paths) {
-            for (auto linked_table_key : link_info.backlink_tables) {
-                tables_to_check.push_back(linked_table_key);
+            for (auto& [backlink_col_key, origin_table_key] : link_info.backlinks) {
+                if (is_in_key_paths(table_key_to_check, backlink_col_key))
+                    tables_to_check.push_back(origin_table_key);
             }
         }
     }
@@ -148,6 +172,11 @@ DeepChangeChecker::DeepChangeChecker(TransactionChangeInfo const& info, Table co
             }
         }
     }
+
+    // The results of a deep change check are the same for every checker which
+    // does not filter on any columns, so they can be shared between notifiers.
+    if (info.deep_change_cache && m_filtered_columns.empty())
+        m_shared_cache = info.deep_change_cache.get();
 }
 
 bool DeepChangeChecker::do_check_mixed_for_link(Group& group, TableRef& cached_linked_table, Mixed value,
@@ -322,16 +351,24 @@ bool DeepChangeChecker::check_row(Table const& table, ObjKey object_key, const s
 
     // We may have already performed deep checking on this object and discovered
     // that it is not possible to reach a modified object from it.
+    // Another notifier may also have done so for the same changes.
     auto& not_modified = m_not_modified[table_key];
     auto it = not_modified.find(object_key);
     if (it != not_modified.end())
         return false;
+    if (m_shared_cache && m_shared_cache->is_not_modified(table_key, object_key)) {
+        not_modified.insert(object_key);
+        return false;
+    }
 
     bool ret = check_outgoing_links(table, ObjKey(object_key), filtered_columns, depth);
     // If this object isn't modified and we didn't exceed the maximum search depth,
     // cache that result to avoid having to repeat it.
-    if (!ret && (depth == 0 || !m_current_path[depth - 1].depth_exceeded))
+    if (!ret && (depth == 0 || !m_current_path[depth - 1].depth_exceeded)) {
         not_modified.insert(object_key);
+        if (m_shared_cache)
+            m_shared_cache->mark_not_modified(table_key, object_key);
+    }
     return ret;
 }
 
@@ -529,3 +566,24 @@ std::vector<ColKey> ObjectKeyPathChangeChecker::operator()(ObjKey object_key)
 
     return changed_columns;
 }
+
+DeepChangeChecker::LinkGraph const& DeepChangeCache::link_graph(Group const& group)
+{
+    std::lock_guard lock(m_link_graph_mutex);
+    if (!m_link_graph)
+        m_link_graph = std::make_unique<DeepChangeChecker::LinkGraph>(DeepChangeChecker::build_link_graph(group));
+    return *m_link_graph;
+}
+
+bool DeepChangeCache::is_not_modified(TableKey table_key, ObjKey object_key)
+{
+    std::lock_guard lock(m_not_modified_mutex);
+    auto it = m_not_modified.find(table_key);
+    return it != m_not_modified.end() && it->second.count(object_key);
+}
+
+void DeepChangeCache::mark_not_modified(TableKey table_key, ObjKey object_key)
+{
+    std::lock_guard lock(m_not_modified_mutex);
+    m_not_modified[table_key].insert(object_key);
+}
@@ -23,6 +23,8 @@
 #include <realm/object-store/impl/collection_change_builder.hpp>
 
 #include <array>
+#include <memory>
+#include <mutex>
 
 namespace realm {
 class CollectionBase;
@@ -39,6 +41,7 @@ using ref_type = size_t;
 
 namespace _impl {
 class RealmCoordinator;
+class DeepChangeCache;
 
 struct ListChangeInfo {
     TableKey table_key;
@@ -52,6 +55,23 @@ struct TransactionChangeInfo {
     std::unordered_map<TableKey, ObjectChangeSet> tables;
     bool track_all;
     bool schema_changed;
+    // For tables where every observer only cares about some of the columns,
+    // the columns whose modifications are recorded. Modifications of every
+    // column are recorded for the tables in `tables` not listed here.
+    std::unordered_map<TableKey, std::vector<ColKey>> tracked_columns;
+    // Deep change checking results shared by all of the notifiers which use
+    // this change info. Only set by the RealmCoordinator once the change info
+    // is complete; null when the checkers are not run in the background.
+    std::shared_ptr<DeepChangeCache> deep_change_cache;
+
+    // Request that all changes to the given table be recorded.
+    void track_table(TableKey table_key);
+    // Request that insertions and deletions in the given table and
+    // modifications of the given columns be recorded. Has no effect on
+    // tables for which all changes were already requested.
+    void track_columns(TableKey table_key, std::vector<ColKey> const& columns);
+    // Whether modifications of every column of the given table are recorded.
+    bool tracks_all_columns(TableKey table_key) const;
 };
 
 /**
@@ -75,6 +95,20 @@ public:
     };
 
     typedef std::vector<RelatedTable> RelatedTables;
+
+    /**
+     * The links between all tables of a `Group`, built from the backlink columns so that links stored in
+     * `Mixed` values are included.
+     */
+    struct TableLinks {
+        // All outgoing link columns of the table and the tables they link to.
+        std::vector<ColKey> forward_links;
+        std::vector<TableKey> forward_tables;
+        // All backlink columns of the table and the table each of them originates from.
+        std::vector<std::pair<ColKey, TableKey>> backlinks;
+    };
+    typedef std::unordered_map<TableKey, TableLinks> LinkGraph;
+
     DeepChangeChecker(TransactionChangeInfo const& info, Table const& root_table, RelatedTables const& related_tables,
                       const KeyPathArray& key_path_array, bool all_callbacks_filtered);
 
@@ -129,6 +163,18 @@ public:
     static void find_related_tables(std::vector<RelatedTable>& out, Table const& table,
                                     const KeyPathArray& key_path_array);
 
+    /**
+     * Same as above, but using a `LinkGraph` which was previously built by `build_link_graph()` for the group
+     * containing `table` rather than scanning every table in the group.
+     */
+    static void find_related_tables(std::vector<RelatedTable>& out, Table const& table,
+                                    const KeyPathArray& key_path_array, LinkGraph const& link_graph);
+
+    /**
+     * Build the `LinkGraph` for all tables in `group`.
+     */
+    static LinkGraph build_link_graph(Group const& group);
+
 protected:
     friend class ObjectKeyPathChangeChecker;
 
@@ -153,6 +199,11 @@ private:
 
     std::unordered_map<TableKey, std::unordered_set<ObjKey>> m_not_modified;
 
+    // The cache shared with the other notifiers checking the same changes, if
+    // the results of this checker are valid for them. This is only the case
+    // when no columns are filtered.
+    DeepChangeCache* m_shared_cache = nullptr;
+
     struct Path {
         ObjKey obj_key;
         ColKey col_key;
@@ -260,6 +311,33 @@ public:
     std::vector<ColKey> operator()(ObjKey object_key);
 };
 
+/**
+ * The `DeepChangeCache` holds the parts of deep change checking which do not depend on the notifier performing the
+ * check, so that they are computed once per version rather than once per notifier. It is owned by the
+ * `TransactionChangeInfo` it caches results for and may be used by notifiers running on multiple threads at once.
+ */
+class DeepChangeCache {
+public:
+    /**
+     * Get the `LinkGraph` of `group`, building it on first use. All callers must pass a `Group` at the version
+     * the owning `TransactionChangeInfo` was advanced to.
+     */
+    DeepChangeChecker::LinkGraph const& link_graph(Group const& group);
+
+    /**
+     * Check if an unfiltered `DeepChangeChecker` has already determined that no modified object can be reached
+     * from the object identified by `table_key` and `object_key`.
+     */
+    bool is_not_modified(TableKey table_key, ObjKey object_key);
+    void mark_not_modified(TableKey table_key, ObjKey object_key);
+
+private:
+    std::mutex m_link_graph_mutex;
+    std::unique_ptr<DeepChangeChecker::LinkGraph> m_link_graph;
+
+    std::mutex m_not_modified_mutex;
+    std::unordered_map<TableKey, std::unordered_set<ObjKey>> m_not_modified;
+};
 
 } // namespace _impl
 } // namespace realm
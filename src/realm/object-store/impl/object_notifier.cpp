@@ -43,7 +43,8 @@ bool ObjectNotifier::do_add_required_change_info(TransactionChangeInfo& info)
     REALM_ASSERT(m_table);
 
     m_info = &info;
-    info.tables[m_table_key];
+    // Deletions of the object have to be tracked even if none of the columns are
+    info.track_columns(m_table_key, {});
 
     // When adding or removing a callback the related tables can change due to the way we calculate related tables
     // when key path filters are set hence we need to recalculate every time the callbacks are changed.
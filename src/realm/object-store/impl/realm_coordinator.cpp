@@ -43,11 +43,15 @@
 
 #include <realm/db.hpp>
 #include <realm/history.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/string_data.hpp>
 #include <realm/util/fifo_helper.hpp>
+#include <realm/util/thread_pool.hpp>
+#include <realm/util/tracing.hpp>
 #include <realm/sync/config.hpp>
 
 #include <algorithm>
+#include <thread>
 #include <unordered_map>
 
 using namespace realm;
@@ -562,12 +566,40 @@ void RealmCoordinator::close()
 {
     m_db->close();
     m_db = nullptr;
+    util::CheckedLockGuard lock(m_frozen_transaction_mutex);
+    m_frozen_transactions.clear();
 }
 
 TransactionRef RealmCoordinator::begin_read(VersionID version, bool frozen_transaction)
 {
     open_db();
-    return (frozen_transaction) ? m_db->start_frozen(version) : m_db->start_read(version);
+    if (!frozen_transaction)
+        return m_db->start_read(version);
+
+    // The latest version is only known once the transaction has been started
+    bool is_latest = (version == VersionID());
+    if (!is_latest) {
+        util::CheckedLockGuard lock(m_frozen_transaction_mutex);
+        auto it = m_frozen_transactions.find(version.version);
+        if (it != m_frozen_transactions.end()) {
+            if (auto tr = it->second.lock())
+                return tr;
+        }
+    }
+
+    auto tr = m_db->start_frozen(version);
+    util::CheckedLockGuard lock(m_frozen_transaction_mutex);
+    for (auto it = m_frozen_transactions.begin(); it != m_frozen_transactions.end();) {
+        if (it->second.expired())
+            it = m_frozen_transactions.erase(it);
+        else
+            ++it;
+    }
+    auto& cached = m_frozen_transactions[tr->get_version()];
+    if (auto existing = cached.lock())
+        return existing;
+    cached = tr;
+    return tr;
 }
 
 uint64_t RealmCoordinator::get_schema_version() const noexcept
@@ -640,6 +672,15 @@ RealmCoordinator::~RealmCoordinator()
     // Waits for the worker thread to join
     m_notifier = nullptr;
 
+    if (m_delayed_notify_thread.joinable()) {
+        {
+            util::CheckedLockGuard lock(m_delayed_notify_mutex);
+            m_delayed_notify_stop = true;
+        }
+        m_delayed_notify_cv.notify_one();
+        m_delayed_notify_thread.join();
+    }
+
     // Ensure the notifiers aren't holding on to Transactions after we destroy
     // the History object the DB depends on
     // No locking needed here because the worker thread is gone
@@ -845,11 +886,54 @@ void RealmCoordinator::clean_up_dead_notifiers()
 
     if (swap_remove(m_notifiers) && m_notifiers.empty()) {
         m_notifier_sg = nullptr;
+        m_notifier_worker_sgs.clear();
+        m_next_notifier_worker = 0;
         m_notifier_skip_version = {0, 0};
     }
     swap_remove(m_new_notifiers);
 }
 
+void RealmCoordinator::notify_realms_at(std::chrono::steady_clock::time_point time)
+{
+    util::CheckedLockGuard lock(m_delayed_notify_mutex);
+    // A notification at an earlier time will also deliver anything waiting
+    // for this one, as the notifiers will reschedule if they're still not ready
+    if (m_delayed_notify_time && *m_delayed_notify_time <= time)
+        return;
+    m_delayed_notify_time = time;
+    if (m_delayed_notify_thread.joinable())
+        m_delayed_notify_cv.notify_one();
+    else
+        m_delayed_notify_thread = std::thread([this] {
+            run_delayed_notify_thread();
+        });
+}
+
+void RealmCoordinator::run_delayed_notify_thread()
+{
+    util::CheckedUniqueLock lock(m_delayed_notify_mutex);
+    while (!m_delayed_notify_stop) {
+        if (!m_delayed_notify_time) {
+            m_delayed_notify_cv.wait(lock.native_handle());
+            continue;
+        }
+        if (std::chrono::steady_clock::now() < *m_delayed_notify_time) {
+            m_delayed_notify_cv.wait_until(lock.native_handle(), *m_delayed_notify_time);
+            continue;
+        }
+
+        m_delayed_notify_time = util::none;
+        lock.unlock();
+        {
+            util::CheckedLockGuard realm_lock(m_realm_mutex);
+            for (auto& realm : m_weak_realm_notifiers) {
+                realm.notify();
+            }
+        }
+        lock.lock();
+    }
+}
+
 void RealmCoordinator::on_change()
 {
     run_async_notifiers();
@@ -912,6 +996,7 @@ public:
             auto next = &m_info.back();
             for (auto& table : m_current->tables)
                 next->tables[table.first];
+            next->tracked_columns = m_current->tracked_columns;
             m_current = next;
             return true;
         }
@@ -959,6 +1044,11 @@ public:
                 }
             }
         }
+
+        // Each change info is now complete, so deep change checking done by
+        // one notifier can be reused by all other notifiers sharing its info
+        for (auto& info : m_info)
+            info.deep_change_cache = std::make_shared<DeepChangeCache>();
     }
 
 private:
@@ -966,8 +1056,57 @@ private:
     TransactionChangeInfo* m_current = nullptr;
     Transaction& m_sg;
 };
+
+// Run the given notifiers as one task on the default thread pool per distinct
+// Transaction which they are attached to. Notifiers sharing a Transaction are
+// run sequentially as a Transaction cannot be read from multiple threads at
+// once. The change info must already be fully gathered as it is read
+// concurrently.
+void run_notifiers(std::vector<std::shared_ptr<_impl::CollectionNotifier>> const& notifiers)
+{
+    std::vector<Transaction*> transactions;
+    std::vector<std::vector<_impl::CollectionNotifier*>> groups;
+    for (auto& notifier : notifiers) {
+        auto it = std::find(transactions.begin(), transactions.end(), notifier->attached_transaction());
+        if (it == transactions.end()) {
+            transactions.push_back(notifier->attached_transaction());
+            groups.emplace_back();
+            it = transactions.end() - 1;
+        }
+        groups[it - transactions.begin()].push_back(notifier.get());
+    }
+
+    util::ThreadPool::get_default().run_parallel(
+        groups.size(),
+        [&](size_t i) {
+            for (auto notifier : groups[i])
+                notifier->run();
+        },
+        util::ThreadPool::Priority::high); // Throws
+}
 } // anonymous namespace
 
+std::shared_ptr<Transaction> RealmCoordinator::next_notifier_transaction()
+{
+    // Hand out the notifier transactions round-robin so that the notifiers are
+    // spread evenly over the threads used to run them
+    size_t count = std::max<size_t>(m_config.notifier_thread_count, 1);
+    size_t index = m_next_notifier_worker++ % count;
+    if (index == 0)
+        return m_notifier_sg;
+    while (m_notifier_worker_sgs.size() < index)
+        m_notifier_worker_sgs.push_back(m_notifier_sg->duplicate());
+    return m_notifier_worker_sgs[index - 1];
+}
+
+void RealmCoordinator::advance_notifier_worker_transactions(VersionID version)
+{
+    // The change info is gathered on m_notifier_sg, so the other transactions
+    // only need to be moved to the same version
+    for (auto& sg : m_notifier_worker_sgs)
+        sg->advance_read(version);
+}
+
 void RealmCoordinator::run_async_notifiers()
 {
     util::CheckedUniqueLock lock(m_notifier_mutex);
@@ -980,6 +1119,11 @@ void RealmCoordinator::run_async_notifiers()
         return;
     }
 
+#if REALM_METRICS
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::notifier_run);
+#endif
+    util::tracing::Span span("RealmCoordinator::run_async_notifiers");
+
     if (!m_notifier_sg) {
         REALM_ASSERT(m_notifiers.empty());
         REALM_ASSERT(!m_notifier_skip_version.version);
@@ -1019,6 +1163,8 @@ void RealmCoordinator::run_async_notifiers()
 
     auto new_notifiers = std::move(m_new_notifiers);
     m_new_notifiers.clear();
+    span.set_attribute("notifiers", int64_t(notifiers.size()));
+    span.set_attribute("new_notifiers", int64_t(new_notifiers.size()));
     m_notifiers.insert(m_notifiers.end(), new_notifiers.begin(), new_notifiers.end());
 
     // Advance all of the new notifiers to the most recent version, if any
@@ -1074,9 +1220,9 @@ void RealmCoordinator::run_async_notifiers()
         for (auto& notifier : notifiers)
             notifier->add_required_change_info(change_info.current());
         change_info.advance_to_final(skip_version);
+        advance_notifier_worker_transactions(skip_version);
 
-        for (auto& notifier : notifiers)
-            notifier->run();
+        run_notifiers(notifiers);
 
         util::CheckedLockGuard lock(m_notifier_mutex);
         for (auto& notifier : notifiers)
@@ -1090,28 +1236,24 @@ void RealmCoordinator::run_async_notifiers()
         notifier->add_required_change_info(change_info.current());
     }
     change_info.advance_to_final(version);
+    advance_notifier_worker_transactions(version);
 
     // Now that they're at the same version, switch the new notifiers over to
-    // the main Transaction used for background work rather than the temporary one
+    // the Transactions used for background work rather than the temporary one
     REALM_ASSERT(new_notifiers.empty() || m_notifier_sg->get_version_of_current_transaction() ==
                                               new_notifier_transaction->get_version_of_current_transaction());
     for (auto& notifier : new_notifiers) {
-        notifier->attach_to(m_notifier_sg);
-        notifier->run();
+        notifier->attach_to(next_notifier_transaction());
     }
 
     // Change info is now all ready, so the notifiers can now perform their
     // background work
-    for (auto& notifier : notifiers) {
-        notifier->run();
-    }
+    notifiers.insert(notifiers.end(), new_notifiers.begin(), new_notifiers.end());
+    run_notifiers(notifiers);
 
     // Reacquire the lock while updating the fields that are actually read on
     // other threads
     util::CheckedLockGuard lock2(m_notifier_mutex);
-    for (auto& notifier : new_notifiers) {
-        notifier->prepare_handover();
-    }
     for (auto& notifier : notifiers) {
         notifier->prepare_handover();
     }
@@ -1249,6 +1391,11 @@ bool RealmCoordinator::compact()
     return m_db->compact();
 }
 
+size_t RealmCoordinator::release_memory(DB::MemoryPressure level)
+{
+    return m_db->release_memory(level);
+}
+
 void RealmCoordinator::write_copy(StringData path, const char* key)
 {
     m_db->write_copy(path, key);
@@ -24,8 +24,11 @@
 #include <realm/util/checked_mutex.hpp>
 #include <realm/version_id.hpp>
 
+#include <chrono>
 #include <condition_variable>
+#include <map>
 #include <mutex>
+#include <thread>
 
 namespace realm {
 class DB;
@@ -142,6 +145,11 @@ public:
     void send_commit_notifications(Realm&);
     void wake_up_notifier_worker();
 
+    // Call notify() on every Realm instance for this coordinator's path in
+    // this process once `time` is reached. Used to deliver notifications which
+    // were held back to limit how often a callback is called.
+    void notify_realms_at(std::chrono::steady_clock::time_point time) REQUIRES(!m_delayed_notify_mutex);
+
     // Clear the weak Realm cache for all paths
     // Should only be called in test code, as continuing to use the previously
     // cached instances will have odd results
@@ -166,7 +174,11 @@ public:
 
     static void register_notifier(std::shared_ptr<CollectionNotifier> notifier);
 
-    TransactionRef begin_read(VersionID version = {}, bool frozen_transaction = false);
+    // Frozen transactions are immutable, so all frozen Realms and Results at
+    // the same version share a single transaction for as long as any of them
+    // is alive.
+    TransactionRef begin_read(VersionID version = {}, bool frozen_transaction = false)
+        REQUIRES(!m_frozen_transaction_mutex);
 
     // Check if advance_to_ready() would actually advance the Realm's read version
     bool can_advance(Realm& realm);
@@ -195,8 +207,9 @@ public:
     bool wait_for_change(std::shared_ptr<Transaction> tr);
     void wait_for_change_release();
 
-    void close();
+    void close() REQUIRES(!m_frozen_transaction_mutex);
     bool compact();
+    size_t release_memory(DB::MemoryPressure level);
     void write_copy(StringData path, const char* key);
 
     template <typename Pred>
@@ -223,6 +236,10 @@ private:
     util::CheckedMutex m_realm_mutex;
     std::vector<WeakRealmNotifier> m_weak_realm_notifiers GUARDED_BY(m_realm_mutex);
 
+    util::CheckedMutex m_frozen_transaction_mutex;
+    std::map<VersionID::version_type, std::weak_ptr<Transaction>>
+        m_frozen_transactions GUARDED_BY(m_frozen_transaction_mutex);
+
     util::CheckedMutex m_notifier_mutex;
     std::condition_variable m_notifier_cv GUARDED_BY(m_notifier_mutex);
     std::vector<std::shared_ptr<_impl::CollectionNotifier>> m_new_notifiers GUARDED_BY(m_notifier_mutex);
@@ -232,9 +249,22 @@ private:
     // Transaction used for actually running async notifiers
     // Will have a read transaction iff m_notifiers is non-empty
     std::shared_ptr<Transaction> m_notifier_sg;
+    // Additional Transactions used when notifier_thread_count is greater than
+    // one. These are kept at the same version as m_notifier_sg, and each
+    // notifier is attached to either m_notifier_sg or one of these.
+    std::vector<std::shared_ptr<Transaction>> m_notifier_worker_sgs;
+    size_t m_next_notifier_worker = 0;
 
     std::unique_ptr<_impl::ExternalCommitHelper> m_notifier;
 
+    // Thread which calls notify() on our Realms at the earliest time requested
+    // by notify_realms_at(). Only started the first time it is needed.
+    util::CheckedMutex m_delayed_notify_mutex;
+    std::condition_variable m_delayed_notify_cv;
+    util::Optional<std::chrono::steady_clock::time_point> m_delayed_notify_time GUARDED_BY(m_delayed_notify_mutex);
+    bool m_delayed_notify_stop GUARDED_BY(m_delayed_notify_mutex) = false;
+    std::thread m_delayed_notify_thread;
+
 #if REALM_ENABLE_SYNC
     std::shared_ptr<SyncSession> m_sync_session;
 #endif
@@ -252,7 +282,10 @@ private:
                       util::CheckedUniqueLock& realm_lock) REQUIRES(m_realm_mutex);
     void run_async_notifiers() REQUIRES(!m_notifier_mutex);
     void advance_helper_shared_group_to_latest();
+    std::shared_ptr<Transaction> next_notifier_transaction();
+    void advance_notifier_worker_transactions(VersionID version);
     void clean_up_dead_notifiers() REQUIRES(m_notifier_mutex);
+    void run_delayed_notify_thread() REQUIRES(!m_delayed_notify_mutex, !m_realm_mutex);
 
     std::vector<std::shared_ptr<_impl::CollectionNotifier>> notifiers_for_realm(Realm&) REQUIRES(m_notifier_mutex);
 };
@@ -21,6 +21,7 @@
 #include <realm/object-store/shared_realm.hpp>
 
 #include <numeric>
+#include <unordered_set>
 
 using namespace realm;
 using namespace realm::_impl;
@@ -63,6 +64,10 @@ ResultsNotifier::ResultsNotifier(Results& target)
     , m_descriptor_ordering(target.get_descriptor_ordering())
     , m_target_is_in_table_order(target.is_in_table_order())
 {
+    // The notifier keeps rerunning the query in the background, so a token
+    // meant for a single synchronous evaluation must not make it fail
+    m_query->set_cancellation(nullptr);
+    m_descriptor_ordering.set_cancellation(nullptr);
 }
 
 void ResultsNotifier::release_data() noexcept
@@ -103,7 +108,8 @@ bool ResultsNotifier::do_add_required_change_info(TransactionChangeInfo& info)
         update_related_tables(*(m_query->get_table()));
     }
 
-    return m_query->get_table() && has_run() && have_callbacks();
+    m_info_has_table_changes = m_query->get_table() && has_run() && have_callbacks();
+    return m_info_has_table_changes;
 }
 
 void ResultsNotifier::calculate_changes()
@@ -136,6 +142,95 @@ void ResultsNotifier::calculate_changes()
         for (size_t i = 0; i < sz; ++i)
             m_previous_objs[i] = m_run_tv.get_key(i);
     }
+    m_previous_objs_are_current = true;
+}
+
+bool ResultsNotifier::update_incrementally(TableVersions const& new_versions)
+{
+    if (!m_previous_objs_are_current || !m_info_has_table_changes)
+        return false;
+
+    // The change info only tells us which objects in the query's own table
+    // were changed, so the predicate and the sort must not depend on any other
+    // table. Results restricted to a view aren't in table order, which the
+    // sort relies on for breaking ties.
+    if (new_versions.size() != 1 || !m_query->produces_results_in_table_order())
+        return false;
+
+    std::vector<ColKey> sort_columns;
+    std::vector<bool> ascending;
+    if (!m_descriptor_ordering.is_empty()) {
+        if (m_descriptor_ordering.size() != 1 || m_descriptor_ordering.get_type(0) != DescriptorType::Sort)
+            return false;
+        auto sort = static_cast<const SortDescriptor*>(m_descriptor_ordering[0]);
+        auto& columns = sort->get_column_keys();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i].size() != 1)
+                return false;
+            sort_columns.push_back(columns[i][0]);
+            ascending.push_back(sort->is_ascending(i).value_or(true));
+        }
+    }
+
+    // If only the columns on some key paths were tracked, changes to the
+    // columns used by the query may be missing from the change info
+    auto table = m_query->get_table();
+    auto it = m_info->tables.find(table->get_key());
+    if (it == m_info->tables.end() || !m_info->tracks_all_columns(table->get_key()))
+        return false;
+    auto& changes = it->second;
+
+    // Evaluating the query one object at a time is much slower per object than
+    // running it over the whole table, so only do so for small changes
+    size_t change_count = changes.insertions_size() + changes.modifications_size() + changes.deletions_size();
+    if (change_count > table->size() / 8)
+        return false;
+
+    std::unordered_set<ObjKey> changed;
+    changed.reserve(change_count);
+    changed.insert(changes.get_insertions().begin(), changes.get_insertions().end());
+    changed.insert(changes.get_deletions().begin(), changes.get_deletions().end());
+    for (auto& modification : changes.get_modifications())
+        changed.insert(modification.first);
+
+    // Objects which weren't changed keep both their place in the results and
+    // their relative order, so only the changed objects need to be re-evaluated
+    // and then inserted in the right places
+    std::vector<ObjKey> kept;
+    kept.reserve(m_previous_objs.size());
+    for (auto key : m_previous_objs) {
+        if (!changed.count(key))
+            kept.push_back(key);
+    }
+    auto matches = m_query->find_all_of(std::vector<ObjKey>(changed.begin(), changed.end()));
+
+    auto less = [&](ObjKey a, ObjKey b) {
+        if (!sort_columns.empty()) {
+            auto obj_a = table->get_object(a);
+            auto obj_b = table->get_object(b);
+            for (size_t i = 0; i < sort_columns.size(); ++i) {
+                int c = obj_a.get_any(sort_columns[i]).compare(obj_b.get_any(sort_columns[i]));
+                if (c)
+                    return ascending[i] ? c < 0 : c > 0;
+            }
+        }
+        return a < b;
+    };
+    std::sort(matches.begin(), matches.end(), less);
+
+    std::vector<ObjKey> keys;
+    keys.reserve(kept.size() + matches.size());
+    auto begin = kept.begin();
+    for (auto key : matches) {
+        auto pos = std::upper_bound(begin, kept.end(), key, less);
+        keys.insert(keys.end(), begin, pos);
+        keys.push_back(key);
+        begin = pos;
+    }
+    keys.insert(keys.end(), begin, kept.end());
+
+    m_run_tv = TableView(*m_query, keys, m_descriptor_ordering);
+    return true;
 }
 
 void ResultsNotifier::run()
@@ -153,8 +248,10 @@ void ResultsNotifier::run()
     {
         auto lock = lock_target();
         // Don't run the query if the results aren't actually going to be used
-        if (!get_realm() || (!have_callbacks() && !m_results_were_used))
+        if (!get_realm() || (!have_callbacks() && !m_results_were_used)) {
+            m_previous_objs_are_current = false;
             return;
+        }
     }
 
     auto new_versions = m_query->sync_view_if_needed();
@@ -176,10 +273,14 @@ void ResultsNotifier::run()
         return;
     }
 
-    m_query->sync_view_if_needed();
-    m_run_tv = m_query->find_all();
-    m_run_tv.apply_descriptor_ordering(m_descriptor_ordering);
-    m_run_tv.sync_if_needed();
+    // When only a few objects in the table changed, patch the previous results
+    // rather than rerunning the query over the whole table
+    if (!update_incrementally(new_versions)) {
+        m_query->sync_view_if_needed();
+        m_run_tv = m_query->find_all();
+        m_run_tv.apply_descriptor_ordering(m_descriptor_ordering);
+        m_run_tv.sync_if_needed();
+    }
     m_last_seen_version = std::move(new_versions);
 
     calculate_changes();
@@ -72,11 +72,16 @@ private:
 
     // The objects from the previous run of the query, for calculating diffs
     ObjKeys m_previous_objs;
+    // True if m_previous_objs is the result of the query at the version the
+    // notifier was last run at, and m_info holds the changes since then
+    bool m_previous_objs_are_current = false;
+    bool m_info_has_table_changes = false;
 
     TransactionChangeInfo* m_info = nullptr;
     bool m_results_were_used = true;
 
     void calculate_changes();
+    bool update_incrementally(TableVersions const& new_versions);
 
     void run() override;
     void do_prepare_handover(Transaction&) override;
@@ -244,6 +244,10 @@ public:
     {
         return true;
     }
+    bool set_compressed(ColKey, bool)
+    {
+        return true;
+    }
     bool insert_column(ColKey)
     {
         return true;
@@ -325,6 +329,10 @@ struct TransactLogValidator : public TransactLogValidationMixin {
     {
         return true;
     }
+    bool modify_object_range(ColKey, ObjKey, size_t)
+    {
+        return true;
+    }
     bool select_collection(ColKey, ObjKey)
     {
         return true;
@@ -336,6 +344,8 @@ class TransactLogObserver : public TransactLogValidationMixin {
     _impl::TransactionChangeInfo& m_info;
     _impl::CollectionChangeBuilder* m_active_collection = nullptr;
     ObjectChangeSet* m_active_table = nullptr;
+    // Columns of the active table to record modifications of, or null for all
+    std::vector<ColKey> const* m_active_columns = nullptr;
 
     _impl::CollectionChangeBuilder* find_list(ObjKey obj, ColKey col)
     {
@@ -382,6 +392,8 @@ public:
             else
                 m_active_table = &it->second;
         }
+        auto columns = m_info.tracked_columns.find(table_key);
+        m_active_columns = columns == m_info.tracked_columns.end() ? nullptr : &columns->second;
         return true;
     }
 
@@ -510,11 +522,22 @@ public:
 
     bool modify_object(ColKey col, ObjKey key)
     {
-        if (m_active_table)
+        if (m_active_table && (!m_active_columns || std::binary_search(m_active_columns->begin(),
+                                                                       m_active_columns->end(), col)))
             m_active_table->modifications_add(key, col);
         return true;
     }
 
+    bool modify_object_range(ColKey col, ObjKey first_key, size_t count)
+    {
+        if (m_active_table && (!m_active_columns || std::binary_search(m_active_columns->begin(),
+                                                                       m_active_columns->end(), col))) {
+            for (size_t i = 0; i < count; ++i)
+                m_active_table->modifications_add(ObjKey(first_key.value + int64_t(i)), col);
+        }
+        return true;
+    }
+
     bool insert_column(ColKey)
     {
         m_info.schema_changed = true;
@@ -116,7 +116,7 @@ ChunkedRangeVector::iterator ChunkedRangeVector::ensure_space(iterator pos)
     auto to_move = max_size / 2;
     new_pos->data.reserve(to_move);
     new_pos->data.assign(prev->data.end() - to_move, prev->data.end());
-    prev->data.resize(prev->data.size() - to_move);
+    prev->data.erase(prev->data.end() - to_move, prev->data.end());
 
     size_t moved_count = 0;
     for (auto range : new_pos->data)
@@ -200,10 +200,10 @@ public:
     ChunkedRangeVectorBuilder(ChunkedRangeVector const& expected);
     void push_back(size_t index);
     void push_back(std::pair<size_t, size_t> range);
-    std::vector<ChunkedRangeVector::Chunk> finalize();
+    ChunkedRangeVector::Chunks finalize();
 
 private:
-    std::vector<ChunkedRangeVector::Chunk> m_data;
+    ChunkedRangeVector::Chunks m_data;
     size_t m_outer_pos = 0;
 };
 
@@ -242,7 +242,7 @@ void ChunkedRangeVectorBuilder::push_back(std::pair<size_t, size_t> range)
         chunk.end = chunk.data.back().second;
         ++m_outer_pos;
         if (m_outer_pos >= m_data.size())
-            m_data.push_back({{range}, range.first, 0, 1});
+            m_data.push_back({{range}, range.first, 0, range.second - range.first});
         else {
             auto& chunk = m_data[m_outer_pos];
             chunk.data.push_back(range);
@@ -252,7 +252,7 @@ void ChunkedRangeVectorBuilder::push_back(std::pair<size_t, size_t> range)
     }
 }
 
-std::vector<ChunkedRangeVector::Chunk> ChunkedRangeVectorBuilder::finalize()
+ChunkedRangeVector::Chunks ChunkedRangeVectorBuilder::finalize()
 {
     if (!m_data.empty()) {
         m_data.resize(m_outer_pos + 1);
@@ -298,7 +298,8 @@ size_t IndexSet::count(size_t start_index, size_t end_index) const noexcept
         }
         if (it != end && it->first < end_index && it.offset() != 0)
             ret += end_index - it->first;
-        if (it == end || it->second >= end_index)
+        // If we stopped at the start of a chunk the remainder is counted below
+        if (it == end || it.offset() != 0)
             return ret;
     }
 
@@ -328,8 +329,10 @@ IndexSet::iterator IndexSet::find(size_t index) noexcept
 
 IndexSet::iterator IndexSet::find(size_t index, iterator begin) noexcept
 {
-    auto it = std::find_if(begin.outer(), m_data.end(), [&](auto const& lft) {
-        return lft.end > index;
+    // Chunks are sorted and non-overlapping, so the first one which ends
+    // after the index can be found with a binary search
+    auto it = std::partition_point(begin.outer(), m_data.end(), [&](auto const& lft) {
+        return lft.end <= index;
     });
     if (it == m_data.end())
         return end();
@@ -658,12 +661,17 @@ void IndexSet::remove(realm::IndexSet const& values)
 
 size_t IndexSet::shift(size_t index) const noexcept
 {
-    // FIXME: optimize
-    for (auto range : *this) {
-        if (range.first > index)
-            break;
-        index += range.second - range.first;
-    }
+    auto it = cbegin(), end = cend();
+
+    // Shift for any complete chunks before the target. Every range in a chunk
+    // shifts the index if the last one does, which is the case if the
+    // chunk ends before the index shifted by the whole chunk.
+    for (; it != end && it.outer()->end <= index + it.outer()->count; it.next_chunk())
+        index += it.outer()->count;
+
+    // And any ranges within the last partial chunk
+    for (; it != end && it->first <= index; ++it)
+        index += it->second - it->first;
     return index;
 }
 
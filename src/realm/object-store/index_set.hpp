@@ -19,6 +19,8 @@
 #ifndef REALM_INDEX_SET_HPP
 #define REALM_INDEX_SET_HPP
 
+#include <realm/util/small_vector.hpp>
+
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
@@ -104,14 +106,21 @@ public:
 };
 
 // A vector which stores ranges in chunks with a maximum size
+//
+// The first chunk and the first few ranges within each chunk are stored
+// inline, so small sets (which are by far the most common in change
+// notifications) never allocate.
 struct ChunkedRangeVector {
+    static const size_t inline_ranges = 4;
+
     struct Chunk {
-        std::vector<std::pair<size_t, size_t>> data;
+        util::SmallVector<std::pair<size_t, size_t>, inline_ranges> data;
         size_t begin;
         size_t end;
         size_t count;
     };
-    std::vector<Chunk> m_data;
+    using Chunks = util::SmallVector<Chunk, 1>;
+    Chunks m_data;
 
     using value_type = std::pair<size_t, size_t>;
     using iterator = MutableChunkedRangeVectorIterator<typename decltype(m_data)::iterator>;
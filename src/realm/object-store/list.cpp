@@ -205,6 +205,34 @@ Mixed List::get_any(size_t row_ndx) const
     return value;
 }
 
+void List::get_any_range(size_t begin, size_t end, Mixed* out) const
+{
+    if (begin > end)
+        throw OutOfBoundsIndexException{begin, end};
+    if (begin == end)
+        return;
+    verify_valid_row(end - 1);
+    dispatch([&](auto t) {
+        using T = std::decay_t<decltype(*t)>;
+        if constexpr (std::is_same_v<T, Obj>) {
+            for (size_t i = begin; i < end; ++i)
+                out[i - begin] = get_any(i);
+        }
+        else {
+            // Not a std::vector, as there is no std::vector<bool>::data()
+            const size_t count = end - begin;
+            auto values = std::make_unique<T[]>(count);
+            as<T>().get_range(begin, end, values.get());
+            for (size_t i = 0; i < count; ++i)
+                out[i] = Mixed(values[i]);
+            if constexpr (std::is_same_v<T, Mixed>) {
+                for (size_t i = 0; i < count; ++i)
+                    record_audit_read(out[i]);
+            }
+        }
+    });
+}
+
 size_t List::find_any(Mixed value) const
 {
     return list_base().find_any(value);
@@ -78,6 +78,8 @@ public:
     void insert_any(size_t list_ndx, Mixed value);
     void set_any(size_t list_ndx, Mixed value);
     Mixed get_any(size_t list_ndx) const final;
+    // Read the values in [begin, end) into `out` a leaf at a time
+    void get_any_range(size_t begin, size_t end, Mixed* out) const;
     size_t find_any(Mixed value) const final;
 
     Results filter(Query q) const;
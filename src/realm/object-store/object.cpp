@@ -199,3 +199,49 @@ void Object::validate_property_for_setter(Property const& property) const
         m_obj.get_table()->set_primary_key_column({});
     }
 }
+
+ClassAccessor::ClassAccessor(std::shared_ptr<Realm> realm, StringData object_type)
+    : m_realm(std::move(realm))
+    , m_object_schema(find_object_schema(*m_realm, object_type))
+{
+    // In the order ObjectSchema::property_for_name() searches them
+    auto add = [&](const Property& prop) {
+        const ObjectSchema* target_schema = nullptr;
+        auto type = prop.type & ~PropertyType::Flags;
+        if (type == PropertyType::Object || type == PropertyType::LinkingObjects)
+            target_schema = find_object_schema(*m_realm, StringData(prop.object_type));
+        m_properties.push_back({&prop, target_schema});
+    };
+    m_properties.reserve(m_object_schema->persisted_properties.size() +
+                         m_object_schema->computed_properties.size());
+    for (auto& prop : m_object_schema->persisted_properties)
+        add(prop);
+    for (auto& prop : m_object_schema->computed_properties)
+        add(prop);
+}
+
+ConstTableRef ClassAccessor::get_table() const
+{
+    if (!m_object_schema->table_key)
+        return {};
+    return m_realm->read_group().get_table(m_object_schema->table_key);
+}
+
+size_t ClassAccessor::get_property_index(StringData prop_name) const
+{
+    for (size_t i = 0; i < m_properties.size(); ++i) {
+        if (StringData(m_properties[i].property->name) == prop_name)
+            return i;
+    }
+    throw InvalidPropertyException(m_object_schema->name, prop_name);
+}
+
+void ClassAccessor::verify_attached(const Obj& obj) const
+{
+    m_realm->verify_thread();
+    if (!obj.is_valid()) {
+        throw InvalidatedObjectException(m_object_schema->name);
+    }
+    if (auto audit = m_realm->audit_context())
+        audit->record_read(m_realm->read_transaction_version(), obj, {}, {});
+}
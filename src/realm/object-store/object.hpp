@@ -183,6 +183,7 @@ public:
     void verify_attached() const;
 
 private:
+    friend class ClassAccessor;
     friend class Results;
 
     std::shared_ptr<Realm> m_realm;
@@ -200,6 +201,11 @@ private:
                                  bool is_default);
     template <typename ValueType, typename ContextType>
     ValueType get_property_value_impl(ContextType& ctx, const Property& property) const;
+    // The target class of a link or linking objects property is looked up if
+    // `target_schema` is null
+    template <typename ValueType, typename ContextType>
+    static ValueType read_property_value(ContextType& ctx, const std::shared_ptr<Realm>& realm, const Obj& obj,
+                                         const Property& property, const ObjectSchema* target_schema);
 
     template <typename ValueType, typename ContextType>
     static ObjKey get_for_primary_key_in_migration(ContextType& ctx, Table const& table, const Property& primary_prop,
@@ -209,6 +215,66 @@ private:
     void validate_property_for_setter(Property const&) const;
 };
 
+// Reads the objects of one class for bindings which read many objects of the
+// same class, such as when scrolling through a list. The object schema, the
+// properties and the classes they link to are resolved once, when the
+// accessor is created, and the objects are read through their Obj, so unlike
+// reading through an Object nothing is looked up by name, no reference to the
+// Realm is taken and nothing is allocated per object, save for the values
+// boxed by the context. The accessor must be created anew when the schema of
+// the Realm changes.
+class ClassAccessor {
+public:
+    ClassAccessor(std::shared_ptr<Realm> realm, StringData object_type);
+
+    std::shared_ptr<Realm> const& get_realm() const noexcept
+    {
+        return m_realm;
+    }
+    ObjectSchema const& get_object_schema() const noexcept
+    {
+        return *m_object_schema;
+    }
+    // The table of the class, or a null ref if it has not been created yet
+    ConstTableRef get_table() const;
+
+    // The index of a property in the functions below. Throws
+    // InvalidPropertyException if the class has no such property.
+    size_t get_property_index(StringData prop_name) const;
+    Property const& get_property(size_t prop_ndx) const noexcept
+    {
+        return *m_properties[prop_ndx].property;
+    }
+
+    // Same value as Object::get_property_value() for an Object of `obj`
+    template <typename ValueType, typename ContextType>
+    ValueType get_property_value(ContextType& ctx, const Obj& obj, size_t prop_ndx) const;
+
+    // A null Obj if there is no object with that primary key
+    template <typename ValueType, typename ContextType>
+    Obj get_for_primary_key(ContextType& ctx, ValueType primary_value) const;
+
+    // An Object for what this accessor does not do, such as writing values
+    // or observing the object
+    Object get_object(Obj const& obj) const
+    {
+        return Object(m_realm, *m_object_schema, obj);
+    }
+
+private:
+    struct ResolvedProperty {
+        const Property* property;
+        // The class linked to by an object or linking objects property
+        const ObjectSchema* target_schema;
+    };
+
+    std::shared_ptr<Realm> m_realm;
+    const ObjectSchema* m_object_schema;
+    std::vector<ResolvedProperty> m_properties;
+
+    void verify_attached(const Obj& obj) const;
+};
+
 struct InvalidatedObjectException : public std::logic_error {
     InvalidatedObjectException(const std::string& object_type);
     const std::string object_type;
@@ -179,54 +179,62 @@ template <typename ValueType, typename ContextType>
 ValueType Object::get_property_value_impl(ContextType& ctx, const Property& property) const
 {
     verify_attached();
+    return read_property_value<ValueType>(ctx, m_realm, m_obj, property, nullptr);
+}
 
+template <typename ValueType, typename ContextType>
+ValueType Object::read_property_value(ContextType& ctx, const std::shared_ptr<Realm>& realm, const Obj& obj,
+                                      const Property& property, const ObjectSchema* target_schema)
+{
     ColKey column{property.column_key};
-    if (is_nullable(property.type) && m_obj.is_null(column))
+    if (is_nullable(property.type) && obj.is_null(column))
         return ctx.null_value();
     if (is_array(property.type) && property.type != PropertyType::LinkingObjects)
-        return ctx.box(List(m_realm, m_obj, column));
+        return ctx.box(List(realm, obj, column));
     if (is_set(property.type) && property.type != PropertyType::LinkingObjects)
-        return ctx.box(object_store::Set(m_realm, m_obj, column));
+        return ctx.box(object_store::Set(realm, obj, column));
     if (is_dictionary(property.type))
-        return ctx.box(object_store::Dictionary(m_realm, m_obj, column));
+        return ctx.box(object_store::Dictionary(realm, obj, column));
 
     switch (property.type & ~PropertyType::Flags) {
         case PropertyType::Bool:
-            return ctx.box(m_obj.get<bool>(column));
+            return ctx.box(obj.get<bool>(column));
         case PropertyType::Int:
-            return is_nullable(property.type) ? ctx.box(*m_obj.get<util::Optional<int64_t>>(column))
-                                              : ctx.box(m_obj.get<int64_t>(column));
+            return is_nullable(property.type) ? ctx.box(*obj.get<util::Optional<int64_t>>(column))
+                                              : ctx.box(obj.get<int64_t>(column));
         case PropertyType::Float:
-            return ctx.box(m_obj.get<float>(column));
+            return ctx.box(obj.get<float>(column));
         case PropertyType::Double:
-            return ctx.box(m_obj.get<double>(column));
+            return ctx.box(obj.get<double>(column));
         case PropertyType::String:
-            return ctx.box(m_obj.get<StringData>(column));
+            return ctx.box(obj.get<StringData>(column));
         case PropertyType::Data:
-            return ctx.box(m_obj.get<BinaryData>(column));
+            return ctx.box(obj.get<BinaryData>(column));
         case PropertyType::Date:
-            return ctx.box(m_obj.get<Timestamp>(column));
+            return ctx.box(obj.get<Timestamp>(column));
         case PropertyType::ObjectId:
-            return is_nullable(property.type) ? ctx.box(m_obj.get<util::Optional<ObjectId>>(column))
-                                              : ctx.box(m_obj.get<ObjectId>(column));
+            return is_nullable(property.type) ? ctx.box(obj.get<util::Optional<ObjectId>>(column))
+                                              : ctx.box(obj.get<ObjectId>(column));
         case PropertyType::Decimal:
-            return ctx.box(m_obj.get<Decimal>(column));
+            return ctx.box(obj.get<Decimal>(column));
         case PropertyType::UUID:
-            return is_nullable(property.type) ? ctx.box(m_obj.get<util::Optional<UUID>>(column))
-                                              : ctx.box(m_obj.get<UUID>(column));
+            return is_nullable(property.type) ? ctx.box(obj.get<util::Optional<UUID>>(column))
+                                              : ctx.box(obj.get<UUID>(column));
         case PropertyType::Mixed:
-            return ctx.box(m_obj.get<Mixed>(column));
+            return ctx.box(obj.get<Mixed>(column));
         case PropertyType::Object: {
-            auto linkObjectSchema = m_realm->schema().find(property.object_type);
-            auto linked = const_cast<Obj&>(m_obj).get_linked_object(column);
-            return ctx.box(Object(m_realm, *linkObjectSchema, linked, m_obj, column));
+            if (!target_schema)
+                target_schema = &*realm->schema().find(property.object_type);
+            auto linked = const_cast<Obj&>(obj).get_linked_object(column);
+            return ctx.box(Object(realm, *target_schema, linked, obj, column));
         }
         case PropertyType::LinkingObjects: {
-            auto target_object_schema = m_realm->schema().find(property.object_type);
-            auto link_property = target_object_schema->property_for_name(property.link_origin_property_name);
-            auto table = m_realm->read_group().get_table(target_object_schema->table_key);
-            auto tv = const_cast<Obj&>(m_obj).get_backlink_view(table, ColKey(link_property->column_key));
-            return ctx.box(Results(m_realm, std::move(tv)));
+            if (!target_schema)
+                target_schema = &*realm->schema().find(property.object_type);
+            auto link_property = target_schema->property_for_name(property.link_origin_property_name);
+            auto table = realm->read_group().get_table(target_schema->table_key);
+            auto tv = const_cast<Obj&>(obj).get_backlink_view(table, ColKey(link_property->column_key));
+            return ctx.box(Results(realm, std::move(tv)));
         }
         default:
             REALM_UNREACHABLE();
@@ -401,6 +409,35 @@ Object Object::get_for_primary_key(ContextType& ctx, std::shared_ptr<Realm> cons
     return Object(realm, object_schema, key ? table->get_object(key) : Obj{});
 }
 
+template <typename ValueType, typename ContextType>
+ValueType ClassAccessor::get_property_value(ContextType& ctx, const Obj& obj, size_t prop_ndx) const
+{
+    verify_attached(obj);
+    auto& prop = m_properties[prop_ndx];
+    return Object::read_property_value<ValueType>(ctx, m_realm, obj, *prop.property, prop.target_schema);
+}
+
+template <typename ValueType, typename ContextType>
+Obj ClassAccessor::get_for_primary_key(ContextType& ctx, ValueType primary_value) const
+{
+    auto primary_prop = m_object_schema->primary_key_property();
+    if (!primary_prop) {
+        throw MissingPrimaryKeyException(m_object_schema->name);
+    }
+
+    auto table = get_table();
+    if (!table)
+        return Obj();
+    if (ctx.is_null(primary_value) && !is_nullable(primary_prop->type))
+        throw std::logic_error("Invalid null value for non-nullable primary key.");
+
+    auto primary_key_value = switch_on_type(primary_prop->type, [&](auto* t) {
+        return Mixed(ctx.template unbox<NonObjTypeT<decltype(*t)>>(primary_value));
+    });
+    auto key = table->find_primary_key(primary_key_value);
+    return key ? table->get_object(key) : Obj();
+}
+
 template <typename ValueType, typename ContextType>
 ObjKey Object::get_for_primary_key_in_migration(ContextType& ctx, Table const& table, const Property& primary_prop,
                                                 ValueType&& primary_value)
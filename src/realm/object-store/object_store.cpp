@@ -42,6 +42,7 @@ constexpr uint64_t ObjectStore::NotVersioned;
 namespace {
 const char* const c_metadataTableName = "metadata";
 const char* const c_versionColumnName = "version";
+const char* const c_fingerprintColumnName = "fingerprint";
 
 const char c_object_table_prefix[] = "class_";
 
@@ -239,6 +240,29 @@ uint64_t ObjectStore::get_schema_version(Group const& group)
     return table->get_object(0).get<int64_t>(c_versionColumnName);
 }
 
+void ObjectStore::set_schema_fingerprint(Group& group, uint64_t fingerprint)
+{
+    ::create_metadata_tables(group);
+    TableRef table = group.get_table(c_metadataTableName);
+    ColKey col = table->get_column_key(c_fingerprintColumnName);
+    if (!col)
+        col = table->add_column(type_Int, c_fingerprintColumnName);
+    table->get_object(0).set<int64_t>(col, fingerprint);
+}
+
+uint64_t ObjectStore::get_schema_fingerprint(Group const& group)
+{
+    ConstTableRef table = group.get_table(c_metadataTableName);
+    if (!table || table->get_column_count() == 0) {
+        return 0;
+    }
+    ColKey col = table->get_column_key(c_fingerprintColumnName);
+    if (!col) {
+        return 0;
+    }
+    return table->get_object(0).get<int64_t>(col);
+}
+
 StringData ObjectStore::object_type_for_table_name(StringData table_name)
 {
     if (table_name.begins_with(c_object_table_prefix)) {
@@ -530,7 +554,40 @@ void ObjectStore::verify_compatible_for_immutable_and_readonly(std::vector<Schem
     verify_no_errors<InvalidReadOnlySchemaChangeException>(verifier, changes);
 }
 
-static void apply_non_migration_changes(Group& group, std::vector<SchemaChange> const& changes)
+namespace {
+// Reports the schema changes applied so far to the progress function passed
+// to apply_schema_changes(). A migration applies the changes in a pass before
+// and a pass after the migration function, so each change is counted once per
+// pass.
+class MigrationProgress {
+public:
+    MigrationProgress(std::function<void(size_t, size_t)> const& callback = {}, size_t total = 0)
+        : m_callback(callback)
+        , m_total(total)
+    {
+    }
+
+    void set_total(size_t total) noexcept
+    {
+        m_total = total;
+    }
+
+    void did_apply(size_t count = 1)
+    {
+        m_applied += count;
+        if (m_callback)
+            m_callback(m_applied, m_total);
+    }
+
+private:
+    std::function<void(size_t, size_t)> m_callback;
+    size_t m_applied = 0;
+    size_t m_total;
+};
+} // anonymous namespace
+
+static void apply_non_migration_changes(Group& group, std::vector<SchemaChange> const& changes,
+                                        MigrationProgress& progress)
 {
     using namespace schema_change;
     struct Applier : SchemaDifferenceExplainer {
@@ -564,6 +621,7 @@ static void apply_non_migration_changes(Group& group, std::vector<SchemaChange>
         }
     } applier{group};
     verify_no_errors<SchemaMismatchException>(applier, changes);
+    progress.did_apply(changes.size());
 }
 
 static void set_primary_key(Table& table, const Property* property)
@@ -576,7 +634,8 @@ static void set_primary_key(Table& table, const Property* property)
     table.set_primary_key_column(col);
 }
 
-static void create_initial_tables(Group& group, std::vector<SchemaChange> const& changes)
+static void create_initial_tables(Group& group, std::vector<SchemaChange> const& changes,
+                                  MigrationProgress& progress)
 {
     using namespace schema_change;
     struct Applier {
@@ -644,10 +703,12 @@ static void create_initial_tables(Group& group, std::vector<SchemaChange> const&
 
     for (auto& change : changes) {
         change.visit(applier);
+        progress.did_apply();
     }
 }
 
-void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes)
+static void apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes,
+                                   MigrationProgress& progress)
 {
     using namespace schema_change;
     struct Applier {
@@ -696,10 +757,18 @@ void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange>
 
     for (auto& change : changes) {
         change.visit(applier);
+        progress.did_apply();
     }
 }
 
-static void apply_pre_migration_changes(Group& group, std::vector<SchemaChange> const& changes)
+void ObjectStore::apply_additive_changes(Group& group, std::vector<SchemaChange> const& changes, bool update_indexes)
+{
+    MigrationProgress progress;
+    ::apply_additive_changes(group, changes, update_indexes, progress);
+}
+
+static void apply_pre_migration_changes(Group& group, std::vector<SchemaChange> const& changes,
+                                        MigrationProgress& progress)
 {
     using namespace schema_change;
     struct Applier {
@@ -758,6 +827,7 @@ static void apply_pre_migration_changes(Group& group, std::vector<SchemaChange>
 
     for (auto& change : changes) {
         change.visit(applier);
+        progress.did_apply();
     }
 }
 
@@ -766,7 +836,8 @@ enum class HandleBackLinksAutomatically { Yes, No };
 
 static void apply_post_migration_changes(Group& group, std::vector<SchemaChange> const& changes,
                                          Schema const& initial_schema, DidRereadSchema did_reread_schema,
-                                         HandleBackLinksAutomatically handle_backlinks_automatically)
+                                         HandleBackLinksAutomatically handle_backlinks_automatically,
+                                         MigrationProgress& progress)
 {
     using namespace schema_change;
     struct Applier {
@@ -875,6 +946,7 @@ static void apply_post_migration_changes(Group& group, std::vector<SchemaChange>
 
     for (auto& change : changes) {
         change.visit(applier);
+        progress.did_apply();
     }
 }
 
@@ -882,9 +954,11 @@ static void apply_post_migration_changes(Group& group, std::vector<SchemaChange>
 void ObjectStore::apply_schema_changes(Transaction& group, uint64_t schema_version, Schema& target_schema,
                                        uint64_t target_schema_version, SchemaMode mode,
                                        std::vector<SchemaChange> const& changes, bool handle_automatically_backlinks,
-                                       std::function<void()> migration_function)
+                                       std::function<void()> migration_function,
+                                       std::function<void(size_t, size_t)> const& progress_function)
 {
     create_metadata_tables(group);
+    MigrationProgress progress(progress_function, changes.size());
 
     if (mode == SchemaMode::AdditiveDiscovered || mode == SchemaMode::AdditiveExplicit) {
         bool target_schema_is_newer =
@@ -892,7 +966,7 @@ void ObjectStore::apply_schema_changes(Transaction& group, uint64_t schema_versi
 
         // With sync v2.x, indexes are no longer synced, so there's no reason to avoid creating them.
         bool update_indexes = true;
-        apply_additive_changes(group, changes, update_indexes);
+        ::apply_additive_changes(group, changes, update_indexes, progress);
 
         if (target_schema_is_newer)
             set_schema_version(group, target_schema_version);
@@ -903,7 +977,7 @@ void ObjectStore::apply_schema_changes(Transaction& group, uint64_t schema_versi
 
     if (schema_version == ObjectStore::NotVersioned) {
         if (mode != SchemaMode::ReadOnly) {
-            create_initial_tables(group, changes);
+            create_initial_tables(group, changes, progress);
         }
         set_schema_version(group, target_schema_version);
         set_schema_keys(group, target_schema);
@@ -924,13 +998,14 @@ void ObjectStore::apply_schema_changes(Transaction& group, uint64_t schema_versi
     }
 
     if (schema_version == target_schema_version) {
-        apply_non_migration_changes(group, changes);
+        apply_non_migration_changes(group, changes, progress);
         set_schema_keys(group, target_schema);
         return;
     }
 
     auto old_schema = schema_from_group(group);
-    apply_pre_migration_changes(group, changes);
+    progress.set_total(changes.size() * 2);
+    apply_pre_migration_changes(group, changes, progress);
     HandleBackLinksAutomatically handle_backlinks =
         handle_automatically_backlinks ? HandleBackLinksAutomatically::Yes : HandleBackLinksAutomatically::No;
     if (migration_function) {
@@ -939,12 +1014,14 @@ void ObjectStore::apply_schema_changes(Transaction& group, uint64_t schema_versi
 
         // Migration function may have changed the schema, so we need to re-read it
         auto schema = schema_from_group(group);
-        apply_post_migration_changes(group, schema.compare(target_schema, mode), old_schema, DidRereadSchema::Yes,
-                                     handle_backlinks);
+        auto post_migration_changes = schema.compare(target_schema, mode);
+        progress.set_total(changes.size() + post_migration_changes.size());
+        apply_post_migration_changes(group, post_migration_changes, old_schema, DidRereadSchema::Yes,
+                                     handle_backlinks, progress);
         group.validate_primary_columns();
     }
     else {
-        apply_post_migration_changes(group, changes, {}, DidRereadSchema::No, handle_backlinks);
+        apply_post_migration_changes(group, changes, {}, DidRereadSchema::No, handle_backlinks, progress);
     }
 
     set_schema_version(group, target_schema_version);
@@ -56,6 +56,14 @@ public:
     // NOTE: must be performed within a write transaction
     static void set_schema_version(Group& group, uint64_t version);
 
+    // get the fingerprint stored with set_schema_fingerprint(), or 0 if there is none
+    static uint64_t get_schema_fingerprint(Group const& group);
+
+    // store a fingerprint of a schema which is known to match the file, so that
+    // opening the file with the same schema can skip validating and diffing it
+    // NOTE: must be performed within a write transaction
+    static void set_schema_fingerprint(Group& group, uint64_t fingerprint);
+
     // check if all of the changes in the list can be applied automatically, or
     // throw if any of them require a schema version bump and migration function
     static void verify_no_migration_required(std::vector<SchemaChange> const& changes);
@@ -81,11 +89,13 @@ public:
     // updates a Realm from old_schema to the given target schema, creating and updating tables as needed
     // passed in target schema is updated with the correct column mapping
     // optionally runs migration function if schema is out of date
+    // optionally reports the number of changes applied so far and the total to progress_function
     // NOTE: must be performed within a write transaction
     static void apply_schema_changes(Transaction& group, uint64_t schema_version, Schema& target_schema,
                                      uint64_t target_schema_version, SchemaMode mode,
                                      std::vector<SchemaChange> const& changes, bool handle_automatically_backlinks,
-                                     std::function<void()> migration_function = {});
+                                     std::function<void()> migration_function = {},
+                                     std::function<void(size_t, size_t)> const& progress_function = {});
 
     static void apply_additive_changes(Group&, std::vector<SchemaChange> const&, bool update_indexes);
 
@@ -25,9 +25,12 @@
 #include <realm/object-store/object_store.hpp>
 #include <realm/object-store/schema.hpp>
 #include <realm/object-store/sectioned_results.hpp>
+#include <realm/object-store/util/scheduler.hpp>
 
 #include <realm/set.hpp>
+#include <realm/util/thread_pool.hpp>
 
+#include <cstring>
 #include <stdexcept>
 
 namespace realm {
@@ -139,6 +142,21 @@ size_t Results::size()
     return do_size();
 }
 
+Query::Estimate Results::count_approximate(double fraction)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    validate_read();
+    if (m_mode == Mode::Query && !m_descriptor_ordering.will_apply_distinct() &&
+        !m_descriptor_ordering.will_apply_limit())
+        return m_query.count_approximate(fraction);
+
+    Query::Estimate estimate;
+    size_t size = do_size();
+    estimate.value = double(size);
+    estimate.sampled_rows = size;
+    return estimate;
+}
+
 size_t Results::do_size()
 {
     validate_read();
@@ -289,6 +307,8 @@ void Results::ensure_up_to_date(EvaluateMode mode)
             if (m_update_policy != UpdatePolicy::AsyncOnly)
                 m_table_view = m_query.find_all(m_descriptor_ordering);
             m_mode = Mode::TableView;
+            m_prefix_view = TableView();
+            m_prefix_limit = 0;
             if (auto audit = m_realm->audit_context())
                 audit->record_query(m_realm->read_transaction_version(), m_table_view);
 
@@ -317,6 +337,51 @@ void Results::ensure_up_to_date(EvaluateMode mode)
     }
 }
 
+// Reading the first rows of an unsorted query does not need the full
+// TableView. They are read from a view of the first matches instead, which
+// grows as further rows are read, while the notifier evaluates the full query
+// in the background. Once that has been delivered, or the rows read go beyond
+// max_prefix_limit, the Results switch to the full TableView as usual.
+bool Results::evaluate_prefix(size_t ndx)
+{
+    static constexpr size_t min_prefix_limit = 64;
+    static constexpr size_t max_prefix_limit = 4096;
+
+    if (m_mode != Mode::Query || m_update_policy != UpdatePolicy::Auto || !m_descriptor_ordering.is_empty() ||
+        m_query.has_ordering())
+        return false;
+    if (m_notifier && m_notifier->get_tableview(m_table_view)) {
+        m_mode = Mode::TableView;
+        m_prefix_view = TableView();
+        m_prefix_limit = 0;
+        if (auto audit = m_realm->audit_context())
+            audit->record_query(m_realm->read_transaction_version(), m_table_view);
+        return false;
+    }
+
+    if (m_prefix_limit && m_prefix_view.is_in_sync()) {
+        if (ndx < m_prefix_view.size())
+            return true;
+        // The query has no further matches
+        if (m_prefix_view.size() < m_prefix_limit)
+            return false;
+    }
+
+    size_t limit = std::max({ndx + 1, m_prefix_limit * 4, min_prefix_limit});
+    if (limit > max_prefix_limit)
+        return false;
+    m_query.sync_view_if_needed();
+    m_prefix_view = m_query.find_all(limit);
+    m_prefix_limit = limit;
+    if (auto audit = m_realm->audit_context())
+        audit->record_query(m_realm->read_transaction_version(), m_prefix_view);
+
+    // Have the full result computed in the background
+    if (!m_notifier)
+        prepare_async(ForCallback{false});
+    return ndx < m_prefix_view.size();
+}
+
 size_t Results::actual_index(size_t ndx) const noexcept
 {
     if (auto& indices = m_list_indices) {
@@ -379,6 +444,8 @@ template <>
 util::Optional<Obj> Results::try_get(size_t row_ndx)
 {
     validate_read();
+    if (evaluate_prefix(row_ndx))
+        return m_prefix_view.try_get_object(row_ndx);
     ensure_up_to_date();
     switch (m_mode) {
         case Mode::Empty:
@@ -412,6 +479,8 @@ Mixed Results::get_any(size_t ndx)
 {
     util::CheckedUniqueLock lock(m_mutex);
     validate_read();
+    if (evaluate_prefix(ndx))
+        return Mixed(ObjLink(m_table->get_key(), m_prefix_view.get_key(ndx)));
     ensure_up_to_date();
     switch (m_mode) {
         case Mode::Empty:
@@ -840,32 +909,62 @@ util::Optional<Mixed> Results::aggregate(ColKey column, const char* name, Aggreg
         return none;
 
     auto type = prepare_for_aggregate(column, name);
+
+    // The result of an aggregate can be reused until anything in the Realm
+    // changes. A TableView which is not kept in sync may still be replaced
+    // by the notifier, so its aggregates are not cached.
+    bool cacheable = m_mode != Mode::TableView || m_table_view.is_in_sync();
+    if (cacheable) {
+        uint64_t content_version = m_mode == Mode::Collection
+                                       ? m_collection->get_obj().get_table()->get_content_version()
+                                       : m_table->get_content_version();
+        if (m_aggregate_cache_version != content_version) {
+            m_aggregate_cache.clear();
+            m_aggregate_cache_version = content_version;
+        }
+        for (auto& cached : m_aggregate_cache) {
+            if (cached.column == column && strcmp(cached.name, name) == 0)
+                return cached.value;
+        }
+    }
+
+    util::Optional<Mixed> value;
     switch (m_mode) {
         case Mode::Table:
-            return call_with_helper(func, *m_table, type);
+            value = call_with_helper(func, *m_table, type);
+            break;
         case Mode::Collection:
-            return call_with_helper(func, *m_collection, type);
+            value = call_with_helper(func, *m_collection, type);
+            break;
         default:
-            return call_with_helper(func, m_table_view, type);
+            value = call_with_helper(func, m_table_view, type);
+            break;
     }
+    if (cacheable)
+        m_aggregate_cache.push_back({column, name, value});
+    return value;
 }
 
 util::Optional<Mixed> Results::max(ColKey column)
 {
-    ReturnIndexHelper return_ndx;
-    auto results = aggregate(column, "max", [&](auto&& helper) {
-        return helper.max(column, return_ndx);
+    return aggregate(column, "max", [&](auto&& helper) -> util::Optional<Mixed> {
+        ReturnIndexHelper return_ndx;
+        auto results = helper.max(column, return_ndx);
+        if (!return_ndx)
+            return none;
+        return results;
     });
-    return return_ndx ? results : none;
 }
 
 util::Optional<Mixed> Results::min(ColKey column)
 {
-    ReturnIndexHelper return_ndx;
-    auto results = aggregate(column, "min", [&](auto&& helper) {
-        return helper.min(column, return_ndx);
+    return aggregate(column, "min", [&](auto&& helper) -> util::Optional<Mixed> {
+        ReturnIndexHelper return_ndx;
+        auto results = helper.min(column, return_ndx);
+        if (!return_ndx)
+            return none;
+        return results;
     });
-    return return_ndx ? results : none;
 }
 
 util::Optional<Mixed> Results::sum(ColKey column)
@@ -877,11 +976,13 @@ util::Optional<Mixed> Results::sum(ColKey column)
 
 util::Optional<Mixed> Results::average(ColKey column)
 {
-    size_t value_count = 0;
-    auto results = aggregate(column, "avg", [&](auto&& helper) {
-        return helper.avg(column, &value_count);
+    return aggregate(column, "avg", [&](auto&& helper) -> util::Optional<Mixed> {
+        size_t value_count = 0;
+        auto results = helper.avg(column, &value_count);
+        if (value_count == 0)
+            return none;
+        return results;
     });
-    return value_count == 0 ? none : results;
 }
 
 void Results::clear()
@@ -950,6 +1051,16 @@ Query Results::get_query() const
     return do_get_query();
 }
 
+QueryExplanation Results::explain() const
+{
+    return get_query().explain();
+}
+
+QueryExplanation Results::explain_analyze() const
+{
+    return get_query().explain_analyze();
+}
+
 const DescriptorOrdering& Results::get_ordering() const REQUIRES(!m_mutex)
 {
     return m_descriptor_ordering;
@@ -1013,6 +1124,14 @@ Query Results::do_get_query() const
     REALM_COMPILER_HINT_UNREACHABLE();
 }
 
+util::Optional<TableView> Results::get_evaluated_tableview() const
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    if (m_mode != Mode::TableView || m_update_policy != UpdatePolicy::Auto || !m_table_view.is_in_sync())
+        return util::none;
+    return m_table_view;
+}
+
 TableView Results::get_tableview()
 {
     util::CheckedUniqueLock lock(m_mutex);
@@ -1329,6 +1448,40 @@ Results Results::import_copy_into_realm(std::shared_ptr<Realm> const& realm)
     }
 }
 
+auto Results::evaluate_async(AsyncEvaluationCallback callback) -> AsyncEvaluation
+{
+    REALM_ASSERT(callback);
+    validate_read();
+    auto scheduler = m_realm->scheduler();
+    if (!scheduler->can_invoke())
+        throw InvalidTransactionException(
+            "Cannot evaluate Results asynchronously. Make sure you are running from inside a run loop.");
+
+    AsyncEvaluation handle;
+    auto frozen = freeze(m_realm->freeze());
+    util::ThreadPool::get_default().submit([frozen = std::move(frozen), callback = std::move(callback),
+                                            scheduler = std::move(scheduler),
+                                            cancelled = handle.m_cancelled]() mutable {
+        std::exception_ptr error;
+        if (!*cancelled) {
+            try {
+                frozen.evaluate_query_if_needed(false);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+        }
+        // The callback is always moved back to the scheduler, as the userdata
+        // captured by a binding may only be released on the Realm's thread
+        scheduler->invoke([frozen = std::move(frozen), callback = std::move(callback), cancelled = std::move(cancelled),
+                           error]() mutable {
+            if (!*cancelled)
+                callback(std::move(frozen), error);
+        });
+    });
+    return handle;
+}
+
 Results Results::freeze(std::shared_ptr<Realm> const& frozen_realm)
 {
     return import_copy_into_realm(frozen_realm);
@@ -78,6 +78,11 @@ public:
     // Returned query will not be valid if the current mode is Empty
     Query get_query() const REQUIRES(!m_mutex);
 
+    // Describe how the query of this Results is evaluated, see Query::explain() and Query::explain_analyze().
+    // The sort and distinct operations are not included.
+    QueryExplanation explain() const REQUIRES(!m_mutex);
+    QueryExplanation explain_analyze() const REQUIRES(!m_mutex);
+
     // Get ordering for thr query associated with the result
     const DescriptorOrdering& get_ordering() const;
 
@@ -95,6 +100,9 @@ public:
 
     // Get a tableview containing the same rows as this Results
     TableView get_tableview() REQUIRES(!m_mutex);
+    // Get the tableview produced by the last evaluation of the query if it is
+    // still up to date, without evaluating anything
+    util::Optional<TableView> get_evaluated_tableview() const REQUIRES(!m_mutex);
 
     // Get the object type which will be returned by get()
     StringData get_object_type() const noexcept;
@@ -104,6 +112,9 @@ public:
     // Get the size of this results
     // Can be either O(1) or O(N) depending on the state of things
     size_t size() REQUIRES(!m_mutex);
+    // Estimate the size from a sample of about `fraction` of the table, see Query::count_approximate(). Results
+    // which are not a query on a table without distinct or limit give their exact size.
+    Query::Estimate count_approximate(double fraction = 0.01) REQUIRES(!m_mutex);
 
     // Get the row accessor for the given index
     // Throws OutOfBoundsIndexException if index >= size()
@@ -303,6 +314,39 @@ public:
     NotificationToken add_notification_callback(CollectionChangeCallback callback,
                                                 KeyPathArray key_path_array = {}) &;
 
+    // A handle for an evaluation started by evaluate_async(). Destroying it does
+    // not cancel the evaluation.
+    class AsyncEvaluation {
+    public:
+        // Skips the evaluation if it has not started yet. When called on the
+        // Realm's thread, the callback is not called afterwards.
+        void cancel() noexcept
+        {
+            *m_cancelled = true;
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_cancelled = std::make_shared<std::atomic<bool>>(false);
+        friend class Results;
+    };
+    using AsyncEvaluationCallback = util::UniqueFunction<void(Results, std::exception_ptr)>;
+
+    /**
+     * Evaluate the query once on the shared thread pool, without blocking this thread and
+     * without registering a notifier.
+     *
+     * The query runs against a frozen copy of the Realm's current version. The evaluated frozen
+     * Results, or the error the evaluation failed with, are passed to the callback on the
+     * Realm's scheduler. Inside a write transaction the version the transaction started from
+     * is used.
+     *
+     * @param callback The function to call with the evaluated Results. It is destroyed on the
+     * Realm's scheduler even if the evaluation is cancelled.
+     *
+     * @return A handle which can be used to cancel the evaluation.
+     */
+    AsyncEvaluation evaluate_async(AsyncEvaluationCallback callback) REQUIRES(!m_mutex);
+
     // Returns whether the rows are guaranteed to be in table order.
     bool is_in_table_order() const;
 
@@ -370,6 +414,9 @@ private:
     Query m_query GUARDED_BY(m_mutex);
     ConstTableRef m_table;
     TableView m_table_view GUARDED_BY(m_mutex);
+    // The first matches of an unsorted query, see evaluate_prefix()
+    TableView m_prefix_view GUARDED_BY(m_mutex);
+    size_t m_prefix_limit GUARDED_BY(m_mutex) = 0;
     DescriptorOrdering m_descriptor_ordering;
     std::shared_ptr<CollectionBase> m_collection;
     util::Optional<std::vector<size_t>> m_list_indices GUARDED_BY(m_mutex);
@@ -381,6 +428,15 @@ private:
     UpdatePolicy m_update_policy = UpdatePolicy::Auto;
     uint64_t m_last_collection_content_version GUARDED_BY(m_mutex) = 0;
 
+    // Results of the aggregates computed at m_aggregate_cache_version, see aggregate()
+    struct CachedAggregate {
+        ColKey column;
+        const char* name;
+        util::Optional<Mixed> value;
+    };
+    std::vector<CachedAggregate> m_aggregate_cache GUARDED_BY(m_mutex);
+    uint64_t m_aggregate_cache_version GUARDED_BY(m_mutex) = 0;
+
     void validate_read() const;
     void validate_write() const;
 
@@ -409,6 +465,9 @@ private:
     /// for `ensure_up_to_date` to run.
     bool has_changed() REQUIRES(!m_mutex);
     void ensure_up_to_date(EvaluateMode mode = EvaluateMode::Normal) REQUIRES(m_mutex);
+    /// Returns true if row `ndx` can be read from `m_prefix_view` without
+    /// evaluating the full query.
+    bool evaluate_prefix(size_t ndx) REQUIRES(m_mutex);
 
     // Shared logic between freezing and thawing Results as the Core API is the same.
     Results import_copy_into_realm(std::shared_ptr<Realm> const& realm) REQUIRES(!m_mutex);
@@ -48,11 +48,12 @@ static SectionedResults::SectionKeyFunc builtin_comparison(Results& results, Res
 struct SectionedResultsNotificationHandler {
 public:
     SectionedResultsNotificationHandler(SectionedResults& sectioned_results, SectionedResultsNotificatonCallback cb,
-                                        util::Optional<Mixed> section_filter = util::none)
+                                        bool has_key_path_filter, util::Optional<Mixed> section_filter = util::none)
         : m_cb(std::move(cb))
         , m_sectioned_results(sectioned_results)
         , m_prev_row_to_index_path(m_sectioned_results.m_row_to_index_path)
         , m_section_filter(section_filter)
+        , m_has_key_path_filter(has_key_path_filter)
     {
     }
 
@@ -70,7 +71,13 @@ public:
 
         util::CheckedUniqueLock lock(m_sectioned_results.m_mutex);
 
-        m_sectioned_results.calculate_sections_if_required();
+        // The changes are relative to the sections seen by the previous call,
+        // so they can be used to update the sections if nothing else has
+        // recalculated them since. A key path filter may hide modifications
+        // of properties the section keys depend on.
+        bool can_update = m_prev_sections_version == m_sectioned_results.m_sections_version &&
+                          !m_has_key_path_filter;
+        m_sectioned_results.calculate_sections_if_required(can_update ? &c : nullptr);
 
         auto converted_insertions = convert_indices(c.insertions, m_sectioned_results.m_row_to_index_path);
         auto converted_modifications = convert_indices(c.modifications, m_prev_row_to_index_path);
@@ -181,6 +188,7 @@ public:
 
         REALM_ASSERT(m_sectioned_results.m_results.is_valid());
         m_prev_row_to_index_path = m_sectioned_results.m_row_to_index_path;
+        m_prev_sections_version = m_sectioned_results.m_sections_version;
     }
 
     std::pair<IndexSet, IndexSet> calculate_sections_to_insert_and_delete() REQUIRES(m_sectioned_results.m_mutex)
@@ -211,6 +219,10 @@ private:
     // change indices refering to the supplied section key.
     util::Optional<Mixed> m_section_filter;
     bool m_section_filter_should_deliver_initial_notification = true;
+    bool m_has_key_path_filter;
+    // The version of the sections seen by the previous call, none before the
+    // initial notification
+    util::Optional<uint64_t> m_prev_sections_version;
 };
 
 template <typename StringType>
@@ -324,7 +336,7 @@ SectionedResults::SectionedResults(Results results, Results::SectionedResultsOpe
 {
 }
 
-void SectionedResults::calculate_sections_if_required()
+void SectionedResults::calculate_sections_if_required(const CollectionChangeSet* changes)
 {
     if (m_results.m_update_policy == Results::UpdatePolicy::Never)
         return;
@@ -335,7 +347,7 @@ void SectionedResults::calculate_sections_if_required()
         m_results.ensure_up_to_date();
     }
 
-    calculate_sections();
+    calculate_sections(has_performed_initial_evalutation ? changes : nullptr);
     if (!has_performed_initial_evalutation)
         has_performed_initial_evalutation = true;
 }
@@ -351,11 +363,37 @@ void create_buffered_key(Mixed& key, std::list<std::string>& buffer, StringType
     }
 }
 
+namespace {
+// Tells which indices are in an IndexSet, when asked in increasing order
+class IndexCursor {
+public:
+    IndexCursor(const IndexSet& indexes)
+        : m_it(indexes.as_indexes().begin())
+        , m_end(indexes.as_indexes().end())
+    {
+    }
+
+    bool contains(size_t index)
+    {
+        while (m_it != m_end && *m_it < index)
+            ++m_it;
+        return m_it != m_end && *m_it == index;
+    }
+
+private:
+    IndexSet::IndexIterator m_it;
+    IndexSet::IndexIterator m_end;
+};
+} // anonymous namespace
+
 // This method will run in the following scenarios:
 // - SectionedResults is performing its initial evaluation.
 // - The underlying Table in the Results collection has changed
-void SectionedResults::calculate_sections()
+void SectionedResults::calculate_sections(const CollectionChangeSet* changes)
 {
+    ++m_sections_version;
+    auto prev_row_to_index_path = std::move(m_row_to_index_path);
+
     m_previous_str_buffers.clear();
     m_previous_str_buffers.swap(m_current_str_buffers);
     m_previous_key_to_index_lookup.clear();
@@ -371,12 +409,38 @@ void SectionedResults::calculate_sections()
     size_t size = m_results.size();
     m_row_to_index_path.resize(size);
 
+    // Rows which are not deleted keep their order, so the rows neither
+    // inserted nor modified can take their key from the row they were.
+    // The keys of the previous sections stay valid until the end of this
+    // method, as they are held by m_previous_str_buffers.
+    bool reuse_keys = changes && !changes->collection_was_cleared && !changes->collection_root_was_deleted &&
+                      prev_row_to_index_path.size() + changes->insertions.count() ==
+                          size + changes->deletions.count();
+    const IndexSet no_changes;
+    IndexCursor deleted(reuse_keys ? changes->deletions : no_changes);
+    IndexCursor inserted(reuse_keys ? changes->insertions : no_changes);
+    IndexCursor modified(reuse_keys ? changes->modifications_new : no_changes);
+    size_t prev_row = 0;
+
     for (size_t i = 0; i < size; ++i) {
-        Mixed key = m_callback(m_results.get_any(i), m_results.get_realm());
-        // Disallow links as section keys. It would be uncommon to use them to begin with
-        // and if the object acting as the key was deleted bad things would happen.
-        if (key.is_type(type_Link, type_TypedLink)) {
-            throw std::logic_error("Links are not supported as section keys.");
+        Mixed key;
+        bool has_key = false;
+        if (reuse_keys && !inserted.contains(i)) {
+            while (deleted.contains(prev_row))
+                ++prev_row;
+            if (!modified.contains(i) && prev_row < prev_row_to_index_path.size()) {
+                key = m_prev_section_index_to_key[prev_row_to_index_path[prev_row].first];
+                has_key = true;
+            }
+            ++prev_row;
+        }
+        if (!has_key) {
+            key = m_callback(m_results.get_any(i), m_results.get_realm());
+            // Disallow links as section keys. It would be uncommon to use them to begin with
+            // and if the object acting as the key was deleted bad things would happen.
+            if (key.is_type(type_Link, type_TypedLink)) {
+                throw std::logic_error("Links are not supported as section keys.");
+            }
         }
 
         auto it = m_sections.find(key);
@@ -440,15 +504,19 @@ ResultsSection SectionedResults::operator[](Mixed key)
 NotificationToken SectionedResults::add_notification_callback(SectionedResultsNotificatonCallback callback,
                                                               KeyPathArray key_path_array) &
 {
-    return m_results.add_notification_callback(SectionedResultsNotificationHandler(*this, std::move(callback)),
-                                               std::move(key_path_array));
+    bool has_key_path_filter = !key_path_array.empty();
+    return m_results.add_notification_callback(
+        SectionedResultsNotificationHandler(*this, std::move(callback), has_key_path_filter),
+        std::move(key_path_array));
 }
 
 NotificationToken SectionedResults::add_notification_callback_for_section(
     Mixed section_key, SectionedResultsNotificatonCallback callback, KeyPathArray key_path_array)
 {
+    bool has_key_path_filter = !key_path_array.empty();
     return m_results.add_notification_callback(
-        SectionedResultsNotificationHandler(*this, std::move(callback), section_key), std::move(key_path_array));
+        SectionedResultsNotificationHandler(*this, std::move(callback), has_key_path_filter, section_key),
+        std::move(key_path_array));
 }
 
 SectionedResults SectionedResults::copy(Results&& results)
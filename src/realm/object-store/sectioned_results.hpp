@@ -183,9 +183,14 @@ private:
     friend struct SectionedResultsNotificationHandler;
     util::CheckedOptionalMutex m_mutex;
     SectionedResults copy(Results&&) REQUIRES(!m_mutex);
-    void calculate_sections_if_required() REQUIRES(m_mutex);
-    void calculate_sections() REQUIRES(m_mutex);
+    // If `changes` is given it must describe the changes since the sections
+    // were last calculated. The keys of rows which were neither inserted nor
+    // modified are then reused rather than recalculated.
+    void calculate_sections_if_required(const CollectionChangeSet* changes = nullptr) REQUIRES(m_mutex);
+    void calculate_sections(const CollectionChangeSet* changes) REQUIRES(m_mutex);
     bool has_performed_initial_evalutation = false;
+    // Incremented each time the sections are calculated
+    uint64_t m_sections_version GUARDED_BY(m_mutex) = 0;
     NotificationToken add_notification_callback_for_section(Mixed section_key,
                                                             SectionedResultsNotificatonCallback callback,
                                                             KeyPathArray key_path_array = {});
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <realm/object-store/sharded_realm.hpp>
+
+#include <realm/object-store/keypath_helpers.hpp>
+#include <realm/object-store/object_store.hpp>
+
+#include <realm/util/thread_pool.hpp>
+
+using namespace realm;
+
+namespace {
+
+// Mixed::hash() differs between 32 and 64 bit platforms, and the placement of
+// objects must not, so the primary keys are hashed here
+uint64_t fnv1a(const char* data, size_t size) noexcept
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= uint8_t(data[i]);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+uint64_t stable_hash(Mixed pk)
+{
+    if (pk.is_null())
+        return 0;
+    switch (pk.get_type()) {
+        case type_Int: {
+            // The finalizer of splitmix64, so that consecutive keys are spread
+            uint64_t x = uint64_t(pk.get_int());
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+            return x ^ (x >> 31);
+        }
+        case type_String: {
+            auto str = pk.get_string();
+            return fnv1a(str.data(), str.size());
+        }
+        case type_ObjectId: {
+            auto bytes = pk.get_object_id().to_bytes();
+            return fnv1a(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+        case type_UUID: {
+            auto bytes = pk.get<UUID>().to_bytes();
+            return fnv1a(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+        default:
+            throw LogicError(LogicError::illegal_type);
+    }
+}
+
+} // anonymous namespace
+
+ShardedRealm::ShardedRealm(std::vector<SharedRealm> shards)
+    : m_shards(std::move(shards))
+{
+    if (m_shards.empty())
+        throw LogicError(LogicError::illegal_combination);
+}
+
+size_t ShardedRealm::get_shard_for(Mixed pk) const
+{
+    return size_t(stable_hash(pk) % m_shards.size());
+}
+
+void ShardedRealm::run_query(StringData object_type, const std::string& query_string,
+                             const std::vector<Mixed>& arguments,
+                             util::FunctionRef<void(size_t, const SharedRealm&, Query&&)> func) const
+{
+    size_t num_shards = m_shards.size();
+    // Live Realms may only be used on their own thread, so the snapshots which
+    // the pool threads query are taken here
+    std::vector<SharedRealm> frozen;
+    frozen.reserve(num_shards);
+    for (auto& shard : m_shards) {
+        shard->read_group();               // Throws
+        frozen.push_back(shard->freeze()); // Throws
+    }
+
+    util::ThreadPool::get_default().run_parallel(num_shards, [&](size_t ndx) {
+        auto& realm = frozen[ndx];
+        auto table = ObjectStore::table_for_object_type(realm->read_group(), object_type);
+        if (!table)
+            return;
+        query_parser::KeyPathMapping mapping;
+        populate_keypath_mapping(mapping, *realm);
+        func(ndx, realm, table->query(query_string, arguments, mapping)); // Throws
+    });
+}
+
+ShardedRealm::Results ShardedRealm::find_all(StringData object_type, const std::string& query_string,
+                                             const std::vector<Mixed>& arguments) const
+{
+    Results results;
+    results.m_results.resize(m_shards.size());
+    run_query(object_type, query_string, arguments, [&](size_t ndx, const SharedRealm& realm, Query&& query) {
+        results.m_results[ndx] = realm::Results(realm, query.find_all()); // Throws
+    });
+    return results;
+}
+
+size_t ShardedRealm::count(StringData object_type, const std::string& query_string,
+                           const std::vector<Mixed>& arguments) const
+{
+    std::vector<size_t> counts(m_shards.size());
+    run_query(object_type, query_string, arguments, [&](size_t ndx, const SharedRealm&, Query&& query) {
+        counts[ndx] = query.count(); // Throws
+    });
+    size_t total = 0;
+    for (auto c : counts)
+        total += c;
+    return total;
+}
+
+size_t ShardedRealm::Results::size()
+{
+    size_t total = 0;
+    for (auto& results : m_results)
+        total += results.size();
+    return total;
+}
+
+std::pair<size_t, size_t> ShardedRealm::Results::find(size_t ndx)
+{
+    for (size_t shard_ndx = 0; shard_ndx < m_results.size(); ++shard_ndx) {
+        size_t sz = m_results[shard_ndx].size();
+        if (ndx < sz)
+            return {shard_ndx, ndx};
+        ndx -= sz;
+    }
+    throw std::out_of_range("Index out of range");
+}
+
+Obj ShardedRealm::Results::get(size_t ndx)
+{
+    auto [shard_ndx, ndx_in_shard] = find(ndx);
+    return m_results[shard_ndx].get<Obj>(ndx_in_shard);
+}
+
+size_t ShardedRealm::Results::get_shard_ndx(size_t ndx)
+{
+    return find(ndx).first;
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_OS_SHARDED_REALM_HPP
+#define REALM_OS_SHARDED_REALM_HPP
+
+#include <realm/object-store/results.hpp>
+#include <realm/object-store/shared_realm.hpp>
+
+#include <realm/util/function_ref.hpp>
+
+#include <string>
+#include <vector>
+
+namespace realm {
+
+// A logical Realm whose objects are partitioned by primary key over several
+// files, the shards. Every shard is an ordinary Realm with the same schema, so
+// each file only holds its part of the data, and writes to different shards do
+// not share a write lock. A write which touches several shards is one
+// transaction per shard, and is not atomic across them.
+class ShardedRealm {
+public:
+    // The order of the shards determines where objects are placed, so it must
+    // be the same every time the files are opened. The shards must be live
+    // Realms confined to the thread using the ShardedRealm.
+    explicit ShardedRealm(std::vector<SharedRealm> shards);
+
+    size_t get_shard_count() const noexcept
+    {
+        return m_shards.size();
+    }
+    const SharedRealm& get_shard(size_t ndx) const
+    {
+        return m_shards.at(ndx);
+    }
+
+    // The shard which holds the object with primary key `pk`. The placement is
+    // the same on all platforms and in all versions.
+    size_t get_shard_for(Mixed pk) const;
+    const SharedRealm& get_shard_realm_for(Mixed pk) const
+    {
+        return m_shards[get_shard_for(pk)];
+    }
+
+    // The objects of a query run on every shard. The objects of each shard are
+    // kept together, in the order of the shards, so a sort or limit in the
+    // query applies per shard.
+    class Results {
+    public:
+        size_t size();
+        Obj get(size_t ndx);
+        // The shard holding the object at `ndx`
+        size_t get_shard_ndx(size_t ndx);
+
+        // The results of one shard, which belong to a frozen Realm and so can
+        // be read from any thread
+        realm::Results& get_results(size_t shard_ndx)
+        {
+            return m_results.at(shard_ndx);
+        }
+
+    private:
+        friend class ShardedRealm;
+        std::vector<realm::Results> m_results;
+
+        std::pair<size_t, size_t> find(size_t ndx);
+    };
+
+    // Runs the query on the version each shard is reading, or the latest one
+    // if it isn't in a read transaction. The shards are frozen on the calling
+    // thread and then queried in parallel on the default thread pool. Shards
+    // without the object type contribute no objects.
+    Results find_all(StringData object_type, const std::string& query_string,
+                     const std::vector<Mixed>& arguments = {}) const;
+    size_t count(StringData object_type, const std::string& query_string,
+                 const std::vector<Mixed>& arguments = {}) const;
+
+private:
+    std::vector<SharedRealm> m_shards;
+
+    // Calls `func` on a pool thread with the parsed query of every shard which
+    // has the object type
+    void run_query(StringData object_type, const std::string& query_string, const std::vector<Mixed>& arguments,
+                   util::FunctionRef<void(size_t, const SharedRealm&, Query&&)> func) const;
+};
+
+} // namespace realm
+
+#endif // REALM_OS_SHARDED_REALM_HPP
@@ -35,6 +35,7 @@
 #include <realm/object-store/util/scheduler.hpp>
 
 #include <realm/db.hpp>
+#include <realm/parser/query_cache.hpp>
 #include <realm/util/fifo_helper.hpp>
 #include <realm/util/file.hpp>
 #include <realm/util/scope_exit.hpp>
@@ -72,6 +73,53 @@ public:
 private:
     size_t& m_count;
 };
+
+void append_to_fingerprint(std::string& buffer, Schema const& schema)
+{
+    auto append_string = [&](std::string const& str) {
+        buffer += str;
+        buffer += '\0';
+    };
+    auto append_int = [&](uint64_t value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto append_properties = [&](std::vector<Property> const& properties) {
+        append_int(properties.size());
+        for (auto& property : properties) {
+            append_string(property.name);
+            append_string(property.public_name);
+            append_string(property.object_type);
+            append_string(property.link_origin_property_name);
+            append_int(uint64_t(property.type));
+            append_int(bool(property.is_primary) | (bool(property.is_indexed) << 1));
+        }
+    };
+
+    append_int(schema.size());
+    for (auto& object_schema : schema) {
+        append_string(object_schema.name);
+        append_string(object_schema.primary_key);
+        append_string(object_schema.alias);
+        append_int(uint64_t(object_schema.table_type));
+        append_properties(object_schema.persisted_properties);
+        append_properties(object_schema.computed_properties);
+    }
+}
+
+// Identifies the result of validating `target` and comparing it with the
+// schema in the file. The keys are left out, as neither depends on them.
+uint64_t schema_fingerprint(Schema const& actual, Schema const& target, uint64_t version, SchemaMode mode,
+                            uint64_t validation_mode)
+{
+    std::string buffer;
+    append_to_fingerprint(buffer, actual);
+    append_to_fingerprint(buffer, target);
+    for (uint64_t value : {version, uint64_t(mode), validation_mode})
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    uint64_t fingerprint = cityhash_64(reinterpret_cast<const unsigned char*>(buffer.data()), buffer.size());
+    // 0 means that there is no fingerprint
+    return fingerprint ? fingerprint : 1;
+}
 } // namespace
 
 Realm::Realm(Config config, util::Optional<VersionID> version, std::shared_ptr<_impl::RealmCoordinator> coordinator,
@@ -79,6 +127,7 @@ Realm::Realm(Config config, util::Optional<VersionID> version, std::shared_ptr<_
     : m_config(std::move(config))
     , m_frozen_version(std::move(version))
     , m_scheduler(m_config.scheduler)
+    , m_query_cache(std::make_unique<query_parser::QueryCache>())
 {
     if (!coordinator->get_cached_schema(m_schema, m_schema_version, m_schema_transaction_version)) {
         m_transaction = coordinator->begin_read();
@@ -393,10 +442,28 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
         validation_mode |= SchemaValidationMode::RejectEmbeddedOrphans;
     }
 
-    schema.validate(validation_mode);
-
     bool was_in_read_transaction = is_in_read_transaction();
     Schema actual_schema = get_full_schema();
+
+    // If this schema was applied to the file before, and neither has changed
+    // since, it is known to be valid and to require no changes
+    uint64_t fingerprint =
+        schema_fingerprint(actual_schema, schema, version, m_config.schema_mode, validation_mode);
+    if (version == m_schema_version && fingerprint == ObjectStore::get_schema_fingerprint(read_group())) {
+        if (!was_in_read_transaction)
+            m_transaction = nullptr;
+        set_schema(actual_schema, std::move(schema));
+        return;
+    }
+
+    try {
+        schema.validate(validation_mode);
+    }
+    catch (...) {
+        if (!was_in_read_transaction)
+            m_transaction = nullptr;
+        throw;
+    }
     std::vector<SchemaChange> required_changes = actual_schema.compare(schema, m_config.schema_mode);
 
     if (!schema_change_needs_write_transaction(schema, required_changes, version)) {
@@ -461,11 +528,12 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
 
         ObjectStore::apply_schema_changes(transaction(), version, m_schema, m_schema_version, m_config.schema_mode,
                                           required_changes, m_config.automatic_handle_backlicks_in_migrations,
-                                          wrapper);
+                                          wrapper, m_config.migration_progress_function);
     }
     else {
         ObjectStore::apply_schema_changes(transaction(), m_schema_version, schema, version, m_config.schema_mode,
-                                          required_changes, m_config.automatic_handle_backlicks_in_migrations);
+                                          required_changes, m_config.automatic_handle_backlicks_in_migrations,
+                                          nullptr, m_config.migration_progress_function);
         REALM_ASSERT_DEBUG(additive ||
                            (required_changes = ObjectStore::schema_from_group(read_group()).compare(schema)).empty());
     }
@@ -486,6 +554,12 @@ void Realm::update_schema(Schema schema, uint64_t version, MigrationFunction mig
     m_new_schema = ObjectStore::schema_from_group(read_group());
     m_schema_version = ObjectStore::get_schema_version(read_group());
     m_dynamic_schema = false;
+
+    // Let the next open with the same schema skip validating and diffing it
+    if (m_schema_version == version && m_new_schema->compare(m_schema, m_config.schema_mode).empty()) {
+        ObjectStore::set_schema_fingerprint(read_group(), schema_fingerprint(*m_new_schema, m_schema, version,
+                                                                             m_config.schema_mode, validation_mode));
+    }
     m_coordinator->clear_schema_cache_and_set_schema_version(version);
 
     if (!in_transaction) {
@@ -503,7 +577,8 @@ void Realm::rename_property(Schema schema, StringData object_type, StringData ol
 
 void Realm::add_schema_change_handler()
 {
-    if (m_config.immutable())
+    // A frozen transaction never changes, and may be shared with other frozen Realms
+    if (m_config.immutable() || m_frozen_version)
         return;
     m_transaction->set_schema_change_notification_handler([&] {
         m_new_schema = ObjectStore::schema_from_group(read_group());
@@ -691,10 +766,15 @@ void Realm::call_completion_callbacks()
         return;
     }
 
-    CountGuard sending_completions(m_is_running_async_commit_completions);
     auto error = m_transaction->get_commit_exception();
     auto completions = std::move(m_async_commit_q);
     m_async_commit_q.clear();
+    call_completion_callbacks(completions, error);
+}
+
+void Realm::call_completion_callbacks(std::vector<AsyncCommitDesc>& completions, std::exception_ptr error)
+{
+    CountGuard sending_completions(m_is_running_async_commit_completions);
     for (auto& cb : completions) {
         if (!cb.when_completed)
             continue;
@@ -746,6 +826,22 @@ void Realm::end_current_write(bool check_pending)
     }
 }
 
+void Realm::sync_commits_in_background()
+{
+    // The write mutex is kept, so the following writes can be committed while the
+    // ones made so far are synchronized to disk
+    auto completions = std::move(m_async_commit_q);
+    m_async_commit_q.clear();
+    m_transaction->async_sync_commits([self = shared_from_this(), this, completions = std::move(completions)](
+                                          std::exception_ptr error) mutable {
+        m_scheduler->invoke([self = std::move(self), this, completions = std::move(completions),
+                              error = std::move(error)]() mutable {
+            call_completion_callbacks(completions, error);
+            self.reset();
+        });
+    });
+}
+
 void Realm::run_writes()
 {
     if (!m_transaction) {
@@ -759,7 +855,9 @@ void Realm::run_writes()
     }
 
     CountGuard running_writes(m_is_running_async_writes);
-    int run_limit = 20; // max number of commits without full sync to disk
+    constexpr int max_commits_per_sync = 20;
+    int run_limit = max_commits_per_sync; // max number of commits without full sync to disk
+    bool synced_in_background = false;
     // this is tricky
     //  - each pending call may itself add other async writes
     //  - the 'run' will terminate as soon as a commit without grouping is requested
@@ -812,8 +910,16 @@ void Realm::run_writes()
         if (new_version > prev_version) {
             // A commit was done during callback
             --run_limit;
-            if (run_limit <= 0)
-                break;
+            if (run_limit <= 0) {
+                // Once per run, overlap the sync of the commits made so far with the
+                // next batch of writes instead of giving up the write mutex
+                if (synced_in_background || m_async_write_q.empty() || m_async_commit_barrier_requested ||
+                    !m_transaction->has_unsynced_commits())
+                    break;
+                sync_commits_in_background();
+                synced_in_background = true;
+                run_limit = max_commits_per_sync;
+            }
         }
         else {
             if (m_transaction->get_transact_stage() == DB::transact_Writing) {
@@ -1078,6 +1184,19 @@ bool Realm::compact()
     return m_coordinator->compact();
 }
 
+size_t Realm::release_memory(DB::MemoryPressure level)
+{
+    verify_thread();
+    verify_open();
+
+    m_query_cache->clear();
+    size_t freed = 0;
+    if (m_transaction)
+        freed += m_transaction->release_memory();
+    freed += m_coordinator->release_memory(level);
+    return freed;
+}
+
 void Realm::convert(const Config& config, bool merge_into_existing)
 {
     verify_thread();
@@ -57,6 +57,10 @@ namespace util {
 class Scheduler;
 }
 
+namespace query_parser {
+class QueryCache;
+}
+
 namespace _impl {
 class AnyHandover;
 class CollectionNotifier;
@@ -79,6 +83,14 @@ using MigrationFunction = std::function<void(SharedRealm old_realm, SharedRealm
 // schema creation in a single transaction.
 using DataInitializationFunction = std::function<void(SharedRealm realm)>;
 
+// A callback function called on the thread applying a schema change after
+// each step of it, with the number of steps applied so far and the total
+// number of steps. A migration applies the changes both before and after the
+// migration function, and the total is updated once the migration function
+// has run, as it may have changed the schema itself. All of the steps are
+// applied in the same write transaction.
+using MigrationProgressFunction = std::function<void(size_t applied, size_t total)>;
+
 // A callback function called when opening a SharedRealm when no cached
 // version of this Realm exists. It is passed the total bytes allocated for
 // the file (file size) and the total bytes used by data in the file.
@@ -115,6 +127,8 @@ struct RealmConfig {
 
     DataInitializationFunction initialization_function;
 
+    MigrationProgressFunction migration_progress_function;
+
     // A callback function called when opening a SharedRealm when no cached
     // version of this Realm exists. It is passed the total bytes allocated for
     // the file (file size) and the total bytes used by data in the file.
@@ -155,6 +169,13 @@ struct RealmConfig {
     // speeds up tests that don't need notifications.
     bool automatic_change_notifications = true;
 
+    // The number of async notifiers of this file which may run at once.
+    // Notifiers are spread over this many read transactions on the notifier
+    // worker and run in parallel on the default thread pool once the change
+    // information for a commit has been gathered. Only the value from the
+    // first Realm opened for a file is used.
+    size_t notifier_thread_count = 1;
+
     // The Scheduler which this Realm should be bound to. If not supplied,
     // a default one for the current thread will be used.
     std::shared_ptr<util::Scheduler> scheduler;
@@ -351,6 +372,13 @@ public:
     // because it's not crash safe! It may corrupt your database if something fails
     bool compact();
 
+    // Release memory which can be recreated on demand, as a response to memory
+    // pressure reported by the OS: the parsed queries of query_cache(), the
+    // caches of the tables of the current read transaction, and the memory
+    // released by DB::release_memory(). Returns an estimate of the number of
+    // bytes released, which does not include the query cache.
+    size_t release_memory(DB::MemoryPressure level);
+
     /**
      * Copy this Realm's data into another Realm file.
      *
@@ -397,6 +425,14 @@ public:
         return m_scheduler;
     }
 
+    // The parsed query strings of the queries created through this Realm, e.g.
+    // with realm_query_parse(), so that each distinct query string is only
+    // parsed once.
+    query_parser::QueryCache& query_cache() const noexcept
+    {
+        return *m_query_cache;
+    }
+
     // Close this Realm. Continuing to use a Realm after closing it will throw ClosedRealmException
     // Closing a Realm will wait for any asynchronous writes which have been commited but not synced
     // to sync. Asynchronous writes which have not yet started are canceled.
@@ -532,6 +568,8 @@ private:
     bool m_async_commit_barrier_requested = false;
     util::UniqueFunction<void(AsyncHandle, std::exception_ptr)> m_async_exception_handler;
 
+    std::unique_ptr<query_parser::QueryCache> m_query_cache;
+
     void begin_read(VersionID);
     bool do_refresh();
     void do_begin_transaction();
@@ -559,6 +597,8 @@ private:
     void check_pending_write_requests();
     void end_current_write(bool check_pending = true);
     void call_completion_callbacks();
+    void call_completion_callbacks(std::vector<AsyncCommitDesc>& completions, std::exception_ptr error);
+    void sync_commits_in_background();
     void run_writes();
     void run_async_completions();
 
@@ -872,6 +872,17 @@ void App::refresh_access_token(const std::shared_ptr<SyncUser>& sync_user,
         return;
     }
 
+    // A burst of requests failing with an expired access token would otherwise
+    // each refresh the token on its own, so piggyback on a refresh that is
+    // already in flight for this user.
+    {
+        std::lock_guard<std::mutex> lock(*m_pending_requests_mutex);
+        auto& waiting = m_pending_token_refreshes[sync_user.get()];
+        waiting.push_back(std::move(completion));
+        if (waiting.size() > 1)
+            return;
+    }
+
     std::string route;
     {
         std::lock_guard<std::mutex> lock(*m_route_mutex);
@@ -880,20 +891,28 @@ void App::refresh_access_token(const std::shared_ptr<SyncUser>& sync_user,
 
     do_request(Request{HttpMethod::post, std::move(route), m_request_timeout_ms,
                        get_request_headers(sync_user, RequestTokenType::RefreshToken)},
-               [completion = std::move(completion), sync_user](const Response& response) {
-                   if (auto error = AppUtils::check_for_errors(response)) {
-                       return completion(std::move(error));
+               [anchor = shared_from_this(), sync_user](const Response& response) {
+                   util::Optional<AppError> error = AppUtils::check_for_errors(response);
+                   if (!error) {
+                       try {
+                           auto json = parse<BsonDocument>(response.body);
+                           sync_user->update_access_token(get<std::string>(json, "access_token"));
+                       }
+                       catch (AppError& err) {
+                           error = std::move(err);
+                       }
                    }
 
-                   try {
-                       auto json = parse<BsonDocument>(response.body);
-                       sync_user->update_access_token(get<std::string>(json, "access_token"));
-                   }
-                   catch (AppError& err) {
-                       return completion(std::move(err));
+                   std::vector<UniqueFunction<void(Optional<AppError>)>> waiting;
+                   {
+                       std::lock_guard<std::mutex> lock(*anchor->m_pending_requests_mutex);
+                       auto it = anchor->m_pending_token_refreshes.find(sync_user.get());
+                       REALM_ASSERT(it != anchor->m_pending_token_refreshes.end());
+                       waiting = std::move(it->second);
+                       anchor->m_pending_token_refreshes.erase(it);
                    }
-
-                   return completion(util::none);
+                   for (auto& completion : waiting)
+                       completion(error);
                });
 }
 
@@ -907,7 +926,7 @@ void App::call_function(const std::shared_ptr<SyncUser>& user, const std::string
                         const Optional<std::string>& service_name,
                         UniqueFunction<void(Optional<Bson>&&, Optional<AppError>)>&& completion)
 {
-    auto handler = [completion = std::move(completion)](const Response& response) {
+    UniqueFunction<void(const Response&)> handler = [completion = std::move(completion)](const Response& response) {
         if (auto error = AppUtils::check_for_errors(response)) {
             return completion(util::none, error);
         }
@@ -926,10 +945,34 @@ void App::call_function(const std::shared_ptr<SyncUser>& user, const std::string
     if (service_name) {
         args["service"] = *service_name;
     }
+    std::string body = Bson(args).toJson();
+
+    if (m_config.coalesce_function_calls) {
+        FunctionCallKey key{user.get(), body};
+        {
+            std::lock_guard<std::mutex> lock(*m_pending_requests_mutex);
+            auto& waiting = m_pending_function_calls[key];
+            waiting.push_back(std::move(handler));
+            if (waiting.size() > 1)
+                return;
+        }
+        handler = [anchor = shared_from_this(), key = std::move(key)](const Response& response) {
+            std::vector<UniqueFunction<void(const Response&)>> waiting;
+            {
+                std::lock_guard<std::mutex> lock(*anchor->m_pending_requests_mutex);
+                auto it = anchor->m_pending_function_calls.find(key);
+                REALM_ASSERT(it != anchor->m_pending_function_calls.end());
+                waiting = std::move(it->second);
+                anchor->m_pending_function_calls.erase(it);
+            }
+            for (auto& handler : waiting)
+                handler(response);
+        };
+    }
 
     do_authenticated_request(
-        Request{HttpMethod::post, function_call_url_path(), m_request_timeout_ms, {}, Bson(args).toJson(), false},
-        user, std::move(handler));
+        Request{HttpMethod::post, function_call_url_path(), m_request_timeout_ms, {}, std::move(body), false}, user,
+        std::move(handler));
 }
 
 void App::call_function(const std::shared_ptr<SyncUser>& user, const std::string& name, const BsonArray& args_bson,
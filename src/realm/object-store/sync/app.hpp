@@ -30,6 +30,7 @@
 #include <realm/util/optional.hpp>
 #include <realm/util/functional.hpp>
 
+#include <map>
 #include <mutex>
 
 namespace realm {
@@ -64,6 +65,11 @@ public:
         std::string platform;
         std::string platform_version;
         std::string sdk_version;
+        // If true, concurrent calls to the same function, by the same user and
+        // with the same arguments, share a single request to the server, and
+        // all of them receive its result. Only enable this when the functions
+        // being called have no side effects.
+        bool coalesce_function_calls = false;
     };
 
     // `enable_shared_from_this` is unsafe with public constructors; use `get_shared_app` instead
@@ -369,6 +375,15 @@ private:
     uint64_t m_request_timeout_ms;
     std::shared_ptr<SyncManager> m_sync_manager;
 
+    // Completion handlers waiting for a request that is already in flight:
+    // access token refreshes by user, and coalesced function calls by user and
+    // request body.
+    using FunctionCallKey = std::pair<const SyncUser*, std::string>;
+    mutable std::unique_ptr<std::mutex> m_pending_requests_mutex = std::make_unique<std::mutex>();
+    std::map<const SyncUser*, std::vector<util::UniqueFunction<void(util::Optional<AppError>)>>>
+        m_pending_token_refreshes;
+    std::map<FunctionCallKey, std::vector<util::UniqueFunction<void(const Response&)>>> m_pending_function_calls;
+
     /// Refreshes the access token for a specified `SyncUser`
     /// @param completion Passes an error should one occur.
     void refresh_access_token(const std::shared_ptr<SyncUser>& user,
@@ -94,7 +94,7 @@ ResponseHandler<util::Optional<Bson>> get_document_handler(ResponseHandler<util:
             return completion(util::none, util::none);
         }
 
-        return completion(static_cast<BsonDocument>(*value), util::none);
+        return completion(std::move(static_cast<BsonDocument&>(*value)), util::none);
     };
 }
 
@@ -121,7 +121,7 @@ void MongoCollection::find(const BsonDocument& filter_bson, const FindOptions& o
                       return completion(util::none, std::move(error));
                   }
 
-                  return completion(static_cast<BsonArray>(*value), util::none);
+                  return completion(std::move(static_cast<BsonArray&>(*value)), util::none);
               });
 }
 
@@ -163,7 +163,7 @@ void MongoCollection::aggregate(const BsonArray& pipeline, ResponseHandler<util:
             return completion(util::none, std::move(error));
         }
 
-        return completion(static_cast<BsonArray>(*value), util::none);
+        return completion(std::move(static_cast<BsonArray&>(*value)), util::none);
     });
 }
 
@@ -154,6 +154,13 @@ public:
             m_table_key = list->get_table()->get_key();
             m_col_key = list->get_col_key();
         }
+        else if (auto tv = r.get_realm()->is_in_transaction() ? util::none : r.get_evaluated_tableview()) {
+            // Hand over the matches as well, so that they can be used as they
+            // are if the target Realm is at the same version. Inside a write
+            // transaction they may include objects the target cannot see.
+            m_transaction = r.get_realm()->duplicate();
+            m_table_view = m_transaction->import_copy_of(*tv, PayloadPolicy::Move);
+        }
         else {
             Query q(r.get_query());
             m_transaction = r.get_realm()->duplicate();
@@ -198,6 +205,11 @@ public:
             }
             return Results(r, std::move(collection), m_ordering);
         }
+        if (m_table_view) {
+            // Re-run on first access if the target Realm is at a later version
+            auto tv = r->import_copy_of(*m_table_view, PayloadPolicy::Copy);
+            return Results(std::move(r), std::move(*tv), m_ordering);
+        }
         auto q = r->import_copy_of(*m_query, PayloadPolicy::Stay);
         return Results(std::move(r), std::move(*q), m_ordering);
     }
@@ -207,6 +219,7 @@ private:
     TransactionRef m_transaction;
     DescriptorOrdering m_ordering;
     std::unique_ptr<Query> m_query;
+    std::unique_ptr<TableView> m_table_view;
     ObjKey m_key;
     TableKey m_table_key;
     ColKey m_col_key;
@@ -105,8 +105,8 @@ public:
             return;
         }
         init();
-        m_queue.push(std::move(fn));
-        notify_fd(m_message_pipe.write);
+        if (m_queue.push(std::move(fn)))
+            notify_fd(m_message_pipe.write);
     }
 
     bool can_invoke() const noexcept override
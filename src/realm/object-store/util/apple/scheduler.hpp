@@ -89,7 +89,8 @@ RunLoopScheduler::~RunLoopScheduler()
 
 void RunLoopScheduler::invoke(util::UniqueFunction<void()>&& fn)
 {
-    m_queue.queue.push(std::move(fn));
+    if (!m_queue.queue.push(std::move(fn)))
+        return;
 
     CFRunLoopSourceSignal(m_notify_signal);
     // Signalling the source makes it run the next time the runloop gets
@@ -474,20 +474,21 @@ std::ostream& operator<<(std::ostream& out, const Bson& b)
             out << "{\"$minKey\":1}";
             break;
         case Bson::Type::Document: {
-            const BsonDocument& doc = static_cast<BsonDocument>(b);
+            const BsonDocument& doc = static_cast<const BsonDocument&>(b);
             out << "{";
             bool first = true;
-            for (auto const& pair : doc) {
+            // Iterating the document itself would copy every entry
+            for (auto const& key : doc.keys()) {
                 if (!first)
                     out << ',';
                 first = false;
-                out << nlohmann::json(pair.first).dump() << ':' << pair.second;
+                out << nlohmann::json(key).dump() << ':' << doc.at(key);
             }
             out << "}";
             break;
         }
         case Bson::Type::Array: {
-            const BsonArray& arr = static_cast<BsonArray>(b);
+            const BsonArray& arr = static_cast<const BsonArray&>(b);
             out << "[";
             bool first = true;
             for (auto const& b : arr) {
@@ -526,104 +527,27 @@ struct BsonError : public std::runtime_error {
     }
 };
 
-namespace {
-// This implements just enough of the map API to support nlohmann's DOM apis that we use.
-template <typename K, typename V, typename... Ignored>
-struct LinearMap {
-    using key_type = K;
-    using mapped_type = V;
-    using value_type = std::pair<const K, V>;
-    using storage_type = std::vector<value_type>;
-    using iterator = typename storage_type::iterator;
-    using const_iterator = typename storage_type::const_iterator;
-
-    auto begin()
-    {
-        return _elems.begin();
-    }
-    auto begin() const
-    {
-        return _elems.begin();
-    }
-    auto end()
-    {
-        return _elems.end();
-    }
-    auto end() const
-    {
-        return _elems.end();
-    }
-    auto size() const
-    {
-        return _elems.size();
-    }
-    auto max_size() const
-    {
-        return _elems.max_size();
-    }
-    auto clear()
-    {
-        return _elems.clear();
-    }
-    V& operator[](const K& k)
-    {
-        // assume this is only used for adding a new element.
-        return _elems.emplace_back(k, V()).second;
-    }
-
-    template <typename... Args>
-    std::pair<iterator, bool> emplace(Args&&... args)
-    {
-        // assume this is only used for adding a new element.
-        _elems.emplace_back(std::forward<Args>(args)...);
-        return {--_elems.end(), true};
-    }
-
-    iterator erase(iterator)
-    {
-        // This is only used when mutating the DOM which we don't do.
-        REALM_TERMINATE("LinearMap::erase() should never be called");
-    }
+const std::string& get_string(const Bson& bson, const char* what)
+{
+    if (bson.type() != Bson::Type::String)
+        throw BsonError(util::format("invalid extended json %1", what));
+    return static_cast<const std::string&>(bson);
+}
 
-    storage_type _elems;
-};
+int64_t get_integer(const Bson& bson, const char* what)
+{
+    if (bson.type() == Bson::Type::Int32)
+        return static_cast<int32_t>(bson);
+    if (bson.type() == Bson::Type::Int64)
+        return static_cast<int64_t>(bson);
+    throw BsonError(util::format("invalid extended json %1", what));
+}
 
-using Json = nlohmann::basic_json<LinearMap>;
-
-Bson dom_obj_to_bson(const Json& json);
-
-Bson dom_elem_to_bson(const Json& json)
-{
-    switch (json.type()) {
-        case Json::value_t::null:
-            return Bson();
-        case Json::value_t::string:
-            return Bson(json.get<std::string>());
-        case Json::value_t::boolean:
-            return Bson(json.get<bool>());
-        case Json::value_t::number_integer:
-            return Bson(json.get<int64_t>());
-        case Json::value_t::number_unsigned: {
-            uint64_t val = json.get<uint64_t>();
-            if (val <= uint64_t(std::numeric_limits<int64_t>::max()))
-                return Bson(int64_t(val));
-            return Bson(double(val));
-        }
-        case Json::value_t::number_float:
-            return Bson(json.get<double>());
-        case Json::value_t::object:
-            return dom_obj_to_bson(json);
-        case Json::value_t::array: {
-            std::vector<Bson> out;
-            for (auto&& elem : json) {
-                out.push_back(dom_elem_to_bson(elem));
-            }
-            return Bson(std::move(out));
-        }
-        case Json::value_t::discarded:
-            REALM_TERMINATE("should never see discarded");
-    }
-    REALM_TERMINATE("unknown json value type");
+const BsonDocument& get_document(const Bson& bson, const char* what)
+{
+    if (bson.type() != Bson::Type::Document)
+        throw BsonError(util::format("invalid extended json %1", what));
+    return static_cast<const BsonDocument&>(bson);
 }
 
 // This works around the deleted rvalue constructor in StringData
@@ -632,22 +556,27 @@ inline StringData tosd(const std::string& s)
     return s;
 }
 
+// The parsers for the extended json wrapper objects. They are given the value
+// of the wrapper's only field (or the whole wrapper if it has two fields),
+// which has itself already been converted.
+//
 // Keep these sorted by key. This is checked so you can't forget.
-using FancyParser = Bson (*)(const Json& json);
+using FancyParser = Bson (*)(const Bson& bson);
 static constexpr std::pair<std::string_view, FancyParser> bson_fancy_parsers[] = {
     {"$binary",
-     +[](const Json& json) {
+     +[](const Bson& bson) {
          util::Optional<std::vector<char>> base64;
          util::Optional<uint8_t> subType;
-         if (json.size() != 2)
+         const BsonDocument& doc = get_document(bson, "$binary");
+         if (doc.size() != 2)
              throw BsonError("invalid extended json $binary");
-         for (auto&& [k, v] : json.items()) {
+         for (auto& [k, v] : doc.entries()) {
              if (k == "base64") {
-                 const std::string& str = v.get<std::string>();
+                 const std::string& str = get_string(v, "$binary");
                  base64.emplace(str.begin(), str.end());
              }
              else if (k == "subType") {
-                 subType = uint8_t(std::stoul(v.get<std::string>(), nullptr, 16));
+                 subType = uint8_t(std::stoul(get_string(v, "$binary"), nullptr, 16));
              }
          }
          if (!base64 || !subType)
@@ -666,69 +595,71 @@ static constexpr std::pair<std::string_view, FancyParser> bson_fancy_parsers[] =
          }
      }},
     {"$date",
-     +[](const Json& json) {
-         int64_t millis_since_epoch = dom_elem_to_bson(json).operator int64_t();
+     +[](const Bson& bson) {
+         int64_t millis_since_epoch = get_integer(bson, "$date");
          return Bson(realm::Timestamp(millis_since_epoch / 1000,
                                       (millis_since_epoch % 1000) * 1'000'000)); // ms -> ns
      }},
     {"$maxKey",
-     +[](const Json&) {
+     +[](const Bson&) {
          return Bson(MaxKey());
      }},
     {"$minKey",
-     +[](const Json&) {
+     +[](const Bson&) {
          return Bson(MinKey());
      }},
     {"$numberDecimal",
-     +[](const Json& json) {
-         return Bson(Decimal128(tosd(json.get<std::string>())));
+     +[](const Bson& bson) {
+         return Bson(Decimal128(tosd(get_string(bson, "$numberDecimal"))));
      }},
     {"$numberDouble",
-     +[](const Json& json) {
-         return Bson(std::stod(json.get<std::string>()));
+     +[](const Bson& bson) {
+         return Bson(std::stod(get_string(bson, "$numberDouble")));
      }},
     {"$numberInt",
-     +[](const Json& json) {
-         return Bson(int32_t(std::stoi(json.get<std::string>())));
+     +[](const Bson& bson) {
+         return Bson(int32_t(std::stoi(get_string(bson, "$numberInt"))));
      }},
     {"$numberLong",
-     +[](const Json& json) {
-         return Bson(int64_t(std::stoll(json.get<std::string>())));
+     +[](const Bson& bson) {
+         return Bson(int64_t(std::stoll(get_string(bson, "$numberLong"))));
      }},
     {"$oid",
-     +[](const Json& json) {
-         return Bson(ObjectId(json.get<std::string>().c_str()));
+     +[](const Bson& bson) {
+         return Bson(ObjectId(get_string(bson, "$oid").c_str()));
      }},
     {"$regularExpression",
-     +[](const Json& json) {
+     +[](const Bson& bson) {
          util::Optional<std::string> pattern;
          util::Optional<std::string> options;
-         if (json.size() != 2)
-             throw BsonError("invalid extended json $binary");
-         for (auto&& [k, v] : json.items()) {
+         const BsonDocument& doc = get_document(bson, "$regularExpression");
+         if (doc.size() != 2)
+             throw BsonError("invalid extended json $regularExpression");
+         for (auto& [k, v] : doc.entries()) {
              if (k == "pattern") {
-                 pattern = v.get<std::string>();
+                 pattern = get_string(v, "$regularExpression");
              }
              else if (k == "options") {
-                 options = v.get<std::string>();
+                 options = get_string(v, "$regularExpression");
              }
          }
          if (!pattern || !options)
-             throw BsonError("invalid extended json $binary");
+             throw BsonError("invalid extended json $regularExpression");
          return Bson(RegularExpression(std::move(*pattern), std::move(*options)));
      }},
     {"$timestamp",
-     +[](const Json& json) {
+     +[](const Bson& bson) {
          util::Optional<uint32_t> t;
          util::Optional<uint32_t> i;
-         if (json.size() != 2)
+         const BsonDocument& doc = get_document(bson, "$timestamp");
+         if (doc.size() != 2)
              throw BsonError("invalid extended json $timestamp");
-         for (auto&& [k, v] : json.items()) {
+         for (auto& [k, v] : doc.entries()) {
              if (k == "t") {
-                 t = v.get<uint32_t>();
+                 t = uint32_t(get_integer(v, "$timestamp"));
              }
              else if (k == "i") {
-                 i = v.get<uint32_t>();
+                 i = uint32_t(get_integer(v, "$timestamp"));
              }
          }
          if (!t || !i)
@@ -736,9 +667,8 @@ static constexpr std::pair<std::string_view, FancyParser> bson_fancy_parsers[] =
          return Bson(MongoTimestamp(*t, *i));
      }},
     {"$uuid",
-     +[](const Json& json) {
-         std::string uuid = json.get<std::string>();
-         return Bson(UUID(uuid));
+     +[](const Bson& bson) {
+         return Bson(UUID(get_string(bson, "$uuid")));
      }},
 };
 
@@ -756,42 +686,162 @@ constexpr auto parser_comp = [](const std::pair<std::string_view, FancyParser>&
 }();
 #endif
 
-Bson dom_obj_to_bson(const Json& json)
-{
-    if (json.size() == 1) {
-        const auto& [key, value] = json.items().begin();
-        if (key[0] == '$') {
-            auto it = std::lower_bound(std::begin(bson_fancy_parsers), std::end(bson_fancy_parsers),
-                                       std::pair<std::string_view, FancyParser>(key, nullptr), parser_comp);
-            if (it != std::end(bson_fancy_parsers) && it->first == key) {
-                return it->second(value);
-            }
-        }
+FancyParser find_fancy_parser(const std::string& key)
+{
+    if (key.empty() || key[0] != '$')
+        return nullptr;
+    auto it = std::lower_bound(std::begin(bson_fancy_parsers), std::end(bson_fancy_parsers),
+                               std::pair<std::string_view, FancyParser>(key, nullptr), parser_comp);
+    if (it != std::end(bson_fancy_parsers) && it->first == key)
+        return it->second;
+    return nullptr;
+}
+
+// Builds the Bson value directly from the parser's events, rather than going
+// through a json DOM first. Values are moved into their parent container as
+// soon as they are complete, and extended json wrappers are replaced by the
+// value they describe when their closing brace is seen.
+class BsonBuilder {
+public:
+    using number_integer_t = nlohmann::json::number_integer_t;
+    using number_unsigned_t = nlohmann::json::number_unsigned_t;
+    using number_float_t = nlohmann::json::number_float_t;
+    using string_t = nlohmann::json::string_t;
+
+    Bson release()
+    {
+        REALM_ASSERT(m_stack.empty());
+        return std::move(m_root);
     }
-    else if (json.size() == 2) {
-        const auto& [key, value] = json.items().begin();
-        if (key[0] == '$') {
-            auto it = std::lower_bound(std::begin(bson_fancy_parsers), std::end(bson_fancy_parsers),
-                                       std::pair<std::string_view, FancyParser>(key, nullptr), parser_comp);
-            if (it != std::end(bson_fancy_parsers) && it->first == key) {
-                return it->second(json);
-            }
+
+    bool null()
+    {
+        add(Bson());
+        return true;
+    }
+    bool boolean(bool val)
+    {
+        add(Bson(val));
+        return true;
+    }
+    bool number_integer(number_integer_t val)
+    {
+        add(Bson(int64_t(val)));
+        return true;
+    }
+    bool number_unsigned(number_unsigned_t val)
+    {
+        if (val <= uint64_t(std::numeric_limits<int64_t>::max()))
+            add(Bson(int64_t(val)));
+        else
+            add(Bson(double(val)));
+        return true;
+    }
+    bool number_float(number_float_t val, const string_t&)
+    {
+        add(Bson(double(val)));
+        return true;
+    }
+    bool string(string_t& val)
+    {
+        add(Bson(std::move(val)));
+        return true;
+    }
+    template <typename Binary>
+    bool binary(Binary&)
+    {
+        // Never produced when parsing json text
+        throw BsonError("unexpected binary value in json");
+    }
+    bool start_object(std::size_t)
+    {
+        m_stack.emplace_back();
+        m_stack.back().is_document = true;
+        return true;
+    }
+    bool key(string_t& val)
+    {
+        Frame& frame = m_stack.back();
+        if (frame.document.size() == 0)
+            frame.first_key = val;
+        frame.key = std::move(val);
+        return true;
+    }
+    bool end_object()
+    {
+        Frame& frame = m_stack.back();
+        Bson value;
+        FancyParser parser = nullptr;
+        std::size_t size = frame.document.size();
+        if (size == 1 || size == 2)
+            parser = find_fancy_parser(frame.first_key);
+        if (parser && size == 1) {
+            value = parser(frame.document.at(frame.first_key));
+        }
+        else if (parser) {
+            value = parser(Bson(std::move(frame.document)));
         }
+        else {
+            value = Bson(std::move(frame.document));
+        }
+        m_stack.pop_back();
+        add(std::move(value));
+        return true;
+    }
+    bool start_array(std::size_t size)
+    {
+        m_stack.emplace_back();
+        if (size != std::size_t(-1))
+            m_stack.back().array.reserve(size);
+        return true;
+    }
+    bool end_array()
+    {
+        Bson value(std::move(m_stack.back().array));
+        m_stack.pop_back();
+        add(std::move(value));
+        return true;
+    }
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex)
+    {
+        throw BsonError(ex.what());
     }
 
-    BsonDocument out;
-    for (auto&& [k, v] : json.items()) {
-        out[k] = dom_elem_to_bson(v);
+private:
+    struct Frame {
+        bool is_document = false;
+        BsonDocument document;
+        BsonArray array;
+        std::string key;
+        std::string first_key;
+    };
+
+    void add(Bson&& value)
+    {
+        if (m_stack.empty()) {
+            m_root = std::move(value);
+            return;
+        }
+        Frame& frame = m_stack.back();
+        if (frame.is_document) {
+            frame.document[frame.key] = std::move(value);
+        }
+        else {
+            frame.array.push_back(std::move(value));
+        }
     }
-    return out;
-}
-} // namespace
+
+    std::vector<Frame> m_stack;
+    Bson m_root;
+};
 
 } // anonymous namespace
 
 Bson parse(const std::string_view& json)
 {
-    return dom_elem_to_bson(Json::parse(json));
+    BsonBuilder builder;
+    nlohmann::json::sax_parse(json, &builder);
+    return builder.release();
 }
 
 } // namespace bson
@@ -0,0 +1,363 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_OS_UTIL_COROUTINE_HPP
+#define REALM_OS_UTIL_COROUTINE_HPP
+
+#include <realm/util/features.h>
+
+// Core itself is built as C++17, so the awaitables are only available to code
+// which includes this header with C++20 coroutine support enabled.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define REALM_HAVE_COROUTINES 1
+#else
+#define REALM_HAVE_COROUTINES 0
+#endif
+
+#if REALM_HAVE_COROUTINES
+
+#include <realm/object-store/results.hpp>
+#include <realm/object-store/shared_realm.hpp>
+#include <realm/object-store/thread_safe_reference.hpp>
+#include <realm/object-store/util/scheduler.hpp>
+#include <realm/status_with.hpp>
+#include <realm/util/future.hpp>
+
+#if REALM_ENABLE_SYNC
+#include <realm/object-store/sync/async_open_task.hpp>
+#include <realm/object-store/sync/sync_session.hpp>
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <system_error>
+
+// Awaitables for the callback based asynchronous APIs, for use in C++20
+// coroutines. The coroutine is resumed on the scheduler of the Realm, or on the
+// given scheduler, which defaults to the one for the awaiting thread. Nothing
+// is allocated beyond what the wrapped API allocates for its callback.
+//
+// A coroutine which is suspended on one of these is never resumed if the
+// operation is abandoned, e.g. because the Realm is closed, and so must not own
+// anything which needs to be released.
+namespace realm::util {
+
+namespace _impl {
+class ScheduledResume {
+protected:
+    ScheduledResume(std::shared_ptr<Scheduler> scheduler)
+        : m_scheduler(std::move(scheduler))
+    {
+    }
+
+    // Resumes the coroutine on the next iteration of the scheduler's run loop.
+    // This must be the last access to the awaiter, as the coroutine may resume
+    // and destroy it right away if the scheduler is for another thread.
+    void resume(std::coroutine_handle<> handle)
+    {
+        m_scheduler->invoke([handle] {
+            handle.resume();
+        });
+    }
+
+private:
+    std::shared_ptr<Scheduler> m_scheduler;
+};
+} // namespace _impl
+
+/// Awaits the completion of a Future. Evaluates to the value of the future, or
+/// throws ExceptionForStatus if the future completed with an error.
+template <typename T>
+class FutureAwaiter : _impl::ScheduledResume {
+public:
+    FutureAwaiter(Future<T>&& future, std::shared_ptr<Scheduler> scheduler)
+        : ScheduledResume(std::move(scheduler))
+        , m_future(std::move(future))
+    {
+    }
+
+    bool await_ready() const
+    {
+        return m_future.is_ready();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        std::move(m_future).get_async([this, handle](StatusOrStatusWith<T> result) noexcept {
+            m_result.emplace(std::move(result));
+            resume(handle);
+        });
+    }
+
+    T await_resume()
+    {
+        if (!m_result)
+            return std::move(m_future).get();
+        if constexpr (std::is_void_v<T>) {
+            if (!m_result->is_ok())
+                throw ExceptionForStatus(std::move(*m_result));
+        }
+        else {
+            if (!m_result->is_ok())
+                throw ExceptionForStatus(m_result->get_status());
+            return std::move(m_result->get_value());
+        }
+    }
+
+private:
+    Future<T> m_future;
+    std::optional<StatusOrStatusWith<T>> m_result;
+};
+
+template <typename T>
+FutureAwaiter<T> await_future(Future<T>&& future,
+                              std::shared_ptr<Scheduler> scheduler = Scheduler::make_default())
+{
+    return {std::move(future), std::move(scheduler)};
+}
+
+/// Resumes the coroutine inside the write transaction started by
+/// Realm::async_begin_transaction(). The coroutine is resumed directly from the
+/// write block, so the transaction is still open when it continues. It is
+/// expected to end it with `co_await await_commit_transaction(realm)` or with
+/// Realm::cancel_transaction().
+class BeginTransactionAwaiter {
+public:
+    explicit BeginTransactionAwaiter(Realm& realm)
+        : m_realm(realm)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_realm.async_begin_transaction([handle] {
+            handle.resume();
+        });
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    Realm& m_realm;
+};
+
+inline BeginTransactionAwaiter await_begin_transaction(Realm& realm)
+{
+    return BeginTransactionAwaiter(realm);
+}
+
+/// Commits the current write transaction with Realm::async_commit_transaction()
+/// and resumes once the commit is durable. Throws if the commit failed.
+class CommitTransactionAwaiter : _impl::ScheduledResume {
+public:
+    CommitTransactionAwaiter(Realm& realm, bool allow_grouping)
+        : ScheduledResume(realm.scheduler())
+        , m_realm(realm)
+        , m_allow_grouping(allow_grouping)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // The completion callback runs while completions are being delivered,
+        // where a new write can't be started, so the coroutine continues on
+        // the next run loop iteration
+        m_realm.async_commit_transaction(
+            [this, handle](std::exception_ptr error) {
+                m_error = error;
+                resume(handle);
+            },
+            m_allow_grouping);
+    }
+
+    void await_resume() const
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+private:
+    Realm& m_realm;
+    bool m_allow_grouping;
+    std::exception_ptr m_error;
+};
+
+inline CommitTransactionAwaiter await_commit_transaction(Realm& realm, bool allow_grouping = false)
+{
+    return CommitTransactionAwaiter(realm, allow_grouping);
+}
+
+/// Resumes once the query of the Results has been run in the background by a
+/// notifier, and evaluates to the Results holding that evaluation. Unlike
+/// evaluating the Results on the awaiting thread, this does not block it.
+class ResultsAwaiter : _impl::ScheduledResume {
+public:
+    explicit ResultsAwaiter(const Results& results)
+        : ScheduledResume(results.get_realm()->scheduler())
+        , m_results(results)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_token = m_results.add_notification_callback([this, handle](CollectionChangeSet) {
+            if (m_delivered)
+                return;
+            m_delivered = true;
+            resume(handle);
+        });
+    }
+
+    Results await_resume()
+    {
+        m_token.unregister();
+        return std::move(m_results);
+    }
+
+private:
+    Results m_results;
+    NotificationToken m_token;
+    bool m_delivered = false;
+};
+
+inline ResultsAwaiter await_results(const Results& results)
+{
+    return ResultsAwaiter(results);
+}
+
+#if REALM_ENABLE_SYNC
+/// Waits for SyncSession::wait_for_upload_completion() or
+/// SyncSession::wait_for_download_completion(). Throws std::system_error if
+/// the wait failed.
+class SyncCompletionAwaiter : _impl::ScheduledResume {
+public:
+    enum class Direction { upload, download };
+
+    SyncCompletionAwaiter(SyncSession& session, Direction direction, std::shared_ptr<Scheduler> scheduler)
+        : ScheduledResume(std::move(scheduler))
+        , m_session(session)
+        , m_direction(direction)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        auto callback = [this, handle](std::error_code ec) {
+            m_error = ec;
+            resume(handle);
+        };
+        if (m_direction == Direction::upload)
+            m_session.wait_for_upload_completion(std::move(callback));
+        else
+            m_session.wait_for_download_completion(std::move(callback));
+    }
+
+    void await_resume() const
+    {
+        if (m_error)
+            throw std::system_error(m_error);
+    }
+
+private:
+    SyncSession& m_session;
+    Direction m_direction;
+    std::error_code m_error;
+};
+
+inline SyncCompletionAwaiter await_upload_completion(SyncSession& session,
+                                                     std::shared_ptr<Scheduler> scheduler = Scheduler::make_default())
+{
+    return {session, SyncCompletionAwaiter::Direction::upload, std::move(scheduler)};
+}
+
+inline SyncCompletionAwaiter await_download_completion(SyncSession& session,
+                                                       std::shared_ptr<Scheduler> scheduler = Scheduler::make_default())
+{
+    return {session, SyncCompletionAwaiter::Direction::download, std::move(scheduler)};
+}
+
+/// Starts the AsyncOpenTask and evaluates to the reference to the opened
+/// Realm. Throws the error the task failed with.
+class AsyncOpenAwaiter : _impl::ScheduledResume {
+public:
+    AsyncOpenAwaiter(std::shared_ptr<AsyncOpenTask> task, std::shared_ptr<Scheduler> scheduler)
+        : ScheduledResume(std::move(scheduler))
+        , m_task(std::move(task))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_task->start([this, handle](ThreadSafeReference realm, std::exception_ptr error) {
+            m_realm = std::move(realm);
+            m_error = error;
+            resume(handle);
+        });
+    }
+
+    ThreadSafeReference await_resume()
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+        return std::move(m_realm);
+    }
+
+private:
+    std::shared_ptr<AsyncOpenTask> m_task;
+    ThreadSafeReference m_realm;
+    std::exception_ptr m_error;
+};
+
+inline AsyncOpenAwaiter await_open(std::shared_ptr<AsyncOpenTask> task,
+                                   std::shared_ptr<Scheduler> scheduler = Scheduler::make_default())
+{
+    return {std::move(task), std::move(scheduler)};
+}
+#endif // REALM_ENABLE_SYNC
+
+} // namespace realm::util
+
+#endif // REALM_HAVE_COROUTINES
+
+#endif // REALM_OS_UTIL_COROUTINE_HPP
@@ -34,6 +34,8 @@
 
 #include <realm/object-store/util/generic/scheduler.hpp>
 
+#include <utility>
+
 namespace realm::util {
 namespace {
 
@@ -84,10 +86,11 @@ public:
 };
 } // anonymous namespace
 
-void InvocationQueue::push(util::UniqueFunction<void()>&& fn)
+bool InvocationQueue::push(util::UniqueFunction<void()>&& fn)
 {
     std::lock_guard lock(m_mutex);
     m_functions.push_back(std::move(fn));
+    return !std::exchange(m_signalled, true);
 }
 
 void InvocationQueue::invoke_all()
@@ -96,6 +99,8 @@ void InvocationQueue::invoke_all()
     {
         std::lock_guard lock(m_mutex);
         functions.swap(m_functions);
+        // Functions pushed from here on need a new wakeup
+        m_signalled = false;
     }
     for (auto&& fn : functions) {
         fn();
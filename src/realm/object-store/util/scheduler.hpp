@@ -133,12 +133,16 @@ public:
 // some of the schedulers
 class InvocationQueue {
 public:
-    void push(util::UniqueFunction<void()>&&);
+    // Returns true if the scheduler needs to wake up its loop to call
+    // invoke_all(). Pushes made before that call are picked up by it, so only
+    // the first push after each invoke_all() needs to signal.
+    bool push(util::UniqueFunction<void()>&&);
     void invoke_all();
 
 private:
     std::mutex m_mutex;
     std::vector<util::UniqueFunction<void()>> m_functions;
+    bool m_signalled = false;
 };
 
 
@@ -81,8 +81,8 @@ public:
     void invoke(util::UniqueFunction<void()>&& fn) override
     {
         auto& data = *static_cast<Data*>(m_handle->data);
-        data.queue.push(std::move(fn));
-        uv_async_send(m_handle.get());
+        if (data.queue.push(std::move(fn)))
+            uv_async_send(m_handle.get());
     }
 
 private:
@@ -1,5 +1,6 @@
 #include "realm/parser/driver.hpp"
 #include "realm/parser/keypath_mapping.hpp"
+#include "realm/parser/query_cache.hpp"
 #include "realm/parser/query_parser.hpp"
 #include "realm/sort_descriptor.hpp"
 #include <realm/decimal128.hpp>
@@ -63,6 +64,7 @@ static std::map<int, std::string> opstr = {
     {CompareNode::CONTAINS, "contains"},
     {CompareNode::LIKE, "like"},
     {CompareNode::IN, "in"},
+    {CompareNode::TEXT, "text"},
 };
 
 std::string print_pretty_objlink(const ObjLink& link, const Group* g, ParserDriver* drv)
@@ -395,6 +397,11 @@ std::unique_ptr<Subexpr> OperationNode::visit(ParserDriver* drv, DataType type)
 }
 
 Query EqualityNode::visit(ParserDriver* drv)
+{
+    return drv->bind_placeholder(make_query(drv), values);
+}
+
+Query EqualityNode::make_query(ParserDriver* drv)
 {
     auto [left, right] = drv->cmp(values);
 
@@ -552,6 +559,11 @@ Query BetweenNode::visit(ParserDriver* drv)
 }
 
 Query RelationalNode::visit(ParserDriver* drv)
+{
+    return drv->bind_placeholder(make_query(drv), values);
+}
+
+Query RelationalNode::make_query(ParserDriver* drv)
 {
     auto [left, right] = drv->cmp(values);
 
@@ -624,6 +636,11 @@ Query RelationalNode::visit(ParserDriver* drv)
 }
 
 Query StringOpsNode::visit(ParserDriver* drv)
+{
+    return drv->bind_placeholder(make_query(drv), values);
+}
+
+Query StringOpsNode::make_query(ParserDriver* drv)
 {
     auto [left, right] = drv->cmp(values);
 
@@ -633,6 +650,15 @@ Query StringOpsNode::visit(ParserDriver* drv)
 
     verify_only_string_types(right_type, opstr[op]);
 
+    if (op == CompareNode::TEXT) {
+        if (!prop || prop->links_exist() || left_type != type_String || prop->column_key().is_collection() ||
+            right_type != type_String || !right->has_single_value()) {
+            throw InvalidQueryError(
+                "Operator 'TEXT' requires a string property of the queried class on the left and a string on the right");
+        }
+        return drv->m_base_table->where().fulltext(prop->column_key(), right->get_mixed().get_string());
+    }
+
     if (prop && !prop->links_exist() && right->has_single_value() &&
         (left_type == right_type || left_type == type_Mixed)) {
         auto col_key = prop->column_key();
@@ -710,27 +736,29 @@ Query TrueOrFalseNode::visit(ParserDriver* drv)
 
 std::unique_ptr<Subexpr> PropNode::visit(ParserDriver* drv)
 {
+    // A QueryCache visits the same nodes again, so they must not be modified
+    std::string prop_name = identifier;
+    const PathNode* prop_path = path;
+    PathNode dictionary_path;
     bool is_keys = false;
-    if (identifier[0] == '@') {
-        if (identifier == "@values") {
-            identifier = path->path_elems.back();
-            path->path_elems.pop_back();
-        }
-        else if (identifier == "@keys") {
-            identifier = path->path_elems.back();
-            path->path_elems.pop_back();
-            is_keys = true;
-        }
-        else if (identifier == "@links") {
+    if (prop_name[0] == '@') {
+        if (prop_name == "@values" || prop_name == "@keys") {
+            is_keys = prop_name == "@keys";
+            dictionary_path = *prop_path;
+            prop_name = dictionary_path.path_elems.back();
+            dictionary_path.path_elems.pop_back();
+            prop_path = &dictionary_path;
+        }
+        else if (prop_name == "@links") {
             // This is a backlink aggregate query
-            auto link_chain = path->visit(drv, comp_type);
+            auto link_chain = prop_path->visit(drv, comp_type);
             auto sub = link_chain.get_backlink_count<Int>();
             return sub.clone();
         }
     }
     try {
-        auto link_chain = path->visit(drv, comp_type);
-        std::unique_ptr<Subexpr> subexpr{drv->column(link_chain, identifier)};
+        auto link_chain = prop_path->visit(drv, comp_type);
+        std::unique_ptr<Subexpr> subexpr{drv->column(link_chain, prop_name)};
         if (index) {
             if (auto s = dynamic_cast<Columns<Dictionary>*>(subexpr.get())) {
                 auto t = s->get_type();
@@ -752,12 +780,13 @@ std::unique_ptr<Subexpr> PropNode::visit(ParserDriver* drv)
     }
     catch (const std::runtime_error& e) {
         // Is 'identifier' perhaps length operator?
-        if (!post_op && is_length_suffix(identifier) && path->path_elems.size() > 0) {
+        if (!post_op && is_length_suffix(prop_name) && prop_path->path_elems.size() > 0) {
             // If 'length' is the operator, the last id in the path must be the name
             // of a list property
-            auto prop = path->path_elems.back();
-            path->path_elems.pop_back();
-            std::unique_ptr<Subexpr> subexpr{path->visit(drv, comp_type).column(prop)};
+            PathNode list_path = *prop_path;
+            auto prop = list_path.path_elems.back();
+            list_path.path_elems.pop_back();
+            std::unique_ptr<Subexpr> subexpr{list_path.visit(drv, comp_type).column(prop)};
             if (auto list = dynamic_cast<ColumnListBase*>(subexpr.get())) {
                 if (auto length_expr = list->get_element_length())
                     return length_expr;
@@ -777,23 +806,23 @@ std::unique_ptr<Subexpr> SubqueryNode::visit(ParserDriver* drv)
                                        variable_name));
     }
     LinkChain lc = prop->path->visit(drv, prop->comp_type);
-    prop->identifier = drv->translate(lc, prop->identifier);
+    std::string identifier = drv->translate(lc, prop->identifier);
 
-    if (prop->identifier.find("@links") == 0) {
-        drv->backlink(lc, prop->identifier);
+    if (identifier.find("@links") == 0) {
+        drv->backlink(lc, identifier);
     }
     else {
-        ColKey col_key = lc.get_current_table()->get_column_key(prop->identifier);
+        ColKey col_key = lc.get_current_table()->get_column_key(identifier);
         if (col_key.is_list() && col_key.get_type() != col_type_LinkList) {
             throw InvalidQueryError(util::format(
-                "A subquery can not operate on a list of primitive values (property '%1')", prop->identifier));
+                "A subquery can not operate on a list of primitive values (property '%1')", identifier));
         }
         if (col_key.get_type() != col_type_LinkList) {
             throw InvalidQueryError(util::format("A subquery must operate on a list property, but '%1' is type '%2'",
-                                                 prop->identifier,
+                                                 identifier,
                                                  realm::get_data_type_name(DataType(col_key.get_type()))));
         }
-        lc.link(prop->identifier);
+        lc.link(identifier);
     }
     TableRef previous_table = drv->m_base_table;
     drv->m_base_table = lc.get_current_table().cast_away_const();
@@ -1293,7 +1322,7 @@ std::unique_ptr<Subexpr> ListNode::visit(ParserDriver* drv, DataType hint)
     return ret;
 }
 
-LinkChain PathNode::visit(ParserDriver* drv, util::Optional<ExpressionComparisonType> comp_type)
+LinkChain PathNode::visit(ParserDriver* drv, util::Optional<ExpressionComparisonType> comp_type) const
 {
     LinkChain link_chain(drv->m_base_table, comp_type);
     for (std::string path_elem : path_elems) {
@@ -1408,12 +1437,12 @@ ParserDriver::ParserDriver(TableRef t, Arguments& args, const query_parser::KeyP
     , m_args(args)
     , m_mapping(mapping)
 {
-    yylex_init(&m_yyscanner);
 }
 
 ParserDriver::~ParserDriver()
 {
-    yylex_destroy(m_yyscanner);
+    if (m_yyscanner)
+        yylex_destroy(m_yyscanner);
 }
 
 
@@ -1501,6 +1530,9 @@ int ParserDriver::parse(const std::string& str)
     // std::cout << str << std::endl;
     parse_buffer.append(str);
     parse_buffer.append("\0\0", 2); // Flex requires 2 terminating zeroes
+    // The scanner is only needed for parsing, and not when building a query from cached nodes
+    if (!m_yyscanner)
+        yylex_init(&m_yyscanner);
     scan_begin(m_yyscanner, trace_scanning);
     yy::parser parse(*this, m_yyscanner);
     parse.set_debug_level(trace_parsing);
@@ -1509,9 +1541,39 @@ int ParserDriver::parse(const std::string& str)
         std::string msg = "Invalid predicate: '" + str + "': " + error_string;
         throw SyntaxError(msg);
     }
+    if (result)
+        result->canonicalize();
     return res;
 }
 
+Query ParserDriver::build()
+{
+    return result->visit(this).set_ordering(ordering->visit(this));
+}
+
+Query ParserDriver::bind_placeholder(Query&& query, const std::vector<ExpressionNode*>& values)
+{
+    if (!m_bind_placeholders)
+        return std::move(query);
+
+    // Only a comparison with exactly one argument holding a single value is bound
+    util::Optional<size_t> placeholder;
+    for (auto value : values) {
+        auto value_node = dynamic_cast<ValueNode*>(value);
+        if (!value_node || !value_node->constant || value_node->constant->type != ConstantNode::ARG)
+            continue;
+        auto constant = value_node->constant;
+        size_t arg_no = size_t(strtol(constant->text.substr(1).c_str(), nullptr, 10));
+        if (placeholder || constant->m_comp_type || m_args.is_argument_list(arg_no) ||
+            m_args.is_argument_null(arg_no))
+            return std::move(query);
+        placeholder = arg_no;
+    }
+    if (placeholder)
+        query.set_placeholder(*placeholder);
+    return std::move(query);
+}
+
 void parse(const std::string& str)
 {
     ParserDriver driver;
@@ -1571,13 +1633,34 @@ Query Table::query(const std::string& query_string, const std::vector<std::vecto
     return query(query_string, args, mapping);
 }
 
+Query query_parser::QueryCache::query(ConstTableRef table, const std::string& query_string,
+                                     const std::vector<Mixed>& arguments, const KeyPathMapping& mapping)
+{
+    MixedArguments args(arguments);
+    return query(table, query_string, args, mapping);
+}
+
 Query Table::query(const std::string& query_string, query_parser::Arguments& args,
                    const query_parser::KeyPathMapping& mapping) const
 {
     ParserDriver driver(m_own_ref, args, mapping);
     driver.parse(query_string);
-    driver.result->canonicalize();
-    return driver.result->visit(&driver).set_ordering(driver.ordering->visit(&driver));
+    return driver.build();
+}
+
+Query Table::prepare_query(const std::string& query_string, const std::vector<Mixed>& arguments) const
+{
+    MixedArguments args(arguments);
+    return prepare_query(query_string, args, {});
+}
+
+Query Table::prepare_query(const std::string& query_string, query_parser::Arguments& args,
+                           const query_parser::KeyPathMapping& mapping) const
+{
+    ParserDriver driver(m_own_ref, args, mapping);
+    driver.m_bind_placeholders = true;
+    driver.parse(query_string);
+    return driver.build();
 }
 
 std::unique_ptr<Subexpr> LinkChain::column(const std::string& col)
@@ -110,6 +110,20 @@ public:
     static constexpr int CONTAINS = 8;
     static constexpr int LIKE = 9;
     static constexpr int IN = 10;
+    static constexpr int TEXT = 11;
+
+    // 'TEXT' is not a keyword of the lexer, so the grammar picks it out among the identifiers
+    static bool is_text_operator(const std::string& id)
+    {
+        const char* text = "text";
+        if (id.size() != 4)
+            return false;
+        for (size_t i = 0; i < 4; ++i) {
+            if ((id[i] | 0x20) != text[i])
+                return false;
+        }
+        return true;
+    }
 };
 
 class ConstantNode : public ParserNode {
@@ -263,6 +277,9 @@ public:
         values.emplace_back(right);
     }
     Query visit(ParserDriver*) override;
+
+private:
+    Query make_query(ParserDriver*);
 };
 
 class RelationalNode : public CompareNode {
@@ -277,6 +294,9 @@ public:
         values.emplace_back(right);
     }
     Query visit(ParserDriver*) override;
+
+private:
+    Query make_query(ParserDriver*);
 };
 
 class BetweenNode : public CompareNode {
@@ -305,6 +325,9 @@ public:
         values.emplace_back(right);
     }
     Query visit(ParserDriver*) override;
+
+private:
+    Query make_query(ParserDriver*);
 };
 
 class TrueOrFalseNode : public QueryNode {
@@ -348,7 +371,7 @@ class PathNode : public ParserNode {
 public:
     std::vector<std::string> path_elems;
 
-    LinkChain visit(ParserDriver*, util::Optional<ExpressionComparisonType> = util::none);
+    LinkChain visit(ParserDriver*, util::Optional<ExpressionComparisonType> = util::none) const;
     void add_element(const std::string& str)
     {
         path_elems.push_back(str);
@@ -514,10 +537,15 @@ public:
     Arguments& m_args;
     query_parser::KeyPathMapping m_mapping;
     ParserNodeStore m_parse_nodes;
-    void* m_yyscanner;
+    void* m_yyscanner = nullptr;
+    // Set by Table::prepare_query()
+    bool m_bind_placeholders = false;
 
     // Run the parser on file F.  Return 0 on success.
     int parse(const std::string& str);
+    // Build the query for the base table from `result` and `ordering`. This does not modify the nodes, so it can be
+    // done again with other arguments.
+    Query build();
 
     // Handling the scanner.
     void scan_begin(void*, bool trace_scanning);
@@ -535,6 +563,7 @@ public:
     template <class T>
     Query simple_query(int op, ColKey col_key, T val);
     std::pair<SubexprPtr, SubexprPtr> cmp(const std::vector<ExpressionNode*>& values);
+    Query bind_placeholder(Query&& query, const std::vector<ExpressionNode*>& values);
     SubexprPtr column(LinkChain&, std::string);
     void backlink(LinkChain&, const std::string&);
     std::string translate(LinkChain&, const std::string&);
@@ -550,6 +579,13 @@ private:
     static query_parser::KeyPathMapping s_default_mapping;
 };
 
+// The nodes of a parsed query string, kept by a QueryCache
+struct ParsedQuery {
+    ParserDriver::ParserNodeStore nodes;
+    QueryNode* result = nullptr;
+    DescriptorOrderingNode* ordering = nullptr;
+};
+
 template <class T>
 Query ParserDriver::simple_query(int op, ColKey col_key, T val, bool case_sensitive)
 {
@@ -1471,375 +1471,385 @@ namespace yy {
                                 { yylhs.value.as < QueryNode* > () = drv.m_parse_nodes.create<BetweenNode>(yystack_[2].value.as < ValueNode* > (), yystack_[0].value.as < ListNode* > ()); }
     break;
 
-  case 15: // expr: value
+  case 15: // compare: value "identifier" value
+                                {
+                                    if (!CompareNode::is_text_operator(yystack_[1].value.as < std::string > ())) {
+                                        error("syntax error, unexpected identifier '" + yystack_[1].value.as < std::string > () + "'");
+                                        YYERROR;
+                                    }
+                                    yylhs.value.as < QueryNode* > () = drv.m_parse_nodes.create<StringOpsNode>(yystack_[2].value.as < ValueNode* > (), CompareNode::TEXT, yystack_[0].value.as < ValueNode* > ());
+                                }
+    break;
+
+  case 16: // expr: value
                                 { yylhs.value.as < ExpressionNode* > () = yystack_[0].value.as < ValueNode* > (); }
     break;
 
-  case 16: // expr: '(' expr ')'
+  case 17: // expr: '(' expr ')'
                                 { yylhs.value.as < ExpressionNode* > () = yystack_[1].value.as < ExpressionNode* > (); }
     break;
 
-  case 17: // expr: expr '*' expr
+  case 18: // expr: expr '*' expr
                                 { yylhs.value.as < ExpressionNode* > () = drv.m_parse_nodes.create<OperationNode>(yystack_[2].value.as < ExpressionNode* > (), '*', yystack_[0].value.as < ExpressionNode* > ()); }
     break;
 
-  case 18: // expr: expr '/' expr
+  case 19: // expr: expr '/' expr
                                 { yylhs.value.as < ExpressionNode* > () = drv.m_parse_nodes.create<OperationNode>(yystack_[2].value.as < ExpressionNode* > (), '/', yystack_[0].value.as < ExpressionNode* > ()); }
     break;
 
-  case 19: // expr: expr '+' expr
+  case 20: // expr: expr '+' expr
                                 { yylhs.value.as < ExpressionNode* > () = drv.m_parse_nodes.create<OperationNode>(yystack_[2].value.as < ExpressionNode* > (), '+', yystack_[0].value.as < ExpressionNode* > ()); }
     break;
 
-  case 20: // expr: expr '-' expr
+  case 21: // expr: expr '-' expr
                                 { yylhs.value.as < ExpressionNode* > () = drv.m_parse_nodes.create<OperationNode>(yystack_[2].value.as < ExpressionNode* > (), '-', yystack_[0].value.as < ExpressionNode* > ()); }
     break;
 
-  case 21: // value: constant
+  case 22: // value: constant
                                 { yylhs.value.as < ValueNode* > () = drv.m_parse_nodes.create<ValueNode>(yystack_[0].value.as < ConstantNode* > ());}
     break;
 
-  case 22: // value: prop
+  case 23: // value: prop
                                 { yylhs.value.as < ValueNode* > () = drv.m_parse_nodes.create<ValueNode>(yystack_[0].value.as < PropertyNode* > ());}
     break;
 
-  case 23: // value: list
+  case 24: // value: list
                                 { yylhs.value.as < ValueNode* > () = drv.m_parse_nodes.create<ValueNode>(yystack_[0].value.as < ListNode* > ());}
     break;
 
-  case 24: // prop: path id post_op
+  case 25: // prop: path id post_op
                                 { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<PropNode>(yystack_[2].value.as < PathNode* > (), yystack_[1].value.as < std::string > (), yystack_[0].value.as < PostOpNode* > ()); }
     break;
 
-  case 25: // prop: path id '[' constant ']' post_op
+  case 26: // prop: path id '[' constant ']' post_op
                                        { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<PropNode>(yystack_[5].value.as < PathNode* > (), yystack_[4].value.as < std::string > (), yystack_[2].value.as < ConstantNode* > (), yystack_[0].value.as < PostOpNode* > ()); }
     break;
 
-  case 26: // prop: comp_type path id post_op
+  case 27: // prop: comp_type path id post_op
                                 { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<PropNode>(yystack_[2].value.as < PathNode* > (), yystack_[1].value.as < std::string > (), yystack_[0].value.as < PostOpNode* > (), ExpressionComparisonType(yystack_[3].value.as < int > ())); }
     break;
 
-  case 27: // prop: path "@links" post_op
+  case 28: // prop: path "@links" post_op
                                 { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<PropNode>(yystack_[2].value.as < PathNode* > (), "@links", yystack_[0].value.as < PostOpNode* > ()); }
     break;
 
-  case 28: // prop: path id '.' aggr_op '.' id
+  case 29: // prop: path id '.' aggr_op '.' id
                                     { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<LinkAggrNode>(yystack_[5].value.as < PathNode* > (), yystack_[4].value.as < std::string > (), yystack_[2].value.as < AggrNode* > (), yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 29: // prop: path id '.' aggr_op
+  case 30: // prop: path id '.' aggr_op
                                 { yylhs.value.as < PropertyNode* > () = drv.m_parse_nodes.create<ListAggrNode>(yystack_[3].value.as < PathNode* > (), yystack_[2].value.as < std::string > (), yystack_[0].value.as < AggrNode* > ()); }
     break;
 
-  case 30: // prop: subquery
+  case 31: // prop: subquery
                                 { yylhs.value.as < PropertyNode* > () = yystack_[0].value.as < SubqueryNode* > (); }
     break;
 
-  case 31: // simple_prop: path id
+  case 32: // simple_prop: path id
                                 { yylhs.value.as < PropNode* > () = drv.m_parse_nodes.create<PropNode>(yystack_[1].value.as < PathNode* > (), yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 32: // subquery: "subquery" '(' simple_prop ',' id ',' query ')' '.' "@size"
+  case 33: // subquery: "subquery" '(' simple_prop ',' id ',' query ')' '.' "@size"
                                                                { yylhs.value.as < SubqueryNode* > () = drv.m_parse_nodes.create<SubqueryNode>(yystack_[7].value.as < PropNode* > (), yystack_[5].value.as < std::string > (), yystack_[3].value.as < QueryNode* > ()); }
     break;
 
-  case 33: // post_query: %empty
+  case 34: // post_query: %empty
                                 { yylhs.value.as < DescriptorOrderingNode* > () = drv.m_parse_nodes.create<DescriptorOrderingNode>();}
     break;
 
-  case 34: // post_query: post_query sort
+  case 35: // post_query: post_query sort
                                 { yystack_[1].value.as < DescriptorOrderingNode* > ()->add_descriptor(yystack_[0].value.as < DescriptorNode* > ()); yylhs.value.as < DescriptorOrderingNode* > () = yystack_[1].value.as < DescriptorOrderingNode* > (); }
     break;
 
-  case 35: // post_query: post_query distinct
+  case 36: // post_query: post_query distinct
                                 { yystack_[1].value.as < DescriptorOrderingNode* > ()->add_descriptor(yystack_[0].value.as < DescriptorNode* > ()); yylhs.value.as < DescriptorOrderingNode* > () = yystack_[1].value.as < DescriptorOrderingNode* > (); }
     break;
 
-  case 36: // post_query: post_query limit
+  case 37: // post_query: post_query limit
                                 { yystack_[1].value.as < DescriptorOrderingNode* > ()->add_descriptor(yystack_[0].value.as < DescriptorNode* > ()); yylhs.value.as < DescriptorOrderingNode* > () = yystack_[1].value.as < DescriptorOrderingNode* > (); }
     break;
 
-  case 37: // distinct: "distinct" '(' distinct_param ')'
+  case 38: // distinct: "distinct" '(' distinct_param ')'
                                           { yylhs.value.as < DescriptorNode* > () = yystack_[1].value.as < DescriptorNode* > (); }
     break;
 
-  case 38: // distinct_param: path id
+  case 39: // distinct_param: path id
                                 { yylhs.value.as < DescriptorNode* > () = drv.m_parse_nodes.create<DescriptorNode>(DescriptorNode::DISTINCT); yylhs.value.as < DescriptorNode* > ()->add(yystack_[1].value.as < PathNode* > ()->path_elems, yystack_[0].value.as < std::string > ());}
     break;
 
-  case 39: // distinct_param: distinct_param ',' path id
+  case 40: // distinct_param: distinct_param ',' path id
                                  { yystack_[3].value.as < DescriptorNode* > ()->add(yystack_[1].value.as < PathNode* > ()->path_elems, yystack_[0].value.as < std::string > ()); yylhs.value.as < DescriptorNode* > () = yystack_[3].value.as < DescriptorNode* > (); }
     break;
 
-  case 40: // sort: "sort" '(' sort_param ')'
+  case 41: // sort: "sort" '(' sort_param ')'
                                  { yylhs.value.as < DescriptorNode* > () = yystack_[1].value.as < DescriptorNode* > (); }
     break;
 
-  case 41: // sort_param: path id direction
+  case 42: // sort_param: path id direction
                                 { yylhs.value.as < DescriptorNode* > () = drv.m_parse_nodes.create<DescriptorNode>(DescriptorNode::SORT); yylhs.value.as < DescriptorNode* > ()->add(yystack_[2].value.as < PathNode* > ()->path_elems, yystack_[1].value.as < std::string > (), yystack_[0].value.as < bool > ());}
     break;
 
-  case 42: // sort_param: sort_param ',' path id direction
+  case 43: // sort_param: sort_param ',' path id direction
                                         { yystack_[4].value.as < DescriptorNode* > ()->add(yystack_[2].value.as < PathNode* > ()->path_elems, yystack_[1].value.as < std::string > (), yystack_[0].value.as < bool > ()); yylhs.value.as < DescriptorNode* > () = yystack_[4].value.as < DescriptorNode* > (); }
     break;
 
-  case 43: // limit: "limit" '(' "natural0" ')'
+  case 44: // limit: "limit" '(' "natural0" ')'
                                 { yylhs.value.as < DescriptorNode* > () = drv.m_parse_nodes.create<DescriptorNode>(DescriptorNode::LIMIT, yystack_[1].value.as < std::string > ()); }
     break;
 
-  case 44: // direction: "ascending"
+  case 45: // direction: "ascending"
                                 { yylhs.value.as < bool > () = true; }
     break;
 
-  case 45: // direction: "descending"
+  case 46: // direction: "descending"
                                 { yylhs.value.as < bool > () = false; }
     break;
 
-  case 46: // list: '{' list_content '}'
+  case 47: // list: '{' list_content '}'
                                         { yylhs.value.as < ListNode* > () = yystack_[1].value.as < ListNode* > (); }
     break;
 
-  case 47: // list: comp_type '{' list_content '}'
+  case 48: // list: comp_type '{' list_content '}'
                                         { yystack_[1].value.as < ListNode* > ()->set_comp_type(ExpressionComparisonType(yystack_[3].value.as < int > ())); yylhs.value.as < ListNode* > () = yystack_[1].value.as < ListNode* > (); }
     break;
 
-  case 48: // list_content: constant
+  case 49: // list_content: constant
                                 { yylhs.value.as < ListNode* > () = drv.m_parse_nodes.create<ListNode>(yystack_[0].value.as < ConstantNode* > ()); }
     break;
 
-  case 49: // list_content: %empty
+  case 50: // list_content: %empty
                                 { yylhs.value.as < ListNode* > () = drv.m_parse_nodes.create<ListNode>(); }
     break;
 
-  case 50: // list_content: list_content ',' constant
+  case 51: // list_content: list_content ',' constant
                                 { yystack_[2].value.as < ListNode* > ()->add_element(yystack_[0].value.as < ConstantNode* > ()); yylhs.value.as < ListNode* > () = yystack_[2].value.as < ListNode* > (); }
     break;
 
-  case 51: // constant: "natural0"
+  case 52: // constant: "natural0"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::NUMBER, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 52: // constant: "number"
+  case 53: // constant: "number"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::NUMBER, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 53: // constant: "infinity"
+  case 54: // constant: "infinity"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::INFINITY_VAL, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 54: // constant: "NaN"
+  case 55: // constant: "NaN"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::NAN_VAL, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 55: // constant: "string"
+  case 56: // constant: "string"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::STRING, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 56: // constant: "base64"
+  case 57: // constant: "base64"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::BASE64, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 57: // constant: "float"
+  case 58: // constant: "float"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::FLOAT, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 58: // constant: "date"
+  case 59: // constant: "date"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::TIMESTAMP, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 59: // constant: "UUID"
+  case 60: // constant: "UUID"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::UUID_T, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 60: // constant: "ObjectId"
+  case 61: // constant: "ObjectId"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::OID, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 61: // constant: "link"
+  case 62: // constant: "link"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::LINK, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 62: // constant: "typed link"
+  case 63: // constant: "typed link"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::TYPED_LINK, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 63: // constant: "true"
+  case 64: // constant: "true"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::TRUE, ""); }
     break;
 
-  case 64: // constant: "false"
+  case 65: // constant: "false"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::FALSE, ""); }
     break;
 
-  case 65: // constant: "null"
+  case 66: // constant: "null"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::NULL_VAL, ""); }
     break;
 
-  case 66: // constant: "argument"
+  case 67: // constant: "argument"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ConstantNode::ARG, yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 67: // constant: comp_type "argument"
+  case 68: // constant: comp_type "argument"
                                 { yylhs.value.as < ConstantNode* > () = drv.m_parse_nodes.create<ConstantNode>(ExpressionComparisonType(yystack_[1].value.as < int > ()), yystack_[0].value.as < std::string > ()); }
     break;
 
-  case 68: // boolexpr: "truepredicate"
+  case 69: // boolexpr: "truepredicate"
                                 { yylhs.value.as < TrueOrFalseNode* > () = drv.m_parse_nodes.create<TrueOrFalseNode>(true); }
     break;
 
-  case 69: // boolexpr: "falsepredicate"
+  case 70: // boolexpr: "falsepredicate"
                                 { yylhs.value.as < TrueOrFalseNode* > () = drv.m_parse_nodes.create<TrueOrFalseNode>(false); }
     break;
 
-  case 70: // comp_type: "any"
+  case 71: // comp_type: "any"
                                 { yylhs.value.as < int > () = int(ExpressionComparisonType::Any); }
     break;
 
-  case 71: // comp_type: "all"
+  case 72: // comp_type: "all"
                                 { yylhs.value.as < int > () = int(ExpressionComparisonType::All); }
     break;
 
-  case 72: // comp_type: "none"
+  case 73: // comp_type: "none"
                                 { yylhs.value.as < int > () = int(ExpressionComparisonType::None); }
     break;
 
-  case 73: // post_op: %empty
+  case 74: // post_op: %empty
                                 { yylhs.value.as < PostOpNode* > () = nullptr; }
     break;
 
-  case 74: // post_op: '.' "@size"
+  case 75: // post_op: '.' "@size"
                                 { yylhs.value.as < PostOpNode* > () = drv.m_parse_nodes.create<PostOpNode>(yystack_[0].value.as < std::string > (), PostOpNode::SIZE);}
     break;
 
-  case 75: // post_op: '.' "@type"
+  case 76: // post_op: '.' "@type"
                                 { yylhs.value.as < PostOpNode* > () = drv.m_parse_nodes.create<PostOpNode>(yystack_[0].value.as < std::string > (), PostOpNode::TYPE);}
     break;
 
-  case 76: // aggr_op: "@max"
+  case 77: // aggr_op: "@max"
                                 { yylhs.value.as < AggrNode* > () = drv.m_parse_nodes.create<AggrNode>(AggrNode::MAX);}
     break;
 
-  case 77: // aggr_op: "@min"
+  case 78: // aggr_op: "@min"
                                 { yylhs.value.as < AggrNode* > () = drv.m_parse_nodes.create<AggrNode>(AggrNode::MIN);}
     break;
 
-  case 78: // aggr_op: "@sun"
+  case 79: // aggr_op: "@sun"
                                 { yylhs.value.as < AggrNode* > () = drv.m_parse_nodes.create<AggrNode>(AggrNode::SUM);}
     break;
 
-  case 79: // aggr_op: "@average"
+  case 80: // aggr_op: "@average"
                                 { yylhs.value.as < AggrNode* > () = drv.m_parse_nodes.create<AggrNode>(AggrNode::AVG);}
     break;
 
-  case 80: // equality: "=="
+  case 81: // equality: "=="
                                 { yylhs.value.as < int > () = CompareNode::EQUAL; }
     break;
 
-  case 81: // equality: "!="
+  case 82: // equality: "!="
                                 { yylhs.value.as < int > () = CompareNode::NOT_EQUAL; }
     break;
 
-  case 82: // equality: "in"
+  case 83: // equality: "in"
                                 { yylhs.value.as < int > () = CompareNode::IN; }
     break;
 
-  case 83: // relational: "<"
+  case 84: // relational: "<"
                                 { yylhs.value.as < int > () = CompareNode::LESS; }
     break;
 
-  case 84: // relational: "<="
+  case 85: // relational: "<="
                                 { yylhs.value.as < int > () = CompareNode::LESS_EQUAL; }
     break;
 
-  case 85: // relational: ">"
+  case 86: // relational: ">"
                                 { yylhs.value.as < int > () = CompareNode::GREATER; }
     break;
 
-  case 86: // relational: ">="
+  case 87: // relational: ">="
                                 { yylhs.value.as < int > () = CompareNode::GREATER_EQUAL; }
     break;
 
-  case 87: // stringop: "beginswith"
+  case 88: // stringop: "beginswith"
                                 { yylhs.value.as < int > () = CompareNode::BEGINSWITH; }
     break;
 
-  case 88: // stringop: "endswith"
+  case 89: // stringop: "endswith"
                                 { yylhs.value.as < int > () = CompareNode::ENDSWITH; }
     break;
 
-  case 89: // stringop: "contains"
+  case 90: // stringop: "contains"
                                 { yylhs.value.as < int > () = CompareNode::CONTAINS; }
     break;
 
-  case 90: // stringop: "like"
+  case 91: // stringop: "like"
                                 { yylhs.value.as < int > () = CompareNode::LIKE; }
     break;
 
-  case 91: // path: %empty
+  case 92: // path: %empty
                                 { yylhs.value.as < PathNode* > () = drv.m_parse_nodes.create<PathNode>(); }
     break;
 
-  case 92: // path: path path_elem
+  case 93: // path: path path_elem
                                 { yystack_[1].value.as < PathNode* > ()->add_element(yystack_[0].value.as < std::string > ()); yylhs.value.as < PathNode* > () = yystack_[1].value.as < PathNode* > (); }
     break;
 
-  case 93: // path_elem: id '.'
+  case 94: // path_elem: id '.'
                                 { yylhs.value.as < std::string > () = yystack_[1].value.as < std::string > (); }
     break;
 
-  case 94: // id: "identifier"
+  case 95: // id: "identifier"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 95: // id: "@links" '.' "identifier" '.' "identifier"
+  case 96: // id: "@links" '.' "identifier" '.' "identifier"
                                 { yylhs.value.as < std::string > () = std::string("@links.") + yystack_[2].value.as < std::string > () + "." + yystack_[0].value.as < std::string > (); }
     break;
 
-  case 96: // id: "beginswith"
+  case 97: // id: "beginswith"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 97: // id: "endswith"
+  case 98: // id: "endswith"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 98: // id: "contains"
+  case 99: // id: "contains"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 99: // id: "like"
+  case 100: // id: "like"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 100: // id: "between"
+  case 101: // id: "between"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 101: // id: "key or value"
+  case 102: // id: "key or value"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 102: // id: "sort"
+  case 103: // id: "sort"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 103: // id: "distinct"
+  case 104: // id: "distinct"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 104: // id: "limit"
+  case 105: // id: "limit"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 105: // id: "ascending"
+  case 106: // id: "ascending"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 106: // id: "descending"
+  case 107: // id: "descending"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
-  case 107: // id: "in"
+  case 108: // id: "in"
                                 { yylhs.value.as < std::string > () = yystack_[0].value.as < std::string > (); }
     break;
 
@@ -2191,166 +2201,162 @@ namespace yy {
   }
 
 
-  const signed char parser::yypact_ninf_ = -81;
+  const signed char parser::yypact_ninf_ = -83;
 
   const signed char parser::yytable_ninf_ = -1;
 
   const short
   parser::yypact_[] =
   {
-     130,   -81,   -81,   -39,   -81,   -81,   -81,   -81,   -81,   -81,
-     130,   -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,
-     -81,   -81,   -81,   -81,   130,   389,    27,   -13,   -81,    84,
-     136,   -81,   -81,   -81,   -81,   -81,     5,   307,   -81,   -81,
-     -16,    19,   -10,   -81,     2,   -81,   130,   130,    36,   -81,
-     -81,   -81,   -81,   -81,   -81,   -81,   206,   206,   206,   206,
-     168,   206,   -81,   -81,   -81,   -81,    23,   244,   -81,   389,
-     340,    15,   -81,   -81,   -81,   -81,   -81,   -81,   -81,   -81,
-     -81,   -81,   -81,   -81,   -81,   -81,     3,   -14,   340,   -81,
-     -81,   389,   -81,   -81,    29,     4,    22,    28,   -81,   -81,
-     -81,   206,   -23,   -81,   -23,   -81,   -81,   206,    58,    58,
-     -81,    41,   282,   -81,    39,    44,    46,    16,   -81,   389,
-      97,   -81,   340,    47,   -81,   -81,   -81,    79,    71,    58,
-     -81,   -81,    94,    37,   -81,    60,   -81,   -81,    62,   -81,
-     -81,   -81,   -81,    69,    80,   -81,   -42,   340,   -41,   340,
-      83,   124,    89,   340,   130,   -81,   -81,   -37,   -81,   -81,
-      47,   -81,   -81,    37,   -81,   -81,    -8,   340,   -81,   -81,
-     -81,   340,    90,   -37,    47,   103,   -81,   -81
+     103,   -83,   -83,   -50,   -83,   -83,   -83,   -83,   -83,   -83,
+     103,   -83,   -83,   -83,   -83,   -83,   -83,   -83,   -83,   -83,
+     -83,   -83,   -83,   -83,   103,   364,    14,    60,   -83,   258,
+      55,   -83,   -83,   -83,   -83,   -83,   -15,   282,   -83,   -83,
+      -7,    20,     5,   -83,     9,   -83,   103,   103,   -21,   -83,
+     -83,   -83,   -83,   -83,   -83,   -83,   181,   181,   181,   181,
+     143,   181,   257,   -83,   -83,   -83,   -83,    -5,   219,   -83,
+     364,   315,   -28,   -83,   -83,   -83,   -83,   -83,   -83,   -83,
+     -83,   -83,   -83,   -83,   -83,   -83,   -83,    52,   -45,   315,
+     -83,   -83,   364,   -83,   -83,    35,    11,    36,    45,   -83,
+     -83,   -83,   181,    87,   -83,    87,   -83,   -83,   181,    33,
+      33,   -83,   -83,    47,   257,   -83,    59,    16,    63,    12,
+     -83,   364,   132,   -83,   315,    65,   -83,   -83,   -83,    31,
+     109,    33,   -83,   -83,    91,    64,   -83,    67,   -83,   -83,
+      84,   -83,   -83,   -83,   -83,    94,    58,   -83,   -44,   315,
+      -3,   315,   110,   136,   127,   315,   103,   -83,   -83,     4,
+     -83,   -83,    65,   -83,   -83,    64,   -83,   -83,    -2,   315,
+     -83,   -83,   -83,   315,   128,     4,    65,   140,   -83,   -83
   };
 
   const signed char
   parser::yydefact_[] =
   {
-      91,    68,    69,     0,    63,    64,    65,    70,    71,    72,
-      91,    55,    56,    53,    54,    51,    52,    57,    58,    59,
-      60,    61,    62,    66,    91,    49,     0,    33,     3,     0,
-      15,    22,    30,    23,    21,     8,    91,     0,    91,     6,
-       0,     0,     0,    48,     0,     1,    91,    91,     2,    80,
-      81,    83,    85,    86,    84,    82,    91,    91,    91,    91,
-      91,    91,    87,    88,    89,    90,     0,    91,    67,    49,
-       0,    73,    94,    96,    97,    98,    99,   100,   107,   102,
-     103,   104,   105,   106,   101,    92,    73,     0,     0,     7,
-      16,     0,    46,     5,     4,     0,     0,     0,    35,    34,
-      36,    91,    19,    15,    20,    17,    18,    91,     9,    11,
-      14,     0,    91,    12,     0,     0,    73,     0,    27,     0,
-      93,    24,     0,    31,    50,    91,    91,     0,     0,    10,
-      13,    47,     0,    93,    26,     0,    74,    75,     0,    76,
-      77,    78,    79,    29,     0,    93,     0,     0,     0,     0,
-       0,     0,    73,     0,    91,    40,    91,     0,    37,    91,
-      38,    43,    95,     0,    25,    28,     0,     0,    44,    45,
-      41,     0,     0,     0,    39,     0,    42,    32
+      92,    69,    70,     0,    64,    65,    66,    71,    72,    73,
+      92,    56,    57,    54,    55,    52,    53,    58,    59,    60,
+      61,    62,    63,    67,    92,    50,     0,    34,     3,     0,
+      16,    23,    31,    24,    22,     8,    92,     0,    92,     6,
+       0,     0,     0,    49,     0,     1,    92,    92,     2,    81,
+      82,    84,    86,    87,    85,    83,    92,    92,    92,    92,
+      92,    92,    92,    88,    89,    90,    91,     0,    92,    68,
+      50,     0,    74,    95,    97,    98,    99,   100,   101,   108,
+     103,   104,   105,   106,   107,   102,    93,    74,     0,     0,
+       7,    17,     0,    47,     5,     4,     0,     0,     0,    36,
+      35,    37,    92,    20,    16,    21,    18,    19,    92,     9,
+      11,    15,    14,     0,    92,    12,     0,     0,    74,     0,
+      28,     0,    94,    25,     0,    32,    51,    92,    92,     0,
+       0,    10,    13,    48,     0,    94,    27,     0,    75,    76,
+       0,    77,    78,    79,    80,    30,     0,    94,     0,     0,
+       0,     0,     0,     0,    74,     0,    92,    41,    92,     0,
+      38,    92,    39,    44,    96,     0,    26,    29,     0,     0,
+      45,    46,    42,     0,     0,     0,    40,     0,    43,    33
   };
 
-  const signed char
+  const short
   parser::yypgoto_[] =
   {
-     -81,   -81,    -9,   -81,     1,     0,   -81,   -81,   -81,   -81,
-     -81,   -81,   -81,   -81,   -81,    -2,    91,   113,   -20,   -81,
-     -18,   -80,   -81,   -81,   -81,   -81,   -34,   -81,   -67
+     -83,   -83,    -9,   -83,   -16,     0,   -83,   -83,   -83,   -83,
+     -83,   -83,   -83,   -83,   -83,    18,   129,   124,   -18,   -83,
+     -19,   -82,   -83,   -83,   -83,   -83,   -34,   -83,   -68
   };
 
   const unsigned char
   parser::yydefgoto_[] =
   {
-       0,    26,    27,    28,    29,   103,    31,    87,    32,    48,
-      98,   148,    99,   146,   100,   170,    33,    42,    34,    35,
-      36,   118,   143,    60,    61,    67,    37,    85,    86
+       0,    26,    27,    28,    29,   104,    31,    88,    32,    48,
+      99,   150,   100,   148,   101,   172,    33,    42,    34,    35,
+      36,   120,   145,    60,    61,    68,    37,    86,    87
   };
 
   const unsigned char
   parser::yytable_[] =
   {
-      30,    39,    70,   116,    88,    43,   121,    44,    46,    47,
-      30,    46,    47,   168,   169,    40,    46,    47,   155,   158,
-      38,   123,   156,   159,    30,    41,   145,    45,    49,    50,
-      51,    52,    53,    54,    58,    59,   134,    93,    94,     7,
-       8,     9,    68,   135,    89,    68,    30,    30,   111,    43,
-     122,    44,   172,    46,    91,   144,    92,   102,   104,   105,
-     106,   108,   109,   125,   119,    55,   120,   113,   136,   137,
-      69,   124,   164,    44,    56,    57,    58,    59,   117,    90,
-     157,   126,   160,    95,    96,    97,   165,   127,    25,   136,
-     137,   147,   149,    49,    50,    51,    52,    53,    54,   138,
-     173,    44,   128,    91,   174,   131,    69,   132,   129,   133,
-     145,   150,   130,    56,    57,    58,    59,   139,   140,   141,
-     142,   135,   167,   151,   152,   171,    56,    57,    58,    59,
-      55,    90,   153,     1,     2,     3,     4,     5,     6,    56,
-      57,    58,    59,   161,   154,   166,     7,     8,     9,   136,
-     137,   162,   163,   175,    30,   177,    10,   110,    11,    12,
-      13,    14,    15,    16,    17,    18,    19,    20,    21,    22,
-      23,   176,     0,     3,     4,     5,     6,    62,    63,    64,
-      65,    66,   114,   107,     7,     8,     9,     0,     0,    24,
-       0,     0,     0,     0,     0,    25,    11,    12,    13,    14,
-      15,    16,    17,    18,    19,    20,    21,    22,    23,     0,
-       0,     3,     4,     5,     6,     0,     0,     0,     0,     0,
-       0,     0,     7,     8,     9,     0,     0,   101,     0,     0,
-       0,     0,     0,    25,    11,    12,    13,    14,    15,    16,
-      17,    18,    19,    20,    21,    22,    23,     0,     0,     3,
-       4,     5,     6,     0,     0,     0,     0,     0,     0,   112,
-       7,     8,     9,     0,     0,   101,     0,     0,     0,     0,
-       0,    25,    11,    12,    13,    14,    15,    16,    17,    18,
-      19,    20,    21,    22,    23,     0,     0,     3,     4,     5,
-       6,     0,     0,     0,     0,     0,     0,     0,     7,     8,
-       9,     0,     0,     0,     0,     0,     0,     0,     0,    25,
-      11,    12,    13,    14,    15,    16,    17,    18,    19,    20,
-      21,    22,    23,     0,     0,     0,    71,     0,     0,     0,
-       0,     0,     0,     0,    72,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    25,    73,    74,
-      75,    76,    77,    78,    79,    80,    81,    82,    83,   115,
-       0,    84,     0,     0,     0,     0,     0,    72,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,    73,    74,    75,    76,    77,    78,    79,    80,    81,
-      82,    83,     0,     0,    84,     4,     5,     6,     0,     0,
-       0,     0,     0,     0,     0,     7,     8,     9,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    11,    12,    13,
-      14,    15,    16,    17,    18,    19,    20,    21,    22,    23
+      30,    39,    71,   118,    89,   123,    44,    43,    41,    38,
+      30,     7,     8,     9,    45,    40,   157,    46,    47,   124,
+     158,   125,    46,    47,    30,    69,    96,    97,    98,    49,
+      50,    51,    52,    53,    54,   119,   136,    94,    95,   137,
+     103,   105,   106,   107,   109,   110,    30,    30,   113,    69,
+      70,    44,    43,    90,   170,   171,   146,   160,   174,    46,
+      25,   161,   111,   152,   138,   139,    55,   147,   115,    92,
+     127,    93,   166,    44,   126,    56,    57,    58,    59,   134,
+      91,   159,    62,   162,    46,    47,   130,   167,    56,    57,
+      58,    59,   131,   149,   151,   128,    63,    64,    65,    66,
+      67,   175,    44,   140,   129,   176,     1,     2,     3,     4,
+       5,     6,    70,   121,   132,   122,   138,   139,   137,     7,
+       8,     9,   156,    92,   169,   133,   135,   173,   147,    10,
+     153,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    58,    59,   154,   168,     3,     4,
+       5,     6,   141,   142,   143,   144,    30,   155,   108,     7,
+       8,     9,    24,   164,    56,    57,    58,    59,    25,    91,
+     163,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,   138,   139,     3,     4,     5,     6,
+     165,   177,   179,   178,   116,     0,   112,     7,     8,     9,
+       0,     0,   102,     0,     0,     0,     0,     0,    25,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,     0,     0,     3,     4,     5,     6,     0,     0,
+       0,     0,     0,     0,   114,     7,     8,     9,     0,     0,
+     102,     0,     0,     0,     0,     0,    25,    11,    12,    13,
+      14,    15,    16,    17,    18,    19,    20,    21,    22,    23,
+       0,     0,     3,     4,     5,     6,     0,    49,    50,    51,
+      52,    53,    54,     7,     8,     9,     0,     0,     0,     0,
+       0,     0,     0,     0,    25,    11,    12,    13,    14,    15,
+      16,    17,    18,    19,    20,    21,    22,    23,     0,     0,
+       0,    72,     0,     0,    55,     0,     0,     0,     0,    73,
+       0,     0,     0,    56,    57,    58,    59,     0,     0,     0,
+       0,     0,    25,    74,    75,    76,    77,    78,    79,    80,
+      81,    82,    83,    84,   117,     0,    85,     0,     0,     0,
+       0,     0,    73,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,    74,    75,    76,    77,
+      78,    79,    80,    81,    82,    83,    84,     0,     0,    85,
+       4,     5,     6,     0,     0,     0,     0,     0,     0,     0,
+       7,     8,     9,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    21,    22,    23
   };
 
   const short
   parser::yycheck_[] =
   {
-       0,    10,    36,    70,    38,    25,    86,    25,    24,    25,
-      10,    24,    25,    50,    51,    24,    24,    25,    60,    60,
-      59,    88,    64,    64,    24,    24,    63,     0,     9,    10,
-      11,    12,    13,    14,    57,    58,   116,    46,    47,    16,
-      17,    18,    40,    27,    60,    40,    46,    47,    66,    69,
-      64,    69,    60,    24,    64,   122,    66,    56,    57,    58,
-      59,    60,    61,    59,    61,    46,    63,    67,    52,    53,
-      65,    91,   152,    91,    55,    56,    57,    58,    63,    60,
-     147,    59,   149,    47,    48,    49,   153,    59,    65,    52,
-      53,   125,   126,     9,    10,    11,    12,    13,    14,   119,
-     167,   119,   101,    64,   171,    66,    65,    63,   107,    63,
-      63,    32,   112,    55,    56,    57,    58,    20,    21,    22,
-      23,    27,   156,    63,    62,   159,    55,    56,    57,    58,
-      46,    60,    63,     3,     4,     5,     6,     7,     8,    55,
-      56,    57,    58,    60,    64,   154,    16,    17,    18,    52,
-      53,    27,    63,    63,   154,    52,    26,    66,    28,    29,
-      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
-      40,   173,    -1,     5,     6,     7,     8,    41,    42,    43,
-      44,    45,    69,    15,    16,    17,    18,    -1,    -1,    59,
-      -1,    -1,    -1,    -1,    -1,    65,    28,    29,    30,    31,
-      32,    33,    34,    35,    36,    37,    38,    39,    40,    -1,
-      -1,     5,     6,     7,     8,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    16,    17,    18,    -1,    -1,    59,    -1,    -1,
-      -1,    -1,    -1,    65,    28,    29,    30,    31,    32,    33,
-      34,    35,    36,    37,    38,    39,    40,    -1,    -1,     5,
-       6,     7,     8,    -1,    -1,    -1,    -1,    -1,    -1,    15,
-      16,    17,    18,    -1,    -1,    59,    -1,    -1,    -1,    -1,
-      -1,    65,    28,    29,    30,    31,    32,    33,    34,    35,
-      36,    37,    38,    39,    40,    -1,    -1,     5,     6,     7,
-       8,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    16,    17,
-      18,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    65,
-      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
-      38,    39,    40,    -1,    -1,    -1,    19,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    27,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    65,    41,    42,
-      43,    44,    45,    46,    47,    48,    49,    50,    51,    19,
-      -1,    54,    -1,    -1,    -1,    -1,    -1,    27,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    41,    42,    43,    44,    45,    46,    47,    48,    49,
-      50,    51,    -1,    -1,    54,     6,     7,     8,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    16,    17,    18,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    28,    29,    30,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40
+       0,    10,    36,    71,    38,    87,    25,    25,    24,    59,
+      10,    16,    17,    18,     0,    24,    60,    24,    25,    64,
+      64,    89,    24,    25,    24,    40,    47,    48,    49,     9,
+      10,    11,    12,    13,    14,    63,   118,    46,    47,    27,
+      56,    57,    58,    59,    60,    61,    46,    47,    67,    40,
+      65,    70,    70,    60,    50,    51,   124,    60,    60,    24,
+      65,    64,    62,    32,    52,    53,    46,    63,    68,    64,
+      59,    66,   154,    92,    92,    55,    56,    57,    58,    63,
+      60,   149,    27,   151,    24,    25,   102,   155,    55,    56,
+      57,    58,   108,   127,   128,    59,    41,    42,    43,    44,
+      45,   169,   121,   121,    59,   173,     3,     4,     5,     6,
+       7,     8,    65,    61,   114,    63,    52,    53,    27,    16,
+      17,    18,    64,    64,   158,    66,    63,   161,    63,    26,
+      63,    28,    29,    30,    31,    32,    33,    34,    35,    36,
+      37,    38,    39,    40,    57,    58,    62,   156,     5,     6,
+       7,     8,    20,    21,    22,    23,   156,    63,    15,    16,
+      17,    18,    59,    27,    55,    56,    57,    58,    65,    60,
+      60,    28,    29,    30,    31,    32,    33,    34,    35,    36,
+      37,    38,    39,    40,    52,    53,     5,     6,     7,     8,
+      63,    63,    52,   175,    70,    -1,    67,    16,    17,    18,
+      -1,    -1,    59,    -1,    -1,    -1,    -1,    -1,    65,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    -1,    -1,     5,     6,     7,     8,    -1,    -1,
+      -1,    -1,    -1,    -1,    15,    16,    17,    18,    -1,    -1,
+      59,    -1,    -1,    -1,    -1,    -1,    65,    28,    29,    30,
+      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
+      -1,    -1,     5,     6,     7,     8,    -1,     9,    10,    11,
+      12,    13,    14,    16,    17,    18,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    65,    28,    29,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    39,    40,    -1,    -1,
+      -1,    19,    -1,    -1,    46,    -1,    -1,    -1,    -1,    27,
+      -1,    -1,    -1,    55,    56,    57,    58,    -1,    -1,    -1,
+      -1,    -1,    65,    41,    42,    43,    44,    45,    46,    47,
+      48,    49,    50,    51,    19,    -1,    54,    -1,    -1,    -1,
+      -1,    -1,    27,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    -1,    -1,    54,
+       6,     7,     8,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      16,    17,    18,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    28,    29,    30,    31,    32,    33,    34,    35,
+      36,    37,    38,    39,    40
   };
 
   const signed char
@@ -2362,50 +2368,50 @@ namespace yy {
       72,    73,    75,    83,    85,    86,    87,    93,    59,    69,
       69,    71,    84,    85,    87,     0,    24,    25,    76,     9,
       10,    11,    12,    13,    14,    46,    55,    56,    57,    58,
-      90,    91,    41,    42,    43,    44,    45,    92,    40,    65,
-      93,    19,    27,    41,    42,    43,    44,    45,    46,    47,
-      48,    49,    50,    51,    54,    94,    95,    74,    93,    60,
-      60,    64,    66,    69,    69,    47,    48,    49,    77,    79,
-      81,    59,    71,    72,    71,    71,    71,    15,    71,    71,
-      83,    87,    15,    72,    84,    19,    95,    63,    88,    61,
-      63,    88,    64,    95,    85,    59,    59,    59,    71,    71,
-      72,    66,    63,    63,    88,    27,    52,    53,    85,    20,
-      21,    22,    23,    89,    95,    63,    80,    93,    78,    93,
-      32,    63,    62,    63,    64,    60,    64,    95,    60,    64,
-      95,    60,    27,    63,    88,    95,    69,    93,    50,    51,
-      82,    93,    60,    95,    95,    63,    82,    52
+      90,    91,    27,    41,    42,    43,    44,    45,    92,    40,
+      65,    93,    19,    27,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    51,    54,    94,    95,    74,    93,
+      60,    60,    64,    66,    69,    69,    47,    48,    49,    77,
+      79,    81,    59,    71,    72,    71,    71,    71,    15,    71,
+      71,    72,    83,    87,    15,    72,    84,    19,    95,    63,
+      88,    61,    63,    88,    64,    95,    85,    59,    59,    59,
+      71,    71,    72,    66,    63,    63,    88,    27,    52,    53,
+      85,    20,    21,    22,    23,    89,    95,    63,    80,    93,
+      78,    93,    32,    63,    62,    63,    64,    60,    64,    95,
+      60,    64,    95,    60,    27,    63,    88,    95,    69,    93,
+      50,    51,    82,    93,    60,    95,    95,    63,    82,    52
   };
 
   const signed char
   parser::yyr1_[] =
   {
        0,    67,    68,    69,    69,    69,    69,    69,    69,    70,
-      70,    70,    70,    70,    70,    71,    71,    71,    71,    71,
-      71,    72,    72,    72,    73,    73,    73,    73,    73,    73,
-      73,    74,    75,    76,    76,    76,    76,    77,    78,    78,
-      79,    80,    80,    81,    82,    82,    83,    83,    84,    84,
-      84,    85,    85,    85,    85,    85,    85,    85,    85,    85,
-      85,    85,    85,    85,    85,    85,    85,    85,    86,    86,
-      87,    87,    87,    88,    88,    88,    89,    89,    89,    89,
-      90,    90,    90,    91,    91,    91,    91,    92,    92,    92,
-      92,    93,    93,    94,    95,    95,    95,    95,    95,    95,
-      95,    95,    95,    95,    95,    95,    95,    95
+      70,    70,    70,    70,    70,    70,    71,    71,    71,    71,
+      71,    71,    72,    72,    72,    73,    73,    73,    73,    73,
+      73,    73,    74,    75,    76,    76,    76,    76,    77,    78,
+      78,    79,    80,    80,    81,    82,    82,    83,    83,    84,
+      84,    84,    85,    85,    85,    85,    85,    85,    85,    85,
+      85,    85,    85,    85,    85,    85,    85,    85,    85,    86,
+      86,    87,    87,    87,    88,    88,    88,    89,    89,    89,
+      89,    90,    90,    90,    91,    91,    91,    91,    92,    92,
+      92,    92,    93,    93,    94,    95,    95,    95,    95,    95,
+      95,    95,    95,    95,    95,    95,    95,    95,    95
   };
 
   const signed char
   parser::yyr2_[] =
   {
        0,     2,     2,     1,     3,     3,     2,     3,     1,     3,
-       4,     3,     3,     4,     3,     1,     3,     3,     3,     3,
-       3,     1,     1,     1,     3,     6,     4,     3,     6,     4,
-       1,     2,    10,     0,     2,     2,     2,     4,     2,     4,
-       4,     3,     5,     4,     1,     1,     3,     4,     1,     0,
-       3,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     2,     1,     1,
-       1,     1,     1,     0,     2,     2,     1,     1,     1,     1,
+       4,     3,     3,     4,     3,     3,     1,     3,     3,     3,
+       3,     3,     1,     1,     1,     3,     6,     4,     3,     6,
+       4,     1,     2,    10,     0,     2,     2,     2,     4,     2,
+       4,     4,     3,     5,     4,     1,     1,     3,     4,     1,
+       0,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     2,     1,
+       1,     1,     1,     1,     0,     2,     2,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     0,     2,     2,     1,     5,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1
+       1,     1,     0,     2,     2,     1,     5,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1
   };
 
 
@@ -2442,16 +2448,16 @@ namespace yy {
   parser::yyrline_[] =
   {
        0,   148,   148,   151,   152,   153,   154,   155,   156,   159,
-     160,   165,   166,   167,   172,   175,   176,   177,   178,   179,
-     180,   183,   184,   185,   188,   189,   190,   191,   192,   193,
-     194,   197,   200,   203,   204,   205,   206,   208,   211,   212,
-     214,   217,   218,   220,   223,   224,   226,   227,   230,   231,
-     232,   235,   236,   237,   238,   239,   240,   241,   242,   243,
-     244,   245,   246,   247,   248,   249,   250,   251,   255,   256,
-     259,   260,   261,   264,   265,   266,   269,   270,   271,   272,
-     275,   276,   277,   280,   281,   282,   283,   286,   287,   288,
-     289,   292,   293,   296,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312
+     160,   165,   166,   167,   172,   173,   182,   183,   184,   185,
+     186,   187,   190,   191,   192,   195,   196,   197,   198,   199,
+     200,   201,   204,   207,   210,   211,   212,   213,   215,   218,
+     219,   221,   224,   225,   227,   230,   231,   233,   234,   237,
+     238,   239,   242,   243,   244,   245,   246,   247,   248,   249,
+     250,   251,   252,   253,   254,   255,   256,   257,   258,   262,
+     263,   266,   267,   268,   271,   272,   273,   276,   277,   278,
+     279,   282,   283,   284,   287,   288,   289,   290,   293,   294,
+     295,   296,   299,   300,   303,   306,   307,   308,   309,   310,
+     311,   312,   313,   314,   315,   316,   317,   318,   319
   };
 
   void
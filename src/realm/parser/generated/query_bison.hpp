@@ -2306,7 +2306,7 @@ switch (yykind)
     static const signed char yydefact_[];
 
     // YYPGOTO[NTERM-NUM].
-    static const signed char yypgoto_[];
+    static const short yypgoto_[];
 
     // YYDEFGOTO[NTERM-NUM].
     static const unsigned char yydefgoto_[];
@@ -2558,7 +2558,7 @@ switch (yykind)
     /// Constants.
     enum
     {
-      yylast_ = 429,     ///< Last index in yytable_.
+      yylast_ = 404,     ///< Last index in yytable_.
       yynnts_ = 29,  ///< Number of nonterminal symbols.
       yyfinal_ = 45 ///< Termination state number.
     };
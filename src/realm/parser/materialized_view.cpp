@@ -0,0 +1,508 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/parser/materialized_view.hpp>
+
+#include <realm/impl/transact_log.hpp>
+#include <realm/list.hpp>
+#include <realm/replication.hpp>
+#include <realm/transaction.hpp>
+#include <realm/util/input_stream.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace realm {
+
+namespace {
+
+struct ViewColumns {
+    ColKey table;
+    ColKey query;
+    ColKey group_by;
+    ColKey aggregate;
+    ColKey aggregate_column;
+    ColKey keys;
+    ColKey group_keys;
+    ColKey group_counts;
+    ColKey group_values;
+    ColKey version;
+
+    explicit ViewColumns(const Table& views)
+        : table(views.get_column_key("table"))
+        , query(views.get_column_key("query"))
+        , group_by(views.get_column_key("group_by"))
+        , aggregate(views.get_column_key("aggregate"))
+        , aggregate_column(views.get_column_key("aggregate_column"))
+        , keys(views.get_column_key("keys"))
+        , group_keys(views.get_column_key("group_keys"))
+        , group_counts(views.get_column_key("group_counts"))
+        , group_values(views.get_column_key("group_values"))
+        , version(views.get_column_key("version"))
+    {
+    }
+};
+
+// The objects touched by a transaction, per table
+class ChangeCollector : public _impl::NullInstructionObserver {
+public:
+    struct TableChanges {
+        std::vector<ObjKey> objects;
+        bool schema_changed = false;
+    };
+    std::map<TableKey, TableChanges> tables;
+
+    bool select_table(TableKey key)
+    {
+        m_selected = &tables[key];
+        return true;
+    }
+    bool insert_group_level_table(TableKey key)
+    {
+        tables[key].schema_changed = true;
+        return true;
+    }
+    bool erase_class(TableKey key)
+    {
+        tables[key].schema_changed = true;
+        return true;
+    }
+    bool rename_class(TableKey key)
+    {
+        tables[key].schema_changed = true;
+        return true;
+    }
+
+    bool create_object(ObjKey key)
+    {
+        m_selected->objects.push_back(key);
+        return true;
+    }
+    bool remove_object(ObjKey key)
+    {
+        m_selected->objects.push_back(key);
+        return true;
+    }
+    bool modify_object(ColKey, ObjKey key)
+    {
+        m_selected->objects.push_back(key);
+        return true;
+    }
+    // A change to a collection is a change to the object owning it
+    bool select_collection(ColKey, ObjKey key)
+    {
+        m_selected->objects.push_back(key);
+        return true;
+    }
+
+    bool insert_column(ColKey)
+    {
+        m_selected->schema_changed = true;
+        return true;
+    }
+    bool erase_column(ColKey)
+    {
+        m_selected->schema_changed = true;
+        return true;
+    }
+    bool rename_column(ColKey)
+    {
+        m_selected->schema_changed = true;
+        return true;
+    }
+    bool set_link_type(ColKey)
+    {
+        m_selected->schema_changed = true;
+        return true;
+    }
+
+private:
+    TableChanges* m_selected = nullptr;
+};
+
+// The tables a query on `table` may read: the table itself and those reachable
+// from it over links in either direction
+std::vector<TableKey> get_dependencies(const Table& table)
+{
+    std::vector<TableKey> dependencies{table.get_key()};
+    std::vector<const Table*> pending{&table};
+    auto follow = [&](ConstTableRef target) {
+        if (target && std::find(dependencies.begin(), dependencies.end(), target->get_key()) == dependencies.end()) {
+            dependencies.push_back(target->get_key());
+            pending.push_back(target.unchecked_ptr());
+        }
+    };
+    while (!pending.empty()) {
+        const Table* current = pending.back();
+        pending.pop_back();
+        current->for_each_public_column([&](ColKey col) {
+            if (col.get_type() == col_type_Link || col.get_type() == col_type_LinkList)
+                follow(current->get_link_target(col));
+            return false;
+        });
+        current->for_each_backlink_column([&](ColKey col) {
+            follow(current->get_opposite_table(col));
+            return false;
+        });
+    }
+    return dependencies;
+}
+
+ColKey get_column(const Table& table, StringData name)
+{
+    ColKey col = table.get_column_key(name);
+    if (!col)
+        throw LogicError(LogicError::column_does_not_exist);
+    return col;
+}
+
+// A view is stamped with the version committed by the last transaction which
+// brought it up to date. An older stamp means that a commit was made by a DB
+// without views enabled.
+bool is_stale(const ViewColumns& cols, const Obj& view, const Transaction& tr)
+{
+    return view.get<Int>(cols.version) < int64_t(tr.get_version());
+}
+
+std::vector<MaterializedViews::GroupValue> compute_groups(const ViewColumns& cols, const Obj& view,
+                                                          const Table& table, const TableView& results)
+{
+    using Aggregate = MaterializedViews::Aggregate;
+    ColKey group_col = get_column(table, view.get<String>(cols.group_by));
+    auto aggregate = Aggregate(view.get<Int>(cols.aggregate));
+    ColKey value_col;
+    if (aggregate != Aggregate::count)
+        value_col = get_column(table, view.get<String>(cols.aggregate_column));
+
+    struct GroupState {
+        size_t count = 0;
+        size_t value_count = 0;
+        Mixed value;
+    };
+    std::map<Mixed, GroupState> groups;
+    for (size_t i = 0; i < results.size(); ++i) {
+        Obj obj = results.get_object(i);
+        auto& group = groups[obj.get_any(group_col)];
+        ++group.count;
+        if (!value_col)
+            continue;
+        Mixed value = obj.get_any(value_col);
+        if (value.is_null())
+            continue;
+        if (group.value_count++ == 0) {
+            group.value = value;
+            continue;
+        }
+        switch (aggregate) {
+            case Aggregate::sum:
+            case Aggregate::average:
+                group.value = group.value + value;
+                break;
+            case Aggregate::min:
+                if (value < group.value)
+                    group.value = value;
+                break;
+            case Aggregate::max:
+                if (group.value < value)
+                    group.value = value;
+                break;
+            case Aggregate::count:
+                break;
+        }
+    }
+
+    std::vector<MaterializedViews::GroupValue> result;
+    result.reserve(groups.size());
+    for (auto& [key, group] : groups) {
+        Mixed value = group.value;
+        if (aggregate == Aggregate::count) {
+            value = int64_t(group.count);
+        }
+        else if (aggregate == Aggregate::average && group.value_count) {
+            if (value.get_type() == type_Int)
+                value = double(value.get_int());
+            value = value / Mixed(int64_t(group.value_count));
+        }
+        result.push_back({key, group.count, value});
+    }
+    return result;
+}
+
+void evaluate(const ViewColumns& cols, Obj& view, const Table& table, const Query& query,
+              const DescriptorOrdering& ordering)
+{
+    TableView results = query.find_all(ordering); // Throws
+    auto keys = view.get_list<Int>(cols.keys);
+    keys.clear();
+    for (size_t i = 0; i < results.size(); ++i)
+        keys.add(results.get_key(i).value);
+    if (view.get<String>(cols.group_by).size() == 0)
+        return;
+
+    auto group_keys = view.get_list<Mixed>(cols.group_keys);
+    auto group_counts = view.get_list<Int>(cols.group_counts);
+    auto group_values = view.get_list<Mixed>(cols.group_values);
+    group_keys.clear();
+    group_counts.clear();
+    group_values.clear();
+    for (auto& group : compute_groups(cols, view, table, results)) { // Throws
+        group_keys.add(group.group);
+        group_counts.add(int64_t(group.count));
+        group_values.add(group.value);
+    }
+}
+
+// Reevaluates the query for the given objects only. The keys of a view
+// without ordering are in ascending order, as the objects are in the table.
+void apply_changes(const ViewColumns& cols, Obj& view, const Query& query, std::vector<ObjKey> changed)
+{
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    std::vector<ObjKey> matches = query.find_all_of(changed); // Throws
+
+    auto keys = view.get_list<Int>(cols.keys);
+    auto match = matches.begin();
+    for (auto key : changed) {
+        bool is_match = match != matches.end() && *match == key;
+        if (is_match)
+            ++match;
+        size_t begin = 0, end = keys.size();
+        while (begin < end) {
+            size_t mid = begin + (end - begin) / 2;
+            if (keys.get(mid) < key.value)
+                begin = mid + 1;
+            else
+                end = mid;
+        }
+        bool is_in_view = begin < keys.size() && keys.get(begin) == key.value;
+        if (is_match && !is_in_view)
+            keys.insert(begin, key.value);
+        else if (!is_match && is_in_view)
+            keys.remove(begin);
+    }
+}
+
+} // anonymous namespace
+
+void MaterializedViews::create(StringData name, const Spec& spec)
+{
+    TableRef views = m_tr.get_table(c_table_name);
+    if (!views) {
+        views = m_tr.add_table_with_primary_key(c_table_name, type_String, "name");
+        views->add_column(type_String, "table");
+        views->add_column(type_String, "query");
+        views->add_column(type_String, "group_by");
+        views->add_column(type_Int, "aggregate");
+        views->add_column(type_String, "aggregate_column");
+        views->add_column_list(type_Int, "keys");
+        views->add_column_list(type_Mixed, "group_keys", true);
+        views->add_column_list(type_Int, "group_counts");
+        views->add_column_list(type_Mixed, "group_values", true);
+        views->add_column(type_Int, "version");
+    }
+    if (views->find_primary_key(name))
+        throw KeyAlreadyUsed(util::format("Materialized view '%1' already exists", name));
+
+    TableRef table = m_tr.get_table(spec.table_name);
+    if (!table)
+        throw NoSuchTable();
+    Query query = table->query(spec.query_string); // Throws
+    auto ordering = query.get_ordering();
+
+    if (!spec.group_by.empty()) {
+        ColKey group_col = get_column(*table, spec.group_by);
+        if (group_col.is_collection() || group_col.get_type() == col_type_Link)
+            throw LogicError(LogicError::illegal_type);
+        if (spec.aggregate != Aggregate::count) {
+            ColKey value_col = get_column(*table, spec.aggregate_column);
+            if (value_col.is_collection() || value_col.get_type() == col_type_Link)
+                throw LogicError(LogicError::illegal_type);
+            bool numeric = value_col.get_type() == col_type_Int || value_col.get_type() == col_type_Float ||
+                           value_col.get_type() == col_type_Double || value_col.get_type() == col_type_Decimal ||
+                           value_col.get_type() == col_type_Mixed;
+            if (!numeric && (spec.aggregate == Aggregate::sum || spec.aggregate == Aggregate::average))
+                throw LogicError(LogicError::illegal_type);
+        }
+    }
+    else if (spec.aggregate != Aggregate::count || !spec.aggregate_column.empty()) {
+        throw LogicError(LogicError::illegal_combination);
+    }
+
+    ViewColumns cols(*views);
+    Obj view = views->create_object_with_primary_key(name);
+    view.set(cols.table, StringData(spec.table_name));
+    view.set(cols.query, StringData(spec.query_string));
+    view.set(cols.group_by, StringData(spec.group_by));
+    view.set(cols.aggregate, int64_t(spec.aggregate));
+    view.set(cols.aggregate_column, StringData(spec.aggregate_column));
+    view.set(cols.version, int64_t(m_tr.get_version() + 1));
+    evaluate(cols, view, *table, query, ordering ? *ordering : DescriptorOrdering()); // Throws
+}
+
+void MaterializedViews::enable(DBOptions& options)
+{
+    options.before_commit = [next = std::move(options.before_commit)](Transaction& tr) {
+        if (next)
+            next(tr); // Throws
+        // Checked here, so that commits to files without views do not parse
+        // the transaction log
+        if (tr.has_table(c_table_name))
+            MaterializedViews(tr).update(); // Throws
+    };
+}
+
+bool MaterializedViews::remove(StringData name)
+{
+    TableRef views = m_tr.get_table(c_table_name);
+    ObjKey key = views ? views->find_primary_key(name) : ObjKey();
+    if (!key)
+        return false;
+    views->remove_object(key);
+    return true;
+}
+
+bool MaterializedViews::exists(StringData name) const
+{
+    TableRef views = m_tr.get_table(c_table_name);
+    return views && views->find_primary_key(name);
+}
+
+std::vector<std::string> MaterializedViews::get_names() const
+{
+    std::vector<std::string> names;
+    if (TableRef views = m_tr.get_table(c_table_name)) {
+        for (auto& view : *views)
+            names.push_back(view.get_primary_key().get_string());
+    }
+    return names;
+}
+
+Obj MaterializedViews::get_view(StringData name) const
+{
+    if (TableRef views = m_tr.get_table(c_table_name)) {
+        if (ObjKey key = views->find_primary_key(name))
+            return views->get_object(key);
+    }
+    throw KeyNotFound(util::format("No materialized view named '%1'", name));
+}
+
+TableView MaterializedViews::get_results(StringData name) const
+{
+    Obj view = get_view(name);
+    ViewColumns cols(*view.get_table());
+    TableRef table = m_tr.get_table(view.get<String>(cols.table));
+    if (!table)
+        throw NoSuchTable();
+    Query query = table->query(std::string(view.get<String>(cols.query))); // Throws
+    auto ordering = query.get_ordering();
+    if (is_stale(cols, view, m_tr))
+        return query.find_all(ordering ? *ordering : DescriptorOrdering()); // Throws
+
+    auto stored_keys = view.get_list<Int>(cols.keys);
+    std::vector<ObjKey> keys;
+    keys.reserve(stored_keys.size());
+    for (auto key : stored_keys)
+        keys.emplace_back(key);
+    return TableView(query, keys, ordering ? *ordering : DescriptorOrdering());
+}
+
+std::vector<MaterializedViews::GroupValue> MaterializedViews::get_groups(StringData name) const
+{
+    Obj view = get_view(name);
+    ViewColumns cols(*view.get_table());
+    if (is_stale(cols, view, m_tr)) {
+        TableRef table = m_tr.get_table(view.get<String>(cols.table));
+        if (!table || view.get<String>(cols.group_by).size() == 0)
+            return {};
+        TableView results = get_results(name); // Throws
+        return compute_groups(cols, view, *table, results); // Throws
+    }
+
+    auto keys = view.get_list<Mixed>(cols.group_keys);
+    auto counts = view.get_list<Int>(cols.group_counts);
+    auto values = view.get_list<Mixed>(cols.group_values);
+    std::vector<GroupValue> groups;
+    groups.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        groups.push_back({keys.get(i), size_t(counts.get(i)), values.get(i)});
+    return groups;
+}
+
+void MaterializedViews::update()
+{
+    TableRef views = m_tr.get_table(c_table_name);
+    if (!views || views->is_empty())
+        return;
+
+    // Without a transaction log, every view has to be evaluated anew
+    ChangeCollector changes;
+    Replication* repl = m_tr.get_replication();
+    if (repl) {
+        util::SimpleInputStream in(repl->get_uncommitted_changes());
+        _impl::TransactLogParser parser;
+        parser.parse(in, changes); // Throws
+    }
+
+    ViewColumns cols(*views);
+    std::vector<ObjKey> view_keys;
+    for (auto& view : *views)
+        view_keys.push_back(view.get_key());
+
+    for (auto view_key : view_keys) {
+        Obj view = views->get_object(view_key);
+        bool stale = is_stale(cols, view, m_tr);
+        view.set(cols.version, int64_t(m_tr.get_version() + 1));
+        TableRef table = m_tr.get_table(view.get<String>(cols.table));
+        if (!table) {
+            // The table was removed
+            view.get_list<Int>(cols.keys).clear();
+            view.get_list<Mixed>(cols.group_keys).clear();
+            view.get_list<Int>(cols.group_counts).clear();
+            view.get_list<Mixed>(cols.group_values).clear();
+            continue;
+        }
+
+        bool changed_elsewhere = !repl || stale;
+        std::vector<ObjKey>* changed_objects = nullptr;
+        for (auto table_key : get_dependencies(*table)) {
+            auto it = changes.tables.find(table_key);
+            if (it == changes.tables.end())
+                continue;
+            if (table_key == table->get_key() && !it->second.schema_changed)
+                changed_objects = &it->second.objects;
+            else
+                changed_elsewhere = true;
+        }
+        if (!changed_elsewhere && !changed_objects)
+            continue;
+
+        Query query = table->query(std::string(view.get<String>(cols.query))); // Throws
+        auto ordering = query.get_ordering();
+        bool is_filter = (!ordering || ordering->is_empty()) && view.get<String>(cols.group_by).size() == 0;
+        // Evaluating the changed objects one by one is slower than a full
+        // evaluation once a large part of the table has changed
+        if (!changed_elsewhere && is_filter && changed_objects->size() < table->size() / 4) {
+            apply_changes(cols, view, query, *changed_objects); // Throws
+        }
+        else {
+            evaluate(cols, view, *table, query, ordering ? *ordering : DescriptorOrdering()); // Throws
+        }
+    }
+}
+
+} // namespace realm
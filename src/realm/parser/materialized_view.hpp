@@ -0,0 +1,120 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_PARSER_MATERIALIZED_VIEW_HPP
+#define REALM_PARSER_MATERIALIZED_VIEW_HPP
+
+#include <realm/db_options.hpp>
+#include <realm/mixed.hpp>
+#include <realm/table_view.hpp>
+
+#include <string>
+#include <vector>
+
+namespace realm {
+
+class Transaction;
+
+/// Named queries whose results are stored in the file, and brought up to date
+/// by every commit which changes what they depend on. Reading a view only
+/// reads the stored object keys, whatever the cost of the query, and a view
+/// created by one process can be read by all others using the file.
+///
+/// A view whose query is a plain filter is maintained incrementally: a commit
+/// evaluates the query only for the objects it created, modified or removed in
+/// the table of the view. Views with SORT, DISTINCT, LIMIT or groups, and
+/// views affected by changes to a table linked to or from their table, are
+/// evaluated anew by the commit. Commits which leave those tables alone leave
+/// the view alone.
+///
+/// Views are only maintained by commits made through a DB opened with options
+/// passed to enable(). Should a commit be made without, the first commit with
+/// views enabled evaluates every view anew, and until then get_results() and
+/// get_groups() run the query instead of reading the stored results.
+///
+/// The definitions and results are kept in a table which is not a class, so
+/// they are neither part of the schema seen by the object store nor synced.
+class MaterializedViews {
+public:
+    enum class Aggregate { count, sum, min, max, average };
+
+    struct Spec {
+        std::string table_name;
+        /// In the query language, and may end with SORT, DISTINCT and LIMIT
+        std::string query_string;
+        /// If not empty, the objects of the view are grouped by the value of
+        /// this column, and `aggregate` is kept for every group.
+        std::string group_by;
+        Aggregate aggregate = Aggregate::count;
+        /// The column aggregated by anything but count. Null values are not
+        /// included.
+        std::string aggregate_column;
+    };
+
+    struct GroupValue {
+        Mixed group;
+        size_t count;
+        /// The count as an Int for Aggregate::count, else null if no object
+        /// in the group has a value.
+        Mixed value;
+    };
+
+    static constexpr const char* c_table_name = "materialized_views";
+
+    /// Makes commits by a DB opened with `options` bring the views up to date,
+    /// through DBOptions::before_commit. A hook already set there is kept, and
+    /// called first.
+    static void enable(DBOptions& options);
+
+    explicit MaterializedViews(Transaction& tr) noexcept
+        : m_tr(tr)
+    {
+    }
+
+    /// Must be called in a write transaction. The view is evaluated right
+    /// away, which also validates the query. Throws KeyAlreadyUsed if there is
+    /// a view named `name`.
+    void create(StringData name, const Spec& spec);
+    /// Returns false if there is no view named `name`
+    bool remove(StringData name);
+    bool exists(StringData name) const;
+    std::vector<std::string> get_names() const;
+
+    /// The objects of the view, as of the version of the transaction. The view
+    /// can be brought up to date by TableView::sync_if_needed() like any
+    /// other, which runs the query. Throws KeyNotFound if there is no such
+    /// view.
+    TableView get_results(StringData name) const;
+    /// The groups of a view with `group_by`, ordered by the value grouped by.
+    /// String values refer to the file and are valid until the transaction
+    /// advances.
+    std::vector<GroupValue> get_groups(StringData name) const;
+
+    /// Brings the views up to date with the changes made in the current write
+    /// transaction. Called before every commit once enable() has been used.
+    void update();
+
+private:
+    Transaction& m_tr;
+
+    Obj get_view(StringData name) const;
+};
+
+} // namespace realm
+
+#endif // REALM_PARSER_MATERIALIZED_VIEW_HPP
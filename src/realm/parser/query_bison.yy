@@ -170,6 +170,13 @@ compare
                                     $$ = tmp;
                                 }
     | value BETWEEN list        { $$ = drv.m_parse_nodes.create<BetweenNode>($1, $3); }
+    | value ID value            {
+                                    if (!CompareNode::is_text_operator($2)) {
+                                        error("syntax error, unexpected identifier '" + $2 + "'");
+                                        YYERROR;
+                                    }
+                                    $$ = drv.m_parse_nodes.create<StringOpsNode>($1, CompareNode::TEXT, $3);
+                                }
 
 expr
     : value                     { $$ = $1; }
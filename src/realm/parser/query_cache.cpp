@@ -0,0 +1,102 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/parser/query_cache.hpp>
+#include <realm/parser/driver.hpp>
+
+using namespace realm;
+using namespace realm::query_parser;
+
+QueryCache::QueryCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+QueryCache::~QueryCache() = default;
+
+size_t QueryCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t QueryCache::get_hit_count() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_hits;
+}
+
+size_t QueryCache::get_miss_count() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_misses;
+}
+
+void QueryCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+std::shared_ptr<const ParsedQuery> QueryCache::get(const std::string& query_string)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_index.find(query_string); it != m_index.end()) {
+            ++m_hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->parsed;
+        }
+        ++m_misses;
+    }
+
+    // Parsing is the slow part, so other threads are not held up by it
+    ParserDriver driver;
+    driver.parse(query_string); // Throws
+    auto parsed = std::make_shared<ParsedQuery>();
+    parsed->nodes = std::move(driver.m_parse_nodes);
+    parsed->result = driver.result;
+    parsed->ordering = driver.ordering;
+
+    std::lock_guard lock(m_mutex);
+    // Another thread may have parsed the same string meanwhile
+    if (m_index.count(query_string) == 0) {
+        if (m_entries.size() == m_capacity) {
+            m_index.erase(m_entries.back().query_string);
+            m_entries.pop_back();
+        }
+        m_entries.push_front({query_string, parsed});
+        m_index.emplace(m_entries.front().query_string, m_entries.begin());
+    }
+    return parsed;
+}
+
+Query QueryCache::query(ConstTableRef table, const std::string& query_string, Arguments& args,
+                        const KeyPathMapping& mapping)
+{
+    if (m_capacity == 0)
+        return table->query(query_string, args, mapping);
+
+    // The nodes are not modified when building the query, so they can be used by several threads at once
+    auto parsed = get(query_string); // Throws
+    ParserDriver driver(table.cast_away_const(), args, mapping);
+    driver.result = parsed->result;
+    driver.ordering = parsed->ordering;
+    return driver.build();
+}
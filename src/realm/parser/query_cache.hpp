@@ -0,0 +1,101 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_PARSER_QUERY_CACHE_HPP
+#define REALM_PARSER_QUERY_CACHE_HPP
+
+#include <realm/parser/keypath_mapping.hpp>
+#include <realm/parser/query_parser.hpp>
+#include <realm/query.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace realm::query_parser {
+
+struct ParsedQuery;
+
+/// Keeps the most recently used query strings in parsed form, so that queries
+/// which only differ in their arguments are only parsed once.
+///
+/// The parsed form of a query string does not depend on the table, the
+/// arguments or the key path mapping. These are only looked at when the query
+/// is built from it, which happens on every call to query(), so the result is
+/// the same as with Table::query(). In particular the arguments are bound anew
+/// every time, and a query string is only cached once it has parsed without
+/// errors.
+///
+/// A QueryCache may be used from multiple threads, e.g. when shared by the
+/// users of a frozen Realm.
+class QueryCache {
+public:
+    static constexpr size_t default_capacity = 256;
+
+    /// A `capacity` of 0 disables caching.
+    explicit QueryCache(size_t capacity = default_capacity);
+    ~QueryCache();
+
+    QueryCache(const QueryCache&) = delete;
+    QueryCache& operator=(const QueryCache&) = delete;
+
+    /// Same as `table->query(query_string, args, mapping)`.
+    Query query(ConstTableRef table, const std::string& query_string, Arguments& args,
+                const KeyPathMapping& mapping = {});
+    Query query(ConstTableRef table, const std::string& query_string, const std::vector<Mixed>& args = {},
+                const KeyPathMapping& mapping = {});
+
+    size_t size() const;
+    size_t get_capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    /// The number of calls to query() which found the query string in the
+    /// cache, and which had to parse it.
+    size_t get_hit_count() const;
+    size_t get_miss_count() const;
+
+    void clear();
+
+private:
+    struct Entry {
+        std::string query_string;
+        // Shared with the threads which are building a query from it while it
+        // is evicted
+        std::shared_ptr<const ParsedQuery> parsed;
+    };
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    // Most recently used first
+    std::list<Entry> m_entries;
+    // Keyed by the query strings of the entries
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+
+    std::shared_ptr<const ParsedQuery> get(const std::string& query_string);
+};
+
+} // namespace realm::query_parser
+
+#endif // REALM_PARSER_QUERY_CACHE_HPP
@@ -28,8 +28,11 @@
 #include <realm/table_tpl.hpp>
 #include <realm/set.hpp>
 #include <realm/array_integer_tpl.hpp>
+#include <realm/metrics/latency.hpp>
+#include <realm/util/thread_pool.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 
 using namespace realm;
@@ -90,6 +93,9 @@ Query::Query(const Query& source)
     , m_groups(source.m_groups)
     , m_table(source.m_table)
     , m_ordering(source.m_ordering)
+    , m_max_threads(source.m_max_threads)
+    , m_cancellation(source.m_cancellation)
+    , m_cost_sample(source.m_cost_sample)
 {
     if (source.m_owned_source_table_view) {
         m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -114,6 +120,9 @@ Query& Query::operator=(const Query& source)
     if (this != &source) {
         m_groups = source.m_groups;
         m_table = source.m_table;
+        m_max_threads = source.m_max_threads;
+        m_cancellation = source.m_cancellation;
+        m_cost_sample = source.m_cost_sample;
 
         if (source.m_owned_source_table_view) {
             m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -161,6 +170,8 @@ Query::Query(const Query* source, Transaction* tr, PayloadPolicy policy)
         REALM_ASSERT_DEBUG(m_view);
     }
     m_groups = source->m_groups;
+    m_max_threads = source->m_max_threads;
+    m_cancellation = source->m_cancellation;
     if (source->m_table)
         set_table(tr->import_copy_of(source->m_table));
     // otherwise: empty query.
@@ -186,6 +197,7 @@ void Query::set_table(TableRef tr)
     }
 
     m_table = tr;
+    m_cost_sample.reset();
     if (m_table) {
         ParentNode* root = root_node();
         if (root)
@@ -269,6 +281,16 @@ REALM_NOINLINE REALM_COLD REALM_NORETURN void throw_type_mismatch_error()
     throw LogicError{LogicError::type_mismatch};
 }
 
+void check_geo_columns(const Table& table, ColKey latitude, ColKey longitude)
+{
+    table.check_column(latitude);
+    table.check_column(longitude);
+    for (auto col : {latitude, longitude}) {
+        if (col.get_type() != col_type_Double || col.is_collection())
+            throw_type_mismatch_error();
+    }
+}
+
 template <class Node>
 struct MakeConditionNode {
     static std::unique_ptr<ParentNode> make(ColKey col_key, typename Node::TConditionValue value)
@@ -548,6 +570,14 @@ Query& Query::links_to(ColKey origin_column, const std::vector<ObjKey>& target_k
     return *this;
 }
 
+Query& Query::modified_since(uint64_t version)
+{
+    ColKey col_key = m_table->get_modification_version_column();
+    if (!col_key)
+        throw LogicError(LogicError::illegal_combination);
+    return greater(col_key, int64_t(version));
+}
+
 // int64 constant vs column
 Query& Query::equal(ColKey column_key, int64_t value)
 {
@@ -918,6 +948,28 @@ Query& Query::contains(ColKey column_key, StringData value, bool case_sensitive)
         add_condition<ContainsIns>(column_key, value);
     return *this;
 }
+Query& Query::fulltext(ColKey column_key, StringData text)
+{
+    m_table->check_column(column_key);
+    if (column_key.get_type() != col_type_String || column_key.is_collection())
+        throw_type_mismatch_error();
+    add_node(std::unique_ptr<ParentNode>(new FulltextNode(text, column_key)));
+    return *this;
+}
+Query& Query::geo_within(ColKey latitude, ColKey longitude, const GeoBox& box)
+{
+    check_geo_columns(*m_table, latitude, longitude);
+    add_node(std::unique_ptr<ParentNode>(new GeoWithinNode(latitude, longitude, box)));
+    return *this;
+}
+Query& Query::geo_within(ColKey latitude, ColKey longitude, const GeoCircle& circle)
+{
+    check_geo_columns(*m_table, latitude, longitude);
+    if (!(circle.radius_km >= 0))
+        throw std::runtime_error(util::format("Invalid radius %1 in geo_within()", circle.radius_km));
+    add_node(std::unique_ptr<ParentNode>(new GeoWithinNode(latitude, longitude, circle)));
+    return *this;
+}
 Query& Query::not_equal(ColKey column_key, StringData value, bool case_sensitive)
 {
     if (case_sensitive)
@@ -938,6 +990,53 @@ Query& Query::like(ColKey column_key, StringData value, bool case_sensitive)
 
 // Aggregates =================================================================================
 
+namespace {
+// The conditions in the top level AND group that are evaluated using a search index are combined by intersecting
+// their matches. The conditions are then removed from pn->m_children, as the resulting keys need not be tested
+// against them any more.
+std::vector<ObjKey> take_index_based_keys(ParentNode* pn)
+{
+    std::vector<std::vector<ObjKey>> matches;
+    for (size_t c = 0; c < pn->m_children.size();) {
+        ParentNode* node = pn->m_children[c];
+        if (!node->has_search_index()) {
+            ++c;
+            continue;
+        }
+        matches.push_back(node->index_based_keys());
+        pn->m_children[c] = pn->m_children.back();
+        pn->m_children.pop_back();
+    }
+    REALM_ASSERT(!matches.empty());
+
+    std::sort(matches.begin(), matches.end(), [](auto& a, auto& b) {
+        return a.size() < b.size();
+    });
+    std::vector<ObjKey> keys = std::move(matches.front());
+    if (matches.size() > 1 && !std::is_sorted(keys.begin(), keys.end()))
+        std::sort(keys.begin(), keys.end());
+    for (size_t i = 1; i < matches.size() && !keys.empty(); ++i) {
+        auto& other = matches[i];
+        if (!std::is_sorted(other.begin(), other.end()))
+            std::sort(other.begin(), other.end());
+        if (keys.size() * 16 < other.size()) {
+            // Much fewer candidates than matches of this condition, so look each of them up
+            keys.erase(std::remove_if(keys.begin(), keys.end(),
+                                      [&](ObjKey key) {
+                                          return !std::binary_search(other.begin(), other.end(), key);
+                                      }),
+                       keys.end());
+        }
+        else {
+            std::vector<ObjKey> common;
+            std::set_intersection(keys.begin(), keys.end(), other.begin(), other.end(), std::back_inserter(common));
+            keys = std::move(common);
+        }
+    }
+    return keys;
+}
+} // anonymous namespace
+
 bool Query::eval_object(const Obj& obj) const
 {
     if (has_conditions())
@@ -947,15 +1046,46 @@ bool Query::eval_object(const Obj& obj) const
     return true;
 }
 
+std::vector<ObjKey> Query::find_all_of(const std::vector<ObjKey>& keys) const
+{
+    REALM_ASSERT(!m_view);
+    std::vector<ObjKey> ret;
+    if (!m_table)
+        return ret;
 
-template <typename T>
-void Query::aggregate(QueryStateBase& st, ColKey column_key, size_t* resultcount, ObjKey* return_ndx) const
+    init();
+    for (auto key : keys) {
+        auto obj = m_table->try_get_object(key);
+        if (obj && eval_object(obj))
+            ret.push_back(key);
+    }
+    return ret;
+}
+
+
+template <typename T, class State>
+void Query::aggregate(State& st, ColKey column_key, size_t* resultcount, ObjKey* return_ndx) const
 {
     using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
 
     if (!has_conditions() && !m_view) {
-        // use table aggregate
-        m_table.unchecked_ptr()->aggregate<T>(st, column_key);
+        if (can_run_parallel()) {
+            // Each range is aggregated like Table::aggregate() does it, and the partial results are then merged
+            // in table order
+            Allocator& alloc = m_table.unchecked_ptr()->get_alloc();
+            std::vector<State> states(m_max_threads, st);
+            parallel_traverse([&](size_t range, const Query&, const Cluster* cluster) {
+                check_cancellation();
+                LeafType leaf(alloc);
+                Table::aggregate_leaf(states[range], cluster, column_key, leaf);
+            });
+            for (auto& range_state : states)
+                st.combine(range_state);
+        }
+        else {
+            // use table aggregate
+            m_table.unchecked_ptr()->aggregate<T>(st, column_key);
+        }
     }
     else {
 
@@ -967,11 +1097,7 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key, size_t* resultcount
             auto best = find_best_node(pn);
             auto node = pn->m_children[best];
             if (node->has_search_index()) {
-                auto keys = node->index_based_keys();
-                // The node having the search index can be removed from the query as we know that
-                // all the objects will match this condition
-                pn->m_children[best] = pn->m_children.back();
-                pn->m_children.pop_back();
+                auto keys = take_index_based_keys(pn);
                 for (auto key : keys) {
                     auto obj = m_table->get_object(key);
                     if (pn->m_children.empty() || eval_object(obj)) {
@@ -980,12 +1106,30 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key, size_t* resultcount
                     }
                 }
             }
+            else if (can_run_parallel()) {
+                Allocator& alloc = m_table.unchecked_ptr()->get_alloc();
+                std::vector<State> states(m_max_threads, st);
+                parallel_traverse([&](size_t range, const Query& query, const Cluster* cluster) {
+                    query.check_cancellation();
+                    auto& range_state = states[range];
+                    LeafType leaf(alloc);
+                    ParentNode* root = query.root_node();
+                    root->set_cluster(cluster);
+                    cluster->init_leaf(column_key, &leaf);
+                    range_state.m_key_offset = cluster->get_offset();
+                    range_state.m_key_values = cluster->get_key_array();
+                    query.aggregate_internal(root, &range_state, 0, cluster->node_size(), &leaf);
+                });
+                for (auto& range_state : states)
+                    st.combine(range_state);
+            }
             else {
                 // no index, traverse cluster tree
                 node = pn;
                 LeafType leaf(m_table.unchecked_ptr()->get_alloc());
 
                 auto f = [column_key, &leaf, &node, &st, this](const Cluster* cluster) {
+                    check_cancellation();
                     size_t e = cluster->node_size();
                     node->set_cluster(cluster);
                     cluster->init_leaf(column_key, &leaf);
@@ -996,6 +1140,7 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key, size_t* resultcount
                     return false;
                 };
 
+                util::SequentialScanHint scan_hint;
                 m_table.unchecked_ptr()->traverse_clusters(f);
             }
         }
@@ -1029,6 +1174,247 @@ size_t Query::find_best_node(ParentNode* pn) const
     return best;
 }
 
+namespace {
+// On smaller tables the statistics collected by aggregate_internal() converge fast enough by themselves
+constexpr size_t s_min_rows_for_sampling = 2 * REALM_MAX_BPNODE_SIZE;
+constexpr size_t s_sampled_leaves = 4;
+
+bool can_sample(const ParentNode* node)
+{
+    // Nodes driven by a search index or by a search in nested conditions keep a cursor that is only
+    // reset by init(), so those are not run ahead of the actual query. An index based node has a cost of
+    // zero which already makes it the preferred one.
+    return node->m_dT > 0.0 && !node->has_search_index() && !dynamic_cast<const OrNode*>(node) &&
+           !dynamic_cast<const NotNode*>(node);
+}
+} // anonymous namespace
+
+void Query::estimate_costs(ParentNode* root) const
+{
+    const uint_fast64_t content_version = m_table->get_content_version();
+    if (m_cost_sample && m_cost_sample->content_version == content_version &&
+        m_cost_sample->counts.size() == root->m_children.size()) {
+        // Sampled before by this query, or by the one it was copied from
+        for (size_t i = 0; i < root->m_children.size(); ++i) {
+            ParentNode* node = root->m_children[i];
+            std::tie(node->m_probes, node->m_matches) = m_cost_sample->counts[i];
+            if (node->m_probes)
+                node->m_dD = double(node->m_probes) / (node->m_matches + 1.1);
+        }
+    }
+    else {
+        sample_costs(root);
+        CostSample sample{content_version, {}};
+        sample.counts.reserve(root->m_children.size());
+        for (auto node : root->m_children)
+            sample.counts.emplace_back(node->m_probes, node->m_matches);
+        m_cost_sample = std::move(sample);
+    }
+
+    // Each node starts by testing its own condition, then tests the others in order of increasing cost
+    auto score_compare = [](const ParentNode* a, const ParentNode* b) {
+        return a->cost() < b->cost();
+    };
+    for (auto node : root->m_children) {
+        REALM_ASSERT_DEBUG(node->m_children.front() == node);
+        std::stable_sort(node->m_children.begin() + 1, node->m_children.end(), score_compare);
+    }
+}
+
+void Query::sample_costs(ParentNode* root) const
+{
+    std::vector<ParentNode*> sampled;
+    for (auto node : root->m_children) {
+        node->m_probes = 0;
+        node->m_matches = 0;
+        if (can_sample(node))
+            sampled.push_back(node);
+    }
+
+    const size_t table_size = m_table->size();
+    if (!sampled.empty() && table_size >= s_min_rows_for_sampling) {
+        // Spread the samples evenly over the table, so that a column correlated with insertion order does not
+        // look more or less selective than it is
+        size_t rows_seen = 0;
+        size_t samples_taken = 0;
+        m_table->traverse_clusters([&](const Cluster* cluster) {
+            const size_t sz = cluster->node_size();
+            if (rows_seen + sz > samples_taken * table_size / s_sampled_leaves) {
+                root->set_cluster(cluster);
+                for (auto node : sampled) {
+                    size_t matches = 0;
+                    for (size_t r = 0; r < sz; ++r) {
+                        r = node->find_first_local(r, sz);
+                        if (r == not_found)
+                            break;
+                        ++matches;
+                    }
+                    node->m_probes += sz;
+                    node->m_matches += matches;
+                }
+                ++samples_taken;
+            }
+            rows_seen += sz;
+            return samples_taken == s_sampled_leaves; // Stop when all samples are taken
+        });
+        for (auto node : sampled) {
+            // Same estimate as ParentNode::aggregate_local() uses
+            node->m_dD = double(node->m_probes) / (node->m_matches + 1.1);
+        }
+        // The sampled leaves are not part of an analyzed evaluation
+        for (auto node : root->m_children) {
+            if (node->m_statistics)
+                *node->m_statistics = ParentNode::Statistics();
+        }
+    }
+}
+
+namespace {
+QueryExplanation::Condition explain_node(const ParentNode* node, util::serializer::SerialisationState& state)
+{
+    QueryExplanation::Condition condition;
+    try {
+        condition.description = node->describe(state);
+    }
+    catch (const SerialisationError&) {
+        condition.description = node->describe_condition();
+    }
+    condition.uses_index = node->has_search_index();
+    condition.estimated_cost = node->cost();
+    condition.sampled_rows = node->m_probes;
+    condition.sampled_matches = node->m_matches;
+    if (auto stats = node->m_statistics.get()) {
+        condition.rows_scanned = stats->rows_scanned;
+        condition.rows_tested = stats->rows_tested;
+        condition.rows_matched = stats->rows_matched;
+        condition.time = stats->time;
+    }
+
+    auto explain_group = [&](const ParentNode* first) {
+        QueryExplanation::Condition group;
+        try {
+            group.description = first->describe_expression(state);
+        }
+        catch (const SerialisationError&) {
+            group.description = first->describe_condition();
+        }
+        for (auto n = first; n; n = n->m_child.get())
+            group.children.push_back(explain_node(n, state));
+        if (group.children.size() == 1)
+            return std::move(group.children.front());
+        return group;
+    };
+    if (auto or_node = dynamic_cast<const OrNode*>(node)) {
+        for (auto& alternative : or_node->m_conditions)
+            condition.children.push_back(explain_group(alternative.get()));
+    }
+    else if (auto not_node = dynamic_cast<const NotNode*>(node)) {
+        if (not_node->m_condition)
+            condition.children.push_back(explain_group(not_node->m_condition.get()));
+    }
+    return condition;
+}
+
+void explain_to_string(std::string& out, const QueryExplanation::Condition& condition, bool analyzed,
+                       size_t level)
+{
+    out.append(2 * level, ' ');
+    out += condition.description;
+    out += condition.uses_index ? " (index" : " (scan";
+    out += util::format(", cost %1", condition.estimated_cost);
+    if (condition.sampled_rows)
+        out += util::format(", %1 of %2 sampled rows match", condition.sampled_matches, condition.sampled_rows);
+    if (analyzed) {
+        out += util::format(", scanned %1, tested %2, matched %3, %4 us", condition.rows_scanned,
+                            condition.rows_tested, condition.rows_matched,
+                            std::chrono::duration_cast<std::chrono::microseconds>(condition.time).count());
+    }
+    out += ")\n";
+    for (auto& child : condition.children)
+        explain_to_string(out, child, analyzed, level + 1);
+}
+
+
+void explain_conditions(const ParentNode* root, QueryExplanation& explanation)
+{
+    // Nodes may have been removed from m_children by a previous evaluation, so collect them from the chain
+    std::vector<const ParentNode*> nodes;
+    for (const ParentNode* node = root; node; node = node->m_child.get())
+        nodes.push_back(node);
+    std::stable_sort(nodes.begin(), nodes.end(), [](const ParentNode* a, const ParentNode* b) {
+        return a->cost() < b->cost();
+    });
+    util::serializer::SerialisationState state("");
+    for (auto node : nodes)
+        explanation.conditions.push_back(explain_node(node, state));
+}
+} // anonymous namespace
+
+std::string QueryExplanation::to_string() const
+{
+    std::string out;
+    if (analyzed) {
+        out += util::format("%1 rows matched in %2 leaves, %3 us\n", rows_matched, leaves_scanned,
+                            std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+    }
+    for (auto& condition : conditions)
+        explain_to_string(out, condition, analyzed, 0);
+    return out;
+}
+
+QueryExplanation Query::explain() const
+{
+    QueryExplanation explanation;
+    if (ParentNode* root = root_node()) {
+        init();
+        explain_conditions(root, explanation);
+    }
+    return explanation;
+}
+
+QueryExplanation Query::explain_analyze() const
+{
+    // Run on a copy as the collected statistics belong to this evaluation only
+    Query query(*this);
+    query.m_max_threads = 1;
+    if (ParentNode* root = query.root_node()) {
+        for (ParentNode* node = root; node; node = node->m_child.get())
+            node->m_statistics = std::make_unique<ParentNode::Statistics>();
+    }
+
+    TableView tv(query, size_t(-1));
+    auto t = std::chrono::steady_clock::now();
+    query.do_find_all(tv, size_t(-1));
+    auto time = std::chrono::steady_clock::now() - t;
+
+    // explain() would init() again and reset the cost estimates, so report the state left by the evaluation
+    QueryExplanation explanation;
+    if (ParentNode* root = query.root_node()) {
+        explain_conditions(root, explanation);
+        explanation.leaves_scanned = root->m_statistics->leaves;
+    }
+    explanation.analyzed = true;
+    explanation.rows_matched = tv.size();
+    explanation.time = std::chrono::duration_cast<std::chrono::nanoseconds>(time);
+    return explanation;
+}
+
+std::string Query::get_plan_description() const
+{
+    std::string plan;
+    for (auto& condition : explain().conditions) {
+        if (!plan.empty())
+            plan += ", ";
+        plan += condition.description;
+        plan += condition.uses_index ? " (index" : " (scan";
+        if (condition.sampled_rows) {
+            plan += util::format(", %1 of %2 sampled rows match", condition.sampled_matches, condition.sampled_rows);
+        }
+        plan += ")";
+    }
+    return plan;
+}
+
 /**************************************************************************************************************
  *                                                                                                             *
  * Main entry point of a query. Schedules calls to aggregate_local                                             *
@@ -1039,13 +1425,23 @@ size_t Query::find_best_node(ParentNode* pn) const
 void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start, size_t end,
                                ArrayPayload* source_column) const
 {
+    auto aggregate_local = [&](ParentNode* node, size_t begin, size_t stop, size_t local_limit) {
+        if (REALM_UNLIKELY(node->m_statistics)) {
+            auto t = std::chrono::steady_clock::now();
+            size_t next = node->aggregate_local(st, begin, stop, local_limit, source_column);
+            node->m_statistics->time += std::chrono::steady_clock::now() - t;
+            return next;
+        }
+        return node->aggregate_local(st, begin, stop, local_limit, source_column);
+    };
+
     while (start < end) {
         // Executes start...end range of a query and will stay inside the condition loop of the node it was called
         // on. Can be called on any node; yields same result, but different performance. Returns prematurely if
         // condition of called node has evaluated to true local_matches number of times.
         // Return value is the next row for resuming aggregating (next row that caller must call aggregate_local on)
         size_t best = find_best_node(pn);
-        start = pn->m_children[best]->aggregate_local(st, start, end, findlocals, source_column);
+        start = aggregate_local(pn->m_children[best], start, end, findlocals);
         double current_cost = pn->m_children[best]->cost();
 
         // Make remaining conditions compute their m_dD (statistics)
@@ -1059,7 +1455,7 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
                 // Limit to bestdist in order not to skip too large parts of index nodes
                 size_t maxD = pn->m_children[c]->m_dT == 0.0 ? end - start : bestdist;
                 size_t td = pn->m_children[c]->m_dT == 0.0 ? end : (start + maxD > end ? end : start + maxD);
-                start = pn->m_children[c]->aggregate_local(st, start, td, probe_matches, source_column);
+                start = aggregate_local(pn->m_children[c], start, td, probe_matches);
             }
         }
     }
@@ -1072,6 +1468,7 @@ int64_t Query::sum_int(ColKey column_key) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateSum<int64_t> st;
@@ -1087,6 +1484,7 @@ double Query::sum_float(ColKey column_key) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateSum<float> st;
@@ -1097,6 +1495,7 @@ double Query::sum_double(ColKey column_key) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
     QueryStateSum<double> st;
     aggregate<double>(st, column_key);
@@ -1107,6 +1506,7 @@ Decimal128 Query::sum_decimal128(ColKey column_key) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateSum<Decimal128> st;
@@ -1118,6 +1518,7 @@ Decimal128 Query::sum_mixed(ColKey column_key) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateSum<Mixed> st;
@@ -1131,6 +1532,7 @@ int64_t Query::maximum_int(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<int64_t> st;
@@ -1147,6 +1549,7 @@ float Query::maximum_float(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<float> st;
@@ -1157,6 +1560,7 @@ double Query::maximum_double(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<double> st;
@@ -1168,6 +1572,7 @@ Decimal128 Query::maximum_decimal128(ColKey column_key, ObjKey* return_ndx) cons
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<Decimal128> st;
@@ -1179,6 +1584,7 @@ Mixed Query::maximum_mixed(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<Mixed> st;
@@ -1190,6 +1596,7 @@ Timestamp Query::maximum_timestamp(ColKey column_key, ObjKey* return_ndx)
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Maximum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMax<Timestamp> st;
@@ -1203,6 +1610,7 @@ int64_t Query::minimum_int(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<int64_t> st;
@@ -1218,6 +1626,7 @@ float Query::minimum_float(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<float> st;
@@ -1228,6 +1637,7 @@ double Query::minimum_double(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<double> st;
@@ -1239,6 +1649,7 @@ Timestamp Query::minimum_timestamp(ColKey column_key, ObjKey* return_ndx)
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<Timestamp> st;
@@ -1250,6 +1661,7 @@ Decimal128 Query::minimum_decimal128(ColKey column_key, ObjKey* return_ndx) cons
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<Decimal128> st;
@@ -1261,6 +1673,7 @@ Mixed Query::minimum_mixed(ColKey column_key, ObjKey* return_ndx) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Minimum);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     QueryStateMin<Mixed> st;
@@ -1275,6 +1688,7 @@ R Query::average(ColKey column_key, size_t* resultcount) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Average);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
     size_t resultcount2 = 0;
     QueryStateSum<typename util::RemoveOptional<T>::type> st;
@@ -1307,6 +1721,7 @@ Decimal128 Query::average_decimal128(ColKey column_key, size_t* resultcount) con
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Average);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
     return average<Decimal128>(column_key, resultcount);
 }
@@ -1314,6 +1729,7 @@ Decimal128 Query::average_mixed(ColKey column_key, size_t* resultcount) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Average);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
     return average<Mixed>(column_key, resultcount);
 }
@@ -1383,11 +1799,51 @@ Query& Query::Or()
     return *this;
 }
 
+// Prepared queries
+Query& Query::set_placeholder(size_t placeholder)
+{
+    auto& current_group = m_groups.back();
+    ParentNode* node = current_group.m_root_node.get();
+    if (node && current_group.m_state != QueryGroup::State::Default) {
+        REALM_ASSERT_DEBUG(dynamic_cast<OrNode*>(node));
+        auto& conditions = static_cast<OrNode*>(node)->m_conditions;
+        node = conditions.empty() ? nullptr : conditions.back().get();
+    }
+    // The last condition added is at the end of the chain, possibly inside a NotNode
+    while (node) {
+        while (node->m_child)
+            node = node->m_child.get();
+        auto not_node = dynamic_cast<NotNode*>(node);
+        if (!not_node)
+            break;
+        node = not_node->m_condition.get();
+    }
+    if (!node)
+        throw util::runtime_error("no condition to bind the placeholder to");
+
+    node->m_placeholder = placeholder;
+    return *this;
+}
+
+Query& Query::rebind(size_t placeholder, Mixed value)
+{
+    m_cost_sample.reset();
+    size_t count = 0;
+    for (auto& group : m_groups) {
+        if (group.m_root_node)
+            count += group.m_root_node->rebind(placeholder, value); // Throws
+    }
+    if (count == 0)
+        throw std::out_of_range(util::format("No condition is bound to placeholder %1", placeholder));
+    return *this;
+}
+
 
 ObjKey Query::find() const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Find);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     init();
@@ -1429,7 +1885,8 @@ ObjKey Query::find() const
     else {
         auto node = root_node();
         ObjKey key;
-        auto f = [&node, &key](const Cluster* cluster) {
+        auto f = [&node, &key, this](const Cluster* cluster) {
+            check_cancellation();
             size_t end = cluster->node_size();
             node->set_cluster(cluster);
             size_t res = node->find_first(0, end);
@@ -1469,7 +1926,8 @@ void Query::do_find_all(TableView& ret, size_t limit) const
         if (!has_cond) {
             KeyColumn& refs = ret.m_key_values;
 
-            auto f = [&limit, &refs](const Cluster* cluster) {
+            auto f = [&limit, &refs, this](const Cluster* cluster) {
+                check_cancellation();
                 size_t sz = cluster->node_size();
                 auto offset = cluster->get_offset();
                 auto key_values = cluster->get_key_array();
@@ -1488,13 +1946,7 @@ void Query::do_find_all(TableView& ret, size_t limit) const
             auto node = pn->m_children[best];
             if (node->has_search_index()) {
                 KeyColumn& refs = ret.m_key_values;
-
-                // The node having the search index can be removed from the query as we know that
-                // all the objects will match this condition
-                pn->m_children[best] = pn->m_children.back();
-                pn->m_children.pop_back();
-
-                auto keys = node->index_based_keys();
+                auto keys = take_index_based_keys(pn);
                 for (auto key : keys) {
                     if (limit == 0)
                         break;
@@ -1515,9 +1967,36 @@ void Query::do_find_all(TableView& ret, size_t limit) const
             }
             // no index on best node (and likely no index at all), descend B+-tree
             node = pn;
+            if (limit == size_t(-1) && can_run_parallel()) {
+                // Each range collects its own matches. The ranges are in table order, so concatenating them
+                // gives the same result as the serial traversal.
+                std::vector<std::vector<ObjKey>> keys(m_max_threads);
+                std::vector<QueryStateFindAll<std::vector<ObjKey>>> states;
+                states.reserve(m_max_threads);
+                for (auto& range_keys : keys)
+                    states.emplace_back(range_keys);
+
+                parallel_traverse([&states](size_t range, const Query& query, const Cluster* cluster) {
+                    query.check_cancellation();
+                    auto& st = states[range];
+                    ParentNode* root = query.root_node();
+                    root->set_cluster(cluster);
+                    st.m_key_offset = cluster->get_offset();
+                    st.m_key_values = cluster->get_key_array();
+                    query.aggregate_internal(root, &st, 0, cluster->node_size(), nullptr);
+                });
+
+                KeyColumn& refs = ret.m_key_values;
+                for (auto& range_keys : keys) {
+                    for (auto key : range_keys)
+                        refs.add(key);
+                }
+                return;
+            }
             QueryStateFindAll<KeyColumn> st(ret.m_key_values, limit);
 
             auto f = [&node, &st, this](const Cluster* cluster) {
+                check_cancellation();
                 size_t e = cluster->node_size();
                 node->set_cluster(cluster);
                 st.m_key_offset = cluster->get_offset();
@@ -1527,6 +2006,7 @@ void Query::do_find_all(TableView& ret, size_t limit) const
                 return st.match_count() == st.limit();
             };
 
+            util::SequentialScanHint scan_hint;
             m_table->traverse_clusters(f);
         }
     }
@@ -1536,6 +2016,7 @@ TableView Query::find_all(size_t limit) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_FindAll);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
 
     TableView ret(*this, limit);
@@ -1579,12 +2060,11 @@ size_t Query::do_count(size_t limit) const
         auto best = find_best_node(pn);
         auto node = pn->m_children[best];
         if (node->has_search_index()) {
-            auto keys = node->index_based_keys();
-            if (pn->m_children.size() > 1) {
-                // The node having the search index can be removed from the query as we know that
-                // all the objects will match this condition
-                pn->m_children[best] = pn->m_children.back();
-                pn->m_children.pop_back();
+            // A single condition is counted by the index
+            if (pn->m_children.size() == 1)
+                return std::min(limit, node->index_based_count());
+            auto keys = take_index_based_keys(pn);
+            if (!pn->m_children.empty()) {
                 for (auto key : keys) {
                     auto obj = m_table->get_object(key);
                     if (eval_object(obj)) {
@@ -1595,7 +2075,7 @@ size_t Query::do_count(size_t limit) const
                 }
             }
             else {
-                // The node having the search index is the only node
+                // All conditions are evaluated using a search index
                 auto sz = keys.size();
                 counter = std::min(limit, sz);
             }
@@ -1603,9 +2083,25 @@ size_t Query::do_count(size_t limit) const
         }
         // no index, descend down the B+-tree instead
         node = pn;
+        if (limit == size_t(-1) && can_run_parallel()) {
+            std::vector<QueryStateCount> states(m_max_threads);
+            parallel_traverse([&states](size_t range, const Query& query, const Cluster* cluster) {
+                query.check_cancellation();
+                auto& st = states[range];
+                ParentNode* root = query.root_node();
+                root->set_cluster(cluster);
+                st.m_key_offset = cluster->get_offset();
+                st.m_key_values = cluster->get_key_array();
+                query.aggregate_internal(root, &st, 0, cluster->node_size(), nullptr);
+            });
+            for (auto& st : states)
+                cnt += st.get_count();
+            return cnt;
+        }
         QueryStateCount st(limit);
 
         auto f = [&node, &st, this](const Cluster* cluster) {
+            check_cancellation();
             size_t e = cluster->node_size();
             node->set_cluster(cluster);
             st.m_key_offset = cluster->get_offset();
@@ -1615,6 +2111,7 @@ size_t Query::do_count(size_t limit) const
             return st.match_count() == st.limit();
         };
 
+        util::SequentialScanHint scan_hint;
         m_table->traverse_clusters(f);
 
         cnt = st.get_count();
@@ -1623,10 +2120,252 @@ size_t Query::do_count(size_t limit) const
     return cnt;
 }
 
+bool Query::can_run_parallel() const
+{
+    // The leaves of a frozen table never change, so they can be read by several threads at once
+    return m_max_threads > 1 && !m_view && m_table && m_table->is_frozen();
+}
+
+size_t Query::parallel_traverse(ParallelFunction func) const
+{
+    std::vector<std::pair<ref_type, uint64_t>> leaves;
+    m_table->traverse_clusters([&leaves](const Cluster* cluster) {
+        leaves.emplace_back(cluster->get_ref(), cluster->get_offset());
+        return false; // Continue
+    });
+
+    const size_t num_ranges = std::min(m_max_threads, leaves.size());
+    if (num_ranges == 0)
+        return 0;
+
+    // The copies are made and initialized up front as that touches the accessors shared with this query
+    std::vector<Query> queries(num_ranges, *this);
+    for (auto& query : queries)
+        query.init();
+
+    Allocator& alloc = m_table->get_alloc();
+    const ClusterTree& tree = m_table->m_clusters;
+    util::ThreadPool::get_default().run_parallel(num_ranges, [&](size_t range) {
+        util::SequentialScanHint scan_hint;
+        size_t begin = range * leaves.size() / num_ranges;
+        size_t end = (range + 1) * leaves.size() / num_ranges;
+        for (size_t i = begin; i < end; ++i) {
+            Cluster cluster(leaves[i].second, alloc, tree);
+            cluster.init(MemRef(leaves[i].first, alloc));
+            func(range, queries[range], &cluster);
+        }
+    }); // Throws
+    return num_ranges;
+}
+
+namespace {
+// Fewer leaves than this give too unreliable an estimate of the error
+constexpr size_t s_min_sampled_leaves = 8;
+
+// The ratio estimate of `scale` * sum(y) / sum(x) from the (x, y) pairs of the sampled leaves, with the error
+// bound for a sample of the given fraction of the population
+Query::Estimate ratio_estimate(const std::vector<std::pair<double, double>>& samples, double scale,
+                               double sampled_fraction)
+{
+    double x = 0;
+    double y = 0;
+    for (auto& [x_i, y_i] : samples) {
+        x += x_i;
+        y += y_i;
+    }
+    Query::Estimate estimate;
+    if (x == 0 || samples.size() < 2) {
+        estimate.error_bound = std::numeric_limits<double>::infinity();
+        return estimate;
+    }
+    double ratio = y / x;
+    double variance = 0;
+    for (auto& [x_i, y_i] : samples) {
+        double residual = y_i - ratio * x_i;
+        variance += residual * residual;
+    }
+    size_t k = samples.size();
+    variance /= k - 1;
+    double mean_x = x / k;
+    estimate.value = ratio * scale;
+    estimate.error_bound = 1.96 * scale * std::sqrt((1 - sampled_fraction) * variance / k) / mean_x;
+    return estimate;
+}
+} // anonymous namespace
+
+size_t Query::sample_leaves(double fraction, SampleFunction func) const
+{
+    const size_t table_size = m_table->size();
+    if (table_size == 0)
+        return 0;
+
+    // The leaves are assumed to be full, so the sample may be somewhat smaller than asked for
+    const double leaf_size = double(m_table->get_cluster_node_size());
+    const size_t num_samples =
+        std::max(s_min_sampled_leaves, size_t(std::ceil(fraction * double(table_size) / leaf_size)));
+    const ClusterTree& tree = m_table->m_clusters;
+    Cluster leaf(0, m_table->get_alloc(), tree);
+    ClusterNode::IteratorState state(leaf);
+    ref_type last_sampled = 0;
+    size_t sampled_rows = 0;
+    for (size_t i = 0; i < num_samples; ++i) {
+        check_cancellation();
+        // The middle of each of `num_samples` equal ranges of rows
+        size_t row = size_t((double(i) + 0.5) * double(table_size) / double(num_samples));
+        ObjKey key;
+        tree.get(row, key);
+        tree.get_leaf(key, state);
+        // Several ranges may fall into one leaf
+        if (leaf.get_ref() == last_sampled)
+            continue;
+        last_sampled = leaf.get_ref();
+        func(&leaf);
+        sampled_rows += leaf.node_size();
+    }
+    return sampled_rows;
+}
+
+Query::Estimate Query::count_approximate(double fraction) const
+{
+    auto exact = [&] {
+        Estimate estimate;
+        estimate.value = double(do_count());
+        estimate.sampled_rows = m_view ? m_view->size() : m_table->size();
+        return estimate;
+    };
+    if (!has_conditions() || m_view || fraction >= 1.0)
+        return exact();
+    init();
+    auto pn = root_node();
+    if (pn->m_children[find_best_node(pn)]->has_search_index())
+        return exact();
+
+    std::vector<std::pair<double, double>> samples;
+    size_t sampled_rows = sample_leaves(fraction, [&](const Cluster* cluster) {
+        QueryStateCount st;
+        pn->set_cluster(cluster);
+        st.m_key_offset = cluster->get_offset();
+        st.m_key_values = cluster->get_key_array();
+        aggregate_internal(pn, &st, 0, cluster->node_size(), nullptr);
+        samples.emplace_back(double(cluster->node_size()), double(st.get_count()));
+    });
+
+    const size_t table_size = m_table->size();
+    Estimate estimate = ratio_estimate(samples, double(table_size), double(sampled_rows) / double(table_size));
+    if (sampled_rows == table_size) {
+        // Every leaf was sampled
+        estimate.value = 0;
+        for (auto& sample : samples)
+            estimate.value += sample.second;
+        estimate.error_bound = 0;
+    }
+    else if (estimate.value == 0) {
+        // No match in the sample. The "rule of three" gives the bound on the fraction of matching rows.
+        estimate.error_bound = 3.0 * double(table_size) / double(sampled_rows);
+    }
+    estimate.sampled_rows = sampled_rows;
+    return estimate;
+}
+
+template <typename T>
+Query::Estimate Query::aggregate_approximate(ColKey column_key, double fraction, bool average) const
+{
+    using ValueType = typename util::RemoveOptional<T>::type;
+    using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
+
+    auto exact = [&] {
+        QueryStateSum<ValueType> st;
+        aggregate<T>(st, column_key);
+        Estimate estimate;
+        estimate.value = double(st.result_sum());
+        if (average)
+            estimate.value = st.result_count() ? estimate.value / double(st.result_count()) : 0.0;
+        estimate.sampled_rows = m_view ? m_view->size() : m_table->size();
+        return estimate;
+    };
+    if (m_view || fraction >= 1.0)
+        return exact();
+    if (has_conditions()) {
+        init();
+        auto pn = root_node();
+        if (pn->m_children[find_best_node(pn)]->has_search_index())
+            return exact();
+    }
+
+    // The sums are estimated from (rows, sum) of every leaf, and the averages from (values, sum)
+    LeafType leaf(m_table->get_alloc());
+    std::vector<std::pair<double, double>> samples;
+    size_t sampled_rows = sample_leaves(fraction, [&](const Cluster* cluster) {
+        QueryStateSum<ValueType> st;
+        if (has_conditions()) {
+            ParentNode* root = root_node();
+            root->set_cluster(cluster);
+            cluster->init_leaf(column_key, &leaf);
+            st.m_key_offset = cluster->get_offset();
+            st.m_key_values = cluster->get_key_array();
+            aggregate_internal(root, &st, 0, cluster->node_size(), &leaf);
+        }
+        else {
+            Table::aggregate_leaf(st, cluster, column_key, leaf);
+        }
+        double x = average ? double(st.result_count()) : double(cluster->node_size());
+        samples.emplace_back(x, double(st.result_sum()));
+    });
+
+    const size_t table_size = m_table->size();
+    if (sampled_rows == table_size) {
+        // Every leaf was sampled
+        double x = 0;
+        double y = 0;
+        for (auto& [x_i, y_i] : samples) {
+            x += x_i;
+            y += y_i;
+        }
+        Estimate estimate;
+        estimate.value = average ? (x ? y / x : 0.0) : y;
+        estimate.sampled_rows = sampled_rows;
+        return estimate;
+    }
+    Estimate estimate = ratio_estimate(samples, average ? 1.0 : double(table_size),
+                                       double(sampled_rows) / double(table_size));
+    estimate.sampled_rows = sampled_rows;
+    return estimate;
+}
+
+Query::Estimate Query::aggregate_approximate(ColKey column_key, double fraction, bool average) const
+{
+    m_table->check_column(column_key);
+    if (column_key.is_collection())
+        throw LogicError(LogicError::illegal_type);
+    switch (column_key.get_type()) {
+        case col_type_Int:
+            if (m_table->is_nullable(column_key))
+                return aggregate_approximate<util::Optional<int64_t>>(column_key, fraction, average);
+            return aggregate_approximate<int64_t>(column_key, fraction, average);
+        case col_type_Float:
+            return aggregate_approximate<float>(column_key, fraction, average);
+        case col_type_Double:
+            return aggregate_approximate<double>(column_key, fraction, average);
+        default:
+            throw LogicError(LogicError::illegal_type);
+    }
+}
+
+Query::Estimate Query::sum_approximate(ColKey column_key, double fraction) const
+{
+    return aggregate_approximate(column_key, fraction, false);
+}
+
+Query::Estimate Query::average_approximate(ColKey column_key, double fraction) const
+{
+    return aggregate_approximate(column_key, fraction, true);
+}
+
 size_t Query::count() const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Count);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
     return do_count();
 }
@@ -1635,7 +2374,10 @@ TableView Query::find_all(const DescriptorOrdering& descriptor) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_FindAll);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
+    if (auto& token = descriptor.get_cancellation(); token && !m_cancellation)
+        return Query(*this).set_cancellation(token).find_all(descriptor);
     if (descriptor.is_empty()) {
         return find_all();
     }
@@ -1668,7 +2410,10 @@ size_t Query::count(const DescriptorOrdering& descriptor) const
 {
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Count);
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
 #endif
+    if (auto& token = descriptor.get_cancellation(); token && !m_cancellation)
+        return Query(*this).set_cancellation(token).count(descriptor);
     realm::util::Optional<size_t> min_limit = descriptor.get_min_limit();
 
     if (bool(min_limit) && *min_limit == 0)
@@ -1885,6 +2630,8 @@ void Query::init() const
         root->init(m_view == nullptr);
         std::vector<ParentNode*> vec;
         root->gather_children(vec);
+        if (!m_view && root->m_children.size() > 1)
+            estimate_costs(root);
     }
 }
 
@@ -1911,6 +2658,7 @@ void Query::add_node(std::unique_ptr<ParentNode> node)
 {
     REALM_ASSERT(node);
     using State = QueryGroup::State;
+    m_cost_sample.reset();
 
     if (m_table)
         node->set_table(m_table);
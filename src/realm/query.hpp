@@ -23,6 +23,8 @@
 #include <cstdio>
 #include <climits>
 #include <algorithm>
+#include <chrono>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -42,7 +44,11 @@
 #include <realm/handover_defs.hpp>
 #include <realm/util/serializer.hpp>
 #include <realm/util/bind_ptr.hpp>
+#include <realm/util/cancellation.hpp>
+#include <realm/util/function_ref.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/exceptions.hpp>
+#include <realm/geospatial.hpp>
 
 namespace realm {
 
@@ -53,6 +59,7 @@ class Table;
 class TableView;
 class TableView;
 class Array;
+class Cluster;
 class Expression;
 class Group;
 class Transaction;
@@ -82,6 +89,36 @@ struct QueryGroup {
     State m_state = State::Default;
 };
 
+// Query plan as returned by Query::explain() and Query::explain_analyze()
+struct QueryExplanation {
+    struct Condition {
+        std::string description;
+        bool uses_index = false;
+        double estimated_cost = 0.0;
+        // Rows the condition was run on when estimating its selectivity, and how many matched
+        size_t sampled_rows = 0;
+        size_t sampled_matches = 0;
+        // Only set by explain_analyze(). A condition either drives the query by searching a range of rows for
+        // its next match, or is tested on single rows matched by the condition currently driving the query.
+        size_t rows_scanned = 0;
+        size_t rows_tested = 0;
+        size_t rows_matched = 0;
+        std::chrono::nanoseconds time{0};
+        // The alternatives of an OR group, or the negated conditions of a NOT group
+        std::vector<Condition> children;
+    };
+
+    // The AND-ed top level conditions, in the order the query engine will initially prefer them
+    std::vector<Condition> conditions;
+    bool analyzed = false;
+    size_t leaves_scanned = 0;
+    size_t rows_matched = 0;
+    std::chrono::nanoseconds time{0};
+
+    // One line per condition, indented by nesting level
+    std::string to_string() const;
+};
+
 class Query final {
 public:
     Query(ConstTableRef table, TableView* tv = nullptr);
@@ -105,6 +142,10 @@ public:
     // Find links that point to specific target objects
     Query& links_to(ColKey column_key, const std::vector<ObjKey>& target_obj);
 
+    // Find objects created or modified after the table had the given
+    // modification version, see Table::set_modification_version_column()
+    Query& modified_since(uint64_t version);
+
     // Conditions: null
     Query& equal(ColKey column_key, null);
     Query& not_equal(ColKey column_key, null);
@@ -210,6 +251,9 @@ public:
     Query& ends_with(ColKey column_key, StringData value, bool case_sensitive = true);
     Query& contains(ColKey column_key, StringData value, bool case_sensitive = true);
     Query& like(ColKey column_key, StringData value, bool case_sensitive = true);
+    // Matches the objects whose string contains every word of `text` as a whole word, ignoring case.
+    // See tokenize_words() for what makes up a word. Text without any words matches nothing.
+    Query& fulltext(ColKey column_key, StringData text);
 
     // These are shortcuts for equal(StringData(c_str)) and
     // not_equal(StringData(c_str)), and are needed to avoid unwanted
@@ -225,6 +269,11 @@ public:
     Query& contains(ColKey column_key, BinaryData value, bool case_sensitive = true);
     Query& like(ColKey column_key, BinaryData b, bool case_sensitive = true);
 
+    // Conditions: location, for points stored as latitude and longitude (in degrees) in two double columns.
+    // Objects where either is null never match.
+    Query& geo_within(ColKey latitude, ColKey longitude, const GeoBox& box);
+    Query& geo_within(ColKey latitude, ColKey longitude, const GeoCircle& circle);
+
     // Conditions: untyped column vs column comparison
     // if the column types are not comparable, an exception is thrown
     Query& equal(ColKey column_key1, ColKey column_key2);
@@ -280,9 +329,70 @@ public:
     Mixed minimum_mixed(ColKey column_key, ObjKey* return_ndx = nullptr) const;
     Decimal128 average_mixed(ColKey column_key, size_t* resultcount = nullptr) const;
 
+    // Approximate aggregates
+    //
+    // Estimates from evaluating the query on about `fraction` of the rows of the table, in whole leaves spread
+    // evenly over the key range. The result is exact, with an error bound of zero, if the sample would cover the
+    // whole table, if the query is restricted by a view, or if a search index answers its conditions, as the exact
+    // result is then about as cheap. The sums and averages are for Int, Float and Double columns.
+    struct Estimate {
+        double value = 0;
+        // The exact result is within this distance of `value` with a probability of about 95%
+        double error_bound = 0;
+        size_t sampled_rows = 0;
+    };
+    Estimate count_approximate(double fraction = 0.01) const;
+    Estimate sum_approximate(ColKey column_key, double fraction = 0.01) const;
+    Estimate average_approximate(ColKey column_key, double fraction = 0.01) const;
+
     // Deletion
     size_t remove() const;
 
+    // Parallel evaluation
+    //
+    // find_all(), count() and the aggregates can split the leaves of the table into up to `max_threads` ranges which
+    // are evaluated concurrently by private copies of the query on the calling thread and the default
+    // util::ThreadPool. This only happens for queries on frozen tables, where the leaves are guaranteed to be
+    // immutable, without a restricting view and without a limit. Except for rounding differences in floating point
+    // sums, the result is the same as with serial evaluation. 0 and 1 (the default) disable parallel evaluation.
+    Query& set_max_threads(size_t max_threads) noexcept
+    {
+        m_max_threads = max_threads;
+        return *this;
+    }
+    size_t get_max_threads() const noexcept
+    {
+        return m_max_threads;
+    }
+
+    // Cancellation
+    //
+    // find_all(), find(), count() and the aggregates check the token between the leaves of the table and throw
+    // QueryCancelled once it has been cancelled or its deadline has passed. Evaluations over a restricting view or
+    // through a search index are not interrupted. A token set on the DescriptorOrdering passed to find_all() or
+    // count() applies in the same way.
+    Query& set_cancellation(std::shared_ptr<const util::CancellationToken> token) noexcept
+    {
+        m_cancellation = std::move(token);
+        return *this;
+    }
+    const std::shared_ptr<const util::CancellationToken>& get_cancellation() const noexcept
+    {
+        return m_cancellation;
+    }
+
+    // Prepared queries
+    //
+    // set_placeholder() binds the condition added last to the index of a placeholder, and rebind() replaces the
+    // value compared with by all conditions bound to that placeholder, in place. This way a query can be run with
+    // other values without being built again. Conditions bound to a placeholder are not merged with other conditions
+    // on the same column in an OR. Only conditions comparing with a single value can be bound, not IN and list
+    // comparisons or conditions comparing two properties. rebind() throws LogicError if a condition can't compare with a value of that
+    // type, in which case it has to be rebound successfully before it is run again, and std::out_of_range if no
+    // condition is bound to the placeholder.
+    Query& set_placeholder(size_t placeholder);
+    Query& rebind(size_t placeholder, Mixed value);
+
 #if REALM_MULTITHREAD_QUERY
     // Multi-threading
     TableView find_all_multi(size_t start = 0, size_t end = size_t(-1));
@@ -325,12 +435,26 @@ public:
     std::string get_description(const std::string& class_prefix = "") const;
     std::string get_description(util::serializer::SerialisationState& state) const;
 
+    // Describe how the conditions of the query will be evaluated. explain_analyze() additionally evaluates the
+    // query like find_all() without limit or ordering, and reports how many rows each condition processed.
+    QueryExplanation explain() const;
+    QueryExplanation explain_analyze() const;
+
     Query& set_ordering(util::bind_ptr<DescriptorOrdering> ordering);
     // This will remove the ordering from the Query object
     util::bind_ptr<DescriptorOrdering> get_ordering();
+    bool has_ordering() const noexcept
+    {
+        return bool(m_ordering);
+    }
 
     bool eval_object(const Obj& obj) const;
 
+    // Returns the keys of those of the given objects which match the query, in
+    // the order given. Keys of objects which do not exist are skipped. The
+    // query must not be restricted by a view.
+    std::vector<ObjKey> find_all_of(const std::vector<ObjKey>& keys) const;
+
 private:
     void create();
 
@@ -364,16 +488,40 @@ private:
               typename R = typename aggregate_operations::Average<typename util::RemoveOptional<T>::type>::ResultType>
     R average(ColKey column_key, size_t* resultcount = nullptr) const;
 
-    template <typename T>
-    void aggregate(QueryStateBase& st, ColKey column_key, size_t* resultcount = nullptr,
-                   ObjKey* return_ndx = nullptr) const;
+    template <typename T, class State>
+    void aggregate(State& st, ColKey column_key, size_t* resultcount = nullptr, ObjKey* return_ndx = nullptr) const;
 
     size_t find_best_node(ParentNode* pn) const;
+    // Seed the cost estimates of the conditions in the top level AND group with the selectivity measured on a
+    // sample of the leaves, and order the conditions by the resulting cost.
+    void estimate_costs(ParentNode* root) const;
+    // Runs the conditions over the sampled leaves, setting their probe and match counts
+    void sample_costs(ParentNode* root) const;
+    // Conditions in the order chosen by estimate_costs(), with the access path and estimated selectivity of each
+    std::string get_plan_description() const;
     void aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start, size_t end,
                             ArrayPayload* source_column) const;
 
     void do_find_all(TableView& tv, size_t limit) const;
     size_t do_count(size_t limit = size_t(-1)) const;
+
+    // Called once for every leaf with the index of the range it belongs to and the copy of the query evaluating it
+    using ParallelFunction = util::FunctionRef<void(size_t range, const Query& query, const Cluster* cluster)>;
+    bool can_run_parallel() const;
+    // Returns the number of ranges, which is at most m_max_threads. Rethrows the first exception thrown by `func`.
+    size_t parallel_traverse(ParallelFunction func) const;
+    // Calls `func` with leaves spread evenly over the table which hold about `fraction` of its rows. Returns the
+    // number of rows in the leaves sampled.
+    using SampleFunction = util::FunctionRef<void(const Cluster* cluster)>;
+    size_t sample_leaves(double fraction, SampleFunction func) const;
+    template <typename T>
+    Estimate aggregate_approximate(ColKey column_key, double fraction, bool average) const;
+    Estimate aggregate_approximate(ColKey column_key, double fraction, bool average) const;
+    void check_cancellation() const
+    {
+        if (m_cancellation && m_cancellation->is_cancelled())
+            throw QueryCancelled();
+    }
     void delete_nodes() noexcept;
 
     bool has_conditions() const
@@ -415,6 +563,17 @@ private:
     TableView* m_source_table_view = nullptr;      // table views are not refcounted, and not owned by the query.
     std::unique_ptr<TableView> m_owned_source_table_view; // <--- except when indicated here
     util::bind_ptr<DescriptorOrdering> m_ordering;
+    size_t m_max_threads = 1;
+    std::shared_ptr<const util::CancellationToken> m_cancellation;
+
+    // The counts sampled by estimate_costs(), so that later evaluations and copies of this query, such as the
+    // ones made to run it in parallel, do not sample the table again until it changes. Holds the probed and the
+    // matching rows of every condition in the top level AND group. Cleared when the conditions change.
+    struct CostSample {
+        uint_fast64_t content_version;
+        std::vector<std::pair<size_t, size_t>> counts;
+    };
+    mutable std::optional<CostSample> m_cost_sample;
 };
 
 // Implementation:
@@ -54,6 +54,36 @@ public:
         return m_state.items_counted();
     }
 
+    // Sum all values of a leaf directly rather than through match(). This avoids the virtual call and the
+    // conversion to Mixed per value, and lets integer leaves use the vectorized Array::get_sum().
+    template <class LeafType>
+    void match_leaf(const LeafType& leaf)
+    {
+        REALM_ASSERT_DEBUG(m_limit == size_t(-1));
+        size_t sz = leaf.size();
+        size_t counted = m_state.items_counted();
+        if constexpr (std::is_same_v<LeafType, ArrayInteger>) {
+            m_state.accumulate_sum(leaf.get_sum(0, sz), sz);
+        }
+        else if constexpr (std::is_same_v<LeafType, ArrayDecimal128>) {
+            size_t count;
+            Decimal128 sum = leaf.sum(count);
+            m_state.accumulate_sum(sum, count);
+        }
+        else {
+            for (size_t i = 0; i < sz; i++)
+                m_state.accumulate(leaf.get(i));
+        }
+        m_match_count += m_state.items_counted() - counted;
+    }
+
+    // Merge the state of an aggregate over a range of leaves following the ones this one has seen
+    void combine(const QueryStateSum& other)
+    {
+        m_state.combine(other.m_state);
+        m_match_count += other.m_match_count;
+    }
+
 private:
     aggregate_operations::Sum<typename util::RemoveOptional<T>::type> m_state;
 };
@@ -82,6 +112,15 @@ public:
         return m_state.is_null() ? R{} : m_state.result();
     }
 
+    // Merge the state of an aggregate over a range of leaves following the ones this one has seen. Equal
+    // values do not replace the current result, so the key of the first occurrence is kept as in a serial scan.
+    void combine(const QueryStateMin& other)
+    {
+        if (!other.m_state.is_null() && m_state.accumulate(other.m_state.result()))
+            m_minmax_key = other.m_minmax_key;
+        m_match_count += other.m_match_count;
+    }
+
 private:
     aggregate_operations::Minimum<typename util::RemoveOptional<R>::type> m_state;
 };
@@ -110,6 +149,15 @@ public:
         return m_state.is_null() ? R{} : m_state.result();
     }
 
+    // Merge the state of an aggregate over a range of leaves following the ones this one has seen. Equal
+    // values do not replace the current result, so the key of the first occurrence is kept as in a serial scan.
+    void combine(const QueryStateMax& other)
+    {
+        if (!other.m_state.is_null() && m_state.accumulate(other.m_state.result()))
+            m_minmax_key = other.m_minmax_key;
+        m_match_count += other.m_match_count;
+    }
+
 private:
     aggregate_operations::Maximum<typename util::RemoveOptional<R>::type> m_state;
 };
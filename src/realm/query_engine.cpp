@@ -27,9 +27,80 @@ namespace realm {
 
 std::vector<ObjKey> ParentNode::s_dummy_keys;
 
+std::shared_ptr<LeafSummaryCache> LeafSummaryCache::get(Allocator& alloc)
+{
+    std::lock_guard lock(alloc.m_leaf_summary_cache_mutex);
+    if (!alloc.m_leaf_summary_cache)
+        alloc.m_leaf_summary_cache = std::make_shared<LeafSummaryCache>(); // Throws
+    return alloc.m_leaf_summary_cache;
+}
+
+auto LeafSummaryCache::find(ref_type ref) -> Entry*
+{
+    auto it = m_entries.find(ref);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= max_entries)
+            m_entries.clear();
+        m_entries.emplace(ref, Entry()); // Throws
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool LeafSummaryCache::lookup(ref_type ref, LeafRange& range, util::FunctionRef<void(LeafRange&)> compute,
+                              bool summarize_now)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        Entry* entry = find(ref); // Throws
+        if (!entry && !summarize_now)
+            return false;
+        if (entry && entry->has_range) {
+            range = entry->range;
+            return true;
+        }
+    }
+
+    // Compute without holding the lock
+    LeafRange computed;
+    compute(computed);
+
+    std::lock_guard lock(m_mutex);
+    Entry& entry = m_entries[ref]; // Throws
+    entry.range = computed;
+    entry.has_range = true;
+    range = computed;
+    return true;
+}
+
+bool LeafSummaryCache::lookup(ref_type ref, std::shared_ptr<const LeafBloomFilter>& bloom,
+                              util::FunctionRef<void(LeafBloomFilter&)> compute)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        Entry* entry = find(ref); // Throws
+        if (!entry)
+            return false;
+        if (entry->bloom) {
+            bloom = entry->bloom;
+            return true;
+        }
+    }
+
+    // Compute without holding the lock
+    auto computed = std::make_shared<LeafBloomFilter>(); // Throws
+    compute(*computed);
+
+    std::lock_guard lock(m_mutex);
+    m_entries[ref].bloom = computed; // Throws
+    bloom = std::move(computed);
+    return true;
+}
+
 ParentNode::ParentNode(const ParentNode& from)
     : m_child(from.m_child ? from.m_child->clone() : nullptr)
     , m_condition_column_key(from.m_condition_column_key)
+    , m_placeholder(from.m_placeholder)
     , m_dD(from.m_dD)
     , m_dT(from.m_dT)
     , m_probes(from.m_probes)
@@ -38,6 +109,19 @@ ParentNode::ParentNode(const ParentNode& from)
 {
 }
 
+size_t ParentNode::rebind(size_t placeholder, Mixed value)
+{
+    size_t count = 0;
+    for (ParentNode* node = this; node; node = node->m_child.get()) {
+        if (node->m_placeholder == placeholder) {
+            if (!node->rebind_value(value))
+                throw LogicError(LogicError::type_mismatch);
+            ++count;
+        }
+        count += node->rebind_nested(placeholder, value);
+    }
+    return count;
+}
 
 size_t ParentNode::find_first(size_t start, size_t end)
 {
@@ -103,6 +187,13 @@ size_t ParentNode::aggregate_local(QueryStateBase* st, size_t start, size_t end,
     size_t local_matches = 0;
 
     if (m_children.size() == 1) {
+        if (REALM_UNLIKELY(m_statistics)) {
+            size_t matches_before = st->match_count();
+            size_t r = find_all_local(start, end);
+            m_statistics->rows_scanned += end - start;
+            m_statistics->rows_matched += st->match_count() - matches_before;
+            return r;
+        }
         return find_all_local(start, end);
     }
 
@@ -116,6 +207,10 @@ size_t ParentNode::aggregate_local(QueryStateBase* st, size_t start, size_t end,
         // Find first match in this condition node
         auto pos = r + 1;
         r = find_first_local(pos, end);
+        if (REALM_UNLIKELY(m_statistics)) {
+            m_statistics->rows_scanned += (r == not_found ? end : r + 1) - pos;
+            m_statistics->rows_matched += r != not_found;
+        }
         if (r == not_found) {
             m_dD = double(pos - start) / (local_matches + 1.1);
             return end;
@@ -128,6 +223,10 @@ size_t ParentNode::aggregate_local(QueryStateBase* st, size_t start, size_t end,
 
         for (size_t c = 1; c < m_children.size(); c++) {
             m = m_children[c]->find_first_local(r, r + 1);
+            if (auto stats = m_children[c]->m_statistics.get(); REALM_UNLIKELY(stats)) {
+                stats->rows_tested++;
+                stats->rows_matched += m == r;
+            }
             if (m != r) {
                 break;
             }
@@ -176,6 +275,7 @@ void MixedNode<Equal>::init(bool will_query_ranges)
     }
     else {
         m_dT = 10.0;
+        init_type_filter(true);
     }
 
     if (m_has_search_index) {
@@ -229,6 +329,19 @@ size_t MixedNode<Equal>::find_first_local(size_t start, size_t end)
         }
     }
     else {
+        if (!leaf_may_match())
+            return not_found;
+
+        if (m_type_filter) {
+            // If the only comparable type held by the leaf is the type of the
+            // value, the leaf can search for it without materializing every
+            // element as Mixed.
+            uint32_t value_type_bit =
+                m_value_is_null ? ArrayMixed::null_type_bit : ArrayMixed::type_bit(m_value.get_type());
+            if ((m_leaf_types & m_types_to_match) == value_type_bit)
+                return m_leaf_ptr->find_first(m_value, start, end);
+        }
+
         Equal cond;
         for (size_t i = start; i < end; i++) {
             QueryValue val(m_leaf_ptr->get(i));
@@ -302,7 +415,7 @@ size_t StringNodeEqualBase::find_first_local(size_t start, size_t end)
 }
 
 
-size_t do_search_index(ObjKey& last_start_key, size_t& result_get, std::vector<ObjKey>& results,
+size_t do_search_index(ObjKey& last_start_key, size_t& result_get, const std::vector<ObjKey>& results,
                        const Cluster* cluster, size_t start, size_t end)
 {
     ObjKey first_key = cluster->get_real_key(start);
@@ -395,8 +508,28 @@ bool StringNode<Equal>::do_consume_condition(ParentNode& node)
     return true;
 }
 
+void StringNode<Equal>::init(bool will_query_ranges)
+{
+    StringNodeEqualBase::init(will_query_ranges);
+
+    m_needle_hashes.clear();
+    if (m_needles.empty()) {
+        m_needle_hashes.push_back(Mixed(m_value ? StringData(*m_value) : StringData()).hash());
+    }
+    else {
+        for (auto& needle : m_needles)
+            m_needle_hashes.push_back(Mixed(needle).hash());
+    }
+}
+
 size_t StringNode<Equal>::_find_first_local(size_t start, size_t end)
 {
+    if (m_bloom.cannot_match(m_needle_hashes))
+        return not_found;
+
+    if (m_leaf_ptr->is_dict_encoded())
+        return find_first_dict_encoded(start, end);
+
     if (m_needles.empty()) {
         return m_leaf_ptr->find_first(m_value, start, end);
     }
@@ -408,6 +541,40 @@ size_t StringNode<Equal>::_find_first_local(size_t start, size_t end)
     }
 }
 
+// The needles are looked up in the dictionary once per leaf, after which only
+// the integer codes of the elements are compared.
+size_t StringNode<Equal>::find_first_dict_encoded(size_t start, size_t end)
+{
+    if (!m_dict_codes_valid) {
+        if (m_needles.empty()) {
+            m_dict_code = m_leaf_ptr->find_dict_code(m_value);
+        }
+        else {
+            size_t num_values = m_leaf_ptr->get_dict_size();
+            m_dict_matches.assign(num_values, false);
+            for (auto& needle : m_needles) {
+                size_t code = m_leaf_ptr->find_dict_code(needle);
+                if (code != npos)
+                    m_dict_matches[code] = true;
+            }
+        }
+        m_dict_codes_valid = true;
+    }
+
+    if (end == npos)
+        end = m_leaf_ptr->size();
+    if (m_needles.empty()) {
+        if (m_dict_code == npos)
+            return not_found;
+        return m_leaf_ptr->find_first_dict_code(m_dict_code, start, end);
+    }
+    for (size_t i = start; i < end; ++i) {
+        if (m_dict_matches[m_leaf_ptr->get_dict_code(i)])
+            return i;
+    }
+    return not_found;
+}
+
 std::string StringNode<Equal>::describe(util::serializer::SerialisationState& state) const
 {
     if (m_needles.empty()) {
@@ -753,6 +920,11 @@ size_t ExpressionNode::find_first_local(size_t start, size_t end)
     return m_expression->find_first(start, end);
 }
 
+bool ExpressionNode::rebind_value(Mixed value)
+{
+    return m_expression->rebind_value(value);
+}
+
 std::unique_ptr<ParentNode> ExpressionNode::clone() const
 {
     return std::unique_ptr<ParentNode>(new ExpressionNode(*this));
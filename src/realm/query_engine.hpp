@@ -85,6 +85,7 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #define REALM_QUERY_ENGINE_HPP
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <sstream>
 #include <string>
@@ -103,6 +104,7 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <realm/array_bool.hpp>
 #include <realm/array_backlink.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/geospatial.hpp>
 #include <realm/metrics/query_info.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/table.hpp>
@@ -112,8 +114,11 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <realm/util/serializer.hpp>
 #include <realm/utilities.hpp>
 #include <realm/index_string.hpp>
+#include <realm/index_fulltext.hpp>
 
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #if REALM_X86_OR_X64_TRUE && defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219
@@ -140,6 +145,249 @@ const size_t bitwidth_time_unit = 64;
 typedef bool (*CallbackDummy)(int64_t);
 using Evaluator = util::FunctionRef<bool(const Obj& obj)>;
 
+// Range of the values held by a column leaf. Conditions on columns holding
+// naturally ordered data (e.g. timestamps of objects inserted over time) use
+// it to skip leaves that cannot hold a match.
+struct LeafRange {
+    Mixed min; // Null if the leaf holds no values other than null
+    Mixed max;
+    bool has_null = false;
+    bool is_ordered = true; // False if the leaf holds NaN, in which case nothing can be skipped
+
+    // Floats and doubles are read as non-nullable, with null stored as a
+    // specific NaN, so 'nullable_float' tells how to treat NaN.
+    template <class LeafType>
+    void compute(const LeafType& leaf, bool nullable_float)
+    {
+        size_t sz = leaf.size();
+        for (size_t i = 0; i < sz; i++) {
+            Mixed value = leaf.get_any(i);
+            if (is_nan(value)) {
+                if (nullable_float && (value.is_type(type_Float) ? null::is_null_float(value.get_float())
+                                                                 : null::is_null_float(value.get_double()))) {
+                    has_null = true;
+                    continue;
+                }
+                is_ordered = false;
+                return;
+            }
+            if (value.is_null()) {
+                has_null = true;
+            }
+            else if (min.is_null()) {
+                min = max = value;
+            }
+            else if (value < min) {
+                min = value;
+            }
+            else if (value > max) {
+                max = value;
+            }
+        }
+    }
+
+    template <class TConditionFunction>
+    bool may_match(const Mixed& value) const
+    {
+        if (!is_ordered || is_nan(value))
+            return true;
+        if (value.is_null()) {
+            if constexpr (std::is_same_v<TConditionFunction, Equal>)
+                return has_null;
+            return true;
+        }
+        // Null never compares equal, less or greater than a value
+        if constexpr (std::is_same_v<TConditionFunction, Equal>)
+            return !min.is_null() && min <= value && value <= max;
+        if constexpr (std::is_same_v<TConditionFunction, Greater>)
+            return !max.is_null() && max > value;
+        if constexpr (std::is_same_v<TConditionFunction, GreaterEqual>)
+            return !max.is_null() && max >= value;
+        if constexpr (std::is_same_v<TConditionFunction, Less>)
+            return !min.is_null() && min < value;
+        if constexpr (std::is_same_v<TConditionFunction, LessEqual>)
+            return !min.is_null() && min <= value;
+        return true;
+    }
+
+    static bool is_nan(const Mixed& value)
+    {
+        if (value.is_type(type_Float))
+            return std::isnan(value.get_float());
+        if (value.is_type(type_Double))
+            return std::isnan(value.get_double());
+        if (value.is_type(type_Decimal))
+            return value.get_decimal().is_nan();
+        return false;
+    }
+};
+
+// Bloom filter over the values of a column leaf. Equality conditions on
+// unindexed columns use it to skip leaves that cannot hold the value.
+class LeafBloomFilter {
+public:
+    template <class LeafType>
+    void compute(const LeafType& leaf)
+    {
+        size_t sz = leaf.size();
+        // About 8 bits per value with 3 probes gives 3% false positives
+        size_t num_words = 1;
+        while (num_words * 64 < sz * 8)
+            num_words <<= 1;
+        m_bits.assign(num_words, 0); // Throws
+        m_mask = num_words * 64 - 1;
+        for (size_t i = 0; i < sz; i++) {
+            for_each_probe(leaf.get_any(i).hash(), [&](size_t bit) {
+                m_bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+                return true;
+            });
+        }
+    }
+
+    // 'hash' must be the hash of the value as a Mixed
+    bool may_contain(size_t hash) const noexcept
+    {
+        if (m_bits.empty())
+            return true;
+        return for_each_probe(hash, [&](size_t bit) {
+            return (m_bits[bit >> 6] >> (bit & 63)) & 1;
+        });
+    }
+
+private:
+    std::vector<uint64_t> m_bits;
+    size_t m_mask = 0;
+
+    template <class F>
+    bool for_each_probe(size_t hash, F&& func) const
+    {
+        uint64_t h = uint64_t(hash) * 0x9E3779B97F4A7C15ULL;
+        uint64_t step = (h >> 32) | 1;
+        for (int i = 0; i < 3; i++) {
+            if (!func(size_t((h >> 16) & m_mask)))
+                return false;
+            h += step;
+        }
+        return true;
+    }
+};
+
+// Summaries (ranges and Bloom filters) of the column leaves read through one
+// allocator. Leaves are identified by ref, so only leaves that are part of
+// the snapshot (and thereby immutable) are cached. As every table has its own
+// allocator, the cache is kept when moving to another snapshot, and dropped
+// only when the table is modified, see Table::drop_leaf_summaries(). The
+// summary of a leaf is only computed the second time the leaf is scanned, so
+// that queries run once do not pay for it, unless asked for right away.
+class LeafSummaryCache {
+public:
+    static constexpr size_t max_entries = 0x10000;
+
+    static std::shared_ptr<LeafSummaryCache> get(Allocator& alloc);
+
+    // Returns false if the summary of the leaf is not known
+    bool lookup(ref_type ref, LeafRange& range, util::FunctionRef<void(LeafRange&)> compute,
+                bool summarize_now = false);
+    bool lookup(ref_type ref, std::shared_ptr<const LeafBloomFilter>& bloom,
+                util::FunctionRef<void(LeafBloomFilter&)> compute);
+
+private:
+    struct Entry {
+        bool has_range = false;
+        LeafRange range;
+        std::shared_ptr<const LeafBloomFilter> bloom;
+    };
+
+    // Returns nullptr, after registering the leaf, if it is seen for the first time
+    Entry* find(ref_type ref);
+
+    std::mutex m_mutex;
+    std::unordered_map<ref_type, Entry> m_entries;
+};
+
+// Used by condition nodes to decide whether the current leaf can be skipped
+class LeafRangeFilter {
+public:
+    template <class LeafType>
+    void leaf_changed(const LeafType& leaf, Allocator& alloc, bool nullable_float = false)
+    {
+        m_state = State::MayMatch;
+        ref_type ref = leaf.get_ref();
+        if (!ref || !alloc.is_read_only(ref))
+            return;
+        auto cache = LeafSummaryCache::get(alloc);
+        if (cache->lookup(
+                ref, m_range,
+                [&](LeafRange& range) {
+                    range.compute(leaf, nullable_float);
+                },
+                m_summarize_now))
+            m_state = State::Unknown;
+    }
+
+    // Compute the range of a leaf the first time it is scanned, for columns
+    // that are expected to be queried over and over
+    void set_summarize_now(bool summarize_now) noexcept
+    {
+        m_summarize_now = summarize_now;
+    }
+
+    template <class TConditionFunction>
+    bool cannot_match(const Mixed& value)
+    {
+        if (REALM_UNLIKELY(m_state == State::Unknown)) {
+            m_state = m_range.may_match<TConditionFunction>(value) ? State::MayMatch : State::CannotMatch;
+        }
+        return m_state == State::CannotMatch;
+    }
+
+private:
+    enum class State { Unknown, MayMatch, CannotMatch };
+    State m_state = State::MayMatch;
+    LeafRange m_range;
+    bool m_summarize_now = false;
+};
+
+// Used by equality conditions to decide whether the current leaf can be skipped
+class LeafBloomSkipper {
+public:
+    template <class LeafType>
+    void leaf_changed(const LeafType& leaf, Allocator& alloc)
+    {
+        m_state = State::MayMatch;
+        m_bloom.reset();
+        ref_type ref = leaf.get_ref();
+        if (!ref || !alloc.is_read_only(ref))
+            return;
+        auto cache = LeafSummaryCache::get(alloc);
+        if (cache->lookup(ref, m_bloom, [&](LeafBloomFilter& bloom) {
+                bloom.compute(leaf);
+            }))
+            m_state = State::Unknown;
+    }
+
+    // 'hashes' are the hashes of the values searched for, as Mixed
+    template <class Hashes>
+    bool cannot_match(const Hashes& hashes)
+    {
+        if (REALM_UNLIKELY(m_state == State::Unknown)) {
+            m_state = State::CannotMatch;
+            for (size_t hash : hashes) {
+                if (m_bloom->may_contain(hash)) {
+                    m_state = State::MayMatch;
+                    break;
+                }
+            }
+        }
+        return m_state == State::CannotMatch;
+    }
+
+private:
+    enum class State { Unknown, MayMatch, CannotMatch };
+    State m_state = State::MayMatch;
+    std::shared_ptr<const LeafBloomFilter> m_bloom;
+};
+
 class ParentNode {
     typedef ParentNode ThisType;
 
@@ -155,6 +403,11 @@ public:
     {
         return s_dummy_keys;
     }
+    // The number of keys index_based_keys() would return
+    virtual size_t index_based_count()
+    {
+        return index_based_keys().size();
+    }
 
     void gather_children(std::vector<ParentNode*>& v)
     {
@@ -209,6 +462,8 @@ public:
     void set_cluster(const Cluster* cluster)
     {
         m_cluster = cluster;
+        if (REALM_UNLIKELY(m_statistics))
+            m_statistics->leaves++;
         if (m_child)
             m_child->set_cluster(cluster);
         cluster_changed();
@@ -287,6 +542,9 @@ public:
             return false;
         if (m_child || other.m_child)
             return false;
+        // A condition bound to a placeholder must stay a node of its own to be rebound
+        if (m_placeholder != npos || other.m_placeholder != npos)
+            return false;
         if (typeid(*this) != typeid(other))
             return false;
 
@@ -304,9 +562,16 @@ public:
         return do_consume_condition(other);
     }
 
+    // Replaces the value compared with by the conditions bound to 'placeholder'
+    // in this node, the nodes nested in it and the nodes ANDed on. Returns the
+    // number of conditions rebound. Throws if a condition can't compare with a
+    // value of that type.
+    size_t rebind(size_t placeholder, Mixed value);
+
     std::unique_ptr<ParentNode> m_child;
     std::vector<ParentNode*> m_children;
     mutable ColKey m_condition_column_key = ColKey(); // Column of search criteria
+    size_t m_placeholder = npos;                      // Query argument bound to, see Query::rebind()
     ArrayPayload* m_source_column = nullptr;
 
     double m_dD;       // Average row distance between each local match at current position
@@ -316,6 +581,16 @@ public:
     size_t m_probes = 0;
     size_t m_matches = 0;
 
+    // Collected while running Query::explain_analyze()
+    struct Statistics {
+        size_t leaves = 0;
+        size_t rows_scanned = 0; // Rows searched by this condition while it was driving the query
+        size_t rows_tested = 0;  // Matches of other conditions this condition was tested on
+        size_t rows_matched = 0; // Scanned or tested rows matching this condition
+        std::chrono::nanoseconds time{0}; // Time spent in aggregate_local() on this node
+    };
+    std::unique_ptr<Statistics> m_statistics;
+
 protected:
     ConstTableRef m_table = ConstTableRef();
     const Cluster* m_cluster = nullptr;
@@ -340,6 +615,15 @@ private:
     {
         return false;
     }
+    // Returns false if the condition can't compare with the value
+    virtual bool rebind_value(Mixed)
+    {
+        return false;
+    }
+    virtual size_t rebind_nested(size_t, Mixed)
+    {
+        return 0;
+    }
 };
 
 
@@ -387,6 +671,15 @@ protected:
         m_array_ptr = LeafPtr(new (&m_leaf_cache_storage) LeafType(m_table.unchecked_ptr()->get_alloc()));
         m_cluster->init_leaf(this->m_condition_column_key, m_array_ptr.get());
         m_leaf_ptr = m_array_ptr.get();
+        m_range_filter.leaf_changed(*m_leaf_ptr, m_table.unchecked_ptr()->get_alloc());
+    }
+
+    void table_changed() override
+    {
+        // Caches poll the modification versions of objects, see Query::modified_since(). Most
+        // leaves then hold only older versions, and are skipped once their range is known.
+        m_range_filter.set_summarize_now(m_table->get_modification_version_column() ==
+                                         this->m_condition_column_key);
     }
 
     void init(bool will_query_ranges) override
@@ -428,6 +721,14 @@ protected:
                describe_condition() + " " + util::serializer::print_value(this->m_value);
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_Int))
+            return false;
+        m_value = value.get_int();
+        return true;
+    }
+
 
     // Search value:
     TConditionValue m_value;
@@ -438,6 +739,7 @@ protected:
     LeafCacheStorage m_leaf_cache_storage;
     LeafPtr m_array_ptr;
     const LeafType* m_leaf_ptr = nullptr;
+    LeafRangeFilter m_range_filter;
 };
 
 
@@ -460,11 +762,15 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (this->m_range_filter.template cannot_match<TConditionFunction>(Mixed(this->m_value)))
+            return realm::npos;
         return this->m_leaf_ptr->template find_first<TConditionFunction>(this->m_value, start, end);
     }
 
     size_t find_all_local(size_t start, size_t end) override
     {
+        if (this->m_range_filter.template cannot_match<TConditionFunction>(Mixed(this->m_value)))
+            return end;
         return BaseType::template find_all_local<TConditionFunction>(start, end);
     }
 
@@ -522,10 +828,10 @@ public:
         m_nb_needles = m_needles.size();
 
         if (has_search_index()) {
-            // _search_index_init();
+            // The matches are looked up when first needed, as a count is
+            // answered by the index without them
             m_result.clear();
-            auto index = ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key);
-            index->find_all(m_result, BaseType::m_value);
+            m_result_valid = false;
             m_result_get = 0;
             m_last_start_key = ObjKey();
             IntegerNodeBase<LeafType>::m_dT = 0;
@@ -551,9 +857,22 @@ public:
 
     const std::vector<ObjKey>& index_based_keys() override
     {
+        if (!m_result_valid) {
+            auto index = ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key);
+            index->find_all(m_result, BaseType::m_value);
+            m_result_valid = true;
+        }
         return m_result;
     }
 
+    size_t index_based_count() override
+    {
+        if (m_result_valid)
+            return m_result.size();
+        auto index = ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key);
+        return index->count(BaseType::m_value);
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         REALM_ASSERT(this->m_table);
@@ -564,7 +883,11 @@ public:
                 s = find_first_haystack<22>(*this->m_leaf_ptr, m_needles, start, end);
             }
             else if (has_search_index()) {
-                return do_search_index(m_last_start_key, m_result_get, m_result, BaseType::m_cluster, start, end);
+                return do_search_index(m_last_start_key, m_result_get, index_based_keys(), BaseType::m_cluster, start,
+                                       end);
+            }
+            else if (this->m_range_filter.template cannot_match<Equal>(Mixed(this->m_value))) {
+                return realm::npos;
             }
             else if (end - start == 1) {
                 if (this->m_leaf_ptr->get(start) == this->m_value) {
@@ -581,6 +904,8 @@ public:
 
     size_t find_all_local(size_t start, size_t end) override
     {
+        if (!m_nb_needles && this->m_range_filter.template cannot_match<Equal>(Mixed(this->m_value)))
+            return end;
         return BaseType::template find_all_local<Equal>(start, end);
     }
 
@@ -616,6 +941,7 @@ public:
 private:
     std::unordered_set<TConditionValue> m_needles;
     std::vector<ObjKey> m_result;
+    bool m_result_valid = false;
     size_t m_nb_needles = 0;
     size_t m_result_get = 0;
     ObjKey m_last_start_key;
@@ -659,10 +985,16 @@ public:
         m_array_ptr = LeafPtr(new (&m_leaf_cache_storage) LeafType(m_table.unchecked_ptr()->get_alloc()));
         m_cluster->init_leaf(this->m_condition_column_key, m_array_ptr.get());
         m_leaf_ptr = m_array_ptr.get();
+        m_range_filter.leaf_changed(*m_leaf_ptr, m_table.unchecked_ptr()->get_alloc(),
+                                    m_table.unchecked_ptr()->is_nullable(m_condition_column_key));
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        bool value_is_null = null::is_null_float(m_value) && m_table->is_nullable(m_condition_column_key);
+        if (m_range_filter.cannot_match<TConditionFunction>(value_is_null ? Mixed() : Mixed(m_value)))
+            return not_found;
+
         TConditionFunction cond;
 
         auto find = [&](bool nullability) {
@@ -706,6 +1038,14 @@ public:
     }
 
 protected:
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(ColumnTypeTraits<TConditionValue>::id))
+            return false;
+        m_value = value.get<TConditionValue>();
+        return true;
+    }
+
     TConditionValue m_value;
     // Leaf cache
     using LeafCacheStorage = typename std::aligned_storage<sizeof(LeafType), alignof(LeafType)>::type;
@@ -713,6 +1053,7 @@ protected:
     LeafCacheStorage m_leaf_cache_storage;
     LeafPtr m_array_ptr;
     const LeafType* m_leaf_ptr = nullptr;
+    LeafRangeFilter m_range_filter;
 };
 
 template <class T, class TConditionFunction>
@@ -964,6 +1305,14 @@ public:
     }
 
 private:
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_Bool))
+            return false;
+        m_value = value.get_bool();
+        return true;
+    }
+
     util::Optional<bool> m_value;
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayBoolNull), alignof(ArrayBoolNull)>::type;
     using LeafPtr = std::unique_ptr<ArrayBoolNull, PlacementDelete>;
@@ -995,6 +1344,7 @@ public:
         m_array_ptr = LeafPtr(new (&m_leaf_cache_storage) ArrayTimestamp(m_table.unchecked_ptr()->get_alloc()));
         m_cluster->init_leaf(this->m_condition_column_key, m_array_ptr.get());
         m_leaf_ptr = m_array_ptr.get();
+        m_range_filter.leaf_changed(*m_leaf_ptr, m_table.unchecked_ptr()->get_alloc());
     }
 
 protected:
@@ -1004,12 +1354,21 @@ protected:
     {
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_Timestamp))
+            return false;
+        m_value = value.get_timestamp();
+        return true;
+    }
+
     Timestamp m_value;
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayTimestamp), alignof(ArrayTimestamp)>::type;
     using LeafPtr = std::unique_ptr<ArrayTimestamp, PlacementDelete>;
     LeafCacheStorage m_leaf_cache_storage;
     LeafPtr m_array_ptr;
     const ArrayTimestamp* m_leaf_ptr = nullptr;
+    LeafRangeFilter m_range_filter;
 };
 
 template <class TConditionFunction>
@@ -1019,6 +1378,8 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_range_filter.cannot_match<TConditionFunction>(Mixed(m_value)))
+            return not_found;
         return m_leaf_ptr->find_first<TConditionFunction>(m_value, start, end);
     }
 
@@ -1063,6 +1424,7 @@ public:
         m_array_ptr = LeafPtr(new (&m_leaf_cache_storage) ArrayDecimal128(m_table.unchecked_ptr()->get_alloc()));
         m_cluster->init_leaf(this->m_condition_column_key, m_array_ptr.get());
         m_leaf_ptr = m_array_ptr.get();
+        m_range_filter.leaf_changed(*m_leaf_ptr, m_table.unchecked_ptr()->get_alloc());
     }
 
     void init(bool will_query_ranges) override
@@ -1079,12 +1441,21 @@ protected:
     {
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_Decimal))
+            return false;
+        m_value = value.get_decimal();
+        return true;
+    }
+
     Decimal128 m_value;
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayDecimal128), alignof(ArrayDecimal128)>::type;
     using LeafPtr = std::unique_ptr<ArrayDecimal128, PlacementDelete>;
     LeafCacheStorage m_leaf_cache_storage;
     LeafPtr m_array_ptr;
     const ArrayDecimal128* m_leaf_ptr = nullptr;
+    LeafRangeFilter m_range_filter;
 };
 
 template <class TConditionFunction>
@@ -1094,6 +1465,9 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_range_filter.cannot_match<TConditionFunction>(Mixed(m_value)))
+            return realm::npos;
+
         TConditionFunction cond;
         bool value_is_null = m_value.is_null();
         for (size_t i = start; i < end; i++) {
@@ -1123,7 +1497,7 @@ protected:
     }
 };
 
-size_t do_search_index(ObjKey& last_start_key, size_t& result_get, std::vector<ObjKey>& results,
+size_t do_search_index(ObjKey& last_start_key, size_t& result_get, const std::vector<ObjKey>& results,
                        const Cluster* cluster, size_t start, size_t end);
 
 template <class ObjectType, class ArrayType>
@@ -1167,6 +1541,15 @@ protected:
     {
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(ColumnTypeTraits<ObjectType>::id))
+            return false;
+        m_value = value.get<ObjectType>();
+        m_value_is_null = false;
+        return true;
+    }
+
     ObjectType m_value;
     bool m_value_is_null = false;
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayType), alignof(ArrayType)>::type;
@@ -1232,12 +1615,12 @@ public:
         if (!this->m_value_is_null) {
             m_optional_value = this->m_value;
         }
+        m_value_hash[0] = (this->m_value_is_null ? Mixed() : Mixed(this->m_value)).hash();
 
         if (has_search_index()) {
-            // _search_index_init();
+            // Looked up when first needed, see index_based_count()
             m_result.clear();
-            auto index = BaseType::m_table->get_search_index(BaseType::m_condition_column_key);
-            index->find_all(m_result, m_optional_value);
+            m_result_valid = false;
             m_result_get = 0;
             m_last_start_key = ObjKey();
             this->m_dT = 0;
@@ -1246,14 +1629,34 @@ public:
 
     const std::vector<ObjKey>& index_based_keys() override
     {
+        if (!m_result_valid) {
+            auto index = BaseType::m_table->get_search_index(BaseType::m_condition_column_key);
+            index->find_all(m_result, m_optional_value);
+            m_result_valid = true;
+        }
         return m_result;
     }
 
+    size_t index_based_count() override
+    {
+        if (m_result_valid)
+            return m_result.size();
+        auto index = BaseType::m_table->get_search_index(BaseType::m_condition_column_key);
+        return index->count(m_optional_value);
+    }
+
     bool has_search_index() const override
     {
         return this->m_table->has_search_index(BaseType::m_condition_column_key);
     }
 
+    void cluster_changed() override
+    {
+        BaseType::cluster_changed();
+        if (!has_search_index())
+            m_bloom.leaf_changed(*this->m_leaf_ptr, this->m_table.unchecked_ptr()->get_alloc());
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         REALM_ASSERT(this->m_table);
@@ -1261,7 +1664,11 @@ public:
 
         if (start < end) {
             if (has_search_index()) {
-                return do_search_index(m_last_start_key, m_result_get, m_result, this->m_cluster, start, end);
+                return do_search_index(m_last_start_key, m_result_get, index_based_keys(), this->m_cluster, start,
+                                       end);
+            }
+            if (m_bloom.cannot_match(m_value_hash)) {
+                return s;
             }
 
             if (end - start == 1) {
@@ -1297,7 +1704,10 @@ protected:
     {
     }
     util::Optional<ObjectType> m_optional_value;
+    std::array<size_t, 1> m_value_hash;
+    LeafBloomSkipper m_bloom;
     std::vector<ObjKey> m_result;
+    bool m_result_valid = false;
     size_t m_result_get = 0;
     ObjKey m_last_start_key;
 };
@@ -1334,6 +1744,9 @@ public:
         m_array_ptr = LeafPtr(new (&m_leaf_cache_storage) ArrayMixed(m_table.unchecked_ptr()->get_alloc()));
         m_cluster->init_leaf(this->m_condition_column_key, m_array_ptr.get());
         m_leaf_ptr = m_array_ptr.get();
+        if (m_type_filter) {
+            m_leaf_types = m_leaf_ptr->get_type_mask();
+        }
     }
 
     void init(bool will_query_ranges) override
@@ -1376,9 +1789,47 @@ protected:
         }
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        m_value = value;
+        m_value_is_null = value.is_null();
+        get_ownership();
+        // Set up again by init() if the condition uses it for the new value
+        m_type_filter = false;
+        return true;
+    }
+
+    // Used by conditions that can only match values of a type comparable to
+    // the value searched for, and possibly null. Leaves holding none of these
+    // types are skipped.
+    void init_type_filter(bool null_matches_null)
+    {
+        if (m_value_is_null) {
+            m_types_to_match = null_matches_null ? ArrayMixed::null_type_bit : 0;
+            m_type_filter = true;
+        }
+        else if (!m_value.is_type(type_TypeOfValue)) {
+            DataType value_type = m_value.get_type();
+            m_types_to_match = 0;
+            for (int t = 0; t < 31; t++) {
+                if (Mixed::data_types_are_comparable(value_type, DataType(t)))
+                    m_types_to_match |= ArrayMixed::type_bit(DataType(t));
+            }
+            m_type_filter = true;
+        }
+    }
+
+    bool leaf_may_match() const
+    {
+        return !m_type_filter || (m_leaf_types & m_types_to_match);
+    }
+
     QueryValue m_value;
     OwnedBinaryData m_buffer;
     bool m_value_is_null = false;
+    bool m_type_filter = false;
+    uint32_t m_types_to_match = 0;
+    uint32_t m_leaf_types = 0;
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayMixed), alignof(ArrayMixed)>::type;
     using LeafPtr = std::unique_ptr<ArrayMixed, PlacementDelete>;
     LeafCacheStorage m_leaf_cache_storage;
@@ -1391,8 +1842,29 @@ class MixedNode : public MixedNodeBase {
 public:
     using MixedNodeBase::MixedNodeBase;
 
+    void init(bool will_query_ranges) override
+    {
+        MixedNodeBase::init(will_query_ranges);
+
+        if constexpr (realm::is_any_v<TConditionFunction, Contains, ContainsIns>) {
+            // A null pattern is contained in any value
+            if (!m_value_is_null)
+                init_type_filter(false);
+        }
+        else if constexpr (realm::is_any_v<TConditionFunction, Greater, Less, BeginsWith, BeginsWithIns, EndsWith,
+                                           EndsWithIns>) {
+            init_type_filter(false);
+        }
+        else if constexpr (realm::is_any_v<TConditionFunction, EqualIns, Like, LikeIns, GreaterEqual, LessEqual>) {
+            init_type_filter(true);
+        }
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (!leaf_may_match())
+            return realm::npos;
+
         TConditionFunction cond;
         for (size_t i = start; i < end; i++) {
             QueryValue val(m_leaf_ptr->get(i));
@@ -1554,6 +2026,20 @@ public:
 protected:
     util::Optional<std::string> m_value;
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_String))
+            return false;
+        m_value = std::string(value.get_string());
+        return value_changed();
+    }
+
+    // Updates what the node derives from m_value. Returns false if it is not valid UTF-8.
+    virtual bool value_changed()
+    {
+        return true;
+    }
+
     using LeafCacheStorage = typename std::aligned_storage<sizeof(ArrayString), alignof(ArrayString)>::type;
     using LeafPtr = std::unique_ptr<ArrayString, PlacementDelete>;
     LeafCacheStorage m_leaf_cache_storage;
@@ -1579,15 +2065,8 @@ public:
     StringNode(StringData v, ColKey column)
         : StringNodeBase(v, column)
     {
-        auto upper = case_map(v, true);
-        auto lower = case_map(v, false);
-        if (!upper || !lower) {
+        if (!value_changed())
             error_code = "Malformed UTF-8: " + std::string(v);
-        }
-        else {
-            m_ucase = std::move(*upper);
-            m_lcase = std::move(*lower);
-        }
     }
 
     void init(bool will_query_ranges) override
@@ -1629,6 +2108,18 @@ public:
 protected:
     std::string m_ucase;
     std::string m_lcase;
+
+    bool value_changed() override
+    {
+        StringData v = m_value ? StringData(*m_value) : StringData();
+        auto upper = case_map(v, true);
+        auto lower = case_map(v, false);
+        if (!upper || !lower)
+            return false;
+        m_ucase = std::move(*upper);
+        m_lcase = std::move(*lower);
+        return true;
+    }
 };
 
 // Specialization for Contains condition on Strings - we specialize because we can utilize Boyer-Moore
@@ -1639,20 +2130,9 @@ public:
         : StringNodeBase(v, column)
         , m_charmap()
     {
-        if (v.size() == 0)
-            return;
-
-        // Build a dictionary of char-to-last distances in the search string
-        // (zero indicates that the char is not in needle)
-        size_t last_char_pos = v.size() - 1;
-        for (size_t i = 0; i < last_char_pos; ++i) {
-            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
-            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
-
-            unsigned char c = v[i];
-            m_charmap[c] = jump;
-        }
-        m_dT = 50.0;
+        value_changed();
+        if (v.size() != 0)
+            m_dT = 50.0;
     }
 
     void init(bool will_query_ranges) override
@@ -1694,6 +2174,26 @@ public:
 
 protected:
     std::array<uint8_t, 256> m_charmap;
+
+    bool value_changed() override
+    {
+        m_charmap.fill(0);
+        if (!m_value || m_value->empty())
+            return true;
+
+        // Build a dictionary of char-to-last distances in the search string
+        // (zero indicates that the char is not in needle)
+        const std::string& v = *m_value;
+        size_t last_char_pos = v.size() - 1;
+        for (size_t i = 0; i < last_char_pos; ++i) {
+            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
+            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
+
+            unsigned char c = v[i];
+            m_charmap[c] = jump;
+        }
+        return true;
+    }
 };
 
 // Specialization for ContainsIns condition on Strings - we specialize because we can utilize Boyer-Moore
@@ -1704,32 +2204,10 @@ public:
         : StringNodeBase(v, column)
         , m_charmap()
     {
-        auto upper = case_map(v, true);
-        auto lower = case_map(v, false);
-        if (!upper || !lower) {
+        if (!value_changed())
             error_code = "Malformed UTF-8: " + std::string(v);
-        }
-        else {
-            m_ucase = std::move(*upper);
-            m_lcase = std::move(*lower);
-        }
-
-        if (v.size() == 0)
-            return;
-
-        // Build a dictionary of char-to-last distances in the search string
-        // (zero indicates that the char is not in needle)
-        size_t last_char_pos = m_ucase.size() - 1;
-        for (size_t i = 0; i < last_char_pos; ++i) {
-            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
-            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
-
-            unsigned char uc = m_ucase[i];
-            unsigned char lc = m_lcase[i];
-            m_charmap[uc] = jump;
-            m_charmap[lc] = jump;
-        }
-        m_dT = 75.0;
+        if (v.size() != 0)
+            m_dT = 75.0;
     }
 
     void init(bool will_query_ranges) override
@@ -1778,6 +2256,35 @@ protected:
     std::array<uint8_t, 256> m_charmap;
     std::string m_ucase;
     std::string m_lcase;
+
+    bool value_changed() override
+    {
+        m_charmap.fill(0);
+        StringData v = m_value ? StringData(*m_value) : StringData();
+        auto upper = case_map(v, true);
+        auto lower = case_map(v, false);
+        if (!upper || !lower)
+            return false;
+        m_ucase = std::move(*upper);
+        m_lcase = std::move(*lower);
+
+        if (v.size() == 0)
+            return true;
+
+        // Build a dictionary of char-to-last distances in the search string
+        // (zero indicates that the char is not in needle)
+        size_t last_char_pos = m_ucase.size() - 1;
+        for (size_t i = 0; i < last_char_pos; ++i) {
+            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
+            uint8_t jump = last_char_pos - i < 255 ? static_cast<uint8_t>(last_char_pos - i) : 255;
+
+            unsigned char uc = m_ucase[i];
+            unsigned char lc = m_lcase[i];
+            m_charmap[uc] = jump;
+            m_charmap[lc] = jump;
+        }
+        return true;
+    }
 };
 
 class StringNodeEqualBase : public StringNodeBase {
@@ -1850,6 +2357,16 @@ public:
 
     void _search_index_init() override;
 
+    void init(bool will_query_ranges) override;
+
+    void cluster_changed() override
+    {
+        StringNodeEqualBase::cluster_changed();
+        m_dict_codes_valid = false;
+        if (!m_has_search_index)
+            m_bloom.leaf_changed(*m_leaf_ptr, m_table.unchecked_ptr()->get_alloc());
+    }
+
     bool do_consume_condition(ParentNode& other) override;
 
     std::unique_ptr<ParentNode> clone() const override
@@ -1888,6 +2405,11 @@ public:
         }
         return m_obj_key_buffer;
     }
+    // Counted without copying the matches out of the index
+    size_t index_based_count() override
+    {
+        return m_results_end - m_results_start;
+    }
 
 private:
     std::unique_ptr<IntegerColumn> m_index_matches;
@@ -1904,9 +2426,22 @@ private:
     }
 
     size_t _find_first_local(size_t start, size_t end) override;
+    size_t find_first_dict_encoded(size_t start, size_t end);
     std::unordered_set<StringData> m_needles;
     std::vector<std::unique_ptr<char[]>> m_needle_storage;
     std::vector<ObjKey> m_obj_key_buffer;
+
+    // The codes the needle(s) have in the dictionary of the current leaf, if
+    // it is dictionary encoded. m_dict_code is npos if the needle does not
+    // occur in the leaf. With multiple needles m_dict_matches tells which
+    // codes match.
+    bool m_dict_codes_valid = false;
+    size_t m_dict_code = npos;
+    std::vector<bool> m_dict_matches;
+
+    // Hashes of the needle(s), probed in the Bloom filter of the leaf
+    std::vector<size_t> m_needle_hashes;
+    LeafBloomSkipper m_bloom;
 };
 
 
@@ -1918,15 +2453,8 @@ public:
     StringNode(StringData v, ColKey column)
         : StringNodeEqualBase(v, column)
     {
-        auto upper = case_map(v, true);
-        auto lower = case_map(v, false);
-        if (!upper || !lower) {
+        if (!value_changed())
             error_code = "Malformed UTF-8: " + std::string(v);
-        }
-        else {
-            m_ucase = std::move(*upper);
-            m_lcase = std::move(*lower);
-        }
     }
 
     void clear_leaf_state() override
@@ -1976,6 +2504,195 @@ private:
     }
 
     size_t _find_first_local(size_t start, size_t end) override;
+
+    bool value_changed() override
+    {
+        StringData v = m_value ? StringData(*m_value) : StringData();
+        auto upper = case_map(v, true);
+        auto lower = case_map(v, false);
+        if (!upper || !lower)
+            return false;
+        m_ucase = std::move(*upper);
+        m_lcase = std::move(*lower);
+        return true;
+    }
+};
+
+// Condition on the words of a string column, see Query::fulltext(). The matches are looked up in the FulltextIndex
+// of the column, so the node takes part in the query like a node using a search index.
+class FulltextNode : public ParentNode {
+public:
+    FulltextNode(StringData text, ColKey column)
+        : m_text(text)
+    {
+        m_condition_column_key = column;
+        m_dT = 0.0;
+    }
+
+    void init(bool will_query_ranges) override
+    {
+        ParentNode::init(will_query_ranges);
+        m_result = m_table->get_fulltext_index(m_condition_column_key)->find_all(m_text);
+        m_result_get = 0;
+        m_last_start_key = ObjKey();
+    }
+
+    bool has_search_index() const override
+    {
+        return true;
+    }
+
+    const std::vector<ObjKey>& index_based_keys() override
+    {
+        return m_result;
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (start >= end)
+            return not_found;
+        return do_search_index(m_last_start_key, m_result_get, m_result, m_cluster, start, end);
+    }
+
+    std::string describe(util::serializer::SerialisationState& state) const override
+    {
+        return state.describe_column(ParentNode::m_table, m_condition_column_key) + " " + describe_condition() +
+               " " + util::serializer::print_value(StringData(m_text));
+    }
+
+    std::string describe_condition() const override
+    {
+        return "TEXT";
+    }
+
+    std::unique_ptr<ParentNode> clone() const override
+    {
+        return std::unique_ptr<ParentNode>(new FulltextNode(*this));
+    }
+
+    FulltextNode(const FulltextNode& from)
+        : ParentNode(from)
+        , m_text(from.m_text)
+    {
+    }
+
+private:
+    std::string m_text;
+    std::vector<ObjKey> m_result;
+    size_t m_result_get = 0;
+    ObjKey m_last_start_key;
+};
+
+// Condition on a point stored as latitude and longitude in two double columns, see Query::geo_within(). Both
+// leaves are tested together, and leaves which hold no latitude (or longitude) within the bounding box of the
+// region are skipped using their range. Null is stored as NaN, which is never within the box.
+class GeoWithinNode : public ParentNode {
+public:
+    GeoWithinNode(ColKey latitude, ColKey longitude, const GeoBox& box)
+        : m_longitude_key(longitude)
+        , m_box(box)
+    {
+        m_condition_column_key = latitude;
+        m_dT = 2.0;
+    }
+    GeoWithinNode(ColKey latitude, ColKey longitude, const GeoCircle& circle)
+        : GeoWithinNode(latitude, longitude, circle.bounding_box())
+    {
+        m_circle = circle;
+        m_is_circle = true;
+    }
+
+    void cluster_changed() override
+    {
+        Allocator& alloc = m_table.unchecked_ptr()->get_alloc();
+        if (!m_latitude_leaf) {
+            m_latitude_leaf = std::make_unique<ArrayDouble>(alloc);
+            m_longitude_leaf = std::make_unique<ArrayDouble>(alloc);
+        }
+        m_cluster->init_leaf(m_condition_column_key, m_latitude_leaf.get());
+        m_cluster->init_leaf(m_longitude_key, m_longitude_leaf.get());
+        m_latitude_lo.leaf_changed(*m_latitude_leaf, alloc, true);
+        m_latitude_hi = m_latitude_lo;
+        if (!crosses_antimeridian()) {
+            m_longitude_lo.leaf_changed(*m_longitude_leaf, alloc, true);
+            m_longitude_hi = m_longitude_lo;
+        }
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_latitude_lo.cannot_match<GreaterEqual>(m_box.lo.latitude) ||
+            m_latitude_hi.cannot_match<LessEqual>(m_box.hi.latitude))
+            return not_found;
+        bool wraps = crosses_antimeridian();
+        if (!wraps && (m_longitude_lo.cannot_match<GreaterEqual>(m_box.lo.longitude) ||
+                       m_longitude_hi.cannot_match<LessEqual>(m_box.hi.longitude)))
+            return not_found;
+
+        for (size_t s = start; s < end; ++s) {
+            GeoPoint point{m_latitude_leaf->get(s), m_longitude_leaf->get(s)};
+            if (!(point.latitude >= m_box.lo.latitude && point.latitude <= m_box.hi.latitude))
+                continue;
+            bool lo = point.longitude >= m_box.lo.longitude;
+            bool hi = point.longitude <= m_box.hi.longitude;
+            if (wraps ? !(lo || hi) : !(lo && hi))
+                continue;
+            if (m_is_circle && !(geo_distance_km(m_circle.center, point) <= m_circle.radius_km))
+                continue;
+            return s;
+        }
+        return not_found;
+    }
+
+    std::string describe(util::serializer::SerialisationState& state) const override
+    {
+        auto point = [](const GeoPoint& p) {
+            return "[" + util::serializer::print_value(p.latitude) + ", " +
+                   util::serializer::print_value(p.longitude) + "]";
+        };
+        std::string region = m_is_circle ? "geoCircle(" + point(m_circle.center) + ", " +
+                                               util::serializer::print_value(m_circle.radius_km) + ")"
+                                         : "geoBox(" + point(m_box.lo) + ", " + point(m_box.hi) + ")";
+        return state.describe_column(ParentNode::m_table, m_condition_column_key) + ", " +
+               state.describe_column(ParentNode::m_table, m_longitude_key) + " " + describe_condition() + " " +
+               region;
+    }
+
+    std::string describe_condition() const override
+    {
+        return "GEOWITHIN";
+    }
+
+    std::unique_ptr<ParentNode> clone() const override
+    {
+        return std::unique_ptr<ParentNode>(new GeoWithinNode(*this));
+    }
+
+    GeoWithinNode(const GeoWithinNode& from)
+        : ParentNode(from)
+        , m_longitude_key(from.m_longitude_key)
+        , m_box(from.m_box)
+        , m_circle(from.m_circle)
+        , m_is_circle(from.m_is_circle)
+    {
+    }
+
+private:
+    ColKey m_longitude_key;
+    GeoBox m_box;
+    GeoCircle m_circle;
+    bool m_is_circle = false;
+    std::unique_ptr<ArrayDouble> m_latitude_leaf;
+    std::unique_ptr<ArrayDouble> m_longitude_leaf;
+    LeafRangeFilter m_latitude_lo;
+    LeafRangeFilter m_latitude_hi;
+    LeafRangeFilter m_longitude_lo;
+    LeafRangeFilter m_longitude_hi;
+
+    bool crosses_antimeridian() const noexcept
+    {
+        return m_box.lo.longitude > m_box.hi.longitude;
+    }
 };
 
 // OR node contains at least two node pointers: Two or more conditions to OR
@@ -2135,6 +2852,14 @@ public:
     std::vector<std::unique_ptr<ParentNode>> m_conditions;
 
 private:
+    size_t rebind_nested(size_t placeholder, Mixed value) override
+    {
+        size_t count = 0;
+        for (auto& condition : m_conditions)
+            count += condition->rebind(placeholder, value);
+        return count;
+    }
+
     void combine_conditions(bool ignore_indexes)
     {
         std::sort(m_conditions.begin(), m_conditions.end(), [](auto& a, auto& b) {
@@ -2249,6 +2974,11 @@ private:
     size_t m_known_range_end;
     size_t m_first_in_known_range;
 
+    size_t rebind_nested(size_t placeholder, Mixed value) override
+    {
+        return m_condition ? m_condition->rebind(placeholder, value) : 0;
+    }
+
     bool evaluate_at(size_t rowndx);
     void update_known(size_t start, size_t end, size_t first);
     size_t find_first_loop(size_t start, size_t end);
@@ -2378,6 +3108,8 @@ public:
 private:
     ExpressionNode(const ExpressionNode& from);
 
+    bool rebind_value(Mixed value) override;
+
     std::unique_ptr<Expression> m_expression;
 };
 
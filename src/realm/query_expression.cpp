@@ -348,9 +348,25 @@ void ColumnDictionaryKeys::evaluate(size_t index, ValueBase& destination)
                 return false;
             });
         }
+        else {
+            // The dictionary has never been created
+            destination.init(true, 0);
+        }
     }
 }
 
+bool ColumnDictionaryKeys::contains(size_t index, Mixed value)
+{
+    REALM_ASSERT(m_leaf_ptr != nullptr);
+    if (!m_leaf_ptr->get(index))
+        return false;
+
+    DictionaryClusterTree dict_cluster(static_cast<Array*>(m_leaf_ptr), m_key_type,
+                                       m_link_map.get_base_table()->get_alloc(), index);
+    dict_cluster.init_from_parent();
+    return dict_cluster.try_get_with_key(Dictionary::get_internal_obj_key(value), value).index != realm::npos;
+}
+
 void ColumnDictionaryKey::evaluate(size_t index, ValueBase& destination)
 {
     if (links_exist()) {
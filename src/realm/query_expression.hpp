@@ -151,6 +151,7 @@ The Columns class encapsulates all this into a simple class that, for any type T
 
 #include <numeric>
 #include <algorithm>
+#include <unordered_set>
 
 // Normally, if a next-generation-syntax condition is supported by the old query_engine.hpp, a query_engine node is
 // created because it's faster (by a factor of 5 - 10). Because many of our existing next-generation-syntax unit
@@ -173,6 +174,11 @@ struct Plus {
     {
         return v1 + v2;
     }
+    template <class T>
+    static T apply(T v1, T v2)
+    {
+        return v1 + v2;
+    }
     static std::string description()
     {
         return "+";
@@ -184,6 +190,11 @@ struct Minus {
     {
         return v1 - v2;
     }
+    template <class T>
+    static T apply(T v1, T v2)
+    {
+        return v1 - v2;
+    }
     static std::string description()
     {
         return "-";
@@ -195,6 +206,16 @@ struct Div {
     {
         return v1 / v2;
     }
+    // Must agree with Mixed::operator/()
+    template <class T>
+    static T apply(T v1, T v2)
+    {
+        if constexpr (std::is_integral_v<T>) {
+            if (v2 == 0)
+                return v1 < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        return v1 / v2;
+    }
     static std::string description()
     {
         return "/";
@@ -206,6 +227,11 @@ struct Mul {
     {
         return v1 * v2;
     }
+    template <class T>
+    static T apply(T v1, T v2)
+    {
+        return v1 * v2;
+    }
     static std::string description()
     {
         return "*";
@@ -664,6 +690,12 @@ public:
     virtual ConstTableRef get_base_table() const = 0;
     virtual std::string description(util::serializer::SerialisationState& state) const = 0;
 
+    // See Subexpr::rebind_value()
+    virtual bool rebind_value(Mixed)
+    {
+        return false;
+    }
+
     virtual std::unique_ptr<Expression> clone() const = 0;
 };
 
@@ -727,6 +759,19 @@ public:
         return {};
     }
 
+    // For expressions yielding the elements of a collection: can
+    // contains() be used to check if the collection of an object has an
+    // element equal to `value`?
+    virtual bool can_search_for(Mixed) const
+    {
+        return false;
+    }
+
+    virtual bool contains(size_t, Mixed)
+    {
+        REALM_UNREACHABLE();
+    }
+
     virtual DataType get_type() const = 0;
 
     virtual void evaluate(size_t index, ValueBase& destination) = 0;
@@ -745,6 +790,35 @@ public:
     {
         return util::none;
     }
+
+    // Replaces the value of a constant, see Query::rebind(). Returns false if
+    // the expression is not a single constant value of the same type.
+    virtual bool rebind_value(Mixed)
+    {
+        return false;
+    }
+
+    // Vector-at-a-time evaluation. If the expression yields exactly one non-null value of type Int or
+    // Double per row, get_batch_type() returns that type, and evaluate_batch() stores the values of rows
+    // [start, end) of the current cluster contiguously in 'dest', without going through ValueBase. The
+    // range may be at most batch_size rows. Values of type Int may be requested as doubles, in which case
+    // they are converted after evaluation.
+    static constexpr size_t batch_size = 256;
+
+    virtual util::Optional<DataType> get_batch_type() const
+    {
+        return util::none;
+    }
+
+    virtual void evaluate_batch(size_t, size_t, int64_t*)
+    {
+        REALM_UNREACHABLE();
+    }
+
+    virtual void evaluate_batch(size_t, size_t, double*)
+    {
+        REALM_UNREACHABLE();
+    }
 };
 
 template <typename T, typename... Args>
@@ -1288,6 +1362,20 @@ public:
         destination = *this;
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        // Values referring to memory they don't own are rebound by the subclasses holding it
+        if constexpr (realm::is_any_v<T, int64_t, bool, float, double, Timestamp, Decimal128, ObjectId, UUID>) {
+            if (m_from_list || size() != 1 || !value.is_type(ColumnTypeTraits<T>::id))
+                return false;
+            set(0, value.get<T>());
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+
     std::unique_ptr<Subexpr> clone() const override
     {
         return make_subexpr<Value<T>>(*this);
@@ -1305,6 +1393,15 @@ public:
         begin()->use_buffer(m_buffer);
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (m_from_list || size() != 1)
+            return false;
+        set(0, value);
+        begin()->use_buffer(m_buffer);
+        return true;
+    }
+
     std::unique_ptr<Subexpr> clone() const override
     {
         return std::unique_ptr<Subexpr>(new ConstantMixedValue(*this));
@@ -1362,6 +1459,15 @@ public:
             set(0, *m_string);
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (!value.is_type(type_String))
+            return false;
+        m_string = std::string(value.get_string());
+        set(0, StringData(*m_string));
+        return true;
+    }
+
     std::unique_ptr<Subexpr> clone() const override
     {
         return std::unique_ptr<Subexpr>(new ConstantStringValue(*this));
@@ -1718,6 +1824,36 @@ public:
         return m_column_key;
     }
 
+    virtual ~ObjPropertyBase() = default;
+
+    // Call `func` with the key and the value of the property of every object in
+    // the target table of the link path, in key order.
+    virtual void for_each_target_value(util::FunctionRef<void(ObjKey, Mixed)> func) const = 0;
+
+    // Evaluate a comparison of the property for the object at `index` in the
+    // current cluster, given the sorted keys of the target objects for which
+    // the comparison holds, and whether it holds for a missing value.
+    bool links_match(size_t index, const std::vector<ObjKey>& target_matches, bool null_matches) const
+    {
+        auto is_match = [&](ObjKey k) {
+            return std::binary_search(target_matches.begin(), target_matches.end(), k);
+        };
+        if (m_link_map.only_unary_links()) {
+            ObjKey k = m_link_map.get_unary_link_or_not_found(index);
+            return k ? is_match(k) : null_matches;
+        }
+        std::vector<ObjKey> links = m_link_map.get_links(index);
+        switch (m_comparison_type.value_or(ExpressionComparisonType::Any)) {
+            case ExpressionComparisonType::Any:
+                return std::any_of(links.begin(), links.end(), is_match);
+            case ExpressionComparisonType::All:
+                return std::all_of(links.begin(), links.end(), is_match);
+            case ExpressionComparisonType::None:
+                return std::none_of(links.begin(), links.end(), is_match);
+        }
+        return false;
+    }
+
 protected:
     LinkMap m_link_map;
     // Column index of payload column of m_table
@@ -1789,6 +1925,17 @@ public:
         return ret;
     }
 
+    void for_each_target_value(util::FunctionRef<void(ObjKey, Mixed)> func) const final
+    {
+        if constexpr (realm::is_any_v<T, Int, Bool, Float, Double, ObjectId, UUID>) {
+            if (is_nullable()) {
+                for_each_target_value<typename ColumnTypeTraits<util::Optional<T>>::cluster_leaf_type>(func);
+                return;
+            }
+        }
+        for_each_target_value<typename ColumnTypeTraits<T>::cluster_leaf_type>(func);
+    }
+
     void collect_dependencies(std::vector<TableKey>& tables) const final
     {
         m_link_map.collect_dependencies(tables);
@@ -1808,6 +1955,22 @@ public:
     {
         return make_subexpr<Columns<T>>(static_cast<const Columns<T>&>(*this));
     }
+
+private:
+    template <class LeafType>
+    void for_each_target_value(util::FunctionRef<void(ObjKey, Mixed)> func) const
+    {
+        auto target_table = m_link_map.get_target_table();
+        LeafType leaf(target_table->get_alloc());
+        util::SequentialScanHint scan_hint;
+        target_table->traverse_clusters([&](const Cluster* cluster) {
+            cluster->init_leaf(m_column_key, &leaf);
+            size_t sz = cluster->node_size();
+            for (size_t i = 0; i < sz; i++)
+                func(cluster->get_real_key(i), leaf.get_any(i));
+            return false; // Continue
+        });
+    }
 };
 
 // If we add a new Realm type T and quickly want Query support for it, then simply inherit from it like
@@ -2299,8 +2462,17 @@ public:
             m_link_map.set_cluster(cluster);
         }
         else {
-            m_keys = cluster->get_key_array();
-            m_offset = cluster->get_offset();
+            // Count directly from the backlink columns of the leaf, so that the
+            // count is a scan over the leaf like any other integer column.
+            auto table = m_link_map.get_base_table();
+            size_t num_leaves = 0;
+            table->for_each_backlink_column([&](ColKey col_key) {
+                if (num_leaves == m_leaves.size())
+                    m_leaves.push_back(std::make_unique<ArrayBacklink>(table->get_alloc()));
+                cluster->init_leaf(col_key, m_leaves[num_leaves++].get());
+                return false;
+            });
+            m_leaves.resize(num_leaves);
         }
     }
 
@@ -2316,13 +2488,33 @@ public:
             count = m_link_map.count_all_backlinks(index);
         }
         else {
-            ObjKey key(m_keys->get(index) + m_offset);
-            const Obj obj = m_link_map.get_base_table()->get_object(key);
-            count = obj.get_backlink_count();
+            count = count_backlinks(index);
         }
         destination = Value<int64_t>(count);
     }
 
+    util::Optional<DataType> get_batch_type() const override
+    {
+        if (m_link_map.has_links())
+            return util::none;
+        return type_Int;
+    }
+
+    void evaluate_batch(size_t start, size_t end, int64_t* dest) override
+    {
+        std::fill(dest, dest + (end - start), 0);
+        for (auto& leaf : m_leaves) {
+            for (size_t i = start; i < end; i++)
+                dest[i - start] += leaf->get_backlink_count(i);
+        }
+    }
+
+    void evaluate_batch(size_t start, size_t end, double* dest) override
+    {
+        for (size_t i = start; i < end; i++)
+            *dest++ = double(count_backlinks(i));
+    }
+
     virtual std::string description(util::serializer::SerialisationState& state) const override
     {
         std::string s;
@@ -2334,8 +2526,15 @@ public:
     }
 
 private:
-    const ClusterKeyArray* m_keys = nullptr;
-    uint64_t m_offset = 0;
+    size_t count_backlinks(size_t index) const
+    {
+        size_t count = 0;
+        for (auto& leaf : m_leaves)
+            count += leaf->get_backlink_count(index);
+        return count;
+    }
+
+    std::vector<std::unique_ptr<ArrayBacklink>> m_leaves;
     LinkMap m_link_map;
 };
 
@@ -2780,6 +2979,34 @@ public:
 
     SizeOperator<int64_t> size() override;
 
+    bool can_search_for(Mixed value) const override
+    {
+        if constexpr (realm::is_any_v<T, Int, Bool, StringData, ObjectId, UUID, Timestamp>) {
+            return !links_exist() && !value.is_null() && value.get_type() == ColumnTypeTraits<T>::id;
+        }
+        else {
+            static_cast<void>(value);
+            return false;
+        }
+    }
+
+    bool contains(size_t index, Mixed value) override
+    {
+        if constexpr (realm::is_any_v<T, Int, Bool, StringData, ObjectId, UUID, Timestamp>) {
+            if constexpr (realm::is_any_v<T, ObjectId, Int, Bool, UUID>) {
+                if (m_is_nullable_storage) {
+                    return contains<util::Optional<T>>(index, value.get<T>());
+                }
+            }
+            return contains<T>(index, value.get<T>());
+        }
+        else {
+            static_cast<void>(index);
+            static_cast<void>(value);
+            REALM_UNREACHABLE();
+        }
+    }
+
     ColumnListElementLength<T> element_lengths() const
     {
         return {*this};
@@ -2864,6 +3091,22 @@ public:
     const bool m_is_nullable_storage;
 
 private:
+    // Search the leaves of the collection directly rather than copying the
+    // elements out as evaluate() does
+    template <typename StorageType>
+    bool contains(size_t index, StorageType value)
+    {
+        Value<int64_t> list_refs;
+        get_lists(index, list_refs, 1);
+        REALM_ASSERT_DEBUG(list_refs.size() == 1);
+        ref_type list_ref = to_ref(list_refs.get(0).get_int());
+        if (!list_ref)
+            return false;
+        BPlusTree<StorageType> list(get_alloc());
+        list.init_from_ref(list_ref);
+        return list.find_first(value) != realm::npos;
+    }
+
     template <typename StorageType>
     void evaluate(size_t index, ValueBase& destination)
     {
@@ -3063,6 +3306,13 @@ public:
     void set_cluster(const Cluster* cluster) override;
     void evaluate(size_t index, ValueBase& destination) override;
 
+    // A key can be looked up directly instead of comparing it with every key
+    bool can_search_for(Mixed value) const final
+    {
+        return !m_link_map.has_links() && value.is_type(type_String);
+    }
+    bool contains(size_t index, Mixed value) final;
+
     std::string description(util::serializer::SerialisationState& state) const override
     {
         return state.describe_expression_type(m_comparison_type) + state.describe_columns(m_link_map, m_column_key) +
@@ -3365,18 +3615,31 @@ private:
     {
         BPlusTree<StorageType> list(alloc);
         list.init_from_ref(list_ref);
-        size_t s = list.size();
-        for (unsigned j = 0; j < s; j++) {
-            auto v = list.get(j);
-            if (!value_is_null(v)) {
-                if constexpr (std::is_same_v<StorageType, util::Optional<T>>) {
-                    op.accumulate(*v);
-                }
-                else {
-                    op.accumulate(v);
+        // Walk the leaves rather than looking up each element through the tree. Sums over integer leaves
+        // use the vectorized Array::get_sum().
+        auto func = [&op](BPlusTreeNode* node, size_t) {
+            auto leaf = static_cast<typename BPlusTree<StorageType>::LeafNode*>(node);
+            size_t sz = leaf->size();
+            if constexpr (std::is_same_v<StorageType, Int> &&
+                          std::is_same_v<Operation, aggregate_operations::Sum<Int>>) {
+                op.accumulate_sum(leaf->get_sum(0, sz), sz);
+            }
+            else {
+                for (size_t j = 0; j < sz; j++) {
+                    auto v = leaf->get(j);
+                    if (!value_is_null(v)) {
+                        if constexpr (std::is_same_v<StorageType, util::Optional<T>>) {
+                            op.accumulate(*v);
+                        }
+                        else {
+                            op.accumulate(v);
+                        }
+                    }
                 }
             }
-        }
+            return false;
+        };
+        list.traverse(func);
     }
 
     Mixed do_dictionary_agg(const DictionaryClusterTree& dict_cluster)
@@ -3589,10 +3852,56 @@ public:
         }
     }
 
+    util::Optional<DataType> get_batch_type() const override
+    {
+        if constexpr (realm::is_any_v<T, Int, double>) {
+            if (!links_exist() && !is_nullable())
+                return ColumnTypeTraits<T>::id;
+        }
+        return util::none;
+    }
+
+    void evaluate_batch(size_t start, size_t end, int64_t* dest) override
+    {
+        evaluate_batch_internal(start, end, dest);
+    }
+
+    void evaluate_batch(size_t start, size_t end, double* dest) override
+    {
+        evaluate_batch_internal(start, end, dest);
+    }
+
 private:
     using ObjPropertyExpr<T>::m_link_map;
     using ObjPropertyExpr<T>::m_column_key;
 
+    template <class D>
+    void evaluate_batch_internal(size_t start, size_t end, D* dest)
+    {
+        if constexpr (realm::is_any_v<T, Int, double>) {
+            REALM_ASSERT(m_leaf_ptr != nullptr);
+            auto leaf = static_cast<const LeafType*>(m_leaf_ptr);
+            if constexpr (std::is_same_v<T, Int>) {
+                // Decode eight values at a time
+                auto array = static_cast<const Array*>(leaf);
+                int64_t chunk[8];
+                for (; start + 8 <= end; start += 8, dest += 8) {
+                    array->get_chunk(start, chunk);
+                    for (size_t t = 0; t < 8; t++)
+                        dest[t] = D(chunk[t]);
+                }
+            }
+            for (; start < end; ++start)
+                *dest++ = D(leaf->get(start));
+        }
+        else {
+            static_cast<void>(start);
+            static_cast<void>(end);
+            static_cast<void>(dest);
+            REALM_UNREACHABLE();
+        }
+    }
+
     // Leaf cache
     using LeafCacheStorage =
         typename std::aligned_storage<std::max(sizeof(LeafType), sizeof(NullableLeafType)), alignof(LeafType)>::type;
@@ -3977,6 +4286,37 @@ public:
         destination = result;
     }
 
+    util::Optional<DataType> get_batch_type() const override
+    {
+        if (m_left_is_const && m_right_is_const)
+            return util::none;
+        auto left = batch_type_of(*m_left, m_left_is_const);
+        auto right = batch_type_of(*m_right, m_right_is_const);
+        if (!left || !right)
+            return util::none;
+        // Same promotion as Mixed arithmetic
+        return (*left == type_Int && *right == type_Int) ? type_Int : type_Double;
+    }
+
+    void evaluate_batch(size_t start, size_t end, int64_t* dest) override
+    {
+        REALM_ASSERT_DEBUG(get_batch_type() == util::Optional<DataType>(type_Int));
+        evaluate_batch_internal(start, end, dest);
+    }
+
+    void evaluate_batch(size_t start, size_t end, double* dest) override
+    {
+        if (*get_batch_type() == type_Int) {
+            int64_t values[batch_size];
+            evaluate_batch_internal(start, end, values);
+            for (size_t t = 0; t < end - start; t++)
+                dest[t] = double(values[t]);
+        }
+        else {
+            evaluate_batch_internal(start, end, dest);
+        }
+    }
+
     std::string description(util::serializer::SerialisationState& state) const override
     {
         std::string s = "(";
@@ -4008,6 +4348,40 @@ public:
     }
 
 private:
+    util::Optional<DataType> batch_type_of(const Subexpr& expr, bool is_const) const
+    {
+        if (!is_const)
+            return expr.get_batch_type();
+        if (m_const_value.is_type(type_Int, type_Double))
+            return m_const_value.get_type();
+        return util::none;
+    }
+
+    template <class T>
+    void evaluate_batch_internal(size_t start, size_t end, T* dest)
+    {
+        size_t rows = end - start;
+        if (m_left_is_const) {
+            T value = m_const_value.export_to_type<T>();
+            m_right->evaluate_batch(start, end, dest);
+            for (size_t t = 0; t < rows; t++)
+                dest[t] = oper::apply(value, dest[t]);
+        }
+        else if (m_right_is_const) {
+            T value = m_const_value.export_to_type<T>();
+            m_left->evaluate_batch(start, end, dest);
+            for (size_t t = 0; t < rows; t++)
+                dest[t] = oper::apply(dest[t], value);
+        }
+        else {
+            T right[batch_size];
+            m_left->evaluate_batch(start, end, dest);
+            m_right->evaluate_batch(start, end, right);
+            for (size_t t = 0; t < rows; t++)
+                dest[t] = oper::apply(dest[t], right[t]);
+        }
+    }
+
     std::unique_ptr<Subexpr> m_left;
     std::unique_ptr<Subexpr> m_right;
     bool m_left_is_const;
@@ -4052,6 +4426,10 @@ public:
     double init() override
     {
         double dT = 50.0;
+        // The constant may have been rebound since the last run
+        m_has_matches = false;
+        m_matches.clear();
+        init_batch();
         if ((m_left->has_single_value()) || (m_right->has_single_value())) {
             dT = 10.0;
             if constexpr (std::is_same_v<TCond, Equal>) {
@@ -4102,6 +4480,9 @@ public:
                 }
             }
         }
+        init_semi_join();
+        init_collection_search();
+        init_value_set();
 
         return dT;
     }
@@ -4166,6 +4547,53 @@ public:
             return m_cluster->lower_bound_key(ObjKey(actual_key.value - m_cluster->get_offset()));
         }
 
+        if (m_link_prop) {
+            // Follow links with lookups in the target table until that has cost
+            // about as much as a pass over the target table, then switch to
+            // evaluating the condition for all target objects in that pass.
+            if (!m_has_target_matches) {
+                if (m_semi_join_rows < m_semi_join_threshold)
+                    m_semi_join_rows += end - start;
+                else
+                    find_target_matches();
+            }
+            if (m_has_target_matches) {
+                for (; start < end; ++start) {
+                    if (m_link_prop->links_match(start, m_target_matches, m_null_matches))
+                        return start;
+                }
+                return not_found;
+            }
+        }
+
+        if (m_collection) {
+            for (; start < end; ++start) {
+                if (m_collection->contains(start, m_collection_value))
+                    return start;
+            }
+            return not_found;
+        }
+
+        if (m_set_column) {
+            ValueBase values;
+            while (start < end) {
+                m_set_column->evaluate(start, values);
+                REALM_ASSERT_DEBUG(!values.m_from_list && values.size() > 0);
+                size_t rows = std::min(values.size(), end - start);
+                for (size_t i = 0; i < rows; ++i) {
+                    if (m_value_set.count(values[i]))
+                        return start + i;
+                }
+                start += rows;
+            }
+            return not_found;
+        }
+
+        if (m_batch_type == util::Optional<DataType>(type_Int))
+            return find_first_batch<int64_t>(start, end);
+        if (m_batch_type == util::Optional<DataType>(type_Double))
+            return find_first_batch<double>(start, end);
+
         size_t match;
         ValueBase left_buf;
         ValueBase right_buf;
@@ -4206,6 +4634,15 @@ public:
         }
     }
 
+    bool rebind_value(Mixed value) override
+    {
+        if (m_left_const_values)
+            return m_left->rebind_value(value);
+        if (m_right_const_values)
+            return m_right->rebind_value(value);
+        return false;
+    }
+
     std::unique_ptr<Expression> clone() const override
     {
         return std::unique_ptr<Expression>(new Compare(*this));
@@ -4224,15 +4661,249 @@ private:
         }
     }
 
+    // A comparison between a constant and a property across links can be
+    // evaluated as a semi-join: evaluate the condition once for every object in
+    // the target table, and then only look up the link keys of each object in
+    // the sorted set of target objects which matched.
+    void init_semi_join()
+    {
+        m_link_prop = nullptr;
+        m_has_target_matches = false;
+        m_target_matches.clear();
+        m_semi_join_rows = 0;
+        if (m_has_matches)
+            return;
+
+        Subexpr* column;
+        Subexpr* constant;
+        if (m_right->has_single_value() && !m_right->get_comparison_type()) {
+            column = m_left.get();
+            constant = m_right.get();
+        }
+        else if (m_left->has_single_value() && !m_left->get_comparison_type()) {
+            column = m_right.get();
+            constant = m_left.get();
+        }
+        else {
+            return;
+        }
+        auto prop = dynamic_cast<const ObjPropertyBase*>(column);
+        if (!prop || !prop->links_exist())
+            return;
+
+        m_link_prop = prop;
+        m_link_prop_is_left = column == m_left.get();
+        m_semi_join_constant = constant->get_mixed();
+        m_semi_join_threshold = prop->get_link_map().get_target_table()->size() / 8;
+    }
+
+    // ANY list == constant can be evaluated by searching each list (or
+    // dictionary) for the constant, which avoids copying out the elements of
+    // every collection.
+    void init_collection_search()
+    {
+        m_collection = nullptr;
+        if constexpr (std::is_same_v<TCond, Equal>) {
+            if (m_has_matches)
+                return;
+
+            Subexpr* column;
+            Subexpr* constant;
+            if (m_right->has_single_value() && !m_right->get_comparison_type()) {
+                column = m_left.get();
+                constant = m_right.get();
+            }
+            else if (m_left->has_single_value() && !m_left->get_comparison_type()) {
+                column = m_right.get();
+                constant = m_left.get();
+            }
+            else {
+                return;
+            }
+            // A list literal such as {'a'} is compared with the whole collection
+            if (constant->has_multiple_values() ||
+                column->get_comparison_type().value_or(ExpressionComparisonType::Any) !=
+                    ExpressionComparisonType::Any)
+                return;
+            Mixed value = constant->get_mixed();
+            if (!column->can_search_for(value))
+                return;
+
+            m_collection = column;
+            m_collection_value = value;
+        }
+    }
+
+    // property IN {...} with more than a few constants is evaluated by
+    // looking up the value of each object in a hash set of the constants
+    // instead of comparing it with each of them.
+    void init_value_set()
+    {
+        m_set_column = nullptr;
+        m_value_set.clear();
+        if constexpr (std::is_same_v<TCond, Equal>) {
+            if (m_has_matches || m_link_prop || m_collection)
+                return;
+
+            Subexpr* column;
+            Subexpr* constant;
+            const ValueBase* constants;
+            if (m_right_const_values && m_right->has_multiple_values()) {
+                column = m_left.get();
+                constant = m_right.get();
+                constants = m_right_const_values;
+            }
+            else if (m_left_const_values && m_left->has_multiple_values()) {
+                column = m_right.get();
+                constant = m_left.get();
+                constants = m_left_const_values;
+            }
+            else {
+                return;
+            }
+            constexpr size_t min_constants = 8;
+            auto prop = dynamic_cast<const ObjPropertyBase*>(column);
+            if (constants->size() < min_constants || !prop || prop->links_exist() ||
+                prop->column_key().is_collection() || column->get_comparison_type() ||
+                constant->get_comparison_type().value_or(ExpressionComparisonType::Any) !=
+                    ExpressionComparisonType::Any)
+                return;
+            // Only types where equal values have equal hashes, which is not
+            // the case for e.g. 1 and 1.0
+            DataType type = column->get_type();
+            switch (type) {
+                case type_Int:
+                case type_Bool:
+                case type_String:
+                case type_Timestamp:
+                case type_ObjectId:
+                case type_UUID:
+                    break;
+                default:
+                    return;
+            }
+            for (size_t i = 0; i < constants->size(); ++i) {
+                const Mixed& value = (*constants)[i];
+                if (!value.is_null() && value.get_type() != type) {
+                    m_value_set.clear();
+                    return;
+                }
+                m_value_set.insert(value);
+            }
+            m_set_column = column;
+        }
+    }
+
+    void find_target_matches() const
+    {
+        TCond c;
+        QueryValue constant(m_semi_join_constant);
+        auto is_match = [&](const QueryValue& value) {
+            return m_link_prop_is_left ? c(value, constant) : c(constant, value);
+        };
+        m_link_prop->for_each_target_value([&](ObjKey key, Mixed value) {
+            if (is_match(QueryValue(value)))
+                m_target_matches.push_back(key);
+        });
+        m_null_matches = is_match(QueryValue());
+        m_has_target_matches = true;
+    }
+
+    // Use vectorized evaluation if both sides are numeric columns, constants or arithmetic on those, and
+    // are of the same type. Comparing Int with Double is left to Mixed, which handles the cases where
+    // the integer cannot be represented exactly as a double.
+    void init_batch()
+    {
+        m_batch_type = util::none;
+        if constexpr (realm::is_any_v<TCond, Equal, NotEqual, Greater, Less, GreaterEqual, LessEqual>) {
+            if (m_has_matches || m_left->get_comparison_type() || m_right->get_comparison_type())
+                return;
+            auto left = batch_type_of(*m_left, m_batch_left_value);
+            auto right = batch_type_of(*m_right, m_batch_right_value);
+            if (left && right && *left == *right && !(m_batch_left_value && m_batch_right_value))
+                m_batch_type = left;
+        }
+    }
+
+    static util::Optional<DataType> batch_type_of(Subexpr& expr, util::Optional<Mixed>& const_value)
+    {
+        const_value = util::none;
+        if (expr.has_single_value()) {
+            Mixed value = expr.get_mixed();
+            if (!value.is_type(type_Int, type_Double))
+                return util::none;
+            const_value = value;
+            return value.get_type();
+        }
+        return expr.get_batch_type();
+    }
+
+    template <class T>
+    static bool batch_compare(T v1, T v2)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            // NaN is ordered by Mixed::compare(), so let it handle those
+            if (REALM_UNLIKELY(std::isnan(v1) || std::isnan(v2)))
+                return TCond()(QueryValue(v1), QueryValue(v2));
+        }
+        return TCond()(v1, v2);
+    }
+
+    template <class T>
+    size_t find_first_batch(size_t start, size_t end) const
+    {
+        T left[Subexpr::batch_size];
+        T right[Subexpr::batch_size];
+        while (start < end) {
+            size_t rows = std::min(end - start, Subexpr::batch_size);
+            if (m_batch_left_value) {
+                std::fill_n(left, rows, m_batch_left_value->export_to_type<T>());
+            }
+            else {
+                m_left->evaluate_batch(start, start + rows, left);
+            }
+            if (m_batch_right_value) {
+                std::fill_n(right, rows, m_batch_right_value->export_to_type<T>());
+            }
+            else {
+                m_right->evaluate_batch(start, start + rows, right);
+            }
+            for (size_t t = 0; t < rows; t++) {
+                if (batch_compare(left[t], right[t]))
+                    return start + t;
+            }
+            start += rows;
+        }
+        return not_found;
+    }
+
     std::unique_ptr<Subexpr> m_left;
     std::unique_ptr<Subexpr> m_right;
     const Cluster* m_cluster;
+    util::Optional<DataType> m_batch_type;
+    util::Optional<Mixed> m_batch_left_value;
+    util::Optional<Mixed> m_batch_right_value;
     ValueBase* m_left_const_values = nullptr;
     ValueBase* m_right_const_values = nullptr;
     bool m_has_matches = false;
     std::vector<ObjKey> m_matches;
     mutable size_t m_index_get = 0;
     size_t m_index_end = 0;
+
+    const ObjPropertyBase* m_link_prop = nullptr;
+    bool m_link_prop_is_left = false;
+    Mixed m_semi_join_constant;
+    size_t m_semi_join_threshold = 0;
+    mutable size_t m_semi_join_rows = 0;
+    mutable bool m_has_target_matches = false;
+    mutable bool m_null_matches = false;
+    mutable std::vector<ObjKey> m_target_matches;
+
+    Subexpr* m_collection = nullptr;
+    Mixed m_collection_value;
+
+    Subexpr* m_set_column = nullptr;
+    std::unordered_set<Mixed> m_value_set;
 };
 } // namespace realm
 #endif // REALM_QUERY_EXPRESSION_HPP
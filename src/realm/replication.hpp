@@ -55,6 +55,7 @@ public:
     virtual void insert_column(const Table*, ColKey col_key, DataType type, StringData name, Table* target_table);
     virtual void erase_column(const Table*, ColKey col_key);
     virtual void rename_column(const Table*, ColKey col_key, StringData name);
+    virtual void set_compressed(const Table*, ColKey col_key, bool compressed);
 
     virtual void add_int(const Table*, ColKey col_key, ObjKey key, int_fast64_t value);
     virtual void set(const Table*, ColKey col_key, ObjKey key, Mixed value,
@@ -77,6 +78,13 @@ public:
     virtual void create_object(const Table*, GlobalKey);
     virtual void create_object_with_primary_key(const Table*, ObjKey, Mixed);
     virtual void remove_object(const Table*, ObjKey);
+    /// Record the creation of an object in an asymmetric table without
+    /// creating it locally. Returns false if the object must be created in the
+    /// table as usual.
+    virtual bool create_asymmetric_object(const Table*, Mixed, const FieldValues&)
+    {
+        return false;
+    }
 
     virtual void typed_link_change(const Table*, ColKey, TableKey);
 
@@ -514,11 +522,17 @@ inline void Replication::rename_column(const Table* t, ColKey col_key, StringDat
     m_encoder.rename_column(col_key); // Throws
 }
 
+inline void Replication::set_compressed(const Table* t, ColKey col_key, bool compressed)
+{
+    select_table(t);                               // Throws
+    m_encoder.set_compressed(col_key, compressed); // Throws
+}
+
 inline void Replication::do_set(const Table* t, ColKey col_key, ObjKey key, _impl::Instruction variant)
 {
     if (variant != _impl::Instruction::instr_SetDefault) {
-        select_table(t);                       // Throws
-        m_encoder.modify_object(col_key, key); // Throws
+        select_table(t);                                 // Throws
+        m_encoder.modify_object_coalesced(col_key, key); // Throws
     }
 }
 
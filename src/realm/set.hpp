@@ -216,6 +216,7 @@ private:
     {
         if (!m_tree) {
             m_tree.reset(new BPlusTree<T>(m_obj.get_alloc()));
+            m_tree->set_max_node_size(m_obj.get_table()->get_collection_node_size());
             const ArrayParent* parent = this;
             m_tree->set_parent(const_cast<ArrayParent*>(parent), 0);
         }
@@ -247,6 +248,11 @@ private:
     void do_erase(size_t ndx);
     void do_clear();
 
+    // Insert or erase at a position which is known to be correct, e.g. while
+    // merging with another sorted range, emitting the replication instruction
+    void insert_at(size_t ndx, T value);
+    void erase_at(size_t ndx);
+
     iterator find_impl(const T& value) const;
 
     template <class It1, class It2>
@@ -924,29 +930,20 @@ template <class T>
 inline void Set<T>::assign_union(const CollectionBase& rhs)
 {
     if (auto other_set = dynamic_cast<const Set<T>*>(&rhs)) {
+        if (*this == *other_set)
+            return;
         return assign_union(other_set->begin(), other_set->end());
     }
     auto other_set = convert_to_set(rhs, m_nullable);
     return assign_union(other_set.begin(), other_set.end());
 }
 
-template <class T>
-template <class It1, class It2>
-void Set<T>::assign_union(It1 first, It2 last)
-{
-    std::vector<T> the_diff;
-    std::set_difference(first, last, begin(), end(), std::back_inserter(the_diff), SetElementLessThan<T>{});
-    // 'the_diff' now contains all the elements that are in foreign set, but not in 'this'
-    // Now insert those elements
-    for (auto&& value : the_diff) {
-        insert(value);
-    }
-}
-
 template <class T>
 inline void Set<T>::assign_intersection(const CollectionBase& rhs)
 {
     if (auto other_set = dynamic_cast<const Set<T>*>(&rhs)) {
+        if (*this == *other_set)
+            return;
         return assign_intersection(other_set->begin(), other_set->end());
     }
     auto other_set = convert_to_set(rhs, m_nullable);
@@ -954,66 +951,165 @@ inline void Set<T>::assign_intersection(const CollectionBase& rhs)
 }
 
 template <class T>
-template <class It1, class It2>
-void Set<T>::assign_intersection(It1 first, It2 last)
+inline void Set<T>::assign_difference(const CollectionBase& rhs)
 {
-    std::vector<T> intersection;
-    std::set_intersection(first, last, begin(), end(), std::back_inserter(intersection), SetElementLessThan<T>{});
-    clear();
-    // Elements in intersection comes from foreign set, so ok to use here
-    for (auto&& value : intersection) {
-        insert(value);
+    if (auto other_set = dynamic_cast<const Set<T>*>(&rhs)) {
+        if (*this == *other_set)
+            return clear();
+        return assign_difference(other_set->begin(), other_set->end());
     }
+    auto other_set = convert_to_set(rhs, m_nullable);
+    return assign_difference(other_set.begin(), other_set.end());
 }
 
 template <class T>
-inline void Set<T>::assign_difference(const CollectionBase& rhs)
+inline void Set<T>::assign_symmetric_difference(const CollectionBase& rhs)
 {
     if (auto other_set = dynamic_cast<const Set<T>*>(&rhs)) {
-        return assign_difference(other_set->begin(), other_set->end());
+        if (*this == *other_set)
+            return clear();
+        return assign_symmetric_difference(other_set->begin(), other_set->end());
     }
     auto other_set = convert_to_set(rhs, m_nullable);
-    return assign_difference(other_set.begin(), other_set.end());
+    return assign_symmetric_difference(other_set.begin(), other_set.end());
+}
+
+template <class T>
+void Set<T>::insert_at(size_t ndx, T value)
+{
+    if (value_is_null(value) && !m_nullable)
+        throw LogicError(LogicError::column_not_nullable);
+
+    ensure_created();
+    if (Replication* repl = m_obj.get_replication()) {
+        this->insert_repl(repl, ndx, value);
+    }
+    do_insert(ndx, value);
+}
+
+template <class T>
+void Set<T>::erase_at(size_t ndx)
+{
+    if (Replication* repl = m_obj.get_replication()) {
+        this->erase_repl(repl, ndx, m_tree->get(ndx));
+    }
+    do_erase(ndx);
+}
+
+// The set algebra below merges the sorted elements of this set with the
+// sorted range [first, last) in a single pass, so every insertion and erase
+// happens at a known position rather than after a lookup in the tree, and only
+// the elements which actually change are replicated.
+
+template <class T>
+template <class It1, class It2>
+void Set<T>::assign_union(It1 first, It2 last)
+{
+    SetElementLessThan<T> less;
+    size_t sz = size();
+    size_t ndx = 0;
+    bool changed = false;
+    for (; first != last; ++first) {
+        T value = *first;
+        while (ndx < sz && less(m_tree->get(ndx), value))
+            ++ndx;
+        if (ndx < sz && !less(value, m_tree->get(ndx))) {
+            ++ndx;
+            continue;
+        }
+        insert_at(ndx++, value);
+        ++sz;
+        changed = true;
+    }
+    if (changed)
+        bump_content_version();
 }
 
 template <class T>
 template <class It1, class It2>
-void Set<T>::assign_difference(It1 first, It2 last)
+void Set<T>::assign_intersection(It1 first, It2 last)
 {
-    std::vector<T> intersection;
-    std::set_intersection(first, last, begin(), end(), std::back_inserter(intersection), SetElementLessThan<T>{});
-    // 'intersection' now contains all the elements that are in both foreign set and 'this'.
-    // Remove those elements. The elements comes from the foreign set, so ok to refer to.
-    for (auto&& value : intersection) {
-        erase(value);
+    if (first == last)
+        return clear();
+
+    SetElementLessThan<T> less;
+    size_t sz = size();
+    size_t ndx = 0;
+    bool changed = false;
+    while (ndx < sz && first != last) {
+        T value = m_tree->get(ndx);
+        while (first != last && less(*first, value))
+            ++first;
+        if (first != last && !less(value, *first)) {
+            ++ndx;
+            ++first;
+            continue;
+        }
+        erase_at(ndx);
+        --sz;
+        changed = true;
+    }
+    // Everything past the end of the other range goes. Erase from the back
+    // so that the elements don't have to be moved.
+    while (sz > ndx) {
+        erase_at(--sz);
+        changed = true;
     }
+    if (changed)
+        bump_content_version();
 }
 
 template <class T>
-inline void Set<T>::assign_symmetric_difference(const CollectionBase& rhs)
+template <class It1, class It2>
+void Set<T>::assign_difference(It1 first, It2 last)
 {
-    if (auto other_set = dynamic_cast<const Set<T>*>(&rhs)) {
-        return assign_symmetric_difference(other_set->begin(), other_set->end());
+    SetElementLessThan<T> less;
+    size_t sz = size();
+    size_t ndx = 0;
+    bool changed = false;
+    while (ndx < sz && first != last) {
+        T value = m_tree->get(ndx);
+        if (less(value, *first)) {
+            ++ndx;
+        }
+        else if (less(*first, value)) {
+            ++first;
+        }
+        else {
+            erase_at(ndx);
+            --sz;
+            ++first;
+            changed = true;
+        }
     }
-    auto other_set = convert_to_set(rhs, m_nullable);
-    return assign_symmetric_difference(other_set.begin(), other_set.end());
+    if (changed)
+        bump_content_version();
 }
 
 template <class T>
 template <class It1, class It2>
 void Set<T>::assign_symmetric_difference(It1 first, It2 last)
 {
-    std::vector<T> difference;
-    std::set_difference(first, last, begin(), end(), std::back_inserter(difference), SetElementLessThan<T>{});
-    std::vector<T> intersection;
-    std::set_intersection(first, last, begin(), end(), std::back_inserter(intersection), SetElementLessThan<T>{});
-    // Now remove the common elements and add the differences
-    for (auto&& value : intersection) {
-        erase(value);
-    }
-    for (auto&& value : difference) {
-        insert(value);
+    SetElementLessThan<T> less;
+    size_t sz = size();
+    size_t ndx = 0;
+    bool changed = false;
+    for (; first != last; ++first) {
+        T value = *first;
+        while (ndx < sz && less(m_tree->get(ndx), value))
+            ++ndx;
+        if (ndx < sz && !less(value, m_tree->get(ndx))) {
+            erase_at(ndx);
+            --sz;
+        }
+        else {
+            insert_at(ndx++, value);
+            ++sz;
+        }
+        changed = true;
     }
+    if (changed)
+        bump_content_version();
 }
 
 inline bool LnkSet::operator==(const LnkSet& other) const
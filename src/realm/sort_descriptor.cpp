@@ -21,6 +21,9 @@
 #include <realm/db.hpp>
 #include <realm/util/assert.hpp>
 #include <realm/list.hpp>
+#include <realm/unicode.hpp>
+
+#include <unordered_map>
 
 using namespace realm;
 
@@ -154,7 +157,8 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ColKey>> const& column_li
 {
     REALM_ASSERT(!column_lists.empty());
     REALM_ASSERT_EX(column_lists.size() == ascending.size(), column_lists.size(), ascending.size());
-    size_t translated_size = std::max_element(indexes.begin(), indexes.end())->index_in_view + 1;
+    size_t translated_size =
+        indexes.empty() ? 0 : std::max_element(indexes.begin(), indexes.end())->index_in_view + 1;
 
     m_columns.reserve(column_lists.size());
     for (size_t i = 0; i < column_lists.size(); ++i) {
@@ -168,6 +172,7 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ColKey>> const& column_li
 
         if (sz == 1) { // no link chain
             m_columns.emplace_back(&root_table, columns[0], ascending[i]);
+            pin_decompressed(m_columns.back());
             continue;
         }
 
@@ -183,6 +188,8 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ColKey>> const& column_li
         }
 
         m_columns.emplace_back(tables.back(), columns.back(), ascending[i]);
+        pin_decompressed(m_columns.back());
+        m_has_links = true;
 
         auto& translated_keys = m_columns.back().translated_keys;
         auto& is_null = m_columns.back().is_null;
@@ -207,6 +214,13 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ColKey>> const& column_li
     m_cache.resize(column_lists.size() - 1);
 }
 
+void BaseDescriptor::Sorter::pin_decompressed(const SortColumn& col)
+{
+    auto type = col.col_key.get_type();
+    if (type == col_type_String || type == col_type_Binary)
+        m_pins.emplace_back(col.table->get_alloc()); // Throws
+}
+
 BaseDescriptor::Sorter DistinctDescriptor::sorter(Table const& table, const IndexPairs& indexes) const
 {
     REALM_ASSERT(!m_column_keys.empty());
@@ -225,6 +239,33 @@ void DistinctDescriptor::execute(IndexPairs& v, const Sorter& predicate, const B
         v.erase(nulls, v.end());
     }
 
+    if (predicate.has_hashable_values()) {
+        // Keep the first occurrence of each value, without sorting
+        std::unordered_map<Mixed, size_t> kept_ndx;
+        kept_ndx.reserve(v.size());
+        size_t num_kept = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            auto [it, inserted] = kept_ndx.emplace(v[i].cached_value, num_kept);
+            if (inserted) {
+                if (i != num_kept)
+                    v[num_kept] = std::move(v[i]);
+                ++num_kept;
+            }
+            else if (v[i].index_in_view < v[it->second].index_in_view) {
+                v[it->second] = std::move(v[i]);
+            }
+        }
+        v.erase(v.begin() + num_kept, v.end());
+        if (!std::is_sorted(v.begin(), v.end(), [](const IP& a, const IP& b) {
+                return a.index_in_view < b.index_in_view;
+            })) {
+            std::sort(v.begin(), v.end(), [](const IP& a, const IP& b) {
+                return a.index_in_view < b.index_in_view;
+            });
+        }
+        return;
+    }
+
     // Sort by the columns to distinct on
     std::sort(v.begin(), v.end(), std::ref(predicate));
 
@@ -252,7 +293,16 @@ BaseDescriptor::Sorter SortDescriptor::sorter(Table const& table, const IndexPai
 
 void SortDescriptor::execute(IndexPairs& v, const Sorter& predicate, const BaseDescriptor* next) const
 {
-    std::sort(v.begin(), v.end(), std::ref(predicate));
+    // When a limit follows, only the objects that survive it need to be in order. The predicate is
+    // a total ordering, so the result is the same as sorting everything and then cutting off.
+    size_t limit = v.size();
+    if (next && next->get_type() == DescriptorType::Limit)
+        limit = std::min(limit, static_cast<const LimitDescriptor*>(next)->get_limit());
+
+    if (limit < v.size())
+        std::partial_sort(v.begin(), v.begin() + limit, v.end(), std::ref(predicate));
+    else
+        std::sort(v.begin(), v.end(), std::ref(predicate));
 
     // not doing this on the last step is an optimisation
     if (next) {
@@ -309,7 +359,11 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
         int c;
 
         if (t == 0) {
-            c = i.cached_value.compare(j.cached_value);
+            c = m_sort_keys.empty() ? i.cached_value.compare(j.cached_value) : compare_sort_keys(i, j);
+        }
+        else if (!m_columns[t].values.empty()) {
+            // Columns with links have no value for null links, which were handled above
+            c = m_columns[t].values[i.index_in_view].compare(m_columns[t].values[j.index_in_view]);
         }
         else {
             if (m_cache[t - 1].empty()) {
@@ -347,33 +401,119 @@ bool BaseDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
     return total_ordering ? i.index_in_view < j.index_in_view : 0;
 }
 
+bool BaseDescriptor::Sorter::has_hashable_values() const
+{
+    if (m_columns.size() != 1)
+        return false;
+    // Not floating point, where e.g. 0.0 and -0.0 compare equal, nor Mixed,
+    // where e.g. 1 and 1.0 do
+    switch (m_columns[0].col_key.get_type()) {
+        case col_type_Int:
+        case col_type_Bool:
+        case col_type_String:
+        case col_type_Binary:
+        case col_type_Timestamp:
+        case col_type_ObjectId:
+        case col_type_UUID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void BaseDescriptor::Sorter::cache_first_column(IndexPair& index) const
+{
+    REALM_ASSERT_DEBUG(!m_columns.empty() && m_columns[0].translated_keys.empty());
+    auto& col = m_columns[0];
+    index.cached_value = col.table->get_object(index.key_for_object).get_any(col.col_key);
+}
+
 void BaseDescriptor::Sorter::cache_first_column(IndexPairs& v)
 {
     if (m_columns.empty())
         return;
 
-    auto& col = m_columns[0];
-    ColKey ck = col.col_key;
-    for (size_t i = 0; i < v.size(); i++) {
-        IndexPair& index = v[i];
-        ObjKey key = index.key_for_object;
-
-        if (!col.translated_keys.empty()) {
-            if (col.is_null[i]) {
-                index.cached_value = Mixed();
-                continue;
+    size_t max_index = 0;
+    for (auto& index : v)
+        max_index = std::max(max_index, index.index_in_view);
+
+    // Fetch the values of all columns up front rather than on each comparison. The objects are looked up in
+    // key order, so each cluster is visited once, and objects linked to from many rows are looked up once.
+    std::vector<std::pair<ObjKey, size_t>> keys;
+    keys.reserve(v.size());
+    for (size_t t = 0; t < m_columns.size(); ++t) {
+        auto& col = m_columns[t];
+        keys.clear();
+        for (size_t i = 0; i < v.size(); i++) {
+            IndexPair& index = v[i];
+            ObjKey key = index.key_for_object;
+            if (!col.translated_keys.empty()) {
+                if (col.is_null[index.index_in_view]) {
+                    if (t == 0)
+                        index.cached_value = Mixed();
+                    continue;
+                }
+                key = col.translated_keys[index.index_in_view];
             }
-            else {
-                key = col.translated_keys[v[i].index_in_view];
+            keys.emplace_back(key, i);
+        }
+        if (!std::is_sorted(keys.begin(), keys.end()))
+            std::sort(keys.begin(), keys.end());
+
+        if (t > 0)
+            col.values.assign(max_index + 1, Mixed());
+        ObjKey previous_key;
+        Mixed value;
+        for (auto& [key, i] : keys) {
+            if (key != previous_key) {
+                value = col.table->get_object(key).get_any(col.col_key);
+                previous_key = key;
             }
+            if (t == 0)
+                v[i].cached_value = value;
+            else
+                col.values[v[i].index_in_view] = value;
         }
+    }
 
-        index.cached_value = col.table->get_object(key).get_any(ck);
+    // Compare strings by keys computed up front instead of decoding them on every comparison
+    ColKey ck = m_columns[0].col_key;
+    m_sort_keys.clear();
+    m_sort_key_data.clear();
+    if (ck.get_type() != col_type_String || v.size() < 2)
+        return;
+    m_sort_keys.resize(max_index + 1);
+    std::string key;
+    for (auto& index : v) {
+        if (index.cached_value.is_null())
+            continue;
+        if (!utf8_sort_key(index.cached_value.get_string(), key)) {
+            m_sort_keys.clear();
+            m_sort_key_data.clear();
+            return;
+        }
+        m_sort_keys[index.index_in_view] = {m_sort_key_data.size(), key.size()};
+        m_sort_key_data += key;
     }
 }
 
+int BaseDescriptor::Sorter::compare_sort_keys(const IndexPair& i, const IndexPair& j) const
+{
+    bool null_i = i.cached_value.is_null();
+    bool null_j = j.cached_value.is_null();
+    if (null_i || null_j)
+        return int(!null_i) - int(!null_j); // Null comes first
+    auto [offset_i, size_i] = m_sort_keys[i.index_in_view];
+    auto [offset_j, size_j] = m_sort_keys[j.index_in_view];
+    int c = memcmp(m_sort_key_data.data() + offset_i, m_sort_key_data.data() + offset_j, std::min(size_i, size_j));
+    if (c)
+        return c < 0 ? -1 : 1;
+    return size_i == size_j ? 0 : size_i < size_j ? -1 : 1;
+}
+
 DescriptorOrdering::DescriptorOrdering(const DescriptorOrdering& other)
     : AtomicRefCountBase()
+    , m_cancellation(other.m_cancellation)
 {
     for (const auto& d : other.m_descriptors) {
         m_descriptors.emplace_back(d->clone());
@@ -387,6 +527,7 @@ DescriptorOrdering& DescriptorOrdering::operator=(const DescriptorOrdering& rhs)
         for (const auto& d : rhs.m_descriptors) {
             m_descriptors.emplace_back(d->clone());
         }
+        m_cancellation = rhs.m_cancellation;
     }
     return *this;
 }
@@ -424,12 +565,16 @@ void DescriptorOrdering::append(const DescriptorOrdering& other)
     for (const auto& d : other.m_descriptors) {
         m_descriptors.emplace_back(d->clone());
     }
+    if (!m_cancellation)
+        m_cancellation = other.m_cancellation;
 }
 
 void DescriptorOrdering::append(DescriptorOrdering&& other)
 {
     std::move(other.m_descriptors.begin(), other.m_descriptors.end(), std::back_inserter(m_descriptors));
     other.m_descriptors.clear();
+    if (!m_cancellation)
+        m_cancellation = std::move(other.m_cancellation);
 }
 
 DescriptorType DescriptorOrdering::get_type(size_t index) const
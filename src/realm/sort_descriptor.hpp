@@ -21,9 +21,11 @@
 
 #include <vector>
 #include <unordered_set>
+#include <realm/array_blobs_big.hpp>
 #include <realm/cluster.hpp>
 #include <realm/mixed.hpp>
 #include <realm/util/bind_ptr.hpp>
+#include <realm/util/cancellation.hpp>
 
 
 namespace realm {
@@ -84,8 +86,7 @@ public:
 
         bool has_links() const
         {
-            return std::any_of(m_columns.begin(), m_columns.end(),
-                               [](auto&& col) { return !col.translated_keys.empty(); });
+            return m_has_links;
         }
 
         bool any_is_null(IndexPair i) const
@@ -94,7 +95,13 @@ public:
                 return col.is_null.empty() ? false : col.is_null[i.index_in_view];
             });
         }
+        // True if there is a single column, and values of it compare equal exactly when they
+        // are equal as Mixed, so that duplicates can be found by hashing the cached values.
+        bool has_hashable_values() const;
+        // Also fetches the values of the other columns
         void cache_first_column(IndexPairs& v);
+        // Cache the first column for a single entry. Only for sorting without links.
+        void cache_first_column(IndexPair& index) const;
 
     private:
         struct SortColumn {
@@ -106,18 +113,30 @@ public:
             }
             std::vector<bool> is_null;
             std::vector<ObjKey> translated_keys;
+            // Values by index in view, for columns other than the first. See cache_first_column().
+            std::vector<Mixed> values;
 
             const Table* table;
             ColKey col_key;
             bool ascending;
         };
         std::vector<SortColumn> m_columns;
+        // The cached values of compressed strings and binaries point into the decompression caches
+        std::vector<ArrayBigBlobs::DecompressedPin> m_pins;
         struct ObjCache {
             ObjKey key;
             Mixed value;
         };
         using TableCache = std::vector<ObjCache>;
         mutable std::vector<TableCache> m_cache;
+        bool m_has_links = false;
+        // Collation keys of the strings in the first column, see utf8_sort_key(), as
+        // (offset, size) in m_sort_key_data by index in view. Empty if not used.
+        std::vector<std::pair<size_t, size_t>> m_sort_keys;
+        std::string m_sort_key_data;
+
+        int compare_sort_keys(const IndexPair& i, const IndexPair& j) const;
+        void pin_decompressed(const SortColumn& col);
 
         friend class ObjList;
     };
@@ -156,6 +175,11 @@ public:
     }
     void collect_dependencies(const Table* table, std::vector<TableKey>& table_keys) const override;
 
+    const std::vector<std::vector<ColKey>>& get_column_keys() const noexcept
+    {
+        return m_column_keys;
+    }
+
 protected:
     std::vector<std::vector<ColKey>> m_column_keys;
 };
@@ -305,9 +329,22 @@ public:
     std::string get_description(ConstTableRef target_table) const;
     void collect_dependencies(const Table* table);
     void get_versions(const Group* group, TableVersions& versions) const;
+
+    // A token which cancels the evaluation of a query using this ordering, see Query::set_cancellation(). It is not
+    // a descriptor, so it does not make the ordering non-empty.
+    void set_cancellation(std::shared_ptr<const util::CancellationToken> token) noexcept
+    {
+        m_cancellation = std::move(token);
+    }
+    const std::shared_ptr<const util::CancellationToken>& get_cancellation() const noexcept
+    {
+        return m_cancellation;
+    }
+
 private:
     std::vector<std::unique_ptr<BaseDescriptor>> m_descriptors;
     std::vector<TableKey> m_dependencies;
+    std::shared_ptr<const util::CancellationToken> m_cancellation;
 };
 }
 
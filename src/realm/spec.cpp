@@ -45,6 +45,7 @@ void Spec::init(MemRef mem) noexcept
 
     m_types.init_from_ref(m_top.get_as_ref(0));
     m_names.init_from_ref(m_top.get_as_ref(1));
+    m_name_lookup.reset();
     m_attr.init_from_ref(m_top.get_as_ref(2));
 
     while (m_top.size() < 6) {
@@ -95,6 +96,7 @@ void Spec::update_from_parent() noexcept
     m_top.update_from_parent();
     m_types.update_from_parent();
     m_names.update_from_parent();
+    m_name_lookup.reset();
     m_attr.update_from_parent();
 
     if (m_top.get_as_ref(4) != 0) {
@@ -165,9 +167,10 @@ MemRef Spec::create_empty_spec(Allocator& alloc)
 ColKey Spec::update_colkey(ColKey existing_key, size_t spec_ndx, TableKey table_key)
 {
     auto attr = get_column_attr(spec_ndx);
-    // index and uniqueness are not passed on to the key, so clear them
+    // index, uniqueness and compression are not passed on to the key, so clear them
     attr.reset(col_attr_Indexed);
     attr.reset(col_attr_Unique);
+    attr.reset(col_attr_Compressed);
     auto type = get_column_type(spec_ndx);
     if (existing_key.get_type() != type || existing_key.get_attrs() != attr) {
         unsigned upper = unsigned(table_key.value);
@@ -189,11 +192,13 @@ bool Spec::convert_column_attributes()
             if (name.size() == 0) {
                 auto new_name = std::string("col_") + util::to_string(column_ndx);
                 m_names.set(column_ndx, new_name);
+                m_name_lookup.reset();
                 changes = true;
             }
             else if (m_names.find_first(name) != column_ndx) {
                 auto new_name = std::string(name.data()) + '_' + util::to_string(column_ndx);
                 m_names.set(column_ndx, new_name);
+                m_name_lookup.reset();
                 changes = true;
             }
         }
@@ -304,6 +309,7 @@ void Spec::insert_column(size_t column_ndx, ColKey col_key, ColumnType type, Str
 
     if (type != col_type_BackLink) {
         m_names.insert(column_ndx, name); // Throws
+        m_name_lookup.reset();
         m_num_public_columns++;
     }
 
@@ -348,6 +354,7 @@ void Spec::erase_column(size_t column_ndx)
         }
         m_num_public_columns--;
         m_names.erase(column_ndx); // Throws
+        m_name_lookup.reset();
     }
 
     // Delete the entries common for all columns
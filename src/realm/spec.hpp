@@ -91,6 +91,7 @@ private:
     Array m_top;
     Array m_types;            // 1st slot in m_top
     ArrayStringShort m_names; // 2nd slot in m_top
+    ArrayStringShortLookup m_name_lookup;
     Array m_attr;             // 3rd slot in m_top
     // 4th slot in m_top is vacant
     Array m_enumkeys; // 5th slot in m_top
@@ -207,6 +208,7 @@ inline void Spec::rename_column(size_t column_ndx, StringData new_name)
 {
     REALM_ASSERT(column_ndx < m_types.size());
     m_names.set(column_ndx, new_name);
+    m_name_lookup.reset();
 }
 
 inline size_t Spec::get_column_count() const noexcept
@@ -263,7 +265,7 @@ inline StringData Spec::get_column_name(size_t ndx) const noexcept
 
 inline size_t Spec::get_column_index(StringData name) const noexcept
 {
-    return m_names.find_first(name);
+    return m_name_lookup.find(m_names, name);
 }
 
 inline bool Spec::operator!=(const Spec& s) const noexcept
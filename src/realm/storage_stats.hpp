@@ -0,0 +1,93 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_STORAGE_STATS_HPP
+#define REALM_STORAGE_STATS_HPP
+
+#include <realm/keys.hpp>
+
+#include <string>
+#include <vector>
+
+namespace realm {
+
+/// Where the bytes of a snapshot are, as computed by
+/// Group::get_storage_stats(). All sizes are in bytes, and are the sizes of
+/// the array nodes in the file.
+struct StorageStats {
+    struct Column {
+        ColKey key;
+        std::string name;
+        /// The values, including those of the collections in the column
+        size_t payload_bytes = 0;
+        /// The search index, if any
+        size_t index_bytes = 0;
+    };
+
+    struct Table {
+        TableKey key;
+        std::string name;
+        size_t num_objects = 0;
+        /// Columns other than backlink columns
+        std::vector<Column> columns;
+        /// The backlink columns, which record the links from other tables
+        size_t backlink_bytes = 0;
+        /// The cluster tree itself, i.e. the inner nodes, the leaves and the
+        /// object keys
+        size_t cluster_bytes = 0;
+        /// The objects which have been deleted but are still linked to
+        size_t tombstone_bytes = 0;
+        /// The schema and other per table bookkeeping
+        size_t metadata_bytes = 0;
+        /// True if the sizes of the columns and clusters are extrapolated
+        /// from a sample of the clusters
+        bool is_estimate = false;
+
+        size_t get_total_bytes() const noexcept;
+    };
+
+    struct FreeList {
+        size_t free_bytes = 0;
+        size_t num_chunks = 0;
+        size_t largest_chunk = 0;
+        /// The size of the arrays which make up the free list itself
+        size_t bookkeeping_bytes = 0;
+
+        /// 0 if all free space is one chunk, approaching 1 the more it is
+        /// split up.
+        double get_fragmentation() const noexcept
+        {
+            return free_bytes == 0 ? 0 : 1 - double(largest_chunk) / double(free_bytes);
+        }
+    };
+
+    /// The logical size of the file as of the snapshot
+    size_t file_size = 0;
+    /// The top array, the table names and the table list
+    size_t group_bytes = 0;
+    /// The history used for notifications and sync
+    size_t history_bytes = 0;
+    FreeList free_list;
+    std::vector<Table> tables;
+    /// True if any of the tables is an estimate
+    bool is_estimate = false;
+};
+
+} // namespace realm
+
+#endif // REALM_STORAGE_STATS_HPP
@@ -86,6 +86,7 @@ struct Changeset {
 
     /// Insert an instruction at the end, invalidating all iterators.
     void push_back(const Instruction&);
+    void push_back(Instruction&&);
 
     //@{
     /// Insert instructions at \a position without invalidating other
@@ -610,6 +611,11 @@ inline void Changeset::push_back(const Instruction& instr)
     m_instructions.emplace_back(instr);
 }
 
+inline void Changeset::push_back(Instruction&& instr)
+{
+    m_instructions.emplace_back(std::move(instr));
+}
+
 inline auto Changeset::const_iterator_to_iterator(const_iterator cpos) -> iterator
 {
     size_t offset = cpos.m_inner - m_instructions.cbegin();
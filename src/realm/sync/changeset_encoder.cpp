@@ -1,9 +1,29 @@
 #include <realm/sync/noinst/integer_codec.hpp>
 #include <realm/sync/changeset_encoder.hpp>
 
+#include <unordered_map>
+
 using namespace realm;
 using namespace realm::sync;
 
+namespace {
+
+// Shorter runs would not be smaller than the individual instructions.
+constexpr std::size_t min_update_run_size = 3;
+
+bool is_columnar_update(const Instruction::Update& instr) noexcept
+{
+    return instr.path.size() == 0 && is_columnar_payload_type(instr.value.type);
+}
+
+bool is_same_column(const Instruction::Update& a, const Instruction::Update& b) noexcept
+{
+    return a.table == b.table && a.field == b.field && a.object.index() == b.object.index() &&
+           a.value.type == b.value.type && a.is_default == b.is_default && b.path.size() == 0;
+}
+
+} // unnamed namespace
+
 void ChangesetEncoder::operator()(const Instruction::AddTable& instr)
 {
     auto spec = mpark::get_if<Instruction::AddTable::TopLevelTable>(&instr.type);
@@ -56,10 +76,15 @@ void ChangesetEncoder::operator()(const Instruction::Update& instr)
 
 // Appends sequence [value-type, dumb-value]
 void ChangesetEncoder::append_value(const Instruction::Payload& payload)
+{
+    append_value(payload.type);
+    append_payload_data(payload);
+}
+
+void ChangesetEncoder::append_payload_data(const Instruction::Payload& payload)
 {
     using Type = Instruction::Payload::Type;
 
-    append_value(payload.type);
     const auto& data = payload.data;
 
     switch (payload.type) {
@@ -423,10 +448,99 @@ void ChangesetEncoder::encode_single(const Changeset& log)
         for (size_t i = 0; i < strings.size(); ++i) {
             set_intern_string(uint32_t(i), strings[i]); // Throws
         }
-        for (auto instr : log) {
+        for (auto it = log.begin(), end = log.end(); it != end;) {
+            auto instr = *it;
+            ++it;
             if (!instr)
                 continue;
-            (*this)(*instr); // Throws
+            auto update = instr->get_if<Instruction::Update>();
+            if (!m_columnar_updates || !update || !is_columnar_update(*update)) {
+                (*this)(*instr); // Throws
+                continue;
+            }
+
+            m_update_run.clear();
+            m_update_run.push_back(update); // Throws
+            auto next = it;
+            for (; next != end; ++next) {
+                if (!*next)
+                    continue;
+                auto next_update = (*next)->get_if<Instruction::Update>();
+                if (!next_update || !is_same_column(*update, *next_update))
+                    break;
+                m_update_run.push_back(next_update); // Throws
+            }
+            if (m_update_run.size() < min_update_run_size) {
+                (*this)(*instr); // Throws
+                continue;
+            }
+            append_update_run(); // Throws
+            it = next;
+        }
+    }
+}
+
+// Appends sequence [InstrTypeUpdateRun, count, table, field, key-type,
+// value-type, is-default, keys..., values...]
+void ChangesetEncoder::append_update_run()
+{
+    using Type = Instruction::Payload::Type;
+
+    const Instruction::Update& first = *m_update_run.front();
+    append_int(uint64_t(InstrTypeUpdateRun));
+    append_value(uint32_t(m_update_run.size()));
+    append_value(first.table);
+    append_value(first.field);
+    append_value(get_primary_key_type(first.object));
+    append_value(first.value.type);
+    append_value(first.is_default);
+
+    // Integer keys and values are delta-encoded, as they are often sequential.
+    int64_t prev_key = 0;
+    for (auto update : m_update_run) {
+        auto append_key = util::overload{
+            [&](mpark::monostate) {},
+            [&](int64_t value) {
+                append_value(int64_t(uint64_t(value) - uint64_t(prev_key)));
+                prev_key = value;
+            },
+            [&](auto value) {
+                append_value(value);
+            },
+        };
+        mpark::visit(std::move(append_key), update->object);
+    }
+
+    switch (first.value.type) {
+        case Type::Int: {
+            int64_t prev_value = 0;
+            for (auto update : m_update_run) {
+                int64_t value = update->value.data.integer;
+                append_value(int64_t(uint64_t(value) - uint64_t(prev_value)));
+                prev_value = value;
+            }
+            return;
         }
+        case Type::String:
+        case Type::Binary: {
+            // Strings are dictionary-encoded. A string is written out in full
+            // the first time it occurs, and referred to by its index in the
+            // dictionary afterwards.
+            std::unordered_map<std::string_view, uint32_t> dictionary;
+            for (auto update : m_update_run) {
+                const auto& data = update->value.data;
+                StringBufferRange range = (first.value.type == Type::String ? data.str : data.binary);
+                std::string_view str = m_string_range.substr(range.offset, range.size);
+                auto [it, inserted] = dictionary.emplace(str, uint32_t(dictionary.size())); // Throws
+                append_value(it->second);
+                if (inserted)
+                    append_string(range);
+            }
+            return;
+        }
+        default:
+            for (auto update : m_update_run)
+                append_payload_data(update->value);
+            return;
     }
 }
@@ -28,6 +28,12 @@ struct ChangesetEncoder {
 
     void encode_single(const Changeset& log);
 
+    /// If enabled, encode_single() encodes consecutive Update instructions
+    /// setting the same scalar field in the same table as columnar runs (see
+    /// `InstrTypeUpdateRun`). Such runs can only be parsed by peers that
+    /// support them, so this is disabled by default.
+    void set_columnar_updates(bool enabled) noexcept;
+
 protected:
     template <class E>
     static void encode(E& encoder, const Instruction&);
@@ -40,6 +46,8 @@ private:
     template <class... Args>
     void append_path_instr(Instruction::Type t, const Instruction::PathInstruction&, Args&&...);
     void append_string(StringBufferRange); // does not intern the string
+    void append_update_run();
+    void append_payload_data(const Instruction::Payload&);
     void append_bytes(const void*, size_t);
 
     template <class T>
@@ -69,6 +77,8 @@ private:
     Buffer m_buffer;
     std::map<std::string, uint32_t, std::less<>> m_intern_strings_rev;
     std::string_view m_string_range;
+    bool m_columnar_updates = false;
+    std::vector<const Instruction::Update*> m_update_run;
 };
 
 // Implementation
@@ -78,6 +88,11 @@ inline auto ChangesetEncoder::buffer() noexcept -> Buffer&
     return m_buffer;
 }
 
+inline void ChangesetEncoder::set_columnar_updates(bool enabled) noexcept
+{
+    m_columnar_updates = enabled;
+}
+
 inline void ChangesetEncoder::operator()(const Instruction& instr)
 {
     encode(*this, instr); // Throws
@@ -96,9 +111,11 @@ inline StringData ChangesetEncoder::get_string(StringBufferRange range) const no
     return StringData{data, size};
 }
 
-inline void encode_changeset(const Changeset& changeset, ChangesetEncoder::Buffer& out_buffer)
+inline void encode_changeset(const Changeset& changeset, ChangesetEncoder::Buffer& out_buffer,
+                             bool columnar_updates = false)
 {
     ChangesetEncoder encoder;
+    encoder.set_columnar_updates(columnar_updates);
     swap(encoder.buffer(), out_buffer);
     encoder.encode_single(changeset); // Throws
     swap(encoder.buffer(), out_buffer);
@@ -56,8 +56,10 @@ struct State {
     Instruction::Payload::Type read_payload_type();
     Instruction::AddColumn::CollectionType read_collection_type();
     Instruction::Payload read_payload();
+    void read_payload_data(Instruction::Payload&);
     Instruction::Payload::Link read_link();
     Instruction::PrimaryKey read_object_key();
+    Instruction::PrimaryKey read_object_key(Instruction::Payload::Type);
     Instruction::Path read_path();
     bool read_char(char& c) noexcept;
     void read_bytes(char* data, size_t size); // Throws
@@ -72,6 +74,7 @@ struct State {
     UUID read_uuid();                         // Throws
 
     void read_path_instr(Instruction::PathInstruction& instr);
+    void read_update_run();
 
     // Reads a string value from the stream. The returned value is only valid
     // until the next call to `read_string()` or `read_binary()`.
@@ -120,6 +123,11 @@ struct InstructionBuilder : InstructionHandler {
         m_log.push_back(instr);
     }
 
+    void emplace(Instruction&& instr) final
+    {
+        m_log.push_back(std::move(instr));
+    }
+
     StringBufferRange add_string_range(StringData string) final
     {
         return m_log.append_string(string);
@@ -195,10 +203,16 @@ Instruction::AddColumn::CollectionType State::read_collection_type()
 
 Instruction::Payload State::read_payload()
 {
-    using Type = Instruction::Payload::Type;
-
     Instruction::Payload payload;
     payload.type = read_payload_type();
+    read_payload_data(payload);
+    return payload;
+}
+
+void State::read_payload_data(Instruction::Payload& payload)
+{
+    using Type = Instruction::Payload::Type;
+
     auto& data = payload.data;
     switch (payload.type) {
         case Type::GlobalKey: {
@@ -206,49 +220,49 @@ Instruction::Payload State::read_payload()
         }
         case Type::Int: {
             data.integer = read_int();
-            return payload;
+            return;
         }
         case Type::Bool: {
             data.boolean = read_bool();
-            return payload;
+            return;
         }
         case Type::Float: {
             data.fnum = read_float();
-            return payload;
+            return;
         }
         case Type::Double: {
             data.dnum = read_double();
-            return payload;
+            return;
         }
         case Type::String: {
             StringData value = read_string();
             data.str = m_handler.add_string_range(value);
-            return payload;
+            return;
         }
         case Type::Binary: {
             BinaryData value = read_binary();
             data.binary = m_handler.add_string_range(StringData{value.data(), value.size()});
-            return payload;
+            return;
         }
         case Type::Timestamp: {
             data.timestamp = read_timestamp();
-            return payload;
+            return;
         }
         case Type::ObjectId: {
             data.object_id = read_object_id();
-            return payload;
+            return;
         }
         case Type::Decimal: {
             data.decimal = read_decimal();
-            return payload;
+            return;
         }
         case Type::UUID: {
             data.uuid = read_uuid();
-            return payload;
+            return;
         }
         case Type::Link: {
             data.link = read_link();
-            return payload;
+            return;
         }
 
         case Type::Null:
@@ -258,16 +272,20 @@ Instruction::Payload State::read_payload()
         case Type::Erased:
             [[fallthrough]];
         case Type::ObjectValue:
-            return payload;
+            return;
     }
 
     parser_error("Unsupported payload type");
 }
 
 Instruction::PrimaryKey State::read_object_key()
+{
+    return read_object_key(read_payload_type());
+}
+
+Instruction::PrimaryKey State::read_object_key(Instruction::Payload::Type type)
 {
     using Type = Instruction::Payload::Type;
-    Type type = read_payload_type();
     switch (type) {
         case Type::Null:
             return mpark::monostate{};
@@ -326,10 +344,89 @@ void State::read_path_instr(Instruction::PathInstruction& instr)
     instr.path = read_path();
 }
 
+void State::read_update_run()
+{
+    using Type = Instruction::Payload::Type;
+
+    uint32_t count = read_int<uint32_t>();
+    InternString table = read_intern_string();
+    InternString field = read_intern_string();
+    Type key_type = read_payload_type();
+    if (key_type != Type::Null && !is_valid_key_type(key_type))
+        parser_error("Unsupported object key type in update run");
+    Type value_type = read_payload_type();
+    if (!is_columnar_payload_type(value_type))
+        parser_error("Unsupported payload type in update run");
+    bool is_default = read_bool();
+
+    // Note: Not reserving `count`, because a corrupt changeset could cause
+    // std::bad_alloc to be thrown.
+    std::vector<Instruction::PrimaryKey> keys;
+    int64_t prev_key = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (key_type == Type::Int) {
+            prev_key = int64_t(uint64_t(prev_key) + uint64_t(read_int()));
+            keys.emplace_back(prev_key);
+        }
+        else {
+            keys.push_back(read_object_key(key_type));
+        }
+    }
+
+    int64_t prev_value = 0;
+    std::vector<std::string> dictionary;
+    for (auto& key : keys) {
+        Instruction::Update instr;
+        instr.table = table;
+        instr.object = std::move(key);
+        instr.field = field;
+        instr.is_default = is_default;
+        instr.value.type = value_type;
+        switch (value_type) {
+            case Type::Int:
+                prev_value = int64_t(uint64_t(prev_value) + uint64_t(read_int()));
+                instr.value.data.integer = prev_value;
+                break;
+            case Type::String:
+            case Type::Binary: {
+                uint32_t index = read_int<uint32_t>();
+                if (index == dictionary.size()) {
+                    if (value_type == Type::String) {
+                        StringData value = read_string();
+                        dictionary.emplace_back(value.data(), value.size());
+                    }
+                    else {
+                        BinaryData value = read_binary();
+                        dictionary.emplace_back(value.data(), value.size());
+                    }
+                }
+                else if (index > dictionary.size()) {
+                    parser_error("Invalid dictionary index in update run");
+                }
+                StringBufferRange range = m_handler.add_string_range(dictionary[index]);
+                if (value_type == Type::String)
+                    instr.value.data.str = range;
+                else
+                    instr.value.data.binary = range;
+                break;
+            }
+            default:
+                read_payload_data(instr.value);
+                break;
+        }
+        m_handler.emplace(std::move(instr));
+    }
+}
+
 void State::parse_one()
 {
     uint64_t t = read_int<uint64_t>();
 
+    if (t == InstrTypeUpdateRun) {
+        read_update_run();
+        return;
+    }
+
     if (t == InstrTypeInternString) {
         uint32_t index = read_int<uint32_t>();
         if (index != m_intern_strings.size()) {
@@ -370,27 +467,27 @@ void State::parse_one()
                 default:
                     parser_error("AddTable: unknown table type");
             }
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::EraseTable: {
             Instruction::EraseTable instr;
             instr.table = read_intern_string();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::CreateObject: {
             Instruction::CreateObject instr;
             instr.table = read_intern_string();
             instr.object = read_object_key();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::EraseObject: {
             Instruction::EraseObject instr;
             instr.table = read_intern_string();
             instr.object = read_object_key();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::Update: {
@@ -406,14 +503,14 @@ void State::parse_one()
             else {
                 instr.prior_size = read_int<uint32_t>();
             }
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::AddInteger: {
             Instruction::AddInteger instr;
             read_path_instr(instr);
             instr.value = read_int();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::AddColumn: {
@@ -432,14 +529,14 @@ void State::parse_one()
             else {
                 instr.key_type = Instruction::Payload::Type::Null;
             }
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::EraseColumn: {
             Instruction::EraseColumn instr;
             instr.table = read_intern_string();
             instr.field = read_intern_string();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::ArrayInsert: {
@@ -450,7 +547,7 @@ void State::parse_one()
             }
             instr.value = read_payload();
             instr.prior_size = read_int<uint32_t>();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::ArrayMove: {
@@ -461,7 +558,7 @@ void State::parse_one()
             }
             instr.ndx_2 = read_int<uint32_t>();
             instr.prior_size = read_int<uint32_t>();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::ArrayErase: {
@@ -471,7 +568,7 @@ void State::parse_one()
                 parser_error("ArrayErase without an index");
             }
             instr.prior_size = read_int<uint32_t>();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::Clear: {
@@ -479,21 +576,21 @@ void State::parse_one()
             read_path_instr(instr);
             uint32_t prior_size = read_int<uint32_t>();
             static_cast<void>(prior_size); // Ignored
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::SetInsert: {
             Instruction::SetInsert instr;
             read_path_instr(instr);
             instr.value = read_payload();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
         case Instruction::Type::SetErase: {
             Instruction::SetErase instr;
             read_path_instr(instr);
             instr.value = read_payload();
-            m_handler(instr);
+            m_handler.emplace(std::move(instr));
             return;
         }
     }
@@ -2,6 +2,7 @@
 #include <memory>
 #include <tuple>
 #include <atomic>
+#include <thread>
 
 #include "realm/sync/client_base.hpp"
 #include "realm/sync/protocol.hpp"
@@ -15,6 +16,7 @@
 #include <realm/util/bind_ptr.hpp>
 #include <realm/util/circular_buffer.hpp>
 #include <realm/util/platform_info.hpp>
+#include <realm/util/scope_exit.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/uri.hpp>
 #include <realm/util/value_reset_guard.hpp>
@@ -224,6 +226,8 @@ private:
     const std::map<std::string, std::string> m_custom_http_headers;
     const bool m_verify_servers_ssl_certificate;
     const bool m_simulate_integration_error;
+    const unsigned m_priority;
+    const std::size_t m_upload_bandwidth_limit;
     const Optional<std::string> m_ssl_trust_certificate_path;
     const std::function<SyncConfig::SSLVerifyCallback> m_ssl_verify_callback;
 
@@ -491,6 +495,58 @@ void ClientImpl::run()
 }
 
 
+ClientImpl::WorkerPool::WorkerPool(std::size_t num_threads)
+{
+    m_threads.reserve(num_threads); // Throws
+    for (std::size_t i = 0; i < num_threads; ++i)
+        m_threads.emplace_back([this] {
+            run();
+        }); // Throws
+}
+
+
+ClientImpl::WorkerPool::~WorkerPool() noexcept
+{
+    {
+        util::LockGuard lock{m_mutex};
+        m_stopped = true;
+    }
+    m_cond.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+
+void ClientImpl::WorkerPool::submit(std::function<void()> job)
+{
+    {
+        util::LockGuard lock{m_mutex};
+        m_jobs.push_back(std::move(job)); // Throws
+    }
+    m_cond.notify();
+}
+
+
+void ClientImpl::WorkerPool::run() noexcept
+{
+    for (;;) {
+        std::function<void()> job;
+        {
+            util::LockGuard lock{m_mutex};
+            while (!m_stopped && m_jobs.empty())
+                m_cond.wait(lock);
+            // Jobs that are still queued when the pool is destroyed are
+            // discarded. Their completion handlers would never run anyway.
+            if (m_stopped)
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+
 void ClientImpl::start_keep_running_timer()
 {
     auto handler = [this](std::error_code ec) {
@@ -645,6 +701,26 @@ void SessionImpl::on_connection_state_changed(ConnectionState state,
 }
 
 
+SessionImpl::Session(SessionWrapper& wrapper, Connection& conn)
+    : Session{wrapper, conn, conn.get_client().get_next_session_ident()} // Throws
+{
+}
+
+SessionImpl::Session(SessionWrapper& wrapper, Connection& conn, session_ident_type ident)
+    : logger{make_logger_prefix(ident), conn.logger} // Throws
+    , m_conn{conn}
+    , m_ident{ident}
+    , m_is_flx_sync_session(conn.is_flx_sync_connection())
+    , m_fix_up_object_ids(get_client().m_fix_up_object_ids)
+    , m_wrapper{wrapper}
+    , m_priority{wrapper.m_priority}
+    , m_upload_bandwidth_limit{wrapper.m_upload_bandwidth_limit}
+    , m_realm_path{wrapper.m_db->get_path()} // Throws
+{
+    if (get_client().m_disable_upload_activation_delay)
+        m_allow_upload = true;
+}
+
 const std::string& SessionImpl::get_virt_path() const noexcept
 {
     return m_wrapper.m_virt_path;
@@ -789,8 +865,15 @@ void SessionImpl::process_pending_flx_bootstrap()
     VersionInfo new_version;
     SyncProgress progress;
     int64_t query_version = -1;
+
+    // In pipelined mode the next batch is read and decompressed on a background
+    // thread while the current one is being integrated.
+    const bool pipelined = get_client().pipeline_bootstraps();
+    util::Optional<PendingBootstrapStore::PendingBatch> prefetched_batch;
     while (bootstrap_store->has_pending()) {
-        auto pending_batch = bootstrap_store->peek_pending(batch_size_in_bytes);
+        auto pending_batch =
+            prefetched_batch ? std::move(*prefetched_batch) : bootstrap_store->peek_pending(batch_size_in_bytes);
+        prefetched_batch = util::none;
         if (!pending_batch.progress) {
             logger.info("Incomplete pending bootstrap found for query version %1", pending_batch.query_version);
             bootstrap_store->clear();
@@ -808,6 +891,24 @@ void SessionImpl::process_pending_flx_bootstrap()
         }
 
 
+        PendingBootstrapStore::PendingBatch next_batch;
+        std::exception_ptr prefetch_error;
+        std::thread prefetcher;
+        if (pipelined && pending_batch.remaining > 0) {
+            prefetcher = std::thread([&, offset = pending_batch.changesets.size()] {
+                try {
+                    next_batch = bootstrap_store->peek_pending(batch_size_in_bytes, offset); // Throws
+                }
+                catch (...) {
+                    prefetch_error = std::current_exception();
+                }
+            });
+        }
+        auto join_prefetcher = util::make_scope_exit([&]() noexcept {
+            if (prefetcher.joinable())
+                prefetcher.join();
+        });
+
         history.integrate_server_changesets(
             *pending_batch.progress, &downloadable_bytes, pending_batch.changesets, new_version, batch_state, logger,
             [&](const TransactionRef& tr) {
@@ -816,6 +917,13 @@ void SessionImpl::process_pending_flx_bootstrap()
             get_transact_reporter());
         progress = *pending_batch.progress;
 
+        if (prefetcher.joinable()) {
+            prefetcher.join();
+            if (prefetch_error)
+                std::rethrow_exception(prefetch_error);
+            prefetched_batch = std::move(next_batch);
+        }
+
         logger.info("Integrated %1 changesets from pending bootstrap for query version %2, producing client version "
                     "%3. %4 changesets remaining in bootstrap",
                     pending_batch.changesets.size(), pending_batch.query_version, new_version.realm_version,
@@ -882,6 +990,8 @@ SessionWrapper::SessionWrapper(ClientImpl& client, DBRef db, std::shared_ptr<Sub
     , m_custom_http_headers{config.custom_http_headers}
     , m_verify_servers_ssl_certificate{config.verify_servers_ssl_certificate}
     , m_simulate_integration_error{config.simulate_integration_error}
+    , m_priority{config.priority}
+    , m_upload_bandwidth_limit{config.upload_bandwidth_limit}
     , m_ssl_trust_certificate_path{std::move(config.ssl_trust_certificate_path)}
     , m_ssl_verify_callback{std::move(config.ssl_verify_callback)}
     , m_http_request_path_prefix{std::move(config.service_identifier)}
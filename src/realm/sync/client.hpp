@@ -307,6 +307,18 @@ public:
 
         util::Optional<SyncConfig::ProxyConfig> proxy_config;
 
+        /// The priority of this session relative to other sessions that share
+        /// the same connection (see ClientConfig::one_connection_per_session).
+        /// Outgoing messages of sessions of different priorities are
+        /// interleaved such that each priority gets a share of the connection
+        /// that is proportional to its value. Must be at least 1.
+        unsigned priority = 1;
+
+        /// If nonzero, the number of bytes per second that this session is
+        /// allowed to send to the server on average. Messages are never split,
+        /// so the limit is enforced by delaying the next message.
+        std::size_t upload_bandwidth_limit = 0;
+
         /// Set to true to cause the integration of the first received changeset
         /// (in a DOWNLOAD message) to fail.
         ///
@@ -271,12 +271,13 @@ struct ClientConfig {
     /// For testing purposes only.
     bool disable_upload_activation_delay = false;
 
-    /// If `disable_upload_compaction` is true, every changeset will be
-    /// compacted before it is uploaded to the server. Compaction will
-    /// reduce the size of a changeset if the same field is set multiple
-    /// times or if newly created objects are deleted within the same
-    /// transaction. Log compaction increeses CPU usage and memory
-    /// consumption.
+    /// Unless `disable_upload_compaction` is true, the changesets of each
+    /// UPLOAD message will be compacted before they are sent to the
+    /// server. Compaction will reduce the size of the changesets if the same
+    /// field is set multiple times or if newly created objects are deleted
+    /// again, also when this happens across several transactions. See
+    /// `_impl::compact_changesets_for_upload()` for details. Log compaction
+    /// increases CPU usage and memory consumption.
     bool disable_upload_compaction = false;
 
     /// The specified function will be called whenever a PONG message is
@@ -299,6 +300,51 @@ struct ClientConfig {
     /// requires pks for all tables, so this is now only applicable to old sync
     /// tests and so is disabled by default.
     bool fix_up_object_ids = false;
+
+    /// The maximum number of threads used to transform changesets received
+    /// from the server against local changesets. Conflict groups that do not
+    /// interact with each other are merged concurrently when this is greater
+    /// than one. See sync::Transformer::set_max_threads().
+    size_t transform_max_threads = 1;
+
+    /// The approximate number of bytes of received changesets to integrate
+    /// per write transaction. A DOWNLOAD message containing more than this is
+    /// integrated in several transactions, which bounds the memory used by
+    /// the integration. Zero means that every DOWNLOAD message is integrated
+    /// in a single transaction. Changesets that are part of a bootstrap are
+    /// always integrated atomically.
+    size_t integration_chunk_size = 0;
+
+    /// If enabled, the batches of a flexible sync bootstrap are read from the
+    /// pending bootstrap store and decompressed on a background thread, while
+    /// the preceding batch is being integrated into the Realm.
+    bool pipeline_bootstraps = false;
+
+    /// The number of worker threads used to decompress the bodies of DOWNLOAD
+    /// messages, such that the event loop thread can go on serving other
+    /// connections while large messages are decompressed. Messages are still
+    /// processed by the event loop thread, and in the order they were
+    /// received on each connection. Zero means that bodies are decompressed
+    /// by the event loop thread.
+    size_t download_decompression_threads = 0;
+
+    /// If enabled, the client offers the permessage-deflate WebSocket
+    /// extension (RFC 7692) to the server. If the server accepts it, small
+    /// messages, which are not compressed by the sync protocol itself, are
+    /// compressed with a deflate context that is shared by all the messages
+    /// sent on a connection.
+    bool websocket_compression = false;
+
+    /// If enabled, a session whose Realm has not yet downloaded anything asks
+    /// the server for a snapshot of the server-side Realm (a SNAPSHOT_REQUEST
+    /// message), and adopts that snapshot instead of downloading and
+    /// integrating the entire history. Local changes which have not yet been
+    /// uploaded are replayed on top of the snapshot. Only partition based
+    /// sync sessions make the request. The messages are not part of any
+    /// released protocol version, so this must only be enabled against a
+    /// server which is known to accept them; a server which does not wish to
+    /// serve a snapshot simply ignores the request.
+    bool snapshot_bootstrap = false;
 };
 
 /// \brief Information about an error causing a session to be temporarily
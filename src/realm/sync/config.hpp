@@ -183,6 +183,12 @@ struct SyncConfig {
 
     bool simulate_integration_error = false;
 
+    // The priority of the session relative to other sessions sharing the same
+    // connection to the server, and the number of bytes per second it may
+    // send on average (0 for no limit). See sync::Session::Config.
+    unsigned priority = 1;
+    size_t upload_bandwidth_limit = 0;
+
     explicit SyncConfig(std::shared_ptr<SyncUser> user, bson::Bson partition);
     explicit SyncConfig(std::shared_ptr<SyncUser> user, std::string partition);
     explicit SyncConfig(std::shared_ptr<SyncUser> user, const char* partition);
@@ -168,6 +168,10 @@ void InstructionApplier::operator()(const Instruction::EraseTable& instr)
 
     log("sync::erase_table(m_group, \"%1\")", table_name);
     m_transaction.remove_table(table_name);
+
+    m_last_table_name = InternString{};
+    m_last_table = TableRef{};
+    reset_resolution_cache();
 }
 
 void InstructionApplier::operator()(const Instruction::CreateObject& instr)
@@ -653,6 +657,7 @@ void InstructionApplier::operator()(const Instruction::EraseColumn& instr)
     }
 
     table->remove_column(col);
+    m_column_cache.clear();
 }
 
 void InstructionApplier::operator()(const Instruction::ArrayInsert& instr)
@@ -1138,10 +1143,18 @@ TableRef InstructionApplier::get_table(const Instruction::TableInstruction& inst
         return m_last_table;
     }
     else {
-        auto table_name = get_table_name(instr, name);
-        TableRef table = m_transaction.get_table(table_name);
+        TableRef table;
+        if (instr.table.value < m_table_cache.size())
+            table = m_table_cache[instr.table.value];
         if (!table) {
-            bad_transaction_log("%1: Table '%2' does not exist", name, table_name);
+            auto table_name = get_table_name(instr, name);
+            table = m_transaction.get_table(table_name);
+            if (!table) {
+                bad_transaction_log("%1: Table '%2' does not exist", name, table_name);
+            }
+            if (instr.table.value >= m_table_cache.size())
+                m_table_cache.resize(instr.table.value + 1); // Throws
+            m_table_cache[instr.table.value] = table;
         }
         m_last_table = table;
         m_last_table_name = instr.table;
@@ -1153,6 +1166,19 @@ TableRef InstructionApplier::get_table(const Instruction::TableInstruction& inst
     }
 }
 
+ColKey InstructionApplier::get_column_key(const Table& table, InternString field)
+{
+    uint64_t cache_key = (uint64_t(table.get_key().value) << 32) | field.value;
+    auto it = m_column_cache.find(cache_key);
+    if (it != m_column_cache.end())
+        return it->second;
+
+    ColKey col = table.get_column_key(get_string(field));
+    if (col)
+        m_column_cache.emplace(cache_key, col); // Throws
+    return col;
+}
+
 util::Optional<Obj> InstructionApplier::get_top_object(const Instruction::ObjectInstruction& instr,
                                                        const std::string_view& name)
 {
@@ -1311,7 +1337,7 @@ InstructionApplier::PathResolver::Status InstructionApplier::PathResolver::resol
 InstructionApplier::PathResolver::Status InstructionApplier::PathResolver::resolve_field(Obj& obj, InternString field)
 {
     auto field_name = get_string(field);
-    ColKey col = obj.get_table()->get_column_key(field_name);
+    ColKey col = m_applier->get_column_key(*obj.get_table(), field);
     if (!col) {
         on_error(util::format("%1: No such field: '%2' in class '%3'", m_instr_name, field_name,
                               obj.get_table()->get_name()));
@@ -22,10 +22,13 @@
 #include <realm/sync/instructions.hpp>
 #include <realm/sync/changeset.hpp>
 #include <realm/util/logger.hpp>
+#include <realm/util/tracing.hpp>
 #include <realm/list.hpp>
 #include <realm/dictionary.hpp>
 
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace realm {
 namespace sync {
@@ -133,8 +136,17 @@ private:
     util::Optional<Obj> m_last_object;
     std::unique_ptr<LstBase> m_last_list;
 
+    // Tables and columns resolved while applying the current changeset,
+    // indexed by the interned name of the table, and by the key of the table
+    // combined with the interned name of the column respectively. Instructions
+    // that alter the schema invalidate the affected entries.
+    std::vector<TableRef> m_table_cache;
+    std::unordered_map<uint64_t, ColKey> m_column_cache;
+
     StringData get_table_name(const Instruction::TableInstruction&, const std::string_view& instr = "(unspecified)");
     TableRef get_table(const Instruction::TableInstruction&, const std::string_view& instr = "(unspecified)");
+    ColKey get_column_key(const Table&, InternString field);
+    void reset_resolution_cache() noexcept;
 
     // Note: This may return a non-invalid ObjKey if the key is dangling.
     ObjKey get_object_key(Table& table, const Instruction::PrimaryKey&,
@@ -160,6 +172,7 @@ inline void InstructionApplier::begin_apply(const Changeset& log, util::Logger*
 {
     m_log = &log;
     m_logger = logger;
+    reset_resolution_cache();
 }
 
 inline void InstructionApplier::end_apply() noexcept
@@ -173,33 +186,48 @@ inline void InstructionApplier::end_apply() noexcept
     m_last_object.reset();
     m_last_object_key.reset();
     m_last_list.reset();
+    reset_resolution_cache();
+}
+
+inline void InstructionApplier::reset_resolution_cache() noexcept
+{
+    m_table_cache.clear();
+    m_column_cache.clear();
 }
 
 template <class A>
 inline void InstructionApplier::apply(A& applier, const Changeset& changeset, util::Logger* logger)
 {
+    util::tracing::Span span("InstructionApplier::apply");
+    int64_t num_instructions = 0;
     applier.begin_apply(changeset, logger);
     for (auto instr : changeset) {
         if (!instr)
             continue;
         instr->visit(applier); // Throws
+        ++num_instructions;
     }
     applier.end_apply();
+    span.set_attribute("instructions", num_instructions);
 }
 
 template <class A>
 inline void InstructionApplier::apply(A& applier, Changeset& changeset, util::Logger* logger)
 {
+    util::tracing::Span span("InstructionApplier::apply");
+    int64_t num_instructions = 0;
     applier.begin_apply(changeset, logger);
     for (auto instr : changeset) {
         if (!instr)
             continue;
         instr->visit(applier); // Throws
+        ++num_instructions;
 #if REALM_DEBUG
         applier.m_table_info_cache.verify();
 #endif
     }
     applier.end_apply();
+    span.set_attribute("instructions", num_instructions);
 }
 
 inline void InstructionApplier::apply(const Changeset& log, util::Logger* logger)
@@ -298,6 +298,47 @@ void SyncReplication::create_object_with_primary_key(const Table* table, ObjKey
 }
 
 
+bool SyncReplication::create_asymmetric_object(const Table* table, Mixed pk, const FieldValues& values)
+{
+    // Only a client uploads the objects of asymmetric tables, and only
+    // values which can be expressed as a single Update bypass the table.
+    if (get_history_type() != HistoryType::hist_SyncClient)
+        return false;
+    auto pk_col = table->get_primary_key_column();
+    for (auto& val : values) {
+        if (val.col_key == pk_col)
+            continue;
+        if (val.col_key.is_collection() || val.col_key.get_type() == col_type_Link ||
+            val.value.is_type(type_Link, type_TypedLink))
+            return false;
+    }
+
+    if (!select_table(*table))
+        return true;
+    if (m_write_validator) {
+        m_write_validator(*table);
+    }
+
+    Instruction::CreateObject create_instr;
+    create_instr.table = m_last_class_name;
+    create_instr.object = as_primary_key(pk);
+    emit(create_instr);
+
+    for (auto& val : values) {
+        if (val.col_key == pk_col)
+            continue;
+        Instruction::Update instr;
+        instr.table = m_last_class_name;
+        instr.object = create_instr.object;
+        instr.field = m_encoder.intern_string(table->get_column_name(val.col_key));
+        instr.value = as_payload(*table, val.col_key, val.value);
+        instr.is_default = val.is_default;
+        emit(instr);
+    }
+    return true;
+}
+
+
 void SyncReplication::prepare_erase_class(TableKey table_key)
 {
     REALM_ASSERT(!m_table_being_erased);
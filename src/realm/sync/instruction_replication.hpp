@@ -76,6 +76,7 @@ public:
     void dictionary_erase(const CollectionBase&, size_t ndx, Mixed key) final;
 
     void remove_object(const Table*, ObjKey) final;
+    bool create_asymmetric_object(const Table*, Mixed, const FieldValues&) final;
 
     //@{
 
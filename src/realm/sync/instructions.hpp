@@ -847,6 +847,55 @@ inline bool is_valid_key_type(Instruction::Payload::Type type) noexcept
     }
 }
 
+inline Instruction::Payload::Type get_primary_key_type(const Instruction::PrimaryKey& key) noexcept
+{
+    using Type = Instruction::Payload::Type;
+    auto get_type = util::overload{
+        [](mpark::monostate) {
+            return Type::Null;
+        },
+        [](int64_t) {
+            return Type::Int;
+        },
+        [](InternString) {
+            return Type::String;
+        },
+        [](GlobalKey) {
+            return Type::GlobalKey;
+        },
+        [](ObjectId) {
+            return Type::ObjectId;
+        },
+        [](UUID) {
+            return Type::UUID;
+        },
+    };
+    return mpark::visit(get_type, key);
+}
+
+/// Whether Update instructions with payloads of the specified type may be
+/// encoded as part of an `InstrTypeUpdateRun`.
+inline bool is_columnar_payload_type(Instruction::Payload::Type type) noexcept
+{
+    using Type = Instruction::Payload::Type;
+    switch (type) {
+        case Type::Null:
+        case Type::Int:
+        case Type::Bool:
+        case Type::String:
+        case Type::Binary:
+        case Type::Timestamp:
+        case Type::Float:
+        case Type::Double:
+        case Type::Decimal:
+        case Type::ObjectId:
+        case Type::UUID:
+            return true;
+        default:
+            return false;
+    }
+}
+
 inline DataType get_data_type(Instruction::Payload::Type type) noexcept
 {
     using Type = Instruction::Payload::Type;
@@ -891,6 +940,11 @@ inline DataType get_data_type(Instruction::Payload::Type type) noexcept
 // encoded integer instruction format.
 static constexpr uint8_t InstrTypeInternString = 0x3f;
 
+// A run of Update instructions setting the same scalar field of many objects
+// in the same table, encoded column-wise. The parser expands it into the
+// individual Update instructions. See `doc/changeset.md`.
+static constexpr uint8_t InstrTypeUpdateRun = 0x3e;
+
 // This instruction code is only ever used internally by the Changeset class
 // to allow insertion/removal while keeping iterators stable. Should never
 // make it onto the wire.
@@ -910,6 +964,15 @@ struct InstructionHandler {
 
     /// Handle an instruction.
     virtual void operator()(const Instruction&) = 0;
+
+    /// Handle an instruction that the handler may take ownership of. The
+    /// parser passes every instruction this way, so a handler that stores the
+    /// instructions can avoid copying their paths. The default implementation
+    /// forwards to operator().
+    virtual void emplace(Instruction&& instr)
+    {
+        (*this)(instr);
+    }
 };
 
 
@@ -19,9 +19,11 @@
 #include "realm/util/functional.hpp"
 #include <realm/sync/noinst/client_history_impl.hpp>
 
+#include <realm/metrics/latency.hpp>
 #include <realm/util/compression.hpp>
 #include <realm/util/features.h>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/tracing.hpp>
 #include <realm/sync/changeset.hpp>
 #include <realm/sync/changeset_parser.hpp>
 #include <realm/sync/instruction_applier.hpp>
@@ -312,7 +314,8 @@ void ClientHistory::set_sync_progress(const SyncProgress& progress, const std::u
 
 void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, version_type end_version,
                                                std::vector<UploadChangeset>& uploadable_changesets,
-                                               version_type& locked_server_version) const
+                                               version_type& locked_server_version,
+                                               std::size_t soft_size_limit) const
 {
     TransactionRef rt = m_db->start_read(); // Throws
     auto& alloc = m_db->get_alloc();
@@ -324,7 +327,7 @@ void ClientHistory::find_uploadable_changesets(UploadCursor& upload_progress, ve
     const auto sync_history_size = arrays.changesets.size();
     const auto sync_history_base_version = rt->get_version() - sync_history_size;
 
-    std::size_t accum_byte_size_soft_limit = 0x20000;  // 128 KB
+    std::size_t accum_byte_size_soft_limit = soft_size_limit;
     std::size_t accum_byte_size_hard_limit = 16777216; // server-imposed limit
     std::size_t accum_byte_size = 0;
 
@@ -385,7 +388,57 @@ void ClientHistory::integrate_server_changesets(const SyncProgress& progress,
                                                 SyncTransactReporter* transact_reporter)
 {
     REALM_ASSERT(incoming_changesets.size() != 0);
+#if REALM_METRICS
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::sync_integrate);
+#endif
+    util::tracing::Span span("ClientHistory::integrate_server_changesets");
+    span.set_attribute("changesets", int64_t(incoming_changesets.size()));
+
+    // A DOWNLOAD message that completes a batch may be integrated in several
+    // transactions, such that only one chunk of parsed and transformed
+    // changesets is held in memory at a time. Each intermediate transaction
+    // records a download cursor pointing at its last changeset, so a chunk is
+    // only ever ended between changesets of different server versions. The
+    // changesets of a bootstrap, and those integrated together with
+    // `run_in_write_tr`, must be integrated atomically.
+    bool split = (m_integration_chunk_size != 0 && batch_state == DownloadBatchState::LastInBatch &&
+                  !run_in_write_tr);
+    std::size_t begin = 0;
+    while (begin < incoming_changesets.size()) {
+        std::size_t end = incoming_changesets.size();
+        if (split) {
+            std::uint_fast64_t chunk_size = 0;
+            for (std::size_t i = begin; i < incoming_changesets.size(); ++i) {
+                chunk_size += incoming_changesets[i].data.size();
+                bool next_is_newer =
+                    (i + 1 < incoming_changesets.size() &&
+                     incoming_changesets[i + 1].remote_version > incoming_changesets[i].remote_version);
+                if (chunk_size >= m_integration_chunk_size && next_is_newer) {
+                    end = i + 1;
+                    break;
+                }
+            }
+        }
+        bool last_chunk = (end == incoming_changesets.size());
+        auto chunk = incoming_changesets.sub_span(begin, end - begin);
+        integrate_server_changeset_chunk(progress, downloadable_bytes, chunk, begin, version_info, batch_state,
+                                         last_chunk, logger, run_in_write_tr, transact_reporter); // Throws
+        if (!last_chunk) {
+            logger.debug("Integrated changesets %1 to %2 of %3 from DOWNLOAD message, producing client version %4",
+                         begin + 1, end, incoming_changesets.size(), version_info.realm_version); // Throws
+        }
+        begin = end;
+    }
+}
+
 
+void ClientHistory::integrate_server_changeset_chunk(
+    const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
+    util::Span<const RemoteChangeset> incoming_changesets, std::size_t transform_sequence_offset,
+    VersionInfo& version_info, DownloadBatchState batch_state, bool last_chunk, util::Logger& logger,
+    util::UniqueFunction<void(const TransactionRef&)>& run_in_write_tr, SyncTransactReporter* transact_reporter)
+{
+    util::tracing::Span span("ClientHistory::integrate_server_changeset_chunk");
     std::uint_fast64_t downloaded_bytes_in_message = 0;
     std::vector<Changeset> changesets;
     changesets.resize(incoming_changesets.size()); // Throws
@@ -395,13 +448,15 @@ void ClientHistory::integrate_server_changesets(const SyncProgress& progress,
             const RemoteChangeset& changeset = incoming_changesets[i];
             downloaded_bytes_in_message += changeset.original_changeset_size;
             parse_remote_changeset(changeset, changesets[i]); // Throws
-            changesets[i].transform_sequence = i;
+            changesets[i].transform_sequence = transform_sequence_offset + i;
         }
     }
     catch (const TransformError& e) {
         throw IntegrationException(ClientError::bad_changeset,
                                    util::format("Failed to parse received changeset: %1", e.what()));
     }
+    span.set_attribute("changesets", int64_t(incoming_changesets.size()));
+    span.set_attribute("bytes", int64_t(downloaded_bytes_in_message));
 
     TransactionRef transact = m_db->start_write(); // Throws
     VersionID old_version = transact->get_version_of_current_transaction();
@@ -472,10 +527,16 @@ void ClientHistory::integrate_server_changesets(const SyncProgress& progress,
 
     // During the bootstrap phase in flexible sync, the server sends multiple download messages with the same
     // synthetic server version that represents synthetic changesets generated from state on the server.
-    if (batch_state == DownloadBatchState::LastInBatch) {
+    if (!last_chunk) {
+        const RemoteChangeset& last_changeset = incoming_changesets.back();
+        update_download_progress({last_changeset.remote_version,
+                                  last_changeset.last_integrated_local_version}); // Throws
+    }
+    else if (batch_state == DownloadBatchState::LastInBatch) {
         update_sync_progress(progress, downloadable_bytes, transact); // Throws
     }
     if (run_in_write_tr) {
+        REALM_ASSERT(last_chunk);
         run_in_write_tr(transact);
     }
 
@@ -723,6 +784,30 @@ void ClientHistory::add_sync_history_entry(const HistoryEntry& entry)
 }
 
 
+void ClientHistory::update_download_progress(const DownloadCursor& download)
+{
+    Array& root = m_arrays->root;
+
+    // Progress must never decrease
+    if (download.server_version <
+        version_type(root.get_as_ref_or_tagged(s_progress_download_server_version_iip).get_as_int())) {
+        throw IntegrationException(ClientError::bad_progress, "server version of download cursor cannot decrease");
+    }
+    if (download.last_integrated_client_version <
+        version_type(root.get_as_ref_or_tagged(s_progress_download_client_version_iip).get_as_int())) {
+        throw IntegrationException(ClientError::bad_progress,
+                                   "last integrated client version of download cursor cannot decrease");
+    }
+
+    root.set(s_progress_download_server_version_iip,
+             RefOrTagged::make_tagged(download.server_version)); // Throws
+    root.set(s_progress_download_client_version_iip,
+             RefOrTagged::make_tagged(download.last_integrated_client_version)); // Throws
+
+    m_progress_download = download;
+}
+
+
 void ClientHistory::update_sync_progress(const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes,
                                          TransactionRef wt)
 {
@@ -802,7 +887,7 @@ void ClientHistory::trim_ct_history()
     version_type end = m_version_of_oldest_bound_snapshot;
     REALM_ASSERT(end >= begin);
 
-    std::size_t n = std::size_t(end - begin);
+    std::size_t n = std::min(std::size_t(end - begin), s_max_trimmed_per_transaction);
     if (n == 0)
         return;
 
@@ -888,7 +973,7 @@ void ClientHistory::trim_sync_history()
         end += i;
     }
 
-    std::size_t n = std::size_t(end - begin);
+    std::size_t n = std::min(std::size_t(end - begin), s_max_trimmed_per_transaction);
     do_trim_sync_history(n); // Throws
 }
 
@@ -1163,10 +1248,10 @@ void ClientHistory::get_changesets(version_type begin_version, version_type end_
 void ClientHistory::set_oldest_bound_version(version_type version)
 {
     REALM_ASSERT(version >= m_version_of_oldest_bound_snapshot);
-    if (version > m_version_of_oldest_bound_snapshot) {
-        m_version_of_oldest_bound_snapshot = version;
-        trim_ct_history(); // Throws
-    }
+    m_version_of_oldest_bound_snapshot = version;
+    // Also when the version is unchanged, as the previous trimming may have
+    // stopped short of it
+    trim_ct_history(); // Throws
 }
 
 // Overriding member function in realm::_impl::History
@@ -179,6 +179,17 @@ public:
     /// of the estimate of the number of remaining bytes to be downloaded.
     void set_sync_progress(const SyncProgress& progress, const std::uint_fast64_t* downloadable_bytes, VersionInfo&);
 
+    /// Set the maximum number of threads used by the transformer when
+    /// integrating changesets received from the server. See
+    /// Transformer::set_max_threads().
+    void set_transform_max_threads(size_t max_threads) noexcept;
+
+    /// Set the approximate number of bytes of received changesets that
+    /// integrate_server_changesets() integrates per write transaction. When
+    /// this is zero, which is the default, all the changesets of a DOWNLOAD
+    /// message are integrated in a single transaction.
+    void set_integration_chunk_size(size_t chunk_size) noexcept;
+
     /// \brief Scan through the history for changesets to be uploaded.
     ///
     /// This function scans the history for changesets to be uploaded, i.e., for
@@ -206,7 +217,8 @@ public:
     /// reflect a value of UploadChangeset::progress produced by an earlier
     /// invocation of find_uploadable_changesets().
     ///
-    /// Found changesets are added to \a uploadable_changesets.
+    /// Found changesets are added to \a uploadable_changesets, until their
+    /// combined size reaches \a soft_size_limit.
     ///
     /// \param locked_server_version will be set to the value that should be
     /// used as `<locked server version>` in a DOWNLOAD message.
@@ -215,7 +227,10 @@ public:
     /// be zero.
     void find_uploadable_changesets(UploadCursor& upload_progress, version_type end_version,
                                     std::vector<UploadChangeset>& uploadable_changesets,
-                                    version_type& locked_server_version) const;
+                                    version_type& locked_server_version,
+                                    std::size_t soft_size_limit = default_upload_size_limit) const;
+
+    static constexpr std::size_t default_upload_size_limit = 0x20000; // 128 KB
 
     /// \brief Integrate a sequence of changesets received from the server using
     /// a single Realm transaction.
@@ -277,6 +292,10 @@ public: // Stuff in this section is only used by tests.
 private:
     friend class ClientReplication;
     static constexpr version_type s_initial_version = 1;
+    // The most history entries trimmed by a single write transaction, so that
+    // catching up on a long backlog of trimming does not stall one commit.
+    // The rest is trimmed by the following transactions.
+    static constexpr std::size_t s_max_trimmed_per_transaction = 1000;
 
     ClientHistory(ClientReplication& owner)
         : m_replication(owner)
@@ -289,6 +308,8 @@ private:
     // FIXME: All history objects belonging to a particular client object
     // (sync::Client) should use a single shared transformer object.
     std::unique_ptr<Transformer> m_transformer;
+    size_t m_transform_max_threads = 1;
+    size_t m_integration_chunk_size = 0;
 
     /// The version on which the first changeset in the continuous transactions
     /// history is based, or if that history is empty, the version associated
@@ -418,7 +439,13 @@ private:
     void prepare_for_write();
     Replication::version_type add_changeset(BinaryData changeset, BinaryData sync_changeset);
     void add_sync_history_entry(const HistoryEntry&);
+    void integrate_server_changeset_chunk(const SyncProgress&, const std::uint_fast64_t* downloadable_bytes,
+                                          util::Span<const RemoteChangeset>, std::size_t transform_sequence_offset,
+                                          VersionInfo&, DownloadBatchState, bool last_chunk, util::Logger&,
+                                          util::UniqueFunction<void(const TransactionRef&)>& run_in_write_tr,
+                                          SyncTransactReporter*);
     void update_sync_progress(const SyncProgress&, const std::uint_fast64_t* downloadable_bytes, TransactionRef);
+    void update_download_progress(const DownloadCursor&);
     void trim_ct_history();
     void trim_sync_history();
     void do_trim_sync_history(std::size_t n);
@@ -546,10 +573,24 @@ inline void ClientHistory::clamp_sync_version_range(version_type& begin, version
     }
 }
 
+inline void ClientHistory::set_transform_max_threads(size_t max_threads) noexcept
+{
+    m_transform_max_threads = max_threads;
+    if (m_transformer)
+        m_transformer->set_max_threads(max_threads);
+}
+
+inline void ClientHistory::set_integration_chunk_size(size_t chunk_size) noexcept
+{
+    m_integration_chunk_size = chunk_size;
+}
+
 inline auto ClientHistory::get_transformer() -> Transformer&
 {
-    if (!m_transformer)
+    if (!m_transformer) {
         m_transformer = make_transformer(); // Throws
+        m_transformer->set_max_threads(m_transform_max_threads);
+    }
     return *m_transformer;
 }
 
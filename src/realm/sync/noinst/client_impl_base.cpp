@@ -14,8 +14,10 @@
 #include <realm/util/platform_info.hpp>
 #include <realm/sync/impl/clock.hpp>
 #include <realm/impl/simulated_failure.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/sync/noinst/client_history_impl.hpp>
 #include <realm/sync/noinst/client_impl_base.hpp>
+#include <realm/sync/noinst/client_reset.hpp>
 #include <realm/sync/noinst/compact_changesets.hpp>
 #include <realm/sync/protocol.hpp>
 #include <realm/version.hpp>
@@ -116,14 +118,22 @@ ClientImpl::ClientImpl(ClientConfig config)
     , m_enable_default_port_hack{config.enable_default_port_hack}
     , m_disable_upload_compaction{config.disable_upload_compaction}
     , m_fix_up_object_ids{config.fix_up_object_ids}
+    , m_transform_max_threads{config.transform_max_threads}
+    , m_integration_chunk_size{config.integration_chunk_size}
+    , m_pipeline_bootstraps{config.pipeline_bootstraps}
+    , m_snapshot_bootstrap{config.snapshot_bootstrap}
     , m_roundtrip_time_handler{std::move(config.roundtrip_time_handler)}
     , m_user_agent_string{make_user_agent_string(config)} // Throws
     , m_service{}                                         // Throws
+    , m_decompression_pool{config.download_decompression_threads > 0
+                               ? std::make_unique<WorkerPool>(config.download_decompression_threads)
+                               : nullptr} // Throws
     , m_socket_factory(util::websocket::EZConfig{
           logger,
           m_random,
           m_service,
           get_user_agent_string(),
+          config.websocket_compression,
       })
     , m_client_protocol{} // Throws
     , m_one_connection_per_session{config.one_connection_per_session}
@@ -159,6 +169,18 @@ ClientImpl::ClientImpl(ClientConfig config)
                  config.disable_upload_compaction); // Throws
     logger.debug("Config param: disable_sync_to_disk = %1",
                  config.disable_sync_to_disk); // Throws
+    logger.debug("Config param: transform_max_threads = %1",
+                 config.transform_max_threads); // Throws
+    logger.debug("Config param: integration_chunk_size = %1",
+                 config.integration_chunk_size); // Throws
+    logger.debug("Config param: pipeline_bootstraps = %1",
+                 config.pipeline_bootstraps); // Throws
+    logger.debug("Config param: download_decompression_threads = %1",
+                 config.download_decompression_threads); // Throws
+    logger.debug("Config param: websocket_compression = %1",
+                 config.websocket_compression); // Throws
+    logger.debug("Config param: snapshot_bootstrap = %1",
+                 config.snapshot_bootstrap); // Throws
     logger.debug("User agent string: '%1'", get_user_agent_string());
 
     if (config.reconnect_mode != ReconnectMode::normal) {
@@ -836,6 +858,20 @@ void Connection::initiate_write_message(const OutputBuffer& out, Session* sess)
     m_websocket->async_write_binary(out.data(), out.size(), std::move(handler)); // Throws
     m_sending_session = sess;
     m_sending = true;
+    charge_for_message(*sess, out.size());
+}
+
+
+void Connection::initiate_write_message(const OutputBuffer& header, BinaryData body, Session* sess)
+{
+    auto handler = [this] {
+        handle_write_message(); // Throws
+    };
+    util::Span<const char> payload[] = {{header.data(), std::size_t(header.size())}, {body.data(), body.size()}};
+    m_websocket->async_write_binary(payload, std::move(handler)); // Throws
+    m_sending_session = sess;
+    m_sending = true;
+    charge_for_message(*sess, std::size_t(header.size()) + body.size());
 }
 
 
@@ -868,8 +904,11 @@ void Connection::send_next_message()
         // provided by util::Websocket::async_write_text(), and friends.
         REALM_ASSERT(m_state == ConnectionState::connected);
 
-        Session& sess = *m_sessions_enlisted_to_send.front();
-        m_sessions_enlisted_to_send.pop_front();
+        auto i = select_session_to_send(); // Throws
+        if (i == m_sessions_enlisted_to_send.end())
+            break; // All enlisted sessions are throttled
+        Session& sess = **i;
+        m_sessions_enlisted_to_send.erase(i);
         sess.send_message(); // Throws
 
         if (sess.m_state == Session::Deactivated) {
@@ -886,6 +925,93 @@ void Connection::send_next_message()
 }
 
 
+// Sessions are served in order of the virtual time of their priority (see
+// `m_send_virtual_times`), which shares the outgoing bandwidth between the
+// priorities in proportion to their values. Sessions of the same priority are
+// served in the order that they enlisted, and a session is never served before
+// a session associated with the same Realm file that enlisted earlier.
+//
+// Returns the end of the queue if all enlisted sessions are throttled due to
+// their upload bandwidth limit, in which case sending is resumed when the
+// first of them is allowed to send again. The limit does not hold back the
+// messages that rebind a session after the connection was lost (see
+// Session::next_message_is_urgent()).
+auto Connection::select_session_to_send() -> std::deque<Session*>::iterator
+{
+    auto begin = m_sessions_enlisted_to_send.begin();
+    auto end = m_sessions_enlisted_to_send.end();
+    auto selected = end;
+    std::uint_fast64_t selected_virtual_time = 0;
+    milliseconds_type now = 0;
+    milliseconds_type throttled_until = 0;
+    for (auto i = begin; i != end; ++i) {
+        Session& sess = **i;
+        if (sess.m_send_throttled_until != 0 && !sess.next_message_is_urgent()) {
+            if (now == 0)
+                now = monotonic_clock_now();
+            if (sess.m_send_throttled_until > now) {
+                if (throttled_until == 0 || sess.m_send_throttled_until < throttled_until)
+                    throttled_until = sess.m_send_throttled_until;
+                continue;
+            }
+        }
+        std::uint_fast64_t virtual_time = m_send_virtual_time;
+        auto j = m_send_virtual_times.find(sess.get_priority());
+        if (j != m_send_virtual_times.end() && j->second > virtual_time)
+            virtual_time = j->second;
+        if (selected == end || virtual_time < selected_virtual_time) {
+            selected = i;
+            selected_virtual_time = virtual_time;
+        }
+    }
+
+    if (selected == end) {
+        REALM_ASSERT(throttled_until > now);
+        initiate_send_throttle_delay(throttled_until - now); // Throws
+        return end;
+    }
+
+    // Not get_realm_path(), as deactivating sessions may be enlisted
+    const std::string& realm_path = (*selected)->m_realm_path;
+    for (auto i = begin; i != selected; ++i) {
+        if ((*i)->m_realm_path == realm_path) {
+            selected = i;
+            break;
+        }
+    }
+    m_send_virtual_time = selected_virtual_time;
+    return selected;
+}
+
+
+void Connection::charge_for_message(Session& sess, std::size_t size)
+{
+    // Scaled so that small messages still advance the virtual time of high
+    // priorities.
+    constexpr std::uint_fast64_t scale = 1024;
+    unsigned priority = std::max(sess.get_priority(), 1U);
+    std::uint_fast64_t& virtual_time = m_send_virtual_times[priority]; // Throws
+    virtual_time = std::max(virtual_time, m_send_virtual_time) + std::uint_fast64_t(size) * scale / priority;
+
+    if (std::size_t limit = sess.get_upload_bandwidth_limit()) {
+        milliseconds_type now = monotonic_clock_now();
+        milliseconds_type time = milliseconds_type(std::uint_fast64_t(size) * 1000 / limit);
+        sess.m_send_throttled_until = std::max(sess.m_send_throttled_until, now) + time;
+    }
+}
+
+
+void Connection::initiate_send_throttle_delay(milliseconds_type delay)
+{
+    auto handler = [this](std::error_code ec) {
+        if (ec != util::error::operation_aborted && m_state == ConnectionState::connected && !m_sending)
+            send_next_message(); // Throws
+    };
+    m_send_throttle_timer.emplace(m_client.get_service());                                   // Throws
+    m_send_throttle_timer->async_wait(std::chrono::milliseconds(delay), std::move(handler)); // Throws
+}
+
+
 void Connection::send_ping()
 {
     REALM_ASSERT(!m_ping_delay_in_progress);
@@ -929,9 +1055,76 @@ void Connection::handle_write_ping()
 
 void Connection::handle_message_received(const char* data, std::size_t size)
 {
+    std::string_view msg_data(data, size);
+    if (m_client.m_decompression_pool) {
+        // Messages must be processed in the order they are received, so while
+        // a DOWNLOAD message is being decompressed, every following message
+        // has to wait in the queue.
+        if (msg_data.substr(0, 9) == "download " || !m_incoming_messages.empty()) {
+            initiate_decompression(msg_data); // Throws
+            return;
+        }
+    }
+
     // parse_message_received() parses the message and calls the proper handler
     // on the Connection object (this).
-    get_client_protocol().parse_message_received<Connection>(*this, std::string_view(data, size));
+    get_client_protocol().parse_message_received<Connection>(*this, msg_data);
+}
+
+
+void Connection::initiate_decompression(std::string_view msg_data)
+{
+    auto msg = std::make_shared<IncomingMessage>();
+    msg->data = std::string(msg_data); // Throws
+    m_incoming_messages.push_back(msg); // Throws
+    if (msg_data.substr(0, 9) != "download ") {
+        msg->ready = true;
+        return;
+    }
+
+    std::weak_ptr<IncomingMessage> weak_msg = msg;
+    msg.reset();
+    auto job = [client = &m_client, conn = this, is_flx = is_flx_sync_connection(), weak_msg] {
+        util::compression::CompressMemoryArena compress_memory_arena;
+        if (auto msg = weak_msg.lock()) {
+            // A DOWNLOAD message with a malformed header or an uncompressed
+            // body is left to parse_message_received(), and so is one that
+            // could not be decompressed due to lack of memory.
+            try {
+                msg->decompressed_body =
+                    ClientProtocol::decompress_download_body(msg->data, is_flx, compress_memory_arena); // Throws
+            }
+            catch (const std::bad_alloc&) {
+            }
+        }
+        // The queue of the connection must hold the only reference to the
+        // message when the handler runs, as it is otherwise impossible to
+        // tell whether the connection still exists.
+        client->get_service().post([conn, weak_msg] {
+            if (auto msg = weak_msg.lock()) {
+                msg->ready = true;
+                conn->process_incoming_messages(); // Throws
+            }
+        }); // Throws
+    };
+    m_client.m_decompression_pool->submit(std::move(job)); // Throws
+}
+
+
+void Connection::process_incoming_messages()
+{
+    while (!m_incoming_messages.empty() && m_incoming_messages.front()->ready) {
+        std::shared_ptr<IncomingMessage> msg = std::move(m_incoming_messages.front());
+        m_incoming_messages.pop_front();
+        const ClientProtocol::DecompressedDownloadBody* decompressed_body =
+            msg->decompressed_body ? &*msg->decompressed_body : nullptr;
+        get_client_protocol().parse_message_received<Connection>(*this, msg->data, decompressed_body); // Throws
+
+        // The connection may have been closed by the handler of the message,
+        // in which case the queue is cleared.
+        if (!m_websocket)
+            return;
+    }
 }
 
 
@@ -1115,8 +1308,12 @@ void Connection::disconnect(const SessionErrorInfo& info)
 
     m_websocket.reset();
     m_input_body_buffer.reset();
+    m_incoming_messages.clear();
     m_sending_session = nullptr;
     m_sessions_enlisted_to_send.clear();
+    m_send_virtual_times.clear();
+    m_send_virtual_time = 0;
+    m_send_throttle_timer = util::none;
     m_sending = false;
 
     report_connection_state_change(ConnectionState::disconnected, info); // Throws
@@ -1256,6 +1453,22 @@ void Connection::receive_ident_message(session_ident_type session_ident, SaltedF
         close_due_to_protocol_error(ec); // Throws
 }
 
+void Connection::receive_snapshot_message(session_ident_type session_ident, SaltedVersion server_version,
+                                          BinaryData body)
+{
+    Session* sess = get_session(session_ident);
+    if (REALM_UNLIKELY(!sess)) {
+        logger.error("Bad session identifier in SNAPSHOT message, session_ident = %1",
+                     session_ident);                                 // Throws
+        close_due_to_protocol_error(ClientError::bad_session_ident); // Throws
+        return;
+    }
+
+    std::error_code ec = sess->receive_snapshot_message(server_version, body); // Throws
+    if (ec)
+        close_due_to_protocol_error(ec); // Throws
+}
+
 void Connection::receive_download_message(session_ident_type session_ident, const SyncProgress& progress,
                                           std::uint_fast64_t downloadable_bytes, int64_t query_version,
                                           DownloadBatchState batch_state,
@@ -1343,8 +1556,9 @@ void Connection::handle_protocol_error(ClientProtocol::Error error)
 }
 
 
-// Sessions are guaranteed to be granted the opportunity to send a message in
-// the order that they enlist. Note that this is important to ensure
+// Sessions associated with the same Realm file are guaranteed to be granted the
+// opportunity to send a message in the order that they enlist (see
+// select_session_to_send()). Note that this is important to ensure
 // nonoverlapping communication with the server for consecutive sessions
 // associated with the same Realm file.
 //
@@ -1394,6 +1608,8 @@ void Session::integrate_changesets(ClientReplication& repl, const SyncProgress&
         history.set_sync_progress(progress, &downloadable_bytes, version_info); // Throws
         return;
     }
+    history.set_transform_max_threads(get_client().m_transform_max_threads);
+    history.set_integration_chunk_size(get_client().m_integration_chunk_size);
     history.integrate_server_changesets(progress, &downloadable_bytes, received_changesets, version_info,
                                         download_batch_state, logger, {}, get_transact_reporter()); // Throws
     if (received_changesets.size() == 1) {
@@ -1601,8 +1817,15 @@ void Session::send_message()
         return send_bind_message(); // Throws
 
     if (!m_ident_message_sent) {
-        if (have_client_file_ident())
+        if (have_client_file_ident()) {
+            // A snapshot is only worth asking for when nothing has been
+            // downloaded yet, since it replaces the entire download
+            bool request_snapshot = (get_client().m_snapshot_bootstrap && !m_is_flx_sync_session &&
+                                     m_progress.download.server_version == 0 && !m_snapshot_request_sent);
+            if (request_snapshot)
+                return send_snapshot_request_message(); // Throws
             send_ident_message(); // Throws
+        }
         return;
     }
 
@@ -1634,7 +1857,10 @@ void Session::send_message()
 
     REALM_ASSERT(m_upload_progress.client_version <= m_upload_target_version);
     REALM_ASSERT(m_upload_target_version <= m_last_version_available);
-    if (m_allow_upload && (m_upload_target_version > m_upload_progress.client_version)) {
+    // Changesets uploaded before the snapshot is taken would be part of it,
+    // and would then be uploaded again as recovered local changes
+    if (m_allow_upload && !m_snapshot_pending && (m_upload_target_version > m_upload_progress.client_version) &&
+        m_upload_flow_control.can_send()) {
         return send_upload_message(); // Throws
     }
 }
@@ -1668,6 +1894,28 @@ void Session::send_bind_message()
 }
 
 
+void Session::send_snapshot_request_message()
+{
+    REALM_ASSERT(m_state == Active);
+    REALM_ASSERT(m_bind_message_sent);
+    REALM_ASSERT(!m_ident_message_sent);
+    REALM_ASSERT(have_client_file_ident());
+
+    logger.debug("Sending: SNAPSHOT_REQUEST"); // Throws
+
+    ClientProtocol& protocol = m_conn.get_client_protocol();
+    OutputBuffer& out = m_conn.get_output_buffer();
+    protocol.make_snapshot_request_message(out, m_ident); // Throws
+    m_conn.initiate_write_message(out, this);             // Throws
+
+    m_snapshot_request_sent = true;
+    m_snapshot_pending = true;
+
+    // Ready to send the IDENT message
+    enlist_to_send(); // Throws
+}
+
+
 void Session::send_ident_message()
 {
     REALM_ASSERT(m_state == Active);
@@ -1750,6 +1998,10 @@ void Session::send_upload_message()
     if (REALM_UNLIKELY(get_client().is_dry_run()))
         return;
 
+#if REALM_METRICS
+    metrics::LatencyTimer latency_timer(metrics::LatencyMetric::sync_upload);
+#endif
+
     auto target_upload_version = m_upload_target_version;
     if (m_is_flx_sync_session) {
         if (!m_pending_flx_sub_set || m_pending_flx_sub_set->snapshot_version < m_upload_progress.client_version) {
@@ -1768,7 +2020,8 @@ void Session::send_upload_message()
     std::vector<UploadChangeset> uploadable_changesets;
     version_type locked_server_version = 0;
     repl.get_history().find_uploadable_changesets(m_upload_progress, target_upload_version, uploadable_changesets,
-                                                  locked_server_version); // Throws
+                                                  locked_server_version,
+                                                  m_upload_flow_control.get_message_size()); // Throws
 
     if (uploadable_changesets.empty()) {
         // Nothing more to upload right now
@@ -1788,9 +2041,42 @@ void Session::send_upload_message()
 
     ClientProtocol& protocol = m_conn.get_client_protocol();
     ClientProtocol::UploadMessageBuilder upload_message_builder =
-        protocol.make_upload_message_builder(logger); // Throws
+        m_conn.make_upload_message_builder(logger); // Throws
+
+    // Compaction takes place across all the changesets of the UPLOAD message,
+    // which is safe because none of them have been seen by the server yet.
+    std::vector<ChangesetEncoder::Buffer> compacted_changesets;
+    if (!get_client().m_disable_upload_compaction) {
+        std::vector<Changeset> changesets;
+        changesets.reserve(uploadable_changesets.size()); // Throws
+        std::size_t original_size = 0;
+        for (const UploadChangeset& uc : uploadable_changesets) {
+            ChunkedBinaryInputStream stream{uc.changeset};
+            Changeset& changeset = changesets.emplace_back(); // Throws
+            parse_changeset(stream, changeset);                // Throws
+            changeset.version = uc.progress.client_version;
+            changeset.last_integrated_remote_version = uc.progress.last_integrated_server_version;
+            changeset.origin_timestamp = uc.origin_timestamp;
+            changeset.origin_file_ident = uc.origin_file_ident;
+            original_size += uc.changeset.size();
+        }
+
+        compact_changesets_for_upload(changesets.data(), changesets.size()); // Throws
 
-    for (const UploadChangeset& uc : uploadable_changesets) {
+        bool columnar_updates =
+            (m_conn.get_negotiated_protocol_version() >= get_columnar_changesets_protocol_version());
+        std::size_t compacted_size = 0;
+        compacted_changesets.resize(changesets.size()); // Throws
+        for (std::size_t i = 0; i < changesets.size(); ++i) {
+            encode_changeset(changesets[i], compacted_changesets[i], columnar_updates); // Throws
+            compacted_size += compacted_changesets[i].size();
+        }
+        logger.debug("Upload compaction: original size = %1, compacted size = %2", original_size,
+                     compacted_size); // Throws
+    }
+
+    for (std::size_t i = 0; i < uploadable_changesets.size(); ++i) {
+        const UploadChangeset& uc = uploadable_changesets[i];
         logger.debug("Fetching changeset for upload (client_version=%1, server_version=%2, "
                      "changeset_size=%3, origin_timestamp=%4, origin_file_ident=%5)",
                      uc.progress.client_version, uc.progress.last_integrated_server_version, uc.changeset.size(),
@@ -1816,36 +2102,17 @@ void Session::send_upload_message()
 #endif
         }
 
-#if 0 // Upload log compaction is currently not implemented
-        if (!get_client().m_disable_upload_compaction) {
-            ChangesetEncoder::Buffer encode_buffer;
-
-            {
-                // Upload compaction only takes place within single changesets to
-                // avoid another client seeing inconsistent snapshots.
-                ChunkedBinaryInputStream stream{uc.changeset};
-                Changeset changeset;
-                parse_changeset(stream, changeset); // Throws
-                // FIXME: What is the point of setting these? How can compaction care about them?
-                changeset.version = uc.progress.client_version;
-                changeset.last_integrated_remote_version = uc.progress.last_integrated_server_version;
-                changeset.origin_timestamp = uc.origin_timestamp;
-                changeset.origin_file_ident = uc.origin_file_ident;
-
-                compact_changesets(&changeset, 1);
-                encode_changeset(changeset, encode_buffer);
-
-                logger.debug("Upload compaction: original size = %1, compacted size = %2", uc.changeset.size(),
-                             encode_buffer.size()); // Throws
-            }
-
+        if (!compacted_changesets.empty()) {
+            const ChangesetEncoder::Buffer& encode_buffer = compacted_changesets[i];
+            // Changesets that were entirely cancelled out by later ones need
+            // not be uploaded, as the upload progress covers them anyway.
+            if (encode_buffer.size() == 0)
+                continue;
             upload_message_builder.add_changeset(
                 uc.progress.client_version, uc.progress.last_integrated_server_version, uc.origin_timestamp,
                 uc.origin_file_ident, BinaryData{encode_buffer.data(), encode_buffer.size()}); // Throws
         }
-        else
-#endif
-        {
+        else {
             upload_message_builder.add_changeset(uc.progress.client_version,
                                                  uc.progress.last_integrated_server_version, uc.origin_timestamp,
                                                  uc.origin_file_ident,
@@ -1856,10 +2123,16 @@ void Session::send_upload_message()
     int protocol_version = m_conn.get_negotiated_protocol_version();
     OutputBuffer& out = m_conn.get_output_buffer();
     session_ident_type session_ident = get_ident();
-    upload_message_builder.make_upload_message(protocol_version, out, session_ident, progress_client_version,
-                                               progress_server_version,
-                                               locked_server_version); // Throws
-    m_conn.initiate_write_message(out, this);                          // Throws
+    BinaryData body = upload_message_builder.make_upload_message(protocol_version, out, session_ident,
+                                                                 progress_client_version, progress_server_version,
+                                                                 locked_server_version); // Throws
+    m_conn.initiate_write_message(out, body, this);                                      // Throws
+
+    m_upload_flow_control.on_upload_sent(m_upload_progress.client_version, body.size(),
+                                         monotonic_clock_now()); // Throws
+    logger.trace("Upload window: %1 bytes, %2 bytes in flight, round-trip time %3 ms",
+                 m_upload_flow_control.get_window(), m_upload_flow_control.get_bytes_in_flight(),
+                 m_upload_flow_control.get_round_trip_time()); // Throws
 
     // Other messages may be waiting to be sent
     enlist_to_send(); // Throws
@@ -2016,6 +2289,83 @@ std::error_code Session::receive_ident_message(SaltedFileIdent client_file_ident
     return std::error_code{};  // Success
 }
 
+std::error_code Session::receive_snapshot_message(SaltedVersion server_version, BinaryData body)
+{
+    logger.debug("Received: SNAPSHOT(server_version=%1, server_version_salt=%2, body_size=%3)",
+                 server_version.version, server_version.salt, body.size()); // Throws
+
+    // Ignore the message if the deactivation process has been initiated,
+    // because in that case, the associated Realm must not be accessed any
+    // longer.
+    if (m_state != Active)
+        return std::error_code{}; // Success
+
+    bool legal_at_this_time = (m_ident_message_sent && m_snapshot_pending && !m_error_message_received &&
+                               !m_unbound_message_received);
+    if (REALM_UNLIKELY(!legal_at_this_time)) {
+        logger.error("Illegal message at this time");
+        return ClientError::bad_message_order;
+    }
+    if (REALM_UNLIKELY(server_version.version == 0)) {
+        logger.error("Bad server version in SNAPSHOT message");
+        return ClientError::bad_server_version;
+    }
+    m_snapshot_pending = false;
+
+    if (REALM_UNLIKELY(get_client().is_dry_run()))
+        return std::error_code{}; // Success
+
+    ClientReplication& repl = access_realm(); // Throws
+    DBRef db = get_db();
+
+    // The snapshot is written to a file next to the Realm, as it must be
+    // opened as a Realm of its own, and encrypted like the Realm itself
+    std::string snapshot_path = get_realm_path() + ".snapshot";
+    _impl::client_reset::LocalVersionIDs version_ids;
+    try {
+        DB::delete_files(snapshot_path); // Throws
+        Group(body, false).write(snapshot_path, db->get_encryption_key()); // Throws
+        DBOptions options;
+        options.encryption_key = db->get_encryption_key();
+        DBRef db_snapshot = DB::create(snapshot_path, true, options); // Throws
+        auto clean_up_snapshot = util::make_scope_exit([&]() noexcept {
+            try {
+                db_snapshot.reset();
+                DB::call_with_lock(snapshot_path, [](const std::string& path) {
+                    DB::delete_files(path);
+                });
+            }
+            catch (const std::exception& e) {
+                logger.warn("The snapshot '%1' could not be cleaned up: %2", snapshot_path, e.what());
+            }
+        });
+        version_ids = _impl::client_reset::perform_snapshot_bootstrap(db, db_snapshot, server_version,
+                                                                      logger); // Throws
+    }
+    catch (const std::exception& e) {
+        logger.error("Failed to integrate snapshot: %1", e.what());
+        return ClientError::bad_changeset;
+    }
+
+    SaltedFileIdent client_file_ident;
+    repl.get_history().get_status(m_last_version_available, client_file_ident, m_progress); // Throws
+    REALM_ASSERT_EX(m_progress.download.server_version == server_version.version,
+                    m_progress.download.server_version, server_version.version);
+    logger.trace("last_version_available  = %1", m_last_version_available); // Throws
+
+    // The local changes have been replayed as a single new changeset, which
+    // is uploaded from scratch
+    m_download_progress = m_progress.download;
+    m_upload_target_version = m_last_version_available;
+    m_upload_progress = m_progress.upload;
+    m_last_version_selected_for_upload = m_upload_progress.client_version;
+
+    get_transact_reporter()->report_sync_transact(version_ids.old_version, version_ids.new_version);
+
+    ensure_enlisted_to_send(); // Throws
+    return std::error_code{};  // Success
+}
+
 void Session::receive_download_message(const SyncProgress& progress, std::uint_fast64_t downloadable_bytes,
                                        DownloadBatchState batch_state, int64_t query_version,
                                        const ReceivedChangesets& received_changesets)
@@ -2041,6 +2391,10 @@ void Session::receive_download_message(const SyncProgress& progress, std::uint_f
         m_conn.close_due_to_protocol_error(ClientError::bad_message_order);
         return;
     }
+    // The server did not send a snapshot, so the history is downloaded as
+    // usual
+    m_snapshot_pending = false;
+
     int error_code = 0;
     if (REALM_UNLIKELY(!check_received_sync_progress(progress, error_code))) {
         logger.error("Bad sync progress received (%1)", error_code);
@@ -2087,6 +2441,11 @@ void Session::receive_download_message(const SyncProgress& progress, std::uint_f
         }
     }
 
+    // The upload progress reported by the server acknowledges the UPLOAD
+    // messages up to it, which may allow more of them to be sent
+    if (m_upload_flow_control.on_upload_acknowledged(progress.upload.client_version, monotonic_clock_now()))
+        ensure_enlisted_to_send(); // Throws
+
     receive_download_message_hook(progress, query_version, batch_state);
 
     if (process_flx_bootstrap_message(progress, batch_state, query_version, received_changesets)) {
@@ -9,6 +9,7 @@
 #include <map>
 #include <string>
 #include <random>
+#include <thread>
 
 #include <realm/binary_data.hpp>
 #include <realm/util/optional.hpp>
@@ -20,6 +21,7 @@
 #include <realm/sync/noinst/client_history_impl.hpp>
 #include <realm/sync/noinst/protocol_codec.hpp>
 #include <realm/sync/noinst/client_reset_operation.hpp>
+#include <realm/sync/noinst/upload_flow_control.hpp>
 #include <realm/sync/client_base.hpp>
 #include <realm/sync/history.hpp>
 #include <realm/sync/protocol.hpp>
@@ -130,6 +132,7 @@ public:
     const std::string& get_user_agent_string() const noexcept;
     ReconnectMode get_reconnect_mode() const noexcept;
     bool is_dry_run() const noexcept;
+    bool pipeline_bootstraps() const noexcept;
     util::network::Service& get_service() noexcept;
     std::mt19937_64& get_random() noexcept;
 
@@ -154,9 +157,39 @@ private:
     const bool m_enable_default_port_hack;
     const bool m_disable_upload_compaction;
     const bool m_fix_up_object_ids;
+    const size_t m_transform_max_threads;
+    const size_t m_integration_chunk_size;
+    const bool m_pipeline_bootstraps;
+    const bool m_snapshot_bootstrap;
     const std::function<RoundtripTimeHandler> m_roundtrip_time_handler;
     const std::string m_user_agent_string;
     util::network::Service m_service;
+
+    // A pool of threads executing jobs submitted from the event loop thread.
+    // A job must not access anything owned by the event loop thread, but it
+    // may post a completion handler to the service object.
+    class WorkerPool {
+    public:
+        WorkerPool(std::size_t num_threads);
+        ~WorkerPool() noexcept;
+
+        void submit(std::function<void()> job);
+
+    private:
+        util::Mutex m_mutex;
+        util::CondVar m_cond;
+        std::deque<std::function<void()>> m_jobs; // Protected by `m_mutex`
+        bool m_stopped = false;                   // Protected by `m_mutex`
+        std::vector<std::thread> m_threads;
+
+        void run() noexcept;
+    };
+
+    // Used for decompressing the bodies of DOWNLOAD messages when
+    // `ClientConfig::download_decompression_threads` is nonzero. Must be
+    // declared after `m_service`, because jobs post to it.
+    std::unique_ptr<WorkerPool> m_decompression_pool;
+
     std::mt19937_64 m_random;
     util::websocket::EZSocketFactory m_socket_factory;
     ClientProtocol m_client_protocol;
@@ -439,12 +472,18 @@ private:
     void initiate_pong_timeout();
     void handle_pong_timeout();
     void initiate_write_message(const OutputBuffer&, Session*);
+    void initiate_write_message(const OutputBuffer& header, BinaryData body, Session*);
     void handle_write_message();
     void send_next_message();
+    std::deque<Session*>::iterator select_session_to_send();
+    void charge_for_message(Session&, std::size_t size);
+    void initiate_send_throttle_delay(milliseconds_type delay);
     void send_ping();
     void initiate_write_ping(const OutputBuffer&);
     void handle_write_ping();
     void handle_message_received(const char* data, std::size_t size);
+    void initiate_decompression(std::string_view msg_data);
+    void process_incoming_messages();
     void initiate_disconnect_wait();
     void handle_disconnect_wait(std::error_code);
     void read_or_write_error(std::error_code);
@@ -462,6 +501,7 @@ private:
     void receive_query_error_message(int error_code, std::string_view message, int64_t query_version,
                                      session_ident_type);
     void receive_ident_message(session_ident_type, SaltedFileIdent);
+    void receive_snapshot_message(session_ident_type, SaltedVersion server_version, BinaryData body);
     void receive_download_message(session_ident_type, const SyncProgress&, std::uint_fast64_t downloadable_bytes,
                                   int64_t query_version, DownloadBatchState batch_state, const ReceivedChangesets&);
     void receive_mark_message(session_ident_type, request_ident_type);
@@ -474,6 +514,7 @@ private:
     void one_less_active_unsuspended_session();
 
     OutputBuffer& get_output_buffer() noexcept;
+    ClientProtocol::UploadMessageBuilder make_upload_message_builder(util::Logger&);
     Session* get_session(session_ident_type) const noexcept;
     static bool was_voluntary(ConnectionTerminationReason) noexcept;
 
@@ -567,18 +608,53 @@ private:
     std::map<session_ident_type, std::unique_ptr<Session>> m_sessions;
 
     // A queue of sessions that have enlisted for an opportunity to send a
-    // message to the server. Sessions will be served in the order that they
-    // enlist. A session is only allowed to occur once in this queue. If the
-    // connection is open, and the queue is not empty, and no message is
-    // currently being written, the first session is taken out of the queue, and
-    // then granted an opportunity to send a message.
+    // message to the server. Sessions of equal priority will be served in the
+    // order that they enlist. A session is only allowed to occur once in this
+    // queue. If the connection is open, and the queue is not empty, and no
+    // message is currently being written, a session is taken out of the queue
+    // by select_session_to_send(), and then granted an opportunity to send a
+    // message.
     std::deque<Session*> m_sessions_enlisted_to_send;
 
+    // The virtual time of each session priority for which a message has been
+    // sent on this connection. The virtual time of a priority advances by the
+    // size of each message sent, divided by the priority, and the priority
+    // with the lowest virtual time is served first. `m_send_virtual_time` is
+    // the virtual time of the most recently served priority.
+    std::map<unsigned, std::uint_fast64_t> m_send_virtual_times;
+    std::uint_fast64_t m_send_virtual_time = 0;
+
+    // Used to resume sending when all enlisted sessions have exceeded their
+    // upload bandwidth limit. For why this timer is optional, see
+    // `m_reconnect_disconnect_timer`.
+    util::Optional<util::network::DeadlineTimer> m_send_throttle_timer;
+
     Session* m_sending_session = nullptr;
 
     std::unique_ptr<char[]> m_input_body_buffer;
     OutputBuffer m_output_buffer;
 
+    // The body of an UPLOAD message is built in these buffers, and is sent
+    // directly from them, after the header in `m_output_buffer`.
+    OutputBuffer m_upload_body_buffer;
+    std::vector<char> m_upload_compression_buffer;
+
+    // A message that was received while the body of a preceding DOWNLOAD
+    // message was still being decompressed by the worker pool of the client,
+    // or a DOWNLOAD message whose body is being decompressed. Messages are
+    // processed in the order they were received, and only once the body of
+    // every preceding DOWNLOAD message has been decompressed.
+    struct IncomingMessage {
+        std::string data;
+        bool ready = false;
+        util::Optional<ClientProtocol::DecompressedDownloadBody> decompressed_body;
+    };
+
+    // The decompression jobs hold weak references to the queued messages, so
+    // a job that completes after the connection has been closed finds that
+    // its message is gone.
+    std::deque<std::shared_ptr<IncomingMessage>> m_incoming_messages;
+
     const connection_ident_type m_ident;
     const ServerEndpoint m_server_endpoint;
     const std::string m_authorization_header_name;
@@ -786,6 +862,12 @@ private:
     // transfer from the server.
     util::Optional<ClientReset>& get_client_reset_config() noexcept;
 
+    // The priority and upload bandwidth limit of this session, as specified
+    // in Session::Config. Unlike most of the functions above, these may also
+    // be called after initiation of deactivation.
+    unsigned get_priority() const noexcept;
+    std::size_t get_upload_bandwidth_limit() const noexcept;
+
     /// \brief Initiate the integration of downloaded changesets.
     ///
     /// This function must provide for the passed changesets (if any) to
@@ -907,6 +989,10 @@ private:
 
     bool m_fix_up_object_ids = false;
 
+    // The point in time (monotonic clock) until which this session is not
+    // allowed to send more messages due to its upload bandwidth limit.
+    milliseconds_type m_send_throttled_until = 0;
+
     // These are reset when the session is activated, and again whenever the
     // connection is lost or the rebinding process is initiated.
     bool m_enlisted_to_send;
@@ -916,6 +1002,8 @@ private:
     bool m_unbind_message_sent_2;    // Sending of UNBIND message has been completed
     bool m_error_message_received;   // Session specific ERROR message received
     bool m_unbound_message_received; // UNBOUND message received
+    bool m_snapshot_request_sent;    // Sending of SNAPSHOT_REQUEST message has been initiated
+    bool m_snapshot_pending;         // Neither SNAPSHOT nor DOWNLOAD received since SNAPSHOT_REQUEST
 
     // True when there is a new FLX sync query we need to send to the server.
     util::Optional<SubscriptionStore::PendingSubscription> m_pending_flx_sub_set;
@@ -986,6 +1074,11 @@ private:
     // INVARIANT: m_last_version_selected_for_upload <= m_upload_progress.client_version
     version_type m_last_version_selected_for_upload = 0;
 
+    // Sizes the UPLOAD messages, and limits the number of bytes of them which
+    // have not yet been acknowledged by the server. Reset whenever the
+    // connection to the server is lost.
+    UploadFlowControl m_upload_flow_control;
+
     // Same as `m_progress.download` but is updated only as the progress gets
     // persisted.
     DownloadCursor m_download_progress = {0, 0};
@@ -1021,6 +1114,13 @@ private:
 
     SessionWrapper& m_wrapper;
 
+    // Copied from the session wrapper, as they are needed for scheduling
+    // outgoing messages, including the UNBIND message, which may be sent after
+    // the session wrapper has let go of the session.
+    const unsigned m_priority;
+    const std::size_t m_upload_bandwidth_limit;
+    const std::string m_realm_path;
+
     static std::string make_logger_prefix(session_ident_type);
 
     Session(SessionWrapper& wrapper, Connection&, session_ident_type);
@@ -1029,6 +1129,12 @@ private:
 
     bool have_client_file_ident() const noexcept;
 
+    // Whether the next message of this session (re)binds it, or asks for
+    // download completion. These small messages are sent right away, also
+    // when the upload bandwidth limit of the session holds it back, so that a
+    // session resumes as soon as the connection is reestablished.
+    bool next_message_is_urgent() const noexcept;
+
     // The unbinding process completes when both of the following become true:
     //
     //  - The sending of the UNBIND message has been completed
@@ -1050,6 +1156,7 @@ private:
     void send_message();
     void message_sent();
     void send_bind_message();
+    void send_snapshot_request_message();
     void send_ident_message();
     void send_upload_message();
     void send_mark_message();
@@ -1057,6 +1164,7 @@ private:
     void send_unbind_message();
     void send_query_change_message();
     std::error_code receive_ident_message(SaltedFileIdent);
+    std::error_code receive_snapshot_message(SaltedVersion server_version, BinaryData body);
     void receive_download_message(const SyncProgress&, std::uint_fast64_t downloadable_bytes,
                                   DownloadBatchState last_in_batch, int64_t query_version, const ReceivedChangesets&);
     std::error_code receive_mark_message(request_ident_type);
@@ -1095,6 +1203,11 @@ inline bool ClientImpl::is_dry_run() const noexcept
     return m_dry_run;
 }
 
+inline bool ClientImpl::pipeline_bootstraps() const noexcept
+{
+    return m_pipeline_bootstraps;
+}
+
 inline util::network::Service& ClientImpl::get_service() noexcept
 {
     return m_service;
@@ -1214,6 +1327,13 @@ inline auto ClientImpl::Connection::get_output_buffer() noexcept -> OutputBuffer
     return m_output_buffer;
 }
 
+inline auto ClientImpl::Connection::make_upload_message_builder(util::Logger& logger)
+    -> ClientProtocol::UploadMessageBuilder
+{
+    return get_client_protocol().make_upload_message_builder(logger, m_upload_body_buffer,
+                                                             m_upload_compression_buffer); // Throws
+}
+
 inline auto ClientImpl::Connection::get_session(session_ident_type ident) const noexcept -> Session*
 {
     auto i = m_sessions.find(ident);
@@ -1295,23 +1415,6 @@ inline void ClientImpl::Session::request_download_completion_notification()
         ensure_enlisted_to_send(); // Throws
 }
 
-inline ClientImpl::Session::Session(SessionWrapper& wrapper, Connection& conn)
-    : Session{wrapper, conn, conn.get_client().get_next_session_ident()} // Throws
-{
-}
-
-inline ClientImpl::Session::Session(SessionWrapper& wrapper, Connection& conn, session_ident_type ident)
-    : logger{make_logger_prefix(ident), conn.logger} // Throws
-    , m_conn{conn}
-    , m_ident{ident}
-    , m_is_flx_sync_session(conn.is_flx_sync_connection())
-    , m_fix_up_object_ids(get_client().m_fix_up_object_ids)
-    , m_wrapper{wrapper}
-{
-    if (get_client().m_disable_upload_activation_delay)
-        m_allow_upload = true;
-}
-
 inline bool ClientImpl::Session::do_recognize_sync_version(version_type version) noexcept
 {
     if (REALM_LIKELY(version > m_last_version_available)) {
@@ -1322,11 +1425,26 @@ inline bool ClientImpl::Session::do_recognize_sync_version(version_type version)
     return false;
 }
 
+inline unsigned ClientImpl::Session::get_priority() const noexcept
+{
+    return m_priority;
+}
+
+inline std::size_t ClientImpl::Session::get_upload_bandwidth_limit() const noexcept
+{
+    return m_upload_bandwidth_limit;
+}
+
 inline bool ClientImpl::Session::have_client_file_ident() const noexcept
 {
     return (m_client_file_ident.ident != 0);
 }
 
+inline bool ClientImpl::Session::next_message_is_urgent() const noexcept
+{
+    return (!m_bind_message_sent || !m_ident_message_sent || m_target_download_mark > m_last_download_mark_sent);
+}
+
 inline bool ClientImpl::Session::unbind_process_complete() const noexcept
 {
     return (m_unbind_message_sent_2 && (m_error_message_received || m_unbound_message_received));
@@ -1431,11 +1549,14 @@ inline void ClientImpl::Session::reset_protocol_state() noexcept
     m_unbind_message_sent_2 = false;
     m_error_message_received = false;
     m_unbound_message_received = false;
+    m_snapshot_request_sent = false;
+    m_snapshot_pending = false;
 
     m_upload_progress = m_progress.upload;
     m_last_version_selected_for_upload = m_upload_progress.client_version;
     m_last_download_mark_sent          = m_last_download_mark_received;
     // clang-format on
+    m_upload_flow_control.reset();
 }
 
 inline void ClientImpl::Session::ensure_enlisted_to_send()
@@ -356,19 +356,31 @@ void transfer_group(const Transaction& group_src, Transaction& group_dst, util::
 
         converters::InterRealmObjectConverter converter(table_src, table_dst, embedded_tracker);
 
+        // Only the values which differ are written, so objects which are
+        // identical in both Realms produce no instructions and no
+        // notifications.
+        size_t num_created = 0;
+        size_t num_updated = 0;
         for (const Obj& src : *table_src) {
             auto src_pk = src.get_primary_key();
-            bool updated = false;
+            bool created = false;
             // get or create the object
-            auto dst = table_dst->create_object_with_primary_key(src_pk, &updated);
+            auto dst = table_dst->create_object_with_primary_key(src_pk, &created);
             REALM_ASSERT(dst);
 
+            bool updated = false;
             converter.copy(src, dst, &updated);
-            if (updated) {
-                logger.debug("  updating %1", src_pk);
+            if (created) {
+                ++num_created;
+            }
+            else if (updated) {
+                ++num_updated;
+                logger.trace("  updating %1", src_pk);
             }
         }
         embedded_tracker->process_pending();
+        logger.debug("Table '%1': %2 objects created, %3 updated, %4 unchanged", table_name, num_created, num_updated,
+                     table_src->size() - num_created - num_updated);
     }
 }
 
@@ -662,4 +674,84 @@ LocalVersionIDs perform_client_reset_diff(DBRef db_local, DBRef db_remote, sync:
     return LocalVersionIDs{old_version_local, new_version_local};
 }
 
+LocalVersionIDs perform_snapshot_bootstrap(DBRef db_local, DBRef db_snapshot, sync::SaltedVersion server_version,
+                                           util::Logger& logger)
+{
+    REALM_ASSERT(db_local);
+    REALM_ASSERT(db_snapshot);
+    logger.info("Snapshot bootstrap, path_local = %1, snapshot = %2, server_version = %3, "
+                "server_version_salt = %4",
+                db_local->get_path(), db_snapshot->get_path(), server_version.version, server_version.salt);
+
+    auto frozen_pre_local_state = db_local->start_frozen();
+    auto wt_local = db_local->start_write();
+    auto client_repl = dynamic_cast<ClientReplication*>(wt_local->get_replication());
+    REALM_ASSERT_RELEASE(client_repl);
+    auto history_local = dynamic_cast<ClientHistory*>(client_repl->_get_history_write());
+    REALM_ASSERT(history_local);
+    VersionID old_version_local = wt_local->get_version_of_current_transaction();
+    sync::version_type current_version_local = old_version_local.version;
+    wt_local->get_history()->ensure_updated(current_version_local);
+    SaltedFileIdent client_file_ident;
+    {
+        sync::version_type version_unused;
+        SyncProgress progress;
+        history_local->get_status(version_unused, client_file_ident, progress);
+        REALM_ASSERT(progress.download.server_version == 0);
+    }
+    // Nothing has been downloaded, so everything in the history is of local
+    // origin, and nothing of it has been integrated by the server.
+    std::vector<ClientHistory::LocalChange> local_changes = history_local->get_local_changes(current_version_local);
+    logger.info("Local changesets to replay: %1", local_changes.size());
+
+    // transfer_group() refuses to remove tables, so the tables which so far
+    // only exist locally are added to the snapshot. Their contents are
+    // recreated by replaying the local changes. The snapshot is never
+    // committed.
+    auto wt_snapshot = db_snapshot->start_write();
+    for (auto table_key : wt_local->get_table_keys()) {
+        if (should_skip_table(*wt_local, table_key))
+            continue;
+        ConstTableRef table = wt_local->get_table(table_key);
+        StringData table_name = table->get_name();
+        if (wt_snapshot->has_table(table_name))
+            continue;
+        logger.debug("Table '%1' only exists locally", table_name);
+        if (ColKey pk_col = table->get_primary_key_column()) {
+            wt_snapshot->add_table_with_primary_key(table_name, DataType(pk_col.get_type()),
+                                                    table->get_column_name(pk_col), pk_col.is_nullable(),
+                                                    table->get_table_type());
+        }
+        else {
+            wt_snapshot->add_table(table_name, table->get_table_type());
+        }
+    }
+
+    {
+        // The instructions for making the local Realm equal to the snapshot
+        // must not be uploaded, as the server has them already
+        TempShortCircuitReplication tscr{*client_repl};
+        transfer_group(*wt_snapshot, *wt_local, logger);
+    }
+    RecoverLocalChangesetsHandler handler{*wt_local, *frozen_pre_local_state, logger};
+    handler.process_changesets(local_changes, {}); // throws on error
+    const sync::ChangesetEncoder::Buffer& buffer = client_repl->get_instruction_encoder().buffer();
+    BinaryData recovered_changeset = {buffer.data(), buffer.size()};
+
+    // The local changes have been read, so the history can now be reset to
+    // start at the version of the snapshot
+    history_local->set_client_reset_adjustments(current_version_local, client_file_ident, server_version,
+                                                recovered_changeset);
+
+    wt_snapshot->rollback();
+    wt_local->commit_and_continue_as_read();
+
+    VersionID new_version_local = wt_local->get_version_of_current_transaction();
+    logger.info("perform_snapshot_bootstrap is done, old_version.version = %1, "
+                "new_version.version = %2",
+                old_version_local.version, new_version_local.version);
+
+    return LocalVersionIDs{old_version_local, new_version_local};
+}
+
 } // namespace realm::_impl::client_reset
@@ -90,6 +90,18 @@ LocalVersionIDs perform_client_reset_diff(DBRef db, DBRef db_remote, sync::Salte
                                           bool* did_recover_out, sync::SubscriptionStore* sub_store,
                                           util::UniqueFunction<void(int64_t)> on_flx_version_complete);
 
+// perform_snapshot_bootstrap() makes the local Realm equal to 'db_snapshot', a
+// Realm without history produced by the server at 'server_version', and then
+// replays the local changes which have not yet been uploaded on top of it. The
+// replayed changes become a single local changeset based on 'server_version'.
+// Unlike a client reset, the client file ident is kept, and the local Realm
+// must not have downloaded anything yet. 'db_snapshot' is left unchanged.
+//
+// The function returns the old version and the new version of the local Realm to
+// be used to report the sync transaction to the user.
+LocalVersionIDs perform_snapshot_bootstrap(DBRef db, DBRef db_snapshot, sync::SaltedVersion server_version,
+                                           util::Logger& logger);
+
 } // namespace _impl::client_reset
 } // namespace realm
 
@@ -1,6 +1,9 @@
 #include <realm/sync/noinst/compact_changesets.hpp>
 #include <realm/sync/noinst/changeset_index.hpp>
 
+#include <map>
+#include <set>
+
 using namespace realm;
 using namespace realm::sync;
 
@@ -412,6 +415,174 @@ void ChangesetCompactor::remove_redundant_selects() {
 
 #endif
 
+bool is_scalar(const Instruction::Payload& payload) noexcept
+{
+    using Type = Instruction::Payload::Type;
+    switch (payload.type) {
+        case Type::Erased:
+        case Type::Dictionary:
+        case Type::ObjectValue:
+        case Type::GlobalKey:
+        case Type::Link:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Objects whose primary key is generated by the client cannot have been
+// created concurrently by another client, so creating and erasing one has no
+// effect outside of the changesets being uploaded.
+bool is_generated_key(const sync::PrimaryKey& key) noexcept
+{
+    return mpark::holds_alternative<GlobalKey>(key) || mpark::holds_alternative<ObjectId>(key) ||
+           mpark::holds_alternative<UUID>(key);
+}
+
+struct UploadCompactor {
+    using InstructionPosition = std::pair<Changeset*, Changeset::iterator>;
+    using ObjectRef = std::pair<StringData, sync::PrimaryKey>;
+
+    struct ObjectInfo {
+        // The instruction creating the object, if the object was created by
+        // the first instruction that touched it.
+        util::Optional<InstructionPosition> create_instruction;
+
+        // All instructions on the object since it was created.
+        std::vector<InstructionPosition> instructions;
+
+        // The last Update instruction setting each field to a scalar value,
+        // that has not been followed by any other instruction on the field.
+        std::map<StringData, InstructionPosition> last_set_instructions;
+    };
+
+    std::map<ObjectRef, ObjectInfo> m_objects;
+    std::set<ObjectRef> m_seen_objects;
+    std::set<ObjectRef> m_link_targets;
+
+    void find_link_targets(Changeset&);
+    void compact(Changeset&);
+    void on_object_instruction(Changeset&, Changeset::iterator, const Instruction::ObjectInstruction&);
+    void on_erase_object(Changeset&, Changeset::iterator, const Instruction::EraseObject&);
+    static void erase(InstructionPosition);
+};
+
+void UploadCompactor::find_link_targets(Changeset& changeset)
+{
+    auto add_link_target = [&](const Instruction::Payload& payload) {
+        if (payload.type == Instruction::Payload::Type::Link) {
+            auto& link = payload.data.link;
+            m_link_targets.emplace(changeset.get_string(link.target_table), changeset.get_key(link.target));
+        }
+    };
+    for (auto instr : changeset) {
+        if (!instr)
+            continue;
+        if (auto update = instr->get_if<Instruction::Update>())
+            add_link_target(update->value);
+        else if (auto insert = instr->get_if<Instruction::ArrayInsert>())
+            add_link_target(insert->value);
+        else if (auto set_insert = instr->get_if<Instruction::SetInsert>())
+            add_link_target(set_insert->value);
+        else if (auto set_erase = instr->get_if<Instruction::SetErase>())
+            add_link_target(set_erase->value);
+    }
+}
+
+void UploadCompactor::erase(InstructionPosition position)
+{
+    if (*position.second)
+        position.first->erase_stable(position.second);
+}
+
+void UploadCompactor::compact(Changeset& changeset)
+{
+    for (auto it = changeset.begin(); it != changeset.end(); ++it) {
+        auto instr = *it;
+        if (!instr)
+            continue;
+
+        switch (instr->type()) {
+            case Instruction::Type::AddTable:
+            case Instruction::Type::EraseTable:
+            case Instruction::Type::AddColumn:
+            case Instruction::Type::EraseColumn:
+                // Do not compact across schema changes.
+                m_objects.clear();
+                break;
+            case Instruction::Type::CreateObject: {
+                auto& create_object = instr->get_as<Instruction::CreateObject>();
+                ObjectRef object{changeset.get_string(create_object.table), changeset.get_key(create_object.object)};
+                ObjectInfo& info = m_objects[object] = ObjectInfo{};
+                if (m_seen_objects.insert(object).second)
+                    info.create_instruction = InstructionPosition{&changeset, it};
+                break;
+            }
+            case Instruction::Type::EraseObject:
+                on_erase_object(changeset, it, instr->get_as<Instruction::EraseObject>());
+                break;
+            default:
+                instr->visit([&](auto& object_instr) {
+                    using T = std::decay_t<decltype(object_instr)>;
+                    if constexpr (std::is_base_of_v<Instruction::ObjectInstruction, T>)
+                        on_object_instruction(changeset, it, object_instr);
+                });
+                break;
+        }
+    }
+}
+
+void UploadCompactor::on_object_instruction(Changeset& changeset, Changeset::iterator it,
+                                            const Instruction::ObjectInstruction& instr)
+{
+    ObjectRef object{changeset.get_string(instr.table), changeset.get_key(instr.object)};
+    m_seen_objects.insert(object);
+    ObjectInfo& info = m_objects[object];
+    info.instructions.emplace_back(&changeset, it);
+
+    auto update = (*it)->get_if<Instruction::Update>();
+    StringData field;
+    if (auto path_instr = (*it)->get_if<Instruction::PathInstruction>())
+        field = changeset.get_string(path_instr->field);
+    else
+        update = nullptr;
+
+    auto last_set = info.last_set_instructions.find(field);
+    bool is_scalar_set = (update && update->path.size() == 0 && is_scalar(update->value));
+    if (last_set != info.last_set_instructions.end()) {
+        // A later non-default Update of the field takes precedence over the
+        // earlier one in every merge, so the earlier one can be discarded.
+        if (is_scalar_set && !update->is_default &&
+            last_set->second.first->origin_timestamp <= changeset.origin_timestamp) {
+            erase(last_set->second);
+        }
+        info.last_set_instructions.erase(last_set);
+    }
+    if (is_scalar_set)
+        info.last_set_instructions.emplace(field, InstructionPosition{&changeset, it});
+}
+
+void UploadCompactor::on_erase_object(Changeset& changeset, Changeset::iterator it,
+                                      const Instruction::EraseObject& instr)
+{
+    ObjectRef object{changeset.get_string(instr.table), changeset.get_key(instr.object)};
+    m_seen_objects.insert(object);
+    auto info = m_objects.find(object);
+    if (info == m_objects.end())
+        return;
+
+    // An object that was both created and erased in the uploaded changesets
+    // can be discarded along with everything done to it, unless it is the
+    // target of a link, or other clients may know of its primary key.
+    if (info->second.create_instruction && is_generated_key(object.second) && !m_link_targets.count(object)) {
+        for (auto& position : info->second.instructions)
+            erase(position);
+        erase(*info->second.create_instruction);
+        erase(InstructionPosition{&changeset, it});
+    }
+    m_objects.erase(info);
+}
+
 } // unnamed namespace
 
 void realm::_impl::compact_changesets(Changeset*, size_t)
@@ -429,3 +600,12 @@ void realm::_impl::compact_changesets(Changeset*, size_t)
     compactor.compact(); // Throws
 #endif
 }
+
+void realm::_impl::compact_changesets_for_upload(Changeset* changesets, size_t num_changesets)
+{
+    UploadCompactor compactor;
+    for (size_t i = 0; i < num_changesets; ++i)
+        compactor.find_link_targets(changesets[i]); // Throws
+    for (size_t i = 0; i < num_changesets; ++i)
+        compactor.compact(changesets[i]); // Throws
+}
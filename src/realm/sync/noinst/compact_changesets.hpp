@@ -35,6 +35,31 @@ namespace _impl {
 /// other threads.
 void compact_changesets(realm::sync::Changeset* changesets, size_t num_changesets);
 
+/// Compact changesets of local origin that are about to be uploaded, by
+/// removing instructions that are made redundant by later instructions in the
+/// same or a later changeset.
+///
+/// Instructions removed:
+///   - Update instructions setting a field to a scalar value, when the field is
+///     set to a scalar value again later, without any other instruction
+///     touching the field in between.
+///   - CreateObject and EraseObject pairs, along with all instructions on the
+///     object in between, when the primary key of the object is a GlobalKey,
+///     an ObjectId or a UUID, and the object is not the target of any link in
+///     the changesets.
+///
+/// Nothing is compacted across schema instructions.
+///
+/// NOTE: This relies on none of the changesets having been seen by any other
+/// client, which is why it must not be used for changesets received from the
+/// server. Compacting across changesets means that the server will not observe
+/// every intermediate state of the local Realm. The server also uses it for
+/// ranges of its history that every client has already integrated (see
+/// ServerHistory::compact_history()).
+///
+/// This function may throw exceptions due to the fact that it allocates memory.
+void compact_changesets_for_upload(realm::sync::Changeset* changesets, size_t num_changesets);
+
 } // namespace _impl
 } // namespace realm
 
@@ -199,7 +199,7 @@ void PendingBootstrapStore::clear()
     tr->commit();
 }
 
-PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t limit_in_bytes)
+PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t limit_in_bytes, size_t offset)
 {
     auto tr = m_db->start_read();
     auto bootstrap_table = tr->get_table(m_table);
@@ -229,7 +229,8 @@ PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t l
 
     auto changeset_list = bootstrap_obj.get_linklist(m_changesets);
     size_t bytes_so_far = 0;
-    for (size_t idx = 0; idx < changeset_list.size() && bytes_so_far < limit_in_bytes; ++idx) {
+    REALM_ASSERT_3(offset, <=, changeset_list.size());
+    for (size_t idx = offset; idx < changeset_list.size() && bytes_so_far < limit_in_bytes; ++idx) {
         auto cur_changeset = changeset_list.get_object(idx);
         ret.changeset_data.push_back(util::AppendBuffer<char>());
         auto& uncompressed_buffer = ret.changeset_data.back();
@@ -253,8 +254,9 @@ PendingBootstrapStore::PendingBatch PendingBootstrapStore::peek_pending(size_t l
             cur_changeset.get<int64_t>(m_changeset_last_integrated_client_version);
         parsed_changeset.data = BinaryData(uncompressed_buffer.data(), uncompressed_buffer.size());
         ret.changesets.push_back(std::move(parsed_changeset));
+        bytes_so_far += uncompressed_buffer.size();
     }
-    ret.remaining = changeset_list.size() - ret.changesets.size();
+    ret.remaining = changeset_list.size() - offset - ret.changesets.size();
 
     return ret;
 }
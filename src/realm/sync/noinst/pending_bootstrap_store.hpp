@@ -64,7 +64,11 @@ public:
 
     // Returns the next batch (download message) of changesets if it exists. The transaction must be in the reading
     // state.
-    PendingBatch peek_pending(size_t limit_in_bytes);
+    //
+    // If offset is non-zero, the batch starts after the first `offset` pending changesets. This allows the batch
+    // following one that has not been popped yet to be read ahead of time. Reading does not modify the store, so
+    // this may be called on a different thread than the one integrating the preceding batch.
+    PendingBatch peek_pending(size_t limit_in_bytes, size_t offset = 0);
 
     // Removes the first set of changesets from the current pending bootstrap batch. The transaction must be in the
     // writing state.
@@ -33,6 +33,12 @@ void ClientProtocol::make_pbs_ident_message(OutputBuffer& out, session_ident_typ
     REALM_ASSERT(!out.fail());
 }
 
+void ClientProtocol::make_snapshot_request_message(OutputBuffer& out, session_ident_type session_ident)
+{
+    out << "snapshot_request " << session_ident << "\n"; // Throws
+    REALM_ASSERT(!out.fail());
+}
+
 void ClientProtocol::make_flx_ident_message(OutputBuffer& out, session_ident_type session_ident,
                                             SaltedFileIdent client_file_ident, const SyncProgress& progress,
                                             int64_t query_version, std::string_view query_body)
@@ -76,11 +82,11 @@ void ClientProtocol::UploadMessageBuilder::add_changeset(version_type client_ver
     ++m_num_changesets;
 }
 
-void ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_version, OutputBuffer& out,
-                                                               session_ident_type session_ident,
-                                                               version_type progress_client_version,
-                                                               version_type progress_server_version,
-                                                               version_type locked_server_version)
+BinaryData ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_version, OutputBuffer& out,
+                                                                     session_ident_type session_ident,
+                                                                     version_type progress_client_version,
+                                                                     version_type progress_server_version,
+                                                                     version_type locked_server_version)
 {
     static_cast<void>(protocol_version);
     BinaryData body = {m_body_buffer.data(), std::size_t(m_body_buffer.size())};
@@ -102,18 +108,18 @@ void ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_vers
         << compressed_body_size;
     out << " " << progress_client_version << " " << progress_server_version << " " << locked_server_version; // Throws
     out << "\n";                                                                                             // Throws
+    REALM_ASSERT(!out.fail());
 
     if (is_body_compressed)
-        out.write(m_compression_buffer.data(), compressed_body_size); // Throws
-    else
-        out.write(body.data(), body.size()); // Throws
-
-    REALM_ASSERT(!out.fail());
+        return BinaryData{m_compression_buffer.data(), compressed_body_size};
+    return body;
 }
 
-ClientProtocol::UploadMessageBuilder ClientProtocol::make_upload_message_builder(util::Logger& logger)
+ClientProtocol::UploadMessageBuilder ClientProtocol::make_upload_message_builder(util::Logger& logger,
+                                                                                 OutputBuffer& body_buffer,
+                                                                                 std::vector<char>& compression_buffer)
 {
-    return UploadMessageBuilder{logger, m_output_buffer, m_buffer, m_compress_memory_arena};
+    return UploadMessageBuilder{logger, body_buffer, compression_buffer, m_compress_memory_arena};
 }
 
 void ClientProtocol::make_unbind_message(OutputBuffer& out, session_ident_type session_ident)
@@ -136,6 +142,34 @@ void ClientProtocol::make_ping(OutputBuffer& out, milliseconds_type timestamp, m
 }
 
 
+auto ClientProtocol::decompress_download_body(std::string_view msg_data, bool is_flx_sync_connection,
+                                              util::compression::CompressMemoryArena& compress_memory_arena)
+    -> util::Optional<DecompressedDownloadBody>
+{
+    HeaderLineParser msg(msg_data);
+    DownloadMessageHeader header;
+    try {
+        if (msg.read_next<std::string_view>() != "download")
+            return util::none;
+        header = parse_download_message_header(msg, is_flx_sync_connection);
+    }
+    catch (const ProtocolCodecException&) {
+        return util::none;
+    }
+    if (!header.is_body_compressed || header.uncompressed_body_size > s_max_body_size ||
+        header.compressed_body_size > msg.bytes_remaining())
+        return util::none;
+
+    DecompressedDownloadBody body;
+    body.data.set_size(header.uncompressed_body_size); // Throws
+    body.size = header.uncompressed_body_size;
+    body.error = util::compression::decompress(compress_memory_arena,
+                                               {msg.remaining().data(), header.compressed_body_size},
+                                               {body.data.data(), body.size}); // Throws
+    return body;
+}
+
+
 std::string ClientProtocol::compressed_hex_dump(BinaryData blob)
 {
     std::vector<char> buf;
@@ -225,6 +259,24 @@ void ServerProtocol::make_download_message(int protocol_version, OutputBuffer& o
 }
 
 
+void ServerProtocol::make_snapshot_message(OutputBuffer& out, session_ident_type session_ident,
+                                           SaltedVersion server_version, const char* body,
+                                           std::size_t uncompressed_body_size, std::size_t compressed_body_size,
+                                           bool body_is_compressed, util::Logger& logger)
+{
+    out << "snapshot " << session_ident << " " << server_version.version << " " << server_version.salt << " "
+        << int(body_is_compressed) << " " << uncompressed_body_size << " " << compressed_body_size << "\n"; // Throws
+
+    std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
+    out.write(body, body_size);
+
+    logger.detail("Sending: SNAPSHOT(server_version=%1, server_version_salt=%2, is_body_compressed=%3, "
+                  "body_size=%4, compressed_body_size=%5)",
+                  server_version.version, server_version.salt, body_is_compressed, uncompressed_body_size,
+                  compressed_body_size); // Throws
+}
+
+
 void ServerProtocol::make_unbound_message(OutputBuffer& out, session_ident_type session_ident)
 {
     out << "unbound " << session_ident << "\n"; // Throws
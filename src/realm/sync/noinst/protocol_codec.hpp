@@ -171,6 +171,8 @@ public:
     void make_pbs_ident_message(OutputBuffer&, session_ident_type session_ident, SaltedFileIdent client_file_ident,
                                 const SyncProgress& progress);
 
+    void make_snapshot_request_message(OutputBuffer&, session_ident_type session_ident);
+
     void make_flx_ident_message(OutputBuffer&, session_ident_type session_ident, SaltedFileIdent client_file_ident,
                                 const SyncProgress& progress, int64_t query_version, std::string_view query_body);
 
@@ -186,9 +188,13 @@ public:
         void add_changeset(version_type client_version, version_type server_version, timestamp_type origin_timestamp,
                            file_ident_type origin_file_ident, ChunkedBinaryData changeset);
 
-        void make_upload_message(int protocol_version, OutputBuffer&, session_ident_type session_ident,
-                                 version_type progress_client_version, version_type progress_server_version,
-                                 version_type locked_server_version);
+        /// Writes the header of the UPLOAD message to the specified output
+        /// buffer, and returns the body, which is not copied. The body refers
+        /// to the buffers that were passed to make_upload_message_builder(),
+        /// so the two must be sent together, for example by a gather write.
+        BinaryData make_upload_message(int protocol_version, OutputBuffer&, session_ident_type session_ident,
+                                       version_type progress_client_version, version_type progress_server_version,
+                                       version_type locked_server_version);
 
     private:
         std::size_t m_num_changesets = 0;
@@ -197,7 +203,11 @@ public:
         util::compression::CompressMemoryArena& m_compress_memory_arena;
     };
 
-    UploadMessageBuilder make_upload_message_builder(util::Logger& logger);
+    /// The changesets of the UPLOAD message are accumulated in \a body_buffer,
+    /// and compressed into \a compression_buffer. Both must outlive the
+    /// sending of the message.
+    UploadMessageBuilder make_upload_message_builder(util::Logger& logger, OutputBuffer& body_buffer,
+                                                     std::vector<char>& compression_buffer);
 
     void make_unbind_message(OutputBuffer&, session_ident_type session_ident);
 
@@ -209,11 +219,32 @@ public:
 
     // Messages received by the client.
 
+    // The body of a DOWNLOAD message that was decompressed ahead of parsing by
+    // decompress_download_body().
+    struct DecompressedDownloadBody {
+        util::Buffer<char> data;
+        std::size_t size = 0;
+        std::error_code error;
+    };
+
+    // If `msg_data` is a DOWNLOAD message with a compressed body, decompress_download_body()
+    // decompresses the body. Otherwise, and if the header of the message is malformed, it
+    // returns none, and it is left to parse_message_received() to deal with the message.
+    // It uses no state of the protocol object, so it may be called by any thread.
+    static util::Optional<DecompressedDownloadBody>
+    decompress_download_body(std::string_view msg_data, bool is_flx_sync_connection,
+                             util::compression::CompressMemoryArena& compress_memory_arena);
+
     // parse_message_received takes a (WebSocket) message and parses it.
     // The result of the parsing is handled by an object of type Connection.
     // Typically, Connection would be the Connection class from client.cpp
+    //
+    // If `decompressed_body` is specified, it must be the result of calling
+    // decompress_download_body() on `msg_data`, and it is used instead of
+    // decompressing the body again.
     template <class Connection>
-    void parse_message_received(Connection& connection, std::string_view msg_data)
+    void parse_message_received(Connection& connection, std::string_view msg_data,
+                                const DecompressedDownloadBody* decompressed_body = nullptr)
     {
         util::Logger& logger = connection.logger;
         auto report_error = [&](Error err, const auto fmt, auto&&... args) {
@@ -232,7 +263,7 @@ public:
 
         try {
             if (message_type == "download") {
-                parse_download_message(connection, msg);
+                parse_download_message(connection, msg, decompressed_body);
             }
             else if (message_type == "pong") {
                 auto timestamp = msg.read_next<milliseconds_type>('\n');
@@ -339,6 +370,9 @@ public:
 
                 connection.receive_ident_message(session_ident, client_file_ident); // Throws
             }
+            else if (message_type == "snapshot") {
+                parse_snapshot_message(connection, msg);
+            }
             else {
                 return report_error(Error::unknown_message, "Unknown input message type '%1'", msg_data);
             }
@@ -352,8 +386,43 @@ public:
     }
 
 private:
+    struct DownloadMessageHeader {
+        session_ident_type session_ident;
+        SyncProgress progress;
+        int64_t query_version;
+        bool last_in_batch;
+        int64_t downloadable_bytes;
+        bool is_body_compressed;
+        size_t uncompressed_body_size;
+        size_t compressed_body_size;
+    };
+
+    // Parses the header line of a DOWNLOAD message following the message type,
+    // leaving `msg` at the start of the body.
+    static DownloadMessageHeader parse_download_message_header(HeaderLineParser& msg, bool is_flx_sync_connection)
+    {
+        DownloadMessageHeader header;
+        header.session_ident = msg.read_next<session_ident_type>();
+        header.progress.download.server_version = msg.read_next<version_type>();
+        header.progress.download.last_integrated_client_version = msg.read_next<version_type>();
+        header.progress.latest_server_version.version = msg.read_next<version_type>();
+        header.progress.latest_server_version.salt = msg.read_next<salt_type>();
+        header.progress.upload.client_version = msg.read_next<version_type>();
+        header.progress.upload.last_integrated_server_version = msg.read_next<version_type>();
+        header.query_version = is_flx_sync_connection ? msg.read_next<int64_t>() : 0;
+
+        // If this is a PBS connection, then every download message is its own complete batch.
+        header.last_in_batch = is_flx_sync_connection ? msg.read_next<bool>() : true;
+        header.downloadable_bytes = msg.read_next<int64_t>();
+        header.is_body_compressed = msg.read_next<bool>();
+        header.uncompressed_body_size = msg.read_next<size_t>();
+        header.compressed_body_size = msg.read_next<size_t>('\n');
+        return header;
+    }
+
     template <typename Connection>
-    void parse_download_message(Connection& connection, HeaderLineParser& msg)
+    void parse_download_message(Connection& connection, HeaderLineParser& msg,
+                                const DecompressedDownloadBody* decompressed_body)
     {
         util::Logger& logger = connection.logger;
         auto report_error = [&](Error err, const auto fmt, auto&&... args) {
@@ -362,41 +431,39 @@ private:
         };
 
         auto msg_with_header = msg.remaining();
-        auto session_ident = msg.read_next<session_ident_type>();
-        SyncProgress progress;
-        progress.download.server_version = msg.read_next<version_type>();
-        progress.download.last_integrated_client_version = msg.read_next<version_type>();
-        progress.latest_server_version.version = msg.read_next<version_type>();
-        progress.latest_server_version.salt = msg.read_next<salt_type>();
-        progress.upload.client_version = msg.read_next<version_type>();
-        progress.upload.last_integrated_server_version = msg.read_next<version_type>();
-        auto query_version = connection.is_flx_sync_connection() ? msg.read_next<int64_t>() : 0;
-
-        // If this is a PBS connection, then every download message is its own complete batch.
-        auto last_in_batch = connection.is_flx_sync_connection() ? msg.read_next<bool>() : true;
-        auto downloadable_bytes = msg.read_next<int64_t>();
-        auto is_body_compressed = msg.read_next<bool>();
-        auto uncompressed_body_size = msg.read_next<size_t>();
-        auto compressed_body_size = msg.read_next<size_t>('\n');
+        auto [session_ident, progress, query_version, last_in_batch, downloadable_bytes, is_body_compressed,
+              uncompressed_body_size, compressed_body_size] =
+            parse_download_message_header(msg, connection.is_flx_sync_connection());
 
         if (uncompressed_body_size > s_max_body_size) {
             auto header = msg_with_header.substr(0, msg_with_header.size() - msg.remaining().size());
             return report_error(Error::limits_exceeded, "Limits exceeded in input message '%1'", header);
         }
 
-        std::unique_ptr<char[]> uncompressed_body_buffer;
         // if is_body_compressed == true, we must decompress the received body.
-        if (is_body_compressed) {
-            uncompressed_body_buffer = std::make_unique<char[]>(uncompressed_body_size);
-            std::error_code ec =
-                util::compression::decompress({msg.remaining().data(), compressed_body_size},
-                                              {uncompressed_body_buffer.get(), uncompressed_body_size});
+        if (is_body_compressed && decompressed_body) {
+            REALM_ASSERT(decompressed_body->size == uncompressed_body_size);
+            if (decompressed_body->error) {
+                return report_error(Error::bad_decompression, "compression::inflate: %1",
+                                    decompressed_body->error.message());
+            }
+
+            msg = HeaderLineParser(std::string_view(decompressed_body->data.data(), uncompressed_body_size));
+        }
+        else if (is_body_compressed) {
+            // During a bootstrap the server sends a long run of large
+            // compressed messages, so neither the body buffer nor the memory
+            // used by zlib is allocated again for every one of them.
+            m_decompressed_body_buffer.reserve(0, uncompressed_body_size); // Throws
+            std::error_code ec = util::compression::decompress(
+                m_compress_memory_arena, {msg.remaining().data(), compressed_body_size},
+                {m_decompressed_body_buffer.data(), uncompressed_body_size}); // Throws
 
             if (ec) {
                 return report_error(Error::bad_decompression, "compression::inflate: %1", ec.message());
             }
 
-            msg = HeaderLineParser(std::string_view(uncompressed_body_buffer.get(), uncompressed_body_size));
+            msg = HeaderLineParser(std::string_view(m_decompressed_body_buffer.data(), uncompressed_body_size));
         }
 
         logger.trace("Download message compression: is_body_compressed = %1, "
@@ -459,6 +526,51 @@ private:
                                             received_changesets); // Throws
     }
 
+    template <typename Connection>
+    void parse_snapshot_message(Connection& connection, HeaderLineParser& msg)
+    {
+        util::Logger& logger = connection.logger;
+        auto report_error = [&](Error err, const auto fmt, auto&&... args) {
+            logger.error(fmt, std::forward<decltype(args)>(args)...);
+            connection.handle_protocol_error(err);
+        };
+
+        auto session_ident = msg.read_next<session_ident_type>();
+        SaltedVersion server_version;
+        server_version.version = msg.read_next<version_type>();
+        server_version.salt = msg.read_next<salt_type>();
+        auto is_body_compressed = msg.read_next<bool>();
+        auto uncompressed_body_size = msg.read_next<size_t>();
+        auto compressed_body_size = msg.read_next<size_t>('\n');
+
+        if (uncompressed_body_size > s_max_body_size) {
+            return report_error(Error::limits_exceeded, "Limits exceeded in SNAPSHOT message");
+        }
+
+        // The body is a Realm file, which must be suitably aligned in memory,
+        // so it is always copied into a buffer of its own.
+        util::Buffer<char> body(uncompressed_body_size); // Throws
+        if (is_body_compressed) {
+            auto compressed_body = msg.read_sized_data<BinaryData>(compressed_body_size);
+            std::error_code ec = util::compression::decompress(m_compress_memory_arena, compressed_body,
+                                                               {body.data(), uncompressed_body_size}); // Throws
+            if (ec) {
+                return report_error(Error::bad_decompression, "compression::inflate: %1", ec.message());
+            }
+        }
+        else {
+            auto uncompressed_body = msg.read_sized_data<BinaryData>(uncompressed_body_size);
+            std::copy(uncompressed_body.data(), uncompressed_body.data() + uncompressed_body_size, body.data());
+        }
+
+        logger.trace("Snapshot message compression: is_body_compressed = %1, "
+                     "compressed_body_size=%2, uncompressed_body_size=%3",
+                     is_body_compressed, compressed_body_size, uncompressed_body_size);
+
+        connection.receive_snapshot_message(session_ident, server_version,
+                                            BinaryData{body.data(), uncompressed_body_size}); // Throws
+    }
+
     static sync::ProtocolErrorInfo::Action string_to_action(const std::string& action_string)
     {
         using action = sync::ProtocolErrorInfo::Action;
@@ -480,11 +592,8 @@ private:
 
     static constexpr std::size_t s_max_body_size = std::numeric_limits<std::size_t>::max();
 
-    // Permanent buffer to use for building messages.
-    OutputBuffer m_output_buffer;
-
-    // Permanent buffers to use for internal purposes such as compression.
-    std::vector<char> m_buffer;
+    // Permanent buffer to use for internal purposes such as decompression.
+    util::Buffer<char> m_decompressed_body_buffer;
 
     util::compression::CompressMemoryArena m_compress_memory_arena;
 };
@@ -544,6 +653,10 @@ public:
                                std::size_t uncompressed_body_size, std::size_t compressed_body_size,
                                bool body_is_compressed, util::Logger&);
 
+    void make_snapshot_message(OutputBuffer&, session_ident_type session_ident, SaltedVersion server_version,
+                               const char* body, std::size_t uncompressed_body_size, std::size_t compressed_body_size,
+                               bool body_is_compressed, util::Logger&);
+
     void make_mark_message(OutputBuffer&, session_ident_type session_ident, request_ident_type request_ident);
 
     void make_error_message(int protocol_version, OutputBuffer&, sync::ProtocolError error_code, const char* message,
@@ -736,6 +849,11 @@ public:
                                                  scan_server_version, scan_client_version, latest_server_version,
                                                  latest_server_version_salt); // Throws
             }
+            else if (message_type == "snapshot_request") {
+                auto session_ident = msg.read_next<session_ident_type>('\n');
+
+                connection.receive_snapshot_request_message(session_ident); // Throws
+            }
             else if (message_type == "unbind") {
                 auto session_ident = msg.read_next<session_ident_type>('\n');
 
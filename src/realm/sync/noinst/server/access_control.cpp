@@ -1,16 +1,92 @@
 #include <realm/sync/noinst/server/access_control.hpp>
 
+#include <realm/util/sha_crypto.hpp>
+#include <realm/util/thread_pool.hpp>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 using namespace realm;
 using namespace realm::sync;
 
 struct AccessControl::Impl final : public AccessToken::Verifier {
+    using Clock = std::chrono::steady_clock;
+
+    struct CachedToken {
+        std::string digest;
+        AccessToken token;
+        Clock::time_point valid_until;
+    };
+
     util::Optional<PKey> m_public_key;
+    const std::size_t m_max_cached_tokens;
+    const std::chrono::seconds m_cache_ttl;
+
+    // Verified tokens by the SHA-256 digest of their signed form, with the
+    // most recently used first in `m_lru`.
+    mutable std::mutex m_cache_mutex;
+    mutable std::list<CachedToken> m_lru;
+    mutable std::unordered_map<std::string, std::list<CachedToken>::iterator> m_cache;
 
-    Impl(util::Optional<PKey> public_key)
+    Impl(util::Optional<PKey> public_key, std::size_t max_cached_tokens, std::chrono::seconds cache_ttl)
         : m_public_key(std::move(public_key))
+        , m_max_cached_tokens(max_cached_tokens)
+        , m_cache_ttl(cache_ttl)
     {
     }
 
+    bool cache_enabled() const noexcept
+    {
+        // Without a public key, nothing is verified, so there is nothing to save
+        return m_public_key && m_max_cached_tokens > 0 && m_cache_ttl.count() > 0;
+    }
+
+    static std::string digest(StringData signed_token)
+    {
+        unsigned char hash[32];
+        util::sha256(signed_token.data(), signed_token.size(), hash);
+        return std::string(reinterpret_cast<const char*>(hash), sizeof hash); // Throws
+    }
+
+    bool find_cached(const std::string& digest, AccessToken& token) const
+    {
+        std::lock_guard lock{m_cache_mutex};
+        auto i = m_cache.find(digest);
+        if (i == m_cache.end())
+            return false;
+        auto entry = i->second;
+        if (Clock::now() > entry->valid_until || entry->token.expired(std::chrono::system_clock::now())) {
+            m_lru.erase(entry);
+            m_cache.erase(i);
+            return false;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, entry);
+        token = entry->token; // Throws
+        return true;
+    }
+
+    void add_cached(std::string digest, const AccessToken& token) const
+    {
+        if (token.expired(std::chrono::system_clock::now()))
+            return;
+        std::lock_guard lock{m_cache_mutex};
+        if (m_cache.count(digest))
+            return;
+        if (m_cache.size() >= m_max_cached_tokens) {
+            m_cache.erase(m_lru.back().digest);
+            m_lru.pop_back();
+        }
+        m_lru.push_front({std::move(digest), token, Clock::now() + m_cache_ttl}); // Throws
+        try {
+            m_cache.emplace(m_lru.front().digest, m_lru.begin()); // Throws
+        }
+        catch (...) {
+            m_lru.pop_front();
+            throw;
+        }
+    }
+
     // Overriding members of AccessToken::Verifier
     bool verify(BinaryData access_token, BinaryData signature) const override final
     {
@@ -19,8 +95,9 @@ struct AccessControl::Impl final : public AccessToken::Verifier {
     }
 };
 
-AccessControl::AccessControl(util::Optional<PKey> public_key)
-    : m_impl(new Impl(std::move(public_key)))
+AccessControl::AccessControl(util::Optional<PKey> public_key, std::size_t max_cached_tokens,
+                             std::chrono::seconds cache_ttl)
+    : m_impl(new Impl(std::move(public_key), max_cached_tokens, cache_ttl))
 {
 }
 
@@ -29,6 +106,17 @@ AccessControl::~AccessControl() {}
 util::Optional<AccessToken> AccessControl::verify_access_token(StringData signed_token,
                                                                AccessToken::ParseError* out_error) const
 {
+    std::string digest;
+    if (m_impl->cache_enabled()) {
+        digest = Impl::digest(signed_token); // Throws
+        AccessToken token;
+        if (m_impl->find_cached(digest, token)) {
+            if (out_error)
+                *out_error = AccessToken::ParseError::none;
+            return token;
+        }
+    }
+
     AccessToken::ParseError error;
     AccessToken token;
     // For the purpose of testing, public key is allowed to be absent. When it
@@ -39,6 +127,8 @@ util::Optional<AccessToken> AccessControl::verify_access_token(StringData signed
     if (REALM_LIKELY(m_impl->m_public_key))
         verifier = &*m_impl;
     if (REALM_LIKELY(AccessToken::parse(signed_token, token, error, verifier))) {
+        if (!digest.empty())
+            m_impl->add_cached(std::move(digest), token); // Throws
         if (REALM_LIKELY(out_error)) {
             if (REALM_LIKELY(m_impl->m_public_key)) {
                 *out_error = AccessToken::ParseError::none;
@@ -54,6 +144,47 @@ util::Optional<AccessToken> AccessControl::verify_access_token(StringData signed
     return util::none;
 }
 
+std::vector<util::Optional<AccessToken>>
+AccessControl::verify_access_tokens(const std::vector<StringData>& signed_tokens,
+                                    std::vector<AccessToken::ParseError>* out_errors) const
+{
+    std::size_t n = signed_tokens.size();
+    std::vector<util::Optional<AccessToken>> tokens(n);           // Throws
+    std::vector<AccessToken::ParseError> errors(n);               // Throws
+    std::vector<std::size_t> first_occurrence(n);                 // Throws
+    std::unordered_map<std::string_view, std::size_t> first_seen; // Throws
+
+    // Verify every distinct token once, and in parallel, as each of those not
+    // cached costs a signature verification
+    std::vector<std::size_t> unique;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto [it, inserted] = first_seen.emplace(std::string_view(signed_tokens[i]), i); // Throws
+        first_occurrence[i] = it->second;
+        if (inserted)
+            unique.push_back(i); // Throws
+    }
+    util::ThreadPool::get_default().run_parallel(unique.size(), [&](std::size_t j) {
+        std::size_t i = unique[j];
+        tokens[i] = verify_access_token(signed_tokens[i], &errors[i]); // Throws
+    }); // Throws
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (first_occurrence[i] != i) {
+            tokens[i] = tokens[first_occurrence[i]]; // Throws
+            errors[i] = errors[first_occurrence[i]];
+        }
+    }
+    if (out_errors)
+        *out_errors = std::move(errors);
+    return tokens;
+}
+
+std::size_t AccessControl::get_num_cached_tokens() const noexcept
+{
+    std::lock_guard lock{m_impl->m_cache_mutex};
+    return m_impl->m_cache.size();
+}
+
 bool AccessControl::can(const AccessToken& token, Privilege permission,
                         const RealmFileIdent& realm_file) const noexcept
 {
@@ -6,16 +6,29 @@
 #include <realm/sync/noinst/server/crypto_server.hpp>
 #include <realm/sync/noinst/server/permissions.hpp>
 
+#include <chrono>
+#include <vector>
+
 namespace realm {
 namespace sync {
 
 struct AccessControl {
+    static constexpr std::size_t default_max_cached_tokens = 10000;
+    static constexpr std::chrono::seconds default_cache_ttl = std::chrono::minutes(5);
+
     /// Opens the Realm database at path \a db_path and initializes this
     /// AccessControl object to verify access tokens using \a public_key.
     ///
     /// If \a public_key is not present, access tokens without a signature
     /// will pass verification.
-    AccessControl(util::Optional<PKey> public_key);
+    ///
+    /// Up to \a max_cached_tokens tokens whose signature has been verified are
+    /// remembered for \a cache_ttl, or until the token expires if that is
+    /// sooner, so that verifying the same token again costs a hash lookup
+    /// rather than a signature verification. A \a max_cached_tokens of zero
+    /// disables the cache.
+    AccessControl(util::Optional<PKey> public_key, std::size_t max_cached_tokens = default_max_cached_tokens,
+                  std::chrono::seconds cache_ttl = default_cache_ttl);
     ~AccessControl();
 
     /// Verify a string representing an access token.
@@ -26,6 +39,22 @@ struct AccessControl {
     util::Optional<AccessToken> verify_access_token(StringData access_token,
                                                     AccessToken::ParseError* error = nullptr) const;
 
+    /// Verify several access tokens at once, such as those of the sessions
+    /// bound while many clients reconnect. The signatures of the tokens which
+    /// are not cached are verified in parallel on the default thread pool, and
+    /// a token occurring more than once is only verified once.
+    ///
+    /// If \a errors is non-null, it will be resized to the number of tokens and
+    /// set to indicate the type of failure of each of them.
+    ///
+    /// NOTE: This method is thread-safe.
+    std::vector<util::Optional<AccessToken>>
+    verify_access_tokens(const std::vector<StringData>& access_tokens,
+                         std::vector<AccessToken::ParseError>* errors = nullptr) const;
+
+    /// The number of verified tokens currently cached.
+    std::size_t get_num_cached_tokens() const noexcept;
+
     //@{
     /// Check whether user has the requested permission for the given
     /// Realm file using the particular access token.
@@ -47,6 +47,7 @@
 #include <cstdio>
 #include <cstring>
 #include <functional>
+#include <list>
 #include <locale>
 #include <map>
 #include <memory>
@@ -187,6 +188,7 @@ bool determine_try_again(ProtocolError error_code) noexcept
 
 class ServerFile;
 class ServerImpl;
+class Worker;
 class HTTPConnection;
 class SyncConnection;
 class Session;
@@ -229,6 +231,80 @@ struct DownloadCache {
 };
 
 
+// A size-bounded cache of DOWNLOAD message bodies shared by all sessions of
+// the server (Server::Config::download_cache_size). The least recently used
+// entries are evicted first.
+class SharedDownloadCache {
+public:
+    struct Key {
+        const ServerFile* file;
+        DownloadCursor download_progress; // Where the history scan begins
+        version_type end_version;
+        std::size_t max_download_size;
+        bool disable_download_compaction;
+
+        bool operator<(const Key& other) const noexcept
+        {
+            return std::tie(file, download_progress.server_version, download_progress.last_integrated_client_version,
+                            end_version, max_download_size, disable_download_compaction) <
+                   std::tie(other.file, other.download_progress.server_version,
+                            other.download_progress.last_integrated_client_version, other.end_version,
+                            other.max_download_size, other.disable_download_compaction);
+        }
+    };
+
+    explicit SharedDownloadCache(std::size_t max_size) noexcept
+        : m_max_size{max_size}
+    {
+    }
+
+    // Returns null if there is no entry for the specified key.
+    const DownloadCache* find(const Key& key) noexcept
+    {
+        auto i = m_index.find(key);
+        if (i == m_index.end())
+            return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, i->second);
+        return &i->second->second;
+    }
+
+    void insert(const Key& key, DownloadCache entry)
+    {
+        std::size_t size = get_body_size(entry);
+        if (size > m_max_size || m_index.count(key) != 0)
+            return;
+        while (m_size + size > m_max_size) {
+            auto& [evicted_key, evicted_entry] = m_entries.back();
+            m_size -= get_body_size(evicted_entry);
+            m_index.erase(evicted_key);
+            m_entries.pop_back();
+        }
+        m_entries.emplace_front(key, std::move(entry)); // Throws
+        try {
+            m_index.emplace(key, m_entries.begin()); // Throws
+        }
+        catch (...) {
+            m_entries.pop_front();
+            throw;
+        }
+        m_size += size;
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, DownloadCache>>;
+
+    const std::size_t m_max_size;
+    std::size_t m_size = 0;
+    Entries m_entries; // Most recently used first
+    std::map<Key, Entries::iterator> m_index;
+
+    static std::size_t get_body_size(const DownloadCache& entry) noexcept
+    {
+        return (entry.body_is_compressed ? entry.compressed_body_size : entry.uncompressed_body_size);
+    }
+};
+
+
 // An unblocked work unit is comprised of one Work object for each of the files
 // that contribute work to the work unit, generally one reference file and a
 // number of partial files.
@@ -534,6 +610,11 @@ public:
 
 private:
     ServerImpl& m_server;
+
+    // The worker to which this file is assigned. All work units of this file
+    // are executed by this worker.
+    Worker& m_worker;
+
     ServerFileAccessCache::Slot m_file;
 
     // In general, `m_version_info` refers to the last snapshot of the Realm
@@ -643,6 +724,10 @@ private:
     // before the destruction of the server object itself.
     ServerFileAccessCache::Slot m_worker_file;
 
+    // The server version at which history compaction was last attempted. Only
+    // accessed by the worker thread.
+    version_type m_worker_history_compaction_version = 0;
+
     std::vector<std::int_fast64_t> m_deleting_connections;
 
     DownloadCache m_download_cache;
@@ -659,6 +744,7 @@ private:
     // NOTE: These functions are executed by the worker thread
     void worker_allocate_file_identifiers();
     bool worker_integrate_changes_from_downstream(WorkerState&);
+    void worker_compact_history(ServerHistory&);
     ServerHistory& get_client_file_history(WorkerState& state, std::unique_ptr<ServerHistory>& hist_ptr,
                                            DBRef& sg_ptr);
     ServerHistory& get_reference_file_history(WorkerState& state);
@@ -696,13 +782,20 @@ inline void ServerFile::group_finalize_work_stage_2()
 // blocked waiting for the worker thread to end a long running write
 // transaction.
 //
+// When the server is configured with more than one worker
+// (Server::Config::num_workers), each Realm file is assigned to one of them
+// (ServerImpl::get_worker()), so work units of a particular file are still
+// executed one at a time, while work units of files assigned to different
+// workers are executed in parallel. Each worker has its own cache of open
+// Realm files.
+//
 // FIXME: Currently, the event loop thread does perform a number of write
 // transactions, but only on subtier nodes of a star topology server cluster.
 class Worker : public ServerHistory::Context {
 public:
     util::PrefixLogger logger;
 
-    explicit Worker(ServerImpl&);
+    Worker(ServerImpl&, const std::string& logger_prefix);
 
     ServerFileAccessCache& get_file_access_cache() noexcept;
 
@@ -825,9 +918,18 @@ public:
         return m_scratch_memory;
     }
 
-    Worker& get_worker() noexcept
+    // Returns the worker to which the Realm file with the specified virtual
+    // path is assigned.
+    // Returns null if the shared download cache is disabled.
+    SharedDownloadCache* get_shared_download_cache() noexcept
+    {
+        return m_shared_download_cache.get();
+    }
+
+    Worker& get_worker(const std::string& virt_path) noexcept
     {
-        return m_worker;
+        std::size_t i = std::hash<std::string>{}(virt_path) % m_workers.size();
+        return *m_workers[i];
     }
 
     void get_workunit_timers(milliseconds_type& parallel_section, milliseconds_type& sequential_section)
@@ -998,7 +1100,8 @@ private:
 
     std::unique_ptr<util::network::ssl::Context> m_ssl_context;
     ServerFileAccessCache m_file_access_cache;
-    Worker m_worker;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::unique_ptr<SharedDownloadCache> m_shared_download_cache;
     std::map<std::string, util::bind_ptr<ServerFile>> m_files; // Key is virtual path
     util::network::Acceptor m_acceptor;
     std::int_fast64_t m_next_conn_id = 0;
@@ -1176,6 +1279,17 @@ public:
         }
     }
 
+    void async_write_buffers(util::Span<const util::Span<const char>> buffers,
+                             util::websocket::WriteCompletionHandler handler) final override
+    {
+        if (m_ssl_stream) {
+            util::websocket::Config::async_write_buffers(buffers, std::move(handler)); // Throws
+        }
+        else {
+            m_socket->async_write(buffers, std::move(handler)); // Throws
+        }
+    }
+
     void async_read(char* buffer, size_t size, util::websocket::ReadCompletionHandler handler) final override
     {
         if (m_ssl_stream) {
@@ -1282,6 +1396,8 @@ public:
 
     void receive_mark_message(session_ident_type, request_ident_type);
 
+    void receive_snapshot_request_message(session_ident_type);
+
     void receive_unbind_message(session_ident_type);
 
     void receive_ping(milliseconds_type timestamp, milliseconds_type rtt);
@@ -2209,6 +2325,10 @@ public:
                     // State is WaitForUnbind.
                     bool relayed_alloc = (m_allocated_file_ident.ident != 0);
                     if (REALM_LIKELY(!relayed_alloc)) {
+                        if (REALM_UNLIKELY(m_send_snapshot)) {
+                            send_snapshot_message(); // Throws
+                            return;
+                        }
                         // Send DOWNLOAD or MARK.
                         continue_history_scan(); // Throws
                         // Session object may have been
@@ -2391,6 +2511,16 @@ public:
         const Server::Config& config = server.get_config();
         m_disable_download = (config.disable_download_for.count(client_file_ident) != 0);
 
+        // A snapshot replaces the download of the entire history, so it is
+        // only sent to a client which has neither downloaded anything, nor
+        // had anything of its own integrated
+        if (m_snapshot_requested) {
+            m_send_snapshot = (config.enable_snapshot_bootstraps && !m_disable_download &&
+                               download_progress.server_version == 0 && upload_threshold.client_version == 0);
+            if (!m_send_snapshot)
+                logger.detail("Ignoring snapshot request"); // Throws
+        }
+
         if (REALM_UNLIKELY(config.session_bootstrap_callback)) {
             config.session_bootstrap_callback(m_server_file->get_virt_path(),
                                               client_file_ident); // Throws
@@ -2401,6 +2531,27 @@ public:
         return true;
     }
 
+    bool receive_snapshot_request_message(ProtocolError& error)
+    {
+        // Protocol state must be WaitForIdent
+        REALM_ASSERT(!need_client_file_ident());
+        REALM_ASSERT(!m_send_ident_message);
+        REALM_ASSERT(!ident_message_received());
+        REALM_ASSERT(!unbind_message_received());
+        REALM_ASSERT(!error_occurred());
+        REALM_ASSERT(!m_error_message_sent);
+
+        logger.debug("Received: SNAPSHOT_REQUEST"); // Throws
+
+        if (REALM_UNLIKELY(m_snapshot_requested)) {
+            logger.error("Received second SNAPSHOT_REQUEST message for session"); // Throws
+            error = ProtocolError::bad_message_order;
+            return false;
+        }
+        m_snapshot_requested = true;
+        return true;
+    }
+
     bool receive_upload_message(version_type progress_client_version, version_type progress_server_version,
                                 version_type locked_server_version, const UploadChangesets& upload_changesets,
                                 ProtocolError& error)
@@ -2769,6 +2920,13 @@ private:
     bool m_unbind_message_received = false;
     bool m_error_message_sent = false;
 
+    // Set when a SNAPSHOT_REQUEST message is received, which must come before
+    // the IDENT message. m_send_snapshot is then set on reception of the IDENT
+    // message if the request is granted, and remains set until the SNAPSHOT
+    // message is sent, or it turns out that no snapshot can be made.
+    bool m_snapshot_requested = false;
+    bool m_send_snapshot = false;
+
     /// m_one_download_message_sent denotes whether at least one DOWNLOAD message
     /// has been sent in the current session. The variable is used to ensure
     /// that a DOWNLOAD message is always sent in a session. The received
@@ -2833,16 +2991,43 @@ private:
                                  m_upload_progress.client_version == 0 && m_upload_threshold.client_version == 0);
             DownloadCache& cache = m_server_file->get_download_cache();
             bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version);
-            if (fetch_from_cache) {
-                body = cache.body.get();
-                uncompressed_body_size = cache.uncompressed_body_size;
-                compressed_body_size = cache.compressed_body_size;
-                body_is_compressed = cache.body_is_compressed;
-                download_progress = cache.download_progress;
-                downloadable_bytes = cache.downloadable_bytes;
-                num_changesets = cache.num_changesets;
-                accum_original_size = cache.accum_original_size;
-                accum_compacted_size = cache.accum_compacted_size;
+
+            // A DOWNLOAD body can be shared by all clients whose scan begins at
+            // the same position, as long as the history contains no changesets
+            // of their own after that position. That is the case when the last
+            // integrated client version is already accounted for by the
+            // download cursor.
+            SharedDownloadCache* shared_cache = (enable_cache ? nullptr : server.get_shared_download_cache());
+            SharedDownloadCache::Key shared_cache_key = {m_server_file.get(), m_download_progress, end_version,
+                                                         config.max_download_size, disable_download_compaction};
+            const DownloadCache* shared_entry = nullptr;
+            if (shared_cache) {
+                UploadCursor upload_progress_2;
+                bool not_expired = history.get_upload_progress(m_client_file_ident, upload_progress_2); // Throws
+                if (not_expired &&
+                    upload_progress_2.client_version == m_download_progress.last_integrated_client_version) {
+                    shared_entry = shared_cache->find(shared_cache_key);
+                    if (shared_entry)
+                        upload_progress = upload_progress_2;
+                }
+                else {
+                    shared_cache = nullptr;
+                }
+            }
+
+            if (fetch_from_cache || shared_entry) {
+                const DownloadCache& entry = (fetch_from_cache ? cache : *shared_entry);
+                body = entry.body.get();
+                uncompressed_body_size = entry.uncompressed_body_size;
+                compressed_body_size = entry.compressed_body_size;
+                body_is_compressed = entry.body_is_compressed;
+                download_progress = entry.download_progress;
+                downloadable_bytes = entry.downloadable_bytes;
+                num_changesets = entry.num_changesets;
+                accum_original_size = entry.accum_original_size;
+                accum_compacted_size = entry.accum_compacted_size;
+                if (shared_entry)
+                    logger.trace("DOWNLOAD body fetched from shared download cache"); // Throws
             }
             else {
                 // Discard the old cached DOWNLOAD body before generating a new
@@ -2922,6 +3107,26 @@ private:
                         // (suicide).
                         return;
                     }
+                    // Changesets of this client may have been integrated since
+                    // the upload progress was checked.
+                    bool shareable = (upload_progress.client_version ==
+                                      m_download_progress.last_integrated_client_version);
+                    if (shared_cache && shareable) {
+                        std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
+                        DownloadCache entry;
+                        entry.body = std::make_unique<char[]>(body_size); // Throws
+                        std::copy(body, body + body_size, entry.body.get());
+                        entry.uncompressed_body_size = uncompressed_body_size;
+                        entry.compressed_body_size = compressed_body_size;
+                        entry.body_is_compressed = body_is_compressed;
+                        entry.end_version = end_version;
+                        entry.download_progress = download_progress;
+                        entry.downloadable_bytes = downloadable_bytes;
+                        entry.num_changesets = num_changesets;
+                        entry.accum_original_size = accum_original_size;
+                        entry.accum_compacted_size = accum_compacted_size;
+                        shared_cache->insert(shared_cache_key, std::move(entry)); // Throws
+                    }
                 }
             }
 
@@ -2956,6 +3161,78 @@ private:
         }
     }
 
+    // Sends the state of the server-side file as a SNAPSHOT message, and
+    // advances the download process to the version of the snapshot. The
+    // history scan then continues from there.
+    void send_snapshot_message()
+    {
+        // Protocol state must be WaitForUnbind
+        REALM_ASSERT(m_send_snapshot);
+        REALM_ASSERT(ident_message_received());
+        REALM_ASSERT(!unbind_message_received());
+        REALM_ASSERT(!error_occurred());
+        REALM_ASSERT(!is_enlisted_to_send());
+        REALM_ASSERT(m_download_progress.server_version == 0);
+
+        ServerImpl& server = m_connection.get_server();
+        m_server_file->register_client_access(m_client_file_ident);     // Throws
+        const ServerHistory& history = m_server_file->access().history; // Throws
+
+        // The snapshot must not be ahead of the version that the server file
+        // has exposed to its sessions, as the download process, and the
+        // latest server version reported to the client, are based on that.
+        // When it is, the new version is about to be exposed, at which point
+        // this session is enlisted to send again.
+        SaltedVersion last_server_version = m_server_file->get_salted_sync_version();
+        OutputBuffer& out = server.get_misc_buffers().download_message;
+        out.reset();
+        SaltedVersion server_version;
+        bool possible = history.write_snapshot(last_server_version.version, out, server_version); // Throws
+        if (!possible) {
+            logger.detail("Snapshot not possible, as some tables have no primary key"); // Throws
+            m_send_snapshot = false;
+            enlist_to_send();
+            return;
+        }
+        if (server_version.version > last_server_version.version)
+            return;
+        if (server_version.version == 0) {
+            // Nothing to bootstrap from
+            m_send_snapshot = false;
+            enlist_to_send();
+            return;
+        }
+
+        BinaryData uncompressed = {out.data(), std::size_t(out.size())};
+        const char* body = uncompressed.data();
+        std::size_t compressed_body_size = 0;
+        bool body_is_compressed = false;
+        std::size_t max_uncompressed = 1024;
+        if (uncompressed.size() > max_uncompressed) {
+            compression::CompressMemoryArena& arena = server.get_compress_memory_arena();
+            std::vector<char>& buffer = server.get_misc_buffers().compress;
+            compression::allocate_and_compress(arena, uncompressed, buffer); // Throws
+            if (buffer.size() < uncompressed.size()) {
+                body = buffer.data();
+                compressed_body_size = buffer.size();
+                body_is_compressed = true;
+            }
+        }
+
+        ServerProtocol& protocol = get_server_protocol();
+        OutputBuffer& out_2 = m_connection.get_output_buffer();
+        protocol.make_snapshot_message(out_2, m_session_ident, server_version, body, uncompressed.size(),
+                                       compressed_body_size, body_is_compressed, logger); // Throws
+        m_connection.initiate_write_output_buffer();                                       // Throws
+
+        m_send_snapshot = false;
+        m_download_progress = {server_version.version, 0};
+        logger.debug("Setting of m_download_progress.server_version = %1",
+                     m_download_progress.server_version); // Throws
+
+        enlist_to_send();
+    }
+
     void send_ident_message()
     {
         // Protocol state must be SendIdent
@@ -3146,11 +3423,12 @@ void SessionQueue::clear() noexcept
 
 ServerFile::ServerFile(ServerImpl& server, ServerFileAccessCache& cache, const std::string& virt_path,
                        std::string real_path, bool disable_sync_to_disk)
-    : logger{"ServerFile[" + virt_path + "]: ", server.logger}               // Throws
-    , wlogger{"ServerFile[" + virt_path + "]: ", server.get_worker().logger} // Throws
+    : logger{"ServerFile[" + virt_path + "]: ", server.logger}                       // Throws
+    , wlogger{"ServerFile[" + virt_path + "]: ", server.get_worker(virt_path).logger} // Throws
     , m_server{server}
+    , m_worker{server.get_worker(virt_path)}
     , m_file{cache, real_path, virt_path, false, disable_sync_to_disk} // Throws
-    , m_worker_file{server.get_worker().get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
+    , m_worker_file{m_worker.get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
 {
 }
 
@@ -3413,8 +3691,7 @@ void ServerFile::group_unblock_work()
         if (REALM_LIKELY(work.has_primary_work)) {
             logger.trace("Work unit unblocked"); // Throws
             m_has_work_in_progress = true;
-            Worker& worker = m_server.get_worker();
-            worker.enqueue(this); // Throws
+            m_worker.enqueue(this); // Throws
         }
     }
 }
@@ -3536,9 +3813,37 @@ bool ServerFile::worker_integrate_changes_from_downstream(WorkerState& state)
             m_work.produced_new_sync_version = true;
         }
     }
+    if (produced_new_sync_version)
+        worker_compact_history(hist); // Throws
     return produced_new_sync_version;
 }
 
+
+void ServerFile::worker_compact_history(ServerHistory& hist)
+{
+    const Server::Config& config = m_server.get_config();
+    if (config.history_compaction_interval == 0)
+        return;
+    version_type server_version = m_work.version_info.sync_version.version;
+    if (server_version - m_worker_history_compaction_version < config.history_compaction_interval)
+        return;
+    m_worker_history_compaction_version = server_version;
+
+    ServerHistory::CompactionConfig compaction_config;
+    compaction_config.tail_length = config.history_compaction_tail;
+    compaction_config.min_versions = config.history_compaction_interval;
+    compaction_config.max_client_lag = config.history_compaction_max_client_lag;
+    compaction_config.max_batch_size = config.max_download_size;
+    ServerHistory::CompactionResult result =
+        hist.compact_history(compaction_config, m_work.version_info, wlogger); // Throws
+    if (result.num_compacted_versions == 0 && result.num_expired_clients == 0)
+        return;
+    m_work.produced_new_realm_version = true;
+    wlogger.detail("History compacted until version %1 (%2 versions, %3 -> %4 bytes, %5 clients expired)",
+                   result.compacted_until_version, result.num_compacted_versions, result.original_size,
+                   result.compacted_size, result.num_expired_clients); // Throws
+}
+
 ServerHistory& ServerFile::get_client_file_history(WorkerState& state, std::unique_ptr<ServerHistory>& hist_ptr,
                                                    DBRef& sg_ptr)
 {
@@ -3682,8 +3987,8 @@ void ServerFile::finalize_work_stage_2()
 
 // ============================ Worker implementation ============================
 
-Worker::Worker(ServerImpl& server)
-    : logger{"Worker: ", server.logger} // Throws
+Worker::Worker(ServerImpl& server, const std::string& logger_prefix)
+    : logger{logger_prefix, server.logger} // Throws
     , m_server{server}
     , m_transformer{make_transformer()} // Throws
     , m_file_access_cache{server.get_config().max_open_files, logger, *this, server.get_config().encryption_key}
@@ -3758,11 +4063,19 @@ ServerImpl::ServerImpl(const std::string& root_dir, util::Optional<sync::PKey> p
     , m_access_control{std::move(pkey)}
     , m_protocol_version_range{determine_protocol_version_range(config)}                 // Throws
     , m_file_access_cache{m_config.max_open_files, logger, *this, config.encryption_key} // Throws
-    , m_worker{*this}                                                                    // Throws
     , m_acceptor{get_service()}
     , m_server_protocol{}       // Throws
     , m_compress_memory_arena{} // Throws
 {
+    REALM_ASSERT(m_config.num_workers >= 1);
+    m_workers.reserve(m_config.num_workers); // Throws
+    for (unsigned i = 0; i < m_config.num_workers; ++i) {
+        std::string logger_prefix = (m_config.num_workers == 1 ? "Worker: " : util::format("Worker[%1]: ", i));
+        m_workers.push_back(std::make_unique<Worker>(*this, logger_prefix)); // Throws
+    }
+    if (m_config.download_cache_size > 0)
+        m_shared_download_cache = std::make_unique<SharedDownloadCache>(m_config.download_cache_size); // Throws
+
     if (m_config.ssl) {
         m_ssl_context = std::make_unique<util::network::ssl::Context>();          // Throws
         m_ssl_context->use_certificate_chain_file(m_config.ssl_certificate_path); // Throws
@@ -3805,6 +4118,7 @@ void ServerImpl::start()
     }
     logger.info("Directory holding persistent state: %1", m_root_dir);        // Throws
     logger.info("Maximum number of open files: %1", m_config.max_open_files); // Throws
+    logger.info("Number of workers: %1", m_config.num_workers);               // Throws
     {
         const char* lead_text = "Encryption";
         if (m_config.encryption_key) {
@@ -3832,6 +4146,7 @@ void ServerImpl::start()
                 (m_config.disable_download_compaction ? "No" : "Yes")); // Throws
     logger.info("Download bootstrap caching: %1",
                 (m_config.enable_download_bootstrap_cache ? "Yes" : "No"));                // Throws
+    logger.info("Shared download cache size: %1 bytes", m_config.download_cache_size);     // Throws
     logger.info("Max download size: %1 bytes", m_config.max_download_size);                // Throws
     logger.info("Max upload backlog: %1 bytes", m_max_upload_backlog);                     // Throws
     logger.info("HTTP request timeout: %1 ms", m_config.http_request_timeout);             // Throws
@@ -3856,19 +4171,27 @@ void ServerImpl::run()
     auto ta = util::make_temp_assign(m_running, true);
 
     {
-        auto worker_thread = util::make_thread_exec_guard(m_worker, *this); // Throws
+        std::vector<util::ThreadExecGuardWithParent<Worker, ServerImpl>> worker_threads;
+        worker_threads.reserve(m_workers.size()); // Throws
         std::string name;
-        if (util::Thread::get_name(name)) {
-            name += "-worker";
-            worker_thread.start_with_signals_blocked(name); // Throws
-        }
-        else {
-            worker_thread.start_with_signals_blocked(); // Throws
+        bool has_name = util::Thread::get_name(name);
+        for (std::size_t i = 0; i < m_workers.size(); ++i) {
+            auto& worker_thread = worker_threads.emplace_back(*m_workers[i], *this); // Throws
+            if (has_name) {
+                std::string worker_name = name + "-worker";
+                if (m_workers.size() > 1)
+                    worker_name += "-" + std::to_string(i);
+                worker_thread.start_with_signals_blocked(worker_name); // Throws
+            }
+            else {
+                worker_thread.start_with_signals_blocked(); // Throws
+            }
         }
 
         m_service.run(); // Throws
 
-        worker_thread.stop_and_rethrow(); // Throws
+        for (auto& worker_thread : worker_threads)
+            worker_thread.stop_and_rethrow(); // Throws
     }
 
     logger.info("Realm sync server stopped");
@@ -4380,6 +4703,41 @@ void SyncConnection::receive_mark_message(session_ident_type session_ident, requ
 }
 
 
+void SyncConnection::receive_snapshot_request_message(session_ident_type session_ident)
+{
+    auto i = m_sessions.find(session_ident);
+    if (REALM_UNLIKELY(i == m_sessions.end())) {
+        bad_session_ident("SNAPSHOT_REQUEST", session_ident); // Throws
+        return;
+    }
+    Session& sess = *i->second;
+    if (REALM_UNLIKELY(sess.unbind_message_received())) {
+        message_after_unbind("SNAPSHOT_REQUEST", session_ident); // Throws
+        return;
+    }
+    if (REALM_UNLIKELY(sess.error_occurred())) {
+        // Protocol state is SendError or WaitForUnbindErr. In these states, all
+        // messages, other than UNBIND, must be ignored.
+        return;
+    }
+    if (REALM_UNLIKELY(sess.must_send_ident_message())) {
+        logger.error("Received SNAPSHOT_REQUEST message before IDENT message was sent"); // Throws
+        protocol_error(ProtocolError::bad_message_order);                                // Throws
+        return;
+    }
+    if (REALM_UNLIKELY(sess.ident_message_received())) {
+        logger.error("Received SNAPSHOT_REQUEST message after IDENT message"); // Throws
+        protocol_error(ProtocolError::bad_message_order);                      // Throws
+        return;
+    }
+
+    ProtocolError error = {};
+    bool success = sess.receive_snapshot_request_message(error); // Throws
+    if (REALM_UNLIKELY(!success))                                // Throws
+        protocol_error(error, &sess);                            // Throws
+}
+
+
 void SyncConnection::receive_unbind_message(session_ident_type session_ident)
 {
     auto i = m_sessions.find(session_ident); // Throws
@@ -71,11 +71,19 @@ public:
 
         /// The maximum number of Realm files that will be kept open
         /// concurrently by each major thread inside the server. The server
-        /// currently has two major threads (foreground and background). The
-        /// server keeps a cache of open Realm files for efficiency reasons (one
-        /// for each major thread).
+        /// has one foreground thread, and one background thread per worker
+        /// (see \ref num_workers). The server keeps a cache of open Realm
+        /// files for efficiency reasons (one for each major thread).
         long max_open_files = 256;
 
+        /// The number of background worker threads integrating changesets
+        /// received from clients. Each Realm file is assigned to one worker
+        /// by a hash of its virtual path, so changesets for a particular file
+        /// are integrated by one thread at a time, while changesets for files
+        /// assigned to different workers are integrated in parallel. Must be
+        /// at least 1.
+        unsigned num_workers = 1;
+
         /// An optional custom clock to be used for token expiration checks. If
         /// no clock is specified, the server will use the system clock.
         Clock* token_expiration_clock = nullptr;
@@ -171,6 +179,24 @@ public:
         /// message(s) used for client bootstrapping.
         bool enable_download_bootstrap_cache = false;
 
+        /// If set to true, the server answers a SNAPSHOT_REQUEST message
+        /// from a client that has not yet downloaded anything with a
+        /// SNAPSHOT message containing the server-side Realm at the latest
+        /// server version, after which the download continues from that
+        /// version. Otherwise such requests are ignored, and the client
+        /// downloads the entire history.
+        bool enable_snapshot_bootstraps = false;
+
+        /// The maximum accumulated size, in bytes, of the DOWNLOAD message
+        /// bodies kept in a cache shared by all sessions of the server. A body
+        /// produced for one client is reused for every other client whose
+        /// download starts at the same position in the history of the same
+        /// file, and which has no changesets of its own in the downloaded
+        /// range. This spares the server from fetching, compacting, encoding
+        /// and compressing the same changesets again when many clients of a
+        /// file reconnect at the same time. Zero disables the cache.
+        std::size_t download_cache_size = 0;
+
         /// The accumulated size of changesets that are included in download
         /// messages. The size of the changesets is calculated before log
         /// compaction (if enabled). A larger value leads to more efficient
@@ -179,6 +205,25 @@ public:
         /// for the need to resend the same changes after network disconnects.
         std::size_t max_download_size = 0x1000000; // 16 MiB
 
+        /// If nonzero, the server eliminates redundant instructions from the
+        /// older part of the history of a file, in place, whenever this many
+        /// new versions have been produced since it last tried. This keeps the
+        /// downloads of clients that start from far back in the history small,
+        /// such as when bootstrapping. The most recent
+        /// `history_compaction_tail` versions are always left as they are, and
+        /// so are all versions that a client may still need to download from.
+        version_type history_compaction_interval = 0;
+
+        /// The number of most recent versions left uncompacted by the history
+        /// compaction.
+        version_type history_compaction_tail = 1000;
+
+        /// If nonzero, clients lagging more than this many versions behind the
+        /// current version of a file are expired by the history compaction,
+        /// rather than holding it back. An expired client must reset its file
+        /// when it connects again.
+        version_type history_compaction_max_client_lag = 0;
+
         /// The maximum number of connections that can be queued up waiting to
         /// be accepted by the server. This corresponds to the `backlog`
         /// argument of the `listen()` function as described by POSIX.
@@ -906,6 +906,169 @@ bool ServerHistory::fetch_download_info(file_ident_type client_file_ident, Downl
 }
 
 
+bool ServerHistory::get_upload_progress(file_ident_type client_file_ident, UploadCursor& upload_progress) const
+{
+    REALM_ASSERT(client_file_ident != 0);
+
+    TransactionRef tr = m_db->start_read(); // Throws
+    version_type realm_version = tr->get_version();
+    const_cast<ServerHistory*>(this)->set_group(tr.get());
+    ensure_updated(realm_version); // Throws
+
+    std::size_t client_file_index = std::size_t(client_file_ident);
+    auto client_type = ClientType(m_acc->cf_client_types.get(client_file_index));
+    REALM_ASSERT_RELEASE(is_direct_client(client_type));
+    std::int_fast64_t last_seen_timestamp = m_acc->cf_last_seen_timestamps.get(client_file_index);
+    bool expired = (last_seen_timestamp == 0);
+    if (REALM_UNLIKELY(expired))
+        return false;
+
+    version_type upload_client_version = version_type(m_acc->cf_client_versions.get(client_file_index));
+    version_type upload_server_version = version_type(m_acc->cf_rh_base_versions.get(client_file_index));
+    upload_progress = UploadCursor{upload_client_version, upload_server_version};
+    return true;
+}
+
+
+bool ServerHistory::write_snapshot(version_type max_server_version, std::ostream& out,
+                                   SaltedVersion& server_version) const
+{
+    TransactionRef rt = m_db->start_read(); // Throws
+    version_type realm_version = rt->get_version();
+    const_cast<ServerHistory*>(this)->set_group(rt.get());
+    ensure_updated(realm_version); // Throws
+    server_version = get_salted_server_version();
+
+    for (TableKey table_key : rt->get_table_keys()) {
+        if (!rt->table_is_public(table_key))
+            continue;
+        ConstTableRef table = rt->get_table(table_key);
+        if (!table->is_embedded() && !table->get_primary_key_column())
+            return false;
+    }
+    if (server_version.version > max_server_version)
+        return true;
+
+    bool pad = false;
+    bool write_history = false;
+    rt->write(out, pad, write_history); // Throws
+    return true;
+}
+
+
+auto ServerHistory::compact_history(const CompactionConfig& config, VersionInfo& version_info,
+                                    util::Logger& logger) -> CompactionResult
+{
+    TransactionRef tr = m_db->start_write(); // Throws
+    version_type realm_version = tr->get_version();
+    ensure_updated(realm_version); // Throws
+    prepare_for_write();           // Throws
+
+    CompactionResult result;
+    version_type current_server_version = get_server_version();
+    version_type compacted_until_version =
+        version_type(m_acc->root.get_as_ref_or_tagged(s_compacted_until_version_iip).get_as_int());
+    compacted_until_version = std::max(compacted_until_version, m_history_base_version);
+    result.compacted_until_version = compacted_until_version;
+    if (current_server_version - compacted_until_version <= config.tail_length)
+        return result;
+
+    // No client may be left in the middle of the compacted range, as it would
+    // then miss instructions that were removed because of later instructions
+    // that it has already seen, or that it has not yet seen, but which are in
+    // the same range.
+    version_type end_version = current_server_version - config.tail_length;
+    for (std::size_t i = 0; i < m_num_client_files; ++i) {
+        auto client_type = ClientType(m_acc->cf_client_types.get(i));
+        if (!is_direct_client(client_type))
+            continue;
+        bool expired = (m_acc->cf_last_seen_timestamps.get(i) == 0);
+        if (expired)
+            continue;
+        version_type bound = std::max(version_type(m_acc->cf_rh_base_versions.get(i)),
+                                      version_type(m_acc->cf_locked_server_versions.get(i)));
+        if (bound >= end_version)
+            continue;
+        if (config.max_client_lag != 0 && current_server_version - bound > config.max_client_lag) {
+            logger.debug("Expiring client file %1 during history compaction (%2 versions behind)", i,
+                         current_server_version - bound); // Throws
+            m_acc->cf_last_seen_timestamps.set(i, 0); // Throws
+            ++result.num_expired_clients;
+            continue;
+        }
+        end_version = std::max(bound, compacted_until_version);
+    }
+
+    bool compact = (end_version - compacted_until_version >= std::max<version_type>(config.min_versions, 1));
+    if (!compact && result.num_expired_clients == 0)
+        return result;
+
+    if (compact) {
+        std::vector<Changeset> changesets;
+        std::vector<std::size_t> original_changeset_sizes;
+        ChangesetEncoder::Buffer encode_buffer;
+        auto compact_batch = [&](std::size_t begin_ndx) {
+            // Download compaction (compact_changesets()) is not implemented
+            // for the current instruction set. As every client has either
+            // integrated the whole range, or will download it from the start,
+            // no client depends on its intermediate states, so it can be
+            // compacted like local changesets that are about to be uploaded.
+            compact_changesets_for_upload(changesets.data(), changesets.size()); // Throws
+            for (std::size_t i = 0; i < changesets.size(); ++i) {
+                encode_changeset(changesets[i], encode_buffer); // Throws
+                result.original_size += original_changeset_sizes[i];
+                if (encode_buffer.size() < original_changeset_sizes[i]) {
+                    BinaryData data{encode_buffer.data(), encode_buffer.size()};
+                    m_acc->sh_changesets.set(begin_ndx + i, data); // Throws
+                    result.compacted_size += encode_buffer.size();
+                }
+                else {
+                    result.compacted_size += original_changeset_sizes[i];
+                }
+                encode_buffer.clear();
+            }
+            changesets.clear();
+            original_changeset_sizes.clear();
+        };
+
+        std::size_t begin_ndx = to_size_t(compacted_until_version - m_history_base_version);
+        std::size_t end_ndx = to_size_t(end_version - m_history_base_version);
+        std::size_t batch_begin_ndx = begin_ndx;
+        std::size_t batch_size = 0;
+        for (std::size_t ndx = begin_ndx; ndx < end_ndx; ++ndx) {
+            ChunkedBinaryData chunked_changeset{m_acc->sh_changesets, ndx};
+            ChunkedBinaryInputStream stream{chunked_changeset};
+            Changeset changeset;
+            parse_changeset(stream, changeset); // Throws
+            changeset.version = m_history_base_version + ndx + 1;
+            changeset.origin_file_ident = file_ident_type(m_acc->sh_origin_files.get(ndx));
+            changeset.origin_timestamp = timestamp_type(m_acc->sh_timestamps.get(ndx));
+            changesets.push_back(std::move(changeset));                   // Throws
+            original_changeset_sizes.push_back(chunked_changeset.size()); // Throws
+            batch_size += chunked_changeset.size();
+            if (batch_size >= config.max_batch_size) {
+                compact_batch(batch_begin_ndx); // Throws
+                batch_begin_ndx = ndx + 1;
+                batch_size = 0;
+            }
+        }
+        if (!changesets.empty())
+            compact_batch(batch_begin_ndx); // Throws
+
+        result.num_compacted_versions = end_version - compacted_until_version;
+        result.compacted_until_version = end_version;
+        m_acc->root.set(s_compacted_until_version_iip, RefOrTagged::make_tagged(end_version)); // Throws
+        m_acc->root.set(s_last_compaction_timestamp_iip,
+                        RefOrTagged::make_tagged(std::uint_fast64_t(std::time(nullptr)))); // Throws
+    }
+
+    version_type new_realm_version = tr->commit(); // Throws
+    version_info.realm_version = new_realm_version;
+    version_info.sync_version = get_salted_server_version();
+    return result;
+}
+
+
 void ServerHistory::add_upstream_sync_status()
 {
     TransactionRef tr = m_db->start_write(); // Throws
@@ -388,6 +388,77 @@ public:
                              std::uint_fast64_t& cumulative_byte_size_total, bool disable_download_compaction,
                              std::size_t accum_byte_size_soft_limit = 0x20000) const;
 
+    /// \brief Get the last client version integrated into the history.
+    ///
+    /// Sets \a upload_progress like fetch_download_info() does, but without
+    /// scanning the history.
+    ///
+    /// \return False if the client file entry of the specified client file has
+    /// expired. Otherwise true.
+    bool get_upload_progress(file_ident_type client_file_ident, UploadCursor& upload_progress) const;
+
+    /// \brief Write the state of the Realm as a file to be adopted by a client.
+    ///
+    /// Sets \a server_version to the latest server version, and writes the
+    /// state of the Realm at that version to \a out as a Realm file without
+    /// history, unless the server version is greater than \a
+    /// max_server_version, in which case nothing is written.
+    ///
+    /// \return False, and nothing is written, if a client cannot adopt the
+    /// objects of the Realm from a snapshot, which is the case when a table
+    /// other than an embedded table has no primary key. Otherwise true.
+    bool write_snapshot(version_type max_server_version, std::ostream& out, SaltedVersion& server_version) const;
+
+    struct CompactionConfig {
+        /// The number of most recent server versions that are left as they
+        /// are.
+        version_type tail_length = 1000;
+
+        /// Nothing is done unless at least this many versions can be
+        /// compacted, as every compaction rewrites the compacted changesets.
+        version_type min_versions = 1000;
+
+        /// Direct clients whose reciprocal history is based on a version more
+        /// than this many versions behind the current server version are
+        /// expired, so that they no longer hold back the compaction. Zero means
+        /// that clients are never expired.
+        version_type max_client_lag = 0;
+
+        /// Changesets are compacted in batches of at most about this many
+        /// bytes (before compaction).
+        std::size_t max_batch_size = 0x1000000; // 16 MiB
+    };
+
+    struct CompactionResult {
+        version_type compacted_until_version = 0;
+        version_type num_compacted_versions = 0;
+        std::size_t original_size = 0;
+        std::size_t compacted_size = 0;
+        std::size_t num_expired_clients = 0;
+    };
+
+    /// \brief Eliminate redundant instructions from the older part of the
+    /// history.
+    ///
+    /// The changesets of the history entries from the version after the one
+    /// that was previously compacted until, up to all but the last \a
+    /// config.tail_length versions, are compacted together, and replaced in
+    /// place. The cumulative byte sizes of the entries are left unchanged, so
+    /// download progress is still reported in terms of uncompacted sizes.
+    ///
+    /// Since instructions are removed because of later instructions in the
+    /// compacted range, no client may be left in the middle of that range. The
+    /// range therefore never extends past the base version of the reciprocal
+    /// history, or the locked server version, of any direct client that has not
+    /// expired. Clients lagging more than \a config.max_client_lag versions
+    /// behind are expired instead, and will have to reset their files the next
+    /// time they connect.
+    ///
+    /// If anything was changed, the transaction is committed, and \a
+    /// version_info is set accordingly.
+    CompactionResult compact_history(const CompactionConfig& config, sync::VersionInfo& version_info,
+                                     util::Logger&);
+
     /// The application must call this function before using the history as an
     /// upstream client history.
     ///
@@ -0,0 +1,74 @@
+#include <realm/sync/noinst/upload_flow_control.hpp>
+
+#include <algorithm>
+
+namespace realm::sync {
+
+namespace {
+
+// Round-trip times up to this much above twice the smallest one are taken as
+// jitter, which is common on wireless links, rather than as queuing.
+constexpr milliseconds_type rtt_slack = 50;
+
+} // unnamed namespace
+
+std::size_t UploadFlowControl::get_message_size() const noexcept
+{
+    return std::clamp(m_window / 4, min_message_size, max_message_size);
+}
+
+void UploadFlowControl::on_upload_sent(version_type client_version, std::size_t size, milliseconds_type now)
+{
+    m_in_flight.push_back({client_version, size, now}); // Throws
+    m_bytes_in_flight += size;
+}
+
+bool UploadFlowControl::on_upload_acknowledged(version_type client_version, milliseconds_type now)
+{
+    if (m_in_flight.empty() || m_in_flight.front().client_version > client_version)
+        return false;
+
+    std::size_t acknowledged_bytes = 0;
+    milliseconds_type sent_at = 0;
+    while (!m_in_flight.empty() && m_in_flight.front().client_version <= client_version) {
+        acknowledged_bytes += m_in_flight.front().size;
+        sent_at = m_in_flight.front().sent_at;
+        m_in_flight.pop_front();
+    }
+    m_bytes_in_flight -= acknowledged_bytes;
+
+    milliseconds_type rtt = std::max<milliseconds_type>(now - sent_at, 1);
+    m_min_rtt = (m_min_rtt == 0) ? rtt : std::min(m_min_rtt, rtt);
+    m_smoothed_rtt = (m_smoothed_rtt == 0) ? rtt : (7 * m_smoothed_rtt + rtt) / 8;
+
+    if (rtt > 2 * m_min_rtt + rtt_slack) {
+        // Reduce the window at most once per round trip, as the acknowledgements
+        // of the messages sent before the first reduction took effect will be
+        // late too
+        if (now - m_last_reduction_at >= m_smoothed_rtt) {
+            m_window = std::max(m_window * 7 / 10, min_window);
+            m_slow_start_threshold = m_window;
+            m_last_reduction_at = now;
+        }
+    }
+    else if (m_window < m_slow_start_threshold) {
+        m_window = std::min(m_window + acknowledged_bytes, max_window);
+    }
+    else {
+        m_window = std::min(m_window + acknowledged_bytes * get_message_size() / m_window, max_window);
+    }
+    return true;
+}
+
+void UploadFlowControl::reset() noexcept
+{
+    m_in_flight.clear();
+    m_bytes_in_flight = 0;
+    m_window = initial_window;
+    m_slow_start_threshold = max_window;
+    m_smoothed_rtt = 0;
+    m_min_rtt = 0;
+    m_last_reduction_at = 0;
+}
+
+} // namespace realm::sync
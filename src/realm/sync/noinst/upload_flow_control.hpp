@@ -0,0 +1,99 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#pragma once
+
+#include <realm/sync/protocol.hpp>
+
+#include <deque>
+
+namespace realm::sync {
+
+/// Decides how large the UPLOAD messages of a session are, and how many bytes
+/// of them may be awaiting acknowledgement by the server at a time.
+///
+/// The server acknowledges an UPLOAD message by reporting the upload progress
+/// it carried in a DOWNLOAD message, and the time until then is taken as the
+/// round-trip time of the message. The number of bytes allowed in flight (the
+/// window) doubles every round trip at first, and then grows by about one
+/// message every round trip, for as long as the round-trip time stays close to
+/// the smallest one seen. When the round-trip time grows well beyond that, the
+/// messages are queuing up somewhere along the way, so the window is reduced.
+/// Messages are a quarter of the window in size, so that several are in flight
+/// on a link with a high bandwidth-delay product, and few large ones are sent
+/// on a fast link.
+class UploadFlowControl {
+public:
+    static constexpr std::size_t initial_window = 512 * 1024;
+    static constexpr std::size_t min_window = 64 * 1024;
+    static constexpr std::size_t max_window = 64 * 1024 * 1024;
+    static constexpr std::size_t min_message_size = 16 * 1024;
+    static constexpr std::size_t max_message_size = 4 * 1024 * 1024;
+
+    /// The number of bytes of changesets to put in the next UPLOAD message.
+    std::size_t get_message_size() const noexcept;
+
+    /// Whether another UPLOAD message may be sent now. Always true when no
+    /// message is awaiting acknowledgement.
+    bool can_send() const noexcept
+    {
+        return m_in_flight.empty() || m_bytes_in_flight < m_window;
+    }
+
+    /// Record the sending of an UPLOAD message of \a size bytes which takes
+    /// the upload progress to \a client_version.
+    void on_upload_sent(version_type client_version, std::size_t size, milliseconds_type now);
+
+    /// Record that the server has reported upload progress up to \a
+    /// client_version. Returns true if this acknowledged any message.
+    bool on_upload_acknowledged(version_type client_version, milliseconds_type now);
+
+    /// Forget the messages in flight and start over from the initial window,
+    /// as when the connection is lost.
+    void reset() noexcept;
+
+    std::size_t get_window() const noexcept
+    {
+        return m_window;
+    }
+    std::size_t get_bytes_in_flight() const noexcept
+    {
+        return m_bytes_in_flight;
+    }
+    /// The smoothed round-trip time, or zero before the first acknowledgement.
+    milliseconds_type get_round_trip_time() const noexcept
+    {
+        return m_smoothed_rtt;
+    }
+
+private:
+    struct Upload {
+        version_type client_version;
+        std::size_t size;
+        milliseconds_type sent_at;
+    };
+    std::deque<Upload> m_in_flight;
+    std::size_t m_bytes_in_flight = 0;
+    std::size_t m_window = initial_window;
+    std::size_t m_slow_start_threshold = max_window;
+    milliseconds_type m_smoothed_rtt = 0;
+    milliseconds_type m_min_rtt = 0;
+    milliseconds_type m_last_reduction_at = 0;
+};
+
+} // namespace realm::sync
@@ -31,13 +31,24 @@ namespace sync {
 //   6 Support for asymmetric tables.
 //
 //  XX Changes:
-//     - TBD
+//     - Changesets may contain columnar runs of Update instructions
+//       (`InstrTypeUpdateRun`).
+//     - SNAPSHOT_REQUEST and SNAPSHOT messages let a partition based client
+//       bootstrap from a copy of the server-side file.
 //
 constexpr int get_current_protocol_version() noexcept
 {
     return 6;
 }
 
+/// The first protocol version in which changesets may contain columnar runs
+/// of Update instructions. Until the current protocol version reaches it,
+/// such runs are never sent.
+constexpr int get_columnar_changesets_protocol_version() noexcept
+{
+    return 7;
+}
+
 constexpr std::string_view get_pbs_websocket_protocol_prefix() noexcept
 {
     return "com.mongodb.realm-sync/";
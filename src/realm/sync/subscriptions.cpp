@@ -142,10 +142,30 @@ void SubscriptionSet::load_from_database(const Transaction& tr, Obj obj)
     m_state = static_cast<State>(obj.get<int64_t>(mgr->m_sub_set_state));
     m_error_str = obj.get<String>(mgr->m_sub_set_error_str);
     m_snapshot_version = static_cast<DB::version_type>(obj.get<int64_t>(mgr->m_sub_set_snapshot_version));
+
+    // The subscriptions are written when the set is committed and never
+    // change afterwards
+    bool is_committed = m_state != State::Uncommitted;
+    if (is_committed) {
+        std::lock_guard<std::mutex> lk(mgr->m_cached_subs_mutex);
+        auto it = mgr->m_cached_subs.find(m_version);
+        if (it != mgr->m_cached_subs.end()) {
+            m_subs = it->second;
+            return;
+        }
+    }
+
     auto sub_list = obj.get_linklist(mgr->m_sub_set_subscriptions);
-    m_subs.clear();
+    auto subs = std::make_shared<std::vector<Subscription>>();
+    subs->reserve(sub_list.size());
     for (size_t idx = 0; idx < sub_list.size(); ++idx) {
-        m_subs.push_back(Subscription(mgr.get(), sub_list.get_object(idx)));
+        subs->push_back(Subscription(mgr.get(), sub_list.get_object(idx)));
+    }
+    m_subs = subs;
+
+    if (is_committed) {
+        std::lock_guard<std::mutex> lk(mgr->m_cached_subs_mutex);
+        mgr->m_cached_subs.emplace(m_version, std::move(subs));
     }
 }
 
@@ -182,22 +202,22 @@ StringData SubscriptionSet::error_str() const
 
 size_t SubscriptionSet::size() const
 {
-    return m_subs.size();
+    return m_subs->size();
 }
 
 Subscription SubscriptionSet::at(size_t index) const
 {
-    return m_subs.at(index);
+    return m_subs->at(index);
 }
 
 SubscriptionSet::const_iterator SubscriptionSet::begin() const
 {
-    return m_subs.begin();
+    return m_subs->begin();
 }
 
 SubscriptionSet::const_iterator SubscriptionSet::end() const
 {
-    return m_subs.end();
+    return m_subs->end();
 }
 
 SubscriptionSet::const_iterator SubscriptionSet::find(StringData name) const
@@ -222,6 +242,8 @@ MutableSubscriptionSet::MutableSubscriptionSet(std::weak_ptr<const SubscriptionS
     , m_obj(std::move(obj))
     , m_old_state(state())
 {
+    // Never modify the subscriptions shared with other sets
+    m_subs = std::make_shared<std::vector<Subscription>>(*m_subs);
 }
 
 void MutableSubscriptionSet::check_is_mutable() const
@@ -233,31 +255,31 @@ void MutableSubscriptionSet::check_is_mutable() const
 
 MutableSubscriptionSet::iterator MutableSubscriptionSet::begin()
 {
-    return m_subs.begin();
+    return m_subs->begin();
 }
 
 MutableSubscriptionSet::iterator MutableSubscriptionSet::end()
 {
-    return m_subs.end();
+    return m_subs->end();
 }
 
 MutableSubscriptionSet::iterator MutableSubscriptionSet::erase(const_iterator it)
 {
     check_is_mutable();
     REALM_ASSERT(it != end());
-    return m_subs.erase(it);
+    return m_subs->erase(it);
 }
 
 void MutableSubscriptionSet::clear()
 {
     check_is_mutable();
-    m_subs.clear();
+    m_subs->clear();
 }
 
 void MutableSubscriptionSet::insert_sub(const Subscription& sub)
 {
     check_is_mutable();
-    m_subs.push_back(sub);
+    m_subs->push_back(sub);
 }
 
 std::pair<SubscriptionSet::iterator, bool>
@@ -272,7 +294,7 @@ MutableSubscriptionSet::insert_or_assign_impl(iterator it, util::Optional<std::s
 
         return {it, false};
     }
-    it = m_subs.insert(m_subs.end(),
+    it = m_subs->insert(m_subs->end(),
                        Subscription(std::move(name), std::move(object_class_name), std::move(query_str)));
 
     return {it, true};
@@ -475,7 +497,7 @@ SubscriptionSet MutableSubscriptionSet::commit() &&
 
         auto obj_sub_list = m_obj.get_linklist(mgr->m_sub_set_subscriptions);
         obj_sub_list.clear();
-        for (const auto& sub : m_subs) {
+        for (const auto& sub : *m_subs) {
             auto new_sub =
                 obj_sub_list.create_and_insert_linked_object(obj_sub_list.is_empty() ? 0 : obj_sub_list.size());
             new_sub.set(mgr->m_sub_id, sub.id());
@@ -507,7 +529,7 @@ SubscriptionSet MutableSubscriptionSet::commit() &&
 
 std::string SubscriptionSet::to_ext_json() const
 {
-    if (m_subs.empty()) {
+    if (m_subs->empty()) {
         return "{}";
     }
 
@@ -767,6 +789,20 @@ SubscriptionStore::TableSet SubscriptionStore::get_tables_for_latest(const Trans
     auto latest_id = sub_sets->maximum_int(sub_sets->get_primary_key_column());
     auto latest_obj = sub_sets->get_object_with_primary_key(Mixed{latest_id});
 
+    // This is called at the start of every write transaction, so the tables
+    // of the latest set are cached rather than collected from all of its
+    // subscriptions every time. The subscriptions of a set are written once
+    // when it is committed and never change afterwards, so the version
+    // identifies the tables as long as the set is not still being built in
+    // `tr`.
+    bool is_committed =
+        latest_obj.get<int64_t>(m_sub_set_state) != static_cast<int64_t>(SubscriptionSet::State::Uncommitted);
+    if (is_committed) {
+        std::lock_guard<std::mutex> lk(m_cached_tables_mutex);
+        if (m_cached_tables_version == latest_id)
+            return m_cached_tables;
+    }
+
     TableSet ret;
     auto subs = latest_obj.get_linklist(m_sub_set_subscriptions);
     for (size_t idx = 0; idx < subs.size(); ++idx) {
@@ -774,6 +810,11 @@ SubscriptionStore::TableSet SubscriptionStore::get_tables_for_latest(const Trans
         ret.emplace(sub_obj.get<StringData>(m_sub_object_class_name));
     }
 
+    if (is_committed) {
+        std::lock_guard<std::mutex> lk(m_cached_tables_mutex);
+        m_cached_tables_version = latest_id;
+        m_cached_tables = ret;
+    }
     return ret;
 }
 
@@ -783,6 +824,9 @@ void SubscriptionStore::supercede_prior_to(TransactionRef tr, int64_t version_id
     Query remove_query(sub_sets);
     remove_query.less(sub_sets->get_primary_key_column(), version_id);
     remove_query.remove();
+
+    std::lock_guard<std::mutex> lk(m_cached_subs_mutex);
+    m_cached_subs.erase(m_cached_subs.begin(), m_cached_subs.lower_bound(version_id));
 }
 
 void SubscriptionStore::supercede_all_except(MutableSubscriptionSet& mut_sub) const
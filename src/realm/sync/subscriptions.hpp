@@ -28,6 +28,8 @@
 #include "realm/util/optional.hpp"
 
 #include <list>
+#include <map>
+#include <memory>
 #include <set>
 #include <string_view>
 
@@ -209,7 +211,10 @@ protected:
     State m_state = State::Uncommitted;
     std::string m_error_str;
     DB::version_type m_snapshot_version = -1;
-    std::vector<Subscription> m_subs;
+    // The subscriptions of a committed set never change, so they are shared
+    // between the copies of the set and with the cache in the store.
+    // MutableSubscriptionSet always has its own copy.
+    std::shared_ptr<std::vector<Subscription>> m_subs = std::make_shared<std::vector<Subscription>>();
 };
 
 class MutableSubscriptionSet : public SubscriptionSet {
@@ -395,6 +400,17 @@ protected:
     mutable int64_t m_outstanding_requests = 0;
     mutable int64_t m_min_outstanding_version = 0;
     mutable std::list<NotificationRequest> m_pending_notifications;
+
+    mutable std::mutex m_cached_tables_mutex;
+    mutable int64_t m_cached_tables_version = -1;
+    mutable TableSet m_cached_tables;
+
+    // The subscriptions of the committed sets by version, so that the sets
+    // returned by get_latest(), get_active() and get_by_version() do not
+    // have to read every subscription again. Entries are dropped when the
+    // set is superseded.
+    mutable std::mutex m_cached_subs_mutex;
+    mutable std::map<int64_t, std::shared_ptr<std::vector<Subscription>>> m_cached_subs;
 };
 
 } // namespace realm::sync
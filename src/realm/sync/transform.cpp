@@ -5,6 +5,7 @@
 #include <map>
 #include <sstream>
 #include <fstream>
+#include <thread>
 
 #if REALM_DEBUG
 #include <iostream> // std::cerr used for debug tracing
@@ -27,6 +28,7 @@
 #include <realm/sync/noinst/changeset_index.hpp>
 #include <realm/sync/noinst/protocol_codec.hpp>
 #include <realm/util/logger.hpp>
+#include <realm/util/thread_pool.hpp>
 
 namespace realm {
 
@@ -2437,6 +2439,11 @@ void TransformerImpl::merge_changesets(file_ident_type local_file_ident, Changes
                       their_index.get_num_conflict_groups());
     }
 
+    if (m_max_threads > 1 && !trace &&
+        merge_conflict_groups_concurrently(their_changesets, their_size, our_changesets, our_size, their_index,
+                                           logger)) // Throws
+        return;
+
 #if REALM_DEBUG // LCOV_EXCL_START
     if (trace) {
         std::cerr << TERM_YELLOW << "\n=> PEER " << std::hex << local_file_ident
@@ -2519,6 +2526,247 @@ void TransformerImpl::merge_changesets(file_ident_type local_file_ident, Changes
 #endif // LCOV_EXCL_STOP REALM_DEBUG
 }
 
+namespace {
+
+using Instruction = sync::Instruction;
+
+// A changeset with the same metadata and interned strings as `changeset`, to
+// which the instructions of one partition of conflict groups are copied.
+Changeset make_partition_changeset(const Changeset& changeset)
+{
+    Changeset partition;
+    partition.version = changeset.version;
+    partition.last_integrated_remote_version = changeset.last_integrated_remote_version;
+    partition.origin_timestamp = changeset.origin_timestamp;
+    partition.origin_file_ident = changeset.origin_file_ident;
+    partition.transform_sequence = changeset.transform_sequence;
+    partition.string_buffer() = changeset.string_buffer();
+    partition.interned_strings() = changeset.interned_strings();
+    return partition;
+}
+
+// The merge may intern strings adopted from the other side into the partition
+// copy of a changeset. Those have to be interned again in the original
+// changeset when the instructions are copied back.
+struct AdoptPartitionStrings {
+    const Changeset& from;
+    Changeset& to;
+    size_t num_shared_strings;
+
+    void adopt(InternString& string)
+    {
+        if (string != InternString::npos && string.value >= num_shared_strings)
+            string = to.intern_string(from.get_string(string)); // Throws
+    }
+
+    void adopt(Instruction::PrimaryKey& key)
+    {
+        if (auto string = mpark::get_if<InternString>(&key))
+            adopt(*string);
+    }
+
+    void adopt(Instruction::Payload& payload)
+    {
+        if (payload.type == Instruction::Payload::Type::Link) {
+            adopt(payload.data.link.target_table);
+            adopt(payload.data.link.target);
+        }
+    }
+
+    void operator()(Instruction& instr)
+    {
+        instr.visit([&](auto& i) {
+            using T = std::decay_t<decltype(i)>;
+            if constexpr (std::is_base_of_v<Instruction::TableInstruction, T>)
+                adopt(i.table);
+            if constexpr (std::is_base_of_v<Instruction::ObjectInstruction, T>)
+                adopt(i.object);
+            if constexpr (std::is_base_of_v<Instruction::PathInstruction, T>) {
+                adopt(i.field);
+                for (auto& element : i.path.m_path) {
+                    if (auto string = mpark::get_if<InternString>(&element))
+                        adopt(*string);
+                }
+            }
+            if constexpr (std::is_same_v<T, Instruction::Update> || std::is_same_v<T, Instruction::ArrayInsert> ||
+                          std::is_same_v<T, Instruction::SetInsert> || std::is_same_v<T, Instruction::SetErase>)
+                adopt(i.value);
+        });
+    }
+};
+
+} // unnamed namespace
+
+void TransformerImpl::merge_partition(Changeset* their_changesets, size_t their_size, Changeset** our_changesets,
+                                      size_t our_size)
+{
+    Transformer transformer{false};
+    _impl::ChangesetIndex their_index;
+    for (size_t i = 0; i < their_size; ++i)
+        their_index.scan_changeset(their_changesets[i]);
+    for (size_t i = 0; i < our_size; ++i)
+        their_index.scan_changeset(*our_changesets[i]);
+    for (size_t i = 0; i < their_size; ++i)
+        their_index.add_changeset(their_changesets[i]);
+
+    for (size_t i = 0; i < our_size; ++i) {
+        transformer.m_major_side.set_next_changeset(our_changesets[i]);
+        transformer.m_minor_side.m_changeset_index = &their_index;
+        transformer.transform(); // Throws
+    }
+}
+
+bool TransformerImpl::merge_conflict_groups_concurrently(Changeset* their_changesets, size_t their_size,
+                                                         Changeset** our_changesets, size_t our_size,
+                                                         ChangesetIndex& their_index, util::Logger* logger)
+{
+    // Assign every instruction to its conflict group, numbering the groups in
+    // order of first appearance. Schema changes conflict with everything, so
+    // their presence on either side rules out splitting the merge.
+    std::vector<Changeset*> changesets;
+    changesets.reserve(their_size + our_size);
+    for (size_t i = 0; i < their_size; ++i)
+        changesets.push_back(&their_changesets[i]);
+    for (size_t i = 0; i < our_size; ++i)
+        changesets.push_back(our_changesets[i]);
+
+    std::map<const ChangesetIndex::Ranges*, size_t> group_numbers;
+    std::vector<std::vector<size_t>> instruction_groups(changesets.size());
+    std::vector<size_t> their_counts, our_counts;
+    for (size_t i = 0; i < changesets.size(); ++i) {
+        bool is_theirs = i < their_size;
+        for (auto instr : *changesets[i]) {
+            if (!instr)
+                continue;
+            if (is_schema_change(*instr))
+                return false;
+            ChangesetIndex::GlobalID ids[2];
+            get_object_ids_in_instruction(*changesets[i], *instr, ids, 2);
+            auto ranges = their_index.get_modifications_for_object(ids[0]);
+            auto [it, inserted] = group_numbers.emplace(ranges, group_numbers.size());
+            if (inserted) {
+                their_counts.push_back(0);
+                our_counts.push_back(0);
+            }
+            ++(is_theirs ? their_counts : our_counts)[it->second];
+            instruction_groups[i].push_back(it->second);
+        }
+    }
+
+    // Only groups with instructions on both sides need to be transformed.
+    // Distribute those over the partitions, largest first, so that the
+    // partitions end up with roughly the same number of instructions.
+    std::vector<size_t> merged_groups;
+    for (size_t group = 0; group < their_counts.size(); ++group) {
+        if (their_counts[group] && our_counts[group])
+            merged_groups.push_back(group);
+    }
+    if (merged_groups.size() < 2)
+        return false;
+
+    std::stable_sort(merged_groups.begin(), merged_groups.end(), [&](size_t a, size_t b) {
+        return their_counts[a] + our_counts[a] > their_counts[b] + our_counts[b];
+    });
+    size_t num_partitions = std::min(m_max_threads, merged_groups.size());
+    std::vector<size_t> partition_sizes(num_partitions, 0);
+    std::vector<size_t> group_partitions(their_counts.size(), realm::npos);
+    for (auto group : merged_groups) {
+        size_t partition = std::min_element(partition_sizes.begin(), partition_sizes.end()) - partition_sizes.begin();
+        group_partitions[group] = partition;
+        partition_sizes[partition] += their_counts[group] + our_counts[group];
+    }
+
+    // partitions[p][i] holds the instructions of changeset i which belong to
+    // partition p. Every changeset is represented in every partition (if only
+    // by an empty changeset) to keep the versions seen by the merge intact.
+    std::vector<std::vector<Changeset>> partitions(num_partitions);
+    for (auto& partition : partitions) {
+        partition.reserve(changesets.size());
+        for (auto changeset : changesets)
+            partition.push_back(make_partition_changeset(*changeset));
+    }
+    for (size_t i = 0; i < changesets.size(); ++i) {
+        size_t ndx = 0;
+        for (auto instr : *changesets[i]) {
+            if (!instr)
+                continue;
+            size_t partition = group_partitions[instruction_groups[i][ndx++]];
+            if (partition != realm::npos)
+                partitions[partition][i].push_back(*instr);
+        }
+    }
+
+    util::ThreadPool::get_default().run_parallel(num_partitions, [&](size_t p) {
+        std::vector<Changeset*> ours;
+        ours.reserve(our_size);
+        for (size_t i = 0; i < our_size; ++i)
+            ours.push_back(&partitions[p][their_size + i]);
+        merge_partition(partitions[p].data(), their_size, ours.data(), our_size); // Throws
+    }); // Throws
+
+    // Copy the transformed instructions back. The merge only inserts and
+    // erases instructions in a stable manner, so the instructions which took
+    // the place of the n'th instruction of a partition are found in the n'th
+    // slot of the partition changeset, and go where that instruction was in
+    // the original changeset. This reproduces the order of a merge on a single
+    // thread.
+    for (size_t i = 0; i < changesets.size(); ++i) {
+        Changeset& changeset = *changesets[i];
+        bool is_dirty = std::any_of(partitions.begin(), partitions.end(), [&](auto& partition) {
+            return partition[i].is_dirty();
+        });
+        if (!is_dirty)
+            continue;
+
+        size_t num_shared_strings = changeset.interned_strings().size();
+        std::vector<std::vector<std::vector<const sync::Instruction*>>> slots(num_partitions);
+        for (size_t p = 0; p < num_partitions; ++p) {
+            Changeset& partition = partitions[p][i];
+            auto first = partition.begin().m_inner;
+            for (auto it = partition.begin(); it != partition.end(); ++it) {
+                size_t slot = size_t(it.m_inner - first);
+                if (slots[p].size() <= slot)
+                    slots[p].resize(slot + 1);
+                if (auto instr = *it)
+                    slots[p][slot].push_back(instr);
+            }
+        }
+
+        std::vector<sync::Instruction> instructions;
+        instructions.reserve(changeset.size());
+        std::vector<size_t> next_slot(num_partitions, 0);
+        size_t ndx = 0;
+        for (auto instr : changeset) {
+            if (!instr)
+                continue;
+            size_t p = group_partitions[instruction_groups[i][ndx++]];
+            if (p == realm::npos) {
+                instructions.push_back(*instr);
+                continue;
+            }
+            size_t slot = next_slot[p]++;
+            if (slot >= slots[p].size())
+                continue;
+            AdoptPartitionStrings adopt{partitions[p][i], changeset, num_shared_strings};
+            for (auto transformed : slots[p][slot]) {
+                instructions.push_back(*transformed);
+                adopt(instructions.back()); // Throws
+            }
+        }
+
+        changeset.clear();
+        for (auto& instr : instructions)
+            changeset.push_back(instr);
+        changeset.set_dirty(true);
+    }
+
+    if (logger) {
+        logger->debug("Transformed %1 conflict groups in %2 partitions concurrently", merged_groups.size(),
+                      num_partitions);
+    }
+    return true;
+}
+
 void TransformerImpl::transform_remote_changesets(TransformHistory& history, file_ident_type local_file_ident,
                                                   version_type current_local_version,
                                                   util::Span<Changeset> parsed_changesets, util::Logger* logger)
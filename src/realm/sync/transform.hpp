@@ -173,6 +173,16 @@ public:
                                              version_type current_local_version, util::Span<Changeset> changesets,
                                              util::Logger* = nullptr) = 0;
 
+    /// Allow transform_remote_changesets() to use up to \a max_threads threads.
+    ///
+    /// When this is greater than one, and neither side of a merge contains
+    /// schema changes, the instructions are partitioned by conflict group (see
+    /// `_impl::ChangesetIndex`), and the partitions are transformed
+    /// concurrently. Conflict groups never interact during a merge, so the
+    /// outcome is the same as when transforming on a single thread, and does
+    /// not depend on the number of threads.
+    virtual void set_max_threads(std::size_t max_threads) noexcept = 0;
+
     virtual ~Transformer() noexcept {}
 };
 
@@ -183,6 +193,8 @@ std::unique_ptr<Transformer> make_transformer();
 
 namespace _impl {
 
+struct ChangesetIndex;
+
 class TransformerImpl : public sync::Transformer {
 public:
     using Changeset = sync::Changeset;
@@ -197,6 +209,11 @@ public:
     void transform_remote_changesets(TransformHistory&, file_ident_type, version_type, util::Span<Changeset>,
                                      util::Logger*) override;
 
+    void set_max_threads(std::size_t max_threads) noexcept override
+    {
+        m_max_threads = max_threads;
+    }
+
     struct Side;
     struct MajorSide;
     struct MinorSide;
@@ -210,6 +227,7 @@ protected:
 
 private:
     std::map<version_type, Changeset> m_reciprocal_transform_cache;
+    std::size_t m_max_threads = 1;
 
     TransactLogParser m_changeset_parser;
 
@@ -223,6 +241,12 @@ private:
 
     template <class LeftSide, class RightSide>
     void merge_instructions(LeftSide&, RightSide&);
+
+    bool merge_conflict_groups_concurrently(Changeset* their_changesets, std::size_t their_size,
+                                            Changeset** our_changesets, std::size_t our_size,
+                                            ChangesetIndex& their_index, util::Logger* logger);
+    static void merge_partition(Changeset* their_changesets, std::size_t their_size, Changeset** our_changesets,
+                                std::size_t our_size);
 };
 
 } // namespace _impl
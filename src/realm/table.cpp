@@ -16,6 +16,9 @@
  *
  **************************************************************************/
 
+#include <deque>
+#include <functional>
+#include <numeric>
 #include <stdexcept>
 
 #ifdef REALM_DEBUG
@@ -25,12 +28,14 @@
 
 #include <realm/util/features.h>
 #include <realm/util/miscellaneous.hpp>
+#include <realm/util/scope_exit.hpp>
 #include <realm/util/serializer.hpp>
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/table.hpp>
 #include <realm/alloc_slab.hpp>
 #include <realm/index_string.hpp>
+#include <realm/index_fulltext.hpp>
 #include <realm/db.hpp>
 #include <realm/replication.hpp>
 #include <realm/table_view.hpp>
@@ -41,6 +46,8 @@
 #include <realm/array_timestamp.hpp>
 #include <realm/array_decimal128.hpp>
 #include <realm/array_fixed_bytes.hpp>
+#include <realm/array_key.hpp>
+#include <realm/array_mixed.hpp>
 #include <realm/table_tpl.hpp>
 #include <realm/dictionary.hpp>
 
@@ -521,11 +528,37 @@ void Table::remove_recursive(CascadeState& cascade_state)
         cascade_state.m_to_be_nullified.clear();
 
         auto to_delete = std::move(cascade_state.m_to_be_deleted);
-        for (auto obj : to_delete) {
-            auto table = group->get_table(obj.first);
-            // This might add to the list of objects that should be deleted
-            REALM_ASSERT(!obj.second.is_unresolved());
-            table->m_clusters.erase(obj.second, cascade_state);
+        // The links between the objects have been nullified, so they can be
+        // erased in any order. Erase them table by table, each from the
+        // highest key down as remove_objects() does, so that the embedded
+        // objects of many parents go away leaf by leaf.
+        std::sort(to_delete.begin(), to_delete.end(), std::greater<>());
+        for (auto it = to_delete.begin(); it != to_delete.end();) {
+            TableKey table_key = it->first;
+            auto end = std::find_if(it, to_delete.end(), [&](auto& obj) {
+                return obj.first != table_key;
+            });
+            auto table = group->get_table(table_key);
+            bool rebuild_indexes = !table->m_defer_index_erase && size_t(end - it) * 2 > table->size() &&
+                                   std::any_of(table->m_index_accessors.begin(), table->m_index_accessors.end(),
+                                               [](auto& index) {
+                                                   return bool(index);
+                                               });
+            if (rebuild_indexes)
+                table->m_defer_index_erase = true;
+            auto reset = util::make_scope_exit([&]() noexcept {
+                if (rebuild_indexes)
+                    table->m_defer_index_erase = false;
+            });
+            for (; it != end; ++it) {
+                // This might add to the list of objects that should be deleted
+                REALM_ASSERT(!it->second.is_unresolved());
+                table->m_clusters.erase(it->second, cascade_state);
+            }
+            if (rebuild_indexes) {
+                table->m_defer_index_erase = false;
+                table->rebuild_search_indexes();
+            }
         }
         nullify_links(cascade_state);
     } while (!cascade_state.m_to_be_deleted.empty() || !cascade_state.m_to_be_nullified.empty());
@@ -555,6 +588,9 @@ void Table::remove_column(ColKey col_key)
     else {
         REALM_ASSERT_RELEASE(m_primary_key_col.get_index().val != col_key.get_index().val);
     }
+    if (col_key == m_modification_version_col) {
+        set_modification_version_column(ColKey());
+    }
 
     erase_root_column(col_key); // Throws
     m_has_any_embedded_objects.reset();
@@ -612,6 +648,8 @@ void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bo
         m_top.set_as_ref(top_position_for_cluster_tree, mem.get_ref());
     }
     m_clusters.init_from_parent();
+    // Frozen tables may be read from several threads at once
+    m_clusters.set_leaf_cache_enabled(!is_frzn);
 
     RefOrTagged rot = m_top.get_as_ref_or_tagged(top_position_for_key);
     if (!rot.is_tagged()) {
@@ -653,17 +691,20 @@ void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bo
     }
     else
         m_in_file_version_at_transaction_boundary = rot_version.get_as_int();
+    drop_leaf_summaries();
 
     auto rot_pk_key = m_top.get_as_ref_or_tagged(top_position_for_pk_col);
     m_primary_key_col = rot_pk_key.is_tagged() ? ColKey(rot_pk_key.get_as_int()) : ColKey();
+    init_primary_key_cache();
+    init_modification_version_column();
 
-    if (m_top.size() <= top_position_for_flags) {
-        m_table_type = Type::TopLevel;
-    }
-    else {
-        uint64_t flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
-        m_table_type = Type(flags & table_type_mask);
+    uint64_t flags = 0;
+    if (m_top.size() > top_position_for_flags) {
+        auto rot_flags = m_top.get_as_ref_or_tagged(top_position_for_flags);
+        if (rot_flags.is_tagged())
+            flags = rot_flags.get_as_int();
     }
+    m_table_type = Type(flags & table_type_mask);
     m_has_any_embedded_objects.reset();
 
     if (m_top.size() > top_position_for_tombstones && m_top.get_as_ref(top_position_for_tombstones)) {
@@ -676,6 +717,7 @@ void Table::init(ref_type top_ref, ArrayParent* parent, size_t ndx_in_parent, bo
     else {
         m_tombstones = nullptr;
     }
+    init_node_sizes(flags);
     m_cookie = cookie_initialized;
 }
 
@@ -706,70 +748,50 @@ void Table::populate_search_index(ColKey col_key)
 {
     auto col_ndx = col_key.get_index().val;
     StringIndex* index = m_index_accessors[col_ndx].get();
+    REALM_ASSERT_RELEASE(StringIndex::type_supported(get_column_type(col_key)) &&
+                         "Data type does not support search index");
+
+    // The values are inserted in batches sorted by value rather than in the
+    // order of the objects, so that consecutive insertions follow the same
+    // path through the index and mostly append to its nodes. Strings are
+    // copied, as the batch outlives the leaves they are read from.
+    constexpr size_t batch_size = 0x10000;
+    std::vector<std::pair<Mixed, ObjKey>> batch;
+    std::deque<std::string> strings;
+    batch.reserve(std::min(batch_size, size()));
+
+    auto insert_batch = [&] {
+        std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+            int cmp = a.first.compare(b.first);
+            return cmp < 0 || (cmp == 0 && a.second < b.second);
+        });
+        for (auto& [value, key] : batch)
+            index->insert(key, value); // Throws
+        batch.clear();
+        strings.clear();
+    };
 
-    // Insert ref to index
     for (auto o : *this) {
-        ObjKey key = o.get_key();
-        DataType type = get_column_type(col_key);
-
-        if (type == type_Int) {
-            if (is_nullable(col_key)) {
-                Optional<int64_t> value = o.get<Optional<int64_t>>(col_key);
-                index->insert(key, value); // Throws
-            }
-            else {
-                int64_t value = o.get<int64_t>(col_key);
-                index->insert(key, value); // Throws
-            }
-        }
-        else if (type == type_Bool) {
-            if (is_nullable(col_key)) {
-                Optional<bool> value = o.get<Optional<bool>>(col_key);
-                index->insert(key, value); // Throws
-            }
-            else {
-                bool value = o.get<bool>(col_key);
-                index->insert(key, value); // Throws
-            }
-        }
-        else if (type == type_String) {
-            StringData value = o.get<StringData>(col_key);
-            index->insert(key, value); // Throws
+        Mixed value = o.get_any(col_key);
+        if (value.is_type(type_String)) {
+            StringData str = value.get_string();
+            value = StringData(strings.emplace_back(str.data(), str.size()));
         }
-        else if (type == type_Timestamp) {
-            Timestamp value = o.get<Timestamp>(col_key);
-            index->insert(key, value); // Throws
-        }
-        else if (type == type_ObjectId) {
-            if (is_nullable(col_key)) {
-                Optional<ObjectId> value = o.get<Optional<ObjectId>>(col_key);
-                index->insert(key, value); // Throws
-            }
-            else {
-                ObjectId value = o.get<ObjectId>(col_key);
-                index->insert(key, value); // Throws
-            }
-        }
-        else if (type == type_UUID) {
-            if (is_nullable(col_key)) {
-                Optional<UUID> value = o.get<Optional<UUID>>(col_key);
-                index->insert(key, value); // Throws
-            }
-            else {
-                UUID value = o.get<UUID>(col_key);
-                index->insert(key, value); // Throws
-            }
-        }
-        else {
-            REALM_ASSERT_RELEASE(false && "Data type does not support search index");
+        else if (value.is_type(type_Binary)) {
+            BinaryData bin = value.get_binary();
+            value = BinaryData(strings.emplace_back(bin.data(), bin.size()));
         }
+        batch.emplace_back(value, o.get_key());
+        if (batch.size() == batch_size)
+            insert_batch();
     }
+    insert_batch();
 }
 
 void Table::erase_from_search_indexes(ObjKey key)
 {
     // Tombstones do not use index - will crash if we try to erase values
-    if (!key.is_unresolved()) {
+    if (!key.is_unresolved() && !m_defer_index_erase) {
         for (auto&& index : m_index_accessors) {
             if (index) {
                 index->erase(key);
@@ -797,71 +819,96 @@ void Table::update_indexes(ObjKey key, const FieldValues& values)
             ++value;
         }
 
-        if (auto&& index = m_index_accessors[column_ndx]) {
+        if (m_index_accessors[column_ndx]) {
             // There is an index for this column
-            auto col_key = m_leaf_ndx2colkey[column_ndx];
-            auto type = col_key.get_type();
-            auto attr = col_key.get_attrs();
-            bool nullable = attr.test(col_attr_Nullable);
-            switch (type) {
-                case col_type_Int:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayIntNull::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<int64_t>());
-                    }
-                    break;
-                case col_type_Bool:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayBoolNull::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<bool>());
-                    }
-                    break;
-                case col_type_String:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayString::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<String>());
-                    }
-                    break;
-                case col_type_Timestamp:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayTimestamp::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<Timestamp>());
-                    }
-                    break;
-                case col_type_ObjectId:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayObjectIdNull::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<ObjectId>());
-                    }
-                    break;
-                case col_type_Mixed:
-                    index->insert(key, init_value);
-                    break;
-                case col_type_UUID:
-                    if (init_value.is_null()) {
-                        index->insert(key, ArrayUUIDNull::default_value(nullable));
-                    }
-                    else {
-                        index->insert(key, init_value.get<UUID>());
-                    }
-                    break;
-                default:
-                    REALM_UNREACHABLE();
-            }
+            insert_into_index(column_ndx, key, init_value);
         }
     }
 }
 
+void Table::insert_into_index(size_t column_ndx, ObjKey key, Mixed init_value)
+{
+    auto& index = m_index_accessors[column_ndx];
+    auto col_key = m_leaf_ndx2colkey[column_ndx];
+    auto type = col_key.get_type();
+    auto attr = col_key.get_attrs();
+    bool nullable = attr.test(col_attr_Nullable);
+    switch (type) {
+        case col_type_Int:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayIntNull::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<int64_t>());
+            }
+            break;
+        case col_type_Bool:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayBoolNull::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<bool>());
+            }
+            break;
+        case col_type_String:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayString::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<String>());
+            }
+            break;
+        case col_type_Timestamp:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayTimestamp::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<Timestamp>());
+            }
+            break;
+        case col_type_ObjectId:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayObjectIdNull::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<ObjectId>());
+            }
+            break;
+        case col_type_Mixed:
+            index->insert(key, init_value);
+            break;
+        case col_type_UUID:
+            if (init_value.is_null()) {
+                index->insert(key, ArrayUUIDNull::default_value(nullable));
+            }
+            else {
+                index->insert(key, init_value.get<UUID>());
+            }
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+void Table::rebuild_search_indexes()
+{
+    std::vector<std::pair<Mixed, ObjKey>> entries;
+    for (size_t column_ndx = 0; column_ndx < m_index_accessors.size(); ++column_ndx) {
+        auto& index = m_index_accessors[column_ndx];
+        if (!index)
+            continue;
+        index->clear();
+        auto col_key = m_leaf_ndx2colkey[column_ndx];
+        entries.clear();
+        entries.reserve(size());
+        for (auto o : *this)
+            entries.emplace_back(o.get_any(col_key), o.get_key());
+        std::sort(entries.begin(), entries.end());
+        for (auto& [value, key] : entries)
+            insert_into_index(column_ndx, key, value);
+    }
+}
+
 void Table::clear_indexes()
 {
     for (auto&& index : m_index_accessors) {
@@ -945,6 +992,39 @@ void Table::remove_search_index(ColKey col_key)
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
+void Table::set_compressed(ColKey col_key, bool compressed)
+{
+    check_column(col_key);
+    auto type = col_key.get_type();
+    if ((type != col_type_String && type != col_type_Binary) || col_key.is_collection())
+        throw LogicError(LogicError::illegal_type);
+    // Older versions cannot read compressed values, see DBOptions::enable_value_compression
+    if (compressed && !m_alloc.is_encoding_enabled(Allocator::encoding_CompressedValues))
+        throw LogicError(LogicError::illegal_combination);
+
+    auto spec_ndx = leaf_ndx2spec_ndx(col_key.get_index());
+    auto attr = m_spec.get_column_attr(spec_ndx);
+    if (attr.test(col_attr_Compressed) == compressed)
+        return;
+
+    if (compressed)
+        attr.set(col_attr_Compressed);
+    else
+        attr.reset(col_attr_Compressed);
+    m_spec.set_column_attr(spec_ndx, attr); // Throws
+
+    if (Replication* repl = get_repl())
+        repl->set_compressed(this, col_key, compressed); // Throws
+}
+
+bool Table::is_compressed(ColKey col_key) const noexcept
+{
+    if (!valid_column(col_key))
+        return false;
+    auto spec_ndx = leaf_ndx2spec_ndx(col_key.get_index());
+    return m_spec.get_column_attr(spec_ndx).test(col_attr_Compressed);
+}
+
 void Table::enumerate_string_column(ColKey col_key)
 {
     check_column(col_key);
@@ -1144,6 +1224,50 @@ void Table::do_set_table_type(Type table_type)
     m_table_type = table_type;
 }
 
+void Table::set_node_sizes(size_t cluster_node_size, size_t collection_node_size)
+{
+    if (cluster_node_size == 0)
+        cluster_node_size = ClusterNode::default_cluster_node_size;
+    if (collection_node_size == 0)
+        collection_node_size = REALM_MAX_BPNODE_SIZE;
+    for (size_t sz : {cluster_node_size, collection_node_size}) {
+        if (sz < min_node_size || sz > max_node_size)
+            throw std::invalid_argument(
+                util::format("Node size %1 is not between %2 and %3", sz, min_node_size, max_node_size));
+    }
+    if (size() > 0 || (m_tombstones && m_tombstones->size() > 0)) {
+        throw std::logic_error(util::format("Cannot change the node sizes of '%1' as it is not empty.", get_name()));
+    }
+
+    while (m_top.size() <= top_position_for_flags)
+        m_top.add(0);
+
+    uint64_t flags = m_top.get_as_ref_or_tagged(top_position_for_flags).get_as_int();
+    // reset bits 8-39
+    flags &= ~(uint64_t(0xffffffff) << flags_shift_for_cluster_node_size);
+    if (cluster_node_size != ClusterNode::default_cluster_node_size)
+        flags |= uint64_t(cluster_node_size) << flags_shift_for_cluster_node_size;
+    if (collection_node_size != REALM_MAX_BPNODE_SIZE)
+        flags |= uint64_t(collection_node_size) << flags_shift_for_collection_node_size;
+    m_top.set(top_position_for_flags, RefOrTagged::make_tagged(flags));
+    init_node_sizes(flags);
+}
+
+void Table::init_node_sizes(uint64_t flags) noexcept
+{
+    size_t cluster_node_size = size_t(flags >> flags_shift_for_cluster_node_size) & max_node_size;
+    size_t collection_node_size = size_t(flags >> flags_shift_for_collection_node_size) & max_node_size;
+    if (cluster_node_size < min_node_size)
+        cluster_node_size = ClusterNode::default_cluster_node_size;
+    if (collection_node_size < min_node_size)
+        collection_node_size = REALM_MAX_BPNODE_SIZE;
+
+    m_clusters.set_max_node_size(cluster_node_size);
+    if (m_tombstones)
+        m_tombstones->set_max_node_size(cluster_node_size);
+    m_collection_node_size = collection_node_size;
+}
+
 
 void Table::detach(LifeCycleCookie cookie) noexcept
 {
@@ -1183,6 +1307,42 @@ bool Table::has_search_index(ColKey col_key) const noexcept
     return m_index_accessors[col_key.get_index().val] != nullptr;
 }
 
+std::shared_ptr<const FulltextIndex> Table::get_fulltext_index(ColKey col_key) const
+{
+    check_column(col_key);
+    if (col_key.get_type() != col_type_String || col_key.is_collection())
+        throw LogicError(LogicError::illegal_type);
+
+    uint_fast64_t version = get_content_version();
+    std::lock_guard<std::mutex> lock(m_fulltext_mutex);
+    auto& entry = m_fulltext_indexes[col_key];
+    if (!entry.second || entry.first != version) {
+        entry.second.reset(); // Release the old index before building the new one
+        entry.second = std::make_shared<FulltextIndex>(*this, col_key);
+        entry.first = version;
+    }
+    return entry.second;
+}
+
+size_t Table::release_caches() const
+{
+    size_t freed = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_fulltext_mutex);
+        for (auto& [col_key, entry] : m_fulltext_indexes) {
+            if (entry.second && entry.second.use_count() == 1)
+                freed += entry.second->memory_usage();
+        }
+        m_fulltext_indexes.clear();
+    }
+    // Frozen tables may be searched by other threads at the same time
+    if (!m_is_frozen && m_primary_key_cache) {
+        m_primary_key_cache.reset();
+        freed += s_primary_key_cache_size * sizeof(std::atomic<int64_t>);
+    }
+    return freed;
+}
+
 void Table::migrate_column_info()
 {
     bool changes = false;
@@ -1548,8 +1708,9 @@ void Table::create_columns()
     }
 }
 
-bool Table::migrate_objects()
+bool Table::migrate_objects(bool& no_links, size_t max_objects)
 {
+    no_links = true;
     size_t nb_public_columns = m_spec.get_public_column_count();
     size_t nb_columns = m_spec.get_column_count();
     if (!nb_columns) {
@@ -1685,10 +1846,14 @@ bool Table::migrate_objects()
     }
 
     REALM_ASSERT(number_of_objects != size_t(-1));
+    no_links = !has_link_columns;
 
-    if (m_clusters.size() == number_of_objects) {
+    // Objects are created in row order, and each chunk is committed along with
+    // the objects it created, so an interrupted migration continues from here.
+    size_t begin = m_clusters.size();
+    if (begin == number_of_objects) {
         // We have migrated all objects
-        return !has_link_columns;
+        return true;
     }
 
     // !OID column must not be present. Such columns are only present in syncked
@@ -1697,7 +1862,8 @@ bool Table::migrate_objects()
 
     /*************************** Create objects ******************************/
 
-    for (size_t row_ndx = 0; row_ndx < number_of_objects; row_ndx++) {
+    size_t end = number_of_objects - begin > max_objects ? begin + max_objects : number_of_objects;
+    for (size_t row_ndx = begin; row_ndx < end; row_ndx++) {
         // Build a vector of values obtained from the old columns
         FieldValues init_values;
         for (auto& it : column_accessors) {
@@ -1756,6 +1922,9 @@ bool Table::migrate_objects()
         }
     }
 
+    if (end < number_of_objects)
+        return false;
+
     // Destroy values in the old columns that has been copied.
     // This frees up space in the file
     for (auto ndx : cols_to_destroy) {
@@ -1772,16 +1941,19 @@ bool Table::migrate_objects()
         throw util::runtime_error("Upgrade interrupted");
     }
 #endif
-    return !has_link_columns;
+    return true;
 }
 
-void Table::migrate_links()
+size_t Table::migrate_links(size_t start, size_t max_objects)
 {
     ref_type top_ref = m_top.get_as_ref(top_position_for_columns);
     if (!top_ref) {
         // All objects migrated
-        return;
+        return npos;
     }
+    size_t nb_objects = size();
+    if (start >= nb_objects)
+        return npos;
 
     Array col_refs(m_alloc);
     col_refs.set_parent(&m_top, top_position_for_columns);
@@ -1809,7 +1981,11 @@ void Table::migrate_links()
     }
 
     auto orig_row_ndx_col_key = get_column_key("!ROW_INDEX");
-    for (auto obj : *this) {
+    size_t end = nb_objects - start > max_objects ? start + max_objects : nb_objects;
+    auto it = begin();
+    it.go(start);
+    for (size_t ndx = start; ndx < end; ++ndx, ++it) {
+        Obj& obj = *it;
         for (size_t col_ndx = 0; col_ndx < nb_columns; col_ndx++) {
             if (col_keys[col_ndx]) {
                 // If no !ROW_INDEX column is found, the original row index number is
@@ -1845,6 +2021,7 @@ void Table::migrate_links()
             }
         }
     }
+    return end < nb_objects ? end : npos;
 }
 
 void Table::finalize_migration(ColKey pk_col_key)
@@ -1988,6 +2165,7 @@ void Table::ensure_graveyard()
         m_top.set_as_ref(top_position_for_tombstones, mem.get_ref());
         m_tombstones = std::make_unique<TableClusterTree>(this, m_alloc, size_t(top_position_for_tombstones));
         m_tombstones->init_from_parent();
+        m_tombstones->set_max_node_size(m_clusters.get_max_node_size());
         for_each_and_every_column([ts = m_tombstones.get()](ColKey col) {
             ts->insert_column(col);
             return false;
@@ -1997,21 +2175,48 @@ void Table::ensure_graveyard()
 
 void Table::batch_erase_rows(const KeyColumn& keys)
 {
-    Group* g = get_parent_group();
-
     size_t num_objs = keys.size();
     std::vector<ObjKey> vec;
     vec.reserve(num_objs);
-    for (size_t i = 0; i < num_objs; ++i) {
-        ObjKey key = keys.get(i);
+    for (size_t i = 0; i < num_objs; ++i)
+        vec.push_back(keys.get(i));
+    remove_objects(vec);
+}
+
+void Table::remove_objects(const std::vector<ObjKey>& keys)
+{
+    Group* g = get_parent_group();
+
+    std::vector<ObjKey> vec;
+    vec.reserve(keys.size());
+    for (auto key : keys) {
         if (key != null_key && is_valid(key)) {
             vec.push_back(key);
         }
     }
     sort(vec.begin(), vec.end());
     vec.erase(unique(vec.begin(), vec.end()), vec.end());
+    if (vec.empty())
+        return;
 
-    if (has_any_embedded_objects() || (g && g->has_cascade_notification_handler())) {
+    bool notify = g && g->has_cascade_notification_handler();
+    if (vec.size() == size() && !notify) {
+        clear();
+        return;
+    }
+
+    // When most of the table goes away it is cheaper to rebuild the search
+    // indexes from the surviving objects than to erase one entry at a time
+    bool rebuild_indexes = vec.size() * 2 > size() &&
+                           std::any_of(m_index_accessors.begin(), m_index_accessors.end(), [](auto& index) {
+                               return bool(index);
+                           });
+    m_defer_index_erase = rebuild_indexes;
+    auto reset = util::make_scope_exit([&]() noexcept {
+        m_defer_index_erase = false;
+    });
+
+    if (has_any_embedded_objects() || notify) {
         CascadeState state(CascadeState::Mode::Strong, g);
         std::for_each(vec.begin(), vec.end(), [this, &state](ObjKey k) {
             state.m_to_be_deleted.emplace_back(m_key, k);
@@ -2021,15 +2226,26 @@ void Table::batch_erase_rows(const KeyColumn& keys)
     }
     else {
         CascadeState state(CascadeState::Mode::None, g);
-        for (auto k : vec) {
-            if (g) {
-                m_clusters.nullify_links(k, state);
+        // Nothing can link to objects in a table without backlink columns
+        bool has_backlinks = g && for_each_backlink_column([](ColKey) {
+                                 return true;
+                             });
+        // Erasing the highest key first removes objects from the end of each
+        // leaf, so a run of keys such as the oldest objects of an append-only
+        // table empties whole leaves without shifting the objects left in them
+        for (auto it = vec.rbegin(); it != vec.rend(); ++it) {
+            if (has_backlinks) {
+                m_clusters.nullify_links(*it, state);
             }
-            m_clusters.erase(k, state);
+            m_clusters.erase(*it, state);
         }
     }
-}
 
+    if (rebuild_indexes) {
+        m_defer_index_erase = false;
+        rebuild_search_indexes();
+    }
+}
 
 void Table::clear()
 {
@@ -2662,6 +2878,7 @@ void Table::update_from_parent() noexcept
             m_tombstones->update_from_parent();
 
         refresh_content_version();
+        init_modification_version_column();
         m_has_any_embedded_objects.reset();
     }
     m_alloc.bump_storage_version();
@@ -2756,6 +2973,243 @@ size_t Table::compute_aggregated_byte_size() const noexcept
     return stats_2.allocated;
 }
 
+namespace {
+
+size_t size_of_tree_from_ref(ref_type ref, Allocator& alloc)
+{
+    if (!ref)
+        return 0;
+    Array a(alloc);
+    a.init_from_ref(ref);
+    MemStats stats;
+    a.stats(stats);
+    return stats.allocated;
+}
+
+// Sums the sizes of the columns in every `interval`th leaf of a cluster tree
+class ClusterSizeCollector {
+public:
+    ClusterSizeCollector(Allocator& alloc, size_t num_columns, size_t interval)
+        : column_bytes(num_columns, 0)
+        , m_alloc(alloc)
+        , m_interval(interval)
+    {
+    }
+
+    void collect(ref_type ref)
+    {
+        Array node(m_alloc);
+        node.init_from_ref(ref);
+        if (node.is_inner_bptree_node()) {
+            // The inner nodes are always counted: key array, depth, size and
+            // then the children
+            inner_bytes += node.get_byte_size();
+            if (node.get_as_ref_or_tagged(0).is_ref())
+                inner_bytes += size_of_tree_from_ref(node.get_as_ref(0), m_alloc);
+            for (size_t i = 3; i < node.size(); ++i)
+                collect(node.get_as_ref(i));
+            return;
+        }
+
+        if (num_leaves++ % m_interval != 0)
+            return;
+        ++num_sampled_leaves;
+        leaf_bytes += node.get_byte_size();
+        if (node.get_as_ref_or_tagged(0).is_ref())
+            leaf_bytes += size_of_tree_from_ref(node.get_as_ref(0), m_alloc);
+        // Column i is at position i + 1, after the keys
+        for (size_t i = 1; i < node.size() && i <= column_bytes.size(); ++i) {
+            auto rot = node.get_as_ref_or_tagged(i);
+            if (rot.is_ref())
+                column_bytes[i - 1] += size_of_tree_from_ref(rot.get_as_ref(), m_alloc);
+        }
+    }
+
+    // Scale a size measured on the sampled leaves to all leaves
+    size_t extrapolate(size_t bytes) const
+    {
+        if (num_sampled_leaves == num_leaves)
+            return bytes;
+        return size_t(double(bytes) * double(num_leaves) / double(num_sampled_leaves));
+    }
+
+    size_t num_leaves = 0;
+    size_t num_sampled_leaves = 0;
+    size_t inner_bytes = 0;
+    size_t leaf_bytes = 0;
+    std::vector<size_t> column_bytes;
+
+private:
+    Allocator& m_alloc;
+    size_t m_interval;
+};
+
+} // anonymous namespace
+
+size_t StorageStats::Table::get_total_bytes() const noexcept
+{
+    size_t total = backlink_bytes + cluster_bytes + tombstone_bytes + metadata_bytes;
+    for (auto& column : columns)
+        total += column.payload_bytes + column.index_bytes;
+    return total;
+}
+
+StorageStats::Table Table::get_storage_stats(size_t sample_interval) const
+{
+    StorageStats::Table stats;
+    if (!m_top.is_attached())
+        return stats;
+    stats.key = m_key;
+    stats.name = get_name();
+    stats.num_objects = size();
+
+    // Everything hanging off the top array, except the objects and the
+    // search indexes, is bookkeeping
+    stats.metadata_bytes = m_top.get_byte_size();
+    for (size_t i = 0; i < m_top.size(); ++i) {
+        auto rot = m_top.get_as_ref_or_tagged(i);
+        if (!rot.is_ref() || !rot.get_as_ref())
+            continue;
+        switch (i) {
+            case top_position_for_cluster_tree:
+                break;
+            case top_position_for_tombstones:
+                stats.tombstone_bytes = size_of_tree_from_ref(rot.get_as_ref(), m_alloc);
+                break;
+            case top_position_for_search_indexes:
+                stats.metadata_bytes += m_index_refs.get_byte_size();
+                break;
+            default:
+                stats.metadata_bytes += size_of_tree_from_ref(rot.get_as_ref(), m_alloc);
+                break;
+        }
+    }
+
+    ClusterSizeCollector collector(m_alloc, m_leaf_ndx2colkey.size(), std::max<size_t>(sample_interval, 1));
+    if (ref_type root = m_top.get_as_ref(top_position_for_cluster_tree))
+        collector.collect(root);
+    stats.is_estimate = collector.num_sampled_leaves != collector.num_leaves;
+    stats.cluster_bytes = collector.inner_bytes + collector.extrapolate(collector.leaf_bytes);
+
+    for_each_and_every_column([&](ColKey col_key) {
+        size_t ndx = col_key.get_index().val;
+        size_t payload = collector.extrapolate(collector.column_bytes[ndx]);
+        if (col_key.get_type() == col_type_BackLink) {
+            stats.backlink_bytes += payload;
+            return false;
+        }
+        size_t index = 0;
+        if (ndx < m_index_refs.size())
+            index = size_of_tree_from_ref(m_index_refs.get_as_ref(ndx), m_alloc);
+        stats.columns.push_back({col_key, std::string(get_column_name(col_key)), payload, index});
+        return false;
+    });
+    return stats;
+}
+
+namespace {
+
+// Several independent accumulators, so that the loops can be vectorized
+// without reassociating floating point additions
+constexpr size_t distance_lanes = 8;
+
+float squared_l2_distance(const float* a, const float* b, size_t n) noexcept
+{
+    float sums[distance_lanes] = {};
+    size_t i = 0;
+    for (; i + distance_lanes <= n; i += distance_lanes) {
+        for (size_t j = 0; j < distance_lanes; ++j) {
+            float d = a[i + j] - b[i + j];
+            sums[j] += d * d;
+        }
+    }
+    for (; i < n; ++i) {
+        float d = a[i] - b[i];
+        sums[0] += d * d;
+    }
+    return std::accumulate(std::begin(sums), std::end(sums), 0.0f);
+}
+
+float dot_product(const float* a, const float* b, size_t n) noexcept
+{
+    float sums[distance_lanes] = {};
+    size_t i = 0;
+    for (; i + distance_lanes <= n; i += distance_lanes) {
+        for (size_t j = 0; j < distance_lanes; ++j)
+            sums[j] += a[i + j] * b[i + j];
+    }
+    for (; i < n; ++i)
+        sums[0] += a[i] * b[i];
+    return std::accumulate(std::begin(sums), std::end(sums), 0.0f);
+}
+
+} // anonymous namespace
+
+std::vector<Table::NearestMatch> Table::find_nearest(ColKey col_key, const std::vector<float>& target, size_t k,
+                                                     VectorDistance distance) const
+{
+    check_column(col_key);
+    if (col_key.get_type() != col_type_Float || !col_key.is_list() || col_key.is_nullable())
+        throw LogicError(LogicError::illegal_type);
+
+    const size_t dimensions = target.size();
+    std::vector<NearestMatch> matches;
+    if (k == 0 || dimensions == 0)
+        return matches;
+
+    double target_norm = 0;
+    if (distance == VectorDistance::Cosine) {
+        target_norm = std::sqrt(double(dot_product(target.data(), target.data(), dimensions)));
+        if (target_norm == 0)
+            return matches;
+    }
+
+    // Max-heap on distance of the k nearest objects found so far
+    auto further = [](const NearestMatch& a, const NearestMatch& b) {
+        return a.distance < b.distance;
+    };
+    matches.reserve(k + 1);
+    std::vector<float> values(dimensions);
+    ArrayInteger refs(m_alloc);
+    BPlusTree<float> list(m_alloc);
+    traverse_clusters([&](const Cluster* cluster) {
+        cluster->init_leaf(col_key, &refs);
+        for (size_t i = 0, size = cluster->node_size(); i < size; ++i) {
+            ref_type ref = to_ref(refs.get(i));
+            if (!ref)
+                continue;
+            list.init_from_ref(ref);
+            if (list.size() != dimensions)
+                continue;
+            list.get_range(0, dimensions, values.data());
+
+            double d;
+            if (distance == VectorDistance::L2) {
+                d = std::sqrt(double(squared_l2_distance(values.data(), target.data(), dimensions)));
+            }
+            else {
+                double norm = std::sqrt(double(dot_product(values.data(), values.data(), dimensions)));
+                if (norm == 0)
+                    continue;
+                d = 1 - double(dot_product(values.data(), target.data(), dimensions)) / (norm * target_norm);
+            }
+
+            if (matches.size() == k && d >= matches.front().distance)
+                continue;
+            matches.push_back({cluster->get_real_key(i), d});
+            std::push_heap(matches.begin(), matches.end(), further);
+            if (matches.size() > k) {
+                std::pop_heap(matches.begin(), matches.end(), further);
+                matches.pop_back();
+            }
+        }
+        return false; // Continue
+    });
+
+    std::sort_heap(matches.begin(), matches.end(), further);
+    return matches;
+}
+
 bool Table::operator==(const Table& t) const
 {
     if (size() != t.size()) {
@@ -2795,6 +3249,7 @@ void Table::flush_for_commit()
 {
     if (m_top.is_attached() && m_top.size() >= top_position_for_version) {
         if (!m_top.is_read_only()) {
+            drop_leaf_summaries();
             ++m_in_file_version_at_transaction_boundary;
             auto rot_version = RefOrTagged::make_tagged(m_in_file_version_at_transaction_boundary);
             m_top.set(top_position_for_version, rot_version);
@@ -2813,14 +3268,22 @@ void Table::refresh_content_version()
         if (m_in_file_version_at_transaction_boundary != rot_version.get_as_int()) {
             m_in_file_version_at_transaction_boundary = rot_version.get_as_int();
             bump_content_version();
+            drop_leaf_summaries();
         }
     }
     else {
         // assume the worst:
         bump_content_version();
+        drop_leaf_summaries();
     }
 }
 
+void Table::drop_leaf_summaries() const noexcept
+{
+    std::lock_guard lock(m_alloc.m_leaf_summary_cache_mutex);
+    m_alloc.m_leaf_summary_cache.reset();
+}
+
 
 // Called when Group is moved to another version - either a rollback or an advance.
 // The content of the table is potentially different, so make no assumptions.
@@ -2837,6 +3300,8 @@ void Table::refresh_accessor_tree()
     m_opposite_column.init_from_parent();
     auto rot_pk_key = m_top.get_as_ref_or_tagged(top_position_for_pk_col);
     m_primary_key_col = rot_pk_key.is_tagged() ? ColKey(rot_pk_key.get_as_int()) : ColKey();
+    init_primary_key_cache();
+    init_modification_version_column();
     if (m_top.size() > top_position_for_flags) {
         auto rot_flags = m_top.get_as_ref_or_tagged(top_position_for_flags);
         m_table_type = Type(rot_flags.get_as_int() & table_type_mask);
@@ -2998,6 +3463,30 @@ Obj Table::create_object(GlobalKey object_id, const FieldValues& values)
     }
 }
 
+Obj Table::create_asymmetric_object(const Mixed& primary_key, FieldValues&& field_values)
+{
+    auto primary_key_col = get_primary_key_column();
+    if (!is_asymmetric() || !primary_key_col)
+        throw LogicError(LogicError::wrong_kind_of_table);
+    auto matches = [](ColKey col, const Mixed& value) {
+        if (value.is_null())
+            return col.is_nullable();
+        return value.get_type() == DataType(col.get_type()) || col.get_type() == col_type_Mixed;
+    };
+    if (!matches(primary_key_col, primary_key))
+        throw LogicError(LogicError::type_mismatch);
+    for (auto& val : field_values) {
+        if (!val.col_key.is_collection() && !matches(val.col_key, val.value))
+            throw LogicError(LogicError::type_mismatch);
+    }
+
+    if (auto repl = get_repl()) {
+        if (repl->create_asymmetric_object(this, primary_key, field_values)) // Throws
+            return {};
+    }
+    return create_object_with_primary_key(primary_key, std::move(field_values)); // Throws
+}
+
 Obj Table::create_object_with_primary_key(const Mixed& primary_key, FieldValues&& field_values, UpdateMode mode,
                                           bool* did_create)
 {
@@ -3014,7 +3503,7 @@ Obj Table::create_object_with_primary_key(const Mixed& primary_key, FieldValues&
         *did_create = false;
 
     // Check for existing object
-    if (ObjKey key = m_index_accessors[primary_key_col.get_index().val]->find_first(primary_key)) {
+    if (ObjKey key = find_primary_key(primary_key)) {
         if (mode == UpdateMode::never) {
             throw std::logic_error(
                 util::format("Attempting to create an object in '%1' with an existing primary key value '%2'.",
@@ -3058,6 +3547,7 @@ Obj Table::create_object_with_primary_key(const Mixed& primary_key, FieldValues&
 
     field_values.insert(primary_key_col, primary_key);
     Obj ret = m_clusters.insert(key, field_values);
+    cache_primary_key(primary_key, key);
 
     // Check if unresolved exists
     if (unres_key) {
@@ -3084,7 +3574,12 @@ ObjKey Table::find_primary_key(Mixed primary_key) const
                  primary_key.get_type() == type);
 
     if (auto&& index = m_index_accessors[primary_key_col.get_index().val]) {
-        return index->find_first(primary_key);
+        if (ObjKey key = find_cached_primary_key(primary_key_col, primary_key))
+            return key;
+        ObjKey key = index->find_first(primary_key);
+        if (key)
+            cache_primary_key(primary_key, key);
+        return key;
     }
 
     // This must be file format 11, 20 or 21 as those are the ones we can open in read-only mode
@@ -3103,6 +3598,70 @@ ObjKey Table::find_primary_key(Mixed primary_key) const
     return {};
 }
 
+void Table::init_primary_key_cache()
+{
+    if (m_primary_key_col && !m_primary_key_cache)
+        m_primary_key_cache = std::make_unique<std::atomic<int64_t>[]>(s_primary_key_cache_size);
+}
+
+ObjKey Table::find_cached_primary_key(ColKey pk_col, const Mixed& primary_key) const
+{
+    if (!m_primary_key_cache)
+        return {};
+    auto& slot = m_primary_key_cache[primary_key.hash() & (s_primary_key_cache_size - 1)];
+    int64_t value = slot.load(std::memory_order_relaxed);
+    if (value == 0)
+        return {};
+    ObjKey key(value - 1);
+    if (auto obj = m_clusters.try_get_obj(key)) {
+        if (obj.get_any(pk_col) == primary_key)
+            return key;
+    }
+    return {};
+}
+
+void Table::cache_primary_key(const Mixed& primary_key, ObjKey key) const noexcept
+{
+    if (m_primary_key_cache) {
+        m_primary_key_cache[primary_key.hash() & (s_primary_key_cache_size - 1)].store(key.value + 1,
+                                                                                     std::memory_order_relaxed);
+    }
+}
+
+std::vector<ObjKey> Table::find_primary_keys(const std::vector<Mixed>& primary_keys) const
+{
+    // Order by the first 8 bytes of the index data, which decide the path through the top levels of the index,
+    // and then by value to make duplicates adjacent
+    std::vector<std::pair<uint64_t, size_t>> order;
+    order.reserve(primary_keys.size());
+    StringConversionBuffer buffer;
+    for (size_t i = 0; i < primary_keys.size(); ++i) {
+        StringData data = primary_keys[i].get_index_data(buffer);
+        uint64_t prefix = 0;
+        for (size_t j = 0; j < 8; ++j)
+            prefix = (prefix << 8) | (j < data.size() ? uint8_t(data[j]) : 0);
+        order.emplace_back(prefix, i);
+    }
+    std::sort(order.begin(), order.end(), [&](auto& a, auto& b) {
+        if (a.first != b.first)
+            return a.first < b.first;
+        return primary_keys[a.second] < primary_keys[b.second];
+    });
+
+    std::vector<ObjKey> keys(primary_keys.size());
+    const Mixed* previous = nullptr;
+    ObjKey key;
+    for (auto& entry : order) {
+        const Mixed& primary_key = primary_keys[entry.second];
+        if (!previous || *previous != primary_key) {
+            key = find_primary_key(primary_key);
+            previous = &primary_key;
+        }
+        keys[entry.second] = key;
+    }
+    return keys;
+}
+
 ObjKey Table::get_objkey_from_primary_key(const Mixed& primary_key)
 {
     // Check if existing
@@ -3165,7 +3724,7 @@ Obj Table::get_object_with_primary_key(Mixed primary_key) const
     REALM_ASSERT((primary_key.is_null() && primary_key_col.get_attrs().test(col_attr_Nullable)) ||
                  primary_key.get_type() == type);
 
-    return m_clusters.get(m_index_accessors[primary_key_col.get_index().val]->find_first(primary_key));
+    return m_clusters.get(find_primary_key(primary_key));
 }
 
 Mixed Table::get_primary_key(ObjKey key) const
@@ -3181,6 +3740,81 @@ Mixed Table::get_primary_key(ObjKey key) const
     }
 }
 
+namespace {
+std::unique_ptr<ArrayPayload> make_value_leaf(Allocator& alloc, ColKey col_key)
+{
+    switch (col_key.get_type()) {
+        case col_type_Int:
+            if (col_key.is_nullable())
+                return std::make_unique<ArrayIntNull>(alloc);
+            return std::make_unique<ArrayInteger>(alloc);
+        case col_type_Bool:
+            return std::make_unique<ArrayBoolNull>(alloc);
+        case col_type_String:
+            return std::make_unique<ArrayString>(alloc);
+        case col_type_Binary:
+            return std::make_unique<ArrayBinary>(alloc);
+        case col_type_Mixed:
+            return std::make_unique<ArrayMixed>(alloc);
+        case col_type_Timestamp:
+            return std::make_unique<ArrayTimestamp>(alloc);
+        case col_type_Float:
+            return std::make_unique<ArrayFloatNull>(alloc);
+        case col_type_Double:
+            return std::make_unique<ArrayDoubleNull>(alloc);
+        case col_type_Decimal:
+            return std::make_unique<ArrayDecimal128>(alloc);
+        case col_type_Link:
+            return std::make_unique<ArrayKey>(alloc);
+        case col_type_ObjectId:
+            return std::make_unique<ArrayObjectIdNull>(alloc);
+        case col_type_UUID:
+            return std::make_unique<ArrayUUIDNull>(alloc);
+        case col_type_TypedLink:
+        case col_type_BackLink:
+        case col_type_LinkList:
+            break;
+    }
+    throw LogicError(LogicError::illegal_type);
+}
+} // anonymous namespace
+
+std::vector<Mixed> Table::get_values(const std::vector<ObjKey>& keys, const std::vector<ColKey>& cols) const
+{
+    std::vector<std::unique_ptr<ArrayPayload>> leaves;
+    leaves.reserve(cols.size());
+    for (auto col_key : cols) {
+        check_column(col_key);
+        if (col_key.is_collection())
+            throw LogicError(LogicError::illegal_type);
+        leaves.push_back(make_value_leaf(get_alloc(), col_key));
+    }
+
+    std::vector<Mixed> values(keys.size() * cols.size());
+    Cluster cluster(0, get_alloc(), m_clusters);
+    ref_type cluster_ref = 0;
+    for (size_t k = 0; k < keys.size(); ++k) {
+        REALM_ASSERT(!keys[k].is_unresolved());
+        auto state = m_clusters.ClusterTree::get(keys[k]);
+        // Neighbouring objects are usually stored in the same cluster, in
+        // which case the leaves from the previous object can be reused
+        if (state.mem.get_ref() != cluster_ref) {
+            cluster_ref = state.mem.get_ref();
+            cluster.init(state.mem);
+            for (size_t c = 0; c < cols.size(); ++c)
+                cluster.init_leaf(cols[c], leaves[c].get());
+        }
+        for (size_t c = 0; c < cols.size(); ++c) {
+            Mixed value = leaves[c]->get_any(state.index);
+            // Links to tombstones are reported as null, as by Obj::get_any()
+            if (value.is_type(type_Link) && value.get<ObjKey>().is_unresolved())
+                value = Mixed();
+            values[c * keys.size() + k] = value;
+        }
+    }
+    return values;
+}
+
 GlobalKey Table::allocate_object_id_squeezed()
 {
     // m_client_file_ident will be zero if we haven't been in contact with
@@ -3392,6 +4026,230 @@ void Table::create_objects(const std::vector<ObjKey>& keys)
     }
 }
 
+std::vector<ObjKey> Table::create_objects(const std::vector<ColKey>& cols, const std::vector<Mixed>& values,
+                                          UpdateMode mode)
+{
+    if (is_embedded())
+        throw LogicError(LogicError::wrong_kind_of_table);
+    if (cols.empty() || values.size() % cols.size())
+        throw LogicError(LogicError::illegal_combination);
+    for (auto col_key : cols) {
+        check_column(col_key);
+        if (col_key.is_collection() || col_key.get_type() == col_type_BackLink)
+            throw LogicError(LogicError::illegal_type);
+    }
+
+    size_t num_rows = values.size() / cols.size();
+    auto row_values = [&](size_t row) {
+        FieldValues field_values;
+        for (size_t c = 0; c < cols.size(); ++c)
+            field_values.insert(cols[c], values[c * num_rows + row]);
+        return field_values;
+    };
+
+    std::vector<ObjKey> keys(num_rows);
+    auto primary_key_col = get_primary_key_column();
+    const Mixed* primary_keys = nullptr;
+    if (primary_key_col) {
+        auto it = std::find(cols.begin(), cols.end(), primary_key_col);
+        if (it == cols.end())
+            throw LogicError(LogicError::illegal_combination);
+        primary_keys = &values[(it - cols.begin()) * num_rows];
+    }
+
+    // Tombstones have to be resurrected and objects in asymmetric tables have
+    // to be scheduled for deletion, which the single object path takes care of
+    if (is_asymmetric() || nb_unresolved() ||
+        (primary_key_col && !m_index_accessors[primary_key_col.get_index().val])) {
+        for (size_t row = 0; row < num_rows; ++row) {
+            if (primary_key_col) {
+                auto field_values = row_values(row);
+                keys[row] = create_object_with_primary_key(primary_keys[row], std::move(field_values), mode).get_key();
+            }
+            else {
+                keys[row] = create_object(ObjKey{}, row_values(row)).get_key();
+            }
+        }
+        return keys;
+    }
+
+    // Process the rows in primary key order so that rows with the same primary
+    // key are adjacent and the index is filled in order. The last row with a
+    // given primary key determines the final values of the object.
+    std::vector<size_t> order(num_rows);
+    std::iota(order.begin(), order.end(), 0);
+    if (primary_key_col) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return primary_keys[a] < primary_keys[b];
+        });
+    }
+
+    auto repl = get_repl();
+    std::vector<size_t> created_rows;
+    created_rows.reserve(num_rows);
+    for (size_t i = 0; i < num_rows;) {
+        size_t row = order[i];
+        size_t end = i + 1;
+        if (primary_key_col) {
+            while (end < num_rows && primary_keys[order[end]] == primary_keys[row])
+                ++end;
+        }
+        size_t last_row = order[end - 1];
+
+        ObjKey key;
+        bool create = true;
+        if (primary_key_col) {
+            auto& primary_key = primary_keys[row];
+            REALM_ASSERT((primary_key.is_null() && primary_key_col.get_attrs().test(col_attr_Nullable)) ||
+                         primary_key.get_type() == DataType(primary_key_col.get_type()));
+            key = m_index_accessors[primary_key_col.get_index().val]->find_first(primary_key);
+            if (mode == UpdateMode::never && (key || end - i > 1)) {
+                throw std::logic_error(
+                    util::format("Attempting to create an object in '%1' with an existing primary key value '%2'.",
+                                 get_name(), primary_key));
+            }
+            if (key) {
+                create = false;
+                auto obj = m_clusters.get(key);
+                for (size_t c = 0; c < cols.size(); ++c) {
+                    auto& value = values[c * num_rows + last_row];
+                    if (cols[c] != primary_key_col && (mode == UpdateMode::all || obj.get_any(cols[c]) != value))
+                        obj.set_any(cols[c], value);
+                }
+            }
+            else {
+                key = get_next_valid_key();
+                if (repl)
+                    repl->create_object_with_primary_key(this, key, primary_key);
+            }
+        }
+        else {
+            GlobalKey object_id = allocate_object_id_squeezed();
+            key = object_id.get_local_key(get_sync_file_id());
+            while (m_clusters.is_valid(key)) {
+                object_id = allocate_object_id_squeezed();
+                key = object_id.get_local_key(get_sync_file_id());
+            }
+            if (repl)
+                repl->create_object(this, object_id);
+        }
+
+        if (create) {
+            // Indexes are updated below rather than for each object
+            auto field_values = row_values(last_row);
+            ClusterNode::State state;
+            m_clusters.insert_fast(key, field_values, state);
+            m_clusters.bump_storage_version();
+            if (repl) {
+                for (const auto& v : field_values) {
+                    if (v.col_key != primary_key_col)
+                        repl->set(this, v.col_key, key, v.value, _impl::instr_Set);
+                }
+            }
+            created_rows.push_back(last_row);
+        }
+
+        for (; i < end; ++i)
+            keys[order[i]] = key;
+    }
+
+    if (!created_rows.empty()) {
+        std::vector<std::pair<Mixed, ObjKey>> entries;
+        entries.reserve(created_rows.size());
+        for (size_t column_ndx = 0; column_ndx < m_index_accessors.size(); ++column_ndx) {
+            if (!m_index_accessors[column_ndx])
+                continue;
+            auto col_key = m_leaf_ndx2colkey[column_ndx];
+            auto col = std::find(cols.begin(), cols.end(), col_key);
+            entries.clear();
+            for (auto row : created_rows) {
+                Mixed value = col == cols.end() ? Mixed() : values[(col - cols.begin()) * num_rows + row];
+                entries.emplace_back(value, keys[row]);
+            }
+            std::sort(entries.begin(), entries.end());
+            for (auto& [value, key] : entries)
+                insert_into_index(column_ndx, key, value);
+        }
+        if (m_modification_version_col) {
+            for (auto row : created_rows)
+                get_object(keys[row]).update_modification_version();
+        }
+        m_clusters.bump_content_version();
+    }
+
+    return keys;
+}
+
+void Table::set_links(ColKey col_key, const std::vector<ObjKey>& origins, const std::vector<ObjKey>& targets)
+{
+    check_column(col_key);
+    if (col_key.get_type() != col_type_Link || col_key.is_collection())
+        throw LogicError(LogicError::illegal_type);
+    if (origins.size() != targets.size())
+        throw LogicError(LogicError::illegal_combination);
+    TableRef target_table = get_opposite_table(col_key);
+    if (target_table->is_embedded())
+        throw LogicError(LogicError::wrong_kind_of_table);
+    TableKey target_table_key = target_table->get_key();
+    ColKey backlink_col_key = get_opposite_column(col_key);
+    for (auto target_key : targets) {
+        if (target_key && !target_key.is_unresolved() && !target_table->is_valid(target_key))
+            throw LogicError(LogicError::target_row_index_out_of_range);
+    }
+
+    // Visit the objects in key order. When an object is given more than once
+    // the last link given to it wins, as if the links were set one by one.
+    std::vector<size_t> order(origins.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return origins[a] < origins[b];
+    });
+
+    auto repl = get_repl();
+    CascadeState state(CascadeState::Mode::Strong);
+    bool recurse = false;
+    std::vector<std::pair<ObjKey, ObjKey>> new_backlinks; // target, origin
+    new_backlinks.reserve(origins.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t ndx = order[i];
+        if (i + 1 < order.size() && origins[order[i + 1]] == origins[ndx])
+            continue;
+        ObjKey target_key = targets[ndx];
+        Obj obj = get_object(origins[ndx]);
+        if (target_key.is_unresolved()) {
+            obj.set(col_key, target_key);
+            continue;
+        }
+        ObjKey old_key = obj.get_unfiltered_link(col_key);
+        if (old_key == target_key)
+            continue;
+
+        recurse |= obj.remove_backlink(col_key, {target_table_key, old_key}, state);
+        obj._update_if_needed();
+        obj.set_link_value(col_key, target_key);
+        obj.update_modification_version(col_key);
+        if (repl)
+            repl->set(this, col_key, obj.get_key(), target_key, _impl::instr_Set); // Throws
+        if (target_key)
+            new_backlinks.emplace_back(target_key, obj.get_key());
+    }
+
+    // The backlinks are added target by target, so that each target object is
+    // looked up once, whatever the number of objects linking to it
+    std::sort(new_backlinks.begin(), new_backlinks.end());
+    std::vector<ObjKey> origin_keys;
+    for (size_t i = 0; i < new_backlinks.size();) {
+        ObjKey target_key = new_backlinks[i].first;
+        origin_keys.clear();
+        for (; i < new_backlinks.size() && new_backlinks[i].first == target_key; ++i)
+            origin_keys.push_back(new_backlinks[i].second);
+        target_table->get_object(target_key).add_backlinks(backlink_col_key, origin_keys);
+    }
+
+    if (recurse)
+        target_table->remove_recursive(state);
+}
+
 void Table::dump_objects()
 {
     m_clusters.dump_objects();
@@ -3583,6 +4441,39 @@ ColKey Table::get_primary_key_column() const
     return m_primary_key_col;
 }
 
+void Table::set_modification_version_column(ColKey col_key)
+{
+    if (col_key == m_modification_version_col) {
+        return;
+    }
+
+    if (col_key) {
+        check_column(col_key);
+        if (col_key.get_type() != col_type_Int || col_key.is_collection() || col_key.is_nullable())
+            throw LogicError(LogicError::illegal_type);
+        if (col_key == m_primary_key_col)
+            throw LogicError(LogicError::illegal_combination);
+    }
+
+    while (m_top.size() <= top_position_for_modification_version_col)
+        m_top.add(0); // Throws
+    if (col_key)
+        m_top.set(top_position_for_modification_version_col, RefOrTagged::make_tagged(col_key.value)); // Throws
+    else
+        m_top.set(top_position_for_modification_version_col, 0); // Throws
+    m_modification_version_col = col_key;
+}
+
+void Table::init_modification_version_column()
+{
+    m_modification_version_col = ColKey();
+    if (m_top.size() > top_position_for_modification_version_col) {
+        auto rot_col_key = m_top.get_as_ref_or_tagged(top_position_for_modification_version_col);
+        if (rot_col_key.is_tagged())
+            m_modification_version_col = ColKey(rot_col_key.get_as_int());
+    }
+}
+
 void Table::set_primary_key_column(ColKey col_key)
 {
     if (col_key == m_primary_key_col) {
@@ -3629,6 +4520,7 @@ void Table::do_set_primary_key_column(ColKey col_key)
     }
 
     m_primary_key_col = col_key;
+    init_primary_key_cache();
 }
 
 bool Table::contains_unique_values(ColKey col) const
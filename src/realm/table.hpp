@@ -20,6 +20,7 @@
 #define REALM_TABLE_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <utility>
 #include <typeinfo>
@@ -36,6 +37,7 @@
 #include <realm/keys.hpp>
 #include <realm/global_key.hpp>
 #include <realm/index_string.hpp>
+#include <realm/storage_stats.hpp>
 
 // Only set this to one when testing the code paths that exercise object ID
 // hash collisions. It artificially limits the "optimistic" local ID to use
@@ -60,6 +62,7 @@ class ColKeys;
 struct GlobalKey;
 class LinkChain;
 class Subexpr;
+class FulltextIndex;
 
 struct Link {
 };
@@ -146,6 +149,31 @@ public:
     void set_primary_key_column(ColKey col);
     void validate_primary_column();
 
+    /// The integer column, if any, in which every object records the
+    /// modification version of the table as of the transaction that last
+    /// created or modified it, including changes to its collections. Objects
+    /// modified since an earlier call to get_modification_version() are the
+    /// ones with a larger value in this column, see
+    /// Query::modified_since(). The values are maintained locally, and are
+    /// neither replicated nor reset for existing objects when the column is
+    /// designated. They are versions of this file, which mean nothing to
+    /// another one, and changes applied from elsewhere, as by sync, are
+    /// stamped when they are applied. Passing a null key removes the
+    /// designation.
+    ColKey get_modification_version_column() const noexcept
+    {
+        return m_modification_version_col;
+    }
+    void set_modification_version_column(ColKey col);
+
+    /// The modification version of this table as of the start of the current
+    /// transaction. It grows with every committed transaction which modifies
+    /// the table.
+    uint64_t get_modification_version() const noexcept
+    {
+        return m_in_file_version_at_transaction_boundary;
+    }
+
     //@{
     /// Convenience functions for manipulating the dynamic table type.
     ///
@@ -178,6 +206,23 @@ public:
     void set_table_type(Type table_tpe);
     //@}
 
+    //@{
+    /// Maximum number of objects in each leaf of the tree holding the objects
+    /// of this table, and maximum number of elements in each node of the
+    /// B+trees holding its lists and sets.
+    size_t get_cluster_node_size() const noexcept;
+    size_t get_collection_node_size() const noexcept;
+
+    /// Choose the node sizes used by this table in place of the compile-time
+    /// defaults. Small nodes make updates cheaper while large nodes make scans
+    /// faster. A size of zero selects the default. The sizes are stored in the
+    /// table and can only be changed while the table holds no objects.
+    void set_node_sizes(size_t cluster_node_size, size_t collection_node_size);
+    //@}
+
+    static constexpr size_t min_node_size = 4;
+    static constexpr size_t max_node_size = 0xffff;
+
     /// True for `col_type_Link` and `col_type_LinkList`.
     static bool is_link_type(ColumnType) noexcept;
 
@@ -208,6 +253,26 @@ public:
 
     //@}
 
+    //@{
+
+    /// set_compressed() controls whether large values written to the specified
+    /// string or binary column from now on are stored compressed. Values are
+    /// decompressed transparently when read. Values already stored are left
+    /// as they are until they are next written. Only non-collection columns of
+    /// type String and Binary can be compressed, and only in a DB opened with
+    /// DBOptions::enable_value_compression.
+    /// A value read from a compressed column remains valid only until enough
+    /// other compressed values have been read through the table, see
+    /// ArrayBigBlobs::decompressed_cache_size.
+    ///
+    /// is_compressed() returns true if, and only if compression has been
+    /// enabled for the specified column.
+
+    void set_compressed(ColKey col_key, bool compressed);
+    bool is_compressed(ColKey col_key) const noexcept;
+
+    //@}
+
     /// If the specified column is optimized to store only unique values, then
     /// this function returns the number of unique values currently
     /// stored. Otherwise it returns zero. This function is mainly intended for
@@ -259,8 +324,16 @@ public:
     {
         return create_object_with_primary_key(primary_key, {{}}, UpdateMode::all, did_create);
     }
+    // Create an object in an asymmetric table. When the changes are uploaded by
+    // a sync client, the object is only recorded in the changeset and never
+    // stored in the table, and the returned Obj is invalid. Duplicate primary
+    // keys are then not detected locally.
+    Obj create_asymmetric_object(const Mixed& primary_key, FieldValues&& = {});
     // Return key for existing object or return null key.
     ObjKey find_primary_key(Mixed value) const;
+    // Same as calling find_primary_key() for each value, with the results in the same order. The values are
+    // looked up in the order of the search index, and duplicates only once.
+    std::vector<ObjKey> find_primary_keys(const std::vector<Mixed>& values) const;
     // Return ObjKey for object identified by id. If objects does not exist, return null key
     // Important: This function must not be called for tables with primary keys.
     ObjKey get_objkey(GlobalKey id) const;
@@ -277,6 +350,23 @@ public:
     void create_objects(size_t number, std::vector<ObjKey>& keys);
     /// Create a number of objects with keys supplied
     void create_objects(const std::vector<ObjKey>& keys);
+    /// Create one object per row of a column-major batch of values: the value
+    /// of `cols[c]` for row `r` is `values[c * n + r]`, where `n` is
+    /// `values.size() / cols.size()`. For tables with a primary key the primary
+    /// key column must be one of `cols`, and rows matching an existing object
+    /// (or an earlier row of the batch) update that object according to
+    /// `mode`. Rows are inserted in primary key order and the search indexes
+    /// are filled in a single sorted pass per column once all objects exist.
+    /// Returns the key of the object for each row, in input order.
+    std::vector<ObjKey> create_objects(const std::vector<ColKey>& cols, const std::vector<Mixed>& values,
+                                       UpdateMode mode = UpdateMode::all);
+    /// Set the link column `col_key` of each object in `origins` to the object
+    /// at the same position in `targets`, with the same outcome as setting
+    /// the links one by one, except that the backlinks of an object linked to
+    /// several times are ordered by the key of the object linking. The
+    /// backlinks are added once all links are set, in target key order, and
+    /// all backlinks to the same object at once.
+    void set_links(ColKey col_key, const std::vector<ObjKey>& origins, const std::vector<ObjKey>& targets);
     /// Does the key refer to an object within the table?
     bool is_valid(ObjKey key) const noexcept
     {
@@ -300,6 +390,13 @@ public:
     Obj get_object_with_primary_key(Mixed pk) const;
     // Get primary key based on ObjKey
     Mixed get_primary_key(ObjKey key) const;
+    /// Read the values of the given columns for each of the given objects.
+    /// The result is column-major: the value of `cols[c]` for `keys[k]` is
+    /// at index `c * keys.size() + k`. Objects stored in the same cluster
+    /// share the leaf accessors, so reading a run of neighbouring objects is
+    /// much cheaper than calling Obj::get_any() for every value.
+    /// Collection columns are not supported.
+    std::vector<Mixed> get_values(const std::vector<ObjKey>& keys, const std::vector<ColKey>& cols) const;
     // Get logical index for object. This function is not very efficient
     size_t get_object_ndx(ObjKey key) const noexcept
     {
@@ -320,6 +417,13 @@ public:
     /// remove_object_recursive() will delete linked rows if the removed link was the
     /// last one holding on to the row in question. This will be done recursively.
     void remove_object_recursive(ObjKey key);
+    /// remove_objects() removes all the specified objects from the table with
+    /// the same semantics as calling remove_object() for each of them. Keys
+    /// which are null, invalid or duplicated are ignored. Removing every object
+    /// takes the clear() path, and when most of the table is removed the search
+    /// indexes are rebuilt from the remaining objects rather than updated once
+    /// per removed object.
+    void remove_objects(const std::vector<ObjKey>& keys);
     // Invalidate object. To be used by the Sync client.
     // - turns the object into a tombstone if links exist
     // - otherwise works just as remove_object()
@@ -412,6 +516,12 @@ public:
             return nullptr;
         return m_index_accessors[col.get_index().val].get();
     }
+    // Returns the index of the words in a string column. It is built on first use and kept until the
+    // contents of the table change.
+    std::shared_ptr<const FulltextIndex> get_fulltext_index(ColKey col) const;
+    // Drops the word indexes and the primary key lookup cache, which are rebuilt on demand. Returns an estimate
+    // of the number of bytes freed; indexes still in use elsewhere are released when their last user lets go.
+    size_t release_caches() const;
     template <class T>
     ObjKey find_first(ColKey col_key, T value) const;
 
@@ -530,6 +640,7 @@ private:
     void set_embedded(bool embedded);
     /// Changes type unconditionally. Called only from Group::do_get_or_add_table()
     void do_set_table_type(Type table_type);
+    void init_node_sizes(uint64_t flags) noexcept;
 
 public:
     // mapping between index used in leaf nodes (leaf_ndx) and index used in spec (spec_ndx)
@@ -568,6 +679,12 @@ public:
                 const query_parser::KeyPathMapping& mapping) const;
     Query query(const std::string& query_string, query_parser::Arguments& arguments,
                 const query_parser::KeyPathMapping&) const;
+    // Like query(), but every condition comparing with a single argument is bound to the index of that argument
+    // (see Query::set_placeholder()), so that the query can be run with other arguments by Query::rebind().
+    // Arguments which are null or lists are not bound.
+    Query prepare_query(const std::string& query_string, const std::vector<Mixed>& arguments) const;
+    Query prepare_query(const std::string& query_string, query_parser::Arguments& arguments,
+                        const query_parser::KeyPathMapping&) const;
 
     //@{
     /// WARNING: The link() and backlink() methods will alter a state on the Table object and return a reference
@@ -631,6 +748,25 @@ public:
     /// zero.
     size_t compute_aggregated_byte_size() const noexcept;
 
+    /// Break the size of this table down by column, see
+    /// Group::get_storage_stats(). Only every `sample_interval`th cluster is
+    /// measured, and the sizes of the clusters and columns are extrapolated
+    /// from those.
+    StorageStats::Table get_storage_stats(size_t sample_interval = 1) const;
+
+    enum class VectorDistance { L2, Cosine };
+    struct NearestMatch {
+        ObjKey key;
+        double distance;
+    };
+    /// Find the (at most) `k` objects whose list of floats in `col_key` is
+    /// nearest to `target`, nearest first. Lists which don't have the same
+    /// number of elements as `target` are skipped, as are lists with a norm
+    /// of zero for cosine distance. This is an exact search which reads every
+    /// list in the column, without copying them out of the file.
+    std::vector<NearestMatch> find_nearest(ColKey col_key, const std::vector<float>& target, size_t k,
+                                           VectorDistance distance = VectorDistance::L2) const;
+
     // Debug
     void verify() const;
 
@@ -705,10 +841,19 @@ private:
     Array m_opposite_table;                         // 7th slot in m_top
     Array m_opposite_column;                        // 8th slot in m_top
     std::vector<std::unique_ptr<StringIndex>> m_index_accessors;
+    mutable std::mutex m_fulltext_mutex;
+    mutable std::map<ColKey, std::pair<uint_fast64_t, std::shared_ptr<const FulltextIndex>>> m_fulltext_indexes;
     ColKey m_primary_key_col;
+    ColKey m_modification_version_col;
+    // Keys (plus one, so that zero is empty) of objects found by primary key, in slots chosen by the hash of the
+    // primary key. A slot is only used after checking that the object has that primary key, so entries never need
+    // to be invalidated. Atomic as frozen tables can be read from several threads.
+    static constexpr size_t s_primary_key_cache_size = 1024;
+    mutable std::unique_ptr<std::atomic<int64_t>[]> m_primary_key_cache;
     Replication* const* m_repl;
     static Replication* g_dummy_replication;
     bool m_is_frozen = false;
+    bool m_defer_index_erase = false;
     util::Optional<bool> m_has_any_embedded_objects;
     TableRef m_own_ref;
 
@@ -718,6 +863,8 @@ private:
     void populate_search_index(ColKey col_key);
     void erase_from_search_indexes(ObjKey key);
     void update_indexes(ObjKey key, const FieldValues& values);
+    void insert_into_index(size_t column_ndx, ObjKey key, Mixed init_value);
+    void rebuild_search_indexes();
     void clear_indexes();
 
     // Migration support
@@ -726,8 +873,13 @@ private:
     void migrate_indexes(ColKey pk_col_key);
     void migrate_subspec();
     void create_columns();
-    bool migrate_objects(); // Returns true if there are no links to migrate
-    void migrate_links();
+    // Migrate at most max_objects objects from the old columns, continuing where a
+    // previous call stopped. Returns true when all objects have been migrated, and
+    // sets no_links to true if there are no links to migrate.
+    bool migrate_objects(bool& no_links, size_t max_objects = npos);
+    // Migrate the links of at most max_objects objects, starting at position start.
+    // Returns the position to continue from, or npos when done.
+    size_t migrate_links(size_t start = 0, size_t max_objects = npos);
     void finalize_migration(ColKey pk_col_key);
 
     /// Disable copying assignment.
@@ -765,8 +917,15 @@ private:
     ColKey find_or_add_backlink_column(ColKey origin_col_key, TableKey origin_table);
     void do_set_primary_key_column(ColKey col_key);
     void validate_column_is_unique(ColKey col_key) const;
+    void init_modification_version_column();
+    // The summaries of the leaves of this table computed by queries are kept across versions
+    // until the table is modified, as leaves freed by the modification may then be reused.
+    void drop_leaf_summaries() const noexcept;
 
     ObjKey get_next_valid_key();
+    void init_primary_key_cache();
+    ObjKey find_cached_primary_key(ColKey pk_col, const Mixed& primary_key) const;
+    void cache_primary_key(const Mixed& primary_key, ObjKey key) const noexcept;
     /// Some Object IDs are generated as a tuple of the client_file_ident and a
     /// local sequence number. This function takes the next number in the
     /// sequence for the given table and returns an appropriate globally unique
@@ -827,8 +986,11 @@ private:
     void flush_for_commit();
 
     bool is_cross_table_link_target() const noexcept;
-    template <typename T>
-    void aggregate(QueryStateBase& st, ColKey col_key) const;
+    template <typename T, class State>
+    void aggregate(State& st, ColKey col_key) const;
+    // Feed all values of `col_key` in `cluster` to `st`, using `leaf` as accessor
+    template <class State, class LeafType>
+    static void aggregate_leaf(State& st, const Cluster* cluster, ColKey col_key, LeafType& leaf);
     template <typename T>
     double average(ColKey col_key, size_t* resultcount) const;
 
@@ -836,6 +998,7 @@ private:
     std::vector<ColKey::Idx> m_spec_ndx2leaf_ndx;
     std::vector<size_t> m_leaf_ndx2spec_ndx;
     Type m_table_type = Type::TopLevel;
+    size_t m_collection_node_size = REALM_MAX_BPNODE_SIZE;
     uint64_t m_in_file_version_at_transaction_boundary = 0;
     AtomicLifeCycleCookie m_cookie;
 
@@ -853,8 +1016,14 @@ private:
     static constexpr int top_position_for_pk_col = 11;
     static constexpr int top_position_for_flags = 12;
     // flags contents: bit 0-1 - table type
+    //                 bit 8-23 - cluster node size (0 if default)
+    //                 bit 24-39 - collection node size (0 if default)
+    static constexpr int flags_shift_for_cluster_node_size = 8;
+    static constexpr int flags_shift_for_collection_node_size = 24;
     static constexpr int top_position_for_tombstones = 13;
     static constexpr int top_array_size = 14;
+    // Added on demand, after the above
+    static constexpr int top_position_for_modification_version_col = 14;
 
     enum { s_collision_map_lo = 0, s_collision_map_hi = 1, s_collision_map_local_id = 2, s_collision_map_num_slots };
 
@@ -1160,6 +1329,16 @@ inline Table::Type Table::get_table_type() const noexcept
     return m_table_type;
 }
 
+inline size_t Table::get_cluster_node_size() const noexcept
+{
+    return m_clusters.get_max_node_size();
+}
+
+inline size_t Table::get_collection_node_size() const noexcept
+{
+    return m_collection_node_size;
+}
+
 inline StringData Table::get_column_name(ColKey column_key) const
 {
     auto spec_ndx = colkey2spec_ndx(column_key);
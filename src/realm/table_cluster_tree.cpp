@@ -52,7 +52,11 @@ Obj TableClusterTree::insert(ObjKey k, const FieldValues& values)
         }
     }
 
-    return Obj(get_table_ref(), state.mem, k, state.index);
+    Obj obj(get_table_ref(), state.mem, k, state.index);
+    if (m_owner->get_modification_version_column() && !k.is_unresolved())
+        obj.update_modification_version();
+
+    return obj;
 }
 
 void TableClusterTree::clear(CascadeState& state)
@@ -24,31 +24,55 @@
 
 namespace realm {
 
-template <typename T>
-void Table::aggregate(QueryStateBase& st, ColKey column_key) const
+// States which can consume a whole leaf at a time, see QueryStateSum::match_leaf()
+template <class State, class LeafType, class = void>
+struct HasMatchLeaf : std::false_type {
+};
+template <class State, class LeafType>
+struct HasMatchLeaf<State, LeafType,
+                    std::void_t<decltype(std::declval<State&>().match_leaf(std::declval<const LeafType&>()))>>
+    : std::true_type {
+};
+
+template <typename T, class State>
+void Table::aggregate(State& st, ColKey column_key) const
 {
     using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
     LeafType leaf(get_alloc());
 
     auto f = [&leaf, column_key, &st](const Cluster* cluster) {
-        // direct aggregate on the leaf
-        cluster->init_leaf(column_key, &leaf);
-        st.m_key_offset = cluster->get_offset();
-        st.m_key_values = cluster->get_key_array();
-
-        bool cont = true;
-        size_t sz = leaf.size();
-        for (size_t local_index = 0; cont && local_index < sz; local_index++) {
-            auto v = leaf.get(local_index);
-            cont = st.match(local_index, v);
-        }
+        aggregate_leaf(st, cluster, column_key, leaf);
         // We should continue
         return false;
     };
 
+    util::SequentialScanHint scan_hint;
     traverse_clusters(f);
 }
 
+template <class State, class LeafType>
+void Table::aggregate_leaf(State& st, const Cluster* cluster, ColKey column_key, LeafType& leaf)
+{
+    // direct aggregate on the leaf
+    cluster->init_leaf(column_key, &leaf);
+    st.m_key_offset = cluster->get_offset();
+    st.m_key_values = cluster->get_key_array();
+
+    if constexpr (HasMatchLeaf<State, LeafType>::value) {
+        if (st.limit() == size_t(-1)) {
+            st.match_leaf(leaf);
+            return;
+        }
+    }
+
+    bool cont = true;
+    size_t sz = leaf.size();
+    for (size_t local_index = 0; cont && local_index < sz; local_index++) {
+        auto v = leaf.get(local_index);
+        cont = st.match(local_index, v);
+    }
+}
+
 template <typename T>
 double Table::average(ColKey col_key, size_t* resultcount) const
 {
@@ -19,6 +19,7 @@
 #include <realm/table_view.hpp>
 #include <realm/column_integer.hpp>
 #include <realm/index_string.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/transaction.hpp>
 
 #include <unordered_set>
@@ -96,6 +97,16 @@ TableView::TableView(TableView& src, Transaction* tr, PayloadPolicy policy_mode)
     m_limit = src.m_limit;
 }
 
+TableView::TableView(const Query& query, const std::vector<ObjKey>& keys, const DescriptorOrdering& ordering)
+    : TableView(query, size_t(-1))
+{
+    m_descriptor_ordering = ordering;
+    m_descriptor_ordering.collect_dependencies(m_table.unchecked_ptr());
+    for (auto key : keys)
+        m_key_values.add(key);
+    m_last_seen_versions = get_dependency_versions();
+}
+
 // Aggregates ----------------------------------------------------
 
 template <typename T, Action AggregateOpType>
@@ -588,6 +599,9 @@ void TableView::do_sync()
     // FIXME: Unimplemented for link to a column
     else {
         m_query.m_table.check();
+#if REALM_METRICS
+        metrics::LatencyTimer latency_timer(metrics::LatencyMetric::query);
+#endif
 
         // valid query, so clear earlier results and reexecute it.
         if (m_key_values.is_attached())
@@ -616,22 +630,28 @@ void TableView::do_sort(const DescriptorOrdering& ordering)
     // Gather the current rows into a container we can use std algorithms on
     size_t detached_ref_count = 0;
     BaseDescriptor::IndexPairs index_pairs;
-    index_pairs.reserve(sz);
-    // always put any detached refs at the end of the sort
-    // FIXME: reconsider if this is the right thing to do
-    // FIXME: consider specialized implementations in derived classes
-    // (handling detached refs is not required in linkviews)
-    for (size_t t = 0; t < sz; t++) {
-        ObjKey key = get_key(t);
-        if (m_table->is_valid(key)) {
-            index_pairs.emplace_back(key, t);
+    const int num_descriptors = int(ordering.size());
+    int desc_ndx = 0;
+    if (select_first_sorted(ordering, index_pairs, detached_ref_count)) {
+        desc_ndx = 2; // The sort and the limit have been applied
+    }
+    else {
+        index_pairs.reserve(sz);
+        // always put any detached refs at the end of the sort
+        // FIXME: reconsider if this is the right thing to do
+        // FIXME: consider specialized implementations in derived classes
+        // (handling detached refs is not required in linkviews)
+        for (size_t t = 0; t < sz; t++) {
+            ObjKey key = get_key(t);
+            if (m_table->is_valid(key)) {
+                index_pairs.emplace_back(key, t);
+            }
+            else
+                ++detached_ref_count;
         }
-        else
-            ++detached_ref_count;
     }
 
-    const int num_descriptors = int(ordering.size());
-    for (int desc_ndx = 0; desc_ndx < num_descriptors; ++desc_ndx) {
+    for (; desc_ndx < num_descriptors; ++desc_ndx) {
         const BaseDescriptor* base_descr = ordering[desc_ndx];
         const BaseDescriptor* next = ((desc_ndx + 1) < num_descriptors) ? ordering[desc_ndx + 1] : nullptr;
         BaseDescriptor::Sorter predicate = base_descr->sorter(*m_table, index_pairs);
@@ -653,6 +673,54 @@ void TableView::do_sort(const DescriptorOrdering& ordering)
         m_key_values.add(null_key);
 }
 
+// A sort followed by a limit only needs the first `limit` objects in sorted order. Those are selected with a
+// bounded heap, so no sort state is built for the objects that are cut off.
+bool TableView::select_first_sorted(const DescriptorOrdering& ordering, BaseDescriptor::IndexPairs& index_pairs,
+                                    size_t& detached_ref_count) const
+{
+    if (ordering.size() < 2 || ordering.get_type(0) != DescriptorType::Sort ||
+        ordering.get_type(1) != DescriptorType::Limit)
+        return false;
+    const size_t sz = size();
+    const size_t limit = static_cast<const LimitDescriptor*>(ordering[1])->get_limit();
+    if (limit >= sz)
+        return false;
+    BaseDescriptor::Sorter predicate = ordering[0]->sorter(*m_table, index_pairs);
+    if (predicate.has_links())
+        return false; // The columns behind links are looked up for all objects up front
+
+    index_pairs.reserve(limit);
+    size_t valid_count = 0;
+    for (size_t t = 0; t < sz; t++) {
+        ObjKey key = get_key(t);
+        if (!m_table->is_valid(key)) {
+            ++detached_ref_count;
+            continue;
+        }
+        ++valid_count;
+        BaseDescriptor::IndexPair pair(key, t);
+        predicate.cache_first_column(pair);
+        // The heap keeps the last of the selected objects in front
+        if (index_pairs.size() < limit) {
+            index_pairs.push_back(std::move(pair));
+            std::push_heap(index_pairs.begin(), index_pairs.end(), std::ref(predicate));
+        }
+        else if (limit > 0 && predicate(pair, index_pairs.front())) {
+            std::pop_heap(index_pairs.begin(), index_pairs.end(), std::ref(predicate));
+            index_pairs.back() = std::move(pair);
+            std::push_heap(index_pairs.begin(), index_pairs.end(), std::ref(predicate));
+        }
+    }
+    std::sort_heap(index_pairs.begin(), index_pairs.end(), std::ref(predicate));
+    index_pairs.m_removed_by_limit = valid_count - index_pairs.size();
+
+    // Subsequent descriptors choose between entries by their position in the sorted order
+    for (size_t i = 0; i < index_pairs.size(); ++i) {
+        index_pairs[i].index_in_view = i;
+    }
+    return true;
+}
+
 bool TableView::is_in_table_order() const
 {
     if (!m_table) {
@@ -159,6 +159,11 @@ public:
     TableView(ConstTableRef parent, ColKey column, const Obj& obj);
     TableView(LinkCollectionPtr&& collection);
 
+    /// Construct a view over `keys`, which must be what running `query` and
+    /// then applying `ordering` would produce for the current version of the
+    /// tables involved. The view is in sync with that version.
+    TableView(const Query& query, const std::vector<ObjKey>& keys, const DescriptorOrdering& ordering);
+
     /// Copy constructor.
     TableView(const TableView&);
 
@@ -396,6 +401,7 @@ protected:
 
     void do_sync();
     void do_sort(const DescriptorOrdering&);
+    bool select_first_sorted(const DescriptorOrdering&, BaseDescriptor::IndexPairs&, size_t& detached_ref_count) const;
 
     mutable ConstTableRef m_table;
     // The source column index that this view contain backlinks for.
@@ -22,6 +22,7 @@
 #include <realm/set.hpp>
 #include <realm/dictionary.hpp>
 #include <realm/table_view.hpp>
+#include <realm/util/thread_pool.hpp>
 #include <realm/group_writer.hpp>
 
 namespace {
@@ -97,6 +98,234 @@ void generate_properties_for_obj(Replication& repl, const Obj& obj, const ColInf
     }
 }
 
+#ifdef REALM_DEBUG
+constexpr size_t number_of_objects_to_create_before_committing = 100;
+#else
+constexpr size_t number_of_objects_to_create_before_committing = 1000;
+#endif
+
+// The smallest number of objects whose values a task reads when copying
+constexpr size_t min_objects_per_copy_task = 64;
+
+// Whether the values of a column can be copied as they are, as opposed to
+// links, which must be mapped to the copies of the objects they link to, and
+// collections
+bool is_plain_column(ColKey col) noexcept
+{
+    if (col.is_collection())
+        return false;
+    auto type = col.get_type();
+    return type != col_type_Link && type != col_type_TypedLink && type != col_type_Mixed;
+}
+
+// Copy the objects of `table_keys` in `src` to `dest`, whose schema must
+// already match. This is done in two passes. The first pass creates the
+// objects of one table at a time with the values of the plain columns, and
+// records the keys of the copies. The values of a batch of objects are read
+// column by column, by several threads if `parallel` is true, and then
+// written by this thread. The second pass sets the values of the remaining
+// columns through the replication interface like Transaction::replicate()
+// does, now that every object that can be linked to has a copy.
+void copy_objects(const Transaction& src, const std::vector<TableKey>& table_keys, bool parallel, Transaction& dest,
+                  _impl::CopyReplication& repl)
+{
+    auto& pool = util::ThreadPool::get_default();
+    std::vector<ObjKey> src_keys;
+    std::vector<Mixed> values;
+    for (auto tk : table_keys) {
+        auto table = src.get_table(tk);
+        if (table->is_embedded())
+            continue;
+        auto dest_table = dest.get_table(table->get_name());
+        auto pk_col = table->get_primary_key_column();
+        // The primary key first, and then the plain columns, in the source
+        // realm and in the destination realm
+        std::vector<ColKey> cols = {pk_col};
+        std::vector<ColKey> dest_cols = {dest_table->get_primary_key_column()};
+        for (auto col : table->get_column_keys()) {
+            if (col != pk_col && is_plain_column(col)) {
+                cols.push_back(col);
+                dest_cols.push_back(dest_table->get_column_key(table->get_column_name(col)));
+            }
+        }
+        size_t num_cols = cols.size();
+
+        _impl::CopyReplication::KeyMap key_map;
+        key_map.reserve(table->size());
+        auto it = table->begin();
+        auto end = table->end();
+        while (it != end) {
+            src_keys.clear();
+            for (; it != end && src_keys.size() < number_of_objects_to_create_before_committing; ++it)
+                src_keys.push_back(it->get_key());
+            size_t num_objects = src_keys.size();
+            values.resize(num_objects * num_cols);
+
+            size_t num_tasks = parallel ? std::max<size_t>(num_objects / min_objects_per_copy_task, 1) : 1;
+            size_t objects_per_task = (num_objects + num_tasks - 1) / num_tasks;
+            auto read_values = [&](size_t task) {
+                size_t begin = task * objects_per_task;
+                size_t end = std::min(begin + objects_per_task, num_objects);
+                for (size_t i = begin; i < end; ++i) {
+                    auto obj = table->get_object(src_keys[i]);
+                    for (size_t j = 0; j < num_cols; ++j)
+                        values[i * num_cols + j] = obj.get_any(cols[j]);
+                }
+            };
+            if (num_tasks > 1)
+                pool.run_parallel(num_tasks, read_values);
+            else
+                read_values(0);
+
+            for (size_t i = 0; i < num_objects; ++i) {
+                const Mixed* row = &values[i * num_cols];
+                bool created = false;
+                auto obj = dest_table->create_object_with_primary_key(row[0], &created);
+                for (size_t j = 1; j < num_cols; ++j) {
+                    // A new object already has null where the column is nullable
+                    if (!created || !row[j].is_null())
+                        obj.set_any(dest_cols[j], row[j]);
+                }
+                key_map.emplace_back(src_keys[i], obj.get_key());
+            }
+            dest.commit_and_continue_writing();
+        }
+        repl.add_key_map(table.unchecked_ptr(), std::move(key_map));
+    }
+
+    auto n = number_of_objects_to_create_before_committing;
+    for (auto tk : table_keys) {
+        auto table = src.get_table(tk);
+        if (table->is_embedded())
+            continue;
+        auto pk_col = table->get_primary_key_column();
+        ColInfo cols;
+        for (auto elem : get_col_info(table.unchecked_ptr())) {
+            if (elem.first != pk_col && !is_plain_column(elem.first))
+                cols.push_back(elem);
+        }
+        if (cols.empty())
+            continue;
+        for (auto o : *table) {
+            generate_properties_for_obj(repl, o, cols);
+            if (--n == 0) {
+                dest.commit_and_continue_writing();
+                n = number_of_objects_to_create_before_committing;
+            }
+        }
+    }
+}
+
+// Looks for changes to a read set in the transaction logs of the commits
+// which a promotion to write skips over
+class ReadSetConflictObserver : public _impl::NullInstructionObserver {
+public:
+    ReadSetConflictObserver(const Transaction::ReadSet& read_set)
+        : m_read_set(read_set)
+    {
+    }
+
+    bool has_conflict() const noexcept
+    {
+        return m_conflict;
+    }
+
+    bool select_table(TableKey key)
+    {
+        m_table = key;
+        m_whole_table = m_read_set.tables.count(key) > 0;
+        return true;
+    }
+    bool select_collection(ColKey, ObjKey key)
+    {
+        check_object(key);
+        return true;
+    }
+    bool select_link_list(ColKey, ObjKey key)
+    {
+        check_object(key);
+        return true;
+    }
+    bool erase_class(TableKey key)
+    {
+        check_table(key);
+        return true;
+    }
+    bool rename_class(TableKey key)
+    {
+        check_table(key);
+        return true;
+    }
+    bool create_object(ObjKey key)
+    {
+        check_object(key);
+        return true;
+    }
+    bool remove_object(ObjKey key)
+    {
+        check_object(key);
+        return true;
+    }
+    bool modify_object(ColKey, ObjKey key)
+    {
+        check_object(key);
+        return true;
+    }
+    bool insert_column(ColKey)
+    {
+        check_table(m_table);
+        return true;
+    }
+    bool erase_column(ColKey)
+    {
+        check_table(m_table);
+        return true;
+    }
+    bool rename_column(ColKey)
+    {
+        check_table(m_table);
+        return true;
+    }
+    bool set_compressed(ColKey, bool)
+    {
+        check_table(m_table);
+        return true;
+    }
+    bool set_link_type(ColKey)
+    {
+        check_table(m_table);
+        return true;
+    }
+    bool typed_link_change(ColKey, TableKey)
+    {
+        check_table(m_table);
+        return true;
+    }
+
+private:
+    const Transaction::ReadSet& m_read_set;
+    TableKey m_table;
+    bool m_whole_table = false;
+    bool m_conflict = false;
+
+    // Changes to the schema of a table conflict with reads of any part of it
+    void check_table(TableKey key)
+    {
+        if (m_read_set.tables.count(key)) {
+            m_conflict = true;
+            return;
+        }
+        auto it = m_read_set.objects.lower_bound({key, ObjKey(std::numeric_limits<int64_t>::min())});
+        if (it != m_read_set.objects.end() && it->first == key)
+            m_conflict = true;
+    }
+    void check_object(ObjKey key)
+    {
+        if (m_whole_table || m_read_set.objects.count({m_table, key}))
+            m_conflict = true;
+    }
+};
+
 } // namespace
 
 namespace realm {
@@ -112,6 +341,7 @@ Transaction::Transaction(DBRef _db, SlabAlloc* alloc, DB::ReadLockInfo& rli, DB:
     set_transact_stage(stage);
     m_alloc.note_reader_start(this);
     attach_shared(m_read_lock.m_top_ref, m_read_lock.m_file_size, writable);
+    db->register_reader(m_reader_pin, m_read_lock, stage == DB::transact_Frozen);
 }
 
 Transaction::~Transaction()
@@ -148,10 +378,22 @@ DB::version_type Transaction::commit()
 
     REALM_ASSERT(is_attached());
 
+    run_before_commit(); // Throws
+
     // before committing, allow any accessors at group level or below to sync
     flush_accessors_for_commit();
 
-    DB::version_type new_version = db->do_commit(*this); // Throws
+    {
+        util::CheckedLockGuard lck(m_async_mutex);
+        wait_for_syncs_in_flight(lck.native_handle());
+    }
+
+    // With group commit, the changes are synced to disk together with those of other
+    // writers once the write lock has been released.
+    bool group_commit = db->is_group_commit_enabled();
+    if (group_commit)
+        db->hold_durable_version(*this);                                // Throws
+    DB::version_type new_version = db->do_commit(*this, !group_commit); // Throws
 
     // We need to set m_read_lock in order for wait_for_change to work.
     // To set it, we grab a readlock on the latest available snapshot
@@ -163,12 +405,22 @@ DB::version_type Transaction::commit()
 
     db->end_write_on_correct_thread();
 
+    // do_end_read() releases our reference to the DB
+    DBRef db_ref = db;
     do_end_read();
     m_read_lock = lock_after_commit;
 
+    if (group_commit)
+        db_ref->wait_for_group_commit(new_version); // Throws
     return new_version;
 }
 
+void Transaction::run_before_commit()
+{
+    if (db->m_before_commit)
+        db->m_before_commit(*this); // Throws
+}
+
 void Transaction::rollback()
 {
     // rollback may happen as a consequence of exception handling in cases where
@@ -188,6 +440,12 @@ void Transaction::rollback()
     do_end_read();
 }
 
+void Transaction::end_read_if_invalidated()
+{
+    if (is_invalidated() && (m_transact_stage == DB::transact_Reading || m_transact_stage == DB::transact_Frozen))
+        do_end_read();
+}
+
 void Transaction::end_read()
 {
     if (m_transact_stage == DB::transact_Ready)
@@ -204,9 +462,22 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
     if (m_transact_stage != DB::transact_Writing)
         throw LogicError(LogicError::wrong_transact_state);
 
+    run_before_commit(); // Throws
     flush_accessors_for_commit();
 
-    DB::version_type version = db->do_commit(*this, commit_to_disk); // Throws
+    if (commit_to_disk || db->m_key) {
+        // Syncing the file, or writing to an encrypted one, must not overlap with a
+        // sync requested by async_sync_commits()
+        util::CheckedLockGuard lck(m_async_mutex);
+        wait_for_syncs_in_flight(lck.native_handle());
+    }
+
+    // With group commit, the changes are synced to disk together with those of other
+    // writers once the write lock has been released.
+    bool group_commit = commit_to_disk && db->is_group_commit_enabled();
+    if (group_commit)
+        db->hold_durable_version(*this);                                              // Throws
+    DB::version_type version = db->do_commit(*this, commit_to_disk && !group_commit); // Throws
 
     // advance read lock but dont update accessors:
     // As this is done under lock, along with the addition above of the newest commit,
@@ -223,6 +494,8 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
         m_history = nullptr;
         set_transact_stage(DB::transact_Reading);
 
+        // A sync requested by async_sync_commits() may replace m_oldest_version_not_persisted
+        util::CheckedUniqueLock lck(m_async_mutex);
         if (commit_to_disk || m_oldest_version_not_persisted) {
             // Here we are either committing to disk or we are already
             // holding on to an older version. In either case there is
@@ -242,31 +515,32 @@ VersionID Transaction::commit_and_continue_as_read(bool commit_to_disk)
             m_oldest_version_not_persisted.reset();
         }
         m_read_lock = new_read_lock;
+        DB::note_reader_version(m_reader_pin, m_read_lock);
         // We can be sure that m_read_lock != m_oldest_version_not_persisted
         // because m_oldest_version_not_persisted is either equal to former m_read_lock
         // or older and former m_read_lock is older than current m_read_lock
         REALM_ASSERT(!m_oldest_version_not_persisted ||
                      m_read_lock.m_version != m_oldest_version_not_persisted->m_version);
 
-        {
-            util::CheckedLockGuard lock(m_async_mutex);
-            REALM_ASSERT(m_async_stage != AsyncState::Syncing);
-            if (commit_to_disk) {
-                if (m_async_stage == AsyncState::Requesting) {
-                    m_async_stage = AsyncState::HasLock;
-                }
-                else {
-                    db->end_write_on_correct_thread();
-                    m_async_stage = AsyncState::Idle;
-                }
+        REALM_ASSERT(m_async_stage != AsyncState::Syncing);
+        if (commit_to_disk) {
+            if (m_async_stage == AsyncState::Requesting) {
+                m_async_stage = AsyncState::HasLock;
             }
             else {
-                m_async_stage = AsyncState::HasCommits;
+                db->end_write_on_correct_thread();
+                m_async_stage = AsyncState::Idle;
             }
         }
+        else {
+            m_async_stage = AsyncState::HasCommits;
+        }
+        m_async_mutex.unlock(lck);
 
         // Remap file if it has grown, and update refs in underlying node structure
         remap_and_update_refs(m_read_lock.m_top_ref, m_read_lock.m_file_size, false); // Throws
+        if (group_commit)
+            db->wait_for_group_commit(version); // Throws
         return VersionID{version, new_read_lock.m_reader_idx};
     }
     catch (...) {
@@ -285,6 +559,8 @@ void Transaction::commit_and_continue_writing()
 
     REALM_ASSERT(is_attached());
 
+    run_before_commit(); // Throws
+
     // before committing, allow any accessors at group level or below to sync
     flush_accessors_for_commit();
 
@@ -298,6 +574,7 @@ void Transaction::commit_and_continue_writing()
     db->grab_read_lock(lock_after_commit, version_id);
     db->release_read_lock(m_read_lock);
     m_read_lock = lock_after_commit;
+    DB::note_reader_version(m_reader_pin, m_read_lock);
     if (Replication* repl = db->get_replication()) {
         bool history_updated = false;
         repl->initiate_transact(*this, lock_after_commit.m_version, history_updated); // Throws
@@ -307,8 +584,19 @@ void Transaction::commit_and_continue_writing()
     remap_and_update_refs(m_read_lock.m_top_ref, m_read_lock.m_file_size, writable); // Throws
 }
 
+bool Transaction::promote_to_write_if_unchanged(const ReadSet& read_set)
+{
+    ReadSetConflictObserver observer(read_set);
+    promote_to_write(&observer); // Throws
+    if (!observer.has_conflict())
+        return true;
+    rollback_and_continue_as_read();
+    return false;
+}
+
 TransactionRef Transaction::freeze()
 {
+    end_read_if_invalidated();
     if (m_transact_stage != DB::transact_Reading)
         throw LogicError(LogicError::wrong_transact_state);
     auto version = VersionID(m_read_lock.m_version, m_read_lock.m_reader_idx);
@@ -317,6 +605,7 @@ TransactionRef Transaction::freeze()
 
 TransactionRef Transaction::duplicate()
 {
+    end_read_if_invalidated();
     auto version = VersionID(m_read_lock.m_version, m_read_lock.m_reader_idx);
     if (m_transact_stage == DB::transact_Reading)
         return db->start_read(version);
@@ -329,7 +618,18 @@ TransactionRef Transaction::duplicate()
 void Transaction::copy_to(TransactionRef dest) const
 {
     _impl::CopyReplication repl(dest);
-    replicate(dest.get(), repl);
+    auto public_table_keys = replicate_schema(repl);
+    dest->commit_and_continue_writing();
+
+    // The values are read by several threads, which requires a frozen
+    // transaction. Uncommitted changes can only be read from this one.
+    if (m_transact_stage == DB::transact_Reading) {
+        auto frozen = db->start_frozen(get_version_of_current_transaction());
+        copy_objects(*frozen, public_table_keys, true, *dest, repl);
+    }
+    else {
+        copy_objects(*this, public_table_keys, m_transact_stage == DB::transact_Frozen, *dest, repl);
+    }
 }
 
 _impl::History* Transaction::get_history() const
@@ -454,7 +754,7 @@ std::unique_ptr<TableView> Transaction::import_copy_of(TableView& tv, PayloadPol
     return tv.clone_for_handover(this, policy);
 }
 
-void Transaction::upgrade_file_format(int target_file_format_version)
+void Transaction::upgrade_file_format(int target_file_format_version, size_t chunk_size)
 {
     REALM_ASSERT(is_attached());
     if (fake_target_file_format && *fake_target_file_format == target_file_format_version) {
@@ -465,7 +765,7 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // Be sure to revisit the following upgrade logic when a new file format
     // version is introduced. The following assert attempt to help you not
     // forget it.
-    REALM_ASSERT_EX(target_file_format_version == 22, target_file_format_version);
+    REALM_ASSERT_EX(target_file_format_version == 22 || target_file_format_version == 23, target_file_format_version);
 
     // DB::do_open() must ensure that only supported version are allowed.
     // It does that by asking backup if the current file format version is
@@ -492,12 +792,15 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // Upgrade from version prior to 10 (Cluster based db)
     if (current_file_format_version <= 9 && target_file_format_version >= 10) {
         DisableReplication disable_replication(*this);
+        if (chunk_size == 0)
+            chunk_size = npos;
 
         std::vector<TableRef> table_accessors;
         TableRef pk_table;
         TableRef progress_info;
         ColKey col_objects;
         ColKey col_links;
+        ColKey col_links_progress;
         std::map<TableRef, ColKey> pk_cols;
 
         // Use table lookup by name. The table keys are not generated yet
@@ -531,7 +834,8 @@ void Transaction::upgrade_file_format(int target_file_format_version)
                 pk_table->migrate_column_info();
                 pk_table->migrate_indexes(ColKey());
                 pk_table->create_columns();
-                pk_table->migrate_objects();
+                bool no_links;
+                pk_table->migrate_objects(no_links);
                 pk_cols = get_primary_key_columns_from_pk_table(pk_table);
             }
 
@@ -552,6 +856,11 @@ void Transaction::upgrade_file_format(int target_file_format_version)
             }
             col_objects = progress_info->get_column_key("objects_migrated");
             col_links = progress_info->get_column_key("links_migrated");
+            col_links_progress = progress_info->get_column_key("links_progress");
+        }
+        if (!col_links_progress) {
+            // Not present if the upgrade was started by an older version
+            col_links_progress = progress_info->add_column(type_Int, "links_progress");
         }
 
         bool updates = false;
@@ -564,11 +873,15 @@ void Transaction::upgrade_file_format(int target_file_format_version)
             commit_and_continue_writing();
         }
 
-        // Migrate objects
+        // Migrate objects. Large tables are migrated in chunks of chunk_size
+        // objects, each in its own commit, so that an interrupted upgrade loses
+        // at most one chunk of work when it is resumed.
         for (auto k : table_accessors) {
             auto progress_status = progress_info->create_object_with_primary_key(k->get_name());
             if (!progress_status.get<bool>(col_objects)) {
-                bool no_links = k->migrate_objects();
+                bool no_links;
+                while (!k->migrate_objects(no_links, chunk_size))
+                    commit_and_continue_writing();
                 progress_status.set(col_objects, true);
                 progress_status.set(col_links, no_links);
                 commit_and_continue_writing();
@@ -577,7 +890,13 @@ void Transaction::upgrade_file_format(int target_file_format_version)
         for (auto k : table_accessors) {
             auto progress_status = progress_info->create_object_with_primary_key(k->get_name());
             if (!progress_status.get<bool>(col_links)) {
-                k->migrate_links();
+                // Adding to a link list is not idempotent, so the position to
+                // continue from is committed along with each chunk
+                size_t next = size_t(progress_status.get<Int>(col_links_progress));
+                while ((next = k->migrate_links(next, chunk_size)) != npos) {
+                    progress_status.set(col_links_progress, int64_t(next));
+                    commit_and_continue_writing();
+                }
                 progress_status.set(col_links, true);
                 commit_and_continue_writing();
             }
@@ -635,7 +954,7 @@ void Transaction::promote_to_async()
     }
 }
 
-void Transaction::replicate(Transaction* dest, Replication& repl) const
+std::vector<TableKey> Transaction::replicate_schema(Replication& repl) const
 {
     // We should only create entries for public tables
     std::vector<TableKey> public_table_keys;
@@ -677,13 +996,14 @@ void Transaction::replicate(Transaction* dest, Replication& repl) const
                                table->get_opposite_table(col).unchecked_ptr());
         }
     }
+    return public_table_keys;
+}
+
+void Transaction::replicate(Transaction* dest, Replication& repl) const
+{
+    auto public_table_keys = replicate_schema(repl);
     dest->commit_and_continue_writing();
     // Now the schema should be in place - create the objects
-#ifdef REALM_DEBUG
-    constexpr int number_of_objects_to_create_before_committing = 100;
-#else
-    constexpr int number_of_objects_to_create_before_committing = 1000;
-#endif
     auto n = number_of_objects_to_create_before_committing;
     for (auto tk : public_table_keys) {
         auto table = get_table(tk);
@@ -729,6 +1049,77 @@ void Transaction::complete_async_commit()
     }
 }
 
+void Transaction::async_sync_commits(util::UniqueFunction<void(std::exception_ptr)> when_synchronized)
+{
+    util::CheckedLockGuard lck(m_async_mutex);
+    REALM_ASSERT(m_async_stage == AsyncState::HasCommits);
+    REALM_ASSERT(m_oldest_version_not_persisted);
+    // the read lock refers to the latest commit, also if a new write has begun
+    DB::ReadLockInfo sync_lock;
+    db->grab_read_lock(sync_lock, VersionID(m_read_lock.m_version, m_read_lock.m_reader_idx)); // Throws
+    // The sync runs concurrently with further writes in this transaction, which
+    // change the mappings and size of the shared allocator. So everything the
+    // writer needs from it is set up here, while no write is in progress, and
+    // a separate transaction is used for accessing the file.
+    auto sync = std::make_unique<PendingSync>();
+    try {
+        sync->tr = db->start_read(VersionID(sync_lock.m_version, sync_lock.m_reader_idx)); // Throws
+        sync->writer = std::make_unique<GroupWriter>(*sync->tr);                           // Throws
+        sync->writer->prepare_commit();                                                    // Throws
+    }
+    catch (...) {
+        db->release_read_lock(sync_lock);
+        throw;
+    }
+    ++m_syncs_in_flight;
+    db->async_flush_to_disk([this, sync_lock, sync = std::move(sync), cb = std::move(when_synchronized)]() noexcept {
+        auto error = complete_sync_of_commits(sync_lock, *sync->writer);
+        sync->writer.reset();
+        sync->tr.reset();
+        {
+            util::CheckedLockGuard lck(m_async_mutex);
+            --m_syncs_in_flight;
+            m_async_cv.notify_all();
+        }
+        if (cb)
+            cb(error);
+    });
+}
+
+std::exception_ptr Transaction::complete_sync_of_commits(DB::ReadLockInfo sync_lock, GroupWriter& out) noexcept
+{
+    try {
+        out.commit(sync_lock.m_top_ref); // Throws
+    }
+    catch (...) {
+        util::CheckedLockGuard lck(m_async_mutex);
+        m_async_commit_has_failed = true;
+        db->release_read_lock(sync_lock);
+        return std::current_exception();
+    }
+    // The file now refers to the synced version, so that is the version which must
+    // be protected from later commits until they are synced too.
+    util::CheckedLockGuard lck(m_async_mutex);
+    if (m_oldest_version_not_persisted)
+        db->release_read_lock(*m_oldest_version_not_persisted);
+    if (db->get_version_of_latest_snapshot() != sync_lock.m_version) {
+        m_oldest_version_not_persisted = sync_lock;
+    }
+    else {
+        // No commits since the one synced
+        m_oldest_version_not_persisted.reset();
+        db->release_read_lock(sync_lock);
+    }
+    return nullptr;
+}
+
+void Transaction::wait_for_syncs_in_flight(std::unique_lock<std::mutex>& lck)
+{
+    m_async_cv.wait(lck, [this]() REQUIRES(m_async_mutex) {
+        return m_syncs_in_flight == 0;
+    });
+}
+
 void Transaction::async_complete_writes(util::UniqueFunction<void()> when_synchronized)
 {
     util::CheckedLockGuard lck(m_async_mutex);
@@ -759,6 +1150,7 @@ void Transaction::async_complete_writes(util::UniqueFunction<void()> when_synchr
 void Transaction::prepare_for_close()
 {
     util::CheckedLockGuard lck(m_async_mutex);
+    wait_for_syncs_in_flight(lck.native_handle());
     switch (m_async_stage) {
         case AsyncState::Idle:
             break;
@@ -855,6 +1247,7 @@ void Transaction::do_end_read() noexcept
         db->leak_read_lock(*m_oldest_version_not_persisted);
     }
     db->release_read_lock(m_read_lock);
+    db->unregister_reader(m_reader_pin);
 
     m_alloc.note_reader_end(this);
     set_transact_stage(DB::transact_Ready);
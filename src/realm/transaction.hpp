@@ -21,6 +21,8 @@
 
 #include <realm/db.hpp>
 
+#include <set>
+
 namespace realm {
 class Transaction : public Group {
 public:
@@ -82,12 +84,35 @@ public:
         _impl::NullInstructionObserver* o = nullptr;
         return promote_to_write(o, nonblocking);
     }
+
+    /// The tables and objects which the work of an optimistic write has read.
+    /// A table in `tables` conflicts with any change to the table, including
+    /// objects being created or removed, while an object in `objects` only
+    /// conflicts with changes to that object. Backlinks are not tracked, as
+    /// they change with the links of other objects.
+    struct ReadSet {
+        std::set<TableKey> tables;
+        std::set<std::pair<TableKey, ObjKey>> objects;
+    };
+    /// Promote to a write transaction as promote_to_write() does, unless a
+    /// commit made after the version of this transaction has changed anything
+    /// in `read_set`. This lets a long computation run in a read transaction,
+    /// without holding the write lock, and only take the lock to store its
+    /// result. On a conflict, false is returned and the transaction is left
+    /// reading the latest version, so that the computation can be redone.
+    bool promote_to_write_if_unchanged(const ReadSet& read_set) REQUIRES(!m_async_mutex);
     TransactionRef freeze();
     // Frozen transactions are created by freeze() or DB::start_frozen()
     bool is_frozen() const noexcept override
     {
         return m_transact_stage == DB::transact_Frozen;
     }
+    /// True if DBOptions::stale_reader_policy has invalidated the transaction
+    /// for reading an old version for too long. It should then be ended.
+    bool is_invalidated() const noexcept
+    {
+        return m_reader_pin.invalidated.load(std::memory_order_relaxed);
+    }
     bool is_async() noexcept REQUIRES(!m_async_mutex)
     {
         util::CheckedLockGuard lck(m_async_mutex);
@@ -121,7 +146,9 @@ public:
         return m_transact_stage;
     }
 
-    void upgrade_file_format(int target_file_format_version);
+    // Objects are migrated in chunks of at most chunk_size objects, each
+    // committed separately.
+    void upgrade_file_format(int target_file_format_version, size_t chunk_size = npos);
     void check_consistency() REQUIRES(!m_async_mutex);
 
     /// Task oriented/async interface for continuous transactions.
@@ -140,6 +167,21 @@ public:
     // The write mutex is released after full synchronization.
     void async_complete_writes(util::UniqueFunction<void()> when_synchronized = nullptr) REQUIRES(!m_async_mutex);
 
+    // request full synchronization to stable storage for all writes done so far,
+    // but keep the write mutex. Further writes can be committed while the
+    // synchronization is in progress. 'when_synchronized' is called from the
+    // thread doing the synchronization, and is passed the error if it failed.
+    // The transaction must have commits which are not yet synchronized.
+    void async_sync_commits(util::UniqueFunction<void(std::exception_ptr)> when_synchronized)
+        REQUIRES(!m_async_mutex);
+
+    // true if a synchronization requested by async_sync_commits() is in progress
+    bool has_syncs_in_flight() noexcept REQUIRES(!m_async_mutex)
+    {
+        util::CheckedLockGuard lck(m_async_mutex);
+        return m_syncs_in_flight > 0;
+    }
+
     // Complete all pending async work and return once the async stage is Idle.
     // If currently in an async write transaction that transaction is cancelled,
     // and any async writes which were committed are synchronized.
@@ -183,10 +225,20 @@ private:
     bool internal_advance_read(O* observer, VersionID target_version, _impl::History&, bool);
     void set_transact_stage(DB::TransactStage stage) noexcept;
     void do_end_read() noexcept REQUIRES(!m_async_mutex);
+    void end_read_if_invalidated() REQUIRES(!m_async_mutex);
     void initialize_replication();
+    void run_before_commit();
 
+    std::vector<TableKey> replicate_schema(Replication& repl) const;
     void replicate(Transaction* dest, Replication& repl) const;
     void complete_async_commit();
+    // A sync requested by async_sync_commits(), set up while no write is in progress
+    struct PendingSync {
+        TransactionRef tr;
+        std::unique_ptr<GroupWriter> writer; // Refers to 'tr', so it is destroyed first
+    };
+    std::exception_ptr complete_sync_of_commits(DB::ReadLockInfo, GroupWriter&) noexcept;
+    void wait_for_syncs_in_flight(std::unique_lock<std::mutex>&) REQUIRES(m_async_mutex);
     void acquire_write_lock() REQUIRES(!m_async_mutex);
 
     DBRef db;
@@ -194,6 +246,7 @@ private:
     mutable _impl::History* m_history = nullptr;
 
     DB::ReadLockInfo m_read_lock;
+    DB::ReaderPin m_reader_pin;
     util::Optional<DB::ReadLockInfo> m_oldest_version_not_persisted;
     std::exception_ptr m_commit_exception GUARDED_BY(m_async_mutex);
     bool m_async_commit_has_failed = false;
@@ -204,6 +257,7 @@ private:
     AsyncState m_async_stage GUARDED_BY(m_async_mutex) = AsyncState::Idle;
     bool m_waiting_for_write_lock GUARDED_BY(m_async_mutex) = false;
     bool m_waiting_for_sync GUARDED_BY(m_async_mutex) = false;
+    size_t m_syncs_in_flight GUARDED_BY(m_async_mutex) = 0;
 
     DB::TransactStage m_transact_stage = DB::transact_Ready;
 
@@ -333,6 +387,7 @@ private:
 template <class O>
 inline void Transaction::advance_read(O* observer, VersionID version_id)
 {
+    end_read_if_invalidated();
     if (m_transact_stage != DB::transact_Reading)
         throw LogicError(LogicError::wrong_transact_state);
 
@@ -350,6 +405,7 @@ inline void Transaction::advance_read(O* observer, VersionID version_id)
 template <class O>
 inline bool Transaction::promote_to_write(O* observer, bool nonblocking)
 {
+    end_read_if_invalidated();
     if (m_transact_stage != DB::transact_Reading)
         throw LogicError(LogicError::wrong_transact_state);
 
@@ -491,6 +547,7 @@ inline bool Transaction::internal_advance_read(O* observer, VersionID version_id
     g.release();
     db->release_read_lock(m_read_lock);
     m_read_lock = new_read_lock;
+    DB::note_reader_version(m_reader_pin, m_read_lock);
 
     return true; // _impl::History::update_early_from_top_ref() was called
 }
@@ -39,6 +39,16 @@
 #include <locale>
 #endif
 
+#ifdef REALM_COMPILER_SSE
+#include <emmintrin.h> // SSE2
+#endif
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h> // AVX2, only used from functions compiled with REALM_TARGET_AVX2
+#endif
+#ifdef REALM_COMPILER_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace realm;
 
 namespace {
@@ -155,56 +165,60 @@ uint32_t utf8value(const char* character)
     return res;
 }
 
+namespace {
+
+// These collation_order arrays have 592 entries; one entry per unicode character in the range 0...591
+// (upto and including 'Latin Extended 2'). The value tells what 'sorting order rank' the character
+// has, such that unichar1 < unichar2 implies collation_order[unichar1] < collation_order[unichar2]. The
+// array is generated from the table found at ftp://ftp.unicode.org/Public/UCA/latest/allkeys.txt. At the
+// bottom of this file you can find source code that reads such a file and translates it into C++ that
+// you can copy/paste in case the official table should get updated.
+//
+// NOTE: Some numbers in the array are vere large. This is because the value is the *global* rank of the
+// almost full unicode set. An optimization could be to 'normalize' all values so they ranged from
+// 0...591 so they would fit in a uint16_t array instead of uint32_t.
+//
+// It groups all characters that look visually identical, that is, it puts `a, ‡, Â` together and before
+// `¯, o, ˆ`. Note that this sorting method is wrong in some countries, such as Denmark where `Â` must
+// come last. NOTE: This is a limitation of STRING_COMPARE_CORE until we get better such 'locale' support.
+
+// clang-format off
+const uint32_t collation_order_core_similar[last_latin_extended_2_unicode + 1] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 456, 457, 458, 459, 460, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 461, 462, 463, 464, 8130, 465, 466, 467,
+    468, 469, 470, 471, 472, 473, 474, 475, 8178, 8248, 8433, 8569, 8690, 8805, 8912, 9002, 9093, 9182, 476, 477, 478, 479, 480, 481, 482, 9290, 9446, 9511, 9595, 9690, 9818, 9882, 9965, 10051, 10156, 10211, 10342, 10408, 10492, 10588,
+    10752, 10828, 10876, 10982, 11080, 11164, 11304, 11374, 11436, 11493, 11561, 483, 484, 485, 486, 487, 488, 9272, 9428, 9492, 9575, 9671, 9800, 9864, 9947, 10030, 10138, 10193, 10339, 10389, 10474, 10570, 10734, 10811, 10857, 10964, 11062, 11146, 11285, 11356,
+    11417, 11476, 11543, 489, 490, 491, 492, 27, 28, 29, 30, 31, 32, 493, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58,
+    494, 495, 8128, 8133, 8127, 8135, 496, 497, 498, 499, 9308, 500, 501, 59, 502, 503, 504, 505, 8533, 8669, 506, 12018, 507, 508, 509, 8351, 10606, 510, 8392, 8377, 8679, 511, 9317, 9315, 9329, 9353, 9348, 9341, 9383, 9545,
+    9716, 9714, 9720, 9732, 10078, 10076, 10082, 10086, 9635, 10522, 10615, 10613, 10619, 10640, 10633, 512, 10652, 11190, 11188, 11194, 11202, 11515, 11624, 11038, 9316, 9314, 9328, 9352, 9345, 9340, 9381, 9543, 9715, 9713, 9719, 9731, 10077, 10075, 10081, 10085,
+    9633, 10521, 10614, 10612, 10618, 10639, 10630, 513, 10651, 11189, 11187, 11193, 11199, 11514, 11623, 11521, 9361, 9360, 9319, 9318, 9359, 9358, 9536, 9535, 9538, 9537, 9542, 9541, 9540, 9539, 9620, 9619, 9626, 9625, 9744, 9743, 9718, 9717, 9736, 9735,
+    9742, 9741, 9730, 9729, 9909, 9908, 9907, 9906, 9913, 9912, 9915, 9914, 9989, 9988, 10000, 9998, 10090, 10089, 10095, 10094, 10080, 10079, 10093, 10092, 10091, 10120, 10113, 10112, 10180, 10179, 10240, 10239, 10856, 10322, 10321, 10326, 10325, 10324, 10323, 10340,
+    10337, 10328, 10327, 10516, 10515, 10526, 10525, 10520, 10519, 11663, 10567, 10566, 10660, 10659, 10617, 10616, 10638, 10637, 10689, 10688, 10901, 10900, 10907, 10906, 10903, 10902, 11006, 11005, 11010, 11009, 11018, 11017, 11012, 11011, 11109, 11108, 11104, 11103, 11132, 11131,
+    11215, 11214, 11221, 11220, 11192, 11191, 11198, 11197, 11213, 11212, 11219, 11218, 11401, 11400, 11519, 11518, 11522, 11583, 11582, 11589, 11588, 11587, 11586, 11027, 9477, 9486, 9488, 9487, 11657, 11656, 10708, 9568, 9567, 9662, 9664, 9667, 9666, 11594, 9774, 9779,
+    9784, 9860, 9859, 9937, 9943, 10014, 10135, 10129, 10266, 10265, 10363, 10387, 11275, 10554, 10556, 10723, 10673, 10672, 9946, 9945, 10802, 10801, 10929, 11653, 11652, 11054, 11058, 11136, 11139, 11138, 11141, 11232, 11231, 11282, 11347, 11537, 11536, 11597, 11596, 11613,
+    11619, 11618, 11621, 11645, 11655, 11654, 11125, 11629, 11683, 11684, 11685, 11686, 9654, 9653, 9652, 10345, 10344, 10343, 10541, 10540, 10539, 9339, 9338, 10084, 10083, 10629, 10628, 11196, 11195, 11211, 11210, 11205, 11204, 11209, 11208, 11207, 11206, 9773, 9351, 9350,
+    9357, 9356, 9388, 9387, 9934, 9933, 9911, 9910, 10238, 10237, 10656, 10655, 10658, 10657, 11616, 11615, 10181, 9651, 9650, 9648, 9905, 9904, 10015, 11630, 10518, 10517, 9344, 9343, 9386, 9385, 10654, 10653, 9365, 9364, 9367, 9366, 9752, 9751, 9754, 9753,
+    10099, 10098, 10101, 10100, 10669, 10668, 10671, 10670, 10911, 10910, 10913, 10912, 11228, 11227, 11230, 11229, 11026, 11025, 11113, 11112, 11542, 11541, 9991, 9990, 10557, 9668, 10731, 10730, 11601, 11600, 9355, 9354, 9738, 9737, 10636, 10635, 10646, 10645, 10648, 10647,
+    10650, 10649, 11528, 11527, 10382, 10563, 11142, 10182, 9641, 10848, 9409, 9563, 9562, 10364, 11134, 11048, 11606, 11660, 11659, 9478, 11262, 11354, 9769, 9768, 10186, 10185, 10855, 10854, 10936, 10935, 11535, 11534
+};
+
+const uint32_t collation_order_core[last_latin_extended_2_unicode + 1] = {
+    0, 2, 3, 4, 5, 6, 7, 8, 9, 33, 34, 35, 36, 37, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 31, 38, 39, 40, 41, 42, 43, 29, 44, 45, 46, 76, 47, 30, 48, 49, 128, 132, 134, 137, 139, 140, 143, 144, 145, 146, 50, 51, 77, 78, 79, 52, 53, 148, 182, 191, 208, 229, 263, 267, 285, 295, 325, 333, 341, 360, 363, 385, 429, 433, 439, 454, 473, 491, 527, 531, 537, 539, 557, 54, 55, 56, 57, 58, 59, 147, 181, 190, 207,
+    228, 262, 266, 284, 294, 324, 332, 340, 359, 362, 384, 428, 432, 438, 453, 472, 490, 526, 530, 536, 538, 556, 60, 61, 62, 63, 28, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 32, 64, 72, 73, 74, 75, 65, 88, 66, 89, 149, 81, 90, 1, 91, 67, 92, 80, 136, 138, 68, 93, 94, 95, 69, 133, 386, 82, 129, 130, 131, 70, 153, 151, 157, 165, 575, 588, 570, 201, 233,
+    231, 237, 239, 300, 298, 303, 305, 217, 371, 390, 388, 394, 402, 584, 83, 582, 495, 493, 497, 555, 541, 487, 470, 152, 150, 156, 164, 574, 587, 569, 200, 232, 230, 236, 238, 299, 297, 302, 304, 216, 370, 389, 387, 393, 401, 583, 84, 581, 494, 492, 496, 554, 540, 486, 544, 163, 162, 161, 160, 167, 166, 193, 192, 197, 196, 195, 194, 199, 198, 210, 209, 212, 211, 245, 244, 243, 242, 235, 234, 247, 246, 241, 240, 273, 272, 277, 276, 271, 270, 279, 278, 287, 286, 291, 290, 313, 312, 311, 310, 309,
+    308, 315, 314, 301, 296, 323, 322, 328, 327, 337, 336, 434, 343, 342, 349, 348, 347, 346, 345, 344, 353, 352, 365, 364, 373, 372, 369, 368, 375, 383, 382, 400, 399, 398, 397, 586, 585, 425, 424, 442, 441, 446, 445, 444, 443, 456, 455, 458, 457, 462, 461, 460, 459, 477, 476, 475, 474, 489, 488, 505, 504, 503, 502, 501, 500, 507, 506, 549, 548, 509, 508, 533, 532, 543, 542, 545, 559, 558, 561, 560, 563, 562, 471, 183, 185, 187, 186, 189, 188, 206, 205, 204, 226, 215, 214, 213, 218, 257, 258, 259,
+    265, 264, 282, 283, 292, 321, 316, 339, 338, 350, 354, 361, 374, 376, 405, 421, 420, 423, 422, 431, 430, 440, 468, 467, 466, 469, 480, 479, 478, 481, 524, 523, 525, 528, 553, 552, 565, 564, 571, 579, 578, 580, 135, 142, 141, 589, 534, 85, 86, 87, 71, 225, 224, 223, 357, 356, 355, 380, 379, 378, 159, 158, 307, 306, 396, 395, 499, 498, 518, 517, 512, 511, 516, 515, 514, 513, 256, 174, 173, 170, 169, 573, 572, 281, 280, 275, 274, 335, 334, 404, 403, 415, 414, 577, 576, 329, 222, 221, 220, 269,
+    268, 293, 535, 367, 366, 172, 171, 180, 179, 411, 410, 176, 175, 178, 177, 253, 252, 255, 254, 318, 317, 320, 319, 417, 416, 419, 418, 450, 449, 452, 451, 520, 519, 522, 521, 464, 463, 483, 482, 261, 260, 289, 288, 377, 227, 427, 426, 567, 566, 155, 154, 249, 248, 409, 408, 413, 412, 392, 391, 407, 406, 547, 546, 358, 381, 485, 326, 219, 437, 168, 203, 202, 351, 484, 465, 568, 591, 590, 184, 510, 529, 251, 250, 331, 330, 436, 435, 448, 447, 551, 550
+};
+// clang-format on
+
+} // anonymous namespace
+
 // Returns bool(string1 < string2) for utf-8
 bool utf8_compare(StringData string1, StringData string2)
 {
     const char* s1 = string1.data();
     const char* s2 = string2.data();
 
-    // This collation_order array has 592 entries; one entry per unicode character in the range 0...591
-    // (upto and including 'Latin Extended 2'). The value tells what 'sorting order rank' the character
-    // has, such that unichar1 < unichar2 implies collation_order[unichar1] < collation_order[unichar2]. The
-    // array is generated from the table found at ftp://ftp.unicode.org/Public/UCA/latest/allkeys.txt. At the
-    // bottom of unicode.cpp you can find source code that reads such a file and translates it into C++ that
-    // you can copy/paste in case the official table should get updated.
-    //
-    // NOTE: Some numbers in the array are vere large. This is because the value is the *global* rank of the
-    // almost full unicode set. An optimization could be to 'normalize' all values so they ranged from
-    // 0...591 so they would fit in a uint16_t array instead of uint32_t.
-    //
-    // It groups all characters that look visually identical, that is, it puts `a, ‡, Â` together and before
-    // `¯, o, ˆ`. Note that this sorting method is wrong in some countries, such as Denmark where `Â` must
-    // come last. NOTE: This is a limitation of STRING_COMPARE_CORE until we get better such 'locale' support.
-
-    // clang-format off
-    static const uint32_t collation_order_core_similar[last_latin_extended_2_unicode + 1] = {
-        0, 1, 2, 3, 4, 5, 6, 7, 8, 456, 457, 458, 459, 460, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 461, 462, 463, 464, 8130, 465, 466, 467,
-        468, 469, 470, 471, 472, 473, 474, 475, 8178, 8248, 8433, 8569, 8690, 8805, 8912, 9002, 9093, 9182, 476, 477, 478, 479, 480, 481, 482, 9290, 9446, 9511, 9595, 9690, 9818, 9882, 9965, 10051, 10156, 10211, 10342, 10408, 10492, 10588,
-        10752, 10828, 10876, 10982, 11080, 11164, 11304, 11374, 11436, 11493, 11561, 483, 484, 485, 486, 487, 488, 9272, 9428, 9492, 9575, 9671, 9800, 9864, 9947, 10030, 10138, 10193, 10339, 10389, 10474, 10570, 10734, 10811, 10857, 10964, 11062, 11146, 11285, 11356,
-        11417, 11476, 11543, 489, 490, 491, 492, 27, 28, 29, 30, 31, 32, 493, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58,
-        494, 495, 8128, 8133, 8127, 8135, 496, 497, 498, 499, 9308, 500, 501, 59, 502, 503, 504, 505, 8533, 8669, 506, 12018, 507, 508, 509, 8351, 10606, 510, 8392, 8377, 8679, 511, 9317, 9315, 9329, 9353, 9348, 9341, 9383, 9545,
-        9716, 9714, 9720, 9732, 10078, 10076, 10082, 10086, 9635, 10522, 10615, 10613, 10619, 10640, 10633, 512, 10652, 11190, 11188, 11194, 11202, 11515, 11624, 11038, 9316, 9314, 9328, 9352, 9345, 9340, 9381, 9543, 9715, 9713, 9719, 9731, 10077, 10075, 10081, 10085,
-        9633, 10521, 10614, 10612, 10618, 10639, 10630, 513, 10651, 11189, 11187, 11193, 11199, 11514, 11623, 11521, 9361, 9360, 9319, 9318, 9359, 9358, 9536, 9535, 9538, 9537, 9542, 9541, 9540, 9539, 9620, 9619, 9626, 9625, 9744, 9743, 9718, 9717, 9736, 9735,
-        9742, 9741, 9730, 9729, 9909, 9908, 9907, 9906, 9913, 9912, 9915, 9914, 9989, 9988, 10000, 9998, 10090, 10089, 10095, 10094, 10080, 10079, 10093, 10092, 10091, 10120, 10113, 10112, 10180, 10179, 10240, 10239, 10856, 10322, 10321, 10326, 10325, 10324, 10323, 10340,
-        10337, 10328, 10327, 10516, 10515, 10526, 10525, 10520, 10519, 11663, 10567, 10566, 10660, 10659, 10617, 10616, 10638, 10637, 10689, 10688, 10901, 10900, 10907, 10906, 10903, 10902, 11006, 11005, 11010, 11009, 11018, 11017, 11012, 11011, 11109, 11108, 11104, 11103, 11132, 11131,
-        11215, 11214, 11221, 11220, 11192, 11191, 11198, 11197, 11213, 11212, 11219, 11218, 11401, 11400, 11519, 11518, 11522, 11583, 11582, 11589, 11588, 11587, 11586, 11027, 9477, 9486, 9488, 9487, 11657, 11656, 10708, 9568, 9567, 9662, 9664, 9667, 9666, 11594, 9774, 9779,
-        9784, 9860, 9859, 9937, 9943, 10014, 10135, 10129, 10266, 10265, 10363, 10387, 11275, 10554, 10556, 10723, 10673, 10672, 9946, 9945, 10802, 10801, 10929, 11653, 11652, 11054, 11058, 11136, 11139, 11138, 11141, 11232, 11231, 11282, 11347, 11537, 11536, 11597, 11596, 11613,
-        11619, 11618, 11621, 11645, 11655, 11654, 11125, 11629, 11683, 11684, 11685, 11686, 9654, 9653, 9652, 10345, 10344, 10343, 10541, 10540, 10539, 9339, 9338, 10084, 10083, 10629, 10628, 11196, 11195, 11211, 11210, 11205, 11204, 11209, 11208, 11207, 11206, 9773, 9351, 9350,
-        9357, 9356, 9388, 9387, 9934, 9933, 9911, 9910, 10238, 10237, 10656, 10655, 10658, 10657, 11616, 11615, 10181, 9651, 9650, 9648, 9905, 9904, 10015, 11630, 10518, 10517, 9344, 9343, 9386, 9385, 10654, 10653, 9365, 9364, 9367, 9366, 9752, 9751, 9754, 9753,
-        10099, 10098, 10101, 10100, 10669, 10668, 10671, 10670, 10911, 10910, 10913, 10912, 11228, 11227, 11230, 11229, 11026, 11025, 11113, 11112, 11542, 11541, 9991, 9990, 10557, 9668, 10731, 10730, 11601, 11600, 9355, 9354, 9738, 9737, 10636, 10635, 10646, 10645, 10648, 10647,
-        10650, 10649, 11528, 11527, 10382, 10563, 11142, 10182, 9641, 10848, 9409, 9563, 9562, 10364, 11134, 11048, 11606, 11660, 11659, 9478, 11262, 11354, 9769, 9768, 10186, 10185, 10855, 10854, 10936, 10935, 11535, 11534
-    };
-
-    static const uint32_t collation_order_core[last_latin_extended_2_unicode + 1] = {
-        0, 2, 3, 4, 5, 6, 7, 8, 9, 33, 34, 35, 36, 37, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 31, 38, 39, 40, 41, 42, 43, 29, 44, 45, 46, 76, 47, 30, 48, 49, 128, 132, 134, 137, 139, 140, 143, 144, 145, 146, 50, 51, 77, 78, 79, 52, 53, 148, 182, 191, 208, 229, 263, 267, 285, 295, 325, 333, 341, 360, 363, 385, 429, 433, 439, 454, 473, 491, 527, 531, 537, 539, 557, 54, 55, 56, 57, 58, 59, 147, 181, 190, 207,
-        228, 262, 266, 284, 294, 324, 332, 340, 359, 362, 384, 428, 432, 438, 453, 472, 490, 526, 530, 536, 538, 556, 60, 61, 62, 63, 28, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 32, 64, 72, 73, 74, 75, 65, 88, 66, 89, 149, 81, 90, 1, 91, 67, 92, 80, 136, 138, 68, 93, 94, 95, 69, 133, 386, 82, 129, 130, 131, 70, 153, 151, 157, 165, 575, 588, 570, 201, 233,
-        231, 237, 239, 300, 298, 303, 305, 217, 371, 390, 388, 394, 402, 584, 83, 582, 495, 493, 497, 555, 541, 487, 470, 152, 150, 156, 164, 574, 587, 569, 200, 232, 230, 236, 238, 299, 297, 302, 304, 216, 370, 389, 387, 393, 401, 583, 84, 581, 494, 492, 496, 554, 540, 486, 544, 163, 162, 161, 160, 167, 166, 193, 192, 197, 196, 195, 194, 199, 198, 210, 209, 212, 211, 245, 244, 243, 242, 235, 234, 247, 246, 241, 240, 273, 272, 277, 276, 271, 270, 279, 278, 287, 286, 291, 290, 313, 312, 311, 310, 309,
-        308, 315, 314, 301, 296, 323, 322, 328, 327, 337, 336, 434, 343, 342, 349, 348, 347, 346, 345, 344, 353, 352, 365, 364, 373, 372, 369, 368, 375, 383, 382, 400, 399, 398, 397, 586, 585, 425, 424, 442, 441, 446, 445, 444, 443, 456, 455, 458, 457, 462, 461, 460, 459, 477, 476, 475, 474, 489, 488, 505, 504, 503, 502, 501, 500, 507, 506, 549, 548, 509, 508, 533, 532, 543, 542, 545, 559, 558, 561, 560, 563, 562, 471, 183, 185, 187, 186, 189, 188, 206, 205, 204, 226, 215, 214, 213, 218, 257, 258, 259,
-        265, 264, 282, 283, 292, 321, 316, 339, 338, 350, 354, 361, 374, 376, 405, 421, 420, 423, 422, 431, 430, 440, 468, 467, 466, 469, 480, 479, 478, 481, 524, 523, 525, 528, 553, 552, 565, 564, 571, 579, 578, 580, 135, 142, 141, 589, 534, 85, 86, 87, 71, 225, 224, 223, 357, 356, 355, 380, 379, 378, 159, 158, 307, 306, 396, 395, 499, 498, 518, 517, 512, 511, 516, 515, 514, 513, 256, 174, 173, 170, 169, 573, 572, 281, 280, 275, 274, 335, 334, 404, 403, 415, 414, 577, 576, 329, 222, 221, 220, 269,
-        268, 293, 535, 367, 366, 172, 171, 180, 179, 411, 410, 176, 175, 178, 177, 253, 252, 255, 254, 318, 317, 320, 319, 417, 416, 419, 418, 450, 449, 452, 451, 520, 519, 522, 521, 464, 463, 483, 482, 261, 260, 289, 288, 377, 227, 427, 426, 567, 566, 155, 154, 249, 248, 409, 408, 413, 412, 392, 391, 407, 406, 547, 546, 358, 381, 485, 326, 219, 437, 168, 203, 202, 351, 484, 465, 568, 591, 590, 184, 510, 529, 251, 250, 331, 330, 436, 435, 448, 447, 551, 550
-    };
-    // clang-format on
-
     bool use_internal_sort_order =
         (string_compare_method == STRING_COMPARE_CORE) || (string_compare_method == STRING_COMPARE_CORE_SIMILAR);
 
@@ -274,6 +288,36 @@ bool utf8_compare(StringData string1, StringData string2)
     return false;
 }
 
+bool utf8_sort_key(StringData string, std::string& key)
+{
+    const uint32_t* internal_collation_order;
+    if (string_compare_method == STRING_COMPARE_CORE)
+        internal_collation_order = collation_order_core;
+    else if (string_compare_method == STRING_COMPARE_CORE_SIMILAR)
+        internal_collation_order = collation_order_core_similar;
+    else
+        return false;
+
+    // Characters beyond 'Latin Extended 2' are ordered by unicode value after all others, as in utf8_compare()
+    constexpr uint32_t beyond_collation_order = 12019;
+    key.clear();
+    key.reserve(string.size() * 3);
+    const char* s = string.data();
+    const char* end = s + string.size();
+    while (s < end) {
+        size_t len = sequence_length(s[0]);
+        if (size_t(end - s) < len)
+            break; // invalid utf8
+        uint32_t c = utf8value(s);
+        uint32_t weight = c <= last_latin_extended_2_unicode ? internal_collation_order[c] : c + beyond_collation_order;
+        key += char(weight >> 16);
+        key += char(weight >> 8);
+        key += char(weight);
+        s += len;
+    }
+    return true;
+}
+
 // Here is a version for Windows that may be closer to what is ultimately needed.
 /*
 bool case_map(const char* begin, const char* end, StringBuffer& dest, bool upper)
@@ -445,11 +489,17 @@ std::string case_map(StringData source, bool upper, IgnoreErrorsTag)
 // spirit to std::equal().
 bool equal_case_fold(StringData haystack, const char* needle_upper, const char* needle_lower)
 {
+    unsigned char non_ascii = 0;
     for (size_t i = 0; i != haystack.size(); ++i) {
         char c = haystack[i];
         if (needle_lower[i] != c && needle_upper[i] != c)
             return false;
+        non_ascii |= static_cast<unsigned char>(c);
     }
+    // Every character of an ASCII haystack is a single byte, so the byte
+    // compare was enough
+    if (non_ascii < 0x80)
+        return true;
 
     const char* begin = haystack.data();
     const char* end = begin + haystack.size();
@@ -463,12 +513,115 @@ bool equal_case_fold(StringData haystack, const char* needle_upper, const char*
 }
 
 
+namespace {
+
+// The vector kernels below test a block of candidate positions at a time for
+// a match of the first and the last byte of the needle (in either case), and
+// only verify the candidates that pass both with equal_case_fold(). They
+// return the first match, or the size of the haystack (with 'pos' at the
+// first position not tested) once the rest is too short for a full block.
+
+#ifdef REALM_COMPILER_AVX
+REALM_TARGET_AVX2 size_t search_case_fold_avx2(StringData haystack, const char* needle_upper, const char* needle_lower,
+                                               size_t needle_size, size_t& pos)
+{
+    const char* data = haystack.data();
+    const __m256i first_upper = _mm256_set1_epi8(needle_upper[0]);
+    const __m256i first_lower = _mm256_set1_epi8(needle_lower[0]);
+    const __m256i last_upper = _mm256_set1_epi8(needle_upper[needle_size - 1]);
+    const __m256i last_lower = _mm256_set1_epi8(needle_lower[needle_size - 1]);
+    for (; pos + needle_size + 31 <= haystack.size(); pos += 32) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + needle_size - 1));
+        __m256i match = _mm256_and_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(first, first_upper), _mm256_cmpeq_epi8(first, first_lower)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(last, last_upper), _mm256_cmpeq_epi8(last, last_lower)));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(match));
+        while (mask) {
+            size_t candidate = pos + ctz(mask);
+            if (equal_case_fold(haystack.substr(candidate, needle_size), needle_upper, needle_lower))
+                return candidate;
+            mask &= mask - 1;
+        }
+    }
+    return haystack.size();
+}
+#endif
+
+size_t search_case_fold_simd(StringData haystack, const char* needle_upper, const char* needle_lower,
+                             size_t needle_size, size_t& pos)
+{
+    REALM_ASSERT_DEBUG(needle_size != 0);
+#if defined(REALM_COMPILER_SSE)
+#ifdef REALM_COMPILER_AVX
+    if (sseavx<2>()) {
+        size_t found = search_case_fold_avx2(haystack, needle_upper, needle_lower, needle_size, pos);
+        if (found != haystack.size())
+            return found;
+    }
+#endif
+    // SSE2 is part of x86-64, so no runtime check is needed
+    const char* data = haystack.data();
+    const __m128i first_upper = _mm_set1_epi8(needle_upper[0]);
+    const __m128i first_lower = _mm_set1_epi8(needle_lower[0]);
+    const __m128i last_upper = _mm_set1_epi8(needle_upper[needle_size - 1]);
+    const __m128i last_lower = _mm_set1_epi8(needle_lower[needle_size - 1]);
+    for (; pos + needle_size + 15 <= haystack.size(); pos += 16) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + needle_size - 1));
+        __m128i match =
+            _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(first, first_upper), _mm_cmpeq_epi8(first, first_lower)),
+                          _mm_or_si128(_mm_cmpeq_epi8(last, last_upper), _mm_cmpeq_epi8(last, last_lower)));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(match));
+        while (mask) {
+            size_t candidate = pos + ctz(mask);
+            if (equal_case_fold(haystack.substr(candidate, needle_size), needle_upper, needle_lower))
+                return candidate;
+            mask &= mask - 1;
+        }
+    }
+#elif defined(REALM_COMPILER_NEON)
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(haystack.data());
+    const uint8x16_t first_upper = vdupq_n_u8(uint8_t(needle_upper[0]));
+    const uint8x16_t first_lower = vdupq_n_u8(uint8_t(needle_lower[0]));
+    const uint8x16_t last_upper = vdupq_n_u8(uint8_t(needle_upper[needle_size - 1]));
+    const uint8x16_t last_lower = vdupq_n_u8(uint8_t(needle_lower[needle_size - 1]));
+    for (; pos + needle_size + 15 <= haystack.size(); pos += 16) {
+        uint8x16_t first = vld1q_u8(data + pos);
+        uint8x16_t last = vld1q_u8(data + pos + needle_size - 1);
+        uint8x16_t match = vandq_u8(vorrq_u8(vceqq_u8(first, first_upper), vceqq_u8(first, first_lower)),
+                                    vorrq_u8(vceqq_u8(last, last_upper), vceqq_u8(last, last_lower)));
+        // NEON has no movemask, but narrowing each 16 bit lane by 4 bits yields one nibble per byte
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+        while (mask) {
+            size_t offset = size_t(ctz(size_t(mask))) / 4;
+            size_t candidate = pos + offset;
+            if (equal_case_fold(haystack.substr(candidate, needle_size), needle_upper, needle_lower))
+                return candidate;
+            mask &= ~(uint64_t(0xF) << (offset * 4));
+        }
+    }
+#else
+    static_cast<void>(haystack);
+    static_cast<void>(needle_upper);
+    static_cast<void>(needle_lower);
+    static_cast<void>(pos);
+#endif
+    return haystack.size();
+}
+
+} // anonymous namespace
+
 // Test if needle is a substring of haystack. The signature is similar
 // in spirit to std::search().
 size_t search_case_fold(StringData haystack, const char* needle_upper, const char* needle_lower, size_t needle_size)
 {
-    // FIXME: This solution is very inefficient. Consider deploying the Boyer-Moore algorithm.
     size_t i = 0;
+    if (needle_size != 0) {
+        size_t found = search_case_fold_simd(haystack, needle_upper, needle_lower, needle_size, i);
+        if (found != haystack.size())
+            return found;
+    }
     while (needle_size <= haystack.size() - i) {
         if (equal_case_fold(haystack.substr(i, needle_size), needle_upper, needle_lower)) {
             return i;
@@ -486,13 +639,19 @@ bool contains_ins(StringData haystack, const char* needle_upper, const char* nee
     if (needle_size == 0)
         return haystack.size() != 0;
     
+    // Long haystacks are scanned with vector instructions, leaving the
+    // positions that do not fill a vector to the Boyer-Moore search
+    size_t pos = 0;
+    if (search_case_fold_simd(haystack, needle_upper, needle_lower, needle_size, pos) != haystack.size())
+        return true;
+
     // Prepare vars to avoid lookups in loop
     size_t last_char_pos = needle_size-1;
     unsigned char lastCharU = needle_upper[last_char_pos];
     unsigned char lastCharL = needle_lower[last_char_pos];
     
     // Do Boyer-Moore search
-    size_t p = last_char_pos;
+    size_t p = pos + last_char_pos;
     while (p < haystack.size()) {
         unsigned char c = haystack.data()[p]; // Get candidate for last char
         
@@ -533,6 +692,56 @@ bool string_like_ins(StringData text, StringData pattern) noexcept
     return StringData::matchlike_ins(text, lower.c_str(), upper.c_str());
 }
 
+namespace {
+// Characters outside the ASCII range are taken to be letters, apart from the spaces, punctuation and symbols of
+// the blocks that commonly appear in running text
+bool is_word_character(uint32_t c)
+{
+    if (c < 0x80)
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    if (c < 0xC0)
+        return c == 0xAA || c == 0xB2 || c == 0xB3 || c == 0xB5 || c == 0xB9 || c == 0xBA; // Latin-1 letters
+    if (c == 0xD7 || c == 0xF7)                                                           // Multiplication, division
+        return false;
+    if (c >= 0x2000 && c <= 0x2BFF) // General Punctuation up to Miscellaneous Symbols and Arrows
+        return false;
+    if (c >= 0x3000 && c <= 0x303F) // CJK Symbols and Punctuation
+        return false;
+    if (c >= 0xFF00 && c <= 0xFF0F) // Fullwidth punctuation
+        return false;
+    return true;
+}
+} // unnamed namespace
+
+std::vector<std::string> tokenize_words(StringData text)
+{
+    std::vector<std::string> words;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    std::string word;
+    while (p != end) {
+        size_t len = std::min(sequence_length(*p), size_t(end - p));
+        uint32_t c = len == sequence_length(*p) ? utf8value(p) : 0; // A truncated sequence separates words
+        if (is_word_character(c)) {
+            if (len == 1 && c >= 'A' && c <= 'Z')
+                word += char(c + 0x20);
+            else
+                word.append(p, len);
+        }
+        else if (!word.empty()) {
+            words.push_back(std::move(word));
+            word.clear();
+        }
+        p += len;
+    }
+    if (!word.empty())
+        words.push_back(std::move(word));
+
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
 } // namespace realm
 
 
@@ -22,6 +22,7 @@
 #include <locale>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <realm/string_data.hpp>
 #include <realm/util/features.h>
@@ -100,6 +101,12 @@ size_t sequence_length(char lead);
 // Return bool(string1 < string2)
 bool utf8_compare(StringData string1, StringData string2);
 
+// Compute a key such that comparing the keys of two strings byte by byte (with a key that is a prefix of another
+// being less) gives the same order as utf8_compare(). Sorting on keys computed once per string avoids decoding the
+// strings on every comparison. Returns false if the order is given by a locale or callback (see
+// set_string_compare_method()), in which case no key is computed.
+bool utf8_sort_key(StringData string, std::string& key);
+
 // Return unicode value of character.
 uint32_t utf8value(const char* character);
 
@@ -158,6 +165,11 @@ bool contains_ins(StringData haystack, const char* needle_upper, const char* nee
 bool string_like_ins(StringData text, StringData pattern) noexcept;
 bool string_like_ins(StringData text, StringData upper, StringData lower) noexcept;
 
+/// Returns the distinct words of \a text in sorted order. A word is a maximal run of ASCII letters and digits
+/// and characters outside the ASCII range that are not spaces, punctuation or symbols. Like the other case
+/// insensitive operations, only the ASCII letters are lower cased.
+std::vector<std::string> tokenize_words(StringData text);
+
 } // namespace realm
 
 #endif // REALM_UNICODE_HPP
@@ -50,9 +50,19 @@ public:
 
     void set_file_size(off_t new_size);
 
+    // Returns false if any of the blocks could not be read, in which case
+    // the corresponding part of `dst` is left untouched.
     bool read(FileDesc fd, off_t pos, char* dst, size_t size);
     void try_read_block(FileDesc fd, off_t pos, char* dst) noexcept;
     void write(FileDesc fd, off_t pos, const char* src, size_t size) noexcept;
+    // Re-encrypt the blocks in the given range with the key of this cryptor.
+    // Blocks which can already be read with this key are left alone, and the
+    // rest are read with `old_cryptor`. The IV table keeps the IV and HMAC
+    // of the old version of each block until its new version is written, so
+    // an interrupted re-encryption can be completed by running it again.
+    // `pos` must be at the start of a metadata block. Does not use the IV
+    // table cache of either cryptor.
+    void rekey(AESCryptor& old_cryptor, FileDesc fd, off_t pos, size_t size);
 
 private:
     enum EncryptionMode {
@@ -74,17 +84,24 @@ private:
 #elif defined(_WIN32)
     BCRYPT_KEY_HANDLE m_aes_key_handle;
 #else
-    uint8_t m_aesKey[32];
-    EVP_CIPHER_CTX* m_ctx;
+    // Both contexts are keyed once, so that only the IV is set per block
+    EVP_CIPHER_CTX* m_encr;
+    EVP_CIPHER_CTX* m_decr;
 #endif
 
     uint8_t m_hmacKey[32];
+#if !REALM_PLATFORM_APPLE && !defined(_WIN32)
+    // The hash states after processing the inner and outer HMAC pads
+    SHA256_CTX m_hmac_inner;
+    SHA256_CTX m_hmac_outer;
+#endif
     std::vector<iv_table> m_iv_buffer;
     std::unique_ptr<char[]> m_rw_buffer;
     std::unique_ptr<char[]> m_dst_buffer;
 
-    void calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const;
+    void calc_hmac(const void* src, size_t len, uint8_t* dst) const;
     bool check_hmac(const void* data, size_t len, const uint8_t* hmac) const;
+    bool decrypt_block(FileDesc fd, off_t pos, char* dst, const char* src, size_t bytes_read);
     void crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept;
     iv_table& get_iv_table(FileDesc fd, off_t data_pos) noexcept;
     void handle_error();
@@ -104,10 +121,24 @@ struct SharedFileInfo {
     size_t num_decrypted_pages = 0;
     size_t num_reclaimed_pages = 0;
     size_t progress_index = 0;
+    // The largest number of decrypted pages the reclaimer lets the mappings
+    // of this file hold, independently of the governor. Zero if unlimited.
+    size_t page_budget = 0;
+    uint64_t num_page_hits = 0;
+    uint64_t num_page_misses = 0;
     std::vector<ReaderInfo> readers;
 
     SharedFileInfo(const uint8_t* key, FileDesc file_descriptor);
 };
+
+/// Re-encrypt the encrypted Realm file at `path` in place, so that it can be
+/// opened with `new_key` instead of `old_key`. The file must not be opened by
+/// anyone else while this runs, see DB::call_with_lock(). If interrupted, the
+/// file can be read with neither key, and calling this again completes the
+/// rotation. The file is split into ranges of 256KB, which are re-encrypted
+/// by `num_threads` threads of the default thread pool (all of them if zero).
+void rotate_encryption_key(const std::string& path, const char* old_key, const char* new_key,
+                           size_t num_threads = 0);
 }
 }
 
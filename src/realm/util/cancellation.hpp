@@ -0,0 +1,68 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_CANCELLATION_HPP
+#define REALM_UTIL_CANCELLATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace realm::util {
+
+/// Asks a long-running operation to stop early. The token counts as cancelled
+/// once cancel() has been called, from any thread, or once its deadline, if
+/// any, has passed. The operation checks the token at points where it can stop
+/// cleanly.
+class CancellationToken {
+public:
+    using clock = std::chrono::steady_clock;
+
+    CancellationToken() noexcept = default;
+    explicit CancellationToken(clock::time_point deadline) noexcept
+        : m_deadline(deadline)
+    {
+    }
+
+    /// A token which is cancelled once `timeout` has passed from now.
+    static std::shared_ptr<CancellationToken> with_timeout(clock::duration timeout)
+    {
+        return std::make_shared<CancellationToken>(clock::now() + timeout);
+    }
+
+    void cancel() noexcept
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    bool is_cancelled() const noexcept
+    {
+        if (m_cancelled.load(std::memory_order_relaxed))
+            return true;
+        return m_deadline && clock::now() >= *m_deadline;
+    }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+    std::optional<clock::time_point> m_deadline;
+};
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_CANCELLATION_HPP
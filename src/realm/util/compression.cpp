@@ -398,12 +398,19 @@ std::error_code decompress_none(NoCopyInputStream& compressed, Span<const char>
 }
 
 std::error_code decompress_zlib(NoCopyInputStream& compressed, Span<const char> compressed_buf,
-                                Span<char> decompressed_buf, bool has_header)
+                                Span<char> decompressed_buf, bool has_header, compression::Alloc* custom_allocator)
 {
     using namespace compression;
 
     z_stream strm = {};
+    if (custom_allocator) {
+        strm.opaque = custom_allocator;
+        strm.zalloc = &custom_alloc;
+        strm.zfree = &custom_free;
+    }
     int rc = inflateInit(&strm);
+    if (rc == Z_MEM_ERROR)
+        return error::out_of_memory;
     if (rc != Z_OK)
         return error::decompress_error;
     util::ScopeExit cleanup([&]() noexcept {
@@ -582,7 +589,8 @@ API_AVAILABLE_END
 #endif
 
 std::error_code decompress(NoCopyInputStream& compressed, Span<const char> compressed_buf,
-                           Span<char> decompressed_buf, Algorithm algorithm, bool has_header)
+                           Span<char> decompressed_buf, Algorithm algorithm, bool has_header,
+                           compression::Alloc* custom_allocator = nullptr)
 {
     using namespace compression;
 
@@ -606,7 +614,7 @@ std::error_code decompress(NoCopyInputStream& compressed, Span<const char> compr
         case Algorithm::None:
             return decompress_none(compressed, compressed_buf, decompressed_buf);
         case Algorithm::Deflate:
-            return decompress_zlib(compressed, compressed_buf, decompressed_buf, has_header);
+            return decompress_zlib(compressed, compressed_buf, decompressed_buf, has_header, custom_allocator);
         default:
             return error::decompress_unsupported;
     }
@@ -823,6 +831,17 @@ std::error_code compression::decompress(Span<const char> compressed_buf, Span<ch
     return ::decompress(adapter, adapter.next_block(), decompressed_buf, Algorithm::Deflate, true);
 }
 
+std::error_code compression::decompress(CompressMemoryArena& compress_memory_arena, Span<const char> compressed_buf,
+                                        Span<char> decompressed_buf)
+{
+    // Inflating needs far less memory than deflating, so an arena sized for
+    // compression never has to grow here
+    init_arena(compress_memory_arena); // Throws
+    SimpleNoCopyInputStream adapter(compressed_buf);
+    return ::decompress(adapter, adapter.next_block(), decompressed_buf, Algorithm::Deflate, true,
+                        &compress_memory_arena);
+}
+
 std::error_code compression::decompress_nonportable(NoCopyInputStream& compressed, AppendBuffer<char>& decompressed)
 {
     auto compressed_buf = compressed.next_block();
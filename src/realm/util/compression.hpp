@@ -143,6 +143,13 @@ std::error_code compress(Span<const char> uncompressed_buf, Span<char> compresse
 /// category compression::error_code.
 std::error_code decompress(Span<const char> compressed_buf, Span<char> decompressed_buf);
 
+/// decompress() decompresses zlib-compressed data like the overload above,
+/// but takes all the memory needed by zlib from \a compress_memory_arena, so
+/// that decompressing a sequence of messages does not allocate once the arena
+/// has been set up by the first call.
+std::error_code decompress(CompressMemoryArena& compress_memory_arena, Span<const char> compressed_buf,
+                           Span<char> decompressed_buf);
+
 /// decompress() decompresses zlib-compressed data in \a compressed into \a
 /// decompressed_buf. decompress may throw std::bad_alloc or any exceptions
 /// thrown by \a compressed, but all other errors (including the target buffer
@@ -0,0 +1,92 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/crc32c.hpp>
+
+#include <realm/utilities.hpp>
+
+#include <array>
+#include <cstring>
+
+#if defined(REALM_COMPILER_SSE) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h> // SSE 4.2, only used from functions compiled for that target
+#define REALM_CRC32C_SSE42 1
+#endif
+
+namespace {
+
+constexpr uint32_t poly = 0x82f63b78; // Castagnoli, reversed
+
+constexpr std::array<uint32_t, 256> make_table() noexcept
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j)
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> table = make_table();
+
+uint32_t crc32c_sw(const char* data, size_t size, uint32_t crc) noexcept
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef REALM_CRC32C_SSE42
+__attribute__((target("sse4.2"))) uint32_t crc32c_hw(const char* data, size_t size, uint32_t crc) noexcept
+{
+    uint64_t crc_64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        crc_64 = _mm_crc32_u64(crc_64, word);
+        data += 8;
+        size -= 8;
+    }
+    crc = uint32_t(crc_64);
+    while (size > 0) {
+        crc = _mm_crc32_u8(crc, uint8_t(*data));
+        ++data;
+        --size;
+    }
+    return crc;
+}
+#endif
+
+} // anonymous namespace
+
+namespace realm::util {
+
+uint32_t crc32c(const char* data, size_t size, uint32_t crc) noexcept
+{
+    crc = ~crc;
+#ifdef REALM_CRC32C_SSE42
+    if (sseavx<42>())
+        return ~crc32c_hw(data, size, crc);
+#endif
+    return ~crc32c_sw(data, size, crc);
+}
+
+} // namespace realm::util
@@ -0,0 +1,38 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_CRC32C_HPP
+#define REALM_UTIL_CRC32C_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace realm {
+namespace util {
+
+/// The CRC-32C (Castagnoli) checksum of \param data of size \param size.
+/// Passing the checksum of a preceding block as \param crc continues it, so
+/// that the checksum of a sequence of blocks is that of their concatenation.
+///
+/// The SSE 4.2 crc32 instruction is used when the CPU has it.
+uint32_t crc32c(const char* data, size_t size, uint32_t crc = 0) noexcept;
+
+} // namespace util
+} // namespace realm
+
+#endif // REALM_UTIL_CRC32C_HPP
@@ -23,6 +23,7 @@
 #if REALM_ENABLE_ENCRYPTION
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <system_error>
 
@@ -47,6 +48,7 @@
 
 #include <realm/util/encrypted_file_mapping.hpp>
 #include <realm/util/terminate.hpp>
+#include <realm/util/thread_pool.hpp>
 
 namespace realm {
 namespace util {
@@ -93,6 +95,10 @@ const size_t block_size = 4096;
 const size_t metadata_size = sizeof(iv_table);
 const size_t blocks_per_metadata_block = block_size / metadata_size;
 
+// The largest number of consecutive data blocks AESCryptor::read() fetches
+// from the file with a single read
+const size_t blocks_per_read = 16;
+
 // map an offset in the data to the actual location in the file
 template <typename Int>
 Int real_offset(Int pos)
@@ -143,7 +149,7 @@ size_t check_read(FileDesc fd, off_t pos, void* dst, size_t len)
 } // anonymous namespace
 
 AESCryptor::AESCryptor(const uint8_t* key)
-    : m_rw_buffer(new char[block_size])
+    : m_rw_buffer(new char[block_size * blocks_per_read])
     , m_dst_buffer(new char[block_size])
 {
 #if REALM_PLATFORM_APPLE
@@ -168,14 +174,29 @@ AESCryptor::AESCryptor(const uint8_t* key)
     ret = BCryptGenerateSymmetricKey(hAesAlg, &m_aes_key_handle, nullptr, 0, (PBYTE)key, 32, 0);
     REALM_ASSERT_RELEASE_EX(ret == 0 && "BCryptGenerateSymmetricKey()", ret);
 #else
-    m_ctx = EVP_CIPHER_CTX_new();
-
-    if (!m_ctx)
+    m_encr = EVP_CIPHER_CTX_new();
+    m_decr = EVP_CIPHER_CTX_new();
+    if (!m_encr || !m_decr || !EVP_CipherInit_ex(m_encr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Encrypt) ||
+        !EVP_CipherInit_ex(m_decr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Decrypt)) {
+        EVP_CIPHER_CTX_free(m_encr);
+        EVP_CIPHER_CTX_free(m_decr);
         handle_error();
-
-    memcpy(m_aesKey, key, 32);
+    }
 #endif
     memcpy(m_hmacKey, key + 32, 32);
+
+#if !REALM_PLATFORM_APPLE && !defined(_WIN32)
+    uint8_t ipad[64];
+    uint8_t opad[64];
+    for (size_t i = 0; i < 64; ++i) {
+        ipad[i] = (i < 32 ? m_hmacKey[i] : 0) ^ 0x36;
+        opad[i] = (i < 32 ? m_hmacKey[i] : 0) ^ 0x5C;
+    }
+    SHA224_Init(&m_hmac_inner);
+    SHA256_Update(&m_hmac_inner, ipad, 64);
+    SHA224_Init(&m_hmac_outer);
+    SHA256_Update(&m_hmac_outer, opad, 64);
+#endif
 }
 
 AESCryptor::~AESCryptor() noexcept
@@ -185,8 +206,8 @@ AESCryptor::~AESCryptor() noexcept
     CCCryptorRelease(m_decr);
 #elif defined(_WIN32)
 #else
-    EVP_CIPHER_CTX_cleanup(m_ctx);
-    EVP_CIPHER_CTX_free(m_ctx);
+    EVP_CIPHER_CTX_free(m_encr);
+    EVP_CIPHER_CTX_free(m_decr);
 #endif
 }
 
@@ -228,7 +249,7 @@ iv_table& AESCryptor::get_iv_table(FileDesc fd, off_t data_pos) noexcept
 bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) const
 {
     uint8_t buffer[224 / 8];
-    calc_hmac(src, len, buffer, m_hmacKey);
+    calc_hmac(src, len, buffer);
 
     // Constant-time memcmp to avoid timing attacks
     uint8_t result = 0;
@@ -240,66 +261,83 @@ bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) co
 bool AESCryptor::read(FileDesc fd, off_t pos, char* dst, size_t size)
 {
     REALM_ASSERT(size % block_size == 0);
+    bool all_read = true;
     while (size > 0) {
-        ssize_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), block_size);
+        // Consecutive data blocks are only contiguous in the file up to the
+        // next metadata block, so a single read never crosses one
+        size_t block_ndx = size_t(pos) / block_size;
+        size_t run = std::min({size / block_size, blocks_per_read,
+                               blocks_per_metadata_block - block_ndx % blocks_per_metadata_block});
+        size_t run_bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), run * block_size);
+
+        for (size_t i = 0; i < run; ++i) {
+            size_t offset = i * block_size;
+            if (run_bytes_read <= offset)
+                return false;
 
-        if (bytes_read == 0)
-            return false;
+            size_t bytes_read = std::min(run_bytes_read - offset, block_size);
+            if (!decrypt_block(fd, pos, dst, m_rw_buffer.get() + offset, bytes_read))
+                all_read = false;
 
-        iv_table& iv = get_iv_table(fd, pos);
-        if (iv.iv1 == 0) {
-            // This block has never been written to, so we've just read pre-allocated
-            // space. No memset() since the code using this doesn't rely on
-            // pre-allocated space being zeroed.
-            return false;
+            pos += block_size;
+            dst += block_size;
+            size -= block_size;
         }
+    }
+    return all_read;
+}
 
-        if (!check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac1)) {
-            // Either the DB is corrupted or we were interrupted between writing the
-            // new IV and writing the data
-            if (iv.iv2 == 0) {
-                // Very first write was interrupted
-                return false;
-            }
+bool AESCryptor::decrypt_block(FileDesc fd, off_t pos, char* dst, const char* src, size_t bytes_read)
+{
+    iv_table& iv = get_iv_table(fd, pos);
+    if (iv.iv1 == 0) {
+        // This block has never been written to, so we've just read pre-allocated
+        // space. No memset() since the code using this doesn't rely on
+        // pre-allocated space being zeroed.
+        return false;
+    }
 
-            if (check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac2)) {
-                // Un-bump the IV since the write with the bumped IV never actually
-                // happened
-                memcpy(&iv.iv1, &iv.iv2, 32);
-            }
-            else {
-                // If the file has been shrunk and then re-expanded, we may have
-                // old hmacs that don't go with this data. ftruncate() is
-                // required to fill any added space with zeroes, so assume that's
-                // what happened if the buffer is all zeroes
-                for (ssize_t i = 0; i < bytes_read; ++i) {
-                    if (m_rw_buffer[i] != 0)
-                        throw DecryptionFailed();
-                }
-                return false;
-            }
+    if (!check_hmac(src, bytes_read, iv.hmac1)) {
+        // Either the DB is corrupted or we were interrupted between writing the
+        // new IV and writing the data
+        if (iv.iv2 == 0) {
+            // Very first write was interrupted
+            return false;
         }
 
-        // We may expect some adress ranges of the destination buffer of
-        // AESCryptor::read() to stay unmodified, i.e. being overwritten with
-        // the same bytes as already present, and may have read-access to these
-        // from other threads while decryption is taking place.
-        //
-        // However, some implementations of AES_cbc_encrypt(), in particular
-        // OpenSSL, will put garbled bytes as an intermediate step during the
-        // operation which will lead to incorrect data being read by other
-        // readers concurrently accessing that page. Incorrect data leads to
-        // crashes.
-        //
-        // We therefore decrypt to a temporary buffer first and then copy the
-        // completely decrypted data after.
-        crypt(mode_Decrypt, pos, m_dst_buffer.get(), m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
-        memcpy(dst, m_dst_buffer.get(), block_size);
-
-        pos += block_size;
-        dst += block_size;
-        size -= block_size;
+        if (check_hmac(src, bytes_read, iv.hmac2)) {
+            // Un-bump the IV since the write with the bumped IV never actually
+            // happened
+            memcpy(&iv.iv1, &iv.iv2, 32);
+        }
+        else {
+            // If the file has been shrunk and then re-expanded, we may have
+            // old hmacs that don't go with this data. ftruncate() is
+            // required to fill any added space with zeroes, so assume that's
+            // what happened if the buffer is all zeroes
+            for (size_t i = 0; i < bytes_read; ++i) {
+                if (src[i] != 0)
+                    throw DecryptionFailed();
+            }
+            return false;
+        }
     }
+
+    // We may expect some adress ranges of the destination buffer of
+    // AESCryptor::read() to stay unmodified, i.e. being overwritten with
+    // the same bytes as already present, and may have read-access to these
+    // from other threads while decryption is taking place.
+    //
+    // However, some implementations of AES_cbc_encrypt(), in particular
+    // OpenSSL, will put garbled bytes as an intermediate step during the
+    // operation which will lead to incorrect data being read by other
+    // readers concurrently accessing that page. Incorrect data leads to
+    // crashes.
+    //
+    // We therefore decrypt to a temporary buffer first and then copy the
+    // completely decrypted data after.
+    crypt(mode_Decrypt, pos, m_dst_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
+    memcpy(dst, m_dst_buffer.get(), block_size);
     return true;
 }
 
@@ -350,7 +388,7 @@ void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size) noe
                 ++iv.iv1;
 
             crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-            calc_hmac(m_rw_buffer.get(), block_size, iv.hmac1, m_hmacKey);
+            calc_hmac(m_rw_buffer.get(), block_size, iv.hmac1);
             // In the extremely unlikely case that both the old and new versions have
             // the same hash we won't know which IV to use, so bump the IV until
             // they're different.
@@ -365,6 +403,69 @@ void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size) noe
     }
 }
 
+void AESCryptor::rekey(AESCryptor& old_cryptor, FileDesc fd, off_t pos, size_t size)
+{
+    REALM_ASSERT(size % block_size == 0);
+    REALM_ASSERT(size_t(pos) % (block_size * blocks_per_metadata_block) == 0);
+    std::unique_ptr<char[]> buffer(new char[block_size * blocks_per_metadata_block]);
+    iv_table ivs[blocks_per_metadata_block];
+    while (size > 0) {
+        size_t count = std::min(size / block_size, blocks_per_metadata_block);
+        memset(ivs, 0, sizeof(ivs));
+        check_read(fd, iv_table_pos(pos), ivs, count * metadata_size);
+        size_t bytes_read = check_read(fd, real_offset(pos), buffer.get(), count * block_size);
+        count = bytes_read / block_size;
+        if (count == 0)
+            return;
+
+        bool changed = false;
+        for (size_t i = 0; i < count; ++i) {
+            iv_table& iv = ivs[i];
+            char* data = buffer.get() + i * block_size;
+            off_t block_pos = pos + off_t(i * block_size);
+            if (iv.iv1 == 0 || check_hmac(data, block_size, iv.hmac1))
+                continue; // Never written, or re-encrypted already
+
+            // Find the IV the data was written with. If a previous rotation
+            // was interrupted before the data was written, that is the old one.
+            if (!old_cryptor.check_hmac(data, block_size, iv.hmac1)) {
+                if (iv.iv2 != 0 && old_cryptor.check_hmac(data, block_size, iv.hmac2)) {
+                    memcpy(&iv.iv1, &iv.iv2, 32);
+                }
+                else {
+                    // Zero filled space left by shrinking and re-expanding the file
+                    bool zero = std::all_of(data, data + block_size, [](char c) {
+                        return c == 0;
+                    });
+                    if (!zero)
+                        throw DecryptionFailed();
+                    continue;
+                }
+            }
+            old_cryptor.crypt(mode_Decrypt, block_pos, m_dst_buffer.get(), data,
+                              reinterpret_cast<const char*>(&iv.iv1));
+
+            memcpy(&iv.iv2, &iv.iv1, 32);
+            do {
+                ++iv.iv1;
+                if (iv.iv1 == 0)
+                    ++iv.iv1;
+                crypt(mode_Encrypt, block_pos, data, m_dst_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
+                calc_hmac(data, block_size, iv.hmac1);
+            } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
+            changed = true;
+        }
+
+        // As for write(), the IVs go first
+        if (changed) {
+            check_write(fd, iv_table_pos(pos), ivs, count * metadata_size);
+            check_write(fd, real_offset(pos), buffer.get(), count * block_size);
+        }
+        pos += off_t(count * block_size);
+        size -= count * block_size;
+    }
+}
+
 void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept
 {
     uint8_t iv[aes_block_size] = {0};
@@ -400,28 +501,32 @@ void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* sr
     }
 
 #else
-    if (!EVP_CipherInit_ex(m_ctx, EVP_aes_256_cbc(), NULL, m_aesKey, iv, mode))
+    // Only set the IV. The key schedule was computed when the context was
+    // created, which matters most for decryption where it is the most costly.
+    EVP_CIPHER_CTX* ctx = mode == mode_Encrypt ? m_encr : m_decr;
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1))
         handle_error();
 
     int len;
     // Use zero padding - we always write a whole page
-    EVP_CIPHER_CTX_set_padding(m_ctx, 0);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
 
-    if (!EVP_CipherUpdate(m_ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
+    if (!EVP_CipherUpdate(ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
                           block_size))
         handle_error();
 
     // Finalize the encryption. Should not output further data.
-    if (!EVP_CipherFinal_ex(m_ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
+    if (!EVP_CipherFinal_ex(ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
         handle_error();
 #endif
 }
 
-void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const
+void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst) const
 {
 #if REALM_PLATFORM_APPLE
-    CCHmac(kCCHmacAlgSHA224, key, 32, src, len, dst);
-#else
+    CCHmac(kCCHmacAlgSHA224, m_hmacKey, 32, src, len, dst);
+#elif defined(_WIN32)
+    const uint8_t* key = m_hmacKey;
     uint8_t ipad[64];
     for (size_t i = 0; i < 32; ++i)
         ipad[i] = key[i] ^ 0x36;
@@ -433,7 +538,6 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     memset(opad + 32, 0x5C, 32);
 
     // Full hmac operation is sha224(opad + sha224(ipad + data))
-#ifdef _WIN32
     sha224_state s;
     sha_init(s);
     sha_process(s, ipad, 64);
@@ -445,19 +549,16 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     sha_process(s, dst, 28); // 28 == SHA224_DIGEST_LENGTH
     sha_done(s, dst);
 #else
-    SHA256_CTX ctx;
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, ipad, 64);
+    // Full hmac operation is sha224(opad + sha224(ipad + data)), starting
+    // from the states that have already processed the pads
+    SHA256_CTX ctx = m_hmac_inner;
     SHA256_Update(&ctx, static_cast<const uint8_t*>(src), len);
     SHA256_Final(dst, &ctx);
 
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, opad, 64);
+    ctx = m_hmac_outer;
     SHA256_Update(&ctx, dst, SHA224_DIGEST_LENGTH);
     SHA256_Final(dst, &ctx);
 #endif
-
-#endif
 }
 
 EncryptedFileMapping::EncryptedFileMapping(SharedFileInfo& file, size_t file_offset, void* addr, size_t size,
@@ -527,19 +628,39 @@ bool EncryptedFileMapping::copy_up_to_date_page(size_t local_page_ndx) noexcept
 
 void EncryptedFileMapping::refresh_page(size_t local_page_ndx)
 {
-    REALM_ASSERT_EX(local_page_ndx < m_page_state.size(), local_page_ndx, m_page_state.size());
-
-    char* addr = page_addr(local_page_ndx);
+    refresh_pages(local_page_ndx, local_page_ndx + 1);
+}
 
-    if (!copy_up_to_date_page(local_page_ndx)) {
-        size_t page_ndx_in_file = local_page_ndx + m_first_page;
-        m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), addr,
-                            static_cast<size_t>(1ULL << m_page_shift));
+void EncryptedFileMapping::refresh_pages(size_t begin, size_t end)
+{
+    REALM_ASSERT_EX(begin < end && end <= m_page_state.size(), begin, end, m_page_state.size());
+
+    // Pages which cannot be copied from another mapping are decrypted in runs
+    // of consecutive pages, so that each run is fetched with as few reads of
+    // the file as possible
+    size_t run_begin = begin;
+    auto read_run = [&](size_t run_end) {
+        if (run_begin < run_end) {
+            size_t page_ndx_in_file = run_begin + m_first_page;
+            m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(run_begin),
+                                (run_end - run_begin) << m_page_shift);
+        }
+    };
+    for (size_t ndx = begin; ndx < end; ++ndx) {
+        if (copy_up_to_date_page(ndx)) {
+            read_run(ndx);
+            run_begin = ndx + 1;
+        }
+    }
+    read_run(end);
+
+    m_file.num_page_misses += end - begin;
+    for (size_t ndx = begin; ndx < end; ++ndx) {
+        if (is_not(m_page_state[ndx], UpToDate | RefetchRequired))
+            m_num_decrypted++;
+        clear(m_page_state[ndx], RefetchRequired);
+        set(m_page_state[ndx], UpToDate);
     }
-    if (is_not(m_page_state[local_page_ndx], UpToDate | RefetchRequired))
-        m_num_decrypted++;
-    clear(m_page_state[local_page_ndx], RefetchRequired);
-    set(m_page_state[local_page_ndx], UpToDate);
 }
 
 void EncryptedFileMapping::mark_for_refresh(size_t ref_start, size_t ref_end)
@@ -676,10 +797,18 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
     auto visit_and_potentially_reclaim = [&](size_t page_ndx) {
         PageState ps = m_page_state[page_ndx];
         if (is(m_page_state[page_ndx], UpToDate | RefetchRequired)) {
-            if (is_not(ps, Touched) && is_not(ps, Dirty)) {
+            if (is(ps, Touched | Dirty)) {
+                // in use since the last sweep
+            }
+            else if (is(ps, Hot)) {
+                // give pages in use outside of sequential scans a second chance
+                clear(m_page_state[page_ndx], Hot);
+            }
+            else {
                 clear(m_page_state[page_ndx], UpToDate | RefetchRequired);
                 reclaim_page(page_ndx);
                 m_num_decrypted--;
+                m_file.num_reclaimed_pages++;
                 done_some_work();
             }
             contiguous_scan = false;
@@ -817,14 +946,17 @@ void EncryptedFileMapping::write_barrier(const void* addr, size_t size) noexcept
 void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to_size header_to_size)
 {
     size_t first_accessed_local_page = get_local_index_of_address(addr);
+    const int touch = SequentialScanHint::is_active() ? Touched : Touched | Hot;
 
     {
         // make sure the first page is available
         PageState& ps = m_page_state[first_accessed_local_page];
-        if (is_not(ps, Touched))
-            set(ps, Touched);
+        if ((ps & touch) != touch)
+            set(ps, touch);
         if (is_not(ps, UpToDate))
             refresh_page(first_accessed_local_page);
+        else
+            ++m_file.num_page_hits;
     }
 
     // force the page reclaimer to look into pages in this chunk:
@@ -843,8 +975,12 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to
     size_t pages_size = m_page_state.size();
 
     // We already checked first_accessed_local_page above, so we start the loop
-    // at first_accessed_local_page + 1 to check the following page.
-    for (size_t idx = first_accessed_local_page + 1; idx <= last_idx && idx < pages_size; ++idx) {
+    // at first_accessed_local_page + 1 to check the following page. Pages
+    // which are not up to date are refreshed together in runs.
+    size_t run_begin = 0;
+    bool in_run = false;
+    size_t idx = first_accessed_local_page + 1;
+    for (; idx <= last_idx && idx < pages_size; ++idx) {
 
         // force the page reclaimer to look into pages in this chunk
         chunk_ndx = idx >> page_to_chunk_shift;
@@ -852,11 +988,24 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to
             m_chunk_dont_scan[chunk_ndx] = 0;
 
         PageState& ps = m_page_state[idx];
-        if (is_not(ps, Touched))
-            set(ps, Touched);
-        if (is_not(ps, UpToDate))
-            refresh_page(idx);
+        if ((ps & touch) != touch)
+            set(ps, touch);
+        if (is_not(ps, UpToDate)) {
+            if (!in_run) {
+                run_begin = idx;
+                in_run = true;
+            }
+        }
+        else {
+            ++m_file.num_page_hits;
+            if (in_run) {
+                refresh_pages(run_begin, idx);
+                in_run = false;
+            }
+        }
     }
+    if (in_run)
+        refresh_pages(run_begin, idx);
 }
 
 void EncryptedFileMapping::extend_to(size_t offset, size_t new_size)
@@ -893,6 +1042,35 @@ void EncryptedFileMapping::set(void* new_addr, size_t new_size, size_t new_file_
     m_chunk_dont_scan.resize((num_pages + page_to_chunk_factor - 1) >> page_to_chunk_shift, false);
 }
 
+void rotate_encryption_key(const std::string& path, const char* old_key, const char* new_key, size_t num_threads)
+{
+    const size_t range_size = block_size * blocks_per_metadata_block;
+    size_t data_size = size_t(encrypted_size_to_data_size(File::get_size_static(path)));
+    size_t num_ranges = (data_size + range_size - 1) / range_size;
+    if (num_ranges == 0)
+        return;
+
+    auto& pool = ThreadPool::get_default();
+    if (num_threads == 0)
+        num_threads = pool.get_thread_count();
+    num_threads = std::max<size_t>(1, std::min(num_threads, num_ranges));
+
+    // Each thread has its own descriptor, as the cryptor seeks on it
+    std::atomic<size_t> next_range{0};
+    pool.run_parallel(num_threads, [&](size_t) {
+        File file(path, File::mode_Update);
+        AESCryptor old_cryptor(reinterpret_cast<const uint8_t*>(old_key));
+        AESCryptor new_cryptor(reinterpret_cast<const uint8_t*>(new_key));
+        size_t range;
+        while ((range = next_range.fetch_add(1, std::memory_order_relaxed)) < num_ranges) {
+            size_t pos = range * range_size;
+            size_t size = (std::min(range_size, data_size - pos) + block_size - 1) & ~(block_size - 1);
+            new_cryptor.rekey(old_cryptor, file.get_descriptor(), off_t(pos), size);
+        }
+    });
+    File(path, File::mode_Update).sync();
+}
+
 File::SizeType encrypted_size_to_data_size(File::SizeType size) noexcept
 {
     if (size == 0)
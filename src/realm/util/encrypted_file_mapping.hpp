@@ -112,7 +112,8 @@ private:
         Touched = 1,         // a ref->ptr translation has taken place
         UpToDate = 2,        // the page is fully up to date
         RefetchRequired = 4, // the page is valid for old translations, but requires re-decryption for new
-        Dirty = 8            // the page has been modified with respect to what's on file.
+        Dirty = 8,           // the page has been modified with respect to what's on file.
+        Hot = 16             // touched outside of a sequential scan, survives one more sweep of the reclaimer
     };
     std::vector<PageState> m_page_state;
     // little helpers:
@@ -148,6 +149,7 @@ private:
     void mark_outdated(size_t local_page_ndx) noexcept;
     bool copy_up_to_date_page(size_t local_page_ndx) noexcept;
     void refresh_page(size_t local_page_ndx);
+    void refresh_pages(size_t begin, size_t end);
     void write_and_update_all(size_t local_page_ndx, size_t begin_offset, size_t end_offset) noexcept;
     void reclaim_page(size_t page_ndx);
     void validate_page(size_t local_page_ndx) noexcept;
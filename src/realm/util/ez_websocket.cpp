@@ -4,13 +4,17 @@
 #include <realm/util/network.hpp>
 #include <realm/util/network_ssl.hpp>
 
+#include <algorithm>
+
 namespace realm::util::websocket {
 
 namespace {
 class EZSocketImpl final : public EZSocket, public websocket::Config {
 public:
-    EZSocketImpl(EZConfig& config, EZObserver& observer, EZEndpoint&& endpoint)
+    EZSocketImpl(EZConfig& config, util::network::ssl::SessionCache& ssl_session_cache, EZObserver& observer,
+                 EZEndpoint&& endpoint)
         : m_config(config)
+        , m_ssl_session_cache(ssl_session_cache)
         , m_observer(observer)
         , m_endpoint(std::move(endpoint))
         , m_websocket(*this)
@@ -22,11 +26,17 @@ public:
     {
         m_websocket.async_write_binary(data, size, std::move(handler));
     }
+    void async_write_binary(util::Span<const util::Span<const char>> data,
+                            util::UniqueFunction<void()>&& handler) override
+    {
+        m_websocket.async_write_binary(data, std::move(handler));
+    }
 
     // public for HTTPClient CRTP, but not on the EZSocket interface, so de-facto private
     void async_read(char*, std::size_t, ReadCompletionHandler) override;
     void async_read_until(char*, std::size_t, char, ReadCompletionHandler) override;
     void async_write(const char*, std::size_t, WriteCompletionHandler) override;
+    void async_write_buffers(util::Span<const util::Span<const char>>, WriteCompletionHandler) override;
 
 private:
     using milliseconds_type = std::int_fast64_t;
@@ -39,6 +49,10 @@ private:
     {
         return m_config.random;
     }
+    bool websocket_permessage_deflate_enabled() noexcept override
+    {
+        return m_config.permessage_deflate;
+    }
 
     void websocket_handshake_completion_handler(const util::HTTPHeaders& headers) override
     {
@@ -74,10 +88,20 @@ private:
         return m_observer.websocket_binary_message_received(ptr, size);
     }
 
+    // How long a connection attempt may go on before the next endpoint is
+    // tried in parallel, as recommended by RFC 8305 (Happy Eyeballs).
+    static constexpr std::chrono::milliseconds connection_attempt_delay{250};
+
+    struct ConnectAttempt {
+        std::unique_ptr<util::network::Socket> socket;
+        std::size_t endpoint_ndx;
+    };
+
+    util::network::Resolver::Query make_resolve_query() const;
     void initiate_resolve();
     void handle_resolve(std::error_code, util::network::Endpoint::List);
-    void initiate_tcp_connect(util::network::Endpoint::List, std::size_t);
-    void handle_tcp_connect(std::error_code, util::network::Endpoint::List, std::size_t);
+    void initiate_tcp_connect();
+    void handle_tcp_connect(std::error_code, util::network::Socket*);
     void initiate_http_tunnel();
     void handle_http_tunnel(std::error_code);
     void initiate_websocket_or_ssl_handshake();
@@ -98,11 +122,16 @@ private:
     }
 
     EZConfig& m_config;
+    util::network::ssl::SessionCache& m_ssl_session_cache;
     EZObserver& m_observer;
 
     const EZEndpoint m_endpoint;
     util::Optional<util::network::Resolver> m_resolver;
-    util::Optional<util::network::Socket> m_socket;
+    std::vector<util::network::Endpoint> m_endpoints; // In the order they are tried
+    std::size_t m_next_endpoint_ndx = 0;
+    std::vector<ConnectAttempt> m_connect_attempts;
+    util::Optional<util::network::DeadlineTimer> m_connect_attempt_timer;
+    std::unique_ptr<util::network::Socket> m_socket;
     util::Optional<util::network::ssl::Context> m_ssl_context;
     util::Optional<util::network::ssl::Stream> m_ssl_stream;
     util::network::ReadAheadBuffer m_read_ahead_buffer;
@@ -146,6 +175,28 @@ void EZSocketImpl::async_write(const char* data, std::size_t size, WriteCompleti
     }
 }
 
+void EZSocketImpl::async_write_buffers(util::Span<const util::Span<const char>> buffers,
+                                       WriteCompletionHandler handler)
+{
+    REALM_ASSERT(m_socket);
+    // A TLS stream encrypts each buffer separately anyway, so only a plain
+    // TCP socket benefits from a gather write.
+    if (m_ssl_stream) {
+        websocket::Config::async_write_buffers(buffers, std::move(handler)); // Throws
+    }
+    else {
+        m_socket->async_write(buffers, std::move(handler)); // Throws
+    }
+}
+
+
+util::network::Resolver::Query EZSocketImpl::make_resolve_query() const
+{
+    const std::string& address = m_endpoint.proxy ? m_endpoint.proxy->address : m_endpoint.address;
+    const port_type& port = m_endpoint.proxy ? m_endpoint.proxy->port : m_endpoint.port;
+    return util::network::Resolver::Query(address, util::to_string(port)); // Throws
+}
+
 
 void EZSocketImpl::initiate_resolve()
 {
@@ -158,7 +209,7 @@ void EZSocketImpl::initiate_resolve()
 
     logger().detail("Resolving '%1:%2'", address, port); // Throws
 
-    util::network::Resolver::Query query(address, util::to_string(port)); // Throws
+    util::network::Resolver::Query query = make_resolve_query(); // Throws
     auto handler = [this](std::error_code ec, util::network::Endpoint::List endpoints) {
         // If the operation is aborted, the connection object may have been
         // destroyed.
@@ -178,45 +229,89 @@ void EZSocketImpl::handle_resolve(std::error_code ec, util::network::Endpoint::L
         return;
     }
 
-    initiate_tcp_connect(std::move(endpoints), 0); // Throws
+    // Alternate between the address families, starting with that of the
+    // preferred endpoint, such that a broken IPv6 or IPv4 path delays the
+    // connection by no more than a single connection attempt delay
+    // (RFC 8305 section 4).
+    bool first_is_ip_v6 = endpoints.begin()->protocol().is_ip_v6();
+    std::vector<util::network::Endpoint> same_family, other_family;
+    for (const util::network::Endpoint& ep : endpoints)
+        (ep.protocol().is_ip_v6() == first_is_ip_v6 ? same_family : other_family).push_back(ep); // Throws
+    m_endpoints.clear();
+    m_endpoints.reserve(endpoints.size()); // Throws
+    for (std::size_t i = 0; i < std::max(same_family.size(), other_family.size()); ++i) {
+        if (i < same_family.size())
+            m_endpoints.push_back(same_family[i]);
+        if (i < other_family.size())
+            m_endpoints.push_back(other_family[i]);
+    }
+    m_next_endpoint_ndx = 0;
+
+    initiate_tcp_connect(); // Throws
 }
 
 
-void EZSocketImpl::initiate_tcp_connect(util::network::Endpoint::List endpoints, std::size_t i)
+void EZSocketImpl::initiate_tcp_connect()
 {
-    REALM_ASSERT(i < endpoints.size());
-
-    util::network::Endpoint ep = *(endpoints.begin() + i);
-    std::size_t n = endpoints.size();
-    m_socket.emplace(m_config.service); // Throws
-    m_socket->async_connect(ep, [this, endpoints = std::move(endpoints), i](std::error_code ec) mutable {
+    REALM_ASSERT(m_next_endpoint_ndx < m_endpoints.size());
+
+    std::size_t i = m_next_endpoint_ndx++;
+    const util::network::Endpoint& ep = m_endpoints[i];
+    auto socket = std::make_unique<util::network::Socket>(m_config.service); // Throws
+    util::network::Socket* socket_ptr = socket.get();
+    m_connect_attempts.push_back({std::move(socket), i}); // Throws
+    socket_ptr->async_connect(ep, [this, socket_ptr](std::error_code ec) {
         // If the operation is aborted, the connection object may have been
         // destroyed.
         if (ec != util::error::operation_aborted)
-            handle_tcp_connect(ec, std::move(endpoints), i); // Throws
+            handle_tcp_connect(ec, socket_ptr); // Throws
     });
-    logger().detail("Connecting to endpoint '%1:%2' (%3/%4)", ep.address(), ep.port(), (i + 1), n); // Throws
+    logger().detail("Connecting to endpoint '%1:%2' (%3/%4)", ep.address(), ep.port(), (i + 1),
+                    m_endpoints.size()); // Throws
+
+    // Try the next endpoint in parallel if this attempt does not succeed or
+    // fail soon, rather than waiting for it to time out
+    m_connect_attempt_timer.reset();
+    if (m_next_endpoint_ndx < m_endpoints.size()) {
+        m_connect_attempt_timer.emplace(m_config.service); // Throws
+        m_connect_attempt_timer->async_wait(connection_attempt_delay, [this](std::error_code ec) {
+            if (ec != util::error::operation_aborted)
+                initiate_tcp_connect(); // Throws
+        });
+    }
 }
 
 
-void EZSocketImpl::handle_tcp_connect(std::error_code ec, util::network::Endpoint::List endpoints, std::size_t i)
+void EZSocketImpl::handle_tcp_connect(std::error_code ec, util::network::Socket* socket)
 {
-    REALM_ASSERT(i < endpoints.size());
-    const util::network::Endpoint& ep = *(endpoints.begin() + i);
+    auto i = std::find_if(m_connect_attempts.begin(), m_connect_attempts.end(), [&](const ConnectAttempt& attempt) {
+        return attempt.socket.get() == socket;
+    });
+    REALM_ASSERT(i != m_connect_attempts.end());
+    const util::network::Endpoint& ep = m_endpoints[i->endpoint_ndx];
     if (ec) {
         logger().error("Failed to connect to endpoint '%1:%2': %3", ep.address(), ep.port(),
                        ec.message()); // Throws
-        std::size_t i_2 = i + 1;
-        if (i_2 < endpoints.size()) {
-            initiate_tcp_connect(std::move(endpoints), i_2); // Throws
+        m_connect_attempts.erase(i);
+        if (m_next_endpoint_ndx < m_endpoints.size()) {
+            initiate_tcp_connect(); // Throws
             return;
         }
-        // All endpoints failed
+        if (!m_connect_attempts.empty())
+            return; // Other attempts are still in progress
+        // All endpoints failed. They may no longer be those of the host, so
+        // have the next connection resolve it anew.
+        util::network::Resolver::forget_cached(make_resolve_query()); // Throws
         logger().error("Failed to connect to '%1:%2': All endpoints failed", m_endpoint.address, m_endpoint.port);
         m_observer.websocket_connect_error_handler(ec); // Throws
         return;
     }
 
+    // Abandon the other attempts
+    m_socket = std::move(i->socket);
+    m_connect_attempts.clear();
+    m_connect_attempt_timer.reset();
+
     REALM_ASSERT(m_socket);
     util::network::Endpoint ep_2 = m_socket->local_endpoint();
     logger().info("Connected to endpoint '%1:%2' (from '%3:%4')", ep.address(), ep.port(), ep_2.address(),
@@ -306,6 +401,16 @@ void EZSocketImpl::initiate_ssl_handshake()
         }
     }
 
+    // A resumed session skips certificate verification, so sessions are only
+    // shared between connections that would verify the server the same
+    // way. A verify callback cannot be compared, so it disables resumption.
+    if (!m_endpoint.ssl_verify_callback || !m_endpoint.verify_servers_ssl_certificate) {
+        std::string key = util::format("%1:%2:%3:%4", m_endpoint.address, m_endpoint.port,
+                                       int(m_endpoint.verify_servers_ssl_certificate),
+                                       m_endpoint.ssl_trust_certificate_path.value_or("")); // Throws
+        m_ssl_stream->set_session_cache(m_ssl_session_cache, std::move(key)); // Throws
+    }
+
     auto handler = [this](std::error_code ec) {
         // If the operation is aborted, the connection object may have been
         // destroyed.
@@ -347,9 +452,17 @@ void EZSocketImpl::initiate_websocket_handshake()
 
 EZSocket::~EZSocket() = default;
 
+EZSocketFactory::EZSocketFactory(EZConfig config)
+    : m_config(config)
+    , m_ssl_session_cache(std::make_unique<util::network::ssl::SessionCache>()) // Throws
+{
+}
+
+EZSocketFactory::~EZSocketFactory() = default;
+
 std::unique_ptr<EZSocket> EZSocketFactory::connect(EZObserver* observer, EZEndpoint&& endpoint)
 {
-    return std::make_unique<EZSocketImpl>(m_config, *observer, std::move(endpoint));
+    return std::make_unique<EZSocketImpl>(m_config, *m_ssl_session_cache, *observer, std::move(endpoint));
 }
 
 } // namespace realm::util::websocket
@@ -7,10 +7,14 @@
 
 #include <realm/sync/config.hpp>
 #include <realm/util/http.hpp>
+#include <realm/util/span.hpp>
 
 namespace realm::util::network {
 class Service;
+namespace ssl {
+class SessionCache;
 }
+} // namespace realm::util::network
 
 namespace realm::util::websocket {
 using port_type = sync::port_type;
@@ -21,6 +25,7 @@ struct EZConfig {
     std::mt19937_64& random;
     util::network::Service& service;
     std::string user_agent;
+    bool permessage_deflate = false;
 };
 
 struct EZEndpoint {
@@ -90,14 +95,18 @@ public:
     virtual ~EZSocket();
 
     virtual void async_write_binary(const char* data, size_t size, util::UniqueFunction<void()>&& handler) = 0;
+
+    /// Sends a binary message made up of the concatenation of at most
+    /// `Socket::max_payload_buffers` buffers, which must remain valid until
+    /// the handler is called.
+    virtual void async_write_binary(util::Span<const util::Span<const char>> data,
+                                    util::UniqueFunction<void()>&& handler) = 0;
 };
 
 class EZSocketFactory {
 public:
-    EZSocketFactory(EZConfig config)
-        : m_config(config)
-    {
-    }
+    EZSocketFactory(EZConfig config);
+    ~EZSocketFactory();
 
     EZSocketFactory(EZSocketFactory&&) = delete;
 
@@ -105,6 +114,10 @@ public:
 
 private:
     EZConfig m_config;
+
+    // TLS sessions of earlier connections, so that reconnects can use an
+    // abbreviated handshake.
+    std::unique_ptr<util::network::ssl::SessionCache> m_ssl_session_cache;
 };
 
 } // namespace realm::util::websocket
@@ -41,6 +41,13 @@
 #include <sys/statvfs.h>
 #endif
 
+#if REALM_PLATFORM_APPLE
+#include <sys/clonefile.h>
+#elif defined(__linux__)
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
 #include <realm/exceptions.hpp>
 #include <realm/util/errno.hpp>
 #include <realm/util/file_mapper.hpp>
@@ -48,6 +55,15 @@
 #include <realm/util/features.h>
 #include <realm/util/file.hpp>
 
+#if REALM_HAVE_IO_URING
+#include <atomic>
+#include <memory>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#endif
+
 using namespace realm;
 using namespace realm::util;
 
@@ -180,6 +196,248 @@ struct WindowsFileHandleHolder {
 
 #endif
 
+#ifndef _WIN32
+
+void pwrite_all(int fd, File::SizeType pos, const char* data, size_t size)
+{
+    while (0 < size) {
+        // POSIX requires that 'n' is less than or equal to SSIZE_MAX
+        size_t n = std::min(size, size_t(SSIZE_MAX));
+        ssize_t r = ::pwrite(fd, data, n, off_t(pos));
+        if (r < 0) {
+            int err = errno; // Eliminate any risk of clobbering
+            if (err == EINTR)
+                continue;
+            if (err == ENOSPC || err == EDQUOT)
+                throw OutOfDiskSpace(get_errno_msg("pwrite() failed: ", err));
+            throw std::system_error(err, std::system_category(), "pwrite() failed");
+        }
+        REALM_ASSERT_RELEASE(r != 0);
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        size -= size_t(r);
+        data += size_t(r);
+        pos += r;
+    }
+}
+
+#endif
+
+#if REALM_HAVE_IO_URING
+
+// A submission and completion queue pair set up through the raw system calls, so
+// that liburing is not required. Requires IORING_FEAT_SINGLE_MMAP (Linux 5.4).
+class IoUring {
+public:
+    // Returns nullptr if io_uring is not supported by the running kernel (or
+    // not allowed in this process).
+    static IoUring* get_for_current_thread();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+    ~IoUring();
+
+    void write_batch(int fd, const std::vector<File::WriteRequest>& requests, bool barrier);
+
+private:
+    IoUring() = default;
+    bool setup(unsigned num_entries) noexcept;
+    io_uring_sqe& next_entry() noexcept;
+    // Submit the entries obtained by next_entry() and wait for all of them
+    // to complete.
+    template <class F>
+    void submit_and_wait(unsigned num_entries, F&& on_completion);
+
+    int m_fd = -1;
+    void* m_rings = MAP_FAILED;
+    size_t m_rings_size = 0;
+    io_uring_sqe* m_entries = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t m_entries_size = 0;
+    unsigned m_num_entries = 0;
+    unsigned* m_sq_tail = nullptr;
+    unsigned* m_sq_mask = nullptr;
+    unsigned* m_sq_array = nullptr;
+    unsigned* m_cq_head = nullptr;
+    unsigned* m_cq_tail = nullptr;
+    unsigned* m_cq_mask = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned m_local_sq_tail = 0;
+    unsigned m_fork_generation = 0;
+};
+
+std::atomic<unsigned> g_io_uring_fork_generation{0};
+
+IoUring* IoUring::get_for_current_thread()
+{
+    static std::atomic<bool> unsupported{false};
+    // A child process must not use the rings it inherited, as they are shared with the parent
+    static int at_fork = pthread_atfork(nullptr, nullptr, [] {
+        ++g_io_uring_fork_generation;
+    });
+    static_cast<void>(at_fork);
+    thread_local std::unique_ptr<IoUring> ring;
+    if (ring && ring->m_fork_generation != g_io_uring_fork_generation.load(std::memory_order_relaxed))
+        ring.reset();
+    if (!ring && !unsupported.load(std::memory_order_relaxed)) {
+        std::unique_ptr<IoUring> new_ring(new IoUring);
+        if (new_ring->setup(64)) {
+            ring = std::move(new_ring);
+        }
+        else {
+            unsupported = true;
+        }
+    }
+    return ring.get();
+}
+
+bool IoUring::setup(unsigned num_entries) noexcept
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof params);
+    m_fd = int(::syscall(__NR_io_uring_setup, num_entries, &params));
+    if (m_fd < 0)
+        return false;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+        return false;
+
+    m_rings_size = std::max(size_t(params.sq_off.array + params.sq_entries * sizeof(unsigned)),
+                            size_t(params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe)));
+    m_rings = ::mmap(nullptr, m_rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                     IORING_OFF_SQ_RING);
+    if (m_rings == MAP_FAILED)
+        return false;
+    m_entries_size = params.sq_entries * sizeof(io_uring_sqe);
+    m_entries = static_cast<io_uring_sqe*>(::mmap(nullptr, m_entries_size, PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+    if (m_entries == MAP_FAILED)
+        return false;
+
+    char* rings = static_cast<char*>(m_rings);
+    m_num_entries = params.sq_entries;
+    m_sq_tail = reinterpret_cast<unsigned*>(rings + params.sq_off.tail);
+    m_sq_mask = reinterpret_cast<unsigned*>(rings + params.sq_off.ring_mask);
+    m_sq_array = reinterpret_cast<unsigned*>(rings + params.sq_off.array);
+    m_cq_head = reinterpret_cast<unsigned*>(rings + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned*>(rings + params.cq_off.tail);
+    m_cq_mask = reinterpret_cast<unsigned*>(rings + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(rings + params.cq_off.cqes);
+    m_local_sq_tail = *m_sq_tail;
+    m_fork_generation = g_io_uring_fork_generation;
+    return true;
+}
+
+IoUring::~IoUring()
+{
+    if (m_entries != MAP_FAILED)
+        ::munmap(m_entries, m_entries_size);
+    if (m_rings != MAP_FAILED)
+        ::munmap(m_rings, m_rings_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+io_uring_sqe& IoUring::next_entry() noexcept
+{
+    unsigned index = m_local_sq_tail++ & *m_sq_mask;
+    m_sq_array[index] = index;
+    io_uring_sqe& entry = m_entries[index];
+    memset(&entry, 0, sizeof entry);
+    return entry;
+}
+
+template <class F>
+void IoUring::submit_and_wait(unsigned num_entries, F&& on_completion)
+{
+    // Publish the new entries to the kernel
+    __atomic_store_n(m_sq_tail, m_local_sq_tail, __ATOMIC_RELEASE);
+
+    unsigned to_submit = num_entries;
+    unsigned num_completed = 0;
+    while (num_completed < num_entries) {
+        int r = int(::syscall(__NR_io_uring_enter, m_fd, to_submit, num_entries - num_completed,
+                              IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (r < 0) {
+            int err = errno; // Eliminate any risk of clobbering
+            if (err == EINTR || err == EAGAIN || err == EBUSY)
+                continue;
+            throw std::system_error(err, std::system_category(), "io_uring_enter() failed");
+        }
+        to_submit -= unsigned(r);
+
+        unsigned head = *m_cq_head;
+        unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& completion = m_cqes[head & *m_cq_mask];
+            on_completion(completion.user_data, completion.res);
+            ++num_completed;
+        }
+        __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+void IoUring::write_batch(int fd, const std::vector<File::WriteRequest>& requests, bool barrier)
+{
+    // One entry is kept for the fsync following the last writes
+    const size_t max_writes = m_num_entries - 1;
+    const uint64_t fsync_marker = uint64_t(-1);
+    std::vector<iovec> buffers(std::min(requests.size(), max_writes));
+    int error = 0;
+    bool has_unsynced_writes = false;
+    size_t begin = 0;
+    do {
+        size_t end = std::min(begin + max_writes, requests.size());
+        bool sync = barrier && end == requests.size();
+        for (size_t i = begin; i < end; ++i) {
+            const File::WriteRequest& request = requests[i];
+            iovec& buffer = buffers[i - begin];
+            buffer.iov_base = const_cast<char*>(request.data);
+            buffer.iov_len = request.size;
+            io_uring_sqe& entry = next_entry();
+            entry.opcode = IORING_OP_WRITEV;
+            entry.fd = fd;
+            entry.addr = reinterpret_cast<uint64_t>(&buffer);
+            entry.len = 1;
+            entry.off = uint64_t(request.pos);
+            entry.user_data = i;
+        }
+        if (sync) {
+            // Drained, so that it is not started before all the writes have completed
+            io_uring_sqe& entry = next_entry();
+            entry.opcode = IORING_OP_FSYNC;
+            entry.flags = IOSQE_IO_DRAIN;
+            entry.fd = fd;
+            entry.fsync_flags = IORING_FSYNC_DATASYNC;
+            entry.user_data = fsync_marker;
+        }
+
+        submit_and_wait(unsigned(end - begin + (sync ? 1 : 0)), [&](uint64_t id, int res) {
+            if (res < 0) {
+                if (!error)
+                    error = -res;
+                return;
+            }
+            if (id == fsync_marker)
+                return;
+            // Writes to regular files are rarely short, but complete them if they are
+            const File::WriteRequest& request = requests[size_t(id)];
+            if (size_t(res) < request.size) {
+                pwrite_all(fd, request.pos + res, request.data + res, request.size - res); // Throws
+                has_unsynced_writes = sync;
+            }
+        }); // Throws
+        begin = end;
+    } while (begin < requests.size());
+
+    if (error) {
+        if (error == ENOSPC || error == EDQUOT)
+            throw OutOfDiskSpace(get_errno_msg("io_uring write failed: ", error));
+        throw std::system_error(error, std::system_category(), "io_uring write failed");
+    }
+    if (has_unsynced_writes && ::fdatasync(fd) != 0)
+        throw std::system_error(errno, std::system_category(), "fdatasync() failed");
+}
+
+#endif // REALM_HAVE_IO_URING
+
 } // anonymous namespace
 
 
@@ -653,10 +911,14 @@ void File::write(const char* data, size_t size)
         uint64_t pos_original = get_file_pos(m_fd);
         REALM_ASSERT(!int_cast_has_overflow<size_t>(pos_original));
         size_t pos = size_t(pos_original);
-        Map<char> write_map(*this, access_ReadWrite, static_cast<size_t>(pos + size));
-        realm::util::encryption_read_barrier(write_map, pos, size);
-        memcpy(write_map.get_addr() + pos, data, size);
-        realm::util::encryption_write_barrier(write_map, pos, size);
+        // Only map the pages being written, so that writing a large file
+        // piece by piece does not map everything before each piece again
+        size_t map_offset = pos & ~(page_size() - 1);
+        size_t offset_in_map = pos - map_offset;
+        Map<char> write_map(*this, map_offset, access_ReadWrite, offset_in_map + size);
+        realm::util::encryption_read_barrier(write_map, offset_in_map, size);
+        memcpy(write_map.get_addr() + offset_in_map, data, size);
+        realm::util::encryption_write_barrier(write_map, offset_in_map, size);
         uint64_t cur = get_file_pos(m_fd);
         seek(cur + size);
         return;
@@ -967,6 +1229,23 @@ bool File::prealloc_if_supported(SizeType offset, size_t size)
 }
 
 
+void File::prefetch(SizeType offset, size_t size) noexcept
+{
+    REALM_ASSERT_RELEASE(is_attached());
+#if defined(__linux__) || defined(__ANDROID__)
+    ::posix_fadvise(m_fd, off_t(offset), off_t(size), POSIX_FADV_WILLNEED);
+#elif REALM_PLATFORM_APPLE
+    struct radvisory advice;
+    advice.ra_offset = off_t(offset);
+    advice.ra_count = int(std::min<size_t>(size, std::numeric_limits<int>::max()));
+    ::fcntl(m_fd, F_RDADVISE, &advice);
+#else
+    static_cast<void>(offset);
+    static_cast<void>(size);
+#endif
+}
+
+
 bool File::is_prealloc_supported()
 {
 #if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L // POSIX.1-2001 version
@@ -1050,6 +1329,39 @@ void File::barrier()
 #endif
 }
 
+void File::write_batch(const std::vector<WriteRequest>& requests, bool barrier)
+{
+    REALM_ASSERT_RELEASE(is_attached());
+    REALM_ASSERT(!m_encryption_key);
+
+#if REALM_HAVE_IO_URING
+    if (IoUring* ring = IoUring::get_for_current_thread()) {
+        ring->write_batch(m_fd, requests, barrier); // Throws
+        return;
+    }
+#endif
+
+    for (const WriteRequest& request : requests) {
+#ifdef _WIN32
+        seek_static(m_fd, request.pos);                 // Throws
+        write_static(m_fd, request.data, request.size); // Throws
+#else
+        pwrite_all(m_fd, request.pos, request.data, request.size); // Throws
+#endif
+    }
+    if (barrier)
+        this->barrier(); // Throws
+}
+
+bool File::is_io_uring_supported() noexcept
+{
+#if REALM_HAVE_IO_URING
+    return IoUring::get_for_current_thread() != nullptr;
+#else
+    return false;
+#endif
+}
+
 #ifndef _WIN32
 // little helper
 static void _unlock(int m_fd)
@@ -1472,8 +1784,31 @@ void File::move(const std::string& old_path, const std::string& new_path)
 }
 
 
+bool File::clone(const std::string& origin_path, const std::string& target_path)
+{
+#if REALM_PLATFORM_APPLE
+    return ::clonefile(origin_path.c_str(), target_path.c_str(), 0) == 0;
+#elif defined(__linux__) && defined(FICLONE)
+    File origin_file{origin_path, mode_Read}; // Throws
+    File target_file;
+    target_file.open(target_path, access_ReadWrite, create_Must, 0); // Throws
+    if (::ioctl(target_file.get_descriptor(), FICLONE, origin_file.get_descriptor()) == 0)
+        return true;
+    target_file.close();
+    try_remove(target_path); // Throws
+    return false;
+#else
+    static_cast<void>(origin_path);
+    static_cast<void>(target_path);
+    return false;
+#endif
+}
+
 void File::copy(const std::string& origin_path, const std::string& target_path)
 {
+    if (!exists(target_path) && clone(origin_path, target_path)) // Throws
+        return;
+
     File origin_file{origin_path, mode_Read};  // Throws
     File target_file{target_path, mode_Write}; // Throws
     size_t buffer_size = 4096;
@@ -27,6 +27,7 @@
 #include <stdexcept>
 #include <streambuf>
 #include <string>
+#include <vector>
 
 #ifndef _WIN32
 #include <dirent.h> // POSIX.1-2001
@@ -316,6 +317,11 @@ public:
     /// See prealloc_if_supported().
     static bool is_prealloc_supported();
 
+    /// Ask the system to start reading the specified region of the file into
+    /// the page cache, without waiting for it. This is only a hint, and it has
+    /// no effect on systems that do not support it.
+    void prefetch(SizeType offset, size_t size) noexcept;
+
     /// Reposition the read/write offset of this File
     /// instance. Distinct File instances have separate independent
     /// offsets, as long as the cucrrent process is not forked.
@@ -333,6 +339,30 @@ public:
     /// non-Apple platforms.
     void barrier();
 
+    /// A block of data to be written at a position in the file by
+    /// write_batch().
+    struct WriteRequest {
+        SizeType pos;
+        const char* data;
+        size_t size;
+    };
+
+    /// Write each of the specified blocks at its position in this file, and
+    /// then, if \a barrier is true, make sure that they have reached stable
+    /// storage. The blocks must not overlap. When io_uring is supported (see
+    /// is_io_uring_supported()), all the writes and the following fdatasync()
+    /// are submitted to the kernel together. Otherwise they are done one by
+    /// one, followed by `barrier()`. Calling this function will generally
+    /// affect the read/write offset associated with this File instance.
+    ///
+    /// Calling this function on an encrypted file has undefined behavior.
+    void write_batch(const std::vector<WriteRequest>& requests, bool barrier);
+
+    /// True if write_batch() submits its writes through io_uring. This
+    /// requires Linux 5.4 or later, and that Realm was not built with
+    /// REALM_ENABLE_IO_URING turned off.
+    static bool is_io_uring_supported() noexcept;
+
     /// Place an exclusive lock on this file. This blocks the caller
     /// until all other locks have been released.
     ///
@@ -501,8 +531,18 @@ public:
     static void move(const std::string& old_path, const std::string& new_path);
 
     /// Copy the file at the specified origin path to the specified target path.
+    /// If the target does not exist and the filesystem supports it, the copy
+    /// is made as a clone (see clone()).
     static void copy(const std::string& origin_path, const std::string& target_path);
 
+    /// Create the file at the specified target path as a copy-on-write clone
+    /// of the file at the specified origin path (clonefile() on Apple
+    /// platforms, FICLONE on Linux). The two files share their storage until
+    /// either is modified, so this takes the same short time regardless of the
+    /// size of the file. The target must not exist. Returns false, leaving no
+    /// target behind, if the platform or filesystem cannot clone the file.
+    static bool clone(const std::string& origin_path, const std::string& target_path);
+
     /// Compare the two files at the specified paths for equality. Returns true
     /// if, and only if they are equal.
     static bool compare(const std::string& path_1, const std::string& path_2);
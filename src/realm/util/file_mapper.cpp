@@ -40,6 +40,7 @@
 #include <realm/util/aes_cryptor.hpp>
 
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <csignal>
 #include <sys/stat.h>
@@ -87,6 +88,25 @@ size_t round_up_to_page_size(size_t size) noexcept
     return (size + page_size() - 1) & ~(page_size() - 1);
 }
 
+namespace {
+thread_local int sequential_scan_depth = 0;
+}
+
+SequentialScanHint::SequentialScanHint() noexcept
+{
+    ++sequential_scan_depth;
+}
+
+SequentialScanHint::~SequentialScanHint() noexcept
+{
+    --sequential_scan_depth;
+}
+
+bool SequentialScanHint::is_active() noexcept
+{
+    return sequential_scan_depth > 0;
+}
+
 
 #if REALM_ENABLE_ENCRYPTION
 
@@ -297,6 +317,30 @@ size_t get_num_decrypted_pages()
     return num_decrypted_pages.load();
 }
 
+DecryptedPageStats get_decrypted_page_stats()
+{
+    UniqueLock lock(mapping_mutex);
+    DecryptedPageStats stats;
+    for (auto& m : mappings_by_file) {
+        SharedFileInfo& info = *m.info;
+        for (auto mapping : info.mappings)
+            stats.decrypted_pages += mapping->collect_decryption_count();
+        stats.hits += info.num_page_hits;
+        stats.misses += info.num_page_misses;
+        stats.reclaimed += info.num_reclaimed_pages;
+    }
+    return stats;
+}
+
+void set_decrypted_page_budget(SharedFileInfo& info, size_t budget)
+{
+    UniqueLock lock(mapping_mutex);
+    size_t pages = std::max<size_t>(budget / page_size(), 1);
+    if (info.page_budget == 0 || pages < info.page_budget)
+        info.page_budget = pages;
+    ensure_reclaimer_thread_runs();
+}
+
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id)
 {
     UniqueLock lock(mapping_mutex);
@@ -431,6 +475,16 @@ void reclaim_pages()
     }
     {
         UniqueLock lock(mapping_mutex);
+        // Keep files with a budget of their own within it, whatever the target is
+        for (auto& m : mappings_by_file) {
+            SharedFileInfo& info = *m.info;
+            if (info.page_budget == 0)
+                continue;
+            size_t work_limit = get_work_limit(info.num_decrypted_pages, info.page_budget);
+            if (work_limit > 0)
+                reclaim_pages_for_file(info, work_limit);
+        }
+
         reclaimer_workload = 0;
         reclaimer_target = size_t(target / page_size());
         // Putting the target back into the govenor object will allow the govenor
@@ -474,6 +528,28 @@ mapping_and_addr* find_mapping_for_addr(void* addr, size_t size)
 }
 } // anonymous namespace
 
+size_t reclaim_decrypted_pages(SharedFileInfo& info, bool include_recent)
+{
+    UniqueLock lock(mapping_mutex);
+    auto count_pages = [&] {
+        size_t pages = 0;
+        for (auto mapping : info.mappings)
+            pages += mapping->collect_decryption_count();
+        return pages;
+    };
+    size_t before = count_pages();
+    // A full sweep releases the pages not used since the previous one, and clears the marks of the pages in use.
+    // Pages used outside of sequential scans carry an extra mark, so it takes three sweeps to release every page.
+    // A sweep is skipped while a reader which began before the previous one may still be using the pages.
+    info.progress_index = 0;
+    for (int pass = include_recent ? 3 : 1; pass > 0; --pass) {
+        size_t work_limit = std::numeric_limits<size_t>::max();
+        reclaim_pages_for_file(info, work_limit);
+    }
+    size_t after = count_pages();
+    return (before - after) * page_size();
+}
+
 SharedFileInfo* get_file_info_for_file(File& file)
 {
     LockGuard lock(mapping_mutex);
@@ -736,6 +812,63 @@ void* mmap_anon(size_t size)
 #endif
 }
 
+void madvise(void* addr, size_t size, MappingAdvice advice) noexcept
+{
+#ifndef _WIN32
+    int flag = MADV_NORMAL;
+    switch (advice) {
+        case MappingAdvice::Normal:
+            break;
+        case MappingAdvice::Random:
+            flag = MADV_RANDOM;
+            break;
+        case MappingAdvice::Sequential:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case MappingAdvice::WillNeed:
+            flag = MADV_WILLNEED;
+            break;
+        case MappingAdvice::HugePages:
+#ifdef MADV_HUGEPAGE
+            flag = MADV_HUGEPAGE;
+            break;
+#else
+            return;
+#endif
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~uintptr_t(page_size() - 1);
+    size_t len = round_up_to_page_size(reinterpret_cast<uintptr_t>(addr) + size - start);
+    ::madvise(reinterpret_cast<void*>(start), len, flag);
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(advice);
+#endif
+}
+
+bool get_resident_pages(void* addr, size_t size, std::vector<bool>& pages)
+{
+    pages.clear();
+#ifndef _WIN32
+    size_t num_pages = round_up_to_page_size(size) / page_size();
+#if REALM_PLATFORM_APPLE
+    std::vector<char> vec(num_pages);
+#else
+    std::vector<unsigned char> vec(num_pages);
+#endif
+    if (::mincore(addr, size, vec.data()) != 0)
+        return false;
+    pages.reserve(num_pages);
+    for (auto v : vec)
+        pages.push_back(v & 1);
+    return true;
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    return false;
+#endif
+}
+
 void* mmap_fixed(FileDesc fd, void* address_request, size_t size, File::AccessMode access, size_t offset,
                  const char* enc_key)
 {
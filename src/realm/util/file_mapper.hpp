@@ -38,6 +38,25 @@ void* mremap(FileDesc fd, size_t file_offset, void* old_addr, size_t old_size, F
 void msync(FileDesc fd, void* addr, size_t size);
 void* mmap_anon(size_t size);
 
+// Hints on how a mapped address range is going to be used
+enum class MappingAdvice {
+    Normal,     // Default read-ahead
+    Random,     // Pages are accessed in random order, so don't read ahead
+    Sequential, // Pages are accessed in order, so read ahead aggressively
+    WillNeed,   // The pages will be accessed soon, so start reading them in
+    HugePages,  // Back the range with transparent huge pages if possible
+};
+
+// Pass a hint to the kernel about the given range of a mapping. The range is
+// widened to page boundaries. As this is only a hint, it does nothing on
+// platforms without madvise(), and failures are ignored.
+void madvise(void* addr, size_t size, MappingAdvice advice) noexcept;
+
+// Find which pages of a mapped range are held in memory. On return, \a pages
+// holds one entry per page of the range, true if the page is resident. Returns
+// false if this cannot be determined.
+bool get_resident_pages(void* addr, size_t size, std::vector<bool>& pages);
+
 // A function which may be given to encryption_read_barrier. If present, the read barrier is a
 // a barrier for a full array. If absent, the read barrier is a barrier only for the address
 // range give as argument. If the barrier is for a full array, it will read the array header
@@ -75,6 +94,32 @@ inline void set_page_reclaim_governor_to_default()
 // Retrieves the number of in memory decrypted pages, across all open files.
 size_t get_num_decrypted_pages();
 
+struct DecryptedPageStats {
+    size_t decrypted_pages = 0; // Pages currently held decrypted in memory
+    uint64_t hits = 0;          // Accesses to pages which were already decrypted
+    uint64_t misses = 0;        // Accesses which required a page to be decrypted
+    uint64_t reclaimed = 0;     // Pages released again by the page reclaimer
+};
+
+// Retrieves statistics of the decrypted pages, summed over all open files.
+DecryptedPageStats get_decrypted_page_stats();
+
+// Tells the page reclaimer that the pages the current thread decrypts while
+// an instance exists are read by a sequential scan. Such pages are released
+// before pages which have been used outside of a scan, so that a scan through
+// a large encrypted file does not evict the pages other work depends on.
+// Cluster tree traversals made while an instance exists also prefetch the
+// leaves ahead of the one being visited.
+class SequentialScanHint {
+public:
+    SequentialScanHint() noexcept;
+    ~SequentialScanHint() noexcept;
+    SequentialScanHint(const SequentialScanHint&) = delete;
+    SequentialScanHint& operator=(const SequentialScanHint&) = delete;
+
+    static bool is_active() noexcept;
+};
+
 #if REALM_ENABLE_ENCRYPTION
 
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id);
@@ -82,6 +127,18 @@ void encryption_note_reader_end(SharedFileInfo& info, const void* reader_id) noe
 
 SharedFileInfo* get_file_info_for_file(File& file);
 
+// Limit the memory held by decrypted pages of the file to about \a budget
+// bytes. The page reclaimer enforces the limit in addition to the target set
+// by the governor. When several budgets are given for the same file, the
+// smallest one is used.
+void set_decrypted_page_budget(SharedFileInfo& info, size_t budget);
+
+// Release the decrypted pages of the file which no reader can be using, without
+// waiting for the page reclaimer. Pages used since the last sweep of the
+// reclaimer are only released if \a include_recent is true. Returns the number
+// of bytes released.
+size_t reclaim_decrypted_pages(SharedFileInfo& info, bool include_recent);
+
 // This variant allows the caller to obtain direct access to the encrypted file mapping
 // for optimization purposes.
 void* mmap(FileDesc fd, size_t size, File::AccessMode access, size_t offset, const char* encryption_key,
@@ -147,6 +204,11 @@ size_t inline get_num_decrypted_pages()
     return 0;
 }
 
+inline DecryptedPageStats get_decrypted_page_stats()
+{
+    return {};
+}
+
 void inline encryption_read_barrier(const void*, size_t, EncryptedFileMapping*, HeaderToSize = nullptr) {}
 
 void inline encryption_write_barrier(const void*, size_t) {}
@@ -34,6 +34,14 @@
 #include <sys/time.h>
 #endif
 
+#ifdef REALM_CONDVAR_FUTEX
+#include <cerrno>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #include <Windows.h>
 #include <set>
@@ -224,6 +232,50 @@ void notify_fd(int fd)
 } // anonymous namespace
 #endif // REALM_CONDVAR_EMULATION
 
+#ifdef REALM_CONDVAR_FUTEX
+
+namespace {
+
+constexpr uint32_t all_tickets = FUTEX_BITSET_MATCH_ANY;
+
+uint32_t get_ticket_bit(uint32_t ticket) noexcept
+{
+    return uint32_t(1) << (ticket % 32);
+}
+
+// Not FUTEX_PRIVATE_FLAG, as the waiters may be in other processes
+long futex(std::atomic<uint32_t>& word, int op, uint32_t val, const struct timespec* tp, uint32_t bitset) noexcept
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, val, tp, nullptr, bitset);
+}
+
+// Waiting and notifying are ordered by the mutex, so a notification which is
+// made after the mutex is released, but before the waiter sleeps, changes the
+// sequence and makes the futex return at once.
+void futex_wait(InterprocessCondVar::SharedPart& shared_part, InterprocessMutex& m, const struct timespec* tp,
+                uint32_t bitset)
+{
+    uint32_t sequence = shared_part.sequence.load(std::memory_order_relaxed);
+    ++shared_part.num_waiters;
+    m.unlock();
+    // The time limit is absolute, which FUTEX_WAIT only supports with a bitset
+    long r = futex(shared_part.sequence, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, sequence, tp, bitset);
+    REALM_ASSERT_EX(r == 0 || errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT, errno);
+    m.lock();
+    --shared_part.num_waiters;
+}
+
+void futex_notify(InterprocessCondVar::SharedPart& shared_part, uint32_t bitset) noexcept
+{
+    shared_part.sequence.fetch_add(1, std::memory_order_relaxed);
+    if (shared_part.num_waiters > 0)
+        futex(shared_part.sequence, FUTEX_WAKE_BITSET, INT_MAX, nullptr, bitset);
+}
+
+} // anonymous namespace
+#endif // REALM_CONDVAR_FUTEX
+
 InterprocessCondVar::InterprocessCondVar() {}
 
 
@@ -410,6 +462,9 @@ void InterprocessCondVar::init_shared_part(SharedPart& shared_part)
     shared_part.wait_counter = 0;
     shared_part.signal_counter = 0;
 #endif
+#elif defined(REALM_CONDVAR_FUTEX)
+    shared_part.sequence.store(0, std::memory_order_relaxed);
+    shared_part.num_waiters = 0;
 #else
     new (&shared_part) CondVar(CondVar::process_shared_tag());
 #endif // REALM_CONDVAR_EMULATION
@@ -589,6 +644,8 @@ void InterprocessCondVar::wait(InterprocessMutex& m, const struct timespec* tp)
 
 #endif // _WIN32
 
+#elif defined(REALM_CONDVAR_FUTEX)
+    futex_wait(*m_shared_part, m, tp, all_tickets);
 #else
     m_shared_part->wait(
         *m.m_shared_part, []() {}, tp);
@@ -596,6 +653,18 @@ void InterprocessCondVar::wait(InterprocessMutex& m, const struct timespec* tp)
 }
 
 
+void InterprocessCondVar::wait_for_ticket(InterprocessMutex& m, const struct timespec* tp, uint32_t ticket)
+{
+#ifdef REALM_CONDVAR_FUTEX
+    REALM_ASSERT(m_shared_part);
+    futex_wait(*m_shared_part, m, tp, get_ticket_bit(ticket));
+#else
+    static_cast<void>(ticket);
+    wait(m, tp);
+#endif
+}
+
+
 // Notify_all:
 // precondition: The caller holds the mutex guarding the condition variable.
 // operation: If waiters are present, we wake them up by writing a single
@@ -627,11 +696,25 @@ void InterprocessCondVar::notify_all() noexcept
         notify_fd(m_fd_write != -1 ? m_fd_write : m_fd_read);
     }
 #endif
+#elif defined(REALM_CONDVAR_FUTEX)
+    futex_notify(*m_shared_part, all_tickets);
 #else
     m_shared_part->notify_all();
 #endif
 }
 
+
+void InterprocessCondVar::notify_ticket(uint32_t ticket) noexcept
+{
+#ifdef REALM_CONDVAR_FUTEX
+    REALM_ASSERT(m_shared_part);
+    futex_notify(*m_shared_part, get_ticket_bit(ticket));
+#else
+    static_cast<void>(ticket);
+    notify_all();
+#endif
+}
+
 #ifdef _WIN32
 void InterprocessCondVar::Event::wait(DWORD millis) noexcept
 {
@@ -23,6 +23,7 @@
 #include <realm/util/features.h>
 #include <realm/util/thread.hpp>
 #include <realm/util/interprocess_mutex.hpp>
+#include <atomic>
 #include <cstdint>
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -35,6 +36,10 @@
 // Condvar Emulation is required if RobustMutex emulation is enabled
 #if REALM_ROBUST_MUTEX_EMULATION || defined(_WIN32)
 #define REALM_CONDVAR_EMULATION
+#elif defined(__linux__)
+// On Linux the condition variable is a futex, which allows waking only some of
+// the waiters, and notifying without a system call when nobody waits.
+#define REALM_CONDVAR_FUTEX
 #endif
 
 namespace realm {
@@ -43,7 +48,8 @@ namespace util {
 
 /// Condition variable for use in synchronization monitors.
 /// This condition variable uses emulation based on named pipes
-/// for the inter-process case, if enabled by REALM_CONDVAR_EMULATION.
+/// for the inter-process case, if enabled by REALM_CONDVAR_EMULATION,
+/// and a futex on Linux.
 ///
 /// FIXME: This implementation will never release/delete pipes. This is unlikely
 /// to be a problem as long as only a modest number of different database names
@@ -80,6 +86,15 @@ public:
         uint64_t wait_counter;
 #endif
     };
+#elif defined(REALM_CONDVAR_FUTEX)
+    struct SharedPart {
+        // Bumped by every notification. Waiters sleep on it.
+        std::atomic<uint32_t> sequence;
+        // Guarded by the mutex. A process which dies while waiting leaves it
+        // too high, which only costs notifications a needless system call.
+        uint32_t num_waiters;
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
 #else
     typedef CondVar SharedPart;
 #endif
@@ -145,6 +160,17 @@ public:
     /// within the same mutex hold.
     void notify_all() noexcept;
 
+    /// Like wait(), but where supported only woken by notify_ticket() for the
+    /// same ticket, or by notify_all(). Tickets which are equal modulo 32 are
+    /// not distinguished. Elsewhere this is the same as wait(), and the
+    /// waiter is woken by any notification.
+    void wait_for_ticket(InterprocessMutex& m, const struct timespec* tp, uint32_t ticket);
+
+    /// Wake up the threads waiting for the ticket in wait_for_ticket(), and
+    /// possibly others. The caller must hold the lock associated with the
+    /// condvar.
+    void notify_ticket(uint32_t ticket) noexcept;
+
     /// Cleanup and release system resources if possible.
     void close() noexcept;
 
@@ -61,6 +61,94 @@ void ThreadSafeLogger::do_log(Level level, const std::string& message)
     Logger::do_log(m_base_logger, level, message); // Throws
 }
 
+AsyncLogger::AsyncLogger(Logger& base_logger, Level threshold, size_t max_pending)
+    : Logger::LevelThreshold()
+    , Logger(static_cast<Logger::LevelThreshold&>(*this))
+    , m_level_threshold(threshold)
+    , m_base_logger(base_logger)
+    , m_max_pending(max_pending)
+{
+    m_pending.reserve(m_max_pending); // Throws
+    m_thread = std::thread([this] {
+        run();
+    }); // Throws
+}
+
+AsyncLogger::~AsyncLogger() noexcept
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void AsyncLogger::flush()
+{
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [&] {
+        return m_pending.empty() && !m_writing;
+    });
+}
+
+uint_fast64_t AsyncLogger::get_dropped_count() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_num_dropped;
+}
+
+void AsyncLogger::do_log(Level level, const std::string& message)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_pending.size() >= m_max_pending) {
+            ++m_num_dropped;
+            return;
+        }
+        m_pending.push_back({level, message}); // Throws
+    }
+    m_cv.notify_all();
+}
+
+void AsyncLogger::run() noexcept
+{
+    // Swapped with the queue, so that the memory of both is reused
+    std::vector<Message> batch;
+    batch.reserve(m_max_pending);
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [&] {
+            return m_stop || !m_pending.empty();
+        });
+        if (m_pending.empty())
+            return; // Stopped
+        batch.swap(m_pending);
+        uint_fast64_t num_dropped = m_num_dropped - m_num_dropped_reported;
+        m_num_dropped_reported = m_num_dropped;
+        m_writing = true;
+        lock.unlock();
+
+        // A failing base logger has nowhere to report to, so such messages
+        // are lost
+        try {
+            for (auto& message : batch)
+                Logger::do_log(m_base_logger, message.level, message.text); // Throws
+            if (num_dropped != 0) {
+                Logger::do_log(m_base_logger, Level::warn,
+                               util::format("%1 log messages were dropped", num_dropped)); // Throws
+            }
+        }
+        catch (...) {
+        }
+        batch.clear();
+
+        lock.lock();
+        m_writing = false;
+        m_cv.notify_all();
+    }
+}
+
 void PrefixLogger::do_log(Level level, const std::string& message)
 {
     Logger::do_log(m_base_logger, level, m_prefix + message); // Throws
@@ -23,10 +23,14 @@
 #include <realm/util/thread.hpp>
 #include <realm/util/file.hpp>
 
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace realm::util {
 
@@ -203,6 +207,54 @@ private:
 };
 
 
+/// A thread-safe logger which passes the messages on to the base logger from a
+/// background thread, so that the logging thread does not wait for the I/O of
+/// the base logger. The base logger is only used by the background thread, and
+/// so need not be thread-safe. Like ThreadSafeLogger, this logger has its own
+/// fixed level threshold.
+///
+/// At most `max_pending` messages are queued. Messages logged while the queue
+/// is full are dropped, and the number of dropped messages is logged once the
+/// background thread has caught up. Messages still queued when the logger is
+/// destroyed are written first.
+class AsyncLogger : private Logger::LevelThreshold, public Logger {
+public:
+    explicit AsyncLogger(Logger& base_logger, Level = Level::info, size_t max_pending = 4096);
+    ~AsyncLogger() noexcept;
+
+    /// Wait until all messages logged so far have been passed on to the base
+    /// logger.
+    void flush();
+
+    /// The number of messages dropped because the queue was full.
+    uint_fast64_t get_dropped_count() const noexcept;
+
+protected:
+    void do_log(Level, const std::string&) override final;
+
+private:
+    struct Message {
+        Level level;
+        std::string text;
+    };
+
+    const Level m_level_threshold; // Immutable for thread safety
+    Logger& m_base_logger;
+    const size_t m_max_pending;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Message> m_pending;
+    uint_fast64_t m_num_dropped = 0;
+    uint_fast64_t m_num_dropped_reported = 0;
+    bool m_writing = false;
+    bool m_stop = false;
+    std::thread m_thread;
+
+    Level get() const noexcept override final;
+    void run() noexcept;
+};
+
+
 /// A logger that adds a fixed prefix to each message. This logger inherits the
 /// LevelThreshold object of the specified base logger. This logger is
 /// thread-safe if, and only if the base logger is thread-safe.
@@ -450,6 +502,11 @@ inline Logger::Level ThreadSafeLogger::get() const noexcept
     return m_level_threshold;
 }
 
+inline Logger::Level AsyncLogger::get() const noexcept
+{
+    return m_level_threshold;
+}
+
 inline PrefixLogger::PrefixLogger(std::string prefix, Logger& base_logger) noexcept
     : Logger(base_logger.level_threshold)
     , m_prefix(std::move(prefix))
@@ -5,6 +5,8 @@
 #include <limits>
 #include <algorithm>
 #include <vector>
+#include <map>
+#include <tuple>
 #include <stdexcept>
 #include <thread>
 
@@ -12,6 +14,7 @@
 
 #ifndef _WIN32
 #include <netinet/tcp.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <poll.h>
 #include <realm/util/to_string.hpp>
@@ -21,8 +24,8 @@
 #include <realm/util/optional.hpp>
 #include <realm/util/misc_errors.hpp>
 #include <realm/util/thread.hpp>
-#include <realm/util/priority_queue.hpp>
 #include <realm/util/network.hpp>
+#include <realm/utilities.hpp>
 
 #if defined _GNU_SOURCE && !REALM_ANDROID
 #define HAVE_LINUX_PIPE2 1
@@ -348,30 +351,88 @@ private:
 
 #else // defined _WIN32
 
+// Windows has no pipes that can be waited for together with sockets, so a
+// connected pair of loopback sockets stands in for one. This lets WSAPoll()
+// block on the sockets of all the operations and the wakeup signal at once,
+// rather than polling them in turns.
 class WakeupPipe {
 public:
-    SOCKET wait_fd() const noexcept
+    WakeupPipe()
     {
-        return INVALID_SOCKET;
+        CloseGuard listener{make_socket()}; // Throws
+        sockaddr_in addr = sockaddr_in();
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        sockaddr* addr_2 = reinterpret_cast<sockaddr*>(&addr);
+        int addr_size = int(sizeof addr);
+        check(::bind(listener, addr_2, addr_size));          // Throws
+        check(::getsockname(listener, addr_2, &addr_size)); // Throws
+        check(::listen(listener, 1));                       // Throws
+        m_write_fd.reset(make_socket());                    // Throws
+        check(::connect(m_write_fd, addr_2, addr_size));    // Throws
+        SOCKET fd = ::accept(listener, nullptr, nullptr);
+        if (REALM_UNLIKELY(fd == INVALID_SOCKET))
+            throw std::system_error(make_winsock_error_code(WSAGetLastError()));
+        m_read_fd.reset(fd);
+        set_nonblock_flag(m_read_fd); // Throws
+        BOOL no_delay = TRUE;
+        check(::setsockopt(m_write_fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay),
+                           int(sizeof no_delay))); // Throws
     }
 
-    void signal() noexcept
+    // Thread-safe.
+    SOCKET wait_fd() const noexcept
     {
-        m_signal_count++;
+        return m_read_fd;
     }
 
-    bool is_signaled() const noexcept
+    // Cause the wait descriptor (wait_fd()) to become readable within a short
+    // amount of time.
+    //
+    // Thread-safe.
+    void signal() noexcept
     {
-        return m_signal_count > 0;
+        LockGuard lock{m_mutex};
+        if (!m_signaled) {
+            char c = 0;
+            int ret = ::send(m_write_fd, &c, 1, 0);
+            REALM_ASSERT_RELEASE(ret == 1);
+            m_signaled = true;
+        }
     }
 
+    // Must be called after the wait descriptor (wait_fd()) becomes readable.
+    //
+    // Thread-safe.
     void acknowledge_signal() noexcept
     {
-        m_signal_count--;
+        LockGuard lock{m_mutex};
+        if (m_signaled) {
+            char c;
+            int ret = ::recv(m_read_fd, &c, 1, 0);
+            REALM_ASSERT_RELEASE(ret == 1);
+            m_signaled = false;
+        }
     }
 
 private:
-    std::atomic<uint32_t> m_signal_count = 0;
+    CloseGuard m_read_fd, m_write_fd;
+    Mutex m_mutex;
+    bool m_signaled = false; // Protected by `m_mutex`.
+
+    static SOCKET make_socket()
+    {
+        SOCKET fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (REALM_UNLIKELY(fd == INVALID_SOCKET))
+            throw std::system_error(make_winsock_error_code(WSAGetLastError()));
+        return fd;
+    }
+
+    static void check(int ret)
+    {
+        if (REALM_UNLIKELY(ret == SOCKET_ERROR))
+            throw std::system_error(make_winsock_error_code(WSAGetLastError()));
+    }
 };
 
 #endif // defined _WIN32
@@ -421,6 +482,78 @@ struct GetaddrinfoResultOwner {
     }
 };
 
+
+// Results of getaddrinfo(), shared by all services of the process, so that a
+// reconnect, or a burst of connections to the same host, does not wait for a
+// lookup every time. getaddrinfo() does not report the time to live of the DNS
+// records, so successful results are kept for a fixed time that is short
+// compared to common record TTLs. Failures to find the host are kept for an even
+// shorter time, and transient failures are not kept at all.
+class ResolverCache {
+public:
+    static constexpr auto positive_ttl = std::chrono::seconds(30);
+    static constexpr auto negative_ttl = std::chrono::seconds(5);
+    static constexpr std::size_t max_entries = 256;
+
+    using clock = std::chrono::steady_clock;
+    using Key = std::tuple<std::string, std::string, int, int, int, int>;
+
+    static ResolverCache& get() noexcept
+    {
+        static ResolverCache cache;
+        return cache;
+    }
+
+    // Returns false if no unexpired entry is found.
+    bool find(const Key& key, std::vector<Endpoint>& endpoints, std::error_code& ec)
+    {
+        LockGuard lock{m_mutex};
+        auto i = m_entries.find(key);
+        if (i == m_entries.end())
+            return false;
+        if (clock::now() >= i->second.expires_at) {
+            m_entries.erase(i);
+            return false;
+        }
+        endpoints = i->second.endpoints; // Throws
+        ec = i->second.error;
+        return true;
+    }
+
+    void add(Key key, std::vector<Endpoint> endpoints, std::error_code ec)
+    {
+        bool cacheable = (!ec || ec == ResolveErrors::host_not_found || ec == ResolveErrors::service_not_found);
+        if (!cacheable)
+            return;
+        clock::time_point now = clock::now();
+        clock::time_point expires_at = now + (ec ? clock::duration(negative_ttl) : clock::duration(positive_ttl));
+        LockGuard lock{m_mutex};
+        if (m_entries.size() >= max_entries) {
+            for (auto i = m_entries.begin(); i != m_entries.end();)
+                i = (now >= i->second.expires_at ? m_entries.erase(i) : std::next(i));
+            if (m_entries.size() >= max_entries)
+                m_entries.erase(m_entries.begin());
+        }
+        m_entries[std::move(key)] = {std::move(endpoints), ec, expires_at}; // Throws
+    }
+
+    void remove(const Key& key) noexcept
+    {
+        LockGuard lock{m_mutex};
+        m_entries.erase(key);
+    }
+
+private:
+    struct Entry {
+        std::vector<Endpoint> endpoints;
+        std::error_code error;
+        clock::time_point expires_at;
+    };
+
+    Mutex m_mutex;
+    std::map<Key, Entry> m_entries; // Protected by `m_mutex`
+};
+
 } // unnamed namespace
 
 
@@ -1122,49 +1255,11 @@ bool Service::IoReactor::wait_and_advance(clock::time_point timeout, clock::time
 #endif
 
 #ifdef _WIN32
-            max_wait_millis = 1000;
-
-            // Windows does not have a single API call to wait for pipes and
-            // sockets with a timeout. So we repeatedly poll them individually
-            // in a loop until max_wait_millis has elapsed or an event happend.
-            //
-            // FIXME: Maybe switch to Windows IOCP instead.
-
-            // Following variable is the poll time for the sockets in
-            // miliseconds. Adjust it to find a balance between CPU usage and
-            // response time:
-            constexpr INT socket_poll_timeout = 10;
-
-            for (size_t t = 0; t < m_pollfd_slots.size(); t++)
-                m_pollfd_slots[t].revents = 0;
-
-            using namespace std::chrono;
-            auto started = steady_clock::now();
-            int ret = 0;
-
-            for (;;) {
-                if (m_pollfd_slots.size() > 1) {
-                    // Poll all network sockets
-                    ret = WSAPoll(LPWSAPOLLFD(&m_pollfd_slots[1]), ULONG(m_pollfd_slots.size() - 1),
-                                  socket_poll_timeout);
-                    REALM_ASSERT(ret != SOCKET_ERROR);
-                }
-
-                if (m_wakeup_pipe.is_signaled()) {
-                    m_pollfd_slots[0].revents = POLLIN;
-                    ret++;
-                }
-
-                if (ret != 0 ||
-                    (duration_cast<milliseconds>(steady_clock::now() - started).count() >= max_wait_millis)) {
-                    break;
-                }
-
-                // If we don't have any sockets to poll for (m_pollfd_slots is less than 2) and no one signals
-                // the wakeup pipe, we'd be stuck busy waiting for either condition to become true.
-                std::this_thread::sleep_for(std::chrono::milliseconds(socket_poll_timeout));
+            int ret = WSAPoll(LPWSAPOLLFD(fds), ULONG(nfds), max_wait_millis);
+            if (REALM_UNLIKELY(ret == SOCKET_ERROR)) {
+                std::error_code ec = make_winsock_error_code(WSAGetLastError());
+                throw std::system_error(ec);
             }
-
 #else // !defined _WIN32
             int ret = ::poll(fds, nfds, max_wait_millis);
 #endif
@@ -1321,6 +1416,322 @@ auto Service::IoReactor::get_and_reset_sleep_time() noexcept -> clock::duration
 #endif // REALM_UTIL_NETWORK_EVENT_LOOP_METRICS
 
 
+// A hashed hierarchical timer wheel (Varghese & Lauck) holding the incomplete
+// wait operations of a service. Time is divided into ticks of one
+// millisecond. Level 0 has a slot per tick for the next 256 ticks, and each of
+// the four levels above it has 64 slots, each covering 64 times as many ticks
+// as a slot in the level below. When the current tick enters a new range of a
+// higher level, the operations in the corresponding slot are cascaded into the
+// lower levels. Operations are kept in intrusive doubly linked lists, so arming
+// and canceling a timer are O(1) regardless of the number of pending timers,
+// and bitmaps of non-empty slots let the wheel skip idle stretches of time.
+//
+// Operations expire precisely at their expiration time, not at the end of a
+// tick, and operations that expire together complete in order of expiration
+// time, and then in order of initiation.
+class Service::TimerWheel {
+public:
+    TimerWheel() noexcept
+        : m_origin{clock::now()}
+    {
+    }
+
+    ~TimerWheel() noexcept
+    {
+        for (WaitOperBase*& slot : m_slots) {
+            while (WaitOperBase* op = slot) {
+                slot = op->m_wheel_next;
+                LendersWaitOperPtr lenders_ptr{op}; // Recycle
+            }
+        }
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    void add(LendersWaitOperPtr op) noexcept
+    {
+        op->m_wait_seq = m_next_seq++;
+        if (m_timeout_valid && op->m_expiration_time < m_timeout)
+            m_timeout = op->m_expiration_time;
+        insert(*op.release());
+        ++m_size;
+    }
+
+    LendersWaitOperPtr remove(WaitOperBase& op) noexcept
+    {
+        unlink(op);
+        --m_size;
+        m_timeout_valid = false;
+        return LendersWaitOperPtr{&op};
+    }
+
+    /// Complete all operations that have expired at `now`, and move them to
+    /// `completed` in order of expiration.
+    bool expire(clock::time_point now, OperQueue<AsyncOper>& completed)
+    {
+        std::uint_fast64_t now_tick = to_tick(now);
+        if (m_size == 0) {
+            if (m_tick < now_tick)
+                m_tick = now_tick;
+            return false;
+        }
+        bool any_expired = false;
+        for (;;) {
+            std::uint_fast64_t tick = next_event_tick();
+            if (tick > now_tick) {
+                // Nothing to expire or cascade between here and `now_tick`
+                if (m_tick < now_tick)
+                    m_tick = now_tick;
+                break;
+            }
+            if (tick > m_tick)
+                advance(tick);
+            if (m_tick < now_tick) {
+                any_expired |= take_expired(nullptr, completed); // Throws
+                advance(m_tick + 1);
+                continue;
+            }
+            any_expired |= take_expired(&now, completed); // Throws
+            break;
+        }
+        // Nothing is cascaded before the cached timeout is reached
+        if (any_expired || !(now < m_timeout))
+            m_timeout_valid = false;
+        return any_expired;
+    }
+
+    /// Returns the point in time at which expire() should be called next, or
+    /// the epoch if there are no operations. This may be earlier than the
+    /// earliest expiration time when operations have to be cascaded first.
+    clock::time_point next_timeout() noexcept
+    {
+        if (m_size == 0)
+            return clock::time_point{};
+        if (!m_timeout_valid) {
+            std::uint_fast64_t tick_0 = next_level_0_tick();
+            std::uint_fast64_t tick_1 = next_cascade_tick();
+            if (tick_0 < tick_1) {
+                std::size_t slot = std::size_t(tick_0 & s_level_0_mask);
+                m_timeout = m_slots[slot]->m_expiration_time;
+                for (WaitOperBase* op = m_slots[slot]->m_wheel_next; op; op = op->m_wheel_next) {
+                    if (op->m_expiration_time < m_timeout)
+                        m_timeout = op->m_expiration_time;
+                }
+            }
+            else {
+                m_timeout = m_origin + std::chrono::milliseconds(tick_1);
+            }
+            m_timeout_valid = true;
+        }
+        return m_timeout;
+    }
+
+private:
+    static constexpr int s_level_0_bits = 8;
+    static constexpr int s_level_bits = 6;
+    static constexpr int s_num_upper_levels = 4;
+    static constexpr std::uint_fast64_t s_level_0_mask = (std::uint_fast64_t(1) << s_level_0_bits) - 1;
+    static constexpr std::uint_fast64_t s_level_mask = (std::uint_fast64_t(1) << s_level_bits) - 1;
+    static constexpr std::size_t s_level_0_size = std::size_t(1) << s_level_0_bits;
+    static constexpr std::size_t s_level_size = std::size_t(1) << s_level_bits;
+    static constexpr std::size_t s_num_slots = s_level_0_size + s_num_upper_levels * s_level_size;
+    // Ticks further into the future than this are parked in the last level
+    // and cascaded back into it until they get within range.
+    static constexpr std::uint_fast64_t s_max_delta =
+        (std::uint_fast64_t(1) << (s_level_0_bits + s_num_upper_levels * s_level_bits)) - 1;
+
+    const clock::time_point m_origin;
+    std::uint_fast64_t m_tick = 0; // Ticks before this one have been processed
+    std::size_t m_size = 0;
+    std::uint_fast64_t m_next_seq = 0;
+    WaitOperBase* m_slots[s_num_slots] = {};
+    std::uint64_t m_nonempty[s_num_slots / 64] = {}; // One bit per slot
+    clock::time_point m_timeout;
+    bool m_timeout_valid = false;
+    std::vector<WaitOperBase*> m_expired;
+
+    // Level `level` is 1-based for the upper levels.
+    static int level_shift(int level) noexcept
+    {
+        return s_level_0_bits + (level - 1) * s_level_bits;
+    }
+
+    static std::size_t level_slot(int level, std::uint_fast64_t tick) noexcept
+    {
+        return s_level_0_size + std::size_t(level - 1) * s_level_size +
+               std::size_t((tick >> level_shift(level)) & s_level_mask);
+    }
+
+    static int lowest_bit(std::uint64_t word) noexcept
+    {
+        REALM_ASSERT(word != 0);
+        if (std::uint32_t(word) != 0)
+            return ctz(std::size_t(std::uint32_t(word)));
+        return 32 + ctz(std::size_t(word >> 32));
+    }
+
+    std::uint_fast64_t to_tick(clock::time_point time) const noexcept
+    {
+        if (time <= m_origin)
+            return 0;
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time - m_origin);
+        return std::uint_fast64_t(millis.count());
+    }
+
+    void insert(WaitOperBase& op) noexcept
+    {
+        std::uint_fast64_t tick = std::max(to_tick(op.m_expiration_time), m_tick);
+        std::uint_fast64_t delta = tick - m_tick;
+        if (delta <= s_level_0_mask) {
+            link(op, std::size_t(tick & s_level_0_mask));
+            return;
+        }
+        for (int level = 1; level < s_num_upper_levels; ++level) {
+            if (delta < (std::uint_fast64_t(1) << (level_shift(level) + s_level_bits))) {
+                link(op, level_slot(level, tick));
+                return;
+            }
+        }
+        if (delta > s_max_delta)
+            tick = m_tick + s_max_delta;
+        link(op, level_slot(s_num_upper_levels, tick));
+    }
+
+    void link(WaitOperBase& op, std::size_t slot) noexcept
+    {
+        WaitOperBase* next = m_slots[slot];
+        op.m_wheel_prev = nullptr;
+        op.m_wheel_next = next;
+        op.m_wheel_slot = slot;
+        if (next)
+            next->m_wheel_prev = &op;
+        m_slots[slot] = &op;
+        m_nonempty[slot / 64] |= std::uint64_t(1) << (slot % 64);
+    }
+
+    void unlink(WaitOperBase& op) noexcept
+    {
+        std::size_t slot = op.m_wheel_slot;
+        if (op.m_wheel_prev) {
+            op.m_wheel_prev->m_wheel_next = op.m_wheel_next;
+        }
+        else {
+            REALM_ASSERT(m_slots[slot] == &op);
+            m_slots[slot] = op.m_wheel_next;
+        }
+        if (op.m_wheel_next)
+            op.m_wheel_next->m_wheel_prev = op.m_wheel_prev;
+        if (!m_slots[slot])
+            m_nonempty[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+    }
+
+    // Move the current tick forward to `tick`, and cascade the slots of the
+    // upper levels whose range begins at that tick.
+    void advance(std::uint_fast64_t tick) noexcept
+    {
+        m_tick = tick;
+        for (int level = 1; level <= s_num_upper_levels; ++level) {
+            if ((tick & ((std::uint_fast64_t(1) << level_shift(level)) - 1)) != 0)
+                break;
+            std::size_t slot = level_slot(level, tick);
+            WaitOperBase* op = m_slots[slot];
+            m_slots[slot] = nullptr;
+            m_nonempty[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+            while (op) {
+                WaitOperBase* next = op->m_wheel_next;
+                insert(*op);
+                op = next;
+            }
+        }
+    }
+
+    // The first tick, no earlier than the current one, with a non-empty
+    // level 0 slot.
+    std::uint_fast64_t next_level_0_tick() const noexcept
+    {
+        std::size_t begin = std::size_t(m_tick & s_level_0_mask);
+        constexpr std::size_t num_words = s_level_0_size / 64;
+        for (std::size_t i = 0; i <= num_words; ++i) {
+            std::size_t word_ndx = (begin / 64 + i) % num_words;
+            std::uint64_t word = m_nonempty[word_ndx];
+            if (i == 0)
+                word &= ~std::uint64_t(0) << (begin % 64);
+            else if (i == num_words)
+                word &= ~(~std::uint64_t(0) << (begin % 64));
+            if (word != 0) {
+                std::size_t slot = word_ndx * 64 + std::size_t(lowest_bit(word));
+                return m_tick + ((slot - begin) & s_level_0_mask);
+            }
+        }
+        return std::numeric_limits<std::uint_fast64_t>::max();
+    }
+
+    // The first tick, later than the current one, at which a non-empty slot of
+    // an upper level is to be cascaded.
+    std::uint_fast64_t next_cascade_tick() const noexcept
+    {
+        std::uint_fast64_t result = std::numeric_limits<std::uint_fast64_t>::max();
+        for (int level = 1; level <= s_num_upper_levels; ++level) {
+            std::uint64_t word = m_nonempty[(s_level_0_size + std::size_t(level - 1) * s_level_size) / 64];
+            if (word == 0)
+                continue;
+            int shift = level_shift(level);
+            std::uint_fast64_t block = m_tick >> shift;
+            // Rotate so that bit 0 corresponds to the slot of the next block
+            int rotation = int((block + 1) & s_level_mask);
+            std::uint64_t rotated = (rotation == 0 ? word : (word >> rotation) | (word << (64 - rotation)));
+            std::uint_fast64_t tick = (block + 1 + std::uint_fast64_t(lowest_bit(rotated))) << shift;
+            result = std::min(result, tick);
+        }
+        return result;
+    }
+
+    std::uint_fast64_t next_event_tick() const noexcept
+    {
+        return std::min(next_level_0_tick(), next_cascade_tick());
+    }
+
+    // Complete the operations of the level 0 slot of the current tick that
+    // have expired, and move them to `completed` in order of expiration. If
+    // `now` is null, the tick has passed, and all of them have expired.
+    bool take_expired(const clock::time_point* now, OperQueue<AsyncOper>& completed)
+    {
+        std::size_t slot = std::size_t(m_tick & s_level_0_mask);
+        std::size_t n = 0;
+        for (WaitOperBase* op = m_slots[slot]; op; op = op->m_wheel_next)
+            ++n;
+        if (n == 0)
+            return false;
+        m_expired.clear();
+        m_expired.reserve(n); // Throws
+        WaitOperBase* op = m_slots[slot];
+        while (op) {
+            WaitOperBase* next = op->m_wheel_next;
+            if (!now || op->m_expiration_time <= *now) {
+                unlink(*op);
+                m_expired.push_back(op);
+            }
+            op = next;
+        }
+        auto less = [](const WaitOperBase* a, const WaitOperBase* b) noexcept {
+            if (a->m_expiration_time != b->m_expiration_time)
+                return a->m_expiration_time < b->m_expiration_time;
+            return a->m_wait_seq < b->m_wait_seq;
+        };
+        std::sort(m_expired.begin(), m_expired.end(), less);
+        m_size -= m_expired.size();
+        for (WaitOperBase* op_2 : m_expired) {
+            op_2->complete();
+            completed.push_back(LendersWaitOperPtr{op_2});
+        }
+        return !m_expired.empty();
+    }
+};
+
+
 class Service::Impl {
 public:
     Service& service;
@@ -1459,9 +1870,24 @@ public:
     }
 
     static Endpoint::List resolve(const Resolver::Query&, std::error_code&);
+    static bool resolve_cached(const Resolver::Query&, Endpoint::List&, std::error_code&);
+    static void forget_cached(const Resolver::Query&) noexcept;
+    static ResolverCache::Key resolver_cache_key(const Resolver::Query&);
 
     void add_resolve_oper(LendersResolveOperPtr op)
     {
+        // A cached result completes the operation without involving the
+        // resolver thread, but the completion handler is still deferred to the
+        // event loop.
+        if (resolve_cached(op->m_query, op->m_endpoints, op->m_error_code)) { // Throws
+            {
+                LockGuard lock{m_mutex};
+                op->complete();
+                m_completed_operations_2.push_back(std::move(op));
+            }
+            io_reactor.interrupt();
+            return;
+        }
         {
             LockGuard lock{m_mutex};
             m_resolve_operations.push_back(std::move(op)); // Throws
@@ -1476,9 +1902,9 @@ public:
         m_resolver_thread = std::thread{std::move(func)};
     }
 
-    void add_wait_oper(LendersWaitOperPtr op)
+    void add_wait_oper(LendersWaitOperPtr op) noexcept
     {
-        m_wait_operations.push(std::move(op)); // Throws
+        m_wait_operations.add(std::move(op));
     }
 
     void post(PostOperConstr constr, std::size_t size, void* cookie)
@@ -1558,36 +1984,13 @@ public:
 
     void cancel_incomplete_wait_oper(WaitOperBase& op) noexcept
     {
-        auto p = std::equal_range(m_wait_operations.begin(), m_wait_operations.end(), op.m_expiration_time,
-                                  WaitOperCompare{});
-        auto pred = [&op](const LendersWaitOperPtr& op_2) {
-            return &*op_2 == &op;
-        };
-        auto i = std::find_if(p.first, p.second, pred);
-        REALM_ASSERT(i != p.second);
-        m_completed_operations.push_back(m_wait_operations.erase(i));
+        m_completed_operations.push_back(m_wait_operations.remove(op));
     }
 
 private:
     OperQueue<AsyncOper> m_completed_operations; // Completed, canceled, and post operations
 
-    struct WaitOperCompare {
-        bool operator()(const LendersWaitOperPtr& a, clock::time_point b)
-        {
-            return a->m_expiration_time > b;
-        }
-        bool operator()(clock::time_point a, const LendersWaitOperPtr& b)
-        {
-            return a > b->m_expiration_time;
-        }
-        bool operator()(const LendersWaitOperPtr& a, const LendersWaitOperPtr& b)
-        {
-            return a->m_expiration_time > b->m_expiration_time;
-        }
-    };
-
-    using WaitQueue = util::PriorityQueue<LendersWaitOperPtr, std::vector<LendersWaitOperPtr>, WaitOperCompare>;
-    WaitQueue m_wait_operations;
+    TimerWheel m_wait_operations;
 
     Mutex m_mutex;
     OwnersOperPtr m_post_oper;                       // Protected by `m_mutex`
@@ -1609,25 +2012,12 @@ private:
 
     bool process_timers(clock::time_point now)
     {
-        bool any_operations_completed = false;
-        for (;;) {
-            if (m_wait_operations.empty())
-                break;
-            auto& op = m_wait_operations.top();
-            if (now < op->m_expiration_time)
-                break;
-            op->complete();
-            m_completed_operations.push_back(m_wait_operations.pop_top());
-            any_operations_completed = true;
-        }
-        return any_operations_completed;
+        return m_wait_operations.expire(now, m_completed_operations); // Throws
     }
 
     bool wait_and_process_io(clock::time_point now, bool& interrupted)
     {
-        clock::time_point timeout;
-        if (!m_wait_operations.empty())
-            timeout = m_wait_operations.top()->m_expiration_time;
+        clock::time_point timeout = m_wait_operations.next_timeout();
         bool operations_completed = io_reactor.wait_and_advance(timeout, now, interrupted,
                                                                 m_completed_operations); // Throws
         return operations_completed;
@@ -1670,10 +2060,45 @@ private:
 };
 
 
+ResolverCache::Key Service::Impl::resolver_cache_key(const Resolver::Query& query)
+{
+    const StreamProtocol& prot = query.m_protocol;
+    return {query.m_host, query.m_service, query.m_flags, prot.m_family, prot.m_socktype, prot.m_protocol}; // Throws
+}
+
+
+// This function promises to only ever throw std::bad_alloc.
+bool Service::Impl::resolve_cached(const Resolver::Query& query, Endpoint::List& list, std::error_code& ec)
+{
+    // Passive queries name local interfaces, and are not worth caching
+    if (query.m_host.empty())
+        return false;
+    std::vector<Endpoint> endpoints;
+    ResolverCache::Key key = resolver_cache_key(query); // Throws
+    if (!ResolverCache::get().find(key, endpoints, ec)) // Throws
+        return false;
+    list.m_endpoints.set_size(endpoints.size()); // Throws
+    std::copy(endpoints.begin(), endpoints.end(), list.m_endpoints.data());
+    return true;
+}
+
+
+void Service::Impl::forget_cached(const Resolver::Query& query) noexcept
+{
+    try {
+        ResolverCache::get().remove(resolver_cache_key(query)); // Throws
+    }
+    catch (std::bad_alloc&) {
+    }
+}
+
+
 // This function promises to only ever throw std::bad_alloc.
 Endpoint::List Service::Impl::resolve(const Resolver::Query& query, std::error_code& ec)
 {
     Endpoint::List list;
+    if (resolve_cached(query, list, ec)) // Throws
+        return list;
 
     using addrinfo_type = struct addrinfo;
     addrinfo_type hints = addrinfo_type(); // Clear
@@ -1699,6 +2124,8 @@ Endpoint::List Service::Impl::resolve(const Resolver::Query& query, std::error_c
         }
 #endif
         ec = translate_addrinfo_error(ret);
+        if (!query.m_host.empty())
+            ResolverCache::get().add(resolver_cache_key(query), {}, ec); // Throws
         return list;
     }
 
@@ -1744,6 +2171,10 @@ Endpoint::List Service::Impl::resolve(const Resolver::Query& query, std::error_c
     }
 
     ec = std::error_code(); // Success
+    if (!query.m_host.empty()) {
+        std::vector<Endpoint> endpoints(list.begin(), list.end());                   // Throws
+        ResolverCache::get().add(resolver_cache_key(query), std::move(endpoints), ec); // Throws
+    }
     return list;
 }
 
@@ -2082,6 +2513,85 @@ std::size_t Service::Descriptor::write_some(const char* data, std::size_t size,
 }
 
 
+std::size_t Service::Descriptor::write_some(util::Span<const util::Span<const char>> buffers,
+                                            std::error_code& ec) noexcept
+{
+    if (REALM_UNLIKELY(assume_write_would_block())) {
+        ec = error::resource_unavailable_try_again; // Failure
+        return 0;
+    }
+    REALM_ASSERT(buffers.size() <= Socket::max_write_buffers);
+    std::size_t size = 0;
+#ifdef _WIN32
+    WSABUF bufs[Socket::max_write_buffers];
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        bufs[i].buf = const_cast<char*>(buffers[i].data());
+        bufs[i].len = ULONG(buffers[i].size());
+        size += buffers[i].size();
+    }
+#else
+    struct iovec iov[Socket::max_write_buffers];
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        iov[i].iov_base = const_cast<char*>(buffers[i].data());
+        iov[i].iov_len = buffers[i].size();
+        size += buffers[i].size();
+    }
+    struct msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = decltype(msg.msg_iovlen)(buffers.size());
+#endif
+    for (;;) {
+#ifdef _WIN32
+        DWORD num_bytes_sent = 0;
+        int ret = ::WSASend(m_fd, bufs, DWORD(buffers.size()), &num_bytes_sent, 0, nullptr, nullptr);
+        if (ret == SOCKET_ERROR) {
+            int err = WSAGetLastError();
+            // Retry on interruption by system signal
+            if (err == WSAEINTR)
+                continue;
+            set_write_ready(err != WSAEWOULDBLOCK);
+            ec = make_winsock_error_code(err); // Failure
+            return 0;
+        }
+        std::size_t n = std::size_t(num_bytes_sent);
+#else
+        int flags = 0;
+#ifdef __linux__
+        // Prevent SIGPIPE when remote peer has closed the connection.
+        flags |= MSG_NOSIGNAL;
+#endif
+        ssize_t ret = ::sendmsg(m_fd, &msg, flags);
+        if (ret == -1) {
+            int err = errno;
+            // Retry on interruption by system signal
+            if (err == EINTR)
+                continue;
+#if REALM_PLATFORM_APPLE
+            // See write_some() above.
+            if (REALM_UNLIKELY(err == EPROTOTYPE))
+                err = EPIPE;
+#endif
+            if (err == EWOULDBLOCK)
+                err = EAGAIN;
+            set_write_ready(err != EAGAIN);
+            ec = make_basic_system_error_code(err); // Failure
+            return 0;
+        }
+        std::size_t n = std::size_t(ret);
+#endif
+        REALM_ASSERT(n <= size);
+#if REALM_NETWORK_USE_EPOLL
+        // See write_some() above.
+        set_write_ready(n == size);
+#else
+        set_write_ready(true);
+#endif
+        ec = std::error_code(); // Success
+        return n;
+    }
+}
+
+
 #if REALM_NETWORK_USE_EPOLL || REALM_HAVE_KQUEUE
 
 void Service::Descriptor::deregister_for_async() noexcept
@@ -2137,6 +2647,12 @@ Endpoint::List Resolver::resolve(const Query& query, std::error_code& ec)
 }
 
 
+void Resolver::forget_cached(const Query& query) noexcept
+{
+    Service::Impl::forget_cached(query);
+}
+
+
 void Resolver::cancel() noexcept
 {
     if (m_resolve_oper && m_resolve_oper->in_use() && !m_resolve_oper->is_canceled()) {
@@ -2301,7 +2817,10 @@ void SocketBase::get_option(opt_enum opt, void* value_data, std::size_t& value_s
 {
     int level = 0;
     int option_name = 0;
-    map_option(opt, level, option_name);
+    if (REALM_UNLIKELY(!map_option(opt, level, option_name))) {
+        ec = MiscExtErrors::operation_not_supported;
+        return;
+    }
 
     native_handle_type sock_fd = m_desc.native_handle();
     socklen_t option_len = socklen_t(value_size);
@@ -2317,7 +2836,10 @@ void SocketBase::set_option(opt_enum opt, const void* value_data, std::size_t va
 {
     int level = 0;
     int option_name = 0;
-    map_option(opt, level, option_name);
+    if (REALM_UNLIKELY(!map_option(opt, level, option_name))) {
+        ec = MiscExtErrors::operation_not_supported;
+        return;
+    }
 
     native_handle_type sock_fd = m_desc.native_handle();
     int ret = ::setsockopt(sock_fd, level, option_name, static_cast<const char*>(value_data), socklen_t(value_size));
@@ -2327,13 +2849,13 @@ void SocketBase::set_option(opt_enum opt, const void* value_data, std::size_t va
 }
 
 
-void SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
+bool SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
 {
     switch (opt) {
         case opt_ReuseAddr:
             level = SOL_SOCKET;
             option_name = SO_REUSEADDR;
-            return;
+            return true;
         case opt_Linger:
             level = SOL_SOCKET;
 #if REALM_PLATFORM_APPLE
@@ -2343,13 +2865,22 @@ void SocketBase::map_option(opt_enum opt, int& level, int& option_name) const
 #else
             option_name = SO_LINGER;
 #endif // REALM_PLATFORM_APPLE
-            return;
+            return true;
         case opt_NoDelay:
             level = IPPROTO_TCP;
             option_name = TCP_NODELAY; // Specified by POSIX.1-2001
-            return;
+            return true;
+        case opt_ReusePort:
+#ifdef SO_REUSEPORT
+            level = SOL_SOCKET;
+            option_name = SO_REUSEPORT;
+            return true;
+#else
+            return false;
+#endif
     }
     REALM_ASSERT(false);
+    return false;
 }
 
 
@@ -29,6 +29,7 @@
 #include <realm/util/misc_ext_errors.hpp>
 #include <realm/util/basic_system_errors.hpp>
 #include <realm/util/backtrace.hpp>
+#include <realm/util/span.hpp>
 
 // Linux epoll
 #if defined(REALM_USE_EPOLL) && !REALM_ANDROID
@@ -400,6 +401,7 @@ private:
     using LendersIoOperPtr = std::unique_ptr<IoOper, LendersOperDeleter>;
 
     class IoReactor;
+    class TimerWheel;
     class Impl;
     const std::unique_ptr<Impl> m_impl;
 
@@ -482,6 +484,7 @@ public:
     void accept(Descriptor&, StreamProtocol, Endpoint*, std::error_code&) noexcept;
     std::size_t read_some(char* buffer, std::size_t size, std::error_code&) noexcept;
     std::size_t write_some(const char* data, std::size_t size, std::error_code&) noexcept;
+    std::size_t write_some(util::Span<const util::Span<const char>> buffers, std::error_code&) noexcept;
 
     /// \tparam Oper An operation type inherited from IoOper with an initate()
     /// function that initiates the operation and figures out whether it needs
@@ -597,6 +600,16 @@ public:
     /// Cancellation happens automatically when the resolver object is destroyed.
     void cancel() noexcept;
 
+    /// \brief Forget the cached result of the specified query.
+    ///
+    /// The results of resolving a host name, successful or not, are cached for
+    /// a short while, and shared by all resolvers of the process. Call this when
+    /// the endpoints of a cached result turn out to be unreachable, such that
+    /// the next resolve operation asks the system again.
+    ///
+    /// Thread-safe.
+    static void forget_cached(const Query&) noexcept;
+
 private:
     template <class H>
     class ResolveOper;
@@ -717,6 +730,7 @@ private:
         opt_ReuseAddr, ///< `SOL_SOCKET`, `SO_REUSEADDR`
         opt_Linger,    ///< `SOL_SOCKET`, `SO_LINGER`
         opt_NoDelay,   ///< `IPPROTO_TCP`, `TCP_NODELAY` (disable the Nagle algorithm)
+        opt_ReusePort, ///< `SOL_SOCKET`, `SO_REUSEPORT`
     };
 
     template <class, int, class>
@@ -726,6 +740,13 @@ public:
     using reuse_address = Option<bool, opt_ReuseAddr, int>;
     using no_delay = Option<bool, opt_NoDelay, int>;
 
+    /// Allow several acceptors, typically one per event loop thread, to bind
+    /// to the same endpoint and have the kernel distribute incoming
+    /// connections between them. Setting or getting this option fails with
+    /// MiscExtErrors::operation_not_supported on platforms that do not offer
+    /// `SO_REUSEPORT`.
+    using reuse_port = Option<bool, opt_ReusePort, int>;
+
     // linger struct defined by POSIX sys/socket.h.
     struct linger_opt;
     using linger = Option<linger_opt, opt_Linger, struct linger>;
@@ -748,7 +769,7 @@ protected:
 
     void get_option(opt_enum, void* value_data, std::size_t& value_size, std::error_code&) const;
     void set_option(opt_enum, const void* value_data, std::size_t value_size, std::error_code&);
-    void map_option(opt_enum, int& level, int& option_name) const;
+    bool map_option(opt_enum, int& level, int& option_name) const;
 
     friend class Acceptor;
 };
@@ -1101,6 +1122,22 @@ public:
     template <class H>
     void async_write(const char* data, std::size_t size, H&& handler);
 
+    /// \brief Perform an asynchronous gather write operation.
+    ///
+    /// Same as async_write(const char*, std::size_t, H&&), except that the
+    /// concatenation of the specified buffers is written. Where the platform
+    /// allows it, as many of the buffers as the socket can accept are written
+    /// by a single system call (`sendmsg()`, or `WSASend()` on Windows), so
+    /// there is no need to copy them into a single buffer first.
+    ///
+    /// At most `max_write_buffers` buffers can be specified. The array of
+    /// buffers is copied, but the memory that they refer to must remain valid
+    /// until the completion handler starts to execute.
+    template <class H>
+    void async_write(util::Span<const util::Span<const char>> buffers, H&& handler);
+
+    static constexpr std::size_t max_write_buffers = 4;
+
     template <class H>
     void async_read_some(char* buffer, std::size_t size, H&& handler);
     template <class H>
@@ -1163,8 +1200,12 @@ private:
     class ConnectOperBase;
     template <class H>
     class ConnectOper;
+    class GatherWriteOperBase;
+    template <class H>
+    class GatherWriteOper;
 
     using LendersConnectOperPtr = std::unique_ptr<ConnectOperBase, Service::LendersOperDeleter>;
+    using LendersGatherWriteOperPtr = std::unique_ptr<GatherWriteOperBase, Service::LendersOperDeleter>;
 
     // `ec` untouched on success, but no immediate completion
     bool initiate_async_connect(const Endpoint&, std::error_code& ec);
@@ -2018,6 +2059,10 @@ public:
 protected:
     DeadlineTimer* m_timer;
     clock::time_point m_expiration_time;
+    std::uint_fast64_t m_wait_seq = 0; // Orders timers with equal expiration times
+    WaitOperBase* m_wheel_prev = nullptr;
+    WaitOperBase* m_wheel_next = nullptr;
+    std::size_t m_wheel_slot = 0;
     friend class Service;
 };
 
@@ -3180,6 +3225,112 @@ private:
     H m_handler;
 };
 
+class Socket::GatherWriteOperBase : public Service::IoOper {
+public:
+    GatherWriteOperBase(std::size_t size, Socket& sock, util::Span<const util::Span<const char>> buffers) noexcept
+        : IoOper{size}
+        , m_socket{&sock}
+    {
+        REALM_ASSERT(buffers.size() <= max_write_buffers);
+        for (util::Span<const char> buffer : buffers) {
+            if (!buffer.empty())
+                m_buffers[m_num_buffers++] = buffer;
+        }
+    }
+    Want initiate()
+    {
+        REALM_ASSERT(this == m_socket->m_write_oper.get());
+        REALM_ASSERT(!is_complete());
+        if (REALM_UNLIKELY(m_curr == m_num_buffers)) {
+            set_is_complete(true); // Success
+            return Want::nothing;
+        }
+        m_socket->m_desc.ensure_nonblocking_mode(); // Throws
+        return Want::write;                         // Wait for write readiness before proceeding
+    }
+    Want advance() noexcept override final
+    {
+        REALM_ASSERT(!is_complete());
+        REALM_ASSERT(!is_canceled());
+        REALM_ASSERT(!m_error_code);
+        REALM_ASSERT(m_curr < m_num_buffers);
+        util::Span<const util::Span<const char>> buffers{m_buffers + m_curr, m_num_buffers - m_curr};
+        std::error_code ec;
+        std::size_t n = m_socket->m_desc.write_some(buffers, ec);
+        if (REALM_UNLIKELY(ec)) {
+            if (ec == error::resource_unavailable_try_again)
+                return Want::write; // Wrote nothing, but want something written
+            m_error_code = ec;
+            set_is_complete(true); // Failure
+            return Want::nothing;
+        }
+        m_num_bytes_transferred += n;
+        // Skip past the fully written buffers, and the written part of the
+        // buffer that was partially written, if any.
+        while (n > 0) {
+            util::Span<const char>& buffer = m_buffers[m_curr];
+            if (n < buffer.size()) {
+                buffer = buffer.sub_span(n);
+                break;
+            }
+            n -= buffer.size();
+            ++m_curr;
+        }
+        if (m_curr == m_num_buffers) {
+            set_is_complete(true); // Success
+            return Want::nothing;
+        }
+        return Want::write;
+    }
+    void recycle() noexcept override final
+    {
+        bool orphaned = !m_socket;
+        REALM_ASSERT(orphaned);
+        // Note: do_recycle() commits suicide.
+        do_recycle(orphaned);
+    }
+    void orphan() noexcept override final
+    {
+        m_socket = nullptr;
+    }
+    Service::Descriptor& descriptor() noexcept override final
+    {
+        return m_socket->m_desc;
+    }
+
+protected:
+    Socket* m_socket;
+    std::error_code m_error_code;
+    util::Span<const char> m_buffers[max_write_buffers]; // May be dangling after cancellation
+    std::size_t m_num_buffers = 0;
+    std::size_t m_curr = 0;
+    std::size_t m_num_bytes_transferred = 0;
+};
+
+template <class H>
+class Socket::GatherWriteOper : public GatherWriteOperBase {
+public:
+    GatherWriteOper(std::size_t size, Socket& sock, util::Span<const util::Span<const char>> buffers, H&& handler)
+        : GatherWriteOperBase{size, sock, buffers}
+        , m_handler{std::move(handler)}
+    {
+    }
+    void recycle_and_execute() override final
+    {
+        REALM_ASSERT(is_complete() || is_canceled());
+        REALM_ASSERT(is_complete() == (m_error_code || m_curr == m_num_buffers));
+        bool orphaned = !m_socket;
+        std::error_code ec = m_error_code;
+        if (is_canceled())
+            ec = error::operation_aborted;
+        // Note: do_recycle_and_execute() commits suicide.
+        do_recycle_and_execute<H>(orphaned, m_handler, ec, m_num_bytes_transferred); // Throws
+    }
+
+private:
+    H m_handler;
+};
+
 inline Socket::Socket(Service& service)
     : SocketBase{service}
 {
@@ -3322,6 +3473,14 @@ inline void Socket::async_write(const char* data, std::size_t size, H&& handler)
     StreamOps::async_write(*this, data, size, is_write_some, std::move(handler)); // Throws
 }
 
+template <class H>
+inline void Socket::async_write(util::Span<const util::Span<const char>> buffers, H&& handler)
+{
+    LendersGatherWriteOperPtr op =
+        Service::alloc<GatherWriteOper<H>>(m_write_oper, *this, buffers, std::move(handler)); // Throws
+    m_desc.initiate_oper(std::move(op));                                                       // Throws
+}
+
 template <class H>
 inline void Socket::async_read_some(char* buffer, std::size_t size, H&& handler)
 {
@@ -733,6 +733,135 @@ int Stream::verify_callback_using_delegate(int preverify_ok, X509_STORE_CTX* ctx
     return int(valid);
 }
 
+
+SessionCache::SessionCache(std::size_t max_size) noexcept
+    : m_max_size{max_size}
+{
+}
+
+
+SessionCache::~SessionCache() noexcept
+{
+    for (auto& entry : m_sessions)
+        SSL_SESSION_free(entry.second);
+}
+
+
+SSL_SESSION* SessionCache::get(const std::string& key) noexcept
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto i = m_sessions.find(key);
+    if (i == m_sessions.end())
+        return nullptr;
+    SSL_SESSION* session = i->second;
+    if (!SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION_free(session);
+        m_sessions.erase(i);
+        return nullptr;
+    }
+    // A TLS 1.3 session ticket should only be used once. The server issues new
+    // ones after every handshake, including resumed ones.
+    if (SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION) {
+        m_sessions.erase(i);
+    }
+    else {
+        SSL_SESSION_up_ref(session);
+    }
+    return session;
+#else
+    static_cast<void>(key);
+    return nullptr;
+#endif
+}
+
+
+void SessionCache::put(const std::string& key, SSL_SESSION* session) noexcept
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto i = m_sessions.find(key);
+    if (i != m_sessions.end()) {
+        SSL_SESSION_free(i->second);
+        i->second = session;
+        return;
+    }
+    if (m_max_size == 0) {
+        SSL_SESSION_free(session);
+        return;
+    }
+    if (m_sessions.size() >= m_max_size) {
+        SSL_SESSION_free(m_sessions.begin()->second);
+        m_sessions.erase(m_sessions.begin());
+    }
+    try {
+        m_sessions.emplace(key, session); // Throws
+    }
+    catch (...) {
+        SSL_SESSION_free(session);
+    }
+}
+
+
+void Stream::ssl_set_session_cache(std::error_code& ec)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+    if (m_handshake_type != client) {
+        ec = std::error_code();
+        return;
+    }
+
+    int rc = SSL_set_ex_data(m_ssl, 0, this);
+    if (rc == 0) {
+        ec = std::error_code(int(ERR_get_error()), openssl_error_category);
+        return;
+    }
+
+    // The client side session cache mode is what makes OpenSSL report new
+    // sessions through the callback. Sessions are kept in `m_session_cache`
+    // only, since OpenSSL never looks them up on the client side anyway.
+    SSL_CTX* ssl_ctx = SSL_get_SSL_CTX(m_ssl);
+    SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ssl_ctx, &Stream::new_session_callback);
+
+    if (SSL_SESSION* session = m_session_cache->get(m_session_cache_key)) {
+        rc = SSL_set_session(m_ssl, session);
+        SSL_SESSION_free(session);
+        if (rc == 0) {
+            ec = std::error_code(int(ERR_get_error()), openssl_error_category);
+            return;
+        }
+    }
+#endif
+    ec = std::error_code();
+}
+
+
+bool Stream::is_session_reused() const noexcept
+{
+    return SSL_session_reused(m_ssl) != 0;
+}
+
+
+int Stream::new_session_callback(SSL* ssl, SSL_SESSION* session) noexcept
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+    Stream* stream = static_cast<Stream*>(SSL_get_ex_data(ssl, 0));
+    if (!stream || !stream->m_session_cache || !SSL_SESSION_is_resumable(session))
+        return 0;
+    // OpenSSL marks the session of a connection that is not shut down cleanly
+    // as not resumable, but since TLS 1.1 that is no longer required, and
+    // sync connections are rarely shut down cleanly. The cache therefore keeps
+    // a copy that is unaffected by how this connection ends.
+    if (SSL_SESSION* copy = SSL_SESSION_dup(session))
+        stream->m_session_cache->put(stream->m_session_cache_key, copy);
+    return 0;
+#else
+    static_cast<void>(ssl);
+    static_cast<void>(session);
+    return 0;
+#endif
+}
+
 #ifndef _WIN32
 #pragma GCC diagnostic pop
 #endif
@@ -1176,6 +1305,29 @@ void Stream::ssl_set_host_name(const std::string& host_name, std::error_code& ec
 
 void Stream::ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&) {}
 
+SessionCache::SessionCache(std::size_t) noexcept {}
+
+SessionCache::~SessionCache() noexcept {}
+
+void Stream::ssl_set_session_cache(std::error_code& ec)
+{
+    // Secure Transport resumes sessions from its own cache, but only for
+    // connections with a peer ID.
+    if (m_handshake_type == client) {
+        const std::string& key = m_session_cache_key;
+        if (OSStatus status = SSLSetPeerID(m_ssl.get(), key.data(), key.size())) {
+            ec = std::error_code(status, secure_transport_error_category);
+            return;
+        }
+    }
+    ec = std::error_code();
+}
+
+bool Stream::is_session_reused() const noexcept
+{
+    return false;
+}
+
 void Stream::ssl_handshake(std::error_code& ec, Want& want) noexcept
 {
     auto perform = [this]() noexcept {
@@ -1491,6 +1643,21 @@ void Stream::ssl_set_host_name(const std::string&, std::error_code&) {}
 void Stream::ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&) {}
 
 
+SessionCache::SessionCache(std::size_t) noexcept {}
+
+
+SessionCache::~SessionCache() noexcept {}
+
+
+void Stream::ssl_set_session_cache(std::error_code&) {}
+
+
+bool Stream::is_session_reused() const noexcept
+{
+    return false;
+}
+
+
 void Stream::ssl_handshake(std::error_code&, Want&) noexcept {}
 
 
@@ -3,7 +3,9 @@
 
 #include <cstddef>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <exception>
 #include <system_error>
@@ -190,6 +192,41 @@ private:
 };
 
 
+/// A cache of TLS sessions that lets a client resume a session with a server
+/// it has connected to before, which skips most of the handshake, including
+/// the verification of the server's certificate chain. Sessions are stored
+/// under a key chosen by the application (see Stream::set_session_cache()).
+///
+/// It is safe to use a session cache from multiple threads concurrently.
+///
+/// With Secure Transport, sessions are cached by the system, and this class
+/// only serves to enable resumption.
+class SessionCache {
+public:
+    /// When the cache holds \a max_size sessions, storing another one evicts
+    /// one of the existing ones.
+    explicit SessionCache(std::size_t max_size = 64) noexcept;
+    ~SessionCache() noexcept;
+
+    SessionCache(const SessionCache&) = delete;
+    SessionCache& operator=(const SessionCache&) = delete;
+
+private:
+#if REALM_HAVE_OPENSSL
+    // Returns a new reference to the session stored under `key`, or null.
+    SSL_SESSION* get(const std::string& key) noexcept;
+    // Takes over the caller's reference to `session`.
+    void put(const std::string& key, SSL_SESSION* session) noexcept;
+
+    const std::size_t m_max_size;
+    std::mutex m_mutex;
+    std::map<std::string, SSL_SESSION*> m_sessions; // Protected by `m_mutex`
+#endif
+
+    friend class Stream;
+};
+
+
 /// Switching between synchronous and asynchronous operations is allowed, but
 /// only in a nonoverlapping fashion. That is, a synchronous operation is not
 /// allowed to run concurrently with an asynchronous one on the same
@@ -245,6 +282,22 @@ public:
     /// https://github.com/curl/curl/pull/1240#issuecomment-285281512).
     void set_host_name(std::string host_name);
 
+    /// \brief Resume TLS sessions through the specified cache.
+    ///
+    /// On the client side, this makes the handshake offer the session stored
+    /// in \a cache under \a key, if any, and stores the sessions issued by the
+    /// server on this stream in \a cache under \a key. Because the server's
+    /// certificate is not verified again when a session is resumed, \a key
+    /// must identify both the server and the way its certificate is verified.
+    ///
+    /// Has no effect on the server side. Must be called before the handshake,
+    /// and \a cache must outlive the stream.
+    void set_session_cache(SessionCache& cache, std::string key);
+
+    /// Returns true if the handshake resumed a previous session. Always returns
+    /// false with Secure Transport, which does not report it.
+    bool is_session_reused() const noexcept;
+
     /// get_server_port() and set_server_port() are getter and setter for
     /// the server port. They are only used by the verify callback function
     /// below.
@@ -426,6 +479,9 @@ private:
 
     bool m_valid_certificate_in_chain = false;
 
+    SessionCache* m_session_cache = nullptr;
+    std::string m_session_cache_key;
+
 
     // See Service::BasicStreamOps for details on these these 6 functions.
     void do_init_read_async(std::error_code&, Want&) noexcept;
@@ -466,6 +522,7 @@ private:
     void ssl_set_host_name(const std::string&, std::error_code&);
     void ssl_use_verify_callback(const std::function<SSLVerifyCallback>&, std::error_code&);
     void ssl_use_included_certificates(std::error_code&);
+    void ssl_set_session_cache(std::error_code&);
 
     void ssl_handshake(std::error_code&, Want& want) noexcept;
     bool ssl_shutdown(std::error_code& ec, Want& want) noexcept;
@@ -508,6 +565,10 @@ private:
     // verify_callback_using_root_certs is used by OpenSSL to handle certificate verification
     // using the included root certifictes.
     static int verify_callback_using_root_certs(int preverify_ok, X509_STORE_CTX* ctx);
+
+    // new_session_callback() is installed with SSL_CTX_sess_set_new_cb() when a
+    // session cache is used, and stores new sessions in it.
+    static int new_session_callback(SSL* ssl, SSL_SESSION* session) noexcept;
 #elif REALM_HAVE_SECURE_TRANSPORT
     util::CFPtr<SSLContextRef> m_ssl;
     VerifyMode m_verify_mode = VerifyMode::none;
@@ -771,6 +832,16 @@ inline void Stream::set_host_name(std::string host_name)
         throw std::system_error(ec);
 }
 
+inline void Stream::set_session_cache(SessionCache& cache, std::string key)
+{
+    m_session_cache = &cache;
+    m_session_cache_key = std::move(key);
+    std::error_code ec;
+    ssl_set_session_cache(ec);
+    if (ec)
+        throw std::system_error(ec);
+}
+
 inline void Stream::set_server_port(port_type server_port)
 {
     m_server_port = server_port;
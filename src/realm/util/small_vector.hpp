@@ -0,0 +1,365 @@
+///////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2022 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_UTIL_SMALL_VECTOR_HPP
+#define REALM_UTIL_SMALL_VECTOR_HPP
+
+#include <realm/util/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace realm {
+namespace util {
+
+/// A vector-like container which stores up to `N` elements inline and only
+/// allocates heap memory once it grows beyond that.
+///
+/// Iterators are plain pointers. Unlike std::vector, moving a SmallVector
+/// whose elements are stored inline invalidates all iterators into it.
+template <class T, size_t N>
+class SmallVector {
+public:
+    static_assert(N > 0, "Use std::vector if no inline storage is wanted");
+
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept
+        : m_data(inline_data())
+    {
+    }
+    SmallVector(std::initializer_list<T> values)
+        : SmallVector()
+    {
+        assign(values.begin(), values.end());
+    }
+    SmallVector(const SmallVector& other)
+        : SmallVector()
+    {
+        assign(other.begin(), other.end());
+    }
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : SmallVector()
+    {
+        take(std::move(other));
+    }
+    ~SmallVector()
+    {
+        clear();
+        release();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other) {
+            clear();
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    iterator begin() noexcept
+    {
+        return m_data;
+    }
+    iterator end() noexcept
+    {
+        return m_data + m_size;
+    }
+    const_iterator begin() const noexcept
+    {
+        return m_data;
+    }
+    const_iterator end() const noexcept
+    {
+        return m_data + m_size;
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return m_data;
+    }
+    const_iterator cend() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    T* data() noexcept
+    {
+        return m_data;
+    }
+    const T* data() const noexcept
+    {
+        return m_data;
+    }
+    T& operator[](size_t i) noexcept
+    {
+        REALM_ASSERT_DEBUG(i < m_size);
+        return m_data[i];
+    }
+    const T& operator[](size_t i) const noexcept
+    {
+        REALM_ASSERT_DEBUG(i < m_size);
+        return m_data[i];
+    }
+    T& front() noexcept
+    {
+        return (*this)[0];
+    }
+    const T& front() const noexcept
+    {
+        return (*this)[0];
+    }
+    T& back() noexcept
+    {
+        return (*this)[m_size - 1];
+    }
+    const T& back() const noexcept
+    {
+        return (*this)[m_size - 1];
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    /// True if the elements are stored inline rather than on the heap.
+    bool is_inline() const noexcept
+    {
+        return m_data == inline_data();
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+            reallocate(capacity);
+    }
+    void resize(size_t size)
+    {
+        if (size < m_size) {
+            std::destroy(m_data + size, m_data + m_size);
+            m_size = size;
+            return;
+        }
+        reserve(size);
+        for (; m_size < size; ++m_size)
+            new (m_data + m_size) T();
+    }
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    template <class It>
+    void assign(It first, It last)
+    {
+        clear();
+        reserve(size_t(std::distance(first, last)));
+        for (; first != last; ++first)
+            new (m_data + m_size++) T(*first);
+    }
+
+    template <class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+            return emplace_back_slow(std::forward<Args>(args)...);
+        T* value = new (m_data + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *value;
+    }
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+    void pop_back() noexcept
+    {
+        REALM_ASSERT_DEBUG(m_size > 0);
+        m_data[--m_size].~T();
+    }
+
+    iterator insert(const_iterator pos, T value)
+    {
+        size_t index = pos - m_data;
+        REALM_ASSERT_DEBUG(index <= m_size);
+        if (index == m_size) {
+            emplace_back(std::move(value));
+            return m_data + index;
+        }
+        if (m_size == m_capacity)
+            reallocate(grown_capacity());
+        new (m_data + m_size) T(std::move(m_data[m_size - 1]));
+        std::move_backward(m_data + index, m_data + m_size - 1, m_data + m_size);
+        ++m_size;
+        m_data[index] = std::move(value);
+        return m_data + index;
+    }
+    iterator erase(const_iterator pos) noexcept
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        T* dest = m_data + (first - m_data);
+        T* src = m_data + (last - m_data);
+        if (dest != src) {
+            T* new_end = std::move(src, end(), dest);
+            std::destroy(new_end, end());
+            m_size = new_end - m_data;
+        }
+        return dest;
+    }
+
+private:
+    T* m_data;
+    size_t m_size = 0;
+    size_t m_capacity = N;
+    alignas(T) unsigned char m_inline[sizeof(T) * N];
+
+    T* inline_data() noexcept
+    {
+        return reinterpret_cast<T*>(m_inline);
+    }
+    const T* inline_data() const noexcept
+    {
+        return reinterpret_cast<const T*>(m_inline);
+    }
+
+    size_t grown_capacity() const noexcept
+    {
+        return m_capacity * 2;
+    }
+
+    template <class... Args>
+    T& emplace_back_slow(Args&&... args)
+    {
+        // Construct the new element before moving the existing ones as the
+        // arguments may refer to elements in this vector
+        size_t new_capacity = grown_capacity();
+        T* new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+        try {
+            new (new_data + m_size) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            ::operator delete(new_data);
+            throw;
+        }
+        std::uninitialized_move(begin(), end(), new_data);
+        clear_and_adopt(new_data, new_capacity);
+        ++m_size;
+        return back();
+    }
+
+    void reallocate(size_t new_capacity)
+    {
+        T* new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+        std::uninitialized_move(begin(), end(), new_data);
+        clear_and_adopt(new_data, new_capacity);
+    }
+
+    // Destroy the current elements and switch to the given buffer, which
+    // already holds moved-to copies of them
+    void clear_and_adopt(T* new_data, size_t new_capacity) noexcept
+    {
+        size_t size = m_size;
+        clear();
+        release();
+        m_data = new_data;
+        m_capacity = new_capacity;
+        m_size = size;
+    }
+
+    // Free the heap buffer, if any. Must only be called when empty.
+    void release() noexcept
+    {
+        REALM_ASSERT_DEBUG(m_size == 0);
+        if (!is_inline()) {
+            ::operator delete(m_data);
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    void take(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        REALM_ASSERT_DEBUG(empty() && is_inline());
+        if (other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+        }
+        else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inline_data();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+    }
+};
+
+template <class T, size_t N>
+bool operator==(const SmallVector<T, N>& a, const SmallVector<T, N>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class T, size_t N>
+bool operator!=(const SmallVector<T, N>& a, const SmallVector<T, N>& b)
+{
+    return !(a == b);
+}
+
+} // namespace util
+} // namespace realm
+
+#endif // REALM_UTIL_SMALL_VECTOR_HPP
@@ -0,0 +1,258 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/thread_pool.hpp>
+
+#include <algorithm>
+
+using namespace realm::util;
+
+namespace {
+
+std::atomic<ThreadPool::Observer*> s_observer{nullptr};
+
+std::mutex s_default_mutex;
+ThreadPool* s_default_pool = nullptr;
+size_t s_default_thread_count = 0;
+
+// The pool and queue of the worker running on this thread, if any
+thread_local ThreadPool* t_pool = nullptr;
+thread_local size_t t_queue = ThreadPool::no_affinity;
+
+} // anonymous namespace
+
+ThreadPool::ThreadPool(size_t num_threads)
+{
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    m_queues.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+ThreadPool& ThreadPool::get_default()
+{
+    std::lock_guard lock(s_default_mutex);
+    // The default pool is never destroyed, as tasks and observers may still be
+    // in use during static destruction
+    if (!s_default_pool)
+        s_default_pool = new ThreadPool(s_default_thread_count);
+    return *s_default_pool;
+}
+
+bool ThreadPool::set_default_thread_count(size_t num_threads)
+{
+    std::lock_guard lock(s_default_mutex);
+    if (s_default_pool)
+        return false;
+    s_default_thread_count = num_threads;
+    return true;
+}
+
+void ThreadPool::set_observer(Observer* observer) noexcept
+{
+    s_observer = observer;
+}
+
+void ThreadPool::start()
+{
+    std::call_once(m_started, [this] {
+        // A previous attempt may have started some of the threads
+        m_threads.reserve(m_queues.size());
+        for (size_t i = m_threads.size(); i < m_queues.size(); ++i)
+            m_threads.emplace_back(&ThreadPool::worker, this, i); // Throws
+    });
+}
+
+void ThreadPool::worker(size_t index)
+{
+    t_pool = this;
+    t_queue = index;
+    Observer* observer = s_observer;
+    if (observer)
+        observer->did_create_thread();
+
+    Task task;
+    for (;;) {
+        if (try_pop(index, task)) {
+            run_task(task);
+            continue;
+        }
+        std::unique_lock lock(m_mutex);
+        m_cv.wait(lock, [&] {
+            return m_stop || m_num_pending > 0;
+        });
+        if (m_stop && m_num_pending == 0)
+            break;
+    }
+
+    if (observer)
+        observer->will_destroy_thread();
+}
+
+void ThreadPool::push(Task task, Priority priority, size_t affinity)
+{
+    if (affinity == no_affinity && t_pool == this)
+        affinity = t_queue;
+    if (affinity == no_affinity)
+        affinity = m_next_queue.fetch_add(1, std::memory_order_relaxed);
+    Queue& queue = *m_queues[affinity % m_queues.size()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks[size_t(priority)].push_back(std::move(task)); // Throws
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_num_pending;
+    }
+    m_cv.notify_one();
+}
+
+bool ThreadPool::try_pop(size_t index, Task& task)
+{
+    const size_t num_queues = m_queues.size();
+    if (index == no_affinity)
+        index = 0;
+    for (size_t priority = 0; priority < num_priorities; ++priority) {
+        for (size_t i = 0; i < num_queues; ++i) {
+            Queue& queue = *m_queues[(index + i) % num_queues];
+            std::lock_guard lock(queue.mutex);
+            auto& tasks = queue.tasks[priority];
+            if (tasks.empty())
+                continue;
+            // The owner takes the newest task, which is the most likely to
+            // still be in its cache, while thieves take the oldest one
+            if (i == 0) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            else {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            std::lock_guard pending_lock(m_mutex);
+            --m_num_pending;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_task(Task& task) noexcept
+{
+    try {
+        task();
+    }
+    catch (const std::exception& e) {
+        if (Observer* observer = s_observer)
+            observer->handle_error(e);
+    }
+    catch (...) {
+    }
+    task = nullptr;
+}
+
+void ThreadPool::submit(UniqueFunction<void()> task, Priority priority, size_t affinity)
+{
+    start(); // Throws
+    push(std::move(task), priority, affinity); // Throws
+}
+
+void ThreadPool::run_parallel(size_t count, FunctionRef<void(size_t)> func, Priority priority)
+{
+    if (count == 0)
+        return;
+
+    std::vector<std::exception_ptr> errors(count);
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t remaining = count - 1;
+
+    auto run = [&](size_t i) {
+        try {
+            func(i);
+        }
+        catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    size_t pushed = 1;
+    try {
+        start();
+        for (; pushed < count; ++pushed) {
+            size_t affinity = (pushed - 1) % m_queues.size();
+            push(
+                [&, i = pushed] {
+                    run(i);
+                    std::lock_guard lock(mutex);
+                    if (--remaining == 0)
+                        cv.notify_one();
+                },
+                priority, affinity);
+        }
+    }
+    catch (...) {
+        // Could not hand out all indices, so run the remaining ones here
+        for (size_t i = pushed; i < count; ++i) {
+            run(i);
+            std::lock_guard lock(mutex);
+            --remaining;
+        }
+    }
+    run(0);
+
+    // Help with the queued tasks rather than blocking a worker which might be
+    // needed to run ours
+    size_t queue = t_pool == this ? t_queue : no_affinity;
+    Task task;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex);
+            if (remaining == 0)
+                break;
+        }
+        if (try_pop(queue, task)) {
+            run_task(task);
+            continue;
+        }
+        // Everything that is queued is being run by someone, so our remaining
+        // tasks will complete without our help
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] {
+            return remaining == 0;
+        });
+        break;
+    }
+
+    for (auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
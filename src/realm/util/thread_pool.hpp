@@ -0,0 +1,138 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_THREAD_POOL_HPP
+#define REALM_UTIL_THREAD_POOL_HPP
+
+#include <realm/util/function_ref.hpp>
+#include <realm/util/functional.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace realm::util {
+
+/// A pool of worker threads which run short tasks submitted by the different
+/// parts of core, such as parallel query evaluation, notifiers and the
+/// transformation of changesets.
+///
+/// Every worker has its own queue. A task is put on the queue of the worker
+/// given as affinity hint, or otherwise on the queues in turn. A worker takes
+/// the most recently added task from its own queue, and when that is empty it
+/// steals the oldest task from the queue of another worker. Tasks with a higher
+/// priority are always taken before tasks with a lower priority.
+///
+/// The threads are started when the first task is submitted and run until the
+/// pool is destroyed. Tasks must not block for long, as that takes a worker
+/// away from everyone else. Event loops and other long-running work should keep
+/// using a dedicated thread.
+class ThreadPool {
+public:
+    enum class Priority { high, normal, low };
+    static constexpr size_t num_priorities = 3;
+    static constexpr size_t no_affinity = size_t(-1);
+
+    /// Hooks which run on every worker thread. This allows a binding to attach
+    /// the threads to its runtime, e.g. to the JVM.
+    class Observer {
+    public:
+        virtual ~Observer() = default;
+        // Called on the worker thread before it runs the first task
+        virtual void did_create_thread() = 0;
+        // Called on the worker thread just before it exits
+        virtual void will_destroy_thread() = 0;
+        // Called on the worker thread with any exception thrown by a task
+        // passed to submit()
+        virtual void handle_error(const std::exception& e) = 0;
+    };
+
+    /// A `num_threads` of 0 uses one thread per hardware thread.
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// The pool shared by all of core. It is created on first use with the
+    /// size given to set_default_thread_count(), or one thread per hardware
+    /// thread.
+    static ThreadPool& get_default();
+
+    /// Sets the number of threads of the default pool. Returns false and has no
+    /// effect if the default pool was already created.
+    static bool set_default_thread_count(size_t num_threads);
+
+    /// Sets the observer which is notified by the threads of all pools. Threads
+    /// which are already running are not notified of their creation. The
+    /// observer must outlive all pools.
+    static void set_observer(Observer* observer) noexcept;
+
+    size_t get_thread_count() const noexcept
+    {
+        return m_queues.size();
+    }
+
+    /// Runs `task` on one of the workers. An exception thrown by the task is
+    /// passed to the observer, or otherwise ignored.
+    void submit(UniqueFunction<void()> task, Priority priority = Priority::normal,
+                size_t affinity = no_affinity);
+
+    /// Calls `func` with every index from 0 to `count - 1` and waits for all
+    /// calls to complete. Index 0 is run on the calling thread, which also runs
+    /// other queued tasks while waiting, so this may be called from within a
+    /// task. Rethrows the exception thrown for the lowest index, if any.
+    void run_parallel(size_t count, FunctionRef<void(size_t)> func, Priority priority = Priority::normal);
+
+private:
+    using Task = UniqueFunction<void()>;
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks[num_priorities];
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::once_flag m_started;
+    std::atomic<size_t> m_next_queue{0};
+
+    // Guards sleeping and waking up the workers
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    size_t m_num_pending = 0;
+    bool m_stop = false;
+
+    void start();
+    void worker(size_t index);
+    // Takes the next task, preferring the queue at `index`. Returns false if
+    // there are no queued tasks.
+    bool try_pop(size_t index, Task& task);
+    void push(Task task, Priority priority, size_t affinity);
+    // Runs and then destroys the task, passing any exception to the observer
+    static void run_task(Task& task) noexcept;
+};
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_THREAD_POOL_HPP
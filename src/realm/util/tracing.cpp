@@ -0,0 +1,80 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/tracing.hpp>
+
+#include <atomic>
+#include <mutex>
+
+using namespace realm::util::tracing;
+
+namespace {
+
+std::mutex g_sink_mutex;
+std::shared_ptr<Sink> g_sink;
+
+#if REALM_TRACING
+std::atomic<SpanId> g_last_span_id{no_span};
+// The innermost span alive on the thread
+thread_local SpanId t_current_span = no_span;
+#endif
+
+} // anonymous namespace
+
+namespace realm::util::tracing {
+
+void set_sink(std::shared_ptr<Sink> sink)
+{
+    std::lock_guard lock(g_sink_mutex);
+#if REALM_TRACING
+    Span::s_enabled.store(bool(sink), std::memory_order_relaxed);
+#endif
+    g_sink = std::move(sink);
+}
+
+std::shared_ptr<Sink> get_sink()
+{
+    std::lock_guard lock(g_sink_mutex);
+    return g_sink;
+}
+
+#if REALM_TRACING
+
+std::atomic<bool> Span::s_enabled{false};
+
+void Span::begin(const char* name)
+{
+    m_sink = get_sink();
+    if (!m_sink)
+        return;
+    m_name = name;
+    m_id = g_last_span_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_parent = t_current_span;
+    t_current_span = m_id;
+    m_sink->begin_span(m_id, m_parent, m_name, Sink::clock::now());
+}
+
+void Span::end() noexcept
+{
+    t_current_span = m_parent;
+    m_sink->end_span(m_id, m_name, Sink::clock::now(), m_attributes.data(), m_num_attributes);
+}
+
+#endif // REALM_TRACING
+
+} // namespace realm::util::tracing
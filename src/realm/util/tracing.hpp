@@ -0,0 +1,139 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_TRACING_HPP
+#define REALM_UTIL_TRACING_HPP
+
+#include <realm/util/config.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Spans around the commit, integration and notification pipelines, which are
+// reported to the sink installed with set_sink(). The sink can forward them to
+// e.g. OpenTelemetry or Perfetto. Without a sink a span costs a relaxed atomic
+// load, and with REALM_TRACING off spans compile to nothing.
+namespace realm::util::tracing {
+
+/// Unique within the process. Spans without a parent have `no_span` as parent.
+using SpanId = uint64_t;
+constexpr SpanId no_span = 0;
+
+struct Attribute {
+    const char* key;
+    int64_t value;
+};
+
+/// Receives the spans on the thread which runs the traced operation, so it
+/// must be thread safe, should return quickly and must not throw. The names
+/// and keys are string literals.
+class Sink {
+public:
+    using clock = std::chrono::steady_clock;
+
+    virtual ~Sink() = default;
+    virtual void begin_span(SpanId id, SpanId parent, const char* name, clock::time_point start) = 0;
+    virtual void end_span(SpanId id, const char* name, clock::time_point end, const Attribute* attributes,
+                          size_t num_attributes) = 0;
+};
+
+/// Pass null to stop tracing. Spans which have already begun are still ended
+/// on the sink they began on.
+void set_sink(std::shared_ptr<Sink> sink);
+std::shared_ptr<Sink> get_sink();
+
+#if REALM_TRACING
+
+/// A span from construction to destruction. It is the parent of the spans
+/// begun on the same thread while it is alive.
+class Span {
+public:
+    static constexpr size_t max_attributes = 8;
+
+    explicit Span(const char* name)
+    {
+        if (s_enabled.load(std::memory_order_relaxed))
+            begin(name);
+    }
+    ~Span()
+    {
+        if (m_sink)
+            end();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /// False if there is no sink, in which case attributes are ignored, and
+    /// need not be computed.
+    bool is_recording() const noexcept
+    {
+        return bool(m_sink);
+    }
+    SpanId get_id() const noexcept
+    {
+        return m_id;
+    }
+
+    /// Attributes beyond `max_attributes` are dropped.
+    void set_attribute(const char* key, int64_t value) noexcept
+    {
+        if (m_sink && m_num_attributes < max_attributes)
+            m_attributes[m_num_attributes++] = {key, value};
+    }
+
+private:
+    static std::atomic<bool> s_enabled;
+    friend void set_sink(std::shared_ptr<Sink>);
+
+    std::shared_ptr<Sink> m_sink;
+    const char* m_name = nullptr;
+    SpanId m_id = no_span;
+    SpanId m_parent = no_span;
+    size_t m_num_attributes = 0;
+    std::array<Attribute, max_attributes> m_attributes;
+
+    void begin(const char* name);
+    void end() noexcept;
+};
+
+#else // REALM_TRACING
+
+class Span {
+public:
+    explicit Span(const char*) noexcept {}
+
+    bool is_recording() const noexcept
+    {
+        return false;
+    }
+    SpanId get_id() const noexcept
+    {
+        return no_span;
+    }
+    void set_attribute(const char*, int64_t) noexcept {}
+};
+
+#endif // REALM_TRACING
+
+} // namespace realm::util::tracing
+
+#endif // REALM_UTIL_TRACING_HPP
@@ -1,4 +1,7 @@
 #include <cctype>
+#include <cstring>
+
+#include <zlib.h>
 
 #include <realm/util/websocket.hpp>
 #include <realm/util/buffer.hpp>
@@ -165,42 +168,308 @@ util::Optional<HTTPResponse> do_make_http_response(const HTTPRequest& request,
     return response;
 }
 
+// The parameters of the permessage-deflate extension (RFC 7692) that were
+// agreed upon in the handshake. A window size of 15 bits is the default.
+struct PermessageDeflateParams {
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int server_max_window_bits = 15;
+    int client_max_window_bits = 15;
+};
+
+std::string_view trim_whitespace(std::string_view str)
+{
+    size_t begin = str.find_first_not_of(" \t");
+    if (begin == std::string_view::npos)
+        return {};
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(begin, end - begin + 1);
+}
+
+// parse_max_window_bits() parses the value of a server_max_window_bits or
+// client_max_window_bits extension parameter. The value must be an integer
+// in the range 8 to 15, and it may be quoted.
+bool parse_max_window_bits(std::string_view value, int& window_bits)
+{
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+    if (value.size() == 1 && (value[0] == '8' || value[0] == '9')) {
+        window_bits = value[0] - '0';
+        return true;
+    }
+    if (value.size() == 2 && value[0] == '1' && value[1] >= '0' && value[1] <= '5') {
+        window_bits = 10 + (value[1] - '0');
+        return true;
+    }
+    return false;
+}
+
+// parse_permessage_deflate() parses a single element of a
+// Sec-WebSocket-Extensions header, that is, an extension name followed by
+// extension parameters separated by semicolons. None is returned if the
+// element is not a valid permessage-deflate offer (from the client), or
+// response (from the server) if \a is_response is true.
+util::Optional<PermessageDeflateParams> parse_permessage_deflate(std::string_view element, bool is_response)
+{
+    size_t end = element.find(';');
+    if (!case_insensitive_equal(trim_whitespace(element.substr(0, end)), "permessage-deflate"))
+        return none;
+
+    PermessageDeflateParams params;
+    bool seen_server_no_context_takeover = false;
+    bool seen_client_no_context_takeover = false;
+    bool seen_server_max_window_bits = false;
+    bool seen_client_max_window_bits = false;
+    while (end != std::string_view::npos) {
+        element = element.substr(end + 1);
+        end = element.find(';');
+        std::string_view param = trim_whitespace(element.substr(0, end));
+        std::string_view name = param;
+        util::Optional<std::string_view> value;
+        size_t equals = param.find('=');
+        if (equals != std::string_view::npos) {
+            name = trim_whitespace(param.substr(0, equals));
+            value = trim_whitespace(param.substr(equals + 1));
+        }
+
+        // A parameter must not occur more than once.
+        if (name == "server_no_context_takeover") {
+            if (value || seen_server_no_context_takeover)
+                return none;
+            seen_server_no_context_takeover = true;
+            params.server_no_context_takeover = true;
+        }
+        else if (name == "client_no_context_takeover") {
+            if (value || seen_client_no_context_takeover)
+                return none;
+            seen_client_no_context_takeover = true;
+            params.client_no_context_takeover = true;
+        }
+        else if (name == "server_max_window_bits") {
+            if (!value || seen_server_max_window_bits || !parse_max_window_bits(*value, params.server_max_window_bits))
+                return none;
+            seen_server_max_window_bits = true;
+        }
+        else if (name == "client_max_window_bits") {
+            // In an offer, the value is optional, and its absence only
+            // signals that the client supports the parameter.
+            if (seen_client_max_window_bits)
+                return none;
+            if (value) {
+                if (!parse_max_window_bits(*value, params.client_max_window_bits))
+                    return none;
+            }
+            else if (is_response) {
+                return none;
+            }
+            seen_client_max_window_bits = true;
+        }
+        else {
+            return none;
+        }
+    }
+    return params;
+}
+
+// negotiate_permessage_deflate() is used by the server to select the first
+// acceptable permessage-deflate offer in the Sec-WebSocket-Extensions header
+// of the client's request. If one is found, \a response_value is set to the
+// value of the Sec-WebSocket-Extensions header of the response.
+util::Optional<PermessageDeflateParams> negotiate_permessage_deflate(const HTTPHeaders& headers,
+                                                                     std::string& response_value)
+{
+    util::Optional<StringData> header_value = find_http_header_value(headers, "Sec-WebSocket-Extensions");
+    if (!header_value)
+        return none;
+
+    std::string_view offers(*header_value);
+    for (;;) {
+        size_t end = offers.find(',');
+        if (auto params = parse_permessage_deflate(offers.substr(0, end), false)) {
+            // Every restriction that the client puts on the server is accepted.
+            response_value = "permessage-deflate";
+            if (params->server_no_context_takeover)
+                response_value += "; server_no_context_takeover";
+            if (params->client_no_context_takeover)
+                response_value += "; client_no_context_takeover";
+            if (params->server_max_window_bits < 15)
+                response_value += "; server_max_window_bits=" + std::to_string(params->server_max_window_bits);
+            return params;
+        }
+        if (end == std::string_view::npos)
+            return none;
+        offers = offers.substr(end + 1);
+    }
+}
+
 // mask_payload masks (and demasks) the payload sent from the client to the server.
-void mask_payload(char* masking_key, const char* payload, size_t payload_len, char* output)
+// The payload is processed a 64-bit word at a time, which compilers turn into
+// vector instructions where available. Since the masking key repeats itself
+// every four bytes, two copies of it mask any eight consecutive bytes starting
+// at a multiple of four. \a payload and \a output may be the same buffer.
+void mask_payload(const char* masking_key, const char* payload, size_t payload_len, char* output)
 {
-    for (size_t i = 0; i < payload_len; ++i) {
+    char key_bytes[8];
+    std::memcpy(key_bytes, masking_key, 4);
+    std::memcpy(key_bytes + 4, masking_key, 4);
+    uint_fast64_t key_word;
+    std::memcpy(&key_word, key_bytes, 8);
+
+    size_t i = 0;
+    for (; i + 8 <= payload_len; i += 8) {
+        uint_fast64_t word;
+        std::memcpy(&word, payload + i, 8);
+        word ^= key_word;
+        std::memcpy(output + i, &word, 8);
+    }
+    for (; i < payload_len; ++i) {
         output[i] = payload[i] ^ masking_key[i % 4];
     }
 }
 
-// make_frame() creates a WebSocket frame according to the WebSocket standard.
-// \param fin indicates whether the frame is the final fragment in a message.
-// Sync clients and servers will only send unfragmented messages, but they must be
-// prepared to receive fragmented messages.
-// \param opcode must be one of six values:
-// 0  = continuation frame
-// 1  = text frame
-// 2  = binary frame
-// 8  = ping frame
-// 9  = pong frame
-// 10 = close frame.
-// Sync clients and server will only send the last four, but must be prepared to
-// receive all.
-// \param mask indicates whether the payload of the frame should be masked. Frames
-// are masked if and only if they originate from the client.
-// The payload is located in the buffer \param payload, and has size \param payload_size.
-// \param output is the output buffer. It must be large enough to contain the frame.
-// The frame size can at most be payload_size + 14.
-// \param random is used to create a random masking key.
-// The return value is the size of the frame.
-size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t payload_size, char* output,
-                  std::mt19937_64& random)
+// Deflater compresses the outgoing messages of a connection that uses the
+// permessage-deflate extension. Unless context takeover has been disabled,
+// the deflate stream, and therefore the sliding window, is carried over from
+// one message to the next, which is what makes small and similar messages
+// compress well.
+class Deflater {
+public:
+    Deflater(int window_bits, bool no_context_takeover)
+        : m_no_context_takeover(no_context_takeover)
+    {
+        // Raw deflate (negative window bits) since the extension strips the
+        // zlib header and trailer.
+        int ret = deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -window_bits, 8, Z_DEFAULT_STRATEGY);
+        if (ret == Z_MEM_ERROR)
+            throw std::bad_alloc();
+        REALM_ASSERT(ret == Z_OK);
+    }
+
+    ~Deflater() noexcept
+    {
+        deflateEnd(&m_stream);
+    }
+
+    // deflate() compresses the message made up of the concatenation of
+    // \a parts into \a output, and resizes \a output to the size of the
+    // compressed message.
+    void deflate(util::Span<const util::Span<const char>> parts, std::vector<char>& output)
+    {
+        size_t output_size = 0;
+        if (output.size() < s_min_output_size)
+            output.resize(s_min_output_size); // Throws
+
+        // The last part is followed by a sync flush, which emits all pending
+        // output and aligns it on a byte boundary. Both that, and the
+        // consumption of the preceding parts, are complete when the output
+        // buffer is not filled up.
+        for (size_t i = 0; i < parts.size(); ++i) {
+            m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(parts[i].data()));
+            m_stream.avail_in = uInt(parts[i].size());
+            int flush = (i + 1 == parts.size() ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+            for (;;) {
+                m_stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_size);
+                m_stream.avail_out = uInt(output.size() - output_size);
+                int ret = ::deflate(&m_stream, flush);
+                REALM_ASSERT(ret == Z_OK || ret == Z_BUF_ERROR);
+                output_size = output.size() - m_stream.avail_out;
+                if (m_stream.avail_out != 0)
+                    break;
+                output.resize(2 * output.size()); // Throws
+            }
+        }
+
+        // The flush ends with the four octets 0x00 0x00 0xff 0xff, which the
+        // extension requires the sender to remove.
+        REALM_ASSERT(output_size >= 4);
+        output.resize(output_size - 4);
+
+        if (m_no_context_takeover)
+            deflateReset(&m_stream);
+    }
+
+private:
+    z_stream m_stream = {};
+    const bool m_no_context_takeover;
+
+    static constexpr size_t s_min_output_size = 256;
+};
+
+// Inflater decompresses the incoming messages of a connection that uses the
+// permessage-deflate extension. The window is always kept across messages,
+// which is harmless if the peer resets its deflate context for every message.
+class Inflater {
+public:
+    Inflater()
+    {
+        // 15 bits is the largest window size, so it works for any size the
+        // peer may be using.
+        int ret = inflateInit2(&m_stream, -15);
+        if (ret == Z_MEM_ERROR)
+            throw std::bad_alloc();
+        REALM_ASSERT(ret == Z_OK);
+    }
+
+    ~Inflater() noexcept
+    {
+        inflateEnd(&m_stream);
+    }
+
+    // inflate() decompresses the compressed message in \a data into \a output,
+    // and resizes \a output to the size of the decompressed message. The
+    // return value is false if the message is not valid compressed data.
+    bool inflate(const char* data, size_t size, std::vector<char>& output)
+    {
+        // The sender removed the four octets that end the sync flush, so they
+        // have to be put back before decompressing.
+        static const char flush_tail[4] = {0, 0, char(0xff), char(0xff)};
+        size_t output_size = 0;
+        if (!inflate_chunk(data, size, output, output_size) || !inflate_chunk(flush_tail, 4, output, output_size))
+            return false;
+        output.resize(output_size);
+        return true;
+    }
+
+private:
+    z_stream m_stream = {};
+
+    bool inflate_chunk(const char* data, size_t size, std::vector<char>& output, size_t& output_size)
+    {
+        m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        m_stream.avail_in = uInt(size);
+        for (;;) {
+            if (output_size == output.size())
+                output.resize(std::max(2 * output.size(), size_t(1024))); // Throws
+            m_stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_size);
+            m_stream.avail_out = uInt(output.size() - output_size);
+            int ret = ::inflate(&m_stream, Z_SYNC_FLUSH);
+            output_size = output.size() - m_stream.avail_out;
+            if (ret == Z_STREAM_END) {
+                // The message ended with a final deflate block, so whatever
+                // follows is the start of a new deflate stream.
+                inflateReset(&m_stream);
+            }
+            else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                return false;
+            }
+            if (m_stream.avail_in == 0 && m_stream.avail_out != 0)
+                return true;
+        }
+    }
+};
+
+// make_frame_header() creates the header of a WebSocket frame according to the
+// WebSocket standard. The parameters are as for make_frame() below. If \param mask
+// is true, the header ends with a random masking key. The return value is the
+// size of the header, which is at most 14.
+size_t make_frame_header(bool fin, bool compressed, int opcode, bool mask, size_t payload_size, char* output,
+                         std::mt19937_64& random)
 {
     int index = 0; // used to keep track of position within the header.
     using uchar = unsigned char;
-    output[0] = (fin ? char(uchar(128)) : 0) + opcode; // fin and opcode in the first byte.
-    output[1] = (mask ? char(uchar(128)) : 0);         // First bit of the second byte is mask.
-    if (payload_size <= 125) {                         // The payload length is contained in the second byte.
+    output[0] = (fin ? char(uchar(128)) : 0) + (compressed ? 64 : 0) + opcode; // fin, rsv1, and opcode.
+    output[1] = (mask ? char(uchar(128)) : 0); // First bit of the second byte is mask.
+    if (payload_size <= 125) {                 // The payload length is contained in the second byte.
         output[1] += static_cast<char>(payload_size);
         index = 2;
     }
@@ -227,24 +496,85 @@ size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t p
         index = 10;
     }
     if (mask) {
-        char masking_key[4];
         std::uniform_int_distribution<> dis(0, 255);
         for (int i = 0; i < 4; ++i) {
-            masking_key[i] = dis(random);
+            output[index++] = dis(random);
         }
-        output[index++] = masking_key[0];
-        output[index++] = masking_key[1];
-        output[index++] = masking_key[2];
-        output[index++] = masking_key[3];
-        mask_payload(masking_key, payload, payload_size, output + index);
     }
-    else {
-        std::copy(payload, payload + payload_size, output + index);
+
+    return index;
+}
+
+// make_frame() creates a WebSocket frame according to the WebSocket standard.
+// \param fin indicates whether the frame is the final fragment in a message.
+// Sync clients and servers will only send unfragmented messages, but they must be
+// prepared to receive fragmented messages.
+// \param opcode must be one of six values:
+// 0  = continuation frame
+// 1  = text frame
+// 2  = binary frame
+// 8  = ping frame
+// 9  = pong frame
+// 10 = close frame.
+// Sync clients and server will only send the last four, but must be prepared to
+// receive all.
+// \param compressed sets the RSV1 bit, which marks the first frame of a message
+// compressed by the permessage-deflate extension.
+// \param mask indicates whether the payload of the frame should be masked. Frames
+// are masked if and only if they originate from the client.
+// The payload is the concatenation of the buffers in \param payload, and has size
+// \param payload_size.
+// \param output is the output buffer. It must be large enough to contain the frame.
+// The frame size can at most be payload_size + 14.
+// \param random is used to create a random masking key.
+// The return value is the size of the frame.
+size_t make_frame(bool fin, bool compressed, int opcode, bool mask, util::Span<const util::Span<const char>> payload,
+                  size_t payload_size, char* output, std::mt19937_64& random)
+{
+    size_t index = make_frame_header(fin, compressed, opcode, mask, payload_size, output, random);
+    const char* masking_key = output + index - 4;
+    size_t offset = 0;
+    for (util::Span<const char> part : payload) {
+        if (mask) {
+            // The masking key is aligned with the start of the payload, not
+            // with the start of each part.
+            char part_masking_key[4];
+            for (size_t i = 0; i < 4; ++i)
+                part_masking_key[i] = masking_key[(offset + i) % 4];
+            mask_payload(part_masking_key, part.data(), part.size(), output + index + offset);
+        }
+        else {
+            std::copy(part.begin(), part.end(), output + index + offset);
+        }
+        offset += part.size();
     }
+    REALM_ASSERT(offset == payload_size);
 
     return payload_size + index;
 }
 
+// write_buffers_in_sequence() implements the default behaviour of
+// websocket::Config::async_write_buffers().
+void write_buffers_in_sequence(websocket::Config& config, std::vector<util::Span<const char>> buffers, size_t index,
+                               size_t num_bytes_transferred, websocket::WriteCompletionHandler handler)
+{
+    if (index == buffers.size()) {
+        handler(std::error_code(), num_bytes_transferred); // Throws
+        return;
+    }
+    util::Span<const char> buffer = buffers[index];
+    auto handler_2 = [&config, buffers = std::move(buffers), index, num_bytes_transferred,
+                      handler = std::move(handler)](std::error_code ec, size_t n) mutable {
+        if (ec) {
+            handler(ec, num_bytes_transferred + n); // Throws
+            return;
+        }
+        write_buffers_in_sequence(config, std::move(buffers), index + 1, num_bytes_transferred + n,
+                                  std::move(handler)); // Throws
+    };
+    config.async_write(buffer.data(), buffer.size(), std::move(handler_2)); // Throws
+}
+
 // class FrameReader takes care of parsing the incoming bytes and
 // constructing the received WebSocket messages. FrameReader manages
 // read buffers internally. FrameReader handles fragmented messages as
@@ -266,6 +596,8 @@ size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t p
 //     // frame_reader.delivery_size
 //     // with opcode (type)
 //     // frame_reader.delivery_opcode
+//     // which must be decompressed first if
+//     // frame_reader.delivery_compressed
 // }
 // else {
 //    // read frame_reader.read_size
@@ -284,8 +616,13 @@ public:
     char* read_buffer = nullptr;
     bool protocol_error = false;
     bool delivery_ready = false;
+    bool delivery_compressed = false;
     websocket::Opcode delivery_opcode = websocket::Opcode::continuation;
 
+    // Whether the permessage-deflate extension is in use, in which case the
+    // RSV1 bit marks compressed messages.
+    bool permessage_deflate = false;
+
     FrameReader(util::Logger& logger, bool& is_client)
         : logger(logger)
         , m_is_client(is_client)
@@ -297,6 +634,7 @@ public:
     void reset()
     {
         m_stage = Stage::init;
+        permessage_deflate = false;
     }
 
     // next() parses the new information and moves
@@ -344,6 +682,9 @@ private:
     // The opcode of the message.
     websocket::Opcode m_message_opcode = websocket::Opcode::continuation;
 
+    // Whether the RSV1 bit was set in the first frame of the message.
+    bool m_message_compressed = false;
+
     // The size of the stored Websocket message.
     // This size is not the same as the size of the buffer.
     size_t m_message_size = 0;
@@ -384,6 +725,7 @@ private:
         if (m_message_buffer.size() != s_message_buffer_min_size)
             m_message_buffer.resize(s_message_buffer_min_size);
         m_message_opcode = websocket::Opcode::continuation;
+        m_message_compressed = false;
         m_message_size = 0;
     }
 
@@ -395,6 +737,7 @@ private:
     {
         protocol_error = false;
         delivery_ready = false;
+        delivery_compressed = false;
         delivery_buffer = nullptr;
         delivery_size = 0;
         delivery_opcode = websocket::Opcode::continuation;
@@ -412,9 +755,11 @@ private:
         // bit 1.
         m_fin = ((header_buffer[0] & 128) == 128);
 
-        // bit 2,3, and 4.
+        // bit 2,3, and 4. RSV1 is only allowed when permessage-deflate is in
+        // use, and only in the first frame of a text or binary message.
         char rsv = (header_buffer[0] & 112) >> 4;
-        if (rsv != 0)
+        bool rsv1 = ((rsv & 4) == 4);
+        if ((rsv & 3) != 0 || (rsv1 && !permessage_deflate))
             return set_protocol_error();
 
         // bit 5, 6, 7, and 8.
@@ -434,7 +779,7 @@ private:
         m_short_payload_size = (header_buffer[1] & 127);
 
         if (m_opcode == websocket::Opcode::continuation) {
-            if (m_message_opcode == websocket::Opcode::continuation)
+            if (m_message_opcode == websocket::Opcode::continuation || rsv1)
                 return set_protocol_error();
         }
         else if (m_opcode == websocket::Opcode::text || m_opcode == websocket::Opcode::binary) {
@@ -442,9 +787,10 @@ private:
                 return set_protocol_error();
 
             m_message_opcode = m_opcode;
+            m_message_compressed = rsv1;
         }
         else { // close, ping, pong.
-            if (!m_fin || m_short_payload_size > 125)
+            if (!m_fin || m_short_payload_size > 125 || rsv1)
                 return set_protocol_error();
         }
 
@@ -534,6 +880,7 @@ private:
             if (m_fin) {
                 m_stage = Stage::delivery;
                 delivery_ready = true;
+                delivery_compressed = m_message_compressed;
                 delivery_opcode = m_message_opcode;
                 delivery_buffer = m_message_buffer.data();
                 delivery_size = m_message_size;
@@ -552,6 +899,7 @@ private:
         read_buffer = header_buffer;
         read_size = 2;
         delivery_ready = false;
+        delivery_compressed = false;
         delivery_buffer = nullptr;
         delivery_size = 0;
         delivery_opcode = websocket::Opcode::continuation;
@@ -580,6 +928,7 @@ public:
 
         m_stopped = false;
         m_is_client = true;
+        disable_permessage_deflate();
 
         m_sec_websocket_key = make_random_sec_websocket_key(m_config.websocket_get_random());
 
@@ -595,6 +944,9 @@ public:
         req.headers["Sec-WebSocket-Key"] = m_sec_websocket_key;
         req.headers["Sec-WebSocket-Version"] = sec_websocket_version;
         req.headers["Sec-WebSocket-Protocol"] = sec_websocket_protocol;
+        m_permessage_deflate_offered = m_config.websocket_permessage_deflate_enabled();
+        if (m_permessage_deflate_offered)
+            req.headers["Sec-WebSocket-Extensions"] = "permessage-deflate; client_max_window_bits";
 
         m_logger.trace("HTTP request =\n%1", req);
 
@@ -626,6 +978,7 @@ public:
     {
         m_stopped = false;
         m_is_client = false;
+        disable_permessage_deflate();
         m_frame_reader.reset();
         frame_reader_loop(); // Throws
     }
@@ -636,6 +989,7 @@ public:
 
         m_stopped = false;
         m_is_client = false;
+        disable_permessage_deflate();
         m_http_server.reset(new HTTPServer<websocket::Config>(m_config, m_logger));
         m_frame_reader.reset();
 
@@ -659,23 +1013,61 @@ public:
         m_http_server->async_receive_request(std::move(handler));
     }
 
-    void async_write_frame(bool fin, int opcode, const char* data, size_t size,
+    void async_write_frame(bool fin, int opcode, util::Span<const util::Span<const char>> payload,
                            util::UniqueFunction<void()> write_completion_handler)
     {
         REALM_ASSERT(!m_stopped);
+        REALM_ASSERT(payload.size() <= websocket::Socket::max_payload_buffers);
 
         m_write_completion_handler = std::move(write_completion_handler);
 
+        size_t size = 0;
+        for (util::Span<const char> part : payload)
+            size += part.size();
+
+        // Only small unfragmented text and binary messages are compressed.
+        // Control frames must never be, and large messages are generally
+        // compressed by the application already.
+        bool compressed = false;
+        util::Span<const char> deflated;
+        if (m_deflater && fin && (opcode == int(websocket::Opcode::text) || opcode == int(websocket::Opcode::binary)) &&
+            size > 0 && size <= s_max_deflated_message_size) {
+            m_deflater->deflate(payload, m_deflate_buffer); // Throws
+            deflated = {m_deflate_buffer.data(), m_deflate_buffer.size()};
+            payload = {&deflated, 1};
+            size = deflated.size();
+            compressed = true;
+        }
+
         bool mask = m_is_client;
 
+        // A large payload that needs no masking is written to the stream
+        // directly from the caller's buffers, right after the header, instead
+        // of being copied into the write buffer.
+        if (!mask && size >= s_separate_payload_write_min_size) {
+            size_t header_size = make_frame_header(fin, compressed, opcode, mask, size, m_write_header_buffer,
+                                                   m_config.websocket_get_random());
+            util::Span<const char> buffers[1 + websocket::Socket::max_payload_buffers];
+            buffers[0] = {m_write_header_buffer, header_size};
+            std::copy(payload.begin(), payload.end(), buffers + 1);
+            initiate_write({buffers, 1 + payload.size()});
+            return;
+        }
+
         // 14 is the maximum header length of a Websocket frame.
         size_t required_size = size + 14;
         if (m_write_buffer.size() < required_size)
             m_write_buffer.resize(required_size);
 
-        size_t message_size =
-            make_frame(fin, opcode, mask, data, size, m_write_buffer.data(), m_config.websocket_get_random());
+        size_t message_size = make_frame(fin, compressed, opcode, mask, payload, size, m_write_buffer.data(),
+                                         m_config.websocket_get_random());
+        util::Span<const char> buffer{m_write_buffer.data(), message_size};
+        initiate_write({&buffer, 1});
+    }
 
+    // initiate_write() writes the concatenation of \a buffers to the stream.
+    void initiate_write(util::Span<const util::Span<const char>> buffers)
+    {
         auto handler = [this](std::error_code ec, size_t) {
             // If the operation is aborted, then the write operation was canceled and we should ignore this callback.
             if (ec == util::error::operation_aborted) {
@@ -701,7 +1093,12 @@ public:
             handle_write_message();
         };
 
-        m_config.async_write(m_write_buffer.data(), message_size, handler);
+        if (buffers.size() == 1) {
+            m_config.async_write(buffers[0].data(), buffers[0].size(), std::move(handler)); // Throws
+        }
+        else {
+            m_config.async_write_buffers(buffers, std::move(handler)); // Throws
+        }
     }
 
     void handle_write_message()
@@ -710,6 +1107,10 @@ public:
             m_write_buffer.resize(s_write_buffer_stable_size);
             m_write_buffer.shrink_to_fit();
         }
+        if (m_deflate_buffer.size() > s_write_buffer_stable_size) {
+            m_deflate_buffer.resize(s_write_buffer_stable_size);
+            m_deflate_buffer.shrink_to_fit();
+        }
 
         auto handler = std::move(m_write_completion_handler);
         m_write_completion_handler = nullptr;
@@ -740,6 +1141,21 @@ private:
     std::vector<char> m_write_buffer;
     static const size_t s_write_buffer_stable_size = 2048;
 
+    // Frames with a payload of at least this size are written as a header
+    // followed by the payload, unless the payload must be masked.
+    static const size_t s_separate_payload_write_min_size = 64 * 1024;
+    char m_write_header_buffer[14];
+
+    // The permessage-deflate extension. m_deflater is null if outgoing
+    // messages are not compressed, and m_inflater is null if the extension
+    // was not negotiated.
+    bool m_permessage_deflate_offered = false;
+    std::unique_ptr<Deflater> m_deflater;
+    std::unique_ptr<Inflater> m_inflater;
+    std::vector<char> m_deflate_buffer;
+    std::vector<char> m_inflate_buffer;
+    static const size_t s_max_deflated_message_size = 16 * 1024;
+
     util::UniqueFunction<void()> m_write_completion_handler;
 
     void error_client_malformed_response()
@@ -860,6 +1276,19 @@ private:
             return;
         }
 
+        // The server may only accept the extension that was offered.
+        if (util::Optional<StringData> extensions =
+                find_http_header_value(response.headers, "Sec-WebSocket-Extensions")) {
+            util::Optional<PermessageDeflateParams> params;
+            if (m_permessage_deflate_offered)
+                params = parse_permessage_deflate(std::string_view(*extensions), true);
+            if (!params) {
+                error_client_response_websocket_headers_invalid(response);
+                return;
+            }
+            enable_permessage_deflate(*params); // Throws
+        }
+
         m_config.websocket_handshake_completion_handler(response.headers);
 
         if (m_stopped)
@@ -884,6 +1313,14 @@ private:
         }
         REALM_ASSERT(response);
 
+        if (m_config.websocket_permessage_deflate_enabled()) {
+            std::string extensions;
+            if (auto params = negotiate_permessage_deflate(request.headers, extensions)) {
+                response->headers["Sec-WebSocket-Extensions"] = std::move(extensions);
+                enable_permessage_deflate(*params); // Throws
+            }
+        }
+
         auto handler = [request, this](std::error_code ec) {
             // If the operation is aborted, the socket object may have been destroyed.
             if (ec != util::error::operation_aborted) {
@@ -907,6 +1344,30 @@ private:
         m_http_server->async_send_response(*response, std::move(handler));
     }
 
+    void enable_permessage_deflate(const PermessageDeflateParams& params)
+    {
+        bool no_context_takeover =
+            (m_is_client ? params.client_no_context_takeover : params.server_no_context_takeover);
+        int max_window_bits = (m_is_client ? params.client_max_window_bits : params.server_max_window_bits);
+        m_logger.debug("WebSocket: Using permessage-deflate (no_context_takeover = %1, max_window_bits = %2)",
+                       no_context_takeover, max_window_bits);
+
+        // zlib does not support a raw deflate window of 8 bits. Messages are
+        // then sent uncompressed, which the extension always allows.
+        if (max_window_bits > 8)
+            m_deflater = std::make_unique<Deflater>(max_window_bits, no_context_takeover); // Throws
+        m_inflater = std::make_unique<Inflater>();                                         // Throws
+        m_frame_reader.permessage_deflate = true;
+    }
+
+    void disable_permessage_deflate() noexcept
+    {
+        m_permessage_deflate_offered = false;
+        m_deflater.reset();
+        m_inflater.reset();
+        m_frame_reader.permessage_deflate = false;
+    }
+
     // find_sec_websocket_accept is similar to
     // find_sec_websockey_key.
     bool find_sec_websocket_accept(const HTTPHeaders& headers)
@@ -961,14 +1422,24 @@ private:
         if (m_frame_reader.delivery_ready) {
             bool should_continue = true;
 
+            const char* data = m_frame_reader.delivery_buffer;
+            size_t size = m_frame_reader.delivery_size;
+            if (m_frame_reader.delivery_compressed) {
+                REALM_ASSERT(m_inflater);
+                if (!m_inflater->inflate(data, size, m_inflate_buffer)) { // Throws
+                    protocol_error(Error::bad_message);
+                    return;
+                }
+                data = m_inflate_buffer.data();
+                size = m_inflate_buffer.size();
+            }
+
             switch (m_frame_reader.delivery_opcode) {
                 case websocket::Opcode::text:
-                    should_continue = m_config.websocket_text_message_received(m_frame_reader.delivery_buffer,
-                                                                               m_frame_reader.delivery_size);
+                    should_continue = m_config.websocket_text_message_received(data, size);
                     break;
                 case websocket::Opcode::binary:
-                    should_continue = m_config.websocket_binary_message_received(m_frame_reader.delivery_buffer,
-                                                                                 m_frame_reader.delivery_size);
+                    should_continue = m_config.websocket_binary_message_received(data, size);
                     break;
                 case websocket::Opcode::close: {
                     auto [error_code, error_message] =
@@ -995,6 +1466,11 @@ private:
             if (m_stopped)
                 return;
 
+            if (m_inflate_buffer.size() > s_write_buffer_stable_size) {
+                m_inflate_buffer.resize(s_write_buffer_stable_size);
+                m_inflate_buffer.shrink_to_fit();
+            }
+
             // recursion is harmless, since the depth will be at most 2.
             frame_reader_loop();
             return;
@@ -1163,6 +1639,18 @@ bool websocket::Config::websocket_pong_message_received(const char*, size_t)
     return true;
 }
 
+bool websocket::Config::websocket_permessage_deflate_enabled() noexcept
+{
+    return false;
+}
+
+void websocket::Config::async_write_buffers(util::Span<const util::Span<const char>> buffers,
+                                            WriteCompletionHandler handler)
+{
+    std::vector<util::Span<const char>> buffers_2(buffers.begin(), buffers.end()); // Throws
+    write_buffers_in_sequence(*this, std::move(buffers_2), 0, 0, std::move(handler)); // Throws
+}
+
 
 class websocket::Socket::Impl : public WebSocket {
 public:
@@ -1203,7 +1691,14 @@ void websocket::Socket::initiate_server_websocket_after_handshake()
 void websocket::Socket::async_write_frame(bool fin, Opcode opcode, const char* data, size_t size,
                                           util::UniqueFunction<void()> handler)
 {
-    m_impl->async_write_frame(fin, int(opcode), data, size, std::move(handler));
+    util::Span<const char> payload{data, size};
+    m_impl->async_write_frame(fin, int(opcode), {&payload, 1}, std::move(handler));
+}
+
+void websocket::Socket::async_write_frame(bool fin, Opcode opcode, util::Span<const util::Span<const char>> payload,
+                                          util::UniqueFunction<void()> handler)
+{
+    m_impl->async_write_frame(fin, int(opcode), payload, std::move(handler));
 }
 
 void websocket::Socket::async_write_text(const char* data, size_t size, util::UniqueFunction<void()> handler)
@@ -1216,6 +1711,12 @@ void websocket::Socket::async_write_binary(const char* data, size_t size, util::
     async_write_frame(true, Opcode::binary, data, size, std::move(handler));
 }
 
+void websocket::Socket::async_write_binary(util::Span<const util::Span<const char>> payload,
+                                           util::UniqueFunction<void()> handler)
+{
+    async_write_frame(true, Opcode::binary, payload, std::move(handler));
+}
+
 void websocket::Socket::async_write_close(const char* data, size_t size, util::UniqueFunction<void()> handler)
 {
     async_write_frame(true, Opcode::close, data, size, std::move(handler));
@@ -5,6 +5,7 @@
 #include <realm/util/functional.hpp>
 #include <realm/util/http.hpp>
 #include <realm/util/logger.hpp>
+#include <realm/util/span.hpp>
 
 #include <random>
 #include <system_error>
@@ -42,6 +43,18 @@ public:
     virtual void async_read_until(char* buffer, size_t size, char delim, ReadCompletionHandler handler) = 0;
     //@}
 
+    /// async_write_buffers() writes the concatenation of at most four
+    /// buffers to the underlying stream. The Socket uses it to send a frame
+    /// header together with a payload that is not copied into the frame
+    /// buffer. The array of buffers is only valid until the function returns,
+    /// but the memory that the buffers refer to remains valid until the
+    /// handler is called. The default implementation writes the buffers one
+    /// after the other using async_write(). Implementations on top of a stream
+    /// that supports gather writes, such as util::network::Socket, should
+    /// override it.
+    virtual void async_write_buffers(util::Span<const util::Span<const char>> buffers,
+                                     WriteCompletionHandler handler);
+
     /// websocket_handshake_completion_handler() is called when the websocket is connected, .i.e.
     /// after the handshake is done. It is not allowed to send messages on the socket before the
     /// handshake is done. No message_received callbacks will be called before the handshake is done.
@@ -82,6 +95,15 @@ public:
     virtual bool websocket_ping_message_received(const char* data, size_t size);
     virtual bool websocket_pong_message_received(const char* data, size_t size);
     //@}
+
+    /// websocket_permessage_deflate_enabled() determines whether the Socket
+    /// negotiates the permessage-deflate extension (RFC 7692) during the
+    /// handshake. A client Socket offers the extension, and a server Socket
+    /// accepts a client's offer. When the extension is in use, small text and
+    /// binary messages are compressed with a deflate context that is carried
+    /// over from message to message, unless the peer asks for it to be
+    /// reset. The default implementation returns false.
+    virtual bool websocket_permessage_deflate_enabled() noexcept;
 };
 
 
@@ -132,7 +154,9 @@ public:
     /// async_write_frame() sends a single frame with this content:
     /// \param fin The fin bit set to 0 or 1
     /// \param opcode Specifies the opcpde.
-    /// \param data size The frame payload is taken from this buffer.
+    /// \param data size The frame payload is taken from this buffer. The
+    /// buffer must remain valid until the handler is called, since large
+    /// payloads are written to the stream directly from it.
     /// \param handler Called when the frame has been successfully sent. Error s are reported through
     /// websocket_write_error_handler() in Config.
     /// This function is rather low level and should only be used with knowledge of the WebSocket protocol.
@@ -144,6 +168,15 @@ public:
     void async_write_frame(bool fin, Opcode opcode, const char* data, size_t size,
                            util::UniqueFunction<void()> handler);
 
+    /// Same as async_write_frame() above, except that the frame payload is
+    /// the concatenation of at most `max_payload_buffers` buffers. This allows
+    /// the caller to send, for example, a message header and a message body
+    /// that are held in separate buffers without first copying them into one.
+    void async_write_frame(bool fin, Opcode opcode, util::Span<const util::Span<const char>> payload,
+                           util::UniqueFunction<void()> handler);
+
+    static constexpr size_t max_payload_buffers = 3;
+
     //@{
     /// Five utility functions used to send whole messages. These five
     /// functions are implemented in terms of async_write_frame(). These
@@ -157,6 +190,7 @@ public:
     /// protocol.
     void async_write_text(const char* data, size_t size, util::UniqueFunction<void()> handler);
     void async_write_binary(const char* data, size_t size, util::UniqueFunction<void()> handler);
+    void async_write_binary(util::Span<const util::Span<const char>> payload, util::UniqueFunction<void()> handler);
     void async_write_close(const char* data, size_t size, util::UniqueFunction<void()> handler);
     void async_write_ping(const char* data, size_t size, util::UniqueFunction<void()> handler);
     void async_write_pong(const char* data, size_t size, util::UniqueFunction<void()> handler);
@@ -38,6 +38,8 @@
 #ifdef REALM_COMPILER_SSE
 #ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <cpuid.h>
 #endif
 #endif
 
@@ -62,6 +64,46 @@ inline unsigned long long _xgetbv(unsigned index)
 
 #endif
 #endif
+
+// Leaf 7 of CPUID reports the extended features, AVX2 is EBX bit 5
+bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+    int CPUInfo[4];
+    __cpuid(CPUInfo, 0);
+    if (CPUInfo[0] < 7)
+        return false;
+    __cpuidex(CPUInfo, 7, 0);
+    return (CPUInfo[1] & (1 << 5)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 5)) != 0;
+#endif
+}
+
+// AVX-512 Foundation is EBX bit 16 of leaf 7, and the byte and word instructions (BW) are bit 30
+bool cpu_has_avx512bw()
+{
+    constexpr unsigned int bits = (1u << 16) | (1u << 30);
+#ifdef _MSC_VER
+    int CPUInfo[4];
+    __cpuid(CPUInfo, 0);
+    if (CPUInfo[0] < 7)
+        return false;
+    __cpuidex(CPUInfo, 7, 0);
+    return (unsigned(CPUInfo[1]) & bits) == bits;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & bits) == bits;
+#endif
+}
+
 #endif
 
 } // anonymous namespace
@@ -106,6 +148,7 @@ void cpuid_init()
     }
 
     bool avxSupported = false;
+    bool avx512Supported = false;
 
 // seems like in jenkins builds, __GNUC__ is defined for clang?! todo fixme
 #if !defined __clang__ && ((defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219) || defined __GNUC__)
@@ -116,18 +159,21 @@ void cpuid_init()
         // Check if the OS will save the YMM registers
         unsigned long long xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
         avxSupported = (xcrFeatureMask & 0x6) || false;
+        // The OS must also save the opmask and ZMM registers
+        avx512Supported = (xcrFeatureMask & 0xe6) == 0xe6;
     }
 #endif
 
     if (avxSupported) {
-        avx_support = 0; // AVX1 supported
+        // The YMM state check above also covers AVX2, so only the CPU feature bit remains
+        avx_support = cpu_has_avx2() ? 1 : 0; // AVX2 or AVX1 supported
+        if (avx_support == 1 && avx512Supported && cpu_has_avx512bw())
+            avx_support = 2;
     }
     else {
         avx_support = -1; // No AVX supported
     }
 
-    // 1 is reserved for AVX2
-
 #endif
 }
 } // namespace realm
@@ -73,6 +73,22 @@ typedef SSIZE_T ssize_t;
 #define REALM_COMPILER_AVX
 #endif
 
+// AVX2 and AVX-512 code paths are compiled for their target on a per-function basis so that the rest of the library
+// can still be built for baseline x86-64. The paths are only entered after a runtime check with sseavx<2>() and
+// sseavx<3>() respectively.
+#if defined(REALM_COMPILER_AVX) && (defined(__GNUC__) || defined(__clang__))
+#define REALM_TARGET_AVX2 __attribute__((target("avx2")))
+#define REALM_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define REALM_TARGET_AVX2
+#define REALM_TARGET_AVX512
+#endif
+
+// Advanced SIMD is mandatory on AArch64, so no runtime detection is needed
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define REALM_COMPILER_NEON
+#endif
+
 namespace realm {
 
 using StringCompareCallback = util::UniqueFunction<bool(const char* string1, const char* string2)>;
@@ -93,7 +109,8 @@ REALM_FORCEINLINE bool sseavx()
 
     avx_support = -1: No AVX support
     avx_support = 0: AVX1 supported
-    sse_support = 1: AVX2 supported (not yet implemented for detection in our cpuid_init(), todo)
+    avx_support = 1: AVX2 supported
+    avx_support = 2: AVX-512 F and BW supported
 
     This lets us test very rapidly at runtime because we just need 1 compare instruction (with 0) to test both for
     SSE 3 and 4.2 by caller (compiler optimizes if calls are concecutive), and can decide branch with ja/jl/je because
@@ -102,8 +119,9 @@ REALM_FORCEINLINE bool sseavx()
     We runtime-initialize sse_support in a constructor of a static variable which is not guaranteed to be called
     prior to cpu_sse(). So we compile-time initialize sse_support to -2 as fallback.
     */
-    static_assert(version == 1 || version == 2 || version == 30 || version == 42,
-                  "Only version == 1 (AVX), 2 (AVX2), 30 (SSE 3) and 42 (SSE 4.2) are supported for detection");
+    static_assert(version == 1 || version == 2 || version == 3 || version == 30 || version == 42,
+                  "Only version == 1 (AVX), 2 (AVX2), 3 (AVX-512), 30 (SSE 3) and 42 (SSE 4.2) are supported for "
+                  "detection");
 #ifdef REALM_COMPILER_SSE
     if (version == 30)
         return (sse_support >= 0);
@@ -113,6 +131,8 @@ REALM_FORCEINLINE bool sseavx()
         return (avx_support >= 0);
     else if (version == 2) // avx2
         return (avx_support > 0);
+    else if (version == 3) // avx-512
+        return (avx_support > 1);
     else
         return false;
 #else
@@ -10,7 +10,6 @@
 #endif // REALM_ENABLE_ENCRYPTION
 
 #include <realm/sync/history.hpp>
-#include <realm/sync/object.hpp>
 
 #include "../peer.hpp"
 
@@ -48,7 +47,7 @@ void transform_transactions(TestContext& test_context, BenchmarkResults& results
             ColKey col_ndx;
             {
                 peer.start_transaction();
-                TableRef t = sync::create_table(*peer.group, "class_t");
+                TableRef t = peer.group->add_table("class_t");
                 col_ndx = t->add_column(type_Int, "i");
                 peer.commit();
             }
@@ -91,7 +90,7 @@ void transform_transactions(TestContext& test_context, BenchmarkResults& results
     }
 
     // results.finish(ident_preface, ident_preface);
-    results.finish(ident, ident);
+    results.finish(ident, ident, "runtime_secs");
 }
 
 // Two peers have 1 transaction each with 1000 instructions (8.3% of
@@ -145,7 +144,7 @@ void transform_instructions(TestContext& test_context, BenchmarkResults& results
     }
 
     // results.finish(ident_preface, ident_preface);
-    results.finish(ident, ident);
+    results.finish(ident, ident, "runtime_secs");
 }
 
 template <size_t num_iterations>
@@ -164,7 +163,7 @@ void connected_objects(TestContext& test_context, BenchmarkResults& results)
 
         auto make_instructions = [](Peer& peer) {
             peer.start_transaction();
-            TableRef t = sync::create_table_with_primary_key(*peer.group, "class_t", type_String, "pk");
+            TableRef t = peer.group->add_table_with_primary_key("class_t", type_String, "pk");
             auto col_key = t->add_column(*t, "l");
 
             // Everything links to this object!
@@ -194,7 +193,7 @@ void connected_objects(TestContext& test_context, BenchmarkResults& results)
         results.submit(ident.c_str(), t.get_elapsed_time());
     }
 
-    results.finish(ident, ident);
+    results.finish(ident, ident, "runtime_secs");
 }
 
 } // namespace bench
@@ -206,7 +205,7 @@ const int max_lead_text_width = 40;
 TEST(BenchMerge1000x1000Instructions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_1000x1000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<1000>(test_context, results);
 }
@@ -214,7 +213,7 @@ TEST(BenchMerge1000x1000Instructions)
 TEST(BenchMerge2000x2000Instructions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_2000x2000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<2000>(test_context, results);
 }
@@ -222,7 +221,7 @@ TEST(BenchMerge2000x2000Instructions)
 TEST_IF(BenchMerge3000x3000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_3000x3000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<3000>(test_context, results);
 }
@@ -230,7 +229,7 @@ TEST_IF(BenchMerge3000x3000Instructions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge4000x4000Instructions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_4000x4000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<4000>(test_context, results);
 }
@@ -238,7 +237,7 @@ TEST(BenchMerge4000x4000Instructions)
 TEST_IF(BenchMerge5000x5000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_5000x5000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<5000>(test_context, results);
 }
@@ -246,7 +245,7 @@ TEST_IF(BenchMerge5000x5000Instructions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge8000x8000Instructions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_8000x8000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<8000>(test_context, results);
 }
@@ -254,7 +253,7 @@ TEST(BenchMerge8000x8000Instructions)
 TEST_IF(BenchMerge10000x10000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_10000x10000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<10000>(test_context, results);
 }
@@ -262,7 +261,7 @@ TEST_IF(BenchMerge10000x10000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge11000x11000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_11000x11000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<11000>(test_context, results);
 }
@@ -270,7 +269,7 @@ TEST_IF(BenchMerge11000x11000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge12000x12000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_12000x12000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<12000>(test_context, results);
 }
@@ -278,7 +277,7 @@ TEST_IF(BenchMerge12000x12000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge13000x13000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_13000x13000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<13000>(test_context, results);
 }
@@ -286,7 +285,7 @@ TEST_IF(BenchMerge13000x13000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge14000x14000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_14000x14000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<14000>(test_context, results);
 }
@@ -294,7 +293,7 @@ TEST_IF(BenchMerge14000x14000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge15000x15000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_15000x15000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<15000>(test_context, results);
 }
@@ -302,7 +301,7 @@ TEST_IF(BenchMerge15000x15000Instructions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge16000x16000Instructions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_16000x16000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<16000>(test_context, results);
 }
@@ -310,7 +309,7 @@ TEST(BenchMerge16000x16000Instructions)
 TEST_IF(BenchMerge17000x17000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_17000x17000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<17000>(test_context, results);
 }
@@ -318,7 +317,7 @@ TEST_IF(BenchMerge17000x17000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge18000x18000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_18000x18000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<18000>(test_context, results);
 }
@@ -326,7 +325,7 @@ TEST_IF(BenchMerge18000x18000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge19000x19000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_19000x19000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<19000>(test_context, results);
 }
@@ -334,7 +333,7 @@ TEST_IF(BenchMerge19000x19000Instructions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge20000x20000Instructions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "instructions_20000x20000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_instructions<20000>(test_context, results);
 }
@@ -343,7 +342,7 @@ TEST_IF(BenchMerge20000x20000Instructions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge100x100Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_100x100";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<100>(test_context, results);
 }
@@ -351,7 +350,7 @@ TEST(BenchMerge100x100Transactions)
 TEST(BenchMerge500x500Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_500x500";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<500>(test_context, results);
 }
@@ -359,7 +358,7 @@ TEST(BenchMerge500x500Transactions)
 TEST(BenchMerge1000x1000Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_1000x1000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<1000>(test_context, results);
 }
@@ -367,7 +366,7 @@ TEST(BenchMerge1000x1000Transactions)
 TEST(BenchMerge2000x2000Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_2000x2000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<2000>(test_context, results);
 }
@@ -375,7 +374,7 @@ TEST(BenchMerge2000x2000Transactions)
 TEST_IF(BenchMerge3000x3000Transactions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_3000x3000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<3000>(test_context, results);
 }
@@ -384,7 +383,7 @@ TEST_IF(BenchMerge3000x3000Transactions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge4000x4000Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_4000x4000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<4000>(test_context, results);
 }
@@ -392,7 +391,7 @@ TEST(BenchMerge4000x4000Transactions)
 TEST_IF(BenchMerge5000x5000Transactions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_5000x5000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<5000>(test_context, results);
 }
@@ -400,7 +399,7 @@ TEST_IF(BenchMerge5000x5000Transactions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge6000x6000Transactions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_6000x6000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<6000>(test_context, results);
 }
@@ -408,7 +407,7 @@ TEST_IF(BenchMerge6000x6000Transactions, RUN_ALL_BENCHMARKS)
 TEST_IF(BenchMerge7000x7000Transactions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_7000x7000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<7000>(test_context, results);
 }
@@ -417,7 +416,7 @@ TEST_IF(BenchMerge7000x7000Transactions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge8000x8000Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_8000x8000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<8000>(test_context, results);
 }
@@ -425,7 +424,7 @@ TEST(BenchMerge8000x8000Transactions)
 TEST_IF(BenchMerge9000x9000Transactions, RUN_ALL_BENCHMARKS)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_9000x9000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<9000>(test_context, results);
 }
@@ -433,7 +432,7 @@ TEST_IF(BenchMerge9000x9000Transactions, RUN_ALL_BENCHMARKS)
 TEST(BenchMerge16000x16000Transactions)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "transactions_16000x16000";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::transform_transactions<16000>(test_context, results);
 }
@@ -441,14 +440,16 @@ TEST(BenchMerge16000x16000Transactions)
 TEST(BenchMergeManyConnectedObjects)
 {
     std::string results_file_stem = test_util::get_test_path_prefix() + "connected_objects";
-    BenchmarkResults results(max_lead_text_width, results_file_stem.c_str());
+    BenchmarkResults results(max_lead_text_width, "bench-transform", results_file_stem.c_str());
 
     bench::connected_objects<8000>(test_context, results);
 }
 
 #if !REALM_IOS
-int main(int argc, char** argv)
+int main(int argc, const char* argv[])
 {
-    return test_all(argc, argv, nullptr);
+    if (!realm::test_util::initialize_test_path(argc, argv))
+        return 1;
+    return test_all();
 }
 #endif // REALM_IOS
@@ -1,163 +1,400 @@
-#include <getopt.h>
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+// A load test of the sync server in noinst/server, which simulates many sync
+// clients in one process. The clients share a few event loops (sync::Client
+// objects), and are all bound to the same server Realm, so every changeset
+// uploaded by one of them is downloaded by all the others. A fraction of the
+// clients write synthetic changesets at a fixed rate, and a few observers
+// measure how long it takes from a write until they have integrated it.
+// Periodic reconnect storms drop all connections at once.
+//
+// The load is configured through environment variables:
+//
+//   REALM_LOAD_TEST_CLIENTS             simulated clients (1000)
+//   REALM_LOAD_TEST_EVENT_LOOPS         sync::Client objects shared by them (4)
+//   REALM_LOAD_TEST_WRITERS             clients which write (50)
+//   REALM_LOAD_TEST_OBSERVERS           clients which measure latency (10)
+//   REALM_LOAD_TEST_DURATION_SECS       (30)
+//   REALM_LOAD_TEST_TRANSACT_PERIOD_MS  time between writes of a writer (1000)
+//   REALM_LOAD_TEST_OBJECTS_PER_WRITE   objects created per write (10)
+//   REALM_LOAD_TEST_PAYLOAD_SIZE        bytes per object (256)
+//   REALM_LOAD_TEST_STORM_PERIOD_SECS   time between reconnect storms, 0 for none (0)
+//   REALM_LOAD_TEST_CONNECTION_PER_SESSION  one connection per client (0)
+//   REALM_LOAD_TEST_OUTPUT              file to write the results to as JSON
+//
+// The server runs in the same process, so the memory reported is that of the
+// server and the clients together.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <external/json/json.hpp>
 
-#include "load_tester.hpp"
+#include <realm/metrics/latency.hpp>
+
+#include "../sync_fixtures.hpp"
+#include "../test_all.hpp"
+#include "../util/test_path.hpp"
 
 using namespace realm;
-using namespace sync;
+using namespace realm::sync;
+using namespace realm::test_util;
+using namespace realm::test_util::unit_test;
+using namespace realm::fixtures;
+using nlohmann::json;
+using metrics::LatencyHistogram;
+
+namespace {
 
-static void print_usage(std::ostream& os, const char* prog)
+template <class T>
+T get_env(const char* name, T default_value)
 {
-    os << "Usage: " << prog << " <server-url> <local-root> <options>\n";
-    os << "Options:\n";
-    os << "    --verbose          Print debug information.\n";
-    os << "    --token=<file>  User token file. (Required)\n";
-    os << "    --machine-id=N     Id of the machine the client is started on, starting with 1.(Required)\n";
-    os << "    --client-id=N    Numeric Client id, starting with 0.(Required)\n";
-    os << "    --sleep-between=N    Sleep time in between transactions. Milliseconds.(Optional)\n";
-    os << "    --num-transactions=N    The number of transactions after which the client stops sending.(Optional)\n";
-    os << "    --listen=N    The client will just listen for changes\n";
-    os << "    --statsd-host=N    Statsd server hostname\n";
-    os << "    --statsd-port=N    Statsd server port\n";
+    const char* str = std::getenv(name);
+    if (!str || !*str)
+        return default_value;
+    std::istringstream in(str);
+    in.imbue(std::locale::classic());
+    T value;
+    if (!(in >> value))
+        throw std::runtime_error(util::format("Invalid value of %1: '%2'", name, str));
+    return value;
 }
 
-int main(int argc, char** argv)
+struct LoadConfig {
+    size_t num_clients = get_env<size_t>("REALM_LOAD_TEST_CLIENTS", 1000);
+    size_t num_event_loops = get_env<size_t>("REALM_LOAD_TEST_EVENT_LOOPS", 4);
+    size_t num_writers = get_env<size_t>("REALM_LOAD_TEST_WRITERS", 50);
+    size_t num_observers = get_env<size_t>("REALM_LOAD_TEST_OBSERVERS", 10);
+    double duration_secs = get_env<double>("REALM_LOAD_TEST_DURATION_SECS", 30);
+    int64_t transact_period_ms = get_env<int64_t>("REALM_LOAD_TEST_TRANSACT_PERIOD_MS", 1000);
+    size_t objects_per_write = get_env<size_t>("REALM_LOAD_TEST_OBJECTS_PER_WRITE", 10);
+    size_t payload_size = get_env<size_t>("REALM_LOAD_TEST_PAYLOAD_SIZE", 256);
+    double storm_period_secs = get_env<double>("REALM_LOAD_TEST_STORM_PERIOD_SECS", 0);
+    bool connection_per_session = get_env<int>("REALM_LOAD_TEST_CONNECTION_PER_SESSION", 0) != 0;
+    std::string output = get_env<std::string>("REALM_LOAD_TEST_OUTPUT", "");
+};
+
+int64_t now_ns()
 {
-    std::string root_dir;
-    std::string server_url;
-
-    int verbose = 0;
-    int listen = 0;
-    unsigned int sleep_in_between = 0; // Sleep in between transactions
-    unsigned int num_operations = 0;   // Number of operations in a transaction
-    int num_transactions = -1;
-    unsigned int client_id = 0;
-    std::string machine_id = "1";
-    util::Optional<std::string> token_path;
-    util::Optional<std::string> signature_path;
-    std::string statsd_hostname{"localhost"};
-    unsigned int statsd_port = 8125;
-    // Process command line
-    const struct option long_options[] = {{"verbose", no_argument, &verbose, 1},
-                                          {"token", required_argument, 0, 't'},
-                                          {"machine-id", required_argument, 0, 'm'},
-                                          {"client-id", required_argument, 0, 'c'},
-                                          {"sleep-between", optional_argument, 0, 's'},
-                                          {"num-transactions", optional_argument, 0, 'n'},
-                                          {"num-operations", optional_argument, 0, 'o'},
-                                          {"listen", no_argument, &listen, 1},
-                                          {"help", no_argument, 0, 'h'},
-                                          {"statsd-host", optional_argument, 0, 'x'},
-                                          {"statsd-port", optional_argument, 0, 'y'}};
-    while (true) {
-        int option_index = 0;
-        int c = getopt_long(argc, argv, "l:t:m:c:s:n:o:h:x:y", long_options, &option_index);
-        if (c == -1)
-            break; // no more options
-
-        switch (c) {
-            case 0: /* flag set */
-                break;
-            case 't': {
-                token_path = std::string(optarg);
-                break;
-            }
-            case 'm': {
-                machine_id = std::string(optarg);
-                break;
-            }
-            case 'c': {
-                std::stringstream ss;
-                ss << optarg;
-                if (!(ss >> client_id)) {
-                    std::cerr << "Invalid Client id.\n";
-                    print_usage(std::cerr, argv[0]);
-                    return 1;
-                }
-                break;
-            }
-            case 's': {
-                std::stringstream ss;
-                ss << optarg;
-                if (!(ss >> sleep_in_between)) {
-                    std::cerr << "Invalid sleep time.\n";
-                    print_usage(std::cerr, argv[0]);
-                    return 1;
-                }
-                break;
-            }
-            case 'x': {
-                statsd_hostname = std::string(optarg);
-                break;
-            }
-            case 'y': {
-                std::stringstream ss;
-                ss << optarg;
-                if (!(ss >> statsd_port)) {
-                    std::cerr << "Invalid statsd port.\n";
-                    print_usage(std::cerr, argv[0]);
-                    return 1;
-                }
-                break;
-            }
-            case 'n': {
-                std::stringstream ss;
-                ss << optarg;
-                if (!(ss >> num_transactions) || num_transactions < 0) {
-                    std::cerr << "Invalid number of transactions. Should be > 0\n";
-                    print_usage(std::cerr, argv[0]);
-                    return 1;
-                }
-                break;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// The resident memory of the process, or 0 if not known
+size_t get_resident_bytes()
+{
+#ifdef __linux__
+    std::ifstream in("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (in >> total_pages >> resident_pages)
+        return resident_pages * size_t(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+class LatencyRecorder {
+public:
+    void record(int64_t nanoseconds)
+    {
+        auto ns = uint64_t(std::max<int64_t>(nanoseconds, 0));
+        std::lock_guard lock(m_mutex);
+        ++m_histogram.buckets[LatencyHistogram::get_bucket(ns)];
+        ++m_histogram.count;
+        m_histogram.total_nanoseconds += ns;
+        m_histogram.max_nanoseconds = std::max(m_histogram.max_nanoseconds, ns);
+    }
+
+    LatencyHistogram get() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_histogram;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    LatencyHistogram m_histogram;
+};
+
+json to_json(const LatencyHistogram& h)
+{
+    return json{{"count", h.count},
+                {"avg_ns", h.count ? h.total_nanoseconds / h.count : 0},
+                {"p50_ns", h.get_percentile(50)},
+                {"p90_ns", h.get_percentile(90)},
+                {"p99_ns", h.get_percentile(99)},
+                {"p999_ns", h.get_percentile(99.9)},
+                {"max_ns", h.max_nanoseconds}};
+}
+
+struct SimulatedClient {
+    std::unique_ptr<DBTestPathGuard> path;
+    DBRef db;
+    std::unique_ptr<Session> session;
+    uint_fast64_t downloaded_bytes = 0;
+    // The sequence number last seen of each writer, for observers
+    std::map<int64_t, int64_t> last_seen;
+};
+
+void create_schema(DBRef db)
+{
+    WriteTransaction wt(db);
+    auto writers = wt.get_group().add_table_with_primary_key("class_Writer", type_Int, "_id");
+    writers->add_column(type_Int, "seq");
+    writers->add_column(type_Int, "written_at");
+    auto payload = wt.get_group().add_table_with_primary_key("class_Payload", type_ObjectId, "_id");
+    payload->add_column(type_Binary, "data");
+    wt.commit();
+}
+
+} // anonymous namespace
+
+TEST(BenchSyncLoad)
+{
+    LoadConfig config;
+    REALM_ASSERT_RELEASE(config.num_event_loops > 0);
+    config.num_writers = std::min(config.num_writers, config.num_clients);
+    config.num_observers = std::min(config.num_observers, config.num_clients);
+    std::cout << "Simulating " << config.num_clients << " clients on " << config.num_event_loops
+              << " event loops, " << config.num_writers << " of which write" << std::endl;
+
+    TEST_DIR(server_dir);
+    TEST_DIR(client_dir);
+    MultiClientServerFixture::Config fixture_config;
+    fixture_config.one_connection_per_session = config.connection_per_session;
+    fixture_config.server_max_open_files = 1024;
+    MultiClientServerFixture fixture(int(config.num_event_loops), 1, server_dir, test_context,
+                                     std::move(fixture_config));
+    fixture.start();
+
+    LatencyRecorder integration_latency;
+    LatencyRecorder commit_latency;
+    std::atomic<uint64_t> total_downloaded{0};
+    std::atomic<uint64_t> num_disconnects{0};
+    std::atomic<uint64_t> num_writes{0};
+
+    // Observers are spread over the clients which do not write
+    std::vector<SimulatedClient> clients(config.num_clients);
+    auto is_writer = [&](size_t i) {
+        return i < config.num_writers;
+    };
+    auto is_observer = [&](size_t i) {
+        return i >= config.num_clients - config.num_observers;
+    };
+
+    auto setup_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < config.num_clients; ++i) {
+        auto& client = clients[i];
+        client.path = std::make_unique<DBTestPathGuard>(util::format("%1/client_%2.realm", std::string(client_dir), i));
+        client.db = DB::create(make_client_replication(), *client.path);
+        create_schema(client.db);
+        client.session = std::make_unique<Session>(fixture.make_session(int(i % config.num_event_loops), client.db));
+
+        // Replaces the fixture's listener, which treats disconnects as errors
+        client.session->set_connection_state_change_listener(
+            [&](ConnectionState state, util::Optional<SessionErrorInfo>) {
+                if (state == ConnectionState::disconnected)
+                    ++num_disconnects;
+            });
+        client.session->set_progress_handler([&client, &total_downloaded](uint_fast64_t downloaded, uint_fast64_t,
+                                                                          uint_fast64_t, uint_fast64_t,
+                                                                          uint_fast64_t, uint_fast64_t) {
+            if (downloaded > client.downloaded_bytes) {
+                total_downloaded += downloaded - client.downloaded_bytes;
+                client.downloaded_bytes = downloaded;
             }
-            case 'o': {
-                std::stringstream ss;
-                ss << optarg;
-                if (!(ss >> num_operations)) {
-                    std::cerr << "Invalid number of operations. Should be > 0\n";
-                    print_usage(std::cerr, argv[0]);
-                    return 1;
+        });
+        if (is_observer(i)) {
+            client.session->set_sync_transact_callback([&client, &integration_latency](VersionID, VersionID) {
+                int64_t now = now_ns();
+                ReadTransaction rt(client.db);
+                auto table = rt.get_table("class_Writer");
+                if (!table)
+                    return;
+                auto col_seq = table->get_column_key("seq");
+                auto col_written_at = table->get_column_key("written_at");
+                for (auto& obj : *table) {
+                    int64_t seq = obj.get<Int>(col_seq);
+                    int64_t& last_seen = client.last_seen[obj.get_primary_key().get_int()];
+                    if (seq > last_seen) {
+                        last_seen = seq;
+                        integration_latency.record(now - obj.get<Int>(col_written_at));
+                    }
                 }
-                break;
-            }
-            case 'h': {
-                print_usage(std::cout, argv[0]);
-                return 1;
-            }
-            case '?': {
-                // getopt already printed an error
-                print_usage(std::cerr, argv[0]);
-                return 1;
-            }
+            });
         }
+        fixture.bind_session(*client.session, 0, "/load");
     }
+    for (auto& client : clients)
+        client.session->wait_for_download_complete_or_client_stopped();
+    double setup_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count();
+    std::cout << "All clients bound and downloaded in " << setup_secs << "s" << std::endl;
 
-    if (optind != argc - 2) {
-        print_usage(std::cerr, argv[0]);
-        return 1;
+    // The writers are spread over one thread per event loop
+    std::atomic<bool> stop{false};
+    auto write = [&](SimulatedClient& client, int64_t writer_id, int64_t seq, std::mt19937_64& engine) {
+        std::string payload(config.payload_size, '\0');
+        for (auto& c : payload)
+            c = char(engine());
+        auto start = std::chrono::steady_clock::now();
+        WriteTransaction wt(client.db);
+        auto writers = wt.get_table("class_Writer");
+        auto obj = writers->create_object_with_primary_key(writer_id);
+        obj.set("seq", seq);
+        obj.set("written_at", now_ns());
+        auto payloads = wt.get_table("class_Payload");
+        auto col_data = payloads->get_column_key("data");
+        for (size_t i = 0; i < config.objects_per_write; ++i) {
+            payloads->create_object_with_primary_key(ObjectId::gen())
+                .set(col_data, BinaryData(payload.data(), payload.size()));
+        }
+        auto version = wt.commit();
+        commit_latency.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        client.session->nonsync_transact_notify(version);
+        ++num_writes;
+    };
+    std::vector<std::thread> writer_threads;
+    for (size_t t = 0; t < config.num_event_loops; ++t) {
+        writer_threads.emplace_back([&, t] {
+            std::mt19937_64 engine(t);
+            auto period = std::chrono::milliseconds(config.transact_period_ms);
+            auto next = std::chrono::steady_clock::now();
+            for (int64_t seq = 1; !stop; ++seq) {
+                for (size_t i = t; i < config.num_writers && !stop; i += config.num_event_loops)
+                    write(clients[i], int64_t(i), seq, engine);
+                next += period;
+                while (!stop && std::chrono::steady_clock::now() < next)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
     }
 
-    server_url = argv[optind];
-    root_dir = argv[optind + 1];
+    // Report once a second, and start reconnect storms
+    LatencyRecorder storm_recovery;
+    auto timeline = json::array();
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(config.duration_secs));
+    auto next_storm = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(config.storm_period_secs));
+    uint64_t previous_downloaded = 0;
+    uint64_t previous_writes = 0;
+    size_t max_resident = 0;
+    std::cout << std::setw(8) << "secs" << std::setw(12) << "writes/s" << std::setw(16) << "download KB/s"
+              << std::setw(12) << "p99 ms" << std::setw(14) << "RSS MB" << std::endl;
+    while (std::chrono::steady_clock::now() < end) {
+        if (config.storm_period_secs > 0 && std::chrono::steady_clock::now() >= next_storm) {
+            auto storm_start = std::chrono::steady_clock::now();
+            fixture.close_server_side_connections();
+            for (size_t i = 0; i < config.num_event_loops; ++i)
+                fixture.cancel_reconnect_delay(int(i));
+            for (auto& client : clients)
+                client.session->wait_for_download_complete_or_client_stopped();
+            auto recovery = std::chrono::steady_clock::now() - storm_start;
+            storm_recovery.record(std::chrono::duration_cast<std::chrono::nanoseconds>(recovery).count());
+            std::cout << "Reconnect storm recovered in " << std::chrono::duration<double>(recovery).count() << "s"
+                      << std::endl;
+            next_storm = std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(config.storm_period_secs));
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
 
-    if (!token_path) {
-        std::cerr << "Please provide a user token file. :-)\n";
-        print_usage(std::cerr, argv[0]);
-        return 1;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t downloaded = total_downloaded;
+        uint64_t writes = num_writes;
+        size_t resident = get_resident_bytes();
+        max_resident = std::max(max_resident, resident);
+        auto p99_ms = double(integration_latency.get().get_percentile(99)) / 1e6;
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << elapsed << std::setw(12)
+                  << double(writes - previous_writes) << std::setw(16)
+                  << double(downloaded - previous_downloaded) / 1024 << std::setw(12) << p99_ms << std::setw(14)
+                  << double(resident) / (1024 * 1024) << std::endl;
+        timeline.push_back(json{{"secs", elapsed},
+                                {"writes", writes - previous_writes},
+                                {"downloaded_bytes", downloaded - previous_downloaded},
+                                {"resident_bytes", resident}});
+        previous_downloaded = downloaded;
+        previous_writes = writes;
     }
-    if (!util::File::exists(*token_path)) {
-        std::cerr << "User token file not found (\"" << *token_path << "\")\n";
-        return 1;
+    stop = true;
+    for (auto& thread : writer_threads)
+        thread.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& client : clients) {
+        client.session->wait_for_upload_complete_or_client_stopped();
+        client.session->wait_for_download_complete_or_client_stopped();
     }
 
-    std::ifstream identity_file;
-    identity_file.open(*token_path);
-    std::string syncUserToken;
-    identity_file >> syncUserToken;
-    std::string realm_path = root_dir + "/load.realm";
+    auto latency = integration_latency.get();
+    std::cout << "Writes: " << num_writes << " (" << double(num_writes) / elapsed << "/s)\n"
+              << "Downloaded: " << total_downloaded << " bytes (" << double(total_downloaded) / elapsed
+              << " bytes/s over all clients)\n"
+              << "Integration latency ms: p50 " << double(latency.get_percentile(50)) / 1e6 << ", p99 "
+              << double(latency.get_percentile(99)) / 1e6 << ", max " << double(latency.max_nanoseconds) / 1e6
+              << "\n"
+              << "Disconnects: " << num_disconnects << "\n"
+              << "Peak RSS: " << double(max_resident) / (1024 * 1024) << " MB" << std::endl;
 
-    LoadTester ld{syncUserToken,  realm_path,       server_url,  machine_id,      client_id,  sleep_in_between,
-                  num_operations, num_transactions, listen == 1, statsd_hostname, statsd_port};
-    ld.run();
-    return 0;
+    if (!config.output.empty()) {
+        json results{{"clients", config.num_clients},
+                     {"event_loops", config.num_event_loops},
+                     {"writers", config.num_writers},
+                     {"observers", config.num_observers},
+                     {"setup_secs", setup_secs},
+                     {"duration_secs", elapsed},
+                     {"writes", uint64_t(num_writes)},
+                     {"downloaded_bytes", uint64_t(total_downloaded)},
+                     {"download_bytes_per_sec", double(total_downloaded) / elapsed},
+                     {"disconnects", uint64_t(num_disconnects)},
+                     {"peak_resident_bytes", max_resident},
+                     {"integration_latency", to_json(latency)},
+                     {"commit_latency", to_json(commit_latency.get())},
+                     {"storm_recovery", to_json(storm_recovery.get())},
+                     {"timeline", std::move(timeline)}};
+        std::ofstream out(config.output);
+        out << std::setw(2) << results << std::endl;
+    }
+
+    // Sessions must be gone before the fixture
+    for (auto& client : clients)
+        client.session.reset();
+    fixture.stop();
+}
+
+int main(int argc, const char* argv[])
+{
+    if (!initialize_test_path(argc, argv))
+        return 1;
+    return test_all();
 }
@@ -0,0 +1,101 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <realm.hpp>
+#include <realm/alloc_slab.hpp>
+
+#include "../util/test_path.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void report(const char* name, Clock::time_point start, size_t num_ops)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    std::cout << name << ": " << double(ns) / num_ops << " ns/op" << std::endl;
+}
+
+// Allocate and free blocks as a write transaction modifying many small arrays
+// would, then release everything at once as a commit does.
+void bench_slab_alloc(const char* name, size_t min_size, size_t max_size)
+{
+    const size_t num_rounds = 20;
+    const size_t num_blocks = 200000;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> size_dist(min_size / 8, max_size / 8);
+    std::vector<MemRef> blocks;
+    blocks.reserve(num_blocks);
+
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    auto start = Clock::now();
+    for (size_t round = 0; round < num_rounds; ++round) {
+        for (size_t i = 0; i < num_blocks; ++i) {
+            size_t size = size_dist(rng) * 8;
+            MemRef mem = alloc.alloc(size);
+            NodeHeader::set_capacity_in_header(size, mem.get_addr());
+            blocks.push_back(mem);
+            // Copy-on-write frees the old version of about every other array
+            if (i % 2) {
+                size_t ndx = rng() % blocks.size();
+                alloc.free_(blocks[ndx].get_ref(), blocks[ndx].get_addr());
+                blocks[ndx] = blocks.back();
+                blocks.pop_back();
+            }
+        }
+        blocks.clear();
+        alloc.reset_free_space_tracking();
+    }
+    report(name, start, num_rounds * num_blocks * 3 / 2);
+}
+
+void bench_create_objects()
+{
+    const size_t num_objects = 1000000;
+    TestPathGuard guard("benchmark-alloc.realm");
+    DBRef db = DB::create(std::string(guard));
+    auto start = Clock::now();
+    {
+        WriteTransaction wt(db);
+        auto table = wt.add_table("table");
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_str = table->add_column(type_String, "str");
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object().set(col_int, int64_t(i)).set(col_str, "abc");
+        wt.commit();
+    }
+    report("Table::create_object", start, num_objects);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    bench_slab_alloc("SlabAlloc small blocks", 16, 256);
+    bench_slab_alloc("SlabAlloc mixed blocks", 16, 4096);
+    bench_create_objects();
+}
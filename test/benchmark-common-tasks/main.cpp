@@ -18,9 +18,11 @@
 
 #include <iostream>
 #include <iomanip>
+#include <numeric>
 #include <set>
 #include <sstream>
 #include <set>
+#include <thread>
 
 #include <realm.hpp>
 #include <realm/query_expression.hpp> // only needed to compile on v2.6.0
@@ -70,6 +72,9 @@ const double min_warmup_time_s = 0.1;
 const char* to_lead_cstr(RealmDurability level);
 const char* to_ident_cstr(RealmDurability level);
 
+// Only run the benchmarks whose names contain this, if set
+std::string benchmark_filter;
+
 #ifdef REALM_CLUSTER_IF
 #define KEY(x) ObjKey(x)
 #else
@@ -724,6 +729,71 @@ struct BenchmarkQueryTimestampEqualNull : BenchmarkWithTimestamps {
     }
 };
 
+struct BenchmarkWithDecimals : Benchmark {
+    constexpr static size_t num_rows = BASE_SIZE * 5;
+    Decimal128 needle{"5000.00"};
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.add_table(name());
+        m_col = t->add_column(type_Decimal, "amounts");
+        // Amounts of money with two decimals, like most decimals in practice
+        Random r;
+        for (size_t i = 0; i < num_rows; ++i) {
+            Decimal128 amount(Decimal128::Bid128{{uint64_t(r.draw_int<int64_t>(0, 1000000)), 0}}, -2, false);
+            t->create_object().set(m_col, amount);
+        }
+        tr.commit();
+    }
+
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+    }
+};
+
+struct BenchmarkSumDecimal : BenchmarkWithDecimals {
+    const char* name() const
+    {
+        return "SumDecimal";
+    }
+
+    void operator()(DBRef)
+    {
+        Decimal128 sum = m_table->sum_decimal(m_col);
+        REALM_ASSERT(sum > Decimal128(0));
+    }
+};
+
+struct BenchmarkMinMaxDecimal : BenchmarkWithDecimals {
+    const char* name() const
+    {
+        return "MinMaxDecimal";
+    }
+
+    void operator()(DBRef)
+    {
+        Decimal128 min = m_table->minimum_decimal(m_col);
+        Decimal128 max = m_table->maximum_decimal(m_col);
+        REALM_ASSERT(min <= max);
+    }
+};
+
+struct BenchmarkQueryDecimalGreater : BenchmarkWithDecimals {
+    const char* name() const
+    {
+        return "QueryDecimalGreater";
+    }
+
+    void operator()(DBRef)
+    {
+        size_t count = m_table->where().greater(m_col, needle).count();
+        REALM_ASSERT(count > 0 && count < num_rows);
+    }
+};
+
 struct BenchmarkWithIntsTable : Benchmark {
     void before_all(DBRef group)
     {
@@ -980,6 +1050,114 @@ struct BenchmarkWithIntUIDsRandomOrderRandomCreate : BenchmarkWithIntUIDsRandomO
     }
 };
 
+// Compare the cost of scans, inserts and lookups with different node sizes
+// for the cluster tree of a table and the B+trees of its lists.
+template <size_t node_size>
+struct BenchmarkWithNodeSize : Benchmark {
+    ColKey m_col_list;
+
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.add_table(name());
+        t->set_node_sizes(node_size, node_size);
+        m_col = t->add_column(type_Int, "ints");
+        m_col_list = t->add_column_list(type_Int, "list");
+
+        std::vector<int64_t> keys(BASE_SIZE);
+        std::iota(keys.begin(), keys.end(), 0);
+        Random r;
+        r.shuffle(keys.begin(), keys.end());
+        for (auto k : keys) {
+            m_keys.push_back(ObjKey(k * 2));
+            t->create_object(m_keys.back()).set<Int>(m_col, k);
+        }
+        tr.commit();
+    }
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+        Benchmark::after_all(group);
+    }
+};
+
+template <size_t node_size>
+struct BenchmarkNodeSizeScan : BenchmarkWithNodeSize<node_size> {
+    const char* name() const
+    {
+        switch (node_size) {
+            case 16:
+                return "NodeSizeScan16";
+            case 256:
+                return "NodeSizeScan256";
+            case 4096:
+                return "NodeSizeScan4096";
+        }
+        return "NodeSizeScan";
+    }
+    void operator()(DBRef)
+    {
+        ConstTableRef t = this->m_table;
+        int64_t sum = t->sum_int(this->m_col);
+        REALM_ASSERT_3(sum, ==, int64_t(BASE_SIZE) * (BASE_SIZE - 1) / 2);
+    }
+};
+
+template <size_t node_size>
+struct BenchmarkNodeSizeRandomLookup : BenchmarkWithNodeSize<node_size> {
+    const char* name() const
+    {
+        switch (node_size) {
+            case 16:
+                return "NodeSizeRandomLookup16";
+            case 256:
+                return "NodeSizeRandomLookup256";
+            case 4096:
+                return "NodeSizeRandomLookup4096";
+        }
+        return "NodeSizeRandomLookup";
+    }
+    void operator()(DBRef)
+    {
+        ConstTableRef t = this->m_table;
+        for (auto key : this->m_keys) {
+            REALM_ASSERT_3(t->get_object(key).template get<Int>(this->m_col), ==, key.value / 2);
+        }
+    }
+};
+
+template <size_t node_size>
+struct BenchmarkNodeSizeInsert : BenchmarkWithNodeSize<node_size> {
+    const char* name() const
+    {
+        switch (node_size) {
+            case 16:
+                return "NodeSizeInsert16";
+            case 256:
+                return "NodeSizeInsert256";
+            case 4096:
+                return "NodeSizeInsert4096";
+        }
+        return "NodeSizeInsert";
+    }
+    void operator()(DBRef)
+    {
+        TableRef t = this->m_table;
+        // Fill the gaps between the existing keys in random order
+        for (size_t i = 0; i < 10000; ++i) {
+            t->create_object(ObjKey(this->m_keys[i].value + 1)).template set<Int>(this->m_col, i);
+        }
+        // Insert into the middle of a list
+        auto list = t->get_object(this->m_keys[0]).template get_list<Int>(this->m_col_list);
+        for (size_t i = 0; i < 10000; ++i) {
+            list.insert(list.size() / 2, i);
+        }
+        // abort transaction
+    }
+};
+
 struct BenchmarkQueryChainedOrInts : BenchmarkWithIntsTable {
     const size_t num_queried_matches = 1000;
     const size_t num_rows = BASE_SIZE;
@@ -1208,6 +1386,44 @@ struct BenchmarkEmptyCommit : Benchmark {
     }
 };
 
+// Begin and end a fixed number of read transactions spread over a number of threads
+// sharing one DB, to measure how the read lock bookkeeping scales with contention.
+template <int num_threads>
+struct BenchmarkConcurrentReadTransactions : Benchmark {
+    const char* name() const
+    {
+        switch (num_threads) {
+            case 1:
+                return "ConcurrentReadTransactions1";
+            case 4:
+                return "ConcurrentReadTransactions4";
+            case 16:
+                return "ConcurrentReadTransactions16";
+            case 64:
+                return "ConcurrentReadTransactions64";
+        }
+        return "ConcurrentReadTransactions";
+    }
+    void before_all(DBRef) {}
+    void after_all(DBRef) {}
+    void before_each(DBRef) {}
+    void after_each(DBRef) {}
+    void operator()(DBRef group)
+    {
+        const size_t num_transactions = 64 * 1024;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&] {
+                for (size_t j = 0; j < num_transactions / num_threads; ++j) {
+                    RdTrans tr(group);
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+};
+
 struct BenchmarkSortInt : BenchmarkWithInts {
     const char* name() const
     {
@@ -1756,6 +1972,83 @@ struct BenchmarkInitiatorOpen : public BenchmarkNonInitiatorOpen {
     }
 };
 
+// Write the whole group to a new file, which is what DB::write_copy() and
+// DB::compact() spend their time on. With encryption on, the output is
+// written through the encryption layer one buffer at a time.
+struct BenchmarkWriteCopy : BenchmarkWithStrings {
+    const char* name() const
+    {
+        return "WriteCopy";
+    }
+    std::unique_ptr<realm::test_util::DBTestPathGuard> path;
+
+    void before_all(DBRef group)
+    {
+        BenchmarkWithStrings::before_all(group);
+        std::string ident = util::format("BenchmarkCommonTasks_%1_%2", name(), to_ident_cstr(m_durability));
+        path = std::make_unique<DBTestPathGuard>(get_test_path(ident, ".realm"));
+    }
+    void before_each(DBRef) {}
+    void after_each(DBRef)
+    {
+        File::try_remove(*path);
+    }
+    void operator()(DBRef group)
+    {
+        RdTrans tr(group);
+        tr.get_group().write(*path, m_encryption_key);
+    }
+};
+
+struct BenchmarkCompact : BenchmarkWithStrings {
+    const char* name() const
+    {
+        return "Compact";
+    }
+    void before_each(DBRef) {}
+    void after_each(DBRef) {}
+    void operator()(DBRef group)
+    {
+        group->compact();
+    }
+};
+
+#ifdef REALM_CLUSTER_IF
+// Advance a read transaction over a commit which changed a few objects, which is
+// what the notifiers do to compute the changes to report.
+struct BenchmarkAdvanceRead : BenchmarkWithInts {
+    const char* name() const
+    {
+        return "AdvanceRead";
+    }
+    TransactionRef m_reader;
+
+    void before_all(DBRef group)
+    {
+        BenchmarkWithInts::before_all(group);
+        m_reader = group->start_read();
+    }
+    void after_all(DBRef group)
+    {
+        m_reader = nullptr;
+        BenchmarkWithInts::after_all(group);
+    }
+    void before_each(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.get_table(name());
+        for (size_t i = 0; i < 1000; ++i)
+            t->get_object(m_keys[(i * 197) % m_keys.size()]).set(m_col, int64_t(i));
+        tr.commit();
+    }
+    void after_each(DBRef) {}
+    void operator()(DBRef)
+    {
+        m_reader->advance_read();
+    }
+};
+#endif
+
 struct IterateTableByIterator : Benchmark {
     const char* name() const override
     {
@@ -1985,6 +2278,9 @@ void run_benchmark_once(Benchmark& benchmark, DBRef sg, Timer& timer)
 template <typename B>
 void run_benchmark(BenchmarkResults& results, bool force_full = false)
 {
+    if (!benchmark_filter.empty() && std::string(B().name()).find(benchmark_filter) == std::string::npos)
+        return;
+
     typedef std::pair<RealmDurability, const char*> config_pair;
     std::vector<config_pair> configs;
 
@@ -2074,13 +2370,26 @@ int benchmark_common_tasks_main()
     results_file_stem += "results";
     BenchmarkResults results(40, "benchmark-common-tasks", results_file_stem.c_str());
 
+    if (const char* filter = getenv("REALM_BENCHMARK_FILTER"))
+        benchmark_filter = filter;
+    const char* fail_on_regression = getenv("REALM_BENCHMARK_FAIL_ON_REGRESSION");
+
 #define BENCH(B) run_benchmark<B>(results)
 #define BENCH2(B, mode) run_benchmark<B>(results, mode)
 
     BENCH2(BenchmarkEmptyCommit, true);
     BENCH2(BenchmarkEmptyCommit, false);
+    BENCH(BenchmarkConcurrentReadTransactions<1>);
+    BENCH(BenchmarkConcurrentReadTransactions<4>);
+    BENCH(BenchmarkConcurrentReadTransactions<16>);
+    BENCH(BenchmarkConcurrentReadTransactions<64>);
     BENCH2(BenchmarkNonInitiatorOpen, true);
     BENCH2(BenchmarkInitiatorOpen, true);
+    BENCH2(BenchmarkWriteCopy, true);
+    BENCH2(BenchmarkCompact, true);
+#ifdef REALM_CLUSTER_IF
+    BENCH(BenchmarkAdvanceRead);
+#endif
     BENCH2(AddTable, true);
     BENCH2(AddTable, false);
 
@@ -2140,14 +2449,33 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkQueryTimestampNotNull);
     BENCH(BenchmarkQueryTimestampEqualNull);
     BENCH(BenchmarkQueryIntListSize);
+    BENCH(BenchmarkSumDecimal);
+    BENCH(BenchmarkMinMaxDecimal);
+    BENCH(BenchmarkQueryDecimalGreater);
 
     BENCH(BenchmarkWithIntUIDsRandomOrderSeqAccess);
     BENCH(BenchmarkWithIntUIDsRandomOrderRandomAccess);
     BENCH(BenchmarkWithIntUIDsRandomOrderRandomDelete);
     BENCH(BenchmarkWithIntUIDsRandomOrderRandomCreate);
 
+    BENCH(BenchmarkNodeSizeScan<16>);
+    BENCH(BenchmarkNodeSizeScan<256>);
+    BENCH(BenchmarkNodeSizeScan<4096>);
+    BENCH(BenchmarkNodeSizeRandomLookup<16>);
+    BENCH(BenchmarkNodeSizeRandomLookup<256>);
+    BENCH(BenchmarkNodeSizeRandomLookup<4096>);
+    BENCH(BenchmarkNodeSizeInsert<16>);
+    BENCH(BenchmarkNodeSizeInsert<256>);
+    BENCH(BenchmarkNodeSizeInsert<4096>);
+
 #undef BENCH
 #undef BENCH2
+
+    if (size_t num_regressions = results.get_num_regressions()) {
+        std::cout << num_regressions << " benchmark(s) are significantly slower than the baseline" << std::endl;
+        if (fail_on_regression && std::string(fail_on_regression) != "0")
+            return 1;
+    }
     return 0;
 }
 
@@ -2164,6 +2492,15 @@ int main(int argc, const char** argv)
                       << "  -h, --help      display this help" << std::endl
                       << "  PATH            alternate path to store the results files;" << std::endl
                       << "                  this path should end with a slash." << std::endl
+                      << std::endl
+                      << "Results are compared to PATH/results.baseline, which is the first run" << std::endl
+                      << "unless replaced. PATH/results.latest.json holds the results in JSON." << std::endl
+                      << std::endl
+                      << "Environment:" << std::endl
+                      << "  REALM_BENCHMARK_FILTER              only run the benchmarks whose names" << std::endl
+                      << "                                      contain this" << std::endl
+                      << "  REALM_BENCHMARK_FAIL_ON_REGRESSION  exit with 1 if a benchmark is" << std::endl
+                      << "                                      significantly slower than the baseline" << std::endl
                       << std::endl;
             return 1;
         }
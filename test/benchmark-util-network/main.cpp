@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <thread>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include <realm/util/network.hpp>
 
@@ -120,9 +122,9 @@ private:
     void initiate_read()
     {
         auto handler = [=](std::error_code ec, size_t) {
-            if (ec && ec != network::end_of_input)
+            if (ec && ec != MiscExtErrors::end_of_input)
                 throw std::system_error(ec);
-            if (ec != network::end_of_input)
+            if (ec != MiscExtErrors::end_of_input)
                 initiate_read();
         };
         m_read_socket.async_read(m_read_buffer, m_read_size, m_read_ahead_buffer, handler);
@@ -177,9 +179,9 @@ private:
     void initiate_read()
     {
         auto handler = [=](std::error_code ec, size_t) {
-            if (ec && ec != network::end_of_input)
+            if (ec && ec != MiscExtErrors::end_of_input)
                 throw std::system_error(ec);
-            if (ec != network::end_of_input)
+            if (ec != MiscExtErrors::end_of_input)
                 initiate_read();
         };
         m_read_socket.async_read(m_read_buffer, sizeof m_read_buffer, m_read_ahead_buffer, handler);
@@ -201,13 +203,130 @@ private:
     }
 };
 
+
+// Round trips of small messages over many connections at once, which is where
+// the cost of waiting for readiness grows with the number of sockets.
+class PingPong {
+public:
+    PingPong(size_t num_connections, size_t num_round_trips)
+    {
+        for (size_t i = 0; i < num_connections; ++i) {
+            m_connections.push_back(std::make_unique<Connection>(m_service, num_round_trips));
+            connect_sockets(m_connections.back()->server_socket, m_connections.back()->client_socket);
+        }
+    }
+
+    void run()
+    {
+        for (auto& conn : m_connections) {
+            initiate_echo(*conn);
+            initiate_ping(*conn);
+        }
+        m_service.run();
+    }
+
+private:
+    struct Connection {
+        network::Socket server_socket, client_socket;
+        network::ReadAheadBuffer server_read_ahead_buffer, client_read_ahead_buffer;
+        char server_buffer[1], client_buffer[1] = {0};
+        size_t num_round_trips;
+
+        Connection(network::Service& service, size_t n)
+            : server_socket{service}
+            , client_socket{service}
+            , num_round_trips{n}
+        {
+        }
+    };
+
+    network::Service m_service;
+    std::vector<std::unique_ptr<Connection>> m_connections;
+
+    void initiate_echo(Connection& conn)
+    {
+        auto handler = [this, &conn](std::error_code ec, size_t) {
+            if (ec == MiscExtErrors::end_of_input)
+                return;
+            if (ec)
+                throw std::system_error(ec);
+            conn.server_socket.async_write(conn.server_buffer, 1, [this, &conn](std::error_code ec, size_t) {
+                if (ec)
+                    throw std::system_error(ec);
+                initiate_echo(conn);
+            });
+        };
+        conn.server_socket.async_read(conn.server_buffer, 1, conn.server_read_ahead_buffer, handler);
+    }
+
+    void initiate_ping(Connection& conn)
+    {
+        if (conn.num_round_trips == 0) {
+            conn.client_socket.close();
+            return;
+        }
+        --conn.num_round_trips;
+        conn.client_socket.async_write(conn.client_buffer, 1, [this, &conn](std::error_code ec, size_t) {
+            if (ec)
+                throw std::system_error(ec);
+            auto handler = [this, &conn](std::error_code ec, size_t) {
+                if (ec)
+                    throw std::system_error(ec);
+                initiate_ping(conn);
+            };
+            conn.client_socket.async_read(conn.client_buffer, 1, conn.client_read_ahead_buffer, handler);
+        });
+    }
+};
+
+// Many pending timer waits with random deadlines that are canceled in random
+// order, which exercises insertion into, and removal from the middle of, the
+// queue of pending wait operations.
+class Timers {
+public:
+    Timers(size_t num_timers, size_t num_rounds)
+        : m_num_rounds(num_rounds)
+    {
+        for (size_t i = 0; i < num_timers; ++i)
+            m_timers.push_back(std::make_unique<network::DeadlineTimer>(m_service));
+    }
+
+    void run()
+    {
+        Random random{random_int<unsigned long>()}; // Seed from slow global generator
+        std::vector<size_t> order(m_timers.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        for (size_t i = 0; i < m_num_rounds; ++i) {
+            for (auto& timer : m_timers) {
+                auto handler = [](std::error_code ec) {
+                    if (ec != error::operation_aborted)
+                        throw std::runtime_error("Unexpected expiration");
+                };
+                // Far enough into the future that no wait can expire
+                std::chrono::seconds delay{3600 + random.draw_int(0, 3600)};
+                timer->async_wait(delay, std::move(handler));
+            }
+            random.shuffle(order.begin(), order.end());
+            for (size_t j : order)
+                m_timers[j]->cancel();
+            m_service.run();
+        }
+    }
+
+private:
+    network::Service m_service;
+    std::vector<std::unique_ptr<network::DeadlineTimer>> m_timers;
+    const size_t m_num_rounds;
+};
+
 } // unnamed namespace
 
 
 int main()
 {
-    int max_lead_text_size = 12;
-    BenchmarkResults results(max_lead_text_size);
+    int max_lead_text_size = 13;
+    BenchmarkResults results(max_lead_text_size, "benchmark-util-network");
 
     Timer timer(Timer::type_UserTime);
     {
@@ -217,7 +336,7 @@ int main()
             task.run();
             results.submit("post", timer);
         }
-        results.finish("post", "Post");
+        results.finish("post", "Post", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(1, 11500000); // (size, num)
@@ -225,7 +344,7 @@ int main()
             task.run();
             results.submit("read_1", timer);
         }
-        results.finish("read_1", "Read 1");
+        results.finish("read_1", "Read 1", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(10, 9000000); // (size, num)
@@ -233,7 +352,7 @@ int main()
             task.run();
             results.submit("read_10", timer);
         }
-        results.finish("read_10", "Read 10");
+        results.finish("read_10", "Read 10", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(100, 2700000); // (size, num)
@@ -241,7 +360,7 @@ int main()
             task.run();
             results.submit("read_100", timer);
         }
-        results.finish("read_100", "Read 100");
+        results.finish("read_100", "Read 100", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(1000, 350000); // (size, num)
@@ -249,7 +368,7 @@ int main()
             task.run();
             results.submit("read_1000", timer);
         }
-        results.finish("read_1000", "Read 1000");
+        results.finish("read_1000", "Read 1000", "runtime_secs");
 
 
         for (int i = 0; i != 100; ++i) {
@@ -258,7 +377,7 @@ int main()
             task.run();
             results.submit("write_1", timer);
         }
-        results.finish("write_1", "Write 1");
+        results.finish("write_1", "Write 1", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(10, 100000); // (size, num)
@@ -266,7 +385,7 @@ int main()
             task.run();
             results.submit("write_10", timer);
         }
-        results.finish("write_10", "Write 10");
+        results.finish("write_10", "Write 10", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(100, 100000); // (size, num)
@@ -274,7 +393,7 @@ int main()
             task.run();
             results.submit("write_100", timer);
         }
-        results.finish("write_100", "Write 100");
+        results.finish("write_100", "Write 100", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(1000, 100000); // (size, num)
@@ -282,6 +401,33 @@ int main()
             task.run();
             results.submit("write_1000", timer);
         }
-        results.finish("write_1000", "Write 1000");
+        results.finish("write_1000", "Write 1000", "runtime_secs");
+
+        for (int i = 0; i != 100; ++i) {
+            Timers task(10000, 20); // (timers, rounds)
+            timer.reset();
+            task.run();
+            results.submit("timers", timer);
+        }
+        results.finish("timers", "Timers", "runtime_secs");
+    }
+
+    Timer real_timer(Timer::type_RealTime);
+    {
+        for (int i = 0; i != 10; ++i) {
+            PingPong task(1, 20000); // (connections, round trips)
+            real_timer.reset();
+            task.run();
+            results.submit("ping_pong_1", real_timer);
+        }
+        results.finish("ping_pong_1", "Ping pong 1", "runtime_secs");
+
+        for (int i = 0; i != 10; ++i) {
+            PingPong task(200, 100); // (connections, round trips)
+            real_timer.reset();
+            task.run();
+            results.submit("ping_pong_200", real_timer);
+        }
+        results.finish("ping_pong_200", "Ping pong 200", "runtime_secs");
     }
 }
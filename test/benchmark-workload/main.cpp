@@ -0,0 +1,640 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+// A macrobenchmark of a DB shared by many threads, modelled on how the SDKs
+// use it: readers holding on to snapshots while querying them, a few writers,
+// async writes, threads waiting for changes like the notifiers do, and
+// snapshots pinned for a long time. The workload is described by a JSON file,
+// see workloads/mixed.json. The throughput, the latencies and the growth of
+// the file are reported while running, and as JSON at the end.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <external/json/json.hpp>
+
+#include <realm.hpp>
+#include <realm/history.hpp>
+#include <realm/metrics/latency.hpp>
+#include <realm/util/file.hpp>
+
+#include "../util/test_path.hpp"
+
+using namespace realm;
+using nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+using metrics::LatencyHistogram;
+
+namespace {
+
+struct Workload {
+    double duration_secs = 60;
+    double report_interval_secs = 5;
+    bool durable = true;
+    size_t initial_objects = 100'000;
+    size_t payload_size = 64;
+    // 0 means uniform, otherwise the exponent of a Zipfian distribution
+    double zipf_exponent = 0;
+
+    struct Readers {
+        size_t threads = 4;
+        // How long a reader keeps querying one snapshot before advancing
+        double snapshot_ms = 100;
+        double lookup = 1;
+        double range = 0;
+        double count = 0;
+        double scan = 0;
+        size_t range_size = 100;
+    } readers;
+
+    struct Writers {
+        size_t threads = 1;
+        size_t objects_per_transaction = 10;
+        double update = 1;
+        double insert = 0;
+        double remove = 0;
+        double pause_ms = 0;
+        // Commit without syncing, and sync every `async_batch` commits
+        bool async = false;
+        size_t async_batch = 10;
+    } writers;
+
+    // Threads which wait for changes and advance to them
+    size_t notifiers = 1;
+
+    // Snapshots which are held for `hold_secs` before being refreshed, which
+    // keeps the versions between alive
+    size_t pinned_snapshots = 0;
+    double pinned_hold_secs = 10;
+};
+
+clock_type::duration to_duration(double secs)
+{
+    return std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(secs));
+}
+
+template <class T>
+void get_to(const json& j, const char* key, T& value)
+{
+    if (j.contains(key))
+        value = j.at(key).get<T>();
+}
+
+Workload parse_workload(const json& j)
+{
+    Workload w;
+    get_to(j, "duration_secs", w.duration_secs);
+    get_to(j, "report_interval_secs", w.report_interval_secs);
+    get_to(j, "durable", w.durable);
+    get_to(j, "initial_objects", w.initial_objects);
+    get_to(j, "payload_size", w.payload_size);
+    if (j.contains("key_distribution")) {
+        auto& dist = j.at("key_distribution");
+        auto type = dist.value("type", "uniform");
+        if (type == "zipf") {
+            w.zipf_exponent = dist.value("exponent", 0.99);
+            if (w.zipf_exponent <= 0 || w.zipf_exponent >= 1)
+                throw std::runtime_error("The Zipf exponent must be between 0 and 1");
+        }
+        else if (type != "uniform")
+            throw std::runtime_error("Unknown key distribution: " + type);
+    }
+    if (j.contains("readers")) {
+        auto& r = j.at("readers");
+        get_to(r, "threads", w.readers.threads);
+        get_to(r, "snapshot_ms", w.readers.snapshot_ms);
+        get_to(r, "range_size", w.readers.range_size);
+        if (r.contains("query_mix")) {
+            auto& mix = r.at("query_mix");
+            w.readers.lookup = mix.value("lookup", 0.0);
+            w.readers.range = mix.value("range", 0.0);
+            w.readers.count = mix.value("count", 0.0);
+            w.readers.scan = mix.value("scan", 0.0);
+        }
+    }
+    if (j.contains("writers")) {
+        auto& wr = j.at("writers");
+        get_to(wr, "threads", w.writers.threads);
+        get_to(wr, "objects_per_transaction", w.writers.objects_per_transaction);
+        get_to(wr, "pause_ms", w.writers.pause_ms);
+        get_to(wr, "async", w.writers.async);
+        get_to(wr, "async_batch", w.writers.async_batch);
+        if (wr.contains("mix")) {
+            auto& mix = wr.at("mix");
+            w.writers.update = mix.value("update", 0.0);
+            w.writers.insert = mix.value("insert", 0.0);
+            w.writers.remove = mix.value("remove", 0.0);
+        }
+    }
+    get_to(j, "notifiers", w.notifiers);
+    if (j.contains("pinned_snapshots")) {
+        auto& p = j.at("pinned_snapshots");
+        get_to(p, "count", w.pinned_snapshots);
+        get_to(p, "hold_secs", w.pinned_hold_secs);
+    }
+    if (w.writers.async_batch == 0)
+        w.writers.async_batch = 1;
+    return w;
+}
+
+// Draws keys in [0, n) either uniformly or from a Zipfian distribution, using
+// the method of Gray et al., "Quickly generating billion-record synthetic
+// databases", where key 0 is the most popular.
+class KeyGenerator {
+public:
+    KeyGenerator(size_t n, double exponent)
+        : m_n(std::max<size_t>(n, 1))
+        , m_theta(exponent)
+    {
+        if (m_theta == 0)
+            return;
+        m_zeta_n = zeta(m_n);
+        double zeta_2 = zeta(2);
+        m_alpha = 1 / (1 - m_theta);
+        m_eta = (1 - std::pow(2.0 / double(m_n), 1 - m_theta)) / (1 - zeta_2 / m_zeta_n);
+    }
+
+    template <class Engine>
+    size_t operator()(Engine& engine) const
+    {
+        if (m_theta == 0)
+            return std::uniform_int_distribution<size_t>(0, m_n - 1)(engine);
+        double u = std::uniform_real_distribution<double>(0, 1)(engine);
+        double uz = u * m_zeta_n;
+        if (uz < 1)
+            return 0;
+        if (uz < 1 + std::pow(0.5, m_theta))
+            return std::min<size_t>(1, m_n - 1);
+        auto key = size_t(double(m_n) * std::pow(m_eta * u - m_eta + 1, m_alpha));
+        return std::min(key, m_n - 1);
+    }
+
+private:
+    size_t m_n;
+    double m_theta;
+    double m_zeta_n = 0;
+    double m_alpha = 0;
+    double m_eta = 0;
+
+    double zeta(size_t n) const
+    {
+        double sum = 0;
+        for (size_t i = 1; i <= n; ++i)
+            sum += 1 / std::pow(double(i), m_theta);
+        return sum;
+    }
+};
+
+enum Operation { op_begin_read, op_lookup, op_range, op_count, op_scan, op_commit, op_sync, op_notify, num_ops };
+
+const char* operation_names[num_ops] = {"begin_read", "lookup", "range", "count",
+                                        "scan",       "commit", "sync",  "notify"};
+
+// The counts are read by the reporter while running, the histograms only at
+// the end
+struct ThreadStats {
+    std::array<std::atomic<uint64_t>, num_ops> counts = {};
+    std::array<LatencyHistogram, num_ops> latencies;
+
+    void record(Operation op, clock_type::time_point start, clock_type::time_point end = clock_type::now())
+    {
+        auto ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        auto& h = latencies[op];
+        ++h.buckets[LatencyHistogram::get_bucket(ns)];
+        ++h.count;
+        h.total_nanoseconds += ns;
+        h.max_nanoseconds = std::max(h.max_nanoseconds, ns);
+        counts[op].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+class Runner {
+public:
+    Runner(const Workload& workload, std::string path)
+        : m_workload(workload)
+        , m_path(std::move(path))
+        , m_keys(workload.initial_objects, workload.zipf_exponent)
+    {
+        DBOptions options;
+        options.durability = workload.durable ? DBOptions::Durability::Full : DBOptions::Durability::MemOnly;
+        options.enable_async_writes = workload.writers.async;
+        m_db = DB::create(make_in_realm_history(), m_path, options);
+    }
+
+    json run();
+
+private:
+    const Workload& m_workload;
+    std::string m_path;
+    KeyGenerator m_keys;
+    DBRef m_db;
+    TableKey m_table;
+    ColKey m_col_value;
+    ColKey m_col_payload;
+    std::atomic<int64_t> m_next_key{0};
+    std::atomic<bool> m_stop{false};
+    std::vector<std::unique_ptr<ThreadStats>> m_stats;
+
+    // The time at which recent versions were committed, to measure how long it
+    // takes until a notifier sees them
+    static constexpr size_t num_commit_times = 1024;
+    struct CommitTime {
+        std::atomic<uint64_t> version{0};
+        std::atomic<int64_t> ns{0};
+    };
+    std::array<CommitTime, num_commit_times> m_commit_times;
+
+    void populate();
+    void record_commit(DB::version_type version);
+    void reader(ThreadStats& stats, unsigned seed);
+    void writer(ThreadStats& stats, unsigned seed);
+    void notifier(ThreadStats& stats);
+    void pinner();
+    bool sleep_unless_stopped(double secs);
+};
+
+void Runner::populate()
+{
+    auto wt = m_db->start_write();
+    auto table = wt->add_table("Item");
+    m_col_value = table->add_column(type_Int, "value");
+    m_col_payload = table->add_column(type_String, "payload");
+    table->add_search_index(m_col_value);
+    m_table = table->get_key();
+
+    std::string payload(m_workload.payload_size, 'x');
+    for (size_t i = 0; i < m_workload.initial_objects; ++i) {
+        table->create_object(ObjKey(int64_t(i))).set(m_col_value, int64_t(i)).set(m_col_payload, payload);
+    }
+    m_next_key = int64_t(m_workload.initial_objects);
+    wt->commit();
+}
+
+void Runner::record_commit(DB::version_type version)
+{
+    auto& slot = m_commit_times[version % num_commit_times];
+    slot.ns.store(clock_type::now().time_since_epoch().count(), std::memory_order_relaxed);
+    slot.version.store(version, std::memory_order_release);
+}
+
+bool Runner::sleep_unless_stopped(double secs)
+{
+    auto until = clock_type::now() + to_duration(secs);
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        auto now = clock_type::now();
+        if (now >= until)
+            return true;
+        std::this_thread::sleep_for(std::min<clock_type::duration>(until - now, std::chrono::milliseconds(10)));
+    }
+    return false;
+}
+
+void Runner::reader(ThreadStats& stats, unsigned seed)
+{
+    std::mt19937_64 engine(seed);
+    const auto& r = m_workload.readers;
+    std::discrete_distribution<int> query_mix({r.lookup, r.range, r.count, r.scan});
+    auto snapshot_duration = std::chrono::duration<double, std::milli>(r.snapshot_ms);
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        auto start = clock_type::now();
+        auto rt = m_db->start_read();
+        stats.record(op_begin_read, start);
+        auto table = rt->get_table(m_table);
+        auto snapshot_end = clock_type::now() + snapshot_duration;
+
+        do {
+            int64_t key = int64_t(m_keys(engine));
+            start = clock_type::now();
+            switch (query_mix(engine)) {
+                case 0: {
+                    if (auto obj = table->try_get_object(ObjKey(key)))
+                        static_cast<void>(obj.get<StringData>(m_col_payload).size());
+                    stats.record(op_lookup, start);
+                    break;
+                }
+                case 1: {
+                    auto tv = table->where()
+                                  .greater_equal(m_col_value, key)
+                                  .less(m_col_value, key + int64_t(r.range_size))
+                                  .find_all();
+                    static_cast<void>(tv.size());
+                    stats.record(op_range, start);
+                    break;
+                }
+                case 2: {
+                    static_cast<void>(table->where().greater_equal(m_col_value, key).count());
+                    stats.record(op_count, start);
+                    break;
+                }
+                case 3: {
+                    int64_t sum = 0;
+                    for (auto& obj : *table)
+                        sum += obj.get<Int>(m_col_value);
+                    static_cast<void>(sum);
+                    stats.record(op_scan, start);
+                    break;
+                }
+            }
+        } while (clock_type::now() < snapshot_end && !m_stop.load(std::memory_order_relaxed));
+    }
+}
+
+void Runner::writer(ThreadStats& stats, unsigned seed)
+{
+    std::mt19937_64 engine(seed);
+    const auto& w = m_workload.writers;
+    std::discrete_distribution<int> write_mix({w.update, w.insert, w.remove});
+    std::string payload(m_workload.payload_size, 'y');
+
+    auto write = [&](Table& table) {
+        for (size_t i = 0; i < w.objects_per_transaction; ++i) {
+            ObjKey key(int64_t(m_keys(engine)));
+            switch (write_mix(engine)) {
+                case 0:
+                    if (auto obj = table.try_get_object(key))
+                        obj.set(m_col_value, int64_t(engine() >> 1));
+                    break;
+                case 1:
+                    table.create_object(ObjKey(m_next_key++)).set(m_col_value, key.value).set(m_col_payload, payload);
+                    break;
+                case 2:
+                    if (table.is_valid(key))
+                        table.remove_object(key);
+                    break;
+            }
+        }
+    };
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        if (!w.async) {
+            auto wt = m_db->start_write();
+            write(*wt->get_table(m_table));
+            auto start = clock_type::now();
+            auto version = wt->commit();
+            stats.record(op_commit, start);
+            record_commit(version);
+        }
+        else {
+            // Commit a batch without syncing, then sync it in the background
+            // like Realm::async_commit_transaction() does
+            auto tr = m_db->start_read();
+            tr->promote_to_write();
+            tr->promote_to_async();
+            for (size_t i = 0; i < w.async_batch && !m_stop.load(std::memory_order_relaxed); ++i) {
+                if (tr->get_transact_stage() != DB::transact_Writing)
+                    tr->promote_to_write();
+                write(*tr->get_table(m_table));
+                auto start = clock_type::now();
+                auto version = tr->commit_and_continue_as_read(false);
+                stats.record(op_commit, start);
+                record_commit(version.version);
+            }
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+            auto start = clock_type::now();
+            tr->async_complete_writes([&] {
+                std::lock_guard lock(mutex);
+                done = true;
+                cv.notify_one();
+            });
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] {
+                return done;
+            });
+            stats.record(op_sync, start);
+        }
+        if (w.pause_ms > 0)
+            sleep_unless_stopped(w.pause_ms / 1000);
+    }
+}
+
+void Runner::notifier(ThreadStats& stats)
+{
+    auto tr = m_db->start_read();
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        if (!m_db->wait_for_change(tr))
+            break;
+        tr->advance_read();
+        auto version = tr->get_version();
+        auto& slot = m_commit_times[version % num_commit_times];
+        if (slot.version.load(std::memory_order_acquire) == version) {
+            clock_type::time_point committed{clock_type::duration(slot.ns.load(std::memory_order_relaxed))};
+            stats.record(op_notify, committed);
+        }
+    }
+}
+
+void Runner::pinner()
+{
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        auto pinned = m_db->start_read();
+        sleep_unless_stopped(m_workload.pinned_hold_secs);
+    }
+}
+
+json Runner::run()
+{
+    populate();
+    auto initial_size = util::File::get_size_static(m_path);
+    std::cout << "Populated " << m_workload.initial_objects << " objects, file size " << initial_size << std::endl;
+
+    std::vector<std::thread> threads;
+    auto add_stats = [&] {
+        m_stats.push_back(std::make_unique<ThreadStats>());
+        return m_stats.back().get();
+    };
+    for (size_t i = 0; i < m_workload.readers.threads; ++i) {
+        threads.emplace_back(&Runner::reader, this, std::ref(*add_stats()), unsigned(i + 1));
+    }
+    for (size_t i = 0; i < m_workload.writers.threads; ++i) {
+        threads.emplace_back(&Runner::writer, this, std::ref(*add_stats()), unsigned(1000 + i));
+    }
+    for (size_t i = 0; i < m_workload.notifiers; ++i) {
+        threads.emplace_back(&Runner::notifier, this, std::ref(*add_stats()));
+    }
+    for (size_t i = 0; i < m_workload.pinned_snapshots; ++i) {
+        threads.emplace_back(&Runner::pinner, this);
+        // Stagger them so that a pinned version is always alive
+        std::this_thread::sleep_for(to_duration(m_workload.pinned_hold_secs / double(m_workload.pinned_snapshots)));
+    }
+
+    auto sum_counts = [&] {
+        std::array<uint64_t, num_ops> counts = {};
+        for (auto& stats : m_stats) {
+            for (size_t op = 0; op < num_ops; ++op)
+                counts[op] += stats->counts[op].load(std::memory_order_relaxed);
+        }
+        return counts;
+    };
+
+    auto timeline = json::array();
+    auto start = clock_type::now();
+    auto end = start + to_duration(m_workload.duration_secs);
+    auto previous_counts = sum_counts();
+    auto previous_time = start;
+    std::cout << std::setw(8) << "secs" << std::setw(12) << "reads/s" << std::setw(12) << "commits/s"
+              << std::setw(14) << "file size" << std::setw(10) << "versions" << std::endl;
+    while (clock_type::now() < end) {
+        std::this_thread::sleep_for(std::min(end - clock_type::now(), to_duration(m_workload.report_interval_secs)));
+        auto now = clock_type::now();
+        auto counts = sum_counts();
+        double interval = std::chrono::duration<double>(now - previous_time).count();
+        uint64_t queries = 0;
+        for (auto op : {op_lookup, op_range, op_count, op_scan})
+            queries += counts[op] - previous_counts[op];
+        uint64_t commits = counts[op_commit] - previous_counts[op_commit];
+        auto file_size = util::File::get_size_static(m_path);
+        auto versions = m_db->get_number_of_versions();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << elapsed << std::setw(12)
+                  << double(queries) / interval << std::setw(12) << double(commits) / interval << std::setw(14)
+                  << file_size << std::setw(10) << versions << std::endl;
+        timeline.push_back(json{{"secs", elapsed},
+                                {"queries_per_sec", double(queries) / interval},
+                                {"commits_per_sec", double(commits) / interval},
+                                {"file_size", file_size},
+                                {"versions", versions}});
+        previous_counts = counts;
+        previous_time = now;
+    }
+
+    m_stop = true;
+    m_db->wait_for_change_release();
+    for (auto& thread : threads)
+        thread.join();
+    double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    auto operations = json::object();
+    std::cout << std::endl
+              << std::setw(12) << "operation" << std::setw(12) << "count" << std::setw(12) << "per sec"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us"
+              << std::setw(12) << "max us" << std::endl;
+    for (size_t op = 0; op < num_ops; ++op) {
+        LatencyHistogram total;
+        for (auto& stats : m_stats) {
+            auto& h = stats->latencies[op];
+            total.count += h.count;
+            total.total_nanoseconds += h.total_nanoseconds;
+            total.max_nanoseconds = std::max(total.max_nanoseconds, h.max_nanoseconds);
+            for (size_t i = 0; i < LatencyHistogram::num_buckets; ++i)
+                total.buckets[i] += h.buckets[i];
+        }
+        if (total.count == 0)
+            continue;
+        auto us = [](uint64_t ns) {
+            return double(ns) / 1000;
+        };
+        std::cout << std::setw(12) << operation_names[op] << std::setw(12) << total.count << std::setw(12)
+                  << double(total.count) / elapsed << std::setw(12) << us(total.get_percentile(50))
+                  << std::setw(12) << us(total.get_percentile(99)) << std::setw(12)
+                  << us(total.get_percentile(99.9)) << std::setw(12) << us(total.max_nanoseconds) << std::endl;
+        operations[operation_names[op]] = json{{"count", total.count},
+                                               {"per_sec", double(total.count) / elapsed},
+                                               {"avg_ns", total.total_nanoseconds / total.count},
+                                               {"p50_ns", total.get_percentile(50)},
+                                               {"p90_ns", total.get_percentile(90)},
+                                               {"p99_ns", total.get_percentile(99)},
+                                               {"p999_ns", total.get_percentile(99.9)},
+                                               {"max_ns", total.max_nanoseconds}};
+    }
+
+    return json{{"duration_secs", elapsed},
+                {"initial_file_size", initial_size},
+                {"final_file_size", util::File::get_size_static(m_path)},
+                {"operations", std::move(operations)},
+                {"timeline", std::move(timeline)}};
+}
+
+void usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--output FILE] [--path DIR] WORKLOAD\n"
+              << "Run the workload described by the JSON file WORKLOAD against a new Realm\n"
+              << "file, see workloads/mixed.json.\n"
+              << "\n"
+              << "  --output FILE  write the results as JSON to FILE\n"
+              << "  --path DIR     create the Realm file in DIR, which should end with a slash\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, const char* argv[])
+{
+    std::string output;
+    std::string workload_path;
+    std::string dir;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        }
+        else if (arg == "--path" && i + 1 < argc) {
+            dir = argv[++i];
+        }
+        else if (arg.empty() || arg[0] == '-' || !workload_path.empty()) {
+            usage(argv[0]);
+            return 1;
+        }
+        else {
+            workload_path = arg;
+        }
+    }
+    if (workload_path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    json workload_json;
+    Workload workload;
+    try {
+        std::ifstream in(workload_path);
+        if (!in)
+            throw std::runtime_error("Could not open " + workload_path);
+        in >> workload_json;
+        workload = parse_workload(workload_json);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Invalid workload: " << e.what() << std::endl;
+        return 1;
+    }
+
+    test_util::DBTestPathGuard path(dir + "benchmark-workload.realm");
+    json results;
+    {
+        Runner runner(workload, path);
+        results = runner.run();
+    }
+    results["workload"] = std::move(workload_json);
+
+    if (!output.empty()) {
+        std::ofstream out(output);
+        out << std::setw(2) << results << std::endl;
+    }
+    return 0;
+}
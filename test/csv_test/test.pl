@@ -1,19 +1,38 @@
-@files = <*.csv>;
-foreach $file (@files) {
-	unlink("out.realm");
-
-	print "\n\n\n\n***********************************************************\ntesting $file\n***********************************************************\n\n\n\n";
-
-
-    system("../../csv.exe", $file, "out.realm");
-	
-	if ( $? != 0 )
-	{
-		print "\n\n\n\n***********************************************************\n$file failed!\n***********************************************************\n\n\n\n\n\n";
-		die();
-	}
-	
-	
-}
-
-print "\n\n\n\n***********************************************************\nAll databases were successfully converted!\n\nHOWEVER, please manually verify that float, int, etc, columns are recognized correctly and not just converted to String type\n***********************************************************\n\n\n\n\n\n";
+# Usage: perl test.pl [importer binary] [threads]
+#
+# Imports every .csv file in this directory and reports the total import
+# throughput. Run it with different thread counts to compare.
+
+use Time::HiRes qw(time);
+
+$importer = $ARGV[0] || "../../csv.exe";
+$threads = $ARGV[1] || 1;
+
+@files = <*.csv>;
+$total_bytes = 0;
+$total_seconds = 0;
+foreach $file (@files) {
+	unlink("out.realm");
+
+	print "\n\n\n\n***********************************************************\ntesting $file\n***********************************************************\n\n\n\n";
+
+	$start = time();
+    system($importer, "-j=$threads", $file, "out.realm");
+	$total_seconds += time() - $start;
+	$total_bytes += -s $file;
+	
+	if ( $? != 0 )
+	{
+		print "\n\n\n\n***********************************************************\n$file failed!\n***********************************************************\n\n\n\n\n\n";
+		die();
+	}
+	
+	
+}
+
+unlink("out.realm");
+
+printf("\nImported %d files (%.1f MB) in %.3f seconds using %d threads: %.2f MB/s\n", scalar(@files),
+       $total_bytes / (1024 * 1024), $total_seconds, $threads, $total_bytes / (1024 * 1024) / $total_seconds);
+
+print "\n\n\n\n***********************************************************\nAll databases were successfully converted!\n\nHOWEVER, please manually verify that float, int, etc, columns are recognized correctly and not just converted to String type\n***********************************************************\n\n\n\n\n\n";
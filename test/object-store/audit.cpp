@@ -226,11 +226,12 @@ class CustomSerializer : public AuditObjectSerializer {
 public:
     const Obj* expected_obj = nullptr;
     bool error = false;
+    ObjKey error_obj;
     size_t completion_count = 0;
 
     void to_json(json& out, const Obj& obj) override
     {
-        if (error) {
+        if (error || obj.get_key() == error_obj) {
             throw std::runtime_error("custom serialization error");
         }
         if (expected_obj) {
@@ -484,6 +485,36 @@ TEST_CASE("audit object serialization") {
         audit->wait_for_completion();
     }
 
+    SECTION("serialization errors are only reported to the failing scope") {
+        realm->begin_transaction();
+        auto obj1 = table->create_object_with_primary_key(2);
+        auto obj2 = table->create_object_with_primary_key(3);
+        realm->commit_transaction();
+        serializer->error_obj = obj2.get_key();
+
+        // Scopes ended while the previous ones are still being processed are
+        // written together
+        std::exception_ptr errors[3];
+        for (size_t i = 0; i < 3; ++i) {
+            audit->begin_scope(util::format("scope %1", i));
+            Object(realm, i == 1 ? obj2 : obj1);
+            audit->end_scope([&errors, i](auto error) {
+                errors[i] = error;
+            });
+        }
+        audit->wait_for_completion();
+        REQUIRE_FALSE(errors[0]);
+        REQUIRE(errors[1]);
+        REQUIRE_THROWS_CONTAINING(std::rethrow_exception(errors[1]), "custom serialization error");
+        REQUIRE_FALSE(errors[2]);
+        REQUIRE(serializer->completion_count == 3);
+
+        auto events = get_audit_events(test_session);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].activity == "scope 0");
+        REQUIRE(events[1].activity == "scope 2");
+    }
+
     SECTION("write transaction serialization") {
         SECTION("create object") {
             audit->begin_scope("scope");
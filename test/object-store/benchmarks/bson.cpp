@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <realm/object-store/util/bson/bson.hpp>
+
+#include <catch2/catch_all.hpp>
+
+using namespace realm;
+
+TEST_CASE("Benchmark bson", "[benchmark]") {
+    // The shape of a large MongoCollection::find() response
+    std::string response = "[";
+    for (int i = 0; i < 10000; ++i) {
+        if (i != 0)
+            response += ",";
+        response += util::format("{\"_id\":{\"$oid\":\"57e193d7a9cc81b4027498b5\"},\"name\":\"document %1\","
+                                 "\"count\":{\"$numberInt\":\"%1\"},\"price\":{\"$numberDouble\":\"1.5\"},"
+                                 "\"created\":{\"$date\":{\"$numberLong\":\"1600000000000\"}},"
+                                 "\"tags\":[\"a\",\"b\",\"c\"],"
+                                 "\"nested\":{\"a\":{\"$numberLong\":\"1\"},\"b\":true,\"c\":null}}",
+                                 i);
+    }
+    response += "]";
+
+    BENCHMARK("parse find response")
+    {
+        return bson::parse(response);
+    };
+
+    auto documents = bson::parse(response);
+    BENCHMARK("serialize find response")
+    {
+        return documents.to_string();
+    };
+}
@@ -34,7 +34,10 @@
 #include <realm/query_engine.hpp>
 #include <realm/query_expression.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <vector>
 
 using namespace realm;
@@ -145,6 +148,57 @@ TEST_CASE("Benchmark index change calculations", "[benchmark]") {
         REQUIRE_INDICES(c.insertions, 0, 1);
         REQUIRE_INDICES(c.deletions, 1, 2);
     }
+
+    SECTION("reorderings of large collections") {
+        auto calc = [&](const ObjKeys& old_keys, const ObjKeys& new_keys) {
+            return _impl::CollectionChangeBuilder::calculate(old_keys, new_keys, none_modified, false);
+        };
+        constexpr int64_t size = 50000;
+        std::vector<int64_t> indices(size);
+        std::iota(indices.begin(), indices.end(), 0);
+        ObjKeys objkeys(indices);
+
+        std::vector<int64_t> reversed(indices.rbegin(), indices.rend());
+        ObjKeys reversed_keys(reversed);
+        BENCHMARK("reverse")
+        {
+            c = calc(objkeys, reversed_keys);
+        };
+        REQUIRE(c.insertions.count() == size - 1);
+
+        // Every other row moved to the end, as happens when re-sorting on a
+        // second property
+        std::vector<int64_t> interleaved;
+        interleaved.reserve(size);
+        for (int64_t i = 0; i < size; i += 2)
+            interleaved.push_back(i);
+        for (int64_t i = 1; i < size; i += 2)
+            interleaved.push_back(i);
+        ObjKeys interleaved_keys(interleaved);
+        BENCHMARK("interleave")
+        {
+            c = calc(objkeys, interleaved_keys);
+        };
+        REQUIRE(c.insertions.count() == size / 2 - 1);
+
+        std::vector<int64_t> shuffled = indices;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(0));
+        ObjKeys shuffled_keys(shuffled);
+        BENCHMARK("shuffle")
+        {
+            c = calc(objkeys, shuffled_keys);
+        };
+
+        std::vector<int64_t> swapped = indices;
+        std::mt19937 rng(0);
+        for (int64_t i = 0; i < size / 100; ++i)
+            std::swap(swapped[rng() % size], swapped[rng() % size]);
+        ObjKeys swapped_keys(swapped);
+        BENCHMARK("swap 1% of rows")
+        {
+            c = calc(objkeys, swapped_keys);
+        };
+    }
 }
 
 TEST_CASE("Benchmark object", "[benchmark]") {
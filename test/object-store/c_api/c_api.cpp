@@ -1387,6 +1387,13 @@ TEST_CASE("C API", "[c_api]") {
         CHECK(did_compact);
     }
 
+    SECTION("realm_release_memory()") {
+        CHECK(checked(realm_release_memory(realm, RLM_MEMORY_PRESSURE_MODERATE, nullptr)));
+        size_t released = 1;
+        CHECK(checked(realm_release_memory(realm, RLM_MEMORY_PRESSURE_CRITICAL, &released)));
+        CHECK(released == 0);
+    }
+
     SECTION("realm_get_class_keys()") {
         realm_class_key_t keys[2];
         // return total number of keys present, copy only if there is enough space in the vector passed in
@@ -1671,6 +1678,79 @@ TEST_CASE("C API", "[c_api]") {
             CHECK_ERR(RLM_ERR_INVALIDATED_OBJECT);
         }
 
+        SECTION("realm_get_values_for_objects()") {
+            realm_value_t values[4];
+
+            realm_object_key_t obj_keys[2] = {realm_object_get_key(obj1.get()), realm_object_get_key(obj1.get())};
+            realm_property_key_t keys1[2] = {foo_int_key, foo_str_key};
+            CHECK(checked(realm_get_values_for_objects(realm, class_foo.key, 2, obj_keys, 2, keys1, values)));
+
+            CHECK(values[0].type == RLM_TYPE_INT);
+            CHECK(values[1].type == RLM_TYPE_INT);
+            CHECK(values[2].type == RLM_TYPE_STRING);
+            CHECK(values[3].type == RLM_TYPE_STRING);
+
+            CHECK(values[0].integer == 123);
+            CHECK(values[1].integer == 123);
+            CHECK(strncmp(values[2].string.data, "Hello, World!", values[2].string.size) == 0);
+
+            realm_property_key_t keys2[2] = {foo_int_key, 123123123};
+            CHECK(!realm_get_values_for_objects(realm, class_foo.key, 2, obj_keys, 2, keys2, values));
+            CHECK_ERR(RLM_ERR_INVALID_PROPERTY);
+
+            realm_property_key_t keys3[1] = {foo_links_key};
+            CHECK(!realm_get_values_for_objects(realm, class_foo.key, 2, obj_keys, 1, keys3, values));
+            CHECK_ERR(RLM_ERR_PROPERTY_TYPE_MISMATCH);
+
+            realm_object_key_t invalid_keys[1] = {123123123};
+            CHECK(!realm_get_values_for_objects(realm, class_foo.key, 1, invalid_keys, 2, keys1, values));
+            CHECK_ERR(RLM_ERR_NO_SUCH_OBJECT);
+        }
+
+        SECTION("realm_object_create_batch()") {
+            realm_property_key_t foo_keys[2] = {foo_int_key, foo_str_key};
+            realm_value_t foo_values[4] = {rlm_int_val(7), rlm_int_val(8), rlm_str_val("a"), rlm_str_val("b")};
+            realm_object_key_t out_keys[2];
+
+            CHECK(!realm_object_create_batch(realm, class_foo.key, 2, 2, foo_keys, foo_values, out_keys));
+            CHECK_ERR(RLM_ERR_NOT_IN_A_TRANSACTION);
+
+            write([&]() {
+                CHECK(checked(realm_object_create_batch(realm, class_foo.key, 2, 2, foo_keys, foo_values, out_keys)));
+                CHECK(out_keys[0] != out_keys[1]);
+                auto obj = cptr_checked(realm_get_object(realm, class_foo.key, out_keys[1]));
+                realm_value_t value;
+                CHECK(checked(realm_get_value(obj.get(), foo_int_key, &value)));
+                CHECK(value.type == RLM_TYPE_INT);
+                CHECK(value.integer == 8);
+
+                // Existing objects are updated and duplicates are merged
+                realm_property_key_t bar_keys[1] = {bar_int_key};
+                realm_value_t bar_values[3] = {rlm_int_val(1), rlm_int_val(2), rlm_int_val(2)};
+                realm_object_key_t bar_out[3];
+                CHECK(checked(realm_object_create_batch(realm, class_bar.key, 3, 1, bar_keys, bar_values, bar_out)));
+                CHECK(bar_out[0] == realm_object_get_key(obj2.get()));
+                CHECK(bar_out[1] == bar_out[2]);
+                size_t count;
+                CHECK(checked(realm_get_num_objects(realm, class_bar.key, &count)));
+                CHECK(count == 2);
+
+                realm_property_key_t bar_doubles[1] = {bar_doubles_key};
+                CHECK(!realm_object_create_batch(realm, class_bar.key, 1, 1, bar_doubles, bar_values, bar_out));
+                CHECK_ERR(RLM_ERR_PROPERTY_TYPE_MISMATCH);
+
+                realm_property_key_t foo_only_int[1] = {foo_int_key};
+                realm_value_t wrong_type[1] = {rlm_str_val("x")};
+                CHECK(!realm_object_create_batch(realm, class_foo.key, 1, 1, foo_only_int, wrong_type, out_keys));
+                CHECK_ERR(RLM_ERR_PROPERTY_TYPE_MISMATCH);
+
+                realm_property_key_t foo_str_only[1] = {foo_str_key};
+                realm_value_t str_value[1] = {rlm_str_val("x")};
+                CHECK(!realm_object_create_batch(realm, class_bar.key, 1, 1, foo_str_only, str_value, out_keys));
+                CHECK_ERR(RLM_ERR_INVALID_PROPERTY);
+            });
+        }
+
         SECTION("realm_set_value() errors") {
             CHECK(!realm_set_value(obj1.get(), foo_int_key, rlm_int_val(456), false));
             CHECK_ERR(RLM_ERR_NOT_IN_A_TRANSACTION);
@@ -1911,6 +1991,29 @@ TEST_CASE("C API", "[c_api]") {
             CHECK_ERR(RLM_ERR_NO_SUCH_TABLE);
         }
 
+        SECTION("find keys with primary keys") {
+            realm_value_t pks[] = {rlm_int_val(2), rlm_int_val(1), rlm_null(), rlm_str_val("a"), rlm_int_val(1)};
+            realm_object_key_t keys[5];
+            bool found[5];
+            CHECK(checked(realm_object_find_keys_with_primary_keys(realm, class_bar.key, pks, 5, keys, found)));
+            auto obj2_key = realm_object_get_key(obj2.get());
+            CHECK(!found[0]);
+            CHECK(found[1]);
+            CHECK(keys[1] == obj2_key);
+            // Type-mismatched values just find nothing
+            CHECK(!found[2]);
+            CHECK(!found[3]);
+            CHECK(found[4]);
+            CHECK(keys[4] == obj2_key);
+
+            CHECK(checked(realm_object_find_keys_with_primary_keys(realm, class_bar.key, pks, 2, keys, nullptr)));
+            CHECK(keys[1] == obj2_key);
+
+            // Invalid class key
+            CHECK(!realm_object_find_keys_with_primary_keys(realm, 123123123, pks, 1, keys, found));
+            CHECK_ERR(RLM_ERR_NO_SUCH_TABLE);
+        }
+
         SECTION("find all") {
             auto r = cptr_checked(realm_object_find_all(realm, class_bar.key));
             size_t count;
@@ -1933,6 +2036,43 @@ TEST_CASE("C API", "[c_api]") {
                 CHECK(descr == expected);
             }
 
+            SECTION("realm_query_explain()") {
+                char* plan = checked(realm_query_explain(q.get(), false));
+                CHECK(std::string(plan).find("string == \"Hello, World!\" (scan") != std::string::npos);
+                realm_free(plan);
+
+                char* analyzed = checked(realm_query_explain(q.get(), true));
+                CHECK(std::string(analyzed).find("1 rows matched") == 0);
+                realm_free(analyzed);
+            }
+
+            SECTION("realm_query_find_all_async()") {
+                if (!util::EventLoop::has_implementation())
+                    return;
+
+                struct Userdata {
+                    bool called = false;
+                    bool frozen = false;
+                    size_t count = 0;
+                } userdata;
+                auto evaluation = cptr_checked(realm_query_find_all_async(
+                    q.get(),
+                    [](void* data, const realm_results_t* results, const realm_async_error_t* error) {
+                        auto& userdata = *static_cast<Userdata*>(data);
+                        REQUIRE(results);
+                        REQUIRE(!error);
+                        userdata.called = true;
+                        userdata.frozen = realm_is_frozen(results);
+                        realm_results_count(const_cast<realm_results_t*>(results), &userdata.count);
+                    },
+                    &userdata, nullptr));
+                util::EventLoop::main().run_until([&] {
+                    return userdata.called;
+                });
+                CHECK(userdata.frozen);
+                CHECK(userdata.count == 1);
+            }
+
             SECTION("realm_query_count()") {
                 size_t count;
                 CHECK(checked(realm_query_count(q.get(), &count)));
@@ -1967,6 +2107,25 @@ TEST_CASE("C API", "[c_api]") {
                 }
             }
 
+            SECTION("realm_query_prepare()") {
+                auto prepared =
+                    cptr_checked(realm_query_prepare(realm, class_foo.key, "string == $0", num_args, arg_list));
+                size_t count;
+                CHECK(checked(realm_query_count(prepared.get(), &count)));
+                CHECK(count == 1);
+                CHECK(checked(realm_query_rebind(prepared.get(), 0, rlm_str_val("Goodbye"))));
+                CHECK(checked(realm_query_count(prepared.get(), &count)));
+                CHECK(count == 0);
+                CHECK(checked(realm_query_rebind(prepared.get(), 0, rlm_str_val("Hello, World!"))));
+                CHECK(checked(realm_query_count(prepared.get(), &count)));
+                CHECK(count == 1);
+
+                CHECK(!realm_query_rebind(prepared.get(), 0, rlm_int_val(1)));
+                CHECK_ERR(RLM_ERR_LOGIC);
+                CHECK(!realm_query_rebind(prepared.get(), 1, rlm_int_val(1)));
+                CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+            }
+
             SECTION("realm_query_parse() errors") {
                 // Invalid class key
                 CHECK(!realm_query_parse(realm, 123123123, "string == $0", num_args, arg_list));
@@ -2171,6 +2330,19 @@ TEST_CASE("C API", "[c_api]") {
                     CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
                 }
 
+                SECTION("realm_results_get_values()") {
+                    realm_property_key_t props[] = {foo_str_key, foo_int_key};
+                    realm_value_t values[2];
+                    CHECK(checked(realm_results_get_values(r.get(), 0, 1, 2, props, values)));
+                    CHECK(rlm_stdstr(values[0]) == "Hello, World!");
+                    realm_value_t int_value;
+                    CHECK(checked(realm_get_value(obj1.get(), foo_int_key, &int_value)));
+                    CHECK(rlm_val_eq(values[1], int_value));
+
+                    CHECK(!realm_results_get_values(r.get(), 0, 2, 2, props, values));
+                    CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+                }
+
                 SECTION("realm_results_get_object()") {
                     auto p = cptr_checked(realm_results_get_object(r.get(), 0));
                     CHECK(p.get());
@@ -2421,6 +2593,22 @@ TEST_CASE("C API", "[c_api]") {
                     });
                 }
 
+                SECTION("insert, then get range") {
+                    write([&]() {
+                        CHECK(checked(realm_list_insert(strings.get(), 0, a)));
+                        CHECK(checked(realm_list_insert(strings.get(), 1, b)));
+                        CHECK(checked(realm_list_insert(strings.get(), 2, c)));
+
+                        realm_value_t values[2];
+                        CHECK(checked(realm_list_get_range(strings.get(), 1, 3, values)));
+                        CHECK(rlm_stdstr(values[0]) == "b");
+                        CHECK(values[1].type == RLM_TYPE_NULL);
+
+                        CHECK(!realm_list_get_range(strings.get(), 1, 4, values));
+                        CHECK_ERR(RLM_ERR_INDEX_OUT_OF_BOUNDS);
+                    });
+                }
+
                 SECTION("equality") {
                     auto strings2 = cptr_checked(realm_get_list(obj2.get(), bar_strings_key));
                     CHECK(strings2);
@@ -2787,6 +2975,44 @@ TEST_CASE("C API", "[c_api]") {
                     REQUIRE(!state.called);
                 }
 
+                SECTION("batched callbacks") {
+                    struct BatchState {
+                        std::vector<uint64_t> ids;
+                        std::vector<size_t> num_insertions;
+                        size_t num_batches = 0;
+                    };
+                    BatchState batch_state;
+                    auto on_batch = [](void* userdata, size_t num_changes, const uint64_t* ids,
+                                       const realm_collection_changes_t* const* changes) {
+                        auto* state = static_cast<BatchState*>(userdata);
+                        ++state->num_batches;
+                        for (size_t i = 0; i < num_changes; ++i) {
+                            size_t num_deletions, num_insertions, num_modifications, num_moves;
+                            realm_collection_changes_get_num_changes(changes[i], &num_deletions, &num_insertions,
+                                                                     &num_modifications, &num_moves);
+                            state->ids.push_back(ids[i]);
+                            state->num_insertions.push_back(num_insertions);
+                        }
+                    };
+                    auto batch = cptr_checked(realm_notification_batch_new(realm, &batch_state, nullptr, on_batch));
+                    auto token_1 = cptr_checked(
+                        realm_list_add_batched_notification_callback(strings.get(), batch.get(), 1, nullptr));
+                    auto token_2 = cptr_checked(
+                        realm_list_add_batched_notification_callback(strings.get(), batch.get(), 2, nullptr));
+                    checked(realm_refresh(realm));
+                    batch_state = {};
+
+                    write([&]() {
+                        checked(realm_list_insert(strings.get(), 0, str1));
+                        checked(realm_list_insert(strings.get(), 1, str2));
+                    });
+                    std::sort(batch_state.ids.begin(), batch_state.ids.end());
+                    CHECK(batch_state.ids == std::vector<uint64_t>{1, 2});
+                    CHECK(batch_state.num_insertions == std::vector<size_t>{2, 2});
+                    // Without a scheduler which can invoke, each change is delivered on its own
+                    CHECK(batch_state.num_batches >= 1);
+                }
+
                 SECTION("insertion, deletion, modification, modification after") {
                     write([&]() {
                         checked(realm_list_insert(strings.get(), 0, str1));
@@ -22,6 +22,7 @@
 
 #include "util/index_helpers.hpp"
 
+#include <algorithm>
 #include <limits>
 
 using namespace realm;
@@ -649,6 +650,26 @@ TEST_CASE("collection_change: calculate() sorted") {
         REQUIRE_INDICES(c.insertions, 0, 3, 7, 10);
     }
 
+    SECTION("moves the fewest rows possible for large reorderings") {
+        std::vector<size_t> prev, next;
+        for (size_t i = 0; i < 1000; ++i)
+            prev.push_back(i);
+        for (size_t i = 0; i < 1000; i += 2)
+            next.push_back(i);
+        for (size_t i = 1; i < 1000; i += 2)
+            next.push_back(i);
+        c = _impl::CollectionChangeBuilder::calculate(prev, next, none_modified);
+        REQUIRE(c.insertions.count() == 499);
+        REQUIRE(c.deletions.count() == 499);
+
+        // Moving a single row to a new position only moves that row
+        next = prev;
+        std::rotate(next.begin() + 100, next.begin() + 101, next.begin() + 900);
+        c = _impl::CollectionChangeBuilder::calculate(prev, next, none_modified);
+        REQUIRE_INDICES(c.deletions, 100);
+        REQUIRE_INDICES(c.insertions, 899);
+    }
+
     SECTION("produces diffs which let merge collapse insert -> move -> delete to no-op") {
         auto four_modified = [](auto ndx) {
             return ndx == 4;
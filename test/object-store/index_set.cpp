@@ -89,6 +89,21 @@ TEST_CASE("index_set: count()") {
             REQUIRE(set.count(0, i) == (i + 1) / 3 + (i + 2) / 3);
         }
     }
+
+    SECTION("includes ranges at the start of the next chunk when starting mid-chunk") {
+        size_t count = realm::_impl::ChunkedRangeVector::max_size;
+        realm::IndexSet set;
+        for (size_t i = 0; i < count; ++i)
+            set.add(i * 2);
+        size_t last = count * 2;
+        set.add(last);
+        set.add(last + 1);
+        set.add(last + 2);
+
+        REQUIRE(set.count(1, last + 2) == count - 1 + 2);
+        REQUIRE(set.count(1, last + 3) == count - 1 + 3);
+        REQUIRE(set.count(1) == count - 1 + 3);
+    }
 }
 
 TEST_CASE("index_set: add()") {
@@ -584,6 +599,17 @@ TEST_CASE("index_set: shift()") {
         REQUIRE(set.shift(3) == 7);
         REQUIRE(set.shift(4) == 8);
     }
+
+    SECTION("skips over full chunks") {
+        size_t count = realm::_impl::ChunkedRangeVector::max_size * 4;
+        for (size_t i = 0; i < count; ++i)
+            set.add(i * 2 + 1);
+
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(set.shift(i) == i * 2);
+        REQUIRE(set.shift(count) == count * 2);
+        REQUIRE(set.shift(count + 10) == count * 2 + 10);
+    }
 }
 
 TEST_CASE("index_set: unshift()") {
@@ -608,3 +634,34 @@ TEST_CASE("index_set: clear()") {
         REQUIRE(set.empty());
     }
 }
+
+TEST_CASE("index_set: copy and move") {
+    size_t count = realm::_impl::ChunkedRangeVector::max_size * 2;
+
+    SECTION("preserve small sets") {
+        realm::IndexSet set = {1, 2, 5};
+        realm::IndexSet copy = set;
+        REQUIRE_INDICES(copy, 1, 2, 5);
+        realm::IndexSet moved = std::move(copy);
+        REQUIRE_INDICES(moved, 1, 2, 5);
+        copy = moved;
+        moved.add(3);
+        REQUIRE_INDICES(copy, 1, 2, 5);
+        copy = std::move(moved);
+        REQUIRE_INDICES(copy, 1, 2, 3, 5);
+    }
+
+    SECTION("preserve sets spanning multiple chunks") {
+        realm::IndexSet set;
+        for (size_t i = 0; i < count; ++i)
+            set.add(i * 2);
+        realm::IndexSet copy = set;
+        realm::IndexSet moved = std::move(copy);
+        REQUIRE(moved.count() == count);
+        for (size_t i = 0; i < count * 2; ++i)
+            REQUIRE(moved.contains(i) == (i % 2 == 0));
+        set = realm::IndexSet{1};
+        set = std::move(moved);
+        REQUIRE(set.count() == count);
+    }
+}
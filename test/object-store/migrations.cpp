@@ -2473,6 +2473,53 @@ TEST_CASE("migration: Automatic") {
     }
 }
 
+TEST_CASE("migration: progress") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+    std::vector<std::pair<size_t, size_t>> progress;
+    config.migration_progress_function = [&](size_t applied, size_t total) {
+        progress.emplace_back(applied, total);
+    };
+    auto realm = Realm::get_shared_realm(config);
+
+    Schema schema1 = {
+        {"object", {{"value", PropertyType::Int}}},
+        {"object2", {{"value", PropertyType::Int}}},
+    };
+
+    SECTION("initial schema") {
+        REQUIRE_UPDATE_SUCCEEDS(*realm, schema1, 0);
+        REQUIRE(progress.size() > 0);
+        REQUIRE(progress.back().first == progress.back().second);
+        for (size_t i = 0; i < progress.size(); ++i)
+            REQUIRE(progress[i].first == i + 1);
+    }
+
+    SECTION("migration") {
+        REQUIRE_UPDATE_SUCCEEDS(*realm, schema1, 0);
+        progress.clear();
+        auto schema2 = add_property(remove_property(schema1, "object", "value"), "object",
+                                    {"value2", PropertyType::Int});
+        bool migration_called = false;
+        realm->update_schema(schema2, 1, [&](SharedRealm, SharedRealm, Schema&) {
+            migration_called = true;
+            // Only the changes before the migration function have been applied
+            REQUIRE(progress.size() > 0);
+            REQUIRE(progress.back().first < progress.back().second);
+        });
+        REQUIRE(migration_called);
+        REQUIRE(progress.size() > 0);
+        REQUIRE(progress.back().first == progress.back().second);
+    }
+
+    SECTION("no changes") {
+        REQUIRE_UPDATE_SUCCEEDS(*realm, schema1, 0);
+        progress.clear();
+        REQUIRE_UPDATE_SUCCEEDS(*realm, schema1, 0);
+        REQUIRE(progress.empty());
+    }
+}
+
 TEST_CASE("migration: Immutable") {
     TestFile config;
 
@@ -928,6 +928,37 @@ TEST_CASE("object") {
         }
     }
 
+    SECTION("ClassAccessor") {
+        auto obj = create_sub(AnyDict{{"_id", INT64_C(1)}, {"value", INT64_C(5)}});
+        create_sub(AnyDict{{"_id", INT64_C(2)}, {"value", INT64_C(6)}});
+
+        ClassAccessor accessor(r, "link target");
+        REQUIRE(accessor.get_object_schema().name == "link target");
+        REQUIRE(accessor.get_table() == r->read_group().get_table("class_link target"));
+        size_t value_ndx = accessor.get_property_index("value");
+        REQUIRE(accessor.get_property(value_ndx).name == "value");
+        size_t origin_ndx = accessor.get_property_index("origin");
+        REQUIRE(accessor.get_property(origin_ndx).name == "origin");
+        REQUIRE_THROWS_AS(accessor.get_property_index("not a property"), InvalidPropertyException);
+
+        REQUIRE(any_cast<int64_t>(accessor.get_property_value<std::any>(d, obj.obj(), value_ndx)) ==
+                any_cast<int64_t>(obj.get_property_value<std::any>(d, "value")));
+        auto origin = any_cast<Results&&>(accessor.get_property_value<std::any>(d, obj.obj(), origin_ndx));
+        REQUIRE(origin.get_object_type() == "all types");
+        REQUIRE(origin.size() == 0);
+
+        Obj found = accessor.get_for_primary_key(d, std::any(INT64_C(2)));
+        REQUIRE(found.is_valid());
+        REQUIRE(any_cast<int64_t>(accessor.get_property_value<std::any>(d, found, value_ndx)) == 6);
+        REQUIRE_FALSE(accessor.get_for_primary_key(d, std::any(INT64_C(3))).is_valid());
+        REQUIRE(accessor.get_object(found).obj().get_key() == found.get_key());
+
+        r->begin_transaction();
+        found.remove();
+        r->commit_transaction();
+        REQUIRE_THROWS_AS(accessor.get_property_value<std::any>(d, found, value_ndx), InvalidatedObjectException);
+    }
+
     SECTION("create object") {
         auto obj = create(AnyDict{
             {"_id", INT64_C(1)},
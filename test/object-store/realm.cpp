@@ -33,6 +33,7 @@
 #include <realm/object-store/results.hpp>
 #include <realm/object-store/schema.hpp>
 #include <realm/object-store/thread_safe_reference.hpp>
+#include <realm/object-store/util/coroutine.hpp>
 #include <realm/object-store/util/scheduler.hpp>
 #include <realm/object-store/util/event_loop_dispatcher.hpp>
 
@@ -288,6 +289,39 @@ TEST_CASE("SharedRealm: get_shared_realm()") {
         REQUIRE(migration_called);
     }
 
+    SECTION("should store a fingerprint of the applied schema") {
+        Realm::get_shared_realm(config);
+        uint64_t fingerprint;
+        {
+            Group g(config.path, config.encryption_key.data());
+            fingerprint = ObjectStore::get_schema_fingerprint(g);
+            REQUIRE(fingerprint != 0);
+        }
+
+        // Opening with the same schema uses the fingerprint and still sets
+        // up the column keys
+        {
+            auto realm = Realm::get_shared_realm(config);
+            auto& object_schema = *realm->schema().find("object");
+            REQUIRE(object_schema.table_key);
+            REQUIRE(object_schema.persisted_properties[0].column_key);
+        }
+
+        // A different schema with the same version is still diffed
+        config.schema = Schema{
+            {"object", {{"value", PropertyType::Int}, {"value2", PropertyType::Int}}},
+        };
+        REQUIRE_THROWS_CONTAINING(Realm::get_shared_realm(config), "Migration is required");
+
+        config.schema_version = 2;
+        Realm::get_shared_realm(config);
+        {
+            Group g(config.path, config.encryption_key.data());
+            REQUIRE(ObjectStore::get_schema_fingerprint(g) != 0);
+            REQUIRE(ObjectStore::get_schema_fingerprint(g) != fingerprint);
+        }
+    }
+
     SECTION("should properly roll back from migration errors") {
         Realm::get_shared_realm(config);
 
@@ -552,6 +586,35 @@ TEST_CASE("SharedRealm: get_shared_realm()") {
         REQUIRE(frozen2->read_transaction_version() > frozen1->read_transaction_version());
     }
 
+    SECTION("frozen Realms at the same version share a transaction") {
+        config.cache = false;
+        auto realm = Realm::get_shared_realm(config);
+        realm->read_group();
+        auto frozen1 = realm->freeze();
+        auto frozen2 = realm->freeze();
+        frozen1->read_group();
+        frozen2->read_group();
+        REQUIRE(frozen1 != frozen2);
+        REQUIRE(frozen1->transaction_ref() == frozen2->transaction_ref());
+        REQUIRE(realm->duplicate() != frozen1->transaction_ref());
+        REQUIRE(frozen1->duplicate() == frozen1->transaction_ref());
+
+        auto table = realm->read_group().get_table("class_object");
+        realm->begin_transaction();
+        table->create_object();
+        realm->commit_transaction();
+
+        auto frozen3 = realm->freeze();
+        frozen3->read_group();
+        REQUIRE(frozen3->transaction_ref() != frozen1->transaction_ref());
+        REQUIRE(frozen3->read_group().get_table("class_object")->size() == 1);
+        REQUIRE(frozen1->read_group().get_table("class_object")->size() == 0);
+
+        // Closing one of the Realms does not affect the others
+        frozen1->close();
+        REQUIRE(frozen2->read_group().get_table("class_object")->size() == 0);
+    }
+
     SECTION("frozen realm should have the same schema as originating realm") {
         auto full_schema = Schema{
             {"object1", {{"value", PropertyType::Int}}},
@@ -2176,6 +2239,100 @@ TEST_CASE("SharedRealm: async_writes_2") {
 }
 #endif
 
+#if REALM_HAVE_COROUTINES
+namespace {
+// A coroutine which starts right away and is not awaited by anyone
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept
+        {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+} // anonymous namespace
+
+TEST_CASE("SharedRealm: coroutines") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+    if (!util::EventLoop::has_implementation())
+        return;
+
+    TestFile config;
+    config.schema_version = 0;
+    config.schema = Schema{
+        {"object", {{"value", PropertyType::Int}}},
+    };
+    auto realm = Realm::get_shared_realm(config);
+    auto table = realm->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+    bool done = false;
+
+    SECTION("async write") {
+        auto write = [&]() -> DetachedTask {
+            for (int i = 0; i < 3; ++i) {
+                co_await util::await_begin_transaction(*realm);
+                REQUIRE(realm->is_in_transaction());
+                table->create_object().set(col, i);
+                co_await util::await_commit_transaction(*realm);
+                REQUIRE_FALSE(realm->is_in_transaction());
+            }
+            done = true;
+        };
+        write();
+        util::EventLoop::main().run_until([&] {
+            return done;
+        });
+        REQUIRE(table->size() == 3);
+    }
+
+    SECTION("async query") {
+        realm->begin_transaction();
+        for (int i = 0; i < 10; ++i)
+            table->create_object().set(col, i);
+        realm->commit_transaction();
+
+        auto query = [&]() -> DetachedTask {
+            Results results = co_await util::await_results(Results(realm, table->where().greater(col, 4)));
+            REQUIRE(results.size() == 5);
+            done = true;
+        };
+        query();
+        util::EventLoop::main().run_until([&] {
+            return done;
+        });
+    }
+
+    SECTION("future") {
+        auto pf = util::make_promise_future<int>();
+        int value = 0;
+        auto wait = [&](util::Future<int> future) -> DetachedTask {
+            value = co_await util::await_future(std::move(future), realm->scheduler());
+            done = true;
+        };
+        wait(std::move(pf.future));
+        REQUIRE_FALSE(done);
+        pf.promise.emplace_value(5);
+        util::EventLoop::main().run_until([&] {
+            return done;
+        });
+        REQUIRE(value == 5);
+    }
+}
+#endif // REALM_HAVE_COROUTINES
+
 TEST_CASE("SharedRealm: notifications") {
     if (!util::EventLoop::has_implementation())
         return;
@@ -1394,6 +1394,275 @@ TEST_CASE("notifications: TableView delivery") {
 
 
 #if REALM_ENABLE_SYNC
+TEST_CASE("notifications: multiple notifier threads") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+    config.notifier_thread_count = 4;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({
+        {"object", {{"value", PropertyType::Int}}},
+    });
+
+    auto table = r->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    r->begin_transaction();
+    for (int i = 0; i < 10; ++i)
+        table->create_object().set(col, i);
+    r->commit_transaction();
+
+    constexpr int notifier_count = 10;
+    std::vector<Results> results;
+    std::vector<NotificationToken> tokens;
+    std::vector<CollectionChangeSet> changes(notifier_count);
+    std::vector<int> notification_calls(notifier_count);
+    for (int i = 0; i < notifier_count; ++i) {
+        results.push_back(Results(r, table->where().greater_equal(col, i)));
+        tokens.push_back(results.back().add_notification_callback([&, i](CollectionChangeSet c) {
+            changes[i] = c;
+            ++notification_calls[i];
+        }));
+    }
+
+    advance_and_notify(*r);
+    for (int i = 0; i < notifier_count; ++i) {
+        REQUIRE(notification_calls[i] == 1);
+        REQUIRE(results[i].size() == size_t(10 - i));
+    }
+
+    SECTION("every notifier reports the changes from a commit") {
+        r->begin_transaction();
+        table->create_object().set(col, 5);
+        r->commit_transaction();
+        advance_and_notify(*r);
+
+        for (int i = 0; i < notifier_count; ++i) {
+            if (i <= 5) {
+                REQUIRE(notification_calls[i] == 2);
+                REQUIRE_INDICES(changes[i].insertions, 10 - i);
+            }
+            else {
+                REQUIRE(notification_calls[i] == 1);
+            }
+            REQUIRE(results[i].size() == size_t(10 - i + (i <= 5)));
+        }
+    }
+
+    SECTION("notifiers added later are spread over the existing transactions") {
+        Results later(r, table->where().less(col, 3));
+        CollectionChangeSet later_changes;
+        int later_calls = 0;
+        auto token = later.add_notification_callback([&](CollectionChangeSet c) {
+            later_changes = c;
+            ++later_calls;
+        });
+        advance_and_notify(*r);
+        REQUIRE(later_calls == 1);
+        REQUIRE(later.size() == 3);
+
+        r->begin_transaction();
+        table->begin()->remove();
+        r->commit_transaction();
+        advance_and_notify(*r);
+
+        REQUIRE(later_calls == 2);
+        REQUIRE_INDICES(later_changes.deletions, 0);
+        for (int i = 0; i < notifier_count; ++i)
+            REQUIRE(notification_calls[i] == (i == 0 ? 2 : 1));
+    }
+}
+
+TEST_CASE("notifications: delivery interval") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({
+        {"object", {{"value", PropertyType::Int}}},
+    });
+
+    auto table = r->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    Results results(r, table->where());
+    CollectionChangeSet change;
+    int notification_calls = 0;
+    auto token = results.add_notification_callback([&](CollectionChangeSet c) {
+        change = c;
+        ++notification_calls;
+    });
+    token.set_delivery_interval(std::chrono::hours(1));
+
+    auto insert = [&](int value) {
+        r->begin_transaction();
+        table->create_object().set(col, value);
+        r->commit_transaction();
+        advance_and_notify(*r);
+    };
+
+    SECTION("initial notification is not delayed") {
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 1);
+        REQUIRE(change.empty());
+    }
+
+    SECTION("changes within the interval are held back and merged") {
+        advance_and_notify(*r);
+        insert(0);
+        REQUIRE(notification_calls == 2);
+        REQUIRE_INDICES(change.insertions, 0);
+
+        insert(1);
+        insert(2);
+        REQUIRE(notification_calls == 2);
+
+        token.set_delivery_interval(std::chrono::milliseconds(0));
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 3);
+        REQUIRE_INDICES(change.insertions, 1, 2);
+        REQUIRE(results.size() == 3);
+    }
+
+    SECTION("suppress_next() with held back changes keeps them pending") {
+        advance_and_notify(*r);
+        insert(0);
+        insert(1);
+        REQUIRE(notification_calls == 2);
+
+        r->begin_transaction();
+        table->create_object().set(col, 2);
+        token.suppress_next();
+        r->commit_transaction();
+
+        token.set_delivery_interval(std::chrono::milliseconds(0));
+        advance_and_notify(*r);
+        REQUIRE(notification_calls == 3);
+        REQUIRE_INDICES(change.insertions, 1, 2);
+    }
+}
+
+TEST_CASE("notifications: incremental results update") {
+    _impl::RealmCoordinator::assert_no_open_realms();
+
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+
+    auto r = Realm::get_shared_realm(config);
+    r->update_schema({
+        {"object", {{"value", PropertyType::Int}, {"other", PropertyType::Int}}},
+    });
+
+    auto table = r->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+    auto other_col = table->get_column_key("other");
+
+    r->begin_transaction();
+    for (int i = 0; i < 100; ++i)
+        table->create_object().set(col, (i * 37) % 100);
+    r->commit_transaction();
+
+    auto query = table->where().greater_equal(col, 50);
+    bool sorted = GENERATE(false, true);
+    Results results(r, query);
+    if (sorted)
+        results = results.sort({{"value", true}});
+
+    CollectionChangeSet change;
+    auto token = results.add_notification_callback([&](CollectionChangeSet c) {
+        change = c;
+    });
+    advance_and_notify(*r);
+    REQUIRE(results.size() == 50);
+
+    auto check_matches_full_run = [&] {
+        auto expected = query.find_all();
+        if (sorted)
+            expected.sort(col, true);
+        REQUIRE(results.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            REQUIRE(results.get(i).get_key() == expected.get_key(i));
+    };
+    auto write = [&](auto&& fn) {
+        r->begin_transaction();
+        fn();
+        r->commit_transaction();
+        advance_and_notify(*r);
+    };
+
+    SECTION("object starts matching") {
+        auto obj = *table->begin();
+        REQUIRE(obj.get<Int>(col) == 0);
+        write([&] {
+            obj.set(col, 75);
+        });
+        check_matches_full_run();
+        REQUIRE(change.insertions.count() == 1);
+        REQUIRE(change.deletions.empty());
+        REQUIRE(results.index_of(obj) != npos);
+    }
+
+    SECTION("object stops matching") {
+        auto matching = table->get_object(2);
+        REQUIRE(matching.get<Int>(col) == 74);
+        size_t index = results.index_of(matching);
+        write([&] {
+            matching.set(col, 10);
+        });
+        check_matches_full_run();
+        REQUIRE_INDICES(change.deletions, index);
+        REQUIRE(change.insertions.empty());
+    }
+
+    SECTION("matching object changes sort position") {
+        auto obj = table->get_object(2);
+        write([&] {
+            obj.set(col, 100);
+        });
+        check_matches_full_run();
+        if (sorted)
+            REQUIRE(results.get(results.size() - 1).get_key() == obj.get_key());
+        REQUIRE(results.size() == 50);
+    }
+
+    SECTION("modifying a column not used by the query reports a modification") {
+        auto obj = table->get_object(2);
+        size_t index = results.index_of(obj);
+        write([&] {
+            obj.set(other_col, 1);
+        });
+        check_matches_full_run();
+        REQUIRE_INDICES(change.modifications, index);
+        REQUIRE(change.insertions.empty());
+        REQUIRE(change.deletions.empty());
+    }
+
+    SECTION("inserting and deleting objects") {
+        ObjKey removed;
+        write([&] {
+            table->create_object().set(col, 50);
+            table->create_object().set(col, 5);
+            removed = table->get_object(2).get_key();
+            table->remove_object(removed);
+        });
+        check_matches_full_run();
+        REQUIRE(change.insertions.count() == 1);
+        REQUIRE(change.deletions.count() == 1);
+    }
+
+    SECTION("large changes rerun the query") {
+        write([&] {
+            for (auto obj : *table)
+                obj.set(col, 100 - obj.get<Int>(col));
+        });
+        check_matches_full_run();
+    }
+}
+
 TEST_CASE("notifications: sync") {
     _impl::RealmCoordinator::assert_no_open_realms();
 
@@ -4362,6 +4631,34 @@ TEMPLATE_TEST_CASE("results: aggregate", "[query][aggregate]", ResultsFromTable,
         }
     }
 
+    SECTION("after a modification") {
+        r->begin_transaction();
+        auto obj = table->create_object().set_all(1, 1.f, 1.0, Timestamp(1, 0));
+        table->create_object().set_all(2, 2.f, 2.0, Timestamp(2, 0));
+        r->commit_transaction();
+
+        Results results = TestType::call(r, table);
+        REQUIRE(results.sum(col_int)->get_int() == 3);
+        REQUIRE(results.min(col_double)->get_double() == 1.0);
+        REQUIRE(results.max(col_date)->get_timestamp() == Timestamp(2, 0));
+        REQUIRE(results.average(col_float) == 1.5);
+        // Repeated aggregates give the same results
+        REQUIRE(results.sum(col_int)->get_int() == 3);
+        REQUIRE(results.min(col_double)->get_double() == 1.0);
+
+        r->begin_transaction();
+        obj.set_all(5, 5.f, 5.0, Timestamp(5, 0));
+        REQUIRE(results.sum(col_int)->get_int() == 7);
+        REQUIRE(results.min(col_double)->get_double() == 2.0);
+        REQUIRE(results.max(col_date)->get_timestamp() == Timestamp(5, 0));
+        REQUIRE(results.average(col_float) == 3.5);
+        obj.set(col_int, 10);
+        REQUIRE(results.sum(col_int)->get_int() == 12);
+        r->commit_transaction();
+        REQUIRE(results.sum(col_int)->get_int() == 12);
+        REQUIRE(results.min(col_double)->get_double() == 2.0);
+    }
+
     SECTION("empty") {
         Results results = TestType::call(r, table);
 
@@ -4805,6 +5102,141 @@ TEST_CASE("results: limit", "[limit]") {
     }
 }
 
+TEST_CASE("results: reading the first rows of an unsorted query") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+    config.schema = Schema{
+        {"object",
+         {
+             {"value", PropertyType::Int},
+         }},
+    };
+
+    auto realm = Realm::get_shared_realm(config);
+    auto table = realm->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    realm->begin_transaction();
+    for (int i = 0; i < 10000; ++i) {
+        table->create_object().set(col, i);
+    }
+    realm->commit_transaction();
+    Results r(realm, table->where().greater_equal(col, 10));
+
+    SECTION("first rows are read without evaluating the full query") {
+        REQUIRE(r.get(0).get<Int>(col) == 10);
+        REQUIRE(r.get(100).get<Int>(col) == 110);
+        REQUIRE(r.get_any(200).get_link().get_obj_key() == table->get_object(210).get_key());
+        REQUIRE(r.get_mode() == Results::Mode::Query);
+        REQUIRE(r.size() == 9990);
+    }
+
+    SECTION("reading past the first rows evaluates the full query") {
+        REQUIRE(r.get(0).get<Int>(col) == 10);
+        REQUIRE(r.get(5000).get<Int>(col) == 5010);
+        REQUIRE(r.get_mode() == Results::Mode::TableView);
+    }
+
+    SECTION("first rows follow changes") {
+        REQUIRE(r.get(0).get<Int>(col) == 10);
+        realm->begin_transaction();
+        table->get_object(10).remove();
+        REQUIRE(r.get(0).get<Int>(col) == 11);
+        realm->commit_transaction();
+        REQUIRE(r.get(0).get<Int>(col) == 11);
+    }
+
+    SECTION("reading past the last match") {
+        Results last(realm, table->where().greater_equal(col, 9998));
+        REQUIRE(last.get(1).get<Int>(col) == 9999);
+        REQUIRE_THROWS_WITH(last.get(2), "Requested index 2 greater than max 1");
+    }
+
+    SECTION("sorted results are evaluated in full") {
+        auto sorted = r.sort({{"value", false}});
+        REQUIRE(sorted.get(0).get<Int>(col) == 9999);
+        REQUIRE(sorted.get_mode() == Results::Mode::TableView);
+    }
+}
+
+TEST_CASE("results: evaluate_async") {
+    if (!util::EventLoop::has_implementation())
+        return;
+
+    InMemoryTestFile config;
+    config.schema = Schema{
+        {"object",
+         {
+             {"value", PropertyType::Int},
+         }},
+    };
+
+    auto realm = Realm::get_shared_realm(config);
+    auto table = realm->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    realm->begin_transaction();
+    for (int i = 0; i < 1000; ++i) {
+        table->create_object().set(col, i);
+    }
+    realm->commit_transaction();
+    Results r(realm, table->where().greater_equal(col, 990));
+
+    bool called = false;
+    Results delivered;
+    std::exception_ptr delivered_error;
+    auto callback = [&](Results results, std::exception_ptr error) {
+        REQUIRE(realm->scheduler()->is_on_thread());
+        called = true;
+        delivered = std::move(results);
+        delivered_error = error;
+    };
+
+    SECTION("delivers frozen results on the scheduler") {
+        r.evaluate_async(callback);
+        REQUIRE_FALSE(called);
+        util::EventLoop::main().run_until([&] {
+            return called;
+        });
+        REQUIRE_FALSE(delivered_error);
+        REQUIRE(delivered.is_frozen());
+        REQUIRE(delivered.get_mode() == Results::Mode::TableView);
+        REQUIRE(delivered.size() == 10);
+        // The query was not run on the calling thread
+        REQUIRE(r.get_mode() == Results::Mode::Query);
+    }
+
+    SECTION("uses the version the call was made at") {
+        r.evaluate_async(callback);
+        realm->begin_transaction();
+        table->create_object().set(col, 1000);
+        realm->commit_transaction();
+        util::EventLoop::main().run_until([&] {
+            return called;
+        });
+        REQUIRE(delivered.size() == 10);
+        REQUIRE(r.size() == 11);
+    }
+
+    SECTION("cancel") {
+        // The callback is released on the scheduler whether or not it is called
+        auto alive = std::make_shared<bool>();
+        auto evaluation = r.evaluate_async([&, alive](Results, std::exception_ptr) {
+            called = true;
+        });
+        evaluation.cancel();
+        util::EventLoop::main().run_until([&] {
+            return alive.use_count() == 1;
+        });
+        REQUIRE_FALSE(called);
+    }
+
+    SECTION("throws on a frozen Realm") {
+        auto frozen = r.freeze(realm->freeze());
+        REQUIRE_THROWS(frozen.evaluate_async(callback));
+    }
+}
+
 TEST_CASE("notifications: objects with PK recreated") {
 #ifndef _WIN32
     _impl::RealmCoordinator::assert_no_open_realms();
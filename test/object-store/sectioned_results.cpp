@@ -813,7 +813,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         auto o6 = table->create_object().set(name_col, "any");
         r->commit_transaction();
         advance_and_notify(*r);
-        REQUIRE(algo_run_count == 11);
+        REQUIRE(algo_run_count == 6);
 
         REQUIRE(changes.sections_to_insert.count() == 3);
         REQUIRE(changes.sections_to_delete.count() == 0);
@@ -848,7 +848,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(changes.modifications[5], 1);
         REQUIRE(changes.insertions.empty());
         REQUIRE(changes.deletions.empty());
-        REQUIRE(algo_run_count == 11);
+        REQUIRE(algo_run_count == 1);
 
         algo_run_count = 0;
         // Deletions
@@ -864,7 +864,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(changes.deletions[2], 1);
         REQUIRE(changes.insertions.empty());
         REQUIRE(changes.modifications.empty());
-        REQUIRE(algo_run_count == 9);
+        REQUIRE(algo_run_count == 0);
 
         // Test moving objects from one section to a new one.
         // delete all objects starting with 'S'
@@ -885,7 +885,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(changes.deletions[3], 0);
         REQUIRE_INDICES(changes.insertions[3], 0, 1);
         REQUIRE_INDICES(changes.insertions[4], 0);
-        REQUIRE(algo_run_count == 9);
+        REQUIRE(algo_run_count == 3);
 
         // Test moving objects from one section to an existing one.
         // move all objects starting with 'E'
@@ -903,7 +903,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE(changes.insertions.size() == 1);
         REQUIRE(changes.modifications.empty());
         REQUIRE_INDICES(changes.insertions[0], 0, 5);
-        REQUIRE(algo_run_count == 9);
+        REQUIRE(algo_run_count == 2);
 
         // Test clearing all from the table
         algo_run_count = 0;
@@ -1272,7 +1272,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         auto o1 = table->create_object().set(name_col, "any");
         r->commit_transaction();
         advance_and_notify(*r);
-        REQUIRE(algo_run_count == 6);
+        REQUIRE(algo_run_count == 1);
 
         REQUIRE(section1_notification_calls == 1);
         REQUIRE(section2_notification_calls == 0);
@@ -1294,7 +1294,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(section2_changes.insertions[1], 1);
         REQUIRE(section2_changes.modifications.empty());
         REQUIRE(section2_changes.deletions.empty());
-        REQUIRE(algo_run_count == 7);
+        REQUIRE(algo_run_count == 1);
         algo_run_count = 0;
 
         // Modifications
@@ -1308,7 +1308,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(section1_changes.modifications[0], 0);
         REQUIRE(section1_changes.insertions.empty());
         REQUIRE(section1_changes.deletions.empty());
-        REQUIRE(algo_run_count == 7);
+        REQUIRE(algo_run_count == 1);
         algo_run_count = 0;
         // Modify the column value to now be in a diff section
         r->begin_transaction();
@@ -1320,7 +1320,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE(section1_changes.modifications.empty());
         REQUIRE(section1_changes.insertions.empty());
         REQUIRE_INDICES(section1_changes.deletions[0], 0);
-        REQUIRE(algo_run_count == 7);
+        REQUIRE(algo_run_count == 1);
         algo_run_count = 0;
 
         // Deletions
@@ -1334,7 +1334,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(section2_changes.deletions[1], 1);
         REQUIRE(section2_changes.insertions.empty());
         REQUIRE(section2_changes.modifications.empty());
-        REQUIRE(algo_run_count == 6);
+        REQUIRE(algo_run_count == 0);
         algo_run_count = 0;
 
         r->begin_transaction();
@@ -1347,7 +1347,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(section1_changes.deletions[0], 1);
         REQUIRE(section1_changes.insertions.empty());
         REQUIRE(section1_changes.modifications.empty());
-        REQUIRE(algo_run_count == 5);
+        REQUIRE(algo_run_count == 0);
     }
 
     SECTION("notifications on section where section is deleted") {
@@ -1391,17 +1391,17 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE(section1_changes.insertions.empty());
         REQUIRE(section1_changes.modifications.empty());
         REQUIRE_INDICES(section1_changes.sections_to_delete, 0);
-        REQUIRE(algo_run_count == 2);
+        REQUIRE(algo_run_count == 0);
 
         r->begin_transaction();
-        REQUIRE(algo_run_count == 2);
+        REQUIRE(algo_run_count == 0);
         algo_run_count = 0;
         section1_notification_calls = 0;
         section2_notification_calls = 0;
         table->create_object().set(name_col, "book");
         r->commit_transaction();
         advance_and_notify(*r);
-        REQUIRE(algo_run_count == 3);
+        REQUIRE(algo_run_count == 1);
 
         REQUIRE(section1_notification_calls == 0);
         REQUIRE(section2_notification_calls == 1);
@@ -1410,12 +1410,12 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         REQUIRE_INDICES(section2_changes.insertions[0], 1);
         REQUIRE(section2_changes.modifications.empty());
         REQUIRE(section2.index() == 0);
-        REQUIRE(algo_run_count == 3);
+        REQUIRE(algo_run_count == 1);
 
         // Insert values back into section1
         REQUIRE_FALSE(section1.is_valid());
         r->begin_transaction();
-        REQUIRE(algo_run_count == 3);
+        REQUIRE(algo_run_count == 1);
         algo_run_count = 0;
         section1_notification_calls = 0;
         section2_notification_calls = 0;
@@ -1423,7 +1423,7 @@ TEST_CASE("sectioned results", "[sectioned_results]") {
         r->commit_transaction();
         advance_and_notify(*r);
 
-        REQUIRE(algo_run_count == 4);
+        REQUIRE(algo_run_count == 1);
         REQUIRE(section1_notification_calls == 1);
         REQUIRE(section2_notification_calls == 0);
         REQUIRE(section1_changes.deletions.empty());
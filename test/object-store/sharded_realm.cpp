@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch_all.hpp>
+
+#include "util/test_file.hpp"
+
+#include <realm/object-store/object_store.hpp>
+#include <realm/object-store/property.hpp>
+#include <realm/object-store/schema.hpp>
+#include <realm/object-store/sharded_realm.hpp>
+
+#include <set>
+
+using namespace realm;
+
+TEST_CASE("ShardedRealm") {
+    Schema schema{
+        {"Reading",
+         {{"_id", PropertyType::Int, Property::IsPrimary{true}},
+          {"value", PropertyType::Double},
+          {"label", PropertyType::String, Property::IsPrimary{false}, Property::IsIndexed{false}, "display"}}},
+    };
+    TestFile config_1, config_2, config_3;
+    std::vector<SharedRealm> shards;
+    for (auto config : {&config_1, &config_2, &config_3}) {
+        config->schema = schema;
+        shards.push_back(Realm::get_shared_realm(*config));
+    }
+    ShardedRealm realm(std::move(shards));
+    REQUIRE(realm.get_shard_count() == 3);
+
+    SECTION("placement") {
+        // The placement must never change, as it decides where existing objects are
+        CHECK(realm.get_shard_for(Mixed()) == 0);
+        CHECK(realm.get_shard_for(int64_t(1)) == 1);
+        CHECK(realm.get_shard_for(int64_t(2)) == 1);
+        CHECK(realm.get_shard_for(int64_t(3)) == 2);
+        CHECK(realm.get_shard_for("a") == 1);
+        CHECK(realm.get_shard_for("abc") == 0);
+
+        // Consecutive keys are spread over all shards
+        std::vector<size_t> counts(3);
+        for (int64_t i = 0; i < 300; ++i)
+            ++counts[realm.get_shard_for(i)];
+        for (auto count : counts)
+            CHECK(count > 70);
+
+        CHECK_THROWS_AS(realm.get_shard_for(1.5), LogicError);
+        CHECK_THROWS_AS(ShardedRealm({}), LogicError);
+    }
+
+    SECTION("queries") {
+        const int64_t num_objects = 100;
+        size_t expected = 0, expected_large = 0;
+        for (int64_t i = 0; i < num_objects; ++i) {
+            auto& shard = realm.get_shard_realm_for(i);
+            shard->begin_transaction();
+            auto table = ObjectStore::table_for_object_type(shard->read_group(), "Reading");
+            table->create_object_with_primary_key(i).set("value", double(i)).set("label", i % 2 ? "odd" : "even");
+            shard->commit_transaction();
+            ++expected;
+            expected_large += i >= 50 ? 1 : 0;
+        }
+
+        CHECK(realm.count("Reading", "TRUEPREDICATE") == expected);
+        CHECK(realm.count("Reading", "value >= $0", {50.0}) == expected_large);
+        // Queries use the public names of properties
+        CHECK(realm.count("Reading", "display == 'odd'") == expected / 2);
+
+        auto results = realm.find_all("Reading", "value >= $0", {50.0});
+        REQUIRE(results.size() == expected_large);
+        std::set<int64_t> seen;
+        for (size_t i = 0; i < results.size(); ++i) {
+            Obj obj = results.get(i);
+            auto pk = obj.get_primary_key().get_int();
+            CHECK(pk >= 50);
+            CHECK(results.get_shard_ndx(i) == realm.get_shard_for(pk));
+            seen.insert(pk);
+        }
+        CHECK(seen.size() == expected_large);
+        CHECK(results.get_results(0).get_realm()->is_frozen());
+        CHECK_THROWS_AS(results.get(results.size()), std::out_of_range);
+    }
+
+    SECTION("object types missing on a shard contribute no objects") {
+        CHECK(realm.count("Missing", "TRUEPREDICATE") == 0);
+        auto results = realm.find_all("Missing", "TRUEPREDICATE");
+        CHECK(results.size() == 0);
+    }
+}
@@ -3934,6 +3934,82 @@ TEST_CASE("app: refresh access token unit tests", "[sync][app]") {
     }
 }
 
+TEST_CASE("app: concurrent requests are coalesced", "[sync][app]") {
+    static std::vector<util::UniqueFunction<void(const Response&)>> pending_requests;
+    static int function_call_requests = 0;
+    static int refresh_requests = 0;
+    pending_requests.clear();
+    function_call_requests = 0;
+    refresh_requests = 0;
+
+    struct transport : UnitTestTransport {
+        void send_request_to_server(Request&& request,
+                                    util::UniqueFunction<void(const Response&)>&& completion_block) override
+        {
+            if (request.url.find("/functions/call") != std::string::npos) {
+                ++function_call_requests;
+                pending_requests.push_back(std::move(completion_block));
+            }
+            else if (request.url.find("/session") != std::string::npos && request.method == HttpMethod::post) {
+                ++refresh_requests;
+                pending_requests.push_back(std::move(completion_block));
+            }
+            else {
+                UnitTestTransport::send_request_to_server(std::move(request), std::move(completion_block));
+            }
+        }
+    };
+
+    auto config = get_config(instance_of<transport>);
+    config.app_config.coalesce_function_calls = true;
+    TestSyncManager sync_manager(config);
+    auto app = sync_manager.app();
+    auto user = app->sync_manager()->get_user("a_user_id", good_access_token, good_access_token, "anon-user",
+                                              dummy_device_id);
+
+    SECTION("identical function calls share a request") {
+        int completed = 0;
+        auto check_result = [&](Optional<bson::Bson>&& result, Optional<AppError> error) {
+            REQUIRE_FALSE(error);
+            CHECK(result);
+            ++completed;
+        };
+        for (int i = 0; i < 3; ++i)
+            app->call_function(user, "sumFunc", {1, 2}, check_result);
+        app->call_function(user, "sumFunc", {2, 2}, check_result);
+        CHECK(function_call_requests == 2);
+        CHECK(completed == 0);
+
+        auto requests = std::move(pending_requests);
+        pending_requests.clear();
+        for (auto& completion_block : requests)
+            completion_block({200, 0, {}, "3"});
+        CHECK(completed == 4);
+
+        // Once the shared request has completed, a new call makes a new request
+        app->call_function(user, "sumFunc", {1, 2}, check_result);
+        CHECK(function_call_requests == 3);
+    }
+
+    SECTION("concurrent access token refreshes share a request") {
+        int completed = 0;
+        for (int i = 0; i < 3; ++i) {
+            app->refresh_custom_data(user, [&](const Optional<AppError>& error) {
+                REQUIRE_FALSE(error);
+                ++completed;
+            });
+        }
+        CHECK(refresh_requests == 1);
+        REQUIRE(pending_requests.size() == 1);
+        auto completion_block = std::move(pending_requests.front());
+        pending_requests.clear();
+        nlohmann::json json{{"access_token", good_access_token2}};
+        completion_block({200, 0, {}, json.dump()});
+        CHECK(completed == 3);
+        CHECK(user->access_token() == good_access_token2);
+    }
+}
+
 namespace {
 class AsyncMockNetworkTransport {
 public:
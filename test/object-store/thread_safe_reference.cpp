@@ -513,6 +513,37 @@ TEST_CASE("thread safe reference") {
             REQUIRE(results.get(2).get<StringData>(col) == "C");
         }
 
+        SECTION("evaluated object results") {
+            auto& table = *get_table(*r, "string object");
+            auto col = table.get_column_key("value");
+            r->begin_transaction();
+            create_object(r, "string object", {{"value", "A"s}});
+            create_object(r, "string object", {{"value", "B"s}});
+            create_object(r, "string object", {{"value", "C"s}});
+            r->commit_transaction();
+
+            auto results = Results(r, table.where().not_equal(col, "B")).sort({{{col}}, {true}});
+            REQUIRE(results.get(0).get<StringData>(col) == "A");
+            REQUIRE(results.get_mode() == Results::Mode::TableView);
+            auto ref = ThreadSafeReference(results);
+            auto ref_2 = ThreadSafeReference(results);
+
+            SharedRealm r2 = Realm::get_shared_realm(config);
+            // At the same version the matches are used without running the query
+            Results resolved = ref.resolve<Results>(r2);
+            REQUIRE(resolved.get_mode() == Results::Mode::TableView);
+            REQUIRE(resolved.size() == 2);
+            REQUIRE(resolved.get(1).get<StringData>(col) == "C");
+
+            // At a later version they are brought up to date
+            r2->begin_transaction();
+            create_object(r2, "string object", {{"value", "D"s}});
+            r2->commit_transaction();
+            resolved = ref_2.resolve<Results>(r2);
+            REQUIRE(resolved.size() == 3);
+            REQUIRE(resolved.get(2).get<StringData>(col) == "D");
+        }
+
         SECTION("int list") {
             r->begin_transaction();
             auto obj = create_object(r, "int array", {{"value", AnyVector{INT64_C(0)}}});
@@ -331,6 +331,32 @@ TEST_CASE("Transaction log parsing: changeset calcuation") {
             REQUIRE(info.tables.empty());
         }
 
+        SECTION("modifications to untracked columns are ignored") {
+            auto sg = coordinator->begin_read();
+
+            r->begin_transaction();
+            table.get_object(objects[1]).set(cols[0], 10);
+            table.get_object(objects[2]).set(cols[1], 10);
+            table.remove_object(objects[3]);
+            r->commit_transaction();
+
+            _impl::TransactionChangeInfo info{};
+            info.track_columns(table_key, {cols[1]});
+            _impl::transaction::advance(static_cast<Transaction&>(*sg), info);
+            REQUIRE(info.tables.size() == 1);
+            REQUIRE(info.tables[table_key].modifications_size() == 1);
+            REQUIRE(info.tables[table_key].modifications_contains(ObjKey(2), {}));
+            REQUIRE(info.tables[table_key].deletions_contains(ObjKey(3)));
+        }
+
+        SECTION("tracking a whole table overrides column tracking") {
+            _impl::TransactionChangeInfo info{};
+            info.track_columns(table_key, {cols[1]});
+            info.track_table(table_key);
+            info.track_columns(table_key, {cols[1]});
+            REQUIRE(info.tracks_all_columns(table_key));
+        }
+
         SECTION("new row additions are reported") {
             auto info = track_changes({table_key}, [&] {
                 table.create_object();
@@ -2188,4 +2214,42 @@ TEST_CASE("DeepChangeChecker singular links", "[notifications]") {
             }
         }
     }
+
+    SECTION("results are shared between checkers using the same change info") {
+        r->begin_transaction();
+        objects[0].set(cols[1], objects[1].get_key());
+        objects[1].set(cols[1], objects[2].get_key());
+        objects[3].set(cols[1], objects[4].get_key());
+        r->commit_transaction();
+
+        auto info = track_changes([&] {
+            table->get_object(2).set(cols[0], 42);
+        });
+        auto cache = std::make_shared<_impl::DeepChangeCache>();
+        info.deep_change_cache = cache;
+
+        std::vector<_impl::DeepChangeChecker::RelatedTable> cached_related_tables;
+        _impl::DeepChangeChecker::find_related_tables(cached_related_tables, *table, key_path_array_empty,
+                                                      cache->link_graph(r->read_group()));
+        REQUIRE(cached_related_tables.size() == related_tables.size());
+        REQUIRE(cached_related_tables[0].table_key == related_tables[0].table_key);
+        REQUIRE(cached_related_tables[0].links == related_tables[0].links);
+        REQUIRE(&cache->link_graph(r->read_group()) == &cache->link_graph(r->read_group()));
+
+        // Filtered checkers can't share their results with other notifiers
+        REQUIRE_FALSE(_impl::DeepChangeChecker(info, *table, related_tables, key_path_array_int, true)(3));
+        REQUIRE_FALSE(cache->is_not_modified(table->get_key(), objects[3].get_key()));
+
+        REQUIRE(_impl::DeepChangeChecker(info, *table, related_tables, key_path_array_empty, false)(0));
+        REQUIRE_FALSE(_impl::DeepChangeChecker(info, *table, related_tables, key_path_array_empty, false)(3));
+        REQUIRE_FALSE(cache->is_not_modified(table->get_key(), objects[0].get_key()));
+        REQUIRE_FALSE(cache->is_not_modified(table->get_key(), objects[1].get_key()));
+        REQUIRE(cache->is_not_modified(table->get_key(), objects[3].get_key()));
+        REQUIRE(cache->is_not_modified(table->get_key(), objects[4].get_key()));
+
+        // A cached result is used by a later checker without walking the links again
+        cache->mark_not_modified(table->get_key(), objects[1].get_key());
+        REQUIRE_FALSE(_impl::DeepChangeChecker(info, *table, related_tables, key_path_array_empty, false)(0));
+        REQUIRE(_impl::DeepChangeChecker(info, *table, related_tables, key_path_array_int, true)(0));
+    }
 }
@@ -231,6 +231,11 @@ public:
         m_disable_compaction = b;
     }
 
+    void set_transform_max_threads(size_t n)
+    {
+        m_transform_max_threads = n;
+    }
+
     std::map<TableKey, std::unordered_map<GlobalKey, ObjKey>> m_optimistic_object_id_collisions;
 
     ShortCircuitHistory(file_ident_type local_file_ident,
@@ -279,6 +284,7 @@ private:
     std::vector<std::unique_ptr<char[]>> m_entries_data_owner;
     std::map<version_type, std::map<file_ident_type, std::string>> m_reciprocal_transforms;
     bool m_disable_compaction = false;
+    size_t m_transform_max_threads = 1;
 
     ChunkedBinaryData get_reciprocal_transform(file_ident_type remote_file_ident, version_type version) const
     {
@@ -486,6 +492,7 @@ inline auto ShortCircuitHistory::integrate_remote_changesets(file_ident_type rem
     }
 
     TransformHistoryImpl transform_hist{*this, remote_file_ident};
+    m_transformer->set_max_threads(m_transform_max_threads);
     m_transformer->transform_remote_changesets(transform_hist, m_local_file_ident, local_version, changesets, logger);
 
     sync::ChangesetEncoder::Buffer assembled_transformed_changeset;
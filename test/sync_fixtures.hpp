@@ -423,6 +423,10 @@ public:
 
         long server_max_open_files = 64;
 
+        unsigned server_num_workers = 1;
+
+        std::size_t server_download_cache_size = 0;
+
         bool enable_server_ssl = false;
 
         std::string server_ssl_certificate_path = get_test_resource_path() + "test_sync_ca.pem";
@@ -442,6 +446,11 @@ public:
 
         bool disable_upload_activation_delay = false;
 
+        size_t client_download_decompression_threads = 0;
+
+        bool client_snapshot_bootstrap = false;
+        bool server_enable_snapshot_bootstraps = false;
+
         ClusterTopology cluster_topology = ClusterTopology::separate_nodes;
 
         std::string authorization_header_name = "Authorization";
@@ -510,6 +519,8 @@ public:
                 public_key = PKey::load_public(config.server_public_key_path);
             Server::Config config_2;
             config_2.max_open_files = config.server_max_open_files;
+            config_2.num_workers = config.server_num_workers;
+            config_2.download_cache_size = config.server_download_cache_size;
             config_2.logger = &*m_server_loggers[i];
             config_2.token_expiration_clock = &m_fake_token_expiration_clock;
             config_2.ssl = m_enable_server_ssl;
@@ -525,6 +536,7 @@ public:
             config_2.max_protocol_version = config.server_max_protocol_version;
             config_2.disable_download_for = std::move(config.server_disable_download_for);
             config_2.session_bootstrap_callback = std::move(config.server_session_bootstrap_callback);
+            config_2.enable_snapshot_bootstraps = config.server_enable_snapshot_bootstraps;
             m_servers[i] = std::make_unique<Server>(std::move(dir), std::move(public_key), std::move(config_2));
             m_servers[i]->start(listen_address, listen_port);
             m_server_ports[i] = m_servers[i]->listen_endpoint().port();
@@ -541,6 +553,8 @@ public:
             config_2.disable_upload_compaction = config.disable_upload_compaction;
             config_2.one_connection_per_session = config.one_connection_per_session;
             config_2.disable_upload_activation_delay = config.disable_upload_activation_delay;
+            config_2.download_decompression_threads = config.client_download_decompression_threads;
+            config_2.snapshot_bootstrap = config.client_snapshot_bootstrap;
             config_2.fix_up_object_ids = true;
             m_clients[i] = std::make_unique<Client>(std::move(config_2));
         }
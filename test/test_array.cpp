@@ -29,6 +29,7 @@
 #include <realm/array_unsigned.hpp>
 #include <realm/column_integer.hpp>
 #include <realm/query_conditions.hpp>
+#include <realm/util/scope_exit.hpp>
 
 #include "test.hpp"
 
@@ -566,6 +567,37 @@ TEST(Array_Unsigned)
 }
 
 
+TEST(Array_UnsignedBounds)
+{
+    Random random(random_int<unsigned long>());
+    for (uint64_t max : {uint64_t(0xff), uint64_t(0xffff), uint64_t(0xffffffff), uint64_t(-1)}) {
+        std::vector<uint64_t> values;
+        for (size_t i = 0; i < 300; ++i)
+            values.push_back(random.draw_int<uint64_t>(0, max / 2) * 2);
+        std::sort(values.begin(), values.end());
+
+        ArrayUnsigned arr(Allocator::get_default());
+        arr.create(0, max);
+        for (auto v : values)
+            arr.add(v);
+
+        auto check_bounds = [&](uint64_t v) {
+            CHECK_EQUAL(arr.lower_bound(v), size_t(std::lower_bound(values.begin(), values.end(), v) - values.begin()));
+            CHECK_EQUAL(arr.upper_bound(v), size_t(std::upper_bound(values.begin(), values.end(), v) - values.begin()));
+        };
+        for (auto v : values) {
+            check_bounds(v);
+            check_bounds(v + 1);
+            check_bounds(v - 1);
+        }
+        check_bounds(0);
+        check_bounds(max);
+        check_bounds(uint64_t(-1));
+        arr.destroy();
+    }
+}
+
+
 TEST(Array_AddNeg1_1)
 {
     Array c(Allocator::get_default());
@@ -1014,6 +1046,74 @@ TEST(Array_find_sse)
 }
 
 
+// Compares the vectorized finders (AVX-512, AVX2, NEON and SSE) against a naive scan for all byte sized widths, with
+// ranges that start and end at every offset within a vector chunk
+template <class cond>
+static void check_find_vectorized(TestContext& test_context, Array& a, Random& random, int64_t bound)
+{
+    cond c;
+    IntegerColumn r(Allocator::get_default());
+    r.create();
+
+    for (size_t trial = 0; trial < 8; ++trial) {
+        int64_t value = random.chance(1, 2) ? a.get(random.draw_int_mod(a.size()))
+                                            : random.draw_int<int64_t>(-bound, bound - 1);
+        for (size_t start = 0; start < 40; start += 3) {
+            for (size_t end = a.size() - 40; end <= a.size(); end += 5) {
+                r.clear();
+                QueryStateFindAll<IntegerColumn> state(r);
+                ArrayWithFind(a).find<cond>(value, start, end, 0, &state, nullptr);
+
+                std::vector<int64_t> expected;
+                for (size_t i = start; i < end; ++i) {
+                    if (c(a.get(i), value))
+                        expected.push_back(int64_t(i));
+                }
+                CHECK_EQUAL(expected.size(), r.size());
+                if (expected.size() != r.size())
+                    return;
+                for (size_t i = 0; i < expected.size(); ++i)
+                    CHECK_EQUAL(expected[i], r.get(i));
+            }
+        }
+    }
+    r.destroy();
+}
+
+TEST(Array_FindVectorized)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Array a(Allocator::get_default());
+    a.create(Array::type_Normal);
+
+    // Every level of AVX support the CPU has is tested by pretending that the higher ones are missing. Other tests
+    // running meanwhile just take slower paths.
+    const signed char avx_level = avx_support;
+    auto restore_avx_level = util::make_scope_exit([&]() noexcept {
+        avx_support = avx_level;
+    });
+    for (signed char level = avx_level; level >= std::min<signed char>(avx_level, 0); --level) {
+        avx_support = level;
+        for (int64_t bound : {int64_t(100), int64_t(30000), int64_t(2000000000), int64_t(1) << 62}) {
+            a.clear();
+            // Few distinct values so that all conditions get a fair share of matches
+            for (size_t i = 0; i < 300; ++i) {
+                int64_t v = random.draw_int<int64_t>(-3, 3) * (bound / 4);
+                a.add(random.chance(1, 4) ? v + 1 : v);
+            }
+            a.add(-bound);
+            a.add(bound - 1); // Force the bit width
+
+            check_find_vectorized<Equal>(test_context, a, random, bound);
+            check_find_vectorized<NotEqual>(test_context, a, random, bound);
+            check_find_vectorized<Greater>(test_context, a, random, bound);
+            check_find_vectorized<Less>(test_context, a, random, bound);
+        }
+    }
+    a.destroy();
+}
+
+
 TEST(Array_Greater)
 {
     Array a(Allocator::get_default());
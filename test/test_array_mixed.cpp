@@ -150,6 +150,44 @@ TEST(ArrayMixed_Basics)
     arr2.destroy();
 }
 
+TEST(ArrayMixed_FindFirst)
+{
+    ArrayMixed arr(Allocator::get_default());
+    arr.create();
+    CHECK_EQUAL(arr.get_type_mask(), 0);
+
+    arr.add(int64_t(-5));
+    arr.add(int64_t(5000000000));
+    arr.add(false);
+    arr.add("Hello");
+    arr.add({});
+    arr.add(-5.0);
+    arr.add(int64_t(7));
+    arr.add(true);
+    arr.add("World");
+    arr.add(int64_t(5000000000));
+
+    CHECK_EQUAL(arr.get_type_mask(), ArrayMixed::null_type_bit | ArrayMixed::type_bit(type_Int) |
+                                         ArrayMixed::type_bit(type_Bool) | ArrayMixed::type_bit(type_String) |
+                                         ArrayMixed::type_bit(type_Double));
+
+    // Only values of the same type are found
+    CHECK_EQUAL(arr.find_first(int64_t(-5)), 0);
+    CHECK_EQUAL(arr.find_first(-5.0), 5);
+    CHECK_EQUAL(arr.find_first(int64_t(7)), 6);
+    CHECK_EQUAL(arr.find_first(int64_t(7), 0, 6), realm::npos);
+    CHECK_EQUAL(arr.find_first(int64_t(5000000000)), 1);
+    CHECK_EQUAL(arr.find_first(int64_t(5000000000), 2), 9);
+    CHECK_EQUAL(arr.find_first(false), 2);
+    CHECK_EQUAL(arr.find_first(true), 7);
+    CHECK_EQUAL(arr.find_first(Mixed()), 4);
+    CHECK_EQUAL(arr.find_first("World"), 8);
+    CHECK_EQUAL(arr.find_first("World", 0, 8), realm::npos);
+    CHECK_EQUAL(arr.find_first("Hello", 4), realm::npos);
+
+    arr.destroy();
+}
+
 TEST(Mixed_Table)
 {
     Table t;
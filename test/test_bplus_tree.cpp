@@ -431,4 +431,66 @@ TEST(BPlusTree_LeafCache)
     tree.destroy();
 }
 
+TEST(BPlusTree_GetRange)
+{
+    BPlusTree<Int> tree(Allocator::get_default());
+    tree.create();
+    const int n = REALM_MAX_BPNODE_SIZE * 5 + 17;
+    for (int i = 0; i < n; i++) {
+        tree.add(i * 3);
+    }
+
+    std::vector<int64_t> values(n);
+    tree.get_range(0, n, values.data());
+    for (int i = 0; i < n; i++) {
+        CHECK_EQUAL(values[i], i * 3);
+    }
+
+    // Ranges which start and end in the middle of leaves
+    for (size_t begin : {size_t(1), size_t(REALM_MAX_BPNODE_SIZE - 1), size_t(REALM_MAX_BPNODE_SIZE * 2 + 5)}) {
+        size_t end = n - begin / 2;
+        std::vector<int64_t> range(end - begin);
+        tree.get_range(begin, end, range.data());
+        for (size_t i = 0; i < range.size(); i++) {
+            CHECK_EQUAL(range[i], int64_t(begin + i) * 3);
+        }
+    }
+    tree.get_range(5, 5, nullptr);
+    tree.destroy();
+}
+
+TEST(BPlusTree_Move)
+{
+    BPlusTree<StringData> tree(Allocator::get_default());
+    tree.create();
+    std::vector<std::string> expected;
+    const size_t n = REALM_MAX_BPNODE_SIZE * 3 + 7;
+    for (size_t i = 0; i < n; i++) {
+        expected.push_back("value " + util::to_string(i));
+        tree.add(expected.back());
+    }
+
+    auto move = [&](size_t from, size_t to) {
+        tree.move(from, to);
+        auto value = expected[from];
+        expected.erase(expected.begin() + from);
+        expected.insert(expected.begin() + to, value);
+    };
+    // Within the first leaf in both directions, across leaves in both
+    // directions, and to and from both ends
+    move(1, 5);
+    move(5, 1);
+    move(2, n - 2);
+    move(n - 3, 3);
+    move(0, n - 1);
+    move(n - 1, 0);
+    move(REALM_MAX_BPNODE_SIZE, REALM_MAX_BPNODE_SIZE + 1);
+
+    CHECK_EQUAL(tree.size(), n);
+    for (size_t i = 0; i < n; i++) {
+        CHECK_EQUAL(tree.get(i), expected[i]);
+    }
+    tree.destroy();
+}
+
 #endif // TEST_BPLUS_TREE
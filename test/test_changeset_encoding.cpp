@@ -10,12 +10,12 @@ using namespace realm::sync::instr;
 using realm::sync::Changeset;
 
 namespace {
-Changeset encode_then_parse(const Changeset& changeset)
+Changeset encode_then_parse(const Changeset& changeset, bool columnar_updates = false)
 {
     using realm::util::SimpleNoCopyInputStream;
 
     sync::ChangesetEncoder::Buffer buffer;
-    encode_changeset(changeset, buffer);
+    encode_changeset(changeset, buffer, columnar_updates);
     SimpleNoCopyInputStream stream{buffer};
     Changeset parsed;
     parse_changeset(stream, parsed);
@@ -277,6 +277,46 @@ TEST(ChangesetEncoding_Clear)
     CHECK(**changeset.begin() == instr);
 }
 
+TEST(ChangesetEncoding_UpdateRun)
+{
+    Changeset changeset;
+    auto table = changeset.intern_string("Foo");
+    auto make_update = [&](PrimaryKey key, StringData field, Payload value) {
+        Update instr;
+        instr.table = table;
+        instr.object = key;
+        instr.field = changeset.intern_string(field);
+        instr.value = value;
+        return instr;
+    };
+    const char* names[] = {"a", "b", "c"};
+    for (int64_t i = 0; i < 100; ++i)
+        changeset.push_back(make_update(i + 1000, "name", Payload{changeset.append_string(names[i % 3])}));
+    for (int64_t i = 0; i < 100; ++i)
+        changeset.push_back(make_update(1000 - i, "value", Payload{i * i}));
+    // Too short to be a run
+    changeset.push_back(make_update(mpark::monostate{}, "value", Payload{int64_t(1)}));
+    changeset.push_back(make_update(mpark::monostate{}, "value", Payload{int64_t(2)}));
+    for (int i = 0; i < 10; ++i)
+        changeset.push_back(make_update(ObjectId::gen(), "value", Payload{double(i)}));
+    for (int i = 0; i < 10; ++i)
+        changeset.push_back(make_update(UUID{}, "value", Payload{}));
+    Update not_in_run = make_update(int64_t(1), "value", Payload{int64_t(1)});
+    not_in_run.path.push_back(changeset.intern_string("field"));
+    changeset.push_back(not_in_run);
+
+    // String payloads compare by their offset in the string buffer, which is
+    // the same for both parsed changesets.
+    auto parsed = encode_then_parse(changeset, true);
+    CHECK_EQUAL(encode_then_parse(changeset), parsed);
+    CHECK_EQUAL(parsed.size(), changeset.size());
+
+    sync::ChangesetEncoder::Buffer columnar, regular;
+    encode_changeset(changeset, columnar, true);
+    encode_changeset(changeset, regular);
+    CHECK_LESS(columnar.size() * 2, regular.size());
+}
+
 TEST(ChangesetEncoding_AccentWords)
 {
     sync::ChangesetEncoder encoder;
@@ -326,10 +366,42 @@ void encode_string(util::AppendBuffer<char>& buffer, uint32_t index, std::string
 TEST(ChangesetParser_BadInstruction)
 {
     util::AppendBuffer<char> buffer;
-    encode_instruction(buffer, 0x3e);
+    encode_instruction(buffer, 0x3d);
     CHECK_BADCHANGESET(buffer, "unknown instruction");
 }
 
+TEST(ChangesetParser_BadUpdateRun_DictionaryIndex)
+{
+    util::AppendBuffer<char> buffer;
+    encode_string(buffer, 0, "table");
+    encode_string(buffer, 1, "field");
+    encode_instruction(buffer, sync::InstrTypeUpdateRun);
+    encode_int(buffer, 2);                              // Count
+    encode_int(buffer, 0);                              // Table
+    encode_int(buffer, 1);                              // Field
+    encode_int(buffer, int64_t(Payload::Type::Int));    // Key type
+    encode_int(buffer, int64_t(Payload::Type::String)); // Value type
+    encode_int(buffer, 0);                              // is_default
+    encode_int(buffer, 1);                              // Keys
+    encode_int(buffer, 1);
+    encode_int(buffer, 1); // Index of a string that has not been seen
+    CHECK_BADCHANGESET(buffer, "Invalid dictionary index");
+}
+
+TEST(ChangesetParser_BadUpdateRun_ValueType)
+{
+    util::AppendBuffer<char> buffer;
+    encode_string(buffer, 0, "table");
+    encode_string(buffer, 1, "field");
+    encode_instruction(buffer, sync::InstrTypeUpdateRun);
+    encode_int(buffer, 1);                            // Count
+    encode_int(buffer, 0);                            // Table
+    encode_int(buffer, 1);                            // Field
+    encode_int(buffer, int64_t(Payload::Type::Int));  // Key type
+    encode_int(buffer, int64_t(Payload::Type::Link)); // Value type
+    CHECK_BADCHANGESET(buffer, "Unsupported payload type in update run");
+}
+
 TEST(ChangesetParser_GoodInternString)
 {
     util::AppendBuffer<char> buffer;
@@ -24,6 +24,7 @@
 #include <realm/bplustree.hpp>
 #include <realm/array_string.hpp>
 #include <realm/array_key.hpp>
+#include <realm/alloc_slab.hpp>
 
 #include "test.hpp"
 #include "test_string_types.hpp"
@@ -905,4 +906,82 @@ TEST(ColumnString_NonLeafRoot)
     }
 }
 
+TEST(ColumnString_DictEncodedLeaf)
+{
+    const char* statuses[] = {"pending", "active", "suspended", "closed"};
+    std::string long_status(100, 'x');
+
+    // Leaves are only encoded by allocators which have the encoding enabled
+    {
+        ArrayString plain(Allocator::get_default());
+        plain.create();
+        for (size_t i = 0; i < 64; ++i)
+            plain.add(statuses[i % 4]);
+        CHECK_NOT(plain.is_dict_encoded());
+        plain.destroy();
+    }
+
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    alloc.set_enabled_encodings(Allocator::encoding_DictStrings);
+    ArrayString arr(alloc);
+    arr.create();
+    std::vector<util::Optional<std::string>> model;
+    auto check_model = [&] {
+        CHECK_EQUAL(arr.size(), model.size());
+        for (size_t i = 0; i < model.size(); ++i) {
+            CHECK_EQUAL(arr.get(i), model[i] ? StringData(*model[i]) : StringData());
+            CHECK_EQUAL(arr.is_null(i), !model[i]);
+        }
+        arr.verify();
+    };
+
+    for (size_t i = 0; i < 63; ++i) {
+        model.push_back(std::string(statuses[i % 4]));
+        arr.add(statuses[i % 4]);
+    }
+    CHECK_NOT(arr.is_dict_encoded());
+    model.push_back(util::none);
+    arr.add(StringData());
+    CHECK(arr.is_dict_encoded());
+    CHECK_EQUAL(arr.get_dict_size(), 5);
+    check_model();
+
+    // Accessors attached to the leaf see the encoding
+    ArrayString arr2(alloc);
+    arr2.init_from_ref(arr.get_ref());
+    CHECK(arr2.is_dict_encoded());
+    CHECK_EQUAL(arr2.get(2), "suspended");
+    CHECK_EQUAL(ArrayString::get(alloc.translate(arr.get_ref()), 3, alloc), "closed");
+
+    CHECK_EQUAL(arr.find_first("active", 0, arr.size()), 1);
+    CHECK_EQUAL(arr.find_first("active", 2, arr.size()), 5);
+    CHECK_EQUAL(arr.find_first(StringData(), 0, arr.size()), 63);
+    CHECK_EQUAL(arr.find_first("", 0, arr.size()), not_found);
+    CHECK_EQUAL(arr.find_first("unknown", 0, arr.size()), not_found);
+    CHECK_EQUAL(arr.find_dict_code("unknown"), not_found);
+    CHECK_EQUAL(arr.get_dict_code(1), arr.find_dict_code("active"));
+
+    // Modifications, including a value too big for short strings, keep the encoding
+    arr.set(0, long_status);
+    model[0] = long_status;
+    arr.insert(10, "");
+    model.insert(model.begin() + 10, std::string(""));
+    arr.erase(20);
+    model.erase(model.begin() + 20);
+    CHECK(arr.is_dict_encoded());
+    check_model();
+
+    // Too many distinct values decodes the leaf
+    for (size_t i = 0; i < 100; ++i) {
+        std::string s = "status " + util::to_string(i);
+        arr.add(s);
+        model.push_back(s);
+    }
+    CHECK_NOT(arr.is_dict_encoded());
+    check_model();
+
+    arr.destroy();
+}
+
 #endif // TEST_COLUMN_STRING
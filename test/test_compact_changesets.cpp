@@ -252,6 +252,139 @@ TEST_IF(CompactChangesets_EraseRecreate, false)
 }
 
 
+TEST(CompactChangesets_UploadRedundantSetsAcrossChangesets)
+{
+    using Instruction = realm::sync::Instruction;
+    Changeset changesets[2];
+    InstructionBuilder push_1(changesets[0]);
+    InstructionBuilder push_2(changesets[1]);
+    changesets[0].origin_timestamp = 1;
+    changesets[1].origin_timestamp = 2;
+
+    auto make_set = [](Changeset& changeset, StringData field, int64_t value) {
+        Instruction::Update set;
+        set.table = changeset.intern_string("Test");
+        set.object = ObjectId::gen();
+        set.field = changeset.intern_string(field);
+        set.value = Instruction::Payload(value);
+        return set;
+    };
+
+    auto set_foo_1 = make_set(changesets[0], "foo", 1);
+    push_1(set_foo_1);
+    auto set_bar_1 = make_set(changesets[0], "bar", 2);
+    set_bar_1.object = set_foo_1.object;
+    push_1(set_bar_1);
+
+    auto set_foo_2 = make_set(changesets[1], "foo", 3);
+    set_foo_2.object = set_foo_1.object;
+    push_2(set_foo_2);
+
+    // An AddInteger relies on the preceding value of the field.
+    Instruction::AddInteger add_bar;
+    add_bar.table = changesets[1].intern_string("Test");
+    add_bar.object = set_foo_1.object;
+    add_bar.field = changesets[1].intern_string("bar");
+    add_bar.value = 1;
+    push_2(add_bar);
+    auto set_bar_2 = make_set(changesets[1], "bar", 4);
+    set_bar_2.object = set_foo_1.object;
+    push_2(set_bar_2);
+
+    compact_changesets_for_upload(changesets, 2);
+
+    CHECK_EQUAL(changesets[0].size(), 1);
+    for (auto instr : changesets[0]) {
+        if (instr)
+            CHECK_EQUAL(instr->get_as<Instruction::Update>().value.data.integer, 2);
+    }
+    CHECK_EQUAL(changesets[1].size(), 3);
+}
+
+TEST(CompactChangesets_UploadDiscardsCreateErasePair)
+{
+    using Instruction = realm::sync::Instruction;
+    Changeset changesets[3];
+    InstructionBuilder push_1(changesets[0]);
+    InstructionBuilder push_2(changesets[1]);
+    InstructionBuilder push_3(changesets[2]);
+
+    auto object_id = ObjectId::gen();
+    Instruction::CreateObject create;
+    create.table = changesets[0].intern_string("Test");
+    create.object = object_id;
+    push_1(create);
+
+    Instruction::Update set;
+    set.table = changesets[1].intern_string("Test");
+    set.object = object_id;
+    set.field = changesets[1].intern_string("foo");
+    set.value = Instruction::Payload(int64_t(123));
+    push_2(set);
+
+    Instruction::EraseObject erase;
+    erase.table = changesets[2].intern_string("Test");
+    erase.object = object_id;
+    push_3(erase);
+
+    compact_changesets_for_upload(changesets, 3);
+
+    CHECK(changesets[0].empty());
+    CHECK(changesets[1].empty());
+    CHECK(changesets[2].empty());
+
+    util::AppendBuffer<char> encoded;
+    encode_changeset(changesets[0], encoded);
+    CHECK_EQUAL(encoded.size(), 0);
+}
+
+TEST(CompactChangesets_UploadKeepsCreateErasePair)
+{
+    using Instruction = realm::sync::Instruction;
+
+    // Objects with integer primary keys may have been created by other
+    // clients as well.
+    {
+        Changeset changeset;
+        InstructionBuilder push(changeset);
+        Instruction::CreateObject create;
+        create.table = changeset.intern_string("Test");
+        create.object = int64_t(1);
+        push(create);
+        Instruction::EraseObject erase;
+        erase.table = create.table;
+        erase.object = int64_t(1);
+        push(erase);
+
+        compact_changesets_for_upload(&changeset, 1);
+        CHECK_EQUAL(changeset.size(), 2);
+    }
+
+    // Objects that are the target of a link are kept.
+    {
+        Changeset changeset;
+        InstructionBuilder push(changeset);
+        auto object_id = ObjectId::gen();
+        Instruction::CreateObject create;
+        create.table = changeset.intern_string("Test");
+        create.object = object_id;
+        push(create);
+        Instruction::Update set_link;
+        set_link.table = changeset.intern_string("Origin");
+        set_link.object = int64_t(1);
+        set_link.field = changeset.intern_string("link");
+        set_link.value = Instruction::Payload(Instruction::Payload::Link{create.table, object_id});
+        push(set_link);
+        Instruction::EraseObject erase;
+        erase.table = create.table;
+        erase.object = object_id;
+        push(erase);
+
+        compact_changesets_for_upload(&changeset, 1);
+        CHECK_EQUAL(changeset.size(), 3);
+    }
+}
+
 #if 0
 TEST(CompactChangesets_PrimaryKeysRescueObjects)
 {
@@ -18,6 +18,7 @@
 
 #include <realm.hpp>
 #include <realm/array_decimal128.hpp>
+#include <realm/alloc_slab.hpp>
 
 #include "test.hpp"
 
@@ -179,6 +180,34 @@ TEST(Decimal_Arithmetics)
     CHECK_EQUAL(q.to_string(), "200");
 }
 
+TEST(Decimal_SameExponentArithmetics)
+{
+    // Values with the same exponent take a shortcut past the BID library, and
+    // must give the same results
+    Decimal128 a("1.50");
+    Decimal128 b("2.25");
+    CHECK_EQUAL((a + b).to_string(), "3.75");
+    CHECK_EQUAL((a - b).to_string(), "-7.5E-1");
+    CHECK_EQUAL((b - a).to_string(), "7.5E-1");
+    CHECK_EQUAL((Decimal128("-1.50") - b).to_string(), "-3.75");
+    CHECK_EQUAL((Decimal128("-1.50") + a).to_string(), (Decimal128("-1.50") + Decimal128("1.5")).to_string());
+    CHECK_EQUAL((Decimal128("-0.00") + Decimal128("-0.00")).to_string(), "-0E-2");
+
+    Decimal128 max_low_word(Decimal128::Bid128{{~uint64_t(0), 0}}, 0, false);
+    CHECK_EQUAL((max_low_word + Decimal128(1)).to_string(), "+18446744073709551616E+0");
+    CHECK_EQUAL((max_low_word - Decimal128(-1)).to_string(), "+18446744073709551616E+0");
+
+    CHECK(a < b);
+    CHECK(Decimal128("-1.50") < a);
+    CHECK(Decimal128("-2.25") < Decimal128("-1.50"));
+    CHECK_NOT(a < a);
+    CHECK(a == Decimal128("1.50"));
+    CHECK(a != Decimal128("-1.50"));
+    CHECK(Decimal128("0.00") == Decimal128("-0.00"));
+    CHECK_EQUAL(Decimal128("0.00").compare(Decimal128("-0.00")), 0);
+    CHECK_EQUAL(Decimal128("-0.00").compare(Decimal128("0.01")), -1);
+}
+
 TEST(Decimal_Array)
 {
     const char str0[] = "12345.67";
@@ -213,6 +242,65 @@ TEST(Decimal_Array)
     arr1.destroy();
 }
 
+TEST(Decimal_CompactArray)
+{
+    // Leaves are only compact if the allocator has the encoding enabled
+    {
+        ArrayDecimal128 arr(Allocator::get_default());
+        arr.create();
+        arr.add(Decimal128("1000.00"));
+        CHECK_NOT(arr.is_compact());
+        arr.destroy();
+    }
+
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    alloc.set_enabled_encodings(Allocator::encoding_CompactDecimals);
+    ArrayDecimal128 arr(alloc);
+    arr.create();
+
+    // Values are read back with the same representation as they were stored
+    std::vector<Decimal128> values = {Decimal128("1000.00"), Decimal128("-45"), Decimal128(realm::null()),
+                                      Decimal128("0.000001"), Decimal128("-0"), Decimal128("123456789012.34")};
+    for (auto& value : values)
+        arr.add(value);
+    CHECK(arr.is_compact());
+    for (size_t i = 0; i < values.size(); ++i)
+        CHECK_EQUAL(arr.get(i).to_string(), values[i].to_string());
+    CHECK(arr.is_null(2));
+    CHECK_EQUAL(arr.find_first(Decimal128("-45.0")), 1);
+
+    size_t count;
+    CHECK_EQUAL(arr.sum(count), Decimal128("123456789967.340001"));
+    CHECK_EQUAL(count, 5);
+
+    ArrayDecimal128 arr1(alloc);
+    arr1.create();
+    arr.move(arr1, 4);
+    CHECK(arr1.is_compact());
+    CHECK_EQUAL(arr1.size(), 2);
+    CHECK_EQUAL(arr1.get(1), Decimal128("123456789012.34"));
+
+    // A value with a large coefficient expands the leaf
+    Decimal128 large("1234567890123456789012345");
+    arr.set(1, large);
+    CHECK_NOT(arr.is_compact());
+    CHECK_EQUAL(arr.get(0), Decimal128("1000.00"));
+    CHECK_EQUAL(arr.get(1), large);
+    CHECK(arr.is_null(2));
+    arr.add(Decimal128::nan("0"));
+    CHECK_EQUAL(arr.sum(count), large + Decimal128("1000.000001"));
+    CHECK_EQUAL(count, 3);
+
+    // Moving between the two forms converts the values
+    arr1.move(arr, 0);
+    CHECK_EQUAL(arr.size(), 7);
+    CHECK_EQUAL(arr.get(6), Decimal128("123456789012.34"));
+
+    arr.destroy();
+    arr1.destroy();
+}
+
 TEST(Decimal_Table)
 {
     const char str0[] = "12345.67";
@@ -778,3 +778,57 @@ NONCONCURRENT_TEST(Dictionary_HashCollisionTransaction)
     do_Dictionary_HashCollisionTransaction(test_context, 100, 0xFF);  // One node cluster
     do_Dictionary_HashCollisionTransaction(test_context, 500, 0x3FF); // Three node cluster
 }
+
+NONCONCURRENT_TEST(Dictionary_SmallLookup)
+{
+    constexpr int64_t nb_entries = 40;
+    auto mask = Dictionary::set_hash_mask(0xFF); // Some collisions
+    Group g;
+    auto foos = g.add_table("Foo");
+    ColKey col_dict = foos->add_column_dictionary(type_Mixed, "dict");
+
+    auto foo = foos->create_object();
+    auto dict = foo.get_dictionary(col_dict);
+    for (int64_t i = 0; i < nb_entries; i++) {
+        dict.insert("key" + util::to_string(i), i);
+    }
+
+    // Repeated lookups go through the snapshot of the keys
+    for (int pass = 0; pass < 3; pass++) {
+        for (int64_t i = 0; i < nb_entries; i++) {
+            std::string key = "key" + util::to_string(i);
+            CHECK_EQUAL(dict.get(key).get_int(), i);
+            size_t ndx = dict.find_any_key(key);
+            CHECK_EQUAL(dict.get_key(ndx).get_string(), key);
+        }
+        CHECK_NOT(dict.contains("key" + util::to_string(nb_entries + pass)));
+    }
+
+    // The snapshot must follow modifications made through this accessor ...
+    dict.erase("key7");
+    CHECK_NOT(dict.contains("key7"));
+    CHECK_NOT(dict.try_get("key7"));
+    CHECK_EQUAL(dict.find_any_key("key7"), realm::npos);
+    dict.insert("key7", "seven");
+    CHECK_EQUAL(dict.get("key7"), Mixed("seven"));
+    CHECK_EQUAL(dict.get("key8").get_int(), 8);
+
+    // ... and through other accessors
+    auto dict2 = foo.get_dictionary(col_dict);
+    dict2.erase("key8");
+    dict2.insert("extra", 100);
+    CHECK_NOT(dict.contains("key8"));
+    CHECK_EQUAL(dict.get("extra").get_int(), 100);
+    CHECK_EQUAL(dict.size(), nb_entries);
+    for (int64_t i = 0; i < nb_entries; i++) {
+        if (i == 7 || i == 8)
+            continue;
+        CHECK_EQUAL(dict.get("key" + util::to_string(i)).get_int(), i);
+    }
+
+    dict2.clear();
+    CHECK_NOT(dict.contains("key1"));
+    CHECK_EQUAL(dict.size(), 0);
+
+    Dictionary::set_hash_mask(mask);
+}
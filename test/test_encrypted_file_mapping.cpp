@@ -184,5 +184,54 @@ TEST(EncryptedFile_LargePages)
     close(fd);
 }
 
+TEST(EncryptedFile_RotateKey)
+{
+    TEST_PATH(path);
+    const char new_key[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijkl";
+
+    // More blocks than one metadata block covers, so that there are two ranges
+    std::vector<char> data(4096 * 100);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i * 7);
+
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    {
+        AESCryptor cryptor(test_key);
+        cryptor.set_file_size(data.size());
+        cryptor.write(fd, 0, data.data(), data.size());
+    }
+    // The first data block follows the first metadata block
+    char old_block[4096];
+    CHECK_EQUAL(pread(fd, old_block, sizeof(old_block), 4096), 4096);
+
+    auto check_new_key = [&] {
+        AESCryptor cryptor(reinterpret_cast<const uint8_t*>(new_key));
+        cryptor.set_file_size(data.size());
+        std::vector<char> buffer(data.size());
+        CHECK(cryptor.read(fd, 0, buffer.data(), buffer.size()));
+        CHECK(buffer == data);
+    };
+    rotate_encryption_key(path, reinterpret_cast<const char*>(test_key), new_key, 2);
+    check_new_key();
+
+    // Fake a rotation interrupted after updating the IV table but not the data
+    // of the first block. Then it cannot be read with the new key until the
+    // rotation is run again.
+    CHECK_EQUAL(pwrite(fd, old_block, sizeof(old_block), 4096), 4096);
+    {
+        AESCryptor cryptor(reinterpret_cast<const uint8_t*>(new_key));
+        cryptor.set_file_size(data.size());
+        std::vector<char> buffer(data.size());
+        CHECK_THROW(cryptor.read(fd, 0, buffer.data(), buffer.size()), DecryptionFailed);
+    }
+    rotate_encryption_key(path, reinterpret_cast<const char*>(test_key), new_key, 1);
+    check_new_key();
+
+    // Rotating a file which already uses the new key changes nothing
+    rotate_encryption_key(path, reinterpret_cast<const char*>(test_key), new_key);
+    check_new_key();
+    close(fd);
+}
+
 #endif // REALM_ENABLE_ENCRYPTION
 #endif // TEST_ENCRYPTED_FILE_MAPPING
@@ -322,6 +322,38 @@ TEST(File_ReadWrite)
 }
 
 
+TEST(File_WriteBatch)
+{
+    TEST_PATH(path);
+    File f(path, File::mode_Write);
+    // More requests than fit in a single submission when using io_uring
+    const size_t num_blocks = 300;
+    const size_t block_size = 100;
+    f.resize(num_blocks * block_size);
+
+    std::vector<std::string> blocks;
+    std::vector<File::WriteRequest> requests;
+    for (size_t i = 0; i < num_blocks; ++i)
+        blocks.push_back(std::string(block_size, char('a' + i % 26)));
+    // Write every other block, and the rest in a second batch
+    for (size_t i = 0; i < num_blocks; i += 2)
+        requests.push_back({File::SizeType(i * block_size), blocks[i].data(), block_size});
+    f.write_batch(requests, false);
+    requests.clear();
+    for (size_t i = 1; i < num_blocks; i += 2)
+        requests.push_back({File::SizeType(i * block_size), blocks[i].data(), block_size});
+    f.write_batch(requests, true);
+
+    // The data must be visible through a memory mapping too
+    File::Map<char> m(f, File::access_ReadOnly, num_blocks * block_size);
+    for (size_t i = 0; i < num_blocks; ++i)
+        CHECK_EQUAL(std::string(m.get_addr() + i * block_size, block_size), blocks[i]);
+
+    // A barrier on its own is fine too
+    f.write_batch({}, true);
+}
+
+
 TEST(File_Resize)
 {
     TEST_PATH(path);
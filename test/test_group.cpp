@@ -624,6 +624,55 @@ TEST(Group_RenameTable)
 }
 
 
+TEST(Group_ManyTableNames)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    auto name = [](int i) {
+        return "class_Table" + util::to_string(i);
+    };
+
+    // Enough tables for the names to be found through a hash table
+    auto wt = db->start_write();
+    for (int i = 0; i < 50; ++i)
+        wt->add_table(name(i));
+    for (int i = 0; i < 50; ++i)
+        CHECK_EQUAL(wt->get_table(name(i))->get_name(), name(i));
+    CHECK_NOT(wt->has_table("class_Missing"));
+    CHECK_THROW(wt->add_table(name(7)), TableNameInUse);
+
+    wt->remove_table(name(3));
+    wt->rename_table(name(4), name(3));
+    CHECK_EQUAL(wt->find_table(name(3)), wt->get_table(name(3))->get_key());
+    CHECK_NOT(wt->has_table(name(4)));
+    wt->add_table(name(4));
+    CHECK(wt->has_table(name(4)));
+    wt->commit_and_continue_as_read();
+
+    // Names changed by another transaction are seen after advancing
+    auto rt = db->start_read();
+    CHECK(rt->has_table(name(10)));
+    {
+        auto wt2 = db->start_write();
+        wt2->rename_table(name(10), "class_Renamed");
+        wt2->commit();
+    }
+    CHECK(rt->has_table(name(10)));
+    rt->advance_read();
+    CHECK_NOT(rt->has_table(name(10)));
+    CHECK(rt->has_table("class_Renamed"));
+
+    // and are restored by a rollback
+    wt->promote_to_write();
+    wt->rename_table(name(20), "class_Gone");
+    CHECK_NOT(wt->has_table(name(20)));
+    wt->rollback_and_continue_as_read();
+    CHECK(wt->has_table(name(20)));
+    CHECK_NOT(wt->has_table("class_Gone"));
+    CHECK(wt->has_table("class_Renamed"));
+}
+
 TEST(Group_Equal)
 {
     Group g1, g2, g3;
@@ -1381,6 +1430,77 @@ TEST(Group_WriteEmpty)
 }
 
 
+TEST(Group_StorageStats)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    ColKey col_int, col_str, col_link;
+    {
+        auto wt = db->start_write();
+        auto origin = wt->add_table("origin");
+        auto target = wt->add_table("target");
+        col_int = origin->add_column(type_Int, "int");
+        col_str = origin->add_column(type_String, "str");
+        col_link = origin->add_column(*target, "link");
+        origin->add_search_index(col_str);
+        auto target_obj = target->create_object();
+        for (int i = 0; i < 5000; ++i) {
+            origin->create_object().set(col_int, i).set(col_str, util::format("str %1", i)).set(col_link,
+                                                                                             target_obj.get_key());
+        }
+        wt->commit();
+    }
+    // Leave some free space behind
+    for (int i = 0; i < 3; ++i) {
+        auto wt = db->start_write();
+        auto origin = wt->get_table("origin");
+        origin->get_object(i).set(col_int, -i);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    StorageStats stats = rt->get_storage_stats();
+    CHECK_NOT(stats.is_estimate);
+    CHECK_EQUAL(stats.tables.size(), 2);
+    CHECK_GREATER(stats.history_bytes, 0);
+    CHECK_GREATER(stats.free_list.num_chunks, 0);
+    CHECK_GREATER_EQUAL(stats.free_list.free_bytes, stats.free_list.largest_chunk);
+    CHECK_EQUAL(stats.file_size - stats.free_list.free_bytes, rt->get_used_space());
+
+    // Every array node is accounted for exactly once
+    CHECK_EQUAL(stats.history_bytes, rt->compute_aggregated_byte_size(Group::size_of_history));
+    CHECK_EQUAL(stats.free_list.bookkeeping_bytes, rt->compute_aggregated_byte_size(Group::size_of_freelists));
+    for (auto& table : stats.tables)
+        CHECK_EQUAL(table.get_total_bytes(), rt->get_table(table.key)->compute_aggregated_byte_size());
+
+    auto& origin = stats.tables[0].name == "origin" ? stats.tables[0] : stats.tables[1];
+    auto& target = stats.tables[0].name == "origin" ? stats.tables[1] : stats.tables[0];
+    CHECK_EQUAL(origin.name, "origin");
+    CHECK_EQUAL(origin.num_objects, 5000);
+    CHECK_EQUAL(origin.backlink_bytes, 0);
+    CHECK_EQUAL(origin.columns.size(), 3);
+    for (auto& column : origin.columns) {
+        CHECK_GREATER(column.payload_bytes, 0);
+        CHECK_EQUAL(column.index_bytes > 0, column.key == col_str);
+    }
+    CHECK_EQUAL(target.num_objects, 1);
+    CHECK_GREATER(target.backlink_bytes, 0);
+    CHECK(target.columns.empty());
+
+    // Sampling every other cluster gives an estimate of the same magnitude
+    StorageStats sampled = rt->get_storage_stats(2);
+    CHECK(sampled.is_estimate);
+    auto& sampled_origin = sampled.tables[0].name == "origin" ? sampled.tables[0] : sampled.tables[1];
+    for (size_t i = 0; i < origin.columns.size(); ++i) {
+        auto exact = double(origin.columns[i].payload_bytes);
+        auto estimate = double(sampled_origin.columns[i].payload_bytes);
+        CHECK(estimate > exact / 2 && estimate < exact * 2);
+        CHECK_EQUAL(sampled_origin.columns[i].index_bytes, origin.columns[i].index_bytes);
+    }
+}
+
+
 #ifdef REALM_DEBUG
 #ifdef REALM_TO_DOT
 
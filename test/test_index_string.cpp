@@ -762,6 +762,51 @@ TEST(StringIndex_Count_Int)
 }
 
 
+TEST(StringIndex_DuplicatesInKeyOrder)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_str = table.add_column(type_String, "str", true);
+    table.add_search_index(col_int);
+    table.add_search_index(col_str);
+
+    // Appended to the lists of duplicates
+    for (int64_t k = 100; k < 1100; ++k) {
+        auto obj = table.create_object(ObjKey(k));
+        obj.set(col_int, k % 3);
+        obj.set(col_str, util::to_string(k % 3));
+        if (k % 5 == 0) {
+            obj.set_null(col_int);
+            obj.set_null(col_str);
+        }
+    }
+    // Inserted before the keys already in the lists
+    for (int64_t k = 0; k < 100; ++k) {
+        auto obj = table.create_object(ObjKey(k));
+        obj.set(col_int, k % 3);
+        obj.set(col_str, util::to_string(k % 3));
+    }
+
+    auto check_keys = [&](ColKey col, Mixed value) {
+        std::vector<ObjKey> expected;
+        for (auto obj : table) {
+            if (obj.get_any(col) == value)
+                expected.push_back(obj.get_key());
+        }
+        std::sort(expected.begin(), expected.end());
+        std::vector<ObjKey> found;
+        table.get_search_index(col)->find_all(found, value);
+        CHECK(found == expected);
+    };
+    for (int64_t i = 0; i < 3; ++i) {
+        check_keys(col_int, i);
+        check_keys(col_str, util::to_string(i));
+    }
+    check_keys(col_int, Mixed());
+    check_keys(col_str, Mixed());
+    table.verify();
+}
+
 TEST(StringIndex_Distinct_Int)
 {
     // Create a column with duplicate values
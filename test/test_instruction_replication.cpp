@@ -676,3 +676,106 @@ TEST(InstructionReplication_Dictionary)
         CHECK_EQUAL(dict.get("d"), true);
     }
 }
+
+TEST(InstructionReplication_AlternatingTablesAndSchemaChanges)
+{
+    Fixture fixture{test_context};
+    {
+        WriteTransaction wt{fixture.sg_1};
+        TableRef a = wt.get_group().add_table_with_primary_key("class_a", type_Int, "pk");
+        TableRef b = wt.get_group().add_table_with_primary_key("class_b", type_Int, "pk");
+        ColKey a_x = a->add_column(type_Int, "x");
+        ColKey a_y = a->add_column(type_Int, "y");
+        ColKey b_x = b->add_column(type_Int, "x");
+        for (int64_t i = 0; i < 10; ++i) {
+            a->create_object_with_primary_key(i).set(a_x, i).set(a_y, -i);
+            b->create_object_with_primary_key(i).set(b_x, 2 * i);
+        }
+
+        // Replace columns and tables by ones of the same name, so that
+        // resolutions made earlier in the changeset become stale.
+        wt.get_group().remove_table("class_b");
+        b = wt.get_group().add_table_with_primary_key("class_b", type_String, "pk");
+        b_x = b->add_column(type_Double, "x");
+        for (int64_t i = 0; i < 10; ++i) {
+            a->get_object_with_primary_key(i).set(a_x, 3 * i);
+            b->create_object_with_primary_key(util::to_string(i)).set(b_x, double(i));
+        }
+        a->remove_column(a_x);
+        a_x = a->add_column(type_String, "x");
+        for (int64_t i = 0; i < 10; ++i) {
+            a->get_object_with_primary_key(i).set(a_x, "a").set(a_y, i);
+            b->get_object_with_primary_key(util::to_string(i)).set(b_x, -double(i));
+        }
+        wt.commit();
+    }
+    fixture.replay_transactions();
+    fixture.check_equal();
+    {
+        ReadTransaction rt{fixture.sg_2};
+        ConstTableRef b = rt.get_table("class_b");
+        CHECK_EQUAL(b->size(), 10);
+        CHECK_EQUAL(b->get_column_type(b->get_column_key("x")), type_Double);
+    }
+}
+
+TEST(InstructionReplication_AsymmetricObjectsAreNotStored)
+{
+    Fixture fixture{test_context};
+    ColKey col_value, col_sensor;
+    {
+        WriteTransaction wt{fixture.sg_1};
+        auto table =
+            wt.get_group().add_table_with_primary_key("class_reading", type_Int, "_id", false,
+                                                      Table::Type::TopLevelAsymmetric);
+        col_value = table->add_column(type_Double, "value");
+        col_sensor = table->add_column(type_String, "sensor", true);
+        wt.get_group().add_table_with_primary_key("class_plain", type_Int, "_id");
+        wt.commit();
+    }
+    {
+        WriteTransaction wt{fixture.sg_1};
+        auto table = wt.get_table("class_reading");
+        for (int64_t i = 0; i < 3; ++i) {
+            Obj obj = table->create_asymmetric_object(i, {{col_value, 1.5 * i}, {col_sensor, "north"}});
+            CHECK_NOT(obj.is_valid());
+        }
+        CHECK_EQUAL(table->size(), 0);
+        CHECK_THROW(table->create_asymmetric_object("4"), LogicError);
+        CHECK_THROW(table->create_asymmetric_object(4, {{col_value, "1.5"}}), LogicError);
+        CHECK_THROW(wt.get_table("class_plain")->create_asymmetric_object(4), LogicError);
+        wt.commit();
+    }
+
+    Changeset changeset;
+    util::SimpleNoCopyInputStream stream{fixture.history_1->get_instruction_encoder().buffer()};
+    sync::parse_changeset(stream, changeset);
+    size_t num_created = 0, num_updated = 0;
+    for (auto instr : changeset) {
+        if (!instr)
+            continue;
+        if (auto create = instr->get_if<Instruction::CreateObject>()) {
+            CHECK_EQUAL(changeset.get_string(create->table), "reading");
+            CHECK_EQUAL(mpark::get<int64_t>(create->object), int64_t(num_created));
+            ++num_created;
+        }
+        else if (auto update = instr->get_if<Instruction::Update>()) {
+            CHECK_EQUAL(mpark::get<int64_t>(update->object), int64_t(num_created - 1));
+            ++num_updated;
+        }
+    }
+    CHECK_EQUAL(num_created, 3);
+    CHECK_EQUAL(num_updated, 6);
+
+    // Without a sync client history the objects are created as usual
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = DB::create(make_in_realm_history(), path);
+    auto wt = db->start_write();
+    auto table =
+        wt->add_table_with_primary_key("class_reading", type_Int, "_id", false, Table::Type::TopLevelAsymmetric);
+    col_value = table->add_column(type_Double, "value");
+    Obj obj = table->create_asymmetric_object(1, {{col_value, 2.5}});
+    CHECK(obj.is_valid());
+    CHECK_EQUAL(obj.get<double>(col_value), 2.5);
+    CHECK_EQUAL(table->size(), 1);
+}
@@ -827,6 +827,24 @@ TEST(Json_Nulls)
     CHECK(json_test(ss.str(), "expected_json_nulls", generate_all));
 }
 
+TEST(Json_StringEscapes)
+{
+    Group group;
+
+    TableRef table1 = group.add_table("table1");
+    ColKey str_col_ndx = table1->add_column(type_String, "str_col");
+    table1->create_object().set(str_col_ndx, "plain");
+    table1->create_object().set(str_col_ndx, "\"quoted\"\\\n\r\t\f\b end");
+    table1->create_object().set(str_col_ndx, "");
+
+    std::stringstream ss;
+    table1->to_json(ss, 0, no_renames);
+    auto j = nlohmann::json::parse(ss.str());
+    CHECK_EQUAL(j[0]["str_col"].get<std::string>(), "plain");
+    CHECK_EQUAL(j[1]["str_col"].get<std::string>(), "\"quoted\"\\\n\r\t\f\b end");
+    CHECK_EQUAL(j[2]["str_col"].get<std::string>(), "");
+}
+
 TEST(Json_Schema)
 {
     Group group;
@@ -1833,6 +1833,10 @@ public:
     {
         return false;
     }
+    bool set_compressed(ColKey, bool)
+    {
+        return false;
+    }
     bool add_search_index(size_t)
     {
         return false;
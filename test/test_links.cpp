@@ -418,6 +418,68 @@ TEST(Links_MultiToSame)
     CHECK_EQUAL(0, obj0.get_backlink_count(*table2, col_link2));
 }
 
+TEST(Links_SetLinks)
+{
+    Group group;
+    TableRef orders = group.add_table("orders");
+    TableRef items = group.add_table("items");
+    auto col_order = items->add_column(*orders, "order");
+    auto col_next = items->add_column(*items, "next");
+    auto col_int = items->add_column(type_Int, "int");
+
+    std::vector<ObjKey> order_keys, item_keys;
+    orders->create_objects(10, order_keys);
+    items->create_objects(1000, item_keys);
+
+    // A backlink already present is kept
+    items->get_object(item_keys[5]).set(col_order, order_keys[5]);
+
+    std::vector<ObjKey> targets;
+    for (size_t i = 0; i < item_keys.size(); ++i)
+        targets.push_back(order_keys[i % 10]);
+    items->set_links(col_order, item_keys, targets);
+    for (size_t i = 0; i < item_keys.size(); ++i)
+        CHECK_EQUAL(items->get_object(item_keys[i]).get<ObjKey>(col_order), order_keys[i % 10]);
+    for (size_t i = 0; i < order_keys.size(); ++i) {
+        Obj order = orders->get_object(order_keys[i]);
+        CHECK_EQUAL(order.get_backlink_count(*items, col_order), 100);
+        for (size_t j = 0; j < 100; ++j) {
+            ObjKey origin = order.get_backlink(*items, col_order, j);
+            CHECK_EQUAL(items->get_object(origin).get<ObjKey>(col_order), order_keys[i]);
+        }
+    }
+
+    // Links are moved and cleared, and the last link given to an object wins
+    std::vector<ObjKey> origins = {item_keys[0], item_keys[1], item_keys[2], item_keys[2], item_keys[3]};
+    targets = {order_keys[1], ObjKey(), order_keys[9], order_keys[0], order_keys[3]};
+    items->set_links(col_order, origins, targets);
+    CHECK_EQUAL(items->get_object(item_keys[0]).get<ObjKey>(col_order), order_keys[1]);
+    CHECK_NOT(items->get_object(item_keys[1]).get<ObjKey>(col_order));
+    CHECK_EQUAL(items->get_object(item_keys[2]).get<ObjKey>(col_order), order_keys[0]);
+    CHECK_EQUAL(orders->get_object(order_keys[0]).get_backlink_count(*items, col_order), 100);
+    CHECK_EQUAL(orders->get_object(order_keys[1]).get_backlink_count(*items, col_order), 100);
+    CHECK_EQUAL(orders->get_object(order_keys[2]).get_backlink_count(*items, col_order), 99);
+    CHECK_EQUAL(orders->get_object(order_keys[3]).get_backlink_count(*items, col_order), 100);
+    CHECK_EQUAL(orders->get_object(order_keys[9]).get_backlink_count(*items, col_order), 100);
+
+    // Links within a table
+    origins = {item_keys[0], item_keys[1], item_keys[2]};
+    targets = {item_keys[1], item_keys[1], item_keys[0]};
+    items->set_links(col_next, origins, targets);
+    CHECK_EQUAL(items->get_object(item_keys[1]).get_backlink_count(*items, col_next), 2);
+    CHECK_EQUAL(items->get_object(item_keys[0]).get_backlink(*items, col_next, 0), item_keys[2]);
+    orders->remove_object(order_keys[1]);
+    CHECK_NOT(items->get_object(item_keys[0]).get<ObjKey>(col_order));
+    group.verify();
+
+    CHECK_THROW(items->set_links(col_int, origins, targets), LogicError);
+    CHECK_THROW(items->set_links(col_next, origins, {item_keys[0]}), LogicError);
+    CHECK_LOGIC_ERROR(items->set_links(col_order, {item_keys[0]}, {ObjKey(12345)}),
+                      LogicError::target_row_index_out_of_range);
+    CHECK_THROW(items->set_links(col_order, {ObjKey(12345)}, {order_keys[0]}), KeyNotFound);
+}
+
+
 TEST(Links_LinkList_TableOps)
 {
     Group group;
@@ -0,0 +1,297 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/history.hpp>
+#include <realm/transaction.hpp>
+#include <realm/parser/materialized_view.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+
+namespace {
+
+DBRef open_with_views(const std::string& path)
+{
+    DBOptions options;
+    MaterializedViews::enable(options);
+    return DB::create(make_in_realm_history(), path, options);
+}
+
+std::vector<ObjKey> get_keys(const TableView& tv)
+{
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < tv.size(); ++i)
+        keys.push_back(tv.get_key(i));
+    return keys;
+}
+
+} // anonymous namespace
+
+TEST(MaterializedView_Filter)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = open_with_views(path);
+    std::vector<ObjKey> keys;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("class_Item");
+        auto col = table->add_column(type_Int, "value");
+        for (int64_t i = 0; i < 100; ++i)
+            keys.push_back(table->create_object().set(col, i).get_key());
+        MaterializedViews(*wt).create("large", {"class_Item", "value >= 50"});
+        wt->commit();
+    }
+
+    auto check_view = [&] {
+        auto rt = db->start_read();
+        auto view = MaterializedViews(*rt).get_results("large");
+        CHECK_EQUAL(view.size(), rt->get_table("class_Item")->query("value >= 50").count());
+        CHECK(get_keys(view) == get_keys(rt->get_table("class_Item")->query("value >= 50").find_all()));
+        CHECK(view.is_in_sync());
+    };
+    check_view();
+
+    // Few changes are applied one object at a time
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("class_Item");
+        auto col = table->get_column_key("value");
+        table->get_object(keys[10]).set(col, 60);
+        table->get_object(keys[60]).set(col, 10);
+        table->remove_object(keys[70]);
+        table->create_object().set(col, 80);
+        table->create_object().set(col, 0);
+        wt->commit();
+    }
+    check_view();
+
+    // Changes to a large part of the table evaluate the query anew
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("class_Item");
+        auto col = table->get_column_key("value");
+        for (auto& obj : *table)
+            obj.set(col, 100 - obj.get<Int>(col));
+        wt->commit_and_continue_as_read();
+    }
+    check_view();
+
+    // The view is stored in the file, and seen through another DB
+    {
+        auto db_2 = DB::create(make_in_realm_history(), path);
+        auto rt = db_2->start_read();
+        MaterializedViews views(*rt);
+        CHECK(views.exists("large"));
+        CHECK_NOT(views.exists("small"));
+        CHECK(views.get_names() == std::vector<std::string>{"large"});
+        CHECK_EQUAL(views.get_results("large").size(), rt->get_table("class_Item")->query("value >= 50").count());
+    }
+
+    // Removing the table empties the view
+    {
+        auto wt = db->start_write();
+        wt->remove_table("class_Item");
+        wt->commit();
+        auto rt = db->start_read();
+        CHECK_THROW(MaterializedViews(*rt).get_results("large"), NoSuchTable);
+    }
+}
+
+TEST(MaterializedView_SortAndLinks)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = open_with_views(path);
+    {
+        auto wt = db->start_write();
+        auto owners = wt->add_table("class_Owner");
+        auto col_name = owners->add_column(type_String, "name");
+        auto items = wt->add_table("class_Item");
+        auto col_value = items->add_column(type_Int, "value");
+        auto col_owner = items->add_column(*owners, "owner");
+        auto alice = owners->create_object().set(col_name, "alice").get_key();
+        auto bob = owners->create_object().set(col_name, "bob").get_key();
+        for (int64_t i = 0; i < 20; ++i)
+            items->create_object().set(col_value, i).set(col_owner, i % 2 ? alice : bob);
+        MaterializedViews(*wt).create("top", {"class_Item", "owner.name == 'alice' SORT(value DESC) LIMIT(3)"});
+        wt->commit();
+    }
+
+    auto get_values = [&] {
+        auto rt = db->start_read();
+        auto view = MaterializedViews(*rt).get_results("top");
+        auto col_value = rt->get_table("class_Item")->get_column_key("value");
+        std::vector<int64_t> values;
+        for (size_t i = 0; i < view.size(); ++i)
+            values.push_back(view.get_object(i).get<Int>(col_value));
+        return values;
+    };
+    CHECK(get_values() == std::vector<int64_t>({19, 17, 15}));
+
+    {
+        auto wt = db->start_write();
+        auto owners = wt->get_table("class_Owner");
+        auto alice = owners->find_first_string(owners->get_column_key("name"), "alice");
+        wt->get_table("class_Item")->create_object().set("value", 100).set("owner", alice);
+        wt->commit();
+    }
+    CHECK(get_values() == std::vector<int64_t>({100, 19, 17}));
+
+    // A change to the linked table alone must update the view
+    {
+        auto wt = db->start_write();
+        auto owners = wt->get_table("class_Owner");
+        auto col_name = owners->get_column_key("name");
+        owners->get_object(owners->find_first_string(col_name, "bob")).set(col_name, "alice");
+        owners->get_object(owners->find_first_string(col_name, "alice")).set(col_name, "carol");
+        wt->commit();
+    }
+    CHECK(get_values() == std::vector<int64_t>({18, 16, 14}));
+}
+
+TEST(MaterializedView_Groups)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = open_with_views(path);
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("class_Sale");
+        auto col_region = table->add_column(type_String, "region");
+        auto col_amount = table->add_column(type_Int, "amount", true);
+        table->create_object().set(col_region, "north").set(col_amount, 10);
+        table->create_object().set(col_region, "south").set(col_amount, 5);
+        table->create_object().set(col_region, "north").set(col_amount, 20);
+        table->create_object().set(col_region, "north");
+
+        MaterializedViews views(*wt);
+        MaterializedViews::Spec spec{"class_Sale", "TRUEPREDICATE", "region"};
+        views.create("count", spec);
+        spec.aggregate = MaterializedViews::Aggregate::sum;
+        spec.aggregate_column = "amount";
+        views.create("sum", spec);
+        spec.aggregate = MaterializedViews::Aggregate::average;
+        views.create("average", spec);
+        spec.aggregate = MaterializedViews::Aggregate::max;
+        views.create("max", spec);
+        wt->commit();
+    }
+    {
+        auto rt = db->start_read();
+        MaterializedViews views(*rt);
+        auto groups = views.get_groups("count");
+        CHECK_EQUAL(groups.size(), 2);
+        CHECK_EQUAL(groups[0].group, "north");
+        CHECK_EQUAL(groups[0].count, 3);
+        CHECK_EQUAL(groups[0].value, 3);
+        CHECK_EQUAL(groups[1].group, "south");
+        CHECK_EQUAL(groups[1].value, 1);
+
+        groups = views.get_groups("sum");
+        CHECK_EQUAL(groups[0].value, 30);
+        CHECK_EQUAL(groups[1].value, 5);
+        groups = views.get_groups("average");
+        CHECK_EQUAL(groups[0].value, 15.0);
+        CHECK_EQUAL(groups[1].value, 5.0);
+        groups = views.get_groups("max");
+        CHECK_EQUAL(groups[0].value, 20);
+    }
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("class_Sale");
+        table->create_object().set("region", "east").set("amount", 7);
+        table->begin()->set("amount", 40);
+        wt->commit();
+    }
+    {
+        auto rt = db->start_read();
+        auto groups = MaterializedViews(*rt).get_groups("sum");
+        CHECK_EQUAL(groups.size(), 3);
+        CHECK_EQUAL(groups[0].group, "east");
+        CHECK_EQUAL(groups[0].value, 7);
+        CHECK_EQUAL(groups[1].value, 60);
+    }
+}
+
+TEST(MaterializedView_Errors)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = open_with_views(path);
+    auto wt = db->start_write();
+    auto table = wt->add_table("class_Item");
+    table->add_column(type_Int, "value");
+    table->add_column_list(type_Int, "list");
+
+    MaterializedViews views(*wt);
+    CHECK_THROW(views.get_results("missing"), KeyNotFound);
+    CHECK_NOT(views.remove("missing"));
+    CHECK_THROW(views.create("view", {"class_Missing", "TRUEPREDICATE"}), NoSuchTable);
+    CHECK_THROW_ANY(views.create("view", {"class_Item", "missing > 0"}));
+    CHECK_THROW(views.create("view", {"class_Item", "TRUEPREDICATE", "missing"}), LogicError);
+    CHECK_THROW(views.create("view", {"class_Item", "TRUEPREDICATE", "list"}), LogicError);
+    CHECK_THROW(views.create("view", {"class_Item", "TRUEPREDICATE", "", MaterializedViews::Aggregate::sum, "value"}),
+                LogicError);
+
+    views.create("view", {"class_Item", "value > 0"});
+    CHECK_THROW(views.create("view", {"class_Item", "value > 0"}), KeyAlreadyUsed);
+    CHECK(views.remove("view"));
+    CHECK_NOT(views.exists("view"));
+}
+
+TEST(MaterializedView_CommitWithoutViews)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto db = open_with_views(path);
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("class_Item");
+        auto col = table->add_column(type_Int, "value");
+        for (int64_t i = 0; i < 10; ++i)
+            table->create_object().set(col, i);
+        MaterializedViews(*wt).create("large", {"class_Item", "value >= 5", "value"});
+        wt->commit();
+    }
+
+    // A DB without views enabled leaves them as they were
+    auto db_2 = DB::create(make_in_realm_history(), path);
+    {
+        auto wt = db_2->start_write();
+        auto table = wt->get_table("class_Item");
+        table->create_object().set("value", 7);
+        wt->commit();
+    }
+    auto check_view = [&](DB& db) {
+        auto rt = db.start_read();
+        MaterializedViews views(*rt);
+        CHECK_EQUAL(views.get_results("large").size(), 6);
+        auto groups = views.get_groups("large");
+        CHECK_EQUAL(groups.size(), 5);
+        CHECK_EQUAL(groups[2].group, Mixed(7));
+        CHECK_EQUAL(groups[2].count, 2);
+    };
+    // The stale view is evaluated when read
+    check_view(*db_2);
+
+    // The next commit with views enabled evaluates them anew, even if it
+    // changes nothing they depend on
+    {
+        auto wt = db->start_write();
+        wt->add_table("class_Other");
+        wt->commit();
+    }
+    check_view(*db);
+}
@@ -52,6 +52,7 @@
 // check-testcase` (or one of its friends) from the command line.
 
 #include <realm.hpp>
+#include <realm/metrics/latency.hpp>
 #include <realm/replication.hpp>
 
 using namespace realm;
@@ -481,6 +482,49 @@ TEST(Metrics_QueryOrAndNot)
 }
 
 
+TEST(Metrics_QueryPlan)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBOptions options(crypt_key());
+    options.enable_metrics = true;
+    DBRef sg = DB::create(*hist, path, options);
+
+    auto wt = sg->start_write();
+    TableRef table = wt->add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_indexed = table->add_column(type_String, "indexed");
+    table->add_search_index(col_indexed);
+    for (int i = 0; i < 10000; ++i) {
+        table->create_object().set_all(i, i % 500 ? "common" : "rare", i % 2 ? "odd" : "even");
+    }
+    wt->commit_and_continue_as_read();
+
+    // The unselective condition is given first, but the sampled selectivity puts the rare one first
+    CHECK_EQUAL(table->where().greater_equal(col_int, 0).equal(col_str, "rare").count(), 20);
+    // Conditions using a search index are not sampled
+    CHECK_EQUAL(table->where().equal(col_indexed, "odd").greater(col_int, 9990).count(), 5);
+
+    std::shared_ptr<Metrics> metrics = sg->get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::QueryInfoList> queries = metrics->take_queries();
+    CHECK(queries);
+    CHECK_EQUAL(queries->size(), 2);
+
+    std::string plan = queries->at(0).get_plan();
+    auto rare_pos = plan.find("str == \"rare\" (scan");
+    auto int_pos = plan.find("int > -1 (scan");
+    CHECK_NOT_EQUAL(rare_pos, std::string::npos);
+    CHECK_NOT_EQUAL(int_pos, std::string::npos);
+    CHECK_LESS(rare_pos, int_pos);
+    CHECK_NOT_EQUAL(plan.find("sampled rows match"), std::string::npos);
+
+    std::string index_plan = queries->at(1).get_plan();
+    CHECK_NOT_EQUAL(index_plan.find("indexed == \"odd\" (index)"), std::string::npos);
+    CHECK_NOT_EQUAL(index_plan.find("int > 9990 (scan"), std::string::npos);
+}
+
 TEST(Metrics_LinkQueries)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -837,6 +881,44 @@ TEST(Metrics_TransactionData)
     CHECK_EQUAL(transactions->at(2).get_total_objects(), 11 + 3 + 7);
 }
 
+TEST(Metrics_MapWindowUsage)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.max_map_windows = 2;
+    options.map_window_size = 1;
+    DBRef sg = DB::create(*hist, path, options);
+    populate(sg);
+
+    {
+        ReadTransaction rt(sg);
+    }
+    {
+        auto wt = sg->start_write();
+        auto table_keys = wt->get_table_keys();
+        TableRef t0 = wt->get_table(table_keys[0]);
+        std::vector<ObjKey> keys;
+        t0->create_objects(1000, keys);
+        wt->commit();
+    }
+
+    std::shared_ptr<Metrics> metrics = sg->get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::TransactionInfoList> transactions = metrics->take_transactions();
+    CHECK(transactions);
+    CHECK_EQUAL(transactions->size(), 3);
+
+    CHECK_EQUAL(transactions->at(1).get_transaction_type(), TransactionInfo::read_transaction);
+    CHECK_EQUAL(transactions->at(1).get_num_map_window_hits(), 0);
+    CHECK_EQUAL(transactions->at(1).get_num_map_window_misses(), 0);
+    CHECK_EQUAL(transactions->at(2).get_transaction_type(), TransactionInfo::write_transaction);
+    CHECK_GREATER(transactions->at(2).get_num_map_window_hits() + transactions->at(2).get_num_map_window_misses(),
+                  0);
+    CHECK_GREATER_EQUAL(transactions->at(2).get_num_map_window_misses(), 1);
+}
+
 TEST(Metrics_TransactionVersions)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -1119,6 +1201,90 @@ TEST(Metrics_MemoryChecks)
     }
 }
 
+TEST(Metrics_LatencyHistogram)
+{
+    using H = LatencyHistogram;
+    // Small values are exact
+    for (uint64_t v = 0; v < 16; ++v) {
+        CHECK_EQUAL(H::get_bucket(v), v);
+        CHECK_EQUAL(H::get_bucket_limit(H::get_bucket(v)), v);
+    }
+    // Every value is in the bucket that covers it, to within 12.5%
+    size_t last_bucket = 0;
+    for (uint64_t v = 1; v < (uint64_t(1) << 37); v += v / 7 + 1) {
+        size_t bucket = H::get_bucket(v);
+        CHECK_GREATER_EQUAL(bucket, last_bucket);
+        CHECK_LESS(bucket, H::num_buckets);
+        uint64_t limit = H::get_bucket_limit(bucket);
+        CHECK_GREATER_EQUAL(limit, v);
+        CHECK_LESS_EQUAL(limit - v, v / 8);
+        if (bucket > 0)
+            CHECK_LESS(H::get_bucket_limit(bucket - 1), v);
+        last_bucket = bucket;
+    }
+    CHECK_EQUAL(H::get_bucket(uint64_t(-1)), H::num_buckets - 1);
+
+    H histogram;
+    CHECK_EQUAL(histogram.get_percentile(99), 0);
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        ++histogram.buckets[H::get_bucket(v * 1000)];
+        ++histogram.count;
+    }
+    histogram.max_nanoseconds = 1000 * 1000;
+    auto check_percentile = [&](double percentile, uint64_t expected) {
+        uint64_t value = histogram.get_percentile(percentile);
+        CHECK_GREATER_EQUAL(value, expected);
+        CHECK_LESS_EQUAL(value, expected + expected / 8);
+    };
+    check_percentile(50, 500 * 1000);
+    check_percentile(99, 990 * 1000);
+    CHECK_EQUAL(histogram.get_percentile(100), 1000 * 1000);
+    CHECK_EQUAL(histogram.get_percentile(0), H::get_bucket_limit(H::get_bucket(1000)));
+}
+
+TEST(Metrics_LatencyRegistry)
+{
+    // Other tests may record concurrently, so only lower bounds are checked
+    auto& registry = LatencyRegistry::get();
+    CHECK(LatencyRegistry::is_enabled());
+    auto before = [&](LatencyMetric metric) {
+        return registry.get_snapshot(metric).count;
+    };
+    uint64_t begin_reads = before(LatencyMetric::begin_read);
+    uint64_t commits = before(LatencyMetric::commit);
+    uint64_t fsyncs = before(LatencyMetric::fsync);
+    uint64_t queries = before(LatencyMetric::query);
+
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path, DBOptions(crypt_key()));
+    populate(sg);
+    {
+        auto rt = sg->start_read();
+        auto table = rt->get_table(rt->get_table_keys()[0]);
+        auto col = table->get_column_keys()[0];
+        Query q = table->column<Int>(col) > 0;
+        q.count();
+        // Only the outermost of the nested query functions is recorded
+        q.find_all(DescriptorOrdering());
+    }
+
+    CHECK_GREATER_EQUAL(registry.get_snapshot(LatencyMetric::begin_read).count, begin_reads + 1);
+    CHECK_GREATER_EQUAL(registry.get_snapshot(LatencyMetric::commit).count, commits + 1);
+    CHECK_GREATER_EQUAL(registry.get_snapshot(LatencyMetric::fsync).count, fsyncs + 1);
+    auto snapshot = registry.get_snapshot(LatencyMetric::query);
+    CHECK_GREATER_EQUAL(snapshot.count, queries + 2);
+    CHECK_GREATER(snapshot.total_nanoseconds, 0);
+    CHECK_GREATER_EQUAL(snapshot.max_nanoseconds, snapshot.get_percentile(50));
+
+    {
+        LatencyTimer outer(LatencyMetric::sync_upload);
+        LatencyTimer inner(LatencyMetric::sync_upload);
+    }
+    CHECK_GREATER_EQUAL(registry.get_snapshot(LatencyMetric::sync_upload).count, 1);
+    CHECK_EQUAL(std::string(get_latency_metric_name(LatencyMetric::notifier_run)), "notifier_run");
+}
+
 #else // REALM_METRICS
 
 TEST(Metrics_APIAvailability)
@@ -1177,6 +1343,7 @@ TEST(Metrics_APIAvailability)
         if (queries) {
             for (auto query : *queries) {
                 query.get_description();
+                query.get_plan();
                 query.get_table_name();
                 query.get_type();
                 query.get_query_time();
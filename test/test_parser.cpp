@@ -20,6 +20,7 @@
 
 #include <realm.hpp>
 #include <realm/parser/keypath_mapping.hpp>
+#include <realm/parser/query_cache.hpp>
 #include <realm/parser/query_parser.hpp>
 #if defined(TEST_PARSER)
 
@@ -896,6 +897,39 @@ TEST(Parser_StringOperations)
     verify_query(test_context, t, "NULL LIKE[c] name", 1);
 }
 
+TEST(Parser_Fulltext)
+{
+    Group g;
+    TableRef t = g.add_table("note");
+    ColKey body_col = t->add_column(type_String, "body", true);
+    ColKey text_col = t->add_column(type_String, "text");
+    ColKey tags_col = t->add_column_list(type_String, "tags");
+    ColKey link_col = t->add_column(*t, "next");
+    std::vector<std::string> bodies = {"The quick brown fox", "A quick reply.", "Brown-bag lunch", "quicker"};
+    for (auto& body : bodies) {
+        t->create_object().set(body_col, StringData(body)).set(text_col, "text");
+    }
+    t->create_object(); // null
+
+    verify_query(test_context, t, "body TEXT 'quick'", 2);
+    verify_query(test_context, t, "body text 'QUICK brown'", 1);
+    verify_query(test_context, t, "body TEXT 'brown'", 2);
+    verify_query(test_context, t, "body TEXT 'bag lunch'", 1);
+    verify_query(test_context, t, "body TEXT 'qui'", 0);
+    verify_query(test_context, t, "body TEXT 'quick' && body TEXT 'fox'", 1);
+    verify_query(test_context, t, "body TEXT 'quick' || body TEXT 'lunch'", 3);
+    verify_query(test_context, t, "!(body TEXT 'quick')", 3);
+    // A property may itself be called 'text'
+    verify_query(test_context, t, "text TEXT 'text'", 4);
+
+    CHECK_THROW(verify_query(test_context, t, "body SOUNDSLIKE 'quick'", 0), query_parser::SyntaxError);
+    CHECK_THROW(verify_query(test_context, t, "body TEXT 2", 0), query_parser::InvalidQueryError);
+    CHECK_THROW(verify_query(test_context, t, "next.body TEXT 'quick'", 0), query_parser::InvalidQueryError);
+    CHECK_THROW(verify_query(test_context, t, "tags TEXT 'quick'", 0), query_parser::InvalidQueryError);
+    static_cast<void>(tags_col);
+    static_cast<void>(link_col);
+}
+
 
 TEST(Parser_Timestamps)
 {
@@ -4007,6 +4041,44 @@ TEST(Parser_OperatorIN)
                    CHECK_EQUAL(e.what(), "The keypath following 'IN' must contain a list. Found 'fav_item.price'"));
 }
 
+TEST(Parser_OperatorINLargeList)
+{
+    Group g;
+    TableRef t = g.add_table("class_Person");
+    ColKey id_col = t->add_column(type_Int, "id", true);
+    ColKey name_col = t->add_column(type_String, "name", true);
+    ColKey link_col = t->add_column(*t, "link");
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = t->create_object();
+        if (i % 100) {
+            obj.set(id_col, i);
+            obj.set(name_col, "name" + util::to_string(i));
+        }
+        obj.set(link_col, obj.get_key());
+    }
+
+    std::string ids;
+    std::string names;
+    for (int i = 0; i < 1000; i += 7) {
+        ids += util::to_string(i) + ", ";
+        names += "'name" + util::to_string(i) + "', ";
+    }
+    ids += "-1";
+    names += "'none'";
+    // Multiples of 7 below 1000, except those that are multiples of 100 (and null)
+    verify_query(test_context, t, "id IN {" + ids + "}", 143 - 2);
+    verify_query(test_context, t, "NOT id IN {" + ids + "}", 1000 - 141);
+    verify_query(test_context, t, "id IN {" + ids + ", null}", 141 + 10);
+    verify_query(test_context, t, "name IN {" + names + "}", 141);
+    verify_query(test_context, t, "name IN {" + names + ", null}", 151);
+    verify_query(test_context, t, "link.id IN {" + ids + "}", 141);
+    verify_query(test_context, t, "id IN {" + ids + "} AND name IN {" + names + "}", 141);
+    // Constants of another type
+    verify_query(test_context, t, "id IN {" + ids + ", 7.0}", 141);
+    CHECK_THROW_EX(verify_query(test_context, t, "id IN {" + ids + ", 'seven'}", 141),
+                   query_parser::InvalidQueryArgError, CHECK_EQUAL(e.what(), "Cannot convert 'seven' to a number"));
+}
+
 TEST(Parser_ListVsList)
 {
     Group g;
@@ -5511,4 +5583,109 @@ TEST(Parser_Between)
     CHECK_THROW_ANY(verify_query(test_context, table, "NONE scores between {10, 12}", 1));
 }
 
+TEST(Parser_QueryCache)
+{
+    Group g;
+    TableRef person = g.add_table("person");
+    TableRef dog = g.add_table("dog");
+    auto col_name = dog->add_column(type_String, "name");
+    auto col_age = person->add_column(type_Int, "age");
+    auto col_dict = person->add_column_dictionary(type_Int, "dict");
+    auto col_tags = person->add_column_list(type_String, "tags");
+    auto col_dogs = person->add_column_list(*dog, "dogs");
+    dog->add_column(type_Int, "age");
+    for (int i = 0; i < 10; ++i) {
+        auto obj = person->create_object().set(col_age, i);
+        obj.get_dictionary(col_dict).insert(util::format("key%1", i % 3), i);
+        obj.get_list<String>(col_tags).add(std::string(i, 'x'));
+        obj.get_linklist(col_dogs).add(dog->create_object().set(col_name, i % 2 ? "Fido" : "Rex").get_key());
+    }
+
+    query_parser::QueryCache cache(3);
+    auto check = [&](const std::string& query_string, std::vector<Mixed> args, TableRef table = {}) {
+        if (!table)
+            table = person;
+        Query expected = table->query(query_string, args);
+        Query cached = cache.query(table, query_string, args);
+        CHECK_EQUAL(cached.count(), expected.count());
+        CHECK_EQUAL(cached.get_description(), expected.get_description());
+        return cached.count();
+    };
+
+    // The arguments are bound anew for every query built from the same string
+    CHECK_EQUAL(check("age > $0", {3}), 6);
+    CHECK_EQUAL(check("age > $0", {7}), 2);
+    CHECK_EQUAL(cache.size(), 1);
+    CHECK_EQUAL(cache.get_miss_count(), 1);
+    CHECK_EQUAL(cache.get_hit_count(), 1);
+
+    // Queries which rewrite their key paths when built give the same result every time
+    for (int i = 0; i < 2; ++i) {
+        CHECK_EQUAL(check("dict.@keys == 'key1'", {}), 3);
+        CHECK_EQUAL(check("tags.length > 5", {}), 4);
+        CHECK_EQUAL(check("SUBQUERY(dogs, $x, $x.name == $0).@count > 0", {"Fido"}), 5);
+    }
+    CHECK_EQUAL(cache.size(), 3);
+
+    // The least recently used string is evicted
+    CHECK_EQUAL(check("age > $0 SORT(age DESC) LIMIT(2)", {0}), 9);
+    CHECK_EQUAL(cache.size(), 3);
+    size_t misses = cache.get_miss_count();
+    check("SUBQUERY(dogs, $x, $x.name == $0).@count > 0", {"Rex"});
+    CHECK_EQUAL(cache.get_miss_count(), misses);
+    check("dict.@keys == 'key1'", {});
+    CHECK_EQUAL(cache.get_miss_count(), misses + 1);
+
+    // The same string can be used for different tables
+    CHECK_EQUAL(check("age > $0", {3}, dog), 0);
+    CHECK_THROW(cache.query(dog, "dict.@keys == 'key1'"), query_parser::InvalidQueryError);
+
+    // Strings which do not parse are not cached
+    size_t size = cache.size();
+    CHECK_THROW(cache.query(person, "age >"), query_parser::SyntaxError);
+    CHECK_EQUAL(cache.size(), size);
+
+    cache.clear();
+    CHECK_EQUAL(cache.size(), 0);
+}
+
+TEST(Parser_PrepareQuery)
+{
+    Group g;
+    TableRef person = g.add_table("person");
+    TableRef dog = g.add_table("dog");
+    auto col_name = person->add_column(type_String, "name");
+    auto col_age = person->add_column(type_Int, "age");
+    auto col_dog = person->add_column(*dog, "dog");
+    auto col_dog_age = dog->add_column(type_Int, "age");
+    for (int i = 0; i < 10; ++i) {
+        auto obj = person->create_object().set(col_name, i % 2 ? "Bob" : "Alice").set(col_age, i);
+        obj.set(col_dog, dog->create_object().set(col_dog_age, i % 5).get_key());
+    }
+
+    Query q = person->prepare_query("name == $0 AND age > $1", {"Bob", 2});
+    CHECK_EQUAL(q.count(), 4);
+    q.rebind(0, "Alice");
+    CHECK_EQUAL(q.count(), 3);
+    q.rebind(1, 5);
+    CHECK_EQUAL(q.count(), 2);
+    CHECK_EQUAL(q.get_description(), person->query("name == $0 AND age > $1", {"Alice", 5}).get_description());
+
+    // Conditions evaluated as expressions
+    Query q2 = person->prepare_query("dog.age == $0 OR age + 1 > $1", {1, 9});
+    CHECK_EQUAL(q2.count(), 3);
+    q2.rebind(0, 4);
+    CHECK_EQUAL(q2.count(), 2);
+    q2.rebind(1, 5);
+    CHECK_EQUAL(q2.count(), 6);
+
+    CHECK_THROW(q.rebind(1, "x"), LogicError);
+    CHECK_THROW(q.rebind(2, 1), std::out_of_range);
+
+    // Null arguments are not bound
+    Query q3 = person->prepare_query("age == $0", {Mixed()});
+    CHECK_EQUAL(q3.count(), 0);
+    CHECK_THROW(q3.rebind(0, 1), std::out_of_range);
+}
+
 #endif // TEST_PARSER
@@ -21,6 +21,7 @@
 
 #include <cstdlib> // itoa()
 #include <limits>
+#include <set>
 #include <vector>
 #include <chrono>
 
@@ -1507,6 +1508,62 @@ TEST(Query_IntIndex)
     CHECK_EQUAL(cnt, nulls);
 }
 
+TEST(Query_IndexCount)
+{
+    Group group;
+    TableRef table = group.add_table("test");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int_null", true);
+    auto col_oid = table->add_column(type_ObjectId, "oid", true);
+    auto col_uuid = table->add_column(type_UUID, "uuid");
+    auto col_other = table->add_column(type_Int, "other");
+    table->add_search_index(col_int);
+    table->add_search_index(col_int_null);
+    table->add_search_index(col_oid);
+    table->add_search_index(col_uuid);
+
+    ObjectId oid = ObjectId::gen();
+    UUID uuid("01234567-9abc-4def-9012-3456789abcde");
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = table->create_object().set(col_int, i % 10).set(col_other, i % 2);
+        if (i % 4)
+            obj.set(col_int_null, i % 4);
+        if (i % 5 == 0)
+            obj.set(col_oid, oid);
+        if (i % 8 == 0)
+            obj.set(col_uuid, uuid);
+    }
+
+    // A single condition is counted by the index
+    auto check = [&](Query q, size_t expected) {
+        CHECK_EQUAL(q.count(), expected);
+        CHECK_EQUAL(q.find_all().size(), expected);
+        ObjKey first = q.find();
+        CHECK_EQUAL(bool(first), expected > 0);
+        // The same query is counted again after its matches were looked up
+        CHECK_EQUAL(q.count(), expected);
+        CHECK_EQUAL(q.find_all(3).size(), std::min<size_t>(3, expected));
+        auto tv = q.find_all();
+        size_t even = 0;
+        for (size_t i = 0; i < tv.size(); ++i)
+            even += tv.get_object(i).get<Int>(col_other) == 0 ? 1 : 0;
+        CHECK_EQUAL(q.equal(col_other, 0).count(), even);
+    };
+    check(table->where().equal(col_int, 4), 100);
+    check(table->where().equal(col_int, 10), 0);
+    check(table->where().equal(col_int_null, 2), 250);
+    check(table->where().equal(col_int_null, null()), 250);
+    check(table->where().equal(col_oid, oid), 200);
+    check(table->where().equal(col_oid, null()), 800);
+    check(table->where().equal(col_uuid, uuid), 125);
+    check(table->where().equal(col_uuid, UUID()), 875);
+
+    // Conditions on several indexed columns intersect their matches
+    CHECK_EQUAL(table->where().equal(col_int, 0).equal(col_oid, oid).count(), 100);
+    CHECK_EQUAL(table->where().equal(col_int, 0).equal(col_uuid, uuid).count(), 25);
+    CHECK_EQUAL(table->where().equal(col_int, 4).equal(col_int_null, null()).count(), 50);
+}
+
 TEST(Query_StringIndexNull)
 {
     Random random(random_int<unsigned long>()); // Seed from slow global generator
@@ -1851,6 +1908,59 @@ TEST(Query_ListOfPrimitives)
     CHECK_EQUAL(tv.size(), 1);
 }
 
+TEST(Query_ListAggregatesOverSeveralLeaves)
+{
+    Group g;
+    TableRef table = g.add_table("foo");
+    auto col_int = table->add_column_list(type_Int, "integers");
+    auto col_int_null = table->add_column_list(type_Int, "nullable_integers", true);
+    auto col_double = table->add_column_list(type_Double, "doubles");
+
+    // Lists long enough to span several B+tree leaves
+    const size_t list_size = 2500;
+    std::vector<int64_t> sums;
+    for (int64_t i = 0; i < 10; ++i) {
+        Obj obj = table->create_object();
+        auto ints = obj.get_list<Int>(col_int);
+        auto ints_null = obj.get_list<util::Optional<Int>>(col_int_null);
+        auto doubles = obj.get_list<Double>(col_double);
+        int64_t sum = 0;
+        for (size_t j = 0; j < list_size; ++j) {
+            int64_t v = (int64_t(j) * 7 + i) % 1000 - 500;
+            ints.add(v);
+            ints_null.add(j % 3 ? util::Optional<Int>(v) : util::none);
+            doubles.add(double(v) / 2);
+            sum += v;
+        }
+        sums.push_back(sum);
+    }
+
+    size_t greater = 0, equal = 0;
+    for (auto sum : sums) {
+        greater += sum > sums[4] ? 1 : 0;
+        equal += sum == sums[4] ? 1 : 0;
+    }
+    CHECK_EQUAL(table->query("integers.@sum > $0", std::vector<Mixed>{sums[4]}).count(), greater);
+    CHECK_EQUAL(table->query("integers.@sum == $0", std::vector<Mixed>{sums[4]}).count(), equal);
+    CHECK_EQUAL((table->column<Lst<Int>>(col_int).average() == double(sums[4]) / list_size).count(), equal);
+    CHECK_EQUAL(table->query("doubles.@sum == $0", std::vector<Mixed>{double(sums[4]) / 2}).count(), equal);
+    CHECK_EQUAL(table->query("integers.@min == -500 && integers.@max == 499").count(), 10);
+    CHECK_EQUAL(table->query("doubles.@min == -250 && doubles.@max == 249.5").count(), 10);
+    CHECK_EQUAL(table->query("nullable_integers.@min == -500").count(), 10);
+
+    // The nulls are skipped
+    int64_t sum = 0;
+    size_t count = 0;
+    for (size_t j = 0; j < list_size; ++j) {
+        if (j % 3) {
+            sum += (int64_t(j) * 7 + 4) % 1000 - 500;
+            ++count;
+        }
+    }
+    CHECK_EQUAL(table->query("nullable_integers.@sum == $0", std::vector<Mixed>{sum}).count(), 1);
+    CHECK_EQUAL((table->column<Lst<Int>>(col_int_null).average() == double(sum) / count).count(), 1);
+}
+
 TEST(Query_SetOfPrimitives)
 {
     Group g;
@@ -1889,6 +1999,106 @@ TEST(Query_SetOfPrimitives)
     CHECK_EQUAL(tv.get_key(0), keys[2]);
 }
 
+TEST(Query_CollectionContainsConstant)
+{
+    Group g;
+    TableRef table = g.add_table("foo");
+    auto col_tags = table->add_column_list(type_String, "tags", true);
+    auto col_ids = table->add_column_list(type_Int, "ids", true);
+    auto col_set = table->add_column_set(type_String, "set");
+
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = table->create_object();
+        auto tags = obj.get_list<String>(col_tags);
+        auto ids = obj.get_list<util::Optional<Int>>(col_ids);
+        auto set = obj.get_set<String>(col_set);
+        for (int j = 0; j < i % 7; ++j) {
+            std::string tag = "tag" + util::to_string((i + j) % 13);
+            tags.add(tag);
+            set.insert(tag);
+            ids.add(j % 3 ? util::Optional<Int>(i + j) : util::none);
+        }
+        if (i % 10 == 0)
+            tags.add(StringData(""));
+        if (i % 11 == 0)
+            tags.add(StringData());
+    }
+
+    auto count_matching = [&](auto&& pred) {
+        size_t count = 0;
+        for (auto& obj : *table) {
+            if (pred(obj))
+                ++count;
+        }
+        return count;
+    };
+    auto list_contains = [](auto&& list, auto value) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list.get(i) == value)
+                return true;
+        }
+        return false;
+    };
+
+    size_t expected = count_matching([&](const Obj& obj) {
+        return list_contains(obj.get_list<String>(col_tags), StringData("tag3"));
+    });
+    CHECK_GREATER(expected, 0);
+    CHECK_EQUAL(table->query("ANY tags == 'tag3'").count(), expected);
+    CHECK_EQUAL(table->query("tags == 'tag3'").count(), expected);
+    CHECK_EQUAL(table->query("'tag3' == ANY tags").count(), expected);
+    CHECK_EQUAL(table->query("ANY set == 'tag3'").count(), expected);
+    CHECK_EQUAL(table->query("NOT ANY tags == 'tag3'").count(), table->size() - expected);
+
+    // Empty strings and nulls are different
+    expected = count_matching([&](const Obj& obj) {
+        return list_contains(obj.get_list<String>(col_tags), StringData(""));
+    });
+    CHECK_EQUAL(table->query("ANY tags == ''").count(), expected);
+    expected = count_matching([&](const Obj& obj) {
+        return list_contains(obj.get_list<String>(col_tags), StringData());
+    });
+    CHECK_EQUAL(table->query("ANY tags == NULL").count(), expected);
+
+    expected = count_matching([&](const Obj& obj) {
+        return list_contains(obj.get_list<util::Optional<Int>>(col_ids), util::Optional<Int>(500));
+    });
+    CHECK_GREATER(expected, 0);
+    CHECK_EQUAL(table->query("ANY ids == 500").count(), expected);
+    CHECK_EQUAL((table->column<Lst<util::Optional<Int>>>(col_ids) == 500).count(), expected);
+    // Not the same type as the column, so compared as Mixed
+    CHECK_EQUAL(table->query("ANY ids == 500.0").count(), expected);
+
+    // Only ANY can be answered by searching the collections
+    expected = count_matching([&](const Obj& obj) {
+        auto tags = obj.get_list<String>(col_tags);
+        return tags.size() == 0 || !list_contains(tags, StringData("tag3"));
+    });
+    CHECK_EQUAL(table->query("NONE tags == 'tag3'").count(), expected);
+}
+
+TEST(Query_DictionaryContainsKey)
+{
+    Group g;
+    TableRef table = g.add_table("foo");
+    auto col_dict = table->add_column_dictionary(type_Mixed, "attributes");
+
+    size_t expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        auto dict = table->create_object().get_dictionary(col_dict);
+        for (int j = 0; j < i % 5; ++j)
+            dict.insert("key" + util::to_string((i + j) % 17), i);
+        if (dict.contains("key3"))
+            ++expected;
+    }
+
+    CHECK_GREATER(expected, 0);
+    CHECK_EQUAL(table->query("attributes.@keys == 'key3'").count(), expected);
+    CHECK_EQUAL(table->query("ANY attributes.@keys == 'key3'").count(), expected);
+    CHECK_EQUAL(table->query("NONE attributes.@keys == 'key3'").count(), table->size() - expected);
+    CHECK_EQUAL(table->query("ANY attributes.@keys == 'nonexistent'").count(), 0);
+}
+
 TEST(Query_SetOfObjects)
 {
     Group g;
@@ -4245,6 +4455,37 @@ TEST(Query_DescriptorsWillApply)
     CHECK(ordering_copy.will_limit_to_zero());
 }
 
+TEST(Query_FindAllOf)
+{
+    Group g;
+    TableRef t = g.add_table("t");
+    auto col = t->add_column(type_Int, "int");
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 10; ++i)
+        keys.push_back(t->create_object().set(col, i).get_key());
+
+    Query q = t->where().greater(col, 4);
+    std::vector<ObjKey> candidates = {keys[9], keys[2], ObjKey(100), keys[5], keys[4]};
+    std::vector<ObjKey> expected = {keys[9], keys[5]};
+    CHECK(q.find_all_of(candidates) == expected);
+    CHECK(t->where().find_all_of(candidates) == std::vector<ObjKey>({keys[9], keys[2], keys[5], keys[4]}));
+
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col}}, {false}));
+    TableView tv(q, {keys[9], keys[8], keys[7], keys[6], keys[5]}, ordering);
+    CHECK(tv.is_in_sync());
+    CHECK_EQUAL(tv.size(), 5);
+    CHECK_EQUAL(tv.get_key(0), keys[9]);
+
+    // The view behaves like any other query view once the table changes
+    t->get_object(keys[0]).set(col, 20);
+    CHECK_NOT(tv.is_in_sync());
+    tv.sync_if_needed();
+    CHECK_EQUAL(tv.size(), 6);
+    CHECK_EQUAL(tv.get_key(0), keys[0]);
+}
+
 TEST(Query_FindWithDescriptorOrdering)
 {
     Group g;
@@ -4858,6 +5099,73 @@ TEST(Query_CompoundDescriptors) {
     }
 }
 
+TEST(Query_SortWithLimit)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Group g;
+    TableRef target = g.add_table("target");
+    auto col_target_int = target->add_column(type_Int, "value");
+    for (size_t i = 0; i < 20; ++i) {
+        target->create_object().set(col_target_int, random.draw_int_mod(10));
+    }
+    Table& table = *g.add_table("table");
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_str = table.add_column(type_String, "str");
+    auto col_link = table.add_column(*target, "link");
+    for (size_t i = 0; i < 1000; ++i) {
+        Obj obj = table.create_object();
+        if (random.draw_int_mod(10) != 0)
+            obj.set(col_int, random.draw_int_mod(50));
+        obj.set(col_str, util::to_string(random.draw_int_mod(5)));
+        if (random.draw_int_mod(5) != 0)
+            obj.set(col_link, target->get_object(random.draw_int_mod(20)).get_key());
+    }
+
+    // Only the part of the sort surviving the limit is put in order, which must give the same
+    // objects in the same order as sorting everything
+    auto check = [&](SortDescriptor sort, size_t limit) {
+        DescriptorOrdering full;
+        full.append_sort(sort);
+        TableView expected = table.where().find_all(full);
+
+        DescriptorOrdering limited;
+        limited.append_sort(sort);
+        limited.append_limit(LimitDescriptor(limit));
+        TableView tv = table.where().find_all(limited);
+        size_t expected_size = std::min(limit, expected.size());
+        CHECK_EQUAL(tv.size(), expected_size);
+        CHECK_EQUAL(tv.get_num_results_excluded_by_limit(), expected.size() - expected_size);
+        for (size_t i = 0; i < tv.size(); ++i) {
+            CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+        }
+    };
+
+    for (size_t limit : {0, 1, 7, 100, 999, 1000, 5000}) {
+        check(SortDescriptor({{col_int}}, {true}), limit);
+        check(SortDescriptor({{col_int}}, {false}), limit);
+        check(SortDescriptor({{col_str}, {col_int}}, {false, true}), limit);
+        check(SortDescriptor({{col_link, col_target_int}, {col_int}}, {true, false}), limit);
+    }
+
+    // Descriptors after the limit see the selected objects in sorted order
+    DescriptorOrdering limited;
+    limited.append_sort(SortDescriptor({{col_int}}, {false}));
+    limited.append_limit(LimitDescriptor(100));
+    TableView first = table.where().find_all(limited);
+    limited.append_distinct(DistinctDescriptor({{col_str}}));
+    TableView distinct = table.where().find_all(limited);
+    std::vector<ObjKey> expected;
+    std::set<std::string> seen;
+    for (size_t i = 0; i < first.size(); ++i) {
+        if (seen.insert(first.get_object(i).get<String>(col_str)).second)
+            expected.push_back(first.get_key(i));
+    }
+    CHECK_EQUAL(distinct.size(), expected.size());
+    for (size_t i = 0; i < distinct.size() && i < expected.size(); ++i) {
+        CHECK_EQUAL(distinct.get_key(i), expected[i]);
+    }
+}
+
 TEST(Query_DistinctThroughLinks)
 {
     Group g;
@@ -5602,4 +5910,684 @@ TEST(Query_AsymmetricObjects)
                       LogicError::wrong_kind_of_table);
 }
 
+TEST(Query_ParallelEvaluation)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef db = DB::create(*hist, path);
+    auto wt = db->start_write();
+    auto table = wt->add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    table->add_column(type_String, "str");
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 10000; ++i)
+        keys.push_back(table->create_object().set_all(i % 97, util::to_string(i % 13)).get_key());
+    // Leave the clusters unevenly filled
+    for (size_t i = 0; i < keys.size(); i += 3)
+        table->remove_object(keys[i]);
+    wt->commit_and_continue_as_read();
+    auto frozen = wt->freeze();
+    auto frozen_table = frozen->get_table("table");
+
+    for (auto query_string : {"int > 50 AND str == '7'", "int < 10 OR str BEGINSWITH '1'", "int * 2 == str.@size",
+                              "int > 1000"}) {
+        Query q = frozen_table->query(query_string);
+        size_t expected_count = q.count();
+        TableView expected = q.find_all();
+
+        for (size_t threads : {2, 3, 8, 1000}) {
+            Query parallel_query(q);
+            parallel_query.set_max_threads(threads);
+            CHECK_EQUAL(parallel_query.count(), expected_count);
+            TableView tv = parallel_query.find_all();
+            CHECK_EQUAL(tv.size(), expected.size());
+            for (size_t i = 0; i < std::min(tv.size(), expected.size()); ++i)
+                CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+            // A limit forces serial evaluation
+            CHECK_EQUAL(parallel_query.find_all(3).size(), std::min<size_t>(3, expected.size()));
+        }
+    }
+
+    // Queries on live tables are evaluated serially
+    Query live_query = table->where().greater(col_int, 50);
+    live_query.set_max_threads(4);
+    CHECK_EQUAL(live_query.count(), frozen_table->where().greater(col_int, 50).count());
+}
+
+TEST(Query_ParallelAggregates)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef db = DB::create(*hist, path);
+    auto wt = db->start_write();
+    auto table = wt->add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int_null", true);
+    auto col_double = table->add_column(type_Double, "double");
+    auto col_decimal = table->add_column(type_Decimal, "decimal");
+    auto col_mixed = table->add_column(type_Mixed, "mixed");
+    for (int i = 0; i < 5000; ++i) {
+        auto obj = table->create_object();
+        obj.set(col_int, i % 101);
+        if (i % 7)
+            obj.set(col_int_null, int64_t(i % 53));
+        obj.set(col_double, (i % 89) * 0.5);
+        obj.set(col_decimal, Decimal128(i % 31));
+        obj.set(col_mixed, i % 3 ? Mixed(i % 17) : Mixed(double(i % 5)));
+    }
+    wt->commit_and_continue_as_read();
+    auto frozen = wt->freeze();
+    auto frozen_table = frozen->get_table("table");
+
+    for (bool with_condition : {false, true}) {
+        Query q = with_condition ? frozen_table->where().greater(col_double, 10.0) : frozen_table->where();
+        Query pq(q);
+        pq.set_max_threads(4);
+
+        CHECK_EQUAL(pq.sum_int(col_int), q.sum_int(col_int));
+        CHECK_EQUAL(pq.sum_int(col_int_null), q.sum_int(col_int_null));
+        CHECK_EQUAL(pq.sum_double(col_double), q.sum_double(col_double));
+        CHECK_EQUAL(pq.sum_decimal128(col_decimal), q.sum_decimal128(col_decimal));
+        CHECK_EQUAL(pq.sum_mixed(col_mixed), q.sum_mixed(col_mixed));
+
+        size_t count = 0, parallel_count = 0;
+        CHECK_EQUAL(pq.average_int(col_int_null, &parallel_count), q.average_int(col_int_null, &count));
+        CHECK_EQUAL(parallel_count, count);
+        CHECK_EQUAL(pq.average_decimal128(col_decimal), q.average_decimal128(col_decimal));
+
+        // The first occurrence of the extreme value is reported as with serial evaluation
+        ObjKey key, parallel_key;
+        CHECK_EQUAL(pq.maximum_int(col_int, &parallel_key), q.maximum_int(col_int, &key));
+        CHECK_EQUAL(parallel_key, key);
+        CHECK_EQUAL(pq.minimum_double(col_double, &parallel_key), q.minimum_double(col_double, &key));
+        CHECK_EQUAL(parallel_key, key);
+        CHECK_EQUAL(pq.maximum_mixed(col_mixed, &parallel_key), q.maximum_mixed(col_mixed, &key));
+        CHECK_EQUAL(parallel_key, key);
+        CHECK_EQUAL(pq.minimum_decimal128(col_decimal), q.minimum_decimal128(col_decimal));
+    }
+
+    // The leaf-at-a-time sums on the table give the same results as summing per object
+    int64_t expected_sum = 0;
+    for (auto obj : *frozen_table)
+        expected_sum += obj.get<Int>(col_int);
+    CHECK_EQUAL(frozen_table->sum_int(col_int), expected_sum);
+    size_t null_count = 0;
+    frozen_table->average_int(col_int_null, &null_count);
+    CHECK_EQUAL(null_count, frozen_table->where().not_equal(col_int_null, null()).count());
+}
+
+TEST(Query_Cancellation)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    for (int i = 0; i < 2000; ++i)
+        table->create_object().set(col_int, i % 10);
+
+    Query q = table->where().greater(col_int, 4);
+    auto token = std::make_shared<util::CancellationToken>();
+    q.set_cancellation(token);
+    CHECK_EQUAL(q.count(), 1000);
+    CHECK_EQUAL(q.find_all().size(), 1000);
+
+    token->cancel();
+    CHECK_THROW(q.count(), QueryCancelled);
+    CHECK_THROW(q.find_all(), QueryCancelled);
+    CHECK_THROW(q.find(), QueryCancelled);
+    CHECK_THROW(q.sum_int(col_int), QueryCancelled);
+    CHECK_THROW(table->where().set_cancellation(token).find_all(), QueryCancelled);
+    // Copies share the token
+    CHECK_THROW(Query(q).count(), QueryCancelled);
+    q.set_cancellation(nullptr);
+    CHECK_EQUAL(q.count(), 1000);
+
+    // A deadline which has already passed
+    q.set_cancellation(util::CancellationToken::with_timeout(std::chrono::seconds(-1)));
+    CHECK_THROW(q.count(), QueryCancelled);
+    q.set_cancellation(util::CancellationToken::with_timeout(std::chrono::hours(1)));
+    CHECK_EQUAL(q.count(), 1000);
+    q.set_cancellation(nullptr);
+
+    // A token on the descriptor ordering applies to the query using it
+    DescriptorOrdering ordering;
+    ordering.set_cancellation(token);
+    CHECK_THROW(q.find_all(ordering), QueryCancelled);
+    CHECK_THROW(q.count(ordering), QueryCancelled);
+    ordering.append_sort(SortDescriptor({{col_int}}));
+    CHECK_THROW(q.find_all(ordering), QueryCancelled);
+    CHECK_EQUAL(q.find_all(DescriptorOrdering()).size(), 1000);
+}
+
+TEST(Query_Rebind)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_oid = table->add_column(type_ObjectId, "oid", true);
+    auto col_dbl = table->add_column(type_Double, "dbl");
+    auto col_list = table->add_column_list(type_Int, "list");
+    std::vector<ObjKey> keys;
+    std::vector<ObjectId> oids;
+    for (int i = 0; i < 100; ++i) {
+        oids.push_back(ObjectId::gen());
+        auto obj = table->create_object();
+        obj.set(col_int, i % 10).set(col_str, util::format("str %1", i % 5)).set(col_oid, oids.back());
+        obj.set(col_dbl, i * 0.5);
+        obj.get_list<Int>(col_list).add(i % 10);
+        keys.push_back(obj.get_key());
+    }
+
+    Query q = table->where().equal(col_int, 3).set_placeholder(0).greater(col_dbl, 10.0).set_placeholder(1);
+    CHECK_EQUAL(q.count(), 8);
+    q.rebind(0, int64_t(5));
+    CHECK_EQUAL(q.count(), 8);
+    q.rebind(1, 40.0);
+    CHECK_EQUAL(q.count(), 2);
+    CHECK_THROW(q.rebind(0, StringData("str 1")), LogicError);
+    CHECK_THROW(q.rebind(2, int64_t(1)), std::out_of_range);
+    q.rebind(0, int64_t(7));
+    CHECK_EQUAL(q.count(), 2);
+    // Copies are rebound independently
+    Query copy(q);
+    copy.rebind(0, int64_t(1)).rebind(1, 45.0);
+    CHECK_EQUAL(copy.count(), 1);
+    CHECK_EQUAL(q.count(), 2);
+
+    // Bound conditions are not merged into the other conditions of an OR
+    Query q2 = table->where().equal(col_str, "str 1").set_placeholder(0).Or().equal(col_str, "str 2");
+    CHECK_EQUAL(q2.count(), 40);
+    q2.rebind(0, StringData("str 3"));
+    CHECK_EQUAL(q2.count(), 40);
+    q2.rebind(0, StringData("none"));
+    CHECK_EQUAL(q2.count(), 20);
+
+    Query q3 = table->where().contains(col_str, StringData("1"), false).set_placeholder(0);
+    CHECK_EQUAL(q3.count(), 20);
+    q3.rebind(0, StringData("STR"));
+    CHECK_EQUAL(q3.count(), 100);
+
+    Query q4 = table->where().Not().equal(col_int, 3).set_placeholder(0);
+    CHECK_EQUAL(q4.count(), 90);
+    q4.rebind(0, int64_t(42));
+    CHECK_EQUAL(q4.count(), 100);
+
+    Query q5 = table->where().equal(col_oid, oids[7]).set_placeholder(0);
+    CHECK_EQUAL(q5.find(), keys[7]);
+    q5.rebind(0, oids[8]);
+    CHECK_EQUAL(q5.find(), keys[8]);
+
+    // Expressions
+    Query q6 = (table->column<Lst<Int>>(col_list) > 5).set_placeholder(0);
+    CHECK_EQUAL(q6.count(), 40);
+    q6.rebind(0, int64_t(8));
+    CHECK_EQUAL(q6.count(), 10);
+
+    CHECK_THROW(table->where().set_placeholder(0), std::runtime_error);
+}
+
+TEST(Query_BatchEvaluation)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_a = table->add_column(type_Int, "a");
+    auto col_b = table->add_column(type_Int, "b");
+    auto col_x = table->add_column(type_Double, "x");
+    auto col_y = table->add_column(type_Double, "y");
+    // Same values in nullable columns, which are evaluated a value at a time
+    auto col_na = table->add_column(type_Int, "na", true);
+    auto col_nb = table->add_column(type_Int, "nb", true);
+    auto col_nx = table->add_column(type_Double, "nx", true);
+    auto col_ny = table->add_column(type_Double, "ny", true);
+
+    Random random(random_int<unsigned long>());
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int i = 0; i < 3000; ++i) {
+        int64_t a = random.draw_int<int64_t>(-100, 100);
+        int64_t b = i % 50 ? random.draw_int<int64_t>(-2000, 2000) : 0;
+        if (i % 333 == 0)
+            a = (int64_t(1) << 50) + i;
+        double x = (i % 97 == 0) ? nan : random.draw_int<int>(-1000, 1000) * 0.25;
+        double y = (i % 41 == 0) ? 0.0 : random.draw_int<int>(-100, 100) * 0.5;
+        table->create_object().set_all(a, b, x, y, a, b, x, y);
+    }
+
+    const char* expressions[] = {
+        "%a * %b > 1000",
+        "%a + %b == 17",
+        "%b - %a < -150",
+        "%b / %a >= 20",
+        "%a / %b <= -3",
+        "%a * 3 + %b != 0",
+        "1000 < %a * %b",
+        "%x * %y > 1000",
+        "%x / %y < -10",
+        "%x - %y == 0",
+        "%x + 2.5 >= %y",
+        "%x * %x == %y * %y",
+        "%x / %y != %y / %x",
+    };
+    auto substitute = [](std::string expression, const char* prefix) {
+        for (size_t pos = expression.find('%'); pos != std::string::npos; pos = expression.find('%'))
+            expression.replace(pos, 1, prefix);
+        return expression;
+    };
+    for (auto expression : expressions) {
+        Query q = table->query(substitute(expression, ""));
+        Query reference = table->query(substitute(expression, "n"));
+        CHECK_EQUAL(q.count(), reference.count());
+        auto keys = q.find_all();
+        auto reference_keys = reference.find_all();
+        CHECK_EQUAL(keys.size(), reference_keys.size());
+        for (size_t i = 0; i < keys.size() && i < reference_keys.size(); ++i)
+            CHECK_EQUAL(keys.get_key(i), reference_keys.get_key(i));
+    }
+
+    // Mixing integer and floating point operands promotes to double as in Mixed arithmetic
+    CHECK_EQUAL(table->query("a * x > 500").count(), table->query("na * nx > 500").count());
+    CHECK_EQUAL(table->query("a * 0.5 > 40").count(), table->query("na > 80").count());
+}
+
+TEST(Query_CostEstimation)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_double = table->add_column(type_Double, "double");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_indexed = table->add_column(type_Int, "indexed");
+    table->add_search_index(col_indexed);
+    for (int i = 0; i < 20000; ++i) {
+        table->create_object().set_all(i % 1000, i * 0.5, util::to_string(i % 300), i % 7);
+    }
+
+    auto check = [&](Query q, std::function<bool(const Obj&)> pred) {
+        std::vector<ObjKey> expected;
+        for (auto& obj : *table) {
+            if (pred(obj))
+                expected.push_back(obj.get_key());
+        }
+        CHECK_EQUAL(q.count(), expected.size());
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected[i]);
+        CHECK_EQUAL(q.find(), expected.empty() ? ObjKey() : expected.front());
+        // Evaluating the query again starts over with fresh estimates
+        CHECK_EQUAL(q.count(), expected.size());
+    };
+
+    check(table->where().less(col_double, 9000.0).equal(col_str, "17"), [&](const Obj& o) {
+        return o.get<double>(col_double) < 9000.0 && o.get<String>(col_str) == "17";
+    });
+    check(table->where().equal(col_indexed, 3).greater(col_double, 100.0).equal(col_int, 502), [&](const Obj& o) {
+        return o.get<Int>(col_indexed) == 3 && o.get<double>(col_double) > 100.0 && o.get<Int>(col_int) == 502;
+    });
+    check(table->where()
+              .greater(col_int, 10)
+              .group()
+              .equal(col_str, "5")
+              .Or()
+              .equal(col_indexed, 6)
+              .end_group()
+              .Not()
+              .equal(col_int, 11),
+          [&](const Obj& o) {
+              return o.get<Int>(col_int) > 10 &&
+                     (o.get<String>(col_str) == "5" || o.get<Int>(col_indexed) == 6) && o.get<Int>(col_int) != 11;
+          });
+    check(table->query("int * 2 > 1990 AND str BEGINSWITH '29' AND double < 5000"), [&](const Obj& o) {
+        return o.get<Int>(col_int) * 2 > 1990 && o.get<String>(col_str).begins_with("29") &&
+               o.get<double>(col_double) < 5000;
+    });
+}
+
+TEST(Query_CostEstimationReused)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    for (int i = 0; i < 20000; ++i)
+        table->create_object().set_all(i % 1000, util::to_string(i % 3));
+
+    auto sampled_matches = [](const Query& q) {
+        std::vector<size_t> matches;
+        for (auto& condition : q.explain().conditions)
+            matches.push_back(condition.sampled_matches);
+        return matches;
+    };
+    Query q = table->where().equal(col_int, 5).equal(col_str, "1");
+    auto before = sampled_matches(q);
+    CHECK_EQUAL(before.size(), 2);
+
+    // Copies, such as the ones evaluating the query in parallel, take over the sample
+    Query copy(q);
+    CHECK(sampled_matches(copy) == before);
+
+    // The table is sampled again when it has changed
+    for (auto obj : *table)
+        obj.set(col_int, 5);
+    auto after = sampled_matches(q);
+    CHECK_NOT(after == before);
+    CHECK(sampled_matches(copy) == after);
+    CHECK_EQUAL(q.count(), table->where().equal(col_str, "1").count());
+
+    // and so are the conditions
+    q.greater(col_int, 4);
+    CHECK_EQUAL(sampled_matches(q).size(), 3);
+}
+
+TEST(Query_Explain)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_indexed = table->add_column(type_Int, "indexed");
+    table->add_search_index(col_indexed);
+    for (int i = 0; i < 5000; ++i) {
+        table->create_object().set_all(i, util::to_string(i % 10), i % 4);
+    }
+
+    Query q = table->where().greater(col_int, 100).equal(col_str, "3");
+    auto plan = q.explain();
+    CHECK_NOT(plan.analyzed);
+    CHECK_EQUAL(plan.conditions.size(), 2);
+    // Sampling shows the string condition to be the more selective one
+    CHECK_EQUAL(plan.conditions[0].description, "str == \"3\"");
+    CHECK_EQUAL(plan.conditions[1].description, "int > 100");
+    CHECK_NOT(plan.conditions[0].uses_index);
+    CHECK_GREATER(plan.conditions[0].sampled_rows, 0);
+    CHECK_LESS(plan.conditions[0].estimated_cost, plan.conditions[1].estimated_cost);
+
+    auto analyzed = q.explain_analyze();
+    CHECK(analyzed.analyzed);
+    CHECK_EQUAL(analyzed.rows_matched, 490);
+    size_t leaves = 0;
+    table->traverse_clusters([&](const Cluster*) {
+        ++leaves;
+        return false;
+    });
+    CHECK_EQUAL(analyzed.leaves_scanned, leaves);
+    // Each row is searched by exactly one of the conditions driving the query
+    size_t scanned = 0;
+    for (auto& condition : analyzed.conditions) {
+        scanned += condition.rows_scanned;
+        CHECK_LESS_EQUAL(condition.rows_matched, condition.rows_scanned + condition.rows_tested);
+    }
+    CHECK_EQUAL(scanned, table->size());
+    // Analyzing does not leave statistics on the query itself
+    CHECK_EQUAL(q.explain().conditions[1].rows_scanned, 0);
+
+    // Nested groups and index use
+    Query nested = table->where().equal(col_indexed, 2).group().equal(col_str, "2").Or().less(col_int, 10).end_group();
+    auto nested_plan = nested.explain_analyze();
+    CHECK_EQUAL(nested_plan.rows_matched, nested.count());
+    CHECK_EQUAL(nested_plan.conditions.size(), 2);
+    CHECK(nested_plan.conditions[0].uses_index);
+    CHECK_EQUAL(nested_plan.conditions[1].children.size(), 2);
+    std::string text = nested_plan.to_string();
+    CHECK_EQUAL(text.find(util::format("%1 rows matched", nested_plan.rows_matched)), 0);
+    CHECK_NOT_EQUAL(text.find("indexed == 2 (index"), std::string::npos);
+    CHECK_NOT_EQUAL(text.find("\n  int < 10 (scan"), std::string::npos);
+}
+
+TEST(Query_CombinedIndexes)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "str");
+    auto col_mixed = table->add_column(type_Mixed, "mixed");
+    auto col_value = table->add_column(type_Int, "value");
+    table->add_search_index(col_int);
+    table->add_search_index(col_str);
+    table->add_search_index(col_mixed);
+    for (int i = 0; i < 3000; ++i) {
+        table->create_object().set_all(i % 7, util::to_string(i % 11), Mixed(i % 3), i);
+    }
+
+    auto check = [&](Query q, std::function<bool(int)> pred) {
+        size_t expected = 0;
+        int64_t expected_sum = 0;
+        for (int i = 0; i < 3000; ++i) {
+            if (pred(i)) {
+                ++expected;
+                expected_sum += i;
+            }
+        }
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected);
+        for (size_t i = 0; i < tv.size(); ++i) {
+            CHECK(pred(int(tv.get_object(i).get<Int>(col_value))));
+        }
+        CHECK_EQUAL(q.count(), expected);
+        CHECK_EQUAL(q.sum_int(col_value), expected_sum);
+        CHECK_EQUAL(q.find_all(5).size(), std::min<size_t>(expected, 5));
+        DescriptorOrdering limit;
+        limit.append_limit(LimitDescriptor(5));
+        CHECK_EQUAL(q.count(limit), std::min<size_t>(expected, 5));
+    };
+
+    // Every condition uses a search index
+    check(table->where().equal(col_int, 3).equal(col_str, "5"), [](int i) {
+        return i % 7 == 3 && i % 11 == 5;
+    });
+    check(table->where().equal(col_str, "5").equal(col_mixed, Mixed(2)).equal(col_int, 3), [](int i) {
+        return i % 7 == 3 && i % 11 == 5 && i % 3 == 2;
+    });
+    // A range condition is tested on the objects found through the indexes
+    check(table->where().equal(col_int, 3).greater(col_value, 1000).equal(col_str, "5"), [](int i) {
+        return i % 7 == 3 && i % 11 == 5 && i > 1000;
+    });
+    // No object matches all of the indexed conditions
+    check(table->where().equal(col_int, 3).equal(col_str, "12"), [](int) {
+        return false;
+    });
+    // Case insensitive lookups may come back out of key order
+    check(table->where().equal(col_str, "5", false).equal(col_int, 3), [](int i) {
+        return i % 7 == 3 && i % 11 == 5;
+    });
+
+    auto plan = table->where().equal(col_int, 3).equal(col_str, "5").explain();
+    CHECK_EQUAL(plan.conditions.size(), 2);
+    CHECK(plan.conditions[0].uses_index);
+    CHECK(plan.conditions[1].uses_index);
+}
+
+TEST(Query_Fulltext)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_text = table->add_column(type_String, "text", true);
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_indexed = table->add_column(type_Int, "indexed");
+    table->add_search_index(col_indexed);
+    std::vector<std::string> words = {"alpha", "Beta", "gamma", "delta", "epsilon"};
+    for (int i = 0; i < 3000; ++i) {
+        std::string text = words[i % 5] + ", " + words[i % 3] + "!";
+        if (i % 7 == 0)
+            text += " r\xc3\xb8""dgr\xc3\xb8""d";
+        table->create_object().set(col_text, text).set(col_int, i).set(col_indexed, i % 2);
+    }
+    table->create_object().set(col_int, 5000); // null
+    table->create_object().set(col_text, "").set(col_int, 5000);
+
+    auto check = [&](Query q, std::function<bool(int)> pred) {
+        size_t expected = 0;
+        for (int i = 0; i < 3000; ++i) {
+            if (pred(i))
+                ++expected;
+        }
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected);
+        for (size_t i = 0; i < tv.size(); ++i) {
+            CHECK(pred(int(tv.get_object(i).get<Int>(col_int))));
+        }
+        CHECK_EQUAL(q.count(), expected);
+    };
+    auto has_word = [](int i, int w) {
+        return i % 5 == w || i % 3 == w;
+    };
+
+    check(table->where().fulltext(col_text, "beta"), [&](int i) {
+        return has_word(i, 1);
+    });
+    check(table->where().fulltext(col_text, "GAMMA alpha"), [&](int i) {
+        return has_word(i, 2) && has_word(i, 0);
+    });
+    check(table->where().fulltext(col_text, "r\xc3\xb8""dgr\xc3\xb8""d"), [&](int i) {
+        return i % 7 == 0;
+    });
+    // Only whole words match
+    check(table->where().fulltext(col_text, "alp"), [](int) {
+        return false;
+    });
+    check(table->where().fulltext(col_text, " ,. "), [](int) {
+        return false;
+    });
+    // Combined with scanning, OR, NOT and other index based conditions
+    check(table->where().fulltext(col_text, "delta").greater(col_int, 1500), [&](int i) {
+        return has_word(i, 3) && i > 1500;
+    });
+    check(table->where().fulltext(col_text, "delta").equal(col_indexed, 1), [&](int i) {
+        return has_word(i, 3) && i % 2 == 1;
+    });
+    check(table->where().group().fulltext(col_text, "epsilon").Or().less(col_int, 10).end_group(), [&](int i) {
+        return has_word(i, 4) || i < 10;
+    });
+    check(table->where().Not().fulltext(col_text, "alpha").less(col_int, 3000), [&](int i) {
+        return !has_word(i, 0);
+    });
+
+    // The index follows changes to the table
+    Query q = table->where().fulltext(col_text, "zeta");
+    CHECK_EQUAL(q.count(), 0);
+    auto obj = table->get_object(0);
+    obj.set(col_text, "Zeta");
+    CHECK_EQUAL(q.count(), 1);
+    CHECK_EQUAL(table->where().fulltext(col_text, "alpha").count(), 1399);
+    obj.remove();
+    CHECK_EQUAL(q.count(), 0);
+
+    CHECK_EQUAL(table->where().fulltext(col_text, "beta alpha").get_description(),
+                "text TEXT \"beta alpha\"");
+    CHECK_THROW(table->where().fulltext(col_int, "alpha"), LogicError);
+}
+
+TEST(Query_GeoWithin)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    auto col_lat = table->add_column(type_Double, "lat", true);
+    auto col_lon = table->add_column(type_Double, "lon");
+    auto col_int = table->add_column(type_Int, "int");
+    // Points ordered by latitude, so that whole leaves can be skipped
+    std::vector<GeoPoint> points;
+    for (int i = 0; i < 3600; ++i) {
+        GeoPoint point{-89.5 + i * (179.0 / 3600), -180 + (i * 37) % 360 + 0.5};
+        points.push_back(point);
+        table->create_object().set(col_lat, point.latitude).set(col_lon, point.longitude).set(col_int, i);
+    }
+    table->create_object().set(col_lon, 10.0).set(col_int, 5000); // null latitude
+
+    auto check = [&](Query q, std::function<bool(const GeoPoint&)> pred) {
+        size_t expected = 0;
+        for (auto& point : points) {
+            if (pred(point))
+                ++expected;
+        }
+        CHECK_GREATER(expected, 0);
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected);
+        for (size_t i = 0; i < tv.size(); ++i) {
+            auto n = tv.get_object(i).get<Int>(col_int);
+            CHECK(n < 3600 && pred(points[n]));
+        }
+        CHECK_EQUAL(q.count(), expected);
+    };
+
+    GeoBox box{{10, -20}, {40, 30}};
+    check(table->where().geo_within(col_lat, col_lon, box), [&](const GeoPoint& p) {
+        return p.latitude >= 10 && p.latitude <= 40 && p.longitude >= -20 && p.longitude <= 30;
+    });
+    // Crossing the antimeridian
+    GeoBox wrapping{{-30, 170}, {30, -170}};
+    check(table->where().geo_within(col_lat, col_lon, wrapping), [&](const GeoPoint& p) {
+        return p.latitude >= -30 && p.latitude <= 30 && (p.longitude >= 170 || p.longitude <= -170);
+    });
+    GeoCircle circle{{50, 5}, 2000};
+    check(table->where().geo_within(col_lat, col_lon, circle), [&](const GeoPoint& p) {
+        return geo_distance_km(circle.center, p) <= 2000;
+    });
+    GeoCircle date_line{{0, 179}, 1500};
+    check(table->where().geo_within(col_lat, col_lon, date_line), [&](const GeoPoint& p) {
+        return geo_distance_km(date_line.center, p) <= 1500;
+    });
+    GeoCircle pole{{85, 0}, 1000};
+    check(table->where().geo_within(col_lat, col_lon, pole), [&](const GeoPoint& p) {
+        return geo_distance_km(pole.center, p) <= 1000;
+    });
+    // Combined with other conditions
+    check(table->where().geo_within(col_lat, col_lon, circle).less(col_int, 3000), [&](const GeoPoint& p) {
+        return geo_distance_km(circle.center, p) <= 2000 && &p - points.data() < 3000;
+    });
+    check(table->where().less(col_int, 100).Or().geo_within(col_lat, col_lon, box), [&](const GeoPoint& p) {
+        return &p - points.data() < 100 ||
+               (p.latitude >= 10 && p.latitude <= 40 && p.longitude >= -20 && p.longitude <= 30);
+    });
+
+    CHECK_EQUAL(geo_distance_km({0, 0}, {0, 0}), 0);
+    CHECK_APPROXIMATELY_EQUAL(geo_distance_km({0, 0}, {0, 180}), earth_radius_km * 3.14159265358979323846, 1e-9);
+    CHECK_THROW(table->where().geo_within(col_lat, col_int, box), LogicError);
+    CHECK_THROW(table->where().geo_within(col_lat, col_lon, GeoCircle{{0, 0}, -1}), std::runtime_error);
+}
+
+TEST(Query_ApproximateAggregates)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_double = table.add_column(type_Double, "double");
+    auto col_str = table.add_column(type_String, "str");
+    table.add_search_index(col_str);
+    const size_t num_rows = 100 * REALM_MAX_BPNODE_SIZE;
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.create_object().set_all(int64_t(i % 100), double(i % 10), i % 20 ? "common" : "rare");
+    }
+
+    auto check_estimate = [&](const Query::Estimate& estimate, double exact) {
+        CHECK_LESS(estimate.sampled_rows, num_rows / 2);
+        CHECK_GREATER(estimate.error_bound, 0);
+        CHECK_LESS_EQUAL(std::abs(estimate.value - exact), estimate.error_bound);
+    };
+
+    Query q = table.where().less(col_int, 10);
+    check_estimate(q.count_approximate(0.05), double(q.count()));
+    check_estimate(q.sum_approximate(col_double, 0.05), q.sum_double(col_double));
+    check_estimate(q.average_approximate(col_double, 0.05), q.average_double(col_double));
+    check_estimate(table.where().sum_approximate(col_int, 0.05), double(table.where().sum_int(col_int)));
+
+    // The whole table is sampled
+    auto estimate = q.count_approximate(1.0);
+    CHECK_EQUAL(estimate.value, double(num_rows / 10));
+    CHECK_EQUAL(estimate.error_bound, 0);
+
+    // Nothing matches the sample, which still bounds the count
+    estimate = table.where().greater(col_int, 1000).count_approximate(0.05);
+    CHECK_EQUAL(estimate.value, 0);
+    CHECK_GREATER(estimate.error_bound, 0);
+    CHECK_LESS(estimate.error_bound, double(num_rows) / 10);
+
+    // A search index gives the exact count
+    estimate = table.where().equal(col_str, "rare").count_approximate(0.05);
+    CHECK_EQUAL(estimate.value, double(num_rows / 20));
+    CHECK_EQUAL(estimate.error_bound, 0);
+    CHECK_EQUAL(table.where().equal(col_str, "rare").count(), num_rows / 20);
+    CHECK_EQUAL(table.where().equal(col_str, "missing").count(), 0);
+    CHECK_EQUAL(table.where().equal(col_str, "rare").less(col_int, 50).count(), num_rows * 3 / 100);
+
+    CHECK_THROW(table.where().sum_approximate(col_str), LogicError);
+}
+
 #endif // TEST_QUERY
@@ -5326,6 +5326,61 @@ TEST(Query_StringOrLongStrings)
     }
 }
 
+TEST(Query_StringDictEncodedLeaves)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options;
+    options.enable_string_dictionary_encoding = true;
+    DBRef db = DB::create(path, false, options);
+    auto wt = db->start_write();
+    CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*wt), 23);
+    TableRef table = wt->add_table("table");
+    auto col_value = table->add_column(type_String, "value", true);
+
+    // Every leaf has few distinct values, so they are all dictionary encoded
+    const char* countries[] = {"Denmark", "Norway", "Sweden", "Finland", "Iceland"};
+    const size_t num_objects = 3000;
+    for (size_t i = 0; i < num_objects; ++i) {
+        auto obj = table->create_object();
+        if (i % 6)
+            obj.set(col_value, countries[i % 5]);
+    }
+
+    auto count = [&](StringData value, size_t step = 1) {
+        size_t n = 0;
+        for (size_t i = 0; i < num_objects; i += step) {
+            if (value.is_null() ? i % 6 == 0 : (i % 6 && value == countries[i % 5]))
+                ++n;
+        }
+        return n;
+    };
+    for (auto country : countries)
+        CHECK_EQUAL(table->where().equal(col_value, country).count(), count(country));
+    CHECK_EQUAL(table->where().equal(col_value, StringData()).count(), count(StringData()));
+    CHECK_EQUAL(table->where().equal(col_value, "Greenland").count(), 0);
+    CHECK_EQUAL(table->where().not_equal(col_value, "Norway").count(), num_objects - count("Norway"));
+    CHECK_EQUAL(table->where().contains(col_value, StringData("land")).count(), count("Finland") + count("Iceland"));
+
+    Query q = table->where()
+                  .group()
+                  .equal(col_value, "Denmark")
+                  .Or()
+                  .equal(col_value, "Iceland")
+                  .Or()
+                  .equal(col_value, "Greenland")
+                  .end_group();
+    CHECK_EQUAL(q.count(), count("Denmark") + count("Iceland"));
+
+    // A leaf with many distinct values is decoded again
+    for (auto& obj : *table) {
+        if (obj.get_key().value % 2)
+            obj.set(col_value, util::to_string(obj.get_key().value));
+    }
+    CHECK_EQUAL(table->where().equal(col_value, "101").count(), 1);
+    CHECK_EQUAL(table->where().equal(col_value, "Denmark").count(), count("Denmark", 2));
+    wt->verify();
+}
+
 TEST(Query_LinkViewAnd)
 {
     Group g;
@@ -5905,4 +5960,440 @@ TEST(Query_links_to_with_bpnode_split)
     }
 }
 
+TEST(Query_LinkedPropertySemiJoin)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Group g;
+    auto target = g.add_table("Target");
+    auto parent = g.add_table("Parent");
+    auto col_price = target->add_column(type_Int, "price", true);
+    auto col_name = target->add_column(type_String, "name", true);
+    auto col_items = parent->add_column_list(*target, "items");
+    auto col_link = parent->add_column(*target, "link");
+    auto col_count = parent->add_column(type_Int, "count");
+
+    const char* names[] = {"alpha", "beta", "gamma"};
+    std::vector<ObjKey> target_keys;
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = target->create_object();
+        if (random.draw_int_mod(10) != 0)
+            obj.set(col_price, random.draw_int_mod<int64_t>(100));
+        if (random.draw_int_mod(10) != 0)
+            obj.set(col_name, StringData(names[random.draw_int_mod(3)]));
+        target_keys.push_back(obj.get_key());
+    }
+    for (int i = 0; i < 3000; ++i) {
+        auto obj = parent->create_object().set(col_count, random.draw_int_mod<int64_t>(10));
+        if (random.draw_int_mod(5) != 0)
+            obj.set(col_link, target_keys[random.draw_int_mod(target_keys.size())]);
+        auto items = obj.get_linklist(col_items);
+        for (size_t n = random.draw_int_mod(6); n > 0; --n)
+            items.add(target_keys[random.draw_int_mod(target_keys.size())]);
+    }
+
+    auto price_greater = [&](ObjKey k) {
+        auto price = target->get_object(k).get<util::Optional<int64_t>>(col_price);
+        return price && *price > 50;
+    };
+    auto check = [&](const Table& table, const std::string& query, util::FunctionRef<bool(const Obj&)> expected) {
+        size_t expected_count = 0;
+        for (auto& obj : table) {
+            if (expected(obj))
+                ++expected_count;
+        }
+        CHECK_EQUAL(table.query(query).count(), expected_count);
+        auto tv = table.query(query).find_all();
+        CHECK_EQUAL(tv.size(), expected_count);
+        for (size_t i = 0; i < tv.size(); ++i)
+            CHECK(expected(tv.get_object(i)));
+    };
+    auto run_checks = [&] {
+        check(*parent, "ANY items.price > 50", [&](const Obj& obj) {
+            auto items = obj.get_linklist(col_items);
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (price_greater(items.get(i)))
+                    return true;
+            }
+            return false;
+        });
+        check(*parent, "ALL items.price > 50", [&](const Obj& obj) {
+            auto items = obj.get_linklist(col_items);
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (!price_greater(items.get(i)))
+                    return false;
+            }
+            return true;
+        });
+        check(*parent, "NONE items.name == 'beta'", [&](const Obj& obj) {
+            auto items = obj.get_linklist(col_items);
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (target->get_object(items.get(i)).get<String>(col_name) == "beta")
+                    return false;
+            }
+            return true;
+        });
+        check(*parent, "link.price == NULL", [&](const Obj& obj) {
+            auto k = obj.get<ObjKey>(col_link);
+            return !k || target->get_object(k).is_null(col_price);
+        });
+        check(*parent, "link.price != 20", [&](const Obj& obj) {
+            auto k = obj.get<ObjKey>(col_link);
+            return !k || target->get_object(k).get<util::Optional<int64_t>>(col_price) != int64_t(20);
+        });
+        check(*parent, "link.name BEGINSWITH 'g' AND count > 4", [&](const Obj& obj) {
+            auto k = obj.get<ObjKey>(col_link);
+            return k && target->get_object(k).get<String>(col_name).begins_with("g") && obj.get<Int>(col_count) > 4;
+        });
+        check(*target, "ANY @links.Parent.items.count > 7", [&](const Obj& obj) {
+            for (size_t i = 0; i < obj.get_backlink_count(*parent, col_items); ++i) {
+                if (parent->get_object(obj.get_backlink(*parent, col_items, i)).get<Int>(col_count) > 7)
+                    return true;
+            }
+            return false;
+        });
+    };
+
+    run_checks();
+    // Removing targets nullifies links and shrinks lists
+    for (int i = 0; i < 100; ++i) {
+        size_t ndx = random.draw_int_mod(target_keys.size());
+        target->remove_object(target_keys[ndx]);
+        target_keys.erase(target_keys.begin() + ndx);
+    }
+    run_checks();
+}
+
+TEST(Query_BacklinkCount)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Group g;
+    auto target = g.add_table("Target");
+    auto origin1 = g.add_table("Origin1");
+    auto origin2 = g.add_table("Origin2");
+    auto col_int = target->add_column(type_Int, "int");
+    auto col_link = origin1->add_column(*target, "link");
+    auto col_list = origin1->add_column_list(*target, "list");
+    auto col_list2 = origin2->add_column_list(*target, "list");
+
+    std::vector<ObjKey> keys;
+    target->create_objects(1000, keys);
+    for (auto k : keys)
+        target->get_object(k).set(col_int, random.draw_int_mod<int64_t>(5));
+    for (int i = 0; i < 2000; ++i) {
+        auto obj = origin1->create_object();
+        if (random.draw_bool())
+            obj.set(col_link, keys[random.draw_int_mod(keys.size())]);
+        auto list = obj.get_linklist(col_list);
+        for (size_t n = random.draw_int_mod(4); n > 0; --n)
+            list.add(keys[random.draw_int_mod(keys.size())]);
+        auto list2 = origin2->create_object().get_linklist(col_list2);
+        for (size_t n = random.draw_int_mod(4); n > 0; --n)
+            list2.add(keys[random.draw_int_mod(keys.size())]);
+    }
+
+    auto check = [&](const std::string& query, util::FunctionRef<bool(size_t, int64_t)> expected) {
+        size_t expected_count = 0;
+        for (auto& obj : *target) {
+            if (expected(obj.get_backlink_count(), obj.get<Int>(col_int)))
+                ++expected_count;
+        }
+        CHECK_EQUAL(target->query(query).count(), expected_count);
+        auto tv = target->query(query).find_all();
+        CHECK_EQUAL(tv.size(), expected_count);
+        for (size_t i = 0; i < tv.size(); ++i) {
+            auto obj = tv.get_object(i);
+            CHECK(expected(obj.get_backlink_count(), obj.get<Int>(col_int)));
+        }
+    };
+    check("@links.@count > 5", [](size_t count, int64_t) {
+        return count > 5;
+    });
+    check("@links.@count == 0", [](size_t count, int64_t) {
+        return count == 0;
+    });
+    check("@links.@count < int", [](size_t count, int64_t i) {
+        return int64_t(count) < i;
+    });
+    check("@links.@count > 4.5", [](size_t count, int64_t) {
+        return count > 4;
+    });
+}
+
+TEST(Query_MixedLeafTypes)
+{
+    Table table;
+    table.set_node_sizes(16, 0);
+    auto col = table.add_column(type_Mixed, "mixed", true);
+
+    // Leaves holding only strings, only small ints, ints mixed with doubles,
+    // and a mix of everything including nulls and binaries.
+    std::vector<Mixed> values;
+    for (int i = 0; i < 16; i++)
+        values.push_back(Mixed(util::format("str %1", i % 5)));
+    for (int i = 0; i < 16; i++)
+        values.push_back(Mixed(int64_t(i % 7)));
+    for (int i = 0; i < 16; i++)
+        values.push_back(i % 2 ? Mixed(double(i % 7)) : Mixed(int64_t(i % 7)));
+    std::string bin = "str 3";
+    for (int i = 0; i < 16; i++) {
+        switch (i % 6) {
+            case 0:
+                values.push_back(Mixed());
+                break;
+            case 1:
+                values.push_back(Mixed(true));
+                break;
+            case 2:
+                values.push_back(Mixed(BinaryData(bin.data(), bin.size())));
+                break;
+            case 3:
+                values.push_back(Mixed(int64_t(5000000000) + i));
+                break;
+            case 4:
+                values.push_back(Mixed(Timestamp(i, 0)));
+                break;
+            default:
+                values.push_back(Mixed("STR 3"));
+                break;
+        }
+    }
+    for (auto& v : values)
+        table.create_object().set_any(col, v);
+
+    auto check = [&](Query q, util::FunctionRef<bool(const QueryValue&)> expected) {
+        size_t expected_count = 0;
+        for (auto& v : values) {
+            if (expected(QueryValue(v)))
+                ++expected_count;
+        }
+        CHECK_EQUAL(q.count(), expected_count);
+    };
+    std::vector<Mixed> needles = {Mixed(),        Mixed(int64_t(3)), Mixed(3.0),  Mixed(int64_t(5000000003)),
+                                  Mixed("str 3"), Mixed(true),       Mixed(1.5f), Mixed(Timestamp(4, 0))};
+    for (auto& needle : needles) {
+        QueryValue n(needle);
+        check(table.where().equal(col, needle), [&](const QueryValue& v) {
+            return Equal()(v, n);
+        });
+        check(table.where().greater(col, needle), [&](const QueryValue& v) {
+            return Greater()(v, n);
+        });
+        check(table.where().less_equal(col, needle), [&](const QueryValue& v) {
+            return LessEqual()(v, n);
+        });
+    }
+    QueryValue prefix(Mixed("str"));
+    check(table.where().begins_with(col, Mixed("str")), [&](const QueryValue& v) {
+        return BeginsWith()(prefix, v);
+    });
+    check(table.where().begins_with(col, Mixed("str"), false), [&](const QueryValue& v) {
+        return BeginsWithIns()(prefix, v);
+    });
+    check(table.where().contains(col, Mixed()), [&](const QueryValue& v) {
+        return Contains()(QueryValue(), v);
+    });
+}
+
+TEST(Query_LeafRanges)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    auto db = DB::create(*hist, path, DBOptions(crypt_key()));
+    ColKey col_int, col_null_int, col_double, col_null_float, col_time, col_decimal;
+    constexpr int64_t nb_rows = 1000;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        table->set_node_sizes(16, 0);
+        col_int = table->add_column(type_Int, "int");
+        col_null_int = table->add_column(type_Int, "null_int", true);
+        col_double = table->add_column(type_Double, "double");
+        col_null_float = table->add_column(type_Float, "null_float", true);
+        col_time = table->add_column(type_Timestamp, "time", true);
+        col_decimal = table->add_column(type_Decimal, "decimal", true);
+        // Values increase with the key, so most leaves can be skipped
+        for (int64_t i = 0; i < nb_rows; i++) {
+            auto obj = table->create_object();
+            obj.set(col_int, i);
+            if (i % 3)
+                obj.set(col_null_int, i);
+            obj.set(col_double, double(i) / 2);
+            if (i % 5)
+                obj.set(col_null_float, float(i));
+            if (i % 7)
+                obj.set(col_time, Timestamp(i, 0));
+            if (i % 11)
+                obj.set(col_decimal, Decimal128(i));
+        }
+        wt->commit();
+    }
+
+    auto check_all = [&](ConstTableRef table) {
+        auto check = [&](Query q, util::FunctionRef<bool(const Obj&)> expected) {
+            size_t expected_count = 0;
+            for (auto& obj : *table) {
+                if (expected(obj))
+                    ++expected_count;
+            }
+            // The first run records the leaves, the next computes the ranges
+            // and the last one uses them
+            for (int run = 0; run < 3; run++) {
+                CHECK_EQUAL(q.count(), expected_count);
+                CHECK_EQUAL(q.find_all().size(), expected_count);
+            }
+        };
+        check(table->where().greater(col_int, 900), [&](const Obj& o) {
+            return o.get<Int>(col_int) > 900;
+        });
+        check(table->where().equal(col_int, 500), [&](const Obj& o) {
+            return o.get<Int>(col_int) == 500;
+        });
+        check(table->where().less_equal(col_null_int, 100), [&](const Obj& o) {
+            auto v = o.get<util::Optional<Int>>(col_null_int);
+            return v && *v <= 100;
+        });
+        check(table->where().equal(col_null_int, null()), [&](const Obj& o) {
+            return o.is_null(col_null_int);
+        });
+        check(table->where().between(col_double, 100.0, 120.0), [&](const Obj& o) {
+            auto v = o.get<Double>(col_double);
+            return v >= 100 && v <= 120;
+        });
+        check(table->where().less(col_null_float, 50.f), [&](const Obj& o) {
+            auto v = o.get<util::Optional<Float>>(col_null_float);
+            return v && *v < 50;
+        });
+        check(table->where().equal(col_null_float, null()), [&](const Obj& o) {
+            return o.is_null(col_null_float);
+        });
+        check(table->where().greater_equal(col_time, Timestamp(950, 0)), [&](const Obj& o) {
+            auto v = o.get<Timestamp>(col_time);
+            return !v.is_null() && v >= Timestamp(950, 0);
+        });
+        check(table->where().equal(col_time, Timestamp()), [&](const Obj& o) {
+            return o.is_null(col_time);
+        });
+        check(table->where().greater(col_decimal, Decimal128(990)), [&](const Obj& o) {
+            auto v = o.get<Decimal128>(col_decimal);
+            return !v.is_null() && v > Decimal128(990);
+        });
+    };
+
+    auto rt = db->start_read();
+    check_all(rt->get_table("table"));
+
+    // Values written after the ranges were computed must be found
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        for (auto& obj : *table) {
+            if (obj.get<Int>(col_int) % 100 == 0) {
+                obj.set(col_int, 1000 + obj.get<Int>(col_int));
+                obj.set(col_null_int, 0);
+                obj.set(col_double, 110.0);
+                obj.set_null(col_null_float);
+                obj.set(col_time, Timestamp(1000, 0));
+                obj.set(col_decimal, Decimal128(1000));
+            }
+        }
+        check_all(table);
+        wt->commit();
+    }
+    rt->advance_read();
+    check_all(rt->get_table("table"));
+}
+
+TEST(Query_LeafBloomFilters)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    auto db = DB::create(*hist, path, DBOptions(crypt_key()));
+    ColKey col_str, col_oid, col_uuid;
+    constexpr int64_t nb_rows = 1000;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        table->set_node_sizes(16, 0);
+        col_str = table->add_column(type_String, "str", true);
+        col_oid = table->add_column(type_ObjectId, "oid", true);
+        col_uuid = table->add_column(type_UUID, "uuid", true);
+        for (int64_t i = 0; i < nb_rows; i++) {
+            auto obj = table->create_object();
+            if (i % 3)
+                obj.set(col_str, StringData(util::format("str %1", i % 400)));
+            if (i % 5)
+                obj.set(col_oid, ObjectId::gen());
+            if (i % 7)
+                obj.set(col_uuid, UUID(util::format("3b241101-e2bb-4255-8caf-4136c566%1", 1000 + i)));
+        }
+        wt->commit();
+    }
+
+    auto check_all = [&](ConstTableRef table) {
+        auto check = [&](Query q, util::FunctionRef<bool(const Obj&)> expected) {
+            size_t expected_count = 0;
+            for (auto& obj : *table) {
+                if (expected(obj))
+                    ++expected_count;
+            }
+            // The first run records the leaves, the next computes the filters
+            // and the last one uses them
+            for (int run = 0; run < 3; run++) {
+                CHECK_EQUAL(q.count(), expected_count);
+                CHECK_EQUAL(q.find_all().size(), expected_count);
+            }
+        };
+        check(table->where().equal(col_str, "str 123"), [&](const Obj& o) {
+            return o.get<String>(col_str) == "str 123";
+        });
+        check(table->where().equal(col_str, "no match"), [&](const Obj&) {
+            return false;
+        });
+        check(table->where().equal(col_str, StringData()), [&](const Obj& o) {
+            return o.is_null(col_str);
+        });
+        check(table->where().equal(col_str, "str 7").Or().equal(col_str, "str 399").Or().equal(col_str, "none"),
+              [&](const Obj& o) {
+                  auto v = o.get<String>(col_str);
+                  return v == "str 7" || v == "str 399";
+              });
+        auto oid = table->get_object(501).get<ObjectId>(col_oid);
+        check(table->where().equal(col_oid, oid), [&](const Obj& o) {
+            return o.get<util::Optional<ObjectId>>(col_oid) == oid;
+        });
+        check(table->where().equal(col_oid, null()), [&](const Obj& o) {
+            return o.is_null(col_oid);
+        });
+        auto uuid = table->get_object(501).get<UUID>(col_uuid);
+        check(table->where().equal(col_uuid, uuid), [&](const Obj& o) {
+            return o.get<util::Optional<UUID>>(col_uuid) == uuid;
+        });
+        check(table->where().equal(col_uuid, null()), [&](const Obj& o) {
+            return o.is_null(col_uuid);
+        });
+    };
+
+    auto rt = db->start_read();
+    check_all(rt->get_table("table"));
+
+    // Values written after the filters were computed must be found
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        auto oid = table->get_object(501).get<ObjectId>(col_oid);
+        auto uuid = table->get_object(501).get<UUID>(col_uuid);
+        for (auto& obj : *table) {
+            if (obj.get_key().value % 100 == 0) {
+                obj.set(col_str, "str 123");
+                obj.set(col_oid, oid);
+                obj.set(col_uuid, uuid);
+            }
+        }
+        check_all(table);
+        wt->commit();
+    }
+    rt->advance_read();
+    check_all(rt->get_table("table"));
+}
+
 #endif // TEST_QUERY
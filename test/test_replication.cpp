@@ -198,4 +198,128 @@ TEST(Replication_WriteWithoutHistory)
     }
 }
 
+namespace {
+
+struct SetCounter : _impl::NullInstructionObserver {
+    std::vector<std::pair<ColKey, ObjKey>> sets;
+    bool modify_object(ColKey col_key, ObjKey key)
+    {
+        sets.emplace_back(col_key, key);
+        return true;
+    }
+};
+
+struct SetRangeCounter : SetCounter {
+    size_t num_ranges = 0;
+    bool modify_object_range(ColKey col_key, ObjKey first_key, size_t count)
+    {
+        ++num_ranges;
+        for (size_t i = 0; i < count; ++i)
+            sets.emplace_back(col_key, ObjKey(first_key.value + int64_t(i)));
+        return true;
+    }
+};
+
+} // anonymous namespace
+
+TEST(Replication_CoalescedSets)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    std::vector<std::pair<ColKey, ObjKey>> expected;
+    BinaryData changes;
+    std::string log;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        auto col_a = table->add_column(type_Int, "a");
+        auto col_b = table->add_column(type_Int, "b");
+        // Generated keys are not consecutive across clusters
+        std::vector<ObjKey> keys;
+        for (int64_t i = 0; i < 1000; ++i)
+            keys.emplace_back(i);
+        table->create_objects(keys);
+        wt->commit_and_continue_writing();
+        auto repl = db->get_replication();
+        table->get_object(keys[0]).set(col_a, 1);
+        expected.emplace_back(col_a, keys[0]);
+        size_t size_before = repl->get_uncommitted_changes().size();
+        for (size_t i = 1; i < keys.size(); ++i) {
+            table->get_object(keys[i]).set(col_a, 1);
+            expected.emplace_back(col_a, keys[i]);
+        }
+        // The run of 1000 sets takes no more space than a single set
+        CHECK_LESS(repl->get_uncommitted_changes().size(), size_before + 4);
+        // Not consecutive, so not coalesced
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            table->get_object(keys[i]).set(col_b, 1);
+            expected.emplace_back(col_b, keys[i]);
+        }
+        // A run is broken by other instructions
+        table->get_object(keys[0]).set(col_a, 2);
+        table->create_object();
+        table->get_object(keys[1]).set(col_a, 2);
+        expected.emplace_back(col_a, keys[0]);
+        expected.emplace_back(col_a, keys[1]);
+
+        changes = repl->get_uncommitted_changes();
+        log.assign(changes.data(), changes.size());
+        wt->rollback();
+    }
+    SetCounter counter;
+    {
+        util::SimpleInputStream in({log.data(), log.size()});
+        _impl::TransactLogParser parser;
+        parser.parse(in, counter);
+    }
+    CHECK(counter.sets == expected);
+
+    SetRangeCounter range_counter;
+    {
+        util::SimpleInputStream in({log.data(), log.size()});
+        _impl::TransactLogParser parser;
+        parser.parse(in, range_counter);
+    }
+    CHECK(range_counter.sets == expected);
+    CHECK_EQUAL(range_counter.num_ranges, 1);
+}
+
+TEST(Replication_SetCompressed)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBOptions options;
+    options.enable_value_compression = true;
+    DBRef db = DB::create(*hist, path, options);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        col = wt->add_table("table")->add_column(type_String, "str");
+        wt->commit();
+    }
+
+    struct : _impl::NullInstructionObserver {
+        std::vector<std::pair<ColKey, bool>> changes;
+        bool set_compressed(ColKey col_key, bool compressed)
+        {
+            changes.emplace_back(col_key, compressed);
+            return true;
+        }
+    } observer;
+    auto rt = db->start_read();
+    {
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->set_compressed(col, true);
+        table->set_compressed(col, true); // No change
+        wt->commit_and_continue_writing();
+        table->set_compressed(col, false);
+        wt->commit();
+    }
+    rt->advance_read(&observer);
+    std::vector<std::pair<ColKey, bool>> expected = {{col, true}, {col, false}};
+    CHECK(observer.changes == expected);
+}
+
 #endif // TEST_REPLICATION
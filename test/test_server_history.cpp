@@ -81,4 +81,74 @@ TEST(ServerHistory_Verify)
     }
 }
 
+
+TEST(ServerHistory_CompactHistory)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    HistoryContext context;
+    ServerHistory history{context};
+    DBRef sg = DB::create(history, path);
+    {
+        WriteTransaction wt{sg};
+        TableRef table = wt.get_group().add_table_with_primary_key("class_table", type_Int, "_id");
+        table->add_column(type_Int, "value");
+        table->create_object_with_primary_key(1);
+        wt.commit();
+    }
+    auto set_value = [&](int value) {
+        WriteTransaction wt{sg};
+        TableRef table = wt.get_table("class_table");
+        table->get_object_with_primary_key(1).set("value", value);
+        wt.commit();
+    };
+    for (int i = 0; i < 10; ++i)
+        set_value(i);
+
+    // A client registered now may be about to download from this point
+    sync::VersionInfo version_info;
+    ServerHistory::FileIdentAllocSlots slots = {{0, ServerHistory::ClientType::regular, {}}};
+    history.allocate_file_identifiers(slots, version_info);
+    for (int i = 10; i < 20; ++i)
+        set_value(i);
+    ServerHistory::HistoryContents contents = history.get_history_contents();
+    CHECK_EQUAL(contents.sync_history.size(), 21);
+
+    // The client holds the compaction back, until it lags too far behind
+    ServerHistory::CompactionConfig config;
+    config.tail_length = 2;
+    config.min_versions = 1;
+    auto result = history.compact_history(config, version_info, test_context.logger);
+    CHECK_EQUAL(result.num_compacted_versions, 0);
+    CHECK_EQUAL(result.num_expired_clients, 0);
+
+    config.max_client_lag = 10;
+    result = history.compact_history(config, version_info, test_context.logger);
+    CHECK_EQUAL(result.num_expired_clients, 1);
+    CHECK_EQUAL(result.num_compacted_versions, 19);
+    CHECK_EQUAL(result.compacted_until_version, 19);
+    CHECK_LESS(result.compacted_size, result.original_size);
+    CHECK_EQUAL(version_info.sync_version.version, 21);
+    {
+        ReadTransaction rt{sg};
+        rt.get_group().verify();
+        CHECK_EQUAL(rt.get_table("class_table")->get_object_with_primary_key(1).get<Int>("value"), 19);
+    }
+
+    // Only the last of the overwritten values is left, and the cumulative
+    // sizes are those of the original changesets
+    ServerHistory::HistoryContents compacted_contents = history.get_history_contents();
+    CHECK_EQUAL(compacted_contents.sync_history.size(), 21);
+    for (std::size_t i = 1; i < 18; ++i)
+        CHECK_LESS(compacted_contents.sync_history[i].changeset.size(), contents.sync_history[i].changeset.size());
+    for (std::size_t i = 18; i < 21; ++i)
+        CHECK_EQUAL(compacted_contents.sync_history[i].changeset, contents.sync_history[i].changeset);
+    for (std::size_t i = 0; i < 21; ++i)
+        CHECK_EQUAL(compacted_contents.sync_history[i].cumul_byte_size, contents.sync_history[i].cumul_byte_size);
+
+    // Nothing more to do until the history has grown
+    result = history.compact_history(config, version_info, test_context.logger);
+    CHECK_EQUAL(result.num_compacted_versions, 0);
+    CHECK_EQUAL(result.compacted_until_version, 19);
+}
+
 } // unnamed namespace
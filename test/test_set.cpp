@@ -21,6 +21,8 @@
 #include <realm.hpp>
 #include <realm/array_mixed.hpp>
 
+#include <set>
+
 #include "test.hpp"
 #include "test_types_helper.hpp"
 
@@ -789,3 +791,75 @@ TEST(Set_SymmetricDifferenceString)
     CHECK_EQUAL(set1.get(2), "The fox jumps over the lazy dog");
     CHECK_EQUAL(set1.get(3), "World");
 }
+
+TEST(Set_AlgebraLarge)
+{
+    Group g;
+    auto foos = g.add_table("class_Foo");
+    ColKey col_set = foos->add_column_set(type_Int, "int set");
+
+    auto obj1 = foos->create_object();
+    auto obj2 = foos->create_object();
+    auto set1 = obj1.get_set<int64_t>(col_set);
+    auto set2 = obj2.get_set<int64_t>(col_set);
+
+    // Large enough to span several leaves, and overlapping at both ends
+    std::set<int64_t> s1, s2;
+    auto reset = [&] {
+        set1.clear();
+        set2.clear();
+        for (int64_t i = 0; i < 3000; i += 2) {
+            set1.insert(i);
+            s1.insert(i);
+        }
+        for (int64_t i = 1500; i < 6000; i += 3) {
+            set2.insert(i);
+            s2.insert(i);
+        }
+    };
+    auto check = [&](std::vector<int64_t> expected) {
+        if (!CHECK_EQUAL(set1.size(), expected.size()))
+            return;
+        for (size_t i = 0; i < expected.size(); ++i)
+            CHECK_EQUAL(set1.get(i), expected[i]);
+    };
+
+    std::vector<int64_t> expected;
+    reset();
+    std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    set1.assign_union(set2);
+    check(expected);
+
+    expected.clear();
+    reset();
+    std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    set1.assign_intersection(set2);
+    check(expected);
+    CHECK(set1.intersects(set2));
+
+    expected.clear();
+    reset();
+    std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    set1.assign_difference(set2);
+    check(expected);
+    CHECK_NOT(set1.intersects(set2));
+
+    expected.clear();
+    reset();
+    std::set_symmetric_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    set1.assign_symmetric_difference(set2);
+    check(expected);
+
+    // Operations on the set itself
+    reset();
+    auto self = obj1.get_set<int64_t>(col_set);
+    set1.assign_union(self);
+    CHECK_EQUAL(set1.size(), s1.size());
+    set1.assign_intersection(self);
+    CHECK_EQUAL(set1.size(), s1.size());
+    set1.assign_symmetric_difference(self);
+    CHECK_EQUAL(set1.size(), 0);
+    reset();
+    set1.assign_difference(set1);
+    CHECK_EQUAL(set1.size(), 0);
+}
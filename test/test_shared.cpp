@@ -22,6 +22,7 @@
 #include <condition_variable>
 #include <streambuf>
 #include <fstream>
+#include <sstream>
 #include <tuple>
 #include <iostream>
 #include <fstream>
@@ -45,6 +46,7 @@
 #include <realm/util/safe_int_ops.hpp>
 #include <memory>
 #include <realm/util/terminate.hpp>
+#include <realm/util/crc32c.hpp>
 #include <realm/util/file.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/to_string.hpp>
@@ -1418,6 +1420,299 @@ TEST(Many_ConcurrentReaders)
 }
 
 
+TEST(Shared_ConcurrentReadLocks)
+{
+    // Many threads begin and end read transactions on the same DB while another
+    // thread commits, and keep enough versions pinned to make the ringbuffer grow.
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(path);
+    ColKey col;
+    {
+        WriteTransaction wt(db);
+        TableRef t = wt.add_table("table");
+        col = t->add_column(type_Int, "value");
+        t->create_object();
+        wt.commit();
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<int> num_errors(0);
+    auto reader = [&] {
+        std::vector<TransactionRef> pinned;
+        int64_t last_seen = 0;
+        for (size_t i = 0; !done || i < 100; ++i) {
+            auto rt = db->start_read();
+            int64_t value = rt->get_table("table")->begin()->get<Int>(col);
+            if (value < last_seen)
+                ++num_errors;
+            last_seen = value;
+            if (i % 8 == 0)
+                pinned.push_back(rt);
+            if (pinned.size() > 40)
+                pinned.clear();
+        }
+    };
+
+    constexpr int num_threads = 8;
+    Thread threads[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].start(reader);
+    }
+    for (int i = 1; i <= 200; ++i) {
+        WriteTransaction wt(db);
+        wt.get_table("table")->begin()->set(col, i);
+        wt.commit();
+    }
+    done = true;
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].join();
+    }
+    CHECK_EQUAL(num_errors.load(), 0);
+    CHECK_EQUAL(db->start_read()->get_table("table")->begin()->get<Int>(col), 200);
+
+    // Read locks released by close() must not be released again by the transactions
+    auto rt = db->start_read();
+    db->close(true);
+    CHECK_NOT(db->is_attached());
+    rt = nullptr;
+}
+
+
+TEST(Shared_CloseWhileTakingReadLocks)
+{
+    // close() must wait for read locks being taken by other threads, which do not
+    // hold the DB mutex, before unmapping the ringbuffer
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(path);
+    {
+        WriteTransaction wt(db);
+        wt.add_table("table");
+        wt.commit();
+    }
+
+    std::atomic<int> num_started(0);
+    auto reader = [&] {
+        std::vector<TransactionRef> pinned;
+        for (;;) {
+            try {
+                pinned.push_back(db->start_read());
+            }
+            catch (const LogicError&) {
+                break;
+            }
+            ++num_started;
+            if (pinned.size() > 40)
+                pinned.clear();
+        }
+    };
+
+    constexpr int num_threads = 8;
+    Thread threads[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].start(reader);
+    }
+    while (num_started < 1000)
+        std::this_thread::yield();
+    db->close(true);
+    CHECK_NOT(db->is_attached());
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].join();
+    }
+    CHECK_THROW(db->start_read(), LogicError);
+}
+
+
+TEST(Shared_FailedCloseWhileTakingReadLocks)
+{
+    // A close() which fails because a transaction is open must not make
+    // concurrent start_read() fail
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(path);
+    auto rt = db->start_read();
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> num_failed(0);
+    std::atomic<int> num_started(0);
+    auto reader = [&] {
+        while (!stop) {
+            try {
+                db->start_read();
+                ++num_started;
+            }
+            catch (const LogicError&) {
+                ++num_failed;
+            }
+        }
+    };
+
+    constexpr int num_threads = 4;
+    Thread threads[num_threads];
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].start(reader);
+    }
+    for (int i = 0; i < 1000 || num_started < 1000; ++i) {
+        CHECK_THROW(db->close(), LogicError);
+    }
+    stop = true;
+    for (int i = 0; i < num_threads; ++i) {
+        threads[i].join();
+    }
+    CHECK_EQUAL(num_failed, 0);
+    CHECK(db->is_attached());
+}
+
+
+TEST(Shared_GroupCommit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    constexpr int num_threads = 8;
+    constexpr int num_commits = 50;
+    {
+        DBOptions options;
+        options.group_commit_window = std::chrono::microseconds(500);
+        DBRef db = DB::create(path, false, options);
+        {
+            WriteTransaction wt(db);
+            TableRef t = wt.add_table("table");
+            auto col = t->add_column(type_Int, "count");
+            for (int i = 0; i < num_threads; ++i)
+                t->create_object(ObjKey(i)).set(col, 0);
+            wt.commit();
+        }
+
+        auto writer = [&](int i) {
+            for (int j = 0; j < num_commits; ++j) {
+                auto tr = db->start_write();
+                auto t = tr->get_table("table");
+                auto col = t->get_column_key("count");
+                auto obj = t->get_object(ObjKey(i));
+                obj.set(col, obj.get<Int>(col) + 1);
+                if (j % 2)
+                    tr->commit();
+                else
+                    tr->commit_and_continue_as_read();
+            }
+        };
+        Thread threads[num_threads];
+        for (int i = 0; i < num_threads; ++i)
+            threads[i].start([&writer, i] {
+                writer(i);
+            });
+        for (int i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+
+    // Reopening starts a new session from what was last made durable in the file
+    DBRef db = DB::create(path);
+    auto rt = db->start_read();
+    auto t = rt->get_table("table");
+    auto col = t->get_column_key("count");
+    for (int i = 0; i < num_threads; ++i)
+        CHECK_EQUAL(t->get_object(ObjKey(i)).get<Int>(col), num_commits);
+    rt->verify();
+}
+
+TEST(Shared_DeferredGroupCommitSync)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    constexpr int num_commits = 200;
+    std::atomic<int> num_errors{0};
+    {
+        DBOptions options;
+        options.group_commit_window = std::chrono::microseconds(1000);
+        options.defer_group_commit_sync = true;
+        options.on_deferred_sync_error = [&](std::exception_ptr) {
+            ++num_errors;
+        };
+        DBRef db = DB::create(path, false, options);
+        ColKey col;
+        {
+            WriteTransaction wt(db);
+            col = wt.add_table("table")->add_column(type_Int, "value");
+            wt.commit();
+        }
+        for (int i = 0; i < num_commits; ++i) {
+            auto tr = db->start_write();
+            tr->get_table("table")->create_object().set(col, i);
+            if (i % 2)
+                tr->commit();
+            else
+                tr->commit_and_continue_as_read();
+            // Visible before it is durable
+            CHECK_EQUAL(db->start_read()->get_table("table")->size(), i + 1);
+        }
+        // Syncs what is still pending
+        db->close();
+    }
+    CHECK_EQUAL(num_errors, 0);
+
+    DBRef db = DB::create(path);
+    auto rt = db->start_read();
+    auto t = rt->get_table("table");
+    CHECK_EQUAL(t->size(), num_commits);
+    CHECK_EQUAL(t->sum_int(t->get_column_key("value")), num_commits * (num_commits - 1) / 2);
+    rt->verify();
+}
+
+TEST(Shared_AsyncSyncCommitsWhileWriting)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    constexpr int num_batches = 5;
+    constexpr int commits_per_batch = 10;
+    {
+        DBOptions options;
+        options.enable_async_writes = true;
+        DBRef db = DB::create(make_in_realm_history(), path, options);
+        auto tr = db->start_read();
+        tr->promote_to_write();
+        auto col = tr->add_table("table")->add_column(type_Int, "value");
+        tr->promote_to_async();
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        int num_synced = 0;
+        for (int i = 0; i < num_batches; ++i) {
+            for (int j = 0; j < commits_per_batch; ++j) {
+                if (tr->get_transact_stage() != DB::transact_Writing)
+                    tr->promote_to_write();
+                tr->get_table("table")->create_object().set(col, i * commits_per_batch + j);
+                tr->commit_and_continue_as_read(false);
+            }
+            // The next batch is written while this one is synced
+            tr->async_sync_commits([&](std::exception_ptr error) {
+                std::lock_guard<std::mutex> lock(mutex);
+                CHECK_NOT(error);
+                ++num_synced;
+                cv.notify_one();
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] {
+                return num_synced == num_batches;
+            });
+        }
+        CHECK_NOT(tr->has_syncs_in_flight());
+        CHECK_NOT(tr->has_unsynced_commits());
+        CHECK_NOT(tr->get_commit_exception());
+        bool done = false;
+        tr->async_complete_writes([&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            cv.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] {
+            return done;
+        });
+    }
+
+    DBRef db = DB::create(make_in_realm_history(), path);
+    auto rt = db->start_read();
+    CHECK_EQUAL(rt->get_table("table")->size(), num_batches * commits_per_batch);
+    rt->verify();
+}
+
 TEST(Shared_WritesSpecialOrder)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -1685,6 +1980,592 @@ TEST(Shared_SpaceOveruse)
 }
 
 
+TEST(Shared_FragmentedFreeSpaceReuse)
+{
+    // Keep the amount of live data constant while freeing and allocating chunks
+    // of many different sizes, both below and above the sizes which are
+    // tracked exactly by the free space map. The file should stop growing once
+    // the freed space can be reused.
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const size_t num_objects = 200;
+    std::string blob(64 * 1024, 'x');
+    auto draw_size = [&] {
+        return random.draw_int_mod(8) == 0 ? size_t(random.draw_int_mod(64 * 1024))
+                                           : size_t(random.draw_int_mod(512));
+    };
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("blobs");
+        col = table->add_column(type_Binary, "data");
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object().set(col, BinaryData(blob.data(), draw_size()));
+        wt.commit();
+    }
+
+    size_t file_size_after_warmup = 0;
+    for (int round = 0; round < 100; ++round) {
+        WriteTransaction wt(sg);
+        auto table = wt.get_table("blobs");
+        for (size_t i = 0; i < 20; ++i) {
+            size_t ndx = size_t(random.draw_int_mod(int(table->size())));
+            table->get_object(ndx).set(col, BinaryData(blob.data(), draw_size()));
+        }
+        if (round % 10 == 0)
+            wt.get_group().verify();
+        wt.commit();
+        if (round == 20)
+            file_size_after_warmup = util::File::get_size_static(path);
+    }
+
+    size_t free_space, used_space;
+    sg->get_stats(free_space, used_space);
+    CHECK_LESS_EQUAL(util::File::get_size_static(path), 2 * file_size_after_warmup);
+    CHECK_GREATER(free_space, 0);
+
+    ReadTransaction rt(sg);
+    rt.get_group().verify();
+    CHECK_EQUAL(rt.get_table("blobs")->size(), num_objects);
+}
+
+
+TEST(Shared_IncrementalCompaction)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBOptions options(crypt_key());
+    options.enable_incremental_compaction = true;
+    DBRef sg = DB::create(*hist, path, options);
+    const size_t num_objects = 40000;
+    std::string text(80, 'x');
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_str = table->add_column(type_String, "str");
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object().set(col_int, int64_t(i)).set(col_str, text);
+        wt.commit();
+    }
+    // Remove most of the objects, leaving a little in each cluster, so that
+    // the remaining data is rewritten at the end of the file
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.get_table("table");
+        auto col_int = table->get_column_key("int");
+        std::vector<ObjKey> keys;
+        for (auto obj : *table) {
+            if (obj.get<int64_t>(col_int) % 20 != 0)
+                keys.push_back(obj.get_key());
+        }
+        for (auto key : keys)
+            table->remove_object(key);
+        wt.commit();
+    }
+    size_t file_size_before = size_t(util::File::get_size_static(path));
+
+    // A reader of an older version keeps running while the file is compacted
+    TransactionRef reader = sg->start_read();
+    auto check_content = [&](const Transaction& tr) {
+        auto table = tr.get_table("table");
+        CHECK_EQUAL(table->size(), num_objects / 20);
+        auto col_int = table->get_column_key("int");
+        auto col_str = table->get_column_key("str");
+        int64_t expected = 0;
+        for (auto obj : *table) {
+            CHECK_EQUAL(obj.get<int64_t>(col_int), expected);
+            CHECK_EQUAL(obj.get<String>(col_str), text);
+            expected += 20;
+        }
+    };
+
+    auto commit_some = [&](int num_commits) {
+        for (int i = 0; i < num_commits; ++i) {
+            WriteTransaction wt(sg);
+            auto table = wt.get_or_add_table("other");
+            table->create_object();
+            wt.commit();
+        }
+    };
+    commit_some(50);
+    check_content(*reader);
+    reader->verify();
+    reader.reset();
+
+    commit_some(50);
+    // Encrypted files are only shrunk logically
+    size_t free_space, used_space;
+    sg->get_stats(free_space, used_space);
+    CHECK_LESS(free_space + used_space, file_size_before / 2);
+    if (!crypt_key()) {
+        CHECK_LESS(size_t(util::File::get_size_static(path)), file_size_before / 2);
+    }
+
+    auto rt = sg->start_read();
+    rt->verify();
+    check_content(*rt);
+    CHECK_EQUAL(rt->get_table("other")->size(), 100);
+}
+
+
+TEST(Shared_MappingAdvice)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const size_t num_objects = 100000;
+    for (auto pattern : {DBOptions::AccessPattern::Random, DBOptions::AccessPattern::Sequential}) {
+        DBOptions options(crypt_key());
+        options.access_pattern = pattern;
+        options.use_huge_pages = true;
+        options.prefetch_on_open = true;
+        DBRef sg = DB::create(path, false, options);
+        {
+            WriteTransaction wt(sg);
+            auto table = wt.get_or_add_table("table");
+            auto col = table->get_column_key("int");
+            if (!col)
+                col = table->add_column(type_Int, "int");
+            for (size_t i = 0; i < num_objects; ++i)
+                table->create_object().set(col, int64_t(i));
+            wt.commit();
+        }
+        sg.reset();
+
+        // Reopen to have the top arrays prefetched
+        sg = DB::create(path, false, options);
+        ReadTransaction rt(sg);
+        rt.get_group().verify();
+        auto table = rt.get_table("table");
+        CHECK_EQUAL(table->size() % num_objects, 0);
+        CHECK_EQUAL(table->get_object(num_objects - 1).get<int64_t>("int"), int64_t(num_objects - 1));
+    }
+}
+
+
+TEST(Shared_AccessProfile)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::string profile_path = DB::get_core_file(path, DB::CoreFileType::Management) + "/access_profile";
+    const size_t num_objects = 100000;
+    DBOptions options(crypt_key());
+    options.enable_access_profile = true;
+    {
+        DBRef sg = DB::create(path, false, options);
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object().set(col, int64_t(i));
+        wt.commit();
+    }
+    // Only recorded for unencrypted files
+    CHECK_EQUAL(File::exists(profile_path), !crypt_key());
+
+    for (int i = 0; i < 2; ++i) {
+        // A second DB on the file replays the profile, but does not record it
+        DBRef sg = DB::create(path, false, options);
+        DBRef sg_2 = DB::create(path, false, options);
+        sg.reset();
+        ReadTransaction rt(sg_2);
+        rt.get_group().verify();
+        auto table = rt.get_table("table");
+        CHECK_EQUAL(table->size(), num_objects);
+        CHECK_EQUAL(table->get_object(num_objects - 1).get<int64_t>("int"), int64_t(num_objects - 1));
+    }
+    CHECK_EQUAL(File::exists(profile_path), !crypt_key());
+
+    // A malformed profile is ignored
+    if (!crypt_key()) {
+        {
+            File file(profile_path, File::mode_Write);
+            file.write("RAP1\xff\xff");
+        }
+        DBRef sg = DB::create(path, false, options);
+        ReadTransaction rt(sg);
+        CHECK_EQUAL(rt.get_table("table")->size(), num_objects);
+    }
+}
+
+
+TEST(Shared_IntegerLeafEncoding)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(path_plain);
+    const size_t num_objects = 5000;
+    const int64_t epoch = 1700000000000;
+    auto fill = [&](DBRef sg) {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col_time = table->add_column(type_Int, "time");
+        auto col_id = table->add_column(type_Int, "id");
+        auto col_neg = table->add_column(type_Int, "neg", true);
+        table->add_search_index(col_id);
+        for (size_t i = 0; i < num_objects; ++i) {
+            auto obj = table->create_object();
+            obj.set(col_time, epoch + int64_t(i) * 3);
+            obj.set(col_id, int64_t(i % 1000) + 100000);
+            if (i % 7)
+                obj.set(col_neg, -100000 - int64_t(i % 500));
+        }
+        wt.commit();
+    };
+    DBOptions options(crypt_key());
+    options.enable_integer_leaf_encoding = true;
+    fill(DB::create(path, false, options));
+    fill(DB::create(path_plain, false, DBOptions(crypt_key())));
+
+    auto check = [&](const Group& tr, int64_t shift) {
+        tr.verify();
+        auto table = tr.get_table("table");
+        auto col_time = table->get_column_key("time");
+        auto col_id = table->get_column_key("id");
+        auto col_neg = table->get_column_key("neg");
+        CHECK_EQUAL(table->size(), num_objects);
+        CHECK_EQUAL(table->get_object(10).get<int64_t>(col_time), epoch + 30 + shift);
+        CHECK_EQUAL(table->get_object(10).get<Int>(col_id), 100010);
+        CHECK_EQUAL(table->get_object(10).get<util::Optional<Int>>(col_neg), -100010);
+        CHECK_NOT(table->get_object(14).get<util::Optional<Int>>(col_neg));
+        CHECK_EQUAL(table->where().equal(col_time, epoch + 300 + shift).count(), 1);
+        CHECK_EQUAL(table->where().greater(col_time, epoch + 3 * 4000 + shift).count(), 999);
+        CHECK_EQUAL(table->where().less(col_time, epoch + shift).count(), 0);
+        CHECK_EQUAL(table->where().between(col_time, epoch + shift, epoch + 29 + shift).count(), 10);
+        CHECK_EQUAL(table->where().equal(col_id, 100999).count(), 5);
+        CHECK_EQUAL(table->where().equal(col_id, 99999).count(), 0);
+        CHECK_EQUAL(table->where().less(col_neg, -100498).count(), 9);
+        CHECK_EQUAL(table->where().equal(col_neg, null()).count(), 715);
+        CHECK_EQUAL(table->find_first_int(col_id, 100500), table->get_object(500).get_key());
+        CHECK_EQUAL(table->where().sum_int(col_time),
+                    (epoch + shift) * int64_t(num_objects) + 3 * int64_t(num_objects) * (num_objects - 1) / 2);
+        CHECK_EQUAL(table->where().maximum_int(col_time), epoch + 3 * int64_t(num_objects - 1) + shift);
+        CHECK_EQUAL(table->where().minimum_int(col_neg), -100499);
+    };
+
+    size_t plain_size;
+    {
+        DBRef sg = DB::create(path, false, options);
+        DBRef sg_plain = DB::create(path_plain, false, DBOptions(crypt_key()));
+        auto rt = sg->start_read();
+        auto rt_plain = sg_plain->start_read();
+        check(*rt, 0);
+        check(*rt_plain, 0);
+        // Versions which cannot read the encoded leaves refuse the file
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt), 23);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt_plain), 22);
+        plain_size = rt_plain->get_used_space();
+        CHECK_LESS(rt->get_used_space(), plain_size);
+    }
+
+    // Modifying decodes the leaves touched, and the next commit encodes them again
+    {
+        DBRef sg = DB::create(path, false, options);
+        {
+            WriteTransaction wt(sg);
+            auto table = wt.get_table("table");
+            auto col_time = table->get_column_key("time");
+            for (auto& obj : *table)
+                obj.add_int(col_time, 1);
+            check(wt.get_group(), 1);
+            wt.commit();
+        }
+        auto rt = sg->start_read();
+        check(*rt, 1);
+        CHECK_LESS(rt->get_used_space(), plain_size);
+    }
+
+    // Opening without the option reads the encoded leaves and writes plain ones
+    {
+        DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+        {
+            WriteTransaction wt(sg);
+            auto table = wt.get_table("table");
+            auto col_time = table->get_column_key("time");
+            for (auto& obj : *table)
+                obj.add_int(col_time, -1);
+            wt.commit();
+        }
+        auto rt = sg->start_read();
+        check(*rt, 0);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt), 23);
+    }
+}
+
+
+TEST(Shared_EncodedClusterKeys)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    // Keys far from zero, but close to each other, give a 64 bit wide key
+    // array which is encoded with a base when written
+    const int64_t first_key = int64_t(1) << 40;
+    const size_t num_objects = 200;
+    DBOptions options(crypt_key());
+    options.enable_integer_leaf_encoding = true;
+    DBRef sg = DB::create(path, false, options);
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col = table->add_column(type_Int, "value");
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object(ObjKey(first_key + 3 * int64_t(i))).set(col, int64_t(i));
+        wt.commit();
+    }
+
+    auto rt = sg->start_read();
+    auto table = rt->get_table("table");
+    auto col = table->get_column_key("value");
+    for (size_t i = 0; i < num_objects; ++i) {
+        int64_t key = first_key + 3 * int64_t(i);
+        CHECK_EQUAL(table->get_object(ObjKey(key)).get<Int>(col), int64_t(i));
+        CHECK_NOT(table->is_valid(ObjKey(key + 1)));
+    }
+    CHECK_NOT(table->is_valid(ObjKey(first_key - 1)));
+    CHECK_NOT(table->is_valid(ObjKey(0)));
+    CHECK_NOT(table->is_valid(ObjKey(first_key + 3 * int64_t(num_objects))));
+    CHECK_EQUAL(table->begin()->get_key(), ObjKey(first_key));
+}
+
+TEST(Shared_ArrayChecksums)
+{
+    // The check value of CRC-32C
+    CHECK_EQUAL(util::crc32c("123456789", 9), 0xe3069283);
+    CHECK_EQUAL(util::crc32c("6789", 4, util::crc32c("12345", 5)), 0xe3069283);
+
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(path_plain);
+    const std::string payload = "A string to be damaged on disk";
+    auto fill = [&](DBRef sg) {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_str = table->add_column(type_String, "str");
+        for (int64_t i = 0; i < 1000; ++i)
+            table->create_object().set(col_int, i * 1000).set(col_str, i == 500 ? payload : "x");
+        wt.add_table("other")->add_column(type_Double, "double");
+        wt.commit();
+    };
+    DBOptions options;
+    options.enable_array_checksums = true;
+    fill(DB::create(path, false, options));
+    fill(DB::create(path_plain, false, DBOptions()));
+
+    {
+        DBRef sg = DB::create(path, false, options);
+        auto rt = sg->start_read();
+        CHECK_GREATER(rt->check_integrity(), 10);
+        CHECK_EQUAL(rt->check_integrity(0), 0);
+        auto wt = sg->start_write();
+        wt->get_table("table")->create_object().set("int", 7);
+        // Arrays in the slab are not checked
+        CHECK_GREATER(wt->check_integrity(), 0);
+        wt->commit();
+    }
+    {
+        DBRef sg = DB::create(path_plain, false, DBOptions());
+        CHECK_EQUAL(sg->start_read()->check_integrity(), 0);
+    }
+
+    // Damage the file, where the payload is stored
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size_t pos = contents.find(payload);
+        CHECK_NOT_EQUAL(pos, std::string::npos);
+        CHECK_EQUAL(contents.find(payload, pos + 1), std::string::npos);
+        file.seekp(std::streamoff(pos));
+        file.put('a');
+    }
+    DBRef sg = DB::create(path, false, options);
+    auto rt = sg->start_read();
+    CHECK_THROW(rt->check_integrity(), InvalidDatabase);
+    // The contents of the arrays which are not sampled are not read
+    CHECK_EQUAL(rt->check_integrity(0), 0);
+}
+
+TEST(Shared_CompressedColumns)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(path_plain);
+    const size_t num_objects = 3000;
+    auto make_string = [](size_t i) {
+        std::string str = "{\"id\": " + util::to_string(i) + ", \"tags\": [";
+        for (size_t j = 0; j < 20; ++j)
+            str += "\"tag_" + util::to_string(j % 7) + "\", ";
+        return str + "\"last\"], \"group\": " + util::to_string(i % 10) + "}";
+    };
+    auto make_binary = [](size_t i) {
+        std::string str(1000, char('a' + i % 26));
+        str[0] = char(i % 256);
+        return str;
+    };
+    auto fill = [&](DBRef sg, bool compressed) {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col_str = table->add_column(type_String, "str", true);
+        auto col_bin = table->add_column(type_Binary, "bin", true);
+        if (compressed) {
+            table->set_compressed(col_str, true);
+            table->set_compressed(col_bin, true);
+        }
+        for (size_t i = 0; i < num_objects; ++i) {
+            auto obj = table->create_object();
+            if (i % 100 == 1)
+                continue;
+            std::string bin = make_binary(i);
+            obj.set(col_str, i % 100 == 2 ? StringData("short") : StringData(make_string(i)));
+            obj.set(col_bin, BinaryData(bin.data(), bin.size()));
+        }
+        wt.commit();
+    };
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBOptions options(crypt_key());
+    options.enable_value_compression = true;
+    DBRef sg = DB::create(*hist, path, options);
+    DBRef sg_plain = DB::create(path_plain, false, DBOptions(crypt_key()));
+    fill(sg, true);
+    fill(sg_plain, false);
+
+    // Compression is only available in files which older versions refuse
+    {
+        WriteTransaction wt(sg_plain);
+        auto table = wt.get_table("table");
+        CHECK_THROW(table->set_compressed(table->get_column_key("str"), true), LogicError);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(wt.get_group()), 22);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*sg->start_read()), 23);
+    }
+
+    auto check = [&](const Group& tr, const std::string& suffix) {
+        tr.verify();
+        auto table = tr.get_table("table");
+        auto col_str = table->get_column_key("str");
+        auto col_bin = table->get_column_key("bin");
+        CHECK_EQUAL(table->size(), num_objects);
+        for (size_t i = 0; i < num_objects; ++i) {
+            auto obj = table->get_object(i);
+            if (i % 100 == 1) {
+                CHECK(obj.is_null(col_str));
+                CHECK(obj.is_null(col_bin));
+                continue;
+            }
+            std::string expected = i % 100 == 2 ? std::string("short") : make_string(i) + suffix;
+            std::string bin = make_binary(i);
+            CHECK_EQUAL(obj.get<String>(col_str), expected);
+            CHECK_EQUAL(obj.get<Binary>(col_bin), BinaryData(bin.data(), bin.size()));
+            // Zero terminated like any other stored string
+            CHECK_EQUAL(obj.get<String>(col_str).data()[expected.size()], 0);
+        }
+        std::string str = make_string(123) + suffix;
+        CHECK_EQUAL(table->where().equal(col_str, StringData(str)).count(), 1);
+        CHECK_EQUAL(table->find_first(col_str, StringData(str)), table->get_object(123).get_key());
+        CHECK_EQUAL(table->where().contains(col_str, StringData("\"group\": 3}")).count(), 300);
+        CHECK_EQUAL(table->where().equal(col_str, StringData("short")).count(), 30);
+        std::string bin = make_binary(321);
+        CHECK_EQUAL(table->where().equal(col_bin, BinaryData(bin.data(), bin.size())).count(), 1);
+        CHECK_EQUAL(table->where().size_equal(col_bin, 1000).count(), num_objects - 30);
+    };
+    // Sorting holds on to all the values at once
+    auto sorted_keys = [&](const Group& tr) {
+        auto table = tr.get_table("table");
+        auto view = table->get_sorted_view(table->get_column_key("str"));
+        std::vector<ObjKey> keys;
+        for (size_t i = 0; i < view.size(); ++i)
+            keys.push_back(view.get_key(i));
+        return keys;
+    };
+
+    {
+        auto rt = sg->start_read();
+        auto rt_plain = sg_plain->start_read();
+        check(*rt, "");
+        check(*rt_plain, "");
+        CHECK(sorted_keys(*rt) == sorted_keys(*rt_plain));
+        auto table = rt->get_table("table");
+        CHECK(table->is_compressed(table->get_column_key("str")));
+        CHECK_NOT(rt_plain->get_table("table")->is_compressed(table->get_column_key("str")));
+        CHECK_LESS(rt->get_used_space() * 2, rt_plain->get_used_space());
+    }
+
+    // Values are decompressed transparently when modified, and a reader sees
+    // the new values after advancing
+    {
+        auto rt = sg->start_read();
+        check(*rt, "");
+        {
+            WriteTransaction wt(sg);
+            auto table = wt.get_table("table");
+            auto col_str = table->get_column_key("str");
+            for (auto& obj : *table) {
+                if (!obj.is_null(col_str) && obj.get<String>(col_str) != "short")
+                    obj.set(col_str, std::string(obj.get<String>(col_str)) + " ");
+            }
+            check(wt.get_group(), " ");
+            wt.commit();
+        }
+        rt->advance_read();
+        check(*rt, " ");
+    }
+
+    // Turning compression off only affects values written afterwards
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.get_table("table");
+        auto col_str = table->get_column_key("str");
+        table->set_compressed(col_str, false);
+        CHECK_NOT(table->is_compressed(col_str));
+        table->get_object(5).set(col_str, make_string(5) + " ");
+        check(wt.get_group(), " ");
+        CHECK_THROW(table->set_compressed(table->add_column(type_Int, "int"), true), LogicError);
+    }
+}
+
+
+TEST(Shared_CompressedColumnsCacheLimit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.enable_value_compression = true;
+    DBRef sg = DB::create(path, false, options);
+    // Together more than fits in the cache of decompressed values
+    const size_t num_objects = 6;
+    const size_t value_size = 16 * 1024 * 1024 - 1024;
+    CHECK_GREATER(num_objects * value_size, ArrayBigBlobs::decompressed_cache_size);
+    auto make_string = [&](size_t i) {
+        return std::string(value_size, char('a' + i));
+    };
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        auto col = table->add_column(type_String, "str");
+        table->set_compressed(col, true);
+        for (size_t i = 0; i < num_objects; ++i)
+            table->create_object().set(col, make_string(i));
+        wt.commit();
+    }
+
+    auto rt = sg->start_read();
+    auto table = rt->get_table("table");
+    auto col = table->get_column_key("str");
+    CHECK_LESS(rt->get_used_space(), value_size);
+    // Values dropped from the cache are decompressed again
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < num_objects; ++i)
+            CHECK(table->get_object(i).get<String>(col) == make_string(i));
+    }
+    // All values stay valid while pinned
+    {
+        ArrayBigBlobs::DecompressedPin pin(table->get_alloc());
+        std::vector<StringData> values;
+        for (size_t i = 0; i < num_objects; ++i)
+            values.push_back(table->get_object(i).get<String>(col));
+        for (size_t i = 0; i < num_objects; ++i)
+            CHECK(values[i] == make_string(i));
+    }
+    auto view = table->get_sorted_view(col, false);
+    CHECK_EQUAL(view.size(), num_objects);
+    for (size_t i = 0; i < num_objects; ++i)
+        CHECK_EQUAL(view.get_object(i).get_key(), table->get_object(num_objects - 1 - i).get_key());
+}
+
+
 TEST(Shared_Notifications)
 {
     // Create a new shared db
@@ -2841,6 +3722,95 @@ TEST_IF(Shared_CompactEncrypt, REALM_ENABLE_ENCRYPTION)
 }
 #endif
 
+TEST_IF(Shared_DecryptedPageBudget, REALM_ENABLE_ENCRYPTION)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const size_t num_objects = 20000;
+    ColKey col;
+    {
+        auto db = DB::create(path, false, DBOptions(crypt_key(true)));
+        auto wt = db->start_write();
+        TableRef t = wt->add_table("table");
+        col = t->add_column(type_String, "strings");
+        for (size_t i = 0; i < num_objects; ++i) {
+            std::string str = "Shared_DecryptedPageBudget " + util::to_string(i);
+            t->create_object().set(col, StringData(str));
+        }
+        wt->commit();
+    }
+
+    DBOptions options(crypt_key(true));
+    options.decrypted_page_budget = 64 * 1024;
+    auto db = DB::create(path, false, options);
+    auto before = util::get_decrypted_page_stats();
+    for (int i = 0; i < 3; ++i) {
+        auto rt = db->start_read();
+        ConstTableRef t = rt->get_table("table");
+        CHECK_EQUAL(t->where().ends_with(col, StringData("7")).count(), num_objects / 10);
+    }
+    auto after = util::get_decrypted_page_stats();
+    CHECK_GREATER(after.misses, before.misses);
+    CHECK_GREATER(after.hits, before.hits);
+
+    // The file now holds far more decrypted pages than its budget allows, so
+    // the reclaimer must release some of them as new versions are read
+    for (int i = 0; i < 300 && util::get_decrypted_page_stats().reclaimed == before.reclaimed; ++i) {
+        db->start_read();
+        millisleep(100);
+    }
+    CHECK_GREATER(util::get_decrypted_page_stats().reclaimed, before.reclaimed);
+
+    auto rt = db->start_read();
+    ConstTableRef t = rt->get_table("table");
+    CHECK_EQUAL(t->where().ends_with(col, StringData("7")).count(), num_objects / 10);
+}
+
+TEST(Shared_ReleaseMemory)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    const size_t num_objects = 20000;
+    auto db = DB::create(path, false, DBOptions(crypt_key(true)));
+    ColKey col_id, col_text;
+    {
+        auto wt = db->start_write();
+        TableRef t = wt->add_table_with_primary_key("table", type_Int, "id");
+        col_id = t->get_primary_key_column();
+        col_text = t->add_column(type_String, "text");
+        for (size_t i = 0; i < num_objects; ++i)
+            t->create_object_with_primary_key(int64_t(i)).set(col_text, "word" + util::to_string(i % 100));
+        wt->commit();
+    }
+
+    {
+        auto rt = db->start_read();
+        ConstTableRef t = rt->get_table("table");
+        CHECK_EQUAL(t->get_fulltext_index(col_text)->find_all("word7").size(), num_objects / 100);
+        CHECK(t->find_primary_key(int64_t(7)));
+        CHECK_GREATER(rt->release_memory(), 0);
+        CHECK_EQUAL(rt->release_memory(), 0);
+
+        // The caches are rebuilt when needed
+        CHECK_EQUAL(t->get_fulltext_index(col_text)->find_all("word7").size(), num_objects / 100);
+        CHECK_EQUAL(t->find_primary_key(int64_t(7)), t->find_first_int(col_id, 7));
+
+        // An index still in use is kept by its user
+        auto index = t->get_fulltext_index(col_text);
+        t->release_caches();
+        CHECK_EQUAL(index->find_all("word8").size(), num_objects / 100);
+    }
+
+    // With no reader left, every decrypted page of an encrypted file can go
+    size_t released = db->release_memory(DB::MemoryPressure::critical);
+    if (crypt_key(true))
+        CHECK_GREATER(released, 0);
+    else
+        CHECK_EQUAL(released, 0);
+    CHECK_EQUAL(db->release_memory(DB::MemoryPressure::critical), 0);
+
+    auto rt = db->start_read();
+    CHECK_EQUAL(rt->get_table("table")->size(), num_objects);
+}
+
 // Repro case for: Assertion failed: top_size == 3 || top_size == 5 || top_size == 7 [0, 3, 0, 5, 0, 7]
 NONCONCURRENT_TEST(Shared_BigAllocationsMinimized)
 {
@@ -3932,6 +4902,150 @@ TEST(Shared_WriteCopy)
     CHECK_EQUAL(db->start_read()->get_table("foo")->size(), 1);
 }
 
+TEST(Shared_WriteCopyWhileWriting)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(copy_path);
+
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("table");
+        col = t->add_column(type_Int, "value");
+        wt->commit();
+    }
+
+    // Every commit adds an object holding the number of objects before it,
+    // so any consistent version holds the values 0, 1, 2, ...
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        while (!done) {
+            auto wt = db->start_write();
+            auto t = wt->get_table("table");
+            t->create_object().set(col, int64_t(t->size() - 1));
+            wt->commit();
+        }
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        File::try_remove(copy_path);
+        db->write_copy(copy_path.c_str(), nullptr);
+
+        DBRef copy = DB::create(make_in_realm_history(), copy_path);
+        auto rt = copy->start_read();
+        rt->verify();
+        auto t = rt->get_table("table");
+        int64_t sum = 0;
+        for (auto obj : *t)
+            sum += obj.get<int64_t>(col);
+        int64_t n = int64_t(t->size());
+        CHECK_EQUAL(sum, n * (n - 1) / 2);
+    }
+    done = true;
+    writer.join();
+}
+
+TEST(Shared_IncrementalBackup)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SHARED_GROUP_TEST_PATH(backup_path);
+
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto t = wt->add_table("table");
+        col = t->add_column(type_Int, "value");
+        for (int i = 0; i < 10000; ++i)
+            t->create_object().set(col, i);
+        wt->commit();
+    }
+
+    TransactionRef base;
+    std::stringstream full;
+    db->write_backup(full, base);
+    DB::apply_backup(backup_path, full);
+
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("table");
+        t->get_object(0).set(col, 100000);
+        t->create_object().set(col, 10000);
+        wt->commit();
+    }
+    std::stringstream incremental;
+    db->write_backup(incremental, base);
+    CHECK_LESS(incremental.str().size(), full.str().size() / 4);
+
+    // The incremental backup cannot be applied to a file at another version
+    SHARED_GROUP_TEST_PATH(other_path);
+    std::stringstream other_full(full.str());
+    DB::apply_backup(other_path, other_full);
+    std::stringstream second_incremental;
+    db->write_backup(second_incremental, base);
+    CHECK_THROW(DB::apply_backup(other_path, second_incremental), std::runtime_error);
+
+    DB::apply_backup(backup_path, incremental);
+    second_incremental.clear();
+    second_incremental.seekg(0);
+    DB::apply_backup(backup_path, second_incremental);
+
+    DBRef copy = DB::create(make_in_realm_history(), backup_path);
+    auto rt = copy->start_read();
+    rt->verify();
+    auto t = rt->get_table("table");
+    CHECK_EQUAL(t->size(), 10001);
+    CHECK_EQUAL(t->get_object(0).get<Int>(col), 100000);
+    CHECK_EQUAL(t->get_object(10000).get<Int>(col), 10000);
+    CHECK(*rt == *db->start_read());
+}
+
+TEST(Shared_AttachMemoryRegions)
+{
+    // Values large enough that the file spans two regions, with one of the
+    // values lying across the boundary between them
+    const size_t num_values = 40;
+    const size_t value_size = 2 * 1024 * 1024;
+    std::unique_ptr<char[]> data;
+    size_t size;
+    {
+        Group g;
+        auto t = g.add_table("table");
+        auto col = t->add_column(type_Binary, "value");
+        std::string value(value_size, 0);
+        for (size_t i = 0; i < num_values; ++i) {
+            std::fill(value.begin(), value.end(), char('a' + i));
+            t->create_object().set(col, BinaryData(value));
+        }
+        BinaryData buffer = g.write_to_mem();
+        data.reset(const_cast<char*>(buffer.data()));
+        size = buffer.size();
+    }
+    CHECK_GREATER(size, Allocator::section_size());
+
+    std::vector<BinaryData> regions;
+    for (size_t offset = 0; offset < size; offset += Allocator::section_size())
+        regions.emplace_back(data.get() + offset, std::min(Allocator::section_size(), size - offset));
+    auto db = DB::create(regions);
+    auto rt = db->start_read();
+    rt->verify();
+    auto t = rt->get_table("table");
+    auto col = t->get_column_key("value");
+    CHECK_EQUAL(t->size(), num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+        BinaryData value = t->get_object(i).get<BinaryData>(col);
+        CHECK_EQUAL(value.size(), value_size);
+        CHECK(std::all_of(value.data(), value.data() + value.size(), [&](char c) {
+            return c == char('a' + i);
+        }));
+    }
+
+    // Every region but the last must be exactly one section long
+    regions.insert(regions.begin(), BinaryData(data.get(), 4096));
+    CHECK_THROW(DB::create(regions), InvalidDatabase);
+}
+
 TEST(Shared_CompareGroups)
 {
     SHARED_GROUP_TEST_PATH(path1);
@@ -4325,4 +5439,328 @@ TEST(Shared_WriteToFail)
     CHECK(*tr == *dest);
 }
 
+TEST(Shared_WriteToManyObjects)
+{
+    SHARED_GROUP_TEST_PATH(path1);
+    SHARED_GROUP_TEST_PATH(path2);
+    SHARED_GROUP_TEST_PATH(path3);
+
+    DBRef db1 = DB::create(make_in_realm_history(), path1);
+    auto tr = db1->start_write();
+    {
+        // Persons link to dogs, whose table comes later
+        auto persons = tr->add_table_with_primary_key("class_Person", type_Int, "_id");
+        auto dogs = tr->add_table_with_primary_key("class_Dog", type_String, "_id");
+        auto col_name = persons->add_column(type_String, "name", true);
+        auto col_age = persons->add_column(type_Int, "age");
+        auto col_weight = persons->add_column(type_Double, "weight", true);
+        auto col_dog = persons->add_column(*dogs, "dog");
+        auto col_any = persons->add_column(type_Mixed, "any", true);
+        persons->add_search_index(col_name);
+        auto col_owner = dogs->add_column(*persons, "owner");
+
+        for (int i = 0; i < 2500; ++i) {
+            auto dog = dogs->create_object_with_primary_key(util::format("dog %1", i));
+            auto person = persons->create_object_with_primary_key(i);
+            if (i % 3)
+                person.set(col_name, util::format("person %1", i));
+            person.set(col_age, i % 100);
+            if (i % 7)
+                person.set(col_weight, i * 0.5);
+            person.set(col_dog, dog.get_key());
+            if (i % 2)
+                person.set(col_any, Mixed(dog.get_link()));
+            else
+                person.set(col_any, Mixed(i));
+            dog.set(col_owner, person.get_key());
+        }
+        persons->remove_object(persons->get_object_with_primary_key(1000).get_key());
+    }
+
+    // Copy uncommitted changes from the write transaction
+    DBRef db2 = DB::create(make_in_realm_history(), path2);
+    auto dest = db2->start_write();
+    tr->copy_to(dest);
+    dest->commit_and_continue_as_read();
+    CHECK(*tr == *dest);
+
+    // Copy from a read transaction, in parallel
+    tr->commit_and_continue_as_read();
+    DBRef db3 = DB::create(make_in_realm_history(), path3);
+    dest = db3->start_write();
+    tr->copy_to(dest);
+    dest->commit_and_continue_as_read();
+    CHECK(*tr == *dest);
+    auto persons = dest->get_table("class_Person");
+    CHECK_EQUAL(persons->size(), 2499);
+    auto person = persons->get_object_with_primary_key(2003);
+    CHECK_EQUAL(person.get<String>("name"), "person 2003");
+    CHECK_EQUAL(person.get_linked_object(persons->get_column_key("dog")).get_primary_key(), Mixed("dog 2003"));
+    CHECK_EQUAL(person.get_any("any").get_link().get_table_key(), dest->get_table("class_Dog")->get_key());
+}
+
+TEST(Shared_ReclaimSpaceBetweenReaders)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    // No history, as that would keep all changes since the oldest reader
+    DBOptions options;
+    options.reclaim_space_between_readers = true;
+    DBRef db = DB::create(path, false, options);
+    ColKey col;
+    auto write = [&](char c) {
+        auto wt = db->start_write();
+        auto table = wt->get_or_add_table("table");
+        if (table->is_empty()) {
+            col = table->add_column(type_String, "str");
+            for (int i = 0; i < 1000; ++i)
+                table->create_object();
+        }
+        for (auto obj : *table)
+            obj.set(col, std::string(100, c));
+        wt->commit();
+    };
+    write('a');
+
+    // A long lived reader, and one which moves forward now and then
+    auto frozen = db->start_frozen();
+    auto reader = db->start_read();
+    DB::VersionID unread;
+    for (int i = 0; i < 100; ++i) {
+        write('b' + i % 20);
+        if (i % 10 == 0)
+            reader = db->start_read();
+        if (i == 50)
+            unread = db->start_read()->get_version_of_current_transaction();
+    }
+
+    // Without reuse of the space freed between the readers, every commit
+    // would have grown the file by the size of the strings, which takes it to
+    // 12MB. With reuse it stays at 4MB, as the file grows in steps, so the
+    // bound leaves room for one more step.
+    CHECK_LESS(util::File::get_size_static(path), 6 * 1024 * 1024);
+    auto table = frozen->get_table("table");
+    for (auto obj : *table)
+        CHECK_EQUAL(obj.get<String>(col), std::string(100, 'a'));
+    frozen->verify();
+    reader->verify();
+    auto latest = db->start_read();
+    latest->verify();
+
+    // The versions which were not read are gone
+    CHECK_THROW(db->start_read(unread), DB::BadVersion);
+}
+
+TEST(Shared_PinnedReaders)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col = table->add_column(type_String, "str");
+        for (int i = 0; i < 1000; ++i)
+            table->create_object().set(col, std::to_string(i) + std::string(100, 'a'));
+        wt->commit();
+    }
+    CHECK(db->get_pinned_readers().empty());
+
+    auto frozen = db->start_frozen();
+    auto reader = db->start_read();
+    auto pinned = db->get_pinned_readers();
+    CHECK_EQUAL(pinned.size(), 2);
+    for (auto& p : pinned) {
+        CHECK_EQUAL(p.version, frozen->get_version());
+        CHECK_EQUAL(p.thread, std::this_thread::get_id());
+        CHECK(p.is_latest);
+        CHECK_NOT(p.is_invalidated);
+    }
+    CHECK_NOT_EQUAL(pinned[0].reader_id, pinned[1].reader_id);
+    CHECK(pinned[0].is_frozen != pinned[1].is_frozen);
+
+    // Overwrite everything, so that the space used by the frozen version is freed
+    for (int i = 0; i < 2; ++i) {
+        auto wt = db->start_write();
+        int j = 0;
+        for (auto obj : *wt->get_table("table"))
+            obj.set(col, std::to_string(j++) + std::string(100, 'b' + i));
+        wt->commit();
+    }
+    reader->advance_read();
+    pinned = db->get_pinned_readers();
+    if (CHECK_EQUAL(pinned.size(), 2)) {
+        // Oldest first
+        CHECK(pinned[0].is_frozen);
+        CHECK_NOT(pinned[0].is_latest);
+        CHECK_EQUAL(pinned[0].version, frozen->get_version());
+        CHECK_EQUAL(pinned[1].version, reader->get_version());
+        CHECK(pinned[1].is_latest);
+        CHECK_GREATER(pinned[0].pinned_bytes, 100 * 1000);
+        CHECK_GREATER(pinned[0].pinned_bytes, pinned[1].pinned_bytes);
+    }
+
+    frozen.reset();
+    reader->end_read();
+    CHECK(db->get_pinned_readers().empty());
+}
+
+TEST(Shared_StaleReaderPolicy)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBOptions options;
+    options.stale_reader_policy.max_pinned_bytes = 1;
+    options.stale_reader_policy.action = DBOptions::StaleReaderPolicy::Action::Invalidate;
+    std::vector<DBOptions::PinnedReader> reported;
+    options.stale_reader_policy.on_stale_reader = [&](const DBOptions::PinnedReader& reader) {
+        reported.push_back(reader);
+    };
+    DBRef db = DB::create(*hist, path, options);
+    auto write = [&] {
+        auto wt = db->start_write();
+        auto table = wt->get_or_add_table("table");
+        table->clear();
+        for (int i = 0; i < 100; ++i)
+            table->create_object();
+        wt->commit();
+    };
+    write();
+
+    auto frozen = db->start_frozen();
+    auto reader = db->start_read();
+    write();
+    write();
+    auto current = db->start_read();
+
+    // Reported once, even though the second commit exceeded the limit too
+    CHECK_EQUAL(reported.size(), 2);
+    CHECK(frozen->is_invalidated());
+    CHECK(reader->is_invalidated());
+    CHECK_NOT(current->is_invalidated());
+    for (auto& r : reported) {
+        CHECK(r.is_invalidated);
+        CHECK_GREATER(r.pinned_bytes, 1);
+    }
+
+    // Invalidated transactions are ended when used
+    CHECK_LOGIC_ERROR(frozen->duplicate(), LogicError::wrong_transact_state);
+    CHECK_LOGIC_ERROR(reader->advance_read(), LogicError::wrong_transact_state);
+    CHECK_NOT(frozen->is_attached());
+    CHECK_NOT(reader->is_attached());
+    CHECK_EQUAL(db->get_pinned_readers().size(), 1);
+    write();
+    CHECK_EQUAL(reported.size(), 3);
+    CHECK_EQUAL(reported.back().reader_id, db->get_pinned_readers()[0].reader_id);
+    CHECK_LOGIC_ERROR(current->promote_to_write(), LogicError::wrong_transact_state);
+    CHECK(db->get_pinned_readers().empty());
+}
+
+TEST(Shared_StaleReaderPolicyCallbackThrows)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBOptions options;
+    options.stale_reader_policy.max_pinned_bytes = 1;
+    int num_reported = 0;
+    options.stale_reader_policy.on_stale_reader = [&](const DBOptions::PinnedReader&) {
+        ++num_reported;
+        throw std::runtime_error("stale reader");
+    };
+    DBRef db = DB::create(*hist, path, options);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        col = wt->add_table("table")->add_column(type_Int, "int");
+        for (int i = 0; i < 100; ++i)
+            wt->get_table("table")->create_object();
+        wt->commit();
+    }
+    auto reader = db->start_read();
+
+    // The commit is durable by the time the readers are reported, so the
+    // exception must not make it look like it failed
+    auto wt = db->start_write();
+    wt->get_table("table")->clear();
+    DB::version_type version = 0;
+    CHECK_NOTHROW(version = wt->commit());
+    CHECK_EQUAL(num_reported, 1);
+    CHECK_EQUAL(db->start_read()->get_version(), version);
+    CHECK(db->start_read()->get_table("table")->is_empty());
+}
+
+TEST(Shared_Replica)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    {
+        // Nothing has been published yet
+        DBOptions options;
+        options.is_replica = true;
+        auto hist = make_in_realm_history();
+        CHECK_THROW_ANY(DB::create(*hist, path, options));
+    }
+
+    auto hist = make_in_realm_history();
+    DBOptions options;
+    options.publish_to_replicas = true;
+    DBRef db = DB::create(*hist, path, options);
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        col = wt->add_table("table")->add_column(type_Int, "int");
+        wt->commit();
+    }
+
+    auto replica_hist = make_in_realm_history();
+    DBOptions replica_options;
+    replica_options.is_replica = true;
+    DBRef replica = DB::create(*replica_hist, path, replica_options);
+    CHECK_EQUAL(replica->get_version_of_latest_snapshot(), db->get_version_of_latest_snapshot());
+    auto rt = replica->start_read();
+    CHECK_EQUAL(rt->get_table("table")->size(), 0);
+    auto frozen = rt->freeze();
+    CHECK_THROW(replica->start_read(VersionID(rt->get_version() - 1, 0)), DB::BadVersion);
+    CHECK_LOGIC_ERROR(replica->wait_for_change(rt), LogicError::wrong_transact_state);
+
+    for (int i = 0; i < 10; ++i) {
+        auto wt = db->start_write();
+        wt->get_table("table")->create_object().set(col, i);
+        wt->commit();
+        CHECK(replica->has_changed(rt));
+        rt->advance_read();
+        CHECK_NOT(replica->has_changed(rt));
+        CHECK_EQUAL(rt->get_version(), db->get_version_of_latest_snapshot());
+        CHECK_EQUAL(rt->get_table("table")->size(), i + 1);
+        CHECK_EQUAL(rt->get_table("table")->get_object(i).get<Int>(col), i);
+    }
+    // The version read by a transaction of the replica can still be read by
+    // it, even though it is no longer the latest
+    CHECK_EQUAL(replica->start_frozen(frozen->get_version_of_current_transaction())->get_table("table")->size(), 0);
+
+    // The versions from the oldest one read by the replica are kept
+    CHECK_EQUAL(db->get_number_of_versions(), 11);
+    CHECK_LOGIC_ERROR(replica->close(), LogicError::wrong_transact_state);
+    // Versions are let go of as a commit is published, so they are only gone
+    // by the one after it
+    frozen.reset();
+    for (int i = 0; i < 2; ++i) {
+        auto wt = db->start_write();
+        wt->commit();
+    }
+    CHECK_EQUAL(db->get_number_of_versions(), 3);
+
+    // The file cannot be compacted while a replica has it open
+    rt.reset();
+    CHECK_NOT(db->compact());
+    replica->close();
+    CHECK(db->compact());
+    replica = DB::create(*replica_hist, path, replica_options);
+    rt = replica->start_read();
+    CHECK_EQUAL(rt->get_version(), db->get_version_of_latest_snapshot());
+    CHECK_EQUAL(rt->get_table("table")->size(), 10);
+    rt.reset();
+    replica->close();
+    db->close();
+}
+
 #endif // TEST_SHARED
@@ -296,6 +296,203 @@ TEST(Sync_AsyncWaitForDownloadCompletion)
 }
 
 
+TEST(Sync_DownloadDecompressionThreads)
+{
+    TEST_DIR(dir);
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+    TEST_CLIENT_DB(db_3);
+    ClientServerFixture::Config config;
+    config.client_download_decompression_threads = 2;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    // The sessions share a connection, so the DOWNLOAD messages for session 2
+    // and 3 are decompressed concurrently, but must still be processed in
+    // order.
+    Session session_1 = fixture.make_bound_session(db_1, "/test");
+    Session session_2 = fixture.make_bound_session(db_2, "/test");
+    Session session_3 = fixture.make_bound_session(db_3, "/test");
+
+    // Large and repetitive strings, such that the server compresses the
+    // bodies of the DOWNLOAD messages
+    for (int i = 0; i < 16; ++i) {
+        write_transaction_notifying_session(db_1, session_1, [&](WriteTransaction& wt) {
+            TableRef table = wt.get_or_add_table("class_foo");
+            ColKey col = table->get_column_key("str");
+            if (!col)
+                col = table->add_column(type_String, "str");
+            for (int j = 0; j < 64; ++j)
+                table->create_object().set(col, std::string(1024, char('a' + (i + j) % 26)));
+        });
+    }
+    session_1.wait_for_upload_complete_or_client_stopped();
+    session_2.wait_for_download_complete_or_client_stopped();
+    session_3.wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(db_1);
+    ReadTransaction rt_2(db_2);
+    ReadTransaction rt_3(db_3);
+    CHECK_EQUAL(rt_2.get_table("class_foo")->size(), 16 * 64);
+    CHECK(compare_groups(rt_1, rt_2));
+    CHECK(compare_groups(rt_1, rt_3));
+}
+
+
+TEST_TYPES(Sync_SnapshotBootstrap, std::true_type, std::false_type)
+{
+    constexpr bool server_enabled = TEST_TYPE::value;
+    TEST_DIR(dir);
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+    ClientServerFixture::Config config;
+    config.client_snapshot_bootstrap = true;
+    config.server_enable_snapshot_bootstraps = server_enabled;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    auto add_objects = [&](DBRef db, Session& session, int64_t begin, int64_t end) {
+        write_transaction_notifying_session(db, session, [&](WriteTransaction& wt) {
+            TableRef table = wt.get_group().get_or_add_table_with_primary_key("class_foo", type_Int, "_id");
+            ColKey col = table->get_column_key("value");
+            if (!col)
+                col = table->add_column(type_Int, "value");
+            for (int64_t i = begin; i < end; ++i)
+                table->create_object_with_primary_key(i).set(col, i);
+        });
+    };
+
+    Session session_1 = fixture.make_bound_session(db_1, "/test");
+    for (int64_t i = 0; i < 10; ++i)
+        add_objects(db_1, session_1, i * 100, i * 100 + 100);
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    // Changes made before the first download must survive the bootstrap
+    {
+        WriteTransaction wt(db_2);
+        TableRef table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "_id");
+        ColKey col = table->add_column(type_Int, "value");
+        table->create_object_with_primary_key(5000).set(col, 5000);
+        table->create_object_with_primary_key(0).set(col, -1);
+        wt.commit();
+    }
+    Session session_2 = fixture.make_bound_session(db_2, "/test");
+    session_2.wait_for_download_complete_or_client_stopped();
+    session_2.wait_for_upload_complete_or_client_stopped();
+
+    // Later changes are downloaded incrementally
+    add_objects(db_1, session_1, 1000, 1100);
+    session_1.wait_for_upload_complete_or_client_stopped();
+    session_1.wait_for_download_complete_or_client_stopped();
+    session_2.wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(db_1);
+    ReadTransaction rt_2(db_2);
+    CHECK_EQUAL(rt_2.get_table("class_foo")->size(), 1101);
+    CHECK(compare_groups(rt_1, rt_2));
+}
+
+
+TEST(Sync_MultipleServerWorkers)
+{
+    TEST_DIR(dir);
+    ClientServerFixture::Config config;
+    config.server_num_workers = 3;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    // The files are spread over the workers, and each one of them gets
+    // changesets from two clients concurrently.
+    constexpr int num_files = 6;
+    std::vector<std::unique_ptr<DBTestPathGuard>> paths;
+    std::vector<DBRef> dbs;
+    std::vector<Session> sessions;
+    for (int i = 0; i < 2 * num_files; ++i) {
+        std::string suffix = util::format(".client_%1.realm", i);
+        std::string path = get_test_path(test_context.get_test_name(), suffix);
+        paths.push_back(std::make_unique<DBTestPathGuard>(path));
+        dbs.push_back(DB::create(make_client_replication(), path));
+        sessions.push_back(fixture.make_bound_session(dbs.back(), util::format("/test_%1", i % num_files)));
+    }
+    for (int i = 0; i < 2 * num_files; ++i) {
+        write_transaction_notifying_session(dbs[i], sessions[i], [&](WriteTransaction& wt) {
+            TableRef table = wt.get_group().get_or_add_table_with_primary_key("class_foo", type_Int, "_id");
+            ColKey col = table->get_column_key("value");
+            if (!col)
+                col = table->add_column(type_Int, "value");
+            for (int j = 0; j < 100; ++j)
+                table->create_object_with_primary_key(i * 100 + j).set(col, j);
+        });
+    }
+    for (Session& session : sessions)
+        session.wait_for_upload_complete_or_client_stopped();
+    for (Session& session : sessions)
+        session.wait_for_download_complete_or_client_stopped();
+
+    for (int i = 0; i < num_files; ++i) {
+        ReadTransaction rt_1(dbs[i]);
+        ReadTransaction rt_2(dbs[i + num_files]);
+        CHECK_EQUAL(rt_1.get_table("class_foo")->size(), 200);
+        CHECK(compare_groups(rt_1, rt_2));
+    }
+}
+
+
+TEST(Sync_SharedDownloadCache)
+{
+    TEST_DIR(dir);
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+    TEST_CLIENT_DB(db_3);
+    TEST_CLIENT_DB(db_4);
+    ClientServerFixture::Config config;
+    config.server_download_cache_size = 1024 * 1024;
+    ClientServerFixture fixture(dir, test_context, std::move(config));
+    fixture.start();
+
+    auto add_objects = [](WriteTransaction& wt, int begin, int end) {
+        TableRef table = wt.get_group().get_or_add_table_with_primary_key("class_foo", type_Int, "_id");
+        for (int i = begin; i < end; ++i)
+            table->create_object_with_primary_key(i);
+    };
+
+    Session session_1 = fixture.make_bound_session(db_1, "/test");
+    write_transaction_notifying_session(db_1, session_1, [&](WriteTransaction& wt) {
+        add_objects(wt, 0, 100);
+    });
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    // Session 2 and 3 start downloading from the same position, so the DOWNLOAD
+    // body produced for session 2 is reused for session 3.
+    Session session_2 = fixture.make_bound_session(db_2, "/test");
+    session_2.wait_for_download_complete_or_client_stopped();
+    Session session_3 = fixture.make_bound_session(db_3, "/test");
+    session_3.wait_for_download_complete_or_client_stopped();
+
+    // Changesets of session 2 must not be sent back to it, even though the
+    // remaining sessions download them.
+    write_transaction_notifying_session(db_2, session_2, [&](WriteTransaction& wt) {
+        add_objects(wt, 100, 200);
+    });
+    session_2.wait_for_upload_complete_or_client_stopped();
+    write_transaction_notifying_session(db_1, session_1, [&](WriteTransaction& wt) {
+        add_objects(wt, 200, 300);
+    });
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    Session session_4 = fixture.make_bound_session(db_4, "/test");
+    for (Session* session : {&session_1, &session_2, &session_3, &session_4})
+        session->wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(db_1);
+    CHECK_EQUAL(rt_1.get_table("class_foo")->size(), 300);
+    for (DBRef db : {db_2, db_3, db_4}) {
+        ReadTransaction rt_2(db);
+        CHECK(compare_groups(rt_1, rt_2));
+    }
+}
+
+
 TEST(Sync_AsyncWaitForSyncCompletion)
 {
     TEST_DIR(dir);
@@ -3780,6 +3977,101 @@ TEST(Sync_MultipleSyncAgentsNotAllowed)
 }
 
 
+TEST(Sync_SessionPriorityAndUploadBandwidthLimit)
+{
+    TEST_DIR(server_dir);
+    TEST_CLIENT_DB(db_1);
+    TEST_CLIENT_DB(db_2);
+
+    ClientServerFixture::Config fixture_config;
+    fixture_config.one_connection_per_session = false;
+    ClientServerFixture fixture{server_dir, test_context, std::move(fixture_config)};
+    fixture.start();
+
+    // The two sessions share a connection
+    Session::Config config_1;
+    config_1.priority = 10;
+    Session session_1 = fixture.make_bound_session(db_1, "/test_1", std::move(config_1));
+    Session::Config config_2;
+    config_2.upload_bandwidth_limit = 128 * 1024;
+    Session session_2 = fixture.make_bound_session(db_2, "/test_2", std::move(config_2));
+
+    // Random data, as the UPLOAD messages may be compressed
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    auto write_blob = [&](DBRef db, Session& session) {
+        std::string str(64 * 1024, '\0');
+        for (char& c : str)
+            c = random.draw_int<char>();
+        WriteTransaction wt{db};
+        TableRef table = wt.get_or_add_table("class_table");
+        ColKey col = table->get_column_key("blob");
+        if (!col)
+            col = table->add_column(type_Binary, "blob");
+        table->create_object().set(col, BinaryData{str.data(), str.size()});
+        session.nonsync_transact_notify(wt.commit());
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 4; ++i) {
+        write_blob(db_2, session_2);
+        write_blob(db_1, session_1);
+        session_1.wait_for_upload_complete_or_client_stopped();
+        session_2.wait_for_upload_complete_or_client_stopped();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Each of the UPLOAD messages of the limited session holds back the next
+    // one for half a second.
+    CHECK_GREATER_EQUAL(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 1500);
+}
+
+
+TEST(Sync_UploadBandwidthLimitDoesNotDelayRebinding)
+{
+    TEST_DIR(server_dir);
+    TEST_CLIENT_DB(db);
+
+    ClientServerFixture fixture{server_dir, test_context};
+    fixture.start();
+
+    BowlOfStonesSemaphore bowl;
+    auto handler = [&](const SessionErrorInfo& info) {
+        if (CHECK_EQUAL(info.error_code, ProtocolError::connection_closed))
+            bowl.add_stone();
+    };
+    Session::Config config;
+    config.upload_bandwidth_limit = 16 * 1024;
+    Session session = fixture.make_session(db, std::move(config));
+    session.set_error_handler(std::move(handler));
+    fixture.bind_session(session, "/test");
+    session.wait_for_download_complete_or_client_stopped();
+
+    // Random data, as the UPLOAD messages may be compressed. Sending it holds
+    // back the next message of the session for four seconds.
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    std::string str(64 * 1024, '\0');
+    for (char& c : str)
+        c = random.draw_int<char>();
+    {
+        WriteTransaction wt{db};
+        TableRef table = wt.get_or_add_table("class_table");
+        table->create_object().set(table->add_column(type_Binary, "blob"), BinaryData{str.data(), str.size()});
+        session.nonsync_transact_notify(wt.commit());
+    }
+    session.wait_for_upload_complete_or_client_stopped();
+
+    // The session rebinds, and learns that it is up to date, right after the
+    // connection is reestablished
+    auto start = std::chrono::steady_clock::now();
+    fixture.close_server_side_connections();
+    bowl.get_stone();
+    session.cancel_reconnect_delay();
+    session.wait_for_download_complete_or_client_stopped();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK_LESS(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 2000);
+}
+
+
 TEST(Sync_CancelReconnectDelay)
 {
     TEST_DIR(server_dir);
@@ -6605,6 +6897,91 @@ TEST(Sync_NonIncreasingServerVersions)
                                         DownloadBatchState::LastInBatch, logger);
 }
 
+TEST(Sync_ChunkedIntegrationOfServerChangesets)
+{
+    TEST_CLIENT_DB(db);
+
+    auto& history = get_history(db);
+    history.set_client_file_ident(SaltedFileIdent{2, 0x1234567812345678}, false);
+    timestamp_type timestamp{1};
+    history.set_local_origin_timestamp_source([&] {
+        return ++timestamp;
+    });
+
+    auto latest_local_version = [&] {
+        auto tr = db->start_write();
+        tr->add_table_with_primary_key("class_foo", type_String, "_id")->add_column(type_Int, "int_col");
+        return tr->commit();
+    }();
+
+    // The last two changesets share a server version, so they must end up in
+    // the same transaction.
+    std::vector<Changeset> server_changesets;
+    auto prep_changeset = [&](auto pk_name, auto int_col_val, version_type server_version) {
+        Changeset changeset;
+        changeset.version = server_version;
+        changeset.last_integrated_remote_version = latest_local_version - 1;
+        changeset.origin_timestamp = ++timestamp;
+        changeset.origin_file_ident = 1;
+        instr::PrimaryKey pk{changeset.intern_string(pk_name)};
+        auto table_name = changeset.intern_string("foo");
+        auto col_name = changeset.intern_string("int_col");
+        instr::CreateObject create_1;
+        create_1.object = pk;
+        create_1.table = table_name;
+        changeset.push_back(create_1);
+        instr::Update update_1;
+        update_1.table = table_name;
+        update_1.object = pk;
+        update_1.field = col_name;
+        update_1.value = instr::Payload{int64_t(int_col_val)};
+        changeset.push_back(update_1);
+        server_changesets.push_back(std::move(changeset));
+    };
+    prep_changeset("bizz", 1, 10);
+    prep_changeset("buzz", 2, 11);
+    prep_changeset("baz", 3, 12);
+    prep_changeset("bar", 4, 12);
+
+    std::vector<ChangesetEncoder::Buffer> encoded;
+    std::vector<Transformer::RemoteChangeset> server_changesets_encoded;
+    for (const auto& changeset : server_changesets) {
+        encoded.emplace_back();
+        encode_changeset(changeset, encoded.back());
+        server_changesets_encoded.emplace_back(changeset.version, changeset.last_integrated_remote_version,
+                                               BinaryData(encoded.back().data(), encoded.back().size()),
+                                               changeset.origin_timestamp, changeset.origin_file_ident);
+    }
+
+    SyncProgress progress = {};
+    progress.download.server_version = server_changesets.back().version;
+    progress.download.last_integrated_client_version = latest_local_version - 1;
+    progress.latest_server_version.version = server_changesets.back().version;
+    progress.latest_server_version.salt = 0x7876543217654321;
+
+    uint_fast64_t downloadable_bytes = 0;
+    VersionInfo version_info;
+    util::StderrLogger logger;
+    history.set_integration_chunk_size(1);
+    history.integrate_server_changesets(progress, &downloadable_bytes, server_changesets_encoded, version_info,
+                                        DownloadBatchState::LastInBatch, logger);
+
+    CHECK_EQUAL(version_info.realm_version, latest_local_version + 3);
+
+    version_type current_client_version;
+    SaltedFileIdent client_file_ident;
+    SyncProgress stored_progress;
+    history.get_status(current_client_version, client_file_ident, stored_progress);
+    CHECK_EQUAL(current_client_version, version_info.realm_version);
+    CHECK_EQUAL(stored_progress.download.server_version, progress.download.server_version);
+    CHECK_EQUAL(stored_progress.latest_server_version.version, progress.latest_server_version.version);
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("class_foo");
+    CHECK_EQUAL(table->size(), 4);
+    CHECK_EQUAL(table->get_object_with_primary_key("bar").get<Int>("int_col"), 4);
+}
+
 TEST(Sync_InvalidChangesetFromServer)
 {
     TEST_CLIENT_DB(db);
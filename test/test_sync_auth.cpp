@@ -79,4 +79,64 @@ TEST(Sync_Auth_JWTAccessTokenStitchFields)
     CHECK_EQUAL(tok.access, admin_access);
 }
 
+TEST(Sync_Auth_CachedVerification)
+{
+    std::string jwt =
+        "eyJhbGciOiJSUzI1NiIsInR5cCI6IkpXVCJ9."
+        "eyJhcHBJZCI6ImlvLnJlYWxtLkF1dGgiLCJhY2Nlc3MiOlsiZG93bmxvYWQiLCJ1cGxvYWQiXSwic3ViIjoiZGYyZjE4NjBjMTk1MjFiYjk0"
+        "NjM0OTRjOTI1MTYyZjciLCJwYXRoIjoiL2RlZmF1bHQvX19wYXJ0aWFsL2RmMmYxODYwYzE5NTIxYmI5NDYzNDk0YzkyNTE2MmY3LzBlYzNj"
+        "NjdlMTFjNzFkYmU1ZTgzYmZiNDE3MTViZmJlMGQ5ODNmODYiLCJzeW5jX2xhYmVsIjoiZGVmYXVsdCIsInNhbHQiOiIyY2FmZjhlMCIsImlh"
+        "dCI6MTU2NDczNzY1NiwiZXhwIjo0NzIwNDExNjE1LCJhdWQiOiJyZWFsbSIsImlzcyI6InJlYWxtIiwianRpIjoiYmM3MTlkY2ItOTA2Ny00"
+        "ZTQ4LWI1NmItYTQ3MzMxZDNmZDgxIn0.SGFUR8A-"
+        "XXn2i7LFGcWuUlrfcPgUYRj58ZClZrjsW7NSiE1tI5zZSbrEL7vyTPtwbMbMe1qMgdoB1ZdSzt-HAB9RCIrRk40XlHw7flb8jk_"
+        "q0hdqPnKbxEMz9wWzzUGOshXj2Yso1NVEX0q04k-ndpAODtuMDiU5T_3vF1czUFA-WXOMDr9dpX_Wn8KeEO0uOvb4_1AvDM_"
+        "wK3RF5D9IsJGuvE2Sqbq5j2DPGCgTkBsTcKJPQPcgEDC270nSb9SfitzLEzxoQbhF9M82MQJqhfj4ZThImG6ed7hjUIqdgBFuyBQ4WaMQgPD"
+        "vA5KRPYymC5owAHBmGht9wpUFzAbnBg";
+    std::string forged = jwt;
+    forged[forged.size() - 2] = (forged[forged.size() - 2] == 'A' ? 'B' : 'A');
+
+    AccessControl ctrl(PKey::load_public(test_util::get_test_resource_path() + "test_pubkey2.pem"));
+    CHECK_EQUAL(ctrl.get_num_cached_tokens(), 0);
+
+    // A verified token is cached, and found in the cache the next time
+    for (int i = 0; i < 2; ++i) {
+        AccessToken::ParseError error = AccessToken::ParseError::invalid_json;
+        auto token = ctrl.verify_access_token(jwt, &error);
+        CHECK(token);
+        CHECK(error == AccessToken::ParseError::none);
+        CHECK_EQUAL(token->identity, "df2f1860c19521bb9463494c925162f7");
+        CHECK_EQUAL(token->expires, 4720411615);
+        CHECK_EQUAL(ctrl.get_num_cached_tokens(), 1);
+    }
+
+    // A token failing verification is not cached, and does not match the
+    // cached one
+    AccessToken::ParseError error = AccessToken::ParseError::none;
+    CHECK_NOT(ctrl.verify_access_token(forged, &error));
+    CHECK(error == AccessToken::ParseError::invalid_signature);
+    CHECK_EQUAL(ctrl.get_num_cached_tokens(), 1);
+
+    // Verifying several tokens at once gives the same results as verifying
+    // them one by one
+    std::vector<StringData> batch = {forged, jwt, "garbage", jwt, forged};
+    std::vector<AccessToken::ParseError> errors;
+    auto tokens = ctrl.verify_access_tokens(batch, &errors);
+    CHECK_EQUAL(tokens.size(), batch.size());
+    CHECK_EQUAL(errors.size(), batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        bool valid = (batch[i] == jwt);
+        CHECK_EQUAL(bool(tokens[i]), valid);
+        CHECK_EQUAL(errors[i] == AccessToken::ParseError::none, valid);
+        if (valid)
+            CHECK_EQUAL(tokens[i]->identity, "df2f1860c19521bb9463494c925162f7");
+    }
+    CHECK_EQUAL(ctrl.get_num_cached_tokens(), 1);
+
+    // The cache can be disabled
+    AccessControl uncached(PKey::load_public(test_util::get_test_resource_path() + "test_pubkey2.pem"), 0);
+    CHECK(uncached.verify_access_token(jwt));
+    CHECK(uncached.verify_access_token(jwt));
+    CHECK_EQUAL(uncached.get_num_cached_tokens(), 0);
+}
+
 } // unnamed namespace
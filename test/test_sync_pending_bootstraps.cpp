@@ -0,0 +1,84 @@
+#include "realm/sync/noinst/client_history_impl.hpp"
+#include "realm/sync/noinst/pending_bootstrap_store.hpp"
+
+#include "test.hpp"
+#include "util/test_path.hpp"
+
+namespace realm::sync {
+
+TEST(Sync_PendingBootstrapStoreBatching)
+{
+    SHARED_GROUP_TEST_PATH(db_path);
+    SyncProgress progress;
+    progress.download = {5, 5};
+    progress.latest_server_version = {5, 123456789};
+    progress.upload = {5, 5};
+    {
+        auto db = DB::create(make_client_replication(), db_path);
+        bool created_new_batch = false;
+        std::vector<Transformer::RemoteChangeset> changesets;
+        std::vector<std::string> changeset_data;
+
+        for (size_t idx = 0; idx < 5; ++idx) {
+            changeset_data.emplace_back(1024, 'a' + idx);
+            changesets.emplace_back(idx + 1, 5, BinaryData(changeset_data.back()), 1, 2);
+            changesets.back().original_changeset_size = 1024;
+        }
+
+        util::StderrLogger logger;
+        PendingBootstrapStore store(db, &logger);
+
+        store.add_batch(1, util::none, {changesets.begin(), changesets.begin() + 3}, &created_new_batch);
+        CHECK(created_new_batch);
+        CHECK(store.has_pending());
+        store.add_batch(1, progress, {changesets.begin() + 3, changesets.end()}, &created_new_batch);
+        CHECK(!created_new_batch);
+
+        // The limit is checked after each changeset, so a batch always
+        // contains at least one changeset.
+        auto single_batch = store.peek_pending(1);
+        CHECK_EQUAL(single_batch.changesets.size(), 1);
+        CHECK_EQUAL(single_batch.remaining, 4);
+
+        auto first_batch = store.peek_pending(2048);
+        CHECK_EQUAL(first_batch.query_version, 1);
+        CHECK(first_batch.progress);
+        CHECK_EQUAL(first_batch.changesets.size(), 2);
+        CHECK_EQUAL(first_batch.remaining, 3);
+        CHECK_EQUAL(first_batch.changesets[0].remote_version, 1);
+
+        // Reading ahead with an offset yields the batch that follows once the
+        // first one has been popped.
+        auto next_batch = store.peek_pending(2048, first_batch.changesets.size());
+        CHECK_EQUAL(next_batch.changesets.size(), 2);
+        CHECK_EQUAL(next_batch.remaining, 1);
+        CHECK_EQUAL(next_batch.changesets[0].remote_version, 3);
+        CHECK_EQUAL(next_batch.changesets[0].data.size(), 1024);
+
+        auto tr = db->start_write();
+        store.pop_front_pending(tr, first_batch.changesets.size());
+        tr->commit();
+        CHECK(store.has_pending());
+
+        auto popped_batch = store.peek_pending(2048);
+        CHECK_EQUAL(popped_batch.changesets.size(), next_batch.changesets.size());
+        CHECK_EQUAL(popped_batch.remaining, next_batch.remaining);
+        for (size_t idx = 0; idx < popped_batch.changesets.size(); ++idx) {
+            CHECK_EQUAL(popped_batch.changesets[idx].remote_version, next_batch.changesets[idx].remote_version);
+            CHECK(popped_batch.changesets[idx].data.get_first_chunk() ==
+                  next_batch.changesets[idx].data.get_first_chunk());
+        }
+
+        auto last_batch = store.peek_pending(1024 * 1024, 4 - first_batch.changesets.size());
+        CHECK_EQUAL(last_batch.changesets.size(), 1);
+        CHECK_EQUAL(last_batch.remaining, 0);
+        CHECK_EQUAL(last_batch.changesets[0].remote_version, 5);
+
+        tr = db->start_write();
+        store.pop_front_pending(tr, 3);
+        tr->commit();
+        CHECK(!store.has_pending());
+    }
+}
+
+} // namespace realm::sync
@@ -489,6 +489,54 @@ TEST(Sync_SubscriptionStoreNextPendingVersion)
     CHECK(!pending_version);
 }
 
+TEST(Sync_SubscriptionStoreSharedSubscriptions)
+{
+    SHARED_GROUP_TEST_PATH(sub_store_path);
+    SubscriptionStoreFixture fixture(sub_store_path);
+    auto store = SubscriptionStore::create(fixture.db, [](int64_t) {});
+
+    auto read_tr = fixture.db->start_read();
+    Query query_a(read_tr->get_table(fixture.a_table_key));
+    query_a.equal(fixture.foo_col, StringData("JBR"));
+    Query query_b(read_tr->get_table(fixture.a_table_key));
+    query_b.equal(fixture.foo_col, "Realm");
+
+    auto mut_sub_set = store->get_latest().make_mutable_copy();
+    mut_sub_set.insert_or_assign("a sub", query_a);
+    auto sub_set = std::move(mut_sub_set).commit();
+
+    // The sets of the same version see the same subscriptions, also after
+    // the state has changed
+    auto by_version = store->get_by_version(sub_set.version());
+    CHECK_EQUAL(by_version.size(), 1);
+    CHECK(by_version.begin()->id() == sub_set.begin()->id());
+    {
+        auto mut = store->get_mutable_by_version(sub_set.version());
+        mut.update_state(SubscriptionSet::State::Complete);
+        // Not persisted, as the set is already committed, and must not be
+        // seen by the other sets of this version
+        mut.insert_or_assign("b sub", query_b);
+        std::move(mut).commit();
+    }
+    auto active = store->get_active();
+    CHECK_EQUAL(active.version(), sub_set.version());
+    CHECK_EQUAL(active.state(), SubscriptionSet::State::Complete);
+    CHECK_EQUAL(active.size(), 1);
+    CHECK_EQUAL(sub_set.size(), 1);
+    CHECK_EQUAL(by_version.size(), 1);
+
+    // Changing a copy does not change the set it was copied from
+    mut_sub_set = active.make_mutable_copy();
+    mut_sub_set.erase(mut_sub_set.find("a sub"));
+    mut_sub_set.insert_or_assign("b sub", query_b);
+    CHECK_EQUAL(active.size(), 1);
+    CHECK_EQUAL(active.begin()->name(), "a sub");
+    auto latest = std::move(mut_sub_set).commit();
+    CHECK_EQUAL(latest.size(), 1);
+    CHECK_EQUAL(latest.begin()->name(), "b sub");
+    CHECK_EQUAL(store->get_by_version(active.version()).begin()->name(), "a sub");
+}
+
 TEST(Sync_SubscriptionStoreSubSetHasTable)
 {
     SHARED_GROUP_TEST_PATH(sub_store_path)
@@ -514,6 +562,8 @@ TEST(Sync_SubscriptionStoreSubSetHasTable)
     table_set = store->get_tables_for_latest(*read_tr);
     CHECK(table_set.find("a") != table_set.end());
     CHECK(table_set.find("fake_table_that_doesnt_exist") == table_set.end());
+    // The second lookup of the same version is served from the cache
+    CHECK(store->get_tables_for_latest(*read_tr) == table_set);
 
     mut_sub_set = sub_set.make_mutable_copy();
     mut_sub_set.erase(mut_sub_set.find(query_a));
@@ -0,0 +1,106 @@
+#include "test.hpp"
+
+#include <realm/sync/noinst/upload_flow_control.hpp>
+
+using namespace realm;
+using namespace realm::sync;
+
+TEST(Sync_UploadFlowControl_SlowStart)
+{
+    UploadFlowControl flow;
+    CHECK(flow.can_send());
+    CHECK_EQUAL(flow.get_window(), UploadFlowControl::initial_window);
+    CHECK_EQUAL(flow.get_message_size(), UploadFlowControl::initial_window / 4);
+
+    // Several messages are in flight at a time, until the window is full
+    milliseconds_type now = 1000;
+    size_t size = flow.get_message_size();
+    for (version_type version = 1; version <= 4; ++version) {
+        CHECK(flow.can_send());
+        flow.on_upload_sent(version, size, now);
+    }
+    CHECK_NOT(flow.can_send());
+    CHECK_EQUAL(flow.get_bytes_in_flight(), 4 * size);
+
+    // Progress not covering any message acknowledges nothing
+    CHECK_NOT(flow.on_upload_acknowledged(0, now + 10));
+
+    // The window doubles for every round trip
+    CHECK(flow.on_upload_acknowledged(2, now + 200));
+    CHECK(flow.can_send());
+    CHECK_EQUAL(flow.get_window(), UploadFlowControl::initial_window + 2 * size);
+    CHECK_EQUAL(flow.get_round_trip_time(), 200);
+    CHECK(flow.on_upload_acknowledged(4, now + 200));
+    CHECK_EQUAL(flow.get_window(), 2 * UploadFlowControl::initial_window);
+    CHECK_EQUAL(flow.get_bytes_in_flight(), 0);
+    CHECK_EQUAL(flow.get_message_size(), 2 * size);
+    CHECK_NOT(flow.on_upload_acknowledged(4, now + 300));
+}
+
+TEST(Sync_UploadFlowControl_Queuing)
+{
+    UploadFlowControl flow;
+    milliseconds_type now = 1000;
+    version_type version = 0;
+    auto round_trip = [&](milliseconds_type rtt) {
+        while (flow.can_send())
+            flow.on_upload_sent(++version, flow.get_message_size(), now);
+        now += rtt;
+        flow.on_upload_acknowledged(version, now);
+    };
+    for (int i = 0; i < 4; ++i)
+        round_trip(100);
+    size_t window = flow.get_window();
+    CHECK_GREATER(window, UploadFlowControl::initial_window);
+
+    // A round-trip time far above the smallest one means that the messages
+    // queue up, so the window shrinks, and grows slowly from then on
+    round_trip(1000);
+    CHECK_LESS(flow.get_window(), window);
+    window = flow.get_window();
+    round_trip(100);
+    CHECK_GREATER(flow.get_window(), window);
+    CHECK_LESS_EQUAL(flow.get_window(), window + flow.get_message_size());
+
+    // Jitter is tolerated
+    window = flow.get_window();
+    round_trip(240);
+    CHECK_GREATER(flow.get_window(), window);
+
+    // The window never gets too small, and messages are never too small or
+    // too large
+    for (int i = 0; i < 20; ++i)
+        round_trip(100000);
+    CHECK_EQUAL(flow.get_window(), UploadFlowControl::min_window);
+    CHECK_EQUAL(flow.get_message_size(), UploadFlowControl::min_message_size);
+    CHECK(flow.can_send());
+
+    flow.on_upload_sent(++version, 100, now);
+    flow.reset();
+    CHECK_EQUAL(flow.get_window(), UploadFlowControl::initial_window);
+    CHECK_EQUAL(flow.get_bytes_in_flight(), 0);
+    CHECK_EQUAL(flow.get_round_trip_time(), 0);
+    CHECK_NOT(flow.on_upload_acknowledged(version, now));
+}
+
+TEST(Sync_UploadFlowControl_LargeMessages)
+{
+    UploadFlowControl flow;
+    milliseconds_type now = 1000;
+    version_type version = 0;
+    for (int i = 0; i < 30; ++i) {
+        while (flow.can_send())
+            flow.on_upload_sent(++version, flow.get_message_size(), now);
+        now += 50;
+        flow.on_upload_acknowledged(version, now);
+    }
+    CHECK_EQUAL(flow.get_window(), UploadFlowControl::max_window);
+    CHECK_EQUAL(flow.get_message_size(), UploadFlowControl::max_message_size);
+
+    // A single message larger than the window can still be sent
+    flow.reset();
+    flow.on_upload_sent(++version, UploadFlowControl::max_window, now);
+    CHECK_NOT(flow.can_send());
+    flow.on_upload_acknowledged(version, now + 50);
+    CHECK(flow.can_send());
+}
@@ -391,6 +391,34 @@ TEST(Table_Null)
     }
 }
 
+TEST(Table_GetUnchecked)
+{
+    Group group;
+    TableRef table = group.add_table("test");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int_null", true);
+    auto col_bool = table->add_column(type_Bool, "bool");
+    auto col_string = table->add_column(type_String, "string", true);
+    auto col_double_null = table->add_column(type_Double, "double_null", true);
+    auto col_link = table->add_column(*table, "link");
+
+    Obj obj = table->create_object();
+    obj.set(col_int, 5).set(col_bool, true).set(col_string, "hello").set(col_link, obj.get_key());
+    CHECK_EQUAL(obj.get_unchecked<Int>(col_int), 5);
+    CHECK_NOT(obj.get_unchecked<util::Optional<Int>>(col_int_null));
+    CHECK_EQUAL(obj.get_unchecked<Bool>(col_bool), true);
+    CHECK_EQUAL(obj.get_unchecked<String>(col_string), "hello");
+    CHECK_NOT(obj.get_unchecked<util::Optional<Double>>(col_double_null));
+    CHECK_EQUAL(obj.get_unchecked<ObjKey>(col_link), obj.get_key());
+
+    // Sees changes made through another accessor
+    Obj other = table->get_object(obj.get_key());
+    other.set(col_int_null, 7).set(col_double_null, 2.5).set_null(col_string);
+    CHECK_EQUAL(obj.get_unchecked<util::Optional<Int>>(col_int_null), 7);
+    CHECK_EQUAL(obj.get_unchecked<util::Optional<Double>>(col_double_null), 2.5);
+    CHECK(obj.get_unchecked<String>(col_string).is_null());
+}
+
 TEST(Table_DeleteCrash)
 {
     Group group;
@@ -914,6 +942,56 @@ TEST(Table_ColumnNameTooLong)
     table->add_column(*table, StringData(buf, buf_size - 1));
 }
 
+TEST(Table_ManyColumnNames)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+    auto name = [](int i) {
+        return "column" + util::to_string(i);
+    };
+
+    // Enough columns for the names to be found through a hash table
+    auto wt = db->start_write();
+    auto table = wt->add_table("table");
+    std::vector<ColKey> cols;
+    for (int i = 0; i < 50; ++i)
+        cols.push_back(table->add_column(type_Int, name(i)));
+    for (int i = 0; i < 50; ++i)
+        CHECK_EQUAL(table->get_column_key(name(i)), cols[i]);
+    CHECK_NOT(table->get_column_key("missing"));
+    CHECK_LOGIC_ERROR(table->add_column(type_Int, name(7)), LogicError::column_name_in_use);
+
+    table->remove_column(cols[3]);
+    table->rename_column(cols[4], name(3));
+    CHECK_EQUAL(table->get_column_key(name(3)), cols[4]);
+    CHECK_NOT(table->get_column_key(name(4)));
+    CHECK_EQUAL(table->get_column_key(name(5)), cols[5]);
+    wt->commit_and_continue_as_read();
+
+    // Names changed by another transaction are seen after advancing
+    {
+        auto wt2 = db->start_write();
+        auto t = wt2->get_table("table");
+        t->rename_column(t->get_column_key(name(10)), "renamed");
+        t->add_column(type_Int, name(4));
+        wt2->commit();
+    }
+    CHECK_EQUAL(table->get_column_key(name(10)), cols[10]);
+    wt->advance_read();
+    CHECK_NOT(table->get_column_key(name(10)));
+    CHECK_EQUAL(table->get_column_key("renamed"), cols[10]);
+    CHECK(table->get_column_key(name(4)));
+
+    // and are restored by a rollback
+    wt->promote_to_write();
+    table->rename_column(cols[20], "gone");
+    CHECK_NOT(table->get_column_key(name(20)));
+    wt->rollback_and_continue_as_read();
+    CHECK_EQUAL(table->get_column_key(name(20)), cols[20]);
+    CHECK_NOT(table->get_column_key("gone"));
+}
+
 TEST(Table_StringOrBinaryTooBig)
 {
     Table table;
@@ -1439,6 +1517,48 @@ TEST(Table_IndexStringTwice)
 }
 
 
+TEST(Table_AddSearchIndexToLargeTable)
+{
+    // More objects than are inserted into the index in one batch
+    Table table;
+    auto col_str = table.add_column(type_String, "str", true);
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_mixed = table.add_column(type_Mixed, "mixed");
+    const int num_objects = 100000;
+    for (int i = 0; i < num_objects; ++i) {
+        auto obj = table.create_object();
+        int value = (i * 7919) % 1000;
+        if (i % 10)
+            obj.set(col_str, util::to_string(value));
+        obj.set(col_int, value);
+        obj.set(col_mixed, i % 2 ? Mixed(util::to_string(value)) : Mixed(value));
+    }
+
+    table.add_search_index(col_str);
+    table.add_search_index(col_int);
+    table.add_search_index(col_mixed);
+    for (auto col : {col_str, col_int, col_mixed})
+        CHECK(table.has_search_index(col));
+
+    CHECK_EQUAL(table.count_string(col_str, StringData()), num_objects / 10);
+    for (int value : {0, 17, 999}) {
+        size_t num_str = 0, num_mixed_int = 0, num_mixed_str = 0;
+        for (auto obj : table) {
+            if (obj.get<Int>(col_int) != value)
+                continue;
+            if (!obj.is_null(col_str))
+                ++num_str;
+            (obj.get_any(col_mixed).is_type(type_Int) ? num_mixed_int : num_mixed_str)++;
+        }
+        auto str = util::to_string(value);
+        CHECK_EQUAL(table.count_int(col_int, value), num_objects / 1000);
+        CHECK_EQUAL(table.count_string(col_str, str), num_str);
+        CHECK_EQUAL(table.where().equal(col_mixed, Mixed(value)).count(), num_mixed_int);
+        CHECK_EQUAL(table.where().equal(col_mixed, Mixed(str)).count(), num_mixed_str);
+    }
+    table.verify();
+}
+
 // Tests Table part of index on Int, OldDateTime and Bool columns. For a more exhaustive
 // test of the integer index (bypassing Table), see test_index_string.cpp)
 TEST(Table_IndexInteger)
@@ -3279,6 +3399,90 @@ TEST(Table_ListOfMixedSwap)
     CHECK_EQUAL(list.get(3).get_string(), "b");
 }
 
+TEST(Table_ListOfPrimitivesGetRange)
+{
+    Group g;
+    TableRef t = g.add_table("table");
+    ColKey col_float = t->add_column_list(type_Float, "floats");
+    ColKey col_mixed = t->add_column_list(type_Mixed, "mixed");
+
+    auto obj = t->create_object();
+    auto floats = obj.get_list<float>(col_float);
+    auto mixed = obj.get_list<Mixed>(col_mixed);
+    for (int i = 0; i < 3000; i++) {
+        floats.add(i * 0.5f);
+        mixed.add(i % 2 ? Mixed(i) : Mixed(util::to_string(i)));
+    }
+
+    std::vector<float> float_values(floats.size());
+    floats.get_range(0, floats.size(), float_values.data());
+    for (size_t i = 0; i < float_values.size(); i++) {
+        CHECK_EQUAL(float_values[i], floats.get(i));
+    }
+
+    std::vector<Mixed> mixed_values(100);
+    mixed.get_range(1500, 1600, mixed_values.data());
+    for (size_t i = 0; i < mixed_values.size(); i++) {
+        CHECK_EQUAL(mixed_values[i], mixed.get(1500 + i));
+    }
+
+    CHECK_THROW(floats.get_range(10, 3001, float_values.data()), std::out_of_range);
+    CHECK_THROW(floats.get_range(10, 9, float_values.data()), std::out_of_range);
+}
+
+TEST(Table_FindNearest)
+{
+    Group g;
+    TableRef t = g.add_table("table");
+    ColKey col = t->add_column_list(type_Float, "embedding");
+    ColKey col_int = t->add_column(type_Int, "int");
+
+    // Points on a circle, plus a few which should be skipped
+    const size_t n = 1000;
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < n; i++) {
+        auto obj = t->create_object();
+        keys.push_back(obj.get_key());
+        auto list = obj.get_list<float>(col);
+        double angle = 2 * 3.14159265358979323846 * i / n;
+        for (size_t j = 0; j < 10; j++)
+            list.add(float(j == 0 ? std::cos(angle) : j == 1 ? std::sin(angle) : 0));
+    }
+    t->create_object(); // Empty list
+    t->create_object().get_list<float>(col).add(1);
+    auto zero = t->create_object().get_list<float>(col);
+    for (size_t j = 0; j < 10; j++)
+        zero.add(0);
+
+    std::vector<float> target(10, 0.0f);
+    target[0] = 1;
+    auto matches = t->find_nearest(col, target, 5);
+    if (CHECK_EQUAL(matches.size(), 5)) {
+        CHECK_EQUAL(matches[0].key, keys[0]);
+        CHECK_EQUAL(matches[0].distance, 0);
+        // The neighbours on either side are equally far away
+        CHECK(matches[1].key == keys[1] || matches[1].key == keys[n - 1]);
+        CHECK(matches[3].key == keys[2] || matches[3].key == keys[n - 2]);
+        for (size_t i = 1; i < matches.size(); i++)
+            CHECK_LESS_EQUAL(matches[i - 1].distance, matches[i].distance);
+    }
+
+    // Cosine distance ignores the magnitude, and skips the zero vector
+    target[0] = 0;
+    target[1] = -20;
+    matches = t->find_nearest(col, target, 3, Table::VectorDistance::Cosine);
+    if (CHECK_EQUAL(matches.size(), 3)) {
+        CHECK_EQUAL(matches[0].key, keys[n * 3 / 4]);
+        CHECK_APPROXIMATELY_EQUAL(matches[0].distance, 0, 1e-6);
+    }
+
+    matches = t->find_nearest(col, target, n * 2, Table::VectorDistance::Cosine);
+    CHECK_EQUAL(matches.size(), n);
+    CHECK_EQUAL(t->find_nearest(col, target, 0).size(), 0);
+    CHECK_EQUAL(t->find_nearest(col, {}, 10).size(), 0);
+    CHECK_THROW(t->find_nearest(col_int, target, 10), LogicError);
+}
+
 TEST(Table_object_merge_nodes)
 {
     // This test works best for REALM_MAX_BPNODE_SIZE == 8.
@@ -3403,7 +3607,216 @@ TEST(Table_object_by_index)
     }
 }
 
+TEST(Table_GetValues)
+{
+    Group g;
+    auto target = g.add_table_with_primary_key("target", type_Int, "id");
+    auto table = g.add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_int_null = table->add_column(type_Int, "int_null", true);
+    auto col_str = table->add_column(type_String, "string");
+    auto col_enum = table->add_column(type_String, "enum");
+    auto col_double = table->add_column(type_Double, "double", true);
+    auto col_mixed = table->add_column(type_Mixed, "mixed");
+    auto col_link = table->add_column(*target, "link");
+    auto col_list = table->add_column_list(type_Int, "list");
+
+    auto target_1 = target->create_object_with_primary_key(1);
+    auto target_2 = target->create_object_with_primary_key(2);
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = table->create_object();
+        obj.set(col_int, i);
+        if (i % 3)
+            obj.set(col_int_null, i * 2);
+        obj.set(col_str, util::to_string(i));
+        obj.set(col_enum, i % 2 ? "odd" : "even");
+        obj.set(col_double, i / 2.0);
+        obj.set_any(col_mixed, i % 2 ? Mixed(i) : Mixed("mixed"));
+        obj.set(col_link, i % 2 ? target_1.get_key() : target_2.get_key());
+        keys.push_back(obj.get_key());
+    }
+    table->enumerate_string_column(col_enum);
+    target_2.invalidate();
+
+    // Read in an order which crosses cluster boundaries repeatedly
+    std::reverse(keys.begin() + 500, keys.end());
+    std::swap(keys[0], keys[999]);
+    std::vector<ColKey> cols = {col_int, col_int_null, col_str, col_enum, col_double, col_mixed, col_link};
+    auto values = table->get_values(keys, cols);
+    CHECK_EQUAL(values.size(), keys.size() * cols.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+        auto obj = table->get_object(keys[k]);
+        for (size_t c = 0; c < cols.size(); ++c)
+            CHECK_EQUAL(values[c * keys.size() + k], obj.get_any(cols[c]));
+    }
+    CHECK(values[6 * keys.size() + 2].is_null());
+
+    CHECK(table->get_values({}, cols).empty());
+    CHECK(table->get_values(keys, {}).empty());
+    CHECK_THROW(table->get_values(keys, {col_list}), LogicError);
+    CHECK_THROW(table->get_values({ObjKey(5000)}, cols), KeyNotFound);
+}
+
+TEST(Table_CreateObjectsBatch)
+{
+    Group g;
+
+    {
+        auto table = g.add_table("plain");
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_str = table->add_column(type_String, "string", true);
+        auto col_other = table->add_column(type_Int, "other", true);
+        table->add_search_index(col_str);
+        table->add_search_index(col_other);
+
+        std::vector<Mixed> values;
+        std::vector<std::string> strings;
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i);
+        for (int i = 0; i < 1000; ++i)
+            strings.push_back(util::to_string(1000 - i));
+        for (auto& str : strings)
+            values.push_back(StringData(str));
+
+        auto keys = table->create_objects({col_int, col_str}, values);
+        CHECK_EQUAL(keys.size(), 1000);
+        CHECK_EQUAL(table->size(), 1000);
+        for (int i = 0; i < 1000; ++i) {
+            auto obj = table->get_object(keys[i]);
+            CHECK_EQUAL(obj.get<Int>(col_int), i);
+            CHECK_EQUAL(obj.get<String>(col_str), strings[i]);
+            CHECK_EQUAL(table->find_first_string(col_str, strings[i]), keys[i]);
+        }
+        CHECK_EQUAL(table->where().equal(col_other, null()).count(), 1000);
+        table->verify();
+
+        CHECK_THROW(table->create_objects({}, values), LogicError);
+        CHECK_THROW(table->create_objects({col_int, col_str}, {1, 2, 3}), LogicError);
+    }
+
+    {
+        auto table = g.add_table_with_primary_key("pk", type_String, "id");
+        auto col_pk = table->get_primary_key_column();
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_indexed = table->add_column(type_Int, "indexed");
+        table->add_search_index(col_indexed);
+
+        auto existing = table->create_object_with_primary_key("b", {{col_int, 1}, {col_indexed, 1}}).get_key();
+
+        auto keys =
+            table->create_objects({col_pk, col_int}, {"c", "b", "a", "c", "d", /* */ 10, 20, 30, 40, 50});
+        CHECK_EQUAL(keys.size(), 5);
+        CHECK_EQUAL(table->size(), 4);
+        CHECK_EQUAL(keys[1], existing);
+        CHECK_EQUAL(keys[0], keys[3]);
+        CHECK_EQUAL(table->get_object(existing).get<Int>(col_int), 20);
+        CHECK_EQUAL(table->get_object(existing).get<Int>(col_indexed), 1);
+        CHECK_EQUAL(table->get_object(keys[0]).get<Int>(col_int), 40);
+        CHECK_EQUAL(table->get_object(keys[2]).get<Int>(col_int), 30);
+        CHECK_EQUAL(table->get_object(keys[4]).get<Int>(col_int), 50);
+        for (auto pk : {"a", "b", "c", "d"})
+            CHECK_EQUAL(table->get_object(table->find_primary_key(pk)).get<String>(col_pk), pk);
+        CHECK_EQUAL(table->where().equal(col_indexed, 0).count(), 3);
+        table->verify();
+
+        CHECK_THROW(table->create_objects({col_int}, {1}), LogicError);
+        CHECK_THROW(table->create_objects({col_pk, col_int}, {"e", "a", 1, 2}, Table::UpdateMode::never),
+                    std::logic_error);
+        CHECK_THROW(table->create_objects({col_pk, col_int}, {"f", "f", 1, 2}, Table::UpdateMode::never),
+                    std::logic_error);
+    }
+}
+
 // String query benchmark
+TEST(Table_RemoveObjects)
+{
+    Group g;
+    auto origin = g.add_table("origin");
+    auto table = g.add_table("target");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_str = table->add_column(type_String, "string");
+    table->add_search_index(col_int);
+    table->add_search_index(col_str);
+    auto col_link = origin->add_column(*table, "link");
+
+    std::vector<ObjKey> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(table->create_object().set(col_int, i % 10).set(col_str, util::to_string(i)).get_key());
+    }
+    auto origin_obj = origin->create_object().set(col_link, keys[1]);
+
+    // Remove a minority of the objects; invalid and duplicate keys are ignored
+    std::vector<ObjKey> to_remove;
+    for (int i = 0; i < 1000; i += 4)
+        to_remove.push_back(keys[i]);
+    to_remove.push_back(keys[0]);
+    to_remove.push_back(null_key);
+    to_remove.push_back(ObjKey(123456));
+    table->remove_objects(to_remove);
+    CHECK_EQUAL(table->size(), 750);
+    CHECK_EQUAL(table->find_first_string(col_str, "0"), null_key);
+    CHECK_EQUAL(table->find_first_string(col_str, "1"), keys[1]);
+    CHECK_EQUAL(table->where().equal(col_int, 0).count(), 50);
+    table->verify();
+
+    // Remove most of the remaining objects, which rebuilds the indexes
+    to_remove.clear();
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 4 != 0 && i % 3 != 0)
+            to_remove.push_back(keys[i]);
+    }
+    table->remove_objects(to_remove);
+    CHECK_EQUAL(table->size(), 250);
+    CHECK_EQUAL(origin_obj.get<ObjKey>(col_link), null_key);
+    CHECK_EQUAL(table->find_first_string(col_str, "1"), null_key);
+    CHECK_EQUAL(table->find_first_string(col_str, "3"), keys[3]);
+    CHECK_EQUAL(table->where().equal(col_int, 3).count(), 34);
+    CHECK_EQUAL(table->where().equal(col_int, 0).count(), 17);
+    table->verify();
+
+    // Removing everything clears the table
+    origin_obj.set(col_link, keys[3]);
+    std::vector<ObjKey> remaining;
+    for (auto o : *table)
+        remaining.push_back(o.get_key());
+    table->remove_objects(remaining);
+    CHECK_EQUAL(table->size(), 0);
+    CHECK_EQUAL(origin_obj.get<ObjKey>(col_link), null_key);
+    CHECK_EQUAL(table->find_first_string(col_str, "3"), null_key);
+    table->verify();
+}
+
+TEST(Table_RemoveOldestObjects)
+{
+    Group g;
+    auto table = g.add_table_with_primary_key("events", type_Int, "id");
+    auto col_time = table->add_column(type_Timestamp, "time");
+    auto col_value = table->add_column(type_Int, "value");
+
+    // Append-only, with increasing times
+    const int num_objects = 5000;
+    for (int i = 0; i < num_objects; ++i)
+        table->create_object_with_primary_key(int64_t(i)).set(col_time, Timestamp(i, 0)).set(col_value, i % 7);
+
+    // Retention drops a prefix of the objects
+    CHECK_EQUAL(table->where().less(col_time, Timestamp(3000, 0)).remove(), 3000);
+    CHECK_EQUAL(table->size(), num_objects - 3000);
+    CHECK_EQUAL(table->begin()->get<Timestamp>(col_time), Timestamp(3000, 0));
+    CHECK_EQUAL(table->find_primary_key(int64_t(2999)), null_key);
+    CHECK(table->find_primary_key(int64_t(3000)));
+    CHECK_EQUAL(table->where().equal(col_value, 0).count(), 286);
+    table->verify();
+
+    // Appending continues after the retained objects
+    table->create_object_with_primary_key(int64_t(num_objects)).set(col_time, Timestamp(num_objects, 0));
+    CHECK_EQUAL(table->where().greater_equal(col_time, Timestamp(4999, 0)).count(), 2);
+    CHECK_EQUAL(table->where().less(col_time, Timestamp(4000, 0)).remove(), 1000);
+    CHECK_EQUAL(table->size(), 1001);
+    table->verify();
+}
+
 TEST(Table_QuickSort2)
 {
     Table ttt;
@@ -4010,6 +4423,242 @@ TEST(Table_PrimaryKeyIndexBug)
     CHECK_EQUAL(cnt, 1);
 }
 
+TEST(Table_PrimaryKeyCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    auto wt = db->start_write();
+    TableRef table = wt->add_table_with_primary_key("table", type_Int, "pk");
+    auto col_name = table->add_column(type_String, "name");
+    // More objects than slots in the cache, so that slots are shared
+    for (int64_t i = 0; i < 3000; ++i)
+        table->create_object_with_primary_key(i * 7).set(col_name, util::to_string(i));
+    for (int64_t i = 0; i < 3000; ++i) {
+        auto key = table->find_primary_key(i * 7);
+        CHECK_EQUAL(table->get_object(key).get<String>(col_name), util::to_string(i));
+        CHECK_NOT(table->find_primary_key(i * 7 + 1));
+    }
+    // Recreated objects get new keys
+    auto old_key = table->find_primary_key(14);
+    table->remove_object(old_key);
+    CHECK_NOT(table->find_primary_key(14));
+    auto new_key = table->create_object_with_primary_key(14).get_key();
+    CHECK_NOT_EQUAL(new_key, old_key);
+    CHECK_EQUAL(table->find_primary_key(14), new_key);
+    CHECK_EQUAL(table->get_object_with_primary_key(14).get_key(), new_key);
+    wt->commit_and_continue_as_read();
+
+    // Objects created in a rolled back transaction are gone
+    wt->promote_to_write();
+    table->create_object_with_primary_key(1);
+    CHECK(table->find_primary_key(1));
+    wt->rollback_and_continue_as_read();
+    CHECK_NOT(table->find_primary_key(1));
+    CHECK_EQUAL(table->find_primary_key(14), new_key);
+
+    wt->promote_to_write();
+    table->clear();
+    CHECK_NOT(table->find_primary_key(14));
+    bool did_create = false;
+    table->create_object_with_primary_key(14, &did_create);
+    CHECK(did_create);
+    table->create_object_with_primary_key(14, &did_create);
+    CHECK_NOT(did_create);
+}
+
+TEST(Table_ModificationVersion)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+
+    ColKey col_name, col_version, col_list, col_link;
+    ObjKey key_1, key_2, key_target;
+    {
+        auto wt = db->start_write();
+        TableRef target = wt->add_table("target");
+        TableRef table = wt->add_table_with_primary_key("table", type_Int, "pk");
+        col_name = table->add_column(type_String, "name", true);
+        col_version = table->add_column(type_Int, "version");
+        col_list = table->add_column_list(type_Int, "list");
+        col_link = table->add_column(*target, "link");
+        CHECK_THROW(table->set_modification_version_column(col_name), LogicError);
+        CHECK_THROW(table->set_modification_version_column(col_list), LogicError);
+        CHECK_THROW(table->set_modification_version_column(table->get_primary_key_column()), LogicError);
+        table->set_modification_version_column(col_version);
+        table->add_search_index(col_version);
+        key_1 = table->create_object_with_primary_key(1).get_key();
+        key_2 = table->create_object_with_primary_key(2).get_key();
+        key_target = target->create_object().get_key();
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    ConstTableRef table = rt->get_table("table");
+    CHECK_EQUAL(table->get_modification_version_column(), col_version);
+    uint64_t version = table->get_modification_version();
+    CHECK_EQUAL(table->get_object(key_1).get_modification_version(), version);
+    CHECK_EQUAL(table->where().modified_since(version).count(), 0);
+    CHECK_EQUAL(table->where().modified_since(version - 1).count(), 2);
+
+    auto modify = [&](auto&& func) {
+        auto wt = db->start_write();
+        func(*wt->get_table("table"));
+        wt->commit();
+        rt->advance_read();
+        uint64_t old_version = version;
+        version = table->get_modification_version();
+        return table->where().modified_since(old_version).find_all().size();
+    };
+
+    // Setting a property or modifying a collection stamps the object
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.get_object(key_1).set(col_name, "a");
+                }),
+                1);
+    CHECK_EQUAL(table->get_object(key_1).get_modification_version(), version);
+    CHECK_EQUAL(table->find_first_int(col_version, int64_t(version)), key_1);
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.get_object(key_2).get_list<Int>(col_list).add(5);
+                }),
+                1);
+    CHECK_EQUAL(table->get_object(key_2).get_modification_version(), version);
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.get_object(key_1).set_null(col_name);
+                    t.get_object(key_2).set(col_link, key_target);
+                    t.create_object_with_primary_key(3);
+                }),
+                3);
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.create_objects({t.get_primary_key_column()}, {Mixed(4), Mixed(5)});
+                    t.set_links(col_link, {key_1}, {key_target});
+                }),
+                3);
+
+    // Objects gaining or losing incoming links are not modified
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.get_parent_group()->get_table("target")->create_object();
+                    t.get_object(key_2).get_list<Int>(col_list).get(0);
+                }),
+                0);
+
+    // Setting the column directly stores the given value
+    CHECK_EQUAL(modify([&](Table& t) {
+                    t.get_object(key_1).set(col_version, 0);
+                }),
+                0);
+    CHECK_EQUAL(table->get_object(key_1).get_modification_version(), 0);
+
+    {
+        auto wt = db->start_write();
+        TableRef t = wt->get_table("table");
+        t->remove_column(col_version);
+        CHECK_NOT(t->get_modification_version_column());
+        t->get_object(key_1).set(col_name, "b");
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_NOT(table->get_modification_version_column());
+    CHECK_THROW(table->get_object(key_1).get_modification_version(), LogicError);
+    CHECK_THROW(table->where().modified_since(0), LogicError);
+}
+
+TEST(Table_ModificationVersionLeafRanges)
+{
+    // The ranges of the leaves of the modification version column are kept
+    // across versions until the table is modified, and must not outlive leaves
+    // which are freed and reused
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col_value, col_version;
+    {
+        auto wt = db->start_write();
+        TableRef table = wt->add_table("table");
+        wt->add_table("other")->add_column(type_Int, "value");
+        table->set_node_sizes(16, 0);
+        col_value = table->add_column(type_Int, "value");
+        col_version = table->add_column(type_Int, "version");
+        table->set_modification_version_column(col_version);
+        for (int64_t i = 0; i < 500; ++i)
+            table->create_object().set(col_value, i);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    ConstTableRef table = rt->get_table("table");
+    std::vector<uint64_t> versions = {table->get_modification_version()};
+    auto check = [&] {
+        for (uint64_t since : versions) {
+            size_t expected = 0;
+            for (auto& obj : *table) {
+                if (obj.get_modification_version() > since)
+                    ++expected;
+            }
+            // The second run uses the ranges computed by the first
+            for (int run = 0; run < 2; ++run)
+                CHECK_EQUAL(table->where().modified_since(since).count(), expected);
+        }
+    };
+    check();
+
+    for (int64_t round = 0; round < 20; ++round) {
+        {
+            auto wt = db->start_write();
+            if (round % 4 == 3) {
+                // Leaves the table alone
+                wt->get_table("other")->create_object().set("value", round);
+            }
+            else {
+                auto t = wt->get_table("table");
+                for (int64_t i = 0; i < 40; ++i) {
+                    auto key = ObjKey((round * 37 + i * 13) % 500);
+                    if (!t->is_valid(key))
+                        continue;
+                    if (i % 5 == 0)
+                        t->remove_object(key);
+                    else
+                        t->get_object(key).add_int(col_value, 1);
+                }
+                for (int64_t i = 0; i < 5; ++i)
+                    t->create_object().set(col_value, round);
+            }
+            wt->commit();
+        }
+        rt->advance_read();
+        versions.push_back(table->get_modification_version());
+        check();
+    }
+}
+
+TEST(Table_FindPrimaryKeys)
+{
+    Group g;
+    TableRef table = g.add_table_with_primary_key("table", type_String, "pk", true);
+    std::vector<Mixed> pks;
+    std::vector<std::string> strings;
+    for (int i = 0; i < 500; ++i)
+        strings.push_back("key_" + util::to_string(i * 31 % 500));
+    for (int i = 0; i < 500; ++i) {
+        if (i % 3)
+            table->create_object_with_primary_key(StringData(strings[i]));
+        pks.push_back(StringData(strings[i]));
+        // Duplicates
+        if (i % 10 == 0)
+            pks.push_back(StringData(strings[i]));
+    }
+    pks.push_back(StringData("missing"));
+    pks.push_back(Mixed());
+    table->create_object_with_primary_key(Mixed());
+
+    auto keys = table->find_primary_keys(pks);
+    CHECK_EQUAL(keys.size(), pks.size());
+    for (size_t i = 0; i < pks.size(); ++i)
+        CHECK_EQUAL(keys[i], table->find_primary_key(pks[i]));
+    CHECK_NOT(keys[pks.size() - 2]);
+    CHECK(keys.back());
+    CHECK(table->find_primary_keys({}).empty());
+}
+
 TEST(Table_PrimaryKeyString)
 {
 #ifdef REALM_DEBUG
@@ -5490,6 +6139,46 @@ TEST(Table_EmbeddedObjectCreateAndDestroyList)
     tr->commit();
 }
 
+TEST(Table_EmbeddedObjectRemoveMany)
+{
+    SHARED_GROUP_TEST_PATH(path);
+
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path, DBOptions(crypt_key()));
+
+    auto tr = sg->start_write();
+    auto table = tr->add_table("myEmbeddedStuff", Table::Type::Embedded);
+    auto col_value = table->add_column(type_Int, "value");
+    table->add_search_index(col_value);
+    auto parent = tr->add_table("myParentStuff");
+    auto ck = parent->add_column_list(*table, "theGreatColumn");
+    std::vector<ObjKey> parent_keys;
+    for (int64_t i = 0; i < 100; ++i) {
+        Obj o = parent->create_object();
+        parent_keys.push_back(o.get_key());
+        auto ll = o.get_linklist(ck);
+        for (int64_t j = 0; j < 20; ++j)
+            ll.create_and_insert_linked_object(ll.size()).set(col_value, i);
+    }
+    tr->commit_and_continue_as_read();
+
+    tr->promote_to_write();
+    // A few parents: the index entries of their children are erased one by one
+    parent->remove_object(parent_keys[0]);
+    parent->remove_objects({parent_keys[1], parent_keys[2]});
+    CHECK_EQUAL(table->size(), 97 * 20);
+    // Most parents: the index is rebuilt from the children left
+    std::vector<ObjKey> keys(parent_keys.begin() + 3, parent_keys.begin() + 90);
+    parent->remove_objects(keys);
+    CHECK_EQUAL(table->size(), 10 * 20);
+    for (int64_t i = 0; i < 100; ++i)
+        CHECK_EQUAL(table->where().equal(col_value, i).count(), i < 90 ? 0 : 20);
+    for (auto& o : *parent)
+        CHECK_EQUAL(o.get_linklist(ck).size(), 20);
+    tr->commit_and_continue_as_read();
+    tr->verify();
+}
+
 TEST(Table_EmbeddedObjectCreateAndDestroyDictionary)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -5908,4 +6597,184 @@ TEST(Table_AsymmetricObjects)
     tr->commit();
 }
 
+TEST(Table_NodeSizes)
+{
+    SHARED_GROUP_TEST_PATH(path);
+
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path, DBOptions(crypt_key()));
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+
+    auto tr = sg->start_write();
+    auto table = tr->add_table("mytable");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_list = table->add_column_list(type_Int, "list");
+    CHECK_EQUAL(table->get_cluster_node_size(), ClusterNode::default_cluster_node_size);
+    CHECK_EQUAL(table->get_collection_node_size(), REALM_MAX_BPNODE_SIZE);
+
+    CHECK_THROW(table->set_node_sizes(2, 0), std::invalid_argument);
+    CHECK_THROW(table->set_node_sizes(0, Table::max_node_size + 1), std::invalid_argument);
+    table->set_node_sizes(10, 5);
+    CHECK_EQUAL(table->get_cluster_node_size(), 10);
+    CHECK_EQUAL(table->get_collection_node_size(), 5);
+
+    // Sequential keys would give compact inner nodes with the default size
+    std::vector<ObjKey> keys;
+    table->create_objects(500, keys);
+    std::vector<int64_t> random_keys(500);
+    std::iota(random_keys.begin(), random_keys.end(), 1000);
+    random.shuffle(random_keys.begin(), random_keys.end());
+    for (auto k : random_keys) {
+        table->create_object(ObjKey(k)).set(col_int, k);
+    }
+    CHECK_THROW(table->set_node_sizes(0, 0), std::logic_error);
+
+    auto list = table->get_object(keys[0]).get_list<Int>(col_list);
+    for (int i = 0; i < 100; ++i) {
+        list.insert(random.draw_int_mod(list.size() + 1), i);
+    }
+    CHECK_EQUAL(list.size(), 100);
+    tr->commit();
+
+    tr = sg->start_read();
+    table = tr->get_table("mytable");
+    CHECK_EQUAL(table->get_cluster_node_size(), 10);
+    CHECK_EQUAL(table->get_collection_node_size(), 5);
+    tr->verify();
+    auto list2 = table->get_object(keys[0]).get_list<Int>(col_list);
+    int64_t sum = 0;
+    for (auto v : list2)
+        sum += v;
+    CHECK_EQUAL(sum, 99 * 100 / 2);
+
+    tr->promote_to_write();
+    for (size_t i = 0; i < keys.size(); i += 2)
+        table->remove_object(keys[i]);
+    while (list2.size() > 10)
+        list2.remove(random.draw_int_mod(list2.size()));
+    tr->verify();
+    table->clear();
+    table->set_node_sizes(0, 0);
+    CHECK_EQUAL(table->get_cluster_node_size(), ClusterNode::default_cluster_node_size);
+    CHECK_EQUAL(table->get_collection_node_size(), REALM_MAX_BPNODE_SIZE);
+    tr->commit();
+}
+
+TEST(Table_LookupLeafCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+
+    const int64_t key_range = 20000;
+    std::set<int64_t> present;
+    auto tr = sg->start_write();
+    auto table = tr->add_table("table");
+    auto col_int = table->add_column(type_Int, "int");
+    auto col_link = table->add_column(*table, "link");
+    for (int i = 0; i < 5000; ++i) {
+        int64_t k = random.draw_int_mod(key_range);
+        if (present.insert(k).second)
+            table->create_object(ObjKey(k)).set(col_int, k);
+    }
+
+    auto check_lookups = [&](ConstTableRef t) {
+        for (int i = 0; i < 2000; ++i) {
+            int64_t k = random.draw_int_mod(key_range);
+            bool exists = present.count(k) != 0;
+            CHECK_EQUAL(t->is_valid(ObjKey(k)), exists);
+            auto obj = t->try_get_object(ObjKey(k));
+            CHECK_EQUAL(bool(obj), exists);
+            if (exists)
+                CHECK_EQUAL(obj.get<Int>(col_int), k);
+            else
+                CHECK_THROW(t->get_object(ObjKey(k)), KeyNotFound);
+        }
+    };
+    check_lookups(table);
+
+    // Lookups interleaved with changes to the leaves
+    for (int i = 0; i < 1000; ++i) {
+        int64_t k = random.draw_int_mod(key_range);
+        if (present.count(k)) {
+            table->remove_object(ObjKey(k));
+            present.erase(k);
+            CHECK_NOT(table->is_valid(ObjKey(k)));
+        }
+        else {
+            table->create_object(ObjKey(k)).set(col_int, k);
+            present.insert(k);
+            CHECK_EQUAL(table->get_object(ObjKey(k)).get<Int>(col_int), k);
+        }
+    }
+    check_lookups(table);
+
+    // Link traversal
+    std::vector<int64_t> keys(present.begin(), present.end());
+    for (size_t i = 0; i < keys.size(); ++i)
+        table->get_object(ObjKey(keys[i])).set(col_link, ObjKey(keys[(i * 7) % keys.size()]));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto target = table->get_object(ObjKey(keys[i])).get_linked_object(col_link);
+        CHECK_EQUAL(target.get<Int>(col_int), keys[(i * 7) % keys.size()]);
+    }
+    tr->commit_and_continue_as_read();
+    check_lookups(table);
+
+    auto frozen = tr->freeze();
+    check_lookups(frozen->get_table("table"));
+
+    // The cache must not survive a rollback
+    tr->promote_to_write();
+    for (int64_t k : keys)
+        table->remove_object(ObjKey(k));
+    CHECK_EQUAL(table->size(), 0);
+    tr->rollback_and_continue_as_read();
+    CHECK_EQUAL(table->size(), keys.size());
+    check_lookups(table);
+}
+
+TEST(Table_TraverseWithScanHint)
+{
+    SHARED_GROUP_TEST_PATH(path);
+
+    DBRef sg = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    {
+        auto wt = sg->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        table->add_column(type_String, "str");
+        // Small clusters give a tree of several levels
+        table->set_node_sizes(8, 0);
+        for (int64_t i = 0; i < 5000; ++i)
+            table->create_object().set(col, i);
+        wt->commit();
+    }
+
+    auto rt = sg->start_read();
+    auto table = rt->get_table("table");
+    auto col = table->get_column_key("int");
+    auto count_leaves = [&] {
+        size_t objects = 0;
+        int64_t sum = 0;
+        table->traverse_clusters([&](const Cluster* cluster) {
+            ArrayInteger leaf(table->get_alloc());
+            cluster->init_leaf(col, &leaf);
+            for (size_t i = 0; i < cluster->node_size(); ++i)
+                sum += leaf.get(i);
+            objects += cluster->node_size();
+            return false;
+        });
+        CHECK_EQUAL(objects, 5000);
+        CHECK_EQUAL(sum, 4999 * 5000 / 2);
+    };
+    count_leaves();
+    {
+        util::SequentialScanHint scan_hint;
+        count_leaves();
+    }
+    CHECK_EQUAL(table->sum_int(col), 4999 * 5000 / 2);
+    CHECK_EQUAL(table->where().greater(col, 2499).count(), 2500);
+}
+
 #endif // TEST_TABLE
@@ -766,6 +766,48 @@ TEST(TableView_SortNullString)
     CHECK_NOT(tv[3].get<String>(col).is_null());
 }
 
+TEST(TableView_SortStringsByCollation)
+{
+    Table t;
+    auto col_str = t.add_column(type_String, "str", true);
+    auto col_int = t.add_column(type_Int, "int");
+    const char* words[] = {"apple", "Apple", "\xc3\xa9""clair", "eclair", "Zebra", "zebra", "\xc3\x85se", "\xc3\xb8l",
+                           "\xe4\xb8\xad", "", "apples"};
+    for (int i = 0; i < 500; ++i) {
+        auto obj = t.create_object().set(col_int, i % 4);
+        if (i % 13)
+            obj.set(col_str, StringData(words[i * 7 % 11]));
+    }
+
+    auto check = [&](TableView& tv, bool ascending, bool by_int) {
+        std::vector<Obj> expected;
+        for (auto& obj : t)
+            expected.push_back(obj);
+        std::stable_sort(expected.begin(), expected.end(), [&](const Obj& a, const Obj& b) {
+            StringData sa = a.get<String>(col_str);
+            StringData sb = b.get<String>(col_str);
+            if (sa != sb || sa.is_null() != sb.is_null()) {
+                bool less = sa.is_null() || (!sb.is_null() && utf8_compare(sa, sb));
+                return ascending ? less : !less;
+            }
+            return by_int && a.get<Int>(col_int) < b.get<Int>(col_int);
+        });
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected[i].get_key());
+    };
+
+    auto tv = t.where().find_all();
+    tv.sort(col_str);
+    check(tv, true, false);
+    tv = t.where().find_all();
+    tv.sort(col_str, false);
+    check(tv, false, false);
+    tv = t.where().find_all();
+    tv.sort(SortDescriptor({{col_str}, {col_int}}));
+    check(tv, true, true);
+}
+
 TEST(TableView_Clear)
 {
     Table table;
@@ -1105,6 +1147,64 @@ TEST(TableView_SortOverLink)
     CHECK_EQUAL(tv[2].get<Int>(col_int), 3);
 }
 
+TEST(TableView_SortOverLinkSeveralColumns)
+{
+    Group g;
+    TableRef target = g.add_table("target");
+    TableRef origin = g.add_table("origin");
+    auto col_name = target->add_column(type_String, "name");
+    auto col_age = target->add_column(type_Int, "age");
+    auto col_link = origin->add_column(*target, "link");
+    auto col_int = origin->add_column(type_Int, "int");
+
+    std::vector<ObjKey> targets;
+    for (int i = 0; i < 50; ++i) {
+        auto name = std::string(1, char('a' + i % 5));
+        targets.push_back(target->create_object().set(col_name, name).set(col_age, i * 7 % 10).get_key());
+    }
+    for (int i = 0; i < 3000; ++i) {
+        auto obj = origin->create_object().set(col_int, i % 3);
+        if (i % 17)
+            obj.set(col_link, targets[i * 31 % 50]);
+    }
+
+    // Null links come last, as the first column is ascending
+    auto compare_links = [&](const Obj& a, const Obj& b) {
+        bool null_a = a.is_null(col_link);
+        bool null_b = b.is_null(col_link);
+        if (null_a || null_b)
+            return int(null_a) - int(null_b);
+        auto target_a = a.get_linked_object(col_link);
+        auto target_b = b.get_linked_object(col_link);
+        int c = target_a.get_any(col_name).compare(target_b.get_any(col_name));
+        return c ? c : -target_a.get_any(col_age).compare(target_b.get_any(col_age));
+    };
+
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_link, col_name}, {col_link, col_age}, {col_int}}, {true, false, true}));
+    auto tv = origin->where().find_all(ordering);
+    CHECK_EQUAL(tv.size(), 3000);
+    for (size_t i = 1; i < tv.size(); ++i) {
+        auto a = tv.get_object(i - 1);
+        auto b = tv.get_object(i);
+        int c = compare_links(a, b);
+        if (c == 0)
+            c = a.get<Int>(col_int) < b.get<Int>(col_int) ? -1 : a.get<Int>(col_int) > b.get<Int>(col_int);
+        if (c == 0)
+            c = a.get_key() < b.get_key() ? -1 : 1;
+        CHECK_LESS(c, 0);
+    }
+
+    // After a distinct the objects are no longer at consecutive positions in the view
+    DescriptorOrdering distinct_first;
+    distinct_first.append_distinct(DistinctDescriptor({{col_int}, {col_link, col_age}}));
+    distinct_first.append_sort(SortDescriptor({{col_link, col_name}, {col_link, col_age}}, {true, false}));
+    tv = origin->where().find_all(distinct_first);
+    CHECK_EQUAL(tv.size(), 30);
+    for (size_t i = 1; i < tv.size(); ++i)
+        CHECK_LESS_EQUAL(compare_links(tv.get_object(i - 1), tv.get_object(i)), 0);
+}
+
 TEST(TableView_SortOverMultiLink)
 {
     Group g;
@@ -1426,6 +1526,56 @@ TEST(TableView_DistinctOverNullLink)
     CHECK_EQUAL(tv.get_object(1).get_linked_object(col_link).get<Int>(col_int), 1);
 }
 
+TEST(TableView_DistinctKeepsFirstOccurrence)
+{
+    Table t;
+    auto col_str = t.add_column(type_String, "str", true);
+    auto col_int = t.add_column(type_Int, "int");
+    auto col_double = t.add_column(type_Double, "double");
+    for (int i = 0; i < 1000; ++i) {
+        auto obj = t.create_object().set(col_int, i);
+        if (i % 11)
+            obj.set(col_str, util::to_string(i * 7 % 23));
+        obj.set(col_double, i % 3 ? 0.0 : -0.0);
+    }
+
+    // Distinct values in the order they first occur, with the object where they do
+    auto check = [&](TableView& tv, std::function<int(int)> position) {
+        std::vector<Mixed> seen;
+        std::vector<int64_t> expected;
+        for (int i = 0; i < 1000; ++i) {
+            int n = position(i);
+            Mixed value = t.get_object(n).get_any(col_str);
+            if (std::find(seen.begin(), seen.end(), value) == seen.end()) {
+                seen.push_back(value);
+                expected.push_back(n);
+            }
+        }
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_object(i).get<Int>(col_int), expected[i]);
+    };
+
+    auto tv = t.where().find_all();
+    tv.distinct(col_str);
+    CHECK_EQUAL(tv.size(), 24); // 23 strings and null
+    check(tv, [](int i) {
+        return i;
+    });
+
+    tv = t.where().find_all();
+    tv.sort(col_int, false);
+    tv.distinct(col_str);
+    check(tv, [](int i) {
+        return 999 - i;
+    });
+
+    // 0.0 and -0.0 are the same value
+    tv = t.where().find_all();
+    tv.distinct(col_double);
+    CHECK_EQUAL(tv.size(), 1);
+}
+
 TEST(TableView_IsRowAttachedAfterClear)
 {
     Table t;
@@ -931,6 +931,48 @@ TEST_IF(Thread_CondvarAtomicWaitUnlock, !running_with_valgrind && TEST_DURATION
     }
 }
 
+// Waiters for tickets are woken in the order of the tickets notified
+NONCONCURRENT_TEST(Thread_CondvarTickets)
+{
+    InterprocessMutex mutex;
+    InterprocessMutex::SharedPart mutex_part;
+    InterprocessCondVar changed;
+    InterprocessCondVar::SharedPart condvar_part;
+    InterprocessCondVar::init_shared_part(condvar_part);
+    TEST_PATH(path);
+    DBOptions default_options;
+    mutex.set_shared_part(mutex_part, path, "Thread_CondvarTickets_Mutex");
+    changed.set_shared_part(condvar_part, path, "Thread_CondvarTickets_CondVar", default_options.temp_dir);
+
+    const uint32_t num_waiters = 8;
+    uint32_t turn = 0;
+    std::vector<uint32_t> served;
+    std::vector<std::thread> waiters;
+    for (uint32_t ticket = num_waiters; ticket > 0; --ticket) {
+        waiters.emplace_back([&, ticket] {
+            std::lock_guard<InterprocessMutex> l(mutex);
+            while (turn != ticket)
+                changed.wait_for_ticket(mutex, nullptr, ticket);
+            served.push_back(ticket);
+            ++turn;
+            changed.notify_ticket(turn);
+        });
+    }
+    {
+        std::lock_guard<InterprocessMutex> l(mutex);
+        turn = 1;
+        changed.notify_ticket(turn);
+    }
+    for (auto& waiter : waiters)
+        waiter.join();
+
+    CHECK_EQUAL(served.size(), num_waiters);
+    for (uint32_t i = 0; i < served.size(); ++i)
+        CHECK_EQUAL(served[i], i + 1);
+    changed.release_shared_part();
+    mutex.release_shared_part();
+}
+
 NONCONCURRENT_TEST(Thread_Condvar_CreateDestroyDifferentThreads)
 {
     auto cv = std::make_unique<InterprocessCondVar>();
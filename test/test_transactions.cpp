@@ -545,6 +545,135 @@ TEST(Transactions_Continuous_SerialWrites)
 }
 
 
+TEST(Transactions_PromoteToWriteIfUnchanged)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path);
+
+    TableKey accounts_key, log_key;
+    ColKey col_balance;
+    ObjKey alice, bob;
+    {
+        TransactionRef tr = sg->start_write();
+        auto accounts = tr->add_table("accounts");
+        col_balance = accounts->add_column(type_Int, "balance");
+        alice = accounts->create_object().set(col_balance, 10).get_key();
+        bob = accounts->create_object().set(col_balance, 20).get_key();
+        accounts_key = accounts->get_key();
+        log_key = tr->add_table("log")->get_key();
+        tr->commit();
+    }
+    auto write = [&](auto func) {
+        TransactionRef tr = sg->start_write();
+        func(*tr);
+        tr->commit();
+    };
+
+    Transaction::ReadSet read_set;
+    read_set.objects.insert({accounts_key, alice});
+
+    // Changes to other objects and tables do not conflict
+    TransactionRef tr = sg->start_read();
+    write([&](Transaction& t) {
+        t.get_table(accounts_key)->get_object(bob).set(col_balance, 30);
+        t.get_table(log_key)->create_object();
+    });
+    CHECK(tr->promote_to_write_if_unchanged(read_set));
+    CHECK_EQUAL(tr->get_transact_stage(), DB::transact_Writing);
+    CHECK_EQUAL(tr->get_table(accounts_key)->get_object(bob).get<Int>(col_balance), 30);
+    tr->get_table(accounts_key)->get_object(alice).set(col_balance, 11);
+    tr->commit_and_continue_as_read();
+
+    // A change to an object read conflicts, and leaves the transaction reading the latest version
+    write([&](Transaction& t) {
+        t.get_table(accounts_key)->get_object(alice).set(col_balance, 12);
+    });
+    CHECK_NOT(tr->promote_to_write_if_unchanged(read_set));
+    CHECK_EQUAL(tr->get_transact_stage(), DB::transact_Reading);
+    CHECK_EQUAL(tr->get_table(accounts_key)->get_object(alice).get<Int>(col_balance), 12);
+    CHECK(tr->promote_to_write_if_unchanged(read_set));
+    tr->rollback_and_continue_as_read();
+
+    // Creating an object conflicts with a read of the whole table
+    read_set.tables.insert(log_key);
+    write([&](Transaction& t) {
+        t.get_table(log_key)->create_object();
+    });
+    CHECK_NOT(tr->promote_to_write_if_unchanged(read_set));
+    CHECK_EQUAL(tr->get_table(log_key)->size(), 2);
+
+    // Schema changes conflict with reads of any object in the table
+    read_set.tables.clear();
+    write([&](Transaction& t) {
+        t.get_table(accounts_key)->add_column(type_String, "name");
+    });
+    CHECK_NOT(tr->promote_to_write_if_unchanged(read_set));
+
+    // The write lock is released on a conflict
+    write([&](Transaction& t) {
+        t.get_table(accounts_key)->remove_object(alice);
+    });
+    CHECK_NOT(tr->promote_to_write_if_unchanged(read_set));
+    TransactionRef other = sg->start_write(true);
+    CHECK(other);
+}
+
+
+TEST(Transactions_AdvanceReadKeepsUnchangedTables)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history());
+    DBRef sg = DB::create(*hist, path);
+
+    ColKey col_static, col_changing;
+    {
+        TransactionRef tr = sg->start_write();
+        auto static_table = tr->add_table("static");
+        col_static = static_table->add_column(type_String, "name");
+        static_table->add_search_index(col_static);
+        for (int i = 0; i < 100; ++i)
+            static_table->create_object().set(col_static, util::format("name %1", i));
+        col_changing = tr->add_table("changing")->add_column(type_Int, "value");
+        tr->commit();
+    }
+
+    TransactionRef rt = sg->start_read();
+    auto static_table = rt->get_table("static");
+    auto changing = rt->get_table("changing");
+    Obj first = static_table->get_object(0);
+    CHECK_EQUAL(changing->size(), 0);
+
+    // Enough changes to make the file grow and be remapped on the way
+    for (int i = 0; i < 10; ++i) {
+        {
+            TransactionRef wt = sg->start_write();
+            auto table = wt->get_table("changing");
+            for (int j = 0; j < 1000; ++j)
+                table->create_object().set(col_changing, i * 1000 + j);
+            wt->commit();
+        }
+        rt->advance_read();
+        CHECK_EQUAL(changing->size(), (i + 1) * 1000);
+        CHECK_EQUAL(changing->get_object(i * 1000).get<Int>(col_changing), i * 1000);
+        CHECK_EQUAL(static_table->size(), 100);
+        CHECK_EQUAL(first.get<String>(col_static), "name 0");
+        CHECK_EQUAL(static_table->find_first_string(col_static, "name 42"), static_table->get_object(42).get_key());
+    }
+
+    // A change to the unchanged table is still picked up
+    {
+        TransactionRef wt = sg->start_write();
+        wt->get_table("static")->get_object(0).set(col_static, "renamed");
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(first.get<String>(col_static), "renamed");
+    CHECK_EQUAL(static_table->find_first_string(col_static, "renamed"), first.get_key());
+    rt->verify();
+}
+
+
 // Check that enumeration is gone after
 // rolling back the insertion of a string enum column
 TEST(LangBindHelper_RollbackStringEnumInsert)
@@ -997,6 +997,66 @@ TEST(Transform_Randomized)
     }
 }
 
+TEST(Transform_ConcurrentConflictGroups)
+{
+    // Both clients modify the same set of objects, producing one conflict
+    // group per object. Merging the groups on several threads must produce
+    // the same state as the single-threaded merge.
+    auto schema = [](WriteTransaction& tr) {
+        TableRef t = tr.get_group().add_table_with_primary_key("class_t", type_Int, "pk");
+        t->add_column(type_Int, "i");
+        t->add_column(type_String, "s");
+        t->add_column_list(type_Int, "l");
+    };
+
+    auto modify = [](Peer& peer, int64_t offset) {
+        TableRef t = peer.table("class_t");
+        for (int64_t pk = 0; pk < 32; ++pk) {
+            Obj obj = t->create_object_with_primary_key(pk);
+            obj.set("i", pk + offset);
+            obj.set("s", "client " + std::to_string(offset) + " object " + std::to_string(pk));
+            auto list = obj.get_list<Int>("l");
+            for (int64_t j = 0; j < 4; ++j)
+                list.insert(0, offset + j);
+        }
+    };
+
+    auto run = [&](size_t max_threads, const std::string& path_add_on) {
+        auto server = Peer::create_server(test_context, nullptr, path_add_on);
+        auto client_1 = Peer::create_client(test_context, 2, nullptr, path_add_on);
+        auto client_2 = Peer::create_client(test_context, 3, nullptr, path_add_on);
+        for (Peer* peer : {server.get(), client_1.get(), client_2.get()})
+            peer->history.set_transform_max_threads(max_threads);
+
+        client_1->create_schema(schema);
+        client_2->create_schema(schema);
+        synchronize(server.get(), {client_1.get(), client_2.get()});
+
+        client_1->transaction([&](Peer& c1) {
+            modify(c1, 100);
+        });
+        client_2->transaction([&](Peer& c2) {
+            modify(c2, 200);
+        });
+        synchronize(server.get(), {client_1.get(), client_2.get()});
+
+        ReadTransaction read_server(server->shared_group);
+        ReadTransaction read_client_1(client_1->shared_group);
+        ReadTransaction read_client_2(client_2->shared_group);
+        CHECK(compare_groups(read_server, read_client_1));
+        CHECK(compare_groups(read_server, read_client_2));
+        CHECK_EQUAL(read_server.get_table("class_t")->size(), 32);
+        return server;
+    };
+
+    auto sequential = run(1, ".sequential");
+    auto concurrent = run(4, ".concurrent");
+
+    ReadTransaction read_sequential(sequential->shared_group);
+    ReadTransaction read_concurrent(concurrent->shared_group);
+    CHECK(compare_groups(read_sequential, read_concurrent));
+}
+
 namespace {
 
 void integrate_changesets(Peer* peer_to, Peer* peer_from)
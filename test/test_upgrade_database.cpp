@@ -36,6 +36,7 @@
 #include <realm/version.hpp>
 #include "test.hpp"
 #include "test_table_helper.hpp"
+#include "util/compare_groups.hpp"
 
 #include <external/json/json.hpp>
 
@@ -1833,6 +1834,35 @@ TEST(Upgrade_progress)
     }
 }
 
+TEST_IF(Upgrade_Chunked, REALM_MAX_BPNODE_SIZE == 4 || REALM_MAX_BPNODE_SIZE == 1000)
+{
+    std::string path = test_util::get_test_resource_path() + "test_upgrade_database_" +
+                       util::to_string(REALM_MAX_BPNODE_SIZE) + "_9_to_10.realm";
+    CHECK_OR_RETURN(File::exists(path));
+    SHARED_GROUP_TEST_PATH(temp_copy_1);
+    SHARED_GROUP_TEST_PATH(temp_copy_2);
+    File::copy(path, temp_copy_1);
+    File::copy(path, temp_copy_2);
+
+    // Migrating a few objects per commit gives the same result as migrating
+    // each table in one go
+    auto hist_1 = make_in_realm_history();
+    DBOptions options;
+    options.file_format_upgrade_chunk_size = 0;
+    auto db_1 = DB::create(*hist_1, temp_copy_1, options);
+    auto hist_2 = make_in_realm_history();
+    options.file_format_upgrade_chunk_size = 7;
+    auto db_2 = DB::create(*hist_2, temp_copy_2, options);
+
+    auto rt_1 = db_1->start_read();
+    auto rt_2 = db_2->start_read();
+    rt_2->verify();
+    CHECK_NOT(rt_2->has_table("!UPDATE_PROGRESS"));
+    CHECK_GREATER(rt_2->get_table("table")->size(), 7);
+    CHECK(test_util::compare_groups(*rt_1, *rt_2));
+    CHECK_GREATER(rt_2->get_version(), rt_1->get_version());
+}
+
 TEST(Upgrade_FixColumnKeys)
 {
     SHARED_GROUP_TEST_PATH(temp_copy);
@@ -24,6 +24,7 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include <random>
 
 #include <realm/util/assert.hpp>
 #include <memory>
@@ -546,4 +547,97 @@ TEST(UTF8_TranscodeUtf16)
 
 #endif // _WIN32
 
+TEST(UTF8_TokenizeWords)
+{
+    using words = std::vector<std::string>;
+    CHECK(tokenize_words("") == words());
+    CHECK(tokenize_words(" ,.!") == words());
+    CHECK(tokenize_words("Hello, world! HELLO again") == words({"again", "hello", "world"}));
+    CHECK(tokenize_words("route66 is 4-lane") == words({"4", "is", "lane", "route66"}));
+    // Non-ASCII letters are part of words, their case is kept
+    CHECK(tokenize_words("R\xc3\xb8""dgr\xc3\xb8""d med fl\xc3\xb8""de") ==
+          words({"fl\xc3\xb8""de", "med", "r\xc3\xb8""dgr\xc3\xb8""d"}));
+    CHECK(tokenize_words("\xc3\x86""BLE") == words({"\xc3\x86""ble"}));
+    // General punctuation and Latin-1 symbols separate words
+    CHECK(tokenize_words("\xe2\x80\x9cquoted\xe2\x80\x9d\xc2\xa0text\xc2\xbfno\xc3\x97") ==
+          words({"no", "quoted", "text"}));
+    // A truncated sequence at the end separates too
+    CHECK(tokenize_words("word\xc3") == words({"word"}));
+}
+
+TEST(UTF8_SearchCaseFold)
+{
+    auto naive_search = [](StringData haystack, const std::string& upper, const std::string& lower) {
+        for (size_t i = 0; i + upper.size() <= haystack.size(); ++i) {
+            if (equal_case_fold(haystack.substr(i, upper.size()), upper.c_str(), lower.c_str()))
+                return i;
+        }
+        return haystack.size();
+    };
+
+    const char* needles[] = {"a", "Ab", "xyz", "\xc3\x86""ble", "needle in", "Q"};
+    const char* fillers[] = {"a", "b", "X", "Y", "z", " ", "\xc3\xa6", "\xc3\x86", "ble", "BLE", "Needle ", "iN"};
+    std::mt19937 random(42);
+    for (auto needle : needles) {
+        std::string upper = case_map(needle, true, IgnoreErrors);
+        std::string lower = case_map(needle, false, IgnoreErrors);
+        // As built by StringNode<ContainsIns>
+        std::array<uint8_t, 256> charmap{};
+        for (size_t i = 0; i + 1 < upper.size(); ++i) {
+            charmap[static_cast<unsigned char>(upper[i])] = uint8_t(upper.size() - 1 - i);
+            charmap[static_cast<unsigned char>(lower[i])] = uint8_t(upper.size() - 1 - i);
+        }
+        for (int iter = 0; iter < 300; ++iter) {
+            // Haystacks long enough to be scanned with vector instructions and
+            // matches placed across the vector boundaries
+            std::string haystack;
+            size_t nb_parts = random() % 40;
+            for (size_t i = 0; i < nb_parts; ++i)
+                haystack += fillers[random() % (sizeof(fillers) / sizeof(fillers[0]))];
+            if (iter % 2)
+                haystack.insert(random() % (haystack.size() + 1), iter % 4 == 1 ? upper : lower);
+            size_t expected = naive_search(haystack, upper, lower);
+            CHECK_EQUAL(search_case_fold(haystack, upper.c_str(), lower.c_str(), upper.size()), expected);
+            CHECK_EQUAL(contains_ins(haystack, upper.c_str(), lower.c_str(), upper.size(), charmap),
+                        expected != haystack.size());
+        }
+    }
+}
+
+NONCONCURRENT_TEST(UTF8_SortKey)
+{
+    // Latin, Latin-1, Latin Extended, CJK and a 4 byte sequence
+    const char* parts[] = {"a", "b", "A", "Z", "0", " ", "-", "\xc3\xa9", "\xc3\x89", "\xc3\xb8", "\xc3\x85",
+                           "\xc3\x9f", "\xc5\xbe", "\xe4\xb8\xad", "\xf0\x9f\x98\x80"};
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    auto make_string = [&] {
+        std::string str;
+        int n = random.draw_int_mod(6);
+        for (int i = 0; i < n; ++i)
+            str += parts[random.draw_int_mod(15)];
+        return str;
+    };
+
+    for (auto method : {STRING_COMPARE_CORE_SIMILAR, STRING_COMPARE_CORE}) {
+        set_string_compare_method(method, nullptr);
+        for (int i = 0; i < 10000; ++i) {
+            std::string a = make_string();
+            std::string b = make_string();
+            std::string key_a;
+            std::string key_b;
+            CHECK(utf8_sort_key(a, key_a));
+            CHECK(utf8_sort_key(b, key_b));
+            CHECK_EQUAL(utf8_compare(a, b), key_a < key_b);
+            CHECK_EQUAL(a == b, key_a == key_b);
+        }
+    }
+
+    set_string_compare_method(STRING_COMPARE_CALLBACK, [](const char*, const char*) {
+        return false;
+    });
+    std::string key;
+    CHECK_NOT(utf8_sort_key("a", key));
+    set_string_compare_method(STRING_COMPARE_CORE, nullptr);
+}
+
 #endif // TEST_UTF8
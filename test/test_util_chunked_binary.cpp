@@ -143,3 +143,44 @@ TEST(ChunkedBinaryData_From_NullableBinaryColumn)
 
     bc.destroy();
 }
+
+TEST(ChunkedBinaryData_BinaryList)
+{
+    Group g;
+    auto table = g.add_table("table");
+    auto col = table->add_column_list(type_Binary, "blob");
+    Obj obj = table->create_object();
+
+    // Larger than a single binary value can be
+    size_t size = Table::max_binary_size + 1000;
+    std::string str(size, 'a');
+    for (size_t i = 0; i < size; i += 997)
+        str[i] = char('b' + i % 20);
+
+    BinaryListWriter writer(obj.get_list<BinaryData>(col), 100000);
+    writer.write(str.data(), 10);
+    writer.write(str.data() + 10, 250000);
+    writer.write(str.data() + 250010, size - 250010);
+    writer.flush();
+    auto list = obj.get_list<BinaryData>(col);
+    CHECK_EQUAL(list.size(), (size + 99999) / 100000);
+    CHECK_EQUAL(list.get(0).size(), 100000);
+
+    BinaryListInputStream in(list);
+    CHECK_EQUAL(in.size(), size);
+    std::string read;
+    util::Span<const char> block;
+    while ((block = in.next_block()).size() > 0)
+        read.append(block.data(), block.size());
+    CHECK(read == str);
+
+    char buffer[300];
+    CHECK_EQUAL(in.read_at(99900, buffer, sizeof(buffer)), sizeof(buffer));
+    CHECK(std::string(buffer, sizeof(buffer)) == str.substr(99900, sizeof(buffer)));
+    CHECK_EQUAL(in.read_at(size - 100, buffer, sizeof(buffer)), 100);
+    CHECK(std::string(buffer, 100) == str.substr(size - 100));
+    CHECK_EQUAL(in.read_at(size, buffer, sizeof(buffer)), 0);
+
+    CHECK_THROW(BinaryListWriter(list, 0), LogicError);
+    CHECK_THROW(BinaryListWriter(list, Table::max_binary_size + 1), LogicError);
+}
@@ -277,6 +277,28 @@ void for_each_fib_block_size(size_t size, Span<const char> input, FunctionRef<vo
 }
 } // anonymous namespace
 
+// The arena is shared by compression and decompression of consecutive
+// messages, like the sync protocol does.
+TEST(Compression_Decompress_With_Arena)
+{
+    compression::CompressMemoryArena arena;
+    for (size_t uncompressed_size : {size_t(1) << 20, size_t(100), size_t(100000)}) {
+        auto uncompressed_buf = generate_compressible_data(uncompressed_size);
+        std::vector<char> compressed_buf;
+        auto ec = compression::allocate_and_compress(arena, uncompressed_buf, compressed_buf);
+        CHECK_NOT(ec);
+
+        Buffer<char> decompressed_buf(uncompressed_size);
+        ec = compression::decompress(arena, compressed_buf, decompressed_buf);
+        CHECK_NOT(ec);
+        compare(test_context, uncompressed_buf, decompressed_buf);
+
+        compressed_buf[compressed_buf.size() / 2] ^= 0x55;
+        ec = compression::decompress(arena, compressed_buf, decompressed_buf);
+        CHECK(ec);
+    }
+}
+
 TEST(Compression_Decompress_Stream_SmallBlocks)
 {
     size_t uncompressed_size = 10000;
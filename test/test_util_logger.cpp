@@ -16,7 +16,9 @@
  *
  **************************************************************************/
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <locale>
 
@@ -230,6 +232,54 @@ TEST(Util_Logger_ThreadSafe)
     CHECK(messages_1 == messages_2);
 }
 
+TEST(Util_Logger_Async)
+{
+    // Blocks in do_log() until the gate is opened
+    struct GatedLogger : public util::RootLogger {
+        std::mutex gate;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool entered = false;
+        std::vector<std::string> messages;
+        void do_log(util::Logger::Level, std::string const& message) override
+        {
+            {
+                std::lock_guard lock(mutex);
+                entered = true;
+            }
+            cv.notify_all();
+            std::lock_guard lock(gate);
+            messages.push_back(message);
+        }
+    };
+    GatedLogger root_logger;
+    {
+        util::AsyncLogger logger(root_logger, util::Logger::Level::info, 4);
+        std::unique_lock gate(root_logger.gate);
+        logger.info("first");
+        {
+            std::unique_lock lock(root_logger.mutex);
+            root_logger.cv.wait(lock, [&] {
+                return root_logger.entered;
+            });
+        }
+        // The background thread is now blocked, so the queue fills up
+        for (int i = 0; i < 6; ++i)
+            logger.info("%1", i);
+        logger.debug("below the threshold");
+        CHECK_EQUAL(logger.get_dropped_count(), 2);
+
+        gate.unlock();
+        logger.flush();
+        std::vector<std::string> expected = {"first", "0", "1", "2", "3", "2 log messages were dropped"};
+        CHECK(root_logger.messages == expected);
+
+        // Queued messages are written before the logger is destroyed
+        logger.info("last");
+    }
+    CHECK_EQUAL(root_logger.messages.back(), "last");
+}
+
 TEST(Util_HexDump)
 {
     const unsigned char u_char_data[] = {0x00, 0x05, 0x10, 0x17, 0xff};
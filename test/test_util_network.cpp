@@ -253,6 +253,33 @@ TEST(Network_GetSetSocketOption)
 }
 
 
+TEST(Network_ReusePort)
+{
+    network::Service service;
+    network::Acceptor acceptor_1{service}, acceptor_2{service};
+    network::Endpoint ep; // Wildcard
+    acceptor_1.open(ep.protocol());
+    std::error_code ec;
+    acceptor_1.set_option(network::SocketBase::reuse_port(true), ec);
+    if (ec == realm::util::MiscExtErrors::operation_not_supported)
+        return; // No SO_REUSEPORT on this platform
+    CHECK_NOT(ec);
+    network::SocketBase::reuse_port opt_reuse_port;
+    acceptor_1.get_option(opt_reuse_port);
+    CHECK(opt_reuse_port.value());
+    acceptor_1.bind(ep);
+    ep = acceptor_1.local_endpoint(); // Get actual bound endpoint
+    acceptor_1.listen();
+
+    // A second acceptor can bind to the same endpoint when it sets the
+    // option too
+    acceptor_2.open(ep.protocol());
+    acceptor_2.set_option(network::SocketBase::reuse_port(true));
+    acceptor_2.bind(ep);
+    acceptor_2.listen();
+}
+
+
 TEST(Network_AsyncConnectAndAsyncAccept)
 {
     network::Service service;
@@ -494,6 +521,84 @@ TEST(Network_AsyncReadWriteLargeAmount)
 }
 
 
+TEST(Network_AsyncGatherWriteLargeAmount)
+{
+    network::Service service_1;
+    network::Acceptor acceptor{service_1};
+    network::Endpoint listening_endpoint = bind_acceptor(acceptor);
+
+    size_t num_bytes_per_chunk = 1048576 / 2;
+    std::unique_ptr<char[]> chunk(new char[num_bytes_per_chunk]);
+    for (size_t i = 0; i < num_bytes_per_chunk; ++i)
+        chunk[i] = char(i % 127);
+    int num_chunks = 64;
+
+    auto reader = [&] {
+        network::Socket socket_1{service_1};
+        acceptor.accept(socket_1);
+        network::ReadAheadBuffer rab;
+        size_t buffer_size = 8191; // Prime
+        std::unique_ptr<char[]> buffer(new char[buffer_size]);
+        size_t offset_in_chunk = 0;
+        int chunk_index = 0;
+        realm::util::UniqueFunction<void()> read_chunk = [&] {
+            auto handler = [&](std::error_code ec, size_t n) {
+                bool equal = true;
+                for (size_t i = 0; i < n; ++i) {
+                    if (buffer[i] != chunk[offset_in_chunk]) {
+                        equal = false;
+                        break;
+                    }
+                    if (++offset_in_chunk == num_bytes_per_chunk) {
+                        offset_in_chunk = 0;
+                        ++chunk_index;
+                    }
+                }
+                CHECK(equal);
+                if (ec == MiscExtErrors::end_of_input)
+                    return;
+                CHECK_NOT(ec);
+                read_chunk();
+            };
+            socket_1.async_read(buffer.get(), buffer_size, rab, handler);
+        };
+        read_chunk();
+        service_1.run();
+        CHECK_EQUAL(0, offset_in_chunk);
+        CHECK_EQUAL(num_chunks, chunk_index);
+    };
+    ThreadWrapper thread;
+    thread.start(reader);
+
+    // Each chunk is written as a sequence of buffers of varying sizes,
+    // including an empty one.
+    network::Service service_2;
+    network::Socket socket_2{service_2};
+    socket_2.connect(listening_endpoint);
+    std::function<void(int)> write_chunk = [&](int i) {
+        size_t split_1 = size_t(i) * 4099 % num_bytes_per_chunk;
+        size_t split_2 = split_1 + (num_bytes_per_chunk - split_1) / 2;
+        realm::util::Span<const char> buffers[] = {{chunk.get(), split_1},
+                                                   {chunk.get() + split_1, split_2 - split_1},
+                                                   {chunk.get() + split_2, size_t(0)},
+                                                   {chunk.get() + split_2, num_bytes_per_chunk - split_2}};
+        auto handler = [this, i, num_chunks, num_bytes_per_chunk, write_chunk](std::error_code ec, size_t n) {
+            if (CHECK_NOT(ec)) {
+                CHECK_EQUAL(num_bytes_per_chunk, n);
+                if (i + 1 == num_chunks)
+                    return;
+                write_chunk(i + 1);
+            }
+        };
+        socket_2.async_write(buffers, std::move(handler));
+    };
+    write_chunk(0);
+    service_2.run();
+    socket_2.close();
+
+    CHECK_NOT(thread.join());
+}
+
 TEST(Network_SocketAndAcceptorOpen)
 {
     network::Service service_1;
@@ -936,6 +1041,100 @@ TEST(Network_DeadlineTimer)
 }
 
 
+TEST(Network_DeadlineTimer_Order)
+{
+    // Check that expired timers complete in order of expiration time, and in
+    // order of initiation when expiration times are equal, also after some of
+    // them have been canceled
+    network::Service service;
+    Random random{random_int<unsigned long>()}; // Seed from slow global generator
+    const int num_timers = 256;
+    std::vector<std::unique_ptr<network::DeadlineTimer>> timers;
+    std::vector<int> delays; // In seconds into the past
+    std::vector<int> completed;
+    std::vector<bool> canceled(num_timers, false);
+    for (int i = 0; i < num_timers; ++i) {
+        int delay = random.draw_int_mod(16);
+        timers.push_back(std::make_unique<network::DeadlineTimer>(service));
+        timers.back()->async_wait(std::chrono::seconds(-delay), [&, i](std::error_code ec) {
+            if (ec == error::operation_aborted) {
+                canceled[i] = true;
+                return;
+            }
+            CHECK_NOT(ec);
+            completed.push_back(i);
+        });
+        delays.push_back(delay);
+    }
+    std::vector<int> expected;
+    for (int i = 0; i < num_timers; ++i) {
+        if (random.draw_int_mod(3) == 0) {
+            timers[i]->cancel();
+            continue;
+        }
+        expected.push_back(i);
+    }
+    std::stable_sort(expected.begin(), expected.end(), [&](int a, int b) {
+        return delays[a] > delays[b];
+    });
+    service.run();
+    CHECK(completed == expected);
+    for (int i : expected)
+        CHECK_NOT(canceled[i]);
+    CHECK_EQUAL(num_timers - expected.size(), size_t(std::count(canceled.begin(), canceled.end(), true)));
+}
+
+
+TEST(Network_DeadlineTimer_Cascade)
+{
+    // Check that timers far enough into the future to be moved between the
+    // levels of the timer wheel expire on time and in order, and that timers
+    // far beyond the range of the wheel can be canceled
+    using clock = std::chrono::steady_clock;
+    network::Service service;
+    Random random{random_int<unsigned long>()}; // Seed from slow global generator
+    const int num_timers = 64;
+    std::vector<std::unique_ptr<network::DeadlineTimer>> timers;
+    std::vector<clock::time_point> expiration_times;
+    std::vector<clock::time_point> completion_times;
+    std::vector<int> completed;
+    for (int i = 0; i < num_timers; ++i) {
+        auto delay = std::chrono::milliseconds(random.draw_int_mod(600));
+        expiration_times.push_back(clock::now() + delay);
+        timers.push_back(std::make_unique<network::DeadlineTimer>(service));
+        timers.back()->async_wait(delay, [&, i](std::error_code ec) {
+            CHECK_NOT(ec);
+            completed.push_back(i);
+            completion_times.push_back(clock::now());
+        });
+    }
+    bool far_canceled = false;
+    network::DeadlineTimer far_timer{service}, very_far_timer{service};
+    far_timer.async_wait(std::chrono::hours(30), [&](std::error_code ec) {
+        CHECK_EQUAL(error::operation_aborted, ec);
+        very_far_timer.cancel();
+    });
+    very_far_timer.async_wait(std::chrono::hours(10000), [&](std::error_code ec) {
+        CHECK_EQUAL(error::operation_aborted, ec);
+        far_canceled = true;
+    });
+    network::DeadlineTimer cancel_timer{service};
+    cancel_timer.async_wait(std::chrono::milliseconds(700), [&](std::error_code ec) {
+        CHECK_NOT(ec);
+        far_timer.cancel();
+    });
+    service.run();
+    CHECK(far_canceled);
+    CHECK_EQUAL(num_timers, completed.size());
+    for (std::size_t i = 0; i < completed.size(); ++i) {
+        // Each timer was started after its expiration time was sampled
+        CHECK(completion_times[i] >= expiration_times[completed[i]]);
+        if (i > 0)
+            CHECK(expiration_times[completed[i - 1]] <= expiration_times[completed[i]] + std::chrono::milliseconds(1));
+    }
+}
+
+
 /*
 TEST(Network_DeadlineTimer_Special)
 {
@@ -2076,4 +2275,46 @@ TEST(Network_AsyncResolve_Cancellation)
     CHECK(was_called);
 }
 
+
+TEST(Network_Resolve_Cached)
+{
+    network::Service service;
+    network::Resolver resolver{service};
+    network::Resolver::Query query("localhost", "80");
+    network::Resolver::forget_cached(query);
+    network::Endpoint::List endpoints = resolver.resolve(query);
+    CHECK_GREATER(endpoints.size(), 0);
+
+    // A cached result is passed to the completion handler through the event
+    // loop like any other
+    bool was_called = false;
+    auto handler = [&](std::error_code ec, network::Endpoint::List endpoints_2) {
+        CHECK_NOT(ec);
+        CHECK_EQUAL(endpoints_2.size(), endpoints.size());
+        for (std::size_t i = 0; i < std::min(endpoints.size(), endpoints_2.size()); ++i) {
+            CHECK_EQUAL(format("%1", (endpoints.begin() + i)->address()),
+                        format("%1", (endpoints_2.begin() + i)->address()));
+            CHECK_EQUAL((endpoints.begin() + i)->port(), 80);
+        }
+        was_called = true;
+    };
+    resolver.async_resolve(query, std::move(handler));
+    CHECK_NOT(was_called);
+    service.run();
+    CHECK(was_called);
+
+    // Cancellation still applies to an operation completed from the cache
+    was_called = false;
+    resolver.async_resolve(query, [&](std::error_code ec, network::Endpoint::List) {
+        CHECK_EQUAL(error::operation_aborted, ec);
+        was_called = true;
+    });
+    resolver.cancel();
+    service.run();
+    CHECK(was_called);
+
+    network::Resolver::forget_cached(query);
+    CHECK_EQUAL(resolver.resolve(query).size(), endpoints.size());
+}
+
 } // unnamed namespace
@@ -337,6 +337,52 @@ TEST(Util_Network_SSL_ReadWriteShutdown)
 }
 
 
+TEST(Util_Network_SSL_SessionResumption)
+{
+    network::ssl::Context server_ssl_context;
+    configure_server_ssl_context_for_test(server_ssl_context);
+    network::ssl::SessionCache session_cache;
+
+    // The client uses a new context for each connection, as the sync client
+    // does, so it is the session cache that lets the second handshake resume
+    // the first session
+    for (int i = 0; i < 2; ++i) {
+        network::Service service_1, service_2;
+        network::Socket socket_1{service_1}, socket_2{service_2};
+        network::ssl::Context client_ssl_context;
+        network::ssl::Stream ssl_stream_1{socket_1, server_ssl_context, network::ssl::Stream::server};
+        network::ssl::Stream ssl_stream_2{socket_2, client_ssl_context, network::ssl::Stream::client};
+        ssl_stream_1.set_logger(&test_context.logger);
+        ssl_stream_2.set_logger(&test_context.logger);
+        ssl_stream_2.set_session_cache(session_cache, "localhost:0");
+        connect_ssl_streams(ssl_stream_1, ssl_stream_2);
+#if REALM_HAVE_OPENSSL
+        CHECK_EQUAL(i == 1, ssl_stream_2.is_session_reused());
+#endif
+
+        // With TLS 1.3, the session ticket arrives after the handshake, so the
+        // client must read for it to be stored
+        const char* message = "hello";
+        char buffer[256];
+        auto writer = [&] {
+            std::size_t n = ssl_stream_1.write(message, std::strlen(message));
+            CHECK_EQUAL(std::strlen(message), n);
+            ssl_stream_1.shutdown();
+        };
+        auto reader = [&] {
+            std::error_code ec;
+            std::size_t n = ssl_stream_2.read(buffer, sizeof buffer, ec);
+            CHECK_EQUAL(MiscExtErrors::end_of_input, ec);
+            CHECK_EQUAL(std::strlen(message), n);
+        };
+        std::thread thread_1(std::move(writer));
+        std::thread thread_2(std::move(reader));
+        thread_1.join();
+        thread_2.join();
+    }
+}
+
+
 TEST(Util_Network_SSL_AsyncReadWriteShutdown)
 {
     network::Service service;
@@ -0,0 +1,156 @@
+/*************************************************************************
+ *
+ * Copyright 2022 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_UTIL_SMALL_VECTOR
+
+#include <realm/util/small_vector.hpp>
+
+#include <memory>
+#include <string>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+
+TEST(Util_SmallVector_Inline)
+{
+    SmallVector<int, 4> v;
+    CHECK(v.empty());
+    CHECK(v.is_inline());
+    CHECK_EQUAL(v.capacity(), 4);
+
+    for (int i = 0; i < 4; ++i)
+        v.push_back(i);
+    CHECK(v.is_inline());
+    CHECK_EQUAL(v.size(), 4);
+    for (int i = 0; i < 4; ++i)
+        CHECK_EQUAL(v[i], i);
+
+    v.push_back(4);
+    CHECK_NOT(v.is_inline());
+    CHECK_EQUAL(v.size(), 5);
+    CHECK_GREATER_EQUAL(v.capacity(), 5);
+    for (int i = 0; i < 5; ++i)
+        CHECK_EQUAL(v[i], i);
+    CHECK_EQUAL(v.front(), 0);
+    CHECK_EQUAL(v.back(), 4);
+
+    v.pop_back();
+    CHECK_EQUAL(v.size(), 4);
+    v.clear();
+    CHECK(v.empty());
+}
+
+TEST(Util_SmallVector_InsertErase)
+{
+    SmallVector<int, 2> v = {1, 3};
+    auto it = v.insert(v.begin() + 1, 2);
+    CHECK_EQUAL(*it, 2);
+    it = v.insert(v.begin(), 0);
+    CHECK_EQUAL(*it, 0);
+    it = v.insert(v.end(), 4);
+    CHECK_EQUAL(*it, 4);
+    CHECK_EQUAL(v.size(), 5);
+    for (int i = 0; i < 5; ++i)
+        CHECK_EQUAL(v[i], i);
+
+    it = v.erase(v.begin() + 1);
+    CHECK_EQUAL(*it, 2);
+    CHECK((v == SmallVector<int, 2>{0, 2, 3, 4}));
+    it = v.erase(v.begin() + 1, v.begin() + 3);
+    CHECK_EQUAL(*it, 4);
+    CHECK((v == SmallVector<int, 2>{0, 4}));
+    it = v.erase(v.end() - 1);
+    CHECK(it == v.end());
+    CHECK((v == SmallVector<int, 2>{0}));
+
+    // Inserting an element of the vector itself while it has to grow
+    SmallVector<std::string, 1> strings = {"a"};
+    strings.push_back(strings[0]);
+    strings.insert(strings.begin(), strings[1]);
+    CHECK_EQUAL(strings.size(), 3);
+    for (auto& str : strings)
+        CHECK_EQUAL(str, "a");
+}
+
+TEST(Util_SmallVector_Resize)
+{
+    SmallVector<std::string, 2> v;
+    v.resize(3);
+    CHECK_EQUAL(v.size(), 3);
+    CHECK_NOT(v.is_inline());
+    for (auto& str : v)
+        CHECK(str.empty());
+    v[2] = "value";
+    v.resize(1);
+    CHECK_EQUAL(v.size(), 1);
+
+    v.reserve(100);
+    CHECK_GREATER_EQUAL(v.capacity(), 100);
+    CHECK_EQUAL(v.size(), 1);
+
+    std::string values[] = {"a", "b", "c"};
+    v.assign(std::begin(values), std::end(values));
+    CHECK_EQUAL(v.size(), 3);
+    CHECK_EQUAL(v[2], "c");
+}
+
+TEST(Util_SmallVector_CopyAndMove)
+{
+    for (size_t size : {1, 2, 3, 10}) {
+        SmallVector<std::unique_ptr<int>, 2> v;
+        for (size_t i = 0; i < size; ++i)
+            v.push_back(std::make_unique<int>(int(i)));
+
+        SmallVector<std::unique_ptr<int>, 2> moved = std::move(v);
+        CHECK(v.empty());
+        CHECK(v.is_inline());
+        CHECK_EQUAL(moved.size(), size);
+        CHECK_EQUAL(moved.is_inline(), size <= 2);
+        for (size_t i = 0; i < size; ++i)
+            CHECK_EQUAL(*moved[i], int(i));
+
+        v.push_back(std::make_unique<int>(-1));
+        v = std::move(moved);
+        CHECK_EQUAL(v.size(), size);
+        CHECK_EQUAL(*v.back(), int(size - 1));
+    }
+
+    SmallVector<std::string, 2> v = {"a", "b", "c"};
+    SmallVector<std::string, 2> copy = v;
+    CHECK(copy == v);
+    copy[0] = "d";
+    CHECK(copy != v);
+    CHECK_EQUAL(v[0], "a");
+    copy = v;
+    CHECK(copy == v);
+
+    // Nested inline vectors must survive the outer vector growing
+    SmallVector<SmallVector<std::string, 2>, 1> nested;
+    nested.push_back({"a", "b"});
+    nested.push_back({"c"});
+    nested.insert(nested.begin(), {"d", "e", "f"});
+    CHECK_EQUAL(nested.size(), 3);
+    CHECK_EQUAL(nested[0][2], "f");
+    CHECK_EQUAL(nested[1][1], "b");
+    CHECK_EQUAL(nested[2][0], "c");
+}
+
+#endif // TEST_UTIL_SMALL_VECTOR
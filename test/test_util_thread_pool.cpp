@@ -0,0 +1,170 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_UTIL_THREAD_POOL
+
+#include <realm/util/thread_pool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+
+TEST(Util_ThreadPool_RunParallel)
+{
+    ThreadPool pool(4);
+    CHECK_EQUAL(pool.get_thread_count(), 4);
+
+    std::vector<int> results(100, 0);
+    pool.run_parallel(results.size(), [&](size_t i) {
+        results[i] = int(i) * 2;
+    });
+    for (size_t i = 0; i < results.size(); ++i)
+        CHECK_EQUAL(results[i], int(i) * 2);
+
+    // Nothing to do
+    pool.run_parallel(0, [&](size_t) {
+        CHECK(false);
+    });
+}
+
+TEST(Util_ThreadPool_Nested)
+{
+    // Every worker waits for nested tasks, which only completes if the waiting
+    // threads help running the queued tasks
+    ThreadPool pool(2);
+    std::atomic<size_t> count{0};
+    pool.run_parallel(8, [&](size_t) {
+        pool.run_parallel(8, [&](size_t) {
+            ++count;
+        });
+    });
+    CHECK_EQUAL(count.load(), 64);
+}
+
+TEST(Util_ThreadPool_Exceptions)
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> count{0};
+    try {
+        pool.run_parallel(10, [&](size_t i) {
+            ++count;
+            if (i == 3 || i == 7)
+                throw std::runtime_error(i == 3 ? "three" : "seven");
+        });
+        CHECK(false);
+    }
+    catch (const std::runtime_error& e) {
+        CHECK_EQUAL(std::string(e.what()), "three");
+    }
+    // All indices run even if some of them throw
+    CHECK_EQUAL(count.load(), 10);
+}
+
+TEST(Util_ThreadPool_Submit)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<int> order;
+    bool release = false;
+    {
+        ThreadPool pool(1);
+        // Block the only worker until all tasks are queued
+        pool.submit([&] {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] {
+                return release;
+            });
+        });
+        pool.submit(
+            [&] {
+                std::lock_guard lock(mutex);
+                order.push_back(3);
+            },
+            ThreadPool::Priority::low);
+        pool.submit(
+            [&] {
+                std::lock_guard lock(mutex);
+                order.push_back(2);
+            },
+            ThreadPool::Priority::normal);
+        pool.submit(
+            [&] {
+                std::lock_guard lock(mutex);
+                order.push_back(1);
+            },
+            ThreadPool::Priority::high);
+        {
+            std::lock_guard lock(mutex);
+            release = true;
+        }
+        cv.notify_one();
+        // The destructor waits for the queued tasks to complete
+    }
+    CHECK(order == std::vector<int>({1, 2, 3}));
+}
+
+TEST(Util_ThreadPool_Observer)
+{
+    struct Observer : ThreadPool::Observer {
+        std::atomic<int> created{0};
+        std::atomic<int> destroyed{0};
+        std::atomic<int> errors{0};
+        void did_create_thread() override
+        {
+            ++created;
+        }
+        void will_destroy_thread() override
+        {
+            ++destroyed;
+        }
+        void handle_error(const std::exception&) override
+        {
+            ++errors;
+        }
+    };
+    // Static, as the threads of the default pool used by concurrently running
+    // tests may still see the observer after it was reset
+    static Observer observer;
+    observer.errors = 0;
+    int created = observer.created;
+    int destroyed = observer.destroyed;
+
+    ThreadPool::set_observer(&observer);
+    {
+        ThreadPool pool(2);
+        pool.submit([] {
+            throw std::runtime_error("error");
+        });
+    }
+    ThreadPool::set_observer(nullptr);
+    // The default pool may have been started meanwhile, but is never destroyed
+    CHECK_GREATER_EQUAL(observer.created - created, 2);
+    CHECK_EQUAL(observer.destroyed - destroyed, 2);
+    CHECK_EQUAL(observer.errors.load(), 1);
+}
+
+#endif // TEST_UTIL_THREAD_POOL
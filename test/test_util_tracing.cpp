@@ -0,0 +1,170 @@
+/*************************************************************************
+ *
+ * Copyright 2026 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_UTIL_TRACING
+
+#include <realm/util/tracing.hpp>
+#include <realm/transaction.hpp>
+#include <realm/history.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util::tracing;
+
+namespace {
+
+// Records the spans begun on the thread which created it
+class RecordingSink : public Sink {
+public:
+    struct Record {
+        SpanId id;
+        SpanId parent;
+        std::string name;
+        std::vector<std::pair<std::string, int64_t>> attributes;
+        bool ended = false;
+    };
+
+    void begin_span(SpanId id, SpanId parent, const char* name, clock::time_point) override
+    {
+        if (std::this_thread::get_id() != m_thread)
+            return;
+        std::lock_guard lock(m_mutex);
+        m_records.push_back({id, parent, name, {}});
+    }
+
+    void end_span(SpanId id, const char*, clock::time_point, const Attribute* attributes,
+                  size_t num_attributes) override
+    {
+        if (std::this_thread::get_id() != m_thread)
+            return;
+        std::lock_guard lock(m_mutex);
+        for (auto& record : m_records) {
+            if (record.id == id) {
+                record.ended = true;
+                for (size_t i = 0; i < num_attributes; ++i)
+                    record.attributes.emplace_back(attributes[i].key, attributes[i].value);
+            }
+        }
+    }
+
+    const Record* find(const std::string& name) const
+    {
+        for (auto& record : m_records) {
+            if (record.name == name)
+                return &record;
+        }
+        return nullptr;
+    }
+
+    std::vector<Record> m_records;
+
+private:
+    std::mutex m_mutex;
+    std::thread::id m_thread = std::this_thread::get_id();
+};
+
+} // anonymous namespace
+
+#if REALM_TRACING
+
+NONCONCURRENT_TEST(Util_Tracing_Spans)
+{
+    auto sink = std::make_shared<RecordingSink>();
+    {
+        // Not recorded, as there is no sink
+        Span span("none");
+        CHECK_NOT(span.is_recording());
+        CHECK_EQUAL(span.get_id(), no_span);
+    }
+
+    set_sink(sink);
+    CHECK(get_sink() == sink);
+    {
+        Span outer("outer");
+        CHECK(outer.is_recording());
+        outer.set_attribute("a", 1);
+        {
+            Span inner("inner");
+            inner.set_attribute("b", 2);
+        }
+        set_sink(nullptr);
+        // Still ended on the sink it began on
+        for (int i = 0; i < 10; ++i)
+            outer.set_attribute("c", i);
+    }
+    Span ignored("ignored");
+
+    CHECK_EQUAL(sink->m_records.size(), 2);
+    auto outer = sink->find("outer");
+    auto inner = sink->find("inner");
+    if (!CHECK(outer && inner))
+        return;
+    CHECK(outer->ended && inner->ended);
+    CHECK_EQUAL(outer->parent, no_span);
+    CHECK_EQUAL(inner->parent, outer->id);
+    CHECK_NOT_EQUAL(inner->id, outer->id);
+    CHECK_EQUAL(inner->attributes.size(), 1);
+    CHECK_EQUAL(inner->attributes[0].second, 2);
+    // Attributes beyond the maximum are dropped
+    CHECK_EQUAL(outer->attributes.size(), Span::max_attributes);
+    CHECK_EQUAL(outer->attributes[0].first, "a");
+}
+
+NONCONCURRENT_TEST(Util_Tracing_Commit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path);
+
+    auto sink = std::make_shared<RecordingSink>();
+    set_sink(sink);
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 100; ++i)
+            table->create_object().set(col, i);
+        wt->commit();
+    }
+    set_sink(nullptr);
+
+    auto commit = sink->find("DB::do_commit");
+    auto write = sink->find("GroupWriter::write_group");
+    if (!CHECK(commit && write))
+        return;
+    CHECK_EQUAL(write->parent, commit->id);
+    CHECK(commit->ended);
+    CHECK_EQUAL(commit->attributes.size(), 1);
+    CHECK_EQUAL(commit->attributes[0].first, "version");
+    CHECK_EQUAL(write->attributes.size(), 1);
+    CHECK_EQUAL(write->attributes[0].first, "bytes_written");
+    CHECK_GREATER(write->attributes[0].second, 0);
+    if (auto durable = sink->find("GroupWriter::commit"))
+        CHECK_EQUAL(durable->parent, commit->id);
+}
+
+#endif // REALM_TRACING
+
+#endif // TEST_UTIL_TRACING
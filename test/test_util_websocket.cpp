@@ -170,6 +170,9 @@ public:
     int n_protocol_errors = 0;
     int n_read_errors = 0;
     int n_write_errors = 0;
+    size_t n_bytes_written = 0;
+    bool permessage_deflate = false;
+    HTTPHeaders handshake_headers;
 
     std::vector<std::string> text_messages;
     std::vector<std::string> binary_messages;
@@ -196,6 +199,7 @@ public:
 
     void async_write(const char* data, size_t size, WriteCompletionHandler handler) override
     {
+        n_bytes_written += size;
         m_pipe_out.async_write(data, size, std::move(handler));
     }
 
@@ -209,8 +213,9 @@ public:
         m_pipe_in.async_read_until(buffer, size, delim, std::move(handler));
     }
 
-    void websocket_handshake_completion_handler(const HTTPHeaders&) override
+    void websocket_handshake_completion_handler(const HTTPHeaders& headers) override
     {
+        handshake_headers = headers;
         n_handshake_completed++;
     }
 
@@ -264,6 +269,11 @@ public:
         return true;
     }
 
+    bool websocket_permessage_deflate_enabled() noexcept override
+    {
+        return permessage_deflate;
+    }
+
 
 private:
     Pipe &m_pipe_in, &m_pipe_out;
@@ -476,3 +486,138 @@ TEST(WebSocket_Interleaved_Fragmented_Messages)
     CHECK_EQUAL(config_2.binary_messages.size(), 1);
     CHECK_EQUAL(config_2.binary_messages[0], "abcd");
 }
+
+TEST(WebSocket_PermessageDeflate)
+{
+    Fixture fixt{test_context.logger};
+    WSConfig& config_1 = fixt.config_1;
+    WSConfig& config_2 = fixt.config_2;
+
+    websocket::Socket& socket_1 = fixt.socket_1;
+    websocket::Socket& socket_2 = fixt.socket_2;
+
+    config_1.permessage_deflate = true;
+    config_2.permessage_deflate = true;
+
+    socket_2.initiate_server_handshake();
+    socket_1.initiate_client_handshake("/uri", "host", "protocol");
+
+    CHECK_EQUAL(config_1.n_handshake_completed, 1);
+    CHECK_EQUAL(config_2.n_handshake_completed, 1);
+    CHECK_EQUAL(config_1.handshake_headers["Sec-WebSocket-Extensions"], "permessage-deflate");
+    CHECK_EQUAL(config_2.handshake_headers["Sec-WebSocket-Extensions"], "permessage-deflate; client_max_window_bits");
+
+    auto handler_no_op = [=]() {};
+
+    // With context takeover, a message that repeats an earlier one compresses
+    // to a few bytes.
+    std::string message(1000, 'x');
+    for (size_t i = 0; i < message.size(); ++i)
+        message[i] = char('a' + (i * 7) % 26);
+    for (int i = 0; i < 3; ++i) {
+        size_t n_bytes_written = config_1.n_bytes_written;
+        socket_1.async_write_binary(message.data(), message.size(), handler_no_op);
+        CHECK_EQUAL(config_2.binary_messages.size(), i + 1);
+        CHECK_EQUAL(config_2.binary_messages[i], message);
+        if (i > 0)
+            CHECK_LESS(config_1.n_bytes_written - n_bytes_written, 32);
+    }
+    socket_2.async_write_text(message.data(), message.size(), handler_no_op);
+    CHECK_EQUAL(config_1.text_messages.size(), 1);
+    CHECK_EQUAL(config_1.text_messages[0], message);
+
+    // Control frames, fragmented messages, and large messages are not
+    // compressed.
+    socket_1.async_write_ping("ping", 4, handler_no_op);
+    CHECK_EQUAL(config_2.ping_messages.size(), 1);
+    CHECK_EQUAL(config_2.ping_messages[0], "ping");
+    socket_1.async_write_frame(false, websocket::Opcode::binary, "abc", 3, handler_no_op);
+    socket_1.async_write_frame(true, websocket::Opcode::continuation, "defg", 4, handler_no_op);
+    CHECK_EQUAL(config_2.binary_messages.size(), 4);
+    CHECK_EQUAL(config_2.binary_messages[3], "abcdefg");
+
+    std::vector<size_t> message_sizes{1, 7, 8, 9, 125, 126, 16384, 16385, 65536, 100001};
+    for (size_t size : message_sizes) {
+        std::string str(size, 'c');
+        for (size_t i = 0; i < size; i += 3)
+            str[i] = char(i % 251);
+        socket_1.async_write_binary(str.data(), size, handler_no_op);
+        CHECK_EQUAL(config_2.binary_messages.back(), str);
+        socket_2.async_write_binary(str.data(), size, handler_no_op);
+        CHECK_EQUAL(config_1.binary_messages.back(), str);
+    }
+    CHECK_EQUAL(config_1.binary_messages.size(), message_sizes.size());
+    CHECK_EQUAL(config_2.binary_messages.size(), 4 + message_sizes.size());
+    CHECK_EQUAL(config_1.n_protocol_errors, 0);
+    CHECK_EQUAL(config_2.n_protocol_errors, 0);
+}
+
+TEST(WebSocket_PermessageDeflate_NotNegotiated)
+{
+    for (int i = 0; i < 2; ++i) {
+        Fixture fixt{test_context.logger};
+        WSConfig& config_1 = fixt.config_1;
+        WSConfig& config_2 = fixt.config_2;
+
+        // Only one of the sides wants the extension.
+        config_1.permessage_deflate = (i == 0);
+        config_2.permessage_deflate = (i == 1);
+
+        fixt.socket_2.initiate_server_handshake();
+        fixt.socket_1.initiate_client_handshake("/uri", "host", "protocol");
+        CHECK_EQUAL(config_1.n_handshake_completed, 1);
+        CHECK_EQUAL(config_2.n_handshake_completed, 1);
+        CHECK_EQUAL(config_1.handshake_headers.count("Sec-WebSocket-Extensions"), 0);
+
+        std::string message(1000, 'x');
+        auto handler_no_op = [=]() {};
+        for (int j = 0; j < 2; ++j) {
+            size_t n_bytes_written = config_1.n_bytes_written;
+            fixt.socket_1.async_write_binary(message.data(), message.size(), handler_no_op);
+            CHECK_GREATER(config_1.n_bytes_written - n_bytes_written, message.size());
+        }
+        CHECK_EQUAL(config_2.binary_messages.size(), 2);
+        CHECK_EQUAL(config_2.binary_messages[1], message);
+    }
+}
+
+TEST(WebSocket_PayloadBuffers)
+{
+    for (bool permessage_deflate : {false, true}) {
+        Fixture fixt{test_context.logger};
+        WSConfig& config_1 = fixt.config_1;
+        WSConfig& config_2 = fixt.config_2;
+        config_1.permessage_deflate = permessage_deflate;
+        config_2.permessage_deflate = permessage_deflate;
+
+        fixt.socket_2.initiate_server_handshake();
+        fixt.socket_1.initiate_client_handshake("/uri", "host", "protocol");
+        CHECK_EQUAL(config_1.n_handshake_completed, 1);
+        CHECK_EQUAL(config_2.n_handshake_completed, 1);
+
+        auto handler_no_op = [=]() {};
+
+        // The parts have sizes that are not multiples of four, such that the
+        // masking key must be carried over from one part to the next.
+        std::vector<size_t> message_sizes{0, 1, 5, 126, 1000, 70000, 100001};
+        size_t n = 0;
+        for (size_t size_1 : message_sizes) {
+            for (size_t size_2 : message_sizes) {
+                std::string header(size_1, 'h');
+                std::string body(size_2, 'b');
+                for (size_t i = 0; i < size_2; i += 7)
+                    body[i] = char(i % 253);
+                util::Span<const char> payload[] = {{header.data(), header.size()}, {body.data(), body.size()}};
+                fixt.socket_1.async_write_binary(payload, handler_no_op);
+                fixt.socket_2.async_write_binary(payload, handler_no_op);
+                ++n;
+                CHECK_EQUAL(config_2.binary_messages.size(), n);
+                CHECK_EQUAL(config_2.binary_messages.back(), header + body);
+                CHECK_EQUAL(config_1.binary_messages.size(), n);
+                CHECK_EQUAL(config_1.binary_messages.back(), header + body);
+            }
+        }
+        CHECK_EQUAL(config_1.n_protocol_errors, 0);
+        CHECK_EQUAL(config_2.n_protocol_errors, 0);
+    }
+}
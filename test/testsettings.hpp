@@ -91,6 +91,9 @@
 #define TEST_UTIL_FIXED_SIZE_BUFFER
 #define TEST_UTIL_FUNCTIONAL
 #define TEST_UTIL_FROM_CHARS
+#define TEST_UTIL_SMALL_VECTOR
+#define TEST_UTIL_THREAD_POOL
+#define TEST_UTIL_TRACING
 
 #ifndef _WIN32
 #define TEST_UTIL_NETWORK
@@ -84,6 +84,30 @@ std::string pad_right(std::string str, int width, char padding = ' ')
     return ss.str();
 }
 
+std::string format_change(const BenchmarkResults::Change& change)
+{
+    std::ostringstream out;
+    out.precision(2);
+    out << std::fixed;
+    out << '(' << std::showpos << change.relative * 100 << std::noshowpos << "% +/- "
+        << (change.relative_high - change.relative_low) / 2 * 100 << "%)";
+    return out.str();
+}
+
+// The two-sided 95% critical value of Student's t-distribution
+double student_t_95(double degrees_of_freedom)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degrees_of_freedom < 1)
+        return table[0];
+    size_t df = size_t(degrees_of_freedom);
+    if (df <= sizeof table / sizeof *table)
+        return table[df - 1];
+    return 1.96;
+}
+
 } // anonymous namespace
 
 BenchmarkResults::Result::Result()
@@ -99,6 +123,48 @@ double BenchmarkResults::Result::avg() const
     return total / rep;
 }
 
+double BenchmarkResults::Result::ci95() const
+{
+    if (rep < 2)
+        return 0;
+    return student_t_95(double(rep - 1)) * stddev / std::sqrt(double(rep));
+}
+
+bool BenchmarkResults::Change::is_regression() const
+{
+    return relative_low > regression_threshold;
+}
+
+bool BenchmarkResults::Change::is_improvement() const
+{
+    return relative_high < -regression_threshold;
+}
+
+BenchmarkResults::Change BenchmarkResults::compare(const Result& baseline, const Result& result)
+{
+    // Welch's t-test, as the variances of the two runs need not be equal
+    double baseline_avg = baseline.avg();
+    double diff = result.avg() - baseline_avg;
+    double var_baseline = baseline.rep > 1 ? baseline.stddev * baseline.stddev / baseline.rep : 0;
+    double var_result = result.rep > 1 ? result.stddev * result.stddev / result.rep : 0;
+    double standard_error = std::sqrt(var_baseline + var_result);
+    double df = 1;
+    if (standard_error > 0) {
+        double denominator = 0;
+        if (baseline.rep > 1)
+            denominator += var_baseline * var_baseline / (baseline.rep - 1);
+        if (result.rep > 1)
+            denominator += var_result * var_result / (result.rep - 1);
+        df = (var_baseline + var_result) * (var_baseline + var_result) / denominator;
+    }
+    double margin = student_t_95(df) * standard_error;
+    Change change;
+    change.relative = diff / baseline_avg;
+    change.relative_low = (diff - margin) / baseline_avg;
+    change.relative_high = (diff + margin) / baseline_avg;
+    return change;
+}
+
 void BenchmarkResults::submit_single(const char* ident, const char* lead_text, std::string measurement_type,
                                      double seconds)
 {
@@ -209,7 +275,6 @@ void BenchmarkResults::finish(const std::string& ident, const std::string& lead_
     if (baseline_iter != m_baseline_results.end()) {
         const Result& br = baseline_iter->second;
         double avg = r.avg();
-        double baseline_avg = br.avg();
 
         if ((r.min - br.min) > r.stddev * 2) {
             out << "* ";
@@ -233,14 +298,20 @@ void BenchmarkResults::finish(const std::string& ident, const std::string& lead_
         out << "med " << std::setw(time_width) << format_elapsed_time(r.median) << " "
             << pad_right(format_change(br.median, r.median), 15) << "   ";
 
-        if ((avg - baseline_avg) > r.stddev * 2) {
+        // Slower (*) or faster (-) than the baseline with 95% confidence
+        Change change = compare(br, r);
+        if (change.is_regression()) {
             out << "* ";
+            m_regressions.insert(ident);
+        }
+        else if (change.is_improvement()) {
+            out << "- ";
         }
         else {
             out << "  ";
         }
         out << "avg " << std::setw(time_width) << format_elapsed_time(avg) << " "
-            << pad_right(format_change(baseline_avg, avg), 15) << "     ";
+            << pad_right(format_change(change), 25) << "     ";
 
         out << "stddev" << std::setw(time_width) << format_elapsed_time(r.stddev) << " "
             << pad_right(format_change(br.stddev, r.stddev), 15);
@@ -249,7 +320,8 @@ void BenchmarkResults::finish(const std::string& ident, const std::string& lead_
         out << "min " << std::setw(time_width) << format_elapsed_time(r.min) << "     ";
         out << "max " << std::setw(time_width) << format_elapsed_time(r.max) << "     ";
         out << "median " << std::setw(time_width) << format_elapsed_time(r.median) << "     ";
-        out << "avg " << std::setw(time_width) << format_elapsed_time(r.avg()) << "     ";
+        out << "avg " << std::setw(time_width) << format_elapsed_time(r.avg()) << " +/- "
+            << std::setw(time_width) << format_elapsed_time(r.ci95()) << "     ";
         out << "stddev " << std::setw(time_width) << format_elapsed_time(r.stddev);
     }
     out << std::endl;
@@ -373,14 +445,25 @@ void BenchmarkResults::save_results()
                 metric_objs.push_back(make_result_obj("median", result.median));
                 metric_objs.push_back(make_result_obj("avg", result.avg()));
                 metric_objs.push_back(make_result_obj("stddev", result.stddev));
+                metric_objs.push_back(make_result_obj("avg_ci95", result.ci95()));
             }
 
-            test_results.push_back(json{{"info",
-                                         json{
-                                             {"test_name", measurement.first},
-                                             {"parent", m_suite_name},
-                                         }},
-                                        {"metrics", std::move(metric_objs)}});
+            auto info = json{
+                {"test_name", measurement.first},
+                {"parent", m_suite_name},
+                {"repetitions", result.rep},
+            };
+            auto baseline = m_baseline_results.find(measurement.first);
+            if (baseline != m_baseline_results.end()) {
+                Change change = compare(baseline->second, result);
+                info["baseline"] = json{{"avg", baseline->second.avg()},
+                                        {"change", change.relative},
+                                        {"change_ci95_low", change.relative_low},
+                                        {"change_ci95_high", change.relative_high},
+                                        {"regression", change.is_regression()},
+                                        {"improvement", change.is_improvement()}};
+            }
+            test_results.push_back(json{{"info", std::move(info)}, {"metrics", std::move(metric_objs)}});
         }
 
         auto full_results_obj =
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 
 namespace realm {
@@ -39,6 +40,27 @@ public:
     void submit(const char* ident, double seconds);
     void finish(const std::string& ident, const std::string& lead_text, std::string measurement_type);
 
+    /// The number of finished measurements whose average is significantly
+    /// slower than the baseline, i.e. where the 95% confidence interval of the
+    /// change lies entirely above `regression_threshold`.
+    size_t get_num_regressions() const
+    {
+        return m_regressions.size();
+    }
+
+    static constexpr double regression_threshold = 0.02;
+
+    /// The relative change of the average from a baseline, with its 95%
+    /// confidence interval
+    struct Change {
+        double relative;
+        double relative_low;
+        double relative_high;
+
+        bool is_regression() const;
+        bool is_improvement() const;
+    };
+
 private:
     int m_max_lead_text_width;
     std::string m_results_file_stem;
@@ -54,8 +76,12 @@ private:
         size_t rep;
 
         double avg() const;
+        /// Half the width of the 95% confidence interval of the average
+        double ci95() const;
     };
 
+    static Change compare(const Result& baseline, const Result& result);
+
     struct Measurement {
         std::vector<double> samples;
         std::string type;
@@ -67,6 +93,7 @@ private:
     Measurements m_measurements;
     typedef std::map<std::string, Result> BaselineResults;
     BaselineResults m_baseline_results;
+    std::set<std::string> m_regressions;
 
     void try_load_baseline_results();
     void save_results();